@@ -115,6 +115,24 @@ do { \
  * Inline functions
  ****************************************************************************/
 
+/* TPIDRURO holds TLS_THREAD_POINTER() of the running thread.  It changes
+ * only across a context switch, which the thread does not see, so the
+ * read is not volatile and may be merged.
+ */
+
+#if defined(CONFIG_TLS_REGISTER) && !defined(__KERNEL__) && \
+    !defined(__ASSEMBLY__)
+static inline uintptr_t arm_tls_pointer(void)
+{
+  uintptr_t tp;
+
+  __asm__ ("mrc p15, 0, %0, c13, c0, 3" : "=r"(tp));
+  return tp;
+}
+
+#  define up_tls_info() ((FAR struct tls_info_s *)arm_tls_pointer() - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
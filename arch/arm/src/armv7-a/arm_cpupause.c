@@ -134,13 +134,13 @@ int up_cpu_paused(int cpu)
    * requesting CPU.
    */
 
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* Wait for the spinlock to be released.  The requesting CPU will release
    * the spinlock when the CPU is resumed.
    */
 
-  spin_lock(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
 
   /* This CPU has been resumed. Restore the exception context of the TCB at
    * the (new) head of the assigned task list.
@@ -163,7 +163,7 @@ int up_cpu_paused(int cpu)
    */
 
   arm_restorestate(tcb->xcp.regs);
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
 
   return OK;
 }
@@ -260,8 +260,8 @@ int up_cpu_pause(int cpu)
 
   DEBUGASSERT(!spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
 
   /* Execute SGI2 */
 
@@ -271,8 +271,8 @@ int up_cpu_pause(int cpu)
    * it is fully paused and ready for up_cpu_resume();
    */
 
-  spin_lock(&g_cpu_paused[cpu]);
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* On successful return g_cpu_wait will be locked, the other CPU will be
    * spinning on g_cpu_wait and will not continue until g_cpu_resume() is
@@ -319,7 +319,7 @@ int up_cpu_resume(int cpu)
   DEBUGASSERT(spin_islocked(&g_cpu_wait[cpu]) &&
               !spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
   return OK;
 }
 
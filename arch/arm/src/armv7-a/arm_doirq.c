@@ -31,9 +31,12 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/board.h>
+#include <nuttx/sched.h>
+#include <nuttx/tls.h>
 #include <arch/board/board.h>
 
 #include "arm_internal.h"
+#include "cp15.h"
 #include "group/group.h"
 #include "gic.h"
 
@@ -93,6 +96,12 @@ uint32_t *arm_doirq(int irq, uint32_t *regs)
 
   if (regs != CURRENT_REGS)
     {
+#ifdef CONFIG_TLS_REGISTER
+      /* Load the thread pointer of the thread that is switched in */
+
+      CP15_SET(TPIDRURO, TLS_THREAD_POINTER(nxsched_self()));
+#endif
+
       restore_critical_section();
       regs = (uint32_t *)CURRENT_REGS;
     }
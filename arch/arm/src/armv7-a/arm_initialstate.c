@@ -28,9 +28,11 @@
 #include <string.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/tls.h>
 
 #include "arm.h"
 #include "arm_internal.h"
+#include "cp15.h"
 
 /****************************************************************************
  * Public Functions
@@ -77,6 +79,12 @@ void up_initial_state(struct tcb_s *tcb)
       arm_stack_color(tcb->stack_alloc_ptr, 0);
 #endif /* CONFIG_STACK_COLORATION */
 
+#ifdef CONFIG_TLS_REGISTER
+      /* The IDLE thread is already running: Load its thread pointer */
+
+      CP15_SET(TPIDRURO, TLS_THREAD_POINTER(tcb));
+#endif
+
       return;
     }
 
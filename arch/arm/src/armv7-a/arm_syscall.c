@@ -34,10 +34,12 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/addrenv.h>
+#include <nuttx/tls.h>
 
 #include "addrenv.h"
 #include "arm.h"
 #include "arm_internal.h"
+#include "cp15.h"
 #include "group/group.h"
 #include "signal/signal.h"
 
@@ -578,6 +580,12 @@ uint32_t *arm_syscall(uint32_t *regs)
 
   if (regs != CURRENT_REGS)
     {
+#ifdef CONFIG_TLS_REGISTER
+      /* Load the thread pointer of the thread that is switched in */
+
+      CP15_SET(TPIDRURO, TLS_THREAD_POINTER(nxsched_self()));
+#endif
+
       restore_critical_section();
       regs = (uint32_t *)CURRENT_REGS;
     }
@@ -98,6 +98,12 @@ int arm_memfault(int irq, void *context, void *arg)
       mfalert("\tFloating-point lazy state preservation error\n");
     }
 
+#ifdef CONFIG_STACK_GUARD
+  /* Let the assertion logic dump the stack */
+
+  up_stack_guard(NULL);
+#endif
+
   up_irq_save();
   PANIC();
   return OK; /* Won't get here */
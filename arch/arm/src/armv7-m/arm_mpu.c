@@ -223,7 +223,13 @@ static void mpu_reset_internal()
 
 unsigned int mpu_allocregion(void)
 {
+#ifdef CONFIG_STACK_GUARD
+  /* The last region is reserved for the stack guard */
+
+  DEBUGASSERT(g_region < CONFIG_ARM_MPU_NREGIONS - 1);
+#else
   DEBUGASSERT(g_region < CONFIG_ARM_MPU_NREGIONS);
+#endif
   return (unsigned int)g_region++;
 }
 
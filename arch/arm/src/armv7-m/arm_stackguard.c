@@ -0,0 +1,101 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arm_stackguard.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The guard of the running thread is the lowest CONFIG_STACK_GUARD_SIZE
+ * aligned block of its stack, above its TLS data and arguments.  The last
+ * MPU region, which takes precedence over all of the others, denies all
+ * accesses to it, so that an overflow faults at once.  The region is moved
+ * at each context switch.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/lib/math32.h>
+
+#include "mpu.h"
+#include "barriers.h"
+#include "arm_internal.h"
+
+#ifdef CONFIG_STACK_GUARD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_STACK_GUARD_SIZE < 32 || \
+    (CONFIG_STACK_GUARD_SIZE & (CONFIG_STACK_GUARD_SIZE - 1)) != 0
+#  error CONFIG_STACK_GUARD_SIZE must be a power of two of 32 or more
+#endif
+
+#define STACK_GUARD_REGION  (CONFIG_ARM_MPU_NREGIONS - 1)
+#define STACK_GUARD_RASR    (MPU_RASR_ENABLE | MPU_RASR_AP_NONO | \
+                             MPU_RASR_XN | \
+                             MPU_RASR_SIZE_LOG2(LOG2_CEIL( \
+                               CONFIG_STACK_GUARD_SIZE)))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_stack_guard
+ *
+ * Description:
+ *   Move the guard region under the stack of the thread that is about to
+ *   run, or remove it if tcb is NULL.
+ *
+ ****************************************************************************/
+
+void up_stack_guard(FAR struct tcb_s *tcb)
+{
+  uint32_t rbar = MPU_RBAR_VALID | STACK_GUARD_REGION;
+  uint32_t rasr = 0;
+
+  if (tcb != NULL && STACK_GUARD_VALID(tcb))
+    {
+      rbar |= arm_stack_guard(tcb);
+      rasr  = STACK_GUARD_RASR;
+    }
+
+  putreg32(rbar, MPU_RBAR);
+  putreg32(rasr, MPU_RASR);
+
+  /* Keep the default memory map for the privileged code, if the MPU was
+   * not set up by the chip
+   */
+
+  if ((getreg32(MPU_CTRL) & MPU_CTRL_ENABLE) == 0)
+    {
+      mpu_control(true, false, true);
+    }
+
+  ARM_DSB();
+  ARM_ISB();
+}
+
+#endif /* CONFIG_STACK_GUARD */
@@ -423,6 +423,24 @@ int arm_svcall(int irq, void *context, void *arg)
 
           DEBUGASSERT(cmd >= CONFIG_SYS_RESERVED && cmd < SYS_maxsyscall);
 
+#ifdef CONFIG_SYSCALL_LEAF
+          /* Run the calls that never block right here.  This saves the
+           * return to dispatch_syscall and the SYS_syscall_return trap.
+           */
+
+          if (syscall_isleaf(cmd))
+            {
+              syscall_stub_t stub = (syscall_stub_t)
+                g_stublookup[cmd - CONFIG_SYS_RESERVED];
+
+              regs[REG_R0] = stub(cmd - CONFIG_SYS_RESERVED,
+                                  regs[REG_R1], regs[REG_R2],
+                                  regs[REG_R3], regs[REG_R4],
+                                  regs[REG_R5], regs[REG_R6]);
+              break;
+            }
+#endif
+
           /* Make sure that there is a no saved syscall return address.  We
            * cannot yet handle nested system calls.
            */
@@ -199,7 +199,8 @@ void arm_stack_color(void *stackbase, size_t nbytes)
 
 size_t up_check_tcbstack(struct tcb_s *tcb)
 {
-  size_t size;
+  FAR void *base = tcb->stack_base_ptr;
+  size_t size = tcb->adj_stack_size;
 
 #ifdef CONFIG_ARCH_ADDRENV
   save_addrenv_t oldenv;
@@ -212,7 +213,17 @@ size_t up_check_tcbstack(struct tcb_s *tcb)
     }
 #endif
 
-  size = arm_stack_check(tcb->stack_base_ptr, tcb->adj_stack_size);
+#ifdef CONFIG_STACK_GUARD
+  /* The guard is never written, and the running thread cannot read it */
+
+  if (STACK_GUARD_VALID(tcb))
+    {
+      base  = (FAR void *)(arm_stack_guard(tcb) + CONFIG_STACK_GUARD_SIZE);
+      size -= (uintptr_t)base - (uintptr_t)tcb->stack_base_ptr;
+    }
+#endif
+
+  size = arm_stack_check(base, size);
 
 #ifdef CONFIG_ARCH_ADDRENV
   if (saved)
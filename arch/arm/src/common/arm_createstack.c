@@ -110,7 +110,8 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
     {
       /* Allocate the stack.  If DEBUG is enabled (but not stack debug),
        * then create a zeroed stack to make stack dumps easier to trace.
-       * If TLS is enabled, then we must allocate aligned stacks.
+       * If TLS is enabled, then we must allocate aligned stacks.  Stacks
+       * prefer the fast memory tier, if the heap has one.
        */
 
 #ifdef CONFIG_TLS_ALIGNED
@@ -119,14 +120,18 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
-          tcb->stack_alloc_ptr = kmm_memalign(TLS_STACK_ALIGN, stack_size);
+          tcb->stack_alloc_ptr = kmm_memalign_tier(TLS_STACK_ALIGN,
+                                                   stack_size,
+                                                   MM_TIER_FAST);
         }
       else
 #endif
         {
           /* Use the user-space allocator if this is a task or pthread */
 
-          tcb->stack_alloc_ptr = kumm_memalign(TLS_STACK_ALIGN, stack_size);
+          tcb->stack_alloc_ptr = kumm_memalign_tier(TLS_STACK_ALIGN,
+                                                    stack_size,
+                                                    MM_TIER_FAST);
         }
 
 #else /* CONFIG_TLS_ALIGNED */
@@ -135,14 +140,14 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
-          tcb->stack_alloc_ptr = kmm_malloc(stack_size);
+          tcb->stack_alloc_ptr = kmm_malloc_tier(stack_size, MM_TIER_FAST);
         }
       else
 #endif
         {
           /* Use the user-space allocator if this is a task or pthread */
 
-          tcb->stack_alloc_ptr = kumm_malloc(stack_size);
+          tcb->stack_alloc_ptr = kumm_malloc_tier(stack_size, MM_TIER_FAST);
         }
 #endif /* CONFIG_TLS_ALIGNED */
 
@@ -480,6 +480,16 @@ size_t arm_stack_check(void *stackbase, size_t nbytes);
 void arm_stack_color(void *stackbase, size_t nbytes);
 #endif
 
+#ifdef CONFIG_STACK_GUARD
+/* The guard of a stack is its lowest aligned block, if it is large enough */
+
+#  define STACK_GUARD_VALID(tcb) \
+     ((tcb)->adj_stack_size > 2 * CONFIG_STACK_GUARD_SIZE)
+#  define arm_stack_guard(tcb) \
+     (((uintptr_t)(tcb)->stack_base_ptr + CONFIG_STACK_GUARD_SIZE - 1) & \
+      ~(uintptr_t)(CONFIG_STACK_GUARD_SIZE - 1))
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
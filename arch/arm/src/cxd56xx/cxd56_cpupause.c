@@ -110,11 +110,11 @@ static bool handle_irqreq(int cpu)
         {
           /* Unlock the spinlock first */
 
-          spin_unlock(&g_cpu_paused[cpu]);
+          spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
           /* Then wait for the spinlock to be released */
 
-          spin_lock(&g_cpu_wait[cpu]);
+          spin_lock_wo_note(&g_cpu_wait[cpu]);
 
           /* Clear g_irq_to_handle[cpu][i] */
 
@@ -131,7 +131,7 @@ static bool handle_irqreq(int cpu)
 
           /* Finally unlock the spinlock */
 
-          spin_unlock(&g_cpu_wait[cpu]);
+          spin_unlock_wo_note(&g_cpu_wait[cpu]);
           handled = true;
 
           break;
@@ -221,8 +221,8 @@ int up_cpu_paused(int cpu)
 
   /* Wait for the spinlock to be released */
 
-  spin_unlock(&g_cpu_paused[cpu]);
-  spin_lock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
 
   /* Restore the exception context of the tcb at the (new) head of the
    * assigned task list.
@@ -245,7 +245,7 @@ int up_cpu_paused(int cpu)
    */
 
   arm_restorestate(tcb->xcp.regs);
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
 
   return OK;
 }
@@ -356,8 +356,8 @@ int up_cpu_pause(int cpu)
 
   DEBUGASSERT(!spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
 
   /* Generate IRQ for CPU(cpu) */
 
@@ -367,8 +367,8 @@ int up_cpu_pause(int cpu)
    * it is fully paused and ready for up_cpu_resume();
    */
 
-  spin_lock(&g_cpu_paused[cpu]);
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* On successful return g_cpu_wait will be locked, the other CPU will be
    * spinning on g_cpu_wait and will not continue until g_cpu_resume() is
@@ -417,7 +417,7 @@ int up_cpu_resume(int cpu)
   DEBUGASSERT(spin_islocked(&g_cpu_wait[cpu]) &&
               !spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
   return OK;
 }
 
@@ -444,8 +444,8 @@ void up_send_irqreq(int idx, int irq, int cpu)
 
   /* Wait for the spinlocks to be released */
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
 
   /* Set irq for the cpu */
 
@@ -457,12 +457,12 @@ void up_send_irqreq(int idx, int irq, int cpu)
 
   /* Wait for the handler is executed on cpu */
 
-  spin_lock(&g_cpu_paused[cpu]);
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* Finally unlock the spinlock to proceed the handler */
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
 }
 
 #endif /* CONFIG_SMP */
@@ -89,11 +89,11 @@ static void rp2040_handle_irqreq(int irqreq)
 
   /* Unlock the spinlock first */
 
-  spin_unlock(&g_cpu_paused[0]);
+  spin_unlock_wo_note(&g_cpu_paused[0]);
 
   /* Then wait for the spinlock to be released */
 
-  spin_lock(&g_cpu_wait[0]);
+  spin_lock_wo_note(&g_cpu_wait[0]);
 
   if (irqreq > 0)
     {
@@ -106,7 +106,7 @@ static void rp2040_handle_irqreq(int irqreq)
 
   /* Finally unlock the spinlock */
 
-  spin_unlock(&g_cpu_wait[0]);
+  spin_unlock_wo_note(&g_cpu_wait[0]);
 }
 
 /****************************************************************************
@@ -182,8 +182,8 @@ int up_cpu_paused(int cpu)
 
   /* Wait for the spinlock to be released */
 
-  spin_unlock(&g_cpu_paused[cpu]);
-  spin_lock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
 
   /* Restore the exception context of the tcb at the (new) head of the
    * assigned task list.
@@ -206,7 +206,7 @@ int up_cpu_paused(int cpu)
    */
 
   arm_restorestate(tcb->xcp.regs);
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
 
   return OK;
 }
@@ -327,8 +327,8 @@ int up_cpu_pause(int cpu)
 
   DEBUGASSERT(!spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
 
   DEBUGASSERT(cpu != up_cpu_index());
 
@@ -342,8 +342,8 @@ int up_cpu_pause(int cpu)
    * it is fully paused and ready for up_cpu_resume();
    */
 
-  spin_lock(&g_cpu_paused[cpu]);
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* On successful return g_cpu_wait will be locked, the other CPU will be
    * spinning on g_cpu_wait and will not continue until g_cpu_resume() is
@@ -392,7 +392,7 @@ int up_cpu_resume(int cpu)
   DEBUGASSERT(spin_islocked(&g_cpu_wait[cpu]) &&
               !spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
   return 0;
 }
 
@@ -415,8 +415,8 @@ void rp2040_send_irqreq(int irqreq)
 {
   /* Wait for the spinlocks to be released */
 
-  spin_lock(&g_cpu_wait[0]);
-  spin_lock(&g_cpu_paused[0]);
+  spin_lock_wo_note(&g_cpu_wait[0]);
+  spin_lock_wo_note(&g_cpu_paused[0]);
 
   /* Send IRQ number to Core #0 */
 
@@ -426,12 +426,12 @@ void rp2040_send_irqreq(int irqreq)
 
   /* Wait for the handler is executed on cpu */
 
-  spin_lock(&g_cpu_paused[0]);
-  spin_unlock(&g_cpu_paused[0]);
+  spin_lock_wo_note(&g_cpu_paused[0]);
+  spin_unlock_wo_note(&g_cpu_paused[0]);
 
   /* Finally unlock the spinlock to proceed the handler */
 
-  spin_unlock(&g_cpu_wait[0]);
+  spin_unlock_wo_note(&g_cpu_wait[0]);
 }
 
 #endif /* CONFIG_SMP */
@@ -144,8 +144,8 @@ int up_cpu_paused(int cpu)
 
   /* Wait for the spinlock to be released */
 
-  spin_unlock(&g_cpu_paused[cpu]);
-  spin_lock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
 
   /* Restore the exception context of the tcb at the (new) head of the
    * assigned task list.
@@ -168,7 +168,7 @@ int up_cpu_paused(int cpu)
    */
 
   arm_restorestate(tcb->xcp.regs);
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
 
   return OK;
 }
@@ -262,8 +262,8 @@ int up_cpu_pause(int cpu)
 
   DEBUGASSERT(!spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
 
   /* Execute Pause IRQ to CPU(cpu) */
 
@@ -282,8 +282,8 @@ int up_cpu_pause(int cpu)
    * it is fully paused and ready for up_cpu_resume();
    */
 
-  spin_lock(&g_cpu_paused[cpu]);
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* On successful return g_cpu_wait will be locked, the other CPU will be
    * spinning on g_cpu_wait and will not continue until g_cpu_resume() is
@@ -332,7 +332,7 @@ int up_cpu_resume(int cpu)
   DEBUGASSERT(spin_islocked(&g_cpu_wait[cpu]) &&
               !spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
   return OK;
 }
 
@@ -62,7 +62,7 @@
 #  define CORDIC_CSR_FUNC_LN        (8 << CORDIC_CSR_FUNC_SHIFT) /* Natural logarithm */
 #  define CORDIC_CSR_FUNC_SQRT      (9 << CORDIC_CSR_FUNC_SHIFT) /* Square root */
 #define CORDIC_CSR_PRECISION_SHIFT  (4)                          /* Bits 4-7: Precision */
-#define CORDIC_CSR_PRECISION_MASK   (7 << CORDIC_CSR_PRECISION_SHIFT)
+#define CORDIC_CSR_PRECISION_MASK   (15 << CORDIC_CSR_PRECISION_SHIFT)
 #define CORDIC_CSR_SCALE_SHIFT      (8)                          /* Bits 8-10: Scale */
 #define CORDIC_CSR_SCALE_MASK       (3 << CORDIC_CSR_SCALE_SHIFT)
 #define CORDIC_CSR_IEN              (1 << 16)                    /* Bit 16: Enable interrupt */
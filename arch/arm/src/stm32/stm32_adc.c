@@ -2210,11 +2210,25 @@ static void adc_dmaconvcallback(DMA_HANDLE handle, uint8_t isr,
 {
   struct adc_dev_s   *dev  = (struct adc_dev_s *)arg;
   struct stm32_dev_s *priv = (struct stm32_dev_s *)dev->ad_priv;
+  int32_t data[CONFIG_STM32_ADC_MAX_SAMPLES];
   int i;
 
   /* Verify that the upper-half driver has bound its callback functions */
 
-  if (priv->cb != NULL)
+  if (priv->cb != NULL && priv->cb->au_receive_batch != NULL &&
+      priv->current == 0)
+    {
+      /* Hand over the whole conversion sequence at once */
+
+      for (i = 0; i < priv->rnchannels; i++)
+        {
+          data[i] = priv->r_dmabuffer[i];
+        }
+
+      priv->cb->au_receive_batch(dev, priv->r_chanlist, priv->rnchannels,
+                                 data, priv->rnchannels);
+    }
+  else if (priv->cb != NULL)
     {
       DEBUGASSERT(priv->cb->au_receive != NULL);
 
@@ -83,6 +83,10 @@ struct stm32_lowerhalf_s
   uint32_t               clock;      /* Timer clock frequence */
   uint8_t                duty;       /* Result pwm frequence */
   uint32_t               freq;       /* Result pwm frequence */
+#ifdef CONFIG_CAPTURE_STREAM
+  cap_stream_t           handler;    /* Receives the streamed edges */
+  void                   *arg;       /* Argument of handler */
+#endif
 };
 
 /****************************************************************************
@@ -97,6 +101,10 @@ static int stm32_start(struct cap_lowerhalf_s *lower);
 static int stm32_stop(struct cap_lowerhalf_s *lower);
 static int stm32_getduty(struct cap_lowerhalf_s *lower, uint8_t *duty);
 static int stm32_getfreq(struct cap_lowerhalf_s *lower, uint32_t *freq);
+#ifdef CONFIG_CAPTURE_STREAM
+static int stm32_stream(struct cap_lowerhalf_s *lower,
+                        cap_stream_t handler, void *arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -110,6 +118,9 @@ static const struct cap_ops_s g_cap_ops =
   .stop        = stm32_stop,
   .getduty     = stm32_getduty,
   .getfreq     = stm32_getfreq,
+#ifdef CONFIG_CAPTURE_STREAM
+  .stream      = stm32_stream,
+#endif
 };
 
 #ifdef CONFIG_STM32_TIM1_CAP
@@ -273,6 +284,26 @@ static int stm32_cap_handler(int irq, void * context, void * arg)
 
   lower->freq = lower->clock / period;
 
+#ifdef CONFIG_CAPTURE_STREAM
+  /* The counter is reset by the rising edge:  Its capture is the period
+   * and the capture of the falling edge is the pulse width.
+   */
+
+  if (lower->handler != NULL)
+    {
+      struct cap_event_s events[2];
+
+      events[0].time    = period;
+      events[0].channel = lower->channel;
+      events[0].edge    = CAP_EDGE_RISING;
+      events[1].time    = STM32_CAP_GETCAPTURE(lower->cap, 0x3 & (~ch));
+      events[1].channel = lower->channel;
+      events[1].edge    = CAP_EDGE_FALLING;
+
+      lower->handler(lower->arg, events, 2);
+    }
+#endif
+
   return OK;
 }
 
@@ -464,6 +495,40 @@ static int stm32_getfreq(struct cap_lowerhalf_s *lower, uint32_t *freq)
   return OK;
 }
 
+#ifdef CONFIG_CAPTURE_STREAM
+/****************************************************************************
+ * Name: stm32_stream
+ *
+ * Description:
+ *   Deliver both edges of each captured pulse to handler.
+ *
+ * Input Parameters:
+ *   lower   - A pointer the publicly visible representation of the
+ *             "lower-half" driver state structure.
+ *   handler - The handler of the edges, NULL to stop streaming.
+ *   arg     - The argument of handler.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int stm32_stream(struct cap_lowerhalf_s *lower,
+                        cap_stream_t handler, void *arg)
+{
+  struct stm32_lowerhalf_s *priv = (struct stm32_lowerhalf_s *)lower;
+
+  irqstate_t flags = enter_critical_section();
+
+  priv->handler = handler;
+  priv->arg     = arg;
+
+  leave_critical_section(flags);
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -43,7 +43,7 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define STM32_CORDIC_PRECISION (3)
+#define STM32_CORDIC_PRECISION CONFIG_STM32_CORDIC_PRECISION
 #define STM32_CORDIC_ARGSIZE   (0) /* Argument size is 32-bit */
 #define STM32_CORDIC_RESSIZE   (0) /* Result size is 32-bit */
 
@@ -70,10 +70,15 @@ static uint32_t cordic_getreg(struct stm32_cordic_s *priv, int offset);
 static void cordic_putreg(struct stm32_cordic_s *priv, int offset,
                           uint32_t value);
 
+static int stm32_cordic_config(struct cordic_calc_s *calc,
+                               uint32_t *csrp, bool *arg2p);
+
 /* Ops */
 
-int cordic_calc(struct cordic_lowerhalf_s *lower,
-                struct cordic_calc_s *calc);
+static int stm32_cordic_calc(struct cordic_lowerhalf_s *lower,
+                             struct cordic_calc_s *calc);
+static int stm32_cordic_calcv(struct cordic_lowerhalf_s *lower,
+                              struct cordic_calc_s *calc, size_t n);
 
 /****************************************************************************
  * Private Data
@@ -83,7 +88,8 @@ int cordic_calc(struct cordic_lowerhalf_s *lower,
 
 struct cordic_ops_s g_stm32_cordic_ops =
 {
-  .calc = cordic_calc
+  .calc  = stm32_cordic_calc,
+  .calcv = stm32_cordic_calcv
 };
 
 /* STM32 CORDIC device */
@@ -119,20 +125,20 @@ static void cordic_putreg(struct stm32_cordic_s *priv, int offset,
 }
 
 /****************************************************************************
- * Name: cordic_calc
+ * Name: stm32_cordic_config
+ *
+ * Description:
+ *   Get the CSR value for the function of a request, and whether the
+ *   function takes a secondary argument.
+ *
  ****************************************************************************/
 
-int cordic_calc(struct cordic_lowerhalf_s *lower,
-                struct cordic_calc_s *calc)
+static int stm32_cordic_config(struct cordic_calc_s *calc,
+                               uint32_t *csrp, bool *arg2p)
 {
-  struct stm32_cordic_s *priv     = (struct stm32_cordic_s *)lower;
-  int                    ret      = OK;
-  uint32_t               csr      = 0;
-  bool                   arg2_inc = false;
-  uint8_t                scale    = 0;
-
-  DEBUGASSERT(lower);
-  DEBUGASSERT(calc);
+  uint32_t csr      = 0;
+  bool     arg2_inc = false;
+  uint8_t  scale    = 0;
 
   /* Configure CORDIC function */
 
@@ -220,8 +226,7 @@ int cordic_calc(struct cordic_lowerhalf_s *lower,
 
       default:
         {
-          ret = -EINVAL;
-          goto errout;
+          return -EINVAL;
         }
     }
 
@@ -256,6 +261,32 @@ int cordic_calc(struct cordic_lowerhalf_s *lower,
       csr |= CORDIC_CSR_NRES;
     }
 
+  *csrp  = csr;
+  *arg2p = arg2_inc;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_cordic_calc
+ ****************************************************************************/
+
+static int stm32_cordic_calc(struct cordic_lowerhalf_s *lower,
+                             struct cordic_calc_s *calc)
+{
+  struct stm32_cordic_s *priv     = (struct stm32_cordic_s *)lower;
+  int                    ret      = OK;
+  uint32_t               csr      = 0;
+  bool                   arg2_inc = false;
+
+  DEBUGASSERT(lower);
+  DEBUGASSERT(calc);
+
+  ret = stm32_cordic_config(calc, &csr, &arg2_inc);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
   /* Write CSR */
 
   cordic_putreg(priv, STM32_CORDIC_CSR_OFFSET, csr);
@@ -289,6 +320,68 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: stm32_cordic_calcv
+ *
+ * Description:
+ *   Calculate n requests of the same function.  The CSR is written once,
+ *   then each request only costs the accesses to WDATA and RDATA.
+ *
+ ****************************************************************************/
+
+static int stm32_cordic_calcv(struct cordic_lowerhalf_s *lower,
+                              struct cordic_calc_s *calc, size_t n)
+{
+  struct stm32_cordic_s *priv     = (struct stm32_cordic_s *)lower;
+  int                    ret      = OK;
+  uint32_t               csr      = 0;
+  bool                   arg2_inc = false;
+  size_t                 i;
+
+  DEBUGASSERT(lower);
+  DEBUGASSERT(calc);
+
+  if (n == 0)
+    {
+      goto errout;
+    }
+
+  ret = stm32_cordic_config(calc, &csr, &arg2_inc);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  cordic_putreg(priv, STM32_CORDIC_CSR_OFFSET, csr);
+
+  for (i = 0; i < n; i++)
+    {
+      DEBUGASSERT(calc[i].func == calc[0].func &&
+                  calc[i].res2_incl == calc[0].res2_incl);
+
+      cordic_putreg(priv, STM32_CORDIC_WDATA_OFFSET, calc[i].arg1);
+
+      if (arg2_inc == true)
+        {
+          cordic_putreg(priv, STM32_CORDIC_WDATA_OFFSET, calc[i].arg2);
+        }
+
+      calc[i].res1 = cordic_getreg(priv, STM32_CORDIC_RDATA_OFFSET);
+
+      if (calc[0].res2_incl == true)
+        {
+          calc[i].res2 = cordic_getreg(priv, STM32_CORDIC_RDATA_OFFSET);
+        }
+      else
+        {
+          calc[i].res2 = 0;
+        }
+    }
+
+errout:
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
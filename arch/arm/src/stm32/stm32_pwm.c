@@ -496,6 +496,8 @@ static int pwm_start(struct pwm_lowerhalf_s *dev,
                      const struct pwm_info_s *info);
 
 static int pwm_stop(struct pwm_lowerhalf_s *dev);
+static int pwm_update(struct pwm_lowerhalf_s *dev,
+                      const struct pwm_info_s *info);
 static int pwm_ioctl(struct pwm_lowerhalf_s *dev,
                      int cmd, unsigned long arg);
 
@@ -518,6 +520,7 @@ static const struct pwm_ops_s g_pwmops =
 #endif
   .stop        = pwm_stop,
   .ioctl       = pwm_ioctl,
+  .update      = pwm_update,
 };
 
 #ifdef CONFIG_STM32_PWM_LL_OPS
@@ -3678,7 +3681,7 @@ static int pwm_duty_channels_update(struct pwm_lowerhalf_s *dev,
     }
 
 errout:
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -4414,6 +4417,41 @@ static int pwm_start(struct pwm_lowerhalf_s *dev,
   return ret;
 }
 
+/****************************************************************************
+ * Name: pwm_update
+ *
+ * Description:
+ *   Change the duty cycles of the started output.  The compare registers
+ *   are preloaded:  The update event is disabled while they are written,
+ *   so that they are all transferred by the same update event.
+ *
+ * Input Parameters:
+ *   dev  - A reference to the lower half PWM driver state structure
+ *   info - A reference to the characteristics of the pulsed output
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+static int pwm_update(struct pwm_lowerhalf_s *dev,
+                      const struct pwm_info_s *info)
+{
+  struct stm32_pwmtimer_s *priv = (struct stm32_pwmtimer_s *)dev;
+  int ret;
+
+  if (info->frequency != priv->frequency)
+    {
+      return -EINVAL;
+    }
+
+  pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, 0, GTIM_CR1_UDIS);
+  ret = pwm_duty_channels_update(dev, info);
+  pwm_modifyreg(priv, STM32_GTIM_CR1_OFFSET, GTIM_CR1_UDIS, 0);
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: pwm_stop
  *
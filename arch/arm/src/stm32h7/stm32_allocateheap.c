@@ -307,10 +307,12 @@ void up_allocate_kheap(void **heap_start, size_t *heap_size)
  * Description:
  *   Make a range of memory available for allocation from system heap.
  *   If debug is disabled, compiler should optimize out the "desc" strings.
+ *   The tier tells how fast the memory is, see enum mm_tier_e.
  *
  ****************************************************************************/
 
-static void addregion (uintptr_t start, uint32_t size, const char *desc)
+static void addregion (uintptr_t start, uint32_t size, const char *desc,
+                       int tier)
 {
   /* Display memory ranges to help debugging */
 
@@ -330,7 +332,7 @@ static void addregion (uintptr_t start, uint32_t size, const char *desc)
 
   /* Add the SRAM123 user heap region. */
 
-  kumm_addregion((void *)start, size);
+  kumm_addregion_tier((void *)start, size, tier);
 }
 
 /****************************************************************************
@@ -350,14 +352,16 @@ void arm_addregion(void)
 
   if (mm_regions < CONFIG_MM_REGIONS)
     {
-      addregion (SRAM123_START, SRAM123_END - SRAM123_START, "SRAM1,2,3");
+      addregion (SRAM123_START, SRAM123_END - SRAM123_START, "SRAM1,2,3",
+                 MM_TIER_NORMAL);
       mm_regions++;
     }
 
 #ifdef HAVE_SRAM4
   if (mm_regions < CONFIG_MM_REGIONS)
     {
-      addregion (SRAM4_HEAP_START, SRAM4_END - SRAM4_HEAP_START, "SRAM4");
+      addregion (SRAM4_HEAP_START, SRAM4_END - SRAM4_HEAP_START, "SRAM4",
+                 MM_TIER_NORMAL);
       mm_regions++;
     }
 #endif
@@ -365,7 +369,7 @@ void arm_addregion(void)
 #ifdef HAVE_DTCM
   if (mm_regions < CONFIG_MM_REGIONS)
     {
-      addregion (DTCM_START, DTCM_END - DTCM_START, "DTCM");
+      addregion (DTCM_START, DTCM_END - DTCM_START, "DTCM", MM_TIER_FAST);
       mm_regions++;
     }
 #endif
@@ -377,7 +381,7 @@ void arm_addregion(void)
 #ifdef BOARD_SDRAM1_SIZE
   if (mm_regions < CONFIG_MM_REGIONS)
     {
-      addregion (STM32_FMC_BANK5, BOARD_SDRAM1_SIZE, "SDRAM1");
+      addregion (STM32_FMC_BANK5, BOARD_SDRAM1_SIZE, "SDRAM1", MM_TIER_SLOW);
       mm_regions++;
     }
 #endif
@@ -385,7 +389,7 @@ void arm_addregion(void)
 #ifdef BOARD_SDRAM2_SIZE
   if (mm_regions < CONFIG_MM_REGIONS)
     {
-      addregion (STM32_FMC_BANK6, BOARD_SDRAM2_SIZE, "SDRAM2");
+      addregion (STM32_FMC_BANK6, BOARD_SDRAM2_SIZE, "SDRAM2", MM_TIER_SLOW);
       mm_regions++;
     }
 #endif
@@ -393,7 +397,8 @@ void arm_addregion(void)
 #ifdef CONFIG_ARCH_HAVE_HEAP2
   if (mm_regions < CONFIG_MM_REGIONS)
     {
-      addregion (CONFIG_HEAP2_BASE, CONFIG_HEAP2_SIZE, "HEAP2");
+      addregion (CONFIG_HEAP2_BASE, CONFIG_HEAP2_SIZE, "HEAP2",
+                 MM_TIER_SLOW);
       mm_regions++;
     }
 #endif
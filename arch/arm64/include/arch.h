@@ -52,6 +52,24 @@
  * Inline functions
  ****************************************************************************/
 
+/* TPIDR_EL0 holds TLS_THREAD_POINTER() of the running thread.  It changes
+ * only across a context switch, which the thread does not see, so the
+ * read is not volatile and may be merged.
+ */
+
+#if defined(CONFIG_TLS_REGISTER) && !defined(__KERNEL__) && \
+    !defined(__ASSEMBLY__)
+static inline uintptr_t arm64_tls_pointer(void)
+{
+  uintptr_t tp;
+
+  __asm__ ("mrs %0, tpidr_el0" : "=r"(tp));
+  return tp;
+}
+
+#  define up_tls_info() ((FAR struct tls_info_s *)arm64_tls_pointer() - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -133,13 +133,13 @@ int up_cpu_paused(int cpu)
    * requesting CPU.
    */
 
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* Wait for the spinlock to be released.  The requesting CPU will release
    * the spinlock when the CPU is resumed.
    */
 
-  spin_lock(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
 
   /* This CPU has been resumed. Restore the exception context of the TCB at
    * the (new) head of the assigned task list.
@@ -162,7 +162,7 @@ int up_cpu_paused(int cpu)
    */
 
   arm64_restorestate(tcb->xcp.regs);
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
 
   return OK;
 }
@@ -262,8 +262,8 @@ int up_cpu_pause(int cpu)
 
   DEBUGASSERT(!spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
 
   /* Execute SGI2 */
 
@@ -272,7 +272,7 @@ int up_cpu_pause(int cpu)
     {
       /* What happened?  Unlock the g_cpu_wait spinlock */
 
-      spin_unlock(&g_cpu_wait[cpu]);
+      spin_unlock_wo_note(&g_cpu_wait[cpu]);
     }
   else
     {
@@ -280,10 +280,10 @@ int up_cpu_pause(int cpu)
        * it is fully paused and ready for up_cpu_resume();
        */
 
-      spin_lock(&g_cpu_paused[cpu]);
+      spin_lock_wo_note(&g_cpu_paused[cpu]);
     }
 
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* On successful return g_cpu_wait will be locked, the other CPU will be
    * spinning on g_cpu_wait and will not continue until g_cpu_resume() is
@@ -330,6 +330,6 @@ int up_cpu_resume(int cpu)
   DEBUGASSERT(spin_islocked(&g_cpu_wait[cpu]) &&
               !spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
   return OK;
 }
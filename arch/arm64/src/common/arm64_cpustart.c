@@ -35,6 +35,7 @@
 #include <nuttx/cache.h>
 #include <arch/spinlock.h>
 #include <nuttx/init.h>
+#include <nuttx/tls.h>
 
 #include "init/init.h"
 #include "arm64_arch.h"
@@ -116,7 +117,7 @@ static void arm64_smp_init_top(void *arg)
 
   write_sysreg(0, tpidrro_el0);
   write_sysreg(tcb, tpidr_el1);
-  write_sysreg(tcb, tpidr_el0);
+  write_sysreg(TLS_THREAD_POINTER(tcb), tpidr_el0);
 
   nx_idle_trampoline();
 }
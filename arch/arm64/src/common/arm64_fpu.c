@@ -84,6 +84,25 @@ static void arm64_fpu_access_trap_disable(void)
   ARM64_ISB();
 }
 
+/* Let the current thread use the FPU without a trap only if its context
+ * is the one loaded in the FPU; any other thread traps on first use.
+ */
+
+static void arm64_fpu_access_trap_update(void)
+{
+  struct tcb_s *tcb = (struct tcb_s *)arch_get_current_tcb();
+  struct fpu_reg *fpu_reg = (struct fpu_reg *)tcb->xcp.fpu_regs;
+
+  if (fpu_reg->fpu_trap != 0 && tcb == g_cpu_fpu_ctx[this_cpu()].fpu_owner)
+    {
+      arm64_fpu_access_trap_disable();
+    }
+  else
+    {
+      arm64_fpu_access_trap_enable();
+    }
+}
+
 /***************************************************************************
  * Public Functions
  ***************************************************************************/
@@ -130,15 +149,36 @@ void arm64_destory_fpu(struct tcb_s * tcb)
 
 void arm64_fpu_enter_exception(void)
 {
+  /* The registers of the FPU may hold the context of the interrupted
+   * thread:  The handler must trap before it can clobber them.
+   */
+
+  arm64_fpu_access_trap_enable();
 }
 
+/***************************************************************************
+ * Name: arm64_fpu_exit_exception
+ *
+ * Description:
+ *   called at every time return from a exception without a context
+ *   switch
+ *
+ ***************************************************************************/
+
 void arm64_fpu_exit_exception(void)
 {
+  /* Nested handlers keep trapping, only the thread may own the FPU */
+
+  if (arch_get_exception_depth() <= 1)
+    {
+      arm64_fpu_access_trap_update();
+    }
 }
 
 void arm64_fpu_trap(struct regs_context * regs)
 {
   struct tcb_s * owner;
+  struct tcb_s * tcb;
   struct fpu_reg *fpu_reg;
 
   UNUSED(regs);
@@ -147,18 +187,6 @@ void arm64_fpu_trap(struct regs_context * regs)
 
   arm64_fpu_access_trap_disable();
 
-  /* save current fpu owner's context */
-
-  owner = g_cpu_fpu_ctx[this_cpu()].fpu_owner;
-
-  if (owner != NULL)
-    {
-      arm64_fpu_save((struct fpu_reg *)owner->xcp.fpu_regs);
-      ARM64_DSB();
-      g_cpu_fpu_ctx[this_cpu()].save_count++;
-      g_cpu_fpu_ctx[this_cpu()].fpu_owner = NULL;
-    }
-
   if (arch_get_exception_depth() > 1)
     {
       /* if get_exception_depth > 1
@@ -166,51 +194,52 @@ void arm64_fpu_trap(struct regs_context * regs)
        * switch FPU owner to idle thread
        */
 
-      owner = g_cpu_fpu_ctx[this_cpu()].idle_thread;
+      tcb = g_cpu_fpu_ctx[this_cpu()].idle_thread;
     }
   else
     {
-      owner = (struct tcb_s *)arch_get_current_tcb();
+      tcb = (struct tcb_s *)arch_get_current_tcb();
     }
 
-  /* restore our context */
+  owner = g_cpu_fpu_ctx[this_cpu()].fpu_owner;
 
-  arm64_fpu_restore((struct fpu_reg *)owner->xcp.fpu_regs);
-  g_cpu_fpu_ctx[this_cpu()].restore_count++;
+  if (owner != tcb)
+    {
+      /* save current fpu owner's context */
 
-  /* become new owner */
+      if (owner != NULL)
+        {
+          arm64_fpu_save((struct fpu_reg *)owner->xcp.fpu_regs);
+          ARM64_DSB();
+          g_cpu_fpu_ctx[this_cpu()].save_count++;
+        }
 
-  g_cpu_fpu_ctx[this_cpu()].fpu_owner   = owner;
-  fpu_reg = (struct fpu_reg *)owner->xcp.fpu_regs;
-  fpu_reg->fpu_trap = 0;
-}
+      /* restore our context */
 
-void arm64_fpu_context_restore(void)
-{
-  struct tcb_s *new_tcb = (struct tcb_s *)arch_get_current_tcb();
-  struct fpu_reg *fpu_reg = (struct fpu_reg *)new_tcb->xcp.fpu_regs;
-
-  arm64_fpu_access_trap_enable();
+      arm64_fpu_restore((struct fpu_reg *)tcb->xcp.fpu_regs);
+      g_cpu_fpu_ctx[this_cpu()].restore_count++;
 
-  if (fpu_reg->fpu_trap == 0)
-    {
-      /* FPU trap hasn't happened at this task */
+      /* become new owner */
 
-      arm64_fpu_access_trap_enable();
+      g_cpu_fpu_ctx[this_cpu()].fpu_owner = tcb;
     }
-  else
-    {
-      /* FPU trap has happened at this task */
 
-      if (new_tcb == g_cpu_fpu_ctx[this_cpu()].fpu_owner)
-        {
-          arm64_fpu_access_trap_disable();
-        }
-      else
-        {
-          arm64_fpu_access_trap_enable();
-        }
-    }
+  /* Otherwise the FPU still holds our context: the trap was only armed
+   * by a context switch or by an exception since we last used it.
+   */
+
+  fpu_reg = (struct fpu_reg *)tcb->xcp.fpu_regs;
+  fpu_reg->fpu_trap = 1;
+}
+
+void arm64_fpu_context_restore(void)
+{
+  /* Nothing is saved or restored here: a thread that never uses the FPU
+   * never moves its registers, and the owner of the FPU finds its context
+   * still loaded when it is switched back in.
+   */
+
+  arm64_fpu_access_trap_update();
 
   g_cpu_fpu_ctx[this_cpu()].switch_count++;
 }
@@ -39,6 +39,7 @@
 #include <nuttx/serial/pty.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/power/pm.h>
+#include <nuttx/tls.h>
 #include <arch/chip/chip.h>
 
 #include "arm64_arch.h"
@@ -85,7 +86,7 @@ void arm64_new_task(struct tcb_s * tcb)
   pinitctx->sp_elx       = (uint64_t)pinitctx;
   pinitctx->sp_el0       = (uint64_t)pinitctx;
   pinitctx->exe_depth    = 0;
-  pinitctx->tpidr_el0    = (uint64_t)tcb;
+  pinitctx->tpidr_el0    = TLS_THREAD_POINTER(tcb);
   pinitctx->tpidr_el1    = (uint64_t)tcb;
 
   tcb->xcp.regs          = (uint64_t *)pinitctx;
@@ -133,7 +134,7 @@ void up_initial_state(struct tcb_s *tcb)
 
       write_sysreg(0, tpidrro_el0);
       write_sysreg(tcb, tpidr_el1);
-      write_sysreg(tcb, tpidr_el0);
+      write_sysreg(TLS_THREAD_POINTER(tcb), tpidr_el0);
 
 #ifdef CONFIG_STACK_COLORATION
 
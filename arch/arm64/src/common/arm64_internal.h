@@ -214,6 +214,10 @@ EXTERN uint8_t _sztext[];           /* Size of .text */
 EXTERN uint8_t _srodata[];          /* Start of .rodata */
 EXTERN uint8_t _erodata[];          /* End+1 of .rodata */
 EXTERN uint8_t _szrodata[];         /* Size of .rodata */
+EXTERN uint8_t _stdata[];           /* Start of .tdata */
+EXTERN uint8_t _etdata[];           /* End+1 of .tdata */
+EXTERN uint8_t _stbss[];            /* Start of .tbss */
+EXTERN uint8_t _etbss[];            /* End+1 of .tbss */
 EXTERN const uint8_t _eronly[];     /* End+1 of read only section (.text + .rodata) */
 EXTERN uint8_t _sdata[];            /* Start of .data */
 EXTERN uint8_t _edata[];            /* End+1 of .data */
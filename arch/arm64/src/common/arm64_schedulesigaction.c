@@ -31,6 +31,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/tls.h>
 
 #include "sched/sched.h"
 #include "arm64_internal.h"
@@ -72,7 +73,7 @@ void arm64_init_signal_process(struct tcb_s *tcb)
   psigctx->sp_elx    = (uint64_t)psigctx;
   psigctx->sp_el0    = (uint64_t)psigctx;
   psigctx->exe_depth = 1;
-  psigctx->tpidr_el0 = (uint64_t)tcb;
+  psigctx->tpidr_el0 = TLS_THREAD_POINTER(tcb);
   psigctx->tpidr_el1 = (uint64_t)tcb;
   tcb->xcp.regs      = (uint64_t *)psigctx;
 }
@@ -52,6 +52,28 @@
 #  define ARCH_SPGTS          (ARCH_PGT_MAX_LEVELS - 1)
 #endif
 
+/****************************************************************************
+ * Inline functions
+ ****************************************************************************/
+
+/* The tp register holds TLS_THREAD_POINTER() of the running thread.  It
+ * changes only across a context switch, which the thread does not see, so
+ * the read is not volatile and may be merged.
+ */
+
+#if defined(CONFIG_TLS_REGISTER) && !defined(__KERNEL__) && \
+    !defined(__ASSEMBLY__)
+static inline uintptr_t riscv_tls_pointer(void)
+{
+  uintptr_t tp;
+
+  __asm__ ("mv %0, tp" : "=r"(tp));
+  return tp;
+}
+
+#  define up_tls_info() ((FAR struct tls_info_s *)riscv_tls_pointer() - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -98,6 +120,14 @@ struct group_addrenv_s
   /* For convenience store the satp value here */
 
   uintptr_t satp;
+
+#ifdef CONFIG_RISCV_MMU_ASID
+  /* The ASID of the address environment and its generation, 0 if none has
+   * been assigned yet
+   */
+
+  uintptr_t asid;
+#endif
 };
 
 typedef struct group_addrenv_s group_addrenv_t;
@@ -67,5 +67,22 @@
 
 uintptr_t riscv_get_pgtable(group_addrenv_t *addrenv, uintptr_t vaddr);
 
+/****************************************************************************
+ * Name: riscv_addrenv_switch
+ *
+ * Description:
+ *   Instantiate an address environment with its ASID, assigning one first if
+ *   it has none of the current generation.  The TLB is only flushed if the
+ *   ASIDs ran out.
+ *
+ * Input Parameters:
+ *   addrenv - Pointer to a structure describing the address environment
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RISCV_MMU_ASID
+void riscv_addrenv_switch(group_addrenv_t *addrenv);
+#endif
+
 #endif /* CONFIG_ARCH_ADDRENV */
 #endif /* __ARCH_RISC_V_SRC_COMMON_ADDRENV_H */
@@ -68,6 +68,7 @@
 
 #include <arch/barriers.h>
 
+#include "addrenv.h"
 #include "pgalloc.h"
 #include "riscv_mmu.h"
 
@@ -287,6 +288,18 @@ static int create_region(group_addrenv_t *addrenv, uintptr_t vaddr,
 
       for (j = 0; j < ENTRIES_PER_PGT && nmapped < size; j++)
         {
+#ifdef CONFIG_RISCV_DEMAND_PAGING
+          if (mmuflags & PTE_DEMAND)
+            {
+              /* Leave the page to riscv_fillpage(), until it is touched */
+
+              mmu_ln_restore(ptlevel + 1, ptlast, vaddr, PTE_DEMAND);
+              nmapped += MM_PGSIZE;
+              vaddr   += MM_PGSIZE;
+              continue;
+            }
+#endif
+
           paddr = mm_pgalloc(1);
           if (!paddr)
             {
@@ -428,7 +441,11 @@ int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
       goto errout;
     }
 
+#ifdef CONFIG_RISCV_DEMAND_PAGING
+  ret = create_region(addrenv, heapbase, heapsize, PTE_DEMAND);
+#else
   ret = create_region(addrenv, heapbase, heapsize, MMU_UDATA_FLAGS);
+#endif
 
   if (ret < 0)
     {
@@ -694,7 +711,11 @@ int up_addrenv_select(const group_addrenv_t *addrenv,
       *oldenv = (save_addrenv_t)satp_reg;
     }
 
+#ifdef CONFIG_RISCV_MMU_ASID
+  riscv_addrenv_switch((group_addrenv_t *)addrenv);
+#else
   mmu_write_satp(addrenv->satp);
+#endif
   return OK;
 }
 
@@ -718,7 +739,16 @@ int up_addrenv_select(const group_addrenv_t *addrenv,
 int up_addrenv_restore(const save_addrenv_t *oldenv)
 {
   DEBUGASSERT(oldenv);
+
+#ifdef CONFIG_RISCV_MMU_ASID
+  /* The ASID of the saved value may have been reassigned since, restore
+   * it untagged.  ASID 0 is always entered with a flush.
+   */
+
+  mmu_write_satp((uintptr_t)*oldenv & ~SATP_ASID_MASK);
+#else
   mmu_write_satp((uintptr_t)*oldenv);
+#endif
   return OK;
 }
 
@@ -0,0 +1,168 @@
+/****************************************************************************
+ * arch/risc-v/src/common/riscv_addrenv_asid.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The ASIDs are assigned in generations.  An address environment is given
+ * the next free ASID of the current generation when it is first selected,
+ * and keeps it for the rest of the generation.  ASIDs are never released
+ * within a generation, so the translations cached with an ASID always
+ * belong to its owner.  Once the ASIDs run out, a new generation begins:
+ * the whole TLB is flushed and the address environments are given new
+ * ASIDs as they are selected again.
+ *
+ * ASID 0 is not assigned.  It tags untagged switches, which always flush.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "addrenv.h"
+#include "riscv_mmu.h"
+
+#ifdef CONFIG_RISCV_MMU_ASID
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* addrenv->asid holds the generation above the ASID */
+
+#define ASID_BITS         16
+#define ASID_MASK         ((1ul << ASID_BITS) - 1)
+#define ASID_GEN_FIRST    (1ul << ASID_BITS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The current generation and the next ASID to assign within it */
+
+static uintptr_t g_asid_generation = ASID_GEN_FIRST;
+static uintptr_t g_asid_next = 1;
+
+/* The number of ASIDs of the hardware, 0 until it has been probed */
+
+static uintptr_t g_asid_count;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: asid_probe
+ *
+ * Description:
+ *   Return the number of ASIDs that the hardware implements: The ASID field
+ *   of satp is WARL, only the implemented bits retain the ones written.
+ *
+ ****************************************************************************/
+
+static uintptr_t asid_probe(void)
+{
+  uintptr_t satp = mmu_read_satp();
+  uintptr_t asid;
+
+  mmu_write_satp(satp | SATP_ASID_MASK);
+  asid = (mmu_read_satp() & SATP_ASID_MASK) >> SATP_ASID_SHIFT;
+  mmu_write_satp(satp);
+
+  return asid + 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: riscv_addrenv_switch
+ *
+ * Description:
+ *   Instantiate an address environment with its ASID, assigning one first if
+ *   it has none of the current generation.  The TLB is only flushed if the
+ *   ASIDs ran out.
+ *
+ * Input Parameters:
+ *   addrenv - Pointer to a structure describing the address environment
+ *
+ ****************************************************************************/
+
+void riscv_addrenv_switch(group_addrenv_t *addrenv)
+{
+  irqstate_t flags;
+  uintptr_t satp;
+  bool flush = false;
+
+  DEBUGASSERT(addrenv);
+
+  flags = up_irq_save();
+
+  if (g_asid_count == 0)
+    {
+      g_asid_count = asid_probe();
+    }
+
+  if (g_asid_count <= 1)
+    {
+      /* The hardware has no ASIDs: Every switch flushes */
+
+      up_irq_restore(flags);
+      mmu_write_satp(addrenv->satp);
+      return;
+    }
+
+  if ((addrenv->asid & ~ASID_MASK) != g_asid_generation)
+    {
+      if (g_asid_next >= g_asid_count)
+        {
+          /* Out of ASIDs, begin a new generation */
+
+          g_asid_generation += ASID_GEN_FIRST;
+          g_asid_next        = 1;
+          flush              = true;
+        }
+
+      addrenv->asid = g_asid_generation | g_asid_next++;
+    }
+
+  satp = (addrenv->satp & ~SATP_ASID_MASK) |
+         ((addrenv->asid & ASID_MASK) << SATP_ASID_SHIFT);
+
+  if (flush)
+    {
+      mmu_write_satp(satp);
+    }
+  else
+    {
+      mmu_switch_satp(satp);
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_RISCV_MMU_ASID */
@@ -34,6 +34,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/tls.h>
 
 #include "sched/sched.h"
 #include "init/init.h"
@@ -88,6 +89,12 @@ void riscv_cpu_boot(int cpu)
   mmu_enable(g_kernel_pgt_pbase, 0);
 #endif
 
+#ifdef CONFIG_TLS_REGISTER
+  /* Load the thread pointer of the IDLE thread of this CPU */
+
+  WRITE_TP(TLS_THREAD_POINTER(this_task()));
+#endif
+
   _info("CPU%d Started\n", this_cpu());
 
 #ifdef CONFIG_STACK_COLORATION
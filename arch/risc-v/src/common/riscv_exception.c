@@ -129,9 +129,17 @@ void riscv_exception_attach(void)
 #endif
 
   irq_attach(RISCV_IRQ_INSTRUCTIONPF, riscv_exception, NULL);
+#ifdef CONFIG_RISCV_DEMAND_PAGING
+  irq_attach(RISCV_IRQ_LOADPF, riscv_fillpage, NULL);
+#else
   irq_attach(RISCV_IRQ_LOADPF, riscv_exception, NULL);
+#endif
   irq_attach(RISCV_IRQ_RESERVED, riscv_exception, NULL);
+#ifdef CONFIG_RISCV_DEMAND_PAGING
+  irq_attach(RISCV_IRQ_STOREPF, riscv_fillpage, NULL);
+#else
   irq_attach(RISCV_IRQ_STOREPF, riscv_exception, NULL);
+#endif
 
 #ifdef CONFIG_SMP
   irq_attach(RISCV_IRQ_SOFT, riscv_pause_handler, NULL);
@@ -0,0 +1,110 @@
+/****************************************************************************
+ * arch/risc-v/src/common/riscv_fillpage.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The heap of an address environment is created with final level entries
+ * that are invalid and tagged PTE_DEMAND.  The first access to such a page
+ * faults, and the fault handler below backs it with a zeroed page.  The
+ * page tables are walked from satp, as the faulting address environment is
+ * not necessarily the one of the running task, e.g. while a new process is
+ * being loaded.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/pgalloc.h>
+
+#include "pgalloc.h"
+#include "riscv_internal.h"
+#include "riscv_mmu.h"
+
+#ifdef CONFIG_RISCV_DEMAND_PAGING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: riscv_fillpage
+ *
+ * Description:
+ *   The load and store page fault handler.  Populate the faulting page if
+ *   it is to be populated on demand, otherwise handle the fault as any
+ *   other exception.
+ *
+ ****************************************************************************/
+
+int riscv_fillpage(int mcause, void *regs, void *args)
+{
+  uintptr_t vaddr = MM_PGALIGNDOWN(READ_CSR(CSR_TVAL));
+  uintptr_t lnvaddr;
+  uintptr_t entry;
+  uintptr_t paddr;
+  uint32_t  ptlevel;
+
+  /* Find the final level entry of the faulting address */
+
+  lnvaddr = riscv_pgvaddr(mmu_get_satp_pgbase());
+
+  for (ptlevel = 1; ptlevel < RV_MMU_PT_LEVELS; ptlevel++)
+    {
+      entry = mmu_ln_getentry(ptlevel, lnvaddr, vaddr);
+      if ((entry & PTE_VALID) == 0 || (entry & PTE_LEAF_MASK) != 0)
+        {
+          return riscv_exception(mcause, regs, args);
+        }
+
+      lnvaddr = riscv_pgvaddr(mmu_pte_to_paddr(entry));
+      if (lnvaddr == 0)
+        {
+          return riscv_exception(mcause, regs, args);
+        }
+    }
+
+  if (mmu_ln_getentry(ptlevel, lnvaddr, vaddr) != PTE_DEMAND)
+    {
+      return riscv_exception(mcause, regs, args);
+    }
+
+  /* Back it with a zeroed page, the faulting instruction is then retried */
+
+  paddr = mm_pgalloc(1);
+  if (paddr == 0)
+    {
+      _alert("Out of pages for %" PRIxREG "\n", vaddr);
+      return riscv_exception(mcause, regs, args);
+    }
+
+  riscv_pgwipe(paddr);
+  __DMB();
+
+  mmu_ln_setentry(ptlevel, lnvaddr, paddr, vaddr, MMU_UDATA_FLAGS);
+  return OK;
+}
+
+#endif /* CONFIG_RISCV_DEMAND_PAGING */
@@ -78,6 +78,12 @@ void up_initial_state(struct tcb_s *tcb)
 
       riscv_stack_color(tcb->stack_alloc_ptr, 0);
 #endif /* CONFIG_STACK_COLORATION */
+
+#ifdef CONFIG_TLS_REGISTER
+      /* The IDLE thread is already running: Load its thread pointer */
+
+      WRITE_TP(TLS_THREAD_POINTER(tcb));
+#endif
       return;
     }
 
@@ -101,9 +107,8 @@ void up_initial_state(struct tcb_s *tcb)
 
   /* Setup thread local storage pointer */
 
-#ifdef CONFIG_SCHED_THREAD_LOCAL
-  xcp->regs[REG_TP]      = (uintptr_t)tcb->stack_alloc_ptr +
-                                     sizeof(struct tls_info_s);
+#ifdef CONFIG_TLS_REGISTER
+  xcp->regs[REG_TP]      = TLS_THREAD_POINTER(tcb);
 #endif
 
   /* Set the initial value of the interrupt context register.
@@ -159,6 +159,11 @@
      __asm__ __volatile__("csrc " __STR(reg) ", %0" :: "rK"(bits)); \
   })
 
+#define WRITE_TP(val) \
+  ({ \
+     __asm__ __volatile__("mv tp, %0" :: "r"(val)); \
+  })
+
 #endif
 
 /****************************************************************************
@@ -269,6 +274,7 @@ void riscv_netinitialize(void);
 uintptr_t *riscv_doirq(int irq, uintptr_t *regs);
 int riscv_exception(int mcause, void *regs, void *args);
 int riscv_misaligned(int irq, void *context, void *arg);
+int riscv_fillpage(int mcause, void *regs, void *args);
 
 /* Debug ********************************************************************/
 
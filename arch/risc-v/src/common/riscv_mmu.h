@@ -63,6 +63,10 @@
 #define PTE_A                   (1 << 6) /* Page has been accessed */
 #define PTE_D                   (1 << 7) /* Page is dirty */
 
+/* Software bits of the PTE (RSW) */
+
+#define PTE_DEMAND              (1 << 8) /* Invalid, populated on fault */
+
 /* Check if leaf PTE entry or not (if X/W/R are set it is) */
 
 #define PTE_LEAF_MASK           (7 << 1)
@@ -170,6 +174,29 @@ static inline void mmu_write_satp(uintptr_t reg)
     );
 }
 
+/****************************************************************************
+ * Name: mmu_switch_satp
+ *
+ * Description:
+ *   Write satp without flushing the TLB.  This is only safe if the ASID of
+ *   the new value tags no stale translations.
+ *
+ * Input Parameters:
+ *   reg - satp value
+ *
+ ****************************************************************************/
+
+static inline void mmu_switch_satp(uintptr_t reg)
+{
+  __asm__ __volatile__
+    (
+      "csrw satp, %0\n"
+      :
+      : "rK" (reg)
+      : "memory"
+    );
+}
+
 /****************************************************************************
  * Name: mmu_read_satp
  *
@@ -211,7 +238,7 @@ static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
 {
   __asm__ __volatile__
     (
-      "sfence.vma x0, %0\n"
+      "sfence.vma %0, x0\n"
       :
       : "rK" (vaddr)
       : "memory"
@@ -26,6 +26,7 @@
 #include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 
 #include <dirent.h>
 #include <stdio.h>
@@ -398,6 +399,36 @@ int host_ftruncate(int fd, nuttx_off_t length)
   return ret;
 }
 
+/****************************************************************************
+ * Name: host_mmap
+ ****************************************************************************/
+
+void *host_mmap(int fd, nuttx_size_t length, int writable)
+{
+  void *addr;
+
+  /* Map the file shared, so that the mapping and the file stay in sync */
+
+  addr = mmap(NULL, length, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+              MAP_SHARED, fd, 0);
+  return addr == MAP_FAILED ? NULL : addr;
+}
+
+/****************************************************************************
+ * Name: host_munmap
+ ****************************************************************************/
+
+int host_munmap(void *addr, nuttx_size_t length)
+{
+  int ret = munmap(addr, length);
+  if (ret < 0)
+    {
+      ret = -errno;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: host_opendir
  ****************************************************************************/
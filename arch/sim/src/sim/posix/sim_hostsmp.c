@@ -29,6 +29,7 @@
 #include <signal.h>
 #include <sched.h>
 #include <errno.h>
+#include <unistd.h>
 
 #include "sim_internal.h"
 
@@ -78,7 +79,6 @@ static pthread_t     g_cpu_thread[CONFIG_SMP_NCPUS];
 static void *sim_idle_trampoline(void *arg)
 {
   struct sim_cpuinfo_s *cpuinfo = (struct sim_cpuinfo_s *)arg;
-  uint64_t now = 0;
   int ret;
 
   /* Set the CPU number for the CPU thread */
@@ -106,14 +106,14 @@ static void *sim_idle_trampoline(void *arg)
 
   host_cpu_started();
 
-  /* The idle Loop */
+  /* The idle Loop.  The timer runs on CPU0, and the work of this CPU is
+   * started by the IPIs, whose handler switches the context:  There is
+   * nothing to poll, so sleep until the next signal instead of every tick.
+   */
 
   for (; ; )
     {
-      /* Wait a bit so that the timing is close to the correct rate. */
-
-      now += 1000 * CONFIG_USEC_PER_TICK;
-      host_sleepuntil(now);
+      pause();
     }
 
   return NULL;
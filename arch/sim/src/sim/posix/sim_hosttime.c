@@ -77,12 +77,20 @@ void host_sleep(uint64_t nsec)
 
 void host_sleepuntil(uint64_t nsec)
 {
+  struct timespec ts;
   uint64_t now;
 
+  /* nanosleep() is not limited to one second like usleep() and returns
+   * early when a host signal is delivered.
+   */
+
   now = host_gettime(false);
   if (nsec > now + 1000)
     {
-      usleep((nsec - now) / 1000);
+      nsec      -= now;
+      ts.tv_sec  = nsec / 1000000000;
+      ts.tv_nsec = nsec % 1000000000;
+      nanosleep(&ts, NULL);
     }
 }
 
@@ -64,7 +64,9 @@
 #include <sys/uio.h>
 #include <sys/socket.h>
 
+#include <errno.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -268,6 +270,18 @@ void sim_tapdev_init(int devidx, void *priv,
       sim_netdriver_setmtu(devidx, ifr.ifr_mtu);
     }
 
+  /* Read without blocking, and raise SIGIO (sim_tapdev_irq()) when frames
+   * arrive, so that they are received at once instead of at the next poll
+   * of the device.
+   */
+
+  ret = fcntl(tapdevfd, F_GETFL);
+  if (ret < 0 || fcntl(tapdevfd, F_SETOWN, getpid()) < 0 ||
+      fcntl(tapdevfd, F_SETFL, ret | O_NONBLOCK | O_ASYNC) < 0)
+    {
+      syslog(LOG_WARNING, "TAPDEV: can't signal the frames: %d\n", -errno);
+    }
+
   gtapdevfd[devidx] = tapdevfd;
   g_priv[devidx] = priv;
 
@@ -312,15 +326,23 @@ unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
 {
   int ret;
 
-  if (!sim_tapdev_avail(devidx))
+  /* We can't do anything if we failed to open the tap device */
+
+  if (gtapdevfd[devidx] < 0)
     {
       return 0;
     }
 
+  /* The device does not block, so no select() is needed first */
+
   ret = read(gtapdevfd[devidx], buf, buflen);
   if (ret < 0)
     {
-      syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -ret);
+      if (errno != EAGAIN)
+        {
+          syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -errno);
+        }
+
       return 0;
     }
 
@@ -372,6 +394,11 @@ void sim_tapdev_send(int devidx, unsigned char *buf, unsigned int buflen)
     }
 }
 
+int sim_tapdev_irq(void)
+{
+  return SIGIO;
+}
+
 void sim_tapdev_ifup(int devidx, void *ifaddr)
 {
   struct ifreq ifr;
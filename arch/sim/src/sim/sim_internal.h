@@ -271,6 +271,7 @@ unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
 void sim_tapdev_send(int devidx, unsigned char *buf, unsigned int buflen);
 void sim_tapdev_ifup(int devidx, void *ifaddr);
 void sim_tapdev_ifdown(int devidx);
+int sim_tapdev_irq(void);
 
 #  define sim_netdev_init(idx,priv,txcb,rxcb) sim_tapdev_init(idx,priv,txcb,rxcb)
 #  define sim_netdev_avail(idx)               sim_tapdev_avail(idx)
@@ -278,6 +279,7 @@ void sim_tapdev_ifdown(int devidx);
 #  define sim_netdev_send(idx,buf,buflen)     sim_tapdev_send(idx,buf,buflen)
 #  define sim_netdev_ifup(idx,ifaddr)         sim_tapdev_ifup(idx,ifaddr)
 #  define sim_netdev_ifdown(idx)              sim_tapdev_ifdown(idx)
+#  define sim_netdev_irq()                    sim_tapdev_irq()
 #endif
 
 /* sim_wpcap.c **************************************************************/
@@ -63,6 +63,7 @@
 #include <string.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/net/net.h>
@@ -346,6 +347,16 @@ static void netdriver_rxready_interrupt(void *priv)
     }
 }
 
+#ifdef sim_netdev_irq
+/* The host raises this interrupt when frames arrive on any device */
+
+static int netdriver_rx_interrupt(int irq, void *context, void *arg)
+{
+  sim_netdriver_loop();
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -355,6 +366,13 @@ int sim_netdriver_init(void)
   struct net_driver_s *dev;
   int devidx;
 
+#ifdef sim_netdev_irq
+  /* Attach the receive interrupt before the devices can raise it */
+
+  irq_attach(sim_netdev_irq(), netdriver_rx_interrupt, NULL);
+  up_enable_irq(sim_netdev_irq());
+#endif
+
   for (devidx = 0; devidx < CONFIG_SIM_NETDEV_NUMBER; devidx++)
     {
       dev = &g_sim_dev[devidx];
@@ -39,6 +39,14 @@
 
 #include "sim_internal.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The longest sleep of the IDLE loop if no alarm is pending */
+
+#define SIM_TIMER_MAXSLEEP  NSEC_PER_SEC
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,6 +95,12 @@ static int sim_current(struct oneshot_lowerhalf_s *lower,
 
 static sq_queue_t g_oneshot_list;
 
+#if defined(CONFIG_SIM_WALLTIME_SLEEP) && defined(CONFIG_SMP)
+/* The end of the current sleep of the IDLE loop of CPU0 */
+
+static volatile uint64_t g_sleep_until;
+#endif
+
 /* Lower half operations */
 
 static const struct oneshot_operations_s g_oneshot_ops =
@@ -141,6 +155,43 @@ static void sim_timer_update_internal(void)
     }
 }
 
+#ifdef CONFIG_SIM_WALLTIME_SLEEP
+/****************************************************************************
+ * Name: sim_timer_next
+ *
+ * Description:
+ *   Return the host time of the earliest pending alarm, at most
+ *   SIM_TIMER_MAXSLEEP from now.
+ *
+ ****************************************************************************/
+
+static uint64_t sim_timer_next(void)
+{
+  struct sim_oneshot_lowerhalf_s *priv;
+  sq_entry_t *entry;
+  uint64_t next;
+  uint64_t nsec;
+
+  next = host_gettime(false) + SIM_TIMER_MAXSLEEP;
+
+  for (entry = sq_peek(&g_oneshot_list); entry; entry = sq_next(entry))
+    {
+      priv = container_of(entry, struct sim_oneshot_lowerhalf_s, link);
+      if (priv->callback)
+        {
+          nsec = (uint64_t)priv->alarm.tv_sec * NSEC_PER_SEC +
+                 priv->alarm.tv_nsec;
+          if (nsec < next)
+            {
+              next = nsec;
+            }
+        }
+    }
+
+  return next;
+}
+#endif
+
 /****************************************************************************
  * Name: sim_process_tick
  *
@@ -253,6 +304,19 @@ static int sim_start(struct oneshot_lowerhalf_s *lower,
   priv->callback = callback;
   priv->arg      = arg;
 
+#if defined(CONFIG_SIM_WALLTIME_SLEEP) && defined(CONFIG_SMP)
+  /* The IDLE loop of CPU0 sleeps until the earliest alarm.  Wake it up
+   * with an IPI if another CPU sets an earlier one.
+   */
+
+  if (up_cpu_index() != 0 &&
+      (uint64_t)priv->alarm.tv_sec * NSEC_PER_SEC + priv->alarm.tv_nsec <
+      g_sleep_until)
+    {
+      host_send_ipi(0);
+    }
+#endif
+
   return OK;
 }
 
@@ -437,14 +501,36 @@ void up_timer_initialize(void)
 
 void sim_timer_update(void)
 {
+#ifdef CONFIG_SIM_WALLTIME_SLEEP
+  uint64_t until;
+
+  /* Sleep until the earliest alarm instead of waking up every tick, which
+   * matters in the tickless mode.  A host signal (an interrupt or an IPI)
+   * ends the sleep early.
+   */
+
+#ifdef CONFIG_SMP
+  g_sleep_until = UINT64_MAX;
+#endif
+
+  until = sim_timer_next();
+#ifdef CONFIG_SMP
+  g_sleep_until = until;
+#endif
+
+  host_sleepuntil(until);
+
+#ifdef CONFIG_SMP
+  g_sleep_until = 0;
+#endif
+
+  sim_timer_update_internal();
+#else
   static uint64_t until;
 
   /* Wait a bit so that the timing is close to the correct rate. */
 
   until += NSEC_PER_TICK;
   host_sleepuntil(until);
-
-#ifdef CONFIG_SIM_WALLTIME_SLEEP
-  sim_timer_update_internal();
 #endif
 }
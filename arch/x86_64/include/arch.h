@@ -49,6 +49,24 @@
  * Inline functions
  ****************************************************************************/
 
+/* The FS base holds TLS_THREAD_POINTER() of the running thread.  It changes
+ * only across a context switch, which the thread does not see, so the
+ * read is not volatile and may be merged.
+ */
+
+#if defined(CONFIG_TLS_REGISTER) && !defined(__KERNEL__) && \
+    !defined(__ASSEMBLY__)
+static inline uintptr_t x86_64_tls_pointer(void)
+{
+  uintptr_t tp;
+
+  __asm__ ("rdfsbase %0" : "=r"(tp));
+  return tp;
+}
+
+#  define up_tls_info() ((FAR struct tls_info_s *)x86_64_tls_pointer() - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/tls.h>
 #include <arch/arch.h>
 
 #include "x86_64_internal.h"
@@ -77,6 +78,12 @@ void up_initial_state(struct tcb_s *tcb)
       tcb->stack_alloc_ptr = stack_ptr;
       tcb->stack_base_ptr  = stack_ptr;
       tcb->adj_stack_size  = CONFIG_IDLETHREAD_STACKSIZE;
+
+#ifdef CONFIG_TLS_REGISTER
+      /* The IDLE thread is already running: Load its thread pointer */
+
+      write_fsbase(TLS_THREAD_POINTER(tcb));
+#endif
     }
 
   /* Initialize the initial exception register context structure */
@@ -28,6 +28,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/tls.h>
 
 #include <arch/arch.h>
 #include <arch/irq.h>
@@ -53,4 +54,10 @@ void x86_64_restore_auxstate(struct tcb_s *rtcb)
   /* Set PCID, avoid TLB flush */
 
   set_pcid(rtcb->pid);
+
+#ifdef CONFIG_TLS_REGISTER
+  /* Load the thread pointer of the thread that is switched in */
+
+  write_fsbase(TLS_THREAD_POINTER(rtcb));
+#endif
 }
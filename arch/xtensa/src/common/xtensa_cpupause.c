@@ -117,8 +117,8 @@ int up_cpu_paused(int cpu)
 
   /* Wait for the spinlock to be released */
 
-  spin_unlock(&g_cpu_paused[cpu]);
-  spin_lock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
 
   /* Restore the exception context of the tcb at the (new) head of the
    * assigned task list.
@@ -142,7 +142,7 @@ int up_cpu_paused(int cpu)
 
   xtensa_restorestate(tcb->xcp.regs);
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
   return OK;
 }
 
@@ -238,8 +238,8 @@ int up_cpu_pause(int cpu)
 
   DEBUGASSERT(!spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_lock(&g_cpu_wait[cpu]);
-  spin_lock(&g_cpu_paused[cpu]);
+  spin_lock_wo_note(&g_cpu_wait[cpu]);
+  spin_lock_wo_note(&g_cpu_paused[cpu]);
 
   /* Execute the intercpu interrupt */
 
@@ -248,7 +248,7 @@ int up_cpu_pause(int cpu)
     {
       /* What happened?  Unlock the g_cpu_wait spinlock */
 
-      spin_unlock(&g_cpu_wait[cpu]);
+      spin_unlock_wo_note(&g_cpu_wait[cpu]);
     }
   else
     {
@@ -256,10 +256,10 @@ int up_cpu_pause(int cpu)
        * it is fully paused and ready for up_cpu_resume();
        */
 
-      spin_lock(&g_cpu_paused[cpu]);
+      spin_lock_wo_note(&g_cpu_paused[cpu]);
     }
 
-  spin_unlock(&g_cpu_paused[cpu]);
+  spin_unlock_wo_note(&g_cpu_paused[cpu]);
 
   /* On successful return g_cpu_wait will be locked, the other CPU will be
    * spinning on g_cpu_wait and will not continue until g_cpu_resume() is
@@ -306,7 +306,7 @@ int up_cpu_resume(int cpu)
   DEBUGASSERT(spin_islocked(&g_cpu_wait[cpu]) &&
               !spin_islocked(&g_cpu_paused[cpu]));
 
-  spin_unlock(&g_cpu_wait[cpu]);
+  spin_unlock_wo_note(&g_cpu_wait[cpu]);
   return OK;
 }
 
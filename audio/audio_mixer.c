@@ -0,0 +1,1259 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A software mixer in front of one output device.  Each stream device is a
+ * lower half of its own; the buffers enqueued to it are resampled to the
+ * rate of the output with a polyphase filter, scaled by the volume of the
+ * stream and summed into 32-bit accumulators, which are saturated into the
+ * buffers of the output when the output device hands one back.
+ *
+ * The output is started with the first stream and keeps running, with
+ * silence, as long as a stream is reserved, so that a client that starts
+ * again does not wait for the device.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The polyphase filter of the resampler: AUDIO_MIXER_NPHASES fractional
+ * positions between two input frames, AUDIO_MIXER_NTAPS taps each.
+ */
+
+#define AUDIO_MIXER_NTAPS       8
+#define AUDIO_MIXER_NPHASES     32
+#define AUDIO_MIXER_PHASESHIFT  (16 - 5)
+
+/* Positions and gains are fixed point.  The gains are Q12, so that the
+ * 32-bit accumulators hold the sum of 16 streams at full scale.
+ */
+
+#define AUDIO_MIXER_ONE         (1 << 16)   /* One input frame */
+#define AUDIO_MIXER_GAINSHIFT   12
+#define AUDIO_MIXER_UNITY       (1 << AUDIO_MIXER_GAINSHIFT)
+
+#define AUDIO_MIXER_MAXCHANNELS 2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* One stream device */
+
+struct audio_mixer_stream_s
+{
+  /* This is our appearance to the upper half.  It *MUST* be the first
+   * element so that we can freely cast between the two types.
+   */
+
+  struct audio_lowerhalf_s dev;
+
+  FAR struct audio_mixer_s *mixer;
+  struct dq_queue_s pending;        /* Buffers waiting to be mixed */
+  uint32_t samprate;                /* Sample rate of the stream */
+  uint32_t step;                    /* Input frames per output frame */
+  uint32_t pos;                     /* Position past the oldest frame */
+  int32_t volume;                   /* Volume, Q12 */
+  int32_t gain;                     /* Volume, or zero while muted */
+  uint8_t nchannels;                /* Channels of the stream */
+  uint8_t widx;                     /* The oldest frame of the window */
+  bool reserved;
+  bool running;
+  bool paused;
+  bool muted;
+
+  /* The last input frames, stored twice so that the window of the filter
+   * is contiguous wherever it starts
+   */
+
+  int16_t win[AUDIO_MIXER_MAXCHANNELS][2 * AUDIO_MIXER_NTAPS];
+};
+
+/* The mixer and its output */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;                /* The session of the output */
+#endif
+  mutex_t lock;                     /* Serializes start and release */
+  FAR struct ap_buffer_s **outapb;  /* The buffers of the output */
+  FAR int32_t *acc;                 /* Accumulators of one buffer */
+  uint32_t inflight;                /* Buffers queued to the output */
+  uint32_t samprate;                /* Sample rate of the output */
+  uint16_t nframes;                 /* Frames per buffer */
+  uint8_t nchannels;                /* Channels of the output */
+  uint8_t nbuffers;                 /* Number of buffers */
+  uint8_t nreserved;                /* Streams reserved */
+  volatile bool started;            /* The output is running */
+  int nstreams;
+  FAR struct audio_mixer_stream_s *stream;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps);
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session);
+#endif
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session);
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                    FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  audio_mixer_cancelbuffer,  /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release        /* release        */
+};
+
+/* Kaiser-windowed sinc, beta 5, cut off at 0.9 times the Nyquist frequency
+ * of the input.  Each phase is normalized to a gain of one at DC.
+ */
+
+static const int16_t g_mixer_fir[AUDIO_MIXER_NPHASES][AUDIO_MIXER_NTAPS] =
+{
+  {    646,  -1688,   2786,  29371,   2786,  -1688,    646,    -91 },
+  {    574,  -1425,   1940,  29339,   3680,  -1955,    718,   -103 },
+  {    503,  -1168,   1142,  29224,   4617,  -2223,    789,   -116 },
+  {    433,   -918,    394,  29025,   5593,  -2489,    858,   -128 },
+  {    366,   -677,   -303,  28741,   6607,  -2751,    925,   -140 },
+  {    301,   -446,   -947,  28379,   7653,  -3007,    987,   -152 },
+  {    238,   -227,  -1537,  27936,   8727,  -3252,   1045,   -162 },
+  {    180,    -22,  -2072,  27418,   9824,  -3485,   1097,   -172 },
+  {    125,    169,  -2552,  26824,  10941,  -3701,   1142,   -180 },
+  {     75,    345,  -2976,  26160,  12071,  -3899,   1179,   -187 },
+  {     28,    506,  -3346,  25429,  13209,  -4074,   1207,   -191 },
+  {    -13,    650,  -3662,  24635,  14349,  -4223,   1225,   -193 },
+  {    -51,    778,  -3925,  23784,  15487,  -4344,   1231,   -192 },
+  {    -83,    889,  -4136,  22877,  16616,  -4433,   1225,   -187 },
+  {   -111,    984,  -4297,  21923,  17730,  -4487,   1206,   -180 },
+  {   -135,   1063,  -4411,  20927,  18823,  -4503,   1173,   -169 },
+  {   -154,   1126,  -4479,  19891,  19891,  -4479,   1126,   -154 },
+  {   -169,   1173,  -4503,  18823,  20927,  -4411,   1063,   -135 },
+  {   -180,   1206,  -4487,  17730,  21923,  -4297,    984,   -111 },
+  {   -187,   1225,  -4433,  16616,  22877,  -4136,    889,    -83 },
+  {   -192,   1231,  -4344,  15487,  23784,  -3925,    778,    -51 },
+  {   -193,   1225,  -4223,  14349,  24635,  -3662,    650,    -13 },
+  {   -191,   1207,  -4074,  13209,  25429,  -3346,    506,     28 },
+  {   -187,   1179,  -3899,  12071,  26160,  -2976,    345,     75 },
+  {   -180,   1142,  -3701,  10941,  26824,  -2552,    169,    125 },
+  {   -172,   1097,  -3485,   9824,  27418,  -2072,    -22,    180 },
+  {   -162,   1045,  -3252,   8727,  27936,  -1537,   -227,    238 },
+  {   -152,    987,  -3007,   7653,  28379,   -947,   -446,    301 },
+  {   -140,    925,  -2751,   6607,  28741,   -303,   -677,    366 },
+  {   -128,    858,  -2489,   5593,  29025,    394,   -918,    433 },
+  {   -116,    789,  -2223,   4617,  29224,   1142,  -1168,    503 },
+  {   -103,    718,  -1955,   3680,  29339,   1940,  -1425,    574 },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_notify
+ *
+ * Description:
+ *   Report a buffer or the end of a stream to the upper half of a stream.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_notify(FAR struct audio_mixer_stream_s *stream,
+                               uint16_t reason, FAR struct ap_buffer_s *apb)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  stream->dev.upper(stream->dev.priv, reason, apb, OK, stream);
+#else
+  stream->dev.upper(stream->dev.priv, reason, apb, OK);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_retire
+ *
+ * Description:
+ *   Return the oldest buffer of a stream, which has been mixed, to its
+ *   upper half.  The stream stops after its final buffer.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_retire(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+
+  apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pending);
+  audio_mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+
+  if ((apb->flags & AUDIO_APB_FINAL) != 0)
+    {
+      stream->running = false;
+      audio_mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_add
+ *
+ * Description:
+ *   Add nframes frames of a stream that runs at the rate of the output to
+ *   the accumulators.  The loops have no dependency between iterations,
+ *   so that the compiler can vectorize them.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_add(FAR int32_t *acc, FAR const int16_t *src,
+                            uint32_t nframes, uint8_t inch, uint8_t outch,
+                            int32_t gain)
+{
+  uint32_t i;
+
+  if (inch == outch)
+    {
+      for (i = 0; i < nframes * outch; i++)
+        {
+          acc[i] += src[i] * gain;
+        }
+    }
+  else if (inch == 1)
+    {
+      for (i = 0; i < nframes; i++)
+        {
+          acc[2 * i]     += src[i] * gain;
+          acc[2 * i + 1] += src[i] * gain;
+        }
+    }
+  else
+    {
+      for (i = 0; i < nframes; i++)
+        {
+          acc[i] += ((src[2 * i] + src[2 * i + 1]) * gain) >> 1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_direct
+ *
+ * Description:
+ *   Mix a stream at the rate of the output, straight from its buffers.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_direct(FAR struct audio_mixer_s *mixer,
+                               FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  uint32_t framebytes = stream->nchannels * sizeof(int16_t);
+  uint32_t nframes = 0;
+  uint32_t count;
+
+  while (nframes < mixer->nframes && stream->running)
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pending);
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      count = (apb->nbytes - apb->curbyte) / framebytes;
+      if (count > mixer->nframes - nframes)
+        {
+          count = mixer->nframes - nframes;
+        }
+
+      audio_mixer_add(mixer->acc + nframes * mixer->nchannels,
+                      (FAR const int16_t *)(apb->samp + apb->curbyte),
+                      count, stream->nchannels, mixer->nchannels,
+                      stream->gain);
+
+      nframes      += count;
+      apb->curbyte += count * framebytes;
+      if (apb->nbytes - apb->curbyte < framebytes)
+        {
+          audio_mixer_retire(stream);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_push
+ *
+ * Description:
+ *   Move the next input frame of a stream into the window of its filter.
+ *   Return false if the stream has no more data.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_push(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const int16_t *src;
+  uint32_t framebytes = stream->nchannels * sizeof(int16_t);
+  int c;
+
+  apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pending);
+  if (apb == NULL || !stream->running)
+    {
+      return false;
+    }
+
+  src = (FAR const int16_t *)(apb->samp + apb->curbyte);
+  for (c = 0; c < stream->nchannels; c++)
+    {
+      stream->win[c][stream->widx] = src[c];
+      stream->win[c][stream->widx + AUDIO_MIXER_NTAPS] = src[c];
+    }
+
+  stream->widx = (stream->widx + 1) % AUDIO_MIXER_NTAPS;
+
+  apb->curbyte += framebytes;
+  if (apb->nbytes - apb->curbyte < framebytes)
+    {
+      audio_mixer_retire(stream);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resample
+ *
+ * Description:
+ *   Mix a stream at another rate than the output.  Each output frame is
+ *   interpolated from the window of the last AUDIO_MIXER_NTAPS input
+ *   frames with the phase of the filter nearest to its position, which
+ *   delays the stream by AUDIO_MIXER_NTAPS / 2 input frames.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_resample(FAR struct audio_mixer_s *mixer,
+                                 FAR struct audio_mixer_stream_s *stream)
+{
+  FAR const int16_t *h;
+  FAR const int16_t *w;
+  FAR int32_t *acc = mixer->acc;
+  int32_t y[AUDIO_MIXER_MAXCHANNELS];
+  int32_t sum;
+  uint32_t f;
+  int c;
+  int k;
+
+  for (f = 0; f < mixer->nframes; f++)
+    {
+      while (stream->pos >= AUDIO_MIXER_ONE)
+        {
+          if (!audio_mixer_push(stream))
+            {
+              return;
+            }
+
+          stream->pos -= AUDIO_MIXER_ONE;
+        }
+
+      h = g_mixer_fir[stream->pos >> AUDIO_MIXER_PHASESHIFT];
+      for (c = 0; c < stream->nchannels; c++)
+        {
+          w   = &stream->win[c][stream->widx];
+          sum = 0;
+          for (k = 0; k < AUDIO_MIXER_NTAPS; k++)
+            {
+              sum += h[k] * w[k];
+            }
+
+          y[c] = sum >> 15;
+        }
+
+      if (stream->nchannels == mixer->nchannels)
+        {
+          for (c = 0; c < mixer->nchannels; c++)
+            {
+              *acc++ += y[c] * stream->gain;
+            }
+        }
+      else if (stream->nchannels == 1)
+        {
+          *acc++ += y[0] * stream->gain;
+          *acc++ += y[0] * stream->gain;
+        }
+      else
+        {
+          *acc++ += ((y[0] + y[1]) * stream->gain) >> 1;
+        }
+
+      stream->pos += stream->step;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fill
+ *
+ * Description:
+ *   Mix the running streams into a buffer of the output and queue it.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_fill(FAR struct audio_mixer_s *mixer, int i)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct audio_mixer_stream_s *stream;
+  FAR struct ap_buffer_s *apb = mixer->outapb[i];
+  FAR int16_t *out = (FAR int16_t *)apb->samp;
+  uint32_t nsamples = mixer->nframes * mixer->nchannels;
+  uint32_t n;
+  irqstate_t flags;
+  int32_t v;
+  int ret;
+  int s;
+
+  flags = enter_critical_section();
+
+  memset(mixer->acc, 0, nsamples * sizeof(int32_t));
+
+  for (s = 0; s < mixer->nstreams; s++)
+    {
+      stream = &mixer->stream[s];
+      if (!stream->running || stream->paused)
+        {
+          continue;
+        }
+
+      if (stream->step == AUDIO_MIXER_ONE)
+        {
+          audio_mixer_direct(mixer, stream);
+        }
+      else
+        {
+          audio_mixer_resample(mixer, stream);
+        }
+    }
+
+  leave_critical_section(flags);
+
+  for (n = 0; n < nsamples; n++)
+    {
+      v = mixer->acc[n] >> AUDIO_MIXER_GAINSHIFT;
+      out[n] = v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v;
+    }
+
+  apb->nbytes  = nsamples * sizeof(int16_t);
+  apb->curbyte = 0;
+  apb->flags   = 0;
+
+  ret = lower->ops->enqueuebuffer(lower, apb);
+  if (ret >= 0)
+    {
+      mixer->inflight |= 1 << i;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   The callback of the output device.  Each buffer it hands back is
+ *   mixed again and queued at once.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status, FAR void *session)
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  int ret;
+  int i;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        for (i = 0; i < mixer->nbuffers; i++)
+          {
+            if (mixer->outapb[i] == apb)
+              {
+                break;
+              }
+          }
+
+        DEBUGASSERT(i < mixer->nbuffers);
+        mixer->inflight &= ~(1 << i);
+
+        if (mixer->started)
+          {
+            ret = audio_mixer_fill(mixer, i);
+            if (ret < 0)
+              {
+                auderr("ERROR: Failed to queue the output: %d\n", ret);
+              }
+          }
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        auderr("ERROR: I/O error on the output: %d\n", status);
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_startoutput
+ *
+ * Description:
+ *   Start the output with the first stream.  The mixer lock is held.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_startoutput(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+  int i;
+
+  if (mixer->started)
+    {
+      return OK;
+    }
+
+  mixer->started = true;
+  for (i = 0; i < mixer->nbuffers && ret >= 0; i++)
+    {
+      if ((mixer->inflight & (1 << i)) == 0)
+        {
+          ret = audio_mixer_fill(mixer, i);
+        }
+    }
+
+  if (ret >= 0)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->start(lower, mixer->session);
+#else
+      ret = lower->ops->start(lower);
+#endif
+    }
+
+  if (ret < 0)
+    {
+      mixer->started = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stopoutput
+ *
+ * Description:
+ *   Stop the output when no stream is reserved.  The mixer lock is held.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stopoutput(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+  if (!mixer->started || mixer->nreserved > 0)
+    {
+      return;
+    }
+
+  mixer->started = false;
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  lower->ops->stop(lower, mixer->session);
+#else
+  lower->ops->stop(lower);
+#endif
+#else
+  UNUSED(lower);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_flush
+ *
+ * Description:
+ *   Return the buffers of a stream that were not mixed and end it.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  bool running;
+
+  flags = enter_critical_section();
+
+  running = stream->running;
+  stream->running = false;
+
+  while ((apb = (FAR struct ap_buffer_s *)
+                dq_remfirst(&stream->pending)) != NULL)
+    {
+      audio_mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  if (running)
+    {
+      audio_mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_channels = AUDIO_MIXER_MAXCHANNELS;
+            caps->ac_controls.hw[0] =
+              AUDIO_SAMP_RATE_8K   | AUDIO_SAMP_RATE_11K  |
+              AUDIO_SAMP_RATE_16K  | AUDIO_SAMP_RATE_22K  |
+              AUDIO_SAMP_RATE_32K  | AUDIO_SAMP_RATE_44K  |
+              AUDIO_SAMP_RATE_48K  | AUDIO_SAMP_RATE_96K;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_MUTE | AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Set the format of a stream, or its volume, 0 to 1000, or muting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps)
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t samprate;
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(caps != NULL);
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0] | (caps->ac_controls.b[3] << 16);
+        if (stream->running || samprate == 0 ||
+            caps->ac_channels < 1 ||
+            caps->ac_channels > AUDIO_MIXER_MAXCHANNELS ||
+            caps->ac_controls.b[2] != 16)
+          {
+            return -EINVAL;
+          }
+
+        flags = enter_critical_section();
+        stream->samprate  = samprate;
+        stream->nchannels = caps->ac_channels;
+        stream->step      = ((uint64_t)samprate << 16) / mixer->samprate;
+        stream->pos       = 0;
+        stream->widx      = 0;
+        memset(stream->win, 0, sizeof(stream->win));
+        leave_critical_section(flags);
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        switch (caps->ac_format.hw)
+          {
+            case AUDIO_FU_VOLUME:
+              if (caps->ac_controls.hw[0] > 1000)
+                {
+                  return -EDOM;
+                }
+
+              stream->volume = caps->ac_controls.hw[0] *
+                               AUDIO_MIXER_UNITY / 1000;
+              stream->gain   = stream->muted ? 0 : stream->volume;
+              break;
+
+            case AUDIO_FU_MUTE:
+
+              /* A muted stream is still consumed, at a gain of zero */
+
+              stream->muted = caps->ac_controls.b[0] != 0;
+              stream->gain  = stream->muted ? 0 : stream->volume;
+              break;
+
+            default:
+              ret = -ENOTTY;
+              break;
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  audio_mixer_flush((FAR struct audio_mixer_stream_s *)dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing a stream, and the output with the first stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret;
+
+  if (stream->samprate == 0)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&mixer->lock);
+
+  stream->paused  = false;
+  stream->running = true;
+
+  ret = audio_mixer_startoutput(mixer);
+  if (ret < 0)
+    {
+      stream->running = false;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  audio_mixer_flush((FAR struct audio_mixer_stream_s *)dev);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause and audio_mixer_resume
+ *
+ * Description:
+ *   A paused stream keeps its buffers and is left out of the mix.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  ((FAR struct audio_mixer_stream_s *)dev)->paused = true;
+  return OK;
+}
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session)
+#else
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  ((FAR struct audio_mixer_stream_s *)dev)->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  irqstate_t flags;
+
+  DEBUGASSERT(apb != NULL);
+
+  apb->curbyte = 0;
+
+  flags = enter_critical_section();
+  dq_addlast(&apb->dq_entry, &stream->pending);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_cancelbuffer
+ ****************************************************************************/
+
+static int audio_mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                    FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR dq_entry_t *entry;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = enter_critical_section();
+
+  for (entry = dq_peek(&stream->pending); entry; entry = dq_next(entry))
+    {
+      if (entry == &apb->dq_entry)
+        {
+          dq_rem(entry, &stream->pending);
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve
+ *
+ * Description:
+ *   Reserve a stream for one client.  The volume is reset to 1000.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session)
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+      stream->muted    = false;
+      stream->volume   = AUDIO_MIXER_UNITY;
+      stream->gain     = AUDIO_MIXER_UNITY;
+      mixer->nreserved++;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session = stream;
+#endif
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_release
+ *
+ * Description:
+ *   Release a stream, and stop the output with the last one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session)
+#else
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  audio_mixer_flush(stream);
+
+  nxmutex_lock(&mixer->lock);
+
+  if (stream->reserved)
+    {
+      stream->reserved  = false;
+      stream->samprate  = 0;
+      mixer->nreserved--;
+      audio_mixer_stopoutput(mixer);
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_setup
+ *
+ * Description:
+ *   Reserve and configure the output and allocate its buffers.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_setup(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_buf_desc_s desc;
+  struct audio_caps_s caps;
+  int ret;
+  int i;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->reserve(lower, &mixer->session);
+#else
+  ret = lower->ops->reserve(lower);
+#endif
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len            = sizeof(caps);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = mixer->nchannels;
+  caps.ac_controls.hw[0] = mixer->samprate & 0xffff;
+  caps.ac_controls.b[2]  = 16;
+  caps.ac_controls.b[3]  = mixer->samprate >> 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, mixer->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < mixer->nbuffers; i++)
+    {
+      memset(&desc, 0, sizeof(desc));
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      desc.session   = mixer->session;
+#endif
+      desc.numbytes  = mixer->nframes * mixer->nchannels * sizeof(int16_t);
+      desc.u.pbuffer = &mixer->outapb[i];
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &desc);
+        }
+      else
+        {
+          ret = apb_alloc(&desc);
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Share an output audio device between several clients.  See
+ *   include/nuttx/audio/audio_mixer.h.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           FAR const struct audio_mixer_config_s *config,
+                           int nstreams)
+{
+  FAR struct audio_mixer_s *mixer;
+  FAR struct audio_mixer_stream_s *stream;
+  char path[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && lower != NULL && config != NULL);
+
+  if (nstreams < 1 || config->samprate == 0 || config->nframes == 0 ||
+      config->nchannels < 1 ||
+      config->nchannels > AUDIO_MIXER_MAXCHANNELS ||
+      config->nbuffers < 2 || config->nbuffers > 32)
+    {
+      return -EINVAL;
+    }
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mixer->lower     = lower;
+  mixer->samprate  = config->samprate;
+  mixer->nframes   = config->nframes;
+  mixer->nchannels = config->nchannels;
+  mixer->nbuffers  = config->nbuffers;
+  mixer->nstreams  = nstreams;
+  nxmutex_init(&mixer->lock);
+
+  mixer->outapb = kmm_zalloc(config->nbuffers *
+                             sizeof(FAR struct ap_buffer_s *));
+  mixer->acc    = kmm_malloc(config->nframes * config->nchannels *
+                             sizeof(int32_t));
+  mixer->stream = kmm_zalloc(nstreams *
+                             sizeof(struct audio_mixer_stream_s));
+  if (mixer->outapb == NULL || mixer->acc == NULL || mixer->stream == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  lower->upper = audio_mixer_callback;
+  lower->priv  = mixer;
+
+  ret = audio_mixer_setup(mixer);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to set up the output: %d\n", ret);
+      goto errout;
+    }
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream          = &mixer->stream[i];
+      stream->dev.ops = &g_audio_mixer_ops;
+      stream->mixer   = mixer;
+      dq_init(&stream->pending);
+
+      snprintf(path, sizeof(path), "%s%d", name, i);
+      ret = audio_register(path, &stream->dev);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", path, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+
+errout:
+  for (i = 0; mixer->outapb != NULL && i < mixer->nbuffers; i++)
+    {
+      if (mixer->outapb[i] != NULL)
+        {
+          apb_free(mixer->outapb[i]);
+        }
+    }
+
+  kmm_free(mixer->stream);
+  kmm_free(mixer->acc);
+  kmm_free(mixer->outapb);
+  nxmutex_destroy(&mixer->lock);
+  kmm_free(mixer);
+  return ret;
+}
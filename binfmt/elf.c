@@ -31,6 +31,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/streams.h>
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/binfmt/elf.h>
 
@@ -94,6 +95,12 @@ static struct binfmt_s g_elfbinfmt =
 #endif
 };
 
+#ifdef CONFIG_ELF_COREDUMP_LZF
+/* Compresses the core dump.  Not on the stack:  The state is large */
+
+static struct lib_lzfoutstream_s g_elf_lzfstream;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -322,6 +329,11 @@ static int elf_dumpbinary(FAR struct memory_region_s *regions,
 {
   struct elf_dumpinfo_s dumpinfo;
 
+#ifdef CONFIG_ELF_COREDUMP_LZF
+  lib_lzfoutstream(&g_elf_lzfstream, stream);
+  stream = &g_elf_lzfstream.public;
+#endif
+
   dumpinfo.regions = regions;
   dumpinfo.stream  = stream;
 
@@ -35,6 +35,7 @@
 #include <nuttx/elf.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/binfmt.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/sched.h>
 #include <sched/sched.h>
 
@@ -95,20 +96,18 @@ static int elf_emit(FAR struct elf_dumpinfo_s *cinfo,
 }
 
 /****************************************************************************
- * Name: elf_emit_align
+ * Name: elf_emit_zero
  *
  * Description:
- *   Align the filled data according to the current offset
+ *   Send len zero bytes to binfmt_outstream_s
  *
  ****************************************************************************/
 
-static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+static off_t elf_emit_zero(FAR struct elf_dumpinfo_s *cinfo, off_t len)
 {
-  off_t align = ROUNDUP(cinfo->stream->nput,
-                        ELF_PAGESIZE) - cinfo->stream->nput;
   unsigned char null[256];
-  off_t total = align;
-  off_t ret;
+  off_t total = len;
+  off_t ret = 0;
 
   memset(null, 0, sizeof(null));
 
@@ -124,7 +123,105 @@ static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
       total -= ret;
     }
 
-  return ret < 0 ? ret : align;
+  return ret < 0 ? ret : len;
+}
+
+/****************************************************************************
+ * Name: elf_emit_align
+ *
+ * Description:
+ *   Align the filled data according to the current offset
+ *
+ ****************************************************************************/
+
+static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+{
+  off_t align = ROUNDUP(cinfo->stream->nput,
+                        ELF_PAGESIZE) - cinfo->stream->nput;
+
+  return elf_emit_zero(cinfo, align);
+}
+
+#ifdef CONFIG_ELF_COREDUMP_SKIPFREE
+/****************************************************************************
+ * Name: elf_nextfree
+ *
+ * Description:
+ *   Find the free heap memory with the lowest address that ends above addr
+ *
+ ****************************************************************************/
+
+static int elf_nextfree(uintptr_t addr, FAR uintptr_t *start,
+                        FAR uintptr_t *end)
+{
+  int ret = -ENOENT;
+#ifdef CONFIG_MM_KERNEL_HEAP
+  uintptr_t kstart;
+  uintptr_t kend;
+#endif
+
+#if defined(CONFIG_BUILD_FLAT) || !defined(__KERNEL__)
+  ret = mm_nextfree(g_mmheap, addr, start, end);
+#endif
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  if (mm_nextfree(g_kmmheap, addr, &kstart, &kend) == OK &&
+      (ret < 0 || kstart < *start))
+    {
+      *start = kstart;
+      *end   = kend;
+      ret    = OK;
+    }
+#endif
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: elf_emit_memory
+ *
+ * Description:
+ *   Send the memory from start to end to binfmt_outstream_s.  The free heap
+ *   memory is sent as zeros, that compress to almost nothing, instead of
+ *   its stale content.
+ *
+ ****************************************************************************/
+
+static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo,
+                            uintptr_t start, uintptr_t end)
+{
+#ifdef CONFIG_ELF_COREDUMP_SKIPFREE
+  uintptr_t freestart;
+  uintptr_t freeend;
+
+  while (start < end && elf_nextfree(start, &freestart, &freeend) == OK &&
+         freestart < end)
+    {
+      if (freestart > start)
+        {
+          if (elf_emit(cinfo, (FAR void *)start, freestart - start) < 0)
+            {
+              return;
+            }
+
+          start = freestart;
+        }
+
+      freeend = freeend < end ? freeend : end;
+      if (elf_emit_zero(cinfo, freeend - start) < 0)
+        {
+          return;
+        }
+
+      start = freeend;
+    }
+#endif
+
+  if (start < end)
+    {
+      elf_emit(cinfo, (FAR void *)start, end - start);
+    }
 }
 
 /****************************************************************************
@@ -353,9 +450,8 @@ int elf_coredump(FAR struct elf_dumpinfo_s *cinfo)
 
   for (i = 0; i < segs; i++)
     {
-      elf_emit(cinfo, (FAR void *)cinfo->regions[i].start,
-               cinfo->regions[i].end -
-               cinfo->regions[i].start);
+      elf_emit_memory(cinfo, cinfo->regions[i].start,
+                      cinfo->regions[i].end);
 
       /* Align to page */
 
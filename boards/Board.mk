@@ -26,6 +26,14 @@ CSRCS += $(ETCSRC)
 
 RCOBJS = $(RCSRCS:%=$(ETCDIR)$(DELIM)%)
 
+# The image is aligned as its file data, for these to be used in place
+
+ifneq ($(CONFIG_FS_ROMFS_XIP_ALIGN),)
+ROMFSALIGN = $(CONFIG_FS_ROMFS_XIP_ALIGN)
+else
+ROMFSALIGN = 4
+endif
+
 $(RCOBJS): $(ETCDIR)$(DELIM)%: %
 	$(Q) mkdir -p $(dir $@)
 	$(call PREPROCESS, $<, $@)
@@ -35,9 +43,14 @@ $(ETCSRC): $(addprefix $(BOARD_DIR)$(DELIM)src$(DELIM),$(RCRAWS)) $(RCOBJS)
 	  $(shell rm -rf $(ETCDIR)$(DELIM)$(raw)) \
 	  $(shell mkdir -p $(dir $(ETCDIR)$(DELIM)$(raw))) \
 	  $(shell cp -rfp $(BOARD_DIR)$(DELIM)src$(DELIM)$(raw) $(ETCDIR)$(DELIM)$(raw)))
-	$(Q) genromfs -f romfs.img -d $(ETCDIR)$(DELIM)$(CONFIG_NSH_ROMFSMOUNTPT) -V "NSHInitVol"
+	$(Q) genromfs -f romfs.img -d $(ETCDIR)$(DELIM)$(CONFIG_NSH_ROMFSMOUNTPT) -V "NSHInitVol" \
+	  $(if $(CONFIG_FS_ROMFS_XIP_ALIGN),-a $(CONFIG_FS_ROMFS_XIP_ALIGN))
+ifeq ($(CONFIG_FS_ROMFS_INDEX),y)
+	$(Q) $(MAKE) -C $(TOPDIR)$(DELIM)tools -f Makefile.host romfsindex$(HOSTEXEEXT)
+	$(Q) $(TOPDIR)$(DELIM)tools$(DELIM)romfsindex$(HOSTEXEEXT) romfs.img
+endif
 	$(Q) echo "#include <nuttx/compiler.h>" > $@
-	$(Q) xxd -i romfs.img | sed -e "s/^unsigned char/const unsigned char aligned_data(4)/g" >> $@
+	$(Q) xxd -i romfs.img | sed -e "s/^unsigned char/const unsigned char aligned_data($(ROMFSALIGN))/g" >> $@
 	$(Q) rm romfs.img
 endif
 
@@ -60,6 +60,17 @@
 
 #ifdef CONFIG_BOARDCTL
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_PM
+/* The wakeup latency that applications tolerate in each domain */
+
+static struct pm_qos_s g_boardctl_qos[CONFIG_PM_NDOMAINS];
+static bool g_boardctl_qosadded[CONFIG_PM_NDOMAINS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -266,6 +277,31 @@ static inline int boardctl_pmctrl(FAR struct boardioc_pm_ctrl_s *ctrl)
         ctrl->state = pm_checkstate(ctrl->domain);
         break;
 
+      case BOARDIOC_PM_QOS:
+        if (ctrl->domain >= CONFIG_PM_NDOMAINS)
+          {
+            ret = -EINVAL;
+          }
+        else if (ctrl->count == PM_QOS_LATENCY_ANY)
+          {
+            if (g_boardctl_qosadded[ctrl->domain])
+              {
+                pm_qos_remove(&g_boardctl_qos[ctrl->domain]);
+                g_boardctl_qosadded[ctrl->domain] = false;
+              }
+          }
+        else if (g_boardctl_qosadded[ctrl->domain])
+          {
+            pm_qos_update(&g_boardctl_qos[ctrl->domain], ctrl->count);
+          }
+        else
+          {
+            pm_qos_add(&g_boardctl_qos[ctrl->domain], ctrl->domain,
+                       ctrl->count);
+            g_boardctl_qosadded[ctrl->domain] = true;
+          }
+        break;
+
       default:
         ret = -EINVAL;
     }
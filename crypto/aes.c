@@ -31,6 +31,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <string.h>
 #include <sys/types.h>
 #include <crypto/aes.h>
@@ -842,6 +844,11 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
   add_round_key(q, skey);
 }
 
+/* The public functions below are replaced by those of aes_armv8ce.c or
+ * aes_aesni.c when the CPU has AES instructions.
+ */
+
+#if !defined(CONFIG_CRYPTO_AES_ARMV8CE) && !defined(CONFIG_CRYPTO_AES_NI)
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
@@ -964,6 +971,8 @@ void aes_decrypt(FAR AES_CTX *ctx, FAR const uint8_t *src, FAR uint8_t *dst)
   aes_decrypt_ecb(ctx, src, dst, 1);
 }
 
+#endif /* !CONFIG_CRYPTO_AES_ARMV8CE && !CONFIG_CRYPTO_AES_NI */
+
 int aes_keysetup_encrypt(FAR uint32_t *skey, FAR const uint8_t *key, int len)
 {
   unsigned r;
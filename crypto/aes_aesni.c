@@ -0,0 +1,261 @@
+/****************************************************************************
+ * crypto/aes_aesni.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The AES library of include/crypto/aes.h with the AES-NI instructions of
+ * x86_64, instead of the bitsliced implementation of aes.c, and the
+ * carry-less multiply of GHASH with PCLMULQDQ.  Both run in constant time.
+ *
+ * The context keeps the encryption round keys as bytes in sk[] and those
+ * of the equivalent inverse cipher in sk_exp[].
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <sys/types.h>
+#include <crypto/aes.h>
+
+#if !defined(__AES__) || !defined(__PCLMUL__)
+#  pragma GCC target("aes,pclmul")
+#endif
+
+#include <wmmintrin.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define AESNI_EK(ctx, i) \
+  _mm_loadu_si128((FAR const __m128i *)((FAR uint8_t *)(ctx)->sk + \
+                                        16 * (i)))
+#define AESNI_DK(ctx, i) \
+  _mm_loadu_si128((FAR const __m128i *)((FAR uint8_t *)(ctx)->sk_exp + \
+                                        16 * (i)))
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_GHASH_CLMUL
+void ghash_clmul64(uint64_t, uint64_t, FAR uint64_t *, FAR uint64_t *);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline __m128i aesni_encrypt1(FAR AES_CTX *ctx, __m128i s)
+{
+  unsigned i;
+
+  s = _mm_xor_si128(s, AESNI_EK(ctx, 0));
+  for (i = 1; i < ctx->num_rounds; i++)
+    {
+      s = _mm_aesenc_si128(s, AESNI_EK(ctx, i));
+    }
+
+  return _mm_aesenclast_si128(s, AESNI_EK(ctx, ctx->num_rounds));
+}
+
+static inline __m128i aesni_decrypt1(FAR AES_CTX *ctx, __m128i s)
+{
+  unsigned i;
+
+  s = _mm_xor_si128(s, AESNI_DK(ctx, 0));
+  for (i = 1; i < ctx->num_rounds; i++)
+    {
+      s = _mm_aesdec_si128(s, AESNI_DK(ctx, i));
+    }
+
+  return _mm_aesdeclast_si128(s, AESNI_DK(ctx, ctx->num_rounds));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
+{
+  FAR uint8_t *ek = (FAR uint8_t *)ctx->sk;
+  FAR uint8_t *dk = (FAR uint8_t *)ctx->sk_exp;
+  uint32_t skey[60];
+  unsigned i;
+
+  /* The key expansion is done once per key: the one of aes.c does */
+
+  ctx->num_rounds = aes_keysetup_encrypt(skey, key, len);
+  if (ctx->num_rounds == 0)
+    {
+      return -1;
+    }
+
+  for (i = 0; i < (ctx->num_rounds + 1) * 4; i++)
+    {
+      ek[4 * i]     = skey[i] >> 24;
+      ek[4 * i + 1] = skey[i] >> 16;
+      ek[4 * i + 2] = skey[i] >> 8;
+      ek[4 * i + 3] = skey[i];
+    }
+
+  explicit_bzero(skey, sizeof(skey));
+
+  _mm_storeu_si128((FAR __m128i *)dk, AESNI_EK(ctx, ctx->num_rounds));
+  for (i = 1; i < ctx->num_rounds; i++)
+    {
+      _mm_storeu_si128((FAR __m128i *)(dk + 16 * i),
+                       _mm_aesimc_si128(AESNI_EK(ctx,
+                                                 ctx->num_rounds - i)));
+    }
+
+  _mm_storeu_si128((FAR __m128i *)(dk + 16 * ctx->num_rounds),
+                   AESNI_EK(ctx, 0));
+  return 0;
+}
+
+void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                     FAR uint8_t *dst, size_t num_blocks)
+{
+  __m128i s0;
+  __m128i s1;
+  __m128i s2;
+  __m128i s3;
+  __m128i rk;
+  unsigned i;
+
+  /* Four blocks at a time hide the latency of the instructions */
+
+  for (; num_blocks >= 4; num_blocks -= 4, src += 64, dst += 64)
+    {
+      rk = AESNI_EK(ctx, 0);
+      s0 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)src), rk);
+      s1 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)
+                                         (src + 16)), rk);
+      s2 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)
+                                         (src + 32)), rk);
+      s3 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)
+                                         (src + 48)), rk);
+
+      for (i = 1; i < ctx->num_rounds; i++)
+        {
+          rk = AESNI_EK(ctx, i);
+          s0 = _mm_aesenc_si128(s0, rk);
+          s1 = _mm_aesenc_si128(s1, rk);
+          s2 = _mm_aesenc_si128(s2, rk);
+          s3 = _mm_aesenc_si128(s3, rk);
+        }
+
+      rk = AESNI_EK(ctx, ctx->num_rounds);
+      _mm_storeu_si128((FAR __m128i *)dst, _mm_aesenclast_si128(s0, rk));
+      _mm_storeu_si128((FAR __m128i *)(dst + 16),
+                       _mm_aesenclast_si128(s1, rk));
+      _mm_storeu_si128((FAR __m128i *)(dst + 32),
+                       _mm_aesenclast_si128(s2, rk));
+      _mm_storeu_si128((FAR __m128i *)(dst + 48),
+                       _mm_aesenclast_si128(s3, rk));
+    }
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      s0 = _mm_loadu_si128((FAR const __m128i *)src);
+      _mm_storeu_si128((FAR __m128i *)dst, aesni_encrypt1(ctx, s0));
+    }
+}
+
+void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                     FAR uint8_t *dst, size_t num_blocks)
+{
+  __m128i s0;
+  __m128i s1;
+  __m128i s2;
+  __m128i s3;
+  __m128i rk;
+  unsigned i;
+
+  for (; num_blocks >= 4; num_blocks -= 4, src += 64, dst += 64)
+    {
+      rk = AESNI_DK(ctx, 0);
+      s0 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)src), rk);
+      s1 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)
+                                         (src + 16)), rk);
+      s2 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)
+                                         (src + 32)), rk);
+      s3 = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)
+                                         (src + 48)), rk);
+
+      for (i = 1; i < ctx->num_rounds; i++)
+        {
+          rk = AESNI_DK(ctx, i);
+          s0 = _mm_aesdec_si128(s0, rk);
+          s1 = _mm_aesdec_si128(s1, rk);
+          s2 = _mm_aesdec_si128(s2, rk);
+          s3 = _mm_aesdec_si128(s3, rk);
+        }
+
+      rk = AESNI_DK(ctx, ctx->num_rounds);
+      _mm_storeu_si128((FAR __m128i *)dst, _mm_aesdeclast_si128(s0, rk));
+      _mm_storeu_si128((FAR __m128i *)(dst + 16),
+                       _mm_aesdeclast_si128(s1, rk));
+      _mm_storeu_si128((FAR __m128i *)(dst + 32),
+                       _mm_aesdeclast_si128(s2, rk));
+      _mm_storeu_si128((FAR __m128i *)(dst + 48),
+                       _mm_aesdeclast_si128(s3, rk));
+    }
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      s0 = _mm_loadu_si128((FAR const __m128i *)src);
+      _mm_storeu_si128((FAR __m128i *)dst, aesni_decrypt1(ctx, s0));
+    }
+}
+
+void aes_encrypt(FAR AES_CTX *ctx, FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  _mm_storeu_si128((FAR __m128i *)dst,
+                   aesni_encrypt1(ctx, _mm_loadu_si128((FAR const __m128i *)
+                                                       src)));
+}
+
+void aes_decrypt(FAR AES_CTX *ctx, FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  _mm_storeu_si128((FAR __m128i *)dst,
+                   aesni_decrypt1(ctx, _mm_loadu_si128((FAR const __m128i *)
+                                                       src)));
+}
+
+#ifdef CONFIG_CRYPTO_GHASH_CLMUL
+
+/* The 128-bit carry-less product of a and b, for gmac.c */
+
+void ghash_clmul64(uint64_t a, uint64_t b,
+                   FAR uint64_t *hi, FAR uint64_t *lo)
+{
+  __m128i r;
+
+  r = _mm_clmulepi64_si128(_mm_cvtsi64_si128(a), _mm_cvtsi64_si128(b),
+                           0x00);
+  *lo = _mm_cvtsi128_si64(r);
+  *hi = _mm_cvtsi128_si64(_mm_unpackhi_epi64(r, r));
+}
+
+#endif /* CONFIG_CRYPTO_GHASH_CLMUL */
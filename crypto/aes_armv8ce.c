@@ -0,0 +1,249 @@
+/****************************************************************************
+ * crypto/aes_armv8ce.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The AES library of include/crypto/aes.h with the Cryptographic
+ * Extension of ARMv8, instead of the bitsliced implementation of aes.c,
+ * and the carry-less multiply of GHASH with PMULL.  Both run in constant
+ * time.
+ *
+ * The context keeps the encryption round keys as bytes in sk[] and those
+ * of the equivalent inverse cipher in sk_exp[].
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <sys/types.h>
+#include <crypto/aes.h>
+
+#if !defined(__ARM_FEATURE_AES) && !defined(__ARM_FEATURE_CRYPTO)
+#  pragma GCC target("+crypto")
+#endif
+
+#include <arm_neon.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define AESCE_EK(ctx, i)  vld1q_u8((FAR uint8_t *)(ctx)->sk + 16 * (i))
+#define AESCE_DK(ctx, i)  vld1q_u8((FAR uint8_t *)(ctx)->sk_exp + 16 * (i))
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_GHASH_CLMUL
+void ghash_clmul64(uint64_t, uint64_t, FAR uint64_t *, FAR uint64_t *);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* AESE and AESD add the round key first, so the last one is added apart */
+
+static inline uint8x16_t aesce_encrypt1(FAR AES_CTX *ctx, uint8x16_t s)
+{
+  unsigned i;
+
+  for (i = 0; i < ctx->num_rounds - 1; i++)
+    {
+      s = vaesmcq_u8(vaeseq_u8(s, AESCE_EK(ctx, i)));
+    }
+
+  s = vaeseq_u8(s, AESCE_EK(ctx, ctx->num_rounds - 1));
+  return veorq_u8(s, AESCE_EK(ctx, ctx->num_rounds));
+}
+
+static inline uint8x16_t aesce_decrypt1(FAR AES_CTX *ctx, uint8x16_t s)
+{
+  unsigned i;
+
+  for (i = 0; i < ctx->num_rounds - 1; i++)
+    {
+      s = vaesimcq_u8(vaesdq_u8(s, AESCE_DK(ctx, i)));
+    }
+
+  s = vaesdq_u8(s, AESCE_DK(ctx, ctx->num_rounds - 1));
+  return veorq_u8(s, AESCE_DK(ctx, ctx->num_rounds));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
+{
+  FAR uint8_t *ek = (FAR uint8_t *)ctx->sk;
+  FAR uint8_t *dk = (FAR uint8_t *)ctx->sk_exp;
+  uint32_t skey[60];
+  unsigned i;
+
+  /* The key expansion is done once per key: the one of aes.c does */
+
+  ctx->num_rounds = aes_keysetup_encrypt(skey, key, len);
+  if (ctx->num_rounds == 0)
+    {
+      return -1;
+    }
+
+  for (i = 0; i < (ctx->num_rounds + 1) * 4; i++)
+    {
+      ek[4 * i]     = skey[i] >> 24;
+      ek[4 * i + 1] = skey[i] >> 16;
+      ek[4 * i + 2] = skey[i] >> 8;
+      ek[4 * i + 3] = skey[i];
+    }
+
+  explicit_bzero(skey, sizeof(skey));
+
+  vst1q_u8(dk, AESCE_EK(ctx, ctx->num_rounds));
+  for (i = 1; i < ctx->num_rounds; i++)
+    {
+      vst1q_u8(dk + 16 * i,
+               vaesimcq_u8(AESCE_EK(ctx, ctx->num_rounds - i)));
+    }
+
+  vst1q_u8(dk + 16 * ctx->num_rounds, AESCE_EK(ctx, 0));
+  return 0;
+}
+
+void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                     FAR uint8_t *dst, size_t num_blocks)
+{
+  uint8x16_t s0;
+  uint8x16_t s1;
+  uint8x16_t s2;
+  uint8x16_t s3;
+  uint8x16_t rk;
+  unsigned i;
+
+  /* Four blocks at a time hide the latency of the instructions */
+
+  for (; num_blocks >= 4; num_blocks -= 4, src += 64, dst += 64)
+    {
+      s0 = vld1q_u8(src);
+      s1 = vld1q_u8(src + 16);
+      s2 = vld1q_u8(src + 32);
+      s3 = vld1q_u8(src + 48);
+
+      for (i = 0; i < ctx->num_rounds - 1; i++)
+        {
+          rk = AESCE_EK(ctx, i);
+          s0 = vaesmcq_u8(vaeseq_u8(s0, rk));
+          s1 = vaesmcq_u8(vaeseq_u8(s1, rk));
+          s2 = vaesmcq_u8(vaeseq_u8(s2, rk));
+          s3 = vaesmcq_u8(vaeseq_u8(s3, rk));
+        }
+
+      rk = AESCE_EK(ctx, ctx->num_rounds - 1);
+      s0 = vaeseq_u8(s0, rk);
+      s1 = vaeseq_u8(s1, rk);
+      s2 = vaeseq_u8(s2, rk);
+      s3 = vaeseq_u8(s3, rk);
+
+      rk = AESCE_EK(ctx, ctx->num_rounds);
+      vst1q_u8(dst, veorq_u8(s0, rk));
+      vst1q_u8(dst + 16, veorq_u8(s1, rk));
+      vst1q_u8(dst + 32, veorq_u8(s2, rk));
+      vst1q_u8(dst + 48, veorq_u8(s3, rk));
+    }
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      vst1q_u8(dst, aesce_encrypt1(ctx, vld1q_u8(src)));
+    }
+}
+
+void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                     FAR uint8_t *dst, size_t num_blocks)
+{
+  uint8x16_t s0;
+  uint8x16_t s1;
+  uint8x16_t s2;
+  uint8x16_t s3;
+  uint8x16_t rk;
+  unsigned i;
+
+  for (; num_blocks >= 4; num_blocks -= 4, src += 64, dst += 64)
+    {
+      s0 = vld1q_u8(src);
+      s1 = vld1q_u8(src + 16);
+      s2 = vld1q_u8(src + 32);
+      s3 = vld1q_u8(src + 48);
+
+      for (i = 0; i < ctx->num_rounds - 1; i++)
+        {
+          rk = AESCE_DK(ctx, i);
+          s0 = vaesimcq_u8(vaesdq_u8(s0, rk));
+          s1 = vaesimcq_u8(vaesdq_u8(s1, rk));
+          s2 = vaesimcq_u8(vaesdq_u8(s2, rk));
+          s3 = vaesimcq_u8(vaesdq_u8(s3, rk));
+        }
+
+      rk = AESCE_DK(ctx, ctx->num_rounds - 1);
+      s0 = vaesdq_u8(s0, rk);
+      s1 = vaesdq_u8(s1, rk);
+      s2 = vaesdq_u8(s2, rk);
+      s3 = vaesdq_u8(s3, rk);
+
+      rk = AESCE_DK(ctx, ctx->num_rounds);
+      vst1q_u8(dst, veorq_u8(s0, rk));
+      vst1q_u8(dst + 16, veorq_u8(s1, rk));
+      vst1q_u8(dst + 32, veorq_u8(s2, rk));
+      vst1q_u8(dst + 48, veorq_u8(s3, rk));
+    }
+
+  for (; num_blocks > 0; num_blocks--, src += 16, dst += 16)
+    {
+      vst1q_u8(dst, aesce_decrypt1(ctx, vld1q_u8(src)));
+    }
+}
+
+void aes_encrypt(FAR AES_CTX *ctx, FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  vst1q_u8(dst, aesce_encrypt1(ctx, vld1q_u8(src)));
+}
+
+void aes_decrypt(FAR AES_CTX *ctx, FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  vst1q_u8(dst, aesce_decrypt1(ctx, vld1q_u8(src)));
+}
+
+#ifdef CONFIG_CRYPTO_GHASH_CLMUL
+
+/* The 128-bit carry-less product of a and b, for gmac.c */
+
+void ghash_clmul64(uint64_t a, uint64_t b,
+                   FAR uint64_t *hi, FAR uint64_t *lo)
+{
+  uint64x2_t r;
+
+  r = vreinterpretq_u64_p128(vmull_p64((poly64_t)a, (poly64_t)b));
+  *lo = vgetq_lane_u64(r, 0);
+  *hi = vgetq_lane_u64(r, 1);
+}
+
+#endif /* CONFIG_CRYPTO_GHASH_CLMUL */
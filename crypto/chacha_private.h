@@ -58,6 +58,58 @@ chacha_ctx;
     }                                            \
   while (0)
 
+/* With CONFIG_CRYPTO_SIMD, consecutive blocks are computed together, one
+ * per lane of the vectors of the SIMD unit: NEON or SSE2 hold four words,
+ * AVX2 eight.
+ */
+
+#if defined(CONFIG_CRYPTO_SIMD) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  ifdef __AVX2__
+#    define CHACHA_NLANES 8
+#  else
+#    define CHACHA_NLANES 4
+#  endif
+
+typedef uint32_t chacha_vec
+  __attribute__((vector_size(CHACHA_NLANES * sizeof(uint32_t))));
+typedef uint32_t chacha_vec4
+  __attribute__((vector_size(4 * sizeof(uint32_t))));
+
+/* Transpose 4 x 4 words within each 128 bits of the vectors */
+
+#  if CHACHA_NLANES == 8
+#    define CHACHA_ZIPLO  0, 8, 1, 9, 4, 12, 5, 13
+#    define CHACHA_ZIPHI  2, 10, 3, 11, 6, 14, 7, 15
+#    define CHACHA_LO64   0, 1, 8, 9, 4, 5, 12, 13
+#    define CHACHA_HI64   2, 3, 10, 11, 6, 7, 14, 15
+#  else
+#    define CHACHA_ZIPLO  0, 4, 1, 5
+#    define CHACHA_ZIPHI  2, 6, 3, 7
+#    define CHACHA_LO64   0, 1, 4, 5
+#    define CHACHA_HI64   2, 3, 6, 7
+#  endif
+
+#  ifdef __clang__
+#    define VSHUFFLE(a, b, ...) __builtin_shufflevector(a, b, __VA_ARGS__)
+#  else
+#    define VSHUFFLE(a, b, ...) \
+       __builtin_shuffle(a, b, (chacha_vec){ __VA_ARGS__ })
+#  endif
+
+#define VROTATE(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
+
+#define VQUARTERROUND(a, b, c, d)              \
+  do                                           \
+    {                                          \
+      a += b; d = VROTATE(d ^ a, 16);          \
+      c += d; b = VROTATE(b ^ c, 12);          \
+      a += b; d = VROTATE(d ^ a, 8);           \
+      c += d; b = VROTATE(b ^ c, 7);           \
+    }                                          \
+  while (0)
+#endif
+
 static const char sigma[16] = "expand 32-byte k";
 static const char tau[16] = "expand 16-byte k";
 
@@ -146,6 +198,109 @@ static void chacha_ivsetup(FAR chacha_ctx *x,
   x->input[15] = U8TO32_LITTLE(iv + 4);
 }
 
+#if defined(CHACHA_NLANES) && !defined(KEYSTREAM_ONLY)
+
+/* Encrypt nblocks * CHACHA_NLANES blocks, lane i of the vectors holding
+ * the state of block i.
+ */
+
+static void chacha_encrypt_lanes(FAR chacha_ctx *x,
+                                 FAR const uint8_t *m,
+                                 FAR uint8_t *c,
+                                 uint32_t nblocks)
+{
+  chacha_vec j[16];
+  chacha_vec v[16];
+  chacha_vec t[4];
+  chacha_vec lo;
+  chacha_vec4 ks;
+  chacha_vec4 in;
+  u_int i;
+  u_int k;
+  u_int n;
+
+  for (i = 0; i < 16; i++)
+    {
+      for (k = 0; k < CHACHA_NLANES; k++)
+        {
+          j[i][k] = x->input[i];
+        }
+    }
+
+  /* The 64-bit block counter of each lane */
+
+  for (k = 0; k < CHACHA_NLANES; k++)
+    {
+      j[12][k] += k;
+      j[13][k] += j[12][k] < x->input[12];
+    }
+
+  for (; nblocks > 0; nblocks--)
+    {
+      memcpy(v, j, sizeof(v));
+      for (i = 20; i > 0; i -= 2)
+        {
+          VQUARTERROUND(v[0], v[4], v[8], v[12]);
+          VQUARTERROUND(v[1], v[5], v[9], v[13]);
+          VQUARTERROUND(v[2], v[6], v[10], v[14]);
+          VQUARTERROUND(v[3], v[7], v[11], v[15]);
+          VQUARTERROUND(v[0], v[5], v[10], v[15]);
+          VQUARTERROUND(v[1], v[6], v[11], v[12]);
+          VQUARTERROUND(v[2], v[7], v[8], v[13]);
+          VQUARTERROUND(v[3], v[4], v[9], v[14]);
+        }
+
+      /* Words i to i + 3 of the blocks, transposed so that each 128 bits
+       * hold 16 bytes of the key stream of one block.
+       */
+
+      for (i = 0; i < 16; i += 4)
+        {
+          v[i]     += j[i];
+          v[i + 1] += j[i + 1];
+          v[i + 2] += j[i + 2];
+          v[i + 3] += j[i + 3];
+
+          t[0] = VSHUFFLE(v[i], v[i + 1], CHACHA_ZIPLO);
+          t[1] = VSHUFFLE(v[i], v[i + 1], CHACHA_ZIPHI);
+          t[2] = VSHUFFLE(v[i + 2], v[i + 3], CHACHA_ZIPLO);
+          t[3] = VSHUFFLE(v[i + 2], v[i + 3], CHACHA_ZIPHI);
+
+          v[i]     = VSHUFFLE(t[0], t[2], CHACHA_LO64);
+          v[i + 1] = VSHUFFLE(t[0], t[2], CHACHA_HI64);
+          v[i + 2] = VSHUFFLE(t[1], t[3], CHACHA_LO64);
+          v[i + 3] = VSHUFFLE(t[1], t[3], CHACHA_HI64);
+
+          for (k = 0; k < CHACHA_NLANES; k++)
+            {
+              n = 64 * k + 4 * i;
+              memcpy(&ks, (FAR uint8_t *)&v[i + (k & 3)] + 16 * (k >> 2),
+                     sizeof(ks));
+              memcpy(&in, m + n, sizeof(in));
+              in ^= ks;
+              memcpy(c + n, &in, sizeof(in));
+            }
+        }
+
+      m += 64 * CHACHA_NLANES;
+      c += 64 * CHACHA_NLANES;
+
+      /* A lane compares true as -1 */
+
+      lo = j[12];
+      j[12] += CHACHA_NLANES;
+      j[13] -= (chacha_vec)(j[12] < lo);
+    }
+
+  x->input[12] = j[12][0];
+  x->input[13] = j[13][0];
+  explicit_bzero(j, sizeof(j));
+  explicit_bzero(v, sizeof(v));
+  explicit_bzero(&ks, sizeof(ks));
+}
+
+#endif /* CHACHA_NLANES && !KEYSTREAM_ONLY */
+
 static void chacha_encrypt_bytes(FAR chacha_ctx *x,
                                  FAR const uint8_t *m,
                                  FAR uint8_t *c,
@@ -192,6 +347,23 @@ static void chacha_encrypt_bytes(FAR chacha_ctx *x,
       return;
     }
 
+#if defined(CHACHA_NLANES) && !defined(KEYSTREAM_ONLY)
+  if (bytes >= 64 * CHACHA_NLANES)
+    {
+      i = bytes / (64 * CHACHA_NLANES);
+      chacha_encrypt_lanes(x, m, c, i);
+
+      i *= 64 * CHACHA_NLANES;
+      bytes -= i;
+      m += i;
+      c += i;
+      if (!bytes)
+        {
+          return;
+        }
+    }
+#endif
+
   j0 = x->input[0];
   j1 = x->input[1];
   j2 = x->input[2];
@@ -36,8 +36,10 @@
 #include <errno.h>
 #include <crypto/cryptodev.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/irq.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/crypto/crypto.h>
 
 /****************************************************************************
@@ -53,6 +55,97 @@ int crypto_drivers_num = 0;
 
 static mutex_t g_crypto_lock = NXMUTEX_INITIALIZER;
 
+#ifdef CONFIG_SCHED_WORKQUEUE
+/* The requests queued by crypto_dispatch() */
+
+static FAR struct cryptop *g_crypto_head;
+static FAR struct cryptop *g_crypto_tail;
+static struct work_s g_crypto_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Perform a request that a hardware driver declined with the software
+ * driver, in a session of its own that is freed at once.
+ */
+
+static void crypto_invoke_soft(FAR struct cryptop *crp)
+{
+  FAR struct cryptodesc *crd;
+  uint64_t sid = crp->crp_sid;
+  uint64_t nid;
+  uint32_t hid;
+  int error;
+
+  for (crd = crp->crp_desc; crd->crd_next; crd = crd->crd_next)
+    {
+      crd->CRD_INI.cri_next = &(crd->crd_next->CRD_INI);
+    }
+
+  error = crypto_newsession(&nid, &(crp->crp_desc->CRD_INI), -1);
+  if (error != 0)
+    {
+      crp->crp_etype = error;
+      return;
+    }
+
+  hid = (nid >> 32) & 0xffffffff;
+  crp->crp_sid = nid;
+
+  nxmutex_lock(&g_crypto_lock);
+  crypto_drivers[hid].cc_operations++;
+  crypto_drivers[hid].cc_bytes += crp->crp_ilen;
+  error = crypto_drivers[hid].cc_process(crp);
+  nxmutex_unlock(&g_crypto_lock);
+
+  if (error)
+    {
+      crp->crp_etype = error;
+    }
+
+  crypto_freesession(nid);
+  crp->crp_sid = sid;
+}
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+/* Perform the queued requests, all of them in one pass, and complete
+ * them.
+ */
+
+static void crypto_worker(FAR void *arg)
+{
+  FAR struct cryptop *crp;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      crp = g_crypto_head;
+      if (crp != NULL)
+        {
+          g_crypto_head = crp->crp_next;
+          if (g_crypto_head == NULL)
+            {
+              g_crypto_tail = NULL;
+            }
+        }
+
+      leave_critical_section(flags);
+
+      if (crp == NULL)
+        {
+          break;
+        }
+
+      crp->crp_next = NULL;
+      crypto_invoke(crp);
+      crypto_done(crp);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -68,7 +161,7 @@ int crypto_newsession(FAR uint64_t *sid,
   uint32_t hid2 = -1;
   FAR struct cryptocap *cpc;
   FAR struct cryptoini *cr;
-  int turn = 0;
+  int turn = hard < 0; /* Software drivers only */
   int err;
 
   if (crypto_drivers == NULL)
@@ -570,8 +663,9 @@ int crypto_invoke(FAR struct cryptop *crp)
 
   if (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_CLEANUP)
     {
+      nxmutex_unlock(&g_crypto_lock);
       crypto_freesession(crp->crp_sid);
-      goto migrate;
+      goto migrate_unlocked;
     }
 
   if (crypto_drivers[hid].cc_process == NULL)
@@ -589,8 +683,20 @@ int crypto_invoke(FAR struct cryptop *crp)
         {
           /* Unregister driver and migrate session. */
 
+          nxmutex_unlock(&g_crypto_lock);
           crypto_unregister(hid, CRYPTO_ALGORITHM_MAX + 1);
-          goto migrate;
+          goto migrate_unlocked;
+        }
+      else if (error == -ENOTSUP &&
+               (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_SOFTWARE) == 0)
+        {
+          /* The engine cannot do this one, e.g. for its length or
+           * alignment: leave it to the software driver.
+           */
+
+          nxmutex_unlock(&g_crypto_lock);
+          crypto_invoke_soft(crp);
+          return 0;
         }
       else
         {
@@ -602,6 +708,9 @@ int crypto_invoke(FAR struct cryptop *crp)
   return 0;
 
 migrate:
+  nxmutex_unlock(&g_crypto_lock);
+
+migrate_unlocked:
 
   /* Migrate session. */
 
@@ -616,10 +725,72 @@ migrate:
     }
 
   crp->crp_etype = -EAGAIN;
-  nxmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
+/* Queue a crypto request and return at once.  The queued requests are
+ * performed in order on the low priority work queue, all of those queued
+ * before it runs in one pass, and each is completed with crypto_done().
+ * Requests without a callback, or with CRYPTO_F_NOQUEUE, are performed
+ * at once.
+ */
+
+int crypto_dispatch(FAR struct cryptop *crp)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE
+  irqstate_t flags;
+#endif
+
+  if (crp == NULL)
+    {
+      return -EINVAL;
+    }
+
+  crp->crp_flags &= ~CRYPTO_F_DONE;
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+  if (crp->crp_callback != NULL && (crp->crp_flags & CRYPTO_F_NOQUEUE) == 0)
+    {
+      crp->crp_next = NULL;
+
+      flags = enter_critical_section();
+      if (g_crypto_tail != NULL)
+        {
+          g_crypto_tail->crp_next = crp;
+        }
+      else
+        {
+          g_crypto_head = crp;
+        }
+
+      g_crypto_tail = crp;
+      leave_critical_section(flags);
+
+      if (work_available(&g_crypto_work))
+        {
+          work_queue(LPWORK, &g_crypto_work, crypto_worker, NULL, 0);
+        }
+
+      return 0;
+    }
+#endif
+
+  crypto_invoke(crp);
+  crypto_done(crp);
+  return 0;
+}
+
+/* Complete a crypto request: mark it done and call its callback. */
+
+void crypto_done(FAR struct cryptop *crp)
+{
+  crp->crp_flags |= CRYPTO_F_DONE;
+  if (crp->crp_callback != NULL)
+    {
+      crp->crp_callback(crp);
+    }
+}
+
 /* Release a set of crypto descriptors. */
 
 void crypto_freereq(FAR struct cryptop *crp)
@@ -28,7 +28,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <endian.h>
+#include <string.h>
 #include <strings.h>
 #include <sys/param.h>
 #include <crypto/aes.h>
@@ -41,11 +44,22 @@
 void ghash_gfmul(FAR uint32_t *, FAR uint32_t *, FAR uint32_t *);
 void ghash_update_mi(FAR GHASH_CTX *, FAR uint8_t *, size_t);
 
+#ifdef CONFIG_CRYPTO_GHASH_CLMUL
+void ghash_clmul64(uint64_t, uint64_t, FAR uint64_t *, FAR uint64_t *);
+void ghash_update_clmul(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+#endif
+
 /* Allow overriding with optimized MD function */
 
+#ifdef CONFIG_CRYPTO_GHASH_CLMUL
+CODE void (*ghash_update)(FAR GHASH_CTX *,
+                          FAR uint8_t *,
+                          size_t) = ghash_update_clmul;
+#else
 CODE void (*ghash_update)(FAR GHASH_CTX *,
                           FAR uint8_t *,
                           size_t) = ghash_update_mi;
+#endif
 
 /* Computes a block multiplication in the GF(2^128) */
 
@@ -116,6 +130,113 @@ void ghash_update_mi(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
   bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
 }
 
+#ifdef CONFIG_CRYPTO_GHASH_CLMUL
+
+static inline uint64_t ghash_load64(FAR const uint8_t *p)
+{
+  uint64_t v;
+
+  memcpy(&v, p, sizeof(v));
+  return be64toh(v);
+}
+
+static inline void ghash_store64(FAR uint8_t *p, uint64_t v)
+{
+  v = htobe64(v);
+  memcpy(p, &v, sizeof(v));
+}
+
+/* Computes a block multiplication in the GF(2^128) with the carry-less
+ * multiply instruction of the CPU, ghash_clmul64(), in constant time.
+ *
+ * Loaded big-endian, a block is its polynomial with the bits reflected,
+ * x^0 being the most significant bit.  The 255-bit product of two such
+ * values is the reflected product shifted right by one bit, which is
+ * fixed with a left shift; the upper half of the result then holds the
+ * low order terms and the lower half the terms of x^128 and above.  The
+ * latter are folded twice with x^128 = x^7 + x^2 + x + 1.
+ */
+
+static void ghash_gfmul_clmul(FAR uint64_t *x, FAR const uint64_t *y)
+{
+  uint64_t lh;
+  uint64_t ll;
+  uint64_t hh;
+  uint64_t hl;
+  uint64_t mh;
+  uint64_t ml;
+  uint64_t th;
+  uint64_t tl;
+  uint64_t t3;
+  uint64_t t2;
+  uint64_t t1;
+  uint64_t t0;
+
+  /* 128 x 128 bits product, in four 64-bit words */
+
+  ghash_clmul64(x[1], y[1], &lh, &ll);
+  ghash_clmul64(x[0], y[0], &hh, &hl);
+  ghash_clmul64(x[1], y[0], &mh, &ml);
+  ghash_clmul64(x[0], y[1], &th, &tl);
+  mh ^= th;
+  ml ^= tl;
+
+  t3 = hh;
+  t2 = hl ^ mh;
+  t1 = lh ^ ml;
+  t0 = ll;
+
+  /* Undo the shift of the reflected product */
+
+  t3 = (t3 << 1) | (t2 >> 63);
+  t2 = (t2 << 1) | (t1 >> 63);
+  t1 = (t1 << 1) | (t0 >> 63);
+  t0 <<= 1;
+
+  /* The terms that folding the lower half carries above x^127 depend on
+   * its low seven bits only: add their own folding to it first, so that
+   * it is folded into the upper half at once.
+   */
+
+  t1 ^= (t0 << 63) ^ (t0 << 62) ^ (t0 << 57);
+  t3 ^= t1 ^ (t1 >> 1) ^ (t1 >> 2) ^ (t1 >> 7);
+  t2 ^= t0 ^ ((t0 >> 1) | (t1 << 63)) ^ ((t0 >> 2) | (t1 << 62)) ^
+        ((t0 >> 7) | (t1 << 57));
+
+  x[0] = t3;
+  x[1] = t2;
+}
+
+void ghash_update_clmul(FAR GHASH_CTX *ctx, FAR uint8_t *X, size_t len)
+{
+  uint64_t h[2];
+  uint64_t s[2];
+  size_t i;
+
+  if (len >= GMAC_BLOCK_LEN)
+    {
+      h[0] = ghash_load64(ctx->H);
+      h[1] = ghash_load64(ctx->H + 8);
+      s[0] = ghash_load64(ctx->Z);
+      s[1] = ghash_load64(ctx->Z + 8);
+
+      for (i = 0; i < len / GMAC_BLOCK_LEN; i++)
+        {
+          s[0] ^= ghash_load64(X);
+          s[1] ^= ghash_load64(X + 8);
+          ghash_gfmul_clmul(s, h);
+          X += GMAC_BLOCK_LEN;
+        }
+
+      ghash_store64(ctx->S, s[0]);
+      ghash_store64(ctx->S + 8, s[1]);
+    }
+
+  bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
+}
+
+#endif /* CONFIG_CRYPTO_GHASH_CLMUL */
+
 #define AESCTR_NONCESIZE 4
 
 void aes_gmac_init(FAR void *xctx)
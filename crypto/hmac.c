@@ -203,6 +203,29 @@ void hmac_sha256_update(FAR HMAC_SHA256_CTX *ctx,
   sha256update(&ctx->ctx, data, len);
 }
 
+/* Update n contexts with len bytes each at once, with the multi-buffer
+ * SHA-256 when it is configured.
+ */
+
+void hmac_sha256_update_multi(FAR HMAC_SHA256_CTX **ctx,
+                              FAR const uint8_t **data,
+                              u_int len, int n)
+{
+  FAR SHA2_CTX *sctx[8];
+  int i;
+  int j;
+
+  for (i = 0; i < n; i += 8)
+    {
+      for (j = 0; j < 8 && i + j < n; j++)
+        {
+          sctx[j] = &ctx[i + j]->ctx;
+        }
+
+      sha256update_multi(sctx, &data[i], len, j);
+    }
+}
+
 void hmac_sha256_final(FAR uint8_t *digest,
                        FAR HMAC_SHA256_CTX *ctx)
 {
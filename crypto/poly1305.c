@@ -43,10 +43,142 @@ static void U32TO8(FAR unsigned char *p, unsigned long v)
   p[3] = (v >> 24) & 0xff;
 }
 
+/* With a 64 bit unsigned long and a 128 bit product, as on arm64 and
+ * x86_64, h and r are kept in three limbs of 44, 44 and 42 bits instead of
+ * five limbs of 26 bits: a block then costs 9 multiplications instead of
+ * 25.  The limbs use the first words of the arrays of poly1305_state.
+ */
+
+#if defined(__SIZEOF_INT128__) && __SIZEOF_LONG__ == 8
+#  define POLY1305_64BIT
+
+typedef unsigned __int128 uint128_t;
+
+static unsigned long U8TO64(FAR const unsigned char *p)
+{
+  return U8TO32(p) | (U8TO32(p + 4) << 32);
+}
+
+static void U64TO8(FAR unsigned char *p, unsigned long v)
+{
+  U32TO8(p, v & 0xffffffff);
+  U32TO8(p + 4, v >> 32);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef POLY1305_64BIT
+
+void poly1305_init(FAR poly1305_state *st, FAR const unsigned char *key)
+{
+  unsigned long t0;
+  unsigned long t1;
+
+  /* r &= 0xffffffc0ffffffc0ffffffc0fffffff */
+
+  t0 = U8TO64(&key[0]);
+  t1 = U8TO64(&key[8]);
+
+  st->r[0] = t0 & 0xffc0fffffff;
+  st->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+  st->r[2] = (t1 >> 24) & 0x00ffffffc0f;
+
+  /* h = 0 */
+
+  st->h[0] = 0;
+  st->h[1] = 0;
+  st->h[2] = 0;
+
+  /* save pad for later */
+
+  st->pad[0] = U8TO64(&key[16]);
+  st->pad[1] = U8TO64(&key[24]);
+
+  st->leftover = 0;
+  st->final = 0;
+}
+
+static void poly1305_blocks(FAR poly1305_state *st,
+                            FAR const unsigned char *m,
+                            size_t bytes)
+{
+  const unsigned long hibit = (st->final) ? 0 : (1ul << 40); /* 1 << 128 */
+  unsigned long r0;
+  unsigned long r1;
+  unsigned long r2;
+  unsigned long s1;
+  unsigned long s2;
+  unsigned long h0;
+  unsigned long h1;
+  unsigned long h2;
+  unsigned long t0;
+  unsigned long t1;
+  unsigned long c;
+  uint128_t d0;
+  uint128_t d1;
+  uint128_t d2;
+
+  r0 = st->r[0];
+  r1 = st->r[1];
+  r2 = st->r[2];
+
+  /* The limbs above 2^130 wrap around multiplied by 5, and by 4 more as
+   * they are 2 bits short of the next limb.
+   */
+
+  s1 = r1 * (5 << 2);
+  s2 = r2 * (5 << 2);
+
+  h0 = st->h[0];
+  h1 = st->h[1];
+  h2 = st->h[2];
+
+  while (bytes >= poly1305_block_size)
+    {
+      /* h += m[i] */
+
+      t0 = U8TO64(m + 0);
+      t1 = U8TO64(m + 8);
+
+      h0 += t0 & 0xfffffffffff;
+      h1 += ((t0 >> 44) | (t1 << 20)) & 0xfffffffffff;
+      h2 += ((t1 >> 24) & 0x3ffffffffff) | hibit;
+
+      /* h *= r */
+
+      d0 = (uint128_t)h0 * r0 + (uint128_t)h1 * s2 + (uint128_t)h2 * s1;
+      d1 = (uint128_t)h0 * r1 + (uint128_t)h1 * r0 + (uint128_t)h2 * s2;
+      d2 = (uint128_t)h0 * r2 + (uint128_t)h1 * r1 + (uint128_t)h2 * r0;
+
+      /* (partial) h %= p */
+
+      c = (unsigned long)(d0 >> 44);
+      h0 = (unsigned long)d0 & 0xfffffffffff;
+      d1 += c;
+      c = (unsigned long)(d1 >> 44);
+      h1 = (unsigned long)d1 & 0xfffffffffff;
+      d2 += c;
+      c = (unsigned long)(d2 >> 42);
+      h2 = (unsigned long)d2 & 0x3ffffffffff;
+      h0 += c * 5;
+      c = h0 >> 44;
+      h0 = h0 & 0xfffffffffff;
+      h1 += c;
+
+      m += poly1305_block_size;
+      bytes -= poly1305_block_size;
+    }
+
+  st->h[0] = h0;
+  st->h[1] = h1;
+  st->h[2] = h2;
+}
+
+#else /* POLY1305_64BIT */
+
 void poly1305_init(FAR poly1305_state *st, FAR const unsigned char *key)
 {
   /* r &= 0xffffffc0ffffffc0ffffffc0fffffff */
@@ -189,6 +321,8 @@ static void poly1305_blocks(FAR poly1305_state *st,
   st->h[4] = h4;
 }
 
+#endif /* POLY1305_64BIT */
+
 void poly1305_update(FAR poly1305_state *st,
                      FAR const unsigned char *m,
                      size_t bytes)
@@ -245,6 +379,112 @@ void poly1305_update(FAR poly1305_state *st,
     }
 }
 
+#ifdef POLY1305_64BIT
+
+void poly1305_finish(FAR poly1305_state *st, FAR unsigned char *mac)
+{
+  unsigned long h0;
+  unsigned long h1;
+  unsigned long h2;
+  unsigned long c;
+  unsigned long g0;
+  unsigned long g1;
+  unsigned long g2;
+  unsigned long t0;
+  unsigned long t1;
+
+  /* process the remaining block */
+
+  if (st->leftover)
+    {
+      size_t i = st->leftover;
+      st->buffer[i++] = 1;
+      for (; i < poly1305_block_size; i++)
+        st->buffer[i] = 0;
+      st->final = 1;
+      poly1305_blocks(st, st->buffer, poly1305_block_size);
+    }
+
+  /* fully carry h */
+
+  h0 = st->h[0];
+  h1 = st->h[1];
+  h2 = st->h[2];
+
+  c = h1 >> 44;
+  h1 &= 0xfffffffffff;
+  h2 += c;
+  c = h2 >> 42;
+  h2 &= 0x3ffffffffff;
+  h0 += c * 5;
+  c = h0 >> 44;
+  h0 &= 0xfffffffffff;
+  h1 += c;
+  c = h1 >> 44;
+  h1 &= 0xfffffffffff;
+  h2 += c;
+  c = h2 >> 42;
+  h2 &= 0x3ffffffffff;
+  h0 += c * 5;
+  c = h0 >> 44;
+  h0 &= 0xfffffffffff;
+  h1 += c;
+
+  /* compute h + -p */
+
+  g0 = h0 + 5;
+  c = g0 >> 44;
+  g0 &= 0xfffffffffff;
+  g1 = h1 + c;
+  c = g1 >> 44;
+  g1 &= 0xfffffffffff;
+  g2 = h2 + c - (1ul << 42);
+
+  /* select h if h < p, or h + -p if h >= p */
+
+  c = (g2 >> ((sizeof(unsigned long) * 8) - 1)) - 1;
+  g0 &= c;
+  g1 &= c;
+  g2 &= c;
+  c = ~c;
+  h0 = (h0 & c) | g0;
+  h1 = (h1 & c) | g1;
+  h2 = (h2 & c) | g2;
+
+  /* mac = (h + pad) % (2^128) */
+
+  t0 = st->pad[0];
+  t1 = st->pad[1];
+
+  h0 += t0 & 0xfffffffffff;
+  c = h0 >> 44;
+  h0 &= 0xfffffffffff;
+  h1 += (((t0 >> 44) | (t1 << 20)) & 0xfffffffffff) + c;
+  c = h1 >> 44;
+  h1 &= 0xfffffffffff;
+  h2 += ((t1 >> 24) & 0x3ffffffffff) + c;
+  h2 &= 0x3ffffffffff;
+
+  h0 = h0 | (h1 << 44);
+  h1 = (h1 >> 20) | (h2 << 24);
+
+  U64TO8(mac + 0, h0);
+  U64TO8(mac + 8, h1);
+
+  /* zero out the state */
+
+  st->h[0] = 0;
+  st->h[1] = 0;
+  st->h[2] = 0;
+  st->r[0] = 0;
+  st->r[1] = 0;
+  st->r[2] = 0;
+  st->pad[0] = 0;
+  st->pad[1] = 0;
+}
+
+#else /* POLY1305_64BIT */
+
 void poly1305_finish(FAR poly1305_state *st, FAR unsigned char *mac)
 {
   unsigned long h0;
@@ -368,3 +608,5 @@ void poly1305_finish(FAR poly1305_state *st, FAR unsigned char *mac)
   st->pad[2] = 0;
   st->pad[3] = 0;
 }
+
+#endif /* POLY1305_64BIT */
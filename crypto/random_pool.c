@@ -31,12 +31,18 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 #include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/crypto/blake2s.h>
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+#  include "chacha_private.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -48,6 +54,25 @@
 #define ROTL_32(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
 #define ROTR_32(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
 
+/* The ChaCha20 generators: The key and the IV of a generator come from the
+ * start of each batch of its key stream.
+ */
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+#  define RNG_CHACHA_KEYSZ   32
+#  define RNG_CHACHA_IVSZ    8
+#  define RNG_CHACHA_SEEDSZ  (RNG_CHACHA_KEYSZ + RNG_CHACHA_IVSZ)
+#  define RNG_CHACHA_BUFSZ   (64 * CONFIG_CRYPTO_RANDOM_POOL_CHACHA20_BATCH)
+
+#  ifdef CONFIG_SMP
+#    define RNG_CHACHA_NCPUS CONFIG_SMP_NCPUS
+#    define RNG_CHACHA_CPU() up_cpu_index()
+#  else
+#    define RNG_CHACHA_NCPUS 1
+#    define RNG_CHACHA_CPU() 0
+#  endif
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -73,9 +98,22 @@ struct rng_s
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
   bool output_initialized;
+  volatile uint32_t rd_generation; /* Counts the reseeds of the output */
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+struct rng_chacha_s
+{
+  chacha_ctx ctx;                 /* The key and counter of the generator */
+  bool keyed;                     /* The generator was seeded once */
+  size_t have;                    /* Output bytes left at the end of buf */
+  size_t count;                   /* Output bytes left before a reseed */
+  uint32_t generation;            /* rd_generation at the last reseed */
+  uint8_t buf[RNG_CHACHA_BUFSZ];  /* The current batch of key stream */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -94,6 +132,12 @@ static struct rng_s g_rng =
   NXMUTEX_INITIALIZER,
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+/* Each CPU has its own generator, used with its interrupts disabled */
+
+static struct rng_chacha_s g_rng_chacha[RNG_CHACHA_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -307,6 +351,7 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+  g_rng.rd_generation++;
 }
 
 static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
@@ -360,6 +405,95 @@ static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+
+/****************************************************************************
+ * Name: rng_chacha_rekey
+ *
+ * Description:
+ *   Produce the next batch of key stream of a generator and take its next
+ *   key and IV from the start of the batch, mixed with a seed if one is
+ *   given.  The key that produced the output is erased, so the output
+ *   cannot be recomputed from the state of the generator.
+ *
+ *   Code is inspired by _rs_rekey() of the arc4random of OpenBSD.
+ *
+ * Assumptions:
+ *   The interrupts of the CPU of the generator are disabled.
+ *
+ ****************************************************************************/
+
+static void rng_chacha_rekey(FAR struct rng_chacha_s *rs,
+                             FAR const uint8_t *seed)
+{
+  int i;
+
+  memset(rs->buf, 0, sizeof(rs->buf));
+  chacha_encrypt_bytes(&rs->ctx, rs->buf, rs->buf, sizeof(rs->buf));
+
+  if (seed != NULL)
+    {
+      for (i = 0; i < RNG_CHACHA_SEEDSZ; i++)
+        {
+          rs->buf[i] ^= seed[i];
+        }
+    }
+
+  chacha_keysetup(&rs->ctx, rs->buf, RNG_CHACHA_KEYSZ * 8);
+  chacha_ivsetup(&rs->ctx, rs->buf + RNG_CHACHA_KEYSZ, NULL);
+
+  explicit_bzero(rs->buf, RNG_CHACHA_SEEDSZ);
+  rs->have = sizeof(rs->buf) - RNG_CHACHA_SEEDSZ;
+}
+
+/****************************************************************************
+ * Name: rng_chacha_stir
+ *
+ * Description:
+ *   Reseed the generator of the current CPU from the output of the pool.
+ *
+ ****************************************************************************/
+
+static void rng_chacha_stir(void)
+{
+  FAR struct rng_chacha_s *rs;
+  uint8_t seed[RNG_CHACHA_SEEDSZ];
+  uint32_t generation;
+  irqstate_t flags;
+
+  nxmutex_lock(&g_rng.rd_lock);
+  rng_buf_internal(seed, sizeof(seed));
+  generation = g_rng.rd_generation;
+  nxmutex_unlock(&g_rng.rd_lock);
+
+  /* The thread may run on another CPU by now: Seed the generator of the
+   * CPU that it runs on.
+   */
+
+  flags = up_irq_save();
+  rs = &g_rng_chacha[RNG_CHACHA_CPU()];
+
+  if (rs->keyed)
+    {
+      rng_chacha_rekey(rs, seed);
+    }
+  else
+    {
+      chacha_keysetup(&rs->ctx, seed, RNG_CHACHA_KEYSZ * 8);
+      chacha_ivsetup(&rs->ctx, seed + RNG_CHACHA_KEYSZ, NULL);
+      rng_chacha_rekey(rs, NULL);
+      rs->keyed = true;
+    }
+
+  rs->count      = CONFIG_CRYPTO_RANDOM_POOL_CHACHA20_RESEED;
+  rs->generation = generation;
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_CHACHA20 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -519,6 +653,10 @@ void up_randompool_initialize(void)
  *   /dev/random approach is susceptible for things like the attacker
  *   exhausting file descriptors on purpose.
  *
+ *   With CONFIG_CRYPTO_RANDOM_POOL_CHACHA20, the bytes come from the
+ *   ChaCha20 generator of the current CPU, which only takes the lock of
+ *   the pool to reseed.
+ *
  *   Note that this function cannot fail, other than by asserting.
  *
  * Input Parameters:
@@ -532,9 +670,54 @@ void up_randompool_initialize(void)
 
 void arc4random_buf(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+  FAR struct rng_chacha_s *rs;
+  FAR uint8_t *out = bytes;
+  FAR uint8_t *keystream;
+  irqstate_t flags;
+  size_t n;
+
+  while (nbytes > 0)
+    {
+      flags = up_irq_save();
+      rs = &g_rng_chacha[RNG_CHACHA_CPU()];
+
+      /* Reseed after CONFIG_CRYPTO_RANDOM_POOL_CHACHA20_RESEED bytes and
+       * after each reseed of the pool.
+       */
+
+      if (rs->count == 0 || rs->generation != g_rng.rd_generation)
+        {
+          up_irq_restore(flags);
+          rng_chacha_stir();
+          continue;
+        }
+
+      if (rs->have == 0)
+        {
+          rng_chacha_rekey(rs, NULL);
+        }
+
+      /* Serve the request from the batch, erasing what was served */
+
+      n = MIN(nbytes, rs->have);
+      n = MIN(n, rs->count);
+      keystream = rs->buf + sizeof(rs->buf) - rs->have;
+
+      memcpy(out, keystream, n);
+      explicit_bzero(keystream, n);
+      rs->have  -= n;
+      rs->count -= n;
+      up_irq_restore(flags);
+
+      out    += n;
+      nbytes -= n;
+    }
+#else
   nxmutex_lock(&g_rng.rd_lock);
   rng_buf_internal(bytes, nbytes);
   nxmutex_unlock(&g_rng.rd_lock);
+#endif
 }
 
 /****************************************************************************
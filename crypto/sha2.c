@@ -38,6 +38,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <endian.h>
 #include <string.h>
 #include <sys/time.h>
@@ -177,6 +179,7 @@ void sha512transform(FAR uint64_t *, FAR const uint8_t *);
 
 /* Hash constant words K for SHA-256: */
 
+#ifndef CONFIG_CRYPTO_SHA256_ARMV8CE
 const static uint32_t K256[64] =
 {
   0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
@@ -196,6 +199,7 @@ const static uint32_t K256[64] =
   0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
   0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul
 };
+#endif
 
 /* Initial hash value H for SHA-256: */
 
@@ -301,6 +305,11 @@ void sha256init(FAR SHA2_CTX *context)
   context->bitcount[0] = 0;
 }
 
+/* With CONFIG_CRYPTO_SHA256_ARMV8CE, sha256transform() is the one of
+ * sha256_armv8ce.c.
+ */
+
+#ifndef CONFIG_CRYPTO_SHA256_ARMV8CE
 #ifdef SHA2_UNROLL_TRANSFORM
 
 /* Unrolled SHA-256 round macros: */
@@ -506,6 +515,7 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 }
 
 #endif /* SHA2_UNROLL_TRANSFORM */
+#endif /* !CONFIG_CRYPTO_SHA256_ARMV8CE */
 
 void sha256update(FAR SHA2_CTX *context,
                   FAR const void *dataptr,
@@ -576,6 +586,145 @@ void sha256update(FAR SHA2_CTX *context,
   usedspace = freespace = 0;
 }
 
+/* Update n contexts with as many messages of the same length at once.
+ * With CONFIG_CRYPTO_SIMD, the contexts are taken SHA256_NLANES at a
+ * time and, if none has a partial block buffered, their blocks are hashed
+ * together, one per lane of the vectors of the SIMD unit.  With the
+ * SHA-256 instructions of the CPU a single block is faster and this is
+ * the same as updating the contexts in turn.
+ */
+
+#if defined(CONFIG_CRYPTO_SIMD) && !defined(CONFIG_CRYPTO_SHA256_ARMV8CE)
+#  ifdef __AVX2__
+#    define SHA256_NLANES 8
+#  else
+#    define SHA256_NLANES 4
+#  endif
+
+typedef uint32_t sha256_vec
+  __attribute__((vector_size(SHA256_NLANES * sizeof(uint32_t))));
+
+static void sha256transform_lanes(FAR SHA2_CTX **ctx,
+                                  FAR const uint8_t **data)
+{
+  sha256_vec v[8];
+  sha256_vec s0;
+  sha256_vec s1;
+  sha256_vec T1;
+  sha256_vec T2;
+  sha256_vec W256[16];
+  FAR const uint8_t *p;
+  int i;
+  int j;
+  int k;
+
+  for (k = 0; k < SHA256_NLANES; k++)
+    {
+      for (i = 0; i < 8; i++)
+        {
+          v[i][k] = ctx[k]->state.st32[i];
+        }
+
+      for (j = 0, p = data[k]; j < 16; j++, p += 4)
+        {
+          W256[j][k] = (uint32_t)p[3] | ((uint32_t)p[2] << 8) |
+                       ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 24);
+        }
+    }
+
+  /* The compression function of sha256transform(), v[0] to v[7] being
+   * a to h.
+   */
+
+  for (j = 0; j < 64; j++)
+    {
+      if (j >= 16)
+        {
+          s0 = sigma0_256(W256[(j + 1) & 0x0f]);
+          s1 = sigma1_256(W256[(j + 14) & 0x0f]);
+          W256[j & 0x0f] += s1 + W256[(j + 9) & 0x0f] + s0;
+        }
+
+      T1 = v[7] + SIGMA1_256(v[4]) + CH(v[4], v[5], v[6]) + K256[j] +
+           W256[j & 0x0f];
+      T2 = SIGMA0_256(v[0]) + MAJ(v[0], v[1], v[2]);
+      v[7] = v[6];
+      v[6] = v[5];
+      v[5] = v[4];
+      v[4] = v[3] + T1;
+      v[3] = v[2];
+      v[2] = v[1];
+      v[1] = v[0];
+      v[0] = T1 + T2;
+    }
+
+  for (k = 0; k < SHA256_NLANES; k++)
+    {
+      for (i = 0; i < 8; i++)
+        {
+          ctx[k]->state.st32[i] += v[i][k];
+        }
+    }
+
+  explicit_bzero(W256, sizeof(W256));
+}
+#endif
+
+void sha256update_multi(FAR SHA2_CTX **ctx, FAR const uint8_t **data,
+                        size_t len, int n)
+{
+  int i = 0;
+#ifdef SHA256_NLANES
+  FAR const uint8_t *p[SHA256_NLANES];
+  size_t done;
+  int k;
+
+  for (; i + SHA256_NLANES <= n; i += SHA256_NLANES)
+    {
+      for (k = 0; k < SHA256_NLANES; k++)
+        {
+          if ((ctx[i + k]->bitcount[0] >> 3) % SHA256_BLOCK_LENGTH != 0)
+            {
+              break;
+            }
+
+          p[k] = data[i + k];
+        }
+
+      if (k < SHA256_NLANES)
+        {
+          for (k = 0; k < SHA256_NLANES; k++)
+            {
+              sha256update(ctx[i + k], data[i + k], len);
+            }
+
+          continue;
+        }
+
+      for (done = 0; len - done >= SHA256_BLOCK_LENGTH;
+           done += SHA256_BLOCK_LENGTH)
+        {
+          sha256transform_lanes(ctx + i, p);
+          for (k = 0; k < SHA256_NLANES; k++)
+            {
+              p[k] += SHA256_BLOCK_LENGTH;
+            }
+        }
+
+      for (k = 0; k < SHA256_NLANES; k++)
+        {
+          ctx[i + k]->bitcount[0] += done << 3;
+          sha256update(ctx[i + k], p[k], len - done);
+        }
+    }
+#endif
+
+  for (; i < n; i++)
+    {
+      sha256update(ctx[i], data[i], len);
+    }
+}
+
 void sha256final(FAR uint8_t *digest, FAR SHA2_CTX *context)
 {
   unsigned int usedspace;
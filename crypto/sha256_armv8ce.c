@@ -0,0 +1,114 @@
+/****************************************************************************
+ * crypto/sha256_armv8ce.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The block transform of SHA-256 with the SHA256H, SHA256H2, SHA256SU0
+ * and SHA256SU1 instructions of the Cryptographic Extension of ARMv8,
+ * instead of the one of sha2.c.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#if !defined(__ARM_FEATURE_SHA2) && !defined(__ARM_FEATURE_CRYPTO)
+#  pragma GCC target("+crypto")
+#endif
+
+#include <arm_neon.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+void sha256transform(FAR uint32_t *, FAR const uint8_t *);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_k256[64] =
+{
+  0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
+  0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+  0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
+  0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+  0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
+  0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+  0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
+  0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+  0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
+  0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+  0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
+  0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+  0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
+  0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+  0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
+  0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+{
+  uint32x4_t msg[4];
+  uint32x4_t abcd;
+  uint32x4_t efgh;
+  uint32x4_t save;
+  uint32x4_t wk;
+  int i;
+
+  abcd = vld1q_u32(state);
+  efgh = vld1q_u32(state + 4);
+
+  for (i = 0; i < 4; i++)
+    {
+      msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+    }
+
+  /* Four rounds per step; msg[i & 3] holds the words of step i and is
+   * then replaced by those of step i + 4.
+   */
+
+  for (i = 0; i < 16; i++)
+    {
+      wk = vaddq_u32(msg[i & 3], vld1q_u32(&g_k256[4 * i]));
+
+      if (i < 12)
+        {
+          msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3],
+                                                       msg[(i + 1) & 3]),
+                                       msg[(i + 2) & 3],
+                                       msg[(i + 3) & 3]);
+        }
+
+      save = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, wk);
+      efgh = vsha256h2q_u32(efgh, save, wk);
+    }
+
+  vst1q_u32(state, vaddq_u32(abcd, vld1q_u32(state)));
+  vst1q_u32(state + 4, vaddq_u32(efgh, vld1q_u32(state + 4)));
+}
@@ -65,7 +65,6 @@
 #include <crypto/rmd160.h>
 #include <crypto/blf.h>
 #include <crypto/cast.h>
-#include <crypto/rijndael.h>
 #include <crypto/aes.h>
 #include <crypto/cryptodev.h>
 #include <crypto/xform.h>
@@ -125,8 +124,8 @@ struct aes_ctr_ctx
 
 struct aes_xts_ctx
 {
-  rijndael_ctx key1;
-  rijndael_ctx key2;
+  AES_CTX key1;
+  AES_CTX key2;
   uint8_t tweak[AES_XTS_BLOCKSIZE];
 };
 
@@ -511,7 +510,7 @@ void aes_xts_reinit(caddr_t key, FAR uint8_t *iv)
 
   bzero(ctx->tweak + AES_XTS_IVSIZE, AES_XTS_IVSIZE);
 
-  rijndael_encrypt(&ctx->key2, ctx->tweak, ctx->tweak);
+  aes_encrypt(&ctx->key2, ctx->tweak, ctx->tweak);
 }
 
 void aes_xts_crypt(FAR struct aes_xts_ctx *ctx,
@@ -530,11 +529,11 @@ void aes_xts_crypt(FAR struct aes_xts_ctx *ctx,
 
   if (do_encrypt)
     {
-      rijndael_encrypt(&ctx->key1, block, data);
+      aes_encrypt(&ctx->key1, block, data);
     }
   else
     {
-      rijndael_decrypt(&ctx->key1, block, data);
+      aes_decrypt(&ctx->key1, block, data);
     }
 
   for (i = 0; i < AES_XTS_BLOCKSIZE; i++)
@@ -577,8 +576,11 @@ int aes_xts_setkey(FAR void *sched, FAR uint8_t *key, int len)
 
   ctx = (FAR struct aes_xts_ctx *)sched;
 
-  rijndael_set_key(&ctx->key1, key, len * 4);
-  rijndael_set_key(&ctx->key2, key + (len / 2), len * 4);
+  if (aes_setkey(&ctx->key1, key, len / 2) != 0 ||
+      aes_setkey(&ctx->key2, key + (len / 2), len / 2) != 0)
+    {
+      return -1;
+    }
 
   return 0;
 }
@@ -54,11 +54,18 @@ static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_reset(FAR struct adc_dev_s *dev);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
+static int     adc_receive_batch(FAR struct adc_dev_s *dev,
+                                 FAR const uint8_t *channels,
+                                 uint8_t nchannels,
+                                 FAR const int32_t *data, size_t count);
 static void    adc_notify(FAR struct adc_dev_s *dev);
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds,
                         bool setup);
 static int     adc_reset_fifo(FAR struct adc_dev_s *dev);
 static int     adc_samples_on_read(FAR struct adc_dev_s *dev);
+static int     adc_get_ring(FAR struct adc_dev_s *dev,
+                            FAR struct adc_ring_s *ring);
+static int     adc_ring_consume(FAR struct adc_dev_s *dev, size_t count);
 
 /****************************************************************************
  * Private Data
@@ -80,14 +87,30 @@ static const struct file_operations g_adc_fops =
 
 static const struct adc_callback_s g_adc_callback =
 {
-  adc_receive,    /* au_receive */
-  adc_reset       /* au_reset */
+  adc_receive,      /* au_receive */
+  adc_reset,        /* au_reset */
+  adc_receive_batch /* au_receive_batch */
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: adc_fifo_count
+ *
+ * Description:
+ *   Return the number of messages queued in the FIFO.
+ *
+ ****************************************************************************/
+
+static inline int adc_fifo_count(FAR struct adc_fifo_s *fifo)
+{
+  int count = fifo->af_tail - fifo->af_head;
+
+  return count < 0 ? count + CONFIG_ADC_FIFOSIZE : count;
+}
+
 /****************************************************************************
  * Name: adc_open
  *
@@ -224,6 +247,7 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
   irqstate_t            flags;
   int                   ret   = 0;
   int                   msglen;
+  int                   count;
 
   ainfo("buflen: %d\n", (int)buflen);
 
@@ -265,11 +289,18 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
       /* Interrupts must be disabled while accessing the ad_recv FIFO */
 
       flags = enter_critical_section();
-      while (dev->ad_recv.af_head == dev->ad_recv.af_tail)
+      while ((count = adc_fifo_count(&dev->ad_recv)) < dev->ad_watermark)
         {
+          /* Non-blocking reads return whatever is queued */
+
+          if (count > 0 && (filep->f_oflags & O_NONBLOCK))
+            {
+              break;
+            }
+
           /* Check if there was an overrun, if set we need to return EIO */
 
-          if (dev->ad_isovr)
+          if (count == 0 && dev->ad_isovr)
             {
               dev->ad_isovr = false;
               ret = -EIO;
@@ -284,7 +315,7 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
               goto return_with_irqdisabled;
             }
 
-          /* Wait for a message to be received */
+          /* Wait for the watermark to be reached */
 
           dev->ad_nrxwaiters++;
           ret = nxsem_wait(&dev->ad_recv.af_sem);
@@ -426,6 +457,32 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case ANIOC_SET_WATERMARK:
+        {
+          if (arg < 1 || arg >= CONFIG_ADC_FIFOSIZE)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              dev->ad_watermark = arg;
+              ret = OK;
+            }
+        }
+        break;
+
+      case ANIOC_GET_RING:
+        {
+          ret = adc_get_ring(dev, (FAR struct adc_ring_s *)(uintptr_t)arg);
+        }
+        break;
+
+      case ANIOC_RING_CONSUME:
+        {
+          ret = adc_ring_consume(dev, arg);
+        }
+        break;
+
       default:
         {
           /* Those IOCTLs might be used in arch specific section */
@@ -488,7 +545,10 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
 
       fifo->af_tail = nexttail;
 
-      adc_notify(dev);
+      if (adc_fifo_count(fifo) >= dev->ad_watermark)
+        {
+          adc_notify(dev);
+        }
 
       errcode = OK;
     }
@@ -496,6 +556,69 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
   return errcode;
 }
 
+/****************************************************************************
+ * Name: adc_receive_batch
+ ****************************************************************************/
+
+static int adc_receive_batch(FAR struct adc_dev_s *dev,
+                             FAR const uint8_t *channels,
+                             uint8_t nchannels,
+                             FAR const int32_t *data, size_t count)
+{
+  FAR struct adc_fifo_s *fifo = &dev->ad_recv;
+  irqstate_t             flags;
+  size_t                 space;
+  size_t                 i;
+  uint16_t               tail;
+  uint8_t                ch;
+  int                    errcode = OK;
+
+  DEBUGASSERT(channels != NULL && nchannels > 0);
+  DEBUGASSERT(data != NULL || count == 0);
+
+  flags = enter_critical_section();
+
+  /* Queue as many samples as fit, the newest ones are dropped */
+
+  space = CONFIG_ADC_FIFOSIZE - 1 - adc_fifo_count(fifo);
+  if (count > space)
+    {
+      count   = space;
+      errcode = -ENOMEM;
+    }
+
+  tail = fifo->af_tail;
+  ch   = 0;
+
+  for (i = 0; i < count; i++)
+    {
+      fifo->af_buffer[tail].am_channel = channels[ch];
+      fifo->af_buffer[tail].am_data    = data[i];
+
+      if (++tail >= CONFIG_ADC_FIFOSIZE)
+        {
+          tail = 0;
+        }
+
+      if (++ch >= nchannels)
+        {
+          ch = 0;
+        }
+    }
+
+  fifo->af_tail = tail;
+
+  /* Wake up the readers once for the whole block */
+
+  if (count > 0 && adc_fifo_count(fifo) >= dev->ad_watermark)
+    {
+      adc_notify(dev);
+    }
+
+  leave_critical_section(flags);
+  return errcode;
+}
+
 /****************************************************************************
  * Name: adc_notify
  ****************************************************************************/
@@ -575,7 +698,7 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
 
       /* Should we immediately notify on any of the requested events? */
 
-      if (dev->ad_recv.af_head != dev->ad_recv.af_tail)
+      if (adc_fifo_count(&dev->ad_recv) >= dev->ad_watermark)
         {
           poll_notify(dev->fds, CONFIG_ADC_NPOLLWAITERS, POLLIN);
         }
@@ -625,23 +748,78 @@ static int adc_samples_on_read(FAR struct adc_dev_s *dev)
 {
   irqstate_t flags;
   FAR struct adc_fifo_s *fifo = &dev->ad_recv;
-  int16_t ret;
+  int ret;
 
   /* Interrupts must be disabled while accessing the ad_recv FIFO */
 
   flags = enter_critical_section();
 
-  ret = fifo->af_tail - fifo->af_head;
+  ret = adc_fifo_count(fifo);
 
   leave_critical_section(flags);
 
-  if (ret < 0)
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_get_ring
+ *
+ * Description:
+ *   Describe the queued messages, so that they can be read in place
+ *   instead of being copied by read().  The FIFO is in the address space of
+ *   the kernel:  This is only usable by the kernel and by applications of
+ *   flat builds.
+ *
+ ****************************************************************************/
+
+static int adc_get_ring(FAR struct adc_dev_s *dev,
+                        FAR struct adc_ring_s *ring)
+{
+  FAR struct adc_fifo_s *fifo = &dev->ad_recv;
+  irqstate_t flags;
+
+  if (ring == NULL)
     {
-      /* Increment return value by the size of FIFO */
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  ring->ar_buffer = fifo->af_buffer;
+  ring->ar_size   = CONFIG_ADC_FIFOSIZE;
+  ring->ar_head   = fifo->af_head;
+  ring->ar_count  = adc_fifo_count(fifo);
+
+  leave_critical_section(flags);
+  return OK;
+}
 
-      ret += CONFIG_ADC_FIFOSIZE;
+/****************************************************************************
+ * Name: adc_ring_consume
+ *
+ * Description:
+ *   Release the oldest count messages after they were read in place.
+ *
+ ****************************************************************************/
+
+static int adc_ring_consume(FAR struct adc_dev_s *dev, size_t count)
+{
+  FAR struct adc_fifo_s *fifo = &dev->ad_recv;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  if (count > (size_t)adc_fifo_count(fifo))
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      fifo->af_head = (fifo->af_head + count) % CONFIG_ADC_FIFOSIZE;
     }
 
+  leave_critical_section(flags);
   return ret;
 }
 
@@ -671,7 +849,8 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
 
   /* Initialize the ADC device structure */
 
-  dev->ad_ocount = 0;
+  dev->ad_ocount    = 0;
+  dev->ad_watermark = 1;
 
   /* Initialize semaphores & mutex */
 
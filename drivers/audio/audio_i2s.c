@@ -26,10 +26,49 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
 
 #include <nuttx/audio/audio.h>
 #include <nuttx/audio/i2s.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_I2S_RXRING
+
+/* The ring is received into by the DMA, so it comes from DMA-capable
+ * memory when the board provides it.  The periods start on their own
+ * cache lines.
+ */
+
+#  ifdef CONFIG_AUDIO_DMAMEMORY
+#    define AUDIO_I2S_RING_ALIGN    CONFIG_AUDIO_DMAMEMORY_ALIGN
+#    define audio_i2s_ringalloc(s)  audio_dma_alloc(s)
+#    define audio_i2s_ringrelease(p) audio_dma_free(p)
+#  else
+#    define AUDIO_I2S_RING_ALIGN    32
+#    define audio_i2s_ringalloc(s)  kumm_memalign(AUDIO_I2S_RING_ALIGN, s)
+#    define audio_i2s_ringrelease(p) kumm_free(p)
+#  endif
+
+#  define AUDIO_I2S_RING_ALIGNUP(x) \
+     (((x) + AUDIO_I2S_RING_ALIGN - 1) & ~(AUDIO_I2S_RING_ALIGN - 1))
+
+/* The periods received into while the application holds the next period
+ * of the ring, one per period queued
+ */
+
+#  define AUDIO_I2S_RING_NSPARES    CONFIG_AUDIO_I2S_RXRING_DEPTH
+
+#  ifndef CONFIG_SPINLOCK
+#    define SP_DMB()
+#  endif
+#endif
 
 /****************************************************************************
  * Private Types
@@ -40,6 +79,14 @@ struct audio_i2s_s
   struct audio_lowerhalf_s dev;
   struct i2s_dev_s *i2s;
   bool playback;
+#ifdef CONFIG_AUDIO_I2S_RXRING
+  FAR struct audio_ring_s *ring;   /* The capture ring, or NULL */
+  FAR struct ap_buffer_s *rxapb;   /* The periods, then the spare ones */
+  uint32_t next;                   /* The next period to receive into */
+  uint32_t seq;                    /* Sequence number of the next period */
+  uint8_t spare;                   /* The next spare period */
+  volatile bool running;           /* The ring is being received into */
+#endif
 };
 
 /****************************************************************************
@@ -94,6 +141,9 @@ static int audio_i2s_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
 static void audio_i2s_callback(struct i2s_dev_s *dev,
                                FAR struct ap_buffer_s *apb, FAR void *arg,
                                int result);
+#ifdef CONFIG_AUDIO_I2S_RXRING
+static int audio_i2s_ringsubmit(FAR struct audio_i2s_s *audio_i2s);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -127,6 +177,210 @@ static const struct audio_ops_s g_audio_i2s_ops =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_I2S_RXRING
+
+/****************************************************************************
+ * Name: audio_i2s_ringfree
+ *
+ * Description:
+ *   Release the capture ring and its buffers.
+ *
+ ****************************************************************************/
+
+static void audio_i2s_ringfree(FAR struct audio_i2s_s *audio_i2s)
+{
+  uint32_t i;
+
+  if (audio_i2s->ring == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < audio_i2s->ring->nperiods + AUDIO_I2S_RING_NSPARES; i++)
+    {
+      nxmutex_destroy(&audio_i2s->rxapb[i].lock);
+    }
+
+  kmm_free(audio_i2s->rxapb);
+  audio_i2s_ringrelease(audio_i2s->ring);
+
+  audio_i2s->rxapb = NULL;
+  audio_i2s->ring  = NULL;
+}
+
+/****************************************************************************
+ * Name: audio_i2s_setring
+ *
+ * Description:
+ *   Handle AUDIOIOC_SETRXRING: replace the capture ring by one of
+ *   req->nperiods periods of req->period_bytes bytes.  One buffer is set
+ *   up per period, its samples in the ring, so that the DMA receives into
+ *   the ring directly.
+ *
+ ****************************************************************************/
+
+static int audio_i2s_setring(FAR struct audio_i2s_s *audio_i2s,
+                             FAR const struct audio_ring_req_s *req)
+{
+  FAR struct audio_ring_s *ring;
+  FAR struct ap_buffer_s *apb;
+  size_t stride;
+  size_t data;
+  uint32_t n;
+  uint32_t i;
+
+  if (audio_i2s->playback || req == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (audio_i2s->running)
+    {
+      return -EBUSY;
+    }
+
+  audio_i2s_ringfree(audio_i2s);
+  if (req->nperiods == 0)
+    {
+      return OK;
+    }
+
+  if (req->nperiods <= CONFIG_AUDIO_I2S_RXRING_DEPTH ||
+      req->period_bytes == 0 ||
+      req->period_bytes != (apb_samp_t)req->period_bytes)
+    {
+      return -EINVAL;
+    }
+
+  n      = req->nperiods + AUDIO_I2S_RING_NSPARES;
+  stride = AUDIO_I2S_RING_ALIGNUP(req->period_bytes);
+  data   = AUDIO_I2S_RING_ALIGNUP(offsetof(struct audio_ring_s, slot) +
+                                  req->nperiods *
+                                  sizeof(struct audio_ring_slot_s));
+
+  ring = audio_i2s_ringalloc(data + n * stride);
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  audio_i2s->rxapb = kmm_zalloc(n * sizeof(struct ap_buffer_s));
+  if (audio_i2s->rxapb == NULL)
+    {
+      audio_i2s_ringrelease(ring);
+      return -ENOMEM;
+    }
+
+  memset(ring, 0, data);
+  ring->nperiods     = req->nperiods;
+  ring->period_bytes = req->period_bytes;
+  ring->stride       = stride;
+  ring->data         = data;
+
+  for (i = 0; i < n; i++)
+    {
+      apb             = &audio_i2s->rxapb[i];
+      apb->i.channels = 1;
+      apb->crefs      = 1;
+      apb->nmaxbytes  = req->period_bytes;
+      apb->samp       = (FAR uint8_t *)ring + data + i * stride;
+      nxmutex_init(&apb->lock);
+    }
+
+  audio_i2s->ring  = ring;
+  audio_i2s->next  = 0;
+  audio_i2s->seq   = 0;
+  audio_i2s->spare = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_i2s_ringsubmit
+ *
+ * Description:
+ *   Queue the next period of the ring to the I2S lower half or, if the
+ *   application still holds it, a spare period so that the capture goes
+ *   on without a gap in the clock.
+ *
+ ****************************************************************************/
+
+static int audio_i2s_ringsubmit(FAR struct audio_i2s_s *audio_i2s)
+{
+  FAR struct audio_ring_s *ring = audio_i2s->ring;
+  FAR struct ap_buffer_s *apb;
+  uint32_t i = audio_i2s->next % ring->nperiods;
+
+  if (ring->slot[i].status == AUDIO_RING_KERNEL)
+    {
+      apb = &audio_i2s->rxapb[i];
+      audio_i2s->next++;
+    }
+  else
+    {
+      apb = &audio_i2s->rxapb[ring->nperiods + audio_i2s->spare];
+      audio_i2s->spare = (audio_i2s->spare + 1) % AUDIO_I2S_RING_NSPARES;
+    }
+
+  apb->nbytes  = 0;
+  apb->curbyte = 0;
+
+  return I2S_RECEIVE(audio_i2s->i2s, apb, audio_i2s_callback, audio_i2s,
+                     0);
+}
+
+/****************************************************************************
+ * Name: audio_i2s_ringdone
+ *
+ * Description:
+ *   A period of the ring was received: hand it to the application and
+ *   queue the next one.  The periods complete in the order they were
+ *   queued, so the sequence numbers follow the capture.
+ *
+ ****************************************************************************/
+
+static void audio_i2s_ringdone(FAR struct audio_i2s_s *audio_i2s,
+                               FAR struct ap_buffer_s *apb, int result)
+{
+  FAR struct audio_ring_s *ring = audio_i2s->ring;
+  uint32_t i = apb - audio_i2s->rxapb;
+  int ret;
+
+  if (!audio_i2s->running)
+    {
+      return;
+    }
+
+  if (result < 0)
+    {
+      auderr("ERROR: Receive failed: %d\n", result);
+    }
+
+  if (i < ring->nperiods)
+    {
+      ring->slot[i].nbytes = result < 0 ? 0 : apb->nbytes;
+      ring->slot[i].seq    = audio_i2s->seq++;
+
+      /* The slot must be complete before the application sees it */
+
+      SP_DMB();
+      ring->slot[i].status = AUDIO_RING_USER;
+    }
+  else
+    {
+      /* A spare period: the one of the ring was lost */
+
+      audio_i2s->seq++;
+      ring->overruns++;
+    }
+
+  ret = audio_i2s_ringsubmit(audio_i2s);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to queue a period: %d\n", ret);
+    }
+}
+#endif /* CONFIG_AUDIO_I2S_RXRING */
+
 static int audio_i2s_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
                              FAR struct audio_caps_s *caps)
 {
@@ -274,6 +528,13 @@ static int audio_i2s_shutdown(FAR struct audio_lowerhalf_s *dev)
   FAR struct audio_i2s_s *audio_i2s = (struct audio_i2s_s *)dev;
   FAR struct i2s_dev_s *i2s = audio_i2s->i2s;
 
+#ifdef CONFIG_AUDIO_I2S_RXRING
+  if (!audio_i2s->running)
+    {
+      audio_i2s_ringfree(audio_i2s);
+    }
+#endif
+
   return I2S_IOCTL(i2s, AUDIOIOC_SHUTDOWN, audio_i2s->playback);
 }
 
@@ -286,6 +547,26 @@ static int audio_i2s_start(FAR struct audio_lowerhalf_s *dev)
 {
   FAR struct audio_i2s_s *audio_i2s = (struct audio_i2s_s *)dev;
   FAR struct i2s_dev_s *i2s = audio_i2s->i2s;
+#ifdef CONFIG_AUDIO_I2S_RXRING
+  int ret;
+  int i;
+
+  /* Queue the first periods of the ring before the clock starts */
+
+  if (audio_i2s->ring != NULL && !audio_i2s->running)
+    {
+      audio_i2s->running = true;
+      for (i = 0; i < CONFIG_AUDIO_I2S_RXRING_DEPTH; i++)
+        {
+          ret = audio_i2s_ringsubmit(audio_i2s);
+          if (ret < 0)
+            {
+              audio_i2s->running = false;
+              return ret;
+            }
+        }
+    }
+#endif
 
   return I2S_IOCTL(i2s, AUDIOIOC_START, audio_i2s->playback);
 }
@@ -301,6 +582,12 @@ static int audio_i2s_stop(FAR struct audio_lowerhalf_s *dev)
   FAR struct audio_i2s_s *audio_i2s = (struct audio_i2s_s *)dev;
   FAR struct i2s_dev_s *i2s = audio_i2s->i2s;
 
+#ifdef CONFIG_AUDIO_I2S_RXRING
+  /* The periods still queued are not handed out nor queued again */
+
+  audio_i2s->running = false;
+#endif
+
   return I2S_IOCTL(i2s, AUDIOIOC_STOP, audio_i2s->playback);
 }
 #endif
@@ -338,8 +625,19 @@ static int audio_i2s_allocbuffer(FAR struct audio_lowerhalf_s *dev,
 {
   FAR struct audio_i2s_s *audio_i2s = (struct audio_i2s_s *)dev;
   FAR struct i2s_dev_s *i2s = audio_i2s->i2s;
+  int ret;
 
-  return I2S_IOCTL(i2s, AUDIOIOC_ALLOCBUFFER, (unsigned long)bufdesc);
+  /* Without an allocator of the I2S lower half, the buffers of apb_alloc()
+   * are DMA-capable with CONFIG_AUDIO_DMAMEMORY and are sent as they are.
+   */
+
+  ret = I2S_IOCTL(i2s, AUDIOIOC_ALLOCBUFFER, (unsigned long)bufdesc);
+  if (ret == -ENOTTY)
+    {
+      ret = apb_alloc(bufdesc);
+    }
+
+  return ret;
 }
 
 static int audio_i2s_freebuffer(FAR struct audio_lowerhalf_s *dev,
@@ -347,8 +645,17 @@ static int audio_i2s_freebuffer(FAR struct audio_lowerhalf_s *dev,
 {
   FAR struct audio_i2s_s *audio_i2s = (struct audio_i2s_s *)dev;
   FAR struct i2s_dev_s *i2s = audio_i2s->i2s;
+  int ret;
 
-  return I2S_IOCTL(i2s, AUDIOIOC_FREEBUFFER, (unsigned long)bufdesc);
+  ret = I2S_IOCTL(i2s, AUDIOIOC_FREEBUFFER, (unsigned long)bufdesc);
+  if (ret == -ENOTTY)
+    {
+      DEBUGASSERT(bufdesc->u.buffer != NULL);
+      apb_free(bufdesc->u.buffer);
+      ret = sizeof(struct audio_buf_desc_s);
+    }
+
+  return ret;
 }
 
 static int audio_i2s_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
@@ -373,6 +680,30 @@ static int audio_i2s_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
   FAR struct audio_i2s_s *audio_i2s = (struct audio_i2s_s *)dev;
   FAR struct i2s_dev_s *i2s = audio_i2s->i2s;
 
+#ifdef CONFIG_AUDIO_I2S_RXRING
+  switch (cmd)
+    {
+      case AUDIOIOC_SETRXRING:
+        return audio_i2s_setring(audio_i2s,
+                                 (FAR const struct audio_ring_req_s *)
+                                 (uintptr_t)arg);
+
+      /* Map the capture ring, see AUDIOIOC_SETRXRING */
+
+      case FIOC_MMAP:
+        if (audio_i2s->ring == NULL)
+          {
+            return -EINVAL;
+          }
+
+        *(FAR void **)(uintptr_t)arg = audio_i2s->ring;
+        return OK;
+
+      default:
+        break;
+    }
+#endif
+
   return I2S_IOCTL(i2s, cmd, arg);
 }
 
@@ -406,6 +737,18 @@ static void audio_i2s_callback(struct i2s_dev_s *dev,
   FAR struct audio_i2s_s *audio_i2s = arg;
   bool final = false;
 
+#ifdef CONFIG_AUDIO_I2S_RXRING
+  /* The periods of the ring are not seen by the upper half */
+
+  if (audio_i2s->ring != NULL && apb >= audio_i2s->rxapb &&
+      apb < audio_i2s->rxapb + audio_i2s->ring->nperiods +
+            AUDIO_I2S_RING_NSPARES)
+    {
+      audio_i2s_ringdone(audio_i2s, apb, result);
+      return;
+    }
+#endif
+
   if ((apb->flags & AUDIO_APB_FINAL) != 0)
     {
       final = true;
@@ -34,28 +34,73 @@
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Sector cache geometry.  Line (way, set) is lines[way * NSETS + set]; the
+ * data of the lines is stored in the same order, so the lines of one way
+ * hold consecutive sectors in consecutive memory.
+ */
+
+#ifndef CONFIG_BCH_CACHE_NSETS
+#  define CONFIG_BCH_CACHE_NSETS 1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_NWAYS
+#  define CONFIG_BCH_CACHE_NWAYS 1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_READAHEAD
+#  define CONFIG_BCH_CACHE_READAHEAD 0
+#endif
+
+#define BCH_CACHE_NLINES  (CONFIG_BCH_CACHE_NSETS * CONFIG_BCH_CACHE_NWAYS)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One line of the sector cache */
+
+struct bchlib_line_s
+{
+  size_t sector;           /* The sector in the line or (size_t)-1 */
+  uint32_t stamp;          /* Time of the last access (for LRU) */
+  bool dirty;              /* true: Data has been written to the line */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t nextsector;       /* The sector after the last one accessed */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *dax;        /* The media mapped in memory, or NULL */
+  FAR uint8_t *buffer;     /* Data of the current sector */
+
+  /* The sector cache */
+
+  FAR struct bchlib_line_s *line; /* Cache line of the current sector */
+  FAR uint8_t *cache;             /* Data of all cache lines */
+  uint32_t stamp;                 /* LRU clock */
+  struct bchlib_line_s lines[BCH_CACHE_NLINES];
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+  struct work_s work;      /* Deferred write-back of dirty lines */
+  int wbcount;             /* Write-back work queued or running */
+  bool wbcancel;           /* true: The device is being torn down */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -81,9 +126,34 @@ EXTERN const struct file_operations bch_fops;
  * Public Function Prototypes
  ****************************************************************************/
 
+/* Write all dirty cache lines to the media */
+
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
+
+/* Make 'sector' the current sector: bch->buffer then holds its data */
+
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
 
+/* Mark the current sector as modified */
+
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch);
+
+/* Copy dirty cached sectors over data that was read from the media */
+
+EXTERN void bchlib_mergedirty(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                              size_t sector, size_t nsectors);
+
+/* Drop cached sectors that were written to the media directly */
+
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
+
+/* Stop the write-back work before the device is freed */
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+EXTERN void bchlib_cancelwriteback(FAR struct bchlib_s *bch);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
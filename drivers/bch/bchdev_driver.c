@@ -426,6 +426,24 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* The device can be mapped if the media is accessed in place */
+
+      case FIOC_MMAP:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          if (bch->dax != NULL && ppv != NULL)
+            {
+              *ppv = bch->dax;
+              ret  = OK;
+            }
+          else
+            {
+              ret = -ENOTTY;
+            }
+        }
+        break;
+
 #ifdef CONFIG_BCH_ENCRYPTION
       /* This is a request to set the encryption key? */
 
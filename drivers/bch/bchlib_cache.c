@@ -28,14 +28,30 @@
 #include <stdbool.h>
 #include <errno.h>
 #include <assert.h>
+#include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/signal.h>
+
 #include "bch.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 #  include <nuttx/crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BCH_NSETS         CONFIG_BCH_CACHE_NSETS
+#define BCH_NWAYS         CONFIG_BCH_CACHE_NWAYS
+
+/* Index of the line (way, set) and address of its data */
+
+#define BCH_LINE(w, s)    ((w) * BCH_NSETS + (s))
+#define BCH_DATA(b, i)    (&(b)->cache[(size_t)(i) * (b)->sectsize])
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -59,10 +75,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -70,7 +87,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -89,69 +106,283 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bchlib_findline
+ *
+ * Description:
+ *   Return the index of the line that holds 'sector' or -1 if the sector
+ *   is not in the cache.
+ *
  ****************************************************************************/
 
+static int bchlib_findline(FAR struct bchlib_s *bch, size_t sector)
+{
+  int set = sector % BCH_NSETS;
+  int way;
+
+  for (way = 0; way < BCH_NWAYS; way++)
+    {
+      if (bch->lines[BCH_LINE(way, set)].sector == sector)
+        {
+          return BCH_LINE(way, set);
+        }
+    }
+
+  return -1;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_victim
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Select the line of the set of 'sector' that will be replaced: an
+ *   unused line if there is one, the least recently used one otherwise.
  *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ ****************************************************************************/
+
+static int bchlib_victim(FAR struct bchlib_s *bch, size_t sector)
+{
+  int set = sector % BCH_NSETS;
+  uint32_t maxage = 0;
+  int victim = set;
+  int way;
+
+  for (way = 0; way < BCH_NWAYS; way++)
+    {
+      FAR struct bchlib_line_s *line = &bch->lines[BCH_LINE(way, set)];
+
+      if (line->sector == (size_t)-1)
+        {
+          return BCH_LINE(way, set);
+        }
+
+      /* The age is computed relative to the clock so that the comparison
+       * survives a wrap-around of the stamps.
+       */
+
+      if (bch->stamp - line->stamp >= maxage)
+        {
+          maxage = bch->stamp - line->stamp;
+          victim = BCH_LINE(way, set);
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushrun
+ *
+ * Description:
+ *   Write the dirty line 'index' to the media together with the dirty
+ *   lines that follow it in the same way and hold the following sectors,
+ *   so that a sequential run is written with a single request.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bchlib_flushrun(FAR struct bchlib_s *bch, int index)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct inode *inode = bch->inode;
+  FAR struct bchlib_line_s *line = &bch->lines[index];
+  int set = index % BCH_NSETS;
+  int count = 1;
+  ssize_t ret;
+  int i;
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
+  while (set + count < BCH_NSETS && line[count].dirty &&
+         line[count].sector == line->sector + count)
+    {
+      count++;
+    }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
 
-  if (bch->dirty)
+  for (i = 0; i < count; i++)
     {
-      inode = bch->inode;
+      bch_cypher(bch, BCH_DATA(bch, index + i), line->sector + i,
+                 CYPHER_ENCRYPT);
+    }
+#endif
+
+  /* Write the sectors to the media */
+
+  ret = inode->u.i_bops->write(inode, BCH_DATA(bch, index), line->sector,
+                               count);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-      /* Encrypt data as necessary */
+  /* Computation overhead to save memory for extra sector buffer */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+  for (i = 0; i < count; i++)
+    {
+      bch_cypher(bch, BCH_DATA(bch, index + i), line->sector + i,
+                 CYPHER_DECRYPT);
+    }
 #endif
 
-      /* Write the sector to the media */
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
+  /* The sectors are now in sync with the media */
+
+  for (i = 0; i < count; i++)
+    {
+      line[i].dirty = false;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_fill
+ *
+ * Description:
+ *   Read 'sector' into the line 'index'.  If the access is sequential, the
+ *   following sectors are read ahead with the same request into the next
+ *   lines of the same way, as long as those lines are clean and the
+ *   sectors are not already cached elsewhere.
+ *
+ ****************************************************************************/
+
+static int bchlib_fill(FAR struct bchlib_s *bch, int index, size_t sector)
+{
+  FAR struct inode *inode = bch->inode;
+  FAR struct bchlib_line_s *line = &bch->lines[index];
+  size_t count = 1;
+  ssize_t ret;
+  size_t i;
+
+#if CONFIG_BCH_CACHE_READAHEAD > 0
+  if (sector == bch->nextsector)
+    {
+      int set = index % BCH_NSETS;
+
+      while (count <= CONFIG_BCH_CACHE_READAHEAD &&
+             set + count < BCH_NSETS &&
+             sector + count < bch->nsectors &&
+             !line[count].dirty &&
+             bchlib_findline(bch, sector + count) < 0)
         {
-          ferr("Write failed: %zd\n", ret);
-          return (int)ret;
+          count++;
         }
+    }
+#endif
+
+  for (i = 0; i < count; i++)
+    {
+      line[i].sector = (size_t)-1;
+    }
 
+  ret = inode->u.i_bops->read(inode, BCH_DATA(bch, index), sector, count);
+  if (ret < 0)
+    {
+      ferr("Read failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      line[i].sector = sector + i;
+      line[i].stamp  = bch->stamp;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
+      bch_cypher(bch, BCH_DATA(bch, index + i), sector + i,
+                 CYPHER_DECRYPT);
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_writeback
+ *
+ * Description:
+ *   Work queue callback that writes the dirty lines back to the media
+ *   some time after they were modified.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+static void bchlib_writeback(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = (FAR struct bchlib_s *)arg;
+  irqstate_t flags;
+
+  if (nxmutex_trylock(&bch->lock) < 0)
+    {
+      /* The device is busy; try again later unless it is going away */
+
+      flags = enter_critical_section();
+      if (!bch->wbcancel)
+        {
+          work_queue(LPWORK, &bch->work, bchlib_writeback, bch,
+                     MSEC2TICK(CONFIG_BCH_CACHE_WRITEBACK_DELAY));
+        }
+      else
+        {
+          bch->wbcount--;
+        }
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  bchlib_flushsector(bch);
+  nxmutex_unlock(&bch->lock);
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+  /* bchlib_cancelwriteback() may free the structure as soon as the count
+   * drops to zero, so this must be the last access.
+   */
+
+  flags = enter_critical_section();
+  bch->wbcount--;
+  leave_critical_section(flags);
+}
 #endif
 
-      /* The sector is now in sync with the media */
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Write all dirty sectors in the cache to the media
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch)
+{
+  int ret = OK;
+  int i;
 
-      bch->dirty = false;
+  for (i = 0; i < BCH_CACHE_NLINES; i++)
+    {
+      if (bch->lines[i].dirty)
+        {
+          int err = bchlib_flushrun(bch, i);
+          if (err < 0)
+            {
+              ret = err;
+            }
+        }
     }
 
-  return (int)ret;
+  return ret;
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make 'sector' the current sector, reading it into the cache if
+ *   necessary.  On success, bch->buffer holds the data of the sector.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -160,34 +391,162 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  int index;
+  int ret;
+
+  bch->stamp++;
 
-  if (bch->sector != sector)
+  index = bchlib_findline(bch, sector);
+  if (index < 0)
     {
-      inode = bch->inode;
+      index = bchlib_victim(bch, sector);
+      if (bch->lines[index].dirty)
+        {
+          ret = bchlib_flushrun(bch, index);
+          if (ret < 0)
+            {
+              ferr("Flush failed: %d\n", ret);
+              return ret;
+            }
+        }
 
-      ret = bchlib_flushsector(bch);
+      ret = bchlib_fill(bch, index, sector);
       if (ret < 0)
         {
-          ferr("Flush failed: %zd\n", ret);
-          return (int)ret;
+          return ret;
         }
+    }
 
-      bch->sector = (size_t)-1;
+  bch->line        = &bch->lines[index];
+  bch->line->stamp  = bch->stamp;
+  bch->buffer      = BCH_DATA(bch, index);
+  bch->nextsector  = sector + 1;
+  return OK;
+}
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark the current sector as modified.  With write-back enabled, the
+ *   sector is written to the media after a delay unless it is flushed
+ *   earlier.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch)
+{
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+  irqstate_t flags;
+#endif
+
+  DEBUGASSERT(bch->line != NULL);
+  bch->line->dirty = true;
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+  flags = enter_critical_section();
+  if (bch->wbcount == 0 && !bch->wbcancel)
+    {
+      bch->wbcount++;
+      work_queue(LPWORK, &bch->work, bchlib_writeback, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_WRITEBACK_DELAY));
+    }
+
+  leave_critical_section(flags);
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_mergedirty
+ *
+ * Description:
+ *   Sectors [sector, sector + nsectors) were read from the media directly
+ *   into 'buffer'.  Replace the ones that are modified in the cache with
+ *   the cached data.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_mergedirty(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                       size_t sector, size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < BCH_CACHE_NLINES; i++)
+    {
+      FAR struct bchlib_line_s *line = &bch->lines[i];
+
+      if (line->dirty && line->sector >= sector &&
+          line->sector - sector < nsectors)
         {
-          ferr("Read failed: %zd\n", ret);
-          return (int)ret;
+          memcpy(&buffer[(line->sector - sector) * bch->sectsize],
+                 BCH_DATA(bch, i), bch->sectsize);
         }
+    }
+}
 
-      bch->sector = sector;
-#if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Sectors [sector, sector + nsectors) were written to the media
+ *   directly.  Drop them from the cache, discarding older modifications.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < BCH_CACHE_NLINES; i++)
+    {
+      FAR struct bchlib_line_s *line = &bch->lines[i];
+
+      if (line->sector >= sector && line->sector - sector < nsectors)
+        {
+          line->sector = (size_t)-1;
+          line->dirty  = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_cancelwriteback
+ *
+ * Description:
+ *   Stop the write-back work and wait until it is no longer running so
+ *   that the structure can be freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+void bchlib_cancelwriteback(FAR struct bchlib_s *bch)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  bch->wbcancel = true;
+  if (bch->wbcount > 0 && work_cancel(LPWORK, &bch->work) == OK)
+    {
+      bch->wbcount--;
     }
 
-  return (int)ret;
+  leave_critical_section(flags);
+
+  /* The worker may be running; it holds the lock or is about to give up */
+
+  while (bch->wbcount > 0)
+    {
+      nxsig_usleep(1000);
+    }
 }
+#endif
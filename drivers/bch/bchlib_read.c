@@ -92,6 +92,17 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
       return 0;
     }
 
+  if (bch->dax != NULL)
+    {
+      if (len > bch->nsectors * bch->sectsize - offset)
+        {
+          len = bch->nsectors * bch->sectsize - offset;
+        }
+
+      memcpy(buffer, bch->dax + offset, len);
+      return len;
+    }
+
   /* Read the initial partial sector */
 
   bytesread = 0;
@@ -152,6 +163,10 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
           return ret;
         }
 
+      /* The cache may hold newer data than the media */
+
+      bchlib_mergedirty(bch, (FAR uint8_t *)buffer, sector, nsectors);
+
       /* Adjust pointers and counts */
 
       sector    += nsectors;
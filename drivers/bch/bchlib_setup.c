@@ -56,7 +56,11 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 {
   FAR struct bchlib_s *bch;
   struct geometry geo;
+#ifndef CONFIG_BCH_ENCRYPTION
+  struct bio_dax_s dax;
+#endif
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -107,17 +111,39 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   nxmutex_init(&bch->lock);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
-  /* Allocate the sector I/O buffer */
+  for (i = 0; i < BCH_CACHE_NLINES; i++)
+    {
+      bch->lines[i].sector = (size_t)-1;
+    }
+
+#ifndef CONFIG_BCH_ENCRYPTION
+  /* If the whole media is memory, access it in place instead of through
+   * the sector cache.  Unless writes can be done in place too, this is
+   * only coherent for read-only access.
+   */
+
+  dax.startsector = 0;
+  dax.nsectors    = bch->nsectors;
+  if (bch->inode->u.i_bops->ioctl != NULL &&
+      bch->inode->u.i_bops->ioctl(bch->inode, BIOC_DAX,
+                                  (unsigned long)((uintptr_t)&dax)) >= 0 &&
+      dax.nsectors >= bch->nsectors && (readonly || dax.writable))
+    {
+      bch->dax = dax.addr;
+    }
+#endif
+
+  /* Allocate the sector cache */
 
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-  bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+  bch->cache = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                            BCH_CACHE_NLINES * bch->sectsize);
 #else
-  bch->buffer = kmm_malloc(bch->sectsize);
+  bch->cache = kmm_malloc(BCH_CACHE_NLINES * bch->sectsize);
 #endif
-  if (!bch->buffer)
+  if (!bch->cache)
     {
       ferr("ERROR: Failed to allocate sector buffer\n");
       ret = -ENOMEM;
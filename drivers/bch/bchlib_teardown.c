@@ -60,6 +60,12 @@ int bchlib_teardown(FAR void *handle)
       return -EBUSY;
     }
 
+#ifdef CONFIG_BCH_CACHE_WRITEBACK
+  /* Stop the deferred write-back */
+
+  bchlib_cancelwriteback(bch);
+
+#endif
   /* Flush any pending data to the block driver */
 
   bchlib_flushsector(bch);
@@ -70,9 +76,9 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
-  if (bch->buffer)
+  if (bch->cache)
     {
-      kmm_free(bch->buffer);
+      kmm_free(bch->cache);
     }
 
   nxmutex_destroy(&bch->lock);
@@ -77,6 +77,17 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       return -EFBIG;
     }
 
+  if (bch->dax != NULL)
+    {
+      if (len > bch->nsectors * bch->sectsize - offset)
+        {
+          len = bch->nsectors * bch->sectsize - offset;
+        }
+
+      memcpy(bch->dax + offset, buffer, len);
+      return len;
+    }
+
   /* Write the initial partial sector */
 
   byteswritten = 0;
@@ -102,7 +113,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
         }
 
       memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust pointers and counts */
 
@@ -130,8 +141,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
+      /* Drop the cached copies of the sectors that are overwritten, then
+       * flush the other dirty sectors to keep the sector sequence.
+       */
 
+      bchlib_invalidate(bch, sector, nsectors);
       ret = bchlib_flushsector(bch);
       if (ret < 0)
         {
@@ -179,7 +193,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       /* Copy the head end of the sector from the user buffer */
 
       memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust counts */
 
@@ -105,6 +105,10 @@ static uint8_t        can_bytes2dlc(uint8_t nbytes);
 #ifdef CONFIG_CAN_TXREADY
 static void           can_txready_work(FAR void *arg);
 #endif
+#ifdef CONFIG_CAN_TXPRIORITY
+static uint32_t       can_txpriority(FAR const struct can_hdr_s *hdr);
+static void           can_txselect(FAR struct can_txfifo_s *fifo);
+#endif
 
 /* Character driver methods */
 
@@ -316,6 +320,101 @@ static void can_txready_work(FAR void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: can_txpriority
+ *
+ * Description:
+ *   Return the bus arbitration priority of a message:  The bits of the
+ *   value are those of the arbitration field, so the smaller value wins on
+ *   the bus.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CAN_TXPRIORITY
+static uint32_t can_txpriority(FAR const struct can_hdr_s *hdr)
+{
+#ifdef CONFIG_CAN_EXTID
+  if (hdr->ch_extid)
+    {
+      /* Base ID, recessive SRR and IDE bits, ID extension and RTR */
+
+      return (uint32_t)(hdr->ch_id >> 18) << 21 | (uint32_t)3 << 19 |
+             (uint32_t)(hdr->ch_id & 0x3ffff) << 1 | hdr->ch_rtr;
+    }
+#endif
+
+  /* ID, RTR and dominant IDE bits */
+
+  return (uint32_t)(hdr->ch_id & 0x7ff) << 21 | (uint32_t)hdr->ch_rtr << 20;
+}
+
+/****************************************************************************
+ * Name: can_txselect
+ *
+ * Description:
+ *   Move the queued message with the highest priority to the queue index
+ *   of the TX FIFO, keeping the order of the others, so that it is sent to
+ *   the hardware next.  A high priority message then never waits for the
+ *   lower priority ones written before it, which could lose the bus
+ *   arbitration for a long time.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled
+ *
+ ****************************************************************************/
+
+static void can_txselect(FAR struct can_txfifo_s *fifo)
+{
+  struct can_msg_s msg;
+  uint32_t best;
+  uint32_t prio;
+  int bestndx;
+  int prevndx;
+  int ndx;
+
+  bestndx = fifo->tx_queue;
+  best    = can_txpriority(&fifo->tx_buffer[bestndx].cm_hdr);
+
+  for (ndx = bestndx; ; )
+    {
+      if (++ndx >= CONFIG_CAN_FIFOSIZE)
+        {
+          ndx = 0;
+        }
+
+      if (ndx == fifo->tx_tail)
+        {
+          break;
+        }
+
+      prio = can_txpriority(&fifo->tx_buffer[ndx].cm_hdr);
+      if (prio < best)
+        {
+          best    = prio;
+          bestndx = ndx;
+        }
+    }
+
+  if (bestndx == fifo->tx_queue)
+    {
+      return;
+    }
+
+  /* Shift the messages before it up by one */
+
+  memcpy(&msg, &fifo->tx_buffer[bestndx], sizeof(struct can_msg_s));
+
+  for (ndx = bestndx; ndx != fifo->tx_queue; ndx = prevndx)
+    {
+      prevndx = ndx > 0 ? ndx - 1 : CONFIG_CAN_FIFOSIZE - 1;
+      memcpy(&fifo->tx_buffer[ndx], &fifo->tx_buffer[prevndx],
+             sizeof(struct can_msg_s));
+    }
+
+  memcpy(&fifo->tx_buffer[fifo->tx_queue], &msg, sizeof(struct can_msg_s));
+}
+#endif
+
 static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 {
   FAR struct can_reader_s *reader = kmm_zalloc(sizeof(struct can_reader_s));
@@ -699,6 +798,12 @@ static int can_xmit(FAR struct can_dev_s *dev)
 
       DEBUGASSERT(dev->cd_xmit.tx_head != dev->cd_xmit.tx_tail);
 
+#ifdef CONFIG_CAN_TXPRIORITY
+      /* Send the queued message that would win the bus arbitration */
+
+      can_txselect(&dev->cd_xmit);
+#endif
+
       /* Increment the FIFO queue index before sending (because dev_send()
        * might call can_txdone()).
        */
@@ -2025,11 +2025,13 @@ static void mcp2515_error(FAR struct can_dev_s *dev, uint8_t status,
  * Name: mcp2515_receive
  *
  * Description:
- *   Receive an MCP2515 messages
+ *   Receive an MCP2515 messages.  The message is read with the READ RX
+ *   BUFFER instruction, in a single SPI transfer that also clears the
+ *   receive interrupt flag of the buffer.
  *
  * Input Parameters:
  *   dev      - CAN-common state data
- *   rxbuffer - The RX buffer containing the received messages
+ *   offset   - MCP2515_RX0_OFFSET or MCP2515_RX1_OFFSET
  *
  * Returned Value:
  *   None
@@ -2049,8 +2051,14 @@ static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t offset)
   priv = dev->cd_priv;
   DEBUGASSERT(priv);
 
-  mcp2515_readregs(priv, MCP2515_RXB0CTRL + offset, priv->spi_rxbuf,
-                   SPI_TRANSFER_BUF_LEN);
+  /* The registers from RXBnSIDH on follow the instruction byte, so they
+   * are at their offsets from RXBnCTRL in spi_rxbuf[].
+   */
+
+  memset(priv->spi_txbuf, 0, SPI_TRANSFER_BUF_LEN);
+  priv->spi_txbuf[0] = offset == MCP2515_RX0_OFFSET ? MCP2515_READ_RX0 :
+                                                      MCP2515_READ_RX1;
+  mcp2515_transfer(priv, SPI_TRANSFER_BUF_LEN);
 
   regval = RXREGVAL(MCP2515_RXB0SIDL);
 
@@ -2120,10 +2128,17 @@ static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t offset)
 #endif
   hdr.ch_unused = 0;
 
-  /* Extract the RTR bit */
+  /* Extract the RTR bit, which RXBnCTRL also has */
 
-  regval = RXREGVAL(MCP2515_RXB0CTRL);
-  hdr.ch_rtr = (regval & RXBCTRL_RXRTR) != 0;
+  regval = RXREGVAL(MCP2515_RXB0SIDL);
+  if ((regval & RXBSIDL_IDE) != 0)
+    {
+      hdr.ch_rtr = (RXREGVAL(MCP2515_RXB0DLC) & RXBDLC_RTR) != 0;
+    }
+  else
+    {
+      hdr.ch_rtr = (regval & RXBSIDL_SRR) != 0;
+    }
 
   /* Get the DLC */
 
@@ -2286,31 +2301,21 @@ static int mcp2515_interrupt(FAR struct mcp2515_config_s *config,
 
       if ((pending & MCP2515_RXBUFFER_INTS) != 0)
         {
-          /* RX Buffer 0 is the "high priority" buffer:  We will process
-           * all messages in RXB0 before processing any message from RX
-           * RXB1.
+          /* RX Buffer 0 is the "high priority" buffer, and the older one
+           * when messages roll over to RXB1:  Process RXB0 first, then
+           * RXB1 in the same pass.  Reading a buffer clears its interrupt.
            */
 
           if ((pending & MCP2515_INT_RX0) != 0)
             {
               mcp2515_receive(dev, MCP2515_RX0_OFFSET);
-
-              /* Clear RX0 interrupt */
-
               pending &= ~MCP2515_INT_RX0;
-              clrmask |= MCP2515_INT_RX0;
             }
-          else
-            {
-              if ((pending & MCP2515_INT_RX1) != 0)
-                {
-                  mcp2515_receive(dev, MCP2515_RX1_OFFSET);
 
-                  /* Clear RX1 interrupt */
-
-                  pending &= ~MCP2515_INT_RX1;
-                  clrmask |= MCP2515_INT_RX1;
-                }
+          if ((pending & MCP2515_INT_RX1) != 0)
+            {
+              mcp2515_receive(dev, MCP2515_RX1_OFFSET);
+              pending &= ~MCP2515_INT_RX1;
             }
 
           /* Acknowledge reading the FIFO entry */
@@ -2318,7 +2323,10 @@ static int mcp2515_interrupt(FAR struct mcp2515_config_s *config,
           handled = true;
         }
 
-      mcp2515_modifyreg(priv, MCP2515_CANINTF, clrmask, pending);
+      if (clrmask != 0)
+        {
+          mcp2515_modifyreg(priv, MCP2515_CANINTF, clrmask, pending);
+        }
     }
   while (handled);
 
@@ -0,0 +1,320 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of requests of one bus and the thread that performs them */
+
+struct i2c_asyncbus_s
+{
+  FAR struct i2c_master_s *dev;    /* The bus, NULL if the slot is free */
+  FAR struct i2c_async_s *head;    /* The oldest request */
+  FAR struct i2c_async_s *tail;    /* The newest request */
+  sem_t sem;                       /* Posted for each request queued */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct i2c_asyncbus_s g_i2c_async[CONFIG_I2C_ASYNC_NBUSES];
+static mutex_t g_i2c_async_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_take
+ *
+ * Description:
+ *   Remove the oldest request of a bus from its queue, or return NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct i2c_async_s *
+i2c_async_take(FAR struct i2c_asyncbus_s *bus)
+{
+  FAR struct i2c_async_s *req;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  req = bus->head;
+  if (req != NULL)
+    {
+      bus->head = req->flink;
+      if (bus->head == NULL)
+        {
+          bus->tail = NULL;
+        }
+
+      req->flink = NULL;
+    }
+
+  leave_critical_section(flags);
+  return req;
+}
+
+/****************************************************************************
+ * Name: i2c_async_thread
+ *
+ * Description:
+ *   The thread of a bus.  It performs the queued transfers in order, so
+ *   that the reads of several devices queued together, e.g. a pair of
+ *   sensors polled at the same rate, follow each other on the bus without
+ *   waking the threads that queued them in between.
+ *
+ ****************************************************************************/
+
+static int i2c_async_thread(int argc, FAR char *argv[])
+{
+  FAR struct i2c_asyncbus_s *bus;
+  FAR struct i2c_async_s *req;
+  int ret;
+
+  DEBUGASSERT(argc > 1);
+  bus = &g_i2c_async[atoi(argv[1])];
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&bus->sem);
+
+      /* The request may have been cancelled since it was posted */
+
+      req = i2c_async_take(bus);
+      if (req == NULL)
+        {
+          continue;
+        }
+
+      ret = I2C_TRANSFER(bus->dev, req->msgs, req->count);
+      if (ret < 0)
+        {
+          i2cerr("ERROR: I2C_TRANSFER failed: %d\n", ret);
+        }
+
+      if (req->callback != NULL)
+        {
+          req->callback(req, ret);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_async_bus
+ *
+ * Description:
+ *   Return the queue of a bus, starting its thread on the first request.
+ *
+ ****************************************************************************/
+
+static FAR struct i2c_asyncbus_s *
+i2c_async_bus(FAR struct i2c_master_s *dev, bool create)
+{
+  FAR struct i2c_asyncbus_s *bus = NULL;
+  FAR char *argv[2];
+  char arg[8];
+  int ret;
+  int i;
+
+  nxmutex_lock(&g_i2c_async_lock);
+
+  for (i = 0; i < CONFIG_I2C_ASYNC_NBUSES; i++)
+    {
+      if (g_i2c_async[i].dev == dev)
+        {
+          bus = &g_i2c_async[i];
+          goto out;
+        }
+    }
+
+  if (!create)
+    {
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_I2C_ASYNC_NBUSES; i++)
+    {
+      if (g_i2c_async[i].dev == NULL)
+        {
+          break;
+        }
+    }
+
+  if (i >= CONFIG_I2C_ASYNC_NBUSES)
+    {
+      i2cerr("ERROR: Too many buses\n");
+      goto out;
+    }
+
+  nxsem_init(&g_i2c_async[i].sem, 0, 0);
+  g_i2c_async[i].dev = dev;
+
+  snprintf(arg, sizeof(arg), "%d", i);
+  argv[0] = arg;
+  argv[1] = NULL;
+
+  ret = kthread_create("i2c_async", CONFIG_I2C_ASYNC_PRIORITY,
+                       CONFIG_I2C_ASYNC_STACKSIZE, i2c_async_thread, argv);
+  if (ret < 0)
+    {
+      i2cerr("ERROR: kthread_create failed: %d\n", ret);
+      nxsem_destroy(&g_i2c_async[i].sem);
+      g_i2c_async[i].dev = NULL;
+      goto out;
+    }
+
+  bus = &g_i2c_async[i];
+
+out:
+  nxmutex_unlock(&g_i2c_async_lock);
+  return bus;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer and return at once.  See
+ *   include/nuttx/i2c/i2c_master.h.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *req)
+{
+  FAR struct i2c_asyncbus_s *bus;
+  irqstate_t flags;
+
+  DEBUGASSERT(dev != NULL && req != NULL && req->msgs != NULL);
+
+  bus = i2c_async_bus(dev, true);
+  if (bus == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  req->flink = NULL;
+
+  flags = enter_critical_section();
+
+  if (bus->tail != NULL)
+    {
+      bus->tail->flink = req;
+    }
+  else
+    {
+      bus->head = req;
+    }
+
+  bus->tail = req;
+
+  leave_critical_section(flags);
+
+  nxsem_post(&bus->sem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_transfer_cancel
+ *
+ * Description:
+ *   Remove a request from the queue of its bus if it has not been started.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_cancel(FAR struct i2c_master_s *dev,
+                        FAR struct i2c_async_s *req)
+{
+  FAR struct i2c_asyncbus_s *bus;
+  FAR struct i2c_async_s *prev = NULL;
+  FAR struct i2c_async_s *curr;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  DEBUGASSERT(dev != NULL && req != NULL);
+
+  bus = i2c_async_bus(dev, false);
+  if (bus == NULL)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  for (curr = bus->head; curr != NULL; prev = curr, curr = curr->flink)
+    {
+      if (curr == req)
+        {
+          if (prev != NULL)
+            {
+              prev->flink = curr->flink;
+            }
+          else
+            {
+              bus->head = curr->flink;
+            }
+
+          if (bus->tail == curr)
+            {
+              bus->tail = prev;
+            }
+
+          curr->flink = NULL;
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_I2C_ASYNC */
@@ -39,11 +39,25 @@
 #include <nuttx/mutex.h>
 #include <nuttx/list.h>
 #include <nuttx/mm/circbuf.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_INPUT_TOUCHSCREEN_LATENCY
+#  define CONFIG_INPUT_TOUCHSCREEN_LATENCY 0
+#endif
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The samples that only report moves of the same contacts are coalesced:
+ * The last one is held in pending, and replaced by the next one until a
+ * reader takes it or another kind of sample arrives.
+ */
+
 struct touch_openpriv_s
 {
   struct circbuf_s   circbuf; /* Store touch point data in circle buffer */
@@ -51,6 +65,11 @@ struct touch_openpriv_s
   FAR struct pollfd *fds;     /* Polling structure of waiting thread */
   sem_t              waitsem; /* Used to wait for the availability of data */
   mutex_t            lock;    /* Manages exclusive access to this structure */
+
+  /* Coalescing of the move-only samples */
+
+  bool                       haspending; /* pending holds a sample */
+  FAR struct touch_sample_s *pending;    /* The last move-only sample */
 };
 
 /* This structure is for touchscreen upper half driver */
@@ -61,6 +80,9 @@ struct touch_upperhalf_s
   mutex_t          lock;               /* Manages exclusive access to this structure */
   struct list_node head;               /* Opened file buffer chain header node */
   FAR struct touch_lowerhalf_s *lower; /* A pointer of lower half instance */
+#if CONFIG_INPUT_TOUCHSCREEN_LATENCY > 0
+  struct work_s    work;               /* Wakes up the readers of moves */
+#endif
 };
 
 /****************************************************************************
@@ -100,6 +122,168 @@ static const struct file_operations g_touch_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: touch_ismove
+ *
+ * Description:
+ *   Return true if the sample only reports moves of established contacts.
+ *
+ ****************************************************************************/
+
+static bool touch_ismove(FAR const struct touch_sample_s *sample)
+{
+  int i;
+
+  for (i = 0; i < sample->npoints; i++)
+    {
+      if ((sample->point[i].flags & (TOUCH_DOWN | TOUCH_MOVE | TOUCH_UP)) !=
+          TOUCH_MOVE)
+        {
+          return false;
+        }
+    }
+
+  return sample->npoints > 0;
+}
+
+/****************************************************************************
+ * Name: touch_samecontacts
+ *
+ * Description:
+ *   Return true if two samples report the same contacts.
+ *
+ ****************************************************************************/
+
+static bool touch_samecontacts(FAR const struct touch_sample_s *s1,
+                               FAR const struct touch_sample_s *s2)
+{
+  int i;
+
+  if (s1->npoints != s2->npoints)
+    {
+      return false;
+    }
+
+  for (i = 0; i < s1->npoints; i++)
+    {
+      if (s1->point[i].id != s2->point[i].id)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: touch_putsample
+ *
+ * Description:
+ *   Add a sample to the buffer of an opened file, dropping the oldest whole
+ *   samples if there is no space for it.
+ *
+ ****************************************************************************/
+
+static void touch_putsample(FAR struct touch_openpriv_s *openpriv,
+                            FAR const struct touch_sample_s *sample)
+{
+  size_t size = SIZEOF_TOUCH_SAMPLE_S(sample->npoints);
+  int npoints;
+
+  while (circbuf_space(&openpriv->circbuf) < size &&
+         circbuf_peek(&openpriv->circbuf, &npoints, sizeof(npoints)) ==
+         sizeof(npoints))
+    {
+      circbuf_skip(&openpriv->circbuf, SIZEOF_TOUCH_SAMPLE_S(npoints));
+    }
+
+  circbuf_overwrite(&openpriv->circbuf, sample, size);
+}
+
+/****************************************************************************
+ * Name: touch_flushpending
+ *
+ * Description:
+ *   Move the pending sample of an opened file to its buffer.
+ *
+ ****************************************************************************/
+
+static void touch_flushpending(FAR struct touch_openpriv_s *openpriv)
+{
+  if (openpriv->haspending)
+    {
+      touch_putsample(openpriv, openpriv->pending);
+      openpriv->haspending = false;
+    }
+}
+
+/****************************************************************************
+ * Name: touch_isempty
+ ****************************************************************************/
+
+static bool touch_isempty(FAR struct touch_openpriv_s *openpriv)
+{
+  return !openpriv->haspending && circbuf_is_empty(&openpriv->circbuf);
+}
+
+/****************************************************************************
+ * Name: touch_notify
+ *
+ * Description:
+ *   Wake up the reader of an opened file.
+ *
+ ****************************************************************************/
+
+static void touch_notify(FAR struct touch_openpriv_s *openpriv)
+{
+  int semcount;
+
+  nxsem_get_value(&openpriv->waitsem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&openpriv->waitsem);
+    }
+
+  poll_notify(&openpriv->fds, 1, POLLIN);
+}
+
+/****************************************************************************
+ * Name: touch_notify_worker
+ *
+ * Description:
+ *   Wake up the readers of the moves reported in the last latency period
+ *   at once.
+ *
+ ****************************************************************************/
+
+#if CONFIG_INPUT_TOUCHSCREEN_LATENCY > 0
+static void touch_notify_worker(FAR void *arg)
+{
+  FAR struct touch_upperhalf_s *upper = arg;
+  FAR struct touch_openpriv_s  *openpriv;
+
+  if (nxmutex_lock(&upper->lock) < 0)
+    {
+      return;
+    }
+
+  list_for_every_entry(&upper->head, openpriv, struct touch_openpriv_s, node)
+    {
+      if (nxmutex_lock(&openpriv->lock) == 0)
+        {
+          if (!touch_isempty(openpriv))
+            {
+              touch_notify(openpriv);
+            }
+
+          nxmutex_unlock(&openpriv->lock);
+        }
+    }
+
+  nxmutex_unlock(&upper->lock);
+}
+#endif
+
 /****************************************************************************
  * Name: touch_open
  ****************************************************************************/
@@ -118,10 +302,18 @@ static int touch_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
+  openpriv->pending = kmm_malloc(SIZEOF_TOUCH_SAMPLE_S(lower->maxpoint));
+  if (openpriv->pending == NULL)
+    {
+      kmm_free(openpriv);
+      return -ENOMEM;
+    }
+
   ret = circbuf_init(&openpriv->circbuf, NULL,
                      upper->nums * SIZEOF_TOUCH_SAMPLE_S(lower->maxpoint));
   if (ret < 0)
     {
+      kmm_free(openpriv->pending);
       kmm_free(openpriv);
       return ret;
     }
@@ -130,6 +322,7 @@ static int touch_open(FAR struct file *filep)
   if (ret < 0)
     {
       circbuf_uninit(&openpriv->circbuf);
+      kmm_free(openpriv->pending);
       kmm_free(openpriv);
       return ret;
     }
@@ -168,6 +361,7 @@ static int touch_close(FAR struct file *filep)
   circbuf_uninit(&openpriv->circbuf);
   nxsem_destroy(&openpriv->waitsem);
   nxmutex_destroy(&openpriv->lock);
+  kmm_free(openpriv->pending);
   kmm_free(openpriv);
 
   nxmutex_unlock(&upper->lock);
@@ -201,6 +395,8 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
                           size_t len)
 {
   FAR struct touch_openpriv_s *openpriv = filep->f_priv;
+  size_t size;
+  int npoints;
   int ret;
 
   if (!buffer || !len)
@@ -214,7 +410,7 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  while (circbuf_is_empty(&openpriv->circbuf))
+  while (touch_isempty(openpriv))
     {
       if (filep->f_oflags & O_NONBLOCK)
         {
@@ -238,7 +434,29 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
-  ret = circbuf_read(&openpriv->circbuf, buffer, len);
+  /* Return as many whole samples as fit, or the beginning of the first
+   * one if it does not.
+   */
+
+  touch_flushpending(openpriv);
+
+  for (ret = 0; circbuf_peek(&openpriv->circbuf, &npoints,
+                             sizeof(npoints)) == sizeof(npoints);
+       ret += size)
+    {
+      size = SIZEOF_TOUCH_SAMPLE_S(npoints);
+      if (size > len - ret)
+        {
+          break;
+        }
+
+      circbuf_read(&openpriv->circbuf, buffer + ret, size);
+    }
+
+  if (ret == 0)
+    {
+      ret = circbuf_read(&openpriv->circbuf, buffer, len);
+    }
 
 out:
   nxmutex_unlock(&openpriv->lock);
@@ -304,7 +522,7 @@ static int touch_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
           goto errout;
         }
 
-      if (!circbuf_is_empty(&openpriv->circbuf))
+      if (!touch_isempty(openpriv))
         {
           eventset |= POLLIN;
         }
@@ -334,7 +552,8 @@ void touch_event(FAR void *priv, FAR const struct touch_sample_s *sample)
 {
   FAR struct touch_upperhalf_s *upper = priv;
   FAR struct touch_openpriv_s  *openpriv;
-  int semcount;
+  bool ismove = touch_ismove(sample) &&
+                sample->npoints <= upper->lower->maxpoint;
 
   if (nxmutex_lock(&upper->lock) < 0)
     {
@@ -343,18 +562,50 @@ void touch_event(FAR void *priv, FAR const struct touch_sample_s *sample)
 
   list_for_every_entry(&upper->head, openpriv, struct touch_openpriv_s, node)
     {
-      circbuf_overwrite(&openpriv->circbuf, sample,
-                        SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+      if (nxmutex_lock(&openpriv->lock) < 0)
+        {
+          continue;
+        }
+
+      /* A move replaces the pending move of the same contacts */
+
+      if (!ismove || (openpriv->haspending &&
+                      !touch_samecontacts(openpriv->pending, sample)))
+        {
+          touch_flushpending(openpriv);
+        }
+
+      if (ismove)
+        {
+          memcpy(openpriv->pending, sample,
+                 SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+          openpriv->haspending = true;
+        }
+      else
+        {
+          touch_putsample(openpriv, sample);
+        }
+
+      /* Contacts made and lost are reported at once, moves may wait for
+       * the end of the latency period.
+       */
 
-      nxsem_get_value(&openpriv->waitsem, &semcount);
-      if (semcount < 1)
+      if (!ismove || CONFIG_INPUT_TOUCHSCREEN_LATENCY == 0)
         {
-          nxsem_post(&openpriv->waitsem);
+          touch_notify(openpriv);
         }
 
-      poll_notify(&openpriv->fds, 1, POLLIN);
+      nxmutex_unlock(&openpriv->lock);
     }
 
+#if CONFIG_INPUT_TOUCHSCREEN_LATENCY > 0
+  if (ismove && work_available(&upper->work))
+    {
+      work_queue(LPWORK, &upper->work, touch_notify_worker, upper,
+                 MSEC2TICK(CONFIG_INPUT_TOUCHSCREEN_LATENCY));
+    }
+#endif
+
   nxmutex_unlock(&upper->lock);
 }
 
@@ -416,6 +667,10 @@ void touch_unregister(FAR struct touch_lowerhalf_s *lower,
   iinfo("UnRegistering %s\n", path);
   unregister_driver(path);
 
+#if CONFIG_INPUT_TOUCHSCREEN_LATENCY > 0
+  work_cancel(LPWORK, &upper->work);
+#endif
+
   nxmutex_destroy(&upper->lock);
   kmm_free(upper);
 }
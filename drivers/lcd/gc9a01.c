@@ -589,16 +589,27 @@ static void gc9a01_rdram(FAR struct gc9a01_dev_s *dev,
 
 static void gc9a01_fill(FAR struct gc9a01_dev_s *dev, uint16_t color)
 {
+  size_t npixels = GC9A01_XRES * GC9A01_YRES;
+  size_t len;
   int i;
 
+  /* Send the color from the run buffer, many pixels per transfer */
+
+  for (i = 0; i < GC9A01_LUT_SIZE; i++)
+    {
+      dev->runbuffer[i] = color;
+    }
+
   gc9a01_setarea(dev, 0, 0, GC9A01_XRES - 1, GC9A01_YRES - 1);
 
   gc9a01_sendcmd(dev, GC9A01_RAMWR);
-  gc9a01_select(dev->spi, GC9A01_BYTESPP *8);
+  gc9a01_select(dev->spi, GC9A01_BYTESPP * 8);
 
-  for (i = 0; i < GC9A01_XRES * GC9A01_YRES; i++)
+  while (npixels > 0)
     {
-      SPI_SEND(dev->spi, color);
+      len = npixels < GC9A01_LUT_SIZE ? npixels : GC9A01_LUT_SIZE;
+      SPI_SNDBLOCK(dev->spi, dev->runbuffer, len);
+      npixels -= len;
     }
 
   gc9a01_deselect(dev->spi);
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -31,7 +32,11 @@
 #include <debug.h>
 
 #include <nuttx/board.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/lcd/lcd.h>
 #include <nuttx/video/fb.h>
 
@@ -45,6 +50,18 @@
 
 #define VIDEO_PLANE 0
 
+/* Number of frame buffers that the application pans between */
+
+#ifndef CONFIG_LCD_FRAMEBUFFER_NBUFFERS
+#  define CONFIG_LCD_FRAMEBUFFER_NBUFFERS 1
+#endif
+
+#define LCDFB_NBUFFERS CONFIG_LCD_FRAMEBUFFER_NBUFFERS
+
+/* No buffer is waiting to be written to the LCD */
+
+#define LCDFB_NONE     UINT32_MAX
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +80,16 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+
+#if LCDFB_NBUFFERS > 1
+  mutex_t lock;                     /* Serializes the writes to the LCD */
+  struct work_s work;               /* Writes the panned buffers */
+  sem_t vsync;                      /* Posted when a buffer is shown */
+  uint32_t yoffset;                 /* First row of the shown buffer */
+  uint32_t pending;                 /* Buffer to show next or LCDFB_NONE */
+  uint8_t nwaiters;                 /* Threads waiting for vsync */
+  bool writing;                     /* The worker writes a buffer */
+#endif
 };
 
 /****************************************************************************
@@ -71,9 +98,22 @@ struct lcdfb_dev_s
 
 /* Update the LCD when there is a change to the framebuffer */
 
+static int lcdfb_update(FAR struct lcdfb_dev_s *priv,
+             FAR const uint8_t *fbmem, FAR const struct fb_area_s *area);
 static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
              FAR const struct fb_area_s *area);
 
+/* Show one of the frame buffers */
+
+#if LCDFB_NBUFFERS > 1
+static void lcdfb_flipworker(FAR void *arg);
+static int lcdfb_pandisplay(FAR struct fb_vtable_s *vtable,
+             FAR struct fb_planeinfo_s *pinfo);
+#ifdef CONFIG_FB_SYNC
+static int lcdfb_waitforvsync(FAR struct fb_vtable_s *vtable);
+#endif
+#endif
+
 /* Get information about the video controller configuration and the
  * configuration of each color plane.
  */
@@ -152,19 +192,20 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
 }
 
 /****************************************************************************
- * Name: lcdfb_updateearea
+ * Name: lcdfb_update
  *
  * Description:
- * Update the LCD when there is a change to the framebuffer.
+ *   Write an area of a frame buffer to the LCD, or all of it if area is
+ *   NULL.
  *
  ****************************************************************************/
 
-static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
-                             FAR const struct fb_area_s *area)
+static int lcdfb_update(FAR struct lcdfb_dev_s *priv,
+                        FAR const uint8_t *fbmem,
+                        FAR const struct fb_area_s *area)
 {
-  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
   FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
-  FAR uint8_t *run = priv->fbmem;
+  FAR const uint8_t *run = fbmem;
   fb_coord_t row;
   fb_coord_t startx = 0;
   fb_coord_t endx = priv->xres - 1;
@@ -214,7 +255,7 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
 
       /* Get the starting position in the framebuffer */
 
-      run  = priv->fbmem + starty * priv->stride;
+      run  = fbmem + starty * priv->stride;
       run += (startx * pinfo->bpp + 7) >> 3;
     }
 
@@ -263,6 +304,162 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
   return OK;
 }
 
+/****************************************************************************
+ * Name: lcdfb_updateearea
+ *
+ * Description:
+ * Update the LCD when there is a change to the framebuffer.
+ *
+ ****************************************************************************/
+
+static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
+                             FAR const struct fb_area_s *area)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+#if LCDFB_NBUFFERS > 1
+  int ret;
+
+  /* The area is in the buffer that is shown */
+
+  nxmutex_lock(&priv->lock);
+  ret = lcdfb_update(priv, priv->fbmem + priv->yoffset * priv->stride,
+                     area);
+  nxmutex_unlock(&priv->lock);
+  return ret;
+#else
+  return lcdfb_update(priv, priv->fbmem, area);
+#endif
+}
+
+#if LCDFB_NBUFFERS > 1
+/****************************************************************************
+ * Name: lcdfb_flipworker
+ *
+ * Description:
+ *   Write the buffers panned to by the application to the LCD, until none
+ *   is waiting, then wake up the threads waiting for vsync.
+ *
+ ****************************************************************************/
+
+static void lcdfb_flipworker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)arg;
+  irqstate_t flags;
+  uint32_t yoffset;
+  int ret;
+
+  for (; ; )
+    {
+      flags   = enter_critical_section();
+      yoffset = priv->pending;
+      priv->pending = LCDFB_NONE;
+
+      if (yoffset == LCDFB_NONE)
+        {
+          /* All of the buffers that were panned to have been shown */
+
+          priv->writing = false;
+          while (priv->nwaiters > 0)
+            {
+              priv->nwaiters--;
+              nxsem_post(&priv->vsync);
+            }
+
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+
+      nxmutex_lock(&priv->lock);
+      ret = lcdfb_update(priv, priv->fbmem + yoffset * priv->stride, NULL);
+      priv->yoffset = yoffset;
+      nxmutex_unlock(&priv->lock);
+
+      if (ret < 0)
+        {
+          lcderr("ERROR: Failed to show buffer at %" PRIu32 ": %d\n",
+                 yoffset, ret);
+        }
+    }
+
+#ifdef CONFIG_VIDEO_FB
+  /* The application may draw in the buffers that are not shown */
+
+  if (priv->vtable.priv != NULL)
+    {
+      fb_pollnotify(&priv->vtable);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: lcdfb_pandisplay
+ *
+ * Description:
+ *   Show the buffer that begins at the row pinfo->yoffset of the virtual
+ *   frame buffer.  It is written to the LCD in the background.
+ *
+ ****************************************************************************/
+
+static int lcdfb_pandisplay(FAR struct fb_vtable_s *vtable,
+                            FAR struct fb_planeinfo_s *pinfo)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  irqstate_t flags;
+
+  DEBUGASSERT(vtable != NULL && pinfo != NULL);
+
+  if (pinfo->xoffset != 0 || pinfo->yoffset % priv->yres != 0 ||
+      pinfo->yoffset >= (uint32_t)priv->yres * LCDFB_NBUFFERS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  priv->pending = pinfo->yoffset;
+  if (!priv->writing)
+    {
+      priv->writing = true;
+      work_queue(LPWORK, &priv->work, lcdfb_flipworker, priv, 0);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lcdfb_waitforvsync
+ *
+ * Description:
+ *   Wait until the buffers panned to have been written to the LCD.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_SYNC
+static int lcdfb_waitforvsync(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+  irqstate_t flags;
+
+  DEBUGASSERT(vtable != NULL);
+
+  flags = enter_critical_section();
+  if (!priv->writing)
+    {
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  priv->nwaiters++;
+  leave_critical_section(flags);
+
+  return nxsem_wait_uninterruptible(&priv->vsync);
+}
+#endif
+#endif /* LCDFB_NBUFFERS > 1 */
+
 /****************************************************************************
  * Name: lcdfb_getvideoinfo
  ****************************************************************************/
@@ -314,11 +511,19 @@ static int lcdfb_getplaneinfo(FAR struct fb_vtable_s *vtable, int planeno,
     {
       /* Return the plane info */
 
-      pinfo->fbmem   = priv->fbmem;
-      pinfo->fblen   = priv->fblen;
-      pinfo->stride  = priv->stride;
-      pinfo->display = priv->display;
-      pinfo->bpp     = priv->pinfo.bpp;
+      pinfo->fbmem        = priv->fbmem;
+      pinfo->fblen        = priv->fblen;
+      pinfo->stride       = priv->stride;
+      pinfo->display      = priv->display;
+      pinfo->bpp          = priv->pinfo.bpp;
+      pinfo->xres_virtual = priv->xres;
+      pinfo->yres_virtual = (uint32_t)priv->yres * LCDFB_NBUFFERS;
+      pinfo->xoffset      = 0;
+#if LCDFB_NBUFFERS > 1
+      pinfo->yoffset      = priv->yoffset;
+#else
+      pinfo->yoffset      = 0;
+#endif
 
       ret = OK;
     }
@@ -548,6 +753,16 @@ int up_fbinitialize(int display)
 #endif
   priv->vtable.updatearea   = lcdfb_updateearea,
   priv->vtable.setpower     = lcdfb_setpower,
+#if LCDFB_NBUFFERS > 1
+  priv->vtable.pandisplay   = lcdfb_pandisplay;
+#ifdef CONFIG_FB_SYNC
+  priv->vtable.waitforvsync = lcdfb_waitforvsync;
+#endif
+
+  nxmutex_init(&priv->lock);
+  nxsem_init(&priv->vsync, 0, 0);
+  priv->pending             = LCDFB_NONE;
+#endif
 
 #ifdef CONFIG_LCD_EXTERNINIT
   /* Use external graphics driver initialization */
@@ -603,10 +818,10 @@ int up_fbinitialize(int display)
       goto errout_with_lcd;
     }
 
-  /* Allocate (and clear) the framebuffer */
+  /* Allocate (and clear) the framebuffer, all of the buffers together */
 
   priv->stride = ((size_t)priv->xres * priv->pinfo.bpp + 7) >> 3;
-  priv->fblen  = priv->stride * priv->yres;
+  priv->fblen  = priv->stride * priv->yres * LCDFB_NBUFFERS;
 
   priv->fbmem  = (FAR uint8_t *)kmm_zalloc(priv->fblen);
   if (priv->fbmem == NULL)
@@ -645,6 +860,10 @@ errout_with_lcd:
 #endif
 
 errout_with_state:
+#if LCDFB_NBUFFERS > 1
+  nxmutex_destroy(&priv->lock);
+  nxsem_destroy(&priv->vsync);
+#endif
   kmm_free(priv);
   return ret;
 }
@@ -734,6 +953,14 @@ void up_fbuninitialize(int display)
           board_lcd_uninitialize();
 #endif
 
+#if LCDFB_NBUFFERS > 1
+          /* Stop showing the buffers */
+
+          work_cancel(LPWORK, &priv->work);
+          nxmutex_destroy(&priv->lock);
+          nxsem_destroy(&priv->vsync);
+#endif
+
           /* Free the frame buffer allocation */
 
           kmm_free(priv->fbmem);
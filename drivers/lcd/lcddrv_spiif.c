@@ -141,12 +141,12 @@ static int lcddrv_spiif_sendmulti(FAR struct lcddrv_lcd_s *lcd,
 {
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
 
-  SPI_SETBITS(priv->spi, 16);
-  for (uint32_t t = 0; t < nwords; t++)
-    {
-      SPI_SEND(priv->spi, *wd++);
-    }
+  /* One block transfer of 16-bit frames, so that the SPI driver may use
+   * DMA and the pixels need no byte swapping.
+   */
 
+  SPI_SETBITS(priv->spi, 16);
+  SPI_SNDBLOCK(priv->spi, wd, nwords);
   SPI_SETBITS(priv->spi, 8);
 
   return OK;
@@ -496,16 +496,27 @@ static void st7789_rdram(FAR struct st7789_dev_s *dev,
 
 static void st7789_fill(FAR struct st7789_dev_s *dev, uint16_t color)
 {
+  size_t npixels = ST7789_XRES * ST7789_YRES;
+  size_t len;
   int i;
 
+  /* Send the color from the run buffer, many pixels per transfer */
+
+  for (i = 0; i < ST7789_LUT_SIZE; i++)
+    {
+      dev->runbuffer[i] = color;
+    }
+
   st7789_setarea(dev, 0, 0, ST7789_XRES - 1, ST7789_YRES - 1);
 
   st7789_sendcmd(dev, ST7789_RAMWR);
-  st7789_select(dev->spi, ST7789_BYTESPP *8);
+  st7789_select(dev->spi, ST7789_BYTESPP * 8);
 
-  for (i = 0; i < ST7789_XRES * ST7789_YRES; i++)
+  while (npixels > 0)
     {
-      SPI_SEND(dev->spi, color);
+      len = npixels < ST7789_LUT_SIZE ? npixels : ST7789_LUT_SIZE;
+      SPI_SNDBLOCK(dev->spi, dev->runbuffer, len);
+      npixels -= len;
     }
 
   st7789_deselect(dev->spi);
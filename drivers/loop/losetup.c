@@ -65,6 +65,7 @@ struct loop_struct_s
   uint8_t      opencnt;      /* Count of open references to the loop device */
   bool         writeenabled; /* true: can write to device */
   struct file  devfile;      /* File struct of char device/file */
+  FAR uint8_t *base;         /* First sector if the file is mapped */
 };
 
 /****************************************************************************
@@ -80,6 +81,8 @@ static ssize_t loop_write(FAR struct inode *inode,
                           blkcnt_t start_sector, unsigned int nsectors);
 static int     loop_geometry(FAR struct inode *inode,
                              FAR struct geometry *geometry);
+static int     loop_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -92,7 +95,7 @@ static const struct block_operations g_bops =
   loop_read,     /* read */
   loop_write,    /* write */
   loop_geometry, /* geometry */
-  NULL           /* ioctl */
+  loop_ioctl     /* ioctl */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL         /* unlink */
 #endif
@@ -200,6 +203,13 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
+  if (dev->base != NULL)
+    {
+      memcpy(buffer, dev->base + start_sector * dev->sectsize,
+             nsectors * dev->sectsize);
+      return nsectors;
+    }
+
   /* Calculate the offset to read the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
@@ -248,6 +258,18 @@ static ssize_t loop_write(FAR struct inode *inode,
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
 
+  if (dev->base != NULL)
+    {
+      if (start_sector + nsectors > dev->nsectors)
+        {
+          return -EFBIG;
+        }
+
+      memcpy(dev->base + start_sector * dev->sectsize, buffer,
+             nsectors * dev->sectsize);
+      return nsectors;
+    }
+
   /* Calculate the offset to write the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
@@ -303,6 +325,51 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_ioctl
+ *
+ * Description:
+ *   Give direct access to the sectors of a file that is mapped in memory,
+ *   e.g. a file of tmpfs, or of romfs on XIP media.
+ *
+ ****************************************************************************/
+
+static int loop_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct loop_struct_s *dev;
+  FAR struct bio_dax_s *dax;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct loop_struct_s *)inode->i_private;
+
+  if (dev->base == NULL || arg == 0)
+    {
+      return -ENOTTY;
+    }
+
+  switch (cmd)
+    {
+      case BIOC_XIPBASE:
+        *(FAR void **)((uintptr_t)arg) = dev->base;
+        return OK;
+
+      case BIOC_DAX:
+        dax = (FAR struct bio_dax_s *)((uintptr_t)arg);
+        if (dax->startsector >= dev->nsectors)
+          {
+            return -EINVAL;
+          }
+
+        dax->addr     = dev->base + dax->startsector * dev->sectsize;
+        dax->nsectors = dev->nsectors - dax->startsector;
+        dax->writable = dev->writeenabled;
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -393,6 +460,20 @@ int losetup(FAR const char *devname, FAR const char *filename,
         }
     }
 
+  /* Access the file in place if its file system maps it in memory.  The
+   * file must not be resized while the loop device is set up.
+   */
+
+  if (file_ioctl(&dev->devfile, FIOC_MMAP,
+                 (unsigned long)((uintptr_t)&dev->base)) >= 0)
+    {
+      dev->base += offset;
+    }
+  else
+    {
+      dev->base = NULL;
+    }
+
   /* Inode private data will be reference to the loop device structure */
 
   ret = register_blockdriver(devname, &g_bops, 0, dev);
@@ -37,6 +37,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #include <nuttx/math/math_ioctl.h>
 #include <nuttx/math/cordic.h>
@@ -45,6 +46,20 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+/* Angles beyond this are not reduced to [-pi, pi) accurately in float */
+
+#  define CORDIC_ANGLE_MAX   1048576.0f
+
+#  define CORDIC_1_BY_2PI    0.159154943091895336f
+#  define CORDIC_PI_BY_Q31   (3.14159265358979324f / 2147483648.0f)
+#  define CORDIC_1_BY_Q31    (1.0f / 2147483648.0f)
+
+/* 2^31 / pi in Q16, to convert a b16 angle to a q1.31 fraction of pi */
+
+#  define CORDIC_B16_TO_Q31  683565276
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
@@ -71,6 +86,14 @@ static int     cordic_ioctl(FAR struct file *filep, int cmd,
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+/* The unit used by the direct calls, and whether a call is using it */
+
+static FAR struct cordic_lowerhalf_s *g_cordic_direct;
+static spinlock_t g_cordic_lock;
+static bool g_cordic_busy;
+#endif
+
 static const struct file_operations g_cordicops =
 {
   NULL,         /* open */
@@ -89,6 +112,46 @@ static const struct file_operations g_cordicops =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+/****************************************************************************
+ * Name: cordic_claim
+ *
+ * Description:
+ *   Take the unit for one request.  This fails instead of waiting if the
+ *   unit is in use, as the user may be an interrupted thread.
+ *
+ ****************************************************************************/
+
+static bool cordic_claim(void)
+{
+  irqstate_t flags;
+  bool claimed = false;
+
+  flags = spin_lock_irqsave(&g_cordic_lock);
+  if (!g_cordic_busy)
+    {
+      g_cordic_busy = true;
+      claimed       = true;
+    }
+
+  spin_unlock_irqrestore(&g_cordic_lock, flags);
+  return claimed;
+}
+
+/****************************************************************************
+ * Name: cordic_release
+ ****************************************************************************/
+
+static void cordic_release(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_cordic_lock);
+  g_cordic_busy = false;
+  spin_unlock_irqrestore(&g_cordic_lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: cordic_read
  *
@@ -153,8 +216,25 @@ static int cordic_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           FAR struct cordic_calc_s *calc =
             (FAR struct cordic_calc_s *)((uintptr_t)arg);
 
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+          /* The unit may be shared with the direct calls */
+
+          if (lower == g_cordic_direct && !cordic_claim())
+            {
+              ret = -EBUSY;
+              break;
+            }
+#endif
+
           ret = lower->ops->calc(lower, calc);
 
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+          if (lower == g_cordic_direct)
+            {
+              cordic_release();
+            }
+#endif
+
           break;
         }
 
@@ -216,7 +296,230 @@ int cordic_register(FAR const char *path,
       _err("register_driver failed: %d\n", ret);
       kmm_free(upper);
     }
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+  else if (g_cordic_direct == NULL)
+    {
+      /* The first unit also serves the direct calls */
+
+      g_cordic_direct = lower;
+    }
+#endif
 
 errout:
   return ret;
 }
+
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+/****************************************************************************
+ * Name: cordic_direct_calc
+ *
+ * Description:
+ *   Calculate n requests of the same function with the first registered
+ *   CORDIC unit, without going through the character driver.
+ *
+ ****************************************************************************/
+
+int cordic_direct_calc(FAR struct cordic_calc_s *calc, size_t n)
+{
+  FAR struct cordic_lowerhalf_s *lower = g_cordic_direct;
+  int ret = OK;
+  size_t i;
+
+  DEBUGASSERT(calc != NULL);
+
+  if (lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (!cordic_claim())
+    {
+      return -EBUSY;
+    }
+
+  if (n > 1 && lower->ops->calcv != NULL)
+    {
+      ret = lower->ops->calcv(lower, calc, n);
+    }
+  else
+    {
+      for (i = 0; i < n && ret >= 0; i++)
+        {
+          ret = lower->ops->calc(lower, &calc[i]);
+        }
+    }
+
+  cordic_release();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cordic_sincosf
+ *
+ * Description:
+ *   Calculate the sine and the cosine of an angle in radians with the
+ *   CORDIC unit.
+ *
+ ****************************************************************************/
+
+int cordic_sincosf(float angle, FAR float *sinval, FAR float *cosval)
+{
+  struct cordic_calc_s calc;
+  float turns;
+  int ret;
+
+  if (!(angle > -CORDIC_ANGLE_MAX && angle < CORDIC_ANGLE_MAX))
+    {
+      return -EDOM;
+    }
+
+  /* The unit takes the angle as a q1.31 fraction of pi.  Reduce the angle
+   * to a fraction of a turn in [0, 1), whose 32-bit fixed-point value is
+   * that fraction of pi modulo 2.
+   */
+
+  turns  = angle * CORDIC_1_BY_2PI;
+  turns -= (float)(int32_t)turns;
+  if (turns < 0.0f)
+    {
+      turns += 1.0f;
+    }
+
+  calc.arg1 = turns < 1.0f ? (int32_t)(uint32_t)(turns * 4294967296.0f) : 0;
+  calc.arg2 = INT32_MAX;
+
+  if (cosval != NULL)
+    {
+      calc.func      = CORDIC_CALC_FUNC_COS;
+      calc.res2_incl = sinval != NULL;
+    }
+  else
+    {
+      calc.func      = CORDIC_CALC_FUNC_SIN;
+      calc.res2_incl = false;
+    }
+
+  ret = cordic_direct_calc(&calc, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (cosval != NULL)
+    {
+      *cosval = (float)calc.res1 * CORDIC_1_BY_Q31;
+      if (sinval != NULL)
+        {
+          *sinval = (float)calc.res2 * CORDIC_1_BY_Q31;
+        }
+    }
+  else if (sinval != NULL)
+    {
+      *sinval = (float)calc.res1 * CORDIC_1_BY_Q31;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cordic_atan2f
+ *
+ * Description:
+ *   Calculate atan2(y, x) in radians with the CORDIC unit.
+ *
+ ****************************************************************************/
+
+int cordic_atan2f(float y, float x, FAR float *phase)
+{
+  struct cordic_calc_s calc;
+  union
+  {
+    float    f;
+    uint32_t u;
+  } max;
+
+  union
+  {
+    float    f;
+    uint32_t u;
+  } scale;
+
+  int expo;
+  int ret;
+
+  DEBUGASSERT(phase != NULL);
+
+  /* Scale the arguments by a power of 2 so that the larger one lies in
+   * [0.25, 0.5) and the modulus stays below 1.  Zero, subnormal and
+   * non-finite arguments are left to the software.
+   */
+
+  max.f = x < 0.0f ? -x : x;
+  if (y > max.f || -y > max.f)
+    {
+      max.f = y < 0.0f ? -y : y;
+    }
+
+  expo = (int)((max.u >> 23) & 0xff) - 127;
+  if (expo <= -126 || expo >= 125)
+    {
+      return -EDOM;
+    }
+
+  scale.u = (uint32_t)(127 - expo - 2) << 23;
+
+  calc.func      = CORDIC_CALC_FUNC_PHASE;
+  calc.res2_incl = false;
+  calc.arg1      = (int32_t)(x * scale.f * 2147483648.0f);
+  calc.arg2      = (int32_t)(y * scale.f * 2147483648.0f);
+
+  ret = cordic_direct_calc(&calc, 1);
+  if (ret >= 0)
+    {
+      *phase = (float)calc.res1 * CORDIC_PI_BY_Q31;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cordic_sincos_b16
+ *
+ * Description:
+ *   Calculate the sine and the cosine of a b16 angle in radians with the
+ *   CORDIC unit.
+ *
+ ****************************************************************************/
+
+int cordic_sincos_b16(b16_t angle, FAR b16_t *sinval, FAR b16_t *cosval)
+{
+  struct cordic_calc_s calc;
+  int ret;
+
+  /* The angle as a q1.31 fraction of pi, modulo 2 by the truncation */
+
+  calc.func      = CORDIC_CALC_FUNC_COS;
+  calc.res2_incl = true;
+  calc.arg1      = (int32_t)(uint32_t)
+                   (((int64_t)angle * CORDIC_B16_TO_Q31) >> 16);
+  calc.arg2      = INT32_MAX;
+
+  ret = cordic_direct_calc(&calc, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (cosval != NULL)
+    {
+      *cosval = (calc.res1 + 0x4000) >> 15;
+    }
+
+  if (sinval != NULL)
+    {
+      *sinval = (calc.res2 + 0x4000) >> 15;
+    }
+
+  return OK;
+}
+#endif /* CONFIG_MATH_CORDIC_DIRECT */
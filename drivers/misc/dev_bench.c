@@ -0,0 +1,980 @@
+/****************************************************************************
+ * drivers/misc/dev_bench.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* /dev/bench runs microbenchmarks of the kernel primitives when it is read
+ * and returns their results as comma separated values, one line per
+ * benchmark:
+ *
+ *   name,status,iterations,nsec/op,bytes/s
+ *
+ * status is 0 or the negated errno value of a benchmark that could not
+ * run, nsec/op has one decimal and bytes/s is 0 unless the benchmark moves
+ * data.  Each benchmark runs for at least CONFIG_DEV_BENCH_MSEC, so that
+ * the coarse clock of tick based systems is good enough.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/mm/mempool.h>
+
+#ifndef CONFIG_DISABLE_MQUEUE
+#  include <nuttx/mqueue.h>
+#endif
+
+#ifdef CONFIG_MM_IOB
+#  include <nuttx/mm/iob.h>
+#endif
+
+#if defined(CONFIG_NET_LOOPBACK) && defined(CONFIG_NET_IPv4)
+#  include <netinet/in.h>
+#  include <nuttx/net/net.h>
+#  if defined(CONFIG_NET_UDP) && !defined(CONFIG_NET_UDP_NO_STACK)
+#    define HAVE_BENCH_UDP 1
+#  endif
+#  if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
+#    define HAVE_BENCH_TCP 1
+#  endif
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_MINTIME     ((uint64_t)CONFIG_DEV_BENCH_MSEC * NSEC_PER_MSEC)
+#define BENCH_MAXITER     (UINT32_MAX / 2)
+#define BENCH_LINELEN     80
+#define BENCH_BUFSIZE     (BENCH_NBENCH * BENCH_LINELEN + BENCH_LINELEN)
+
+#define BENCH_BLOCKSIZE   64    /* The size of the heap and pool blocks */
+#define BENCH_MSGSIZE     16    /* The size of the messages */
+#define BENCH_CHUNKSIZE   1024  /* The size of the network transfers */
+#define BENCH_PORT        5471
+
+#define BENCH_NBENCH      (sizeof(g_bench) / sizeof(g_bench[0]))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_s
+{
+  FAR const char *name;
+  uint8_t nops;                   /* Operations per iteration */
+  size_t bytes;                   /* Bytes moved per iteration */
+  CODE int (*setup)(void);
+  CODE int (*run)(uint32_t niter);
+  CODE void (*teardown)(void);
+};
+
+/* The state shared by the benchmarks and their helper thread */
+
+struct bench_state_s
+{
+  volatile bool stop;             /* Tells the helper thread to exit */
+  sem_t exited;                   /* Posted by the helper thread on exit */
+  sem_t done;                     /* Posted by the benchmark thread */
+  sem_t req;
+  sem_t rsp;
+  mutex_t mutex;
+  struct wdog_s wdog;
+  struct mempool_s pool;
+#ifndef CONFIG_DISABLE_MQUEUE
+  mqd_t mqreq;
+  mqd_t mqrsp;
+#endif
+#if defined(HAVE_BENCH_UDP) || defined(HAVE_BENCH_TCP)
+  struct socket sock;
+  struct socket peer;
+  struct sockaddr_in addr;
+  char chunk[BENCH_CHUNKSIZE];
+#endif
+  FAR char *buffer;               /* The results */
+  size_t len;
+};
+
+/* This structure describes one open "file" */
+
+struct bench_file_s
+{
+  bool done;                      /* The benchmarks have run */
+  size_t len;
+  char buffer[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     bench_yield_setup(void);
+static int     bench_yield_run(uint32_t niter);
+static void    bench_yield_teardown(void);
+static int     bench_sem_setup(void);
+static int     bench_sem_run(uint32_t niter);
+static void    bench_sem_teardown(void);
+static int     bench_mutex_setup(void);
+static int     bench_mutex_run(uint32_t niter);
+static void    bench_mutex_teardown(void);
+#ifndef CONFIG_DISABLE_MQUEUE
+static int     bench_mq_setup(void);
+static int     bench_mq_run(uint32_t niter);
+static void    bench_mq_teardown(void);
+#endif
+static int     bench_wdog_run(uint32_t niter);
+static int     bench_malloc_run(uint32_t niter);
+static int     bench_mempool_setup(void);
+static int     bench_mempool_run(uint32_t niter);
+static void    bench_mempool_teardown(void);
+#ifdef CONFIG_MM_IOB
+static int     bench_iob_run(uint32_t niter);
+#endif
+#ifdef HAVE_BENCH_UDP
+static int     bench_udp_setup(void);
+static int     bench_udp_run(uint32_t niter);
+static void    bench_udp_teardown(void);
+#endif
+#ifdef HAVE_BENCH_TCP
+static int     bench_tcp_setup(void);
+static int     bench_tcp_run(uint32_t niter);
+static void    bench_tcp_teardown(void);
+#endif
+
+static int     bench_open(FAR struct file *filep);
+static int     bench_close(FAR struct file *filep);
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_bench_fops =
+{
+  bench_open,   /* open */
+  bench_close,  /* close */
+  bench_read,   /* read */
+  NULL,         /* write */
+  NULL,         /* seek */
+  NULL,         /* ioctl */
+  NULL          /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL        /* unlink */
+#endif
+};
+
+static struct bench_state_s g_bench_state;
+static mutex_t g_bench_lock = NXMUTEX_INITIALIZER;
+
+static const struct bench_s g_bench[] =
+{
+  {
+    "ctxsw", 2, 0,
+    bench_yield_setup, bench_yield_run, bench_yield_teardown
+  },
+  {
+    "sem_pingpong", 1, 0,
+    bench_sem_setup, bench_sem_run, bench_sem_teardown
+  },
+  {
+    "mutex", 1, 0,
+    bench_mutex_setup, bench_mutex_run, bench_mutex_teardown
+  },
+#ifndef CONFIG_DISABLE_MQUEUE
+  {
+    "mq_roundtrip", 1, 0,
+    bench_mq_setup, bench_mq_run, bench_mq_teardown
+  },
+#endif
+  {
+    "wd_start", 1, 0,
+    NULL, bench_wdog_run, NULL
+  },
+  {
+    "kmm_malloc", 1, 0,
+    NULL, bench_malloc_run, NULL
+  },
+  {
+    "mempool", 1, 0,
+    bench_mempool_setup, bench_mempool_run, bench_mempool_teardown
+  },
+#ifdef CONFIG_MM_IOB
+  {
+    "iob", 1, 0,
+    NULL, bench_iob_run, NULL
+  },
+#endif
+#ifdef HAVE_BENCH_UDP
+  {
+    "udp_loopback", 1, BENCH_CHUNKSIZE,
+    bench_udp_setup, bench_udp_run, bench_udp_teardown
+  },
+#endif
+#ifdef HAVE_BENCH_TCP
+  {
+    "tcp_loopback", 1, BENCH_CHUNKSIZE,
+    bench_tcp_setup, bench_tcp_run, bench_tcp_teardown
+  },
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_start_helper
+ *
+ * Description:
+ *   Start a helper thread at the priority of the benchmark thread and, in
+ *   SMP, on its CPU, so that the benchmarks measure context switches and
+ *   not inter-processor wakeups.
+ *
+ ****************************************************************************/
+
+static int bench_start_helper(main_t entry)
+{
+  int pid;
+
+  g_bench_state.stop = false;
+  nxsem_init(&g_bench_state.exited, 0, 0);
+
+  pid = kthread_create("bench_helper", nxsched_self()->sched_priority,
+                       CONFIG_DEV_BENCH_STACKSIZE, entry, NULL);
+#ifdef CONFIG_SMP
+  if (pid > 0)
+    {
+      cpu_set_t cpuset;
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(up_cpu_index(), &cpuset);
+      nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+    }
+#endif
+
+  return pid < 0 ? pid : OK;
+}
+
+static void bench_wait_helper(void)
+{
+  nxsem_wait_uninterruptible(&g_bench_state.exited);
+  nxsem_destroy(&g_bench_state.exited);
+}
+
+/* Context switch:  the benchmark thread and the helper yield to each other,
+ * two switches per iteration.
+ */
+
+static int bench_yield_helper(int argc, FAR char *argv[])
+{
+  while (!g_bench_state.stop)
+    {
+      sched_yield();
+    }
+
+  nxsem_post(&g_bench_state.exited);
+  return 0;
+}
+
+static int bench_yield_setup(void)
+{
+  return bench_start_helper(bench_yield_helper);
+}
+
+static int bench_yield_run(uint32_t niter)
+{
+  while (niter-- > 0)
+    {
+      sched_yield();
+    }
+
+  return OK;
+}
+
+static void bench_yield_teardown(void)
+{
+  g_bench_state.stop = true;
+  bench_wait_helper();
+}
+
+/* Semaphore ping-pong:  a round trip through the helper thread */
+
+static int bench_sem_helper(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_bench_state.req);
+      if (g_bench_state.stop)
+        {
+          break;
+        }
+
+      nxsem_post(&g_bench_state.rsp);
+    }
+
+  nxsem_post(&g_bench_state.exited);
+  return 0;
+}
+
+static int bench_sem_setup(void)
+{
+  int ret;
+
+  nxsem_init(&g_bench_state.req, 0, 0);
+  nxsem_init(&g_bench_state.rsp, 0, 0);
+
+  ret = bench_start_helper(bench_sem_helper);
+  if (ret < 0)
+    {
+      nxsem_destroy(&g_bench_state.req);
+      nxsem_destroy(&g_bench_state.rsp);
+    }
+
+  return ret;
+}
+
+static int bench_sem_run(uint32_t niter)
+{
+  while (niter-- > 0)
+    {
+      nxsem_post(&g_bench_state.req);
+      nxsem_wait_uninterruptible(&g_bench_state.rsp);
+    }
+
+  return OK;
+}
+
+static void bench_sem_teardown(void)
+{
+  g_bench_state.stop = true;
+  nxsem_post(&g_bench_state.req);
+  bench_wait_helper();
+
+  nxsem_destroy(&g_bench_state.req);
+  nxsem_destroy(&g_bench_state.rsp);
+}
+
+/* Uncontended mutex lock and unlock */
+
+static int bench_mutex_setup(void)
+{
+  return nxmutex_init(&g_bench_state.mutex);
+}
+
+static int bench_mutex_run(uint32_t niter)
+{
+  while (niter-- > 0)
+    {
+      nxmutex_lock(&g_bench_state.mutex);
+      nxmutex_unlock(&g_bench_state.mutex);
+    }
+
+  return OK;
+}
+
+static void bench_mutex_teardown(void)
+{
+  nxmutex_destroy(&g_bench_state.mutex);
+}
+
+#ifndef CONFIG_DISABLE_MQUEUE
+/* Message queue round trip through the helper thread */
+
+static int bench_mq_helper(int argc, FAR char *argv[])
+{
+  char msg[BENCH_MSGSIZE];
+  unsigned int prio;
+
+  for (; ; )
+    {
+      if (nxmq_receive(g_bench_state.mqreq, msg, sizeof(msg), &prio) < 0 ||
+          g_bench_state.stop)
+        {
+          break;
+        }
+
+      nxmq_send(g_bench_state.mqrsp, msg, sizeof(msg), prio);
+    }
+
+  nxsem_post(&g_bench_state.exited);
+  return 0;
+}
+
+static void bench_mq_close(void)
+{
+  nxmq_close(g_bench_state.mqreq);
+  nxmq_close(g_bench_state.mqrsp);
+  nxmq_unlink("bench_req");
+  nxmq_unlink("bench_rsp");
+}
+
+static int bench_mq_setup(void)
+{
+  struct mq_attr attr;
+  int ret;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = BENCH_MSGSIZE;
+
+  g_bench_state.mqreq = nxmq_open("bench_req", O_RDWR | O_CREAT, 0666,
+                                  &attr);
+  if (g_bench_state.mqreq < 0)
+    {
+      return (int)g_bench_state.mqreq;
+    }
+
+  g_bench_state.mqrsp = nxmq_open("bench_rsp", O_RDWR | O_CREAT, 0666,
+                                  &attr);
+  if (g_bench_state.mqrsp < 0)
+    {
+      ret = (int)g_bench_state.mqrsp;
+      nxmq_close(g_bench_state.mqreq);
+      nxmq_unlink("bench_req");
+      return ret;
+    }
+
+  ret = bench_start_helper(bench_mq_helper);
+  if (ret < 0)
+    {
+      bench_mq_close();
+    }
+
+  return ret;
+}
+
+static int bench_mq_run(uint32_t niter)
+{
+  char msg[BENCH_MSGSIZE];
+  unsigned int prio;
+  ssize_t nrecv;
+  int ret;
+
+  memset(msg, 0, sizeof(msg));
+  while (niter-- > 0)
+    {
+      ret = nxmq_send(g_bench_state.mqreq, msg, sizeof(msg), 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nrecv = nxmq_receive(g_bench_state.mqrsp, msg, sizeof(msg), &prio);
+      if (nrecv < 0)
+        {
+          return (int)nrecv;
+        }
+    }
+
+  return OK;
+}
+
+static void bench_mq_teardown(void)
+{
+  char msg[BENCH_MSGSIZE];
+
+  memset(msg, 0, sizeof(msg));
+  g_bench_state.stop = true;
+  nxmq_send(g_bench_state.mqreq, msg, sizeof(msg), 0);
+  bench_wait_helper();
+  bench_mq_close();
+}
+#endif
+
+/* Start and cancel of a watchdog */
+
+static void bench_wdog_cb(wdparm_t arg)
+{
+}
+
+static int bench_wdog_run(uint32_t niter)
+{
+  while (niter-- > 0)
+    {
+      wd_start(&g_bench_state.wdog, SEC2TICK(3600), bench_wdog_cb, 0);
+      wd_cancel(&g_bench_state.wdog);
+    }
+
+  return OK;
+}
+
+/* Heap allocation and release */
+
+static int bench_malloc_run(uint32_t niter)
+{
+  FAR void *mem;
+
+  while (niter-- > 0)
+    {
+      mem = kmm_malloc(BENCH_BLOCKSIZE);
+      if (mem == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      kmm_free(mem);
+    }
+
+  return OK;
+}
+
+/* Memory pool allocation and release */
+
+static int bench_mempool_setup(void)
+{
+  memset(&g_bench_state.pool, 0, sizeof(g_bench_state.pool));
+  g_bench_state.pool.bsize    = BENCH_BLOCKSIZE;
+  g_bench_state.pool.ninitial = 4;
+
+  return mempool_init(&g_bench_state.pool, "bench");
+}
+
+static int bench_mempool_run(uint32_t niter)
+{
+  FAR void *blk;
+
+  while (niter-- > 0)
+    {
+      blk = mempool_alloc(&g_bench_state.pool);
+      if (blk == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      mempool_free(&g_bench_state.pool, blk);
+    }
+
+  return OK;
+}
+
+static void bench_mempool_teardown(void)
+{
+  mempool_deinit(&g_bench_state.pool);
+}
+
+#ifdef CONFIG_MM_IOB
+/* I/O buffer allocation and release */
+
+static int bench_iob_run(uint32_t niter)
+{
+  FAR struct iob_s *iob;
+
+  while (niter-- > 0)
+    {
+      iob = iob_tryalloc(false);
+      if (iob == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      iob_free(iob);
+    }
+
+  return OK;
+}
+#endif
+
+#if defined(HAVE_BENCH_UDP) || defined(HAVE_BENCH_TCP)
+static void bench_loopback_addr(void)
+{
+  memset(&g_bench_state.addr, 0, sizeof(g_bench_state.addr));
+  g_bench_state.addr.sin_family      = AF_INET;
+  g_bench_state.addr.sin_port        = HTONS(BENCH_PORT);
+  g_bench_state.addr.sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+#endif
+
+#ifdef HAVE_BENCH_UDP
+/* UDP throughput through the loopback device:  datagrams sent to the
+ * socket itself.
+ */
+
+static int bench_udp_setup(void)
+{
+  int ret;
+
+  bench_loopback_addr();
+
+  ret = psock_socket(AF_INET, SOCK_DGRAM, 0, &g_bench_state.sock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = psock_bind(&g_bench_state.sock,
+                   (FAR const struct sockaddr *)&g_bench_state.addr,
+                   sizeof(g_bench_state.addr));
+  if (ret < 0)
+    {
+      psock_close(&g_bench_state.sock);
+    }
+
+  return ret;
+}
+
+static int bench_udp_run(uint32_t niter)
+{
+  ssize_t ret;
+
+  while (niter-- > 0)
+    {
+      ret = psock_sendto(&g_bench_state.sock, g_bench_state.chunk,
+                         BENCH_CHUNKSIZE, 0,
+                         (FAR const struct sockaddr *)&g_bench_state.addr,
+                         sizeof(g_bench_state.addr));
+      if (ret >= 0)
+        {
+          ret = psock_recvfrom(&g_bench_state.sock, g_bench_state.chunk,
+                               BENCH_CHUNKSIZE, 0, NULL, NULL);
+        }
+
+      if (ret < 0)
+        {
+          return (int)ret;
+        }
+    }
+
+  return OK;
+}
+
+static void bench_udp_teardown(void)
+{
+  psock_close(&g_bench_state.sock);
+}
+#endif
+
+#ifdef HAVE_BENCH_TCP
+/* TCP throughput through the loopback device:  the benchmark thread sends
+ * on one end of a connection and receives on the other one.
+ */
+
+static int bench_tcp_helper(int argc, FAR char *argv[])
+{
+  /* Connect while the benchmark thread waits in accept() */
+
+  psock_connect(&g_bench_state.peer,
+                (FAR const struct sockaddr *)&g_bench_state.addr,
+                sizeof(g_bench_state.addr));
+
+  nxsem_post(&g_bench_state.exited);
+  return 0;
+}
+
+static int bench_tcp_setup(void)
+{
+  struct socket listener;
+  int ret;
+
+  bench_loopback_addr();
+
+  ret = psock_socket(AF_INET, SOCK_STREAM, 0, &listener);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = psock_bind(&listener,
+                   (FAR const struct sockaddr *)&g_bench_state.addr,
+                   sizeof(g_bench_state.addr));
+  if (ret >= 0)
+    {
+      ret = psock_listen(&listener, 1);
+    }
+
+  if (ret >= 0)
+    {
+      ret = psock_socket(AF_INET, SOCK_STREAM, 0, &g_bench_state.peer);
+    }
+
+  if (ret < 0)
+    {
+      psock_close(&listener);
+      return ret;
+    }
+
+  ret = bench_start_helper(bench_tcp_helper);
+  if (ret >= 0)
+    {
+      ret = psock_accept(&listener, NULL, NULL, &g_bench_state.sock);
+      bench_wait_helper();
+    }
+
+  psock_close(&listener);
+  if (ret < 0)
+    {
+      psock_close(&g_bench_state.peer);
+    }
+
+  return ret;
+}
+
+static int bench_tcp_run(uint32_t niter)
+{
+  ssize_t nsent;
+  ssize_t nrecv;
+  ssize_t ret;
+
+  while (niter-- > 0)
+    {
+      nsent = psock_send(&g_bench_state.peer, g_bench_state.chunk,
+                         BENCH_CHUNKSIZE, 0);
+      if (nsent < 0)
+        {
+          return (int)nsent;
+        }
+
+      for (nrecv = 0; nrecv < nsent; nrecv += ret)
+        {
+          ret = psock_recv(&g_bench_state.sock, g_bench_state.chunk,
+                           nsent - nrecv, 0);
+          if (ret <= 0)
+            {
+              return ret < 0 ? (int)ret : -ECONNRESET;
+            }
+        }
+    }
+
+  return OK;
+}
+
+static void bench_tcp_teardown(void)
+{
+  psock_close(&g_bench_state.peer);
+  psock_close(&g_bench_state.sock);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_measure
+ *
+ * Description:
+ *   Run a benchmark with twice as many iterations each time until it lasts
+ *   long enough, and append its result to the output.
+ *
+ ****************************************************************************/
+
+static void bench_measure(FAR const struct bench_s *bench)
+{
+  struct timespec start;
+  struct timespec end;
+  uint64_t elapsed = 0;
+  uint64_t rate = 0;
+  uint64_t nsec10 = 0;
+  uint32_t niter = 1;
+  int ret = OK;
+
+  if (bench->setup != NULL)
+    {
+      ret = bench->setup();
+    }
+
+  if (ret >= 0)
+    {
+      for (; ; )
+        {
+          clock_systime_timespec(&start);
+          ret = bench->run(niter);
+          clock_systime_timespec(&end);
+
+          clock_timespec_subtract(&end, &start, &end);
+          elapsed = (uint64_t)end.tv_sec * NSEC_PER_SEC + end.tv_nsec;
+
+          if (ret < 0 || elapsed >= BENCH_MINTIME || niter >= BENCH_MAXITER)
+            {
+              break;
+            }
+
+          niter *= 2;
+        }
+
+      if (bench->teardown != NULL)
+        {
+          bench->teardown();
+        }
+    }
+
+  if (ret < 0)
+    {
+      niter   = 0;
+    }
+  else if (elapsed > 0)
+    {
+      nsec10  = elapsed * 10 / ((uint64_t)niter * bench->nops);
+      rate    = (uint64_t)bench->bytes * niter * NSEC_PER_SEC / elapsed;
+    }
+
+  g_bench_state.len +=
+    snprintf(g_bench_state.buffer + g_bench_state.len,
+             BENCH_BUFSIZE - g_bench_state.len,
+             "%s,%d,%" PRIu32 ",%" PRIu64 ".%u,%" PRIu64 "\n",
+             bench->name, ret < 0 ? ret : 0, niter, nsec10 / 10,
+             (unsigned int)(nsec10 % 10), rate);
+}
+
+/****************************************************************************
+ * Name: bench_thread
+ ****************************************************************************/
+
+static int bench_thread(int argc, FAR char *argv[])
+{
+  int i;
+
+  g_bench_state.len =
+    snprintf(g_bench_state.buffer, BENCH_BUFSIZE,
+             "# name,status,iterations,nsec/op,bytes/s\n");
+
+  for (i = 0; i < BENCH_NBENCH; i++)
+    {
+      bench_measure(&g_bench[i]);
+    }
+
+  nxsem_post(&g_bench_state.done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_open
+ ****************************************************************************/
+
+static int bench_open(FAR struct file *filep)
+{
+  FAR struct bench_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct bench_file_s) + BENCH_BUFSIZE);
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_close
+ ****************************************************************************/
+
+static int bench_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_read
+ *
+ * Description:
+ *   Run the benchmarks at the first read, in a thread of their own, and
+ *   return their results.
+ *
+ ****************************************************************************/
+
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct bench_file_s *priv = filep->f_priv;
+  size_t nread;
+  int ret;
+
+  if (!priv->done)
+    {
+      ret = nxmutex_lock(&g_bench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      g_bench_state.buffer = priv->buffer;
+      g_bench_state.len    = 0;
+      nxsem_init(&g_bench_state.done, 0, 0);
+
+      ret = kthread_create("bench", CONFIG_DEV_BENCH_PRIORITY,
+                           CONFIG_DEV_BENCH_STACKSIZE, bench_thread, NULL);
+      if (ret >= 0)
+        {
+          nxsem_wait_uninterruptible(&g_bench_state.done);
+          priv->len  = g_bench_state.len;
+          priv->done = true;
+        }
+
+      nxsem_destroy(&g_bench_state.done);
+      nxmutex_unlock(&g_bench_lock);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (filep->f_pos >= priv->len)
+    {
+      return 0;
+    }
+
+  nread = priv->len - filep->f_pos;
+  if (nread > buflen)
+    {
+      nread = buflen;
+    }
+
+  memcpy(buffer, priv->buffer + filep->f_pos, nread);
+  filep->f_pos += nread;
+  return nread;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devbench_register
+ *
+ * Description:
+ *   Register /dev/bench
+ *
+ ****************************************************************************/
+
+void devbench_register(void)
+{
+  register_driver("/dev/bench", &g_bench_fops, 0444, NULL);
+}
@@ -328,7 +328,7 @@ static int rd_geometry(FAR struct inode *inode, struct geometry *geometry)
  * Name: rd_ioctl
  *
  * Description:
- *   Return device geometry
+ *   Return the address of the RAM disk memory
  *
  ****************************************************************************/
 
@@ -336,21 +336,37 @@ static int rd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 {
   FAR struct rd_struct_s *dev;
   FAR void **ppv = (void**)((uintptr_t)arg);
+  FAR struct bio_dax_s *dax;
 
   finfo("Entry\n");
 
-  /* Only one ioctl command is supported */
-
   DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct rd_struct_s *)inode->i_private;
+
   if (cmd == BIOC_XIPBASE && ppv)
     {
-      dev  = (FAR struct rd_struct_s *)inode->i_private;
       *ppv = (FAR void *)dev->rd_buffer;
 
       finfo("ppv: %p\n", *ppv);
       return OK;
     }
 
+  /* The whole disk is one contiguous range of memory */
+
+  if (cmd == BIOC_DAX && arg != 0)
+    {
+      dax = (FAR struct bio_dax_s *)((uintptr_t)arg);
+      if (dax->startsector >= dev->rd_nsectors)
+        {
+          return -EINVAL;
+        }
+
+      dax->addr     = &dev->rd_buffer[dax->startsector * dev->rd_sectsize];
+      dax->nsectors = dev->rd_nsectors - dax->startsector;
+      dax->writable = RDFLAG_IS_WRENABLED(dev->rd_flags);
+      return OK;
+    }
+
   return -ENOTTY;
 }
 
@@ -32,6 +32,7 @@
 #include <limits.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -101,6 +102,13 @@ static int     rpmsgblk_send_recv(FAR struct rpmsgblk_s *priv,
                                   int len, FAR void *data);
 static FAR void *rpmsgblk_get_tx_payload_buffer(FAR struct rpmsgblk_s *priv,
                                                 FAR uint32_t *len);
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+static ssize_t rpmsgblk_shmem_transfer(FAR struct rpmsgblk_s *priv,
+                                       uint32_t command,
+                                       FAR unsigned char *buffer,
+                                       blkcnt_t start_sector,
+                                       unsigned int nsectors);
+#endif
 
 /* Functions handle the responses from the remote cpu */
 
@@ -110,6 +118,9 @@ static int     rpmsgblk_default_handler(FAR struct rpmsg_endpoint *ept,
 static int     rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv);
+static int     rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv);
 static int     rpmsgblk_geometry_handler(FAR struct rpmsg_endpoint *ept,
                                          FAR void *data, size_t len,
                                          uint32_t src, FAR void *priv);
@@ -132,6 +143,12 @@ static void    rpmsgblk_ns_bound(struct rpmsg_endpoint *ept);
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+/* Serializes the transfers bounced through the shared memory region */
+
+static mutex_t g_rpmsgblk_shmem_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /* Rpmsg device response handler table */
 
 static const rpmsg_ept_cb g_rpmsgblk_handler[] =
@@ -139,10 +156,14 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_OPEN]     = rpmsgblk_default_handler,
   [RPMSGBLK_CLOSE]    = rpmsgblk_default_handler,
   [RPMSGBLK_READ]     = rpmsgblk_read_handler,
-  [RPMSGBLK_WRITE]    = rpmsgblk_default_handler,
+  [RPMSGBLK_WRITE]    = rpmsgblk_write_handler,
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
   [RPMSGBLK_UNLINK]   = rpmsgblk_default_handler,
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+  [RPMSGBLK_READ_SHMEM]  = rpmsgblk_default_handler,
+  [RPMSGBLK_WRITE_SHMEM] = rpmsgblk_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -266,8 +287,10 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
                              blkcnt_t start_sector, unsigned int nsectors)
 {
   FAR struct rpmsgblk_s *priv = (FAR struct rpmsgblk_s *)inode->i_private;
+#ifndef CONFIG_BLK_RPMSG_SHMEM
   struct rpmsgblk_read_s msg;
   struct iovec iov;
+#endif
   int ret;
 
   if (buffer == NULL)
@@ -286,7 +309,14 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
       return ret;
     }
 
-  /* In block read, iov_len represent the received block number */
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+  return rpmsgblk_shmem_transfer(priv, RPMSGBLK_READ_SHMEM, buffer,
+                                 start_sector, nsectors);
+#else
+  /* The server returns the sectors in as many messages as needed, which
+   * arrive in order.  In block read, iov_len represent the received
+   * block number.
+   */
 
   iov.iov_base = buffer;
   iov.iov_len  = 0;
@@ -299,6 +329,7 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
                            sizeof(msg) - 1, &iov);
 
   return ret < 0 ? ret : iov.iov_len;
+#endif
 }
 
 /****************************************************************************
@@ -326,11 +357,15 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
                               blkcnt_t start_sector, unsigned int nsectors)
 {
   FAR struct rpmsgblk_s *priv = (FAR struct rpmsgblk_s *)inode->i_private;
+#ifndef CONFIG_BLK_RPMSG_SHMEM
   FAR struct rpmsgblk_write_s *msg;
   struct rpmsgblk_cookie_s cookie;
   uint32_t sectorsize;
   uint32_t space;
   size_t written = 0;
+  size_t acked = 0;
+  int i;
+#endif
   int ret;
 
   if (buffer == NULL)
@@ -349,40 +384,45 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
       return ret;
     }
 
-  /* Perform the rpmsg write */
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+  return rpmsgblk_shmem_transfer(priv, RPMSGBLK_WRITE_SHMEM,
+                                 (FAR unsigned char *)buffer,
+                                 start_sector, nsectors);
+#else
+  /* Split the write in as many messages as needed.  Each of them is
+   * acknowledged with the number of sectors written, and at most
+   * CONFIG_BLK_RPMSG_WINDOW of them are in flight: cookie.sem counts
+   * the free slots of the window.
+   */
 
   memset(&cookie, 0, sizeof(cookie));
-  nxsem_init(&cookie.sem, 0, 0);
+  nxsem_init(&cookie.sem, 0, CONFIG_BLK_RPMSG_WINDOW);
+  cookie.data = &acked;
 
   sectorsize = priv->geo.geo_sectorsize;
-  while (written < nsectors)
+  while (written < nsectors && cookie.result >= 0)
     {
+      rpmsg_wait(&priv->ept, &cookie.sem);
+
       msg = rpmsgblk_get_tx_payload_buffer(priv, &space);
       if (msg == NULL)
         {
+          nxsem_post(&cookie.sem);
           ret = -ENOMEM;
-          goto out;
+          break;
         }
 
       DEBUGASSERT(sizeof(*msg) - 1 + sectorsize <= space);
 
       msg->nsectors = (space - sizeof(*msg) + 1) / sectorsize;
-      if (msg->nsectors >= nsectors - written)
+      if (msg->nsectors > nsectors - written)
         {
-          /* Send complete, set cookie is valid, need ack */
-
           msg->nsectors = nsectors - written;
-          msg->header.cookie = (uintptr_t)&cookie;
-        }
-      else
-        {
-          /* Not send complete, set cookie invalid, do not need ack */
-
-          msg->header.cookie = 0;
         }
 
       msg->header.command = RPMSGBLK_WRITE;
       msg->header.result  = -ENXIO;
+      msg->header.cookie  = (uintptr_t)&cookie;
       msg->startsector    = start_sector;
       msg->sectorsize     = sectorsize;
       memcpy(msg->buf, buffer, msg->nsectors * sectorsize);
@@ -395,21 +435,27 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
                               sizeof(*msg) - 1 + msg->nsectors * sectorsize);
       if (ret < 0)
         {
-          goto out;
+          nxsem_post(&cookie.sem);
+          break;
         }
     }
 
-  ret = rpmsg_wait(&priv->ept, &cookie.sem);
-  if (ret < 0)
+  /* Wait for the acknowledgements of the messages in flight */
+
+  for (i = 0; i < CONFIG_BLK_RPMSG_WINDOW; i++)
     {
-      goto out;
+      rpmsg_wait(&priv->ept, &cookie.sem);
     }
 
-  ret = cookie.result;
-
-out:
   nxsem_destroy(&cookie.sem);
-  return ret < 0 ? ret : nsectors;
+
+  if (ret >= 0)
+    {
+      ret = cookie.result;
+    }
+
+  return ret < 0 ? ret : acked;
+#endif
 }
 
 /****************************************************************************
@@ -721,6 +767,122 @@ fail:
   return ret;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_shmem_transfer
+ *
+ * Description:
+ *   Read or write sectors through the shared memory region, sending only
+ *   descriptors over rpmsg.  A buffer that lies in the region is passed
+ *   to the server as is, any other one is bounced through the region.
+ *
+ * Parameters:
+ *   priv         - rpmsg blk handle
+ *   command      - RPMSGBLK_READ_SHMEM or RPMSGBLK_WRITE_SHMEM
+ *   buffer       - the data
+ *   start_sector - the first sector
+ *   nsectors     - the number of sectors
+ *
+ * Returned Values:
+ *   The number of sectors transferred; A negated errno value is returned
+ *   if none could be.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+static ssize_t rpmsgblk_shmem_transfer(FAR struct rpmsgblk_s *priv,
+                                       uint32_t command,
+                                       FAR unsigned char *buffer,
+                                       blkcnt_t start_sector,
+                                       unsigned int nsectors)
+{
+  FAR unsigned char *shmem =
+    (FAR unsigned char *)CONFIG_BLK_RPMSG_SHMEM_BASE;
+  size_t sectorsize = priv->geo.geo_sectorsize;
+  size_t total = nsectors * sectorsize;
+  struct rpmsgblk_shmem_s msg;
+  FAR unsigned char *addr;
+  unsigned int maxsectors;
+  unsigned int count;
+  unsigned int done = 0;
+  bool inplace;
+  int ret = 0;
+
+  inplace = total <= CONFIG_BLK_RPMSG_SHMEM_SIZE && buffer >= shmem &&
+            (size_t)(buffer - shmem) <= CONFIG_BLK_RPMSG_SHMEM_SIZE - total;
+  if (inplace)
+    {
+      maxsectors = nsectors;
+    }
+  else
+    {
+      maxsectors = CONFIG_BLK_RPMSG_SHMEM_SIZE / sectorsize;
+      if (maxsectors == 0)
+        {
+          return -EINVAL;
+        }
+
+      ret = nxmutex_lock(&g_rpmsgblk_shmem_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  while (done < nsectors)
+    {
+      count = nsectors - done < maxsectors ? nsectors - done : maxsectors;
+      addr  = inplace ? buffer : shmem;
+
+      if (command == RPMSGBLK_WRITE_SHMEM && !inplace)
+        {
+          memcpy(shmem, buffer + done * sectorsize, count * sectorsize);
+        }
+
+      /* Write back the data to send, and any dirty line of a buffer to
+       * receive that could otherwise overwrite the data of the server.
+       */
+
+      up_clean_dcache((uintptr_t)addr, (uintptr_t)addr + count * sectorsize);
+
+      msg.startsector = start_sector + done;
+      msg.nsectors    = count;
+      msg.sectorsize  = sectorsize;
+      msg.reserved    = 0;
+      msg.addr        = (uintptr_t)addr;
+
+      ret = rpmsgblk_send_recv(priv, command, true, &msg.header,
+                               sizeof(msg), NULL);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      if (command == RPMSGBLK_READ_SHMEM)
+        {
+          up_invalidate_dcache((uintptr_t)addr,
+                               (uintptr_t)addr + ret * sectorsize);
+          if (!inplace)
+            {
+              memcpy(buffer + done * sectorsize, shmem, ret * sectorsize);
+            }
+        }
+
+      done += ret;
+      if ((unsigned int)ret < count)
+        {
+          break;
+        }
+    }
+
+  if (!inplace)
+    {
+      nxmutex_unlock(&g_rpmsgblk_shmem_lock);
+    }
+
+  return done > 0 ? done : ret;
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgblk_default_handler
  *
@@ -805,6 +967,51 @@ static int rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_write_handler
+ *
+ * Description:
+ *   Rpmsg-blk block write response handler, this function will be called
+ *   to acknowledge each message of rpmsgblk_write().  It adds the sectors
+ *   written to the total, keeps the first error and frees a slot of the
+ *   window.
+ *
+ * Parameters:
+ *   ept  - The rpmsg endpoint
+ *   data - The return message
+ *   len  - The return message length
+ *   src  - unknow
+ *   priv - unknow
+ *
+ * Returned Values:
+ *   Always OK
+ *
+ ****************************************************************************/
+
+static int rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
+                                  FAR void *data, size_t len,
+                                  uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgblk_header_s *header = data;
+  FAR struct rpmsgblk_cookie_s *cookie =
+      (FAR struct rpmsgblk_cookie_s *)(uintptr_t)header->cookie;
+  FAR size_t *acked = cookie->data;
+
+  if (header->result < 0)
+    {
+      if (cookie->result >= 0)
+        {
+          cookie->result = header->result;
+        }
+    }
+  else
+    {
+      *acked += header->result;
+    }
+
+  return rpmsg_post(ept, &cookie->sem);
+}
+
 /****************************************************************************
  * Name: rpmsgblk_geometry_handler
  *
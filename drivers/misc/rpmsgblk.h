@@ -45,6 +45,8 @@
 #define RPMSGBLK_GEOMETRY        5
 #define RPMSGBLK_IOCTL           6
 #define RPMSGBLK_UNLINK          7
+#define RPMSGBLK_READ_SHMEM      8
+#define RPMSGBLK_WRITE_SHMEM     9
 
 /****************************************************************************
  * Public Types
@@ -98,6 +100,20 @@ begin_packed_struct struct rpmsgblk_unlink_s
   struct rpmsgblk_header_s header;
 } end_packed_struct;
 
+/* A transfer whose data is at addr in the shared memory region, rather
+ * than in the message.
+ */
+
+begin_packed_struct struct rpmsgblk_shmem_s
+{
+  struct rpmsgblk_header_s header;
+  uint32_t                 startsector;
+  uint32_t                 nsectors;
+  int32_t                  sectorsize;
+  uint32_t                 reserved;
+  uint64_t                 addr;
+} end_packed_struct;
+
 /****************************************************************************
  * Internal function prototypes
  ****************************************************************************/
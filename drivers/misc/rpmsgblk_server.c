@@ -26,6 +26,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/rptun/openamp.h>
@@ -74,6 +75,11 @@ static int rpmsgblk_ioctl_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgblk_unlink_handler(FAR struct rpmsg_endpoint *ept,
                                    FAR void *data, size_t len,
                                    uint32_t src, FAR void *priv);
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+static int rpmsgblk_shmem_handler(FAR struct rpmsg_endpoint *ept,
+                                  FAR void *data, size_t len,
+                                  uint32_t src, FAR void *priv);
+#endif
 
 /* Functions for creating communication with client cpu */
 
@@ -101,6 +107,10 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
   [RPMSGBLK_UNLINK]   = rpmsgblk_unlink_handler,
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+  [RPMSGBLK_READ_SHMEM]  = rpmsgblk_shmem_handler,
+  [RPMSGBLK_WRITE_SHMEM] = rpmsgblk_shmem_handler,
+#endif
 };
 
 /****************************************************************************
@@ -179,6 +189,10 @@ static int rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
   size_t nsectors;
   uint32_t space;
 
+  /* Stream the sectors back in as many messages as needed, the client
+   * appends them in the order they arrive.
+   */
+
   while (read < msg->nsectors)
     {
       rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
@@ -199,7 +213,7 @@ static int rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
         }
 
       ret = server->bops->read(server->blknode, (unsigned char *)rsp->buf,
-                               msg->startsector, msg->nsectors);
+                               msg->startsector + read, nsectors);
       rsp->header.result = ret;
       rpmsg_send_nocopy(ept, rsp, (ret < 0 ? 0 : ret * msg->sectorsize) +
                         sizeof(*rsp) - 1);
@@ -234,8 +248,8 @@ static int rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
       ferr("mtd block write failed\n");
     }
 
-  /* cookie != 0 indicate the data has been sent complete, so send back
-   * the total written blocks.
+  /* cookie != 0 indicate the client waits for the acknowledgement of the
+   * message, send back the written blocks.
    */
 
   if (msg->header.cookie != 0)
@@ -301,6 +315,59 @@ static int rpmsgblk_unlink_handler(FAR struct rpmsg_endpoint *ept,
   return rpmsg_send(ept, msg, len);
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_shmem_handler
+ *
+ * Description:
+ *   Read or write the sectors at the address of the message, which must
+ *   lie in the shared memory region.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BLK_RPMSG_SHMEM
+static int rpmsgblk_shmem_handler(FAR struct rpmsg_endpoint *ept,
+                                  FAR void *data, size_t len,
+                                  uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgblk_server_s *server = ept->priv;
+  FAR struct rpmsgblk_shmem_s *msg = data;
+  uintptr_t addr = msg->addr;
+  size_t size = (size_t)msg->nsectors * msg->sectorsize;
+  int ret;
+
+  if (addr < CONFIG_BLK_RPMSG_SHMEM_BASE ||
+      size > CONFIG_BLK_RPMSG_SHMEM_SIZE ||
+      addr - CONFIG_BLK_RPMSG_SHMEM_BASE >
+      CONFIG_BLK_RPMSG_SHMEM_SIZE - size)
+    {
+      ret = -EFAULT;
+    }
+  else if (msg->header.command == RPMSGBLK_READ_SHMEM)
+    {
+      ret = server->bops->read(server->blknode, (FAR unsigned char *)addr,
+                               msg->startsector, msg->nsectors);
+      if (ret > 0)
+        {
+          up_clean_dcache(addr, addr + ret * msg->sectorsize);
+        }
+    }
+  else
+    {
+      up_invalidate_dcache(addr, addr + size);
+      ret = server->bops->write(server->blknode, (FAR unsigned char *)addr,
+                                msg->startsector, msg->nsectors);
+    }
+
+  if (ret < 0)
+    {
+      ferr("shmem transfer failed, ret=%d\n", ret);
+    }
+
+  msg->header.result = ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgblk_ns_match
  ****************************************************************************/
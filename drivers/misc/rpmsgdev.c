@@ -119,6 +119,9 @@ static int     rpmsgdev_default_handler(FAR struct rpmsg_endpoint *ept,
 static int     rpmsgdev_read_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv);
+static int     rpmsgdev_write_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv);
 static int     rpmsgdev_ioctl_handler(FAR struct rpmsg_endpoint *ept,
                                       FAR void *data, size_t len,
                                       uint32_t src, FAR void *priv);
@@ -148,7 +151,7 @@ static const rpmsg_ept_cb g_rpmsgdev_handler[] =
   [RPMSGDEV_OPEN]   = rpmsgdev_default_handler,
   [RPMSGDEV_CLOSE]  = rpmsgdev_default_handler,
   [RPMSGDEV_READ]   = rpmsgdev_read_handler,
-  [RPMSGDEV_WRITE]  = rpmsgdev_default_handler,
+  [RPMSGDEV_WRITE]  = rpmsgdev_write_handler,
   [RPMSGDEV_LSEEK]  = rpmsgdev_default_handler,
   [RPMSGDEV_IOCTL]  = rpmsgdev_ioctl_handler,
   [RPMSGDEV_POLL]   = rpmsgdev_default_handler,
@@ -466,7 +469,9 @@ static ssize_t rpmsgdev_write(FAR struct file *filep, const char *buffer,
   struct rpmsgdev_cookie_s cookie;
   uint32_t space;
   size_t written = 0;
+  size_t acked = 0;
   int ret;
+  int i;
 
   if (buffer == NULL)
     {
@@ -495,37 +500,38 @@ static ssize_t rpmsgdev_write(FAR struct file *filep, const char *buffer,
         }
     }
 
-  /* Perform the rpmsg write */
+  /* Split the write in as many messages as needed.  Each of them is
+   * acknowledged with the number of bytes written, and at most
+   * CONFIG_DEV_RPMSG_WINDOW of them are in flight: cookie.sem counts the
+   * free slots of the window.
+   */
 
   memset(&cookie, 0, sizeof(cookie));
-  nxsem_init(&cookie.sem, 0, 0);
+  nxsem_init(&cookie.sem, 0, CONFIG_DEV_RPMSG_WINDOW);
+  cookie.data = &acked;
 
-  while (written < buflen)
+  ret = 0;
+  while (written < buflen && cookie.result >= 0)
     {
+      rpmsg_wait(&dev->ept, &cookie.sem);
+
       msg = rpmsgdev_get_tx_payload_buffer(dev, &space);
       if (msg == NULL)
         {
+          nxsem_post(&cookie.sem);
           ret = -ENOMEM;
-          goto out;
+          break;
         }
 
       space -= sizeof(*msg) - 1;
-      if (space >= buflen - written)
+      if (space > buflen - written)
         {
-          /* Send complete, set cookie is valid, need ack */
-
           space = buflen - written;
-          msg->header.cookie = (uintptr_t)&cookie;
-        }
-      else
-        {
-          /* Not send complete, set cookie invalid, do not need ack */
-
-          msg->header.cookie = 0;
         }
 
       msg->header.command = RPMSGDEV_WRITE;
       msg->header.result  = -ENXIO;
+      msg->header.cookie  = (uintptr_t)&cookie;
       msg->filep          = priv->filep;
       msg->count          = space;
       memcpy(msg->buf, buffer + written, space);
@@ -533,23 +539,28 @@ static ssize_t rpmsgdev_write(FAR struct file *filep, const char *buffer,
       ret = rpmsg_send_nocopy(&dev->ept, msg, sizeof(*msg) - 1 + space);
       if (ret < 0)
         {
-          goto out;
+          nxsem_post(&cookie.sem);
+          break;
         }
 
       written += space;
     }
 
-  ret = rpmsg_wait(&dev->ept, &cookie.sem);
-  if (ret < 0)
+  /* Wait for the acknowledgements of the messages in flight */
+
+  for (i = 0; i < CONFIG_DEV_RPMSG_WINDOW; i++)
     {
-      goto out;
+      rpmsg_wait(&dev->ept, &cookie.sem);
     }
 
-  ret = cookie.result;
-
-out:
   nxsem_destroy(&cookie.sem);
-  return ret < 0 ? ret : buflen;
+
+  if (ret >= 0)
+    {
+      ret = cookie.result;
+    }
+
+  return acked > 0 ? acked : ret;
 }
 
 /****************************************************************************
@@ -932,6 +943,52 @@ static int rpmsgdev_read_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+/****************************************************************************
+ * Name: rpmsgdev_write_handler
+ *
+ * Description:
+ *   Rpmsg-device write response handler, this function will be called to
+ *   acknowledge each message of rpmsgdev_write().  It adds the bytes
+ *   written to the total, keeps the first error and frees a slot of the
+ *   window.
+ *
+ * Parameters:
+ *   ept  - The rpmsg endpoint
+ *   data - The return message
+ *   len  - The return message length
+ *   src  - unknow
+ *   priv - unknow
+ *
+ * Returned Values:
+ *   Always OK
+ *
+ ****************************************************************************/
+
+static int rpmsgdev_write_handler(FAR struct rpmsg_endpoint *ept,
+                                  FAR void *data, size_t len,
+                                  uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgdev_header_s *header = data;
+  FAR struct rpmsgdev_cookie_s *cookie =
+      (FAR struct rpmsgdev_cookie_s *)(uintptr_t)header->cookie;
+  FAR size_t *acked = cookie->data;
+
+  if (header->result < 0)
+    {
+      if (cookie->result >= 0)
+        {
+          cookie->result = header->result;
+        }
+    }
+  else
+    {
+      *acked += header->result;
+    }
+
+  rpmsg_post(ept, &cookie->sem);
+  return 0;
+}
+
 /****************************************************************************
  * Name: rpmsgdev_ioctl_handler
  *
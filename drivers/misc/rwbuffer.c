@@ -35,6 +35,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
@@ -62,6 +63,10 @@
 
 static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                          size_t nblocks, FAR uint8_t *rdbuffer);
+#ifdef CONFIG_DRVR_READAHEAD
+static void rwb_rhinvalidate(FAR struct rwbuffer_s *rwb,
+                             off_t startblock, size_t blockcount);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -117,56 +122,211 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1,
 #ifdef CONFIG_DRVR_WRITEBUFFER
 static inline void rwb_resetwrbuffer(FAR struct rwbuffer_s *rwb)
 {
+  int i;
+
   /* We assume that the caller holds the wrlock */
 
-  rwb->wrnblocks    = 0;
-  rwb->wrblockstart = -1;
+  for (i = 0; i < rwb->wrnbuffers; i++)
+    {
+      rwb->wrbuffers[i].window  = -1;
+      rwb->wrbuffers[i].nblocks = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrfind
+ *
+ * Description:
+ *   Return the write buffer of a window, or NULL if it is not buffered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static FAR struct rwb_wrbuffer_s *rwb_wrfind(FAR struct rwbuffer_s *rwb,
+                                             off_t window)
+{
+  int i;
+
+  for (i = 0; i < rwb->wrnbuffers; i++)
+    {
+      if (rwb->wrbuffers[i].window == window)
+        {
+          return &rwb->wrbuffers[i];
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrvictim
+ *
+ * Description:
+ *   Return a free write buffer or else the least recently written one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static FAR struct rwb_wrbuffer_s *rwb_wrvictim(FAR struct rwbuffer_s *rwb)
+{
+  FAR struct rwb_wrbuffer_s *victim = &rwb->wrbuffers[0];
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < rwb->wrnbuffers; i++)
+    {
+      if (rwb->wrbuffers[i].window < 0)
+        {
+          return &rwb->wrbuffers[i];
+        }
+
+      if (now - rwb->wrbuffers[i].stamp > now - victim->stamp)
+        {
+          victim = &rwb->wrbuffers[i];
+        }
+    }
+
+  return victim;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrfill
+ *
+ * Description:
+ *   Read blocks of the window of a write buffer from the media, to fill a
+ *   gap between the buffered blocks or to pad them to the alignment.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static int rwb_wrfill(FAR struct rwbuffer_s *rwb,
+                      FAR struct rwb_wrbuffer_s *wrb,
+                      size_t first, size_t nblocks)
+{
+  ssize_t ret;
+
+  ret = rwb->rhreload(rwb->dev, &wrb->buffer[first * rwb->blocksize],
+                      wrb->window + first, nblocks);
+  if (ret != (ssize_t)nblocks)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  return OK;
 }
 #endif
 
 /****************************************************************************
  * Name: rwb_wrflush
  *
+ * Description:
+ *   Write the blocks of a write buffer to the media and free the buffer.
+ *
  * Assumptions:
  *   The caller holds the wrlock mutex.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
+static int rwb_wrflush(FAR struct rwbuffer_s *rwb,
+                       FAR struct rwb_wrbuffer_s *wrb)
 {
-  int ret;
+  size_t first = wrb->first;
+  size_t end = wrb->first + wrb->nblocks;
+  ssize_t ret = OK;
+  size_t pad;
 
-  if (rwb->wrnblocks > 0)
+  if (wrb->nblocks > 0)
     {
-      size_t padblocks;
+      /* Pad the buffered blocks to the alignment.  The window is aligned,
+       * but the device may end within it.
+       */
 
-      finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
-            (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+      pad = first % rwb->wralignblocks;
+      if (pad > 0 && rwb_wrfill(rwb, wrb, first - pad, pad) >= 0)
+        {
+          first -= pad;
+        }
 
-      padblocks = rwb->wrnblocks % rwb->wralignblocks;
-      if (padblocks)
+      pad = end % rwb->wralignblocks;
+      if (pad > 0)
         {
-          padblocks = rwb->wralignblocks - padblocks;
-          rwb_read_(rwb, rwb->wrblockstart + rwb->wrnblocks, padblocks,
-                    &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-          rwb->wrnblocks += padblocks;
+          pad = rwb->wralignblocks - pad;
+          if (wrb->window + end + pad <= rwb->nblocks &&
+              rwb_wrfill(rwb, wrb, end, pad) >= 0)
+            {
+              end += pad;
+            }
         }
 
+      finfo("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n",
+            (long)(wrb->window + first), (int)(end - first), wrb->buffer);
+
       /* Flush cache.  On success, the flush method will return the number
        * of blocks written.  Anything other than the number requested is
        * an error.
        */
 
-      ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart,
-                         rwb->wrnblocks);
-      if (ret != rwb->wrnblocks)
+      ret = rwb->wrflush(rwb->dev, &wrb->buffer[first * rwb->blocksize],
+                         wrb->window + first, end - first);
+      if (ret != (ssize_t)(end - first))
+        {
+          ferr("ERROR: Error flushing write buffer: %zd\n", ret);
+          ret = ret < 0 ? ret : -EIO;
+        }
+      else
+        {
+          ret = OK;
+        }
+
+#ifdef CONFIG_DRVR_READAHEAD
+      /* The read-ahead buffers may have been loaded with old data of the
+       * blocks while they were pending here.
+       */
+
+      if (rwb->rhmaxblocks > 0)
         {
-          ferr("ERROR: Error flushing write buffer: %d\n", ret);
+          nxmutex_lock(&rwb->rhlock);
+          rwb_rhinvalidate(rwb, wrb->window + first, end - first);
+          nxmutex_unlock(&rwb->rhlock);
         }
+#endif
+    }
 
-      rwb_resetwrbuffer(rwb);
+  wrb->window  = -1;
+  wrb->nblocks = 0;
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrflushall
+ *
+ * Assumptions:
+ *   The caller holds the wrlock mutex.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static int rwb_wrflushall(FAR struct rwbuffer_s *rwb)
+{
+  int ret = OK;
+  int tmp;
+  int i;
+
+  for (i = 0; i < rwb->wrnbuffers; i++)
+    {
+      tmp = rwb_wrflush(rwb, &rwb->wrbuffers[i]);
+      if (tmp < 0)
+        {
+          ret = tmp;
+        }
     }
+
+  return ret;
 }
 #endif
 
@@ -177,20 +337,56 @@ static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
 #if defined(CONFIG_DRVR_WRITEBUFFER) && CONFIG_DRVR_WRDELAY != 0
 static void rwb_wrtimeout(FAR void *arg)
 {
-  /* The following assumes that the size of a pointer is 4-bytes or less */
-
   FAR struct rwbuffer_s *rwb = (FAR struct rwbuffer_s *)arg;
+  FAR struct rwb_wrbuffer_s *wrb;
+  clock_t delay = MSEC2TICK(CONFIG_DRVR_WRDELAY);
+  clock_t next = delay;
+  clock_t elapsed;
+  clock_t now;
+  bool pending = false;
+  int i;
+
   DEBUGASSERT(rwb != NULL);
 
   finfo("Timeout!\n");
 
-  /* If a timeout elapses with write buffer activity, this watchdog
-   * handler function will be evoked on the thread of execution of the
-   * worker thread.
+  /* This work is run on the low priority worker thread when a full write
+   * buffer is waiting or when a write buffer has not been written to for
+   * the delay.  Either is flushed; the others are left to a later run.
    */
 
   rwb_lock(&rwb->wrlock);
-  rwb_wrflush(rwb);
+
+  now = clock_systime_ticks();
+  for (i = 0; i < rwb->wrnbuffers; i++)
+    {
+      wrb = &rwb->wrbuffers[i];
+      if (wrb->nblocks == 0)
+        {
+          continue;
+        }
+
+      elapsed = now - wrb->stamp;
+      if (wrb->nblocks == rwb->wrmaxblocks || elapsed >= delay)
+        {
+          rwb_wrflush(rwb, wrb);
+        }
+      else
+        {
+          if (delay - elapsed < next)
+            {
+              next = delay - elapsed;
+            }
+
+          pending = true;
+        }
+    }
+
+  if (pending)
+    {
+      work_queue(LPWORK, &rwb->work, rwb_wrtimeout, rwb, next);
+    }
+
   rwb_unlock(&rwb->wrlock);
 }
 #endif
@@ -200,15 +396,24 @@ static void rwb_wrtimeout(FAR void *arg)
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
+static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb, bool full)
 {
 #if CONFIG_DRVR_WRDELAY != 0
   /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds. CLK_TCK
-   * provides the clock tick of the system (frequency in Hz).
+   * provides the clock tick of the system (frequency in Hz).  A full write
+   * buffer cannot combine more writes: It is flushed in the background at
+   * once rather than by a later write that needs the buffer.
    */
 
-  int ticks = MSEC2TICK(CONFIG_DRVR_WRDELAY);
-  work_queue(LPWORK, &rwb->work, rwb_wrtimeout, rwb, ticks);
+  if (full)
+    {
+      work_queue(LPWORK, &rwb->work, rwb_wrtimeout, rwb, 0);
+    }
+  else if (work_available(&rwb->work))
+    {
+      work_queue(LPWORK, &rwb->work, rwb_wrtimeout, rwb,
+                 MSEC2TICK(CONFIG_DRVR_WRDELAY));
+    }
 #endif
 }
 #endif
@@ -227,174 +432,238 @@ static inline void rwb_wrcanceltimeout(FAR struct rwbuffer_s *rwb)
 #endif
 
 /****************************************************************************
- * Name: rwb_writebuffer
+ * Name: rwb_wrmerge
+ *
+ * Description:
+ *   Copy blocks of one window into its write buffer.  The buffered blocks
+ *   stay contiguous:  A gap between them and the new ones is read from the
+ *   media.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, uint32_t nblocks,
-                               FAR const uint8_t *wrbuffer)
+static void rwb_wrmerge(FAR struct rwbuffer_s *rwb,
+                        FAR struct rwb_wrbuffer_s *wrb, size_t first,
+                        size_t nblocks, FAR const uint8_t *wrbuffer)
 {
-  uint32_t nwritten = nblocks;
-
-  /* Write writebuffer Logic */
-
-  rwb_wrcanceltimeout(rwb);
-
-  /* Is data saved in the write buffer? */
+  size_t end = wrb->first + wrb->nblocks;
+  size_t newend = first + nblocks;
+  off_t window;
+  int ret = OK;
 
-  if (rwb->wrnblocks > 0)
+  if (wrb->nblocks > 0)
     {
-      off_t wrbend;
-      off_t newend;
-
-      /* Now there are five cases:
-       *
-       * 1. We update the non-overlapping region
-       */
-
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
-      newend = startblock + nblocks;
-
-      if (wrbend < startblock || rwb->wrblockstart > newend)
+      if (first > end)
         {
-          /* Nothing to do */;
+          ret = rwb_wrfill(rwb, wrb, end, first - end);
+        }
+      else if (newend < wrb->first)
+        {
+          ret = rwb_wrfill(rwb, wrb, newend, wrb->first - newend);
         }
 
-      /* 2. We update the entire write buffer. */
-
-      else if (rwb->wrblockstart > startblock && wrbend < newend)
+      if (ret < 0)
         {
-          rwb->wrnblocks = 0;
+          /* Write out what is buffered and start over */
+
+          window = wrb->window;
+          rwb_wrflush(rwb, wrb);
+          wrb->window = window;
         }
+    }
 
-      /* We are going to update a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 3. We update a portion in the middle of the write buffer
-       */
+  if (wrb->nblocks == 0)
+    {
+      wrb->first = first;
+      end        = newend;
+    }
+  else
+    {
+      if (first < wrb->first)
+        {
+          wrb->first = first;
+        }
 
-      else if (rwb->wrblockstart <= startblock && wrbend >= newend)
+      if (newend > end)
         {
-          FAR uint8_t *dest;
-          size_t offset;
+          end = newend;
+        }
+    }
 
-          /* Copy the data to the middle of write buffer */
+  memcpy(&wrb->buffer[first * rwb->blocksize], wrbuffer,
+         nblocks * rwb->blocksize);
+  wrb->nblocks = end - wrb->first;
+  wrb->stamp   = clock_systime_ticks();
+}
+#endif
 
-          offset = startblock - rwb->wrblockstart;
-          dest   = rwb->wrbuffer + offset * rwb->blocksize;
-          memcpy(dest, wrbuffer, nblocks * rwb->blocksize);
+/****************************************************************************
+ * Name: rwb_writebuffer
+ ****************************************************************************/
 
-          nblocks = 0;
-        }
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
+                               off_t startblock, size_t nblocks,
+                               FAR const uint8_t *wrbuffer)
+{
+  FAR struct rwb_wrbuffer_s *wrb;
+  size_t nwritten = nblocks;
+  bool full = false;
+  size_t first;
+  size_t ncopy;
+  off_t window;
+  int i;
+
+  /* Each write buffer holds the blocks of one aligned window of
+   * wrmaxblocks blocks, so that the writes to several windows combine
+   * independently.
+   */
 
-      /* 4. We update a portion at the end of the write buffer */
+  while (nblocks > 0)
+    {
+      first  = startblock % rwb->wrmaxblocks;
+      window = startblock - first;
 
-      else if (wrbend >= startblock && wrbend <= newend)
+      if (first == 0 && nblocks >= rwb->wrmaxblocks)
         {
-          FAR uint8_t *dest;
-          size_t offset;
-          size_t ncopy;
+          ssize_t ret;
 
-          /* Copy the data from the updating region to the end
-           * of the write buffer.
+          /* Whole windows are written through, replacing what is buffered
+           * for them.
            */
 
-          offset = rwb->wrnblocks - (wrbend - startblock);
-          ncopy  = rwb->wrmaxblocks - offset;
-          if (ncopy > nblocks)
+          ncopy = nblocks - nblocks % rwb->wrmaxblocks;
+          for (i = 0; i < rwb->wrnbuffers; i++)
             {
-              ncopy = nblocks;
+              wrb = &rwb->wrbuffers[i];
+              if (wrb->window >= startblock &&
+                  wrb->window < startblock + ncopy)
+                {
+                  wrb->window  = -1;
+                  wrb->nblocks = 0;
+                }
             }
 
-          dest = rwb->wrbuffer + offset * rwb->blocksize;
-          memcpy(dest, wrbuffer, ncopy * rwb->blocksize);
-
-          rwb->wrnblocks = offset + ncopy;
-          wrbuffer      += ncopy * rwb->blocksize;
-          startblock    += ncopy;
-          nblocks       -= ncopy;
+          ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, ncopy);
+          if (ret < 0)
+            {
+              return ret;
+            }
         }
-
-      /* 5. We update a portion at the beginning of the write buffer */
-
-      else /* if (rwb->wrblockstart >= startblock && wrbend >= newend) */
+      else
         {
-          FAR uint8_t *dest;
-          FAR const uint8_t *src;
-          size_t ncopy;
-
-          DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend >= newend);
+          ncopy = rwb->wrmaxblocks - first;
+          if (ncopy > nblocks)
+            {
+              ncopy = nblocks;
+            }
 
-          /* Move the cached data to the end of the write buffer */
+          /* Buffer the blocks, recycling the least recently written buffer
+           * if this window has none.
+           */
 
-          ncopy = rwb->wrblockstart - startblock;
-          if (ncopy > rwb->wrmaxblocks - rwb->wrnblocks)
+          wrb = rwb_wrfind(rwb, window);
+          if (wrb == NULL)
             {
-              ncopy = rwb->wrmaxblocks - rwb->wrnblocks;
+              wrb = rwb_wrvictim(rwb);
+              rwb_wrflush(rwb, wrb);
+              wrb->window = window;
             }
 
-          dest = rwb->wrbuffer + ncopy * rwb->blocksize;
-          memmove(dest, rwb->wrbuffer, ncopy * rwb->blocksize);
+          rwb_wrmerge(rwb, wrb, first, ncopy, wrbuffer);
+          if (wrb->nblocks == rwb->wrmaxblocks)
+            {
+              full = true;
+            }
+        }
 
-          rwb->wrblockstart -= ncopy;
-          rwb->wrnblocks    += ncopy;
+      startblock += ncopy;
+      nblocks    -= ncopy;
+      wrbuffer   += ncopy * rwb->blocksize;
+    }
 
-          /* Copy the data from the updating region to the beginning
-           * of the write buffer.
-           */
+  rwb_wrstarttimeout(rwb, full);
+  return nwritten;
+}
+#endif
 
-          ncopy = newend - rwb->wrblockstart;
-          src   = wrbuffer + (nblocks - ncopy) * rwb->blocksize;
-          memcpy(rwb->wrbuffer, src, ncopy * rwb->blocksize);
+/****************************************************************************
+ * Name: rwb_resetrhbuffer
+ ****************************************************************************/
 
-          nblocks -= ncopy;
-        }
-    }
+#ifdef CONFIG_DRVR_READAHEAD
+static inline void rwb_resetrhbuffer(FAR struct rwbuffer_s *rwb)
+{
+  int i;
 
-  /* Use the block cache unless the buffer size is bigger than block cache */
+  /* We assume that the caller holds the readAheadBufferSemaphore */
 
-  if (nblocks > rwb->wrmaxblocks)
+  for (i = 0; i < rwb->rhnbuffers; i++)
     {
-      ssize_t ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
-      if (ret < 0)
-        {
-          return ret;
-        }
+      rwb->rhbuffers[i].nblocks    = 0;
+      rwb->rhbuffers[i].blockstart = -1;
     }
-  else if (nblocks)
-    {
-      /* Flush the write buffer */
-
-      rwb_wrflush(rwb);
+}
+#endif
 
-      /* Buffer the data in the write buffer */
+/****************************************************************************
+ * Name: rwb_rhfind
+ *
+ * Description:
+ *   Return the read-ahead buffer that holds a block, or NULL if none does.
+ *
+ ****************************************************************************/
 
-      memcpy(rwb->wrbuffer, wrbuffer, nblocks * rwb->blocksize);
-      rwb->wrblockstart = startblock;
-      rwb->wrnblocks    = nblocks;
-    }
+#ifdef CONFIG_DRVR_READAHEAD
+static FAR struct rwb_rhbuffer_s *rwb_rhfind(FAR struct rwbuffer_s *rwb,
+                                             off_t block)
+{
+  FAR struct rwb_rhbuffer_s *rhb;
+  int i;
 
-  if (rwb->wrnblocks > 0)
+  for (i = 0; i < rwb->rhnbuffers; i++)
     {
-      rwb_wrstarttimeout(rwb);
+      rhb = &rwb->rhbuffers[i];
+      if (rhb->nblocks > 0 && block >= rhb->blockstart &&
+          block < rhb->blockstart + rhb->nblocks)
+        {
+          return rhb;
+        }
     }
 
-  return nwritten;
+  return NULL;
 }
 #endif
 
 /****************************************************************************
- * Name: rwb_resetrhbuffer
+ * Name: rwb_rhvictim
+ *
+ * Description:
+ *   Return an empty read-ahead buffer or else the least recently used one.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static inline void rwb_resetrhbuffer(FAR struct rwbuffer_s *rwb)
+static FAR struct rwb_rhbuffer_s *rwb_rhvictim(FAR struct rwbuffer_s *rwb)
 {
-  /* We assume that the caller holds the readAheadBufferSemaphore */
+  FAR struct rwb_rhbuffer_s *victim = &rwb->rhbuffers[0];
+  int i;
+
+  for (i = 0; i < rwb->rhnbuffers; i++)
+    {
+      if (rwb->rhbuffers[i].nblocks == 0)
+        {
+          return &rwb->rhbuffers[i];
+        }
 
-  rwb->rhnblocks    = 0;
-  rwb->rhblockstart = -1;
+      if (rwb->rhseq - rwb->rhbuffers[i].stamp >
+          rwb->rhseq - victim->stamp)
+        {
+          victim = &rwb->rhbuffers[i];
+        }
+    }
+
+  return victim;
 }
 #endif
 
@@ -404,8 +673,8 @@ static inline void rwb_resetrhbuffer(FAR struct rwbuffer_s *rwb)
 
 #ifdef CONFIG_DRVR_READAHEAD
 static inline void
-rwb_bufferread(FAR struct rwbuffer_s *rwb,  off_t startblock,
-               size_t nblocks, FAR uint8_t **rdbuffer)
+rwb_bufferread(FAR struct rwbuffer_s *rwb, FAR struct rwb_rhbuffer_s *rhb,
+               off_t startblock, size_t nblocks, FAR uint8_t **rdbuffer)
 {
   FAR uint8_t *rhbuffer;
 
@@ -417,13 +686,13 @@ rwb_bufferread(FAR struct rwbuffer_s *rwb,  off_t startblock,
 
   /* Convert the units from blocks to bytes */
 
-  off_t  blockoffset = startblock - rwb->rhblockstart;
+  off_t  blockoffset = startblock - rhb->blockstart;
   off_t  byteoffset  = rwb->blocksize * blockoffset;
   size_t nbytes      = rwb->blocksize * nblocks;
 
   /* Get the byte address in the read-ahead buffer */
 
-  rhbuffer           = rwb->rhbuffer + byteoffset;
+  rhbuffer           = rhb->buffer + byteoffset;
 
   /* Copy the data from the read-ahead buffer into the IO buffer */
 
@@ -432,6 +701,7 @@ rwb_bufferread(FAR struct rwbuffer_s *rwb,  off_t startblock,
   /* Update the caller's copy for the next address */
 
   *rdbuffer += nbytes;
+  rhb->stamp = ++rwb->rhseq;
 }
 #endif
 
@@ -440,7 +710,8 @@ rwb_bufferread(FAR struct rwbuffer_s *rwb,  off_t startblock,
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static int rwb_rhreload(FAR struct rwbuffer_s *rwb, off_t startblock)
+static int rwb_rhreload(FAR struct rwbuffer_s *rwb,
+                        FAR struct rwb_rhbuffer_s *rhb, off_t startblock)
 {
   off_t  endblock;
   size_t nblocks;
@@ -470,17 +741,18 @@ static int rwb_rhreload(FAR struct rwbuffer_s *rwb, off_t startblock)
 
   /* Reset the read buffer */
 
-  rwb_resetrhbuffer(rwb);
+  rhb->nblocks    = 0;
+  rhb->blockstart = -1;
 
   /* Now perform the read */
 
-  ret = rwb->rhreload(rwb->dev, rwb->rhbuffer, startblock, nblocks);
+  ret = rwb->rhreload(rwb->dev, rhb->buffer, startblock, nblocks);
   if (ret == nblocks)
     {
       /* Update information about what is in the read-ahead buffer */
 
-      rwb->rhnblocks    = nblocks;
-      rwb->rhblockstart = startblock;
+      rhb->nblocks    = nblocks;
+      rhb->blockstart = startblock;
 
       /* The return value is not the number of blocks we asked to be
        * loaded.
@@ -505,12 +777,15 @@ static int rwb_rhreload(FAR struct rwbuffer_s *rwb, off_t startblock)
 int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
+  FAR struct rwb_wrbuffer_s *wrb;
   int ret = OK;
+  int i;
 
-  /* Is there a write buffer?  Is data saved in the write buffer? */
+  /* Is there a write buffer? */
 
-  if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
+  if (rwb->wrmaxblocks > 0)
     {
+      off_t wrbstart;
       off_t wrbend;
       off_t invend;
 
@@ -523,111 +798,87 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
           return ret;
         }
 
-      /* Now there are five cases:
-       *
-       * 1. We invalidate nothing
-       */
-
-      wrbend = rwb->wrblockstart + rwb->wrnblocks;
       invend = startblock + blockcount;
 
-      if (wrbend <= startblock || rwb->wrblockstart >= invend)
-        {
-          ret = OK;
-        }
-
-      /* 2. We invalidate the entire write buffer. */
-
-      else if (rwb->wrblockstart >= startblock && wrbend <= invend)
+      for (i = 0; i < rwb->wrnbuffers; i++)
         {
-          rwb->wrnblocks = 0;
-          ret = OK;
-        }
-
-      /* We are going to invalidate a subset of the write buffer.  Three
-       * more cases to consider:
-       *
-       * 3. We invalidate a portion in the middle of the write buffer
-       */
+          /* Is data saved in this write buffer? */
 
-      else if (rwb->wrblockstart < startblock && wrbend > invend)
-        {
-          FAR uint8_t *src;
-          off_t block;
-          off_t offset;
-          size_t nblocks;
+          wrb = &rwb->wrbuffers[i];
+          if (wrb->nblocks == 0)
+            {
+              continue;
+            }
 
-          /* Write the blocks at the end of the media to hardware */
+          /* Now there are five cases:
+           *
+           * 1. We invalidate nothing
+           */
 
-          nblocks = wrbend - invend;
-          block   = invend;
-          offset  = block - rwb->wrblockstart;
-          src     = rwb->wrbuffer + offset * rwb->blocksize;
+          wrbstart = wrb->window + wrb->first;
+          wrbend   = wrbstart + wrb->nblocks;
 
-          ret = rwb->wrflush(rwb->dev, src, block, nblocks);
-          if (ret < 0)
+          if (wrbend <= startblock || wrbstart >= invend)
             {
-              ferr("ERROR: wrflush failed: %d\n", ret);
             }
 
-          /* Keep the blocks at the beginning of the buffer up the
-           * start of the invalidated region.
-           */
+          /* 2. We invalidate the entire write buffer. */
 
-          else
+          else if (wrbstart >= startblock && wrbend <= invend)
             {
-              rwb->wrnblocks = startblock - rwb->wrblockstart;
-              ret = OK;
+              wrb->window  = -1;
+              wrb->nblocks = 0;
             }
-        }
-
-      /* 4. We invalidate a portion at the end of the write buffer */
 
-      else if (wrbend > startblock && wrbend <= invend)
-        {
-          rwb->wrnblocks -= wrbend - startblock;
-          ret = OK;
-        }
+          /* We are going to invalidate a subset of the write buffer.
+           * Three more cases to consider:
+           *
+           * 3. We invalidate a portion in the middle of the write buffer
+           */
 
-      /* 5. We invalidate a portion at the beginning of the write buffer */
+          else if (wrbstart < startblock && wrbend > invend)
+            {
+              FAR uint8_t *src;
+              int tmp;
 
-      else /* if (rwb->wrblockstart >= startblock && wrbend > invend) */
-        {
-          FAR uint8_t *src;
-          size_t ninval;
-          size_t nkeep;
+              /* Write the blocks at the end of the media to hardware */
 
-          DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend > invend);
+              src = &wrb->buffer[(invend - wrb->window) * rwb->blocksize];
+              tmp = rwb->wrflush(rwb->dev, src, invend, wrbend - invend);
+              if (tmp < 0)
+                {
+                  ferr("ERROR: wrflush failed: %d\n", tmp);
+                  ret = tmp;
+                }
 
-          /* Copy the data from the uninvalidated region to the beginning
-           * of the write buffer.
-           *
-           * First calculate the source and destination of the transfer.
-           */
+              /* Keep the blocks at the beginning of the buffer up the
+               * start of the invalidated region.
+               */
 
-          ninval = invend - rwb->wrblockstart;
-          src    = rwb->wrbuffer + ninval * rwb->blocksize;
+              else
+                {
+                  wrb->nblocks = startblock - wrbstart;
+                }
+            }
 
-          /* Calculate the number of blocks we are keeping.  We keep
-           * the ones that we don't invalidate.
-           */
+          /* 4. We invalidate a portion at the end of the write buffer */
 
-          nkeep  = rwb->wrnblocks - ninval;
+          else if (wrbend > startblock && wrbend <= invend)
+            {
+              wrb->nblocks -= wrbend - startblock;
+            }
 
-          /* Then move the data that we are keeping to the beginning
-           * the write buffer.
+          /* 5. We invalidate a portion at the beginning of the write
+           *    buffer.  The blocks are kept at their place in the window.
            */
 
-          memcpy(rwb->wrbuffer, src, nkeep * rwb->blocksize);
-
-          /* Update the block info.  The first block is now the one just
-           * after the invalidation region and the number buffered blocks
-           * is the number that we kept.
-           */
+          else /* if (wrbstart >= startblock && wrbend > invend) */
+            {
+              DEBUGASSERT(wrbstart >= startblock && wrbend > invend);
 
-          rwb->wrblockstart = invend;
-          rwb->wrnblocks    = nkeep;
-          ret = OK;
+              wrb->first   = invend - wrb->window;
+              wrb->nblocks = wrbend - invend;
+            }
         }
 
       rwb_unlock(&rwb->wrlock);
@@ -638,31 +889,33 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
 #endif
 
 /****************************************************************************
- * Name: rwb_invalidate_readahead
+ * Name: rwb_rhinvalidate
  *
  * Description:
- *   Invalidate a region of the read-ahead buffer
+ *   Invalidate a region of the read-ahead buffers
+ *
+ * Assumptions:
+ *   The caller holds the rhlock mutex.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
+#ifdef CONFIG_DRVR_READAHEAD
+static void rwb_rhinvalidate(FAR struct rwbuffer_s *rwb,
                              off_t startblock, size_t blockcount)
 {
-  int ret = OK;
-
-  if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0)
-    {
-      off_t rhbend;
-      off_t invend;
+  FAR struct rwb_rhbuffer_s *rhb;
+  off_t rhbend;
+  off_t invend;
+  int i;
 
-      finfo("startblock=%" PRIdOFF " blockcount=%zu\n",
-            startblock, blockcount);
+  invend = startblock + blockcount;
 
-      ret = rwb_lock(&rwb->rhlock);
-      if (ret < 0)
+  for (i = 0; i < rwb->rhnbuffers; i++)
+    {
+      rhb = &rwb->rhbuffers[i];
+      if (rhb->nblocks == 0)
         {
-          return ret;
+          continue;
         }
 
       /* Now there are five cases:
@@ -670,86 +923,111 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
        * 1. We invalidate nothing
        */
 
-      rhbend = rwb->rhblockstart + rwb->rhnblocks;
-      invend = startblock + blockcount;
+      rhbend = rhb->blockstart + rhb->nblocks;
 
-      if (rhbend <= startblock || rwb->rhblockstart >= invend)
+      if (rhbend <= startblock || rhb->blockstart >= invend)
         {
-          ret = OK;
         }
 
       /* 2. We invalidate the entire read-ahead buffer. */
 
-      else if (rwb->rhblockstart >= startblock && rhbend <= invend)
+      else if (rhb->blockstart >= startblock && rhbend <= invend)
         {
-          rwb->rhnblocks = 0;
-          ret = OK;
+          rhb->nblocks = 0;
         }
 
       /* We are going to invalidate a subset of the read-ahead buffer.
        * Three more cases to consider:
        *
-       * 2. We invalidate a portion in the middle of the read-ahead buffer
+       * 3. We invalidate a portion in the middle of the read-ahead buffer
        */
 
-      else if (rwb->rhblockstart < startblock && rhbend > invend)
+      else if (rhb->blockstart < startblock && rhbend > invend)
         {
           /* Keep the blocks at the beginning of the buffer up the
            * start of the invalidated region.
            */
 
-          rwb->rhnblocks = startblock - rwb->rhblockstart;
-          ret = OK;
+          rhb->nblocks = startblock - rhb->blockstart;
         }
 
-      /* 3. We invalidate a portion at the end of the read-ahead buffer */
+      /* 4. We invalidate a portion at the end of the read-ahead buffer */
 
       else if (rhbend > startblock && rhbend <= invend)
         {
-          rwb->rhnblocks -= rhbend - startblock;
-          ret = OK;
+          rhb->nblocks -= rhbend - startblock;
         }
 
-      /* 4. We invalidate a portion at the begin of the read-ahead buffer */
+      /* 5. We invalidate a portion at the begin of the read-ahead buffer */
 
-      else /* if (rwb->rhblockstart >= startblock && rhbend > invend) */
+      else /* if (rhb->blockstart >= startblock && rhbend > invend) */
         {
           FAR uint8_t *src;
           size_t ninval;
           size_t nkeep;
 
-          DEBUGASSERT(rwb->rhblockstart >= startblock && rhbend > invend);
+          DEBUGASSERT(rhb->blockstart >= startblock && rhbend > invend);
+
           /* Copy the data from the uninvalidated region to the beginning
            * of the read buffer.
            *
            * First calculate the source and destination of the transfer.
            */
 
-          ninval = invend - rwb->rhblockstart;
-          src    = rwb->rhbuffer + ninval * rwb->blocksize;
+          ninval = invend - rhb->blockstart;
+          src    = rhb->buffer + ninval * rwb->blocksize;
 
           /* Calculate the number of blocks we are keeping.  We keep
            * the ones that we don't invalidate.
            */
 
-          nkeep  = rwb->rhnblocks - ninval;
+          nkeep  = rhb->nblocks - ninval;
 
           /* Then move the data that we are keeping to the beginning
            * the read buffer.
            */
 
-          memmove(rwb->rhbuffer, src, nkeep * rwb->blocksize);
+          memmove(rhb->buffer, src, nkeep * rwb->blocksize);
 
           /* Update the block info.  The first block is now the one just
            * after the invalidation region and the number buffered blocks
            * is the number that we kept.
            */
 
-          rwb->rhblockstart = invend;
-          rwb->rhnblocks    = nkeep;
+          rhb->blockstart = invend;
+          rhb->nblocks    = nkeep;
         }
+    }
+}
+#endif
 
-      rwb_unlock(&rwb->rhlock);
+/****************************************************************************
+ * Name: rwb_invalidate_readahead
+ *
+ * Description:
+ *   Invalidate a region of the read-ahead buffer
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
+int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
+                             off_t startblock, size_t blockcount)
+{
+  int ret = OK;
+
+  if (rwb->rhmaxblocks > 0)
+    {
+      finfo("startblock=%" PRIdOFF " blockcount=%zu\n",
+            startblock, blockcount);
+
+      ret = nxmutex_lock(&rwb->rhlock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      rwb_rhinvalidate(rwb, startblock, blockcount);
+      nxmutex_unlock(&rwb->rhlock);
     }
 
   return ret;
@@ -767,6 +1045,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 int rwb_initialize(FAR struct rwbuffer_s *rwb)
 {
   uint32_t allocsize;
+  int i;
 
   /* Sanity checking */
 
@@ -779,11 +1058,13 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   DEBUGASSERT(rwb->wrflush != NULL);
-  rwb->wrbuffer = NULL;
+  rwb->wrbuffer  = NULL;
+  rwb->wrbuffers = NULL;
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   DEBUGASSERT(rwb->rhreload != NULL);
-  rwb->rhbuffer = NULL;
+  rwb->rhbuffer  = NULL;
+  rwb->rhbuffers = NULL;
 #endif
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -796,6 +1077,11 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
           rwb->wralignblocks = 1;
         }
 
+      if (rwb->wrnbuffers == 0)
+        {
+          rwb->wrnbuffers = 1;
+        }
+
       DEBUGASSERT(rwb->wralignblocks <= rwb->wrmaxblocks &&
                   rwb->wrmaxblocks % rwb->wralignblocks == 0);
 
@@ -803,21 +1089,31 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       nxmutex_init(&rwb->wrlock);
 
-      /* Initialize write buffer parameters */
-
-      rwb_resetwrbuffer(rwb);
-
-      /* Allocate the write buffer */
+      /* Allocate the write buffers */
 
-      allocsize     = rwb->wrmaxblocks * rwb->blocksize;
-      rwb->wrbuffer = kmm_malloc(allocsize);
-      if (!rwb->wrbuffer)
+      allocsize      = rwb->wrnbuffers * rwb->wrmaxblocks * rwb->blocksize;
+      rwb->wrbuffer  = kmm_malloc(allocsize);
+      rwb->wrbuffers = kmm_malloc(rwb->wrnbuffers *
+                                  sizeof(struct rwb_wrbuffer_s));
+      if (!rwb->wrbuffer || !rwb->wrbuffers)
         {
           ferr("Write buffer kmm_malloc(%" PRIu32 ") failed\n", allocsize);
+          kmm_free(rwb->wrbuffer);
+          kmm_free(rwb->wrbuffers);
           nxmutex_destroy(&rwb->wrlock);
           return -ENOMEM;
         }
 
+      for (i = 0; i < rwb->wrnbuffers; i++)
+        {
+          rwb->wrbuffers[i].buffer = rwb->wrbuffer +
+                                     i * rwb->wrmaxblocks * rwb->blocksize;
+        }
+
+      /* Initialize write buffer parameters */
+
+      rwb_resetwrbuffer(rwb);
+
       finfo("Write buffer size: %" PRIu32 " bytes\n", allocsize);
     }
 #endif /* CONFIG_DRVR_WRITEBUFFER */
@@ -827,22 +1123,27 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
     {
       finfo("Initialize the read-ahead buffer\n");
 
+      if (rwb->rhnbuffers == 0)
+        {
+          rwb->rhnbuffers = 1;
+        }
+
       /* Initialize the read-ahead buffer access mutex */
 
       nxmutex_init(&rwb->rhlock);
 
-      /* Initialize read-ahead buffer parameters */
-
-      rwb_resetrhbuffer(rwb);
-
-      /* Allocate the read-ahead buffer */
+      /* Allocate the read-ahead buffers */
 
-      allocsize     = rwb->rhmaxblocks * rwb->blocksize;
-      rwb->rhbuffer = kmm_malloc(allocsize);
-      if (!rwb->rhbuffer)
+      allocsize      = rwb->rhnbuffers * rwb->rhmaxblocks * rwb->blocksize;
+      rwb->rhbuffer  = kmm_malloc(allocsize);
+      rwb->rhbuffers = kmm_malloc(rwb->rhnbuffers *
+                                  sizeof(struct rwb_rhbuffer_s));
+      if (!rwb->rhbuffer || !rwb->rhbuffers)
         {
           ferr("Read-ahead buffer kmm_malloc(%" PRIu32 ") failed\n",
           allocsize);
+          kmm_free(rwb->rhbuffer);
+          kmm_free(rwb->rhbuffers);
           nxmutex_destroy(&rwb->rhlock);
 #ifdef CONFIG_DRVR_WRITEBUFFER
           if (rwb->wrmaxblocks > 0)
@@ -853,12 +1154,25 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
           if (rwb->wrbuffer != NULL)
             {
               kmm_free(rwb->wrbuffer);
+              kmm_free(rwb->wrbuffers);
             }
 #endif
 
           return -ENOMEM;
         }
 
+      for (i = 0; i < rwb->rhnbuffers; i++)
+        {
+          rwb->rhbuffers[i].buffer = rwb->rhbuffer +
+                                     i * rwb->rhmaxblocks * rwb->blocksize;
+          rwb->rhbuffers[i].stamp  = 0;
+        }
+
+      /* Initialize read-ahead buffer parameters */
+
+      rwb->rhseq = 0;
+      rwb_resetrhbuffer(rwb);
+
       finfo("Read-ahead buffer size: %" PRIu32 " bytes\n", allocsize);
     }
 #endif /* CONFIG_DRVR_READAHEAD */
@@ -876,11 +1190,16 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
   if (rwb->wrmaxblocks > 0)
     {
       rwb_wrcanceltimeout(rwb);
-      rwb_wrflush(rwb);
+      if (rwb->wrbuffers)
+        {
+          rwb_wrflushall(rwb);
+        }
+
       nxmutex_destroy(&rwb->wrlock);
       if (rwb->wrbuffer)
         {
           kmm_free(rwb->wrbuffer);
+          kmm_free(rwb->wrbuffers);
         }
     }
 #endif
@@ -892,6 +1211,7 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
       if (rwb->rhbuffer)
         {
           kmm_free(rwb->rhbuffer);
+          kmm_free(rwb->rhbuffers);
         }
     }
 #endif
@@ -909,7 +1229,9 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
 #ifdef CONFIG_DRVR_READAHEAD
   if (rwb->rhmaxblocks > 0)
     {
+      FAR struct rwb_rhbuffer_s *rhb;
       size_t remaining;
+      size_t rdblocks;
 
       ret = nxmutex_lock(&rwb->rhlock);
       if (ret < 0)
@@ -921,38 +1243,15 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
 
       for (remaining = nblocks; remaining > 0; )
         {
-          /* Is there anything in the read-ahead buffer? */
-
-          if (rwb->rhnblocks > 0)
-            {
-              off_t bufferend;
-
-              /* How many blocks are available in this buffer? */
-
-              bufferend = rwb->rhblockstart + rwb->rhnblocks;
-              if (startblock >= rwb->rhblockstart && startblock < bufferend)
-                {
-                  size_t rdblocks = bufferend - startblock;
-                  if (rdblocks > remaining)
-                    {
-                      rdblocks = remaining;
-                    }
-
-                  /* Then read the data from the read-ahead buffer */
-
-                  rwb_bufferread(rwb, startblock, rdblocks, &rdbuffer);
-                  startblock += rdblocks;
-                  remaining  -= rdblocks;
-                }
-            }
-
-          /* If we did not get all of the data from the buffer, then we have
-           * to refill the buffer and try again.
+          /* Is the next block in a read-ahead buffer?  If not, we have to
+           * refill the least recently used buffer.
            */
 
-          if (remaining > 0)
+          rhb = rwb_rhfind(rwb, startblock);
+          if (rhb == NULL)
             {
-              ret = rwb_rhreload(rwb, startblock);
+              rhb = rwb_rhvictim(rwb);
+              ret = rwb_rhreload(rwb, rhb, startblock);
               if (ret < 0)
                 {
                   ferr("ERROR: Failed to fill the read-ahead buffer: %d\n",
@@ -962,6 +1261,20 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                   return ret;
                 }
             }
+
+          /* How many blocks are available in this buffer? */
+
+          rdblocks = rhb->blockstart + rhb->nblocks - startblock;
+          if (rdblocks > remaining)
+            {
+              rdblocks = remaining;
+            }
+
+          /* Then read the data from the read-ahead buffer */
+
+          rwb_bufferread(rwb, rhb, startblock, rdblocks, &rdbuffer);
+          startblock += rdblocks;
+          remaining  -= rdblocks;
         }
 
       /* On success, return the number of blocks that we were requested to
@@ -985,6 +1298,41 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: rwb_wrlookup
+ *
+ * Description:
+ *   Return the write buffer with the first pending blocks of a range, or
+ *   NULL if none of the blocks are pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static FAR struct rwb_wrbuffer_s *rwb_wrlookup(FAR struct rwbuffer_s *rwb,
+                                               off_t startblock,
+                                               size_t nblocks)
+{
+  FAR struct rwb_wrbuffer_s *found = NULL;
+  FAR struct rwb_wrbuffer_s *wrb;
+  int i;
+
+  for (i = 0; i < rwb->wrnbuffers; i++)
+    {
+      wrb = &rwb->wrbuffers[i];
+      if (wrb->nblocks > 0 &&
+          rwb_overlap(wrb->window + wrb->first, wrb->nblocks,
+                      startblock, nblocks) &&
+          (found == NULL ||
+           wrb->window + wrb->first < found->window + found->first))
+        {
+          found = wrb;
+        }
+    }
+
+  return found;
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_read
  ****************************************************************************/
@@ -999,63 +1347,68 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
         (long)startblock, (long)nblocks, rdbuffer);
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-  /* If the new read data overlaps any part of the write buffer, we
+  /* If the new read data overlaps any part of the write buffers, we
    * directly copy write buffer to read buffer. This boost performance.
    */
 
   if (rwb->wrmaxblocks > 0)
     {
+      FAR struct rwb_wrbuffer_s *wrb;
+
       ret = nxmutex_lock(&rwb->wrlock);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* If the write buffer overlaps the block(s) requested */
+      /* Read the blocks up to the next pending ones, then copy those */
 
-      if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock,
-                      nblocks))
+      while (nblocks > 0 &&
+             (wrb = rwb_wrlookup(rwb, startblock, nblocks)) != NULL)
         {
-          size_t rdblocks = 0;
-          size_t wrnpass  = 0;
+          off_t wrbstart = wrb->window + wrb->first;
+          size_t rdblocks;
 
-          if (rwb->wrblockstart > startblock)
+          if (wrbstart > startblock)
             {
-              rdblocks = rwb->wrblockstart - startblock;
-              ret = rwb_read_(rwb, startblock, rdblocks, rdbuffer);
+              ret = rwb_read_(rwb, startblock, wrbstart - startblock,
+                              rdbuffer);
               if (ret < 0)
                 {
                   rwb_unlock(&rwb->wrlock);
                   return ret;
                 }
-
-              startblock += ret;
-              nblocks    -= ret;
-              rdbuffer   += ret * rwb->blocksize;
-              readblocks += ret;
             }
-
-          if (rwb->wrblockstart < startblock)
+          else
             {
-              wrnpass = startblock - rwb->wrblockstart;
-            }
+              rdblocks = wrbstart + wrb->nblocks - startblock;
+              if (rdblocks > nblocks)
+                {
+                  rdblocks = nblocks;
+                }
 
-          rdblocks = nblocks > (rwb->wrnblocks - wrnpass) ?
-                    (rwb->wrnblocks - wrnpass) : nblocks;
-          memcpy(rdbuffer, &rwb->wrbuffer[wrnpass * rwb->blocksize],
-                rdblocks * rwb->blocksize);
+              memcpy(rdbuffer,
+                     &wrb->buffer[(startblock - wrb->window) *
+                                  rwb->blocksize],
+                     rdblocks * rwb->blocksize);
+              ret = rdblocks;
+            }
 
-          startblock += rdblocks;
-          nblocks    -= rdblocks;
-          rdbuffer   += rdblocks * rwb->blocksize;
-          readblocks += rdblocks;
+          startblock += ret;
+          nblocks    -= ret;
+          rdbuffer   += ret * rwb->blocksize;
+          readblocks += ret;
         }
 
+      ret = nblocks > 0 ? rwb_read_(rwb, startblock, nblocks, rdbuffer) : 0;
       rwb_unlock(&rwb->wrlock);
     }
+  else
 #endif
+    {
+      ret = rwb_read_(rwb, startblock, nblocks, rdbuffer);
+    }
 
-  ret = rwb_read_(rwb, startblock, nblocks, rdbuffer);
   if (ret < 0)
     {
       return ret;
@@ -1076,10 +1429,8 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 #ifdef CONFIG_DRVR_READAHEAD
   if (rwb->rhmaxblocks > 0)
     {
-      /* If the new write data overlaps any part of the read buffer, then
-       * flush the data from the read buffer.  We could attempt some more
-       * exotic handling -- but this simple logic is well-suited for simple
-       * streaming applications.
+      /* If the new write data overlaps any part of the read buffers, then
+       * invalidate those blocks in the read buffers.
        */
 
       ret = nxmutex_lock(&rwb->rhlock);
@@ -1088,24 +1439,7 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
           return ret;
         }
 
-      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock,
-                      nblocks))
-        {
-#ifdef CONFIG_DRVR_INVALIDATE
-          /* Just invalidate the read buffer startblock + nblocks data */
-
-          ret = rwb_invalidate_readahead(rwb, startblock, nblocks);
-          if (ret < 0)
-            {
-              ferr("ERROR: rwb_invalidate_readahead failed: %d\n", ret);
-              rwb_unlock(&rwb->rhlock);
-              return ret;
-            }
-#else
-          rwb_resetrhbuffer(rwb);
-#endif
-        }
-
+      rwb_rhinvalidate(rwb, startblock, nblocks);
       rwb_unlock(&rwb->rhlock);
     }
 #endif
@@ -1182,6 +1516,8 @@ ssize_t rwb_readbytes(FAR struct rwbuffer_s *dev, off_t offset,
 #ifdef CONFIG_DRVR_REMOVABLE
 int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
 {
+  int ret;
+
 #ifdef CONFIG_DRVR_WRITEBUFFER
   if (rwb->wrmaxblocks > 0)
     {
@@ -1264,8 +1600,13 @@ int rwb_flush(FAR struct rwbuffer_s *rwb)
   int ret;
 
   ret = rwb_lock(&rwb->wrlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   rwb_wrcanceltimeout(rwb);
-  rwb_wrflush(rwb);
+  ret = rwb_wrflushall(rwb);
   rwb_unlock(&rwb->wrlock);
 
   return ret;
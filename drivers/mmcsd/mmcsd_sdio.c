@@ -93,6 +93,10 @@
 # define MMCSD_MULTIBLOCK_LIMIT  CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
 
+/* The largest block count that CMD23 (SET_BLOCK_COUNT) accepts */
+
+#define MMCSD_CMD23_MAXBLOCKS   (0xffff)
+
 #define MMCSD_CAPACITY(b, s)    ((s) >= 10 ? (b) << ((s) - 10) : (b) >> (10 - (s)))
 
 /****************************************************************************
@@ -116,6 +120,9 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+#ifdef CONFIG_MMCSD_CMD23
+  uint8_t cmd23:1;                 /* true: card supports CMD23 (SCR/EXT_CSD) */
+#endif
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -177,6 +184,10 @@ static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
 #endif
+#if MMCSD_MULTIBLOCK_LIMIT != 1 && defined(CONFIG_MMCSD_CMD23)
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                 uint32_t nblocks);
+#endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                  uint32_t blocklen);
 static ssize_t mmcsd_readsingle(FAR struct mmcsd_state_s *priv,
@@ -977,6 +988,19 @@ static void mmcsd_decode_scr(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
   priv->buswidth     = (scr[0] >> 8) & 15;
 #endif
 
+  /*   CMD_SUPPORT            33:32 2-bit CMD23/CMD20 support (SD 3.0)
+   *
+   * Only bit 33 (CMD23, SET_BLOCK_COUNT) is of interest.
+   */
+
+#ifdef CONFIG_MMCSD_CMD23
+#ifdef CONFIG_ENDIAN_BIG
+  priv->cmd23        = (scr[0] >> 1) & 1;
+#else
+  priv->cmd23        = (scr[0] >> 25) & 1;
+#endif
+#endif
+
 #ifdef CONFIG_DEBUG_FS_INFO
 #ifdef CONFIG_ENDIAN_BIG
   /* Card SCR is big-endian order / CPU also big-endian
@@ -1303,6 +1327,35 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send CMD23, SET_BLOCK_COUNT, before a multiple block transfer.  The
+ *   card then ends the transfer by itself after 'nblocks' blocks and no
+ *   CMD12 (STOP_TRANSMISSION) is needed.
+ *
+ ****************************************************************************/
+
+#if MMCSD_MULTIBLOCK_LIMIT != 1 && defined(CONFIG_MMCSD_CMD23)
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               uint32_t nblocks)
+{
+  int ret;
+
+  DEBUGASSERT(nblocks > 0 && nblocks <= MMCSD_CMD23_MAXBLOCKS);
+
+  mmcsd_sendcmdpoll(priv, MMCSD_CMD23, nblocks);
+  ret = mmcsd_recv_r1(priv, MMCSD_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recv_r1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1579,6 +1632,22 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       SDIO_RECVSETUP(priv->dev, buffer, nbytes);
     }
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* Tell the card how many blocks will follow so that no CMD12 is needed
+   * at the end of the transfer.
+   */
+
+  if (priv->cmd23)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          SDIO_CANCEL(priv->dev);
+          return ret;
+        }
+    }
+#endif
+
   /* Send CMD18, READ_MULT_BLOCK: Read a block of the size selected by
    * the mmcsd_setblocklen() and verify that good R1 status is returned
    */
@@ -1601,6 +1670,15 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* The transfer ended by itself after the count given with CMD23 */
+
+  if (priv->cmd23)
+    {
+      return nblocks;
+    }
+#endif
+
   /* Send STOP_TRANSMISSION */
 
   ret = mmcsd_stoptransmission(priv);
@@ -1900,6 +1978,22 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
         }
     }
 
+#ifdef CONFIG_MMCSD_CMD23
+  /* Tell the card how many blocks will follow so that no CMD12 is needed
+   * at the end of the transfer.  For SD cards, this must come after
+   * ACMD23.
+   */
+
+  if (priv->cmd23)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* If Controller does not need DMA setup before the write then send CMD25
    * now.
    */
@@ -1975,18 +2069,25 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
        */
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION.  With a block count set by CMD23, the card
+   * has already left the receive-data state unless the transfer failed.
+   */
 
-  ret = mmcsd_stoptransmission(priv);
-  if (evret != OK)
+#ifdef CONFIG_MMCSD_CMD23
+  if (!priv->cmd23 || evret != OK)
+#endif
     {
-      return evret;
-    }
+      ret = mmcsd_stoptransmission(priv);
+      if (evret != OK)
+        {
+          return evret;
+        }
 
-  if (ret != OK)
-    {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
-      return ret;
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+          return ret;
+        }
     }
 
   /* Flag that a write transfer is pending that we will have to check for
@@ -2117,6 +2218,13 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
               nread = MMCSD_MULTIBLOCK_LIMIT;
             }
 
+#ifdef CONFIG_MMCSD_CMD23
+          if (priv->cmd23 && nread > MMCSD_CMD23_MAXBLOCKS)
+            {
+              nread = MMCSD_CMD23_MAXBLOCKS;
+            }
+#endif
+
           if (nread == 1)
             {
               nread = mmcsd_readsingle(priv, buffer, sector);
@@ -2195,6 +2303,13 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
               nwrite = MMCSD_MULTIBLOCK_LIMIT;
             }
 
+#ifdef CONFIG_MMCSD_CMD23
+          if (priv->cmd23 && nwrite > MMCSD_CMD23_MAXBLOCKS)
+            {
+              nwrite = MMCSD_CMD23_MAXBLOCKS;
+            }
+#endif
+
           if (nwrite == 1)
             {
               nwrite = mmcsd_writesingle(priv, buffer, sector);
@@ -2752,6 +2867,18 @@ static int mmcsd_read_csd(FAR struct mmcsd_state_s *priv)
   finfo("MMC ext CSD read succsesfully, number of block %" PRId32 "\n",
         priv->nblocks);
 
+  /* Every card with an EXT_CSD (MMC 4.0 or later) supports CMD23.  Command
+   * queuing (CMDQ_SUPPORT, EXT_CSD[308]) would need a host controller
+   * with a task descriptor interface, so it is only reported.
+   */
+
+#ifdef CONFIG_MMCSD_CMD23
+  priv->cmd23 = true;
+#endif
+
+  finfo("EXT_CSD_REV: %d CMDQ_SUPPORT: %d CMDQ_DEPTH: %d\n",
+        buffer[192], buffer[308] & 1, (buffer[307] & 0x1f) + 1);
+
   SDIO_GOTEXTCSD(priv->dev, buffer);
 
   /* Return value:  One sector read */
@@ -3426,6 +3553,9 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->type         = MMCSD_CARDTYPE_UNKNOWN;
   priv->rca          = 0;
   priv->selblocklen  = 0;
+#ifdef CONFIG_MMCSD_CMD23
+  priv->cmd23        = false;
+#endif
 
   /* Go back to the default 1-bit data bus. */
 
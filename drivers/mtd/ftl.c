@@ -43,6 +43,8 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
 
+#include "ftl_map.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -74,6 +76,9 @@ struct ftl_struct_s
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
   FAR uint8_t          *eblock;   /* One, in-memory erase block */
+#ifdef CONFIG_FTL_MAP
+  FAR struct ftl_map_s *map;      /* Page-mapped translation layer */
+#endif
 };
 
 /****************************************************************************
@@ -155,11 +160,17 @@ static int ftl_close(FAR struct inode *inode)
 #ifdef CONFIG_FTL_WRITEBUFFER
   rwb_flush(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_MAP
+  ftl_map_sync(dev->map);
+#endif
 
   if (--dev->refs == 0 && dev->unlinked)
     {
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_MAP
+      ftl_map_uninitialize(dev->map);
 #endif
       if (dev->eblock)
         {
@@ -185,6 +196,10 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   ssize_t nread;
 
+#ifdef CONFIG_FTL_MAP
+  return ftl_map_read(dev->map, buffer, startblock, nblocks);
+#endif
+
   /* Read the full erase block into the buffer */
 
   nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
@@ -254,6 +269,12 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   int    nbytes;
   int    ret;
 
+#ifdef CONFIG_FTL_MAP
+  /* Sectors are written out of place, with no erase block rewrite */
+
+  return ftl_map_write(dev->map, buffer, startblock, nblocks);
+#endif
+
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -475,7 +496,11 @@ static int ftl_geometry(FAR struct inode *inode,
       geometry->geo_available     = true;
       geometry->geo_mediachanged  = false;
       geometry->geo_writeenabled  = true;
+#ifdef CONFIG_FTL_MAP
+      geometry->geo_nsectors      = ftl_map_nsectors(dev->map);
+#else
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       finfo("available: true mediachanged: false writeenabled: %s\n",
@@ -510,6 +535,13 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     {
 #ifdef CONFIG_FTL_WRITEBUFFER
       rwb_flush(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_MAP
+      ret = ftl_map_sync(dev->map);
+      if (ret < 0)
+        {
+          return ret;
+        }
 #endif
     }
 
@@ -547,6 +579,9 @@ static int ftl_unlink(FAR struct inode *inode)
     {
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_MAP
+      ftl_map_uninitialize(dev->map);
 #endif
       if (dev->eblock)
         {
@@ -618,11 +653,26 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_MAP
+      /* Mount the translation layer */
+
+      dev->map = ftl_map_initialize(mtd, &dev->geo);
+      if (dev->map == NULL)
+        {
+          kmm_free(dev);
+          return -ENOMEM;
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize     = dev->geo.blocksize;
+#ifdef CONFIG_FTL_MAP
+      dev->rwb.nblocks       = ftl_map_nsectors(dev->map);
+#else
       dev->rwb.nblocks       = dev->geo.neraseblocks * dev->blkper;
+#endif
       dev->rwb.dev           = (FAR void *)dev;
       dev->rwb.wrflush       = ftl_flush;
       dev->rwb.rhreload      = ftl_reload;
@@ -640,6 +690,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_MAP
+          ftl_map_uninitialize(dev->map);
+#endif
           kmm_free(dev);
           return ret;
         }
@@ -653,6 +706,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_MAP
+          ftl_map_uninitialize(dev->map);
 #endif
           kmm_free(dev);
         }
@@ -0,0 +1,1371 @@
+/****************************************************************************
+ * drivers/mtd/ftl_map.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A log-structured, page-mapped translation layer.  Sectors are written
+ * out of place to the next free page of the open erase block, and a RAM
+ * map translates the logical sectors to pages.  Nothing is ever read back
+ * and rewritten to update a sector in place.
+ *
+ * Layout of the MTD blocks ("pages"):
+ *
+ *   - The first 2 x ckblocks erase blocks hold two checkpoints of the map,
+ *     written alternately.
+ *   - The first page of each data erase block is a header with the
+ *     sequence number of the block in the log and its erase count.
+ *   - Runs of data pages are followed by a summary page, which lists the
+ *     logical sectors of the run.  Pages are persistent once summarized.
+ *
+ * On mount, the latest valid checkpoint is loaded and the summaries of
+ * the blocks opened after it are replayed in order.  Garbage collection
+ * copies the live pages of the erase block with the fewest of them to the
+ * log and erases it.  Free blocks are allocated by erase count (dynamic
+ * wear leveling), and blocks of cold data are recycled once their erase
+ * count falls far behind (static wear leveling).
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+
+#include "ftl_map.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FTL_MAP_HDRMAGIC    0x4d4c5446  /* "FTLM" */
+#define FTL_MAP_SUMMAGIC    0x534c5446  /* "FTLS" */
+#define FTL_MAP_CKPMAGIC    0x434c5446  /* "FTLC" */
+
+#define FTL_MAP_NONE        UINT32_MAX
+
+/* Block states */
+
+#define FTL_MAP_FREE        0           /* Erased */
+#define FTL_MAP_USED        1           /* Holds a log */
+
+/* Free blocks kept for garbage collection, which needs one to copy to */
+
+#define FTL_MAP_GCRESERVE   1
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The first page of a data erase block */
+
+struct ftl_map_hdr_s
+{
+  uint32_t magic;
+  uint32_t seq;                 /* Order of the block in the log */
+  uint32_t erasecnt;            /* Erase count of the block */
+  uint32_t crc;                 /* CRC32 of the above */
+};
+
+/* A summary page, followed by the sectors of pages first .. first +
+ * count - 1 of the block.
+ */
+
+struct ftl_map_sum_s
+{
+  uint32_t magic;
+  uint32_t seq;                 /* Sequence number of the block */
+  uint16_t first;               /* First page of the run */
+  uint16_t count;               /* Pages of the run */
+  uint32_t crc;                 /* CRC32 of the summary with crc = 0 */
+};
+
+/* A checkpoint, followed by map[nlsn] and erasecnt[nblocks] */
+
+struct ftl_map_ckpt_s
+{
+  uint32_t magic;
+  uint32_t gen;                 /* Generation of the checkpoint */
+  uint32_t seq;                 /* Last sequence number allocated */
+  uint32_t nlsn;                /* Logical sectors */
+  uint32_t nblocks;             /* Erase blocks */
+  uint32_t openblk;             /* The open erase block or FTL_MAP_NONE */
+  uint32_t openpos;             /* Its next page */
+  uint32_t crc;                 /* CRC32 of the checkpoint with crc = 0 */
+};
+
+struct ftl_map_s
+{
+  FAR struct mtd_dev_s *mtd;    /* Contained MTD interface */
+  mutex_t   lock;               /* Exclusive access */
+  uint32_t  pagesize;           /* Size of one MTD block */
+  uint16_t  npages;             /* MTD blocks per erase block */
+  uint16_t  sumper;             /* Sectors per summary page */
+  uint16_t  dataper;            /* Data pages per erase block, at most */
+  uint8_t   erasestate;         /* The erased value */
+  uint8_t   ckslot;             /* The checkpoint to write next */
+  uint32_t  nblocks;            /* Erase blocks */
+  uint32_t  ckblocks;           /* Erase blocks per checkpoint */
+  uint32_t  nlsn;               /* Logical sectors */
+  uint32_t  nfree;              /* Free erase blocks */
+  uint32_t  seq;                /* Last sequence number allocated */
+  uint32_t  ckgen;              /* Generation of the last checkpoint */
+  uint32_t  sinceck;            /* Blocks opened since the checkpoint */
+  uint32_t  openblk;            /* The open erase block or FTL_MAP_NONE */
+  uint32_t  openseq;            /* Its sequence number */
+  uint16_t  openpos;            /* Its next page */
+  uint16_t  sumcount;           /* Pages of the pending run */
+  FAR uint32_t *map;            /* Logical sector to page */
+  FAR uint32_t *erasecnt;       /* Erase count per erase block */
+  FAR uint16_t *valid;          /* Live pages per erase block */
+  FAR uint8_t  *state;          /* State per erase block */
+  FAR uint8_t  *page;           /* Page buffer for scanning */
+  FAR uint8_t  *copy;           /* Page buffer for copying */
+  FAR uint8_t  *sumbuf;         /* The pending summary */
+#ifdef CONFIG_FTL_MAP_BACKGROUND_GC
+  struct work_s work;           /* Background garbage collection */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ftl_map_append(FAR struct ftl_map_s *map, uint32_t lsn,
+                          FAR const uint8_t *buffer, bool gc);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_map_erased
+ ****************************************************************************/
+
+static bool ftl_map_erased(FAR struct ftl_map_s *map,
+                           FAR const uint8_t *buffer)
+{
+  uint32_t i;
+
+  for (i = 0; i < map->pagesize; i++)
+    {
+      if (buffer[i] != map->erasestate)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ftl_map_readpage and ftl_map_writepage
+ ****************************************************************************/
+
+static int ftl_map_readpage(FAR struct ftl_map_s *map, off_t page,
+                            FAR uint8_t *buffer)
+{
+  ssize_t nread;
+
+  nread = MTD_BREAD(map->mtd, page, 1, buffer);
+  if (nread != 1)
+    {
+      ferr("ERROR: Read page %" PRIdOFF " failed: %zd\n", page, nread);
+      return nread < 0 ? (int)nread : -EIO;
+    }
+
+  return OK;
+}
+
+static int ftl_map_writepage(FAR struct ftl_map_s *map, off_t page,
+                             FAR const uint8_t *buffer)
+{
+  ssize_t nwritten;
+
+  nwritten = MTD_BWRITE(map->mtd, page, 1, buffer);
+  if (nwritten != 1)
+    {
+      ferr("ERROR: Write page %" PRIdOFF " failed: %zd\n", page, nwritten);
+      return nwritten < 0 ? (int)nwritten : -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_sumcrc
+ *
+ * Description:
+ *   Return the CRC of the summary at the beginning of buffer.
+ *
+ ****************************************************************************/
+
+static uint32_t ftl_map_sumcrc(FAR uint8_t *buffer)
+{
+  FAR struct ftl_map_sum_s *sum = (FAR struct ftl_map_sum_s *)buffer;
+  uint32_t saved = sum->crc;
+  uint32_t crc;
+
+  sum->crc = 0;
+  crc      = crc32(buffer, sizeof(*sum) + sum->count * sizeof(uint32_t));
+  sum->crc = saved;
+  return crc;
+}
+
+/****************************************************************************
+ * Name: ftl_map_issummary
+ ****************************************************************************/
+
+static bool ftl_map_issummary(FAR struct ftl_map_s *map,
+                              FAR uint8_t *buffer, uint32_t seq,
+                              uint16_t pos)
+{
+  FAR struct ftl_map_sum_s *sum = (FAR struct ftl_map_sum_s *)buffer;
+
+  return sum->magic == FTL_MAP_SUMMAGIC && sum->seq == seq &&
+         sum->first >= 1 && sum->count <= map->sumper &&
+         sum->first + sum->count == pos &&
+         sum->crc == ftl_map_sumcrc(buffer);
+}
+
+/****************************************************************************
+ * Name: ftl_map_readhdr
+ *
+ * Description:
+ *   Read the header of an erase block.  Return 1 if the block is erased,
+ *   0 if the header is valid and -EINVAL if it is neither.
+ *
+ ****************************************************************************/
+
+static int ftl_map_readhdr(FAR struct ftl_map_s *map, uint32_t block,
+                           FAR struct ftl_map_hdr_s *hdr)
+{
+  int ret;
+
+  ret = ftl_map_readpage(map, (off_t)block * map->npages, map->page);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ftl_map_erased(map, map->page))
+    {
+      return 1;
+    }
+
+  memcpy(hdr, map->page, sizeof(*hdr));
+  if (hdr->magic != FTL_MAP_HDRMAGIC ||
+      hdr->crc != crc32((FAR const uint8_t *)hdr,
+                        offsetof(struct ftl_map_hdr_s, crc)))
+    {
+      return -EINVAL;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ftl_map_erase
+ ****************************************************************************/
+
+static int ftl_map_erase(FAR struct ftl_map_s *map, uint32_t block)
+{
+  int ret;
+
+  ret = MTD_ERASE(map->mtd, block, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block %" PRIu32 " failed: %d\n", block, ret);
+      return ret;
+    }
+
+  map->erasecnt[block]++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_ckptio
+ *
+ * Description:
+ *   Write or read a checkpoint: The header, the map and the erase counts,
+ *   streamed through the page buffer.
+ *
+ ****************************************************************************/
+
+static int ftl_map_ckptio(FAR struct ftl_map_s *map, uint32_t slot,
+                          FAR struct ftl_map_ckpt_s *ckpt, bool write)
+{
+  FAR uint8_t *seg[3];
+  size_t len[3];
+  off_t page;
+  size_t off = 0;
+  size_t n;
+  int ret;
+  int i;
+
+  seg[0] = (FAR uint8_t *)ckpt;
+  len[0] = sizeof(*ckpt);
+  seg[1] = (FAR uint8_t *)map->map;
+  len[1] = map->nlsn * sizeof(uint32_t);
+  seg[2] = (FAR uint8_t *)map->erasecnt;
+  len[2] = map->nblocks * sizeof(uint32_t);
+
+  page = (off_t)slot * map->ckblocks * map->npages;
+
+  for (i = 0; i < 3; i++)
+    {
+      while (len[i] > 0)
+        {
+          if (off == 0 && !write)
+            {
+              ret = ftl_map_readpage(map, page, map->page);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          n = map->pagesize - off;
+          if (n > len[i])
+            {
+              n = len[i];
+            }
+
+          if (write)
+            {
+              memcpy(map->page + off, seg[i], n);
+            }
+          else
+            {
+              memcpy(seg[i], map->page + off, n);
+            }
+
+          seg[i] += n;
+          len[i] -= n;
+          off    += n;
+
+          if (off == map->pagesize)
+            {
+              if (write)
+                {
+                  ret = ftl_map_writepage(map, page, map->page);
+                  if (ret < 0)
+                    {
+                      return ret;
+                    }
+                }
+
+              page++;
+              off = 0;
+            }
+        }
+    }
+
+  if (write && off > 0)
+    {
+      memset(map->page + off, map->erasestate, map->pagesize - off);
+      return ftl_map_writepage(map, page, map->page);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_ckptcrc
+ ****************************************************************************/
+
+static uint32_t ftl_map_ckptcrc(FAR struct ftl_map_s *map,
+                                FAR struct ftl_map_ckpt_s *ckpt)
+{
+  uint32_t saved = ckpt->crc;
+  uint32_t crc;
+
+  ckpt->crc = 0;
+  crc = crc32part((FAR const uint8_t *)ckpt, sizeof(*ckpt), 0);
+  crc = crc32part((FAR const uint8_t *)map->map,
+                  map->nlsn * sizeof(uint32_t), crc);
+  crc = crc32part((FAR const uint8_t *)map->erasecnt,
+                  map->nblocks * sizeof(uint32_t), crc);
+  ckpt->crc = saved;
+  return crc;
+}
+
+/****************************************************************************
+ * Name: ftl_map_sync_locked
+ *
+ * Description:
+ *   Write the summary of the pending run of pages, which makes them
+ *   persistent.
+ *
+ ****************************************************************************/
+
+static int ftl_map_sync_locked(FAR struct ftl_map_s *map)
+{
+  FAR struct ftl_map_sum_s *sum = (FAR struct ftl_map_sum_s *)map->sumbuf;
+  size_t used;
+  int ret;
+
+  if (map->sumcount == 0)
+    {
+      return OK;
+    }
+
+  DEBUGASSERT(map->openblk != FTL_MAP_NONE &&
+              map->openpos < map->npages);
+
+  sum->magic = FTL_MAP_SUMMAGIC;
+  sum->seq   = map->openseq;
+  sum->first = map->openpos - map->sumcount;
+  sum->count = map->sumcount;
+  sum->crc   = 0;
+
+  used = sizeof(*sum) + sum->count * sizeof(uint32_t);
+  memset(map->sumbuf + used, map->erasestate, map->pagesize - used);
+  sum->crc = ftl_map_sumcrc(map->sumbuf);
+
+  ret = ftl_map_writepage(map, (off_t)map->openblk * map->npages +
+                               map->openpos, map->sumbuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  map->sumcount = 0;
+  if (++map->openpos >= map->npages - 1)
+    {
+      /* No room left for a page and its summary */
+
+      map->openblk = FTL_MAP_NONE;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_checkpoint
+ ****************************************************************************/
+
+static int ftl_map_checkpoint(FAR struct ftl_map_s *map)
+{
+  struct ftl_map_ckpt_s ckpt;
+  uint32_t first;
+  uint32_t i;
+  int ret;
+
+  ret = ftl_map_sync_locked(map);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  first = map->ckslot * map->ckblocks;
+  for (i = 0; i < map->ckblocks; i++)
+    {
+      ret = ftl_map_erase(map, first + i);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ckpt.magic   = FTL_MAP_CKPMAGIC;
+  ckpt.gen     = map->ckgen + 1;
+  ckpt.seq     = map->seq;
+  ckpt.nlsn    = map->nlsn;
+  ckpt.nblocks = map->nblocks;
+  ckpt.openblk = map->openblk;
+  ckpt.openpos = map->openpos;
+  ckpt.crc     = ftl_map_ckptcrc(map, &ckpt);
+
+  ret = ftl_map_ckptio(map, map->ckslot, &ckpt, true);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("Checkpoint %" PRIu32 " in slot %u\n", ckpt.gen, map->ckslot);
+
+  map->ckgen   = ckpt.gen;
+  map->ckslot ^= 1;
+  map->sinceck = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_victim
+ *
+ * Description:
+ *   Select the erase block to collect: The one with the fewest live pages
+ *   or, for wear leveling, the one with the lowest erase count.
+ *
+ ****************************************************************************/
+
+static uint32_t ftl_map_victim(FAR struct ftl_map_s *map, bool wear)
+{
+  uint32_t victim = FTL_MAP_NONE;
+  uint32_t block;
+
+  for (block = 2 * map->ckblocks; block < map->nblocks; block++)
+    {
+      if (map->state[block] != FTL_MAP_USED || block == map->openblk)
+        {
+          continue;
+        }
+
+      if (victim == FTL_MAP_NONE ||
+          (wear ? map->erasecnt[block] < map->erasecnt[victim] :
+                  map->valid[block] < map->valid[victim]))
+        {
+          victim = block;
+        }
+    }
+
+  /* Collecting a block without garbage frees nothing */
+
+  if (!wear && victim != FTL_MAP_NONE &&
+      map->valid[victim] >= map->dataper)
+    {
+      victim = FTL_MAP_NONE;
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: ftl_map_collect
+ *
+ * Description:
+ *   Copy the live pages of an erase block to the log and erase it.
+ *
+ ****************************************************************************/
+
+static int ftl_map_collect(FAR struct ftl_map_s *map, uint32_t victim)
+{
+  FAR struct ftl_map_sum_s *sum = (FAR struct ftl_map_sum_s *)map->page;
+  FAR uint32_t *lsn;
+  struct ftl_map_hdr_s hdr;
+  off_t base = (off_t)victim * map->npages;
+  uint16_t pos;
+  uint16_t i;
+  int ret;
+
+  finfo("Collect block %" PRIu32 " with %u live pages\n",
+        victim, map->valid[victim]);
+
+  ret = ftl_map_readhdr(map, victim, &hdr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (pos = 1; pos < map->npages && map->valid[victim] > 0; pos++)
+    {
+      ret = ftl_map_readpage(map, base + pos, map->page);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (ftl_map_erased(map, map->page))
+        {
+          break;
+        }
+
+      if (!ftl_map_issummary(map, map->page, hdr.seq, pos))
+        {
+          continue;
+        }
+
+      lsn = (FAR uint32_t *)(map->page + sizeof(*sum));
+      for (i = 0; i < sum->count; i++)
+        {
+          if (lsn[i] >= map->nlsn ||
+              map->map[lsn[i]] != base + sum->first + i)
+            {
+              continue;
+            }
+
+          ret = ftl_map_readpage(map, base + sum->first + i, map->copy);
+          if (ret >= 0)
+            {
+              ret = ftl_map_append(map, lsn[i], map->copy, true);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  DEBUGASSERT(map->valid[victim] == 0);
+
+  /* The copies must be persistent before the originals are erased */
+
+  ret = ftl_map_sync_locked(map);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = ftl_map_erase(map, victim);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  map->state[victim] = FTL_MAP_FREE;
+  map->valid[victim] = 0;
+  map->nfree++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_wearlevel
+ *
+ * Description:
+ *   Recycle the block of the coldest data once its erase count falls
+ *   CONFIG_FTL_MAP_WEAR_DELTA behind the most worn block.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FTL_MAP_WEAR_DELTA > 0
+static void ftl_map_wearlevel(FAR struct ftl_map_s *map)
+{
+  uint32_t maxcnt = 0;
+  uint32_t victim;
+  uint32_t block;
+
+  victim = ftl_map_victim(map, true);
+  if (victim == FTL_MAP_NONE)
+    {
+      return;
+    }
+
+  for (block = 2 * map->ckblocks; block < map->nblocks; block++)
+    {
+      if (map->erasecnt[block] > maxcnt)
+        {
+          maxcnt = map->erasecnt[block];
+        }
+    }
+
+  if (maxcnt - map->erasecnt[victim] > CONFIG_FTL_MAP_WEAR_DELTA &&
+      map->nfree > FTL_MAP_GCRESERVE)
+    {
+      ftl_map_collect(map, victim);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_map_open
+ *
+ * Description:
+ *   Open the free erase block with the lowest erase count for the log.
+ *
+ ****************************************************************************/
+
+static int ftl_map_open(FAR struct ftl_map_s *map, bool gc)
+{
+  FAR struct ftl_map_hdr_s *hdr = (FAR struct ftl_map_hdr_s *)map->sumbuf;
+  uint32_t victim;
+  uint32_t block;
+  uint32_t best = FTL_MAP_NONE;
+  int ret;
+
+  /* Outside of the garbage collection, keep the reserve for it */
+
+  while (!gc && map->nfree <= FTL_MAP_GCRESERVE)
+    {
+      victim = ftl_map_victim(map, false);
+      if (victim == FTL_MAP_NONE)
+        {
+          return -ENOSPC;
+        }
+
+      ret = ftl_map_collect(map, victim);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+#if CONFIG_FTL_MAP_WEAR_DELTA > 0
+  if (!gc)
+    {
+      ftl_map_wearlevel(map);
+    }
+#endif
+
+  /* A collection may have left a block open */
+
+  if (map->openblk != FTL_MAP_NONE)
+    {
+      return OK;
+    }
+
+  for (block = 2 * map->ckblocks; block < map->nblocks; block++)
+    {
+      if (map->state[block] == FTL_MAP_FREE &&
+          (best == FTL_MAP_NONE ||
+           map->erasecnt[block] < map->erasecnt[best]))
+        {
+          best = block;
+        }
+    }
+
+  if (best == FTL_MAP_NONE)
+    {
+      return -ENOSPC;
+    }
+
+  hdr->magic    = FTL_MAP_HDRMAGIC;
+  hdr->seq      = map->seq + 1;
+  hdr->erasecnt = map->erasecnt[best];
+  hdr->crc      = crc32(map->sumbuf, offsetof(struct ftl_map_hdr_s, crc));
+  memset(map->sumbuf + sizeof(*hdr), map->erasestate,
+         map->pagesize - sizeof(*hdr));
+
+  /* The garbage collection may be using the other page buffers, but no
+   * run is pending in a closed block.
+   */
+
+  DEBUGASSERT(map->sumcount == 0);
+  ret = ftl_map_writepage(map, (off_t)best * map->npages, map->sumbuf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  map->seq++;
+  map->state[best] = FTL_MAP_USED;
+  map->valid[best] = 0;
+  map->nfree--;
+  map->openblk     = best;
+  map->openseq     = map->seq;
+  map->openpos     = 1;
+  map->sumcount    = 0;
+
+  /* Bound the log to replay on mount */
+
+  if (!gc && ++map->sinceck >= CONFIG_FTL_MAP_CKPT_INTERVAL)
+    {
+      ret = ftl_map_checkpoint(map);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_map_append
+ *
+ * Description:
+ *   Write a sector to the next page of the log.
+ *
+ ****************************************************************************/
+
+static int ftl_map_append(FAR struct ftl_map_s *map, uint32_t lsn,
+                          FAR const uint8_t *buffer, bool gc)
+{
+  FAR uint32_t *sumlsn;
+  uint32_t page;
+  uint32_t old;
+  int ret;
+
+  /* A full run must be summarized first */
+
+  if (map->openblk != FTL_MAP_NONE && map->sumcount >= map->sumper)
+    {
+      ret = ftl_map_sync_locked(map);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* The page and its summary must fit in the open block */
+
+  if (map->openblk != FTL_MAP_NONE &&
+      map->openpos + 1 >= map->npages)
+    {
+      ret = ftl_map_sync_locked(map);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      map->openblk = FTL_MAP_NONE;
+    }
+
+  if (map->openblk == FTL_MAP_NONE)
+    {
+      ret = ftl_map_open(map, gc);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  page = map->openblk * map->npages + map->openpos;
+  ret  = ftl_map_writepage(map, page, buffer);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  old = map->map[lsn];
+  if (old != FTL_MAP_NONE)
+    {
+      map->valid[old / map->npages]--;
+    }
+
+  map->map[lsn] = page;
+  map->valid[map->openblk]++;
+
+  sumlsn = (FAR uint32_t *)(map->sumbuf + sizeof(struct ftl_map_sum_s));
+  sumlsn[map->sumcount++] = lsn;
+  map->openpos++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_replay
+ *
+ * Description:
+ *   Apply the summaries of an erase block from page pos on.
+ *
+ ****************************************************************************/
+
+static int ftl_map_replay(FAR struct ftl_map_s *map, uint32_t block,
+                          uint32_t seq, uint16_t pos)
+{
+  FAR struct ftl_map_sum_s *sum = (FAR struct ftl_map_sum_s *)map->page;
+  FAR uint32_t *lsn;
+  off_t base = (off_t)block * map->npages;
+  uint16_t i;
+  int ret;
+
+  finfo("Replay block %" PRIu32 " seq %" PRIu32 " from page %u\n",
+        block, seq, pos);
+
+  for (; pos < map->npages; pos++)
+    {
+      ret = ftl_map_readpage(map, base + pos, map->page);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (ftl_map_erased(map, map->page))
+        {
+          break;
+        }
+
+      if (!ftl_map_issummary(map, map->page, seq, pos))
+        {
+          continue;
+        }
+
+      lsn = (FAR uint32_t *)(map->page + sizeof(*sum));
+      for (i = 0; i < sum->count; i++)
+        {
+          if (lsn[i] < map->nlsn)
+            {
+              map->map[lsn[i]] = base + sum->first + i;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_map_mount
+ ****************************************************************************/
+
+static int ftl_map_mount(FAR struct ftl_map_s *map)
+{
+  struct ftl_map_ckpt_s ckpt[2];
+  struct ftl_map_hdr_s hdr;
+  FAR uint32_t *seqs;
+  uint32_t ckopen = FTL_MAP_NONE;
+  uint32_t ckseq = 0;
+  uint32_t ckpos = 0;
+  uint32_t last;
+  uint32_t next;
+  uint32_t block;
+  uint32_t i;
+  int slot = -1;
+  int ret;
+
+  /* Find the latest valid checkpoint */
+
+  for (i = 0; i < 2; i++)
+    {
+      ret = ftl_map_readpage(map, (off_t)i * map->ckblocks * map->npages,
+                             map->page);
+      memcpy(&ckpt[i], map->page, sizeof(ckpt[i]));
+      if (ret < 0 || ckpt[i].magic != FTL_MAP_CKPMAGIC ||
+          ckpt[i].nlsn != map->nlsn || ckpt[i].nblocks != map->nblocks)
+        {
+          ckpt[i].magic = 0;
+        }
+    }
+
+  while (slot < 0 && (ckpt[0].magic != 0 || ckpt[1].magic != 0))
+    {
+      i = ckpt[1].magic != 0 &&
+          (ckpt[0].magic == 0 || (int32_t)(ckpt[1].gen - ckpt[0].gen) > 0);
+
+      if (ftl_map_ckptio(map, i, &ckpt[i], false) >= 0 &&
+          ckpt[i].crc == ftl_map_ckptcrc(map, &ckpt[i]))
+        {
+          slot = i;
+        }
+      else
+        {
+          ckpt[i].magic = 0;
+        }
+    }
+
+  if (slot >= 0)
+    {
+      ckseq      = ckpt[slot].seq;
+      ckopen     = ckpt[slot].openblk;
+      ckpos      = ckpt[slot].openpos;
+      map->ckgen = ckpt[slot].gen;
+      map->ckslot = slot ^ 1;
+    }
+  else
+    {
+      /* No checkpoint: Replay the whole log */
+
+      memset(map->map, 0xff, map->nlsn * sizeof(uint32_t));
+      memset(map->erasecnt, 0, map->nblocks * sizeof(uint32_t));
+    }
+
+  /* Read the headers of the data blocks */
+
+  seqs = kmm_malloc(map->nblocks * sizeof(uint32_t));
+  if (seqs == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  map->seq   = ckseq;
+  map->nfree = 0;
+
+  for (block = 2 * map->ckblocks; block < map->nblocks; block++)
+    {
+      seqs[block] = 0;
+      ret = ftl_map_readhdr(map, block, &hdr);
+      if (ret == 0)
+        {
+          map->state[block]    = FTL_MAP_USED;
+          map->erasecnt[block] = hdr.erasecnt;
+          seqs[block]          = hdr.seq;
+          if ((int32_t)(hdr.seq - map->seq) > 0)
+            {
+              map->seq = hdr.seq;
+            }
+
+          continue;
+        }
+
+      if (ret == -EINVAL)
+        {
+          /* Neither erased nor a log, e.g. an interrupted erase */
+
+          ret = ftl_map_erase(map, block);
+        }
+
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      map->state[block] = FTL_MAP_FREE;
+      map->nfree++;
+    }
+
+  /* Replay the rest of the block that was open at the checkpoint, if it
+   * was not recycled since, and then the blocks opened after it.
+   */
+
+  if (ckopen >= 2 * map->ckblocks && ckopen < map->nblocks &&
+      map->state[ckopen] == FTL_MAP_USED && seqs[ckopen] <= ckseq &&
+      ckpos < map->npages)
+    {
+      ret = ftl_map_replay(map, ckopen, seqs[ckopen], ckpos);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  for (last = ckseq; ; last = seqs[next])
+    {
+      next = FTL_MAP_NONE;
+      for (block = 2 * map->ckblocks; block < map->nblocks; block++)
+        {
+          if (map->state[block] == FTL_MAP_USED &&
+              (int32_t)(seqs[block] - last) > 0 &&
+              (next == FTL_MAP_NONE ||
+               (int32_t)(seqs[block] - seqs[next]) < 0))
+            {
+              next = block;
+            }
+        }
+
+      if (next == FTL_MAP_NONE)
+        {
+          break;
+        }
+
+      ret = ftl_map_replay(map, next, seqs[next], 1);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      map->sinceck++;
+    }
+
+  /* Count the live pages, dropping those of the recycled blocks */
+
+  memset(map->valid, 0, map->nblocks * sizeof(uint16_t));
+  for (i = 0; i < map->nlsn; i++)
+    {
+      block = map->map[i] / map->npages;
+      if (map->map[i] == FTL_MAP_NONE)
+        {
+          continue;
+        }
+
+      if (block < 2 * map->ckblocks || block >= map->nblocks ||
+          map->state[block] != FTL_MAP_USED)
+        {
+          map->map[i] = FTL_MAP_NONE;
+          continue;
+        }
+
+      map->valid[block]++;
+    }
+
+  map->openblk = FTL_MAP_NONE;
+  finfo("%" PRIu32 " sectors, %" PRIu32 " free blocks, seq %" PRIu32 "\n",
+        map->nlsn, map->nfree, map->seq);
+  ret = OK;
+
+errout:
+  kmm_free(seqs);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_map_gcworker
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_MAP_BACKGROUND_GC
+static void ftl_map_gcworker(FAR void *arg)
+{
+  FAR struct ftl_map_s *map = arg;
+  uint32_t victim;
+
+  if (nxmutex_lock(&map->lock) < 0)
+    {
+      return;
+    }
+
+  while (map->nfree < CONFIG_FTL_MAP_GC_FREE)
+    {
+      victim = ftl_map_victim(map, false);
+      if (victim == FTL_MAP_NONE || ftl_map_collect(map, victim) < 0)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&map->lock);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_map_initialize
+ ****************************************************************************/
+
+FAR struct ftl_map_s *
+ftl_map_initialize(FAR struct mtd_dev_s *mtd,
+                   FAR const struct mtd_geometry_s *geo)
+{
+  FAR struct ftl_map_s *map;
+  uint32_t ndata;
+  uint32_t spare;
+  uint64_t bytes;
+  int ret;
+
+  map = kmm_zalloc(sizeof(struct ftl_map_s));
+  if (map == NULL)
+    {
+      return NULL;
+    }
+
+  map->mtd      = mtd;
+  map->pagesize = geo->blocksize;
+  map->npages   = geo->erasesize / geo->blocksize;
+  map->nblocks  = geo->neraseblocks;
+  map->openblk  = FTL_MAP_NONE;
+
+  if (MTD_IOCTL(mtd, MTDIOC_ERASESTATE,
+                (unsigned long)((uintptr_t)&map->erasestate)) < 0)
+    {
+      map->erasestate = 0xff;
+    }
+
+  /* A summary holds up to sumper sectors, so it takes one page of every
+   * sumper + 1 for the data.
+   */
+
+  map->sumper = (map->pagesize - sizeof(struct ftl_map_sum_s)) /
+                sizeof(uint32_t);
+  if (map->sumper >= map->npages)
+    {
+      map->sumper = map->npages - 2;
+    }
+
+  if (map->npages < 4 || map->sumper == 0)
+    {
+      ferr("ERROR: Erase blocks of %u pages are too small\n", map->npages);
+      goto errout;
+    }
+
+  map->dataper = (uint32_t)(map->npages - 1) * map->sumper /
+                 (map->sumper + 1);
+
+  /* Size the checkpoints for the map that they must hold */
+
+  for (map->ckblocks = 1; ; map->ckblocks++)
+    {
+      if (map->nblocks < 2 * map->ckblocks + FTL_MAP_GCRESERVE + 2)
+        {
+          ferr("ERROR: %" PRIu32 " erase blocks are too few\n",
+               map->nblocks);
+          goto errout;
+        }
+
+      ndata = map->nblocks - 2 * map->ckblocks;
+      spare = ndata * CONFIG_FTL_MAP_OVERPROVISION / 100;
+      if (spare < FTL_MAP_GCRESERVE + 1)
+        {
+          spare = FTL_MAP_GCRESERVE + 1;
+        }
+
+      map->nlsn = (ndata - spare) * map->dataper;
+      bytes     = sizeof(struct ftl_map_ckpt_s) +
+                  ((uint64_t)map->nlsn + map->nblocks) * sizeof(uint32_t);
+      if (bytes <= (uint64_t)map->ckblocks * geo->erasesize)
+        {
+          break;
+        }
+    }
+
+  map->map      = kmm_malloc(map->nlsn * sizeof(uint32_t));
+  map->erasecnt = kmm_zalloc(map->nblocks * sizeof(uint32_t));
+  map->valid    = kmm_zalloc(map->nblocks * sizeof(uint16_t));
+  map->state    = kmm_zalloc(map->nblocks);
+  map->page     = kmm_malloc(map->pagesize);
+  map->copy     = kmm_malloc(map->pagesize);
+  map->sumbuf   = kmm_malloc(map->pagesize);
+
+  if (map->map == NULL || map->erasecnt == NULL || map->valid == NULL ||
+      map->state == NULL || map->page == NULL || map->copy == NULL ||
+      map->sumbuf == NULL)
+    {
+      ferr("ERROR: Failed to allocate the map\n");
+      goto errout;
+    }
+
+  nxmutex_init(&map->lock);
+
+  ret = ftl_map_mount(map);
+  if (ret < 0)
+    {
+      ferr("ERROR: Mount failed: %d\n", ret);
+      nxmutex_destroy(&map->lock);
+      goto errout;
+    }
+
+  return map;
+
+errout:
+  ftl_map_uninitialize(map);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ftl_map_uninitialize
+ ****************************************************************************/
+
+void ftl_map_uninitialize(FAR struct ftl_map_s *map)
+{
+#ifdef CONFIG_FTL_MAP_BACKGROUND_GC
+  work_cancel(LPWORK, &map->work);
+#endif
+
+  kmm_free(map->map);
+  kmm_free(map->erasecnt);
+  kmm_free(map->valid);
+  kmm_free(map->state);
+  kmm_free(map->page);
+  kmm_free(map->copy);
+  kmm_free(map->sumbuf);
+  kmm_free(map);
+}
+
+/****************************************************************************
+ * Name: ftl_map_nsectors
+ ****************************************************************************/
+
+off_t ftl_map_nsectors(FAR struct ftl_map_s *map)
+{
+  return map->nlsn;
+}
+
+/****************************************************************************
+ * Name: ftl_map_read
+ ****************************************************************************/
+
+ssize_t ftl_map_read(FAR struct ftl_map_s *map, FAR uint8_t *buffer,
+                     off_t startblock, size_t nblocks)
+{
+  size_t i;
+  int ret;
+
+  if (startblock < 0 || startblock + nblocks > map->nlsn)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&map->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nblocks; i++, buffer += map->pagesize)
+    {
+      if (map->map[startblock + i] == FTL_MAP_NONE)
+        {
+          /* Never written */
+
+          memset(buffer, map->erasestate, map->pagesize);
+          continue;
+        }
+
+      ret = ftl_map_readpage(map, map->map[startblock + i], buffer);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&map->lock);
+  return ret < 0 ? ret : nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_map_write
+ ****************************************************************************/
+
+ssize_t ftl_map_write(FAR struct ftl_map_s *map, FAR const uint8_t *buffer,
+                      off_t startblock, size_t nblocks)
+{
+  size_t i;
+  int ret;
+
+  if (startblock < 0 || startblock + nblocks > map->nlsn)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&map->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nblocks; i++, buffer += map->pagesize)
+    {
+      ret = ftl_map_append(map, startblock + i, buffer, false);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_FTL_MAP_BACKGROUND_GC
+  /* Collect ahead of the writes */
+
+  if (map->nfree < CONFIG_FTL_MAP_GC_FREE && work_available(&map->work))
+    {
+      work_queue(LPWORK, &map->work, ftl_map_gcworker, map, 0);
+    }
+#endif
+
+  nxmutex_unlock(&map->lock);
+  return ret < 0 ? ret : nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_map_sync
+ ****************************************************************************/
+
+int ftl_map_sync(FAR struct ftl_map_s *map)
+{
+  int ret;
+
+  ret = nxmutex_lock(&map->lock);
+  if (ret >= 0)
+    {
+      ret = ftl_map_sync_locked(map);
+      nxmutex_unlock(&map->lock);
+    }
+
+  return ret;
+}
@@ -0,0 +1,109 @@
+/****************************************************************************
+ * drivers/mtd/ftl_map.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_MTD_FTL_MAP_H
+#define __DRIVERS_MTD_FTL_MAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/mtd/mtd.h>
+
+#ifdef CONFIG_FTL_MAP
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct ftl_map_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_map_initialize
+ *
+ * Description:
+ *   Mount the page-mapped translation layer of an MTD device: Load the
+ *   latest checkpoint of the map and replay the log written after it.
+ *   Erase blocks that hold neither a valid log nor erased data are erased.
+ *
+ * Input Parameters:
+ *   mtd - The MTD device
+ *   geo - Its geometry
+ *
+ * Returned Value:
+ *   The translation layer on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct ftl_map_s *
+ftl_map_initialize(FAR struct mtd_dev_s *mtd,
+                   FAR const struct mtd_geometry_s *geo);
+
+/****************************************************************************
+ * Name: ftl_map_uninitialize
+ ****************************************************************************/
+
+void ftl_map_uninitialize(FAR struct ftl_map_s *map);
+
+/****************************************************************************
+ * Name: ftl_map_nsectors
+ *
+ * Description:
+ *   Return the number of logical sectors, smaller than the number of
+ *   blocks of the MTD device.
+ *
+ ****************************************************************************/
+
+off_t ftl_map_nsectors(FAR struct ftl_map_s *map);
+
+/****************************************************************************
+ * Name: ftl_map_read and ftl_map_write
+ *
+ * Description:
+ *   Read and write logical sectors.  Writes go to the log; they are
+ *   persistent once ftl_map_sync() returns.
+ *
+ ****************************************************************************/
+
+ssize_t ftl_map_read(FAR struct ftl_map_s *map, FAR uint8_t *buffer,
+                     off_t startblock, size_t nblocks);
+ssize_t ftl_map_write(FAR struct ftl_map_s *map, FAR const uint8_t *buffer,
+                      off_t startblock, size_t nblocks);
+
+/****************************************************************************
+ * Name: ftl_map_sync
+ *
+ * Description:
+ *   Write the summary of the pending log pages.
+ *
+ ****************************************************************************/
+
+int ftl_map_sync(FAR struct ftl_map_s *map);
+
+#endif /* CONFIG_FTL_MAP */
+#endif /* __DRIVERS_MTD_FTL_MAP_H */
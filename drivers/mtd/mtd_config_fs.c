@@ -41,6 +41,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mtd/configdata.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -81,10 +82,41 @@
 
 #define NVS_SPECIAL_ATE_ID              0xffffffff
 
+/* The ates of a batched update have the part NVS_ATE_PART_BATCH and are
+ * followed by a special ate with the part NVS_ATE_PART_COMMIT.  Neither
+ * value is an erased state.
+ */
+
+#define NVS_ATE_PART_BATCH              0x01
+#define NVS_ATE_PART_COMMIT             0x02
+
+/* The RAM index of the live entries is an open addressing hash table of
+ * the ids.  A free slot has the id 0, which no key hashes to, a removed
+ * one the special id.  The table is kept at most three quarters full.
+ */
+
+#define NVS_INDEX_MINSIZE               16
+#define NVS_INDEX_FREE                  0
+#define NVS_INDEX_REMOVED               NVS_SPECIAL_ATE_ID
+
+#ifdef CONFIG_MTD_CONFIG_NAMED
+#  define NVS_KEY_SIZE                  CONFIG_MTD_CONFIG_NAME_LEN
+#else
+#  define NVS_KEY_SIZE                  (sizeof(uint16_t) + sizeof(int))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* A slot of the RAM index */
+
+struct nvs_slot
+{
+  uint32_t              id;            /* Data id, free or removed */
+  uint32_t              addr;          /* Address of the ate */
+};
+
 /* Non-volatile Storage File system structure */
 
 struct nvs_fs
@@ -98,6 +130,15 @@ struct nvs_fs
   uint32_t              data_wra;      /* Next data write address */
   uint32_t              step_addr;     /* For traverse */
   mutex_t               nvs_lock;
+  FAR struct nvs_slot   *index;        /* Ates of the live entries */
+  uint32_t              index_size;    /* Number of slots, a power of 2 */
+  uint32_t              index_used;    /* Slots that are not free */
+  uint32_t              index_count;   /* Number of live entries */
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_BGERASE
+  struct work_s         erase_work;    /* Erases the gc'ed block */
+  uint32_t              erase_addr;    /* The gc'ed block */
+  bool                  erase_pending; /* It is not erased yet */
+#endif
 };
 
 /* Allocation Table Entry */
@@ -588,7 +629,8 @@ static int nvs_close_ate_valid(FAR struct nvs_fs *fs,
 
 static int nvs_flash_wrt_entry(FAR struct nvs_fs *fs, uint32_t id,
                                FAR const uint8_t *key, size_t key_size,
-                               FAR const void *data, size_t len)
+                               FAR const void *data, size_t len,
+                               uint8_t part)
 {
   int rc;
   struct nvs_ate entry;
@@ -598,6 +640,7 @@ static int nvs_flash_wrt_entry(FAR struct nvs_fs *fs, uint32_t id,
   entry.offset = fs->data_wra & ADDR_OFFS_MASK;
   entry.len = len;
   entry.key_len = key_size;
+  entry.part = part;
 
   nvs_ate_crc8_update(&entry);
 
@@ -716,6 +759,17 @@ static int nvs_prev_ate(FAR struct nvs_fs *fs, FAR uint32_t *addr,
       *addr -= (1 << ADDR_BLOCK_SHIFT);
     }
 
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_BGERASE
+  /* The gc'ed block only holds copies, as if it was erased already */
+
+  if (fs->erase_pending &&
+      ((*addr) & ADDR_BLOCK_MASK) == fs->erase_addr)
+    {
+      *addr = fs->ate_wra;
+      return 0;
+    }
+#endif
+
   rc = nvs_flash_ate_rd(fs, *addr, &close_ate);
   if (rc)
     {
@@ -765,6 +819,55 @@ static void nvs_block_advance(FAR struct nvs_fs *fs, FAR uint32_t *addr)
     }
 }
 
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_BGERASE
+/****************************************************************************
+ * Name: nvs_erase_flush
+ *
+ * Description:
+ *   Erase the last gc'ed block if that is still pending.
+ *
+ ****************************************************************************/
+
+static int nvs_erase_flush(FAR struct nvs_fs *fs)
+{
+  int rc;
+
+  if (!fs->erase_pending)
+    {
+      return 0;
+    }
+
+  rc = nvs_flash_erase_block(fs, fs->erase_addr);
+  if (rc == 0)
+    {
+      fs->erase_pending = false;
+    }
+
+  return rc;
+}
+
+/****************************************************************************
+ * Name: nvs_erase_worker
+ *
+ * Description:
+ *   Erase the gc'ed block in the background.  A power loss before that is
+ *   harmless:  The gc done ate in the write block makes the startup erase
+ *   it.
+ *
+ ****************************************************************************/
+
+static void nvs_erase_worker(FAR void *arg)
+{
+  FAR struct nvs_fs *fs = arg;
+
+  if (nxmutex_lock(&fs->nvs_lock) >= 0)
+    {
+      nvs_erase_flush(fs);
+      nxmutex_unlock(&fs->nvs_lock);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nvs_block_close
  *
@@ -779,6 +882,16 @@ static int nvs_block_close(FAR struct nvs_fs *fs)
   int rc;
   struct nvs_ate close_ate;
 
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_BGERASE
+  /* The next block is written to from now on */
+
+  rc = nvs_erase_flush(fs);
+  if (rc < 0)
+    {
+      return rc;
+    }
+#endif
+
   memset(&close_ate, fs->erasestate, sizeof(close_ate));
   close_ate.id = NVS_SPECIAL_ATE_ID;
   close_ate.len = 0;
@@ -836,6 +949,238 @@ static int nvs_expire_ate(FAR struct nvs_fs *fs, uint32_t addr)
                        &expired, sizeof(expired));
 }
 
+/****************************************************************************
+ * Name: nvs_index_reserve
+ *
+ * Description:
+ *   Make room in the index for count more entries.  If the table is too
+ *   full, it is rehashed into one that is at most half full.
+ *
+ ****************************************************************************/
+
+static int nvs_index_reserve(FAR struct nvs_fs *fs, size_t count)
+{
+  FAR struct nvs_slot *index;
+  uint32_t size;
+  uint32_t mask;
+  uint32_t i;
+  uint32_t j;
+
+  if ((fs->index_used + count) * 4 <= fs->index_size * 3)
+    {
+      return 0;
+    }
+
+  size = NVS_INDEX_MINSIZE;
+  while (size < (fs->index_count + count) * 2)
+    {
+      size *= 2;
+    }
+
+  index = kmm_zalloc(size * sizeof(struct nvs_slot));
+  if (index == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mask = size - 1;
+  for (i = 0; i < fs->index_size; i++)
+    {
+      if (fs->index[i].id == NVS_INDEX_FREE ||
+          fs->index[i].id == NVS_INDEX_REMOVED)
+        {
+          continue;
+        }
+
+      j = fs->index[i].id & mask;
+      while (index[j].id != NVS_INDEX_FREE)
+        {
+          j = (j + 1) & mask;
+        }
+
+      index[j] = fs->index[i];
+    }
+
+  kmm_free(fs->index);
+  fs->index      = index;
+  fs->index_size = size;
+  fs->index_used = fs->index_count;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nvs_index_add
+ *
+ * Description:
+ *   Add the ate of a new key to the index, for which room was reserved.
+ *
+ ****************************************************************************/
+
+static void nvs_index_add(FAR struct nvs_fs *fs, uint32_t id, uint32_t addr)
+{
+  uint32_t mask = fs->index_size - 1;
+  uint32_t i = id & mask;
+
+  DEBUGASSERT(fs->index_count < fs->index_size);
+
+  while (fs->index[i].id != NVS_INDEX_FREE &&
+         fs->index[i].id != NVS_INDEX_REMOVED)
+    {
+      i = (i + 1) & mask;
+    }
+
+  if (fs->index[i].id == NVS_INDEX_FREE)
+    {
+      fs->index_used++;
+    }
+
+  fs->index[i].id   = id;
+  fs->index[i].addr = addr;
+  fs->index_count++;
+}
+
+/****************************************************************************
+ * Name: nvs_index_slot
+ *
+ * Description:
+ *   Return the slot of the ate at addr, or NULL if it is not indexed.
+ *
+ ****************************************************************************/
+
+static FAR struct nvs_slot *nvs_index_slot(FAR struct nvs_fs *fs,
+                                           uint32_t id, uint32_t addr)
+{
+  uint32_t mask;
+  uint32_t i;
+
+  if (fs->index_size == 0)
+    {
+      return NULL;
+    }
+
+  mask = fs->index_size - 1;
+  for (i = id & mask; fs->index[i].id != NVS_INDEX_FREE;
+       i = (i + 1) & mask)
+    {
+      if (fs->index[i].id == id && fs->index[i].addr == addr)
+        {
+          return &fs->index[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nvs_index_move
+ *
+ * Description:
+ *   Update the index when the entry at addr was rewritten at new_addr.
+ *
+ ****************************************************************************/
+
+static void nvs_index_move(FAR struct nvs_fs *fs, uint32_t id,
+                           uint32_t addr, uint32_t new_addr)
+{
+  FAR struct nvs_slot *slot = nvs_index_slot(fs, id, addr);
+
+  if (slot != NULL)
+    {
+      slot->addr = new_addr;
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_remove
+ *
+ * Description:
+ *   Update the index when the entry at addr was expired.
+ *
+ ****************************************************************************/
+
+static void nvs_index_remove(FAR struct nvs_fs *fs, uint32_t id,
+                             uint32_t addr)
+{
+  FAR struct nvs_slot *slot = nvs_index_slot(fs, id, addr);
+
+  if (slot != NULL)
+    {
+      slot->id = NVS_INDEX_REMOVED;
+      fs->index_count--;
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_find
+ *
+ * Description:
+ *   Look up the live entry of a key.  The key is compared with key or, if
+ *   that is NULL, with the one stored in flash at key_addr.
+ *   Returns 0 and the ate and its address if found, -ENOENT if not found,
+ *   errcode if error.
+ *
+ ****************************************************************************/
+
+static int nvs_index_find(FAR struct nvs_fs *fs, uint32_t id,
+                          FAR const uint8_t *key, uint32_t key_addr,
+                          size_t key_size, FAR uint32_t *ate_addr,
+                          FAR struct nvs_ate *ate)
+{
+  uint32_t rd_addr;
+  uint32_t mask;
+  uint32_t i;
+  int rc;
+
+  if (fs->index_size == 0)
+    {
+      return -ENOENT;
+    }
+
+  mask = fs->index_size - 1;
+  for (i = id & mask; fs->index[i].id != NVS_INDEX_FREE;
+       i = (i + 1) & mask)
+    {
+      if (fs->index[i].id != id)
+        {
+          continue;
+        }
+
+      rc = nvs_flash_ate_rd(fs, fs->index[i].addr, ate);
+      if (rc)
+        {
+          return rc;
+        }
+
+      if (ate->key_len == key_size)
+        {
+          rd_addr = (fs->index[i].addr & ADDR_BLOCK_MASK) + ate->offset;
+          if (key != NULL)
+            {
+              rc = nvs_flash_block_cmp(fs, rd_addr, key, key_size);
+            }
+          else
+            {
+              rc = nvs_flash_direct_cmp(fs, rd_addr, key_addr, key_size);
+            }
+
+          if (rc < 0)
+            {
+              return rc;
+            }
+
+          if (rc == 0)
+            {
+              *ate_addr = fs->index[i].addr;
+              return 0;
+            }
+        }
+
+      fwarn("hash conflict\n");
+    }
+
+  return -ENOENT;
+}
+
 /****************************************************************************
  * Name: nvs_gc
  *
@@ -856,6 +1201,7 @@ static int nvs_gc(FAR struct nvs_fs *fs)
   uint32_t gc_prev_addr;
   uint32_t data_addr;
   uint32_t stop_addr;
+  uint32_t new_addr;
 
   finfo("gc: before gc, ate_wra %" PRIx32 "\n", fs->ate_wra);
 
@@ -928,8 +1274,12 @@ static int nvs_gc(FAR struct nvs_fs *fs)
 
           data_addr = gc_prev_addr & ADDR_BLOCK_MASK;
           data_addr += gc_ate.offset;
+          new_addr = fs->ate_wra;
+
+          /* The copy is committed, a batch or not */
 
           gc_ate.offset = fs->data_wra & ADDR_OFFS_MASK;
+          gc_ate.part = fs->erasestate;
           nvs_ate_crc8_update(&gc_ate);
 
           rc = nvs_flash_block_move(fs, data_addr,
@@ -944,6 +1294,8 @@ static int nvs_gc(FAR struct nvs_fs *fs)
             {
               return rc;
             }
+
+          nvs_index_move(fs, gc_ate.id, gc_prev_addr, new_addr);
         }
     }
   while (gc_prev_addr != stop_addr);
@@ -955,6 +1307,15 @@ gc_done:
       return rc;
     }
 
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_BGERASE
+  /* Erase the gc'ed block in the background, it is not written to before
+   * the next block close.
+   */
+
+  fs->erase_addr = sec_addr;
+  fs->erase_pending = true;
+  work_queue(LPWORK, &fs->erase_work, nvs_erase_worker, fs, 0);
+#else
   /* Erase the gc'ed block */
 
   rc = nvs_flash_erase_block(fs, sec_addr);
@@ -962,50 +1323,207 @@ gc_done:
     {
       return rc;
     }
+#endif
 
   return 0;
 }
 
 /****************************************************************************
- * Name: nvs_startup
+ * Name: nvs_batch_recover
+ *
+ * Description:
+ *   Expire the ates of a batched update that was interrupted before its
+ *   commit ate was written.  These are the newest ates.
+ *
  ****************************************************************************/
 
-static int nvs_startup(FAR struct nvs_fs *fs)
+static int nvs_batch_recover(FAR struct nvs_fs *fs)
 {
-  int rc;
-  struct nvs_ate last_ate;
-  size_t empty_len;
+  struct nvs_ate wlk_ate;
   uint32_t wlk_addr;
-  uint32_t second_addr;
-  uint32_t last_addr;
-  struct nvs_ate second_ate;
-
-  /* Initialize addr to 0 for the case fs->geo.neraseblocks == 0. This
-   * should never happen but both
-   * Coverity and GCC believe the contrary.
-   */
+  uint32_t rd_addr;
+  int rc;
 
-  uint32_t addr = 0;
-  uint16_t i;
-  uint16_t closed_blocks = 0;
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+      if (rc)
+        {
+          return rc;
+        }
 
-  fs->ate_wra = 0;
-  fs->data_wra = 0;
+      if (!nvs_ate_cmp_const(&wlk_ate, fs->erasestate) ||
+          !nvs_ate_valid(fs, &wlk_ate))
+        {
+          continue;
+        }
 
-  /* Check the number of blocks, it should be at least 2. */
+      if (wlk_ate.part != NVS_ATE_PART_BATCH)
+        {
+          break;
+        }
 
-  if (fs->geo.neraseblocks < 2)
-    {
-      ferr("Configuration error - block count\n");
-      return -EINVAL;
+      if (wlk_ate.expired == fs->erasestate)
+        {
+          fwarn("uncommitted ate at 0x%" PRIx32 "\n", rd_addr);
+          rc = nvs_expire_ate(fs, rd_addr);
+          if (rc < 0)
+            {
+              return rc;
+            }
+        }
     }
+  while (wlk_addr != fs->ate_wra);
 
-  /* Get the device geometry. (Casting to uintptr_t first eliminates
-   * complaints on some architectures where the sizeof long is different
-   * from the size of a pointer).
-   */
+  return 0;
+}
 
-  rc = MTD_IOCTL(fs->mtd, MTDIOC_GEOMETRY,
+/****************************************************************************
+ * Name: nvs_index_build
+ *
+ * Description:
+ *   Index the live entries, walking once through all ates from the newest
+ *   to the oldest.  An older live entry of an indexed key was left by a
+ *   power loss before it was expired, it is expired now.  So are the
+ *   entries without data, which are the deletions of a batched update,
+ *   once they have hidden the older entries of their keys.
+ *
+ ****************************************************************************/
+
+static int nvs_index_build(FAR struct nvs_fs *fs)
+{
+  struct nvs_ate wlk_ate;
+  struct nvs_ate ate;
+  uint32_t wlk_addr;
+  uint32_t rd_addr;
+  uint32_t addr;
+  uint32_t ndeleted = 0;
+  uint32_t i;
+  int rc;
+
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      rd_addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+      if (rc)
+        {
+          return rc;
+        }
+
+      if (!nvs_ate_valid(fs, &wlk_ate) ||
+          wlk_ate.id == NVS_SPECIAL_ATE_ID ||
+          wlk_ate.expired != fs->erasestate)
+        {
+          continue;
+        }
+
+      rc = nvs_index_find(fs, wlk_ate.id, NULL,
+                          (rd_addr & ADDR_BLOCK_MASK) + wlk_ate.offset,
+                          wlk_ate.key_len, &addr, &ate);
+      if (rc == 0)
+        {
+          finfo("old ate found at 0x%" PRIx32 "\n", rd_addr);
+          rc = nvs_expire_ate(fs, rd_addr);
+          if (rc < 0)
+            {
+              ferr("expire ate failed, addr %" PRIx32 "\n", rd_addr);
+              return rc;
+            }
+        }
+      else if (rc == -ENOENT)
+        {
+          rc = nvs_index_reserve(fs, 1);
+          if (rc < 0)
+            {
+              return rc;
+            }
+
+          nvs_index_add(fs, wlk_ate.id, rd_addr);
+          if (wlk_ate.len == 0)
+            {
+              ndeleted++;
+            }
+        }
+      else
+        {
+          return rc;
+        }
+    }
+  while (wlk_addr != fs->ate_wra);
+
+  for (i = 0; ndeleted > 0 && i < fs->index_size; i++)
+    {
+      if (fs->index[i].id == NVS_INDEX_FREE ||
+          fs->index[i].id == NVS_INDEX_REMOVED)
+        {
+          continue;
+        }
+
+      rc = nvs_flash_ate_rd(fs, fs->index[i].addr, &ate);
+      if (rc)
+        {
+          return rc;
+        }
+
+      if (ate.len == 0)
+        {
+          rc = nvs_expire_ate(fs, fs->index[i].addr);
+          if (rc < 0)
+            {
+              return rc;
+            }
+
+          fs->index[i].id = NVS_INDEX_REMOVED;
+          fs->index_count--;
+          ndeleted--;
+        }
+    }
+
+  finfo("%" PRIu32 " entries indexed\n", fs->index_count);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nvs_startup
+ ****************************************************************************/
+
+static int nvs_startup(FAR struct nvs_fs *fs)
+{
+  int rc;
+  struct nvs_ate last_ate;
+  size_t empty_len;
+
+  /* Initialize addr to 0 for the case fs->geo.neraseblocks == 0. This
+   * should never happen but both
+   * Coverity and GCC believe the contrary.
+   */
+
+  uint32_t addr = 0;
+  uint16_t i;
+  uint16_t closed_blocks = 0;
+
+  fs->ate_wra = 0;
+  fs->data_wra = 0;
+  fs->index_used = 0;
+  fs->index_count = 0;
+  if (fs->index != NULL)
+    {
+      memset(fs->index, 0, fs->index_size * sizeof(struct nvs_slot));
+    }
+
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_BGERASE
+  fs->erase_pending = false;
+#endif
+
+  /* Get the device geometry. (Casting to uintptr_t first eliminates
+   * complaints on some architectures where the sizeof long is different
+   * from the size of a pointer).
+   */
+
+  rc = MTD_IOCTL(fs->mtd, MTDIOC_GEOMETRY,
                  (unsigned long)((uintptr_t)&(fs->geo)));
   if (rc < 0)
     {
@@ -1021,6 +1539,14 @@ static int nvs_startup(FAR struct nvs_fs *fs)
       return rc;
     }
 
+  /* Check the number of blocks, it should be at least 2. */
+
+  if (fs->geo.neraseblocks < 2)
+    {
+      ferr("Configuration error - block count\n");
+      return -EINVAL;
+    }
+
   /* Step through the blocks to find a open block following
    * a closed block, this is where NVS can write.
    */
@@ -1171,30 +1697,35 @@ static int nvs_startup(FAR struct nvs_fs *fs)
           addr += sizeof(struct nvs_ate);
         }
 
-      if (gc_done_marker)
+      if (!gc_done_marker)
         {
-          /* Erase the next block */
+          fwarn("No GC Done marker found: restarting gc\n");
+          rc = nvs_flash_erase_block(fs, fs->ate_wra);
+          if (rc)
+            {
+              return rc;
+            }
 
-          fwarn("GC Done marker found\n");
-          addr = fs->ate_wra & ADDR_BLOCK_MASK;
-          nvs_block_advance(fs, &addr);
-          rc = nvs_flash_erase_block(fs, addr);
+          fs->ate_wra &= ADDR_BLOCK_MASK;
+          fs->ate_wra += (fs->geo.erasesize - 2 * sizeof(struct nvs_ate));
+          fs->data_wra = (fs->ate_wra & ADDR_BLOCK_MASK);
+          finfo("GC when data_wra=0x%" PRIx32 "\n", fs->data_wra);
+          rc = nvs_gc(fs);
           goto end;
         }
 
-      fwarn("No GC Done marker found: restarting gc\n");
-      rc = nvs_flash_erase_block(fs, fs->ate_wra);
+      /* Erase the next block.  If that was left to the background, entries
+       * may have been written after the gc done ate.
+       */
+
+      fwarn("GC Done marker found\n");
+      addr = fs->ate_wra & ADDR_BLOCK_MASK;
+      nvs_block_advance(fs, &addr);
+      rc = nvs_flash_erase_block(fs, addr);
       if (rc)
         {
           return rc;
         }
-
-      fs->ate_wra &= ADDR_BLOCK_MASK;
-      fs->ate_wra += (fs->geo.erasesize - 2 * sizeof(struct nvs_ate));
-      fs->data_wra = (fs->ate_wra & ADDR_BLOCK_MASK);
-      finfo("GC when data_wra=0x%" PRIx32 "\n", fs->data_wra);
-      rc = nvs_gc(fs);
-      goto end;
     }
 
   /* Possible data write after last ate write, update data_wra */
@@ -1238,85 +1769,22 @@ static int nvs_startup(FAR struct nvs_fs *fs)
             fs->data_wra);
     }
 
-  /* Check if there exists an old entry with the same id and key
-   * as the newest entry.
-   * If so, power loss occured before writing the old entry id as expired.
-   * We need to set old entry expired.
-   */
+  rc = 0;
 
-  wlk_addr = fs->ate_wra;
-  while (1)
-    {
-      last_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &last_ate);
-      if (rc)
-        {
-          return rc;
-        }
+end:
 
-      /* Skip last one */
+  /* Drop an interrupted batched update, then index the live entries */
 
-      if (wlk_addr == fs->ate_wra)
-        {
-          break;
-        }
+  if (!rc)
+    {
+      rc = nvs_batch_recover(fs);
+    }
 
-      if (nvs_ate_valid(fs, &last_ate)
-          && (last_ate.id != NVS_SPECIAL_ATE_ID))
-        {
-          finfo("ate found at 0x%" PRIx32 ", id %" PRIu32 ", "
-                "key_len %" PRIu16 ", offset %" PRIu16 "\n",
-                last_addr, last_ate.id, last_ate.key_len, last_ate.offset);
-          while (1)
-            {
-              second_addr = wlk_addr;
-              rc = nvs_prev_ate(fs, &wlk_addr, &second_ate);
-              if (rc)
-                {
-                  return rc;
-                }
-
-              if (nvs_ate_valid(fs, &second_ate)
-                  && second_ate.id == last_ate.id
-                  && second_ate.expired == fs->erasestate)
-                {
-                  finfo("same id at 0x%" PRIx32 ", key_len %" PRIu16 ", "
-                        "offset %" PRIu16 "\n",
-                        second_addr, second_ate.key_len, second_ate.offset);
-                  if ((second_ate.key_len == last_ate.key_len) &&
-                      !nvs_flash_direct_cmp(fs,
-                                            (last_addr & ADDR_BLOCK_MASK) +
-                                            last_ate.offset,
-                                            (second_addr & ADDR_BLOCK_MASK) +
-                                            second_ate.offset,
-                                            last_ate.key_len))
-                    {
-                      finfo("old ate found at 0x%" PRIx32 "\n", second_addr);
-                      rc = nvs_expire_ate(fs, second_addr);
-                      if (rc < 0)
-                        {
-                          ferr("expire ate failed, addr %" PRIx32 "\n",
-                               second_addr);
-                          return rc;
-                        }
-
-                      goto end;
-                    }
-                  else
-                    {
-                      fwarn("hash conflict\n");
-                    }
-                }
-
-              if (wlk_addr == fs->ate_wra)
-                {
-                  goto end;
-                }
-            }
-        }
+  if (!rc)
+    {
+      rc = nvs_index_build(fs);
     }
 
-end:
   /* If the block is empty, add a gc done ate to avoid having insufficient
    * space when doing gc.
    */
@@ -1337,6 +1805,30 @@ end:
   return rc;
 }
 
+/****************************************************************************
+ * Name: nvs_item_key
+ *
+ * Description:
+ *   Get the key of a config data item, buf is used to build it from the
+ *   id and instance.  Returns the size of the key.
+ *
+ ****************************************************************************/
+
+static size_t nvs_item_key(FAR const struct config_data_s *pdata,
+                           FAR uint8_t *buf, FAR const uint8_t **key)
+{
+#ifdef CONFIG_MTD_CONFIG_NAMED
+  UNUSED(buf);
+  *key = (FAR const uint8_t *)pdata->name;
+  return strlen(pdata->name) + 1;
+#else
+  memcpy(buf, &pdata->id, sizeof(pdata->id));
+  memcpy(buf + sizeof(pdata->id), &pdata->instance, sizeof(pdata->instance));
+  *key = buf;
+  return sizeof(pdata->id) + sizeof(pdata->instance);
+#endif
+}
+
 /****************************************************************************
  * Name: nvs_read_entry
  *
@@ -1350,7 +1842,6 @@ end:
  *   key_size - Size of key.
  *   data     - Pointer to data buffer.
  *   len      - Number of bytes to be read.
- *   ate_addr - The addr of found ate.
  *
  * Returned Value:
  *   Number of bytes read. On success, it will be equal to the number
@@ -1361,57 +1852,19 @@ end:
  ****************************************************************************/
 
 static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
-                size_t key_size, FAR void *data, size_t len,
-                FAR uint32_t *ate_addr)
+                              size_t key_size, FAR void *data, size_t len)
 {
   int rc;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
-  uint32_t hist_addr;
   struct nvs_ate wlk_ate;
   uint32_t hash_id;
 
   hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
-  wlk_addr = fs->ate_wra;
-  rd_addr = wlk_addr;
-
-  do
+  rc = nvs_index_find(fs, hash_id, key, 0, key_size, &rd_addr, &wlk_ate);
+  if (rc)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          ferr("Walk to previous ate failed, rc=%d\n", rc);
-          return rc;
-        }
-
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
-        {
-          if ((wlk_ate.key_len == key_size)
-              && (!nvs_flash_block_cmp(fs,
-              (rd_addr & ADDR_BLOCK_MASK) + wlk_ate.offset, key, key_size)))
-            {
-              /* It is old or deleted, return -ENOENT */
-
-              if (wlk_ate.expired != fs->erasestate)
-                {
-                  return -ENOENT;
-                }
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
-        }
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          return -ENOENT;
-        }
+      return rc;
     }
-  while (true);
 
   if (data)
     {
@@ -1426,11 +1879,6 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
         }
     }
 
-  if (ate_addr)
-    {
-      *ate_addr = hist_addr;
-    }
-
   return wlk_ate.len;
 }
 
@@ -1458,28 +1906,16 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
   size_t data_size;
   size_t key_size;
   struct nvs_ate wlk_ate;
-  uint32_t wlk_addr;
   uint32_t rd_addr;
   uint32_t hist_addr;
+  uint32_t new_addr;
   uint16_t required_space = 0;
   bool prev_found = false;
   uint32_t hash_id;
-  uint16_t block_to_write_befor_gc;
-
-#ifdef CONFIG_MTD_CONFIG_NAMED
   FAR const uint8_t *key;
-#else
-  uint8_t key[sizeof(pdata->id) + sizeof(pdata->instance)];
-#endif
+  uint8_t keybuf[NVS_KEY_SIZE];
 
-#ifdef CONFIG_MTD_CONFIG_NAMED
-  key = (FAR const uint8_t *)pdata->name;
-  key_size = strlen(pdata->name) + 1;
-#else
-  memcpy(key, &pdata->id, sizeof(pdata->id));
-  memcpy(key + sizeof(pdata->id), &pdata->instance, sizeof(pdata->instance));
-  key_size = sizeof(pdata->id) + sizeof(pdata->instance);
-#endif
+  key_size = nvs_item_key(pdata, keybuf, &key);
 
   /* Data now contains input data and input key, input key first. */
 
@@ -1501,40 +1937,16 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
   hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
 
-  /* Find latest entry with same id. */
-
-  wlk_addr = fs->ate_wra;
+  /* Find the live entry with the same key. */
 
-  while (1)
+  rc = nvs_index_find(fs, hash_id, key, 0, key_size, &hist_addr, &wlk_ate);
+  if (rc == 0)
     {
-      rd_addr = wlk_addr;
-      hist_addr = wlk_addr;
-      rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-      if (rc)
-        {
-          return rc;
-        }
-
-      if ((wlk_ate.id == hash_id) && (nvs_ate_valid(fs, &wlk_ate)))
-        {
-          if ((wlk_ate.key_len == key_size)
-              && !nvs_flash_block_cmp(fs,
-                                      (rd_addr & ADDR_BLOCK_MASK) +
-                                      wlk_ate.offset, key, key_size))
-            {
-              prev_found = true;
-              break;
-            }
-          else
-            {
-              fwarn("hash conflict\n");
-            }
-        }
-
-      if (wlk_addr == fs->ate_wra)
-        {
-          break;
-        }
+      prev_found = true;
+    }
+  else if (rc != -ENOENT)
+    {
+      return rc;
     }
 
   if (prev_found)
@@ -1543,40 +1955,27 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
 
       /* Previous entry found. */
 
-      rd_addr &= ADDR_BLOCK_MASK;
+      rd_addr = hist_addr & ADDR_BLOCK_MASK;
 
       if (pdata->len == 0)
         {
-          /* If prev ate is expired, it is deleted. */
-
-          if (wlk_ate.expired != fs->erasestate)
+          rc = nvs_expire_ate(fs, hist_addr);
+          if (rc < 0)
             {
-              /* Skip delete entry as it is already the
-               * last one.
-               */
-
-              return 0;
+              ferr("expire ate failed, addr %" PRIx32 "\n", hist_addr);
+              return rc;
             }
-          else
-            {
-              rc = nvs_expire_ate(fs, hist_addr);
-              if (rc < 0)
-                {
-                  ferr("expire ate failed, addr %" PRIx32 "\n", hist_addr);
-                  return rc;
-                }
 
-              /* Delete now requires no extra space, so skip write and gc. */
+          nvs_index_remove(fs, hash_id, hist_addr);
 
-              finfo("nvs_delete success\n");
-              return 0;
-            }
+          /* Delete now requires no extra space, so skip write and gc. */
+
+          finfo("nvs_delete success\n");
+          return 0;
         }
-      else if (pdata->len == wlk_ate.len &&
-               wlk_ate.expired == fs->erasestate)
+      else if (pdata->len == wlk_ate.len)
         {
-          /* Do not try to compare if lengths are not equal
-           * or prev one is deleted.
+          /* Do not try to compare if lengths are not equal.
            * Compare the data and if equal return 0.
            */
 
@@ -1597,14 +1996,19 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
         {
           return 0;
         }
+
+      rc = nvs_index_reserve(fs, 1);
+      if (rc < 0)
+        {
+          return rc;
+        }
     }
 
   /* Leave space for gc_done ate */
 
   required_space = data_size + sizeof(struct nvs_ate);
   gc_count = 0;
-  block_to_write_befor_gc = fs->ate_wra >> ADDR_BLOCK_SHIFT;
-  while (1)
+  while (fs->ate_wra < fs->data_wra + required_space)
     {
       if (gc_count == fs->geo.neraseblocks)
         {
@@ -1615,68 +2019,150 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
           return -ENOSPC;
         }
 
-      if (fs->ate_wra >= fs->data_wra + required_space)
+      rc = nvs_block_close(fs);
+      if (rc)
         {
-          /* Nvs is changed after gc, we will look for the old ate.
-           */
+          return rc;
+        }
 
-          if (prev_found && wlk_ate.expired == fs->erasestate)
-            {
-              finfo("prev entry exists, search for it\n");
-
-              /* If gc touched second latest ate, search for it again */
-
-              if (gc_count >= fs->geo.neraseblocks - 1 -
-                  (block_to_write_befor_gc + fs->geo.neraseblocks -
-                  (hist_addr >> ADDR_BLOCK_SHIFT))
-                  % fs->geo.neraseblocks)
-                {
-                  rc = nvs_read_entry(fs, key, key_size, NULL, 0,
-                                     &hist_addr);
-                  finfo("relocate for prev entry, %" PRIx32 ", "
-                        "rc %d\n",
-                        hist_addr, rc);
-                  if (rc < 0)
-                    {
-                      ferr("read prev entry failed\n");
-                      return rc;
-                    }
-                }
-            }
+      rc = nvs_gc(fs);
+      if (rc)
+        {
+          return rc;
+        }
 
-          finfo("Write entry, ate_wra=0x%" PRIx32 ", "
-                "data_wra=0x%" PRIx32 "\n",
-                fs->ate_wra, fs->data_wra);
-          rc = nvs_flash_wrt_entry(fs, hash_id, key, key_size,
-                                   pdata->configdata, pdata->len);
-          if (rc)
-            {
-              fwarn("Write entry failed\n");
-              return rc;
-            }
+      gc_count++;
+      finfo("Gc count=%d\n", gc_count);
+    }
 
-          finfo("Write entry success\n");
+  /* Gc may have moved the old entry, the index follows it */
 
-          /* Expiring the old ate if exists.
-           * After this operation, only the latest ate is valid.
-           * Expire the old one only if it is not deleted before(Or it is
-           * already expired)
-           */
+  if (prev_found && gc_count > 0)
+    {
+      rc = nvs_index_find(fs, hash_id, key, 0, key_size, &hist_addr,
+                          &wlk_ate);
+      finfo("relocate for prev entry, %" PRIx32 ", rc %d\n",
+            hist_addr, rc);
+      if (rc < 0)
+        {
+          ferr("read prev entry failed\n");
+          return rc;
+        }
+    }
 
-          if (prev_found && wlk_ate.expired == fs->erasestate)
-            {
-              rc = nvs_expire_ate(fs, hist_addr);
-              finfo("expir prev entry, %" PRIx32 ", rc %d\n",
-                    hist_addr, rc);
-              if (rc < 0)
-                {
-                  ferr("expire ate failed, addr %" PRIx32 "\n",
-                       hist_addr);
-                  return rc;
-                }
-            }
+  finfo("Write entry, ate_wra=0x%" PRIx32 ", data_wra=0x%" PRIx32 "\n",
+        fs->ate_wra, fs->data_wra);
+  new_addr = fs->ate_wra;
+  rc = nvs_flash_wrt_entry(fs, hash_id, key, key_size,
+                           pdata->configdata, pdata->len, fs->erasestate);
+  if (rc)
+    {
+      fwarn("Write entry failed\n");
+      return rc;
+    }
 
-          break;
+  finfo("Write entry success\n");
+
+  /* Expiring the old ate if exists.
+   * After this operation, only the latest ate is valid.
+   */
+
+  if (prev_found)
+    {
+      rc = nvs_expire_ate(fs, hist_addr);
+      finfo("expir prev entry, %" PRIx32 ", rc %d\n", hist_addr, rc);
+      if (rc < 0)
+        {
+          ferr("expire ate failed, addr %" PRIx32 "\n", hist_addr);
+          return rc;
+        }
+
+      nvs_index_move(fs, hash_id, hist_addr, new_addr);
+    }
+  else
+    {
+      nvs_index_add(fs, hash_id, new_addr);
+    }
+
+  finfo("nvs_write success\n");
+  return 0;
+}
+
+/****************************************************************************
+ * Name: nvs_write_batch
+ *
+ * Description:
+ *   Write or delete several entries at once.  The new entries, including
+ *   those without data for the deletions, are written in the current
+ *   block and followed by a commit ate.  Only then the old entries are
+ *   expired, as are the deletions.  An interrupted batch is dropped by
+ *   nvs_batch_recover() if it lacks the commit ate, else completed by
+ *   nvs_index_build().
+ *
+ * Input Parameters:
+ *   fs    - Pointer to file system.
+ *   batch - The items to write, delete those with a len of zero.
+ *
+ * Returned Value:
+ *   0 on success, -ERRNO errno code if error.
+ *
+ ****************************************************************************/
+
+static int nvs_write_batch(FAR struct nvs_fs *fs,
+                           FAR const struct config_batch_s *batch)
+{
+  FAR struct config_data_s *pdata;
+  FAR const uint8_t *key;
+  uint8_t keybuf[NVS_KEY_SIZE];
+  struct nvs_ate commit_ate;
+  struct nvs_ate wlk_ate;
+  size_t required_space;
+  size_t key_size;
+  uint32_t hist_addr;
+  uint32_t new_addr;
+  uint32_t hash_id;
+  int gc_count;
+  size_t i;
+  int rc;
+
+  if (batch == NULL || (batch->nitems > 0 && batch->items == NULL))
+    {
+      return -EINVAL;
+    }
+
+  /* All entries and the commit ate must fit in one block, leaving space
+   * for the block close and gc_done ates.
+   */
+
+  required_space = sizeof(struct nvs_ate);
+  for (i = 0; i < batch->nitems; i++)
+    {
+      pdata = &batch->items[i];
+      if (pdata->len > 0 && pdata->configdata == NULL)
+        {
+          return -EINVAL;
+        }
+
+      required_space += nvs_item_key(pdata, keybuf, &key) + pdata->len +
+                        sizeof(struct nvs_ate);
+      if (required_space > fs->geo.erasesize - 2 * sizeof(struct nvs_ate))
+        {
+          return -EINVAL;
+        }
+    }
+
+  rc = nvs_index_reserve(fs, batch->nitems);
+  if (rc < 0)
+    {
+      return rc;
+    }
+
+  gc_count = 0;
+  while (fs->ate_wra < fs->data_wra + required_space)
+    {
+      if (gc_count == fs->geo.neraseblocks)
+        {
+          return -ENOSPC;
         }
 
       rc = nvs_block_close(fs);
@@ -1692,11 +2178,87 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
         }
 
       gc_count++;
-      finfo("Gc count=%d\n", gc_count);
     }
 
-  finfo("nvs_write success\n");
+  new_addr = fs->ate_wra;
+  for (i = 0; i < batch->nitems; i++)
+    {
+      pdata = &batch->items[i];
+      key_size = nvs_item_key(pdata, keybuf, &key);
+      hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
+      rc = nvs_flash_wrt_entry(fs, hash_id, key, key_size,
+                               pdata->configdata, pdata->len,
+                               NVS_ATE_PART_BATCH);
+      if (rc)
+        {
+          goto errout;
+        }
+    }
+
+  memset(&commit_ate, fs->erasestate, sizeof(commit_ate));
+  commit_ate.id = NVS_SPECIAL_ATE_ID;
+  commit_ate.len = 0;
+  commit_ate.key_len = 0;
+  commit_ate.offset = fs->data_wra & ADDR_OFFS_MASK;
+  commit_ate.part = NVS_ATE_PART_COMMIT;
+  nvs_ate_crc8_update(&commit_ate);
+
+  rc = nvs_flash_ate_wrt(fs, &commit_ate);
+  if (rc)
+    {
+      goto errout;
+    }
+
+  /* The batch is committed, expire what it replaced */
+
+  for (i = 0; i < batch->nitems; i++, new_addr -= sizeof(struct nvs_ate))
+    {
+      pdata = &batch->items[i];
+      key_size = nvs_item_key(pdata, keybuf, &key);
+      hash_id = nvs_fnv_hash(key, key_size) % 0xfffffffd + 1;
+      rc = nvs_index_find(fs, hash_id, key, 0, key_size, &hist_addr,
+                          &wlk_ate);
+      if (rc == 0)
+        {
+          rc = nvs_expire_ate(fs, hist_addr);
+          if (rc < 0)
+            {
+              return rc;
+            }
+
+          nvs_index_remove(fs, hash_id, hist_addr);
+        }
+      else if (rc != -ENOENT)
+        {
+          return rc;
+        }
+
+      if (pdata->len > 0)
+        {
+          nvs_index_add(fs, hash_id, new_addr);
+        }
+      else
+        {
+          rc = nvs_expire_ate(fs, new_addr);
+          if (rc < 0)
+            {
+              return rc;
+            }
+        }
+    }
+
   return 0;
+
+errout:
+
+  /* Drop what was written of the batch, as the startup would do */
+
+  for (; new_addr > fs->ate_wra; new_addr -= sizeof(struct nvs_ate))
+    {
+      nvs_expire_ate(fs, new_addr);
+    }
+
+  return rc;
 }
 
 /****************************************************************************
@@ -1742,31 +2304,18 @@ static int nvs_delete(FAR struct nvs_fs *fs, FAR struct config_data_s *pdata)
 static ssize_t nvs_read(FAR struct nvs_fs *fs,
                         FAR struct config_data_s *pdata)
 {
+  FAR const uint8_t *key;
+  uint8_t keybuf[NVS_KEY_SIZE];
   size_t key_size;
   ssize_t ret;
 
-#ifdef CONFIG_MTD_CONFIG_NAMED
-  FAR const uint8_t *key;
-#else
-  uint8_t key[sizeof(pdata->id) + sizeof(pdata->instance)];
-#endif
-
   if (pdata == NULL || pdata->len == 0)
     {
       return -EINVAL;
     }
 
-#ifdef CONFIG_MTD_CONFIG_NAMED
-  key = (FAR const uint8_t *)pdata->name;
-  key_size = strlen(pdata->name) + 1;
-#else
-  memcpy(key, &pdata->id, sizeof(pdata->id));
-  memcpy(key + sizeof(pdata->id), &pdata->instance, sizeof(pdata->instance));
-  key_size = sizeof(pdata->id) + sizeof(pdata->instance);
-#endif
-
-  ret = nvs_read_entry(fs, key, key_size, pdata->configdata, pdata->len,
-                      NULL);
+  key_size = nvs_item_key(pdata, keybuf, &key);
+  ret = nvs_read_entry(fs, key, key_size, pdata->configdata, pdata->len);
   if (ret > 0)
     {
       pdata->len = ret;
@@ -1859,8 +2408,9 @@ static int nvs_next(FAR struct nvs_fs *fs,
       return rc;
     }
 
-  memcpy(pdata->id, key, sizeof(pdata->id));
-  memcpy(pdata->instance, key + sizeof(pdata->id), sizeof(pdata->instance));
+  memcpy(&pdata->id, key, sizeof(pdata->id));
+  memcpy(&pdata->instance, key + sizeof(pdata->id),
+         sizeof(pdata->instance));
 #endif
 
   rc = nvs_flash_rd(fs, (rd_addr & ADDR_BLOCK_MASK) + step_ate.offset +
@@ -1938,6 +2488,13 @@ static int mtdconfig_ioctl(FAR struct file *filep, int cmd,
         ret = nvs_write(fs, pdata);
         break;
 
+      case CFGDIOC_SETCONFIGS:
+
+        /* Write several nvs items at once. */
+
+        ret = nvs_write_batch(fs, (FAR struct config_batch_s *)arg);
+        break;
+
       case CFGDIOC_DELCONFIG:
 
         /* Delete a nvs item. */
@@ -2008,7 +2565,7 @@ int mtdconfig_register(FAR struct mtd_dev_s *mtd)
   int ret;
   FAR struct nvs_fs *fs;
 
-  fs = (FAR struct nvs_fs *)kmm_malloc(sizeof(struct nvs_fs));
+  fs = (FAR struct nvs_fs *)kmm_zalloc(sizeof(struct nvs_fs));
   if (fs == NULL)
     {
       return -ENOMEM;
@@ -2042,6 +2599,7 @@ int mtdconfig_register(FAR struct mtd_dev_s *mtd)
 
 mutex_err:
   nxmutex_destroy(&fs->nvs_lock);
+  kmm_free(fs->index);
 
 errout:
   kmm_free(fs);
@@ -2072,7 +2630,12 @@ int mtdconfig_unregister(void)
 
   inode = file.f_inode;
   fs = (FAR struct nvs_fs *)inode->i_private;
+#ifdef CONFIG_MTD_CONFIG_FAIL_SAFE_BGERASE
+  work_cancel(LPWORK, &fs->erase_work);
+  nvs_erase_flush(fs);
+#endif
   nxmutex_destroy(&fs->nvs_lock);
+  kmm_free(fs->index);
   kmm_free(fs);
   file_close(&file);
   unregister_driver("/dev/config");
@@ -95,6 +95,12 @@ static int      nand_readpage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR uint8_t *data);
 static int      nand_writepage(FAR struct nand_dev_s *nand, off_t block,
                   unsigned int page, FAR const void *data);
+static ssize_t  nand_runlength(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, size_t npages);
+static ssize_t  nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, size_t npages, FAR uint8_t *data);
+static ssize_t  nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                  unsigned int page, size_t npages, FAR const uint8_t *data);
 
 /* MTD driver methods */
 
@@ -504,6 +510,149 @@ static int nand_writepage(FAR struct nand_dev_s *nand, off_t block,
     }
 }
 
+/****************************************************************************
+ * Name: nand_runlength
+ *
+ * Description:
+ *   Return the number of consecutive pages, starting at the given page,
+ *   that can be passed to the multi-page operations of the lower half:
+ *   Those of the good blocks that follow, up to the end of FLASH.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the first page resides.
+ *   page   - Number of the first page inside the given block.
+ *   npages - Number of pages requested.
+ *
+ * Returned Value:
+ *   The number of pages on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nand_runlength(FAR struct nand_dev_s *nand, off_t block,
+                              unsigned int page, size_t npages)
+{
+  FAR struct nand_model_s *model = &nand->raw->model;
+  unsigned int pagesperblock = nandmodel_pagesperblock(model);
+  off_t maxblock = nandmodel_getdevblocks(model);
+  size_t count = 0;
+
+  while (count < npages && block <= maxblock)
+    {
+      if (nand_checkblock(nand, block) != GOODBLOCK)
+        {
+          if (count == 0)
+            {
+              ferr("ERROR: Block is BAD\n");
+              return -EAGAIN;
+            }
+
+          break;
+        }
+
+      count += pagesperblock - page;
+      page   = 0;
+      block++;
+    }
+
+  return count < npages ? count : npages;
+}
+
+/****************************************************************************
+ * Name: nand_readpages
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages, with a single multi-page
+ *   operation of the lower half if it has one, or else one page only.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the first page to read resides.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   The number of pages read is returned in success; a negated errno value
+ *   is returned on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nand_readpages(FAR struct nand_dev_s *nand, off_t block,
+                              unsigned int page, size_t npages,
+                              FAR uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  ssize_t count;
+  int ret;
+
+  /* Software ECC is computed page by page */
+
+  if (npages < 2 || raw->readpages == NULL ||
+      raw->ecctype == NANDECC_SWECC)
+    {
+      ret = nand_readpage(nand, block, page, data);
+      return ret < 0 ? ret : 1;
+    }
+
+  count = nand_runlength(nand, block, page, npages);
+  if (count < 0)
+    {
+      return count;
+    }
+
+  finfo("block=%d page=%d npages=%d data=%p\n",
+        (int)block, page, (int)count, data);
+
+  ret = NAND_READPAGES(raw, block, page, count, data);
+  return ret < 0 ? ret : count;
+}
+
+/****************************************************************************
+ * Name: nand_writepages
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages, with a single multi-page
+ *   operation of the lower half if it has one, or else one page only.
+ *
+ * Input Parameters:
+ *   nand   - Upper-half, NAND FLASH interface
+ *   block  - Number of the block where the first page to write resides.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   The number of pages written is returned in success; a negated errno
+ *   value is returned on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nand_writepages(FAR struct nand_dev_s *nand, off_t block,
+                               unsigned int page, size_t npages,
+                               FAR const uint8_t *data)
+{
+  FAR struct nand_raw_s *raw = nand->raw;
+  ssize_t count;
+  int ret;
+
+  if (npages < 2 || raw->writepages == NULL ||
+      raw->ecctype == NANDECC_SWECC)
+    {
+      ret = nand_writepage(nand, block, page, data);
+      return ret < 0 ? ret : 1;
+    }
+
+  count = nand_runlength(nand, block, page, npages);
+  if (count < 0)
+    {
+      return count;
+    }
+
+  ret = NAND_WRITEPAGES(raw, block, page, count, data);
+  return ret < 0 ? ret : count;
+}
+
 /****************************************************************************
  * Name: nand_erase
  *
@@ -562,6 +711,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
   unsigned int page;
   uint16_t pagesize;
   size_t remaining;
+  ssize_t count;
   off_t maxblock;
   off_t block;
   int ret;
@@ -593,7 +743,7 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then read every page from NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to read beyond the end of NAND */
 
@@ -606,12 +756,15 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Read the next page from NAND */
+      /* Read the next pages from NAND, as many at once as the lower
+       * half supports
+       */
 
-      ret = nand_readpage(nand, block, page, buffer);
-      if (ret < 0)
+      count = nand_readpages(nand, block, page, remaining, buffer);
+      if (count < 0)
         {
-          ferr("ERROR: nand_readpage failed block=%ld page=%d: %d\n",
+          ret = count;
+          ferr("ERROR: nand_readpages failed block=%ld page=%d: %d\n",
                (long)block, page, ret);
           goto errout_with_lock;
         }
@@ -621,15 +774,13 @@ static ssize_t nand_bread(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
-        {
-          page = 0;
-          block++;
-        }
+      page  += count;
+      block += page / pagesperblock;
+      page  %= pagesperblock;
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
@@ -658,6 +809,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
   unsigned int page;
   uint16_t pagesize;
   size_t remaining;
+  ssize_t count;
   off_t maxblock;
   off_t block;
   int ret;
@@ -689,7 +841,7 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
 
   /* Then write every page into NAND */
 
-  for (remaining = npages; remaining > 0; remaining--)
+  for (remaining = npages; remaining > 0; remaining -= count)
     {
       /* Check for attempt to write beyond the end of NAND */
 
@@ -702,12 +854,15 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
           goto errout_with_lock;
         }
 
-      /* Write the next page into NAND */
+      /* Write the next pages into NAND, as many at once as the lower
+       * half supports
+       */
 
-      ret = nand_writepage(nand, block, page, buffer);
-      if (ret < 0)
+      count = nand_writepages(nand, block, page, remaining, buffer);
+      if (count < 0)
         {
-          ferr("ERROR: nand_writepage failed block=%ld page=%d: %d\n",
+          ret = count;
+          ferr("ERROR: nand_writepages failed block=%ld page=%d: %d\n",
                (long)block, page, ret);
           goto errout_with_lock;
         }
@@ -717,15 +872,13 @@ static ssize_t nand_bwrite(struct mtd_dev_s *dev, off_t startpage,
        * the block number.
        */
 
-      if (++page >= pagesperblock)
-        {
-          page = 0;
-          block++;
-        }
+      page  += count;
+      block += page / pagesperblock;
+      page  %= pagesperblock;
 
-      /* Increment the buffer point by the size of one page */
+      /* Increment the buffer point by the size of the pages */
 
-      buffer += pagesize;
+      buffer += count * pagesize;
     }
 
   nxmutex_unlock(&nand->lock);
@@ -884,6 +1037,27 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
       model->devid     = onfi.manufacturer;
       model->options   = onfi.buswidth ? NANDMODEL_DATAWIDTH16 :
                                          NANDMODEL_DATAWIDTH8;
+
+      if (onfi.optcmds & ONFI_OPTCMD_COPYBACK)
+        {
+          model->options |= NANDMODEL_COPYBACK;
+        }
+
+      if (onfi.optcmds & ONFI_OPTCMD_CACHEREAD)
+        {
+          model->options |= NANDMODEL_CACHEREAD;
+        }
+
+      if (onfi.optcmds & ONFI_OPTCMD_CACHEPROG)
+        {
+          model->options |= NANDMODEL_CACHEPROG;
+        }
+
+      if (onfi.planebits > 0)
+        {
+          model->options |= NANDMODEL_MULTIPLANE;
+        }
+
       model->pagesize  = onfi.pagesize;
       model->sparesize = onfi.sparesize;
 
@@ -317,6 +317,11 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->buswidth = (*(FAR uint8_t *)(parmtab + 6)) & 0x01;
 
+  /* Features and optional commands supported (bytes 6-9) */
+
+  onfi->features = parmtab[6] | (parmtab[7] << 8);
+  onfi->optcmds  = parmtab[8] | (parmtab[9] << 8);
+
   /* Get number of data bytes per page (bytes 80-83 in the param table) */
 
   onfi->pagesize =  *(FAR uint32_t *)(FAR void *)(parmtab + 80);
@@ -341,6 +346,11 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
 
   onfi->eccsize = *(FAR uint8_t *)(parmtab + 112);
 
+  /* Number of plane address bits of multi-plane operations */
+
+  onfi->planebits = (onfi->features & ONFI_FEATURE_INTERLEAVED) ?
+                    (parmtab[113] & 0x0f) : 0;
+
   /* Device model */
 
   onfi->model = *(FAR uint8_t *)(parmtab + 49);
@@ -351,6 +361,9 @@ int onfi_read(uintptr_t cmdaddr, uintptr_t addraddr, uintptr_t dataaddr,
   finfo("  luns:          %d\n",          onfi->luns);
   finfo("  eccsize:       %d\n",          onfi->eccsize);
   finfo("  model:         0x%02x\n",      onfi->model);
+  finfo("  planebits:     %d\n",          onfi->planebits);
+  finfo("  features:      0x%04x\n",      onfi->features);
+  finfo("  optcmds:       0x%04x\n",      onfi->optcmds);
   finfo("  sparesize:     %d\n",          onfi->sparesize);
   finfo("  pagesperblock: %d\n",          onfi->pagesperblock);
   finfo("  blocksperlun:  %d\n",          onfi->blocksperlun);
@@ -66,6 +66,14 @@
 #  define CONFIG_MTD_NRDBLOCKS 4
 #endif
 
+#ifndef CONFIG_MTD_NWRBUFFERS
+#  define CONFIG_MTD_NWRBUFFERS 1
+#endif
+
+#ifndef CONFIG_MTD_NRDBUFFERS
+#  define CONFIG_MTD_NRDBUFFERS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -423,9 +431,11 @@ FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd)
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   priv->rwb.wrmaxblocks = CONFIG_MTD_NWRBLOCKS;
+  priv->rwb.wrnbuffers  = CONFIG_MTD_NWRBUFFERS;
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   priv->rwb.rhmaxblocks = CONFIG_MTD_NRDBLOCKS;
+  priv->rwb.rhnbuffers  = CONFIG_MTD_NRDBUFFERS;
 #endif
 
   /* Callouts */
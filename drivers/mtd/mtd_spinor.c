@@ -0,0 +1,245 @@
+/****************************************************************************
+ * drivers/mtd/mtd_spinor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mtd/spinor.h>
+
+#ifdef CONFIG_MTD_SPINOR_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SPINOR_ASYNC_DELAY USEC2TICK(CONFIG_MTD_SPINOR_ASYNC_POLLDELAY)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinor_async_worker
+ *
+ * Description:
+ *   Poll the device and start programming the next page as soon as the
+ *   previous one is done.  The bus is released between the steps so that
+ *   other devices on the bus can be accessed in the meantime.
+ *
+ ****************************************************************************/
+
+static void spinor_async_worker(FAR void *arg)
+{
+  FAR struct spinor_async_s *as = (FAR struct spinor_async_s *)arg;
+  size_t nbytes;
+
+  as->ops->lock(as->arg, true);
+
+  if (as->ops->busy(as->arg))
+    {
+      /* The previous page (or an erase) is still in progress */
+
+      as->ops->lock(as->arg, false);
+      work_queue(LPWORK, &as->work, spinor_async_worker, as,
+                 SPINOR_ASYNC_DELAY);
+      return;
+    }
+
+  if (as->pos < as->len)
+    {
+      /* Program up to the end of the page */
+
+      nbytes = as->pagesize - (as->address & (as->pagesize - 1));
+      if (nbytes > as->len - as->pos)
+        {
+          nbytes = as->len - as->pos;
+        }
+
+      as->ops->program(as->arg, &as->buffer[as->pos], as->address, nbytes);
+      as->ops->lock(as->arg, false);
+
+      as->pos     += nbytes;
+      as->address += nbytes;
+
+      work_queue(LPWORK, &as->work, spinor_async_worker, as,
+                 SPINOR_ASYNC_DELAY);
+      return;
+    }
+
+  /* All data is programmed and the device is idle */
+
+  as->ops->lock(as->arg, false);
+  as->active = false;
+  nxsem_post(&as->donesem);
+}
+
+/****************************************************************************
+ * Name: spinor_async_waitidle
+ *
+ * Description:
+ *   Wait until the pipeline stops.  The caller holds as->lock.
+ *
+ ****************************************************************************/
+
+static void spinor_async_waitidle(FAR struct spinor_async_s *as)
+{
+  while (as->active)
+    {
+      nxsem_wait_uninterruptible(&as->donesem);
+    }
+
+  /* Discard completions that nobody waited for */
+
+  while (nxsem_trywait(&as->donesem) == OK);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinor_async_initialize
+ *
+ * Description:
+ *   Initialize the page program pipeline of one device.
+ *
+ ****************************************************************************/
+
+int spinor_async_initialize(FAR struct spinor_async_s *as,
+                            FAR const struct spinor_async_ops_s *ops,
+                            FAR void *arg, size_t pagesize)
+{
+  DEBUGASSERT(as != NULL && ops != NULL && pagesize > 0 &&
+              (pagesize & (pagesize - 1)) == 0);
+
+  memset(as, 0, sizeof(*as));
+
+  as->buffer = kmm_malloc(CONFIG_MTD_SPINOR_ASYNC_BUFSIZE);
+  if (as->buffer == NULL)
+    {
+      ferr("ERROR: Failed to allocate the program buffer\n");
+      return -ENOMEM;
+    }
+
+  as->ops      = ops;
+  as->arg      = arg;
+  as->pagesize = pagesize;
+  as->bufsize  = CONFIG_MTD_SPINOR_ASYNC_BUFSIZE;
+
+  nxmutex_init(&as->lock);
+  nxsem_init(&as->donesem, 0, 0);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinor_async_uninitialize
+ *
+ * Description:
+ *   Wait for pending writes and release the pipeline resources.
+ *
+ ****************************************************************************/
+
+void spinor_async_uninitialize(FAR struct spinor_async_s *as)
+{
+  spinor_async_wait(as);
+
+  nxsem_destroy(&as->donesem);
+  nxmutex_destroy(&as->lock);
+  kmm_free(as->buffer);
+  as->buffer = NULL;
+}
+
+/****************************************************************************
+ * Name: spinor_async_write
+ *
+ * Description:
+ *   Queue data to be programmed.  The data is copied in chunks of the
+ *   buffer size; each chunk is queued once the previous one is done.
+ *
+ ****************************************************************************/
+
+ssize_t spinor_async_write(FAR struct spinor_async_s *as,
+                           FAR const uint8_t *buffer, off_t address,
+                           size_t nbytes)
+{
+  size_t remaining = nbytes;
+  size_t chunk;
+  int ret;
+
+  ret = nxmutex_lock(&as->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (remaining > 0)
+    {
+      spinor_async_waitidle(as);
+
+      chunk = remaining;
+      if (chunk > as->bufsize)
+        {
+          chunk = as->bufsize;
+        }
+
+      memcpy(as->buffer, buffer, chunk);
+      as->pos     = 0;
+      as->len     = chunk;
+      as->address = address;
+      as->active  = true;
+
+      work_queue(LPWORK, &as->work, spinor_async_worker, as, 0);
+
+      buffer    += chunk;
+      address   += chunk;
+      remaining -= chunk;
+    }
+
+  nxmutex_unlock(&as->lock);
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: spinor_async_wait
+ *
+ * Description:
+ *   Wait until all queued data has been programmed and the device is idle.
+ *
+ ****************************************************************************/
+
+void spinor_async_wait(FAR struct spinor_async_s *as)
+{
+  nxmutex_lock(&as->lock);
+  spinor_async_waitidle(as);
+  nxmutex_unlock(&as->lock);
+}
+
+#endif /* CONFIG_MTD_SPINOR_ASYNC */
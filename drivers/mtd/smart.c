@@ -43,6 +43,8 @@
 #include <nuttx/crc16.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -125,6 +127,19 @@
 
 #define SMART_MAX_ALLOCS        10
 
+/* Background garbage collection.  A block is only worth collecting from
+ * the work queue once at least a quarter of its sectors were released.
+ */
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#  define SMART_GC_DELAY        MSEC2TICK(CONFIG_MTD_SMART_GC_DELAY)
+#  define smart_lock(d)         nxmutex_lock(&(d)->lock)
+#  define smart_unlock(d)       nxmutex_unlock(&(d)->lock)
+#else
+#  define smart_lock(d)
+#  define smart_unlock(d)
+#endif
+
 #ifndef CONFIG_MTD_SMART_ALLOC_DEBUG
 #define smart_malloc(d, b, n)   kmm_malloc(b)
 #define smart_zalloc(d, b, n)   kmm_zalloc(b)
@@ -297,6 +312,10 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+  mutex_t               lock;             /* Serializes sector access */
+  struct work_s         gcwork;           /* Background garbage collection */
+#endif
 };
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -443,6 +462,9 @@ static int     smart_relocate_static_data(FAR struct smart_struct_s *dev,
                  uint16_t block);
 #endif
 
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void    smart_gcworker(FAR void *arg);
+#endif
 static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
@@ -3767,6 +3789,36 @@ retry:
   maxwearlevel = 0;
 #endif
   physicalsector = 0xffff;
+
+#ifdef CONFIG_MTD_SMART_WRITE_MERGE
+  /* Keep filling the erase block of the previous allocation until it is
+   * full.  Sectors that are written together then share an erase block,
+   * tend to be released together and leave blocks that are cheap to
+   * collect.
+   */
+
+  block = dev->lastallocblock;
+  if (block < dev->neraseblocks)
+    {
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->freecount, block);
+#else
+      count = dev->freecount[block];
+#endif
+
+      if (count > 0
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          && smart_get_wear_level(dev, block) <
+             SMART_WEAR_FULL_RELOCATE_THRESHOLD
+#endif
+         )
+        {
+          allocblock = block;
+          goto found;
+        }
+    }
+#endif
+
   if (++dev->lastallocblock >= dev->neraseblocks)
     {
       dev->lastallocblock = 0;
@@ -3913,6 +3965,10 @@ retry:
         }
     }
 
+#ifdef CONFIG_MTD_SMART_WRITE_MERGE
+found:
+#endif
+
   /* Now find a free physical sector within this selected erase block to
    * allocate.
    */
@@ -4004,12 +4060,57 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_findcollectblock
+ *
+ * Description:  Returns the erase block with the most released sectors, or
+ *               0xffff if no block has released sectors.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_findcollectblock(FAR struct smart_struct_s *dev,
+                                       FAR uint16_t *releasemax)
+{
+  uint16_t collectblock;
+  uint16_t count;
+  int x;
+
+  collectblock = 0xffff;
+  *releasemax = 0;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+#else
+      count = dev->releasecount[x];
+#endif
+      if (count > *releasemax)
+        {
+          *releasemax = count;
+          collectblock = x;
+        }
+    }
+
+  return collectblock;
+}
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
  * Description:  Performs garbage collection if needed.  This is determined
  *               by the count of released sectors relative to free and
- *               total sectors.
+ *               total sectors.  With CONFIG_MTD_SMART_BACKGROUND_GC this
+ *               only collects when the reserved free sectors are reached;
+ *               the work queue keeps the free sector count above that.
  *
  ****************************************************************************/
 
@@ -4018,16 +4119,13 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
   uint16_t collectblock;
   uint16_t releasemax;
   bool collect = TRUE;
-  int x;
   int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t count;
-#endif
 
   while (collect)
     {
       collect = FALSE;
 
+#ifndef CONFIG_MTD_SMART_BACKGROUND_GC
       /* Test if the released sectors count is greater than the
        * free sectors.  If it is, then we will do garbage collection.
        */
@@ -4037,6 +4135,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           collect = TRUE;
         }
+#endif
 
       /* Test if we have more reached our reserved free sector limit */
 
@@ -4051,39 +4150,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
-
-#if 0
-          releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-#endif
-
+          collectblock = smart_findcollectblock(dev, &releasemax);
           if (collectblock == 0xffff)
             {
               /* Need to collect, but no sectors with released blocks! */
@@ -4136,6 +4203,98 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_gcneeded
+ *
+ * Description:  Returns the erase block that the background garbage
+ *               collection should relocate next, or 0xffff if there is
+ *               nothing worth doing.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static uint16_t smart_gcneeded(FAR struct smart_struct_s *dev)
+{
+  uint16_t collectblock;
+  uint16_t releasemax;
+
+  /* Keep the free sectors above the low water mark */
+
+  if (dev->freesectors >= (uint32_t)dev->totalsectors *
+                          CONFIG_MTD_SMART_GC_FREEPCT / 100)
+    {
+      return 0xffff;
+    }
+
+  /* Relocating a block costs an erase and copying all of its live
+   * sectors, only do it when that frees a reasonable number of sectors.
+   */
+
+  collectblock = smart_findcollectblock(dev, &releasemax);
+  if (collectblock == 0xffff ||
+      releasemax < ((dev->availsectperblk + 3) >> 2))
+    {
+      return 0xffff;
+    }
+
+  return collectblock;
+}
+
+/****************************************************************************
+ * Name: smart_gcschedule
+ *
+ * Description:  Start the background garbage collection if it is needed
+ *               and not already pending.  Called with the device locked.
+ *
+ ****************************************************************************/
+
+static void smart_gcschedule(FAR struct smart_struct_s *dev)
+{
+  if (work_available(&dev->gcwork) && smart_gcneeded(dev) != 0xffff)
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_gcworker, dev,
+                 SMART_GC_DELAY);
+    }
+}
+
+/****************************************************************************
+ * Name: smart_gcworker
+ *
+ * Description:  Relocate one erase block from the low priority work queue.
+ *               The worker requeues itself while collection is needed, so
+ *               the device lock is only held for one block at a time.
+ *
+ ****************************************************************************/
+
+static void smart_gcworker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  uint16_t collectblock;
+  int ret;
+
+  smart_lock(dev);
+
+  collectblock = smart_gcneeded(dev);
+  if (collectblock != 0xffff)
+    {
+      finfo("Background collect block %d, free=%d released=%d\n",
+            collectblock, dev->freesectors, dev->releasesectors);
+
+      ret = smart_relocate_block(dev, collectblock);
+      if (ret < 0)
+        {
+          ferr("ERROR: Background collection failed: %d\n", ret);
+        }
+      else if (smart_gcneeded(dev) != 0xffff)
+        {
+          work_queue(LPWORK, &dev->gcwork, smart_gcworker, dev, 0);
+        }
+    }
+
+  smart_unlock(dev);
+}
+#endif /* CONFIG_MTD_SMART_BACKGROUND_GC */
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -5494,6 +5653,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
    * to directly to the underlying MTD device.
    */
 
+  smart_lock(dev);
+
   switch (cmd)
     {
     case BIOC_GETFORMAT:
@@ -5542,6 +5703,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       /* Free the specified logical sector */
 
       ret = smart_freesector(dev, arg);
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+      smart_gcschedule(dev);
+#endif
       goto ok_out;
 
     case BIOC_WRITESECT:
@@ -5559,6 +5723,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
 #endif
 
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+      smart_gcschedule(dev);
+#endif
       goto ok_out;
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
@@ -5617,6 +5784,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       break;
     }
 
+  smart_unlock(dev);
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -5628,7 +5797,10 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       ferr("ERROR: MTD ioctl(%04x) failed: %d\n", cmd, ret);
     }
 
+  return ret;
+
 ok_out:
+  smart_unlock(dev);
   return ret;
 }
 
@@ -6169,6 +6341,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+      nxmutex_init(&dev->lock);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6313,6 +6488,9 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+  nxmutex_destroy(&dev->lock);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   if (rootdirdev)
     {
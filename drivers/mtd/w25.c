@@ -44,6 +44,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/spinor.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -190,6 +191,18 @@
 
 #define W25_ERASED_STATE           0xff      /* State of FLASH when erased */
 
+/* Pages are programmed from the work queue unless the erase block cache
+ * (which reads the FLASH while holding the bus) is used.
+ */
+
+#if defined(CONFIG_MTD_SPINOR_ASYNC) && !defined(CONFIG_W25_READONLY) && \
+    !defined(CONFIG_W25_SECTOR512)
+#  define W25_ASYNC 1
+#  define w25_asyncwait(p) spinor_async_wait(&(p)->async)
+#else
+#  define w25_asyncwait(p)
+#endif
+
 /* Cache flags */
 
 #define W25_CACHE_VALID            (1 << 0)  /* 1=Cache has valid data */
@@ -230,6 +243,10 @@ struct w25_dev_s
   uint16_t              esectno;     /* Erase sector number in the cache */
   FAR uint8_t          *sector;      /* Allocated sector data */
 #endif
+
+#ifdef W25_ASYNC
+  struct spinor_async_s async;       /* Page program pipeline */
+#endif
 };
 
 /****************************************************************************
@@ -258,6 +275,11 @@ static void w25_byteread(FAR struct w25_dev_s *priv,
                          off_t address,
                          size_t nbytes);
 #ifndef CONFIG_W25_READONLY
+static void w25_pageprogram(FAR struct w25_dev_s *priv,
+                            FAR const uint8_t *buffer, off_t address,
+                            size_t nbytes);
+#endif
+#if !defined(CONFIG_W25_READONLY) && !defined(W25_ASYNC)
 static void w25_pagewrite(FAR struct w25_dev_s *priv,
                           FAR const uint8_t *buffer,
                           off_t address,
@@ -301,10 +323,26 @@ static ssize_t w25_write(FAR struct mtd_dev_s *dev,
                          FAR const uint8_t *buffer);
 #endif
 
+#ifdef W25_ASYNC
+static void w25_async_lock(FAR void *arg, bool lock);
+static bool w25_async_busy(FAR void *arg);
+static void w25_async_program(FAR void *arg, FAR const uint8_t *buffer,
+                              off_t address, size_t nbytes);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef W25_ASYNC
+static const struct spinor_async_ops_s g_w25_async_ops =
+{
+  w25_async_lock,    /* lock */
+  w25_async_busy,    /* busy */
+  w25_async_program  /* program */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -784,10 +822,53 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
 }
 
 /****************************************************************************
- * Name:  w25_pagewrite
+ * Name:  w25_pageprogram
+ *
+ * Description:
+ *   Start programming data within one page.  This does not wait for the
+ *   operation to complete.
+ *
  ****************************************************************************/
 
 #ifndef CONFIG_W25_READONLY
+static void w25_pageprogram(FAR struct w25_dev_s *priv,
+                            FAR const uint8_t *buffer, off_t address,
+                            size_t nbytes)
+{
+  /* Enable write access to the FLASH */
+
+  w25_wren(priv);
+
+  /* Select this FLASH part */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+
+  /* Send the "Page Program (W25_PP)" Command */
+
+  SPI_SEND(priv->spi, W25_PP);
+  priv->prev_instr = W25_PP;
+
+  /* Send the address high byte first. */
+
+  SPI_SEND(priv->spi, (address >> 16) & 0xff);
+  SPI_SEND(priv->spi, (address >> 8) & 0xff);
+  SPI_SEND(priv->spi, address & 0xff);
+
+  /* Then send the data */
+
+  SPI_SNDBLOCK(priv->spi, buffer, nbytes);
+
+  /* Deselect the FLASH */
+
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+}
+#endif
+
+/****************************************************************************
+ * Name:  w25_pagewrite
+ ****************************************************************************/
+
+#if !defined(CONFIG_W25_READONLY) && !defined(W25_ASYNC)
 static void w25_pagewrite(struct w25_dev_s *priv, FAR const uint8_t *buffer,
                           off_t address, size_t nbytes)
 {
@@ -804,42 +885,70 @@ static void w25_pagewrite(struct w25_dev_s *priv, FAR const uint8_t *buffer,
       status = w25_waitwritecomplete(priv);
       DEBUGASSERT((status & (W25_SR_WEL | W25_SR_BP_MASK)) == 0);
 
-      /* Enable write access to the FLASH */
+      /* Program the page */
 
-      w25_wren(priv);
+      w25_pageprogram(priv, buffer, address, W25_PAGE_SIZE);
 
-      /* Select this FLASH part */
+      /* Update addresses */
 
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+      address += W25_PAGE_SIZE;
+      buffer  += W25_PAGE_SIZE;
+    }
 
-      /* Send the "Page Program (W25_PP)" Command */
+  /* Disable writing */
 
-      SPI_SEND(priv->spi, W25_PP);
-      priv->prev_instr = W25_PP;
+  w25_wrdi(priv);
+}
+#endif
 
-      /* Send the address high byte first. */
+/****************************************************************************
+ * Name: w25_async_lock
+ ****************************************************************************/
 
-      SPI_SEND(priv->spi, (address >> 16) & 0xff);
-      SPI_SEND(priv->spi, (address >> 8) & 0xff);
-      SPI_SEND(priv->spi, address & 0xff);
+#ifdef W25_ASYNC
+static void w25_async_lock(FAR void *arg, bool lock)
+{
+  FAR struct w25_dev_s *priv = (FAR struct w25_dev_s *)arg;
 
-      /* Then send the page of data */
+  if (lock)
+    {
+      w25_lock(priv->spi);
+    }
+  else
+    {
+      w25_unlock(priv->spi);
+    }
+}
 
-      SPI_SNDBLOCK(priv->spi, buffer, W25_PAGE_SIZE);
+/****************************************************************************
+ * Name: w25_async_busy
+ ****************************************************************************/
 
-      /* Deselect the FLASH and setup for the next pass through the loop */
+static bool w25_async_busy(FAR void *arg)
+{
+  FAR struct w25_dev_s *priv = (FAR struct w25_dev_s *)arg;
+  uint8_t status;
 
-      SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
+  /* Send "Read Status Register (RDSR)" command and a dummy byte to
+   * generate the clock needed to shift out the status.
+   */
 
-      /* Update addresses */
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), true);
+  SPI_SEND(priv->spi, W25_RDSR);
+  status = SPI_SEND(priv->spi, W25_DUMMY);
+  SPI_SELECT(priv->spi, SPIDEV_FLASH(0), false);
 
-      address += W25_PAGE_SIZE;
-      buffer  += W25_PAGE_SIZE;
-    }
+  return (status & W25_SR_BUSY) != 0;
+}
 
-  /* Disable writing */
+/****************************************************************************
+ * Name: w25_async_program
+ ****************************************************************************/
 
-  w25_wrdi(priv);
+static void w25_async_program(FAR void *arg, FAR const uint8_t *buffer,
+                              off_t address, size_t nbytes)
+{
+  w25_pageprogram((FAR struct w25_dev_s *)arg, buffer, address, nbytes);
 }
 #endif
 
@@ -1083,8 +1192,11 @@ static int w25_erase(FAR struct mtd_dev_s *dev,
 
   finfo("startblock: %08lx nblocks: %d\n", (long)startblock, (int)nblocks);
 
-  /* Lock access to the SPI bus until we complete the erase */
+  /* Let pending page programs finish, then lock access to the SPI bus
+   * until we complete the erase
+   */
 
+  w25_asyncwait(priv);
   w25_lock(priv->spi);
 
   while (blocksleft-- > 0)
@@ -1159,9 +1271,23 @@ static ssize_t w25_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
   return -EACCESS;
 #else
   FAR struct w25_dev_s *priv = (FAR struct w25_dev_s *)dev;
+#ifdef W25_ASYNC
+  ssize_t ret;
+#endif
 
   finfo("startblock: %08lx nblocks: %d\n", (long)startblock, (int)nblocks);
 
+#ifdef W25_ASYNC
+  /* Queue the pages; they are programmed from the work queue */
+
+  ret = spinor_async_write(&priv->async, buffer,
+                           startblock << W25_PAGE_SHIFT,
+                           nblocks << W25_PAGE_SHIFT);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#else
   /* Lock the SPI bus and write all of the pages to FLASH */
 
   w25_lock(priv->spi);
@@ -1173,6 +1299,7 @@ static ssize_t w25_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
                   nblocks << W25_PAGE_SHIFT);
 #endif
   w25_unlock(priv->spi);
+#endif
 
   return nblocks;
 #endif
@@ -1191,8 +1318,11 @@ static ssize_t w25_read(FAR struct mtd_dev_s *dev,
 
   finfo("offset: %08lx nbytes: %d\n", (long)offset, (int)nbytes);
 
-  /* Lock the SPI bus and select this FLASH part */
+  /* Let pending page programs finish, then lock the SPI bus and select
+   * this FLASH part
+   */
 
+  w25_asyncwait(priv);
   w25_lock(priv->spi);
   w25_byteread(priv, buffer, offset, nbytes);
   w25_unlock(priv->spi);
@@ -1228,6 +1358,7 @@ static ssize_t w25_write(FAR struct mtd_dev_s *dev,
   startpage = offset / W25_PAGE_SIZE;
   endpage = (offset + nbytes) / W25_PAGE_SIZE;
 
+  w25_asyncwait(priv);
   w25_lock(priv->spi);
   if (startpage == endpage)
     {
@@ -1286,6 +1417,12 @@ static int w25_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
 
   finfo("cmd: %d\n", cmd);
 
+  /* Commands may depend on the data being programmed (BIOC_FLUSH,
+   * MTDIOC_BULKERASE, ...)
+   */
+
+  w25_asyncwait(priv);
+
   switch (cmd)
     {
       case MTDIOC_GEOMETRY:
@@ -1459,6 +1596,17 @@ FAR struct mtd_dev_s *w25_initialize(FAR struct spi_dev_s *spi)
               return NULL;
             }
 #endif
+
+#ifdef W25_ASYNC
+          ret = spinor_async_initialize(&priv->async, &g_w25_async_ops,
+                                        priv, W25_PAGE_SIZE);
+          if (ret < 0)
+            {
+              ferr("ERROR: Allocation failed\n");
+              kmm_free(priv);
+              return NULL;
+            }
+#endif
         }
     }
 
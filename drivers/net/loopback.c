@@ -70,6 +70,8 @@
 struct lo_driver_s
 {
   bool lo_bifup;               /* true:ifup false:ifdown */
+  bool lo_polling;             /* A poll of the device is in progress */
+  bool lo_txpending;           /* New TX data arrived while polling */
   struct work_s lo_work;       /* For deferring poll work to the work queue */
 
   /* This holds the information visible to the NuttX network */
@@ -91,6 +93,7 @@ static struct lo_driver_s g_loopback;
 
 static int lo_ifup(FAR struct net_driver_s *dev);
 static int lo_ifdown(FAR struct net_driver_s *dev);
+static void lo_poll(FAR struct lo_driver_s *priv);
 static void lo_txavail_work(FAR void *arg);
 static int lo_txavail(FAR struct net_driver_s *dev);
 #ifdef CONFIG_NET_MCASTGROUP
@@ -169,6 +172,55 @@ static int lo_ifdown(FAR struct net_driver_s *dev)
   return OK;
 }
 
+/****************************************************************************
+ * Name: lo_poll
+ *
+ * Description:
+ *   Loop all the pending TX data back to the input of the network.  A
+ *   notification of new TX data from the input processing of a poll does
+ *   not nest another poll, but has the current one poll again.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void lo_poll(FAR struct lo_driver_s *priv)
+{
+  /* Ignore the notification if the interface is not yet up */
+
+  net_lock();
+  if (priv->lo_bifup)
+    {
+      if (priv->lo_polling)
+        {
+          priv->lo_txpending = true;
+        }
+      else
+        {
+          priv->lo_polling = true;
+
+          do
+            {
+              /* Reuse the devif_loopback() logic, Polling all pending
+               * events until return stop
+               */
+
+              priv->lo_txpending = false;
+              while (devif_poll(&priv->lo_dev, NULL));
+            }
+          while (priv->lo_txpending);
+
+          priv->lo_polling = false;
+        }
+    }
+
+  net_unlock();
+}
+
 /****************************************************************************
  * Name: lo_txavail_work
  *
@@ -190,19 +242,7 @@ static void lo_txavail_work(FAR void *arg)
 {
   FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)arg;
 
-  /* Ignore the notification if the interface is not yet up */
-
-  net_lock();
-  if (priv->lo_bifup)
-    {
-      /* Reuse the devif_loopback() logic, Polling all pending events until
-       * return stop
-       */
-
-      while (devif_poll(&priv->lo_dev, NULL));
-    }
-
-  net_unlock();
+  lo_poll(priv);
 }
 
 /****************************************************************************
@@ -228,6 +268,19 @@ static int lo_txavail(FAR struct net_driver_s *dev)
 {
   FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)dev->d_private;
 
+#ifdef CONFIG_NET_LOOPBACK_DIRECT
+  /* Hand the packets to the input of the network right away, within the
+   * network lock that the sender already holds, instead of waking up the
+   * work queue.
+   */
+
+  if (!up_interrupt_context())
+    {
+      lo_poll(priv);
+      return OK;
+    }
+#endif
+
   /* Is our single work structure available?  It may not be if there are
    * pending interrupt actions and we will have to ignore the Tx
    * availability action.
@@ -334,6 +387,13 @@ int localhost_initialize(void)
   priv->lo_dev.d_rmmac   = lo_rmmac;     /* Remove multicast MAC address */
 #endif
   priv->lo_dev.d_private = priv;         /* Used to recover private state from dev */
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* The packets never leave memory:  There is no TCP/UDP checksum to
+   * compute, nor to verify (see devif_loopback()).
+   */
+
+  priv->lo_dev.d_features = NETDEV_FEATURE_RXCSUM | NETDEV_FEATURE_TXCSUM;
+#endif
 
   /* Register the loopabck device with the OS so that socket IOCTLs can b
    * performed.
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * drivers/net/netdev_rss.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netdev_lowerhalf.h>
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The fields of the IP headers that are hashed, as byte offsets so that
+ * both protocols can be parsed whatever the configuration.
+ */
+
+#define RSS_IPv4_HDRLEN     20
+#define RSS_IPv4_PROTO      9
+#define RSS_IPv4_ADDR       12
+#define RSS_IPv4_ADDRLEN    8
+
+#define RSS_IPv6_HDRLEN     40
+#define RSS_IPv6_PROTO      6
+#define RSS_IPv6_ADDR       8
+#define RSS_IPv6_ADDRLEN    32
+
+/* The largest header that is copied: an IPv4 header with options followed
+ * by the ports.
+ */
+
+#define RSS_MAXHDR          (60 + 4)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The key of the Microsoft RSS specification, also the default of most
+ * network adapters.
+ */
+
+static const uint8_t g_rss_defkey[NETDEV_RSS_KEYLEN] =
+{
+  0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+  0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+  0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+  0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+  0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_lower_rss_init
+ ****************************************************************************/
+
+void netdev_lower_rss_init(FAR struct netdev_lowerhalf_s *dev)
+{
+  int nqueues = dev->rxqueues > 1 ? dev->rxqueues : 1;
+  int i;
+
+  for (i = 0; i < NETDEV_RSS_KEYLEN; i++)
+    {
+      if (dev->rss_key[i] != 0)
+        {
+          return;
+        }
+    }
+
+  memcpy(dev->rss_key, g_rss_defkey, NETDEV_RSS_KEYLEN);
+  for (i = 0; i < NETDEV_RSS_TABLESIZE; i++)
+    {
+      dev->rss_table[i] = i % nqueues;
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_rss_hash
+ *
+ * Description:
+ *   For each bit set in the input, the 32 bits of the key starting at the
+ *   same bit position are added into the hash.
+ *
+ ****************************************************************************/
+
+uint32_t netdev_rss_hash(FAR const uint8_t *key, FAR const uint8_t *data,
+                         unsigned int len)
+{
+  uint32_t window = ((uint32_t)key[0] << 24) | ((uint32_t)key[1] << 16) |
+                    ((uint32_t)key[2] << 8) | key[3];
+  uint32_t hash = 0;
+  unsigned int i;
+  int bit;
+
+  for (i = 0; i < len; i++)
+    {
+      for (bit = 7; bit >= 0; bit--)
+        {
+          if ((data[i] & (1 << bit)) != 0)
+            {
+              hash ^= window;
+            }
+
+          window = (window << 1) | ((key[i + 4] >> bit) & 1);
+        }
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: netpkt_rss_hash
+ ****************************************************************************/
+
+uint32_t netpkt_rss_hash(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *netdev = &dev->netdev;
+  unsigned int llhdrlen = NET_LL_HDRLEN(netdev);
+  uint8_t hdr[RSS_MAXHDR];
+  uint8_t tuple[RSS_IPv6_ADDRLEN + 4];
+  unsigned int hdrlen;
+  unsigned int len;
+  uint16_t type;
+  int ret;
+
+  if (netdev->d_lltype == NET_LL_ETHERNET ||
+      netdev->d_lltype == NET_LL_IEEE80211)
+    {
+      /* Only the EtherType is needed from the L2 header */
+
+      ret = netpkt_copyout(dev, hdr, pkt, 2, ETH_HDRLEN - 2);
+      type = ((uint16_t)hdr[0] << 8) | hdr[1];
+      if (ret < 2 || (type != ETHTYPE_IP && type != ETHTYPE_IP6))
+        {
+          return 0;
+        }
+    }
+
+  ret = netpkt_copyout(dev, hdr, pkt, RSS_MAXHDR, llhdrlen);
+  if (ret < RSS_IPv4_HDRLEN)
+    {
+      return 0;
+    }
+
+  len = ret;
+  if ((hdr[0] >> 4) == 4)
+    {
+      hdrlen = (hdr[0] & 0x0f) << 2;
+      memcpy(tuple, &hdr[RSS_IPv4_ADDR], RSS_IPv4_ADDRLEN);
+
+      /* The ports are only in the first fragment; none are hashed so
+       * that all of the fragments of a packet reach the same queue.
+       */
+
+      if ((hdr[RSS_IPv4_PROTO] == IP_PROTO_TCP ||
+           hdr[RSS_IPv4_PROTO] == IP_PROTO_UDP) &&
+          (hdr[6] & 0x3f) == 0 && hdr[7] == 0 && hdrlen + 4 <= len)
+        {
+          memcpy(&tuple[RSS_IPv4_ADDRLEN], &hdr[hdrlen], 4);
+          return netdev_rss_hash(dev->rss_key, tuple, RSS_IPv4_ADDRLEN + 4);
+        }
+
+      return netdev_rss_hash(dev->rss_key, tuple, RSS_IPv4_ADDRLEN);
+    }
+  else if ((hdr[0] >> 4) == 6 && len >= RSS_IPv6_HDRLEN)
+    {
+      memcpy(tuple, &hdr[RSS_IPv6_ADDR], RSS_IPv6_ADDRLEN);
+
+      /* Extension headers are not parsed */
+
+      if ((hdr[RSS_IPv6_PROTO] == IP_PROTO_TCP ||
+           hdr[RSS_IPv6_PROTO] == IP_PROTO_UDP) &&
+          RSS_IPv6_HDRLEN + 4 <= len)
+        {
+          memcpy(&tuple[RSS_IPv6_ADDRLEN], &hdr[RSS_IPv6_HDRLEN], 4);
+          return netdev_rss_hash(dev->rss_key, tuple, RSS_IPv6_ADDRLEN + 4);
+        }
+
+      return netdev_rss_hash(dev->rss_key, tuple, RSS_IPv6_ADDRLEN);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netpkt_rss_queue
+ ****************************************************************************/
+
+int netpkt_rss_queue(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
+{
+  if (dev->rxqueues <= 1)
+    {
+      return 0;
+    }
+
+  return dev->rss_table[netpkt_rss_hash(dev, pkt) % NETDEV_RSS_TABLESIZE];
+}
+
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
@@ -0,0 +1,1113 @@
+/****************************************************************************
+ * drivers/net/netdev_upperhalf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/pkt.h>
+
+#ifdef CONFIG_NETDEV_LOWERHALF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NETDEV_LOWER(d) container_of(d, struct netdev_lowerhalf_s, netdev)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* This structure describes the thread that drains one RX queue */
+
+struct netdev_rxqueue_s
+{
+  FAR struct netdev_upperhalf_s *upper;
+
+  sem_t   sem;            /* Posted when frames are received */
+  sem_t   done;           /* Posted when the thread exits */
+  pid_t   pid;            /* The thread processing the queue */
+  uint8_t queue;          /* The index of the queue */
+  bool    stop;           /* Tell the thread to exit */
+};
+#endif
+
+/* This structure describes the state of the upper half for one device */
+
+struct netdev_upperhalf_s
+{
+  FAR struct netdev_lowerhalf_s *lower;
+
+  struct work_s txwork;   /* Poll the stack for outgoing packets */
+  struct work_s rxwork;   /* Collect the received packets */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  struct netdev_rxqueue_s rxq[CONFIG_NETDEV_MAX_RXQUEUES];
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netpkt_quota_take / netpkt_quota_give
+ *
+ * Description:
+ *   Account for a packet held by the lower half.  The quota may be changed
+ *   from the interrupt handler of the driver.
+ *
+ ****************************************************************************/
+
+static bool netpkt_quota_take(FAR struct netdev_lowerhalf_s *dev,
+                              enum netpkt_type_e type)
+{
+  irqstate_t flags;
+  bool ret = false;
+
+  flags = enter_critical_section();
+  if (dev->quota[type] > 0)
+    {
+      dev->quota[type]--;
+      ret = true;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+static void netpkt_quota_give(FAR struct netdev_lowerhalf_s *dev,
+                              enum netpkt_type_e type)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  dev->quota[type]++;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_transmit
+ *
+ * Description:
+ *   Hand the packet in dev->d_iob to the lower half.  On return d_iob is
+ *   detached from the device, whatever the outcome.
+ *
+ * Returned Value:
+ *   true if the TX quota of the driver is exhausted.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_transmit(FAR struct netdev_lowerhalf_s *lower)
+{
+  FAR struct net_driver_s *dev = &lower->netdev;
+  FAR netpkt_t *pkt = dev->d_iob;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int len = dev->d_len;
+  int ret;
+
+  netdev_iob_clear(dev);
+
+  if (pkt == NULL || len < llhdrlen)
+    {
+      if (pkt != NULL)
+        {
+          iob_free_chain(pkt);
+        }
+
+      return false;
+    }
+
+  if (!netpkt_quota_take(lower, NETPKT_TX))
+    {
+      NETDEV_TXERRORS(dev);
+      iob_free_chain(pkt);
+      return true;
+    }
+
+  /* d_len is the source of truth for the frame length (some L2 and L3
+   * handlers only update d_len).  The L2 header was built in the guard area
+   * just in front of the L3 data, so exposing it only moves io_offset.
+   */
+
+  iob_update_pktlen(pkt, len - llhdrlen);
+  DEBUGASSERT(pkt->io_offset >= llhdrlen);
+
+  pkt->io_offset -= llhdrlen;
+  pkt->io_len    += llhdrlen;
+  pkt->io_pktlen += llhdrlen;
+
+  NETDEV_TXPACKETS(dev);
+  ret = lower->ops->transmit(lower, pkt);
+  if (ret < 0)
+    {
+      nerr("ERROR: transmit failed: %d\n", ret);
+      NETDEV_TXERRORS(dev);
+      netpkt_free(lower, pkt, NETPKT_TX);
+    }
+
+  return lower->quota[NETPKT_TX] <= 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_xmit
+ *
+ * Description:
+ *   Hand a whole frame, redirected from another device by an early receive
+ *   filter, to the lower half.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXFILTER
+static int netdev_upper_xmit(FAR struct net_driver_s *dev,
+                             FAR struct iob_s *iob)
+{
+  FAR struct netdev_lowerhalf_s *lower = NETDEV_LOWER(dev);
+  int ret;
+
+  if (!netpkt_quota_take(lower, NETPKT_TX))
+    {
+      NETDEV_TXERRORS(dev);
+      iob_free_chain(iob);
+      return -EAGAIN;
+    }
+
+  NETDEV_TXPACKETS(dev);
+  ret = lower->ops->transmit(lower, iob);
+  if (ret < 0)
+    {
+      nerr("ERROR: transmit failed: %d\n", ret);
+      NETDEV_TXERRORS(dev);
+      netpkt_free(lower, iob, NETPKT_TX);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_txpoll
+ *
+ * Description:
+ *   The transmitter callback of devif_poll().  Because d_buf is NULL, the
+ *   stack always presents the packet as an IOB chain and the chain is
+ *   passed to the driver as is.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_lowerhalf_s *lower = NETDEV_LOWER(dev);
+
+  if (netdev_upper_transmit(lower))
+    {
+      return true;
+    }
+
+  /* The remaining connections need a fresh buffer to build into */
+
+  return netdev_iob_prepare(dev, false, 0) != OK;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_txavail_work
+ ****************************************************************************/
+
+static void netdev_upper_txavail_work(FAR void *arg)
+{
+  FAR struct netdev_upperhalf_s *upper = arg;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s *dev = &lower->netdev;
+
+  net_lock();
+  if (IFF_IS_UP(dev->d_flags) && lower->quota[NETPKT_TX] > 0)
+    {
+      DEBUGASSERT(dev->d_buf == NULL);
+      devif_poll(dev, netdev_upper_txpoll);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass one received frame, already attached to dev->d_iob, to the
+ *   protocol that it belongs to.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct net_driver_s *dev)
+{
+  if (dev->d_lltype == NET_LL_ETHERNET ||
+      dev->d_lltype == NET_LL_IEEE80211)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+
+#ifdef CONFIG_NET_PKT
+      /* When packet sockets are enabled, feed the frame into the tap */
+
+      pkt_input(dev);
+#endif
+
+#ifdef CONFIG_NET_IPv4
+      if (eth->type == HTONS(ETHTYPE_IP))
+        {
+          NETDEV_RXIPV4(dev);
+          ipv4_input(dev);
+        }
+      else
+#endif
+#ifdef CONFIG_NET_IPv6
+      if (eth->type == HTONS(ETHTYPE_IP6))
+        {
+          NETDEV_RXIPV6(dev);
+          ipv6_input(dev);
+        }
+      else
+#endif
+#ifdef CONFIG_NET_ARP
+      if (eth->type == HTONS(ETHTYPE_ARP))
+        {
+          NETDEV_RXARP(dev);
+          arp_input(dev);
+        }
+      else
+#endif
+        {
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+        }
+    }
+  else
+    {
+      /* A raw IP device such as TUN:  dispatch on the IP version */
+
+      uint8_t version = dev->d_len > 0 ? (dev->d_buf[0] >> 4) : 0;
+
+#ifdef CONFIG_NET_IPv4
+      if (version == 4)
+        {
+          NETDEV_RXIPV4(dev);
+          ipv4_input(dev);
+        }
+      else
+#endif
+#ifdef CONFIG_NET_IPv6
+      if (version == 6)
+        {
+          NETDEV_RXIPV6(dev);
+          ipv6_input(dev);
+        }
+      else
+#endif
+        {
+          UNUSED(version);
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxpkt
+ *
+ * Description:
+ *   Process one frame received by the lower half.  The frame's IOB chain
+ *   is used as the device buffer as is; the L2 header is stripped by
+ *   moving io_offset back to the guard size expected by the stack.
+ *
+ * Assumptions:
+ *   The network and the device are locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpkt(FAR struct netdev_lowerhalf_s *lower,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev = &lower->netdev;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int len;
+
+  /* The stack owns the packet from now on */
+
+  netpkt_quota_give(lower, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
+
+  len = pkt->io_pktlen;
+  if (!IFF_IS_UP(dev->d_flags) || len <= llhdrlen ||
+      pkt->io_len < llhdrlen ||
+      pkt->io_offset + llhdrlen != CONFIG_NET_LL_GUARDSIZE)
+    {
+      /* Not up, a runt, or a buffer that was not allocated with
+       * netpkt_alloc().
+       */
+
+      NETDEV_RXDROPPED(dev);
+      iob_free_chain(pkt);
+      return;
+    }
+
+  pkt->io_offset += llhdrlen;
+  pkt->io_len    -= llhdrlen;
+  pkt->io_pktlen -= llhdrlen;
+
+  /* As with the flat buffer drivers, d_len covers the whole frame */
+
+  netdev_iob_replace(dev, pkt);
+  dev->d_len = len;
+
+  if (!netdev_rxfilter(dev))
+    {
+      netdev_upper_input(dev);
+    }
+
+  /* Send any response that the input produced in place */
+
+  if (dev->d_iob != NULL && dev->d_len > 0)
+    {
+      netdev_upper_transmit(lower);
+    }
+  else
+    {
+      netdev_iob_release(dev);
+    }
+
+  /* Leave d_buf NULL so that devif_poll() keeps using the IOB path */
+
+  netdev_iob_clear(dev);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxwork
+ *
+ * Description:
+ *   Drain the receive queue of the lower half.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxwork(FAR void *arg)
+{
+  FAR struct netdev_upperhalf_s *upper = arg;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s *dev = &lower->netdev;
+  FAR netpkt_t *pkt;
+
+  net_lock();
+  netdev_lock(dev);
+
+  while ((pkt = lower->ops->receive(lower)) != NULL)
+    {
+      netdev_upper_rxpkt(lower, pkt);
+    }
+
+  netdev_unlock(dev);
+  net_unlock();
+}
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/****************************************************************************
+ * Name: netdev_upper_rxqueue_thread
+ *
+ * Description:
+ *   Drain one RX queue of a multi-queue device.  The frames are collected
+ *   from the driver without the network lock, in parallel with the other
+ *   queues, and passed to the stack in batches so that the lock is only
+ *   taken once per batch.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_rxqueue_thread(int argc, FAR char *argv[])
+{
+  FAR struct netdev_rxqueue_s *rxq = (FAR struct netdev_rxqueue_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct netdev_lowerhalf_s *lower = rxq->upper->lower;
+  FAR struct net_driver_s *dev = &lower->netdev;
+  FAR netpkt_t *batch[CONFIG_NETDEV_RXQUEUE_BATCH];
+  int npkts;
+  int i;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&rxq->sem);
+      if (rxq->stop)
+        {
+          break;
+        }
+
+      do
+        {
+          for (npkts = 0; npkts < CONFIG_NETDEV_RXQUEUE_BATCH; npkts++)
+            {
+              batch[npkts] = lower->ops->receiveq(lower, rxq->queue);
+              if (batch[npkts] == NULL)
+                {
+                  break;
+                }
+            }
+
+          if (npkts > 0)
+            {
+              net_lock();
+              netdev_lock(dev);
+
+              for (i = 0; i < npkts; i++)
+                {
+                  netdev_upper_rxpkt(lower, batch[i]);
+                }
+
+              netdev_unlock(dev);
+              net_unlock();
+            }
+        }
+      while (npkts == CONFIG_NETDEV_RXQUEUE_BATCH);
+    }
+
+  nxsem_post(&rxq->done);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxqueue_start / netdev_upper_rxqueue_stop
+ *
+ * Description:
+ *   Start or stop the threads that drain the RX queues of a multi-queue
+ *   device.  With SMP, queue N is processed on CPU N modulo the number of
+ *   CPUs until netdev_lower_rxqueue_affinity() says otherwise.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxqueue_stop(FAR struct netdev_upperhalf_s *upper,
+                                      int nqueues)
+{
+  FAR struct netdev_rxqueue_s *rxq;
+  int i;
+
+  for (i = 0; i < nqueues; i++)
+    {
+      rxq = &upper->rxq[i];
+      rxq->stop = true;
+      nxsem_post(&rxq->sem);
+      nxsem_wait_uninterruptible(&rxq->done);
+
+      nxsem_destroy(&rxq->sem);
+      nxsem_destroy(&rxq->done);
+    }
+}
+
+static int netdev_upper_rxqueue_start(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct netdev_rxqueue_s *rxq;
+  FAR char *argv[2];
+  char arg1[32];
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+  int ret;
+  int i;
+
+  for (i = 0; i < lower->rxqueues; i++)
+    {
+      rxq        = &upper->rxq[i];
+      rxq->upper = upper;
+      rxq->queue = i;
+
+      nxsem_init(&rxq->sem, 0, 0);
+      nxsem_init(&rxq->done, 0, 0);
+
+      snprintf(arg1, sizeof(arg1), "%p", rxq);
+      argv[0] = arg1;
+      argv[1] = NULL;
+
+      ret = kthread_create("netdev_rxq", CONFIG_NETDEV_RXQUEUE_PRIORITY,
+                           CONFIG_NETDEV_RXQUEUE_STACKSIZE,
+                           netdev_upper_rxqueue_thread, argv);
+      if (ret < 0)
+        {
+          nerr("ERROR: Failed to start RX queue %d: %d\n", i, ret);
+          nxsem_destroy(&rxq->sem);
+          nxsem_destroy(&rxq->done);
+          netdev_upper_rxqueue_stop(upper, i);
+          return ret;
+        }
+
+      rxq->pid = ret;
+
+#ifdef CONFIG_SMP
+      CPU_ZERO(&cpuset);
+      CPU_SET(i % CONFIG_SMP_NCPUS, &cpuset);
+      nxsched_set_affinity(rxq->pid, sizeof(cpu_set_t), &cpuset);
+#endif
+    }
+
+  return OK;
+}
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
+
+/****************************************************************************
+ * Name: netdev_upper_ifup / netdev_upper_ifdown / netdev_upper_txavail
+ ****************************************************************************/
+
+static int netdev_upper_ifup(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_lowerhalf_s *lower = NETDEV_LOWER(dev);
+
+  if (lower->ops->ifup != NULL)
+    {
+      return lower->ops->ifup(lower);
+    }
+
+  return OK;
+}
+
+static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_lowerhalf_s *lower = NETDEV_LOWER(dev);
+  FAR struct netdev_upperhalf_s *upper = lower->upper;
+
+  work_cancel(LPWORK, &upper->txwork);
+  work_cancel(LPWORK, &upper->rxwork);
+
+  if (lower->ops->ifdown != NULL)
+    {
+      return lower->ops->ifdown(lower);
+    }
+
+  return OK;
+}
+
+static int netdev_upper_txavail(FAR struct net_driver_s *dev)
+{
+  netdev_lower_txdone(NETDEV_LOWER(dev));
+  return OK;
+}
+
+#ifdef CONFIG_NET_MCASTGROUP
+static int netdev_upper_addmac(FAR struct net_driver_s *dev,
+                               FAR const uint8_t *mac)
+{
+  FAR struct netdev_lowerhalf_s *lower = NETDEV_LOWER(dev);
+
+  if (lower->ops->addmac != NULL)
+    {
+      return lower->ops->addmac(lower, mac);
+    }
+
+  return -ENOSYS;
+}
+
+static int netdev_upper_rmmac(FAR struct net_driver_s *dev,
+                              FAR const uint8_t *mac)
+{
+  FAR struct netdev_lowerhalf_s *lower = NETDEV_LOWER(dev);
+
+  if (lower->ops->rmmac != NULL)
+    {
+      return lower->ops->rmmac(lower, mac);
+    }
+
+  return -ENOSYS;
+}
+#endif
+
+#ifdef CONFIG_NETDEV_IOCTL
+static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
+                              unsigned long arg)
+{
+  FAR struct netdev_lowerhalf_s *lower = NETDEV_LOWER(dev);
+
+  if (lower->ops->ioctl != NULL)
+    {
+      return lower->ops->ioctl(lower, cmd, arg);
+    }
+
+  return -ENOTTY;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_lower_register
+ *
+ * Description:
+ *   Register a lower-half network driver with the network stack.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   lltype - Link level protocol used by the driver (Ethernet, TUN, ...)
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure
+ *
+ ****************************************************************************/
+
+int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
+                          enum net_lltype_e lltype)
+{
+  FAR struct netdev_upperhalf_s *upper;
+  int ret;
+
+  if (dev == NULL || dev->ops == NULL || dev->ops->transmit == NULL ||
+      dev->ops->receive == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->rxqueues > CONFIG_NETDEV_MAX_RXQUEUES ||
+      (dev->rxqueues > 1 && dev->ops->receiveq == NULL))
+    {
+      return -EINVAL;
+    }
+
+  netdev_lower_rss_init(dev);
+#endif
+
+  upper = kmm_zalloc(sizeof(struct netdev_upperhalf_s));
+  if (upper == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->lower = dev;
+  dev->upper   = upper;
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->rxqueues > 1)
+    {
+      ret = netdev_upper_rxqueue_start(upper);
+      if (ret < 0)
+        {
+          dev->upper = NULL;
+          kmm_free(upper);
+          return ret;
+        }
+    }
+#endif
+
+  dev->netdev.d_buf     = NULL;
+  dev->netdev.d_ifup    = netdev_upper_ifup;
+  dev->netdev.d_ifdown  = netdev_upper_ifdown;
+  dev->netdev.d_txavail = netdev_upper_txavail;
+#ifdef CONFIG_NET_MCASTGROUP
+  dev->netdev.d_addmac  = netdev_upper_addmac;
+  dev->netdev.d_rmmac   = netdev_upper_rmmac;
+#endif
+#ifdef CONFIG_NETDEV_IOCTL
+  dev->netdev.d_ioctl   = netdev_upper_ioctl;
+#endif
+#ifdef CONFIG_NETDEV_RXFILTER
+  dev->netdev.d_xmit    = netdev_upper_xmit;
+#endif
+
+  ret = netdev_register(&dev->netdev, lltype);
+  if (ret < 0)
+    {
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      if (dev->rxqueues > 1)
+        {
+          netdev_upper_rxqueue_stop(upper, dev->rxqueues);
+        }
+#endif
+
+      dev->upper = NULL;
+      kmm_free(upper);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_lower_unregister
+ *
+ * Description:
+ *   Unregister a lower-half network driver.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure
+ *
+ ****************************************************************************/
+
+int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper;
+  int ret;
+
+  if (dev == NULL || dev->upper == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = netdev_unregister(&dev->netdev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  upper = dev->upper;
+  work_cancel(LPWORK, &upper->txwork);
+  work_cancel(LPWORK, &upper->rxwork);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->rxqueues > 1)
+    {
+      netdev_upper_rxqueue_stop(upper, dev->rxqueues);
+    }
+#endif
+
+  dev->upper = NULL;
+  kmm_free(upper);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_lower_carrier_on / netdev_lower_carrier_off
+ *
+ * Description:
+ *   Notify the network stack of a change of the link state.
+ *
+ ****************************************************************************/
+
+void netdev_lower_carrier_on(FAR struct netdev_lowerhalf_s *dev)
+{
+  netdev_carrier_on(&dev->netdev);
+}
+
+void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
+{
+  netdev_carrier_off(&dev->netdev);
+}
+
+/****************************************************************************
+ * Name: netdev_lower_rxready
+ *
+ * Description:
+ *   Notify the upper half that received frames are available.
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->upper;
+
+  if (work_available(&upper->rxwork))
+    {
+      work_queue(LPWORK, &upper->rxwork, netdev_upper_rxwork, upper, 0);
+    }
+}
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/****************************************************************************
+ * Name: netdev_lower_rxqueue_ready
+ *
+ * Description:
+ *   Notify the upper half that frames were received on an RX queue.  A
+ *   device with a single queue is served by the work queue as with
+ *   netdev_lower_rxready().
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxqueue_ready(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->upper;
+  int semcount;
+
+  if (dev->rxqueues <= 1)
+    {
+      netdev_lower_rxready(dev);
+      return;
+    }
+
+  DEBUGASSERT(queue >= 0 && queue < dev->rxqueues);
+
+  /* One pending wakeup is enough, the thread drains the whole queue */
+
+  if (nxsem_get_value(&upper->rxq[queue].sem, &semcount) >= 0 &&
+      semcount <= 0)
+    {
+      nxsem_post(&upper->rxq[queue].sem);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_lower_rxqueue_affinity
+ *
+ * Description:
+ *   Bind the thread that processes an RX queue to a set of CPUs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int netdev_lower_rxqueue_affinity(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue, FAR const cpu_set_t *cpuset)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->upper;
+
+  if (upper == NULL || dev->rxqueues <= 1 || queue < 0 ||
+      queue >= dev->rxqueues)
+    {
+      return -EINVAL;
+    }
+
+  return nxsched_set_affinity(upper->rxq[queue].pid, sizeof(cpu_set_t),
+                              cpuset);
+}
+#endif
+#endif /* CONFIG_NETDEV_MULTIQUEUE */
+
+/****************************************************************************
+ * Name: netdev_lower_txdone
+ *
+ * Description:
+ *   Notify the upper half that more frames may be queued.
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->upper;
+
+  if (work_available(&upper->txwork))
+    {
+      work_queue(LPWORK, &upper->txwork, netdev_upper_txavail_work,
+                 upper, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: netpkt_alloc
+ *
+ * Description:
+ *   Allocate an empty packet with headroom for the guard area.
+ *
+ ****************************************************************************/
+
+FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
+                           enum netpkt_type_e type)
+{
+  FAR netpkt_t *pkt;
+
+  if (!netpkt_quota_take(dev, type))
+    {
+      return NULL;
+    }
+
+  pkt = iob_tryalloc(false);
+  if (pkt == NULL)
+    {
+      netpkt_quota_give(dev, type);
+      return NULL;
+    }
+
+  iob_reserve(pkt, CONFIG_NET_LL_GUARDSIZE - NET_LL_HDRLEN(&dev->netdev));
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: netpkt_alloc_ext
+ *
+ * Description:
+ *   Wrap a frame in a DMA buffer of the driver into a packet whose IOBs
+ *   reference the consecutive slices of the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTERNAL
+FAR netpkt_t *netpkt_alloc_ext(FAR struct netdev_lowerhalf_s *dev,
+                               FAR struct iob_ext_s *ext,
+                               FAR uint8_t *buf, size_t size,
+                               unsigned int len)
+{
+  FAR netpkt_t *pkt = NULL;
+  FAR netpkt_t *iob;
+  unsigned int headroom = NETPKT_HEADROOM(dev);
+  unsigned int nslices;
+  unsigned int i;
+
+  /* Every slice is a full IOB, the last one included, since the stack may
+   * append to it.
+   */
+
+  nslices = (headroom + len + NETPKT_BUFLEN - 1) / NETPKT_BUFLEN;
+  if (nslices * NETPKT_BUFLEN > size || !netpkt_quota_take(dev, NETPKT_RX))
+    {
+      return NULL;
+    }
+
+  /* Get all of the IOBs first, so that the buffer is not given back to
+   * the driver if there are not enough of them.
+   */
+
+  for (i = 0; i < nslices; i++)
+    {
+      iob = iob_tryalloc(false);
+      if (iob == NULL)
+        {
+          iob_free_chain(pkt);
+          netpkt_quota_give(dev, NETPKT_RX);
+          return NULL;
+        }
+
+      iob->io_flink = pkt;
+      pkt = iob;
+    }
+
+  /* The chain was built backwards, so the slices are attached backwards */
+
+  for (iob = pkt; iob != NULL; iob = iob->io_flink)
+    {
+      iob_ext_attach(iob, ext, buf + --nslices * NETPKT_BUFLEN);
+    }
+
+  iob_reserve(pkt, headroom);
+  iob_update_pktlen(pkt, len);
+  return pkt;
+}
+#endif
+
+/****************************************************************************
+ * Name: netpkt_free
+ ****************************************************************************/
+
+void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                 enum netpkt_type_e type)
+{
+  iob_free_chain(pkt);
+  netpkt_quota_give(dev, type);
+}
+
+/****************************************************************************
+ * Name: netpkt_copyin / netpkt_copyout
+ ****************************************************************************/
+
+int netpkt_copyin(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                  FAR const uint8_t *src, unsigned int len, int offset)
+{
+  return iob_trycopyin(pkt, src, len, offset, false);
+}
+
+int netpkt_copyout(FAR struct netdev_lowerhalf_s *dev, FAR uint8_t *dest,
+                   FAR const netpkt_t *pkt, unsigned int len, int offset)
+{
+  return iob_copyout(dest, pkt, len, offset);
+}
+
+/****************************************************************************
+ * Name: netpkt_getdata / netpkt_getdatalen / netpkt_setdatalen
+ ****************************************************************************/
+
+FAR uint8_t *netpkt_getdata(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt)
+{
+  return IOB_DATA(pkt);
+}
+
+unsigned int netpkt_getdatalen(FAR struct netdev_lowerhalf_s *dev,
+                               FAR netpkt_t *pkt)
+{
+  return pkt->io_pktlen;
+}
+
+void netpkt_setdatalen(FAR struct netdev_lowerhalf_s *dev,
+                       FAR netpkt_t *pkt, unsigned int len)
+{
+  iob_update_pktlen(pkt, len);
+}
+
+/****************************************************************************
+ * Name: netpkt_is_fragmented
+ ****************************************************************************/
+
+bool netpkt_is_fragmented(FAR netpkt_t *pkt)
+{
+  return pkt->io_flink != NULL;
+}
+
+/****************************************************************************
+ * Name: netpkt_to_iov
+ *
+ * Description:
+ *   Describe the buffers of a frame with an array of iovecs.
+ *
+ ****************************************************************************/
+
+int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                  FAR struct iovec *iov, int iovcnt)
+{
+  int i = 0;
+
+  for (; pkt != NULL; pkt = pkt->io_flink)
+    {
+      if (pkt->io_len == 0)
+        {
+          continue;
+        }
+
+      if (i >= iovcnt)
+        {
+          return -E2BIG;
+        }
+
+      iov[i].iov_base = IOB_DATA(pkt);
+      iov[i].iov_len  = pkt->io_len;
+      i++;
+    }
+
+  return i;
+}
+
+#endif /* CONFIG_NETDEV_LOWERHALF */
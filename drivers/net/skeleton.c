@@ -330,6 +330,15 @@ static void skel_receive(FAR struct skel_driver_s *priv)
        * amount of data in priv->sk_dev.d_len
        */
 
+      /* Let the early receive filters drop or redirect the frame before
+       * the network stack processes it.
+       */
+
+      if (netdev_rxfilter(&priv->sk_dev))
+        {
+          continue;
+        }
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
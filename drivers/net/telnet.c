@@ -26,6 +26,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 #include <poll.h>
 #include <errno.h>
@@ -330,6 +331,46 @@ static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
     }
 }
 
+/****************************************************************************
+ * Name: telnet_getrun
+ *
+ * Description:
+ *   Copy a run of plain data, which holds no IAC, to the user buffer in
+ *   one go instead of character by character.
+ *
+ ****************************************************************************/
+
+static void telnet_getrun(FAR const char *src, size_t len,
+                          FAR char *dest, int *nread)
+{
+#ifdef CONFIG_TELNET_CHARACTER_MODE
+  memcpy(dest + *nread, src, len);
+  *nread += len;
+#else
+  FAR const char *cr;
+  size_t n;
+
+  /* Ignore carriage returns */
+
+  while (len > 0)
+    {
+      cr = memchr(src, TELNET_CR, len);
+      n  = cr != NULL ? cr - src : len;
+
+      memcpy(dest + *nread, src, n);
+      *nread += n;
+
+      if (cr != NULL)
+        {
+          n++;
+        }
+
+      src += n;
+      len -= n;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: telnet_receive
  *
@@ -342,14 +383,34 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                               FAR const char *src, size_t srclen,
                               FAR char *dest, size_t destlen)
 {
-  int nread;
+  FAR const char *iac;
+  size_t n;
+  int nread = 0;
   uint8_t ch;
 
   ninfo("srclen: %zd destlen: %zd\n", srclen, destlen);
 
-  for (nread = 0; srclen > 0 && nread < destlen; srclen--)
+  while (srclen > 0 && nread < destlen)
     {
+      /* Fast path:  Copy the plain data up to the next IAC at once */
+
+      if (priv->td_state == STATE_NORMAL && (uint8_t)*src != TELNET_IAC)
+        {
+          n   = srclen < destlen - nread ? srclen : destlen - nread;
+          iac = memchr(src, TELNET_IAC, n);
+          if (iac != NULL)
+            {
+              n = iac - src;
+            }
+
+          telnet_getrun(src, n, dest, &nread);
+          src    += n;
+          srclen -= n;
+          continue;
+        }
+
       ch = *src++;
+      srclen--;
       ninfo("ch=%02x state=%d\n", ch, priv->td_state);
 
       switch (priv->td_state)
@@ -825,39 +886,28 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode = filep->f_inode;
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
+  FAR const char *p;
   ssize_t ret = 0;
   ssize_t nsent;
+  size_t n;
   int ncopied;
-  char ch;
-  bool eol;
 
   ninfo("len: %zd\n", len);
 
-  /* Process each character from the user buffer */
-
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+  for (nsent = 0, ncopied = 0; nsent < len; )
     {
-      /* Get the next character from the user buffer */
-
-      ch = *src++;
-
-      /* Add the character to the TX buffer */
-
-      eol = telnet_putchar(priv, ch, &ncopied);
-
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n")?
+      /* Is the buffer too full to hold the next largest character sequence
+       * ("\r\n")?
        */
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 2)
+      if (ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 2)
         {
           /* Yes... send the data now */
 
           ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
           if (ret < 0)
             {
-              nerr("ERROR: psock_send failed '%s': %zd\n",
-                   priv->td_txbuffer, ret);
+              nerr("ERROR: psock_send failed: %zd\n", ret);
               goto out;
             }
 
@@ -865,6 +915,57 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
 
           ncopied = 0;
         }
+
+      /* Find the run of characters up to the next one to translate */
+
+      n = len - nsent;
+      p = memchr(src, TELNET_NL, n);
+      if (p != NULL)
+        {
+          n = p - src;
+        }
+
+      p = memchr(src, TELNET_CR, n);
+      if (p != NULL)
+        {
+          n = p - src;
+        }
+
+      if (n == 0)
+        {
+          /* Add the translated character to the TX buffer */
+
+          telnet_putchar(priv, *src++, &ncopied);
+          nsent++;
+        }
+      else if (ncopied == 0 && n >= CONFIG_TELNET_TXBUFFER_SIZE)
+        {
+          /* Send a long run from the user buffer without copying it */
+
+          ret = psock_send(&priv->td_psock, src, n, 0);
+          if (ret < 0)
+            {
+              nerr("ERROR: psock_send failed: %zd\n", ret);
+              goto out;
+            }
+
+          src   += ret;
+          nsent += ret;
+        }
+      else
+        {
+          /* Add the run to the TX buffer */
+
+          if (n > CONFIG_TELNET_TXBUFFER_SIZE - ncopied)
+            {
+              n = CONFIG_TELNET_TXBUFFER_SIZE - ncopied;
+            }
+
+          memcpy(&priv->td_txbuffer[ncopied], src, n);
+          ncopied += n;
+          src     += n;
+          nsent   += n;
+        }
     }
 
   /* Send anything remaining in the TX buffer */
@@ -874,8 +975,7 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer,
       ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
       if (ret < 0)
         {
-          nerr("ERROR: psock_send failed '%s': %zd\n",
-               priv->td_txbuffer, ret);
+          nerr("ERROR: psock_send failed: %zd\n", ret);
           goto out;
         }
     }
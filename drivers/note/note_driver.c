@@ -33,6 +33,7 @@
 #include <time.h>
 
 #include <nuttx/irq.h>
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/spinlock.h>
@@ -138,10 +139,12 @@ static void note_common(FAR struct tcb_s *tcb,
                         FAR struct note_common_s *note,
                         uint8_t length, uint8_t type)
 {
-#ifdef CONFIG_SCHED_INSTRUMENTATION_HIRES
+#if defined(CONFIG_SCHED_INSTRUMENTATION_HIRES)
   struct timespec ts;
 
   clock_systime_timespec(&ts);
+#elif defined(CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT)
+  clock_t systime = up_perf_gettime();
 #else
   clock_t systime = clock_systime_ticks();
 #endif
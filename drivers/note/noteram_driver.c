@@ -25,28 +25,51 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <sched.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/fs/fs.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With CONFIG_DRIVER_NOTERAM_PERCPU, each CPU adds its notes to a ring of
+ * its own, so that the writers never contend with each other.  The reader
+ * merges the rings in time stamp order.
+ */
+
+#ifdef CONFIG_DRIVER_NOTERAM_PERCPU
+#  define NOTERAM_NRINGS CONFIG_SMP_NCPUS
+#else
+#  define NOTERAM_NRINGS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
 struct noteram_info_s
 {
-  unsigned int ni_overwrite;
+  volatile bool ni_overflow;   /* Full while overwrite is disabled */
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
+#ifdef CONFIG_SMP
+  volatile spinlock_t ni_lock; /* Serializes the writer with the reader */
+#endif
   uint8_t ni_buffer[CONFIG_DRIVER_NOTERAM_BUFSIZE];
 };
 
@@ -92,21 +115,37 @@ static const struct file_operations g_noteram_fops =
 #endif
 };
 
-static struct noteram_info_s g_noteram_info =
-{
 #ifdef CONFIG_DRIVER_NOTERAM_DEFAULT_NOOVERWRITE
-  NOTERAM_MODE_OVERWRITE_DISABLE
+static unsigned int g_noteram_mode = NOTERAM_MODE_OVERWRITE_DISABLE;
 #else
-  NOTERAM_MODE_OVERWRITE_ENABLE
+static unsigned int g_noteram_mode = NOTERAM_MODE_OVERWRITE_ENABLE;
 #endif
-};
+
+static struct noteram_info_s g_noteram_info[NOTERAM_NRINGS];
 
 #if CONFIG_DRIVER_NOTERAM_TASKNAME_BUFSIZE > 0
 static struct noteram_taskname_s g_noteram_taskname;
+
+/* The task names are shared by the writers of all rings */
+
+#ifdef CONFIG_DRIVER_NOTERAM_PERCPU
+static volatile spinlock_t g_noteram_tasklock;
+#  define noteram_tasklock()   spin_lock_wo_note(&g_noteram_tasklock)
+#  define noteram_taskunlock() spin_unlock_wo_note(&g_noteram_tasklock)
+#else
+#  define noteram_tasklock()
+#  define noteram_taskunlock()
 #endif
+#endif
+
+/* The ring locks are only taken with interrupts disabled */
 
 #ifdef CONFIG_SMP
-static volatile spinlock_t g_noteram_lock;
+#  define noteram_lock(ni)     spin_lock_wo_note(&(ni)->ni_lock)
+#  define noteram_unlock(ni)   spin_unlock_wo_note(&(ni)->ni_lock)
+#else
+#  define noteram_lock(ni)
+#  define noteram_unlock(ni)
 #endif
 
 /****************************************************************************
@@ -256,6 +295,7 @@ static const char *noteram_get_taskname(pid_t pid)
   FAR struct tcb_s *tcb;
 
   irq_mask = enter_critical_section();
+  noteram_tasklock();
 
   ti = noteram_find_taskname(pid);
   if (ti != NULL)
@@ -272,6 +312,7 @@ static const char *noteram_get_taskname(pid_t pid)
         }
     }
 
+  noteram_taskunlock();
   leave_critical_section(irq_mask);
   return ret;
 }
@@ -293,20 +334,24 @@ static const char *noteram_get_taskname(pid_t pid)
 
 static void noteram_buffer_clear(void)
 {
+  FAR struct noteram_info_s *ni;
   irqstate_t flags;
 
   flags = enter_critical_section();
 
-  g_noteram_info.ni_tail = g_noteram_info.ni_head;
-  g_noteram_info.ni_read = g_noteram_info.ni_head;
-
-  if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+  for (ni = g_noteram_info; ni < &g_noteram_info[NOTERAM_NRINGS]; ni++)
     {
-      g_noteram_info.ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
+      noteram_lock(ni);
+      ni->ni_tail     = ni->ni_head;
+      ni->ni_read     = ni->ni_head;
+      ni->ni_overflow = false;
+      noteram_unlock(ni);
     }
 
 #if CONFIG_DRIVER_NOTERAM_TASKNAME_BUFSIZE > 0
+  noteram_tasklock();
   g_noteram_taskname.buffer_used = 0;
+  noteram_taskunlock();
 #endif
 
   leave_critical_section(flags);
@@ -346,17 +391,17 @@ static inline unsigned int noteram_next(unsigned int ndx,
  *   Length of data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   Length of data currently in circular buffer.
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(void)
+static unsigned int noteram_length(FAR struct noteram_info_s *ni)
 {
-  unsigned int head = g_noteram_info.ni_head;
-  unsigned int tail = g_noteram_info.ni_tail;
+  unsigned int head = ni->ni_head;
+  unsigned int tail = ni->ni_tail;
 
   if (tail > head)
     {
@@ -373,17 +418,17 @@ static unsigned int noteram_length(void)
  *   Length of unread data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   Length of unread data currently in circular buffer.
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(void)
+static unsigned int noteram_unread_length(FAR struct noteram_info_s *ni)
 {
-  unsigned int head = g_noteram_info.ni_head;
-  unsigned int read = g_noteram_info.ni_read;
+  unsigned int head = ni->ni_head;
+  unsigned int read = ni->ni_read;
 
   if (read > head)
     {
@@ -400,7 +445,7 @@ static unsigned int noteram_unread_length(void)
  *   Remove the variable length note from the tail of the circular buffer
  *
  * Input Parameters:
- *   None
+ *   ni - The circular buffer
  *
  * Returned Value:
  *   None
@@ -410,23 +455,23 @@ static unsigned int noteram_unread_length(void)
  *
  ****************************************************************************/
 
-static void noteram_remove(void)
+static void noteram_remove(FAR struct noteram_info_s *ni)
 {
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = g_noteram_info.ni_tail;
+  tail = ni->ni_tail;
   DEBUGASSERT(tail < CONFIG_DRIVER_NOTERAM_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  length = g_noteram_info.ni_buffer[tail];
-  DEBUGASSERT(length <= noteram_length());
+  length = ni->ni_buffer[tail];
+  DEBUGASSERT(length <= noteram_length(ni));
 
 #if CONFIG_DRIVER_NOTERAM_TASKNAME_BUFSIZE > 0
-  if (g_noteram_info.ni_buffer[noteram_next(tail, 1)] == NOTE_STOP)
+  if (ni->ni_buffer[noteram_next(tail, 1)] == NOTE_STOP)
     {
       uint8_t nc_pid[2];
 
@@ -435,14 +480,16 @@ static void noteram_remove(void)
        */
 
 #ifdef CONFIG_SMP
-      nc_pid[0] = g_noteram_info.ni_buffer[noteram_next(tail, 4)];
-      nc_pid[1] = g_noteram_info.ni_buffer[noteram_next(tail, 5)];
+      nc_pid[0] = ni->ni_buffer[noteram_next(tail, 4)];
+      nc_pid[1] = ni->ni_buffer[noteram_next(tail, 5)];
 #else
-      nc_pid[0] = g_noteram_info.ni_buffer[noteram_next(tail, 3)];
-      nc_pid[1] = g_noteram_info.ni_buffer[noteram_next(tail, 4)];
+      nc_pid[0] = ni->ni_buffer[noteram_next(tail, 3)];
+      nc_pid[1] = ni->ni_buffer[noteram_next(tail, 4)];
 #endif
 
+      noteram_tasklock();
       noteram_remove_taskname(nc_pid[0] + (nc_pid[1] << 8));
+      noteram_taskunlock();
     }
 #endif
 
@@ -450,14 +497,111 @@ static void noteram_remove(void)
    * buffer.
    */
 
-  if (g_noteram_info.ni_read == g_noteram_info.ni_tail)
+  if (ni->ni_read == ni->ni_tail)
     {
       /* The read index also needs increment. */
 
-      g_noteram_info.ni_read = noteram_next(tail, length);
+      ni->ni_read = noteram_next(tail, length);
+    }
+
+  ni->ni_tail = noteram_next(tail, length);
+}
+
+/****************************************************************************
+ * Name: noteram_timestamp
+ *
+ * Description:
+ *   Return the time stamp of the note at index ndx of the circular buffer
+ *   ni.  The note may wrap around the end of the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVER_NOTERAM_PERCPU
+static uint64_t noteram_field(FAR struct noteram_info_s *ni,
+                              unsigned int ndx, size_t offset, size_t len)
+{
+  uint64_t value = 0;
+
+  /* The fields of the notes are saved in little endian order */
+
+  ndx = noteram_next(ndx, offset + len);
+  while (len-- > 0)
+    {
+      ndx = ndx > 0 ? ndx - 1 : CONFIG_DRIVER_NOTERAM_BUFSIZE - 1;
+      value = (value << 8) | ni->ni_buffer[ndx];
+    }
+
+  return value;
+}
+
+static uint64_t noteram_timestamp(FAR struct noteram_info_s *ni,
+                                  unsigned int ndx)
+{
+#ifdef CONFIG_SCHED_INSTRUMENTATION_HIRES
+  return noteram_field(ni, ndx,
+                       offsetof(struct note_common_s, nc_systime_sec),
+                       sizeof(time_t)) * NSEC_PER_SEC +
+         noteram_field(ni, ndx,
+                       offsetof(struct note_common_s, nc_systime_nsec),
+                       sizeof(long));
+#else
+  return noteram_field(ni, ndx,
+                       offsetof(struct note_common_s, nc_systime),
+                       sizeof(clock_t));
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: noteram_oldest
+ *
+ * Description:
+ *   Select the circular buffer that holds the oldest unread note.  The
+ *   unread notes of each buffer are in time order, so this merges the per-
+ *   CPU buffers into one stream.
+ *
+ * Returned Value:
+ *   The selected buffer; NULL if there are no unread notes.
+ *
+ ****************************************************************************/
+
+static FAR struct noteram_info_s *noteram_oldest(void)
+{
+#ifdef CONFIG_DRIVER_NOTERAM_PERCPU
+  FAR struct noteram_info_s *oldest = NULL;
+  FAR struct noteram_info_s *ni;
+  uint64_t oldtime = 0;
+  uint64_t time;
+
+  for (ni = g_noteram_info; ni < &g_noteram_info[NOTERAM_NRINGS]; ni++)
+    {
+      if (noteram_unread_length(ni) == 0)
+        {
+          continue;
+        }
+
+      /* Compare the differences so that the comparison survives the wrap
+       * of the time stamps.
+       */
+
+      time = noteram_timestamp(ni, ni->ni_read);
+#if defined(CONFIG_SCHED_INSTRUMENTATION_HIRES)
+      if (oldest == NULL || (int64_t)(time - oldtime) < 0)
+#elif defined(CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT)
+      if (oldest == NULL || (int32_t)(uint32_t)(time - oldtime) < 0)
+#else
+      if (oldest == NULL || (sclock_t)(clock_t)(time - oldtime) < 0)
+#endif
+        {
+          oldest  = ni;
+          oldtime = time;
+        }
     }
 
-  g_noteram_info.ni_tail = noteram_next(tail, length);
+  return oldest;
+#else
+  return noteram_unread_length(g_noteram_info) > 0 ? g_noteram_info : NULL;
+#endif
 }
 
 /****************************************************************************
@@ -479,6 +623,7 @@ static void noteram_remove(void)
 
 static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
 {
+  FAR struct noteram_info_s *ni;
   FAR struct note_common_s *note;
   irqstate_t flags;
   unsigned int remaining;
@@ -489,9 +634,20 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
   DEBUGASSERT(buffer != NULL);
   flags = enter_critical_section();
 
+  /* Select the circular buffer with the oldest unread note */
+
+  ni = noteram_oldest();
+  if (ni == NULL)
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  noteram_lock(ni);
+
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length();
+  circlen = noteram_unread_length(ni);
   if (circlen <= 0)
     {
       notelen = 0;
@@ -500,12 +656,12 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
 
   /* Get the read index of the circular buffer */
 
-  read    = g_noteram_info.ni_read;
+  read    = ni->ni_read;
   DEBUGASSERT(read < CONFIG_DRIVER_NOTERAM_BUFSIZE);
 
   /* Get the length of the note at the read index */
 
-  note    = (FAR struct note_common_s *)&g_noteram_info.ni_buffer[read];
+  note    = (FAR struct note_common_s *)&ni->ni_buffer[read];
   notelen = note->nc_length;
   DEBUGASSERT(notelen <= circlen);
 
@@ -515,7 +671,7 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Skip the large note so that we do not get constipated. */
 
-      g_noteram_info.ni_read = noteram_next(read, notelen);
+      ni->ni_read = noteram_next(read, notelen);
 
       /* and return an error */
 
@@ -530,7 +686,7 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Copy the next byte at the read index */
 
-      *buffer++ = g_noteram_info.ni_buffer[read];
+      *buffer++ = ni->ni_buffer[read];
 
       /* Adjust indices and counts */
 
@@ -538,9 +694,10 @@ static ssize_t noteram_get(FAR uint8_t *buffer, size_t buflen)
       remaining--;
     }
 
-  g_noteram_info.ni_read = read;
+  ni->ni_read = read;
 
 errout_with_csection:
+  noteram_unlock(ni);
   leave_critical_section(flags);
   return notelen;
 }
@@ -563,6 +720,7 @@ errout_with_csection:
 
 static ssize_t noteram_size(void)
 {
+  FAR struct noteram_info_s *ni;
   FAR struct note_common_s *note;
   irqstate_t flags;
   unsigned int read;
@@ -571,9 +729,20 @@ static ssize_t noteram_size(void)
 
   flags = enter_critical_section();
 
+  /* Select the circular buffer with the oldest unread note */
+
+  ni = noteram_oldest();
+  if (ni == NULL)
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  noteram_lock(ni);
+
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length();
+  circlen = noteram_unread_length(ni);
   if (circlen <= 0)
     {
       notelen = 0;
@@ -582,16 +751,17 @@ static ssize_t noteram_size(void)
 
   /* Get the read index of the circular buffer */
 
-  read = g_noteram_info.ni_read;
+  read = ni->ni_read;
   DEBUGASSERT(read < CONFIG_DRIVER_NOTERAM_BUFSIZE);
 
   /* Get the length of the note at the read index */
 
-  note    = (FAR struct note_common_s *)&g_noteram_info.ni_buffer[read];
+  note    = (FAR struct note_common_s *)&ni->ni_buffer[read];
   notelen = note->nc_length;
   DEBUGASSERT(notelen <= circlen);
 
 errout_with_csection:
+  noteram_unlock(ni);
   leave_critical_section(flags);
   return notelen;
 }
@@ -602,9 +772,14 @@ errout_with_csection:
 
 static int noteram_open(FAR struct file *filep)
 {
-  /* Reset the read index of the circular buffer */
+  FAR struct noteram_info_s *ni;
+
+  /* Reset the read index of the circular buffer(s) */
 
-  g_noteram_info.ni_read = g_noteram_info.ni_tail;
+  for (ni = g_noteram_info; ni < &g_noteram_info[NOTERAM_NRINGS]; ni++)
+    {
+      ni->ni_read = ni->ni_tail;
+    }
 
   return OK;
 }
@@ -675,6 +850,8 @@ static ssize_t noteram_read(FAR struct file *filep,
 
 static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct noteram_info_s *ni;
+  unsigned int mode;
   int ret = -ENOSYS;
 
   /* Handle the ioctl commands */
@@ -703,7 +880,19 @@ static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
-            *(unsigned int *)arg = g_noteram_info.ni_overwrite;
+            /* Report an overflow if any of the buffers is full */
+
+            mode = g_noteram_mode;
+            for (ni = g_noteram_info; ni < &g_noteram_info[NOTERAM_NRINGS];
+                 ni++)
+              {
+                if (ni->ni_overflow)
+                  {
+                    mode = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+                  }
+              }
+
+            *(unsigned int *)arg = mode;
             ret = OK;
           }
         break;
@@ -720,7 +909,17 @@ static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
-            g_noteram_info.ni_overwrite = *(unsigned int *)arg;
+            /* Setting the overflow mode stops recording */
+
+            mode = *(unsigned int *)arg;
+            g_noteram_mode = mode == NOTERAM_MODE_OVERWRITE_OVERFLOW ?
+                             NOTERAM_MODE_OVERWRITE_DISABLE : mode;
+            for (ni = g_noteram_info; ni < &g_noteram_info[NOTERAM_NRINGS];
+                 ni++)
+              {
+                ni->ni_overflow = mode == NOTERAM_MODE_OVERWRITE_OVERFLOW;
+              }
+
             ret = OK;
           }
         break;
@@ -792,21 +991,27 @@ static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg)
 
 void sched_note_add(FAR const void *note, size_t notelen)
 {
+  FAR struct noteram_info_s *ni;
   FAR const char *buf = note;
   unsigned int head;
   unsigned int next;
   irqstate_t flags;
 
   flags = up_irq_save();
-#ifdef CONFIG_SMP
-  spin_lock_wo_note(&g_noteram_lock);
+
+  /* Each CPU only contends with the reader for the lock of its own ring */
+
+#ifdef CONFIG_DRIVER_NOTERAM_PERCPU
+  ni = &g_noteram_info[up_cpu_index()];
+#else
+  ni = g_noteram_info;
 #endif
 
-  if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+  noteram_lock(ni);
+
+  if (ni->ni_overflow)
     {
-#ifdef CONFIG_SMP
-      spin_unlock_wo_note(&g_noteram_lock);
-#endif
+      noteram_unlock(ni);
       up_irq_restore(flags);
       return;
     }
@@ -820,9 +1025,11 @@ void sched_note_add(FAR const void *note, size_t notelen)
       note_st = (FAR struct note_start_s *)note;
       if (note_st->nst_cmn.nc_type == NOTE_START)
         {
+          noteram_tasklock();
           noteram_record_taskname(note_st->nst_cmn.nc_pid[0] +
                                   (note_st->nst_cmn.nc_pid[1] << 8),
                                   note_st->nst_name);
+          noteram_taskunlock();
         }
     }
 #endif
@@ -830,7 +1037,7 @@ void sched_note_add(FAR const void *note, size_t notelen)
   /* Get the index to the head of the circular buffer */
 
   DEBUGASSERT(note != NULL && notelen < CONFIG_DRIVER_NOTERAM_BUFSIZE);
-  head = g_noteram_info.ni_head;
+  head = ni->ni_head;
 
   /* Loop until all bytes have been transferred to the circular buffer */
 
@@ -841,39 +1048,35 @@ void sched_note_add(FAR const void *note, size_t notelen)
        */
 
       next = noteram_next(head, 1);
-      if (next == g_noteram_info.ni_tail)
+      if (next == ni->ni_tail)
         {
-          if (g_noteram_info.ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+          if (g_noteram_mode == NOTERAM_MODE_OVERWRITE_DISABLE)
             {
               /* Stop recording if not in overwrite mode */
 
-              g_noteram_info.ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+              ni->ni_overflow = true;
 
-#ifdef CONFIG_SMP
-              spin_unlock_wo_note(&g_noteram_lock);
-#endif
+              noteram_unlock(ni);
               up_irq_restore(flags);
               return;
             }
 
           /* Yes, then remove the note at the tail index */
 
-          noteram_remove();
+          noteram_remove(ni);
         }
 
       /* Save the next byte at the head index */
 
-      g_noteram_info.ni_buffer[head] = *buf++;
+      ni->ni_buffer[head] = *buf++;
 
       head = next;
       notelen--;
     }
 
-  g_noteram_info.ni_head = head;
+  ni->ni_head = head;
 
-#ifdef CONFIG_SMP
-  spin_unlock_wo_note(&g_noteram_lock);
-#endif
+  noteram_unlock(ni);
   up_irq_restore(flags);
 }
 
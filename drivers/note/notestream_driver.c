@@ -0,0 +1,417 @@
+/****************************************************************************
+ * drivers/note/notestream_driver.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/note/notestream_driver.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The stream is a Common Trace Format (CTF 1.8) data stream.  Each packet
+ * is made of a packet header, a packet context and a sequence of events.
+ * Each event holds one note unmodified, preceded by its type and its time
+ * stamp extended to 64 bits.  All of the fields are little endian.
+ */
+
+#define NOTESTREAM_MAGIC      0xc1fc1fc1
+
+#define NOTESTREAM_PKTHDRLEN  (4 + 4 + 8 + 8 + 4 + 4)
+#define NOTESTREAM_EVTHDRLEN  (1 + 8 + 1)
+
+/* The largest read from /dev/note/ram and the space it can take in the
+ * packet: every note in it gets an event header.
+ */
+
+#define NOTESTREAM_READLEN    UINT8_MAX
+#define NOTESTREAM_READSPACE  (NOTESTREAM_READLEN + NOTESTREAM_EVTHDRLEN * \
+                               (NOTESTREAM_READLEN / \
+                                sizeof(struct note_common_s)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct notestream_s
+{
+  struct file ns_in;           /* /dev/note/ram */
+  struct file ns_out;          /* The output channel */
+  uint64_t    ns_time;         /* The last time stamp, extended */
+#ifndef CONFIG_SCHED_INSTRUMENTATION_HIRES
+  clock_t     ns_raw;          /* The last time stamp, as recorded */
+#endif
+  uint64_t    ns_begin;        /* Time stamp of the first event in packet */
+  size_t      ns_len;          /* Bytes used in ns_packet */
+  uint8_t     ns_note[NOTESTREAM_READLEN];
+  uint8_t     ns_packet[CONFIG_DRIVER_NOTESTREAM_PACKETSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The event names, indexed by enum note_type_e */
+
+static FAR const char * const g_notestream_names[] =
+{
+  "start", "stop", "suspend", "resume", "cpu_start", "cpu_started",
+  "cpu_pause", "cpu_paused", "cpu_resume", "cpu_resumed", "preempt_lock",
+  "preempt_unlock", "csection_enter", "csection_leave", "spinlock_lock",
+  "spinlock_locked", "spinlock_unlock", "spinlock_abort", "syscall_enter",
+  "syscall_leave", "irq_enter", "irq_leave", "dump_string", "dump_binary"
+};
+
+/* The part of the CTF metadata that does not depend on the configuration */
+
+static const char g_notestream_header[] =
+  "typealias integer { size = 8; align = 8; signed = false; } "
+  ":= uint8_t;\n"
+  "typealias integer { size = 32; align = 8; signed = false; } "
+  ":= uint32_t;\n"
+  "typealias integer { size = 64; align = 8; signed = false; "
+  "map = clock.nuttx.value; } := nuttx_clock_t;\n"
+  "trace {\n"
+  "  major = 1; minor = 8; byte_order = le;\n"
+  "  packet.header := struct { uint32_t magic; uint32_t stream_id; };\n"
+  "};\n"
+  "stream {\n"
+  "  id = 0;\n"
+  "  packet.context := struct {\n"
+  "    nuttx_clock_t timestamp_begin; nuttx_clock_t timestamp_end;\n"
+  "    uint32_t content_size; uint32_t packet_size;\n"
+  "  };\n"
+  "  event.header := struct { uint8_t id; nuttx_clock_t timestamp; };\n"
+  "};\n";
+
+static struct notestream_s g_notestream;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notestream_put
+ *
+ * Description:
+ *   Store len bytes of value at offset in the packet, little endian.
+ *
+ ****************************************************************************/
+
+static void notestream_put(FAR struct notestream_s *ns, size_t offset,
+                           uint64_t value, size_t len)
+{
+  while (len-- > 0)
+    {
+      ns->ns_packet[offset++] = value & 0xff;
+      value >>= 8;
+    }
+}
+
+/****************************************************************************
+ * Name: notestream_get
+ *
+ * Description:
+ *   Return the len byte, little endian field of a note.
+ *
+ ****************************************************************************/
+
+static uint64_t notestream_get(FAR const uint8_t *field, size_t len)
+{
+  uint64_t value = 0;
+
+  while (len-- > 0)
+    {
+      value = (value << 8) | field[len];
+    }
+
+  return value;
+}
+
+/****************************************************************************
+ * Name: notestream_timestamp
+ *
+ * Description:
+ *   Return the time stamp of a note in units of the CTF clock.  Time stamps
+ *   that wrap around are extended to 64 bits.
+ *
+ ****************************************************************************/
+
+static uint64_t notestream_timestamp(FAR struct notestream_s *ns,
+                                     FAR const struct note_common_s *note)
+{
+#ifdef CONFIG_SCHED_INSTRUMENTATION_HIRES
+  ns->ns_time = notestream_get(note->nc_systime_sec, sizeof(time_t)) *
+                NSEC_PER_SEC +
+                notestream_get(note->nc_systime_nsec, sizeof(long));
+#else
+  clock_t raw = notestream_get(note->nc_systime, sizeof(clock_t));
+
+  /* The notes of different CPUs may be slightly out of order, so the
+   * difference is signed.
+   */
+
+  if (ns->ns_time == 0)
+    {
+      ns->ns_time = raw;
+    }
+  else
+    {
+#  ifdef CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT
+      ns->ns_time += (int32_t)(uint32_t)(raw - ns->ns_raw);
+#  else
+      ns->ns_time += (sclock_t)(raw - ns->ns_raw);
+#  endif
+    }
+
+  ns->ns_raw = raw;
+#endif
+
+  return ns->ns_time;
+}
+
+/****************************************************************************
+ * Name: notestream_metadata
+ *
+ * Description:
+ *   Write the CTF metadata that describes the stream to path.
+ *
+ ****************************************************************************/
+
+static int notestream_metadata(FAR const char *path)
+{
+  struct file filep;
+  char line[128];
+  uint64_t freq;
+  size_t i;
+  int ret;
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_HIRES)
+  freq = NSEC_PER_SEC;
+#elif defined(CONFIG_SCHED_INSTRUMENTATION_PERFCOUNT)
+  freq = up_perf_getfreq();
+#else
+  freq = TICK_PER_SEC;
+#endif
+
+  ret = file_open(&filep, path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  snprintf(line, sizeof(line),
+           "/* CTF 1.8 */\n"
+           "clock { name = nuttx; freq = %llu; };\n",
+           (unsigned long long)freq);
+  file_write(&filep, line, strlen(line));
+
+  file_write(&filep, g_notestream_header,
+             sizeof(g_notestream_header) - 1);
+
+  /* The payload of each event is the note, as struct note_*_s */
+
+  for (i = 0;
+       i < sizeof(g_notestream_names) / sizeof(g_notestream_names[0]);
+       i++)
+    {
+      snprintf(line, sizeof(line),
+               "event { name = \"%s\"; id = %zu; stream_id = 0; "
+               "fields := struct { uint8_t size; "
+               "uint8_t note[size]; }; };\n",
+               g_notestream_names[i], i);
+      file_write(&filep, line, strlen(line));
+    }
+
+  return file_close(&filep);
+}
+
+/****************************************************************************
+ * Name: notestream_flush
+ *
+ * Description:
+ *   Complete the packet header and write the packet to the channel.
+ *
+ ****************************************************************************/
+
+static void notestream_flush(FAR struct notestream_s *ns)
+{
+  FAR const uint8_t *buf = ns->ns_packet;
+  size_t len = ns->ns_len;
+  ssize_t nwritten;
+
+  notestream_put(ns, 0, NOTESTREAM_MAGIC, 4);
+  notestream_put(ns, 4, 0, 4);
+  notestream_put(ns, 8, ns->ns_begin, 8);
+  notestream_put(ns, 16, ns->ns_time, 8);
+  notestream_put(ns, 24, len * 8, 4);
+  notestream_put(ns, 28, len * 8, 4);
+
+  while (len > 0)
+    {
+      nwritten = file_write(&ns->ns_out, buf, len);
+      if (nwritten < 0)
+        {
+          if (nwritten == -EINTR)
+            {
+              continue;
+            }
+
+          /* Drop the packet; the next one is self-contained */
+
+          serr("ERROR: notestream write failed: %zd\n", nwritten);
+          break;
+        }
+
+      buf += nwritten;
+      len -= nwritten;
+    }
+
+  ns->ns_len = NOTESTREAM_PKTHDRLEN;
+}
+
+/****************************************************************************
+ * Name: notestream_thread
+ *
+ * Description:
+ *   Drain /dev/note/ram into CTF packets on the output channel.
+ *
+ ****************************************************************************/
+
+static int notestream_thread(int argc, FAR char *argv[])
+{
+  FAR struct notestream_s *ns = &g_notestream;
+  FAR struct note_common_s *note;
+  ssize_t nread;
+  size_t offset;
+  uint64_t time;
+
+  /* The devices may not be registered yet when this thread starts */
+
+  while (file_open(&ns->ns_in, "/dev/note/ram", O_RDONLY) < 0)
+    {
+      nxsig_usleep(CONFIG_DRIVER_NOTESTREAM_PERIOD * USEC_PER_MSEC);
+    }
+
+  while (file_open(&ns->ns_out, CONFIG_DRIVER_NOTESTREAM_PATH,
+                   O_WRONLY | O_CREAT | O_TRUNC, 0666) < 0)
+    {
+      nxsig_usleep(CONFIG_DRIVER_NOTESTREAM_PERIOD * USEC_PER_MSEC);
+    }
+
+  if (CONFIG_DRIVER_NOTESTREAM_METADATA[0] != '\0')
+    {
+      notestream_metadata(CONFIG_DRIVER_NOTESTREAM_METADATA);
+    }
+
+  ns->ns_len = NOTESTREAM_PKTHDRLEN;
+
+  for (; ; )
+    {
+      nread = file_read(&ns->ns_in, ns->ns_note, sizeof(ns->ns_note));
+      if (nread <= 0)
+        {
+          /* The note buffer is empty.  Send what we have and wait. */
+
+          if (ns->ns_len > NOTESTREAM_PKTHDRLEN)
+            {
+              notestream_flush(ns);
+            }
+
+          nxsig_usleep(CONFIG_DRIVER_NOTESTREAM_PERIOD * USEC_PER_MSEC);
+          continue;
+        }
+
+      /* Add one event for each of the notes that were read */
+
+      for (offset = 0; offset < nread; offset += note->nc_length)
+        {
+          note = (FAR struct note_common_s *)&ns->ns_note[offset];
+          if (note->nc_length == 0 || offset + note->nc_length > nread)
+            {
+              break;
+            }
+
+          time = notestream_timestamp(ns, note);
+          if (ns->ns_len == NOTESTREAM_PKTHDRLEN)
+            {
+              ns->ns_begin = time;
+            }
+
+          notestream_put(ns, ns->ns_len, note->nc_type, 1);
+          notestream_put(ns, ns->ns_len + 1, time, 8);
+          notestream_put(ns, ns->ns_len + 9, note->nc_length, 1);
+          ns->ns_len += NOTESTREAM_EVTHDRLEN;
+
+          memcpy(&ns->ns_packet[ns->ns_len], note, note->nc_length);
+          ns->ns_len += note->nc_length;
+        }
+
+      /* Make sure that the next read fits into the packet */
+
+      if (ns->ns_len + NOTESTREAM_READSPACE > sizeof(ns->ns_packet))
+        {
+          notestream_flush(ns);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notestream_start
+ *
+ * Description:
+ *   Start the thread that streams the notes to the output channel.
+ *
+ ****************************************************************************/
+
+int notestream_start(void)
+{
+  int pid;
+
+  pid = kthread_create("notestream", CONFIG_DRIVER_NOTESTREAM_PRIORITY,
+                       CONFIG_DRIVER_NOTESTREAM_STACKSIZE,
+                       notestream_thread, NULL);
+  return pid < 0 ? pid : OK;
+}
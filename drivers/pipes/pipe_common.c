@@ -60,6 +60,322 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Write the data in the pipe straight from the circular buffer to
+ *   another file, so that the data is not bounced through a user buffer.
+ *   The data is removed from the pipe unless peek is true (tee()).  An
+ *   ps_len of zero only reports that the file is a pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice(FAR struct file *filep,
+                                 FAR struct pipe_splice_s *ps, bool peek)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  ssize_t                ntotal = 0;
+  ssize_t                nwritten;
+  pipe_ndx_t             rdndx;
+  size_t                 nbytes;
+  int                    sval;
+  int                    ret;
+
+  if (ps->ps_len == 0)
+    {
+      return 0;
+    }
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  /* The pipe cannot be spliced into itself */
+
+  if (ps->ps_file->f_inode == inode)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  while (dev->d_wrndx == dev->d_rdndx)
+    {
+      if (dev->d_nwriters <= 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+          (ps->ps_flags & SPLICE_F_NONBLOCK) != 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Write the contents of the buffer in at most two contiguous runs: up
+   * to the end of the buffer, then from its start.  The lock is held so
+   * that no other reader consumes the data being written.
+   */
+
+  rdndx = dev->d_rdndx;
+  while ((size_t)ntotal < ps->ps_len && rdndx != dev->d_wrndx)
+    {
+      nbytes = (dev->d_wrndx > rdndx ? dev->d_wrndx : dev->d_bufsize) -
+               rdndx;
+      if (nbytes > ps->ps_len - ntotal)
+        {
+          nbytes = ps->ps_len - ntotal;
+        }
+
+      if (ps->ps_offset != NULL)
+        {
+          nwritten = file_pwrite(ps->ps_file, &dev->d_buffer[rdndx],
+                                 nbytes, *ps->ps_offset);
+          if (nwritten > 0)
+            {
+              *ps->ps_offset += nwritten;
+            }
+        }
+      else
+        {
+          nwritten = file_write(ps->ps_file, &dev->d_buffer[rdndx], nbytes);
+        }
+
+      if (nwritten <= 0)
+        {
+          /* Report an error only if nothing has been transferred */
+
+          if (ntotal == 0)
+            {
+              ntotal = nwritten;
+            }
+
+          break;
+        }
+
+      pipe_dumpbuffer("From PIPE:", &dev->d_buffer[rdndx], nwritten);
+
+      ntotal += nwritten;
+      rdndx  += nwritten;
+      if (rdndx >= dev->d_bufsize)
+        {
+          rdndx = 0;
+        }
+
+      if ((size_t)nwritten < nbytes)
+        {
+          break;
+        }
+    }
+
+  if (!peek && ntotal > 0)
+    {
+      dev->d_rdndx = rdndx;
+
+      /* Notify all poll/select waiters and all waiting writers that bytes
+       * have been removed from the buffer.
+       */
+
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+
+      while (nxsem_get_value(&dev->d_wrsem, &sval) == 0 && sval <= 0)
+        {
+          nxsem_post(&dev->d_wrsem);
+        }
+    }
+
+  nxmutex_unlock(&dev->d_bflock);
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: pipecommon_fill
+ *
+ * Description:
+ *   Read another file straight into the free space of the circular
+ *   buffer.  An ps_len of zero only reports that the file is a pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_fill(FAR struct file *filep,
+                               FAR struct pipe_splice_s *ps)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  ssize_t                ntotal = 0;
+  ssize_t                nread;
+  size_t                 nbytes;
+  int                    nxtwrndx;
+  int                    sval;
+  int                    ret;
+
+  if (ps->ps_len == 0)
+    {
+      return 0;
+    }
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (ps->ps_file->f_inode == inode)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait until there is room for at least one byte */
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      nxtwrndx = dev->d_wrndx + 1;
+      if (nxtwrndx >= dev->d_bufsize)
+        {
+          nxtwrndx = 0;
+        }
+
+      if (nxtwrndx != dev->d_rdndx)
+        {
+          break;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+          (ps->ps_flags & SPLICE_F_NONBLOCK) != 0)
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Read into the free space in at most two contiguous runs.  One byte is
+   * always left free to tell a full buffer from an empty one.
+   */
+
+  while ((size_t)ntotal < ps->ps_len)
+    {
+      if (dev->d_wrndx >= dev->d_rdndx)
+        {
+          nbytes = dev->d_bufsize - dev->d_wrndx;
+          if (dev->d_rdndx == 0)
+            {
+              nbytes--;
+            }
+        }
+      else
+        {
+          nbytes = dev->d_rdndx - dev->d_wrndx - 1;
+        }
+
+      if (nbytes == 0)
+        {
+          break;
+        }
+
+      if (nbytes > ps->ps_len - ntotal)
+        {
+          nbytes = ps->ps_len - ntotal;
+        }
+
+      if (ps->ps_offset != NULL)
+        {
+          nread = file_pread(ps->ps_file, &dev->d_buffer[dev->d_wrndx],
+                             nbytes, *ps->ps_offset);
+          if (nread > 0)
+            {
+              *ps->ps_offset += nread;
+            }
+        }
+      else
+        {
+          nread = file_read(ps->ps_file, &dev->d_buffer[dev->d_wrndx],
+                            nbytes);
+        }
+
+      if (nread <= 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = nread;
+            }
+
+          break;
+        }
+
+      pipe_dumpbuffer("To PIPE:", &dev->d_buffer[dev->d_wrndx], nread);
+
+      ntotal       += nread;
+      dev->d_wrndx += nread;
+      if (dev->d_wrndx >= dev->d_bufsize)
+        {
+          dev->d_wrndx = 0;
+        }
+
+      if ((size_t)nread < nbytes)
+        {
+          break;
+        }
+    }
+
+  if (ntotal > 0)
+    {
+      /* Notify all poll/select waiters and all waiting readers that more
+       * data is available.
+       */
+
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+
+      while (nxsem_get_value(&dev->d_rdsem, &sval) == 0 && sval <= 0)
+        {
+          nxsem_post(&dev->d_rdsem);
+        }
+    }
+
+  nxmutex_unlock(&dev->d_bflock);
+  return ntotal;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -749,6 +1065,21 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* The splice commands may block, they manage the lock themselves */
+
+  switch (cmd)
+    {
+      case PIPEIOC_SPLICE:
+      case PIPEIOC_TEE:
+        return pipecommon_splice(filep,
+                                 (FAR struct pipe_splice_s *)(uintptr_t)arg,
+                                 cmd == PIPEIOC_TEE);
+
+      case PIPEIOC_FILL:
+        return pipecommon_fill(filep,
+                               (FAR struct pipe_splice_s *)(uintptr_t)arg);
+    }
+
   ret = nxmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
@@ -0,0 +1,466 @@
+/****************************************************************************
+ * drivers/power/cpufreq/cpufreq.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/clk/clk.h>
+#include <nuttx/power/consumer.h>
+#include <nuttx/power/cpufreq.h>
+
+#include "cpufreq.h"
+
+#ifdef CONFIG_CPUFREQ
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(CONFIG_CPUFREQ_DEFAULT_ONDEMAND) && \
+    !defined(CONFIG_CPUFREQ_DEFAULT_SCHEDUTIL)
+#  error "No cpufreq governor is enabled"
+#endif
+
+#define CPUFREQ_INTERVAL MSEC2TICK(CONFIG_CPUFREQ_SAMPLING_MS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered policies, their state and the sampling work are protected
+ * by the lock.
+ */
+
+static struct dq_queue_s g_cpufreq_policies;
+static mutex_t g_cpufreq_lock = NXMUTEX_INITIALIZER;
+static struct work_s g_cpufreq_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_default_governor
+ ****************************************************************************/
+
+static FAR const struct cpufreq_governor_s *cpufreq_default_governor(void)
+{
+#ifdef CONFIG_CPUFREQ_DEFAULT_ONDEMAND
+  return cpufreq_ondemand_initialize();
+#else
+  return cpufreq_schedutil_initialize();
+#endif
+}
+
+/****************************************************************************
+ * Name: cpufreq_reset
+ *
+ * Description:
+ *   Take the utilization counts of the CPUs of a policy as the start of
+ *   the next sample.
+ *
+ ****************************************************************************/
+
+static void cpufreq_reset(FAR struct cpufreq_policy_s *policy)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      clock_cpuutil(cpu, &policy->prev[cpu]);
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_utilization
+ *
+ * Description:
+ *   Return the utilization of the busiest CPU of a policy since the last
+ *   sample:  The CPUs share the clock, which has to serve all of them.
+ *
+ ****************************************************************************/
+
+static uint32_t cpufreq_utilization(FAR struct cpufreq_policy_s *policy)
+{
+  struct cpuload_s now;
+  uint32_t active;
+  uint32_t total;
+  uint32_t util;
+  uint32_t max = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+#ifdef CONFIG_SMP
+      if (!CPU_ISSET(cpu, &policy->cpus))
+        {
+          continue;
+        }
+#endif
+
+      clock_cpuutil(cpu, &now);
+      total  = now.total - policy->prev[cpu].total;
+      active = now.active - policy->prev[cpu].active;
+      policy->prev[cpu].total  = now.total;
+      policy->prev[cpu].active = now.active;
+
+      if (total > 0)
+        {
+          util = (uint64_t)active * CPUFREQ_UTIL_SCALE / total;
+          if (util > max)
+            {
+              max = util;
+            }
+        }
+    }
+
+  return max;
+}
+
+/****************************************************************************
+ * Name: cpufreq_transition
+ *
+ * Description:
+ *   Move a policy to an operating point.  The voltage is raised before the
+ *   rate and lowered after it, so that the CPUs never run faster than
+ *   their supply allows.
+ *
+ ****************************************************************************/
+
+static void cpufreq_transition(FAR struct cpufreq_policy_s *policy,
+                               int next)
+{
+  FAR const struct cpufreq_opp_s *opp = &policy->opps[next];
+  FAR struct cpufreq_stats_s *stats = &policy->stats;
+  struct timespec ts;
+  uint32_t start;
+  uint32_t usec;
+  int ret = OK;
+
+  start = up_perf_gettime();
+
+#ifdef CONFIG_REGULATOR
+  if (policy->reg != NULL && opp->min_uv > 0 && next > policy->cur)
+    {
+      ret = regulator_set_voltage(policy->reg, opp->min_uv, opp->max_uv);
+    }
+#endif
+
+  if (ret >= 0)
+    {
+      ret = clk_set_rate(policy->clkp, opp->freq);
+    }
+
+  if (ret < 0)
+    {
+      pwrwarn("WARNING: %s to %" PRIu32 " Hz failed: %d\n",
+              policy->clk, opp->freq, ret);
+      stats->errors++;
+      return;
+    }
+
+#ifdef CONFIG_REGULATOR
+  /* Failing to lower the voltage only costs power */
+
+  if (policy->reg != NULL && opp->min_uv > 0 && next < policy->cur)
+    {
+      regulator_set_voltage(policy->reg, opp->min_uv, opp->max_uv);
+    }
+#endif
+
+  up_perf_convert(up_perf_gettime() - start, &ts);
+  usec = ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  policy->cur           = next;
+  stats->freq           = clk_get_rate(policy->clkp);
+  stats->transitions++;
+  stats->last_latency   = usec;
+  stats->total_latency += usec;
+  if (usec > stats->max_latency)
+    {
+      stats->max_latency = usec;
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_sample
+ *
+ * Description:
+ *   Run the governor of a policy on the utilization since the last sample.
+ *   A lower operating point has to be asked for in CONFIG_CPUFREQ_DOWN_HOLD
+ *   consecutive samples, a higher one is applied immediately.
+ *
+ ****************************************************************************/
+
+static void cpufreq_sample(FAR struct cpufreq_policy_s *policy)
+{
+  uint32_t util;
+  int next;
+
+  util = cpufreq_utilization(policy);
+  policy->stats.util = util;
+
+  next = policy->governor->target(policy, util);
+  if (next < 0)
+    {
+      next = 0;
+    }
+  else if (next >= policy->nopps)
+    {
+      next = policy->nopps - 1;
+    }
+
+  if (next < policy->cur)
+    {
+      if (++policy->hold < CONFIG_CPUFREQ_DOWN_HOLD)
+        {
+          return;
+        }
+    }
+
+  policy->hold = 0;
+  if (next != policy->cur)
+    {
+      cpufreq_transition(policy, next);
+    }
+}
+
+/****************************************************************************
+ * Name: cpufreq_worker
+ ****************************************************************************/
+
+static void cpufreq_worker(FAR void *arg)
+{
+  FAR dq_entry_t *entry;
+
+  nxmutex_lock(&g_cpufreq_lock);
+
+  for (entry = dq_peek(&g_cpufreq_policies); entry != NULL;
+       entry = dq_next(entry))
+    {
+      cpufreq_sample(container_of(entry, struct cpufreq_policy_s, node));
+    }
+
+  if (!dq_empty(&g_cpufreq_policies))
+    {
+      work_queue(LPWORK, &g_cpufreq_work, cpufreq_worker, NULL,
+                 CPUFREQ_INTERVAL);
+    }
+
+  nxmutex_unlock(&g_cpufreq_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_register
+ *
+ * Description:
+ *   Start scaling the clock of a group of CPUs.  The clock and the
+ *   regulator are looked up by name and the CPUs start at the operating
+ *   point closest to the current rate, which the governor leaves as soon
+ *   as the first sample has been taken.
+ *
+ * Input Parameters:
+ *   policy - The policy, see struct cpufreq_policy_s
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_register(FAR struct cpufreq_policy_s *policy)
+{
+  DEBUGASSERT(policy != NULL && policy->clk != NULL);
+
+  if (policy->opps == NULL || policy->nopps == 0)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_CPUFREQ_GOVERNOR_ONDEMAND
+  if (CPUFREQ_UP_THRESHOLD(policy) > 100 ||
+      CPUFREQ_DOWN_THRESHOLD(policy) >= CPUFREQ_UP_THRESHOLD(policy))
+    {
+      return -EINVAL;
+    }
+#endif
+
+  policy->clkp = clk_get(policy->clk);
+  if (policy->clkp == NULL)
+    {
+      return -ENODEV;
+    }
+
+  policy->reg = NULL;
+  if (policy->regulator != NULL)
+    {
+#ifdef CONFIG_REGULATOR
+      policy->reg = regulator_get(policy->regulator);
+      if (policy->reg == NULL)
+#endif
+        {
+          return -ENODEV;
+        }
+    }
+
+  if (policy->governor == NULL)
+    {
+      policy->governor = cpufreq_default_governor();
+    }
+
+  memset(&policy->stats, 0, sizeof(policy->stats));
+  policy->stats.freq = clk_get_rate(policy->clkp);
+  policy->cur        = cpufreq_opp_index(policy, policy->stats.freq);
+  policy->hold       = 0;
+
+  nxmutex_lock(&g_cpufreq_lock);
+
+  cpufreq_reset(policy);
+  dq_addlast(&policy->node, &g_cpufreq_policies);
+  if (work_available(&g_cpufreq_work))
+    {
+      work_queue(LPWORK, &g_cpufreq_work, cpufreq_worker, NULL,
+                 CPUFREQ_INTERVAL);
+    }
+
+  nxmutex_unlock(&g_cpufreq_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpufreq_unregister
+ *
+ * Description:
+ *   Stop scaling the clock of a policy.  The rate is left unchanged.
+ *
+ * Input Parameters:
+ *   policy - A registered policy
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_unregister(FAR struct cpufreq_policy_s *policy)
+{
+  DEBUGASSERT(policy != NULL);
+
+  nxmutex_lock(&g_cpufreq_lock);
+
+  dq_rem(&policy->node, &g_cpufreq_policies);
+  if (dq_empty(&g_cpufreq_policies))
+    {
+      work_cancel(LPWORK, &g_cpufreq_work);
+    }
+
+  nxmutex_unlock(&g_cpufreq_lock);
+
+#ifdef CONFIG_REGULATOR
+  if (policy->reg != NULL)
+    {
+      regulator_put(policy->reg);
+      policy->reg = NULL;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpufreq_set_governor
+ *
+ * Description:
+ *   Change the governor of a registered policy.
+ *
+ * Input Parameters:
+ *   policy   - A registered policy
+ *   governor - The new governor, or NULL for the default one
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_set_governor(FAR struct cpufreq_policy_s *policy,
+                         FAR const struct cpufreq_governor_s *governor)
+{
+  DEBUGASSERT(policy != NULL);
+
+  if (governor == NULL)
+    {
+      governor = cpufreq_default_governor();
+    }
+
+  nxmutex_lock(&g_cpufreq_lock);
+  policy->governor = governor;
+  policy->hold     = 0;
+  nxmutex_unlock(&g_cpufreq_lock);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cpufreq_get_stats
+ *
+ * Description:
+ *   Return the current rate, the last utilization and the transition
+ *   statistics of a registered policy.
+ *
+ * Input Parameters:
+ *   policy - A registered policy
+ *   stats  - The location to return the statistics
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_get_stats(FAR struct cpufreq_policy_s *policy,
+                      FAR struct cpufreq_stats_s *stats)
+{
+  DEBUGASSERT(policy != NULL && stats != NULL);
+
+  nxmutex_lock(&g_cpufreq_lock);
+  *stats = policy->stats;
+  nxmutex_unlock(&g_cpufreq_lock);
+
+  return OK;
+}
+
+#endif /* CONFIG_CPUFREQ */
@@ -0,0 +1,80 @@
+/****************************************************************************
+ * drivers/power/cpufreq/cpufreq.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_POWER_CPUFREQ_CPUFREQ_H
+#define __DRIVERS_POWER_CPUFREQ_CPUFREQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/power/cpufreq.h>
+
+#ifdef CONFIG_CPUFREQ
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The thresholds of the ondemand governor for a policy, in percent */
+
+#ifdef CONFIG_CPUFREQ_GOVERNOR_ONDEMAND
+#  define CPUFREQ_UP_THRESHOLD(p) \
+     ((p)->up_threshold ? (p)->up_threshold : CONFIG_CPUFREQ_UP_THRESHOLD)
+#  define CPUFREQ_DOWN_THRESHOLD(p) \
+     ((p)->down_threshold ? (p)->down_threshold : \
+      CONFIG_CPUFREQ_DOWN_THRESHOLD)
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_opp_index
+ *
+ * Description:
+ *   Return the index of the slowest operating point of a policy that runs
+ *   at least at freq, or that of the fastest one.
+ *
+ ****************************************************************************/
+
+static inline int cpufreq_opp_index(FAR struct cpufreq_policy_s *policy,
+                                    uint64_t freq)
+{
+  int i;
+
+  for (i = 0; i < policy->nopps - 1; i++)
+    {
+      if (policy->opps[i].freq >= freq)
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+
+#endif /* CONFIG_CPUFREQ */
+#endif /* __DRIVERS_POWER_CPUFREQ_CPUFREQ_H */
@@ -0,0 +1,108 @@
+/****************************************************************************
+ * drivers/power/cpufreq/cpufreq_ondemand.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/power/cpufreq.h>
+
+#include "cpufreq.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A threshold in percent as a utilization */
+
+#define ONDEMAND_UTIL(pct) ((uint32_t)(pct) * CPUFREQ_UTIL_SCALE / 100)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ondemand_target(FAR struct cpufreq_policy_s *policy,
+                           uint32_t util);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cpufreq_governor_s g_ondemand_governor =
+{
+  "ondemand",                   /* name */
+  ondemand_target               /* target */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ondemand_target
+ ****************************************************************************/
+
+static int ondemand_target(FAR struct cpufreq_policy_s *policy,
+                           uint32_t util)
+{
+  uint32_t up = ONDEMAND_UTIL(CPUFREQ_UP_THRESHOLD(policy));
+  uint32_t down = ONDEMAND_UTIL(CPUFREQ_DOWN_THRESHOLD(policy));
+  uint64_t freq;
+
+  /* A busy policy may need any rate:  Serve it at once with the highest */
+
+  if (util > up)
+    {
+      return policy->nopps - 1;
+    }
+
+  if (util >= down)
+    {
+      return policy->cur;
+    }
+
+  /* Pick the rate at which the work done now would load the CPUs in the
+   * middle of the band, away from both thresholds.
+   */
+
+  freq = (uint64_t)policy->opps[policy->cur].freq * util * 2 / (up + down);
+  return cpufreq_opp_index(policy, freq);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_ondemand_initialize
+ *
+ * Description:
+ *   Return the ondemand governor instance.
+ *
+ ****************************************************************************/
+
+FAR const struct cpufreq_governor_s *cpufreq_ondemand_initialize(void)
+{
+  return &g_ondemand_governor;
+}
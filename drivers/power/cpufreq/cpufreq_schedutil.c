@@ -0,0 +1,90 @@
+/****************************************************************************
+ * drivers/power/cpufreq/cpufreq_schedutil.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/power/cpufreq.h>
+
+#include "cpufreq.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int schedutil_target(FAR struct cpufreq_policy_s *policy,
+                            uint32_t util);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cpufreq_governor_s g_schedutil_governor =
+{
+  "schedutil",                  /* name */
+  schedutil_target              /* target */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedutil_target
+ ****************************************************************************/
+
+static int schedutil_target(FAR struct cpufreq_policy_s *policy,
+                            uint32_t util)
+{
+  uint64_t freq;
+
+  /* The demand is the rate that the busiest CPU used.  At full load it is
+   * unknown, the headroom then moves the policy up one operating point per
+   * sample at least.
+   */
+
+  freq  = (uint64_t)policy->opps[policy->cur].freq * util /
+          CPUFREQ_UTIL_SCALE;
+  freq += freq >> 2;
+
+  return cpufreq_opp_index(policy, freq);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_schedutil_initialize
+ *
+ * Description:
+ *   Return the schedutil governor instance.
+ *
+ ****************************************************************************/
+
+FAR const struct cpufreq_governor_s *cpufreq_schedutil_initialize(void)
+{
+  return &g_schedutil_governor;
+}
@@ -0,0 +1,394 @@
+/****************************************************************************
+ * drivers/power/pm/latency_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The latency governor selects the deepest power state that is not locked
+ * by a wakelock, that resumes within the smallest wakeup latency of the
+ * QoS requests of the domain, and that pays off within the predicted idle
+ * time.  The idle time is predicted from the next watchdog expiry and from
+ * the durations of the recent idle periods:  If these are consistent, the
+ * system is likely to be woken up as often again, e.g. by a periodic
+ * interrupt that the timers do not know about.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Idle periods are recorded in microseconds, clipped to about 4 minutes so
+ * that the variance of the history cannot overflow 64 bits.
+ */
+
+#define LATENCY_MAXIDLE   0x0fffffff
+
+/* The history is consistent if the standard deviation of the idle periods
+ * is below 20 microseconds or below one sixth of their average.
+ */
+
+#define LATENCY_MAXVAR    400
+
+/* Removing the longest idle periods allows for some unrelated wakeups */
+
+#define LATENCY_NPASSES   3
+
+#define NHISTORY          CONFIG_PM_GOVERNOR_LATENCY_NHISTORY
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cost of a power state, in microseconds */
+
+struct latency_cost_s
+{
+  uint32_t exit;            /* The time to resume from the state */
+  uint32_t residency;       /* The idle time for the state to pay off */
+};
+
+struct latency_domain_s
+{
+  struct wdog_s wdog;       /* Holds PM_NORMAL after activity */
+  struct timespec start;    /* The start of the idle period */
+  bool idle;                /* An idle period is in progress */
+  uint8_t next;             /* The next entry of the history */
+  uint8_t count;            /* The number of entries of the history */
+  uint32_t history[NHISTORY];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void latency_governor_statechanged(int domain,
+                                          enum pm_state_e newstate);
+static enum pm_state_e latency_governor_checkstate(int domain);
+static void latency_governor_activity(int domain, int count);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_latency_governor_ops =
+{
+  NULL,                          /* initialize */
+  NULL,                          /* deinitialize */
+  latency_governor_statechanged, /* statechanged */
+  latency_governor_checkstate,   /* checkstate */
+  latency_governor_activity,     /* activity */
+  NULL                           /* priv */
+};
+
+static const struct latency_cost_s g_latency_cost[PM_COUNT] =
+{
+  {
+    0, 0                          /* PM_NORMAL */
+  },
+  {
+    CONFIG_PM_GOVERNOR_LATENCY_IDLE_EXIT,
+    CONFIG_PM_GOVERNOR_LATENCY_IDLE_RESIDENCY
+  },
+  {
+    CONFIG_PM_GOVERNOR_LATENCY_STANDBY_EXIT,
+    CONFIG_PM_GOVERNOR_LATENCY_STANDBY_RESIDENCY
+  },
+  {
+    CONFIG_PM_GOVERNOR_LATENCY_SLEEP_EXIT,
+    CONFIG_PM_GOVERNOR_LATENCY_SLEEP_RESIDENCY
+  }
+};
+
+static struct latency_domain_s g_latency_domain[CONFIG_PM_NDOMAINS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_governor_typical
+ *
+ * Description:
+ *   Return the typical duration of the recent idle periods, or UINT32_MAX
+ *   if they are not consistent enough to predict the next one.
+ *
+ ****************************************************************************/
+
+static uint32_t latency_governor_typical(FAR struct latency_domain_s *ldom)
+{
+  uint32_t thresh = UINT32_MAX;
+  uint64_t variance;
+  uint64_t sum;
+  uint32_t avg;
+  uint32_t max;
+  int64_t diff;
+  int pass;
+  int n;
+  int i;
+
+  if (ldom->count < NHISTORY)
+    {
+      return UINT32_MAX;
+    }
+
+  for (pass = 0; pass < LATENCY_NPASSES; pass++)
+    {
+      sum = 0;
+      max = 0;
+      n   = 0;
+
+      for (i = 0; i < NHISTORY; i++)
+        {
+          if (ldom->history[i] <= thresh)
+            {
+              sum += ldom->history[i];
+              if (ldom->history[i] > max)
+                {
+                  max = ldom->history[i];
+                }
+
+              n++;
+            }
+        }
+
+      /* Give up once too many periods have been discarded */
+
+      if (n <= NHISTORY / 2)
+        {
+          break;
+        }
+
+      avg      = sum / n;
+      variance = 0;
+
+      for (i = 0; i < NHISTORY; i++)
+        {
+          if (ldom->history[i] <= thresh)
+            {
+              diff      = (int64_t)ldom->history[i] - avg;
+              variance += diff * diff;
+            }
+        }
+
+      variance /= n;
+      if (variance <= LATENCY_MAXVAR ||
+          (uint64_t)avg * avg > 36 * variance)
+        {
+          return avg;
+        }
+
+      /* Try again without the longest periods */
+
+      thresh = max - 1;
+    }
+
+  return UINT32_MAX;
+}
+
+/****************************************************************************
+ * Name: latency_governor_predict
+ *
+ * Description:
+ *   Return the predicted duration of the next idle period in microseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t latency_governor_predict(FAR struct latency_domain_s *ldom)
+{
+  uint32_t predicted = UINT32_MAX;
+  uint32_t typical;
+  uint64_t usec;
+  sclock_t next;
+
+  /* No timer will wake up the system later than the next watchdog */
+
+  next = wd_nexttime();
+  if (next >= 0)
+    {
+      usec      = (uint64_t)next * USEC_PER_TICK;
+      predicted = usec > UINT32_MAX ? UINT32_MAX : usec;
+    }
+
+#ifndef CONFIG_SCHED_TICKLESS
+  /* ... and none later than the next system tick */
+
+  if (predicted > USEC_PER_TICK)
+    {
+      predicted = USEC_PER_TICK;
+    }
+#endif
+
+  typical = latency_governor_typical(ldom);
+  return typical < predicted ? typical : predicted;
+}
+
+/****************************************************************************
+ * Name: latency_governor_statechanged
+ ****************************************************************************/
+
+static void latency_governor_statechanged(int domain,
+                                          enum pm_state_e newstate)
+{
+  FAR struct latency_domain_s *ldom = &g_latency_domain[domain];
+  struct timespec now;
+  uint64_t elapsed;
+
+  clock_systime_timespec(&now);
+
+  if (newstate > PM_NORMAL)
+    {
+      /* An idle period begins */
+
+      if (!ldom->idle)
+        {
+          ldom->start = now;
+          ldom->idle  = true;
+        }
+    }
+  else if (ldom->idle)
+    {
+      /* The system woke up:  Record the duration of the idle period */
+
+      clock_timespec_subtract(&now, &ldom->start, &now);
+      elapsed = (uint64_t)now.tv_sec * USEC_PER_SEC +
+                now.tv_nsec / NSEC_PER_USEC;
+
+      ldom->history[ldom->next] = elapsed > LATENCY_MAXIDLE ?
+                                  LATENCY_MAXIDLE : elapsed;
+      ldom->next = (ldom->next + 1) % NHISTORY;
+      if (ldom->count < NHISTORY)
+        {
+          ldom->count++;
+        }
+
+      ldom->idle = false;
+    }
+}
+
+/****************************************************************************
+ * Name: latency_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e latency_governor_checkstate(int domain)
+{
+  FAR struct latency_domain_s *ldom = &g_latency_domain[domain];
+  FAR struct pm_domain_s *pdom = &g_pmglobals.domain[domain];
+  irqstate_t flags;
+  uint32_t predicted;
+  uint32_t latency;
+  int state = PM_NORMAL;
+
+  flags = pm_lock(domain);
+
+  if (!WDOG_ISACTIVE(&ldom->wdog))
+    {
+      /* Find the lowest power-level which is not locked. */
+
+      while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+        {
+          state++;
+        }
+
+      /* Then back off to the deepest state that resumes in time and pays
+       * off within the predicted idle period.
+       */
+
+      latency   = pdom->qos_latency;
+      predicted = latency_governor_predict(ldom);
+
+      while (state > PM_NORMAL &&
+             (g_latency_cost[state].exit > latency ||
+              g_latency_cost[state].residency > predicted))
+        {
+          state--;
+        }
+    }
+
+  pm_unlock(domain, flags);
+
+  return state;
+}
+
+/****************************************************************************
+ * Name: latency_governor_timer_cb
+ ****************************************************************************/
+
+static void latency_governor_timer_cb(wdparm_t arg)
+{
+  pm_auto_updatestate((int)arg);
+}
+
+/****************************************************************************
+ * Name: latency_governor_activity
+ ****************************************************************************/
+
+static void latency_governor_activity(int domain, int count)
+{
+  FAR struct latency_domain_s *ldom = &g_latency_domain[domain];
+  irqstate_t flags;
+
+  count = count ? count : 1;
+
+  flags = pm_lock(domain);
+
+  if (TICK2SEC(wd_gettime(&ldom->wdog)) < count)
+    {
+      wd_start(&ldom->wdog, SEC2TICK(count),
+               latency_governor_timer_cb, (wdparm_t)domain);
+    }
+
+  pm_unlock(domain, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_latency_governor_initialize
+ *
+ * Description:
+ *   Return the latency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_latency_governor_initialize(void)
+{
+  return &g_latency_governor_ops;
+}
@@ -64,6 +64,11 @@ struct pm_domain_s
   struct timespec sleep[PM_COUNT];
 #endif
 
+  /* The wakeup latency constraints and the smallest of their latencies */
+
+  struct dq_queue_s qos;
+  uint32_t qos_latency;
+
   /* Auto update or not */
 
   bool auto_update;
@@ -89,6 +89,8 @@ void pm_initialize(void)
       gov = pm_greedy_governor_initialize();
 #elif defined(CONFIG_PM_GOVERNOR_ACTIVITY)
       gov = pm_activity_governor_initialize();
+#elif defined(CONFIG_PM_GOVERNOR_LATENCY)
+      gov = pm_latency_governor_initialize();
 #else
       static struct pm_governor_s null;
       gov = &null;
@@ -96,6 +98,7 @@ void pm_initialize(void)
       pm_set_governor(i, gov);
 
       nxrmutex_init(&g_pmglobals.domain[i].lock);
+      g_pmglobals.domain[i].qos_latency = PM_QOS_LATENCY_ANY;
 
 #if CONFIG_PM_GOVERNOR_EXPLICIT_RELAX
       for (state = 0; state < PM_COUNT; state++)
@@ -0,0 +1,197 @@
+/****************************************************************************
+ * drivers/power/pm/pm_qos.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+#ifdef CONFIG_PM
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_recompute
+ *
+ * Description:
+ *   Update the smallest latency of the requests of a domain.
+ *
+ * Assumptions:
+ *   The domain is locked.
+ *
+ ****************************************************************************/
+
+static void pm_qos_recompute(FAR struct pm_domain_s *pdom)
+{
+  FAR struct pm_qos_s *qos;
+  FAR dq_entry_t *entry;
+  uint32_t latency = PM_QOS_LATENCY_ANY;
+
+  for (entry = dq_peek(&pdom->qos); entry != NULL; entry = dq_next(entry))
+    {
+      qos = container_of(entry, struct pm_qos_s, node);
+      if (qos->latency < latency)
+        {
+          latency = qos->latency;
+        }
+    }
+
+  pdom->qos_latency = latency;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   This function is called by a device driver or an application to
+ *   constrain the wakeup latency of a domain, e.g. to bound the delay
+ *   before it can serve an interrupt.  The governor of the domain honours
+ *   the smallest latency of all added requests.
+ *
+ * Input Parameters:
+ *   qos     - The request, which must stay valid until it is removed
+ *   domain  - The domain of the constraint
+ *   latency - The tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(FAR struct pm_qos_s *qos, int domain, uint32_t latency)
+{
+  FAR struct pm_domain_s *pdom;
+  irqstate_t flags;
+
+  DEBUGASSERT(qos != NULL);
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+
+  pdom         = &g_pmglobals.domain[domain];
+  qos->domain  = domain;
+  qos->latency = latency;
+
+  flags = pm_lock(domain);
+  dq_addlast(&qos->node, &pdom->qos);
+  if (latency < pdom->qos_latency)
+    {
+      pdom->qos_latency = latency;
+    }
+
+  pm_unlock(domain, flags);
+
+  pm_auto_updatestate(domain);
+}
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of an added request.
+ *
+ * Input Parameters:
+ *   qos     - The request
+ *   latency - The tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_s *qos, uint32_t latency)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(qos != NULL);
+
+  flags = pm_lock(qos->domain);
+  qos->latency = latency;
+  pm_qos_recompute(&g_pmglobals.domain[qos->domain]);
+  pm_unlock(qos->domain, flags);
+
+  pm_auto_updatestate(qos->domain);
+}
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove an added request and its constraint.
+ *
+ * Input Parameters:
+ *   qos - The request
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_s *qos)
+{
+  FAR struct pm_domain_s *pdom;
+  irqstate_t flags;
+
+  DEBUGASSERT(qos != NULL);
+
+  pdom  = &g_pmglobals.domain[qos->domain];
+  flags = pm_lock(qos->domain);
+  dq_rem(&qos->node, &pdom->qos);
+  pm_qos_recompute(pdom);
+  pm_unlock(qos->domain, flags);
+
+  pm_auto_updatestate(qos->domain);
+}
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the wakeup latency that a domain must honour.
+ *
+ * Input Parameters:
+ *   domain - The domain of the constraint
+ *
+ * Returned Value:
+ *   The smallest latency of the requests of the domain in microseconds,
+ *   or PM_QOS_LATENCY_ANY if it has none.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain)
+{
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+
+  return g_pmglobals.domain[domain].qos_latency;
+}
+
+#endif /* CONFIG_PM */
@@ -0,0 +1,635 @@
+/****************************************************************************
+ * drivers/rptun/rpmsg_rpc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A remote procedure call layer for the services between cpus.  A client
+ * builds its calls in place in an rpmsg tx buffer, which is shared memory,
+ * and sends it without copying.  The server runs the handlers on the
+ * arguments in the rx buffer, and they write their results in place in the
+ * tx buffer of the reply.  Several calls can share one message, and the
+ * reply matches its batch through the cookie of the header, so that any
+ * number of batches may be in flight.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <debug.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/rptun/rpmsg_rpc.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RPMSG_RPC_NAME_PREFIX_LEN  (sizeof(RPMSG_RPC_NAME_PREFIX) - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The endpoint of a client on the server */
+
+struct rpmsg_rpc_server_s
+{
+  struct rpmsg_endpoint ept;
+  FAR const struct rpmsg_rpc_service_s *service;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static bool rpmsg_rpc_ns_match(FAR struct rpmsg_device *rdev,
+                               FAR void *priv, FAR const char *name,
+                               uint32_t dest);
+static void rpmsg_rpc_ns_bind(FAR struct rpmsg_device *rdev,
+                              FAR void *priv, FAR const char *name,
+                              uint32_t dest);
+static void rpmsg_rpc_ns_unbind(FAR struct rpmsg_endpoint *ept);
+static int  rpmsg_rpc_server_ept_cb(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+
+static void rpmsg_rpc_device_created(FAR struct rpmsg_device *rdev,
+                                     FAR void *priv);
+static void rpmsg_rpc_device_destroy(FAR struct rpmsg_device *rdev,
+                                     FAR void *priv);
+static void rpmsg_rpc_ns_bound(FAR struct rpmsg_endpoint *ept);
+static int  rpmsg_rpc_client_ept_cb(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ns_match
+ ****************************************************************************/
+
+static bool rpmsg_rpc_ns_match(FAR struct rpmsg_device *rdev,
+                               FAR void *priv, FAR const char *name,
+                               uint32_t dest)
+{
+  FAR const struct rpmsg_rpc_service_s *service = priv;
+
+  return !strncmp(name, RPMSG_RPC_NAME_PREFIX,
+                  RPMSG_RPC_NAME_PREFIX_LEN) &&
+         !strcmp(name + RPMSG_RPC_NAME_PREFIX_LEN, service->name);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ns_bind
+ ****************************************************************************/
+
+static void rpmsg_rpc_ns_bind(FAR struct rpmsg_device *rdev,
+                              FAR void *priv, FAR const char *name,
+                              uint32_t dest)
+{
+  FAR struct rpmsg_rpc_server_s *server;
+  int ret;
+
+  server = kmm_zalloc(sizeof(*server));
+  if (server == NULL)
+    {
+      _err("rpc server malloc failed\n");
+      return;
+    }
+
+  server->service  = priv;
+  server->ept.priv = server;
+
+  ret = rpmsg_create_ept(&server->ept, rdev, name,
+                         RPMSG_ADDR_ANY, dest,
+                         rpmsg_rpc_server_ept_cb, rpmsg_rpc_ns_unbind);
+  if (ret < 0)
+    {
+      _err("rpc endpoint create failed, ret=%d\n", ret);
+      kmm_free(server);
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ns_unbind
+ ****************************************************************************/
+
+static void rpmsg_rpc_ns_unbind(FAR struct rpmsg_endpoint *ept)
+{
+  FAR struct rpmsg_rpc_server_s *server = ept->priv;
+
+  rpmsg_destroy_ept(&server->ept);
+  kmm_free(server);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_server_ept_cb
+ *
+ * Description:
+ *   Run the calls of a message in order and send their results in one
+ *   reply.  A result that does not fit in the reply fails with -E2BIG.
+ *
+ ****************************************************************************/
+
+static int rpmsg_rpc_server_ept_cb(FAR struct rpmsg_endpoint *ept,
+                                   FAR void *data, size_t len,
+                                   uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsg_rpc_server_s *server = ept->priv;
+  FAR const struct rpmsg_rpc_service_s *service = server->service;
+  FAR const struct rpmsg_rpc_method_s *method;
+  FAR struct rpmsg_rpc_header_s *header = data;
+  FAR struct rpmsg_rpc_header_s *rsp;
+  FAR struct rpmsg_rpc_entry_s *call;
+  FAR struct rpmsg_rpc_entry_s *ret;
+  FAR uint8_t *res;
+  uint32_t space;
+  size_t inoff;
+  size_t outoff;
+  uint32_t i;
+
+  if (len < sizeof(*header) || header->command != RPMSG_RPC_CALL)
+    {
+      return -EINVAL;
+    }
+
+  rsp = rpmsg_get_reply_buffer(ept, header, sizeof(*header), &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  rsp->command = RPMSG_RPC_REPLY;
+  rsp->count   = 0;
+
+  inoff  = sizeof(*header);
+  outoff = sizeof(*rsp);
+
+  for (i = 0; i < header->count; i++)
+    {
+      call = (FAR struct rpmsg_rpc_entry_s *)((FAR uint8_t *)data + inoff);
+      if (inoff + sizeof(*call) > len ||
+          inoff + sizeof(*call) + RPMSG_RPC_ALIGN(call->len) > len ||
+          outoff + sizeof(*ret) > space)
+        {
+          break;
+        }
+
+      ret = (FAR struct rpmsg_rpc_entry_s *)((FAR uint8_t *)rsp + outoff);
+      res = (FAR uint8_t *)(ret + 1);
+
+      ret->method   = call->method;
+      ret->len      = 0;
+      ret->reserved = 0;
+
+      method = call->method < service->nmethods ?
+               &service->methods[call->method] : NULL;
+      if (method == NULL || method->handler == NULL)
+        {
+          ret->result = -ENOSYS;
+        }
+      else if (call->len != method->arglen)
+        {
+          ret->result = -EINVAL;
+        }
+      else if (outoff + sizeof(*ret) + method->reslen > space)
+        {
+          ret->result = -E2BIG;
+        }
+      else
+        {
+          memset(res, 0, method->reslen);
+          ret->result = method->handler(service->priv, call + 1, res);
+          ret->len    = method->reslen;
+        }
+
+      inoff  += sizeof(*call) + RPMSG_RPC_ALIGN(call->len);
+      outoff += sizeof(*ret) + RPMSG_RPC_ALIGN(ret->len);
+      if (outoff > space)
+        {
+          outoff = space;
+        }
+
+      rsp->count++;
+    }
+
+  return rpmsg_send_nocopy(ept, rsp, outoff);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_device_created
+ ****************************************************************************/
+
+static void rpmsg_rpc_device_created(FAR struct rpmsg_device *rdev,
+                                     FAR void *priv)
+{
+  FAR struct rpmsg_rpc_s *rpc = priv;
+  char buf[RPMSG_NAME_SIZE];
+
+  if (strcmp(rpc->remotecpu, rpmsg_get_cpuname(rdev)) == 0)
+    {
+      rpc->ept.priv = rpc;
+      rpc->ept.ns_bound_cb = rpmsg_rpc_ns_bound;
+      snprintf(buf, sizeof(buf), "%s%s", RPMSG_RPC_NAME_PREFIX, rpc->name);
+      rpmsg_create_ept(&rpc->ept, rdev, buf,
+                       RPMSG_ADDR_ANY, RPMSG_ADDR_ANY,
+                       rpmsg_rpc_client_ept_cb, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_device_destroy
+ ****************************************************************************/
+
+static void rpmsg_rpc_device_destroy(FAR struct rpmsg_device *rdev,
+                                     FAR void *priv)
+{
+  FAR struct rpmsg_rpc_s *rpc = priv;
+
+  if (strcmp(rpc->remotecpu, rpmsg_get_cpuname(rdev)) == 0)
+    {
+      rpmsg_destroy_ept(&rpc->ept);
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ns_bound
+ ****************************************************************************/
+
+static void rpmsg_rpc_ns_bound(FAR struct rpmsg_endpoint *ept)
+{
+  FAR struct rpmsg_rpc_s *rpc = ept->priv;
+
+  rpmsg_post(&rpc->ept, &rpc->wait);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_client_ept_cb
+ *
+ * Description:
+ *   Copy the results of a reply to its batch and complete it.
+ *
+ ****************************************************************************/
+
+static int rpmsg_rpc_client_ept_cb(FAR struct rpmsg_endpoint *ept,
+                                   FAR void *data, size_t len,
+                                   uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsg_rpc_header_s *header = data;
+  FAR struct rpmsg_rpc_batch_s *batch;
+  FAR struct rpmsg_rpc_entry_s *ret;
+  size_t off = sizeof(*header);
+  uint32_t i;
+
+  if (len < sizeof(*header) || header->command != RPMSG_RPC_REPLY)
+    {
+      return -EINVAL;
+    }
+
+  batch = (FAR struct rpmsg_rpc_batch_s *)(uintptr_t)header->cookie;
+
+  for (i = 0; i < header->count && i < batch->count; i++)
+    {
+      ret = (FAR struct rpmsg_rpc_entry_s *)((FAR uint8_t *)data + off);
+      if (off + sizeof(*ret) > len ||
+          off + sizeof(*ret) + ret->len > len)
+        {
+          break;
+        }
+
+      batch->status[i] = ret->result;
+      if (ret->result >= 0)
+        {
+          if (ret->len == batch->reslen[i])
+            {
+              memcpy(batch->res[i], ret + 1, ret->len);
+            }
+          else
+            {
+              batch->status[i] = -EPROTO;
+            }
+        }
+
+      off += sizeof(*ret) + RPMSG_RPC_ALIGN(ret->len);
+    }
+
+  if (batch->done != NULL)
+    {
+      batch->done(batch, batch->arg);
+      return 0;
+    }
+
+  return rpmsg_post(ept, &batch->sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rpmsg_rpc_register
+ ****************************************************************************/
+
+int rpmsg_rpc_register(FAR const struct rpmsg_rpc_service_s *service)
+{
+  DEBUGASSERT(service != NULL && service->name != NULL);
+  DEBUGASSERT(strlen(service->name) + RPMSG_RPC_NAME_PREFIX_LEN <
+              RPMSG_NAME_SIZE);
+
+  return rpmsg_register_callback((FAR void *)service,
+                                 NULL,
+                                 NULL,
+                                 rpmsg_rpc_ns_match,
+                                 rpmsg_rpc_ns_bind);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_connect
+ ****************************************************************************/
+
+int rpmsg_rpc_connect(FAR struct rpmsg_rpc_s *rpc,
+                      FAR const char *remotecpu, FAR const char *name)
+{
+  int ret;
+
+  if (rpc == NULL || remotecpu == NULL || name == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(rpc, 0, sizeof(*rpc));
+  rpc->remotecpu = remotecpu;
+  rpc->name      = name;
+  nxsem_init(&rpc->wait, 0, 0);
+
+  ret = rpmsg_register_callback(rpc,
+                                rpmsg_rpc_device_created,
+                                rpmsg_rpc_device_destroy,
+                                NULL,
+                                NULL);
+  if (ret < 0)
+    {
+      nxsem_destroy(&rpc->wait);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_disconnect
+ ****************************************************************************/
+
+void rpmsg_rpc_disconnect(FAR struct rpmsg_rpc_s *rpc)
+{
+  rpmsg_unregister_callback(rpc,
+                            rpmsg_rpc_device_created,
+                            rpmsg_rpc_device_destroy,
+                            NULL,
+                            NULL);
+  nxsem_destroy(&rpc->wait);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_init
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_init(FAR struct rpmsg_rpc_s *rpc,
+                         FAR struct rpmsg_rpc_batch_s *batch)
+{
+  FAR struct rpmsg_rpc_header_s *header;
+  int sval;
+  int ret;
+
+  /* Wait for the service to be bound, once */
+
+  nxsem_get_value(&rpc->wait, &sval);
+  if (sval <= 0)
+    {
+      ret = rpmsg_wait(&rpc->ept, &rpc->wait);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      rpmsg_post(&rpc->ept, &rpc->wait);
+    }
+
+  batch->rpc   = rpc;
+  batch->count = 0;
+  batch->msg   = rpmsg_get_tx_payload_buffer(&rpc->ept, &batch->space, true);
+  if (batch->msg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  header          = (FAR struct rpmsg_rpc_header_s *)batch->msg;
+  header->command = RPMSG_RPC_CALL;
+  header->count   = 0;
+  header->cookie  = (uintptr_t)batch;
+  batch->len      = sizeof(*header);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_add
+ ****************************************************************************/
+
+FAR void *rpmsg_rpc_batch_add(FAR struct rpmsg_rpc_batch_s *batch,
+                              uint32_t method, size_t arglen,
+                              FAR void *res, size_t reslen)
+{
+  FAR struct rpmsg_rpc_entry_s *call;
+  size_t size = sizeof(*call) + RPMSG_RPC_ALIGN(arglen);
+
+  if (batch->count >= CONFIG_RPMSG_RPC_BATCH ||
+      batch->len + size > batch->space)
+    {
+      return NULL;
+    }
+
+  call = (FAR struct rpmsg_rpc_entry_s *)(batch->msg + batch->len);
+  call->method   = method;
+  call->result   = 0;
+  call->len      = arglen;
+  call->reserved = 0;
+
+  batch->res[batch->count]    = res;
+  batch->reslen[batch->count] = reslen;
+  batch->status[batch->count] = -E2BIG;
+  batch->count++;
+  batch->len += size;
+
+  return call + 1;
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_send
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_send(FAR struct rpmsg_rpc_batch_s *batch,
+                         rpmsg_rpc_done_t done, FAR void *arg)
+{
+  FAR struct rpmsg_rpc_header_s *header =
+    (FAR struct rpmsg_rpc_header_s *)batch->msg;
+  int ret;
+
+  header->count = batch->count;
+  batch->done   = done;
+  batch->arg    = arg;
+
+  ret = rpmsg_send_nocopy(&batch->rpc->ept, batch->msg, batch->len);
+  batch->msg    = NULL;
+  batch->result = ret < 0 ? ret : OK;
+  return batch->result;
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_call
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_call(FAR struct rpmsg_rpc_batch_s *batch)
+{
+  int ret;
+
+  nxsem_init(&batch->sem, 0, 0);
+
+  ret = rpmsg_rpc_batch_send(batch, NULL, NULL);
+  if (ret >= 0)
+    {
+      ret = rpmsg_wait(&batch->rpc->ept, &batch->sem);
+    }
+
+  nxsem_destroy(&batch->sem);
+  batch->result = ret < 0 ? ret : OK;
+  return batch->result;
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_result
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_result(FAR struct rpmsg_rpc_batch_s *batch,
+                           uint32_t index)
+{
+  if (index >= batch->count)
+    {
+      return -EINVAL;
+    }
+
+  return batch->result < 0 ? batch->result : batch->status[index];
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_call
+ ****************************************************************************/
+
+int rpmsg_rpc_call(FAR struct rpmsg_rpc_s *rpc, uint32_t method,
+                   FAR const void *arg, size_t arglen,
+                   FAR void *res, size_t reslen)
+{
+  struct rpmsg_rpc_batch_s batch;
+  FAR void *buf;
+  int ret;
+
+  ret = rpmsg_rpc_batch_init(rpc, &batch);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  buf = rpmsg_rpc_batch_add(&batch, method, arglen, res, reslen);
+  if (buf == NULL)
+    {
+      /* The tx buffer cannot be given back: send it empty */
+
+      rpmsg_rpc_batch_call(&batch);
+      return -E2BIG;
+    }
+
+  memcpy(buf, arg, arglen);
+
+  ret = rpmsg_rpc_batch_call(&batch);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return rpmsg_rpc_batch_result(&batch, 0);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_set
+ ****************************************************************************/
+
+void rpmsg_rpc_ref_set(FAR struct rpmsg_rpc_ref_s *ref,
+                       FAR const void *buf, size_t len)
+{
+  ref->addr     = (uintptr_t)buf;
+  ref->len      = len;
+  ref->reserved = 0;
+
+  up_clean_dcache((uintptr_t)buf, (uintptr_t)buf + len);
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_done
+ ****************************************************************************/
+
+void rpmsg_rpc_ref_done(FAR const struct rpmsg_rpc_ref_s *ref)
+{
+  up_invalidate_dcache((uintptr_t)ref->addr,
+                       (uintptr_t)(ref->addr + ref->len));
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_map
+ ****************************************************************************/
+
+FAR void *rpmsg_rpc_ref_map(FAR const struct rpmsg_rpc_ref_s *ref)
+{
+  uint64_t base = CONFIG_RPMSG_RPC_SHMEM_BASE;
+  uint64_t size = CONFIG_RPMSG_RPC_SHMEM_SIZE;
+
+  if (ref->addr < base || ref->len > size ||
+      ref->addr - base > size - ref->len)
+    {
+      return NULL;
+    }
+
+  up_invalidate_dcache((uintptr_t)ref->addr,
+                       (uintptr_t)(ref->addr + ref->len));
+  return (FAR void *)(uintptr_t)ref->addr;
+}
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_unmap
+ ****************************************************************************/
+
+void rpmsg_rpc_ref_unmap(FAR const struct rpmsg_rpc_ref_s *ref)
+{
+  up_clean_dcache((uintptr_t)ref->addr, (uintptr_t)(ref->addr + ref->len));
+}
@@ -25,7 +25,9 @@
 #include <nuttx/config.h>
 
 #include <inttypes.h>
+#include <sched.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 
 #include <nuttx/arch.h>
@@ -83,6 +85,12 @@ struct rptun_priv_s
 #ifdef CONFIG_RPTUN_PING
   struct rpmsg_endpoint        ping;
 #endif
+#ifdef CONFIG_RPTUN_NOTIFY_ADAPTIVE
+  bool                         polling;
+#endif
+  unsigned long                nkicks;    /* Notifications sent */
+  unsigned long                nnotifies; /* Notifications received */
+  unsigned long                npolls;    /* Rx batches found by polling */
 };
 
 struct rptun_bind_s
@@ -229,6 +237,65 @@ static inline void rptun_pm_action(FAR struct rptun_priv_s *priv,
 #  define rptun_pm_action(priv, stay)
 #endif
 
+#ifdef CONFIG_RPTUN_NOTIFY_ADAPTIVE
+static void rptun_wakeup_rx(FAR struct rptun_priv_s *priv);
+
+/* Under sustained load, a notification finds several messages queued.
+ * Then the notifications of the remote are disabled through the flags of
+ * the rx vring, which the remote checks before each kick, and the ring is
+ * polled instead until it stays empty.  So a burst costs the remote no
+ * kick per message and this cpu no interrupt per message.
+ */
+
+static void rptun_poll(FAR struct rptun_priv_s *priv)
+{
+  FAR struct virtqueue *rvq = priv->rvdev.rvq;
+  int idle = 0;
+  int nused;
+
+  if (priv->polling || priv->rproc.state != RPROC_RUNNING || rvq == NULL)
+    {
+      remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+      return;
+    }
+
+  nused = rptun_buffer_nused(&priv->rvdev, true);
+  remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+  if (nused < CONFIG_RPTUN_NOTIFY_BUSY)
+    {
+      return;
+    }
+
+  priv->polling = true;
+  virtqueue_disable_cb(rvq);
+
+  while (idle < CONFIG_RPTUN_POLL_IDLE)
+    {
+      sched_yield();
+
+      if (rptun_buffer_nused(&priv->rvdev, true) > 0)
+        {
+          priv->npolls++;
+          idle = 0;
+          remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+        }
+      else
+        {
+          idle++;
+        }
+    }
+
+  priv->polling = false;
+
+  /* Messages queued before the flags were restored came without a kick */
+
+  if (virtqueue_enable_cb(rvq))
+    {
+      rptun_wakeup_rx(priv);
+    }
+}
+#endif
+
 static void rptun_worker(FAR void *arg)
 {
   FAR struct rptun_priv_s *priv = arg;
@@ -251,7 +318,11 @@ static void rptun_worker(FAR void *arg)
     }
 
   priv->cmd = RPTUNIOC_NONE;
+#ifdef CONFIG_RPTUN_NOTIFY_ADAPTIVE
+  rptun_poll(priv);
+#else
   remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+#endif
 }
 
 #ifdef CONFIG_RPTUN_WORKQUEUE
@@ -325,6 +396,8 @@ static int rptun_callback(FAR void *arg, uint32_t vqid)
   FAR struct virtqueue *svq = rvdev->svq;
   FAR struct virtqueue *rvq = rvdev->rvq;
 
+  priv->nnotifies++;
+
   if (vqid == RPTUN_NOTIFY_ALL ||
       vqid == vdev->vrings_info[rvq->vq_queue_index].notifyid)
     {
@@ -407,6 +480,7 @@ static int rptun_notify(FAR struct remoteproc *rproc, uint32_t id)
       rptun_pm_action(priv, true);
     }
 
+  priv->nkicks++;
   RPTUN_NOTIFY(priv->dev, id);
   return 0;
 }
@@ -822,11 +896,18 @@ static int rptun_do_ioctl(FAR struct rptun_priv_s *priv, int cmd,
         break;
       case RPTUNIOC_DUMP:
         rptun_dump(&priv->rvdev);
+        metal_log(METAL_LOG_EMERGENCY,
+                  "  notifications: sent %lu, received %lu, polled %lu\n",
+                  priv->nkicks, priv->nnotifies, priv->npolls);
         break;
 #ifdef CONFIG_RPTUN_PING
       case RPTUNIOC_PING:
         rptun_ping(&priv->ping, (FAR const struct rptun_ping_s *)arg);
         break;
+      case RPTUNIOC_BENCH:
+        ret = rptun_bench(&priv->ping,
+                          (FAR const struct rptun_bench_s *)arg);
+        break;
 #endif
       default:
         ret = -ENOTTY;
@@ -1009,7 +1090,19 @@ int rpmsg_wait(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem)
           break;
         }
 
-      nxsem_wait(&priv->semtx);
+#ifdef CONFIG_RPTUN_NOTIFY_ADAPTIVE
+      /* The remote does not kick while polling, look at the ring again */
+
+      if (priv->polling)
+        {
+          nxsem_tickwait(&priv->semtx, 1);
+        }
+      else
+#endif
+        {
+          nxsem_wait(&priv->semtx);
+        }
+
       rptun_worker(priv);
     }
 
@@ -1039,6 +1132,43 @@ int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem)
   return ret;
 }
 
+/****************************************************************************
+ * Name: rpmsg_get_reply_buffer
+ *
+ * Description:
+ *   Get a tx payload buffer for the response to the request 'req' and copy
+ *   the first 'hdrlen' bytes of the request into it.  The service then
+ *   builds the rest of the response in place and sends it with
+ *   rpmsg_send_nocopy(), instead of building it in the rx buffer and
+ *   having rpmsg_send() copy the whole message again.
+ *
+ * Input Parameters:
+ *   ept    - The endpoint the request was received on
+ *   req    - The received request
+ *   hdrlen - The number of bytes of the request to echo in the response
+ *   len    - Returns the size of the tx buffer
+ *
+ * Returned Value:
+ *   The tx buffer, or NULL if no buffer is available.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_get_reply_buffer(FAR struct rpmsg_endpoint *ept,
+                                 FAR const void *req, size_t hdrlen,
+                                 FAR uint32_t *len)
+{
+  FAR void *buf;
+
+  buf = rpmsg_get_tx_payload_buffer(ept, len, true);
+  if (buf != NULL)
+    {
+      DEBUGASSERT(hdrlen <= *len);
+      memcpy(buf, req, hdrlen);
+    }
+
+  return buf;
+}
+
 FAR const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev)
 {
   FAR struct rptun_priv_s *priv = rptun_get_priv_by_rdev(rdev);
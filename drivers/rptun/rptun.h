@@ -40,5 +40,7 @@ int rptun_ping_init(FAR struct rpmsg_virtio_device *rvdev,
 void rptun_ping_deinit(FAR struct rpmsg_endpoint *ept);
 int rptun_ping(FAR struct rpmsg_endpoint *ept,
                FAR const struct rptun_ping_s *ping);
+int rptun_bench(FAR struct rpmsg_endpoint *ept,
+                FAR const struct rptun_bench_s *bench);
 
 #endif /* __DRIVERS_RPTUN_RPTUN_H */
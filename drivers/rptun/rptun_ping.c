@@ -26,6 +26,7 @@
 #include <nuttx/arch.h>
 
 #include <inttypes.h>
+#include <limits.h>
 #include <string.h>
 
 #include "rptun.h"
@@ -47,6 +48,10 @@
 #define RPTUN_PING_SEND_NOACK       2
 #define RPTUN_PING_ACK              3
 
+/* The latency histogram has a bucket per power of two microseconds */
+
+#define RPTUN_BENCH_NBUCKETS        16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -128,6 +133,109 @@ static int rptun_ping_once(FAR struct rpmsg_endpoint *ept,
   return ret;
 }
 
+static uint64_t rptun_ping_nsec(uint32_t elapsed)
+{
+  struct timespec ts;
+
+  up_perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static int rptun_bench_latency(FAR struct rpmsg_endpoint *ept,
+                               int times, int len)
+{
+  uint32_t hist[RPTUN_BENCH_NBUCKETS];
+  uint64_t min = UINT64_MAX;
+  uint64_t max = 0;
+  uint64_t total = 0;
+  uint64_t ns;
+  uint32_t tm;
+  int bucket;
+  int ret;
+  int i;
+
+  memset(hist, 0, sizeof(hist));
+
+  for (i = 0; i < times; i++)
+    {
+      tm  = up_perf_gettime();
+      ret = rptun_ping_once(ept, len, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ns     = rptun_ping_nsec(up_perf_gettime() - tm);
+      min    = MIN(min, ns);
+      max    = MAX(max, ns);
+      total += ns;
+
+      bucket = 0;
+      while (bucket < RPTUN_BENCH_NBUCKETS - 1 &&
+             ns >= ((uint64_t)NSEC_PER_USEC << bucket))
+        {
+          bucket++;
+        }
+
+      hist[bucket]++;
+    }
+
+  syslog(LOG_INFO, "len %d: round trip avg %" PRIu64 " ns, min %"
+         PRIu64 " ns, max %" PRIu64 " ns\n", len, total / times, min, max);
+
+  for (i = 0; i < RPTUN_BENCH_NBUCKETS; i++)
+    {
+      if (hist[i] != 0)
+        {
+          syslog(LOG_INFO, "  %s %5lu us: %" PRIu32 "\n",
+                 i < RPTUN_BENCH_NBUCKETS - 1 ? "< " : ">=",
+                 1ul << (i < RPTUN_BENCH_NBUCKETS - 1 ? i : i - 1),
+                 hist[i]);
+        }
+    }
+
+  return 0;
+}
+
+static int rptun_bench_throughput(FAR struct rpmsg_endpoint *ept,
+                                  int times, int len)
+{
+  uint64_t bytes = 0;
+  uint64_t ns = 0;
+  uint32_t prev;
+  uint32_t now;
+  int ret;
+  int i;
+
+  /* Sum the intervals so that the 32-bit counter may wrap in the run */
+
+  prev = up_perf_gettime();
+  for (i = 0; i <= times; i++)
+    {
+      /* The last ping is acknowledged once all the others are received */
+
+      ret = rptun_ping_once(ept, len, i == times);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      now   = up_perf_gettime();
+      ns   += rptun_ping_nsec(now - prev);
+      prev  = now;
+
+      if (i < times)
+        {
+          bytes += ret;
+        }
+    }
+
+  syslog(LOG_INFO, "len %d: throughput %" PRIu64 " KiB/s\n", len,
+         ns > 0 ? bytes * NSEC_PER_SEC / ns / 1024 : 0);
+
+  return 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -179,6 +287,43 @@ int rptun_ping(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+int rptun_bench(FAR struct rpmsg_endpoint *ept,
+                FAR const struct rptun_bench_s *bench)
+{
+  int len;
+  int ret;
+
+  if (!ept || !bench || bench->times <= 0 || bench->minlen <= 0 ||
+      bench->maxlen < bench->minlen)
+    {
+      return -EINVAL;
+    }
+
+  syslog(LOG_INFO, "current CPU freq: %" PRIu32 ", bench times: %d\n",
+                    up_perf_getfreq(), bench->times);
+
+  for (len = bench->minlen; len <= bench->maxlen; len *= 2)
+    {
+      ret = rptun_bench_latency(ept, bench->times, len);
+      if (ret >= 0)
+        {
+          ret = rptun_bench_throughput(ept, bench->times, len);
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (len > INT_MAX / 2)
+        {
+          break;
+        }
+    }
+
+  return 0;
+}
+
 int rptun_ping_init(FAR struct rpmsg_virtio_device *rvdev,
                     FAR struct rpmsg_endpoint *ept)
 {
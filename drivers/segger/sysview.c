@@ -23,6 +23,8 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 
 #include <nuttx/clock.h>
@@ -35,13 +37,109 @@
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+
+/* The SystemView event IDs of the raw packets.  The IDs below 24 are sent
+ * without a length.
+ */
+
+#  define SYSVIEW_RAW_OVERFLOW        1
+#  define SYSVIEW_RAW_ISR_ENTER       2
+#  define SYSVIEW_RAW_ISR_EXIT        3
+#  define SYSVIEW_RAW_TASK_START_EXEC 4
+#  define SYSVIEW_RAW_TASK_STOP_EXEC  5
+#  define SYSVIEW_RAW_TASK_CREATE     8
+#  define SYSVIEW_RAW_TASK_INFO       9
+#  define SYSVIEW_RAW_TRACE_START     10
+#  define SYSVIEW_RAW_SYSTIME_CYCLES  12
+#  define SYSVIEW_RAW_MARK_START      15
+#  define SYSVIEW_RAW_MARK_STOP       16
+#  define SYSVIEW_RAW_IDLE            17
+#  define SYSVIEW_RAW_INIT            24
+#  define SYSVIEW_RAW_TASK_TERMINATE  29
+
+#  define SYSVIEW_RAW_SHORTIDS        24
+
+/* The largest packet: a task info with a name of 32 characters */
+
+#  define SYSVIEW_RAW_MAXNAME         32
+#  define SYSVIEW_RAW_MAXPACKET       64
+
+#  define SYSVIEW_RAW_ID(id) ((uint32_t)(id) - CONFIG_SEGGER_SYSVIEW_RAM_BASE)
+
+#  define SYSVIEW_IS_STARTED()        g_sysview.raw_enabled
+#  define SYSVIEW_START()             sysview_raw_start()
+#  define SYSVIEW_STOP()              (g_sysview.raw_enabled = false)
+#  define SYSVIEW_ON_TASK_CREATE(id) \
+     sysview_raw_event1(SYSVIEW_RAW_TASK_CREATE, SYSVIEW_RAW_ID(id))
+#  define SYSVIEW_ON_TASK_TERMINATE(id) \
+     sysview_raw_event1(SYSVIEW_RAW_TASK_TERMINATE, SYSVIEW_RAW_ID(id))
+#  define SYSVIEW_ON_TASK_START_EXEC(id) \
+     sysview_raw_event1(SYSVIEW_RAW_TASK_START_EXEC, SYSVIEW_RAW_ID(id))
+#  define SYSVIEW_ON_TASK_STOP_EXEC() \
+     sysview_raw_event(SYSVIEW_RAW_TASK_STOP_EXEC, NULL, 0, NULL)
+#  define SYSVIEW_ON_IDLE() \
+     sysview_raw_event(SYSVIEW_RAW_IDLE, NULL, 0, NULL)
+#  define SYSVIEW_RECORD_ENTER_ISR() \
+     sysview_raw_event1(SYSVIEW_RAW_ISR_ENTER, sysview_get_interrupt_id())
+#  define SYSVIEW_RECORD_EXIT_ISR() \
+     sysview_raw_event(SYSVIEW_RAW_ISR_EXIT, NULL, 0, NULL)
+#  define SYSVIEW_MARK_START(nr) \
+     sysview_raw_event1(SYSVIEW_RAW_MARK_START, nr)
+#  define SYSVIEW_MARK_STOP(nr) \
+     sysview_raw_event1(SYSVIEW_RAW_MARK_STOP, nr)
+
+/* The host resolves the names of the syscalls itself */
+
+#  define SYSVIEW_NAME_MARKER(nr, name)
+#else
+#  define SYSVIEW_IS_STARTED()           SEGGER_SYSVIEW_IsStarted()
+#  define SYSVIEW_START()                SEGGER_SYSVIEW_Start()
+#  define SYSVIEW_STOP()                 SEGGER_SYSVIEW_Stop()
+#  define SYSVIEW_ON_TASK_CREATE(id)     SEGGER_SYSVIEW_OnTaskCreate(id)
+#  define SYSVIEW_ON_TASK_TERMINATE(id)  SEGGER_SYSVIEW_OnTaskTerminate(id)
+#  define SYSVIEW_ON_TASK_START_EXEC(id) SEGGER_SYSVIEW_OnTaskStartExec(id)
+#  define SYSVIEW_ON_TASK_STOP_EXEC()    SEGGER_SYSVIEW_OnTaskStopExec()
+#  define SYSVIEW_ON_IDLE()              SEGGER_SYSVIEW_OnIdle()
+#  define SYSVIEW_RECORD_ENTER_ISR()     SEGGER_SYSVIEW_RecordEnterISR()
+#  define SYSVIEW_RECORD_EXIT_ISR()      SEGGER_SYSVIEW_RecordExitISR()
+#  define SYSVIEW_MARK_START(nr)         SEGGER_SYSVIEW_MarkStart(nr)
+#  define SYSVIEW_MARK_STOP(nr)          SEGGER_SYSVIEW_MarkStop(nr)
+#  define SYSVIEW_NAME_MARKER(nr, name)  SEGGER_SYSVIEW_NameMarker(nr, name)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+
+/* The stream of one CPU.  Only that CPU writes to it, with its interrupts
+ * disabled, so that no lock is needed.
+ */
+
+struct sysview_raw_s
+{
+  int                          channel;  /* RTT up-buffer of the stream */
+  unsigned int                 session;  /* Session of the stream header */
+  uint32_t                     last;     /* Timestamp of the last packet */
+  uint32_t                     dropped;  /* Packets lost to a full buffer */
+  char                         name[12]; /* Name of the RTT up-buffer */
+};
+#endif
+
 struct sysview_s
 {
   unsigned int                 irq[CONFIG_SMP_NCPUS];
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+  struct sysview_raw_s         raw[CONFIG_SMP_NCPUS];
+  volatile unsigned int        raw_session; /* Incremented on each start */
+  volatile bool                raw_enabled;
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
   struct note_filter_mode_s    mode;
 #endif
@@ -71,16 +169,270 @@ static struct sysview_s g_sysview =
 #endif
 };
 
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+static uint8_t g_sysview_rawbuf[CONFIG_SMP_NCPUS]
+                               [CONFIG_SEGGER_SYSVIEW_RTT_BUFFER_SIZE]
+#  ifdef SEGGER_RTT_BUFFER_SECTION
+  locate_data(SEGGER_RTT_BUFFER_SECTION)
+#  endif
+  ;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+
+/****************************************************************************
+ * Name: sysview_raw_encode
+ *
+ * Description:
+ *   Append a value in the variable length encoding of SystemView:  7 bits
+ *   per byte, least significant first, the top bit set if more follow.
+ *
+ ****************************************************************************/
+
+static inline FAR uint8_t *sysview_raw_encode(FAR uint8_t *p, uint32_t value)
+{
+  while (value > 0x7f)
+    {
+      *p++ = (uint8_t)(value | 0x80);
+      value >>= 7;
+    }
+
+  *p++ = (uint8_t)value;
+  return p;
+}
+
+/****************************************************************************
+ * Name: sysview_raw_write
+ *
+ * Description:
+ *   Append the time stamp delta to an encoded packet and write it to the
+ *   stream.  The packet is dropped if the RTT buffer is full:  The number
+ *   of dropped packets is sent in an overflow packet before the next one.
+ *
+ * Assumptions:
+ *   The interrupts of this CPU are disabled.  p has room for 5 bytes.
+ *
+ ****************************************************************************/
+
+static bool sysview_raw_write(FAR struct sysview_raw_s *raw,
+                              FAR uint8_t *start, FAR uint8_t *p)
+{
+  uint8_t overflow[11];
+  FAR uint8_t *q;
+  uint32_t now;
+
+  now = sysview_get_timestamp();
+
+  if (raw->dropped > 0)
+    {
+      q    = overflow;
+      *q++ = SYSVIEW_RAW_OVERFLOW;
+      q    = sysview_raw_encode(q, raw->dropped);
+      q    = sysview_raw_encode(q, now - raw->last);
+
+      if (SEGGER_RTT_WriteSkipNoLock(raw->channel, overflow,
+                                     q - overflow) == 0)
+        {
+          raw->dropped++;
+          return false;
+        }
+
+      raw->dropped = 0;
+      raw->last    = now;
+    }
+
+  p = sysview_raw_encode(p, now - raw->last);
+  if (SEGGER_RTT_WriteSkipNoLock(raw->channel, start, p - start) == 0)
+    {
+      raw->dropped++;
+      return false;
+    }
+
+  raw->last = now;
+  return true;
+}
+
+/****************************************************************************
+ * Name: sysview_raw_packet
+ *
+ * Description:
+ *   Encode and write one packet.  packet must have SYSVIEW_RAW_MAXPACKET
+ *   bytes.
+ *
+ ****************************************************************************/
+
+static bool sysview_raw_packet(FAR struct sysview_raw_s *raw,
+                               FAR uint8_t *packet, uint8_t id,
+                               FAR const uint32_t *params, int nparams,
+                               FAR const char *str)
+{
+  FAR uint8_t *start = packet + 2;
+  FAR uint8_t *p = start;
+  size_t len;
+  int i;
+
+  for (i = 0; i < nparams; i++)
+    {
+      p = sysview_raw_encode(p, params[i]);
+    }
+
+  if (str != NULL)
+    {
+      len  = strnlen(str, SYSVIEW_RAW_MAXNAME);
+      *p++ = len;
+      memcpy(p, str, len);
+      p   += len;
+    }
+
+  /* Prepend the ID, and the length of the payload for the long packets */
+
+  if (id >= SYSVIEW_RAW_SHORTIDS)
+    {
+      len      = p - start;
+      *--start = len;
+    }
+
+  *--start = id;
+  return sysview_raw_write(raw, start, p);
+}
+
+/****************************************************************************
+ * Name: sysview_raw_header
+ *
+ * Description:
+ *   Start the stream of this CPU for the current session:  The sync bytes,
+ *   the start of the trace, the frequency of the time stamps and the
+ *   absolute time of the first packet.
+ *
+ ****************************************************************************/
+
+static bool sysview_raw_header(FAR struct sysview_raw_s *raw,
+                               FAR uint8_t *packet)
+{
+  uint32_t freq = up_perf_getfreq();
+  uint32_t params[4];
+
+  memset(packet, 0, 10);
+  if (SEGGER_RTT_WriteSkipNoLock(raw->channel, packet, 10) == 0)
+    {
+      return false;
+    }
+
+  raw->session = g_sysview.raw_session;
+  raw->dropped = 0;
+  raw->last    = sysview_get_timestamp();
+
+  sysview_raw_packet(raw, packet, SYSVIEW_RAW_TRACE_START, NULL, 0, NULL);
+
+  params[0] = freq;
+  params[1] = freq;
+  params[2] = CONFIG_SEGGER_SYSVIEW_RAM_BASE;
+  params[3] = 0;
+  sysview_raw_packet(raw, packet, SYSVIEW_RAW_INIT, params, 4, NULL);
+
+  params[0] = raw->last;
+  sysview_raw_packet(raw, packet, SYSVIEW_RAW_SYSTIME_CYCLES, params, 1,
+                     NULL);
+  return true;
+}
+
+/****************************************************************************
+ * Name: sysview_raw_event
+ *
+ * Description:
+ *   Write one event to the stream of this CPU.
+ *
+ ****************************************************************************/
+
+static void sysview_raw_event(uint8_t id, FAR const uint32_t *params,
+                              int nparams, FAR const char *str)
+{
+  uint8_t packet[SYSVIEW_RAW_MAXPACKET];
+  FAR struct sysview_raw_s *raw;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  raw   = &g_sysview.raw[this_cpu()];
+
+  if (raw->session == g_sysview.raw_session ||
+      sysview_raw_header(raw, packet))
+    {
+      sysview_raw_packet(raw, packet, id, params, nparams, str);
+    }
+
+  up_irq_restore(flags);
+}
+
+static inline void sysview_raw_event1(uint8_t id, uint32_t param)
+{
+  sysview_raw_event(id, &param, 1, NULL);
+}
+
+/****************************************************************************
+ * Name: sysview_raw_initialize
+ *
+ * Description:
+ *   Set up the RTT up-buffer of each CPU.
+ *
+ ****************************************************************************/
+
+static int sysview_raw_initialize(void)
+{
+  FAR struct sysview_raw_s *raw;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      raw = &g_sysview.raw[cpu];
+      snprintf(raw->name, sizeof(raw->name), "SysView%d", cpu);
+
+#if CONFIG_SEGGER_SYSVIEW_RTT_CHANNEL == 0
+      raw->channel = SEGGER_RTT_AllocUpBuffer(raw->name,
+                                              g_sysview_rawbuf[cpu],
+                                              sizeof(g_sysview_rawbuf[cpu]),
+                                              SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+      if (raw->channel < 0)
+        {
+          return -ENOMEM;
+        }
+#else
+      raw->channel = CONFIG_SEGGER_SYSVIEW_RTT_CHANNEL + cpu;
+      if (SEGGER_RTT_ConfigUpBuffer(raw->channel, raw->name,
+                                    g_sysview_rawbuf[cpu],
+                                    sizeof(g_sysview_rawbuf[cpu]),
+                                    SEGGER_RTT_MODE_NO_BLOCK_SKIP) < 0)
+        {
+          return -ENOMEM;
+        }
+#endif
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_SEGGER_SYSVIEW_RAW */
+
 /****************************************************************************
  * Name: sysview_send_taskinfo
  ****************************************************************************/
 
 static void sysview_send_taskinfo(FAR struct tcb_s *tcb)
 {
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+  uint32_t params[2];
+
+  params[0] = SYSVIEW_RAW_ID(tcb->pid);
+  params[1] = tcb->sched_priority;
+#  if CONFIG_TASK_NAME_SIZE > 0
+  sysview_raw_event(SYSVIEW_RAW_TASK_INFO, params, 2, tcb->name);
+#  else
+  sysview_raw_event(SYSVIEW_RAW_TASK_INFO, params, 2, "<noname>");
+#  endif
+#else
   SEGGER_SYSVIEW_TASKINFO info;
 
   info.TaskID     = tcb->pid;
@@ -94,16 +446,19 @@ static void sysview_send_taskinfo(FAR struct tcb_s *tcb)
   info.StackSize  = tcb->adj_stack_size;
 
   SEGGER_SYSVIEW_SendTaskInfo(&info);
+#endif
 }
 
 /****************************************************************************
  * Name: sysview_get_time
  ****************************************************************************/
 
+#ifndef CONFIG_SEGGER_SYSVIEW_RAW
 static uint64_t sysview_get_time(void)
 {
   return TICK2USEC(clock_systime_ticks());
 }
+#endif
 
 /****************************************************************************
  * Name: sysview_send_tasklist
@@ -122,16 +477,37 @@ static void sysview_send_tasklist(void)
     }
 }
 
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+/****************************************************************************
+ * Name: sysview_raw_start
+ *
+ * Description:
+ *   Start a new session:  Each CPU writes the header of its stream before
+ *   its next event.
+ *
+ ****************************************************************************/
+
+static void sysview_raw_start(void)
+{
+  g_sysview.raw_session++;
+  g_sysview.raw_enabled = true;
+
+  sysview_send_tasklist();
+}
+#endif
+
 /****************************************************************************
  * Name: sysview_send_description
  ****************************************************************************/
 
+#ifndef CONFIG_SEGGER_SYSVIEW_RAW
 static void sysview_send_description(void)
 {
   SEGGER_SYSVIEW_SendSysDesc("N="SEGGER_SYSVIEW_APP_NAME);
   SEGGER_SYSVIEW_SendSysDesc("D="CONFIG_LIBC_HOSTNAME);
   SEGGER_SYSVIEW_SendSysDesc("O=NuttX");
 }
+#endif
 
 /****************************************************************************
  * Name: sysview_isenabled
@@ -151,7 +527,7 @@ static bool sysview_isenabled(void)
 {
   bool enable;
 
-  enable = SEGGER_SYSVIEW_IsStarted();
+  enable = SYSVIEW_IS_STARTED();
 
 #if defined(CONFIG_SCHED_INSTRUMENTATION_FILTER) && defined(CONFIG_SMP)
   /* Ignore notes that are not in the set of monitored CPUs */
@@ -283,7 +659,7 @@ void PREFIX(sched_note_start)(FAR struct tcb_s *tcb)
       return;
     }
 
-  SEGGER_SYSVIEW_OnTaskCreate(tcb->pid);
+  SYSVIEW_ON_TASK_CREATE(tcb->pid);
   sysview_send_taskinfo(tcb);
 }
 
@@ -294,7 +670,7 @@ void PREFIX(sched_note_stop)(FAR struct tcb_s *tcb)
       return;
     }
 
-  SEGGER_SYSVIEW_OnTaskTerminate(tcb->pid);
+  SYSVIEW_ON_TASK_TERMINATE(tcb->pid);
 }
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
@@ -307,7 +683,7 @@ void PREFIX(sched_note_suspend)(FAR struct tcb_s *tcb)
 
   if (!up_interrupt_context())
     {
-      SEGGER_SYSVIEW_OnTaskStopExec();
+      SYSVIEW_ON_TASK_STOP_EXEC();
     }
 }
 
@@ -322,11 +698,11 @@ void PREFIX(sched_note_resume)(FAR struct tcb_s *tcb)
     {
       if (is_idle_task(tcb))
         {
-          SEGGER_SYSVIEW_OnIdle();
+          SYSVIEW_ON_IDLE();
         }
       else
         {
-          SEGGER_SYSVIEW_OnTaskStartExec(tcb->pid);
+          SYSVIEW_ON_TASK_START_EXEC(tcb->pid);
         }
     }
 }
@@ -344,12 +720,12 @@ void PREFIX(sched_note_irqhandler)(int irq, FAR void *handler, bool enter)
     {
       g_sysview.irq[up_cpu_index()] = irq;
 
-      SEGGER_SYSVIEW_OnTaskStopExec();
-      SEGGER_SYSVIEW_RecordEnterISR();
+      SYSVIEW_ON_TASK_STOP_EXEC();
+      SYSVIEW_RECORD_ENTER_ISR();
     }
   else
     {
-      SEGGER_SYSVIEW_RecordExitISR();
+      SYSVIEW_RECORD_EXIT_ISR();
 
       if (up_interrupt_context())
         {
@@ -357,11 +733,11 @@ void PREFIX(sched_note_irqhandler)(int irq, FAR void *handler, bool enter)
 
           if (tcb && !is_idle_task(tcb))
             {
-              SEGGER_SYSVIEW_OnTaskStartExec(tcb->pid);
+              SYSVIEW_ON_TASK_START_EXEC(tcb->pid);
             }
           else
             {
-              SEGGER_SYSVIEW_OnIdle();
+              SYSVIEW_ON_IDLE();
             }
         }
 
@@ -386,7 +762,7 @@ void PREFIX(sched_note_syscall_enter)(int nr, int argc, ...)
     {
       /* Set the name marker */
 
-      SEGGER_SYSVIEW_NameMarker(nr, g_funcnames[nr]);
+      SYSVIEW_NAME_MARKER(nr, g_funcnames[nr]);
 
       /* Mark the syscall active */
 
@@ -403,7 +779,7 @@ void PREFIX(sched_note_syscall_enter)(int nr, int argc, ...)
         }
     }
 
-  SEGGER_SYSVIEW_MarkStart(nr);
+  SYSVIEW_MARK_START(nr);
 }
 
 void PREFIX(sched_note_syscall_leave)(int nr, uintptr_t result)
@@ -417,7 +793,7 @@ void PREFIX(sched_note_syscall_leave)(int nr, uintptr_t result)
 
   if (NOTE_FILTER_SYSCALLMASK_ISSET(nr, &g_sysview.syscall_marker) != 0)
     {
-      SEGGER_SYSVIEW_MarkStop(nr);
+      SYSVIEW_MARK_STOP(nr);
     }
 }
 #endif
@@ -464,6 +840,15 @@ unsigned int sysview_get_timestamp(void)
 
 int sysview_initialize(void)
 {
+#ifdef CONFIG_SEGGER_SYSVIEW_RAW
+  int ret;
+
+  ret = sysview_raw_initialize();
+  if (ret < 0)
+    {
+      return ret;
+    }
+#else
   uint32_t freq = up_perf_getfreq();
 
   static const SEGGER_SYSVIEW_OS_API g_sysview_trace_api =
@@ -475,15 +860,16 @@ int sysview_initialize(void)
   SEGGER_SYSVIEW_Init(freq, freq, &g_sysview_trace_api,
                       sysview_send_description);
 
-#if CONFIG_SEGGER_SYSVIEW_RAM_BASE != 0
+#  if CONFIG_SEGGER_SYSVIEW_RAM_BASE != 0
   SEGGER_SYSVIEW_SetRAMBase(CONFIG_SEGGER_SYSVIEW_RAM_BASE);
+#  endif
 #endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
   if ((g_sysview.mode.flag & NOTE_FILTER_MODE_FLAG_ENABLE) != 0)
 #endif
     {
-      SEGGER_SYSVIEW_Start();
+      SYSVIEW_START();
     }
 
   syslog(LOG_NOTICE, "SEGGER RTT Control Block Address: %#" PRIxPTR "\n",
@@ -523,7 +909,7 @@ void PREFIX(sched_note_filter_mode)(struct note_filter_mode_s *oldm,
 
   if (oldm != NULL)
     {
-      if (SEGGER_SYSVIEW_IsStarted())
+      if (SYSVIEW_IS_STARTED())
         {
           g_sysview.mode.flag |= NOTE_FILTER_MODE_FLAG_ENABLE;
         }
@@ -541,16 +927,16 @@ void PREFIX(sched_note_filter_mode)(struct note_filter_mode_s *oldm,
 
       if ((g_sysview.mode.flag & NOTE_FILTER_MODE_FLAG_ENABLE) != 0)
         {
-          if (!SEGGER_SYSVIEW_IsStarted())
+          if (!SYSVIEW_IS_STARTED())
             {
-              SEGGER_SYSVIEW_Start();
+              SYSVIEW_START();
             }
         }
       else
         {
-          if (SEGGER_SYSVIEW_IsStarted())
+          if (SYSVIEW_IS_STARTED())
             {
-              SEGGER_SYSVIEW_Stop();
+              SYSVIEW_STOP();
             }
         }
     }
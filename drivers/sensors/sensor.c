@@ -34,6 +34,7 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/circbuf.h>
@@ -157,6 +158,7 @@ static const struct sensor_info_s g_sensor_info[] =
   {sizeof(struct sensor_gps_satellite),   "gps_satellite"},
   {sizeof(struct sensor_wake_gesture),    "wake_gesture"},
   {sizeof(struct sensor_cap),             "cap"},
+  {sizeof(struct sensor_orientation),     "orientation"},
 };
 
 static const struct file_operations g_sensor_fops =
@@ -330,6 +332,33 @@ update:
   return ret;
 }
 
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      return 0;
+    }
+
+  ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
+                     upper->state.esize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+    }
+
+  return ret;
+}
+
 static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
                                    unsigned long nums)
 {
@@ -371,6 +400,35 @@ static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static bool sensor_need_wakeup(FAR struct sensor_upperhalf_s *upper,
+                               FAR struct sensor_user_s *user)
+{
+  unsigned long unread;
+
+  if (!sensor_is_updated(upper, user))
+    {
+      return false;
+    }
+
+  if (user->state.latency == 0 || user->state.latency == ULONG_MAX)
+    {
+      return true;
+    }
+
+  /* The user asked for batches: wake it up once the oldest unread event
+   * is latency old, or when the next event would overwrite it.
+   */
+
+  if (upper->state.generation - user->state.generation >=
+      user->state.latency)
+    {
+      return true;
+    }
+
+  unread = upper->timing.head / TIMING_BUF_ESIZE - user->bufferpos;
+  return unread >= upper->lower->nbuffer;
+}
+
 static void sensor_catch_up(FAR struct sensor_upperhalf_s *upper,
                             FAR struct sensor_user_s *user)
 {
@@ -833,6 +891,56 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* Map the circular buffer of events, see SNIOC_GET_EVENTS */
+
+      case FIOC_MMAP:
+        {
+          if (lower->ops->fetch)
+            {
+              ret = -ENOTSUP;
+              break;
+            }
+
+          nxrmutex_lock(&upper->lock);
+          ret = sensor_init_buffer(upper);
+          if (ret >= 0)
+            {
+              *(FAR void **)(uintptr_t)arg = upper->buffer.base;
+            }
+
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+
+      case SNIOC_GET_EVENTS:
+        {
+          FAR struct sensor_events_s *events =
+            (FAR struct sensor_events_s *)(uintptr_t)arg;
+
+          nxrmutex_lock(&upper->lock);
+          events->offset  = 0;
+          events->nevents = 0;
+          if (!lower->ops->fetch && !circbuf_is_empty(&upper->buffer))
+            {
+              sensor_catch_up(upper, user);
+              events->nevents = upper->timing.head / TIMING_BUF_ESIZE -
+                                user->bufferpos;
+              events->offset  = user->bufferpos * upper->state.esize %
+                                upper->buffer.size;
+              if (events->nevents > 0)
+                {
+                  user->bufferpos += events->nevents;
+                  circbuf_peekat(&upper->timing,
+                                 (user->bufferpos - 1) * TIMING_BUF_ESIZE,
+                                 &user->state.generation,
+                                 TIMING_BUF_ESIZE);
+                }
+            }
+
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+
       default:
 
         /* Lowerhalf driver process other cmd. */
@@ -920,7 +1028,6 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -933,33 +1040,25 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     }
 
   nxrmutex_lock(&upper->lock);
-  if (!circbuf_is_init(&upper->buffer))
-    {
-      /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  ret = sensor_init_buffer(upper);
+  if (ret < 0)
+    {
+      nxrmutex_unlock(&upper->lock);
+      return ret;
     }
 
+  /* A batch of events is stored at once and each user is woken up (at
+   * most) once for it, and not before its batch latency has elapsed.
+   */
+
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
-      if (sensor_is_updated(upper, user))
+      if (sensor_need_wakeup(upper, user))
         {
           nxsem_get_value(&user->buffersem, &semcount);
           if (semcount < 1)
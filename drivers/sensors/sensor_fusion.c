@@ -0,0 +1,670 @@
+/****************************************************************************
+ * drivers/sensors/sensor_fusion.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/sensors/fusion.h>
+#include <nuttx/sensors/ioctl.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_FUSION
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The output interval until a subscriber sets one, 100 Hz */
+
+#define FUSION_INTERVAL     10000
+
+/* The gaps between gyroscope samples that are taken as a restart */
+
+#define FUSION_MAXDT        1.0f
+
+#ifdef CONFIG_SENSORS_FUSION_MADGWICK
+#  define FUSION_GAIN       (CONFIG_SENSORS_FUSION_BETA / 1000.0f)
+#else
+#  define FUSION_GAIN       (CONFIG_SENSORS_FUSION_KP / 1000.0f)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct sensor_fusion_s
+{
+  struct sensor_lowerhalf_s lower;
+  struct file accel;               /* The inputs, open while running */
+  struct file gyro;
+  struct file mag;
+  FAR const char *accel_path;
+  FAR const char *gyro_path;
+  FAR const char *mag_path;        /* NULL without a magnetometer */
+  bool hasmag;                     /* mag is open */
+  unsigned long interval;          /* Output interval in us */
+  sem_t wakeup;
+  volatile bool running;
+
+  /* The state of the filter */
+
+  float q[4];                      /* Body to earth rotation, w x y z */
+  uint64_t last;                   /* Timestamp of the last gyro sample */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int sensor_fusion_activate(FAR struct sensor_lowerhalf_s *lower,
+                                  FAR struct file *filep, bool enable);
+static int sensor_fusion_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                      FAR struct file *filep,
+                                      FAR unsigned long *period_us);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct sensor_ops_s g_sensor_fusion_ops =
+{
+  .activate     = sensor_fusion_activate,
+  .set_interval = sensor_fusion_set_interval,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_fusion_normalize
+ *
+ * Description:
+ *   Normalize a vector in place.  Return false if it is null.
+ *
+ ****************************************************************************/
+
+static bool sensor_fusion_normalize(FAR float *v, int n)
+{
+  float norm = 0.0f;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      norm += v[i] * v[i];
+    }
+
+  if (!(norm > 0.0f) || !isfinite(norm))
+    {
+      return false;
+    }
+
+  norm = 1.0f / sqrtf(norm);
+  for (i = 0; i < n; i++)
+    {
+      v[i] *= norm;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_earthmag
+ *
+ * Description:
+ *   Return the reference direction of the magnetic field in the earth
+ *   frame, b = (bx, 0, bz), from the measured field rotated by q.
+ *
+ ****************************************************************************/
+
+static void sensor_fusion_earthmag(FAR const float *q, FAR const float *m,
+                                   FAR float *bx, FAR float *bz)
+{
+  float hx;
+  float hy;
+
+  hx = (1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3])) * m[0] +
+       2.0f * (q[1] * q[2] - q[0] * q[3]) * m[1] +
+       2.0f * (q[1] * q[3] + q[0] * q[2]) * m[2];
+  hy = 2.0f * (q[1] * q[2] + q[0] * q[3]) * m[0] +
+       (1.0f - 2.0f * (q[1] * q[1] + q[3] * q[3])) * m[1] +
+       2.0f * (q[2] * q[3] - q[0] * q[1]) * m[2];
+
+  *bx = sqrtf(hx * hx + hy * hy);
+  *bz = 2.0f * (q[1] * q[3] - q[0] * q[2]) * m[0] +
+        2.0f * (q[2] * q[3] + q[0] * q[1]) * m[1] +
+        (1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2])) * m[2];
+}
+
+#ifdef CONFIG_SENSORS_FUSION_MADGWICK
+/****************************************************************************
+ * Name: sensor_fusion_correct
+ *
+ * Description:
+ *   The correction of the Madgwick filter: a gradient descent step on the
+ *   errors between the measured gravity and field and the ones predicted
+ *   by q, scaled by beta and subtracted from the rate of change of q.
+ *
+ ****************************************************************************/
+
+static void sensor_fusion_correct(FAR const float *q, FAR const float *a,
+                                  FAR const float *m, FAR float *qdot)
+{
+  float s[4];
+  float f1;
+  float f2;
+  float f3;
+  float bx;
+  float bz;
+  int i;
+
+  /* The gravity error, J_g^T f_g */
+
+  f1 = 2.0f * (q[1] * q[3] - q[0] * q[2]) - a[0];
+  f2 = 2.0f * (q[0] * q[1] + q[2] * q[3]) - a[1];
+  f3 = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]) - a[2];
+
+  s[0] = -2.0f * q[2] * f1 + 2.0f * q[1] * f2;
+  s[1] =  2.0f * q[3] * f1 + 2.0f * q[0] * f2 - 4.0f * q[1] * f3;
+  s[2] = -2.0f * q[0] * f1 + 2.0f * q[3] * f2 - 4.0f * q[2] * f3;
+  s[3] =  2.0f * q[1] * f1 + 2.0f * q[2] * f2;
+
+  /* The field error, J_b^T f_b */
+
+  if (m != NULL)
+    {
+      sensor_fusion_earthmag(q, m, &bx, &bz);
+
+      f1 = 2.0f * bx * (0.5f - q[2] * q[2] - q[3] * q[3]) +
+           2.0f * bz * (q[1] * q[3] - q[0] * q[2]) - m[0];
+      f2 = 2.0f * bx * (q[1] * q[2] - q[0] * q[3]) +
+           2.0f * bz * (q[0] * q[1] + q[2] * q[3]) - m[1];
+      f3 = 2.0f * bx * (q[0] * q[2] + q[1] * q[3]) +
+           2.0f * bz * (0.5f - q[1] * q[1] - q[2] * q[2]) - m[2];
+
+      s[0] += -2.0f * bz * q[2] * f1 +
+              (-2.0f * bx * q[3] + 2.0f * bz * q[1]) * f2 +
+              2.0f * bx * q[2] * f3;
+      s[1] += 2.0f * bz * q[3] * f1 +
+              (2.0f * bx * q[2] + 2.0f * bz * q[0]) * f2 +
+              (2.0f * bx * q[3] - 4.0f * bz * q[1]) * f3;
+      s[2] += (-4.0f * bx * q[2] - 2.0f * bz * q[0]) * f1 +
+              (2.0f * bx * q[1] + 2.0f * bz * q[3]) * f2 +
+              (2.0f * bx * q[0] - 4.0f * bz * q[2]) * f3;
+      s[3] += (-4.0f * bx * q[3] + 2.0f * bz * q[1]) * f1 +
+              (-2.0f * bx * q[0] + 2.0f * bz * q[2]) * f2 +
+              2.0f * bx * q[1] * f3;
+    }
+
+  if (sensor_fusion_normalize(s, 4))
+    {
+      for (i = 0; i < 4; i++)
+        {
+          qdot[i] -= FUSION_GAIN * s[i];
+        }
+    }
+}
+#else
+/****************************************************************************
+ * Name: sensor_fusion_correct
+ *
+ * Description:
+ *   The correction of the Mahony complementary filter: the rotation
+ *   between the measured gravity and field and the ones predicted by q,
+ *   scaled by kp and added to the angular rate.
+ *
+ ****************************************************************************/
+
+static void sensor_fusion_correct(FAR const float *q, FAR const float *a,
+                                  FAR const float *m, FAR float *g)
+{
+  float e[3];
+  float v[3];
+  float bx;
+  float bz;
+
+  /* The gravity predicted by q, in the body frame */
+
+  v[0] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+  v[1] = 2.0f * (q[0] * q[1] + q[2] * q[3]);
+  v[2] = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+
+  e[0] = a[1] * v[2] - a[2] * v[1];
+  e[1] = a[2] * v[0] - a[0] * v[2];
+  e[2] = a[0] * v[1] - a[1] * v[0];
+
+  if (m != NULL)
+    {
+      /* The field predicted by q, in the body frame */
+
+      sensor_fusion_earthmag(q, m, &bx, &bz);
+
+      v[0] = 2.0f * bx * (0.5f - q[2] * q[2] - q[3] * q[3]) +
+             2.0f * bz * (q[1] * q[3] - q[0] * q[2]);
+      v[1] = 2.0f * bx * (q[1] * q[2] - q[0] * q[3]) +
+             2.0f * bz * (q[0] * q[1] + q[2] * q[3]);
+      v[2] = 2.0f * bx * (q[0] * q[2] + q[1] * q[3]) +
+             2.0f * bz * (0.5f - q[1] * q[1] - q[2] * q[2]);
+
+      e[0] += m[1] * v[2] - m[2] * v[1];
+      e[1] += m[2] * v[0] - m[0] * v[2];
+      e[2] += m[0] * v[1] - m[1] * v[0];
+    }
+
+  g[0] += FUSION_GAIN * e[0];
+  g[1] += FUSION_GAIN * e[1];
+  g[2] += FUSION_GAIN * e[2];
+}
+#endif
+
+/****************************************************************************
+ * Name: sensor_fusion_update
+ *
+ * Description:
+ *   Advance the orientation by one gyroscope sample, corrected with the
+ *   normalized gravity and field, if there are.
+ *
+ ****************************************************************************/
+
+static void sensor_fusion_update(FAR struct sensor_fusion_s *fusion,
+                                 FAR const struct sensor_gyro *gyro,
+                                 FAR const float *a, FAR const float *m,
+                                 float dt)
+{
+  FAR float *q = fusion->q;
+  float qdot[4];
+  float g[3];
+  int i;
+
+  g[0] = gyro->x;
+  g[1] = gyro->y;
+  g[2] = gyro->z;
+
+#ifndef CONFIG_SENSORS_FUSION_MADGWICK
+  if (a != NULL)
+    {
+      sensor_fusion_correct(q, a, m, g);
+    }
+#endif
+
+  /* The rate of change of q, 0.5 * q x (0, g) */
+
+  qdot[0] = 0.5f * (-q[1] * g[0] - q[2] * g[1] - q[3] * g[2]);
+  qdot[1] = 0.5f * (q[0] * g[0] + q[2] * g[2] - q[3] * g[1]);
+  qdot[2] = 0.5f * (q[0] * g[1] - q[1] * g[2] + q[3] * g[0]);
+  qdot[3] = 0.5f * (q[0] * g[2] + q[1] * g[1] - q[2] * g[0]);
+
+#ifdef CONFIG_SENSORS_FUSION_MADGWICK
+  if (a != NULL)
+    {
+      sensor_fusion_correct(q, a, m, qdot);
+    }
+#endif
+
+  for (i = 0; i < 4; i++)
+    {
+      q[i] += qdot[i] * dt;
+    }
+
+  if (!sensor_fusion_normalize(q, 4))
+    {
+      q[0] = 1.0f;
+      q[1] = q[2] = q[3] = 0.0f;
+    }
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_read
+ *
+ * Description:
+ *   Read the new events of an input and return the number read, zero if
+ *   there are none.
+ *
+ ****************************************************************************/
+
+static int sensor_fusion_read(FAR struct file *filep, FAR void *buffer,
+                              size_t esize)
+{
+  ssize_t nbytes;
+
+  nbytes = file_read(filep, buffer, CONFIG_SENSORS_FUSION_NEVENTS * esize);
+  return nbytes > 0 ? nbytes / esize : 0;
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_step
+ *
+ * Description:
+ *   Fuse the events received since the last step and publish the
+ *   orientation at the time of the last gyroscope sample.
+ *
+ ****************************************************************************/
+
+static void sensor_fusion_step(FAR struct sensor_fusion_s *fusion)
+{
+  struct sensor_gyro gyro[CONFIG_SENSORS_FUSION_NEVENTS];
+  struct sensor_accel accel[CONFIG_SENSORS_FUSION_NEVENTS];
+  struct sensor_mag mag[CONFIG_SENSORS_FUSION_NEVENTS];
+  struct sensor_orientation orient;
+  FAR const float *q = fusion->q;
+  FAR float *a = NULL;
+  FAR float *m = NULL;
+  float dt;
+  float t;
+  int n;
+  int i;
+
+  /* Only the last samples of the accelerometer and magnetometer, and only
+   * the directions of gravity and of the field.
+   */
+
+  n = sensor_fusion_read(&fusion->accel, accel, sizeof(accel[0]));
+  if (n > 0 && sensor_fusion_normalize(&accel[n - 1].x, 3))
+    {
+      a = &accel[n - 1].x;
+    }
+
+  if (fusion->hasmag && a != NULL)
+    {
+      n = sensor_fusion_read(&fusion->mag, mag, sizeof(mag[0]));
+      if (n > 0 && sensor_fusion_normalize(&mag[n - 1].x, 3))
+        {
+          m = &mag[n - 1].x;
+        }
+    }
+
+  /* All of the samples of the gyroscope, to integrate them */
+
+  n = sensor_fusion_read(&fusion->gyro, gyro, sizeof(gyro[0]));
+  if (n == 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      dt = (float)(int64_t)(gyro[i].timestamp - fusion->last) / 1000000.0f;
+      if (fusion->last == 0 || dt <= 0.0f || dt > FUSION_MAXDT)
+        {
+          dt = fusion->interval / 1000000.0f;
+        }
+
+      fusion->last = gyro[i].timestamp;
+      sensor_fusion_update(fusion, &gyro[i], a, m, dt);
+    }
+
+  orient.timestamp = fusion->last;
+  orient.w         = q[0];
+  orient.x         = q[1];
+  orient.y         = q[2];
+  orient.z         = q[3];
+
+  orient.roll  = atan2f(2.0f * (q[0] * q[1] + q[2] * q[3]),
+                        1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]));
+  t            = 2.0f * (q[0] * q[2] - q[1] * q[3]);
+  orient.pitch = asinf(t > 1.0f ? 1.0f : t < -1.0f ? -1.0f : t);
+  orient.yaw   = atan2f(2.0f * (q[0] * q[3] + q[1] * q[2]),
+                        1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]));
+
+  fusion->lower.push_event(fusion->lower.priv, &orient, sizeof(orient));
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_open
+ *
+ * Description:
+ *   Subscribe to the inputs at the interval of the output.
+ *
+ ****************************************************************************/
+
+static int sensor_fusion_open(FAR struct sensor_fusion_s *fusion)
+{
+  int ret;
+
+  ret = file_open(&fusion->accel, fusion->accel_path,
+                  O_RDONLY | O_NONBLOCK);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to open %s: %d\n", fusion->accel_path, ret);
+      return ret;
+    }
+
+  ret = file_open(&fusion->gyro, fusion->gyro_path, O_RDONLY | O_NONBLOCK);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to open %s: %d\n", fusion->gyro_path, ret);
+      file_close(&fusion->accel);
+      return ret;
+    }
+
+  fusion->hasmag = false;
+  if (fusion->mag_path != NULL)
+    {
+      ret = file_open(&fusion->mag, fusion->mag_path,
+                      O_RDONLY | O_NONBLOCK);
+      if (ret < 0)
+        {
+          snwarn("WARNING: Failed to open %s: %d\n", fusion->mag_path, ret);
+        }
+      else
+        {
+          fusion->hasmag = true;
+          file_ioctl(&fusion->mag, SNIOC_SET_INTERVAL, fusion->interval);
+        }
+    }
+
+  file_ioctl(&fusion->accel, SNIOC_SET_INTERVAL, fusion->interval);
+  file_ioctl(&fusion->gyro, SNIOC_SET_INTERVAL, fusion->interval);
+
+  fusion->q[0] = 1.0f;
+  fusion->q[1] = 0.0f;
+  fusion->q[2] = 0.0f;
+  fusion->q[3] = 0.0f;
+  fusion->last = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_close
+ ****************************************************************************/
+
+static void sensor_fusion_close(FAR struct sensor_fusion_s *fusion)
+{
+  if (fusion->hasmag)
+    {
+      file_close(&fusion->mag);
+      fusion->hasmag = false;
+    }
+
+  file_close(&fusion->gyro);
+  file_close(&fusion->accel);
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_thread
+ ****************************************************************************/
+
+static int sensor_fusion_thread(int argc, FAR char *argv[])
+{
+  FAR struct sensor_fusion_s *fusion = (FAR struct sensor_fusion_s *)
+        ((uintptr_t)strtoul(argv[1], NULL, 0));
+  unsigned long interval;
+
+  for (; ; )
+    {
+      /* Wait for the first subscriber */
+
+      nxsem_wait_uninterruptible(&fusion->wakeup);
+      if (!fusion->running || sensor_fusion_open(fusion) < 0)
+        {
+          continue;
+        }
+
+      interval = fusion->interval;
+      while (fusion->running)
+        {
+          nxsig_usleep(fusion->interval);
+
+          if (interval != fusion->interval)
+            {
+              interval = fusion->interval;
+              file_ioctl(&fusion->accel, SNIOC_SET_INTERVAL, interval);
+              file_ioctl(&fusion->gyro, SNIOC_SET_INTERVAL, interval);
+              if (fusion->hasmag)
+                {
+                  file_ioctl(&fusion->mag, SNIOC_SET_INTERVAL, interval);
+                }
+            }
+
+          sensor_fusion_step(fusion);
+        }
+
+      sensor_fusion_close(fusion);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_activate
+ ****************************************************************************/
+
+static int sensor_fusion_activate(FAR struct sensor_lowerhalf_s *lower,
+                                  FAR struct file *filep, bool enable)
+{
+  FAR struct sensor_fusion_s *fusion =
+    container_of(lower, struct sensor_fusion_s, lower);
+
+  fusion->running = enable;
+  if (enable)
+    {
+      nxsem_post(&fusion->wakeup);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_fusion_set_interval
+ ****************************************************************************/
+
+static int sensor_fusion_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                      FAR struct file *filep,
+                                      FAR unsigned long *period_us)
+{
+  FAR struct sensor_fusion_s *fusion =
+    container_of(lower, struct sensor_fusion_s, lower);
+
+  if (*period_us == 0)
+    {
+      return -EINVAL;
+    }
+
+  fusion->interval = *period_us;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_fusion_register
+ *
+ * Description:
+ *   Register an orientation topic fused from the topics of an
+ *   accelerometer, a gyroscope and optionally a magnetometer.  See
+ *   include/nuttx/sensors/fusion.h.
+ *
+ ****************************************************************************/
+
+int sensor_fusion_register(FAR const char *accel, FAR const char *gyro,
+                           FAR const char *mag, int devno)
+{
+  FAR struct sensor_fusion_s *fusion;
+  FAR char *argv[2];
+  char arg1[32];
+  int ret;
+
+  DEBUGASSERT(accel != NULL && gyro != NULL);
+
+  fusion = kmm_zalloc(sizeof(struct sensor_fusion_s));
+  if (fusion == NULL)
+    {
+      snerr("ERROR: Failed to allocate the fusion\n");
+      return -ENOMEM;
+    }
+
+  fusion->lower.type    = SENSOR_TYPE_ORIENTATION;
+  fusion->lower.ops     = &g_sensor_fusion_ops;
+  fusion->lower.nbuffer = 1;
+  fusion->accel_path    = accel;
+  fusion->gyro_path     = gyro;
+  fusion->mag_path      = mag;
+  fusion->interval      = FUSION_INTERVAL;
+
+  nxsem_init(&fusion->wakeup, 0, 0);
+
+  ret = sensor_register(&fusion->lower, devno);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to register the fusion: %d\n", ret);
+      goto errout;
+    }
+
+  snprintf(arg1, sizeof(arg1), "%p", fusion);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("sensor_fusion", CONFIG_SENSORS_FUSION_PRIORITY,
+                       CONFIG_SENSORS_FUSION_STACKSIZE,
+                       sensor_fusion_thread, argv);
+  if (ret < 0)
+    {
+      snerr("ERROR: Failed to create the fusion thread: %d\n", ret);
+      sensor_unregister(&fusion->lower, devno);
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  nxsem_destroy(&fusion->wakeup);
+  kmm_free(fusion);
+  return ret;
+}
+
+#endif /* CONFIG_SENSORS_FUSION */
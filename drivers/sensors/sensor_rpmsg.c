@@ -102,6 +102,7 @@ struct sensor_rpmsg_ept_s
   struct work_s                  work;
   mutex_t                        lock;
   FAR void                      *buffer;
+  FAR struct sensor_rpmsg_cell_s *cell;
   uint64_t                       expire;
   uint32_t                       space;
   size_t                         written;
@@ -715,6 +716,7 @@ static void sensor_rpmsg_data_worker(FAR void *arg)
     {
       rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
       sre->buffer = NULL;
+      sre->cell   = NULL;
     }
 
   nxmutex_unlock(&sre->lock);
@@ -727,6 +729,8 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
   FAR struct sensor_rpmsg_ept_s *sre;
   FAR struct sensor_rpmsg_data_s *msg;
   struct sensor_ustate_s state;
+  FAR char *data;
+  uint64_t timeout;
   uint64_t now;
   bool updated;
   int ret;
@@ -744,6 +748,11 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       state.interval = 0;
     }
 
+  if (state.latency == ULONG_MAX)
+    {
+      state.latency = 0;
+    }
+
   sre = container_of(stub->ept, struct sensor_rpmsg_ept_s, ept);
   nxmutex_lock(&sre->lock);
 
@@ -772,6 +781,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
           if (sre->buffer)
             {
               rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
+              sre->cell = NULL;
             }
 
           msg = rpmsg_get_tx_payload_buffer(&sre->ept, &sre->space, true);
@@ -787,19 +797,37 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
           msg->command = SENSOR_RPMSG_PUBLISH;
           sre->written = sizeof(*msg);
           sre->expire  = UINT64_MAX;
+          sre->cell    = NULL;
         }
 
-      cell = sre->buffer + sre->written;
-      ret  = file_read(&stub->file, cell->data,
-                       sre->space - sre->written - sizeof(*cell));
+      /* Events of the topic of the last cell are appended to it, so that
+       * the receiver pushes them to its upper half in one batch.
+       */
+
+      if (sre->cell != NULL && sre->cell->cookie == stub->cookie)
+        {
+          cell = sre->cell;
+        }
+      else
+        {
+          cell         = sre->buffer + sre->written;
+          cell->len    = 0;
+          cell->cookie = stub->cookie;
+        }
+
+      data = cell->data + cell->len;
+      ret  = file_read(&stub->file, data, sre->space - sizeof(*cell) -
+                       cell->len - ((FAR char *)cell -
+                                    (FAR char *)sre->buffer));
       if (ret <= 0)
         {
           break;
         }
 
-      cell->len     = ret;
-      cell->cookie  = stub->cookie;
-      sre->written += (sizeof(*cell) + ret + 0x7) & ~0x7;
+      cell->len   += ret;
+      sre->cell    = cell;
+      sre->written = (FAR char *)cell - (FAR char *)sre->buffer +
+                     ((sizeof(*cell) + cell->len + 0x7) & ~0x7);
     }
 
   /* If buffer timeout is expired, do rpmsg_send_nocopy, otherwise using
@@ -811,6 +839,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     {
       ret = rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
       sre->buffer = NULL;
+      sre->cell   = NULL;
       if (ret < 0)
         {
           snerr("ERROR: push event rpmsg send failed:%d, %s\n",
@@ -819,10 +848,19 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     }
   else
     {
-      if (sre->expire == UINT64_MAX ||
-          sre->expire - now > state.interval / 2)
+      /* Hold the buffer for half an interval to coalesce the events of
+       * all topics, or for the batch latency the subscriber asked for.
+       */
+
+      timeout = state.interval / 2;
+      if (timeout < state.latency)
+        {
+          timeout = state.latency;
+        }
+
+      if (sre->expire == UINT64_MAX || sre->expire - now > timeout)
         {
-          sre->expire = now + state.interval / 2;
+          sre->expire = now + timeout;
         }
 
       work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
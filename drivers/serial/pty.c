@@ -500,8 +500,9 @@ static ssize_t pty_write(FAR struct file *filep,
 
   if ((dev->pd_oflag & OPOST) != 0)
     {
-      /* We will transfer one byte at a time, making the appropriae
-       * translations.  Specifically not handled:
+      /* We will transfer the runs of characters that need no translation
+       * at once, and make the translations in between.  Specifically not
+       * handled:
        *
        *   OXTABS - primarily a full-screen terminal optimisation
        *   ONOEOT - Unix interoperability hack
@@ -510,54 +511,68 @@ static ssize_t pty_write(FAR struct file *filep,
        */
 
       ntotal = 0;
-      for (i = 0; i < len; i++)
+      while ((size_t)ntotal < len)
         {
-          ch = *buffer++;
+          /* Find the next character to translate */
 
-          /* Mapping CR to NL? */
-
-          if (ch == '\r' && (dev->pd_oflag & OCRNL) != 0)
+          for (i = (size_t)ntotal; i < len; i++)
             {
-              ch = '\n';
+              ch = buffer[i];
+              if ((ch == '\r' && (dev->pd_oflag & OCRNL) != 0) ||
+                  (ch == '\n' && (dev->pd_oflag & (ONLCR | ONLRET)) != 0))
+                {
+                  break;
+                }
             }
 
-          /* Are we interested in newline processing? */
+          /* Transfer the run before it.  This will block if the sink pipe
+           * is full.
+           *
+           * REVISIT: Should not block if the oflags include O_NONBLOCK.
+           * How would we ripple the O_NONBLOCK characteristic to the
+           * contained sink pipe?  file_fcntl()?  Or FIONSPACE?  See the
+           * TODO comment at the top of this file.
+           */
 
-          if ((ch == '\n') && (dev->pd_oflag & (ONLCR | ONLRET)) != 0)
+          if (i > (size_t)ntotal)
             {
-              char cr = '\r';
-
-              /* Transfer the carriage return.  This will block if the
-               * sink pipe is full.
-               *
-               * REVISIT: Should not block if the oflags include O_NONBLOCK.
-               * How would we ripple the O_NONBLOCK characteristic to the
-               * contained sink pipe?  file_fcntl()?  Or FIONSPACE?  See the
-               * TODO comment at the top of this file.
-               *
-               * NOTE: The newline is not included in total number of bytes
-               * written.  Otherwise, we would return more than the
-               * requested number of bytes.
-               */
-
-              nwritten = file_write(&dev->pd_sink, &cr, 1);
+              nwritten = file_write(&dev->pd_sink, &buffer[ntotal],
+                                    i - ntotal);
               if (nwritten < 0)
                 {
                   ntotal = nwritten;
                   break;
                 }
+
+              ntotal += nwritten;
+              continue;
             }
 
-          /* Transfer the (possibly translated) character..  This will block
-           * if the sink pipe is full
+          /* Mapping CR to NL? */
+
+          ch = buffer[ntotal];
+          if (ch == '\r' && (dev->pd_oflag & OCRNL) != 0)
+            {
+              ch = '\n';
+            }
+
+          /* Are we interested in newline processing?  Then transfer the
+           * carriage return along with the newline.
            *
-           * REVISIT: Should not block if the oflags include O_NONBLOCK.
-           * How would we ripple the O_NONBLOCK characteristic to the
-           * contained sink pipe?  file_fcntl()?  Or FIONSPACe?  See the
-           * TODO comment at the top of this file.
+           * NOTE: The carriage return is not included in total number of
+           * bytes written.  Otherwise, we would return more than the
+           * requested number of bytes.
            */
 
-          nwritten = file_write(&dev->pd_sink, &ch, 1);
+          if ((ch == '\n') && (dev->pd_oflag & (ONLCR | ONLRET)) != 0)
+            {
+              nwritten = file_write(&dev->pd_sink, "\r\n", 2);
+            }
+          else
+            {
+              nwritten = file_write(&dev->pd_sink, &ch, 1);
+            }
+
           if (nwritten < 0)
             {
               ntotal = nwritten;
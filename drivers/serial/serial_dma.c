@@ -43,7 +43,7 @@
  *
  * Description:
  *   Check if the SIGINT character is anywhere in the newly received DMA
- *   buffer.
+ *   data, from offset start to offset end of the transfer.
  *
  *   REVISIT:  We must also remove the SIGINT/SIGTSTP character from the Rx
  *   buffer.  It should not be read as normal data by the caller.
@@ -53,30 +53,87 @@
 #if defined(CONFIG_SERIAL_RXDMA) && \
    (defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
     defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH))
-static int uart_recvchars_check_special(FAR uart_dev_t *dev)
+static int uart_recvchars_check_special(FAR uart_dev_t *dev, size_t start,
+                                        size_t end)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
   int signo;
 
   /* Check if the valid DMAed data is in one or two contiguous regions */
 
-  if (xfer->nbytes <= xfer->length)
-    {
-      return uart_check_special(dev, xfer->buffer, xfer->nbytes);
-    }
-  else
+  if (start < xfer->length)
     {
-      /* REVISIT:  Additional signals could be in the second region. */
-
-      signo = uart_check_special(dev, xfer->buffer, xfer->length);
+      signo = uart_check_special(dev, xfer->buffer + start,
+                                 (end < xfer->length ? end : xfer->length) -
+                                 start);
       if (signo != 0)
         {
           return signo;
         }
 
-      return uart_check_special(dev, xfer->nbuffer,
-                                xfer->nbytes - xfer->length);
+      start = xfer->length;
+    }
+
+  /* REVISIT:  Additional signals could be in the second region. */
+
+  if (end > start)
+    {
+      return uart_check_special(dev, xfer->nbuffer + start - xfer->length,
+                                end - start);
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_publish
+ *
+ * Description:
+ *   Add the bytes from offset start to offset end of the RX DMA transfer
+ *   to the RX circular buffer and wake up the readers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+static void uart_recvchars_publish(FAR uart_dev_t *dev, size_t start,
+                                   size_t end)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  int signo = 0;
+
+  /* Check if the SIGINT character is anywhere in the newly received DMA
+   * data.
+   */
+
+  signo = uart_recvchars_check_special(dev, start, end);
+#endif
+
+  /* Move head for the new bytes. */
+
+  rxbuf->head = (rxbuf->head + end - start) % rxbuf->size;
+
+  /* If any bytes were added to the buffer, inform any waiters there is new
+   * incoming data available.
+   */
+
+  if (end > start)
+    {
+      uart_datareceived(dev);
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      nxsig_kill(dev->pid, signo);
+      uart_reset_sem(dev);
     }
+#endif
 }
 #endif
 
@@ -188,6 +245,10 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
   bool is_full;
   int nexthead;
 
+  /* Nothing of the new transfer has been reported yet */
+
+  xfer->ndone = 0;
+
   /* If RX buffer is empty move tail and head to zero position */
 
   if (rxbuf->head == rxbuf->tail)
@@ -313,44 +374,49 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
 void uart_recvchars_done(FAR uart_dev_t *dev)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
-  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t ndone = xfer->ndone;
   size_t nbytes = xfer->nbytes;
-#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
-    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
-  int signo = 0;
 
-  /* Check if the SIGINT character is anywhere in the newly received DMA
-   * buffer.
+  /* Only the bytes received after the last uart_recvchars_update() are
+   * new.
    */
 
-  signo = uart_recvchars_check_special(dev);
-#endif
-
-  /* Move head for nbytes. */
+  if (nbytes < ndone)
+    {
+      nbytes = ndone;
+    }
 
-  rxbuf->head  = (rxbuf->head + nbytes) % rxbuf->size;
   xfer->nbytes = 0;
+  xfer->ndone  = 0;
+  uart_recvchars_publish(dev, ndone, nbytes);
   xfer->length = xfer->nlength = 0;
+}
+#endif
 
-  /* If any bytes were added to the buffer, inform any waiters there is new
-   * incoming data available.
-   */
+/****************************************************************************
+ * Name: uart_recvchars_update
+ *
+ * Description:
+ *   Hand the bytes that the running RX DMA transfer has stored since the
+ *   last report to the readers, without ending the transfer.  Called from
+ *   the half-transfer, idle-line or receive timeout interrupt of the lower
+ *   half, so that readers don't wait for the whole transfer to complete.
+ *
+ ****************************************************************************/
 
-  if (nbytes)
-    {
-      uart_datareceived(dev);
-    }
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_update(FAR uart_dev_t *dev, size_t nbytes)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  size_t ndone = xfer->ndone;
 
-#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
-    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
-  /* Send the signal if necessary */
+  DEBUGASSERT(nbytes <= xfer->length + xfer->nlength);
 
-  if (signo != 0)
+  if (nbytes > ndone)
     {
-      nxsig_kill(dev->pid, signo);
-      uart_reset_sem(dev);
+      xfer->ndone = nbytes;
+      uart_recvchars_publish(dev, ndone, nbytes);
     }
-#endif
 }
 #endif
 
@@ -0,0 +1,320 @@
+/****************************************************************************
+ * drivers/spi/spi_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_ASYNC
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of requests of one bus and the thread that performs them */
+
+struct spi_asyncbus_s
+{
+  FAR struct spi_dev_s *spi;       /* The bus, NULL if the slot is free */
+  FAR struct spi_async_s *head;    /* The oldest request */
+  FAR struct spi_async_s *tail;    /* The newest request */
+  sem_t sem;                       /* Posted for each request queued */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct spi_asyncbus_s g_spi_async[CONFIG_SPI_ASYNC_NBUSES];
+static mutex_t g_spi_async_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_async_take
+ *
+ * Description:
+ *   Remove the oldest request of a bus from its queue, or return NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_async_s *
+spi_async_take(FAR struct spi_asyncbus_s *bus)
+{
+  FAR struct spi_async_s *req;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  req = bus->head;
+  if (req != NULL)
+    {
+      bus->head = req->flink;
+      if (bus->head == NULL)
+        {
+          bus->tail = NULL;
+        }
+
+      req->flink = NULL;
+    }
+
+  leave_critical_section(flags);
+  return req;
+}
+
+/****************************************************************************
+ * Name: spi_async_thread
+ *
+ * Description:
+ *   The thread of a bus.  It performs the queued requests one after the
+ *   other, so that a driver that queues the next transfers before the
+ *   current ones complete keeps the bus busy without waiting for them.
+ *
+ ****************************************************************************/
+
+static int spi_async_thread(int argc, FAR char *argv[])
+{
+  FAR struct spi_asyncbus_s *bus;
+  FAR struct spi_async_s *req;
+  int ret;
+
+  DEBUGASSERT(argc > 1);
+  bus = &g_spi_async[atoi(argv[1])];
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&bus->sem);
+
+      /* The request may have been cancelled since it was posted */
+
+      req = spi_async_take(bus);
+      if (req == NULL)
+        {
+          continue;
+        }
+
+      ret = spi_transfer(bus->spi, req->seq);
+      if (ret < 0)
+        {
+          spierr("ERROR: spi_transfer failed: %d\n", ret);
+        }
+
+      if (req->callback != NULL)
+        {
+          req->callback(req, ret);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_async_bus
+ *
+ * Description:
+ *   Return the queue of a bus, starting its thread on the first request.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_asyncbus_s *spi_async_bus(FAR struct spi_dev_s *spi,
+                                                bool create)
+{
+  FAR struct spi_asyncbus_s *bus = NULL;
+  FAR char *argv[2];
+  char arg[8];
+  int ret;
+  int i;
+
+  nxmutex_lock(&g_spi_async_lock);
+
+  for (i = 0; i < CONFIG_SPI_ASYNC_NBUSES; i++)
+    {
+      if (g_spi_async[i].spi == spi)
+        {
+          bus = &g_spi_async[i];
+          goto out;
+        }
+    }
+
+  if (!create)
+    {
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_SPI_ASYNC_NBUSES; i++)
+    {
+      if (g_spi_async[i].spi == NULL)
+        {
+          break;
+        }
+    }
+
+  if (i >= CONFIG_SPI_ASYNC_NBUSES)
+    {
+      spierr("ERROR: Too many buses\n");
+      goto out;
+    }
+
+  nxsem_init(&g_spi_async[i].sem, 0, 0);
+  g_spi_async[i].spi = spi;
+
+  snprintf(arg, sizeof(arg), "%d", i);
+  argv[0] = arg;
+  argv[1] = NULL;
+
+  ret = kthread_create("spi_async", CONFIG_SPI_ASYNC_PRIORITY,
+                       CONFIG_SPI_ASYNC_STACKSIZE, spi_async_thread, argv);
+  if (ret < 0)
+    {
+      spierr("ERROR: kthread_create failed: %d\n", ret);
+      nxsem_destroy(&g_spi_async[i].sem);
+      g_spi_async[i].spi = NULL;
+      goto out;
+    }
+
+  bus = &g_spi_async[i];
+
+out:
+  nxmutex_unlock(&g_spi_async_lock);
+  return bus;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return at once.  See
+ *   include/nuttx/spi/spi_transfer.h.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_async_s *req)
+{
+  FAR struct spi_asyncbus_s *bus;
+  irqstate_t flags;
+
+  DEBUGASSERT(spi != NULL && req != NULL && req->seq != NULL);
+
+  bus = spi_async_bus(spi, true);
+  if (bus == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  req->flink = NULL;
+
+  flags = enter_critical_section();
+
+  if (bus->tail != NULL)
+    {
+      bus->tail->flink = req;
+    }
+  else
+    {
+      bus->head = req;
+    }
+
+  bus->tail = req;
+
+  leave_critical_section(flags);
+
+  nxsem_post(&bus->sem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_transfer_cancel
+ *
+ * Description:
+ *   Remove a request from the queue of its bus if it has not been started.
+ *
+ ****************************************************************************/
+
+int spi_transfer_cancel(FAR struct spi_dev_s *spi,
+                        FAR struct spi_async_s *req)
+{
+  FAR struct spi_asyncbus_s *bus;
+  FAR struct spi_async_s *prev = NULL;
+  FAR struct spi_async_s *curr;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  DEBUGASSERT(spi != NULL && req != NULL);
+
+  bus = spi_async_bus(spi, false);
+  if (bus == NULL)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  for (curr = bus->head; curr != NULL; prev = curr, curr = curr->flink)
+    {
+      if (curr == req)
+        {
+          if (prev != NULL)
+            {
+              prev->flink = curr->flink;
+            }
+          else
+            {
+              bus->head = curr->flink;
+            }
+
+          if (bus->tail == curr)
+            {
+              bus->tail = prev;
+            }
+
+          curr->flink = NULL;
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_SPI_ASYNC */
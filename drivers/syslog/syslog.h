@@ -224,6 +224,66 @@ int syslog_add_intbuffer(int ch);
 int syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_staging_write
+ *
+ * Description:
+ *   Copy a message into the staging buffer of the current CPU, to be
+ *   output to the SYSLOG channels by a low priority work.
+ *
+ * Input Parameters:
+ *   buffer - The buffer containing the data to be output
+ *   buflen - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   The number of characters accepted; zero if the message was dropped
+ *   because the staging buffer is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_STAGING
+ssize_t syslog_staging_write(FAR const char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: syslog_staging_flush
+ *
+ * Description:
+ *   Output the messages in the staging buffers now.
+ *
+ * Input Parameters:
+ *   force - Use the force() method of the channels vs. the write() method.
+ *
+ * Assumptions:
+ *   Interrupts may or may not be disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_STAGING
+void syslog_staging_flush(bool force);
+#endif
+
+/****************************************************************************
+ * Name: syslog_binary
+ *
+ * Description:
+ *   Write a message to the SYSLOG channels as a binary record instead of
+ *   formatting it.  See struct syslog_binary_s.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The format string of the message
+ *   ap       - The arguments of the format
+ *
+ * Returned Value:
+ *   The number of bytes written; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+int syslog_binary(int priority, FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
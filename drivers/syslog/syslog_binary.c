@@ -0,0 +1,319 @@
+/****************************************************************************
+ * drivers/syslog/syslog_binary.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_BINARY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Support special access to CODE-space strings for Harvard architectures */
+
+#ifdef CONFIG_ARCH_ROMGETC
+#  define fmt_char(fmt)   up_romgetc((fmt)++)
+#else
+#  define fmt_char(fmt)   (*(fmt)++)
+#endif
+
+/* Append the next argument of the given type, or stop if it does not fit */
+
+#define binary_arg(type) \
+  do \
+    { \
+      type value = va_arg(*ap, type); \
+      if (len + sizeof(type) > CONFIG_SYSLOG_BINARY_MAXLEN) \
+        { \
+          return len; \
+        } \
+      \
+      memcpy(&buf[len], &value, sizeof(type)); \
+      len += sizeof(type); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_binary_args
+ *
+ * Description:
+ *   Append the arguments of the format to a record that already holds
+ *   'len' bytes and return the new length.
+ *
+ ****************************************************************************/
+
+static size_t syslog_binary_args(FAR uint8_t *buf, size_t len,
+                                 FAR const IPTR char *fmt,
+                                 FAR va_list *ap)
+{
+  FAR const char *str;
+  size_t size;
+  char c;
+
+  while ((c = fmt_char(fmt)) != '\0')
+    {
+      if (c != '%')
+        {
+          continue;
+        }
+
+      /* Flags */
+
+      do
+        {
+          c = fmt_char(fmt);
+        }
+      while (c == '-' || c == '+' || c == ' ' || c == '#' || c == '0');
+
+      /* Width and precision, which may be arguments too */
+
+      if (c == '*')
+        {
+          binary_arg(int);
+          c = fmt_char(fmt);
+        }
+
+      while (c >= '0' && c <= '9')
+        {
+          c = fmt_char(fmt);
+        }
+
+      if (c == '.')
+        {
+          c = fmt_char(fmt);
+          if (c == '*')
+            {
+              binary_arg(int);
+              c = fmt_char(fmt);
+            }
+
+          while (c >= '0' && c <= '9')
+            {
+              c = fmt_char(fmt);
+            }
+        }
+
+      /* Length modifiers and conversion */
+
+      switch (c)
+        {
+          case 'h':
+            c = fmt_char(fmt);
+            if (c == 'h')
+              {
+                c = fmt_char(fmt);
+              }
+
+            binary_arg(int);
+            break;
+
+          case 'l':
+            c = fmt_char(fmt);
+#ifdef CONFIG_HAVE_LONG_LONG
+            if (c == 'l')
+              {
+                c = fmt_char(fmt);
+                binary_arg(long long);
+                break;
+              }
+#endif
+
+            if (c == 'f' || c == 'e' || c == 'g' || c == 'a' ||
+                c == 'F' || c == 'E' || c == 'G' || c == 'A')
+              {
+#ifdef CONFIG_HAVE_DOUBLE
+                binary_arg(double);
+#endif
+              }
+            else
+              {
+                binary_arg(long);
+              }
+            break;
+
+          case 'j':
+            c = fmt_char(fmt);
+            binary_arg(intmax_t);
+            break;
+
+          case 'z':
+            c = fmt_char(fmt);
+            binary_arg(size_t);
+            break;
+
+          case 't':
+            c = fmt_char(fmt);
+            binary_arg(ptrdiff_t);
+            break;
+
+          case 'L':
+            c = fmt_char(fmt);
+#ifdef CONFIG_HAVE_LONG_DOUBLE
+            binary_arg(long double);
+#endif
+            break;
+
+          case 'd':
+          case 'i':
+          case 'u':
+          case 'o':
+          case 'x':
+          case 'X':
+          case 'c':
+            binary_arg(int);
+            break;
+
+          case 'f':
+          case 'e':
+          case 'g':
+          case 'a':
+          case 'F':
+          case 'E':
+          case 'G':
+          case 'A':
+#ifdef CONFIG_HAVE_DOUBLE
+            binary_arg(double);
+#endif
+            break;
+
+          case 'p':
+            binary_arg(uintptr_t);
+            break;
+
+          case 's':
+
+            /* Strings are copied: they may not exist any more when the
+             * record is formatted.
+             */
+
+            if (len >= CONFIG_SYSLOG_BINARY_MAXLEN)
+              {
+                return len;
+              }
+
+            str = va_arg(*ap, FAR const char *);
+            if (str == NULL)
+              {
+                str = "(null)";
+              }
+
+            size = strnlen(str, CONFIG_SYSLOG_BINARY_MAXLEN - len - 1);
+            memcpy(&buf[len], str, size);
+            buf[len + size] = '\0';
+            len += size + 1;
+            break;
+
+          case 'n':
+            (void)va_arg(*ap, FAR int *);
+            break;
+
+          default:
+            break;
+        }
+
+      /* The format may end within a conversion */
+
+      if (c == '\0')
+        {
+          break;
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_binary
+ *
+ * Description:
+ *   Write a message to the SYSLOG channels as a binary record instead of
+ *   formatting it.  See struct syslog_binary_s.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The format string of the message
+ *   ap       - The arguments of the format
+ *
+ * Returned Value:
+ *   The number of bytes written; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int syslog_binary(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  uint8_t buf[CONFIG_SYSLOG_BINARY_MAXLEN];
+  FAR struct syslog_binary_s *hdr = (FAR struct syslog_binary_s *)buf;
+  struct timespec ts;
+  size_t len;
+
+  ts.tv_sec  = 0;
+  ts.tv_nsec = 0;
+
+  /* Hardware timer support may not yet be available */
+
+  if (OSINIT_HW_READY())
+    {
+#if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
+      clock_gettime(CLOCK_REALTIME, &ts);
+#else
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    }
+
+  hdr->sb_magic[0] = SYSLOG_BINARY_MAGIC0;
+  hdr->sb_magic[1] = SYSLOG_BINARY_MAGIC1;
+  hdr->sb_priority = priority;
+  hdr->sb_pid      = gettid();
+  hdr->sb_sec      = ts.tv_sec;
+  hdr->sb_nsec     = ts.tv_nsec;
+  hdr->sb_fmt      = (uintptr_t)fmt;
+
+  len = syslog_binary_args(buf, sizeof(struct syslog_binary_s), fmt, ap);
+  hdr->sb_length = len;
+
+  return syslog_write((FAR const char *)buf, len);
+}
+
+#endif /* CONFIG_SYSLOG_BINARY */
@@ -55,6 +55,11 @@
 
 int syslog_putc(int ch)
 {
+#ifdef CONFIG_SYSLOG_STAGING
+  char c = ch;
+
+  syslog_staging_write(&c, 1);
+#else
   int i;
 
   /* Is this an attempt to do SYSLOG output from an interrupt handler? */
@@ -117,6 +122,7 @@ int syslog_putc(int ch)
           g_syslog_channel[i]->sc_ops->sc_putc(g_syslog_channel[i], ch);
         }
     }
+#endif
 
   return ch;
 }
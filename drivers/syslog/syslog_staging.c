@@ -0,0 +1,409 @@
+/****************************************************************************
+ * drivers/syslog/syslog_staging.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_STAGING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SYSLOG_STAGING_SIZE & (CONFIG_SYSLOG_STAGING_SIZE - 1)) != 0
+#  error CONFIG_SYSLOG_STAGING_SIZE must be a power of two
+#endif
+
+#define STAGING_MASK      (CONFIG_SYSLOG_STAGING_SIZE - 1)
+#define STAGING_ALIGN     sizeof(struct syslog_record_s)
+#define STAGING_RECSIZE(len) \
+  (((len) + 2 * STAGING_ALIGN - 1) & ~(STAGING_ALIGN - 1))
+
+/* The longest message, so that a ring never holds less than two */
+
+#define STAGING_MAXLEN    (CONFIG_SYSLOG_STAGING_SIZE / 2 - STAGING_ALIGN)
+
+/* The record fills the end of the buffer, the next one is at the start */
+
+#define STAGING_PADDING   0xffff
+
+#ifdef CONFIG_SMP
+#  define STAGING_NCPUS   CONFIG_SMP_NCPUS
+#  define STAGING_CPU()   up_cpu_index()
+#else
+#  define STAGING_NCPUS   1
+#  define STAGING_CPU()   0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The header of a message in a staging buffer.  The messages are
+ * contiguous, aligned to the size of the header.
+ */
+
+struct syslog_record_s
+{
+  uint32_t sr_seq;                 /* Order among the messages of all CPUs */
+  uint16_t sr_len;                 /* Length of the message or padding */
+  uint16_t sr_reserved;
+};
+
+/* The staging buffer of one CPU.  It has a single producer, the CPU with
+ * its interrupts disabled, and a single consumer, the flusher.  The
+ * indexes run freely and are only reduced modulo the size to access the
+ * buffer.
+ */
+
+struct syslog_staging_s
+{
+  uint32_t ss_head;                /* Written by the CPU */
+  uint32_t ss_tail;                /* Written by the flusher */
+  uint32_t ss_dropped;             /* Messages dropped by the CPU */
+  uint32_t ss_reported;            /* Drops reported by the flusher */
+  uint32_t ss_buffer[CONFIG_SYSLOG_STAGING_SIZE / sizeof(uint32_t)];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_staging_s g_syslog_staging[STAGING_NCPUS];
+static struct work_s g_syslog_staging_work;
+static uint32_t g_syslog_staging_seq;
+static bool g_syslog_staging_draining;
+static bool g_syslog_staging_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_staging_record
+ ****************************************************************************/
+
+static inline FAR struct syslog_record_s *
+syslog_staging_record(FAR struct syslog_staging_s *ss, uint32_t index)
+{
+  return (FAR struct syslog_record_s *)
+    ((FAR uint8_t *)ss->ss_buffer + (index & STAGING_MASK));
+}
+
+/****************************************************************************
+ * Name: syslog_staging_output
+ *
+ * Description:
+ *   Output a message to all of the SYSLOG channels.
+ *
+ ****************************************************************************/
+
+static void syslog_staging_output(FAR const char *buffer, size_t buflen,
+                                  bool force)
+{
+  FAR struct syslog_channel_s *channel;
+  size_t i;
+  int j;
+
+  for (j = 0; j < CONFIG_SYSLOG_MAX_CHANNELS; j++)
+    {
+      channel = g_syslog_channel[j];
+      if (channel == NULL)
+        {
+          break;
+        }
+
+      if (force)
+        {
+          DEBUGASSERT(channel->sc_ops->sc_force != NULL);
+
+          for (i = 0; i < buflen; i++)
+            {
+              channel->sc_ops->sc_force(channel, buffer[i]);
+            }
+        }
+      else if (channel->sc_ops->sc_write != NULL)
+        {
+          channel->sc_ops->sc_write(channel, buffer, buflen);
+        }
+      else
+        {
+          DEBUGASSERT(channel->sc_ops->sc_putc != NULL);
+
+          for (i = 0; i < buflen; i++)
+            {
+              channel->sc_ops->sc_putc(channel, buffer[i]);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_staging_peek
+ *
+ * Description:
+ *   Return the oldest message of a staging buffer, skipping the padding,
+ *   or NULL if the buffer is empty.
+ *
+ ****************************************************************************/
+
+static FAR struct syslog_record_s *
+syslog_staging_peek(FAR struct syslog_staging_s *ss)
+{
+  FAR struct syslog_record_s *rec;
+  uint32_t head = __atomic_load_n(&ss->ss_head, __ATOMIC_ACQUIRE);
+  uint32_t tail = ss->ss_tail;
+
+  while (tail != head)
+    {
+      rec = syslog_staging_record(ss, tail);
+      if (rec->sr_len != STAGING_PADDING)
+        {
+          return rec;
+        }
+
+      tail += CONFIG_SYSLOG_STAGING_SIZE - (tail & STAGING_MASK);
+      __atomic_store_n(&ss->ss_tail, tail, __ATOMIC_RELEASE);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: syslog_staging_drain
+ *
+ * Description:
+ *   Merge the messages of the staging buffers into the SYSLOG channels in
+ *   the order in which they were written.  Only one context drains at a
+ *   time; the others return at once.
+ *
+ ****************************************************************************/
+
+static void syslog_staging_drain(bool force)
+{
+  FAR struct syslog_staging_s *oldest;
+  FAR struct syslog_record_s *rec;
+  FAR struct syslog_record_s *min;
+  char msg[32];
+  uint32_t dropped;
+  int cpu;
+  int len;
+
+  if (__atomic_exchange_n(&g_syslog_staging_draining, true,
+                          __ATOMIC_ACQUIRE))
+    {
+      return;
+    }
+
+  for (; ; )
+    {
+      oldest = NULL;
+      min    = NULL;
+
+      for (cpu = 0; cpu < STAGING_NCPUS; cpu++)
+        {
+          rec = syslog_staging_peek(&g_syslog_staging[cpu]);
+          if (rec != NULL &&
+              (min == NULL || (int32_t)(rec->sr_seq - min->sr_seq) < 0))
+            {
+              oldest = &g_syslog_staging[cpu];
+              min    = rec;
+            }
+        }
+
+      if (min == NULL)
+        {
+          break;
+        }
+
+      syslog_staging_output((FAR const char *)(min + 1), min->sr_len,
+                            force);
+
+      /* Only then the CPU may reuse the space of the message */
+
+      __atomic_store_n(&oldest->ss_tail,
+                       oldest->ss_tail + STAGING_RECSIZE(min->sr_len),
+                       __ATOMIC_RELEASE);
+    }
+
+  for (cpu = 0; cpu < STAGING_NCPUS; cpu++)
+    {
+      oldest  = &g_syslog_staging[cpu];
+      dropped = __atomic_load_n(&oldest->ss_dropped, __ATOMIC_RELAXED) -
+                oldest->ss_reported;
+      if (dropped > 0)
+        {
+          oldest->ss_reported += dropped;
+          len = snprintf(msg, sizeof(msg), "[CPU%d: %lu dropped]\n",
+                         cpu, (unsigned long)dropped);
+          syslog_staging_output(msg, len, force);
+        }
+    }
+
+  __atomic_store_n(&g_syslog_staging_draining, false, __ATOMIC_RELEASE);
+}
+
+/****************************************************************************
+ * Name: syslog_staging_worker
+ ****************************************************************************/
+
+static void syslog_staging_worker(FAR void *arg)
+{
+  syslog_staging_drain(false);
+  work_queue(LPWORK, &g_syslog_staging_work, syslog_staging_worker, NULL,
+             MSEC2TICK(CONFIG_SYSLOG_STAGING_PERIOD));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_staging_write
+ *
+ * Description:
+ *   Copy a message into the staging buffer of the current CPU.  Interrupts
+ *   are only disabled on this CPU for the copy, so neither threads nor
+ *   interrupt handlers ever wait for each other, or for the channels.
+ *
+ *   The messages written before the OS is ready go to the channels at
+ *   once, as the work queue that flushes the buffers may not run yet.
+ *
+ * Input Parameters:
+ *   buffer - The buffer containing the data to be output
+ *   buflen - The number of bytes in the buffer
+ *
+ * Returned Value:
+ *   The number of characters accepted; zero if the message was dropped
+ *   because the staging buffer is full.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_staging_write(FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_staging_s *ss;
+  FAR struct syslog_record_s *rec;
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t size;
+  uint32_t room;
+
+  if (!OSINIT_OS_READY())
+    {
+      syslog_staging_output(buffer, buflen,
+                            up_interrupt_context() || sched_idletask());
+      return buflen;
+    }
+
+  /* The flusher is started by the first thread that logs */
+
+  if (!g_syslog_staging_started && !up_interrupt_context())
+    {
+      g_syslog_staging_started = true;
+      work_queue(LPWORK, &g_syslog_staging_work, syslog_staging_worker,
+                 NULL, 0);
+    }
+
+  if (buflen > STAGING_MAXLEN)
+    {
+      buflen = STAGING_MAXLEN;
+    }
+
+  size  = STAGING_RECSIZE(buflen);
+  flags = up_irq_save();
+
+  ss   = &g_syslog_staging[STAGING_CPU()];
+  head = ss->ss_head;
+  tail = __atomic_load_n(&ss->ss_tail, __ATOMIC_ACQUIRE);
+
+  /* A message does not wrap around the end of the buffer */
+
+  room = CONFIG_SYSLOG_STAGING_SIZE - (head & STAGING_MASK);
+  if (room < size)
+    {
+      if (head + room + size - tail > CONFIG_SYSLOG_STAGING_SIZE)
+        {
+          goto drop;
+        }
+
+      syslog_staging_record(ss, head)->sr_len = STAGING_PADDING;
+      head += room;
+    }
+  else if (head + size - tail > CONFIG_SYSLOG_STAGING_SIZE)
+    {
+      goto drop;
+    }
+
+  rec         = syslog_staging_record(ss, head);
+  rec->sr_seq = __atomic_fetch_add(&g_syslog_staging_seq, 1,
+                                   __ATOMIC_RELAXED);
+  rec->sr_len = buflen;
+  memcpy(rec + 1, buffer, buflen);
+
+  /* Publish the message to the flusher */
+
+  __atomic_store_n(&ss->ss_head, head + size, __ATOMIC_RELEASE);
+  up_irq_restore(flags);
+  return buflen;
+
+drop:
+  __atomic_store_n(&ss->ss_dropped, ss->ss_dropped + 1, __ATOMIC_RELAXED);
+  up_irq_restore(flags);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: syslog_staging_flush
+ *
+ * Description:
+ *   Output the messages in the staging buffers now.
+ *
+ * Input Parameters:
+ *   force - Use the force() method of the channels vs. the write() method.
+ *
+ ****************************************************************************/
+
+void syslog_staging_flush(bool force)
+{
+  syslog_staging_drain(force);
+}
+
+#endif /* CONFIG_SYSLOG_STAGING */
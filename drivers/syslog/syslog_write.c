@@ -139,6 +139,9 @@ static ssize_t syslog_default_write(FAR const char *buffer, size_t buflen)
 
 ssize_t syslog_write(FAR const char *buffer, size_t buflen)
 {
+#ifdef CONFIG_SYSLOG_STAGING
+  return syslog_staging_write(buffer, buflen);
+#else
 #ifdef CONFIG_SYSLOG_INTBUFFER
   if (!up_interrupt_context() && !sched_idletask())
     {
@@ -151,4 +154,5 @@ ssize_t syslog_write(FAR const char *buffer, size_t buflen)
 #endif
 
   return syslog_default_write(buffer, buflen);
+#endif
 }
@@ -80,6 +80,12 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #endif
 #endif
 
+#ifdef CONFIG_SYSLOG_BINARY
+  /* Only record the arguments, the message is formatted on the host */
+
+  return syslog_binary(priority, fmt, ap);
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.
    */
@@ -31,6 +31,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -39,6 +40,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/timers/capture.h>
 
 #include <arch/irq.h>
@@ -62,6 +64,16 @@ struct cap_upperhalf_s
   uint8_t                    crefs;    /* The number of times the device has been opened */
   mutex_t                    lock;     /* Supports mutual exclusion */
   FAR struct cap_lowerhalf_s *lower;   /* lower-half state */
+#ifdef CONFIG_CAPTURE_STREAM
+  bool                       streaming; /* True: the edges are streamed */
+  bool                       overrun;   /* True: edges were dropped */
+  uint8_t                    nwaiters;  /* Readers waiting for edges */
+  uint16_t                   head;      /* Oldest queued edge */
+  uint16_t                   tail;      /* Next free entry of the FIFO */
+  sem_t                      waitsem;   /* Wakes up the readers */
+  FAR struct pollfd          *fds[CONFIG_CAPTURE_NPOLLWAITERS];
+  struct cap_event_s         fifo[CONFIG_CAPTURE_FIFOSIZE];
+#endif
 };
 
 /****************************************************************************
@@ -75,6 +87,10 @@ static ssize_t cap_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t cap_write(FAR struct file *filep, FAR const char *buffer,
                         size_t buflen);
 static int cap_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#ifdef CONFIG_CAPTURE_STREAM
+static int     cap_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -88,7 +104,11 @@ static const struct file_operations g_capops =
   cap_write, /* write */
   NULL,      /* seek */
   cap_ioctl, /* ioctl */
+#ifdef CONFIG_CAPTURE_STREAM
+  cap_poll,  /* poll */
+#else
   NULL,      /* poll */
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   NULL       /* unlink */
 #endif
@@ -98,6 +118,117 @@ static const struct file_operations g_capops =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_CAPTURE_STREAM
+/****************************************************************************
+ * Name: cap_stream_handler
+ *
+ * Description:
+ *   Queue a block of edges delivered by the lower half.  The newest edges
+ *   are dropped if the FIFO is full.  This may run at interrupt level.
+ *
+ ****************************************************************************/
+
+static void cap_stream_handler(FAR void *arg,
+                               FAR const struct cap_event_s *events,
+                               size_t nevents)
+{
+  FAR struct cap_upperhalf_s *upper = arg;
+  irqstate_t flags;
+  uint16_t next;
+  size_t i;
+
+  flags = enter_critical_section();
+
+  for (i = 0; i < nevents; i++)
+    {
+      next = upper->tail + 1;
+      if (next >= CONFIG_CAPTURE_FIFOSIZE)
+        {
+          next = 0;
+        }
+
+      if (next == upper->head)
+        {
+          upper->overrun = true;
+          break;
+        }
+
+      upper->fifo[upper->tail] = events[i];
+      upper->tail = next;
+    }
+
+  /* Wake up the readers once for the whole block */
+
+  if (i > 0)
+    {
+      poll_notify(upper->fds, CONFIG_CAPTURE_NPOLLWAITERS, POLLIN);
+      if (upper->nwaiters > 0)
+        {
+          nxsem_post(&upper->waitsem);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cap_stream
+ *
+ * Description:
+ *   Start or stop the streaming of the edges.
+ *
+ ****************************************************************************/
+
+static int cap_stream(FAR struct cap_upperhalf_s *upper, bool enable)
+{
+  FAR struct cap_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  if (lower->ops->stream == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  if (enable == upper->streaming)
+    {
+      return OK;
+    }
+
+  if (enable)
+    {
+      flags = enter_critical_section();
+      upper->head    = 0;
+      upper->tail    = 0;
+      upper->overrun = false;
+      leave_critical_section(flags);
+
+      ret = lower->ops->stream(lower, cap_stream_handler, upper);
+      if (ret >= 0)
+        {
+          upper->streaming = true;
+        }
+
+      return ret;
+    }
+
+  ret = lower->ops->stream(lower, NULL, NULL);
+
+  /* Let the waiting readers drain the FIFO and see the end */
+
+  flags = enter_critical_section();
+  upper->streaming = false;
+  for (i = 0; i < upper->nwaiters; i++)
+    {
+      nxsem_post(&upper->waitsem);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: cap_open
  *
@@ -202,6 +333,10 @@ static int cap_close(FAR struct file *filep)
 
       upper->crefs = 0;
 
+#ifdef CONFIG_CAPTURE_STREAM
+      cap_stream(upper, false);
+#endif
+
       /* Disable the PWM Capture device */
 
       DEBUGASSERT(lower->ops->stop != NULL);
@@ -220,7 +355,8 @@ errout:
  * Name: cap_read
  *
  * Description:
- *   A dummy read method.  This is provided only to satisfy the VFS layer.
+ *   Return the queued edges while streaming.  Otherwise, this is a dummy
+ *   read method, provided only to satisfy the VFS layer.
  *
  ****************************************************************************/
 
@@ -228,9 +364,78 @@ static ssize_t cap_read(FAR struct file *filep,
                        FAR char *buffer,
                        size_t buflen)
 {
+#ifdef CONFIG_CAPTURE_STREAM
+  FAR struct inode           *inode  = filep->f_inode;
+  FAR struct cap_upperhalf_s *upper  = inode->i_private;
+  FAR struct cap_event_s     *events = (FAR struct cap_event_s *)buffer;
+  size_t                      nevents;
+  size_t                      n      = 0;
+  irqstate_t                  flags;
+  ssize_t                     ret;
+
+  if (!upper->streaming)
+    {
+      return 0;
+    }
+
+  nevents = buflen / sizeof(struct cap_event_s);
+  if (nevents == 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (upper->head == upper->tail)
+    {
+      /* Report the dropped edges once the FIFO is drained */
+
+      if (upper->overrun)
+        {
+          upper->overrun = false;
+          ret = -EIO;
+          goto out;
+        }
+
+      if (!upper->streaming)
+        {
+          ret = 0;
+          goto out;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      upper->nwaiters++;
+      ret = nxsem_wait(&upper->waitsem);
+      upper->nwaiters--;
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  while (n < nevents && upper->head != upper->tail)
+    {
+      events[n++] = upper->fifo[upper->head];
+      if (++upper->head >= CONFIG_CAPTURE_FIFOSIZE)
+        {
+          upper->head = 0;
+        }
+    }
+
+  ret = n * sizeof(struct cap_event_s);
+
+out:
+  leave_critical_section(flags);
+  return ret;
+#else
   /* Return zero -- usually meaning end-of-file */
 
   return 0;
+#endif
 }
 
 /****************************************************************************
@@ -308,6 +513,18 @@ static int cap_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_CAPTURE_STREAM
+      /* CAPIOC_STREAM - Start or stop the streaming of the edges.
+       * Argument: Nonzero to start, zero to stop.
+       */
+
+      case CAPIOC_STREAM:
+        {
+          ret = cap_stream(upper, arg != 0);
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl
        * commands
        */
@@ -323,6 +540,57 @@ static int cap_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_CAPTURE_STREAM
+/****************************************************************************
+ * Name: cap_poll
+ ****************************************************************************/
+
+static int cap_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                    bool setup)
+{
+  FAR struct inode           *inode = filep->f_inode;
+  FAR struct cap_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd         **slot;
+  irqstate_t                  flags;
+  int                         ret   = OK;
+  int                         i;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_CAPTURE_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_CAPTURE_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (upper->head != upper->tail)
+        {
+          poll_notify(&fds, 1, POLLIN);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -366,6 +634,9 @@ int cap_register(FAR const char *devpath, FAR struct cap_lowerhalf_s *lower)
    */
 
   nxmutex_init(&upper->lock);
+#ifdef CONFIG_CAPTURE_STREAM
+  nxsem_init(&upper->waitsem, 0, 0);
+#endif
   upper->lower = lower;
 
   /* Register the PWM Capture device */
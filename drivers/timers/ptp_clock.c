@@ -0,0 +1,173 @@
+/****************************************************************************
+ * drivers/timers/ptp_clock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/timers/ptp_clock.h>
+
+#ifdef CONFIG_PTP_CLOCK
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ptp_clock_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ptp_clock_ops =
+{
+  NULL,            /* open */
+  NULL,            /* close */
+  NULL,            /* read */
+  NULL,            /* write */
+  NULL,            /* seek */
+  ptp_clock_ioctl, /* ioctl */
+  NULL,            /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL             /* unlink */
+#endif
+};
+
+/* The clock of CLOCK_PTP */
+
+static FAR struct ptp_lowerhalf_s *g_ptp_clock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ptp_clock_ioctl
+ ****************************************************************************/
+
+static int ptp_clock_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg)
+{
+  FAR struct ptp_lowerhalf_s *lower = filep->f_inode->i_private;
+  FAR const struct ptp_ops_s *ops = lower->ops;
+  int ret = -ENOTTY;
+
+  switch (cmd)
+    {
+      case PTPIOC_GETTIME:
+        if (ops->gettime != NULL)
+          {
+            ret = ops->gettime(lower, (FAR struct timespec *)arg);
+          }
+        break;
+
+      case PTPIOC_SETTIME:
+        if (ops->settime != NULL)
+          {
+            ret = ops->settime(lower, (FAR const struct timespec *)arg);
+          }
+        break;
+
+      case PTPIOC_ADJTIME:
+        if (ops->adjtime != NULL)
+          {
+            ret = ops->adjtime(lower, *(FAR const int64_t *)arg);
+          }
+        break;
+
+      case PTPIOC_ADJFINE:
+        if (ops->adjfine != NULL)
+          {
+            ret = ops->adjfine(lower, (long)arg);
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ptp_clock_register
+ ****************************************************************************/
+
+int ptp_clock_register(FAR struct ptp_lowerhalf_s *lower, int devno)
+{
+  char devpath[16];
+  int ret;
+
+  DEBUGASSERT(lower != NULL && lower->ops != NULL);
+
+  snprintf(devpath, sizeof(devpath), "/dev/ptp%d", devno);
+  ret = register_driver(devpath, &g_ptp_clock_ops, 0666, lower);
+  if (ret >= 0 && g_ptp_clock == NULL)
+    {
+      g_ptp_clock = lower;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ptp_clock_gettime / ptp_clock_settime
+ ****************************************************************************/
+
+int ptp_clock_gettime(FAR struct timespec *ts)
+{
+  FAR struct ptp_lowerhalf_s *lower = g_ptp_clock;
+
+  if (lower == NULL || lower->ops->gettime == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return lower->ops->gettime(lower, ts);
+}
+
+int ptp_clock_settime(FAR const struct timespec *ts)
+{
+  FAR struct ptp_lowerhalf_s *lower = g_ptp_clock;
+
+  if (lower == NULL || lower->ops->settime == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return lower->ops->settime(lower, ts);
+}
+
+#endif /* CONFIG_PTP_CLOCK */
@@ -539,6 +539,47 @@ static int pwm_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* PWMIOC_UPDATE - Change the duty cycles of the started output on
+       *   all channels at once.
+       *
+       *   ioctl argument:  A read-only reference to struct pwm_info_s that
+       *   provides the characteristics of the pulsed output.
+       */
+
+      case PWMIOC_UPDATE:
+        {
+          FAR const struct pwm_info_s *info =
+            (FAR const struct pwm_info_s *)((uintptr_t)arg);
+          DEBUGASSERT(info != NULL && lower->ops->start != NULL);
+
+          pwm_dump("PWMIOC_UPDATE", info, upper->started);
+
+          if (upper->started && lower->ops->update != NULL)
+            {
+              /* Keep the old characteristics if the update is refused */
+
+              ret = lower->ops->update(lower, info);
+              if (ret >= 0)
+                {
+                  memcpy(&upper->info, info, sizeof(struct pwm_info_s));
+                }
+            }
+          else
+            {
+              memcpy(&upper->info, info, sizeof(struct pwm_info_s));
+
+              if (upper->started)
+                {
+#ifdef CONFIG_PWM_PULSECOUNT
+                  ret = lower->ops->start(lower, &upper->info, upper);
+#else
+                  ret = lower->ops->start(lower, &upper->info);
+#endif
+                }
+            }
+        }
+        break;
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl
        * commands.
        */
@@ -321,12 +321,30 @@ static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
 
   while (xmit->head != xmit->tail && nbytes < reqlen)
     {
-      *reqbuf++ = xmit->buffer[xmit->tail];
-      nbytes++;
+      uint16_t nrun;
+
+      /* Copy the contiguous bytes up to the head or the end of the buffer,
+       * whichever comes first.
+       */
+
+      if (xmit->head > xmit->tail)
+        {
+          nrun = xmit->head - xmit->tail;
+        }
+      else
+        {
+          nrun = xmit->size - xmit->tail;
+        }
+
+      nrun = MIN(nrun, reqlen - nbytes);
+      memcpy(reqbuf, &xmit->buffer[xmit->tail], nrun);
+      reqbuf += nrun;
+      nbytes += nrun;
 
       /* Increment the tail pointer */
 
-      if (++(xmit->tail) >= xmit->size)
+      xmit->tail += nrun;
+      if (xmit->tail >= xmit->size)
         {
           xmit->tail = 0;
         }
@@ -555,7 +573,6 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
               break;
             }
         }
-#endif
 
       /* Copy one byte to the head of the circular RX buffer */
 
@@ -569,6 +586,42 @@ static int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
         {
           nexthead = 0;
         }
+#else
+      uint16_t nrun;
+
+      /* Without watermarks to check on each byte, copy the run of free
+       * bytes up to the tail, or to the end of the buffer, at once.  One
+       * byte before the tail always stays free.
+       */
+
+      if (recv->tail > recv->head)
+        {
+          nrun = recv->tail - recv->head - 1;
+        }
+      else
+        {
+          nrun = recv->size - recv->head - (recv->tail == 0);
+        }
+
+      nrun = MIN(nrun, reqlen - nbytes);
+      memcpy(&recv->buffer[recv->head], reqbuf, nrun);
+      reqbuf += nrun;
+      nbytes += nrun;
+
+      /* Increment the head index and check for wrap around */
+
+      recv->head += nrun;
+      if (recv->head >= recv->size)
+        {
+          recv->head = 0;
+        }
+
+      nexthead = recv->head + 1;
+      if (nexthead >= recv->size)
+        {
+          nexthead = 0;
+        }
+#endif
     }
 
 #if defined(CONFIG_SERIAL_IFLOWCONTROL) && \
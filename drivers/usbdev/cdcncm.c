@@ -0,0 +1,2449 @@
+/****************************************************************************
+ * drivers/usbdev/cdcncm.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* References:
+ *   [CDCNCM1.0] Universal Serial Bus - Communications Class - Subclass
+ *               Specification for Network Control Model Devices - Rev 1.0
+ *
+ * The network side is a lower half of drivers/net/netdev_upperhalf.c, so
+ * the frames are IOB chains.  Every USB transfer is a 16-bit NCM Transfer
+ * Block (NTB) that carries as many frames as fit: the frames that the
+ * stack sends while an NTB is in flight are collected into the next one,
+ * and the OUT NTBs of the host are split into frames as they are received.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/usb/usbdev.h>
+#include <nuttx/usb/cdc.h>
+#include <nuttx/usb/usbdev_trace.h>
+
+#ifdef CONFIG_CDCNCM_BOARD_SERIALSTR
+#include <nuttx/board.h>
+#endif
+
+#include "cdcncm.h"
+
+#ifdef CONFIG_NET_CDCNCM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ETHWORK LPWORK
+
+/* The size of the notifications on the interrupt IN endpoint: the
+ * ConnectionSpeedChange notification is the larger one.
+ */
+
+#define CDCNCM_NOTIFY_SIZE \
+  SIZEOF_NOTIFICATION_S(sizeof(struct cdc_speedchange_s))
+
+/* The notifications that are sent when the data interface is enabled */
+
+#define CDCNCM_NOTIFY_NONE       (0)
+#define CDCNCM_NOTIFY_SPEED      (1) /* ConnectionSpeedChange is next */
+#define CDCNCM_NOTIFY_CONNECT    (2) /* NetworkConnection is next */
+
+/* The largest frame that an empty NTB holds */
+
+#define CDCNCM_NTB_MAXFRAME(ntbsize) \
+  ((ntbsize) - CDCNCM_NTB_ALIGN(SIZEOF_NCM_NTH16) - SIZEOF_NCM_NDP16(2) - \
+   CDCNCM_NTB_DIVISOR)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* An IN NTB.  While it is being filled, dgram[] holds the position of each
+ * frame; the NDP16 is written behind the frames when it is submitted.
+ */
+
+struct cdcncm_wrreq_s
+{
+  sq_entry_t                   entry;       /* Free list */
+  FAR struct usbdev_req_s     *req;
+  uint16_t                     len;         /* Bytes in req->buf */
+  uint16_t                     ndgrams;     /* Frames in req->buf */
+  uint16_t                     dgram[CONFIG_CDCNCM_NTB_MAXDATAGRAMS][2];
+};
+
+/* An OUT NTB */
+
+struct cdcncm_rdreq_s
+{
+  sq_entry_t                   entry;       /* Received or idle list */
+  FAR struct usbdev_req_s     *req;
+};
+
+/* The cdcncm_driver_s encapsulates all state information for a single
+ * hardware interface
+ */
+
+struct cdcncm_driver_s
+{
+  /* USB CDC-NCM device */
+
+  struct usbdevclass_driver_s  usbdev;      /* USB device class vtable */
+  struct usbdev_devinfo_s      devinfo;
+  FAR struct usbdev_req_s     *ctrlreq;     /* Allocated control request */
+  FAR struct usbdev_req_s     *notifyreq;   /* Interrupt IN request */
+  FAR struct usbdev_ep_s      *epint;       /* Interrupt IN endpoint */
+  FAR struct usbdev_ep_s      *epbulkin;    /* Bulk IN endpoint */
+  FAR struct usbdev_ep_s      *epbulkout;   /* Bulk OUT endpoint */
+  uint8_t                      config;      /* Selected configuration */
+  uint8_t                      altsetting;  /* Of the data interface */
+  uint8_t                      notify;      /* Next notification to send */
+  bool                         notifying;   /* notifyreq is in flight */
+  bool                         hispeed;     /* Connected at high speed */
+
+  /* NTB state.  The sizes are those negotiated with the host. */
+
+  uint32_t                     ntbinmax;    /* The largest IN NTB */
+  uint16_t                     txseq;       /* wSequence of the next IN NTB */
+
+  /* Receiving: the OUT NTBs received and the one being split up */
+
+  struct cdcncm_rdreq_s        rdreqs[CONFIG_CDCNCM_NRDREQS];
+  sq_queue_t                   rdidle;      /* Not queued to the endpoint */
+  sq_queue_t                   rxq;         /* Received, not yet split */
+  FAR struct cdcncm_rdreq_s   *rxcur;       /* Being split */
+  uint16_t                     rxblklen;    /* wBlockLength of rxcur */
+  uint16_t                     rxdpe;       /* Next datagram pointer */
+  uint16_t                     rxndpend;    /* End of the current NDP16 */
+  uint16_t                     rxndp;       /* Offset of the current NDP16 */
+
+  /* Sending: the IN NTBs free and the one being filled */
+
+  struct cdcncm_wrreq_s        wrreqs[CONFIG_CDCNCM_NWRREQS];
+  sq_queue_t                   wrfree;      /* Free IN NTBs */
+  FAR struct cdcncm_wrreq_s   *txcur;       /* Being filled */
+  FAR netpkt_t                *txpkt;       /* Waiting for a free NTB */
+  uint8_t                      ninflight;   /* IN NTBs submitted */
+  bool                         connected;   /* Data interface enabled */
+  bool                         carrier;     /* Carrier reported to the
+                                             * network */
+  struct work_s                txwork;      /* Flush and carrier work */
+
+  /* This holds the information visible to the NuttX network */
+
+  struct netdev_lowerhalf_s    dev;         /* Interface understood by the
+                                             * network */
+  bool                         registered;  /* netdev is registered */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Network Device ***********************************************************/
+
+static int  cdcncm_ifup(FAR struct netdev_lowerhalf_s *dev);
+static int  cdcncm_ifdown(FAR struct netdev_lowerhalf_s *dev);
+static int  cdcncm_transmit(FAR struct netdev_lowerhalf_s *dev,
+              FAR netpkt_t *pkt);
+static FAR netpkt_t *cdcncm_receive(FAR struct netdev_lowerhalf_s *dev);
+#ifdef CONFIG_NET_MCASTGROUP
+static int  cdcncm_addmac(FAR struct netdev_lowerhalf_s *dev,
+              FAR const uint8_t *mac);
+static int  cdcncm_rmmac(FAR struct netdev_lowerhalf_s *dev,
+              FAR const uint8_t *mac);
+#endif
+
+static void cdcncm_txwork(FAR void *arg);
+
+/* USB Device Class Driver **************************************************/
+
+/* USB Device Class methods */
+
+static int  cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev);
+
+static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev);
+
+static int  cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev, FAR const struct usb_ctrlreq_s *ctrl,
+              FAR uint8_t *dataout, size_t outlen);
+
+static void cdcncm_disconnect(FAR struct usbdevclass_driver_s *driver,
+              FAR struct usbdev_s *dev);
+
+/* USB Device Class helpers */
+
+static void cdcncm_ep0incomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_intcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
+              FAR struct usbdev_req_s *req);
+
+static void cdcncm_mkepdesc(int epidx,
+              FAR struct usb_epdesc_s *epdesc,
+              FAR struct usbdev_devinfo_s *devinfo, bool hispeed);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* USB Device Class Methods */
+
+static const struct usbdevclass_driverops_s g_usbdevops =
+{
+  cdcncm_bind,
+  cdcncm_unbind,
+  cdcncm_setup,
+  cdcncm_disconnect,
+  NULL,
+  NULL
+};
+
+/* Network Device Methods */
+
+static const struct netdev_ops_s g_netops =
+{
+  cdcncm_ifup,
+  cdcncm_ifdown,
+  cdcncm_transmit,
+  cdcncm_receive,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  NULL,
+#endif
+#ifdef CONFIG_NET_MCASTGROUP
+  cdcncm_addmac,
+  cdcncm_rmmac,
+#endif
+#ifdef CONFIG_NETDEV_IOCTL
+  NULL,
+#endif
+};
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+static const struct usb_devdesc_s g_devdesc =
+{
+  USB_SIZEOF_DEVDESC,
+  USB_DESC_TYPE_DEVICE,
+  {
+    LSBYTE(0x0200),
+    MSBYTE(0x0200)
+  },
+  USB_CLASS_CDC,
+  CDC_SUBCLASS_NONE,
+  CDC_PROTO_NONE,
+  CONFIG_CDCNCM_EP0MAXPACKET,
+  {
+    LSBYTE(CONFIG_CDCNCM_VENDORID),
+    MSBYTE(CONFIG_CDCNCM_VENDORID)
+  },
+  {
+    LSBYTE(CONFIG_CDCNCM_PRODUCTID),
+    MSBYTE(CONFIG_CDCNCM_PRODUCTID)
+  },
+  {
+    LSBYTE(CDCNCM_VERSIONNO),
+    MSBYTE(CDCNCM_VERSIONNO)
+  },
+  CDCNCM_MANUFACTURERSTRID,
+  CDCNCM_PRODUCTSTRID,
+  CDCNCM_SERIALSTRID,
+  CDCNCM_NCONFIGS
+};
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+static const struct usb_qualdesc_s g_qualdesc =
+{
+  USB_SIZEOF_QUALDESC,
+  USB_DESC_TYPE_DEVICEQUALIFIER,
+  {
+    LSBYTE(0x0200),
+    MSBYTE(0x0200)
+  },
+  USB_CLASS_CDC,
+  CDC_SUBCLASS_NONE,
+  CDC_PROTO_NONE,
+  CONFIG_CDCNCM_EP0MAXPACKET,
+  CDCNCM_NCONFIGS,
+  0
+};
+#endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_putle16 / cdcncm_putle32
+ *
+ * Description:
+ *   Store a little endian value into an NTB or a control response
+ *
+ ****************************************************************************/
+
+static void cdcncm_putle16(FAR uint8_t *dest, uint16_t val)
+{
+  dest[0] = val & 0xff;
+  dest[1] = val >> 8;
+}
+
+static void cdcncm_putle32(FAR uint8_t *dest, uint32_t val)
+{
+  cdcncm_putle16(dest, val & 0xffff);
+  cdcncm_putle16(dest + 2, val >> 16);
+}
+
+/****************************************************************************
+ * Name: cdcncm_ntb_fits
+ *
+ * Description:
+ *   Check if a frame of len bytes fits into an IN NTB, behind its frames
+ *   and in front of an NDP16 with one more datagram pointer.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_ntb_fits(FAR struct cdcncm_driver_s *self,
+                            FAR struct cdcncm_wrreq_s *wrcontainer,
+                            unsigned int len)
+{
+  unsigned int end;
+
+  if (wrcontainer->ndgrams >= CONFIG_CDCNCM_NTB_MAXDATAGRAMS)
+    {
+      return false;
+    }
+
+  end = CDCNCM_NTB_ALIGN(wrcontainer->len) + len;
+  return CDCNCM_NTB_ALIGN(end) +
+         SIZEOF_NCM_NDP16(wrcontainer->ndgrams + 2) <= self->ntbinmax;
+}
+
+/****************************************************************************
+ * Name: cdcncm_ntb_append
+ *
+ * Description:
+ *   Copy a frame into an IN NTB, which must have room for it.
+ *
+ ****************************************************************************/
+
+static void cdcncm_ntb_append(FAR struct cdcncm_driver_s *self,
+                              FAR struct cdcncm_wrreq_s *wrcontainer,
+                              FAR netpkt_t *pkt, unsigned int len)
+{
+  FAR uint8_t *buf = wrcontainer->req->buf;
+  unsigned int offset = CDCNCM_NTB_ALIGN(wrcontainer->len);
+
+  memset(&buf[wrcontainer->len], 0, offset - wrcontainer->len);
+  netpkt_copyout(&self->dev, &buf[offset], pkt, len, 0);
+
+  wrcontainer->dgram[wrcontainer->ndgrams][0] = offset;
+  wrcontainer->dgram[wrcontainer->ndgrams][1] = len;
+  wrcontainer->ndgrams++;
+  wrcontainer->len = offset + len;
+}
+
+/****************************************************************************
+ * Name: cdcncm_ntb_alloc
+ *
+ * Description:
+ *   Start filling a free IN NTB, if there is one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct cdcncm_wrreq_s *
+cdcncm_ntb_alloc(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct cdcncm_wrreq_s *wrcontainer;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  wrcontainer = (FAR struct cdcncm_wrreq_s *)sq_remfirst(&self->wrfree);
+  leave_critical_section(flags);
+
+  if (wrcontainer != NULL)
+    {
+      wrcontainer->len     = SIZEOF_NCM_NTH16;
+      wrcontainer->ndgrams = 0;
+    }
+
+  self->txcur = wrcontainer;
+  return wrcontainer;
+}
+
+/****************************************************************************
+ * Name: cdcncm_ntb_submit
+ *
+ * Description:
+ *   Complete the NTB being filled with its NDP16 and NTH16 and send it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcncm_ntb_submit(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct cdcncm_wrreq_s *wrcontainer = self->txcur;
+  FAR struct usbdev_req_s *req = wrcontainer->req;
+  FAR struct cdc_ncm_nth16_s *nth;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  FAR struct cdc_ncm_dpe16_s *dpe;
+  unsigned int ndpoffset;
+  unsigned int ndplen;
+  unsigned int i;
+  irqstate_t flags;
+  int ret;
+
+  self->txcur = NULL;
+
+  /* The NDP16 follows the last frame */
+
+  ndpoffset = CDCNCM_NTB_ALIGN(wrcontainer->len);
+  ndplen    = SIZEOF_NCM_NDP16(wrcontainer->ndgrams + 1);
+  memset(&req->buf[wrcontainer->len], 0, ndpoffset - wrcontainer->len);
+
+  ndp = (FAR struct cdc_ncm_ndp16_s *)&req->buf[ndpoffset];
+  cdcncm_putle32(ndp->sig, NCM_NDP16_SIGNATURE);
+  cdcncm_putle16(ndp->len, ndplen);
+  cdcncm_putle16(ndp->nextndp, 0);
+
+  dpe = (FAR struct cdc_ncm_dpe16_s *)(ndp + 1);
+  for (i = 0; i < wrcontainer->ndgrams; i++, dpe++)
+    {
+      cdcncm_putle16(dpe->index, wrcontainer->dgram[i][0]);
+      cdcncm_putle16(dpe->len, wrcontainer->dgram[i][1]);
+    }
+
+  memset(dpe, 0, sizeof(struct cdc_ncm_dpe16_s));
+
+  nth = (FAR struct cdc_ncm_nth16_s *)req->buf;
+  cdcncm_putle32(nth->sig, NCM_NTH16_SIGNATURE);
+  cdcncm_putle16(nth->hdrlen, SIZEOF_NCM_NTH16);
+  cdcncm_putle16(nth->seq, self->txseq++);
+  cdcncm_putle16(nth->blklen, ndpoffset + ndplen);
+  cdcncm_putle16(nth->ndpindex, ndpoffset);
+
+  /* An NTB shorter than the negotiated maximum ends with a short packet */
+
+  req->len      = ndpoffset + ndplen;
+  req->flags    = req->len < self->ntbinmax ? USBDEV_REQFLAGS_NULLPKT : 0;
+  req->priv     = wrcontainer;
+  req->callback = cdcncm_wrcomplete;
+
+  flags = enter_critical_section();
+  self->ninflight++;
+  leave_critical_section(flags);
+
+  ret = EP_SUBMIT(self->epbulkin, req);
+  if (ret < 0)
+    {
+      uerr("EP_SUBMIT failed. ret %d\n", ret);
+      NETDEV_TXERRORS(&self->dev.netdev);
+
+      flags = enter_critical_section();
+      self->ninflight--;
+      sq_addlast(&wrcontainer->entry, &self->wrfree);
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifup
+ *
+ * Description:
+ *   NuttX Callback: Bring up the Ethernet interface when an IP address is
+ *   provided
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifup(FAR struct netdev_lowerhalf_s *dev)
+{
+  /* The carrier follows the data interface, see cdcncm_txwork() */
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_ifdown
+ *
+ * Description:
+ *   NuttX Callback: Stop the interface.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_ifdown(FAR struct netdev_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit
+ *
+ * Description:
+ *   Add a frame to the IN NTB being filled.  A full NTB is sent at once; a
+ *   partial one is sent by cdcncm_txwork() once no NTB is in flight, so the
+ *   frames queued meanwhile travel together.
+ *
+ * Input Parameters:
+ *   dev - Reference to the lower half driver state structure
+ *   pkt - The frame
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int cdcncm_transmit(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  FAR struct cdcncm_driver_s *self =
+    container_of(dev, struct cdcncm_driver_s, dev);
+  unsigned int len = netpkt_getdatalen(dev, pkt);
+
+  if (!self->connected)
+    {
+      return -ENETDOWN;
+    }
+
+  if (len > CDCNCM_NTB_MAXFRAME(self->ntbinmax))
+    {
+      return -EMSGSIZE;
+    }
+
+  if (self->txcur != NULL && !cdcncm_ntb_fits(self, self->txcur, len))
+    {
+      cdcncm_ntb_submit(self);
+    }
+
+  if (self->txcur == NULL && cdcncm_ntb_alloc(self) == NULL)
+    {
+      /* All NTBs are in flight.  Keep the frame: this uses up the TX
+       * quota so that the stack stops sending until an NTB completes.
+       */
+
+      self->txpkt = pkt;
+      return OK;
+    }
+
+  cdcncm_ntb_append(self, self->txcur, pkt, len);
+  netpkt_free(dev, pkt, NETPKT_TX);
+
+  if (self->ninflight == 0 && work_available(&self->txwork))
+    {
+      work_queue(ETHWORK, &self->txwork, cdcncm_txwork, self, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcncm_rxrecycle
+ *
+ * Description:
+ *   Give the OUT NTB that was split up back to the bulk OUT endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_rxrecycle(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct cdcncm_rdreq_s *rdcontainer = self->rxcur;
+  irqstate_t flags;
+
+  self->rxcur = NULL;
+
+  flags = enter_critical_section();
+  if (self->config == CDCNCM_CONFIGID_NONE ||
+      EP_SUBMIT(self->epbulkout, rdcontainer->req) < 0)
+    {
+      sq_addlast(&rdcontainer->entry, &self->rdidle);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cdcncm_rxndp
+ *
+ * Description:
+ *   Check the NDP16 at offset of the OUT NTB being split up and start on
+ *   its datagram pointers.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_rxndp(FAR struct cdcncm_driver_s *self,
+                         unsigned int offset)
+{
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  unsigned int len;
+
+  if (offset % CDCNCM_NTB_DIVISOR != 0 ||
+      offset + SIZEOF_NCM_NDP16(2) > self->rxblklen)
+    {
+      return false;
+    }
+
+  ndp = (FAR struct cdc_ncm_ndp16_s *)&self->rxcur->req->buf[offset];
+  len = GETUINT16(ndp->len);
+  if (GETUINT32(ndp->sig) != NCM_NDP16_SIGNATURE ||
+      len < SIZEOF_NCM_NDP16(2) || offset + len > self->rxblklen)
+    {
+      return false;
+    }
+
+  self->rxndp    = offset;
+  self->rxdpe    = offset + SIZEOF_NCM_NDP16(0);
+  self->rxndpend = offset + len;
+  return true;
+}
+
+/****************************************************************************
+ * Name: cdcncm_rxntb
+ *
+ * Description:
+ *   Check the NTH16 of the next OUT NTB received and start on its first
+ *   NDP16.
+ *
+ ****************************************************************************/
+
+static bool cdcncm_rxntb(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct usbdev_req_s *req = self->rxcur->req;
+  FAR struct cdc_ncm_nth16_s *nth = (FAR struct cdc_ncm_nth16_s *)req->buf;
+
+  if (req->xfrd < SIZEOF_NCM_NTH16 ||
+      GETUINT32(nth->sig) != NCM_NTH16_SIGNATURE ||
+      GETUINT16(nth->hdrlen) != SIZEOF_NCM_NTH16)
+    {
+      return false;
+    }
+
+  self->rxblklen = GETUINT16(nth->blklen);
+  if (self->rxblklen < SIZEOF_NCM_NTH16 || self->rxblklen > req->xfrd)
+    {
+      return false;
+    }
+
+  return cdcncm_rxndp(self, GETUINT16(nth->ndpindex));
+}
+
+/****************************************************************************
+ * Name: cdcncm_receive
+ *
+ * Description:
+ *   Return the next frame of the OUT NTBs received, or NULL once they are
+ *   all split up.  Each NTB is given back to the endpoint when its last
+ *   frame is taken.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *cdcncm_receive(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct cdcncm_driver_s *self =
+    container_of(dev, struct cdcncm_driver_s, dev);
+  FAR struct cdc_ncm_dpe16_s *dpe;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  FAR netpkt_t *pkt;
+  FAR uint8_t *buf;
+  unsigned int index;
+  unsigned int len;
+  unsigned int next;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      if (self->rxcur == NULL)
+        {
+          flags = enter_critical_section();
+          self->rxcur = (FAR struct cdcncm_rdreq_s *)sq_remfirst(&self->rxq);
+          leave_critical_section(flags);
+
+          if (self->rxcur == NULL)
+            {
+              return NULL;
+            }
+
+          if (!cdcncm_rxntb(self))
+            {
+              uerr("Bad NTB, %u bytes\n", self->rxcur->req->xfrd);
+              NETDEV_RXERRORS(&dev->netdev);
+              cdcncm_rxrecycle(self);
+              continue;
+            }
+        }
+
+      buf = self->rxcur->req->buf;
+      if (self->rxdpe + sizeof(struct cdc_ncm_dpe16_s) > self->rxndpend)
+        {
+          index = 0;
+          len   = 0;
+        }
+      else
+        {
+          dpe   = (FAR struct cdc_ncm_dpe16_s *)&buf[self->rxdpe];
+          index = GETUINT16(dpe->index);
+          len   = GETUINT16(dpe->len);
+          self->rxdpe += sizeof(struct cdc_ncm_dpe16_s);
+        }
+
+      if (index == 0 || len == 0)
+        {
+          /* The end of this NDP16.  The next one, if any, must follow it
+           * so that a malformed NTB cannot loop forever.
+           */
+
+          ndp  = (FAR struct cdc_ncm_ndp16_s *)&buf[self->rxndp];
+          next = GETUINT16(ndp->nextndp);
+          if (next <= self->rxndp || !cdcncm_rxndp(self, next))
+            {
+              cdcncm_rxrecycle(self);
+            }
+
+          continue;
+        }
+
+      if (index + len > self->rxblklen || len > CONFIG_NET_ETH_PKTSIZE)
+        {
+          NETDEV_RXERRORS(&dev->netdev);
+          continue;
+        }
+
+      pkt = netpkt_alloc(dev, NETPKT_RX);
+      if (pkt == NULL)
+        {
+          NETDEV_RXDROPPED(&dev->netdev);
+          continue;
+        }
+
+      if (netpkt_copyin(dev, pkt, &buf[index], len, 0) < 0)
+        {
+          NETDEV_RXDROPPED(&dev->netdev);
+          netpkt_free(dev, pkt, NETPKT_RX);
+          continue;
+        }
+
+      return pkt;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_addmac / cdcncm_rmmac
+ *
+ * Description:
+ *   NuttX Callback: Add or remove a multicast MAC address.  The host
+ *   filters the frames of the simulated point-to-point link.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MCASTGROUP
+static int cdcncm_addmac(FAR struct netdev_lowerhalf_s *dev,
+                         FAR const uint8_t *mac)
+{
+  return OK;
+}
+
+static int cdcncm_rmmac(FAR struct netdev_lowerhalf_s *dev,
+                        FAR const uint8_t *mac)
+{
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: cdcncm_txwork
+ *
+ * Description:
+ *   Follow the data interface with the carrier, queue the frame that
+ *   waited for a free NTB and send the partial NTB once the endpoint is
+ *   idle.
+ *
+ * Assumptions:
+ *   Runs on a work queue thread.
+ *
+ ****************************************************************************/
+
+static void cdcncm_txwork(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR netpkt_t *pkt;
+  irqstate_t flags;
+  unsigned int len;
+
+  net_lock();
+
+  if (self->connected != self->carrier)
+    {
+      self->carrier = self->connected;
+      if (self->carrier)
+        {
+          netdev_lower_carrier_on(&self->dev);
+        }
+      else
+        {
+          netdev_lower_carrier_off(&self->dev);
+        }
+    }
+
+  if (!self->connected)
+    {
+      /* Drop what was not sent yet */
+
+      if (self->txcur != NULL)
+        {
+          flags = enter_critical_section();
+          sq_addlast(&self->txcur->entry, &self->wrfree);
+          leave_critical_section(flags);
+          self->txcur = NULL;
+        }
+
+      if (self->txpkt != NULL)
+        {
+          netpkt_free(&self->dev, self->txpkt, NETPKT_TX);
+          self->txpkt = NULL;
+          netdev_lower_txdone(&self->dev);
+        }
+    }
+  else if (self->txpkt != NULL &&
+           (self->txcur != NULL || cdcncm_ntb_alloc(self) != NULL))
+    {
+      pkt = self->txpkt;
+      len = netpkt_getdatalen(&self->dev, pkt);
+
+      self->txpkt = NULL;
+      cdcncm_ntb_append(self, self->txcur, pkt, len);
+      netpkt_free(&self->dev, pkt, NETPKT_TX);
+
+      /* The stack may send again */
+
+      netdev_lower_txdone(&self->dev);
+    }
+
+  if (self->txcur != NULL && self->txcur->ndgrams > 0 &&
+      self->ninflight == 0)
+    {
+      cdcncm_ntb_submit(self);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * USB Device Class Helpers
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_ep0incomplete
+ *
+ * Description:
+ *   Handle completion of EP0 control operations
+ *
+ ****************************************************************************/
+
+static void cdcncm_ep0incomplete(FAR struct usbdev_ep_s *ep,
+                                 FAR struct usbdev_req_s *req)
+{
+  if (req->result || req->xfrd != req->len)
+    {
+      uerr("result: %hd, xfrd: %hu\n", req->result, req->xfrd);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_notify
+ *
+ * Description:
+ *   Send the next notification of the data interface being enabled:
+ *   first the ConnectionSpeedChange, then the NetworkConnection that
+ *   reports the link up to the host.
+ *
+ * Assumptions:
+ *   Called from the USB interrupt handler or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void cdcncm_notify(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct usbdev_req_s *req = self->notifyreq;
+  FAR struct cdc_notification_s *notification;
+  FAR struct cdc_speedchange_s *speed;
+  uint32_t bitrate;
+  uint16_t datalen = 0;
+
+  if (self->notifying || self->notify == CDCNCM_NOTIFY_NONE)
+    {
+      return;
+    }
+
+  notification = (FAR struct cdc_notification_s *)req->buf;
+  notification->type = USB_REQ_DIR_IN | USB_REQ_TYPE_CLASS |
+                       USB_REQ_RECIPIENT_INTERFACE;
+  cdcncm_putle16(notification->index, self->devinfo.ifnobase);
+
+  if (self->notify == CDCNCM_NOTIFY_SPEED)
+    {
+      bitrate = self->hispeed ? 480000000 : 12000000;
+      speed   = (FAR struct cdc_speedchange_s *)notification->data;
+      datalen = sizeof(struct cdc_speedchange_s);
+
+      cdcncm_putle32(speed->us, bitrate);
+      cdcncm_putle32(speed->ds, bitrate);
+
+      notification->notification = ECM_SPEED_CHANGE;
+      cdcncm_putle16(notification->value, 0);
+      self->notify = CDCNCM_NOTIFY_CONNECT;
+    }
+  else
+    {
+      notification->notification = ECM_NETWORK_CONNECTION;
+      cdcncm_putle16(notification->value, self->connected);
+      self->notify = CDCNCM_NOTIFY_NONE;
+    }
+
+  cdcncm_putle16(notification->len, datalen);
+
+  req->len      = SIZEOF_NOTIFICATION_S(datalen);
+  req->flags    = 0;
+  req->callback = cdcncm_intcomplete;
+
+  self->notifying = true;
+  if (EP_SUBMIT(self->epint, req) < 0)
+    {
+      self->notifying = false;
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_intcomplete
+ *
+ * Description:
+ *   Handle completion of a notification on the interrupt IN endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_intcomplete(FAR struct usbdev_ep_s *ep,
+                               FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+
+  self->notifying = false;
+  if (req->result == OK)
+    {
+      cdcncm_notify(self);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_rdcomplete
+ *
+ * Description:
+ *   Handle completion of read request on the bulk OUT endpoint.
+ *
+ ****************************************************************************/
+
+static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+  FAR struct cdcncm_rdreq_s *rdcontainer =
+    (FAR struct cdcncm_rdreq_s *)req->priv;
+  irqstate_t flags;
+
+  uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
+        req->buf, req->flags, req->len, req->xfrd, req->result);
+
+  flags = enter_critical_section();
+  switch (req->result)
+    {
+      case 0:  /* Normal completion */
+        {
+          sq_addlast(&rdcontainer->entry, &self->rxq);
+          netdev_lower_rxready(&self->dev);
+        }
+        break;
+
+      case -ESHUTDOWN:  /* Disconnection */
+        {
+          sq_addlast(&rdcontainer->entry, &self->rdidle);
+        }
+        break;
+
+      default: /* Some other error occurred */
+        {
+          uerr("req->result: %hd\n", req->result);
+          if (EP_SUBMIT(self->epbulkout, req) < 0)
+            {
+              sq_addlast(&rdcontainer->entry, &self->rdidle);
+            }
+        }
+        break;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cdcncm_wrcomplete
+ *
+ * Description:
+ *   Handle completion of write request.  This function probably executes
+ *   in the context of an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
+                              FAR struct usbdev_req_s *req)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+  FAR struct cdcncm_wrreq_s *wrcontainer =
+    (FAR struct cdcncm_wrreq_s *)req->priv;
+  irqstate_t flags;
+
+  uinfo("buf: %p, flags 0x%hhx, len %hu, xfrd %hu, result %hd\n",
+        req->buf, req->flags, req->len, req->xfrd, req->result);
+
+  if (req->result != OK)
+    {
+      NETDEV_TXERRORS(&self->dev.netdev);
+    }
+  else
+    {
+      NETDEV_TXDONE(&self->dev.netdev);
+    }
+
+  flags = enter_critical_section();
+  self->ninflight--;
+  sq_addlast(&wrcontainer->entry, &self->wrfree);
+  leave_critical_section(flags);
+
+  /* Send the frames collected meanwhile */
+
+  if (work_available(&self->txwork))
+    {
+      work_queue(ETHWORK, &self->txwork, cdcncm_txwork, self, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_allocreq
+ *
+ * Description:
+ *   Allocate a request instance along with its buffer
+ *
+ ****************************************************************************/
+
+static struct usbdev_req_s *cdcncm_allocreq(FAR struct usbdev_ep_s *ep,
+                                            uint16_t len)
+{
+  FAR struct usbdev_req_s *req;
+
+  req = EP_ALLOCREQ(ep);
+
+  if (req != NULL)
+    {
+      req->len   = len;
+      req->buf   = EP_ALLOCBUFFER(ep, len);
+      req->flags = USBDEV_REQFLAGS_NULLPKT;
+
+      if (req->buf == NULL)
+        {
+          EP_FREEREQ(ep, req);
+          req = NULL;
+        }
+    }
+
+  return req;
+}
+
+/****************************************************************************
+ * Name: cdcncm_freereq
+ *
+ * Description:
+ *   Free a request instance along with its buffer
+ *
+ ****************************************************************************/
+
+static void cdcncm_freereq(FAR struct usbdev_ep_s *ep,
+                           FAR struct usbdev_req_s *req)
+{
+  if (ep != NULL && req != NULL)
+    {
+      if (req->buf != NULL)
+        {
+          EP_FREEBUFFER(ep, req->buf);
+        }
+
+      EP_FREEREQ(ep, req);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_setinterface
+ *
+ * Description:
+ *   Select the alternate setting of the data interface.  Setting 1 enables
+ *   the bulk endpoints, setting 0 resets the NTB parameters to their
+ *   defaults [CDCNCM1.0, 7.2].
+ *
+ ****************************************************************************/
+
+static void cdcncm_setinterface(FAR struct cdcncm_driver_s *self,
+                                uint16_t altsetting)
+{
+  uinfo("altsetting: %hu\n", altsetting);
+
+  self->altsetting = altsetting;
+  self->ntbinmax   = CONFIG_CDCNCM_NTB_INSIZE;
+  self->txseq      = 0;
+  self->connected  = (altsetting == 1);
+
+  if (self->connected)
+    {
+      self->notify = CDCNCM_NOTIFY_SPEED;
+      cdcncm_notify(self);
+    }
+  else
+    {
+      self->notify = CDCNCM_NOTIFY_NONE;
+    }
+
+  if (work_available(&self->txwork))
+    {
+      work_queue(ETHWORK, &self->txwork, cdcncm_txwork, self, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_resetconfig
+ *
+ * Description:
+ *   Mark the device as not configured and disable all endpoints.
+ *
+ ****************************************************************************/
+
+static void cdcncm_resetconfig(FAR struct cdcncm_driver_s *self)
+{
+  /* Are we configured? */
+
+  if (self->config != CDCNCM_CONFIGID_NONE)
+    {
+      /* Yes.. but not anymore */
+
+      self->config = CDCNCM_CONFIGID_NONE;
+
+      /* Report the link down */
+
+      cdcncm_setinterface(self, 0);
+
+      /* Disable endpoints.  This should force completion of all pending
+       * transfers.
+       */
+
+      EP_DISABLE(self->epint);
+      EP_DISABLE(self->epbulkin);
+      EP_DISABLE(self->epbulkout);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_setconfig
+ *
+ *   Set the device configuration by allocating and configuring endpoints and
+ *   by allocating and queue read and write requests.
+ *
+ ****************************************************************************/
+
+static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self,
+                            FAR struct usbdev_s *dev, uint8_t config)
+{
+  FAR struct cdcncm_rdreq_s *rdcontainer;
+  struct usb_epdesc_s epdesc;
+  int ret = OK;
+
+  if (config == self->config)
+    {
+      return OK;
+    }
+
+  cdcncm_resetconfig(self);
+
+  if (config == CDCNCM_CONFIGID_NONE)
+    {
+      return OK;
+    }
+
+  if (config != CDCNCM_CONFIGID)
+    {
+      return -EINVAL;
+    }
+
+  self->hispeed = (dev->speed == USB_SPEED_HIGH);
+
+  cdcncm_mkepdesc(CDCNCM_EP_INTIN_IDX, &epdesc, &self->devinfo,
+                  self->hispeed);
+  ret = EP_CONFIGURE(self->epint, &epdesc, false);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epint->priv = self;
+
+  cdcncm_mkepdesc(CDCNCM_EP_BULKIN_IDX, &epdesc, &self->devinfo,
+                  self->hispeed);
+  ret = EP_CONFIGURE(self->epbulkin, &epdesc, false);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epbulkin->priv = self;
+
+  cdcncm_mkepdesc(CDCNCM_EP_BULKOUT_IDX, &epdesc, &self->devinfo,
+                  self->hispeed);
+  ret = EP_CONFIGURE(self->epbulkout, &epdesc, true);
+
+  if (ret < 0)
+    {
+      goto error;
+    }
+
+  self->epbulkout->priv = self;
+
+  /* Queue the OUT NTBs that are not waiting to be split up */
+
+  while ((rdcontainer =
+          (FAR struct cdcncm_rdreq_s *)sq_remfirst(&self->rdidle)) != NULL)
+    {
+      ret = EP_SUBMIT(self->epbulkout, rdcontainer->req);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          sq_addfirst(&rdcontainer->entry, &self->rdidle);
+          goto error;
+        }
+    }
+
+  /* We are successfully configured */
+
+  self->config = config;
+  return OK;
+
+error:
+  cdcncm_resetconfig(self);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkstrdesc
+ *
+ * Description:
+ *   Construct a string descriptor
+ *
+ ****************************************************************************/
+
+static int cdcncm_mkstrdesc(uint8_t id, FAR struct usb_strdesc_s *strdesc)
+{
+  FAR uint8_t *data = (FAR uint8_t *)(strdesc + 1);
+  FAR const char *str;
+  int len;
+  int ndata;
+  int i;
+
+  switch (id)
+    {
+#ifndef CONFIG_CDCNCM_COMPOSITE
+    case 0:
+      {
+        /* Descriptor 0 is the language id */
+
+        strdesc->len  = 4;
+        strdesc->type = USB_DESC_TYPE_STRING;
+        data[0] = LSBYTE(CDCNCM_STR_LANGUAGE);
+        data[1] = MSBYTE(CDCNCM_STR_LANGUAGE);
+        return 4;
+      }
+
+    case CDCNCM_MANUFACTURERSTRID:
+      str = CONFIG_CDCNCM_VENDORSTR;
+      break;
+
+    case CDCNCM_PRODUCTSTRID:
+      str = CONFIG_CDCNCM_PRODUCTSTR;
+      break;
+
+    case CDCNCM_SERIALSTRID:
+#ifdef CONFIG_CDCNCM_BOARD_SERIALSTR
+      str = board_usbdev_serialstr();
+#else
+      str = "0";
+#endif
+      break;
+
+    case CDCNCM_CONFIGSTRID:
+      str = "Default";
+      break;
+#endif
+
+    case CDCNCM_MACSTRID:
+      str = "020000112233";
+      break;
+
+    default:
+      uwarn("Unknown string descriptor index: %d\n", id);
+      return -EINVAL;
+    }
+
+  /* The string is utf16-le.  The poor man's utf-8 to utf16-le
+   * conversion below will only handle 7-bit en-us ascii
+   */
+
+  len = strlen(str);
+  if (len > (CDCNCM_MAXSTRLEN / 2))
+    {
+      len = (CDCNCM_MAXSTRLEN / 2);
+    }
+
+  for (i = 0, ndata = 0; i < len; i++, ndata += 2)
+    {
+      data[ndata]     = str[i];
+      data[ndata + 1] = 0;
+    }
+
+  strdesc->len  = ndata + 2;
+  strdesc->type = USB_DESC_TYPE_STRING;
+  return strdesc->len;
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkepdesc
+ *
+ * Description:
+ *   Construct the endpoint descriptor
+ *
+ ****************************************************************************/
+
+static void cdcncm_mkepdesc(int epidx,
+                            FAR struct usb_epdesc_s *epdesc,
+                            FAR struct usbdev_devinfo_s *devinfo,
+                            bool hispeed)
+{
+  uint16_t intin_mxpktsz   = CONFIG_CDCNCM_EPINTIN_FSSIZE;
+  uint16_t bulkout_mxpktsz = CONFIG_CDCNCM_EPBULKOUT_FSSIZE;
+  uint16_t bulkin_mxpktsz  = CONFIG_CDCNCM_EPBULKIN_FSSIZE;
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  if (hispeed)
+    {
+      intin_mxpktsz   = CONFIG_CDCNCM_EPINTIN_HSSIZE;
+      bulkout_mxpktsz = CONFIG_CDCNCM_EPBULKOUT_HSSIZE;
+      bulkin_mxpktsz  = CONFIG_CDCNCM_EPBULKIN_HSSIZE;
+    }
+#else
+  UNUSED(hispeed);
+#endif
+
+  epdesc->len  = USB_SIZEOF_EPDESC;            /* Descriptor length */
+  epdesc->type = USB_DESC_TYPE_ENDPOINT;       /* Descriptor type */
+
+  switch (epidx)
+    {
+      case CDCNCM_EP_INTIN_IDX:  /* Interrupt IN endpoint */
+        {
+          epdesc->addr            = USB_DIR_IN |
+                                    devinfo->epno[CDCNCM_EP_INTIN_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_INT;
+          epdesc->mxpacketsize[0] = LSBYTE(intin_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(intin_mxpktsz);
+          epdesc->interval        = hispeed ? 9 : 32; /* 32 ms */
+        }
+        break;
+
+      case CDCNCM_EP_BULKIN_IDX:
+        {
+          epdesc->addr            = USB_DIR_IN |
+                                    devinfo->epno[CDCNCM_EP_BULKIN_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_BULK;
+          epdesc->mxpacketsize[0] = LSBYTE(bulkin_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(bulkin_mxpktsz);
+          epdesc->interval        = 0;
+        }
+        break;
+
+      case CDCNCM_EP_BULKOUT_IDX:
+        {
+          epdesc->addr            = USB_DIR_OUT |
+                                    devinfo->epno[CDCNCM_EP_BULKOUT_IDX];
+          epdesc->attr            = USB_EP_ATTR_XFER_BULK;
+          epdesc->mxpacketsize[0] = LSBYTE(bulkout_mxpktsz);
+          epdesc->mxpacketsize[1] = MSBYTE(bulkout_mxpktsz);
+          epdesc->interval        = 0;
+        }
+        break;
+
+      default:
+        DEBUGPANIC();
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_mkcfgdesc
+ *
+ * Description:
+ *   Construct the config descriptor
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+static int16_t cdcncm_mkcfgdesc(FAR uint8_t *desc,
+                                FAR struct usbdev_devinfo_s *devinfo,
+                                uint8_t speed, uint8_t type)
+#else
+static int16_t cdcncm_mkcfgdesc(FAR uint8_t *desc,
+                                FAR struct usbdev_devinfo_s *devinfo)
+#endif
+{
+  FAR struct usb_cfgdesc_s *cfgdesc = NULL;
+  bool hispeed = false;
+  int16_t len = 0;
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  hispeed = (speed == USB_SPEED_HIGH);
+
+  /* Check for switches between high and full speed */
+
+  if (type == USB_DESC_TYPE_OTHERSPEEDCONFIG)
+    {
+      hispeed = !hispeed;
+    }
+#endif
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  if (desc)
+    {
+      cfgdesc = (FAR struct usb_cfgdesc_s *)desc;
+      cfgdesc->len         = USB_SIZEOF_CFGDESC;
+#ifdef CONFIG_USBDEV_DUALSPEED
+      cfgdesc->type        = type;
+#else
+      cfgdesc->type        = USB_DESC_TYPE_CONFIG;
+#endif
+      cfgdesc->ninterfaces = CDCNCM_NINTERFACES;
+      cfgdesc->cfgvalue    = CDCNCM_CONFIGID;
+      cfgdesc->icfg        = devinfo->strbase + CDCNCM_CONFIGSTRID;
+      cfgdesc->attr        = USB_CONFIG_ATTR_ONE | CDCNCM_SELFPOWERED |
+                             CDCNCM_REMOTEWAKEUP;
+      cfgdesc->mxpower     = (CONFIG_USBDEV_MAXPOWER + 1) / 2;
+
+      desc += USB_SIZEOF_CFGDESC;
+    }
+
+  len += USB_SIZEOF_CFGDESC;
+
+#elif defined(CONFIG_COMPOSITE_IAD)
+
+  /* Interface association descriptor */
+
+  if (desc)
+    {
+      FAR struct usb_iaddesc_s *iaddesc = (FAR struct usb_iaddesc_s *)desc;
+
+      iaddesc->len       = USB_SIZEOF_IADDESC;
+      iaddesc->type      = USB_DESC_TYPE_INTERFACEASSOCIATION;
+      iaddesc->firstif   = devinfo->ifnobase;
+      iaddesc->nifs      = devinfo->ninterfaces;
+      iaddesc->classid   = USB_CLASS_CDC;
+      iaddesc->subclass  = CDC_SUBCLASS_NCM;
+      iaddesc->protocol  = CDC_PROTO_NONE;
+      iaddesc->ifunction = 0;
+
+      desc += USB_SIZEOF_IADDESC;
+    }
+
+  len += USB_SIZEOF_IADDESC;
+#endif
+
+  /* Communications Class Interface */
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase;
+      ifdesc->alt      = 0;
+      ifdesc->neps     = 1;
+      ifdesc->classid  = USB_CLASS_CDC;
+      ifdesc->subclass = CDC_SUBCLASS_NCM;
+      ifdesc->protocol = CDC_PROTO_NONE;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_hdr_funcdesc_s *hdrdesc;
+
+      hdrdesc = (FAR struct cdc_hdr_funcdesc_s *)desc;
+      hdrdesc->size    = SIZEOF_HDR_FUNCDESC;
+      hdrdesc->type    = USB_DESC_TYPE_CSINTERFACE;
+      hdrdesc->subtype = CDC_DSUBTYPE_HDR;
+      hdrdesc->cdc[0]  = LSBYTE(0x0110);
+      hdrdesc->cdc[1]  = MSBYTE(0x0110);
+
+      desc += SIZEOF_HDR_FUNCDESC;
+    }
+
+  len += SIZEOF_HDR_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_union_funcdesc_s *uniondesc;
+
+      uniondesc = (FAR struct cdc_union_funcdesc_s *)desc;
+      uniondesc->size = SIZEOF_UNION_FUNCDESC(1);
+      uniondesc->type = USB_DESC_TYPE_CSINTERFACE;
+      uniondesc->subtype = CDC_DSUBTYPE_UNION;
+      uniondesc->master = devinfo->ifnobase;
+      uniondesc->slave[0] = devinfo->ifnobase + 1;
+
+      desc += SIZEOF_UNION_FUNCDESC(1);
+    }
+
+  len += SIZEOF_UNION_FUNCDESC(1);
+
+  if (desc)
+    {
+      FAR struct cdc_ecm_funcdesc_s *ecmdesc;
+
+      ecmdesc = (FAR struct cdc_ecm_funcdesc_s *)desc;
+      ecmdesc->size       = SIZEOF_ECM_FUNCDESC;
+      ecmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ecmdesc->subtype    = CDC_DSUBTYPE_ECM;
+      ecmdesc->mac        = devinfo->strbase + CDCNCM_MACSTRID;
+      ecmdesc->stats[0]   = 0;
+      ecmdesc->stats[1]   = 0;
+      ecmdesc->stats[2]   = 0;
+      ecmdesc->stats[3]   = 0;
+      ecmdesc->maxseg[0]  = LSBYTE(CONFIG_NET_ETH_PKTSIZE);
+      ecmdesc->maxseg[1]  = MSBYTE(CONFIG_NET_ETH_PKTSIZE);
+      ecmdesc->nmcflts[0] = LSBYTE(0);
+      ecmdesc->nmcflts[1] = MSBYTE(0);
+      ecmdesc->npwrflts   = 0;
+
+      desc += SIZEOF_ECM_FUNCDESC;
+    }
+
+  len += SIZEOF_ECM_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct cdc_ncm_funcdesc_s *ncmdesc;
+
+      ncmdesc = (FAR struct cdc_ncm_funcdesc_s *)desc;
+      ncmdesc->size       = SIZEOF_NCM_FUNCDESC;
+      ncmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ncmdesc->subtype    = CDC_DSUBTYPE_NCM;
+      ncmdesc->version[0] = LSBYTE(0x0100);
+      ncmdesc->version[1] = MSBYTE(0x0100);
+      ncmdesc->netcaps    = NCMCAP_PACKET_FILTER;
+
+      desc += SIZEOF_NCM_FUNCDESC;
+    }
+
+  len += SIZEOF_NCM_FUNCDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_INTIN_IDX, epdesc, devinfo, hispeed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  /* Data Class Interface: no endpoints in setting 0, the bulk endpoints in
+   * setting 1.
+   */
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase + 1;
+      ifdesc->alt      = 0;
+      ifdesc->neps     = 0;
+      ifdesc->classid  = USB_CLASS_CDC_DATA;
+      ifdesc->subclass = CDC_DATA_SUBCLASS_NONE;
+      ifdesc->protocol = CDC_DATA_PROTO_NCMNTB;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct usb_ifdesc_s *ifdesc = (FAR struct usb_ifdesc_s *)desc;
+
+      ifdesc->len      = USB_SIZEOF_IFDESC;
+      ifdesc->type     = USB_DESC_TYPE_INTERFACE;
+      ifdesc->ifno     = devinfo->ifnobase + 1;
+      ifdesc->alt      = 1;
+      ifdesc->neps     = 2;
+      ifdesc->classid  = USB_CLASS_CDC_DATA;
+      ifdesc->subclass = CDC_DATA_SUBCLASS_NONE;
+      ifdesc->protocol = CDC_DATA_PROTO_NCMNTB;
+      ifdesc->iif      = 0;
+
+      desc += USB_SIZEOF_IFDESC;
+    }
+
+  len += USB_SIZEOF_IFDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_BULKIN_IDX, epdesc, devinfo, hispeed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  if (desc)
+    {
+      FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
+
+      cdcncm_mkepdesc(CDCNCM_EP_BULKOUT_IDX, epdesc, devinfo, hispeed);
+      desc += USB_SIZEOF_EPDESC;
+    }
+
+  len += USB_SIZEOF_EPDESC;
+
+  if (cfgdesc)
+    {
+      cfgdesc->totallen[0] = LSBYTE(len);
+      cfgdesc->totallen[1] = MSBYTE(len);
+    }
+
+  DEBUGASSERT(len <= CDCNCM_MXDESCLEN);
+  return len;
+}
+
+/****************************************************************************
+ * Name: cdcncm_getdescriptor
+ *
+ * Description:
+ *   Copy the USB CDC-NCM Device USB Descriptor of a given Type and a given
+ *   Index into the provided Descriptor Buffer.
+ *
+ * Returned Value:
+ *   The size in bytes of the requested USB Descriptor or a negated errno in
+ *   case of failure.
+ *
+ ****************************************************************************/
+
+static int cdcncm_getdescriptor(FAR struct cdcncm_driver_s *self,
+                                FAR struct usbdev_s *dev, uint8_t type,
+                                uint8_t index, FAR void *desc)
+{
+  uinfo("type: 0x%02hhx, index: 0x%02hhx\n", type, index);
+
+  switch (type)
+    {
+#ifndef CONFIG_CDCNCM_COMPOSITE
+    case USB_DESC_TYPE_DEVICE:
+      {
+        memcpy(desc, &g_devdesc, sizeof(g_devdesc));
+        return (int)sizeof(g_devdesc);
+      }
+      break;
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+    case USB_DESC_TYPE_DEVICEQUALIFIER:
+      {
+        memcpy(desc, &g_qualdesc, sizeof(g_qualdesc));
+        return (int)sizeof(g_qualdesc);
+      }
+      break;
+
+    case USB_DESC_TYPE_OTHERSPEEDCONFIG:
+#endif
+#endif
+
+    case USB_DESC_TYPE_CONFIG:
+      {
+#ifdef CONFIG_USBDEV_DUALSPEED
+        return cdcncm_mkcfgdesc((FAR uint8_t *)desc, &self->devinfo,
+                                dev->speed, type);
+#else
+        return cdcncm_mkcfgdesc((FAR uint8_t *)desc, &self->devinfo);
+#endif
+      }
+      break;
+
+    case USB_DESC_TYPE_STRING:
+      {
+        return cdcncm_mkstrdesc(index, (FAR struct usb_strdesc_s *)desc);
+      }
+      break;
+
+    default:
+      uwarn("Unsupported descriptor type: 0x%02hhx\n", type);
+      break;
+    }
+
+  return -ENOTSUP;
+}
+
+/****************************************************************************
+ * Name: cdcncm_classrequest
+ *
+ * Description:
+ *   Handle the class requests of [CDCNCM1.0, 6.2].  Only 16-bit NTBs are
+ *   supported, without CRCs.
+ *
+ * Returned Value:
+ *   The length of the response in ctrlreq->buf, or a negated errno.
+ *
+ ****************************************************************************/
+
+static int cdcncm_classrequest(FAR struct cdcncm_driver_s *self,
+                               FAR const struct usb_ctrlreq_s *ctrl,
+                               FAR uint8_t *dataout, size_t outlen)
+{
+  FAR uint8_t *buf = self->ctrlreq->buf;
+  uint32_t size;
+
+  switch (ctrl->req)
+    {
+      case ECM_SET_PACKET_FILTER:
+
+        /* As with CDC/ECM, always operate in promiscuous mode and rely on
+         * the host to do the filtering of the point-to-point link.
+         */
+
+        return OK;
+
+      case NCM_GET_NTB_PARAMETERS:
+        {
+          FAR struct cdc_ncm_ntbparms_s *parms =
+            (FAR struct cdc_ncm_ntbparms_s *)buf;
+
+          memset(parms, 0, SIZEOF_NCM_NTBPARMS);
+          cdcncm_putle16(parms->len, SIZEOF_NCM_NTBPARMS);
+          cdcncm_putle16(parms->formats, NCM_NTB_FORMAT_16);
+          cdcncm_putle32(parms->inmaxsize, CONFIG_CDCNCM_NTB_INSIZE);
+          cdcncm_putle16(parms->indivisor, CDCNCM_NTB_DIVISOR);
+          cdcncm_putle16(parms->inalign, CDCNCM_NTB_DIVISOR);
+          cdcncm_putle32(parms->outmaxsize, CONFIG_CDCNCM_NTB_OUTSIZE);
+          cdcncm_putle16(parms->outdivisor, CDCNCM_NTB_DIVISOR);
+          cdcncm_putle16(parms->outalign, CDCNCM_NTB_DIVISOR);
+          return SIZEOF_NCM_NTBPARMS;
+        }
+
+      case NCM_GET_NTB_INPUT_SIZE:
+        cdcncm_putle32(buf, self->ntbinmax);
+        return 4;
+
+      case NCM_SET_NTB_INPUT_SIZE:
+        if (dataout != NULL && outlen >= 4)
+          {
+            size = GETUINT32(dataout);
+            if (size < CDCNCM_NTB_MINSIZE ||
+                size > CONFIG_CDCNCM_NTB_INSIZE)
+              {
+                return -EINVAL;
+              }
+
+            /* The NTB being filled may already be larger: it is sent
+             * as is, only the next ones are smaller.
+             */
+
+            self->ntbinmax = size;
+          }
+
+        return OK;
+
+      case NCM_GET_NTB_FORMAT:
+        cdcncm_putle16(buf, 0);
+        return 2;
+
+      case NCM_SET_NTB_FORMAT:
+        return GETUINT16(ctrl->value) == 0 ? OK : -EINVAL;
+
+      default:
+        uwarn("Unsupported class req: 0x%02hhx\n", ctrl->req);
+        return -EOPNOTSUPP;
+    }
+}
+
+/****************************************************************************
+ * USB Device Class Methods
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_bind
+ *
+ * Description:
+ *   Invoked when the driver is bound to an USB device
+ *
+ ****************************************************************************/
+
+static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
+                       FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  FAR struct cdcncm_rdreq_s *rdcontainer;
+  FAR struct cdcncm_wrreq_s *wrcontainer;
+  int ret = OK;
+  int i;
+
+  uinfo("\n");
+
+  dev->ep0->priv = self;
+
+  /* Preallocate control request */
+
+  self->ctrlreq = cdcncm_allocreq(dev->ep0, CDCNCM_MXDESCLEN);
+
+  if (self->ctrlreq == NULL)
+    {
+      ret = -ENOMEM;
+      goto error;
+    }
+
+  self->ctrlreq->callback = cdcncm_ep0incomplete;
+
+  self->epint     = DEV_ALLOCEP(dev,
+                                USB_DIR_IN |
+                                self->devinfo.epno[CDCNCM_EP_INTIN_IDX],
+                                true, USB_EP_ATTR_XFER_INT);
+  self->epbulkin  = DEV_ALLOCEP(dev,
+                                USB_DIR_IN |
+                                self->devinfo.epno[CDCNCM_EP_BULKIN_IDX],
+                                true, USB_EP_ATTR_XFER_BULK);
+  self->epbulkout = DEV_ALLOCEP(dev,
+                                USB_DIR_OUT |
+                                self->devinfo.epno[CDCNCM_EP_BULKOUT_IDX],
+                                false, USB_EP_ATTR_XFER_BULK);
+
+  if (!self->epint || !self->epbulkin || !self->epbulkout)
+    {
+      uerr("Failed to allocate endpoints!\n");
+      ret = -ENODEV;
+      goto error;
+    }
+
+  self->epint->priv     = self;
+  self->epbulkin->priv  = self;
+  self->epbulkout->priv = self;
+
+  /* Pre-allocate the notification request */
+
+  self->notifyreq = cdcncm_allocreq(self->epint, CDCNCM_NOTIFY_SIZE);
+  if (self->notifyreq == NULL)
+    {
+      uerr("Out of memory\n");
+      ret = -ENOMEM;
+      goto error;
+    }
+
+  /* Pre-allocate the OUT NTBs.  They are queued by cdcncm_setconfig(). */
+
+  sq_init(&self->rdidle);
+  sq_init(&self->rxq);
+  self->rxcur = NULL;
+
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
+    {
+      rdcontainer      = &self->rdreqs[i];
+      rdcontainer->req = cdcncm_allocreq(self->epbulkout,
+                                         CONFIG_CDCNCM_NTB_OUTSIZE);
+      if (rdcontainer->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      rdcontainer->req->priv     = rdcontainer;
+      rdcontainer->req->callback = cdcncm_rdcomplete;
+      sq_addlast(&rdcontainer->entry, &self->rdidle);
+    }
+
+  /* Pre-allocate the IN NTBs */
+
+  sq_init(&self->wrfree);
+  self->txcur     = NULL;
+  self->ninflight = 0;
+
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
+    {
+      wrcontainer      = &self->wrreqs[i];
+      wrcontainer->req = cdcncm_allocreq(self->epbulkin,
+                                         CONFIG_CDCNCM_NTB_INSIZE);
+      if (wrcontainer->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      sq_addlast(&wrcontainer->entry, &self->wrfree);
+    }
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+#ifdef CONFIG_USBDEV_SELFPOWERED
+  DEV_SETSELFPOWERED(dev);
+#endif
+
+  /* And pull-up the data line for the soft connect function (unless we are
+   * part of a composite device)
+   */
+
+  DEV_CONNECT(dev);
+#endif
+  return OK;
+
+error:
+  uerr("cdcncm_bind failed! ret: %d\n", ret);
+  cdcncm_unbind(driver, dev);
+  return ret;
+}
+
+static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
+                          FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (!driver || !dev)
+    {
+      usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_INVALIDARG), 0);
+      return;
+    }
+#endif
+
+  /* Make sure that the endpoints have been unconfigured.  If we were
+   * terminated gracefully, then the configuration should already have been
+   * reset.  If not, then calling cdcncm_resetconfig should cause the
+   * endpoints to immediately terminate all transfers and return the
+   * requests to us (with result == -ESHUTDOWN)
+   */
+
+  cdcncm_resetconfig(self);
+  up_mdelay(50);
+
+  /* Free the pre-allocated control request */
+
+  if (self->ctrlreq != NULL)
+    {
+      cdcncm_freereq(dev->ep0, self->ctrlreq);
+      self->ctrlreq = NULL;
+    }
+
+  /* Free the interrupt IN endpoint and its request */
+
+  if (self->notifyreq != NULL)
+    {
+      cdcncm_freereq(self->epint, self->notifyreq);
+      self->notifyreq = NULL;
+    }
+
+  if (self->epint)
+    {
+      DEV_FREEEP(dev, self->epint);
+      self->epint = NULL;
+    }
+
+  /* Free the OUT NTBs (which should all have been returned to us at this
+   * time -- we don't check)
+   */
+
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
+    {
+      if (self->rdreqs[i].req != NULL)
+        {
+          cdcncm_freereq(self->epbulkout, self->rdreqs[i].req);
+          self->rdreqs[i].req = NULL;
+        }
+    }
+
+  sq_init(&self->rdidle);
+  sq_init(&self->rxq);
+  self->rxcur = NULL;
+
+  /* Free the bulk OUT endpoint */
+
+  if (self->epbulkout)
+    {
+      DEV_FREEEP(dev, self->epbulkout);
+      self->epbulkout = NULL;
+    }
+
+  /* Free the IN NTBs */
+
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
+    {
+      if (self->wrreqs[i].req != NULL)
+        {
+          cdcncm_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
+    }
+
+  sq_init(&self->wrfree);
+  self->txcur = NULL;
+
+  /* Free the bulk IN endpoint */
+
+  if (self->epbulkin)
+    {
+      DEV_FREEEP(dev, self->epbulkin);
+      self->epbulkin = NULL;
+    }
+}
+
+static int cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
+                        FAR struct usbdev_s *dev,
+                        FAR const struct usb_ctrlreq_s *ctrl,
+                        FAR uint8_t *dataout,
+                        size_t outlen)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  uint16_t value = GETUINT16(ctrl->value);
+  uint16_t index = GETUINT16(ctrl->index);
+  uint16_t len = GETUINT16(ctrl->len);
+  int ret = -EOPNOTSUPP;
+
+  uinfo("\n");
+
+  if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_STANDARD)
+    {
+      switch (ctrl->req)
+        {
+          case USB_REQ_GETDESCRIPTOR:
+            {
+              uint8_t descindex = ctrl->value[0];
+              uint8_t desctype  = ctrl->value[1];
+
+              ret = cdcncm_getdescriptor(self, dev, desctype, descindex,
+                                         self->ctrlreq->buf);
+            }
+            break;
+
+          case USB_REQ_SETCONFIGURATION:
+            ret = cdcncm_setconfig(self, dev, value);
+            break;
+
+          case USB_REQ_SETINTERFACE:
+            if (self->config != CDCNCM_CONFIGID_NONE &&
+                index == self->devinfo.ifnobase + 1 && value <= 1)
+              {
+                cdcncm_setinterface(self, value);
+                ret = OK;
+              }
+            else if (index == self->devinfo.ifnobase && value == 0)
+              {
+                ret = OK;
+              }
+            break;
+
+          case USB_REQ_GETINTERFACE:
+            self->ctrlreq->buf[0] = index == self->devinfo.ifnobase + 1 ?
+                                    self->altsetting : 0;
+            ret = 1;
+            break;
+
+          default:
+            uwarn("Unsupported standard req: 0x%02hhx\n", ctrl->req);
+            break;
+        }
+    }
+  else if ((ctrl->type & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_CLASS)
+    {
+      ret = cdcncm_classrequest(self, ctrl, dataout, outlen);
+    }
+  else
+    {
+      uwarn("Unsupported type: 0x%02hhx\n", ctrl->type);
+    }
+
+  if (ret >= 0)
+    {
+      FAR struct usbdev_req_s *ctrlreq = self->ctrlreq;
+
+      ctrlreq->len   = MIN(len, ret);
+      ctrlreq->flags = USBDEV_REQFLAGS_NULLPKT;
+
+      ret = EP_SUBMIT(dev->ep0, ctrlreq);
+      uinfo("EP_SUBMIT ret: %d\n", ret);
+
+      if (ret < 0)
+        {
+          ctrlreq->result = OK;
+          cdcncm_ep0incomplete(dev->ep0, ctrlreq);
+        }
+    }
+
+  return ret;
+}
+
+static void cdcncm_disconnect(FAR struct usbdevclass_driver_s *driver,
+                              FAR struct usbdev_s *dev)
+{
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+
+  uinfo("\n");
+
+  cdcncm_resetconfig(self);
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  DEV_CONNECT(dev);
+#endif
+}
+
+/****************************************************************************
+ * Name: cdcncm_classobject
+ *
+ * Description:
+ *   Register USB CDC/NCM and return the class object.
+ *
+ * Returned Value:
+ *   A pointer to the allocated class object (NULL on failure).
+ *
+ ****************************************************************************/
+
+static int cdcncm_classobject(int minor,
+                              FAR struct usbdev_devinfo_s *devinfo,
+                              FAR struct usbdevclass_driver_s **classdev)
+{
+  FAR struct cdcncm_driver_s *self;
+  int ret;
+
+  /* Initialize the driver structure */
+
+  self = kmm_zalloc(sizeof(struct cdcncm_driver_s));
+  if (!self)
+    {
+      nerr("Out of memory!\n");
+      return -ENOMEM;
+    }
+
+  /* Network device initialization.  One frame at a time waits for a free
+   * NTB, see cdcncm_transmit(); received frames are passed on at once.
+   */
+
+  self->dev.ops              = &g_netops;
+  self->dev.quota[NETPKT_TX] = 1;
+  self->dev.quota[NETPKT_RX] = 1;
+  self->ntbinmax             = CONFIG_CDCNCM_NTB_INSIZE;
+
+  /* USB device initialization */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  self->usbdev.speed  = USB_SPEED_HIGH;
+#else
+  self->usbdev.speed  = USB_SPEED_FULL;
+#endif
+  self->usbdev.ops    = &g_usbdevops;
+
+  memcpy(&self->devinfo, devinfo, sizeof(struct usbdev_devinfo_s));
+
+  /* The MAC address of the device side of the link */
+
+  memcpy(self->dev.netdev.d_mac.ether.ether_addr_octet,
+         "\x00\xe0\xde\xad\xbe\xef", IFHWADDRLEN);
+
+  /* Register the device with the OS so that socket IOCTLs can be performed */
+
+  ret = netdev_lower_register(&self->dev, NET_LL_ETHERNET);
+  if (ret < 0)
+    {
+      nerr("netdev_lower_register failed. ret: %d\n", ret);
+      kmm_free(self);
+      return ret;
+    }
+
+  self->registered = true;
+
+  *classdev = (FAR struct usbdevclass_driver_s *)self;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcncm_uninitialize
+ *
+ * Description:
+ *   Un-initialize the USB CDC/NCM class driver.  This function is used
+ *   internally by the USB composite driver to uninitialize the CDC/NCM
+ *   driver.  This same interface is available (with an untyped input
+ *   parameter) when the CDC/NCM driver is used standalone.
+ *
+ * Input Parameters:
+ *   There is one parameter, it differs in typing depending upon whether the
+ *   CDC/NCM driver is an internal part of a composite device, or a
+ *   standalone USB driver:
+ *
+ *     classdev - The class object returned by cdcncm_classobject()
+ *     handle   - The opaque handle representing the class object returned by
+ *                a previous call to cdcncm_initialize().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+static void cdcncm_uninitialize(FAR struct usbdevclass_driver_s *classdev)
+#else
+void cdcncm_uninitialize(FAR void *handle)
+#endif
+{
+#ifdef CONFIG_CDCNCM_COMPOSITE
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)classdev;
+#else
+  FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)handle;
+#endif
+  int ret;
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+  /* Check for pass 2 uninitialization.  We did most of the work on the
+   * first pass uninitialization.
+   */
+
+  if (!self->registered)
+    {
+      /* In this second and final pass, all that remains to be done is to
+       * free the memory resources.
+       */
+
+      kmm_free(self);
+      return;
+    }
+#endif
+
+  /* Un-register the CDC/NCM netdev device */
+
+  ret = netdev_lower_unregister(&self->dev);
+  if (ret < 0)
+    {
+      nerr("ERROR: netdev_lower_unregister failed. ret: %d\n", ret);
+    }
+
+  work_cancel(ETHWORK, &self->txwork);
+
+  /* For the case of the composite driver, there is a two pass
+   * uninitialization sequence.  We cannot yet free the driver structure.
+   * We will do that on the second pass.  We mark the fact that we have
+   * already uninitialized by setting the registered flag to false.
+   * If/when we are called again, then we will free the memory resources.
+   */
+
+  self->registered = false; /* Successfully unregistered netdev */
+
+  /* Unregister the driver (unless we are a part of a composite device).  The
+   * device unregister logic will (1) return all of the requests to us then
+   * (2) call the unbind method.
+   */
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+  usbdev_unregister(&self->usbdev);
+
+  /* Drop the frame that waited for an NTB, and free the driver */
+
+  if (self->txpkt != NULL)
+    {
+      iob_free_chain(self->txpkt);
+    }
+
+  kmm_free(self);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cdcncm_initialize
+ *
+ * Description:
+ *   Register CDC/NCM USB device interface. Register the corresponding
+ *   network driver to NuttX and bring up the network.
+ *
+ * Input Parameters:
+ *   minor - Device minor number.
+ *   handle - An optional opaque reference to the CDC/NCM class object that
+ *     may subsequently be used with cdcncm_uninitialize().
+ *
+ * Returned Value:
+ *   Zero (OK) means that the driver was successfully registered.  On any
+ *   failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_CDCNCM_COMPOSITE
+int cdcncm_initialize(int minor, FAR void **handle)
+{
+  FAR struct usbdevclass_driver_s *drvr = NULL;
+  struct usbdev_devinfo_s devinfo;
+  int ret;
+
+  memset(&devinfo, 0, sizeof(struct usbdev_devinfo_s));
+  devinfo.ninterfaces                 = CDCNCM_NINTERFACES;
+  devinfo.nstrings                    = CDCNCM_NSTRIDS;
+  devinfo.nendpoints                  = CDCNCM_NUM_EPS;
+  devinfo.epno[CDCNCM_EP_INTIN_IDX]   = CONFIG_CDCNCM_EPINTIN;
+  devinfo.epno[CDCNCM_EP_BULKIN_IDX]  = CONFIG_CDCNCM_EPBULKIN;
+  devinfo.epno[CDCNCM_EP_BULKOUT_IDX] = CONFIG_CDCNCM_EPBULKOUT;
+
+  ret = cdcncm_classobject(minor, &devinfo, &drvr);
+  if (ret == OK)
+    {
+      ret = usbdev_register(drvr);
+      if (ret < 0)
+        {
+          uinfo("usbdev_register failed. ret %d\n", ret);
+        }
+    }
+
+  if (handle)
+    {
+      *handle = (FAR void *)drvr;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: cdcncm_get_composite_devdesc
+ *
+ * Description:
+ *   Helper function to fill in some constants into the composite
+ *   configuration struct.
+ *
+ * Input Parameters:
+ *     dev - Pointer to the configuration struct we should fill
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCNCM_COMPOSITE
+void cdcncm_get_composite_devdesc(struct composite_devdesc_s *dev)
+{
+  memset(dev, 0, sizeof(struct composite_devdesc_s));
+
+  /* The callback functions for the CDC/NCM class.
+   *
+   * classobject() and uninitialize() must be provided by board-specific
+   * logic
+   */
+
+  dev->mkconfdesc   = cdcncm_mkcfgdesc;
+  dev->mkstrdesc    = cdcncm_mkstrdesc;
+  dev->classobject  = cdcncm_classobject;
+  dev->uninitialize = cdcncm_uninitialize;
+
+  dev->nconfigs     = CDCNCM_NCONFIGS; /* Number of configurations */
+  dev->configid     = CDCNCM_CONFIGID; /* The only configuration ID */
+
+  /* Let the construction function calculate the size of config descriptor */
+
+#ifdef CONFIG_USBDEV_DUALSPEED
+  dev->cfgdescsize  = cdcncm_mkcfgdesc(NULL, NULL, USB_SPEED_UNKNOWN, 0);
+#else
+  dev->cfgdescsize  = cdcncm_mkcfgdesc(NULL, NULL);
+#endif
+
+  /* Board-specific logic must provide the device minor */
+
+  /* Interfaces.
+   *
+   * ifnobase must be provided by board-specific logic
+   */
+
+  dev->devinfo.ninterfaces = CDCNCM_NINTERFACES; /* Interfaces */
+
+  /* Strings.
+   *
+   * strbase must be provided by board-specific logic
+   */
+
+  dev->devinfo.nstrings    = CDCNCM_NSTRIDS + 1;     /* Number of Strings */
+
+  /* Endpoints.
+   *
+   * Endpoint numbers must be provided by board-specific logic.
+   */
+
+  dev->devinfo.nendpoints  = CDCNCM_NUM_EPS;
+}
+#endif /* CONFIG_CDCNCM_COMPOSITE */
+
+#endif /* CONFIG_NET_CDCNCM */
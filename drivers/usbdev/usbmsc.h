@@ -84,6 +84,14 @@
 #  define CONFIG_USBMSC_NRDREQS 4
 #endif
 
+/* Number of sectors that iobuffer[] holds for multiple block transfers */
+
+#if defined(CONFIG_USBMSC_RDMULTIPLE) || defined(CONFIG_USBMSC_WRMULTIPLE)
+#  define USBMSC_NIOSECTORS CONFIG_USBMSC_NWRREQS
+#else
+#  define USBMSC_NIOSECTORS 1
+#endif
+
 /* Logical endpoint numbers / max packet sizes */
 
 #ifndef CONFIG_USBMSC_COMPOSITE
@@ -418,6 +426,7 @@ struct usbmsc_dev_s
   uint8_t           cdblen;           /* Length of cdb[] from CBW */
   uint8_t           cbwlun;           /* LUN from the CBW */
   uint16_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint16_t          niobytes;         /* Bytes read into iobuffer[] */
   uint16_t          nreqbytes;        /* Bytes buffered in head write requests */
   uint16_t          iosize;           /* Size of iobuffer[] */
   uint32_t          cbwlen;           /* Length of data from CBW */
@@ -2223,9 +2223,15 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
  *   nsectbytes - holds the number of bytes buffered for the current sector
+ *                (sectors with CONFIG_USBMSC_RDMULTIPLE)
+ *   niobytes   - holds the number of bytes read into the sector buffer
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
+ *   The data of a sector is copied into the write requests, so that the
+ *   requests already submitted are in flight while the next sectors are
+ *   read from the block driver.
+ *
  ****************************************************************************/
 
 static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
@@ -2235,11 +2241,18 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   irqstate_t flags;
   ssize_t nread;
+  uint32_t nsectors;
+  uint16_t reqlen;
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
   int ret;
 
+  /* Fill each request with as many whole packets as its buffer holds */
+
+  reqlen = CONFIG_USBMSC_BULKINREQLEN / priv->epbulkin->maxpacket *
+           priv->epbulkin->maxpacket;
+
   /* Loop transferring data until either (1) all of the data has been
    * transferred, or (2) we have used up all of the write requests that we
    * have available.
@@ -2253,9 +2266,15 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read the next sector(s) */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+          nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+#else
+          nsectors = 1;
+#endif
+          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                   nsectors);
           if (nread < 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
@@ -2265,9 +2284,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->nsectbytes = lun->sectorsize * nsectors;
+          priv->niobytes   = priv->nsectbytes;
+          priv->u.xfrlen  -= nsectors;
+          priv->sector    += nsectors;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2295,11 +2315,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * OR (2) all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
-      nbytes = MIN(priv->epbulkin->maxpacket - priv->nreqbytes,
-                   priv->nsectbytes);
+      nbytes = MIN(reqlen - priv->nreqbytes, priv->nsectbytes);
 
       /* Copy the data from the sector buffer to the USB request and update
        * counts
@@ -2314,7 +2333,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * then submit the request
        */
 
-      if (priv->nreqbytes >= priv->epbulkin->maxpacket ||
+      if (priv->nreqbytes >= reqlen ||
           (priv->u.xfrlen <= 0 && priv->nsectbytes <= 0))
         {
           /* Remove the request that we just filled from wrreqlist (we've
@@ -2391,6 +2410,8 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   ssize_t nwritten;
   uint16_t xfrd;
+  bool requeued;
+  bool full;
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
@@ -2429,6 +2450,7 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
       req             = privreq->req;
       xfrd            = req->xfrd;
       priv->nreqbytes = xfrd;
+      requeued        = false;
 
       /* Now loop until all of the data in the read request has been
        * transferred to the block driver OR all of the request data has been
@@ -2470,6 +2492,34 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
           priv->nsectbytes += nbytes;
           priv->nreqbytes  -= nbytes;
 
+          /* Once the request is drained and the sector buffer is full,
+           * return the request to the endpoint before writing, so that the
+           * host can send the next packets while the block driver writes.
+           */
+
+#ifdef CONFIG_USBMSC_WRMULTIPLE
+          full = priv->nsectbytes >= lun->sectorsize * priv->u.xfrlen ||
+                 priv->nsectbytes >= lun->sectorsize * CONFIG_USBMSC_NWRREQS;
+#else
+          full = priv->nsectbytes >= lun->sectorsize;
+#endif
+
+          if (priv->nreqbytes == 0 && full)
+            {
+              req->len      = priv->epbulkout->maxpacket;
+              req->priv     = privreq;
+              req->callback = usbmsc_rdcomplete;
+
+              ret = EP_SUBMIT(priv->epbulkout, req);
+              if (ret != OK)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITERDSUBMIT),
+                           (uint16_t)-ret);
+                }
+
+              requeued = true;
+            }
+
 #ifdef CONFIG_USBMSC_WRMULTIPLE
           uint32_t nrbufs = MIN(priv->u.xfrlen, CONFIG_USBMSC_NWRREQS);
 
@@ -2525,15 +2575,18 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
        * top and attempt to get the next read request.
        */
 
-      req->len      = priv->epbulkout->maxpacket;
-      req->priv     = privreq;
-      req->callback = usbmsc_rdcomplete;
-
-      ret = EP_SUBMIT(priv->epbulkout, req);
-      if (ret != OK)
+      if (!requeued)
         {
-          usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITERDSUBMIT),
-                   (uint16_t)-ret);
+          req->len      = priv->epbulkout->maxpacket;
+          req->priv     = privreq;
+          req->callback = usbmsc_rdcomplete;
+
+          ret = EP_SUBMIT(priv->epbulkout, req);
+          if (ret != OK)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITERDSUBMIT),
+                       (uint16_t)-ret);
+            }
         }
 
       /* Did the host decide to stop early? */
@@ -40,7 +40,9 @@
 #include <nuttx/wqueue.h>
 #include <nuttx/scsi.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/drivers/rwbuffer.h>
 
 #include <nuttx/usb/usb.h>
 #include <nuttx/usb/usbhost.h>
@@ -76,6 +78,17 @@
 #  error "Currently limited to 26 devices /dev/sda-z"
 #endif
 
+/* READ(10) and WRITE(10) transfer up to 65535 sectors */
+
+#ifndef CONFIG_USBHOST_MSC_MAXSECTORS
+#  define CONFIG_USBHOST_MSC_MAXSECTORS 128
+#endif
+
+#if defined(CONFIG_USBHOST_MSC_READAHEAD) || \
+    defined(CONFIG_USBHOST_MSC_WRITEBUFFER)
+#  define USBHOST_MSC_HAVE_RWBUFFER 1
+#endif
+
 /* Driver support ***********************************************************/
 
 /* This format is used to construct the /dev/sd[n] device driver path.  It
@@ -96,6 +109,10 @@
 #define USBHOST_MAX_RETRIES 100        /* Give up after 5 seconds */
 #define USBHOST_MAX_CREFS   INT16_MAX  /* Max cref count before signed overflow */
 
+#ifndef MIN
+#  define MIN(a,b)          ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -124,6 +141,10 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+  uint32_t                tag;          /* dCBWTag of the next CBW */
+#ifdef USBHOST_MSC_HAVE_RWBUFFER
+  struct rwbuffer_s       rwb;          /* Read-ahead/write buffer support */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -180,6 +201,16 @@ static inline int usbhost_requestsense(FAR struct usbhost_state_s *priv);
 static inline int usbhost_readcapacity(FAR struct usbhost_state_s *priv);
 static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv);
 
+/* Block transfers */
+
+static ssize_t usbhost_xfer(FAR struct usbhost_state_s *priv,
+                            FAR uint8_t *buffer, blkcnt_t startsector,
+                            unsigned int nsectors, bool write);
+static ssize_t usbhost_reload(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startblock, size_t nblocks);
+static ssize_t usbhost_flush(FAR void *dev, FAR const uint8_t *buffer,
+                             off_t startblock, size_t nblocks);
+
 /* Worker thread actions */
 
 static void usbhost_destroy(FAR void *arg);
@@ -197,9 +228,7 @@ static inline uint16_t usbhost_getle16(const uint8_t *val);
 static inline uint16_t usbhost_getbe16(const uint8_t *val);
 static inline void usbhost_putle16(uint8_t *dest, uint16_t val);
 static inline void usbhost_putbe16(uint8_t *dest, uint16_t val);
-#if defined(CONFIG_DEBUG_USB) && defined(CONFIG_DEBUG_INFO)
 static inline uint32_t usbhost_getle32(const uint8_t *val);
-#endif
 static inline uint32_t usbhost_getbe32(const uint8_t *val);
 static void usbhost_putle32(uint8_t *dest, uint32_t val);
 static void usbhost_putbe32(uint8_t *dest, uint32_t val);
@@ -864,6 +893,188 @@ static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv)
   return nbytes < 0 ? (int)nbytes : OK;
 }
 
+/****************************************************************************
+ * Name: usbhost_xfer
+ *
+ * Description:
+ *   Transfer sectors with one READ(10) or WRITE(10) command of the
+ *   bulk-only transport: the CBW, the data and the CSW.
+ *
+ * Input Parameters:
+ *   priv        - A reference to the class instance.
+ *   buffer      - The data to read or write.
+ *   startsector - The first sector.
+ *   nsectors    - The number of sectors, at most 65535.
+ *   write       - True for WRITE(10).
+ *
+ * Returned Value:
+ *   The number of bytes transferred or a negated errno value.
+ *
+ * Assumptions:
+ *   The caller holds priv->lock.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_xfer(FAR struct usbhost_state_s *priv,
+                            FAR uint8_t *buffer, blkcnt_t startsector,
+                            unsigned int nsectors, bool write)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_cbw_s *cbw;
+  FAR struct usbmsc_csw_s *csw;
+  size_t buflen = (size_t)priv->blocksize * nsectors;
+  ssize_t nbytes;
+  ssize_t ret;
+  uint32_t tag;
+
+  /* Loop in the event that EAGAIN is returned (mean that the transaction
+   * was NAKed and we should try again).
+   */
+
+  do
+    {
+      /* Construct and send the CBW.  It is rebuilt on each attempt since
+       * the CSW is received into the same buffer.
+       */
+
+      cbw = usbhost_cbwalloc(priv);
+      tag = usbhost_getle32(cbw->tag);
+
+      if (write)
+        {
+          usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
+        }
+      else
+        {
+          usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
+        }
+
+      ret = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                          (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+      if (ret < 0)
+        {
+          continue;
+        }
+
+      /* Transfer the user data */
+
+      nbytes = DRVR_TRANSFER(hport->drvr,
+                             write ? priv->bulkout : priv->bulkin,
+                             buffer, buflen);
+      if (nbytes < 0)
+        {
+          ret = nbytes;
+          continue;
+        }
+
+      /* Receive the CSW */
+
+      ret = DRVR_TRANSFER(hport->drvr, priv->bulkin, priv->tbuffer,
+                          USBMSC_CSW_SIZEOF);
+      if (ret < 0)
+        {
+          continue;
+        }
+
+      /* Check the CSW.  A device that moved less data than asked for
+       * reports the difference in dCSWDataResidue.
+       */
+
+      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+      usbhost_dumpcsw(csw);
+
+      if (ret < USBMSC_CSW_SIZEOF ||
+          usbhost_getle32(csw->signature) != USBMSC_CSW_SIGNATURE ||
+          usbhost_getle32(csw->tag) != tag)
+        {
+          uerr("ERROR: Invalid CSW\n");
+          ret = -EIO;
+        }
+      else if (csw->status != 0)
+        {
+          uerr("ERROR: CSW status error: %d\n", csw->status);
+          ret = -ENODEV;
+        }
+      else if (nbytes != buflen || usbhost_getle32(csw->residue) != 0)
+        {
+          uerr("ERROR: Short transfer: %zd of %zu\n", nbytes, buflen);
+          ret = -EIO;
+        }
+      else
+        {
+          ret = nbytes;
+        }
+    }
+  while (ret == -EAGAIN);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usbhost_reload / usbhost_flush
+ *
+ * Description:
+ *   Read or write any number of sectors: requests larger than
+ *   CONFIG_USBHOST_MSC_MAXSECTORS are split into several commands.  These
+ *   are also the callouts of the read-ahead and write buffers.
+ *
+ * Returned Value:
+ *   The number of sectors transferred or a negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_transfer(FAR struct usbhost_state_s *priv,
+                                FAR uint8_t *buffer, blkcnt_t startsector,
+                                size_t nsectors, bool write)
+{
+  size_t remaining = nsectors;
+  unsigned int nxfr;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (remaining > 0)
+    {
+      if (priv->disconnected)
+        {
+          ret = -ENODEV;
+          break;
+        }
+
+      nxfr = MIN(remaining, CONFIG_USBHOST_MSC_MAXSECTORS);
+      ret  = usbhost_xfer(priv, buffer, startsector, nxfr, write);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      buffer      += (size_t)priv->blocksize * nxfr;
+      startsector += nxfr;
+      remaining   -= nxfr;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret < 0 ? ret : (ssize_t)nsectors;
+}
+
+static ssize_t usbhost_reload(FAR void *dev, FAR uint8_t *buffer,
+                              off_t startblock, size_t nblocks)
+{
+  return usbhost_transfer((FAR struct usbhost_state_s *)dev, buffer,
+                          startblock, nblocks, false);
+}
+
+static ssize_t usbhost_flush(FAR void *dev, FAR const uint8_t *buffer,
+                             off_t startblock, size_t nblocks)
+{
+  return usbhost_transfer((FAR struct usbhost_state_s *)dev,
+                          (FAR uint8_t *)buffer, startblock, nblocks, true);
+}
+
 /****************************************************************************
  * Name: usbhost_destroy
  *
@@ -912,6 +1123,15 @@ static void usbhost_destroy(FAR void *arg)
       DRVR_EPFREE(hport->drvr, priv->bulkin);
     }
 
+#ifdef USBHOST_MSC_HAVE_RWBUFFER
+  /* Release the read-ahead/write buffers */
+
+  if (priv->rwb.dev != NULL)
+    {
+      rwb_uninitialize(&priv->rwb);
+    }
+#endif
+
   /* Free any transfer buffers */
 
   usbhost_tfree(priv);
@@ -1316,6 +1536,32 @@ static inline int usbhost_initvolume(FAR struct usbhost_state_s *priv)
         }
     }
 
+#ifdef USBHOST_MSC_HAVE_RWBUFFER
+  /* Set up the read-ahead/write buffers now that the geometry is known */
+
+  if (ret >= 0)
+    {
+      priv->rwb.blocksize     = priv->blocksize;
+      priv->rwb.nblocks       = priv->nblocks;
+      priv->rwb.dev           = priv;
+      priv->rwb.wrflush       = usbhost_flush;
+      priv->rwb.rhreload      = usbhost_reload;
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+      priv->rwb.wrmaxblocks   = CONFIG_USBHOST_MSC_NBUFBLOCKS;
+#endif
+#ifdef CONFIG_USBHOST_MSC_READAHEAD
+      priv->rwb.rhmaxblocks   = CONFIG_USBHOST_MSC_NBUFBLOCKS;
+#endif
+
+      ret = rwb_initialize(&priv->rwb);
+      if (ret < 0)
+        {
+          uerr("ERROR: rwb_initialize failed: %d\n", ret);
+          priv->rwb.dev = NULL;
+        }
+    }
+#endif
+
   /* Register the block driver */
 
   if (ret >= 0)
@@ -1470,7 +1716,6 @@ static void usbhost_putbe16(uint8_t *dest, uint16_t val)
  *
  ****************************************************************************/
 
-#if defined(CONFIG_DEBUG_USB) && defined(CONFIG_DEBUG_INFO)
 static inline uint32_t usbhost_getle32(const uint8_t *val)
 {
   /* Little endian means LS halfword first in byte stream */
@@ -1478,7 +1723,6 @@ static inline uint32_t usbhost_getle32(const uint8_t *val)
   return (uint32_t)usbhost_getle16(&val[2]) << 16 |
          (uint32_t)usbhost_getle16(val);
 }
-#endif
 
 /****************************************************************************
  * Name: usbhost_getbe32
@@ -1636,6 +1880,7 @@ static FAR struct usbmsc_cbw_s *
   cbw = (FAR struct usbmsc_cbw_s *)priv->tbuffer;
   memset(cbw, 0, sizeof(struct usbmsc_cbw_s));
   usbhost_putle32(cbw->signature, USBMSC_CBW_SIGNATURE);
+  usbhost_putle32(cbw->tag, priv->tag++);
   return cbw;
 }
 
@@ -1932,6 +2177,12 @@ static int usbhost_close(FAR struct inode *inode)
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct usbhost_state_s *)inode->i_private;
 
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+  /* Write out what is still buffered */
+
+  rwb_flush(&priv->rwb);
+#endif
+
   /* Decrement the reference count on the block driver */
 
   DEBUGASSERT(priv->crefs > 1);
@@ -1983,15 +2234,11 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
                             blkcnt_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
-  ssize_t nbytes = 0;
-  int ret;
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct usbhost_state_s *)inode->i_private;
 
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   uinfo("startsector: %" PRIuOFF " nsectors: %u "
         "sectorsize: %" PRIu16 "\n", startsector, nsectors, priv->blocksize);
@@ -2005,100 +2252,39 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
        * attempt to read from the device.
        */
 
-      nbytes = -ENODEV;
+      return -ENODEV;
     }
-  else if (nsectors > 0)
-    {
-      FAR struct usbmsc_cbw_s *cbw;
 
-      ret = nxmutex_lock(&priv->lock);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
-
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
-        {
-          /* Loop in the event that EAGAIN is returned (mean that the
-           * transaction was NAKed and we should try again.
-           */
+  if (nsectors == 0)
+    {
+      return 0;
+    }
 
-          do
-            {
-              /* Assume some device failure */
-
-              nbytes = -ENODEV;
-
-              /* Construct and send the CBW */
-
-              usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-              if (nbytes >= 0)
-                {
-                  /* Receive the user data */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         buffer, priv->blocksize * nsectors);
-                  if (nbytes >= 0)
-                    {
-                      /* Receive the CSW */
-
-                      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                             priv->tbuffer,
-                                             USBMSC_CSW_SIZEOF);
-                      if (nbytes >= 0)
-                        {
-                          FAR struct usbmsc_csw_s *csw;
-
-                          /* Check the CSW status */
-
-                          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                          if (csw->status != 0)
-                            {
-                              uerr("ERROR: CSW status error: %d\n",
-                                   csw->status);
-                              nbytes = -ENODEV;
-                            }
-                        }
-                    }
-                }
-            }
-          while (nbytes == -EAGAIN);
-        }
+#ifdef USBHOST_MSC_HAVE_RWBUFFER
+#if defined(CONFIG_USBHOST_MSC_READAHEAD) && \
+    !defined(CONFIG_USBHOST_MSC_WRITEBUFFER)
+  /* A read as large as the read-ahead buffer would only be copied through
+   * it.  Nothing newer than the device can be buffered without a write
+   * buffer, so read directly into the caller's buffer.
+   */
 
-      nxmutex_unlock(&priv->lock);
+  if (nsectors >= CONFIG_USBHOST_MSC_NBUFBLOCKS)
+    {
+      return usbhost_reload(priv, buffer, startsector, nsectors);
     }
+#endif
 
-  /* On success, return the number of blocks read */
-
-  return nbytes < 0 ? (int)nbytes : nsectors;
+  return rwb_read(&priv->rwb, startsector, nsectors, buffer);
+#else
+  return usbhost_reload(priv, buffer, startsector, nsectors);
+#endif
 }
 
-/****************************************************************************
- * Name: usbhost_write
- *
- * Description:
- *   Write the specified number of sectors to the write buffer or to the
- *   physical device.
- *
- ****************************************************************************/
-
 static ssize_t usbhost_write(FAR struct inode *inode,
                              FAR const unsigned char *buffer,
                              blkcnt_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
-  ssize_t nbytes;
-  int ret;
 
   uinfo("sector: %" PRIuOFF " nsectors: %u\n", startsector, nsectors);
 
@@ -2106,7 +2292,6 @@ static ssize_t usbhost_write(FAR struct inode *inode,
   priv = (FAR struct usbhost_state_s *)inode->i_private;
 
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   /* Check if the mass storage device is still connected */
 
@@ -2117,72 +2302,14 @@ static ssize_t usbhost_write(FAR struct inode *inode,
        * attempt to write to the device.
        */
 
-      nbytes = -ENODEV;
-    }
-  else
-    {
-      FAR struct usbmsc_cbw_s *cbw;
-
-      ret = nxmutex_lock(&priv->lock);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
-
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
-        {
-          /* Assume some device failure */
-
-          nbytes = -ENODEV;
-
-          /* Construct and send the CBW */
-
-          usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
-          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                 (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-          if (nbytes >= 0)
-            {
-              /* Send the user data */
-
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)buffer,
-                                     priv->blocksize * nsectors);
-              if (nbytes >= 0)
-                {
-                  /* Receive the CSW */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         priv->tbuffer, USBMSC_CSW_SIZEOF);
-                  if (nbytes >= 0)
-                    {
-                      FAR struct usbmsc_csw_s *csw;
-
-                      /* Check the CSW status */
-
-                      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                      if (csw->status != 0)
-                        {
-                          uerr("ERROR: CSW status error: %d\n", csw->status);
-                          nbytes = -ENODEV;
-                        }
-                    }
-                }
-            }
-        }
-
-      nxmutex_unlock(&priv->lock);
+      return -ENODEV;
     }
 
-  /* On success, return the number of blocks written */
-
-  return nbytes < 0 ? (int)nbytes : nsectors;
+#ifdef USBHOST_MSC_HAVE_RWBUFFER
+  return rwb_write(&priv->rwb, startsector, nsectors, buffer);
+#else
+  return usbhost_flush(priv, buffer, startsector, nsectors);
+#endif
 }
 
 /****************************************************************************
@@ -2262,6 +2389,18 @@ static int usbhost_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       ret = -ENODEV;
     }
+  else if (cmd == BIOC_FLUSH)
+    {
+      /* The write buffer is flushed through usbhost_flush(), which takes
+       * the lock itself.
+       */
+
+#ifdef CONFIG_USBHOST_MSC_WRITEBUFFER
+      ret = rwb_flush(&priv->rwb);
+#else
+      ret = OK;
+#endif
+    }
   else
     {
       /* Process the IOCTL by command */
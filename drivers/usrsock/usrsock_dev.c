@@ -52,20 +52,35 @@
 #  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
 #endif
 
+#ifndef CONFIG_NET_USRSOCK_NREQUESTS
+#  define CONFIG_NET_USRSOCK_NREQUESTS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+struct usrsockdev_req_s
+{
+  FAR const struct iovec *iov;    /* Pending request buffers */
+  int                     iovcnt; /* Number of request buffers */
+  size_t                  pos;    /* Reader position on request buffer */
+  uint32_t                xid;    /* Exchange id of the request */
+};
+
 struct usrsockdev_s
 {
   mutex_t devlock; /* Lock for device node */
   uint8_t ocount;  /* The number of times the device has been opened */
-  struct
-  {
-    FAR const struct iovec *iov;    /* Pending request buffers */
-    int                     iovcnt; /* Number of request buffers */
-    size_t                  pos;    /* Reader position on request buffer */
-  } req;
+  uint8_t nreqs;   /* Number of queued requests */
+  uint8_t rdidx;   /* Request that the daemon is reading */
+
+  /* Requests waiting for acknowledgment, in the order they were made.
+   * The daemon reads them one after the other: once it has read all of
+   * req[rdidx], the next read starts on the following request.
+   */
+
+  struct usrsockdev_req_s req[CONFIG_NET_USRSOCK_NREQUESTS];
   FAR struct pollfd *pollfds[CONFIG_NET_USRSOCKDEV_NPOLLWAITERS];
 };
 
@@ -134,6 +149,83 @@ static bool usrsockdev_is_opened(FAR struct usrsockdev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsockdev_req_unread
+ *
+ * Description:
+ *   Return true if the daemon has not yet read all of the request.
+ *
+ ****************************************************************************/
+
+static bool usrsockdev_req_unread(FAR struct usrsockdev_req_s *req)
+{
+  return usrsock_iovec_get(NULL, 0, req->iov, req->iovcnt,
+                           req->pos, NULL) >= 0;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_curreq
+ *
+ * Description:
+ *   Return the request that the daemon is reading, moving on to the next
+ *   queued request if the current one has been read completely.
+ *
+ ****************************************************************************/
+
+static FAR struct usrsockdev_req_s *
+usrsockdev_curreq(FAR struct usrsockdev_s *dev)
+{
+  if (dev->rdidx >= dev->nreqs)
+    {
+      return NULL;
+    }
+
+  if (dev->rdidx + 1 < dev->nreqs &&
+      !usrsockdev_req_unread(&dev->req[dev->rdidx]))
+    {
+      dev->rdidx++;
+    }
+
+  return &dev->req[dev->rdidx];
+}
+
+/****************************************************************************
+ * Name: usrsockdev_release
+ *
+ * Description:
+ *   Drop the queued requests that have been acknowledged by the daemon.
+ *   Their buffers belong to threads that are no longer waiting.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_release(FAR struct usrsockdev_s *dev)
+{
+  int i = 0;
+
+  while (i < dev->nreqs)
+    {
+      if (usrsock_request_pending(dev->req[i].xid))
+        {
+          i++;
+          continue;
+        }
+
+      dev->nreqs--;
+      memmove(&dev->req[i], &dev->req[i + 1],
+              (dev->nreqs - i) * sizeof(struct usrsockdev_req_s));
+
+      if (i < dev->rdidx)
+        {
+          dev->rdidx--;
+        }
+    }
+
+  if (dev->rdidx > dev->nreqs)
+    {
+      dev->rdidx = dev->nreqs;
+    }
+}
+
 /****************************************************************************
  * Name: usrsockdev_read
  ****************************************************************************/
@@ -142,6 +234,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
                                size_t len)
 {
   FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
   int ret;
 
@@ -169,14 +262,15 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 
   /* Is request available? */
 
-  if (dev->req.iov)
+  req = usrsockdev_curreq(dev);
+  if (req)
     {
       ssize_t rlen;
 
       /* Copy request to user-space. */
 
-      rlen = usrsock_iovec_get(buffer, len, dev->req.iov, dev->req.iovcnt,
-                               dev->req.pos, NULL);
+      rlen = usrsock_iovec_get(buffer, len, req->iov, req->iovcnt,
+                               req->pos, NULL);
       if (rlen < 0)
         {
           /* Tried reading beyond buffer. */
@@ -185,7 +279,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          dev->req.pos += rlen;
+          req->pos += rlen;
           len = rlen;
         }
     }
@@ -206,6 +300,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
                              int whence)
 {
   FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
   off_t pos;
   int ret;
@@ -227,15 +322,16 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
       return ret;
     }
 
-  /* Is request available? */
+  /* Is request available?  Seeking applies to the request being read. */
 
-  if (dev->req.iov)
+  req = dev->rdidx < dev->nreqs ? &dev->req[dev->rdidx] : NULL;
+  if (req)
     {
       ssize_t rlen;
 
       if (whence == SEEK_CUR)
         {
-          pos = dev->req.pos + offset;
+          pos = req->pos + offset;
         }
       else
         {
@@ -244,7 +340,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
 
       /* Copy request to user-space. */
 
-      rlen = usrsock_iovec_get(NULL, 0, dev->req.iov, dev->req.iovcnt,
+      rlen = usrsock_iovec_get(NULL, 0, req->iov, req->iovcnt,
                                pos, NULL);
       if (rlen < 0)
         {
@@ -254,7 +350,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
         }
       else
         {
-          dev->req.pos = pos;
+          req->pos = pos;
         }
     }
   else
@@ -301,11 +397,9 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
     }
 
   ret = usrsock_response(buffer, len, &req_done);
-  if (req_done && dev->req.iov)
+  if (req_done)
     {
-      dev->req.iov = NULL;
-      dev->req.pos = 0;
-      dev->req.iovcnt = 0;
+      usrsockdev_release(dev);
     }
 
   nxmutex_unlock(&dev->devlock);
@@ -387,9 +481,8 @@ static int usrsockdev_close(FAR struct file *filep)
   dev->ocount--;
   DEBUGASSERT(dev->ocount == 0);
   ret = OK;
-  dev->req.iov = NULL;
-  dev->req.iovcnt = 0;
-  dev->req.pos = 0;
+  dev->nreqs = 0;
+  dev->rdidx = 0;
 
   nxmutex_unlock(&dev->devlock);
   usrsock_abort();
@@ -464,9 +557,9 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Notify the POLLIN event if pending request. */
 
-      if (dev->req.iov != NULL &&
-          !(usrsock_iovec_get(NULL, 0, dev->req.iov,
-                              dev->req.iovcnt, dev->req.pos, NULL) < 0))
+      if (dev->rdidx + 1 < dev->nreqs ||
+          (dev->rdidx < dev->nreqs &&
+           usrsockdev_req_unread(&dev->req[dev->rdidx])))
         {
           eventset |= POLLIN;
         }
@@ -515,10 +608,15 @@ int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
 
   if (usrsockdev_is_opened(dev))
     {
-      DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.iov = iov;
-      dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+      FAR struct usrsock_request_common_s *head = iov[0].iov_base;
+      FAR struct usrsockdev_req_s *req;
+
+      DEBUGASSERT(dev->nreqs < CONFIG_NET_USRSOCK_NREQUESTS);
+      req = &dev->req[dev->nreqs++];
+      req->iov = iov;
+      req->pos = 0;
+      req->iovcnt = iovcnt;
+      req->xid = head->xid;
 
       /* Notify daemon of new request. */
 
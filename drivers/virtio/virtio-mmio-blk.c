@@ -0,0 +1,713 @@
+/****************************************************************************
+ * drivers/virtio/virtio-mmio-blk.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/virtio/virtio-mmio.h>
+
+#include "virtio-mmio-blk.h"
+
+#ifdef CONFIG_DRIVERS_VIRTIO_BLK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Feature bits, see 5.2.3 Feature bits */
+
+#define VIRTIO_BLK_F_SIZE_MAX   1  /* size_max is valid */
+#define VIRTIO_BLK_F_SEG_MAX    2  /* seg_max is valid */
+#define VIRTIO_BLK_F_RO         5  /* Device is read-only */
+#define VIRTIO_BLK_F_BLK_SIZE   6  /* blk_size is valid */
+#define VIRTIO_BLK_F_FLUSH      9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ         12 /* num_queues is valid */
+
+/* Request types and status */
+
+#define VIRTIO_BLK_T_IN         0
+#define VIRTIO_BLK_T_OUT        1
+#define VIRTIO_BLK_T_FLUSH      4
+
+#define VIRTIO_BLK_S_OK         0
+#define VIRTIO_BLK_S_UNSUPP     2
+
+/* Offsets of the 32-bit words of struct virtio_blk_config */
+
+#define VIRTIO_BLK_CFG_CAPACITY 0  /* 64-bit, in 512 byte sectors */
+#define VIRTIO_BLK_CFG_SIZE_MAX 2
+#define VIRTIO_BLK_CFG_SEG_MAX  3
+#define VIRTIO_BLK_CFG_BLK_SIZE 5
+#define VIRTIO_BLK_CFG_NQUEUES  8  /* num_queues is in bits 16-31 */
+
+#define VIRTIO_BLK_SECTSIZE     512
+
+/* One queue per CPU */
+
+#ifdef CONFIG_SMP
+#  define VIRTBLK_NQUEUES       CONFIG_SMP_NCPUS
+#else
+#  define VIRTBLK_NQUEUES       1
+#endif
+
+#define VIRTBLK_NSEGS           CONFIG_DRIVERS_VIRTIO_BLK_NSEGS
+
+/* Descriptors of a request in an indirect table: header, data, status */
+
+#define VIRTBLK_NINDIRECT       (VIRTBLK_NSEGS + 2)
+
+/* The largest data descriptor if the device does not limit it */
+
+#define VIRTBLK_SEGSIZE         (1 << 22)
+
+#ifndef MIN
+#  define MIN(a,b)              ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* 5.2.6 Device Operation: the device-readable request header */
+
+begin_packed_struct struct virtblk_hdr_s
+{
+  uint32_t type;
+  uint32_t ioprio;
+  uint64_t sector;
+} end_packed_struct;
+
+/* A request in flight.  It lives on the stack of the waiting thread. */
+
+struct virtblk_req_s
+{
+  struct virtblk_hdr_s hdr;      /* Read by the device */
+  uint8_t              status;   /* Written by the device */
+  sem_t                done;     /* Posted when the device has used it */
+};
+
+/* A request queue.  A request occupies a slot: one descriptor pointing to
+ * an indirect table, or three chained descriptors without
+ * VIRTIO_F_RING_INDIRECT_DESC.
+ */
+
+struct virtblk_queue_s
+{
+  FAR struct virtqueue      *vq;
+  spinlock_t                lock;      /* Protects the ring and slots */
+  sem_t                     slots;     /* Counts the free slots */
+  uint16_t                  nfree;
+  FAR uint16_t              *free;     /* Free slots */
+  FAR struct virtblk_req_s  **reqs;    /* Request of each slot in use */
+  FAR struct virtqueue_desc *indirect; /* Indirect table of each slot */
+};
+
+struct virtblk_dev_s
+{
+  FAR struct virtio_mmio_regs *regs;
+  int        irq;
+  bool       indirect;           /* Use indirect descriptors */
+  bool       readonly;           /* VIRTIO_BLK_F_RO */
+  bool       flush;              /* VIRTIO_BLK_F_FLUSH */
+  uint8_t    nqueues;            /* Number of queues in use */
+  uint16_t   nsegs;              /* Data descriptors per request */
+  uint32_t   segsize;            /* Bytes per data descriptor */
+  blksize_t  sectorsize;         /* Logical sector size */
+  blkcnt_t   nsectors;           /* Number of logical sectors */
+  struct virtblk_queue_s q[VIRTBLK_NQUEUES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t virtblk_read(FAR struct inode *inode,
+                            FAR unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t virtblk_write(FAR struct inode *inode,
+                             FAR const unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors);
+static int     virtblk_geometry(FAR struct inode *inode,
+                                FAR struct geometry *geometry);
+static int     virtblk_ioctl(FAR struct inode *inode, int cmd,
+                             unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_virtblk_bops =
+{
+  NULL,             /* open     */
+  NULL,             /* close    */
+  virtblk_read,     /* read     */
+  virtblk_write,    /* write    */
+  virtblk_geometry, /* geometry */
+  virtblk_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL              /* unlink   */
+#endif
+};
+
+static uint8_t g_virtblk_ndevs;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: virtblk_fill
+ *
+ * Description:
+ *   Describe a request in the descriptor table 'desc': the header, the
+ *   data split into segments of at most segsize bytes, and the status.
+ *   'base' is the index of desc[0] in the table the 'next' fields refer
+ *   to.
+ *
+ * Returned Value:
+ *   The number of descriptors used
+ *
+ ****************************************************************************/
+
+static uint16_t virtblk_fill(FAR struct virtblk_dev_s *priv,
+                             FAR struct virtqueue_desc *desc,
+                             uint16_t base, FAR struct virtblk_req_s *req,
+                             FAR uint8_t *buffer, size_t nbytes)
+{
+  uint16_t n = 0;
+  size_t len;
+
+  desc[n].addr  = (uintptr_t)&req->hdr;
+  desc[n].len   = sizeof(req->hdr);
+  desc[n].flags = VIRTQ_DESC_F_NEXT;
+  desc[n].next  = base + n + 1;
+  n++;
+
+  while (nbytes > 0)
+    {
+      len = MIN(nbytes, priv->segsize);
+
+      desc[n].addr  = (uintptr_t)buffer;
+      desc[n].len   = len;
+      desc[n].flags = VIRTQ_DESC_F_NEXT;
+      desc[n].next  = base + n + 1;
+
+      if (req->hdr.type == VIRTIO_BLK_T_IN)
+        {
+          desc[n].flags |= VIRTQ_DESC_F_WRITE;
+        }
+
+      buffer += len;
+      nbytes -= len;
+      n++;
+    }
+
+  desc[n].addr  = (uintptr_t)&req->status;
+  desc[n].len   = sizeof(req->status);
+  desc[n].flags = VIRTQ_DESC_F_WRITE;
+  desc[n].next  = 0;
+  return n + 1;
+}
+
+/****************************************************************************
+ * Name: virtblk_request
+ *
+ * Description:
+ *   Queue one request on the queue of the current CPU and wait for its
+ *   completion.  The caller limits nbytes to nsegs * segsize.
+ *
+ ****************************************************************************/
+
+static int virtblk_request(FAR struct virtblk_dev_s *priv, uint32_t type,
+                           FAR uint8_t *buffer, uint64_t sector,
+                           size_t nbytes)
+{
+  FAR struct virtblk_queue_s *q;
+  FAR struct virtqueue *vq;
+  struct virtblk_req_s req;
+  irqstate_t flags;
+  uint16_t slot;
+  uint16_t head;
+  uint16_t n;
+  int ret;
+
+#ifdef CONFIG_SMP
+  q = &priv->q[up_cpu_index() % priv->nqueues];
+#else
+  q = &priv->q[0];
+#endif
+  vq = q->vq;
+
+  req.hdr.type   = type;
+  req.hdr.ioprio = 0;
+  req.hdr.sector = sector;
+  req.status     = 0xff;
+  nxsem_init(&req.done, 0, 0);
+
+  /* Wait for a free slot */
+
+  ret = nxsem_wait_uninterruptible(&q->slots);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  flags = spin_lock_irqsave(&q->lock);
+
+  slot = q->free[--q->nfree];
+  q->reqs[slot] = &req;
+
+  if (priv->indirect)
+    {
+      FAR struct virtqueue_desc *table =
+        &q->indirect[slot * VIRTBLK_NINDIRECT];
+
+      n    = virtblk_fill(priv, table, 0, &req, buffer, nbytes);
+      head = slot;
+
+      vq->desc[head].addr  = (uintptr_t)table;
+      vq->desc[head].len   = n * sizeof(struct virtqueue_desc);
+      vq->desc[head].flags = VIRTQ_DESC_F_INDIRECT;
+      vq->desc[head].next  = 0;
+    }
+  else
+    {
+      head = slot * 3;
+      virtblk_fill(priv, &vq->desc[head], head, &req, buffer, nbytes);
+    }
+
+  vq->avail->ring[vq->avail->idx % vq->len] = head;
+  virtio_mb();
+  vq->avail->idx += 1;
+  virtio_mb();
+
+  if ((vq->used->flags & VIRTQ_USED_F_NO_NOTIFY) == 0)
+    {
+      virtio_putreg32(q - priv->q, &priv->regs->queue_notify);
+    }
+
+  spin_unlock_irqrestore(&q->lock, flags);
+
+  /* Wait for virtblk_interrupt() */
+
+  nxsem_wait_uninterruptible(&req.done);
+
+  if (req.status == VIRTIO_BLK_S_OK)
+    {
+      ret = OK;
+    }
+  else
+    {
+      vrterr("ERROR: type %" PRIu32 " sector %" PRIu64 " status %d\n",
+             type, sector, req.status);
+      ret = req.status == VIRTIO_BLK_S_UNSUPP ? -ENOTSUP : -EIO;
+    }
+
+out:
+  nxsem_destroy(&req.done);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtblk_transfer
+ *
+ * Description:
+ *   Transfer nsectors starting at start_sector.  Each request carries as
+ *   many sectors as the device accepts, so a multi-sector transfer from
+ *   the file system reaches the device as one request.
+ *
+ ****************************************************************************/
+
+static ssize_t virtblk_transfer(FAR struct virtblk_dev_s *priv,
+                                uint32_t type, FAR uint8_t *buffer,
+                                blkcnt_t start_sector,
+                                unsigned int nsectors)
+{
+  uint32_t maxsectors = priv->nsegs * (priv->segsize / priv->sectorsize);
+  uint32_t scale = priv->sectorsize / VIRTIO_BLK_SECTSIZE;
+  unsigned int done = 0;
+  unsigned int n;
+  int ret;
+
+  if (start_sector + nsectors > priv->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  while (done < nsectors)
+    {
+      n   = MIN(nsectors - done, maxsectors);
+      ret = virtblk_request(priv, type, buffer + done * priv->sectorsize,
+                            (uint64_t)(start_sector + done) * scale,
+                            n * priv->sectorsize);
+      if (ret < 0)
+        {
+          return done > 0 ? done : ret;
+        }
+
+      done += n;
+    }
+
+  return done;
+}
+
+/****************************************************************************
+ * Name: virtblk_read
+ ****************************************************************************/
+
+static ssize_t virtblk_read(FAR struct inode *inode,
+                            FAR unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors)
+{
+  return virtblk_transfer(inode->i_private, VIRTIO_BLK_T_IN, buffer,
+                          start_sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: virtblk_write
+ ****************************************************************************/
+
+static ssize_t virtblk_write(FAR struct inode *inode,
+                             FAR const unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct virtblk_dev_s *priv = inode->i_private;
+
+  if (priv->readonly)
+    {
+      return -EROFS;
+    }
+
+  return virtblk_transfer(priv, VIRTIO_BLK_T_OUT, (FAR uint8_t *)buffer,
+                          start_sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: virtblk_geometry
+ ****************************************************************************/
+
+static int virtblk_geometry(FAR struct inode *inode,
+                            FAR struct geometry *geometry)
+{
+  FAR struct virtblk_dev_s *priv = inode->i_private;
+
+  if (geometry == NULL)
+    {
+      return -EINVAL;
+    }
+
+  geometry->geo_available    = true;
+  geometry->geo_mediachanged = false;
+  geometry->geo_writeenabled = !priv->readonly;
+  geometry->geo_nsectors     = priv->nsectors;
+  geometry->geo_sectorsize   = priv->sectorsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtblk_ioctl
+ ****************************************************************************/
+
+static int virtblk_ioctl(FAR struct inode *inode, int cmd,
+                         unsigned long arg)
+{
+  FAR struct virtblk_dev_s *priv = inode->i_private;
+
+  switch (cmd)
+    {
+      case BIOC_FLUSH:
+        if (!priv->flush)
+          {
+            return OK;
+          }
+
+        return virtblk_request(priv, VIRTIO_BLK_T_FLUSH, NULL, 0, 0);
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: virtblk_interrupt
+ *
+ * Description:
+ *   Complete the requests used by the device on all queues.
+ *
+ ****************************************************************************/
+
+static int virtblk_interrupt(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct virtblk_dev_s *priv = (FAR struct virtblk_dev_s *)arg;
+  uint32_t stat;
+  int i;
+
+  stat = virtio_getreg32(&priv->regs->interrupt_status);
+  virtio_putreg32(stat, &priv->regs->interrupt_ack);
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      FAR struct virtblk_queue_s *q = &priv->q[i];
+      FAR struct virtqueue *vq = q->vq;
+      irqstate_t flags;
+      uint16_t used;
+
+      flags = spin_lock_irqsave(&q->lock);
+
+      used = vq->used->idx;
+      virtio_mb();
+
+      for (; vq->last_used_idx != used; vq->last_used_idx++)
+        {
+          uint32_t id = vq->used->ring[vq->last_used_idx % vq->len].id;
+          uint16_t slot = priv->indirect ? id : id / 3;
+
+          nxsem_post(&q->reqs[slot]->done);
+          q->reqs[slot] = NULL;
+          q->free[q->nfree++] = slot;
+          nxsem_post(&q->slots);
+        }
+
+      spin_unlock_irqrestore(&q->lock, flags);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtblk_queue_init
+ ****************************************************************************/
+
+static void virtblk_queue_init(FAR struct virtblk_dev_s *priv, int i)
+{
+  FAR struct virtblk_queue_s *q = &priv->q[i];
+  uint16_t nslots;
+  uint16_t slot;
+
+  q->vq  = virtq_create(CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_LEN);
+  nslots = priv->indirect ? q->vq->len : q->vq->len / 3;
+
+  q->free = kmm_malloc(sizeof(*q->free) * nslots);
+  q->reqs = kmm_zalloc(sizeof(*q->reqs) * nslots);
+  ASSERT(q->free && q->reqs);
+
+  if (priv->indirect)
+    {
+      q->indirect = kmm_memalign(16, sizeof(struct virtqueue_desc) *
+                                     VIRTBLK_NINDIRECT * nslots);
+      ASSERT(q->indirect);
+    }
+
+  for (slot = 0; slot < nslots; slot++)
+    {
+      q->free[slot] = nslots - 1 - slot;
+    }
+
+  q->nfree = nslots;
+  nxsem_init(&q->slots, 0, nslots);
+
+  virtq_add_to_mmio_device(priv->regs, q->vq, i);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: virtio_mmio_blk_init
+ *
+ * Description:
+ *   Called from virtio-mmio.c to initialize a virtio block device and
+ *   register it as /dev/vda, /dev/vdb, ...
+ *
+ ****************************************************************************/
+
+int virtio_mmio_blk_init(FAR struct virtio_mmio_regs *regs, uint32_t irq)
+{
+  FAR struct virtblk_dev_s *priv;
+  uint32_t features;
+  uint32_t gen;
+  uint64_t capacity;
+  char devname[16];
+  int ret;
+  int i;
+
+  features = (1 << VIRTIO_BLK_F_SIZE_MAX) | (1 << VIRTIO_BLK_F_SEG_MAX) |
+             (1 << VIRTIO_BLK_F_RO) | (1 << VIRTIO_BLK_F_BLK_SIZE) |
+             (1 << VIRTIO_BLK_F_FLUSH) | (1 << VIRTIO_F_RING_INDIRECT_DESC);
+#if VIRTBLK_NQUEUES > 1
+  features |= 1 << VIRTIO_BLK_F_MQ;
+#endif
+
+  ret = virtio_mmio_negotiate(regs, &features);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  priv = kmm_zalloc(sizeof(struct virtblk_dev_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->regs     = regs;
+  priv->irq      = irq;
+  priv->indirect = (features & (1 << VIRTIO_F_RING_INDIRECT_DESC)) != 0;
+  priv->readonly = (features & (1 << VIRTIO_BLK_F_RO)) != 0;
+  priv->flush    = (features & (1 << VIRTIO_BLK_F_FLUSH)) != 0;
+
+  /* Read the configuration.  The capacity is 64-bit, so retry if it
+   * changed while it was read.
+   */
+
+  do
+    {
+      gen      = virtio_getreg32(&regs->config_generation);
+      capacity = virtio_getreg32(&regs->config[VIRTIO_BLK_CFG_CAPACITY]) |
+                 ((uint64_t)virtio_getreg32(
+                   &regs->config[VIRTIO_BLK_CFG_CAPACITY + 1]) << 32);
+    }
+  while (gen != virtio_getreg32(&regs->config_generation));
+
+  priv->sectorsize = VIRTIO_BLK_SECTSIZE;
+  if ((features & (1 << VIRTIO_BLK_F_BLK_SIZE)) != 0)
+    {
+      uint32_t blksize =
+        virtio_getreg32(&regs->config[VIRTIO_BLK_CFG_BLK_SIZE]);
+
+      if (blksize > VIRTIO_BLK_SECTSIZE &&
+          blksize % VIRTIO_BLK_SECTSIZE == 0)
+        {
+          priv->sectorsize = blksize;
+        }
+    }
+
+  priv->nsectors = capacity / (priv->sectorsize / VIRTIO_BLK_SECTSIZE);
+
+  /* A request has one data descriptor unless it is described in an
+   * indirect table.
+   */
+
+  priv->segsize = VIRTBLK_SEGSIZE;
+  if ((features & (1 << VIRTIO_BLK_F_SIZE_MAX)) != 0)
+    {
+      priv->segsize =
+        MIN(virtio_getreg32(&regs->config[VIRTIO_BLK_CFG_SIZE_MAX]),
+            VIRTBLK_SEGSIZE);
+    }
+
+  priv->segsize -= priv->segsize % priv->sectorsize;
+  if (priv->segsize == 0)
+    {
+      priv->segsize = priv->sectorsize;
+    }
+
+  priv->nsegs = 1;
+  if (priv->indirect)
+    {
+      priv->nsegs = VIRTBLK_NSEGS;
+      if ((features & (1 << VIRTIO_BLK_F_SEG_MAX)) != 0)
+        {
+          priv->nsegs =
+            MIN(virtio_getreg32(&regs->config[VIRTIO_BLK_CFG_SEG_MAX]),
+                VIRTBLK_NSEGS);
+          priv->nsegs = priv->nsegs > 0 ? priv->nsegs : 1;
+        }
+    }
+
+  priv->nqueues = 1;
+#if VIRTBLK_NQUEUES > 1
+  if ((features & (1 << VIRTIO_BLK_F_MQ)) != 0)
+    {
+      uint16_t nqueues =
+        virtio_getreg32(&regs->config[VIRTIO_BLK_CFG_NQUEUES]) >> 16;
+
+      priv->nqueues = MIN(nqueues, VIRTBLK_NQUEUES);
+      priv->nqueues = priv->nqueues > 0 ? priv->nqueues : 1;
+    }
+#endif
+
+  vrtinfo("virtblk: %" PRIu64 " sectors of %d, %d queues, %d x %" PRIu32
+          " bytes per request\n", (uint64_t)priv->nsectors,
+          (int)priv->sectorsize, priv->nqueues, priv->nsegs,
+          priv->segsize);
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtblk_queue_init(priv, i);
+    }
+
+  ret = irq_attach(irq, virtblk_interrupt, priv);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  up_enable_irq(irq);
+
+  /* Set STATUS_DRIVER_OK */
+
+  virtio_putreg32(virtio_getreg32(&regs->status) | VIRTIO_STATUS_DRIVER_OK,
+                  &regs->status);
+  virtio_mb();
+
+  snprintf(devname, sizeof(devname), "/dev/vd%c", 'a' + g_virtblk_ndevs);
+  ret = register_blockdriver(devname, &g_virtblk_bops, 0, priv);
+  if (ret < 0)
+    {
+      vrterr("ERROR: register_blockdriver(%s) failed: %d\n", devname, ret);
+      up_disable_irq(irq);
+      irq_detach(irq);
+      goto errout;
+    }
+
+  g_virtblk_ndevs++;
+  return OK;
+
+errout:
+
+  /* Reset the device so that it stops using the queues.  There is no way
+   * to free a virtqueue, so they are not reclaimed.
+   */
+
+  virtio_putreg32(0, &regs->status);
+  return ret;
+}
+
+#endif /* CONFIG_DRIVERS_VIRTIO_BLK */
@@ -101,6 +101,20 @@
 #define VIRTIO_NET_Q_RX 0
 #define VIRTIO_NET_Q_TX 1
 
+/* Feature bits, see 5.1.3 Feature bits */
+
+#define VIRTIO_NET_F_CSUM       0  /* Device handles partial checksums */
+#define VIRTIO_NET_F_GUEST_CSUM 1  /* Driver handles partial checksums */
+
+/* virtnet_hdr_s flags */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1 /* Checksum from csum_start needed */
+#define VIRTIO_NET_HDR_F_DATA_VALID 2 /* Checksum has been validated */
+
+/* Each packet uses two descriptors: one for the header, one for the data */
+
+#define VIRTNET_NSLOTS (CONFIG_DRIVERS_VIRTIO_NET_QUEUE_LEN / 2)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -122,12 +136,29 @@ struct virtnet_hdr_s
 struct virtnet_driver_s
 {
   bool vnet_bifup;               /* true:ifup false:ifdown */
+  bool event_idx;                /* VIRTIO_F_RING_EVENT_IDX negotiated */
   int  irq;
 
   FAR struct virtio_mmio_regs *regs; /* virtio_mmio registers */
   FAR struct virtqueue   *txq;       /* TX queue */
   FAR struct virtqueue   *rxq;       /* RX queue */
 
+  uint16_t txkick;               /* txq->avail->idx at the last kick */
+  uint16_t rxkick;               /* rxq->avail->idx at the last kick */
+
+  /* TX slots.  A slot owns the descriptors 2 * slot and 2 * slot + 1, a
+   * header and a packet buffer, and is free until the device has used it.
+   */
+
+  uint16_t ntxfree;
+  uint16_t txfree[VIRTNET_NSLOTS];
+  FAR uint8_t *txbuf[VIRTNET_NSLOTS];
+  struct virtnet_hdr_s txhdr[VIRTNET_NSLOTS];
+
+  /* RX headers, written by the device together with the packets */
+
+  struct virtnet_hdr_s rxhdr[VIRTNET_NSLOTS];
+
   struct wdog_s vnet_txtimeout;  /* TX timeout timer */
   struct work_s vnet_irqwork;    /* For deferring interrupt work to the work queue */
   struct work_s vnet_pollwork;   /* For deferring poll work to the work queue */
@@ -167,10 +198,6 @@ static struct virtnet_driver_s g_virtnet[VIRTIO_NET_NINTERFACES];
 
 static uint32_t g_ninterfaces = 0;
 
-/* Common virtnet header */
-
-static struct virtnet_hdr_s g_hdr;
-
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -183,11 +210,8 @@ static int  virtnet_txpoll(FAR struct net_driver_s *dev);
 /* Interrupt handling */
 
 static void virtnet_reply(FAR struct virtnet_driver_s *priv);
-static void virtnet_receive(FAR struct virtnet_driver_s *priv);
-
-#ifdef TODO
+static int  virtnet_receive(FAR struct virtnet_driver_s *priv, int budget);
 static void virtnet_txdone(FAR struct virtnet_driver_s *priv);
-#endif
 
 static void virtnet_interrupt_work(FAR void *arg);
 static int  virtnet_interrupt(int irq, FAR void *context, FAR void *arg);
@@ -274,14 +298,14 @@ static void virtnet_add_packets_to_rxq(FAR struct virtnet_driver_s *priv)
           rxq->len, rxq->avail->idx);
   DEBUGASSERT(rxq->avail->idx == 0);
 
-  for (i = 0; i < rxq->len / 2; i++)
+  for (i = 0; i < VIRTNET_NSLOTS; i++)
     {
       pkt = kmm_memalign(16, PKTBUF_SIZE);
       ASSERT(pkt);
 
       /* Allocate new descriptors for header and packet */
 
-      d1 = virtq_alloc_desc(rxq, (i * 2),  (FAR void *)&g_hdr);
+      d1 = virtq_alloc_desc(rxq, (i * 2), &priv->rxhdr[i]);
       d2 = virtq_alloc_desc(rxq, (i * 2) + 1, pkt);
 
       /* Set up the descriptor for header */
@@ -298,23 +322,180 @@ static void virtnet_add_packets_to_rxq(FAR struct virtnet_driver_s *priv)
       /* Set the first descriptor to the avail->ring */
 
       rxq->avail->ring[i] = d1;
+    }
 
-      /* Increment the avail->idx for each two descriptors */
+  /* Publish all buffers at once */
 
-      virtio_mb();
-      rxq->avail->idx += 1;
-    }
+  virtio_mb();
+  rxq->avail->idx = VIRTNET_NSLOTS;
+  priv->rxkick    = VIRTNET_NSLOTS;
 
   vrtinfo("+++ virtq->avail-idx=%d \n", rxq->avail->idx);
   vrtinfo("+++ virtq->used->idx=%d \n", rxq->used->idx);
 }
 
+/****************************************************************************
+ * Name: virtnet_enable_cb
+ *
+ * Description:
+ *   Enable or suppress the interrupts for buffers used by the device.
+ *   With VIRTIO_F_RING_EVENT_IDX the device interrupts when used->idx
+ *   passes used_event, so pointing used_event just behind the buffers
+ *   already seen suppresses interrupts.
+ *
+ ****************************************************************************/
+
+static void virtnet_enable_cb(FAR struct virtnet_driver_s *priv,
+                              FAR struct virtqueue *vq, bool enable)
+{
+  if (priv->event_idx)
+    {
+      *vq->used_event = enable ? vq->last_used_idx : vq->last_used_idx - 1;
+    }
+  else
+    {
+      vq->avail->flags = enable ? 0 : VIRTQ_AVAIL_F_NO_INTERRUPT;
+    }
+
+  virtio_mb();
+}
+
+/****************************************************************************
+ * Name: virtnet_kick
+ *
+ * Description:
+ *   Notify the device of the buffers added to a queue since the last call,
+ *   unless it has asked not to be notified.
+ *
+ ****************************************************************************/
+
+static void virtnet_kick(FAR struct virtnet_driver_s *priv,
+                         FAR struct virtqueue *vq, uint32_t queue_sel,
+                         FAR uint16_t *kicked)
+{
+  uint16_t idx = vq->avail->idx;
+  bool kick;
+
+  if (idx == *kicked)
+    {
+      return;
+    }
+
+  /* Make the new avail->idx visible before reading the device state */
+
+  virtio_mb();
+
+  if (priv->event_idx)
+    {
+      kick = virtq_need_event(*vq->avail_event, idx, *kicked);
+    }
+  else
+    {
+      kick = (vq->used->flags & VIRTQ_USED_F_NO_NOTIFY) == 0;
+    }
+
+  *kicked = idx;
+  if (kick)
+    {
+      virtio_putreg32(queue_sel, &priv->regs->queue_notify);
+    }
+}
+
+/****************************************************************************
+ * Name: virtnet_txcsum
+ *
+ * Description:
+ *   Let the device insert the TCP/UDP checksum of an outgoing packet.  The
+ *   device sums from csum_start to the end of the packet, so the checksum
+ *   field is seeded with the sum of the pseudo header.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+static void virtnet_txcsum(FAR struct virtnet_hdr_s *hdr,
+                           FAR uint8_t *pkt, uint32_t len)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)pkt;
+  FAR uint8_t *ip = pkt + ETH_HDRLEN;
+  uint16_t iphdrlen;
+  uint16_t l4len;
+  uint16_t offset;
+  uint32_t sum = 0;
+  uint8_t proto;
+  int i;
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
+    {
+      iphdrlen = (ip[0] & 0x0f) << 2;
+      l4len    = ((ip[2] << 8) | ip[3]) - iphdrlen;
+      proto    = ip[9];
+
+      for (i = 12; i < 20; i += 2)
+        {
+          sum += (ip[i] << 8) | ip[i + 1];
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      iphdrlen = IPv6_HDRLEN;
+      l4len    = (ip[4] << 8) | ip[5];
+      proto    = ip[6];
+
+      for (i = 8; i < 40; i += 2)
+        {
+          sum += (ip[i] << 8) | ip[i + 1];
+        }
+    }
+  else
+#endif
+    {
+      return;
+    }
+
+  if (proto == IP_PROTO_TCP)
+    {
+      offset = 16;
+    }
+  else if (proto == IP_PROTO_UDP)
+    {
+      offset = 6;
+    }
+  else
+    {
+      return;
+    }
+
+  if (ETH_HDRLEN + iphdrlen + offset + 2 > len)
+    {
+      return;
+    }
+
+  sum += proto + l4len;
+  while ((sum >> 16) != 0)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+  ip[iphdrlen + offset]     = sum >> 8;
+  ip[iphdrlen + offset + 1] = sum & 0xff;
+
+  hdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  hdr->csum_start  = ETH_HDRLEN + iphdrlen;
+  hdr->csum_offset = offset;
+}
+#endif
+
 /****************************************************************************
  * Name: virtnet_transmit
  *
  * Description:
- *   Start hardware transmission.  Called either from the txdone interrupt
- *   handling or from watchdog based polling.
+ *   Queue the packet in d_buf on the TX queue.  The packet is copied to a
+ *   free TX slot, so d_buf may be reused at once.  The device is notified
+ *   later by virtnet_kick(), once for all packets queued in one pass.
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -329,24 +510,26 @@ static void virtnet_add_packets_to_rxq(FAR struct virtnet_driver_s *priv)
 
 static int virtnet_transmit(FAR struct virtnet_driver_s *priv)
 {
-  FAR void *pkt = priv->vnet_dev.d_buf;
-  uint32_t len  = priv->vnet_dev.d_len;
-  uint16_t idx  = priv->txq->avail->idx;
+  FAR struct virtqueue *txq = priv->txq;
+  FAR struct virtnet_hdr_s *hdr;
+  uint32_t len = priv->vnet_dev.d_len;
+  uint16_t slot;
   uint16_t d1;
   uint16_t d2;
 
-  /* Send the packet:
-   * address=priv->vnet_dev.d_buf, length=priv->vnet_dev.d_len
+  /* Higher level logic only polls while there is a free slot, but a
+   * reply to a received packet may find the queue full.
    */
 
-  /* Verify that the hardware is ready to send another packet.  If we get
-   * here, then we are committed to sending a packet; Higher level logic
-   * must have assured that there is no transmission in progress.
-   */
+  if (priv->ntxfree == 0)
+    {
+      NETDEV_TXERRORS(&priv->vnet_dev);
+      return -EBUSY;
+    }
 
   /* Increment statistics */
 
-  NETDEV_TXPACKETS(priv->vnet_dev);
+  NETDEV_TXPACKETS(&priv->vnet_dev);
 
   vrtinfo("=== Sending packet, length: %d\n", priv->vnet_dev.d_len);
 
@@ -354,42 +537,46 @@ static int virtnet_transmit(FAR struct virtnet_driver_s *priv)
   virtnet_cmd_status(priv);
 #endif
 
+  slot = priv->txfree[--priv->ntxfree];
+  hdr  = &priv->txhdr[slot];
+
+  memset(hdr, 0, sizeof(*hdr));
+  memcpy(priv->txbuf[slot], priv->vnet_dev.d_buf, len);
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  if ((priv->vnet_dev.d_csumflags & NETDEV_CSUM_NEEDED) != 0)
+    {
+      virtnet_txcsum(hdr, priv->txbuf[slot], len);
+    }
+#endif
+
   /* Allocate new descriptors for header and packet */
 
-  d1 = virtq_alloc_desc(priv->txq, idx, (FAR void *)&g_hdr);
-  d2 = virtq_alloc_desc(priv->txq, idx + 1, pkt);
-  DEBUGASSERT(d1 != d2);
+  d1 = virtq_alloc_desc(txq, slot * 2, hdr);
+  d2 = virtq_alloc_desc(txq, slot * 2 + 1, priv->txbuf[slot]);
 
   /* Set up the descriptor for header */
 
-  priv->txq->desc[d2].len   = len;
-  priv->txq->desc[d2].flags = 0;
+  txq->desc[d1].len   = VIRTIO_NET_HDRLEN;
+  txq->desc[d1].flags = VIRTQ_DESC_F_NEXT;
+  txq->desc[d1].next  = d2;
 
   /* Set up the descriptor for packet */
 
-  priv->txq->desc[d1].len   = VIRTIO_NET_HDRLEN;
-  priv->txq->desc[d1].flags = VIRTQ_DESC_F_NEXT;
-  priv->txq->desc[d1].next  = d2;
+  txq->desc[d2].len   = len;
+  txq->desc[d2].flags = 0;
 
   /* Set the first descriptor to the avail->ring */
 
-  priv->txq->avail->ring[d1] = d1;
+  txq->avail->ring[txq->avail->idx % txq->len] = d1;
 
   /* Increment the avail->idx for each two descriptors */
 
   virtio_mb();
-  priv->txq->avail->idx += 1;
+  txq->avail->idx += 1;
 
   vrtinfo("*** d1=%d, d2=%d, txq->avail->idx=%d\n",
-          d1, d2, priv->txq->avail->idx);
-
-  virtio_putreg32(VIRTIO_NET_Q_TX, &priv->regs->queue_notify);
-
-  vrtinfo("*** finish updating queue_notify\n");
-
-#ifdef TODO
-  /* Enable Tx interrupts */
-#endif
+          d1, d2, txq->avail->idx);
 
   /* Setup the TX timeout watchdog (perhaps restarting the timer) */
 
@@ -498,7 +685,7 @@ static void virtnet_rxdispatch(FAR struct virtnet_driver_s *priv)
 {
   /* Update statistics */
 
-  NETDEV_RXPACKETS(&priv->dev);
+  NETDEV_RXPACKETS(&priv->vnet_dev);
 
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the frame into the tap */
@@ -577,69 +764,97 @@ static void virtnet_rxdispatch(FAR struct virtnet_driver_s *priv)
  * Name: virtnet_receive
  *
  * Description:
- *   An interrupt was received indicating the availability of a new RX packet
+ *   Dispatch up to 'budget' received packets and give their buffers back
+ *   to the device in one batch.
  *
  * Input Parameters:
- *   priv - Reference to the driver state structure
+ *   priv   - Reference to the driver state structure
+ *   budget - The maximum number of packets to dispatch
  *
  * Returned Value:
- *   None
+ *   The number of packets dispatched
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static void virtnet_receive(FAR struct virtnet_driver_s *priv)
+static int virtnet_receive(FAR struct virtnet_driver_s *priv, int budget)
 {
-  uint16_t used = priv->rxq->used->idx;
-  uint16_t idx;
+  FAR struct virtqueue *rxq = priv->rxq;
+  FAR uint8_t *buf = priv->vnet_dev.d_buf;
+  uint16_t used = rxq->used->idx;
+  uint16_t avail = rxq->avail->idx;
+  int n = 0;
 
   vrtinfo("+++ rxq->last_used_idx=%d: rxq->used->idx=%d\n",
-          priv->rxq->last_used_idx, priv->rxq->used->idx);
+          rxq->last_used_idx, used);
+
+  /* Read the used ring entries only after used->idx */
+
+  virtio_mb();
 
-  for (idx = priv->rxq->last_used_idx; idx != used; idx++)
+  for (; rxq->last_used_idx != used && n < budget; rxq->last_used_idx++)
     {
-      uint16_t id  = idx % priv->rxq->len;
-      uint16_t d1  = priv->rxq->used->ring[id].id; /* index for header */
-      uint16_t d2  = priv->rxq->desc[d1].next;     /* index for packet */
-      uint32_t len = priv->rxq->used->ring[id].len;
+      uint16_t id  = rxq->last_used_idx % rxq->len;
+      uint16_t d1  = rxq->used->ring[id].id; /* index for header */
+      uint16_t d2  = rxq->desc[d1].next;     /* index for packet */
+      uint32_t len = rxq->used->ring[id].len;
       DEBUGASSERT(d2 == (d1 + 1));
 
-      vrtinfo("+++ idx=%d id=%d used->idx=%d: d1=%d d2=%d len=%" PRId32 "\n",
-              idx, id, priv->rxq->used->idx, d1, d2, len);
+      vrtinfo("+++ id=%d: d1=%d d2=%d len=%" PRId32 "\n", id, d1, d2, len);
 
       /* Set the packet info to d_buf and set d_len */
 
-      priv->vnet_dev.d_buf = priv->rxq->desc_virt[d2];
+      priv->vnet_dev.d_buf = rxq->desc_virt[d2];
       priv->vnet_dev.d_len = len - VIRTIO_NET_HDRLEN;
 
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+      /* With VIRTIO_NET_F_GUEST_CSUM, a partial checksum is as good as a
+       * validated one: the packet never left the host.
+       */
+
+      priv->vnet_dev.d_csumflags =
+        (priv->rxhdr[d1 / 2].flags & (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+                                      VIRTIO_NET_HDR_F_DATA_VALID)) != 0 ?
+        NETDEV_CSUM_VERIFIED : 0;
+#endif
+
       vrtinfo("Receiving packet, pktlen: %d\n", priv->vnet_dev.d_len);
 
       /* Dispatch the incoming packet */
 
       virtnet_rxdispatch(priv);
 
-      /* Set the descriptor back into the avail queue */
+      /* Set the descriptor back into the avail ring */
 
-      id = priv->rxq->avail->idx % priv->rxq->len;
-      priv->rxq->avail->ring[id] = d1;
+      rxq->avail->ring[avail++ % rxq->len] = d1;
+      n++;
+    }
 
-      virtio_mb();
-      priv->rxq->avail->idx += 1;
+  priv->vnet_dev.d_buf = buf;
 
-      vrtinfo("+++ rxq->avail->idx=%d\n", priv->rxq->avail->idx);
-    }
+  /* Process the packets held for TCP receive aggregation */
 
-  priv->rxq->last_used_idx = used;
-  vrtinfo("+++ rxq->last_used_idx=%d\n",  priv->rxq->last_used_idx);
+  netdev_gro_flush(&priv->vnet_dev, virtnet_txpoll);
+
+  /* Publish the buffers and notify the device if it is waiting for them */
+
+  virtio_mb();
+  rxq->avail->idx = avail;
+  virtnet_kick(priv, rxq, VIRTIO_NET_Q_RX, &priv->rxkick);
+
+  vrtinfo("+++ rxq->last_used_idx=%d\n", rxq->last_used_idx);
+  return n;
 }
 
 /****************************************************************************
  * Name: virtnet_txdone
  *
  * Description:
- *   An interrupt was received indicating that the last TX packet(s) is done
+ *   Reclaim the TX slots used by the device, poll the network for new TX
+ *   data while there are free slots and notify the device once for all of
+ *   the new packets.
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -652,28 +867,47 @@ static void virtnet_receive(FAR struct virtnet_driver_s *priv)
  *
  ****************************************************************************/
 
-#ifdef TODO
 static void virtnet_txdone(FAR struct virtnet_driver_s *priv)
 {
-  /* Check for errors and update statistics */
+  FAR struct virtqueue *txq = priv->txq;
+  uint16_t used = txq->used->idx;
+  uint16_t idx;
 
-  NETDEV_TXDONE(priv->vnet_dev);
+  virtio_mb();
 
-  /* Check if there are pending transmissions */
+  for (; txq->last_used_idx != used; txq->last_used_idx++)
+    {
+      uint16_t id = txq->last_used_idx % txq->len;
 
-  /* If no further transmissions are pending, then cancel the TX timeout and
-   * disable further Tx interrupts.
-   */
+      priv->txfree[priv->ntxfree++] = txq->used->ring[id].id / 2;
+      NETDEV_TXDONE(&priv->vnet_dev);
+    }
 
-  wd_cancel(&priv->vnet_txtimeout);
+  /* If no further transmissions are pending, then cancel the TX timeout */
+
+  if (priv->ntxfree == VIRTNET_NSLOTS)
+    {
+      wd_cancel(&priv->vnet_txtimeout);
+    }
+
+  /* Poll the network for new TX data */
+
+  if (priv->vnet_bifup)
+    {
+      do
+        {
+          idx = txq->avail->idx;
+          devif_poll(&priv->vnet_dev, virtnet_txpoll);
+        }
+      while (priv->ntxfree > 0 && txq->avail->idx != idx);
+    }
 
-  /* And disable further TX interrupts. */
+  virtnet_kick(priv, txq, VIRTIO_NET_Q_TX, &priv->txkick);
 
-  /* In any event, poll the network for new TX data */
+  /* TX interrupts are only needed to learn when a full queue drains */
 
-  devif_poll(&priv->vnet_dev, virtnet_txpoll);
+  virtnet_enable_cb(priv, txq, priv->ntxfree == 0);
 }
-#endif
 
 /****************************************************************************
  * Name: virtnet_interrupt_work
@@ -695,6 +929,7 @@ static void virtnet_txdone(FAR struct virtnet_driver_s *priv)
 static void virtnet_interrupt_work(FAR void *arg)
 {
   FAR struct virtnet_driver_s *priv = (FAR struct virtnet_driver_s *)arg;
+  int n;
 
   /* Lock the network and serialize driver operations if necessary.
    * NOTE: Serialization is only required in the case where the driver work
@@ -704,37 +939,35 @@ static void virtnet_interrupt_work(FAR void *arg)
 
   net_lock();
 
-  /* Process pending Ethernet interrupts */
-
-  /* Handle interrupts according to status bit settings */
-
-  /* Check if we received an incoming packet, if so, call virtnet_receive() */
-
-  virtnet_receive(priv);
-
-  /* Check if a packet transmission just completed.
-   * If so, call virtnet_txdone.
-   * This may disable further Tx interrupts if there are no pending
-   * transmissions.
+  /* Process the received packets, then the completed transmissions.  The
+   * replies to the received packets are sent together with the new TX
+   * data.
    */
 
-#ifdef TODO
+  n = virtnet_receive(priv, CONFIG_DRIVERS_VIRTIO_NET_BUDGET);
   virtnet_txdone(priv);
-#endif
 
   net_unlock();
 
-  if (priv->rxq->last_used_idx == priv->rxq->used->idx)
-    {
-      /* Re-enable Ethernet interrupts */
+  /* Keep polling with interrupts disabled while the budget is exhausted.
+   * Otherwise re-enable the interrupt, and poll again if a packet arrived
+   * meanwhile.
+   */
 
-      priv->rxq->avail->flags = 0;
-      priv->txq->avail->flags = 0;
-      virtio_mb();
+  if (n < CONFIG_DRIVERS_VIRTIO_NET_BUDGET)
+    {
+      virtnet_enable_cb(priv, priv->rxq, true);
+      if (priv->rxq->used->idx == priv->rxq->last_used_idx &&
+          (priv->ntxfree > 0 ||
+           priv->txq->used->idx == priv->txq->last_used_idx))
+        {
+          return;
+        }
 
-      virtio_putreg32(VIRTIO_NET_Q_RX, &priv->regs->queue_notify);
+      virtnet_enable_cb(priv, priv->rxq, false);
     }
-  else if (work_available(&priv->vnet_irqwork))
+
+  if (work_available(&priv->vnet_irqwork))
     {
       work_queue(ETHWORK, &priv->vnet_irqwork,
                  virtnet_interrupt_work, priv, 0);
@@ -773,14 +1006,11 @@ static int virtnet_interrupt(int irq, FAR void *context, FAR void *arg)
   virtio_putreg32(stat, &priv->regs->interrupt_ack);
   vrtinfo("+++ called (stat=0x%" PRIx32 ")\n", stat);
 
-  /* Disable further Ethernet interrupts.  Because Ethernet interrupts are
-   * also disabled if the TX timeout event occurs, there can be no race
-   * condition here.
+  /* Disable further RX interrupts until the work queue has drained the
+   * RX queue.  TX interrupts are managed by virtnet_txdone().
    */
 
-  priv->rxq->avail->flags = 1;
-  priv->txq->avail->flags = 1;
-  virtio_mb();
+  virtnet_enable_cb(priv, priv->rxq, false);
 
   /* Schedule to perform the interrupt processing on the worker thread. */
 
@@ -821,13 +1051,13 @@ static void virtnet_txtimeout_work(FAR void *arg)
 
   /* Increment statistics and dump debug info */
 
-  NETDEV_TXTIMEOUTS(priv->vnet_dev);
+  NETDEV_TXTIMEOUTS(&priv->vnet_dev);
 
   /* Then reset the hardware */
 
-  /* Then poll the network for new XMIT data */
+  /* Then reclaim what was sent and poll the network for new XMIT data */
 
-  devif_poll(&priv->vnet_dev, virtnet_txpoll);
+  virtnet_txdone(priv);
   net_unlock();
 }
 
@@ -1003,11 +1233,9 @@ static void virtnet_txavail_work(FAR void *arg)
 
   if (priv->vnet_bifup)
     {
-      /* Check if there is room in the hardware to hold another packet. */
-
-      /* If so, then poll the network for new XMIT data */
+      /* Reclaim the free TX slots and poll the network for new XMIT data */
 
-      devif_poll(&priv->vnet_dev, virtnet_txpoll);
+      virtnet_txdone(priv);
     }
 
   net_unlock();
@@ -1244,9 +1472,11 @@ static int virtnet_ioctl(FAR struct net_driver_s *dev, int cmd,
  *
  ****************************************************************************/
 
-static int virtnet_initialize(FAR struct virtio_mmio_regs *regs, int irq)
+static int virtnet_initialize(FAR struct virtio_mmio_regs *regs, int irq,
+                              uint32_t features)
 {
   FAR struct virtnet_driver_s *priv;
+  uint32_t i;
 
   /* Get the interface structure associated with this interface number. */
 
@@ -1277,6 +1507,20 @@ static int virtnet_initialize(FAR struct virtio_mmio_regs *regs, int irq)
   priv->txq  = virtq_create(CONFIG_DRIVERS_VIRTIO_NET_QUEUE_LEN);
   priv->rxq  = virtq_create(CONFIG_DRIVERS_VIRTIO_NET_QUEUE_LEN);
 
+  priv->event_idx = (features & (1 << VIRTIO_F_RING_EVENT_IDX)) != 0;
+
+  /* Prepare the TX slots.  No TX interrupts until the queue is full. */
+
+  for (i = 0; i < VIRTNET_NSLOTS; i++)
+    {
+      priv->txbuf[i] = kmm_memalign(16, PKTBUF_SIZE);
+      ASSERT(priv->txbuf[i]);
+      priv->txfree[i] = VIRTNET_NSLOTS - 1 - i;
+    }
+
+  priv->ntxfree = VIRTNET_NSLOTS;
+  virtnet_enable_cb(priv, priv->txq, false);
+
   virtq_add_to_mmio_device(regs, priv->rxq, VIRTIO_NET_Q_RX);
   virtq_add_to_mmio_device(regs, priv->txq, VIRTIO_NET_Q_TX);
 
@@ -1298,6 +1542,21 @@ static int virtnet_initialize(FAR struct virtio_mmio_regs *regs, int irq)
 #endif
   priv->vnet_dev.d_private = g_virtnet;                  /* Used to recover private state from dev */
 
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  if ((features & (1 << VIRTIO_NET_F_CSUM)) != 0)
+    {
+      priv->vnet_dev.d_features |= NETDEV_FEATURE_TXCSUM;
+    }
+
+  if ((features & (1 << VIRTIO_NET_F_GUEST_CSUM)) != 0)
+    {
+      priv->vnet_dev.d_features |= NETDEV_FEATURE_RXCSUM;
+#ifdef CONFIG_NET_TCP_GRO
+      priv->vnet_dev.d_features |= NETDEV_FEATURE_GRO;
+#endif
+    }
+#endif
+
 #ifdef TODO
   /* Put the interface in the down state.  This usually amounts to resetting
    * the device and/or calling virtnet_ifdown().
@@ -1329,17 +1588,22 @@ static int virtnet_initialize(FAR struct virtio_mmio_regs *regs, int irq)
 
 int virtio_mmio_net_init(FAR struct virtio_mmio_regs *regs, uint32_t irq)
 {
+  uint32_t features = 1 << VIRTIO_F_RING_EVENT_IDX;
   int ret = OK;
 
-  /* TODO: feature negotiation */
+  /* Checksum offload is negotiated only if the stack can make use of it */
 
-  /* Set STATUS_FEATURE_OK */
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  features |= (1 << VIRTIO_NET_F_CSUM) | (1 << VIRTIO_NET_F_GUEST_CSUM);
+#endif
 
-  virtio_putreg32(virtio_getreg32(&regs->status) | VIRTIO_STATUS_FEATURES_OK,
-                  &regs->status);
-  virtio_mb();
+  ret = virtio_mmio_negotiate(regs, &features);
+  if (OK != ret)
+    {
+      return ret;
+    }
 
-  ret = virtnet_initialize(regs, irq);
+  ret = virtnet_initialize(regs, irq, features);
 
   if (OK != ret)
     {
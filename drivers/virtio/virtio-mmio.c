@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/arch.h>
@@ -36,6 +37,10 @@
 #  include "virtio-mmio-net.h"
 #endif
 
+#ifdef CONFIG_DRIVERS_VIRTIO_BLK
+#  include "virtio-mmio-blk.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -81,10 +86,18 @@ FAR struct virtqueue *virtq_create(uint32_t len)
   vrtinfo("virtq->avail=%p \n", virtq->avail);
   vrtinfo("virtq->used=%p \n", virtq->used);
 
+  virtq->avail->flags = 0;
   virtq->avail->idx = 0;
+  virtq->used->flags = 0;
   virtq->used->idx = 0;
   virtq->last_used_idx = 0;
 
+  /* See: 2.6.7 Used Buffer Notification Suppression */
+
+  virtq->used_event  = &virtq->avail->ring[len];
+  virtq->avail_event = (FAR uint16_t *)&virtq->used->ring[len];
+  *virtq->used_event = 0;
+
   return virtq;
 }
 
@@ -145,6 +158,11 @@ static int virtio_dev_init(uintptr_t virt, uint32_t irq)
     case VIRTIO_DEV_NET:
       ret = virtio_mmio_net_init(regs, irq);
       break;
+#endif
+#ifdef CONFIG_DRIVERS_VIRTIO_BLK
+    case VIRTIO_DEV_BLK:
+      ret = virtio_mmio_blk_init(regs, irq);
+      break;
 #endif
     default:
       vrtwarn("unsupported device_id 0x%" PRIx32 "\n", val);
@@ -173,6 +191,46 @@ uint32_t virtq_alloc_desc(FAR struct virtqueue *virtq,
   return id;
 }
 
+/****************************************************************************
+ * Name: virtio_mmio_negotiate
+ *
+ * Description:
+ *   Accept those of the feature bits 0-31 in *features that the device
+ *   offers and set FEATURES_OK.  On return *features holds the accepted
+ *   features.  Must be called before the queues are set up.
+ *
+ ****************************************************************************/
+
+int virtio_mmio_negotiate(FAR struct virtio_mmio_regs *regs,
+                          FAR uint32_t *features)
+{
+  uint32_t val;
+
+  virtio_putreg32(0, &regs->device_features_sel);
+  virtio_mb();
+  *features &= virtio_getreg32(&regs->device_features);
+
+  virtio_putreg32(0, &regs->driver_features_sel);
+  virtio_mb();
+  virtio_putreg32(*features, &regs->driver_features);
+  virtio_mb();
+
+  val = virtio_getreg32(&regs->status) | VIRTIO_STATUS_FEATURES_OK;
+  virtio_putreg32(val, &regs->status);
+  virtio_mb();
+
+  /* The device clears FEATURES_OK if it does not support the subset */
+
+  if ((virtio_getreg32(&regs->status) & VIRTIO_STATUS_FEATURES_OK) == 0)
+    {
+      vrterr("error: features 0x%" PRIx32 " not accepted\n", *features);
+      return -ENODEV;
+    }
+
+  vrtinfo("features=0x%" PRIx32 "\n", *features);
+  return OK;
+}
+
 /****************************************************************************
  * Name: virtq_add_to_mmio_device
  ****************************************************************************/
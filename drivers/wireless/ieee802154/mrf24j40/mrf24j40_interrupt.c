@@ -122,23 +122,28 @@ static void mrf24j40_irqwork_txnorm(FAR struct mrf24j40_radio_s *dev)
     }
   else
     {
-      /* Inform the next layer of the transmission success/failure */
+      FAR struct ieee802154_txdesc_s *txdesc = dev->csma_desc;
 
-      dev->csma_desc->conf->status = status;
-      dev->csma_desc->framepending = framepending;
-      dev->radiocb->txdone(dev->radiocb, dev->csma_desc);
+      txdesc->conf->status = status;
+      txdesc->framepending = framepending;
 
-      /* We are now done with the transaction */
+      /* We are now done with the transaction.  Load and trigger the next
+       * frame queued by the MAC first, so that the radio does not idle
+       * while the MAC handles the completion.  Must unlock the radio
+       * before calling poll.
+       */
 
       dev->csma_busy = 0;
 
-      /* Must unlock the radio before calling poll */
-
       nxmutex_unlock(&dev->lock);
       mrf24j40_dopoll_csma(dev);
       while (nxmutex_lock(&dev->lock) < 0)
         {
         }
+
+      /* Inform the next layer of the transmission success/failure */
+
+      dev->radiocb->txdone(dev->radiocb, txdesc);
     }
 }
 
@@ -0,0 +1,635 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioring.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+
+#include "aio/aio.h"
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The completion index must be visible only after the entry is written */
+
+#ifdef CONFIG_SMP
+#  define aio_ring_dmb()  SP_DMB()
+#else
+#  define aio_ring_dmb()
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A submitted request.  The entry is copied out of the submission queue,
+ * so the application may reuse the slot as soon as sq_head moves past it.
+ */
+
+struct aio_ring_req_s
+{
+  sq_entry_t             node;
+  FAR struct file       *filep;   /* Resolved in the submitter's context */
+  struct io_ring_sqe     sqe;
+};
+
+/* The kernel side of a ring.  The masks and the queue pointers are kept
+ * here so that the kernel never relies on values the application can
+ * modify.
+ */
+
+struct aio_ring_s
+{
+  FAR struct io_ring_s  *ring;    /* Head and tail indices */
+  FAR struct io_ring_sqe *sqes;
+  FAR struct io_ring_cqe *cqes;
+  uint32_t               sq_mask;
+  uint32_t               cq_mask;
+  int                    crefs;
+  unsigned int           inflight; /* Requests not yet completed */
+  bool                   queued;   /* The worker is scheduled or running */
+  mutex_t                lock;
+  sem_t                  cqsem;    /* Posted when completions are added */
+  FAR struct pollfd     *fds[CONFIG_FS_AIO_RING_NPOLLWAITERS];
+  struct work_s          work;
+  sq_queue_t             pending;  /* Requests waiting for the worker */
+  sq_queue_t             free;     /* Unused requests */
+  struct aio_ring_req_s  reqs[1];  /* sq_mask + 1 requests */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int aio_ring_open(FAR struct file *filep);
+static int aio_ring_close(FAR struct file *filep);
+static int aio_ring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_aio_ring_ops =
+{
+  aio_ring_open,    /* open */
+  aio_ring_close,   /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  NULL,             /* ioctl */
+  aio_ring_poll     /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL            /* unlink */
+#endif
+};
+
+static struct inode g_aio_ring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_aio_ring_ops       /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct aio_ring_s *aio_ring_from_fd(int fd)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return NULL;
+    }
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_aio_ring_ops)
+    {
+      set_errno(EBADF);
+      return NULL;
+    }
+
+  return filep->f_priv;
+}
+
+static void aio_ring_wakeup(FAR struct aio_ring_s *ctx)
+{
+  int semcount = 0;
+
+  nxsem_get_value(&ctx->cqsem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&ctx->cqsem);
+    }
+}
+
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Add one entry to the completion queue and wake up the waiters.  There
+ *   is always room because io_ring_enter() never lets the number of
+ *   requests in flight plus unharvested completions exceed the size of the
+ *   completion queue.
+ *
+ * Assumptions:
+ *   The ring is locked.
+ *
+ ****************************************************************************/
+
+static void aio_ring_complete(FAR struct aio_ring_s *ctx,
+                              uintptr_t user_data, ssize_t res)
+{
+  FAR struct io_ring_s *ring = ctx->ring;
+  FAR struct io_ring_cqe *cqe;
+
+  cqe = &ctx->cqes[ring->cq_tail & ctx->cq_mask];
+  cqe->user_data = user_data;
+  cqe->res       = res;
+
+  aio_ring_dmb();
+  ring->cq_tail++;
+
+  aio_ring_wakeup(ctx);
+  poll_notify(ctx->fds, CONFIG_FS_AIO_RING_NPOLLWAITERS, POLLIN);
+}
+
+/****************************************************************************
+ * Name: aio_ring_execute
+ *
+ * Description:
+ *   Perform one request on the worker thread.
+ *
+ ****************************************************************************/
+
+static ssize_t aio_ring_execute(FAR struct aio_ring_req_s *req)
+{
+  FAR struct io_ring_sqe *sqe = &req->sqe;
+#ifdef CONFIG_NET
+  FAR struct socket *psock;
+#endif
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        return 0;
+
+      case IORING_OP_READ:
+        if (sqe->off < 0)
+          {
+            return file_read(req->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pread(req->filep, sqe->addr, sqe->len, sqe->off);
+
+      case IORING_OP_WRITE:
+        if (sqe->off < 0)
+          {
+            return file_write(req->filep, sqe->addr, sqe->len);
+          }
+
+        return file_pwrite(req->filep, sqe->addr, sqe->len, sqe->off);
+
+      case IORING_OP_FSYNC:
+        return file_fsync(req->filep);
+
+#ifdef CONFIG_NET
+      case IORING_OP_SENDMSG:
+      case IORING_OP_RECVMSG:
+        psock = file_socket(req->filep);
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        if (sqe->opcode == IORING_OP_SENDMSG)
+          {
+            return psock_sendmsg(psock, sqe->addr, sqe->msg_flags);
+          }
+
+        return psock_recvmsg(psock, sqe->addr, sqe->msg_flags);
+#endif
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: aio_ring_worker
+ *
+ * Description:
+ *   Run the pending requests of a ring on the low priority work queue.
+ *   A single work item serves every request of the ring, so a batch of
+ *   submissions costs one wake-up of the worker rather than one each.
+ *
+ ****************************************************************************/
+
+static void aio_ring_worker(FAR void *arg)
+{
+  FAR struct aio_ring_s *ctx = arg;
+  FAR struct aio_ring_req_s *req;
+  ssize_t res;
+
+  nxmutex_lock(&ctx->lock);
+  while ((req = (FAR struct aio_ring_req_s *)
+                sq_remfirst(&ctx->pending)) != NULL)
+    {
+      nxmutex_unlock(&ctx->lock);
+
+      res = aio_ring_execute(req);
+      if (res < 0)
+        {
+          finfo("op %u on fd %d failed: %zd\n",
+                req->sqe.opcode, req->sqe.fd, res);
+        }
+
+      nxmutex_lock(&ctx->lock);
+      aio_ring_complete(ctx, req->sqe.user_data, res);
+      sq_addlast(&req->node, &ctx->free);
+      ctx->inflight--;
+    }
+
+  /* aio_ring_close() may be waiting for the worker to go idle */
+
+  ctx->queued = false;
+  aio_ring_wakeup(ctx);
+  nxmutex_unlock(&ctx->lock);
+}
+
+static int aio_ring_open(FAR struct file *filep)
+{
+  FAR struct aio_ring_s *ctx = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ctx->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ctx->crefs++;
+  nxmutex_unlock(&ctx->lock);
+  return OK;
+}
+
+static int aio_ring_close(FAR struct file *filep)
+{
+  FAR struct aio_ring_s *ctx = filep->f_priv;
+
+  nxmutex_lock(&ctx->lock);
+  if (--ctx->crefs > 0)
+    {
+      nxmutex_unlock(&ctx->lock);
+      return OK;
+    }
+
+  /* Requests cannot be aborted once started; wait for the worker to
+   * finish with the ring.
+   */
+
+  while (ctx->inflight > 0 || ctx->queued)
+    {
+      nxmutex_unlock(&ctx->lock);
+      nxsem_wait_uninterruptible(&ctx->cqsem);
+      nxmutex_lock(&ctx->lock);
+    }
+
+  nxmutex_unlock(&ctx->lock);
+
+  nxmutex_destroy(&ctx->lock);
+  nxsem_destroy(&ctx->cqsem);
+  kumm_free(ctx->sqes);
+  kumm_free(ctx->cqes);
+  kmm_free(ctx);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_poll
+ *
+ * Description:
+ *   The ring is readable while completions wait to be harvested, so that
+ *   an event loop can wait for them together with other descriptors.
+ *
+ ****************************************************************************/
+
+static int aio_ring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup)
+{
+  FAR struct aio_ring_s *ctx = filep->f_priv;
+  FAR struct pollfd **slot;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&ctx->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!setup)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_FS_AIO_RING_NPOLLWAITERS; i++)
+    {
+      if (ctx->fds[i] == NULL)
+        {
+          ctx->fds[i] = fds;
+          fds->priv   = &ctx->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_FS_AIO_RING_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto out;
+    }
+
+  if (ctx->ring->cq_tail != ctx->ring->cq_head)
+    {
+      poll_notify(ctx->fds, CONFIG_FS_AIO_RING_NPOLLWAITERS, POLLIN);
+    }
+
+out:
+  nxmutex_unlock(&ctx->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: io_ring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring pair.  The submission and
+ *   completion entries are allocated from the user heap and attached to
+ *   ring.
+ *
+ * Input Parameters:
+ *   entries - The requested number of submission queue entries
+ *   ring    - The ring structure to be initialized
+ *
+ * Returned Value:
+ *   A file descriptor that refers to the ring on success.  Otherwise, -1
+ *   is returned and the errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int io_ring_setup(unsigned int entries, FAR struct io_ring_s *ring)
+{
+  FAR struct aio_ring_s *ctx;
+  unsigned int size = 1;
+  unsigned int i;
+  int ret;
+
+  if (ring == NULL || entries == 0 ||
+      entries > CONFIG_FS_AIO_RING_MAXENTRIES)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  while (size < entries)
+    {
+      size <<= 1;
+    }
+
+  ctx = kmm_zalloc(sizeof(*ctx) + sizeof(ctx->reqs[0]) * (size - 1));
+  if (ctx == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  ctx->sqes = kumm_zalloc(sizeof(struct io_ring_sqe) * size);
+  ctx->cqes = kumm_zalloc(sizeof(struct io_ring_cqe) * size * 2);
+  if (ctx->sqes == NULL || ctx->cqes == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ctx->ring    = ring;
+  ctx->sq_mask = size - 1;
+  ctx->cq_mask = size * 2 - 1;
+  ctx->crefs   = 1;
+
+  nxmutex_init(&ctx->lock);
+  nxsem_init(&ctx->cqsem, 0, 0);
+  sq_init(&ctx->pending);
+  sq_init(&ctx->free);
+  for (i = 0; i < size; i++)
+    {
+      sq_addlast(&ctx->reqs[i].node, &ctx->free);
+    }
+
+  ring->sq_head = 0;
+  ring->sq_tail = 0;
+  ring->sq_mask = ctx->sq_mask;
+  ring->sqes    = ctx->sqes;
+  ring->cq_head = 0;
+  ring->cq_tail = 0;
+  ring->cq_mask = ctx->cq_mask;
+  ring->cqes    = ctx->cqes;
+
+  ret = file_allocate(&g_aio_ring_inode, O_RDWR, 0, ctx, 0, true);
+  if (ret < 0)
+    {
+      nxmutex_destroy(&ctx->lock);
+      nxsem_destroy(&ctx->cqsem);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  kumm_free(ctx->sqes);
+  kumm_free(ctx->cqes);
+  kmm_free(ctx);
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: io_ring_enter
+ *
+ * Description:
+ *   Submit up to to_submit entries from the submission queue and then wait
+ *   until at least min_complete completions are waiting in the completion
+ *   queue.
+ *
+ *   Descriptors are resolved here, in the context of the caller; the I/O
+ *   itself runs on the low priority work queue in submission order.  A
+ *   request that blocks, e.g. a receive on a socket without data, delays
+ *   the requests behind it on the same ring.
+ *
+ *   Submission stops early when the requests in flight plus the
+ *   completions not yet harvested would overflow the completion queue.
+ *   The wait for completions ends early if no request is in flight.
+ *
+ * Input Parameters:
+ *   fd           - The descriptor returned by io_ring_setup()
+ *   to_submit    - The maximum number of entries to submit
+ *   min_complete - The number of completions to wait for
+ *
+ * Returned Value:
+ *   The number of entries submitted.  Otherwise, -1 is returned and the
+ *   errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int io_ring_enter(int fd, unsigned int to_submit, unsigned int min_complete)
+{
+  FAR struct aio_ring_req_s *req;
+  FAR struct aio_ring_s *ctx;
+  FAR struct io_ring_s *ring;
+  unsigned int submitted = 0;
+  int ret;
+
+  ctx = aio_ring_from_fd(fd);
+  if (ctx == NULL)
+    {
+      return ERROR;
+    }
+
+  ret = nxmutex_lock(&ctx->lock);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  ring = ctx->ring;
+  while (submitted < to_submit && ring->sq_head != ring->sq_tail)
+    {
+      if (ctx->inflight + (ring->cq_tail - ring->cq_head) > ctx->cq_mask)
+        {
+          break;
+        }
+
+      req = (FAR struct aio_ring_req_s *)sq_remfirst(&ctx->free);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      req->sqe = ctx->sqes[ring->sq_head & ctx->sq_mask];
+      ring->sq_head++;
+      submitted++;
+
+      ret = OK;
+      if (req->sqe.opcode != IORING_OP_NOP)
+        {
+          ret = fs_getfilep(req->sqe.fd, &req->filep);
+        }
+
+      if (ret < 0)
+        {
+          /* Complete at once, without bothering the worker */
+
+          aio_ring_complete(ctx, req->sqe.user_data, ret);
+          sq_addlast(&req->node, &ctx->free);
+          continue;
+        }
+
+      sq_addlast(&req->node, &ctx->pending);
+      ctx->inflight++;
+    }
+
+  if (!sq_empty(&ctx->pending) && !ctx->queued)
+    {
+      ret = work_queue(LPWORK, &ctx->work, aio_ring_worker, ctx, 0);
+      if (ret < 0)
+        {
+          /* Fail the requests that cannot be run */
+
+          while ((req = (FAR struct aio_ring_req_s *)
+                        sq_remfirst(&ctx->pending)) != NULL)
+            {
+              aio_ring_complete(ctx, req->sqe.user_data, ret);
+              sq_addlast(&req->node, &ctx->free);
+              ctx->inflight--;
+            }
+        }
+      else
+        {
+          ctx->queued = true;
+        }
+    }
+
+  while (ring->cq_tail - ring->cq_head < min_complete && ctx->inflight > 0)
+    {
+      nxmutex_unlock(&ctx->lock);
+
+      ret = nxsem_wait(&ctx->cqsem);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      nxmutex_lock(&ctx->lock);
+    }
+
+  nxmutex_unlock(&ctx->lock);
+  return submitted;
+}
+
+#endif /* CONFIG_FS_AIO_RING */
@@ -41,6 +41,8 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 
 #include "cromfs.h"
 
@@ -52,6 +54,10 @@
 
 #define CROMFS_MAX_LINKS 64
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+#  define CROMFS_HAVE_CACHE 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,11 +74,41 @@ struct cromfs_dir_s
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+#ifndef CROMFS_HAVE_CACHE
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
+};
+
+#ifdef CROMFS_HAVE_CACHE
+/* One decompressed block in the block cache */
+
+struct cromfs_cblock_s
+{
+  uint32_t cb_offset;                       /* Block offset (0: none) */
+  uint32_t cb_age;                          /* Time of last use, for LRU */
+  uint16_t cb_ulen;                         /* Length of decompressed data */
+  bool cb_busy;                             /* Being filled by read-ahead */
+  FAR uint8_t *cb_buffer;                   /* Decompressed data */
 };
 
+/* The block cache shared by all open files of the image */
+
+struct cromfs_cache_s
+{
+  mutex_t cc_lock;                          /* Protects the cache */
+  uint32_t cc_age;                          /* Free running use counter */
+  struct cromfs_cblock_s cc_blocks[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  struct work_s cc_work;                    /* Read-ahead work */
+  FAR const struct cromfs_volume_s *cc_fs;  /* Volume of the read-ahead */
+  FAR const uint8_t *cc_rasrc;              /* Data to read ahead */
+  uint16_t cc_raclen;                       /* Length of compressed data */
+#endif
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -131,6 +167,20 @@ static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                   FAR const char *relpath,
                   FAR struct cromfs_nodeinfo_s *info,
                   FAR uint32_t *offset);
+#ifdef CROMFS_HAVE_CACHE
+static FAR struct cromfs_cblock_s *cromfs_cache_find(uint32_t voloffs);
+static FAR struct cromfs_cblock_s *
+                cromfs_cache_victim(FAR const struct cromfs_volume_s *fs);
+static int      cromfs_cache_read(FAR const struct cromfs_volume_s *fs,
+                  FAR const uint8_t *src, uint16_t clen, FAR uint8_t *dest,
+                  unsigned int copyoffs, unsigned int copysize);
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void     cromfs_cache_worker(FAR void *arg);
+static void     cromfs_cache_readahead(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct lzf_header_s *hdr);
+#endif
+static void     cromfs_cache_flush(void);
+#endif
 
 /* Common file system methods */
 
@@ -219,6 +269,15 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+#ifdef CROMFS_HAVE_CACHE
+/* The cache of decompressed blocks of that image */
+
+static struct cromfs_cache_s g_cromfs_cache =
+{
+  NXMUTEX_INITIALIZER
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -717,6 +776,296 @@ static int cromfs_find_node(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_cache_find
+ *
+ * Description:
+ *   Return the cache entry holding the decompressed data of the block at
+ *   voloffs, or NULL if the block is not cached.  The caller holds the
+ *   cache lock.
+ *
+ ****************************************************************************/
+
+#ifdef CROMFS_HAVE_CACHE
+static FAR struct cromfs_cblock_s *cromfs_cache_find(uint32_t voloffs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      FAR struct cromfs_cblock_s *cb = &g_cromfs_cache.cc_blocks[i];
+
+      if (cb->cb_offset == voloffs && !cb->cb_busy)
+        {
+          return cb;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_victim
+ *
+ * Description:
+ *   Select the cache entry to receive a new block: an unused entry if
+ *   there is one, otherwise the least recently used one.  The entry is
+ *   returned invalidated and with its buffer allocated.  The caller holds
+ *   the cache lock.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cblock_s *
+cromfs_cache_victim(FAR const struct cromfs_volume_s *fs)
+{
+  FAR struct cromfs_cblock_s *victim = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      FAR struct cromfs_cblock_s *cb = &g_cromfs_cache.cc_blocks[i];
+
+      if (cb->cb_busy)
+        {
+          continue;
+        }
+
+      if (cb->cb_offset == 0)
+        {
+          victim = cb;
+          break;
+        }
+
+      if (victim == NULL || (int32_t)(cb->cb_age - victim->cb_age) < 0)
+        {
+          victim = cb;
+        }
+    }
+
+  if (victim != NULL)
+    {
+      victim->cb_offset = 0;
+      if (victim->cb_buffer == NULL)
+        {
+          victim->cb_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
+          if (victim->cb_buffer == NULL)
+            {
+              return NULL;
+            }
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_read
+ *
+ * Description:
+ *   Copy copysize bytes from offset copyoffs of the decompressed block
+ *   whose compressed data (clen bytes) begins at src.  The block is
+ *   decompressed into the cache unless it is already there.
+ *
+ ****************************************************************************/
+
+static int cromfs_cache_read(FAR const struct cromfs_volume_s *fs,
+                             FAR const uint8_t *src, uint16_t clen,
+                             FAR uint8_t *dest, unsigned int copyoffs,
+                             unsigned int copysize)
+{
+  FAR struct cromfs_cblock_s *cb;
+  uint32_t voloffs;
+  int ret;
+
+  voloffs = cromfs_addr2offset(fs, src);
+
+  ret = nxmutex_lock(&g_cromfs_cache.cc_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  cb = cromfs_cache_find(voloffs);
+  if (cb == NULL)
+    {
+      cb = cromfs_cache_victim(fs);
+      if (cb == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      cb->cb_ulen = lzf_decompress(src, clen, cb->cb_buffer, fs->cv_bsize);
+      if (cb->cb_ulen == 0)
+        {
+          ferr("ERROR: Failed to decompress block at %" PRIu32 "\n",
+               voloffs);
+          ret = -EIO;
+          goto errout_with_lock;
+        }
+
+      cb->cb_offset = voloffs;
+    }
+
+  finfo("voloffs=%" PRIu32 " ulen=%" PRIu16 " copyoffs=%u copysize=%u\n",
+        voloffs, cb->cb_ulen, copyoffs, copysize);
+  DEBUGASSERT(cb->cb_ulen >= (copyoffs + copysize));
+
+  memcpy(dest, &cb->cb_buffer[copyoffs], copysize);
+  cb->cb_age = ++g_cromfs_cache.cc_age;
+
+errout_with_lock:
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_worker
+ *
+ * Description:
+ *   Decompress the block requested by cromfs_cache_readahead() into the
+ *   cache.  The entry is marked busy while the lock is released for the
+ *   decompression, so that readers are not held up meanwhile.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void cromfs_cache_worker(FAR void *arg)
+{
+  FAR const struct cromfs_volume_s *fs;
+  FAR struct cromfs_cblock_s *cb;
+  FAR const uint8_t *src;
+  uint32_t voloffs;
+  uint16_t clen;
+  uint16_t ulen;
+
+  if (nxmutex_lock(&g_cromfs_cache.cc_lock) < 0)
+    {
+      return;
+    }
+
+  fs  = g_cromfs_cache.cc_fs;
+  src = g_cromfs_cache.cc_rasrc;
+  clen = g_cromfs_cache.cc_raclen;
+  g_cromfs_cache.cc_rasrc = NULL;
+
+  if (src == NULL)
+    {
+      goto out_with_lock;
+    }
+
+  voloffs = cromfs_addr2offset(fs, src);
+  if (cromfs_cache_find(voloffs) != NULL)
+    {
+      goto out_with_lock;
+    }
+
+  cb = cromfs_cache_victim(fs);
+  if (cb == NULL)
+    {
+      goto out_with_lock;
+    }
+
+  cb->cb_busy = true;
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+
+  ulen = lzf_decompress(src, clen, cb->cb_buffer, fs->cv_bsize);
+
+  nxmutex_lock(&g_cromfs_cache.cc_lock);
+  cb->cb_busy = false;
+
+  /* A reader may have decompressed the same block in the meantime */
+
+  if (ulen > 0 && cromfs_cache_find(voloffs) == NULL)
+    {
+      cb->cb_offset = voloffs;
+      cb->cb_ulen   = ulen;
+      cb->cb_age    = ++g_cromfs_cache.cc_age;
+    }
+
+out_with_lock:
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_readahead
+ *
+ * Description:
+ *   Schedule the decompression of the block at hdr into the cache, unless
+ *   it is stored uncompressed or already cached.  Only the most recent
+ *   request is kept.
+ *
+ ****************************************************************************/
+
+static void cromfs_cache_readahead(FAR const struct cromfs_volume_s *fs,
+                                   FAR const struct lzf_header_s *hdr)
+{
+  FAR const struct lzf_type1_header_s *hdr1;
+  FAR const uint8_t *src;
+
+  /* With a single entry, the read-ahead would evict the block in use */
+
+  if (CONFIG_FS_CROMFS_CACHE_NBLOCKS < 2 || hdr->lzf_type != LZF_TYPE1_HDR)
+    {
+      return;
+    }
+
+  hdr1 = (FAR const struct lzf_type1_header_s *)hdr;
+  src  = (FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE;
+
+  if (nxmutex_lock(&g_cromfs_cache.cc_lock) < 0)
+    {
+      return;
+    }
+
+  if (cromfs_cache_find(cromfs_addr2offset(fs, src)) == NULL)
+    {
+      g_cromfs_cache.cc_fs     = fs;
+      g_cromfs_cache.cc_rasrc  = src;
+      g_cromfs_cache.cc_raclen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+                                 (uint16_t)hdr1->lzf_clen[1];
+
+      work_queue(LPWORK, &g_cromfs_cache.cc_work, cromfs_cache_worker,
+                 NULL, 0);
+    }
+
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_cache_flush
+ *
+ * Description:
+ *   Release the memory held by the block cache.
+ *
+ ****************************************************************************/
+
+static void cromfs_cache_flush(void)
+{
+  int i;
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  work_cancel(LPWORK, &g_cromfs_cache.cc_work);
+#endif
+
+  nxmutex_lock(&g_cromfs_cache.cc_lock);
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      FAR struct cromfs_cblock_s *cb = &g_cromfs_cache.cc_blocks[i];
+
+      if (!cb->cb_busy && cb->cb_buffer != NULL)
+        {
+          kmm_free(cb->cb_buffer);
+          cb->cb_buffer = NULL;
+          cb->cb_offset = 0;
+        }
+    }
+
+  nxmutex_unlock(&g_cromfs_cache.cc_lock);
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -785,6 +1134,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifndef CROMFS_HAVE_CACHE
   /* Create a file buffer to support partial sector accesses */
 
   ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -793,6 +1143,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       kmm_free(ff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -819,11 +1170,13 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
+#ifndef CROMFS_HAVE_CACHE
   kmm_free(ff->ff_buffer);
+#endif
   kmm_free(ff);
 
   return OK;
@@ -865,7 +1218,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -968,6 +1321,32 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
           finfo("blkoffs=%" PRIu32 " ulen=%" PRIu16 " copysize=%u\n",
                 blkoffs, ulen, copysize);
         }
+#ifdef CROMFS_HAVE_CACHE
+      else
+        {
+          int ret;
+
+          /* Get the data from the block cache, decompressing the block
+           * there if needed.
+           */
+
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
+
+          if (copysize > remaining)  /* Clip to the size really needed */
+            {
+              copysize = remaining;
+            }
+
+          src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          ret = cromfs_cache_read(fs, src, clen, dest, copyoffs, copysize);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+#else
       else
         {
           /* If the source of the data is at the beginning of the compressed
@@ -1049,6 +1428,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
               memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
             }
         }
+#endif
 
       /* Adjust pointers counts and offset */
 
@@ -1057,6 +1437,15 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       fpos      += copysize;
     }
 
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  /* Prepare the next block if the file continues past this read */
+
+  if (buflen > 0 && blkoffs + ulen < ff->ff_node->cn_size)
+    {
+      cromfs_cache_readahead(fs, nexthdr);
+    }
+#endif
+
   /* Update the file pointer */
 
   filep->f_pos = fpos;
@@ -1069,9 +1458,44 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
 static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR const struct cromfs_volume_s *fs;
+  FAR struct cromfs_file_s *ff;
+  FAR struct lzf_type0_header_s *hdr0;
+  FAR void **ppv = (FAR void **)arg;
+  uint16_t ulen;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+  fs = filep->f_inode->i_private;
+  ff = (FAR struct cromfs_file_s *)filep->f_priv;
+
+  /* The file can only be mapped directly if its data is held in one
+   * uncompressed block; otherwise mmap() falls back to a copy in RAM.
+   */
+
+  if (cmd == FIOC_MMAP && ppv != NULL)
+    {
+      hdr0 = (FAR struct lzf_type0_header_s *)
+             cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
 
-  /* No IOCTL commands yet supported */
+      if (ff->ff_node->cn_size == 0)
+        {
+          *ppv = hdr0;
+          return OK;
+        }
+
+      if (hdr0->lzf_type == LZF_TYPE0_HDR)
+        {
+          ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+                 (uint16_t)hdr0->lzf_len[1];
+          if (ulen == ff->ff_node->cn_size)
+            {
+              *ppv = (FAR uint8_t *)hdr0 + LZF_TYPE0_HDR_SIZE;
+              return OK;
+            }
+        }
+    }
 
   return -ENOTTY;
 }
@@ -1102,7 +1526,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1114,6 +1538,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
+#ifndef CROMFS_HAVE_CACHE
   /* Create a file buffer to support partial sector accesses */
 
   newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -1122,6 +1547,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       kmm_free(newff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -1159,7 +1585,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1440,6 +1866,11 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#ifdef CROMFS_HAVE_CACHE
+  cromfs_cache_flush();
+#endif
+
   return OK;
 }
 
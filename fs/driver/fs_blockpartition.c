@@ -245,6 +245,17 @@ static int part_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
                 prot->startblock += dev->firstsector;
               }
+            else if (cmd == BIOC_DAX)
+              {
+                FAR struct bio_dax_s *dax = (FAR struct bio_dax_s *)ptr_arg;
+
+                if ((off_t)dax->startsector >= dev->nsectors)
+                  {
+                    return -EINVAL;
+                  }
+
+                dax->startsector += dev->firstsector;
+              }
 
             ret = parent->u.i_bops->ioctl(parent, cmd, arg);
             if (ret >= 0)
@@ -256,6 +267,18 @@ static int part_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
                     *(FAR uint8_t *)base +=
                           dev->firstsector * dev->sectorsize;
                   }
+                else if (cmd == BIOC_DAX)
+                  {
+                    FAR struct bio_dax_s *dax =
+                      (FAR struct bio_dax_s *)ptr_arg;
+
+                    dax->startsector -= dev->firstsector;
+                    if ((off_t)dax->nsectors >
+                        dev->nsectors - (off_t)dax->startsector)
+                      {
+                        dax->nsectors = dev->nsectors - dax->startsector;
+                      }
+                  }
                 else if (cmd == MTDIOC_GEOMETRY)
                   {
                     FAR struct mtd_geometry_s *mgeo =
@@ -0,0 +1,638 @@
+/****************************************************************************
+ * fs/driver/fs_blockqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A request queue in front of a block driver.  The threads reading and
+ * writing the queue device sleep while their requests are scheduled by a
+ * worker thread.  The worker serves the pending requests in the order of
+ * their sectors, sweeping up the device and then back from its start,
+ * unless a request has waited past its deadline.  Requests for adjacent
+ * sectors in the same direction are merged into one transfer through a
+ * bounce buffer, so that concurrent sequential streams reach the media as
+ * a few large transfers rather than many small interleaved ones.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#include "driver/driver.h"
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_BLOCKQUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A request, on the stack of its caller until it completes */
+
+struct blkq_req_s
+{
+  struct list_node node;        /* In the pending list, sorted by sector */
+  FAR unsigned char *buffer;    /* The data of the request */
+  blkcnt_t start;               /* The first sector */
+  unsigned int nsectors;        /* The number of sectors */
+  bool write;                   /* The direction of the transfer */
+  clock_t deadline;             /* Serve from this time on, in order */
+  ssize_t result;               /* Sectors transferred or negated errno */
+  sem_t done;                   /* Posted when result is set */
+};
+
+struct blkq_dev_s
+{
+  FAR struct inode *parent;     /* The block driver behind the queue */
+  FAR unsigned char *bounce;    /* The buffer of the merged transfers */
+  size_t sectorsize;            /* The sector size of the parent */
+  blkcnt_t next;                /* The sector after the last transfer */
+  struct list_node pending;     /* The queued requests */
+  mutex_t lock;                 /* Protects pending */
+  sem_t work;                   /* Posted for each request */
+  sem_t exit;                   /* Posted when the worker exits */
+  bool stop;                    /* The worker must exit */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     blkq_open(FAR struct inode *inode);
+static int     blkq_close(FAR struct inode *inode);
+static ssize_t blkq_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                 blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t blkq_write(FAR struct inode *inode,
+                 FAR const unsigned char *buffer, blkcnt_t start_sector,
+                 unsigned int nsectors);
+static int     blkq_geometry(FAR struct inode *inode,
+                 FAR struct geometry *geometry);
+static int     blkq_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     blkq_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_blkq_bops =
+{
+  blkq_open,     /* open     */
+  blkq_close,    /* close    */
+  blkq_read,     /* read     */
+  blkq_write,    /* write    */
+  blkq_geometry, /* geometry */
+  blkq_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , blkq_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkq_select
+ *
+ * Description:
+ *   Remove the next request to serve, and those that merge with it, from
+ *   the pending list and move them to batch in the order of their sectors.
+ *
+ ****************************************************************************/
+
+static void blkq_select(FAR struct blkq_dev_s *dev,
+                        FAR struct list_node *batch)
+{
+  FAR struct blkq_req_s *first = NULL;
+  FAR struct blkq_req_s *req;
+  FAR struct blkq_req_s *next;
+  clock_t now = clock_systime_ticks();
+  unsigned int nsectors;
+
+  /* An expired request is served first, the oldest one of them, so that
+   * the sweep cannot starve the requests behind it.
+   */
+
+  list_for_every_entry(&dev->pending, req, struct blkq_req_s, node)
+    {
+      if ((sclock_t)(now - req->deadline) >= 0 &&
+          (first == NULL ||
+           (sclock_t)(req->deadline - first->deadline) < 0))
+        {
+          first = req;
+        }
+    }
+
+  /* Otherwise continue the sweep from the last transfer */
+
+  if (first == NULL)
+    {
+      list_for_every_entry(&dev->pending, req, struct blkq_req_s, node)
+        {
+          if (req->start >= dev->next)
+            {
+              first = req;
+              break;
+            }
+        }
+    }
+
+  if (first == NULL)
+    {
+      first = list_first_entry(&dev->pending, struct blkq_req_s, node);
+    }
+
+  /* Add the requests that continue it without a gap */
+
+  nsectors = first->nsectors;
+  req      = first;
+  next     = list_next_type(&dev->pending, &req->node,
+                            struct blkq_req_s, node);
+
+  list_delete(&first->node);
+  list_add_tail(batch, &first->node);
+
+  while (next != NULL &&
+         next->write == first->write &&
+         next->start == req->start + req->nsectors &&
+         nsectors + next->nsectors <= CONFIG_FS_BLOCKQUEUE_MAXSECTORS)
+    {
+      req       = next;
+      next      = list_next_type(&dev->pending, &req->node,
+                                 struct blkq_req_s, node);
+      nsectors += req->nsectors;
+
+      list_delete(&req->node);
+      list_add_tail(batch, &req->node);
+    }
+
+  dev->next = req->start + req->nsectors;
+}
+
+/****************************************************************************
+ * Name: blkq_transfer
+ *
+ * Description:
+ *   Perform a batch of adjacent requests as one transfer and complete them.
+ *
+ ****************************************************************************/
+
+static void blkq_transfer(FAR struct blkq_dev_s *dev,
+                          FAR struct list_node *batch)
+{
+  FAR struct inode *parent = dev->parent;
+  FAR struct blkq_req_s *first;
+  FAR struct blkq_req_s *req;
+  FAR struct blkq_req_s *tmp;
+  FAR unsigned char *buffer;
+  unsigned int nsectors = 0;
+  unsigned int offset = 0;
+  ssize_t ret;
+
+  first = list_first_entry(batch, struct blkq_req_s, node);
+
+  list_for_every_entry(batch, req, struct blkq_req_s, node)
+    {
+      nsectors += req->nsectors;
+    }
+
+  /* A single request needs no bounce buffer */
+
+  buffer = nsectors == first->nsectors ? first->buffer : dev->bounce;
+
+  if (first->write)
+    {
+      if (buffer == dev->bounce)
+        {
+          list_for_every_entry(batch, req, struct blkq_req_s, node)
+            {
+              memcpy(buffer + offset * dev->sectorsize, req->buffer,
+                     req->nsectors * dev->sectorsize);
+              offset += req->nsectors;
+            }
+
+          offset = 0;
+        }
+
+      ret = parent->u.i_bops->write(parent, buffer, first->start,
+                                    nsectors);
+    }
+  else
+    {
+      ret = parent->u.i_bops->read(parent, buffer, first->start,
+                                   nsectors);
+    }
+
+  /* Split the result of the transfer between the requests */
+
+  list_for_every_entry_safe(batch, req, tmp, struct blkq_req_s, node)
+    {
+      if (ret < 0)
+        {
+          req->result = ret;
+        }
+      else if ((size_t)ret <= offset)
+        {
+          req->result = 0;
+        }
+      else
+        {
+          req->result = (size_t)ret - offset < req->nsectors ?
+                        ret - offset : req->nsectors;
+        }
+
+      if (!req->write && buffer == dev->bounce && req->result > 0)
+        {
+          memcpy(req->buffer, buffer + offset * dev->sectorsize,
+                 req->result * dev->sectorsize);
+        }
+
+      offset += req->nsectors;
+      list_delete(&req->node);
+      nxsem_post(&req->done);
+    }
+}
+
+/****************************************************************************
+ * Name: blkq_thread
+ ****************************************************************************/
+
+static int blkq_thread(int argc, FAR char *argv[])
+{
+  FAR struct blkq_dev_s *dev = (FAR struct blkq_dev_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 16));
+  struct list_node batch;
+
+  list_initialize(&batch);
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&dev->work);
+
+      nxmutex_lock(&dev->lock);
+      if (list_is_empty(&dev->pending))
+        {
+          bool stop = dev->stop;
+
+          nxmutex_unlock(&dev->lock);
+          if (stop)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      blkq_select(dev, &batch);
+      nxmutex_unlock(&dev->lock);
+
+      /* New requests queue up meanwhile and may merge in the next batch */
+
+      blkq_transfer(dev, &batch);
+    }
+
+  nxsem_post(&dev->exit);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: blkq_submit
+ *
+ * Description:
+ *   Queue a request and wait for the worker to complete it.
+ *
+ ****************************************************************************/
+
+static ssize_t blkq_submit(FAR struct blkq_dev_s *dev,
+                           FAR unsigned char *buffer, blkcnt_t start,
+                           unsigned int nsectors, bool write)
+{
+  FAR struct blkq_req_s *pos;
+  struct blkq_req_s req;
+
+  if (nsectors == 0)
+    {
+      return 0;
+    }
+
+  req.buffer   = buffer;
+  req.start    = start;
+  req.nsectors = nsectors;
+  req.write    = write;
+  req.deadline = clock_systime_ticks() +
+                 MSEC2TICK(write ? CONFIG_FS_BLOCKQUEUE_WRITE_DEADLINE :
+                                   CONFIG_FS_BLOCKQUEUE_READ_DEADLINE);
+  nxsem_init(&req.done, 0, 0);
+
+  /* Keep the list sorted, after the requests for the same sector so that
+   * overlapping requests are served in the order they were made.
+   */
+
+  nxmutex_lock(&dev->lock);
+
+  list_for_every_entry(&dev->pending, pos, struct blkq_req_s, node)
+    {
+      if (pos->start > start)
+        {
+          break;
+        }
+    }
+
+  list_add_before(&pos->node, &req.node);
+  nxmutex_unlock(&dev->lock);
+
+  nxsem_post(&dev->work);
+  nxsem_wait_uninterruptible(&req.done);
+  nxsem_destroy(&req.done);
+
+  return req.result;
+}
+
+/****************************************************************************
+ * Name: blkq_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int blkq_open(FAR struct inode *inode)
+{
+  FAR struct blkq_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->open)
+    {
+      ret = parent->u.i_bops->open(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkq_close
+ *
+ * Description: close the block device
+ *
+ ****************************************************************************/
+
+static int blkq_close(FAR struct inode *inode)
+{
+  FAR struct blkq_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+  int ret = OK;
+
+  if (parent->u.i_bops->close)
+    {
+      ret = parent->u.i_bops->close(parent);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkq_read
+ *
+ * Description:  Read the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t blkq_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                         blkcnt_t start_sector, unsigned int nsectors)
+{
+  return blkq_submit(inode->i_private, buffer, start_sector, nsectors,
+                     false);
+}
+
+/****************************************************************************
+ * Name: blkq_write
+ *
+ * Description: Write the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t blkq_write(FAR struct inode *inode,
+                          FAR const unsigned char *buffer,
+                          blkcnt_t start_sector, unsigned int nsectors)
+{
+  return blkq_submit(inode->i_private, (FAR unsigned char *)buffer,
+                     start_sector, nsectors, true);
+}
+
+/****************************************************************************
+ * Name: blkq_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int blkq_geometry(FAR struct inode *inode,
+                         FAR struct geometry *geometry)
+{
+  FAR struct blkq_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+
+  return parent->u.i_bops->geometry(parent, geometry);
+}
+
+/****************************************************************************
+ * Name: blkq_ioctl
+ *
+ * Description:
+ *   Forward the ioctl to the parent.  The callers of read and write wait
+ *   for their requests, so none of theirs can still be queued.
+ *
+ ****************************************************************************/
+
+static int blkq_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct blkq_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+
+  if (parent->u.i_bops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  return parent->u.i_bops->ioctl(parent, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: blkq_free
+ ****************************************************************************/
+
+static void blkq_free(FAR struct blkq_dev_s *dev)
+{
+  nxsem_destroy(&dev->exit);
+  nxsem_destroy(&dev->work);
+  nxmutex_destroy(&dev->lock);
+  kmm_free(dev->bounce);
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: blkq_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int blkq_unlink(FAR struct inode *inode)
+{
+  FAR struct blkq_dev_s *dev = inode->i_private;
+  FAR struct inode *parent = dev->parent;
+
+  nxmutex_lock(&dev->lock);
+  dev->stop = true;
+  nxmutex_unlock(&dev->lock);
+
+  nxsem_post(&dev->work);
+  nxsem_wait_uninterruptible(&dev->exit);
+
+  inode_release(parent);
+  blkq_free(dev);
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockqueue
+ *
+ * Description:
+ *   Register a block driver inode that queues, sorts and merges the
+ *   requests to another block driver.  Concurrent accesses through the
+ *   queue reach the parent as fewer and larger transfers.
+ *
+ * Input Parameters:
+ *   path   - The path to the queue inode
+ *   mode   - The access permissions of the queue inode
+ *   parent - The path to the parent inode
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure:
+ *
+ *   EINVAL - 'path' is invalid for this operation
+ *   EEXIST - An inode already exists at 'path'
+ *   ENOMEM - Failed to allocate in-memory resources for the operation
+ *
+ ****************************************************************************/
+
+int register_blockqueue(FAR const char *path, mode_t mode,
+                        FAR const char *parent)
+{
+  FAR struct blkq_dev_s *dev;
+  struct geometry geo;
+  FAR char *argv[2];
+  char arg1[32];
+  int ret;
+
+  dev = kmm_zalloc(sizeof(*dev));
+  if (!dev)
+    {
+      return -ENOMEM;
+    }
+
+  list_initialize(&dev->pending);
+  nxmutex_init(&dev->lock);
+  nxsem_init(&dev->work, 0, 0);
+  nxsem_init(&dev->exit, 0, 0);
+
+  /* Find the block driver */
+
+  if (mode & (S_IWOTH | S_IWGRP | S_IWUSR))
+    {
+      ret = find_blockdriver(parent, 0, &dev->parent);
+    }
+  else
+    {
+      ret = find_blockdriver(parent, MS_RDONLY, &dev->parent);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_free;
+    }
+
+  ret = dev->parent->u.i_bops->geometry(dev->parent, &geo);
+  if (ret < 0)
+    {
+      goto errout_release;
+    }
+
+  dev->sectorsize = geo.geo_sectorsize;
+  dev->bounce     = kmm_malloc(CONFIG_FS_BLOCKQUEUE_MAXSECTORS *
+                               dev->sectorsize);
+  if (dev->bounce == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_release;
+    }
+
+  snprintf(arg1, sizeof(arg1), "%p", dev);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("blkqueue", CONFIG_FS_BLOCKQUEUE_PRIORITY,
+                       CONFIG_FS_BLOCKQUEUE_STACKSIZE, blkq_thread, argv);
+  if (ret < 0)
+    {
+      goto errout_release;
+    }
+
+  ret = register_blockdriver(path, &g_blkq_bops, mode, dev);
+  if (ret < 0)
+    {
+      goto errout_stop;
+    }
+
+  return OK;
+
+errout_stop:
+  dev->stop = true;
+  nxsem_post(&dev->work);
+  nxsem_wait_uninterruptible(&dev->exit);
+errout_release:
+  inode_release(dev->parent);
+errout_free:
+  blkq_free(dev);
+  return ret;
+}
+
+#endif /* CONFIG_FS_BLOCKQUEUE */
@@ -97,6 +97,8 @@ static int     fat_stat_root(FAR struct fat_mountpt_s *fs,
                  FAR struct stat *buf);
 static int     fat_stat(struct inode *mountpt, const char *relpath,
                  FAR struct stat *buf);
+static int32_t fat_nextcluster(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff, off_t position, bool extend);
 
 /****************************************************************************
  * Public Data
@@ -143,6 +145,59 @@ const struct mountpt_operations fat_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_nextcluster
+ *
+ * Description:
+ *   Return the cluster that holds the file position 'position' which is at
+ *   the beginning of the cluster that follows ff_currentcluster in the
+ *   chain.  The chain is extended if 'extend' is true and the current
+ *   cluster is the last one.
+ *
+ * Returned Value:
+ *   <0:error, 0: end of chain/no free cluster, >=2: cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_nextcluster(FAR struct fat_mountpt_s *fs,
+                               FAR struct fat_file_s *ff, off_t position,
+                               bool extend)
+{
+  int32_t cluster;
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  uint32_t index;
+  uint32_t found;
+
+  /* Try the cached chain first */
+
+  index = position / (fs->fs_fatsecperclus * fs->fs_hwsectorsize);
+  found = index;
+  cluster = fat_extentlookup(ff, &found);
+  if (cluster != 0 && found == index)
+    {
+      return cluster;
+    }
+#endif
+
+  if (extend)
+    {
+      cluster = fat_extendchain(fs, ff->ff_currentcluster);
+    }
+  else
+    {
+      cluster = fat_getcluster(fs, ff->ff_currentcluster);
+    }
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  if (cluster >= 2 && cluster < fs->fs_nclusters)
+    {
+      fat_extentadd(ff, index, cluster);
+    }
+#endif
+
+  return cluster;
+}
+
 /****************************************************************************
  * Name: fat_open
  ****************************************************************************/
@@ -249,6 +304,11 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
         {
           /* Truncate the file to zero length */
 
+#ifdef CONFIG_FAT_EXTENT_CACHE
+          fat_extentinvalidate(fs,
+                    ((uint32_t)DIR_GETFSTCLUSTHI(direntry) << 16) |
+                    DIR_GETFSTCLUSTLO(direntry));
+#endif
           ret = fat_dirtruncate(fs, direntry);
           if (ret < 0)
             {
@@ -572,7 +632,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
         {
           /* Find the next cluster in the FAT. */
 
-          cluster = fat_getcluster(fs, ff->ff_currentcluster);
+          cluster = fat_nextcluster(fs, ff, filep->f_pos, false);
           if (cluster < 2 || cluster >= fs->fs_nclusters)
             {
               ret = -EINVAL; /* Not the right error */
@@ -816,7 +876,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
            * move the file position back from the end of the file)
            */
 
-          cluster = fat_extendchain(fs, ff->ff_currentcluster);
+          cluster = fat_nextcluster(fs, ff, filep->f_pos, true);
 
           /* Verify the cluster number */
 
@@ -1013,6 +1073,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   int32_t cluster;
   off_t position;
   unsigned int clustersize;
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  uint32_t index;
+  uint32_t found;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1143,6 +1207,24 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+      /* Skip the part of the chain that is already known */
+
+      index = position / clustersize;
+      found = fat_extentlookup(ff, &index);
+      if (found != 0)
+        {
+          cluster       = found;
+          filep->f_pos  = (off_t)index * clustersize;
+          position     -= filep->f_pos;
+        }
+      else
+        {
+          fat_extentadd(ff, 0, cluster);
+        }
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1165,21 +1247,14 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
            * is actually written into the gap."
            */
 
-          if ((ff->ff_oflags & O_WROK) != 0)
-            {
-              /* Extend the cluster chain (fat_extendchain
-               * will follow the existing chain or add new
-               * clusters as needed.
-               */
-
-              cluster = fat_extendchain(fs, cluster);
-            }
-          else
-            {
-              /* Otherwise we can only follow the existing chain */
+          /* Extend the cluster chain if the file is writable
+           * (fat_extendchain will follow the existing chain or add
+           * new clusters as needed).  Otherwise we can only follow
+           * the existing chain.
+           */
 
-              cluster = fat_getcluster(fs, cluster);
-            }
+          cluster = fat_nextcluster(fs, ff, filep->f_pos + clustersize,
+                                    (ff->ff_oflags & O_WROK) != 0);
 
           if (cluster < 0)
             {
@@ -1533,6 +1608,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  newff->ff_extnext          = oldff->ff_extnext;          /* Cached chain */
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1852,6 +1931,12 @@ static int fat_truncate(FAR struct file *filep, off_t length)
        * length.
        */
 
+#ifdef CONFIG_FAT_EXTENT_CACHE
+      /* Clusters are removed from the chain */
+
+      fat_extentinvalidate(fs, ff->ff_startcluster);
+#endif
+
       if (length == 0)
         {
           /* Shrink to length == 0 */
@@ -2292,6 +2377,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemapfree(fs);
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   kmm_free(fs);
   return OK;
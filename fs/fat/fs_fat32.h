@@ -887,8 +887,26 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint32_t *fs_freemap;        /* One bit per cluster, set if the
+                                    * cluster is free */
+  bool     fs_nofreemap;           /* true: fs_freemap could not be built */
+#endif
 };
 
+#ifdef CONFIG_FAT_EXTENT_CACHE
+/* One run of clusters that are contiguous both in the file and on the
+ * media.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the run in the file */
+  uint32_t fe_cluster;             /* Its cluster number on the media */
+  uint32_t fe_count;               /* Number of clusters (0: unused) */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -908,6 +926,10 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENT_CACHE
+  uint8_t  ff_extnext;             /* Next extent to be replaced */
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENT_CACHE_SIZE];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1050,6 +1072,23 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+/* Cache of the cluster chain of an open file */
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+EXTERN uint32_t fat_extentlookup(FAR struct fat_file_s *ff,
+                                 FAR uint32_t *index);
+EXTERN void   fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                            uint32_t cluster);
+EXTERN void   fat_extentinvalidate(FAR struct fat_mountpt_s *fs,
+                                   uint32_t startcluster);
+#endif
+
+/* Map of the free clusters */
+
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN void   fat_freemapfree(FAR struct fat_mountpt_s *fs);
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
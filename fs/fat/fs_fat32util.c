@@ -46,6 +46,203 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Build the map of free clusters with one pass over the FAT.  The free
+ *   cluster count of FSINFO is refreshed on the way.
+ *
+ * Returned Value:
+ *   OK if the map is available, a negated errno value otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  if (fs->fs_freemap != NULL)
+    {
+      return OK;
+    }
+
+  if (fs->fs_nofreemap)
+    {
+      return -ENOMEM;
+    }
+
+  fs->fs_freemap = kmm_zalloc(((fs->fs_nclusters + 31) / 32) *
+                              sizeof(uint32_t));
+  if (fs->fs_freemap == NULL)
+    {
+      fs->fs_nofreemap = true;
+      return -ENOMEM;
+    }
+
+  for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          fat_freemapfree(fs);
+          return (int)next;
+        }
+
+      if (next == 0)
+        {
+          fs->fs_freemap[cluster >> 5] |= 1u << (cluster & 31);
+          nfreeclusters++;
+        }
+    }
+
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Description:
+ *   Find a free cluster after 'startcluster' in the map of free clusters,
+ *   wrapping around to the beginning of the FAT.
+ *
+ * Returned Value:
+ *   <0:error (-ENOMEM: no map), 0: no free cluster, >=2: free cluster
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int32_t fat_freemapsearch(FAR struct fat_mountpt_s *fs,
+                                 uint32_t startcluster)
+{
+  uint32_t nwords = (fs->fs_nclusters + 31) / 32;
+  uint32_t cluster;
+  uint32_t word;
+  uint32_t i;
+  int ret;
+
+  ret = fat_freemapbuild(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Visit every word once, starting with the one after the start cluster.
+   * Bits that do not correspond to data clusters are never set.
+   */
+
+  cluster = startcluster + 1;
+  if (cluster >= fs->fs_nclusters)
+    {
+      cluster = 2;
+    }
+
+  for (i = 0; i <= nwords; i++)
+    {
+      word = fs->fs_freemap[cluster >> 5] & (0xffffffff << (cluster & 31));
+      if (word != 0)
+        {
+          return (cluster & ~31) + __builtin_ctz(word);
+        }
+
+      cluster = (cluster | 31) + 1;
+      if (cluster >= fs->fs_nclusters)
+        {
+          cluster = 0;
+        }
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_linearsearch
+ *
+ * Description:
+ *   Find a free cluster after 'startcluster' by reading the FAT entries
+ *   one at a time, wrapping around to the beginning of the FAT.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster
+ *
+ ****************************************************************************/
+
+static int32_t fat_linearsearch(FAR struct fat_mountpt_s *fs,
+                                uint32_t startcluster)
+{
+  off_t    startsector;
+  uint32_t newcluster;
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: fat_checkfsinfo
  *
@@ -1089,6 +1286,22 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* Keep the map of free clusters in sync with the FAT */
+
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          if (nextcluster == 0)
+            {
+              fs->fs_freemap[clusterno >> 5] |= 1u << (clusterno & 31);
+            }
+          else
+            {
+              fs->fs_freemap[clusterno >> 5] &= ~(1u << (clusterno & 31));
+            }
+        }
+#endif
+
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
@@ -1215,66 +1428,25 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+  /* Find a free cluster, with the map of free clusters if possible */
 
-  newcluster = startcluster;
-  for (; ; )
+#ifdef CONFIG_FAT_FREEMAP
+  ret = fat_freemapsearch(fs, startcluster);
+  if (ret == -ENOMEM)
+#endif
     {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+      ret = fat_linearsearch(fs, startcluster);
+    }
 
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+  if (ret <= 0)
+    {
+      return ret;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  newcluster = ret;
+
+  /* We get here only if we found an available cluster number in
+   * 'newcluster'  Now mark that cluster as in-use.
    */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
@@ -1312,6 +1484,155 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_extentlookup
+ *
+ * Description:
+ *   Find the cached cluster of the file that is nearest to, but not after
+ *   the cluster with index '*index' in the file.
+ *
+ * Input Parameters:
+ *   ff    - The open file
+ *   index - The index of the wanted cluster in the file.  On return, the
+ *           index of the cluster that was found.
+ *
+ * Returned Value:
+ *   The cluster number or 0 if no cluster at or before '*index' is cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_EXTENT_CACHE
+uint32_t fat_extentlookup(FAR struct fat_file_s *ff, FAR uint32_t *index)
+{
+  FAR struct fat_extent_s *best = NULL;
+  FAR struct fat_extent_s *ext;
+  uint32_t offset;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_EXTENT_CACHE_SIZE; i++)
+    {
+      ext = &ff->ff_extents[i];
+      if (ext->fe_count > 0 && ext->fe_index <= *index &&
+          (best == NULL || ext->fe_index > best->fe_index))
+        {
+          best = ext;
+        }
+    }
+
+  if (best == NULL)
+    {
+      return 0;
+    }
+
+  offset = *index - best->fe_index;
+  if (offset >= best->fe_count)
+    {
+      offset = best->fe_count - 1;
+    }
+
+  *index = best->fe_index + offset;
+  return best->fe_cluster + offset;
+}
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that cluster 'index' of the file is 'cluster'.  The cluster
+ *   extends an existing extent if it follows it both in the file and on
+ *   the media; otherwise it starts a new extent, replacing an old one if
+ *   necessary.
+ *
+ ****************************************************************************/
+
+void fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                   uint32_t cluster)
+{
+  FAR struct fat_extent_s *ext;
+  FAR struct fat_extent_s *unused = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_EXTENT_CACHE_SIZE; i++)
+    {
+      ext = &ff->ff_extents[i];
+      if (ext->fe_count == 0)
+        {
+          unused = ext;
+        }
+      else if (index >= ext->fe_index &&
+               index - ext->fe_index < ext->fe_count)
+        {
+          /* Already known */
+
+          return;
+        }
+      else if (index == ext->fe_index + ext->fe_count &&
+               cluster == ext->fe_cluster + ext->fe_count)
+        {
+          ext->fe_count++;
+          return;
+        }
+    }
+
+  if (unused == NULL)
+    {
+      unused = &ff->ff_extents[ff->ff_extnext];
+      if (++ff->ff_extnext >= CONFIG_FAT_EXTENT_CACHE_SIZE)
+        {
+          ff->ff_extnext = 0;
+        }
+    }
+
+  unused->fe_index   = index;
+  unused->fe_cluster = cluster;
+  unused->fe_count   = 1;
+}
+
+/****************************************************************************
+ * Name: fat_extentinvalidate
+ *
+ * Description:
+ *   Forget the cached cluster chain of every open file whose chain starts
+ *   with 'startcluster'.  This must be called whenever clusters are
+ *   removed from the chain.
+ *
+ ****************************************************************************/
+
+void fat_extentinvalidate(FAR struct fat_mountpt_s *fs,
+                          uint32_t startcluster)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      if (ff->ff_startcluster == startcluster)
+        {
+          memset(ff->ff_extents, 0, sizeof(ff->ff_extents));
+          ff->ff_extnext = 0;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapfree
+ *
+ * Description:
+ *   Release the map of free clusters
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+void fat_freemapfree(FAR struct fat_mountpt_s *fs)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      kmm_free(fs->fs_freemap);
+      fs->fs_freemap = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -2027,6 +2348,19 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   /* We have to count the number of free clusters */
 
   uint32_t nfreeclusters = 0;
+
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap != NULL)
+    {
+      uint32_t i;
+
+      for (i = 0; i < (fs->fs_nclusters + 31) / 32; i++)
+        {
+          nfreeclusters += __builtin_popcount(fs->fs_freemap[i]);
+        }
+    }
+  else
+#endif
   if (fs->fs_type == FSTYPE_FAT12)
     {
       off_t sector;
@@ -51,6 +51,8 @@
 
 #define HOSTFS_RETRY_DELAY_MS       10
 
+#define HOSTFS_BUFSIZE              CONFIG_FS_HOSTFS_BUFFER_SIZE
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -231,6 +233,165 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#ifdef CONFIG_FS_HOSTFS_MMAP
+/****************************************************************************
+ * Name: hostfs_mmap
+ *
+ * Description: Return the address of the host file mapped in memory, for
+ *   FIOC_MMAP.  A file is mapped again if it grew since it was last mapped.
+ *
+ ****************************************************************************/
+
+static int hostfs_mmap(FAR struct hostfs_mountpt_s *fs,
+                       FAR struct hostfs_ofile_s *hf, FAR void **addr)
+{
+  FAR struct hostfs_map_s *map;
+  struct stat buf;
+  int ret;
+
+  ret = host_fstat(hf->fd, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (buf.st_size == 0)
+    {
+      return -EINVAL;
+    }
+
+  if (hf->map == NULL || hf->map->length < buf.st_size)
+    {
+      map = kmm_malloc(sizeof(struct hostfs_map_s));
+      if (map == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      map->length = buf.st_size;
+      map->addr   = host_mmap(hf->fd, map->length,
+                              (hf->oflags & O_WROK) != 0);
+      if (map->addr == NULL)
+        {
+          kmm_free(map);
+          return -ENODEV;
+        }
+
+      /* The mapping outlives the open file, like a POSIX mapping */
+
+      map->next   = fs->fs_maps;
+      fs->fs_maps = map;
+      hf->map     = map;
+    }
+
+  *addr = hf->map->addr;
+  return OK;
+}
+#endif
+
+#if HOSTFS_BUFSIZE > 0
+/****************************************************************************
+ * Name: hostfs_dropbuffer
+ *
+ * Description: Drop the read ahead data of a file and move the host
+ *   position back to the file position.
+ *
+ ****************************************************************************/
+
+static int hostfs_dropbuffer(FAR struct file *filep,
+                             FAR struct hostfs_ofile_s *hf)
+{
+  off_t ret;
+
+  if (hf->buflen > 0 && hf->bufpos + hf->buflen != filep->f_pos)
+    {
+      ret = host_lseek(hf->fd, filep->f_pos, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  hf->buflen = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufread
+ *
+ * Description: Read through the read ahead buffer of a file.  Reads
+ *   smaller than the buffer fill it with one host call.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_bufread(FAR struct file *filep,
+                              FAR struct hostfs_ofile_s *hf,
+                              FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret = 0;
+  size_t n;
+
+  while (buflen > 0)
+    {
+      /* Copy what the read ahead data holds at the file position */
+
+      if (hf->buflen > 0 && filep->f_pos >= hf->bufpos &&
+          filep->f_pos < hf->bufpos + hf->buflen)
+        {
+          n = hf->bufpos + hf->buflen - filep->f_pos;
+          if (n > buflen)
+            {
+              n = buflen;
+            }
+
+          memcpy(buffer, hf->buffer + (filep->f_pos - hf->bufpos), n);
+          filep->f_pos += n;
+          buffer       += n;
+          buflen       -= n;
+          nread        += n;
+          continue;
+        }
+
+      ret = hostfs_dropbuffer(filep, hf);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      if (buflen < HOSTFS_BUFSIZE && hf->buffer == NULL)
+        {
+          hf->buffer = kmm_malloc(HOSTFS_BUFSIZE);
+        }
+
+      if (buflen >= HOSTFS_BUFSIZE || hf->buffer == NULL)
+        {
+          /* Large reads go to the user buffer directly */
+
+          ret = host_read(hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              filep->f_pos += ret;
+              nread        += ret;
+            }
+
+          break;
+        }
+
+      ret = host_read(hf->fd, hf->buffer, HOSTFS_BUFSIZE);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->bufpos = filep->f_pos;
+      hf->buflen = ret;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -267,7 +428,7 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Allocate memory for the open file */
 
-  hf = (struct hostfs_ofile_s *) kmm_malloc(sizeof *hf);
+  hf = (struct hostfs_ofile_s *) kmm_zalloc(sizeof *hf);
   if (hf == NULL)
     {
       ret = -ENOMEM;
@@ -419,6 +580,13 @@ static int hostfs_close(FAR struct file *filep)
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if HOSTFS_BUFSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      kmm_free(hf->buffer);
+    }
+#endif
+
   kmm_free(hf);
 
 okout:
@@ -458,6 +626,9 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+#if HOSTFS_BUFSIZE > 0
+  ret = hostfs_bufread(filep, hf, buffer, buflen);
+#else
   /* Call the host to perform the read */
 
   ret = host_read(hf->fd, buffer, buflen);
@@ -465,6 +636,7 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
     {
       filep->f_pos += ret;
     }
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -510,6 +682,14 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_lock;
     }
 
+#if HOSTFS_BUFSIZE > 0
+  ret = hostfs_dropbuffer(filep, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = host_write(hf->fd, buffer, buflen);
@@ -554,6 +734,17 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+#if HOSTFS_BUFSIZE > 0
+  /* SEEK_CUR is relative to the host position */
+
+  ret = hostfs_dropbuffer(filep, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, offset, whence);
@@ -597,6 +788,24 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  if (cmd == FIOC_MMAP)
+    {
+      ret = hostfs_mmap(fs, hf, (FAR void **)(uintptr_t)arg);
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
+#if HOSTFS_BUFSIZE > 0
+  ret = hostfs_dropbuffer(filep, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the ioctl */
 
   ret = host_ioctl(hf->fd, cmd, arg);
@@ -805,6 +1014,15 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
       return ret;
     }
 
+#if HOSTFS_BUFSIZE > 0
+  ret = hostfs_dropbuffer(filep, hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call the host to perform the truncate */
 
   ret = host_ftruncate(hf->fd, length);
@@ -1099,6 +1317,9 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                          unsigned int flags)
 {
   FAR struct hostfs_mountpt_s *fs = (FAR struct hostfs_mountpt_s *)handle;
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  FAR struct hostfs_map_s *map;
+#endif
   int ret;
 
   if (!fs)
@@ -1127,6 +1348,18 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return (flags != 0) ? -ENOSYS : -EBUSY;
     }
 
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  /* Release the mappings of the files */
+
+  while (fs->fs_maps != NULL)
+    {
+      map         = fs->fs_maps;
+      fs->fs_maps = map->next;
+      host_munmap(map->addr, map->length);
+      kmm_free(map);
+    }
+#endif
+
   nxmutex_unlock(&g_lock);
   kmm_free(fs);
   return ret;
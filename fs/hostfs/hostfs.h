@@ -41,6 +41,17 @@
  * Public Types
  ****************************************************************************/
 
+/* This structure describes one mapping of a host file (FIOC_MMAP) */
+
+#ifdef CONFIG_FS_HOSTFS_MMAP
+struct hostfs_map_s
+{
+  struct hostfs_map_s      *next;       /* Supports a singly linked list */
+  FAR void                 *addr;       /* Address of the mapping */
+  size_t                    length;     /* Length of the mapping */
+};
+#endif
+
 /* This structure describes the state of one open file.  This structure
  * is protected by the volume semaphore.
  */
@@ -51,6 +62,16 @@ struct hostfs_ofile_s
   int16_t                   crefs;      /* Reference count */
   mode_t                    oflags;     /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  /* The host position is at the end of the read ahead data, if any */
+
+  FAR char                 *buffer;     /* Read ahead data */
+  off_t                     bufpos;     /* File offset of buffer */
+  size_t                    buflen;     /* Number of bytes in buffer */
+#endif
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  struct hostfs_map_s      *map;        /* Latest mapping of the file */
+#endif
 };
 
 /* This structure represents the overall mountpoint state.  An instance of
@@ -61,6 +82,9 @@ struct hostfs_ofile_s
 struct hostfs_mountpt_s
 {
   FAR struct hostfs_ofile_s *fs_head;      /* A singly-linked list of open files */
+#ifdef CONFIG_FS_HOSTFS_MMAP
+  FAR struct hostfs_map_s   *fs_maps;      /* Mappings of the files */
+#endif
   char                       fs_root[HOSTFS_MAX_PATH];
 };
 
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 #include <sched.h>
@@ -38,6 +39,14 @@
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The maximum number of rows of a file list */
+
+#define FILES_MAXROWS (OPEN_MAX / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -48,7 +57,7 @@
 
 static int files_extend(FAR struct filelist *list, size_t row)
 {
-  FAR struct file **tmp;
+  FAR struct file **files;
   int i;
 
   if (row <= list->fl_rows)
@@ -56,38 +65,56 @@ static int files_extend(FAR struct filelist *list, size_t row)
       return 0;
     }
 
-  if (row * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK > OPEN_MAX)
+  if (row > FILES_MAXROWS)
     {
       return -EMFILE;
     }
 
-  tmp = kmm_realloc(list->fl_files, sizeof(FAR struct file *) * row);
-  DEBUGASSERT(tmp);
-  if (tmp == NULL)
+  /* fs_getfilep() reads the row array without the lock, so the array is
+   * allocated once with room for every row and never replaced, and the
+   * rows themselves never move.
+   */
+
+  files = list->fl_files;
+  if (files == NULL)
     {
-      return -ENFILE;
+      files = kmm_zalloc(sizeof(FAR struct file *) * FILES_MAXROWS);
+      DEBUGASSERT(files);
+      if (files == NULL)
+        {
+          return -ENFILE;
+        }
     }
 
   i = list->fl_rows;
   do
     {
-      tmp[i] = kmm_zalloc(sizeof(struct file) *
-                          CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
-      if (tmp[i] == NULL)
+      files[i] = kmm_zalloc(sizeof(struct file) *
+                            CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
+      if (files[i] == NULL)
         {
           while (--i >= list->fl_rows)
             {
-              kmm_free(tmp[i]);
+              kmm_free(files[i]);
+              files[i] = NULL;
+            }
+
+          if (list->fl_files == NULL)
+            {
+              kmm_free(files);
             }
 
-          kmm_free(tmp);
           return -ENFILE;
         }
     }
   while (++i < row);
 
-  list->fl_files = tmp;
-  list->fl_rows = row;
+  /* Publish the new rows.  A reader that sees the new count also sees
+   * the rows.
+   */
+
+  list->fl_files = files;
+  __atomic_store_n(&list->fl_rows, row, __ATOMIC_RELEASE);
 
   /* Note: If assertion occurs, the fl_rows has a overflow.
    * And there may be file descriptors leak in system.
@@ -97,6 +124,24 @@ static int files_extend(FAR struct filelist *list, size_t row)
   return 0;
 }
 
+/****************************************************************************
+ * Name: files_inherit
+ *
+ * Description:
+ *   Return true if the file descriptor 'fd' of the parent list is open and
+ *   is to be inherited by a child task.
+ *
+ ****************************************************************************/
+
+static bool files_inherit(FAR struct filelist *list, int fd)
+{
+  FAR struct file *filep;
+
+  filep = &list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
+                         [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+  return filep->f_inode != NULL && (filep->f_oflags & O_CLOEXEC) == 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -265,9 +310,11 @@ int file_allocate(FAR struct inode *inode, int oflags, off_t pos,
 
 int files_duplist(FAR struct filelist *plist, FAR struct filelist *clist)
 {
+  int nfds;
+  int row;
+  int col;
   int ret;
-  int i;
-  int j;
+  int fd;
 
   ret = nxmutex_lock(&plist->fl_lock);
   if (ret < 0)
@@ -277,41 +324,47 @@ int files_duplist(FAR struct filelist *plist, FAR struct filelist *clist)
       return ret;
     }
 
-  for (i = 0; i < plist->fl_rows; i++)
-    {
-      for (j = 0; j < CONFIG_NFILE_DESCRIPTORS_PER_BLOCK; j++)
-        {
-          FAR struct file *filep;
-#ifdef CONFIG_FDCLONE_STDIO
-
-          /* Determine how many file descriptors to clone.  If
-           * CONFIG_FDCLONE_DISABLE is set, no file descriptors will be
-           * cloned.  If CONFIG_FDCLONE_STDIO is set, only the first
-           * three descriptors (stdin, stdout, and stderr) will be
-           * cloned.  Otherwise all file descriptors will be cloned.
-           */
+  /* Determine how many file descriptors to clone.  If
+   * CONFIG_FDCLONE_DISABLE is set, no file descriptors will be
+   * cloned.  If CONFIG_FDCLONE_STDIO is set, only the first
+   * three descriptors (stdin, stdout, and stderr) will be
+   * cloned.  Otherwise all file descriptors will be cloned.
+   */
 
-          if (i * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK + j >= 3)
-            {
-              goto out;
-            }
+  nfds = plist->fl_rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+#ifdef CONFIG_FDCLONE_STDIO
+  if (nfds > 3)
+    {
+      nfds = 3;
+    }
 #endif
 
-          filep = &plist->fl_files[i][j];
-          if (filep->f_inode == NULL || (filep->f_oflags & O_CLOEXEC) != 0)
-            {
-              continue;
-            }
+  /* Stop after the last descriptor to inherit, so that the child list is
+   * extended once to its final size rather than one row at a time.
+   */
 
-          ret = files_extend(clist, i + 1);
-          if (ret < 0)
-            {
-              goto out;
-            }
+  while (nfds > 0 && !files_inherit(plist, nfds - 1))
+    {
+      nfds--;
+    }
+
+  ret = files_extend(clist, (nfds + CONFIG_NFILE_DESCRIPTORS_PER_BLOCK - 1) /
+                            CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
+  if (ret < 0)
+    {
+      goto out;
+    }
 
+  for (fd = 0; fd < nfds; fd++)
+    {
+      if (files_inherit(plist, fd))
+        {
           /* Yes... duplicate it for the child */
 
-          ret = file_dup2(filep, &clist->fl_files[i][j]);
+          row = fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+          col = fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+          ret = file_dup2(&plist->fl_files[row][col],
+                          &clist->fl_files[row][col]);
           if (ret < 0)
             {
               goto out;
@@ -344,7 +397,7 @@ out:
 int fs_getfilep(int fd, FAR struct file **filep)
 {
   FAR struct filelist *list;
-  int ret;
+  FAR struct file *file;
 
   DEBUGASSERT(filep != NULL);
   *filep = NULL;
@@ -363,36 +416,33 @@ int fs_getfilep(int fd, FAR struct file **filep)
       return -EAGAIN;
     }
 
-  if (fd < 0 || fd >= list->fl_rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+  if (fd < 0)
     {
       return -EBADF;
     }
 
-  /* The descriptor is in a valid range to file descriptor... Get the
-   * thread-specific file list.
+  /* The rows are only added by files_extend() and never move, so they
+   * can be read without the lock.
    */
 
-  /* And return the file pointer from the list */
-
-  ret = nxmutex_lock(&list->fl_lock);
-  if (ret < 0)
+  if (fd >= __atomic_load_n(&list->fl_rows, __ATOMIC_ACQUIRE) *
+            CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
     {
-      return ret;
+      return -EBADF;
     }
 
-  *filep = &list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
-                          [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+  file = &list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
+                        [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
 
-  /* if f_inode is NULL, fd was closed */
+  /* If f_inode is NULL, fd was closed */
 
-  if (!(*filep)->f_inode)
+  if (file->f_inode == NULL)
     {
-      *filep = NULL;
-      ret = -EBADF;
+      return -EBADF;
     }
 
-  nxmutex_unlock(&list->fl_lock);
-  return ret;
+  *filep = file;
+  return OK;
 }
 
 /****************************************************************************
@@ -456,6 +506,12 @@ int nx_dup2(int fd1, int fd2)
 
   filep = &list->fl_files[fd2 / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
                          [fd2 % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+
+  /* epoll knows the file by its place in the list, not by the copy that
+   * is closed below.
+   */
+
+  epoll_fileclose(filep);
   memcpy(&file, filep, sizeof(struct file));
   memset(filep, 0,     sizeof(struct file));
 
@@ -549,6 +605,12 @@ int nx_close(int fd)
 
   filep = &list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
                          [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+
+  /* epoll knows the file by its place in the list, not by the copy that
+   * is closed below.
+   */
+
+  epoll_fileclose(filep);
   memcpy(&file, filep, sizeof(struct file));
   memset(filep, 0,     sizeof(struct file));
 
@@ -28,8 +28,10 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
-#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 
 #include "inode/inode.h"
 
@@ -41,11 +43,78 @@
  * Private Types
  ****************************************************************************/
 
+/* The inode tree lock.  Any number of readers may hold it at the same time
+ * while the writer has exclusive access.  The writer may take the lock
+ * again, for reading or writing, recursively.  New readers wait behind a
+ * waiting writer so that a stream of lookups cannot starve tree updates.
+ * The fields are protected by the critical section.
+ */
+
+struct inode_lock_s
+{
+  sem_t waitsem;      /* Threads waiting for the lock */
+  int   nwaiters;     /* Number of threads waiting on waitsem */
+  int   nposted;      /* Posts on waitsem not yet consumed */
+  int   nwwaiters;    /* Number of waiting writers */
+  int   nreaders;     /* Number of readers holding the lock */
+  int   nwriters;     /* Recursion count of the writer */
+  pid_t holder;       /* The writer or INVALID_PROCESS_ID */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static rmutex_t g_inode_lock = NXRMUTEX_INITIALIZER;
+static struct inode_lock_s g_inode_lock =
+{
+  NXSEM_INITIALIZER(0, 0), 0, 0, 0, 0, 0, INVALID_PROCESS_ID
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_lock_wait
+ *
+ * Description:
+ *   Wait until the lock state changed.  Called within the critical section.
+ *
+ ****************************************************************************/
+
+static int inode_lock_wait(FAR struct inode_lock_s *lock)
+{
+  int ret;
+
+  lock->nwaiters++;
+  ret = nxsem_wait_uninterruptible(&lock->waitsem);
+  lock->nwaiters--;
+
+  if (ret >= 0)
+    {
+      lock->nposted--;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: inode_lock_wakeup
+ *
+ * Description:
+ *   Wake up every waiting thread to re-evaluate the lock state.  Called
+ *   within the critical section.
+ *
+ ****************************************************************************/
+
+static void inode_lock_wakeup(FAR struct inode_lock_s *lock)
+{
+  while (lock->nposted < lock->nwaiters)
+    {
+      lock->nposted++;
+      nxsem_post(&lock->waitsem);
+    }
+}
 
 /****************************************************************************
  * Public Functions
@@ -71,24 +140,145 @@ void inode_initialize(void)
  * Name: inode_lock
  *
  * Description:
- *   Get exclusive access to the in-memory inode tree (g_inode_sem).
+ *   Get exclusive access to the in-memory inode tree (g_inode_lock).
  *
  ****************************************************************************/
 
 int inode_lock(void)
 {
-  return nxrmutex_lock(&g_inode_lock);
+  FAR struct inode_lock_s *lock = &g_inode_lock;
+  pid_t tid = gettid();
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (lock->holder != tid)
+    {
+      lock->nwwaiters++;
+      while (lock->nwriters > 0 || lock->nreaders > 0)
+        {
+          ret = inode_lock_wait(lock);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      lock->nwwaiters--;
+      if (ret < 0)
+        {
+          /* Readers may have been held back by this writer */
+
+          inode_lock_wakeup(lock);
+          leave_critical_section(flags);
+          return ret;
+        }
+
+      lock->holder = tid;
+    }
+
+  lock->nwriters++;
+  leave_critical_section(flags);
+  return OK;
 }
 
 /****************************************************************************
  * Name: inode_unlock
  *
  * Description:
- *   Relinquish exclusive access to the in-memory inode tree (g_inode_sem).
+ *   Relinquish exclusive access to the in-memory inode tree (g_inode_lock).
  *
  ****************************************************************************/
 
 void inode_unlock(void)
 {
-  DEBUGVERIFY(nxrmutex_unlock(&g_inode_lock));
+  FAR struct inode_lock_s *lock = &g_inode_lock;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  DEBUGASSERT(lock->holder == gettid() && lock->nwriters > 0);
+
+  if (--lock->nwriters == 0)
+    {
+      lock->holder = INVALID_PROCESS_ID;
+      inode_lock_wakeup(lock);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_rlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (g_inode_lock) for
+ *   lookups.  The tree must not be modified while holding it.
+ *
+ ****************************************************************************/
+
+int inode_rlock(void)
+{
+  FAR struct inode_lock_s *lock = &g_inode_lock;
+  pid_t tid = gettid();
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  if (lock->holder == tid)
+    {
+      /* The writer already has exclusive access */
+
+      lock->nwriters++;
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  while (lock->nwriters > 0 || lock->nwwaiters > 0)
+    {
+      ret = inode_lock_wait(lock);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  lock->nreaders++;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inode_runlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (g_inode_lock).
+ *
+ ****************************************************************************/
+
+void inode_runlock(void)
+{
+  FAR struct inode_lock_s *lock = &g_inode_lock;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (lock->holder == gettid())
+    {
+      DEBUGASSERT(lock->nwriters > 0);
+      if (--lock->nwriters == 0)
+        {
+          lock->holder = INVALID_PROCESS_ID;
+          inode_lock_wakeup(lock);
+        }
+    }
+  else
+    {
+      DEBUGASSERT(lock->nreaders > 0);
+      if (--lock->nreaders == 0)
+        {
+          inode_lock_wakeup(lock);
+        }
+    }
+
+  leave_critical_section(flags);
 }
@@ -47,11 +47,11 @@ int inode_addref(FAR struct inode *inode)
 
   if (inode)
     {
-      ret = inode_lock();
+      ret = inode_rlock();
       if (ret >= 0)
         {
-          inode->i_crefs++;
-          inode_unlock();
+          __atomic_fetch_add(&inode->i_crefs, 1, __ATOMIC_RELAXED);
+          inode_runlock();
         }
     }
 
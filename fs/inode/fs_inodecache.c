@@ -0,0 +1,226 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/spinlock.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_FS_INODE_CACHE_SIZE & (CONFIG_FS_INODE_CACHE_SIZE - 1)) != 0
+#  error CONFIG_FS_INODE_CACHE_SIZE must be a power of two
+#endif
+
+#define INODE_CACHE_MASK (CONFIG_FS_INODE_CACHE_SIZE - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached lookup.  The cache is direct mapped on the hash of the full
+ * path; an entry with node == NULL is unused.
+ */
+
+struct inode_cache_s
+{
+  uint32_t          hash;    /* Hash of path */
+  FAR struct inode *node;    /* The inode found */
+  FAR struct inode *peer;    /* Node to the "left" of the inode found */
+  FAR struct inode *parent;  /* Node "above" the inode found */
+  char              path[CONFIG_FS_INODE_CACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Readers fill the cache concurrently under the shared tree lock, so the
+ * entries are protected by a spinlock as well.
+ */
+
+static spinlock_t g_inode_cache_lock;
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash and the length of a path.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash ^= (uint8_t)*ptr++;
+      hash *= 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up an absolute path in the path lookup cache.
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  bool hit = false;
+
+  hash  = inode_cache_hash(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN)
+    {
+      return false;
+    }
+
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  if (entry->node != NULL && entry->hash == hash &&
+      strcmp(entry->path, path) == 0)
+    {
+      /* The inode type may have changed since it was cached */
+
+      if (!INODE_IS_MOUNTPT(entry->node) && !INODE_IS_SOFTLINK(entry->node))
+        {
+          desc->node    = entry->node;
+          desc->peer    = entry->peer;
+          desc->parent  = entry->parent;
+          desc->path    = path + len;
+          desc->relpath = desc->path;
+          hit           = true;
+        }
+      else
+        {
+          entry->node   = NULL;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Remember the result of a successful inode_search() of path.
+ *
+ ****************************************************************************/
+
+void inode_cache_insert(FAR const char *path,
+                        FAR const struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  /* Only cache plain results: the search must have consumed the whole
+   * caller's path without a path buffer (so without the working directory
+   * or a link into a mountpoint) and found a node that is neither a
+   * mountpoint nor a soft link.
+   */
+
+  if (desc->buffer != NULL || desc->node == NULL ||
+      INODE_IS_MOUNTPT(desc->node) || INODE_IS_SOFTLINK(desc->node))
+    {
+      return;
+    }
+
+  hash  = inode_cache_hash(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN || desc->path != path + len)
+    {
+      return;
+    }
+
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  entry->hash   = hash;
+  entry->node   = desc->node;
+  entry->peer   = desc->peer;
+  entry->parent = desc->parent;
+  memcpy(entry->path, path, len + 1);
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Forget all cached lookups.
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  for (i = 0; i < CONFIG_FS_INODE_CACHE_SIZE; i++)
+    {
+      g_inode_cache[i].node = NULL;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
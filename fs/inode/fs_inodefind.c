@@ -55,7 +55,7 @@ int inode_find(FAR struct inode_search_s *desc)
    * references on the node.
    */
 
-  ret = inode_lock();
+  ret = inode_rlock();
   if (ret < 0)
     {
       return ret;
@@ -69,11 +69,13 @@ int inode_find(FAR struct inode_search_s *desc)
       FAR struct inode *node = desc->node;
       DEBUGASSERT(node != NULL);
 
-      /* Increment the reference count on the inode */
+      /* Increment the reference count on the inode.  Other readers may
+       * do the same concurrently.
+       */
 
-      node->i_crefs++;
+      __atomic_fetch_add(&node->i_crefs, 1, __ATOMIC_RELAXED);
     }
 
-  inode_unlock();
+  inode_runlock();
   return ret;
 }
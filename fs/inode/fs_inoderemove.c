@@ -77,6 +77,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      /* The node and everything below it can no longer be reached */
+
+      inode_cache_invalidate();
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -468,6 +468,9 @@ static FAR const char *_inode_getcwd(void)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_FS_INODE_CACHE
+  FAR const char *path;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -489,7 +492,14 @@ int inode_search(FAR struct inode_search_s *desc)
 
       desc->path = desc->buffer;
     }
+  else if (inode_cache_lookup(desc))
+    {
+      return OK;
+    }
 
+#ifdef CONFIG_FS_INODE_CACHE
+  path = desc->path;
+#endif
   ret = _inode_search(desc);
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
@@ -525,6 +535,11 @@ int inode_search(FAR struct inode_search_s *desc)
     }
 #endif
 
+  if (ret >= 0)
+    {
+      inode_cache_insert(path, desc);
+    }
+
   return ret;
 }
 
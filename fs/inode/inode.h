@@ -150,7 +150,7 @@ void inode_initialize(void);
  * Name: inode_lock
  *
  * Description:
- *   Get exclusive access to the in-memory inode tree (tree_sem).
+ *   Get exclusive access to the in-memory inode tree (g_inode_lock).
  *
  ****************************************************************************/
 
@@ -160,12 +160,34 @@ int inode_lock(void);
  * Name: inode_unlock
  *
  * Description:
- *   Relinquish exclusive access to the in-memory inode tree (tree_sem).
+ *   Relinquish exclusive access to the in-memory inode tree.
  *
  ****************************************************************************/
 
 void inode_unlock(void);
 
+/****************************************************************************
+ * Name: inode_rlock
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree for lookups.  Any number
+ *   of readers may hold the lock at the same time; the tree must not be
+ *   modified while holding it.
+ *
+ ****************************************************************************/
+
+int inode_rlock(void);
+
+/****************************************************************************
+ * Name: inode_runlock
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree.
+ *
+ ****************************************************************************/
+
+void inode_runlock(void);
+
 /****************************************************************************
  * Name: inode_checkflags
  *
@@ -202,6 +224,56 @@ int inode_checkflags(FAR struct inode *inode, int oflags);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up an absolute path in the path lookup cache.  On a hit, the
+ *   search descriptor is filled in as inode_search() would have done.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock (shared or exclusive)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc);
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Remember the result of a successful inode_search() of path.  Results
+ *   that depend on soft link expansion, on the working directory or that
+ *   end in a mountpoint are not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock (shared or exclusive)
+ *
+ ****************************************************************************/
+
+void inode_cache_insert(FAR const char *path,
+                        FAR const struct inode_search_s *desc);
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Forget all cached lookups.  Called whenever the shape of the inode
+ *   tree changes.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock exclusively
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void);
+#else
+#  define inode_cache_lookup(d) false
+#  define inode_cache_insert(p,d)
+#  define inode_cache_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -417,6 +489,16 @@ int foreach_inode(foreach_inode_t handler, FAR void *arg);
 
 int dir_allocate(FAR struct file *filep, FAR const char *relpath);
 
+/****************************************************************************
+ * Name: epoll_fileclose
+ *
+ * Description:
+ *   Tear down the polls that epoll has set up on a file being closed.
+ *
+ ****************************************************************************/
+
+void epoll_fileclose(FAR struct file *filep);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
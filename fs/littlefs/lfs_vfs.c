@@ -24,14 +24,19 @@
 
 #include <nuttx/config.h>
 
+#include <debug.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -39,6 +44,34 @@
 #include "littlefs/lfs.h"
 #include "littlefs/lfs_util.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Idle time garbage collection relies on lfs_fs_gc() */
+
+#ifdef CONFIG_FS_LITTLEFS_IDLE_GC
+#  if LFS_VERSION < 0x00020008
+#    error "CONFIG_FS_LITTLEFS_IDLE_GC needs littlefs 2.8.0 or later"
+#  endif
+#  define LITTLEFS_GC_DELAY MSEC2TICK(CONFIG_FS_LITTLEFS_IDLE_GC_DELAY)
+#else
+#  define littlefs_gcschedule(fs)
+#endif
+
+/* Any change of file data invalidates the readahead buffers */
+
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+#  define littlefs_invalidate(fs) ((fs)->wrgen++)
+#else
+#  define littlefs_invalidate(fs)
+#endif
+
+/* Mount options */
+
+#define LITTLEFS_FORCEFORMAT    1
+#define LITTLEFS_AUTOFORMAT     2
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -53,6 +86,12 @@ struct littlefs_file_s
 {
   struct lfs_file       file;
   int                   refs;
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  FAR uint8_t          *rabuf;   /* Readahead buffer, allocated on demand */
+  off_t                 rapos;   /* File position of rabuf[0] */
+  size_t                ralen;   /* Number of valid bytes in rabuf */
+  uint32_t              ragen;   /* wrgen of the mountpoint at fill time */
+#endif
 };
 
 /* This structure represents the overall mountpoint state. An instance of
@@ -67,6 +106,12 @@ struct littlefs_mountpt_s
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  uint32_t              wrgen;   /* Incremented when file data changes */
+#endif
+#ifdef CONFIG_FS_LITTLEFS_IDLE_GC
+  struct work_s         gcwork;  /* Idle time garbage collection */
+#endif
 };
 
 /****************************************************************************
@@ -265,6 +310,124 @@ static int littlefs_convert_oflags(int oflags)
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_gcworker
+ *
+ * Description:
+ *   Run the littlefs garbage collection (metadata compaction and lookahead
+ *   population) once the file system has been idle for a while, so that
+ *   the next write does not pay for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_LITTLEFS_IDLE_GC
+static void littlefs_gcworker(FAR void *arg)
+{
+  FAR struct littlefs_mountpt_s *fs = arg;
+  int ret;
+
+  /* The file system is not idle if somebody holds the lock */
+
+  if (nxmutex_trylock(&fs->lock) < 0)
+    {
+      work_queue(LPWORK, &fs->gcwork, littlefs_gcworker, fs,
+                 LITTLEFS_GC_DELAY);
+      return;
+    }
+
+  ret = littlefs_convert_result(lfs_fs_gc(&fs->lfs));
+  if (ret < 0)
+    {
+      fwarn("WARNING: lfs_fs_gc failed: %d\n", ret);
+    }
+
+  nxmutex_unlock(&fs->lock);
+}
+
+/****************************************************************************
+ * Name: littlefs_gcschedule
+ *
+ * Description:
+ *   (Re)start the idle timer after a modification.  Called with the
+ *   mountpoint locked.
+ *
+ ****************************************************************************/
+
+static void littlefs_gcschedule(FAR struct littlefs_mountpt_s *fs)
+{
+  work_queue(LPWORK, &fs->gcwork, littlefs_gcworker, fs,
+             LITTLEFS_GC_DELAY);
+}
+#endif
+
+/****************************************************************************
+ * Name: littlefs_readahead
+ *
+ * Description:
+ *   Read from the per-file readahead buffer, refilling it from the file
+ *   as needed.  Called with the mountpoint locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+static ssize_t littlefs_readahead(FAR struct littlefs_mountpt_s *fs,
+                                  FAR struct littlefs_file_s *priv,
+                                  FAR struct file *filep,
+                                  FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret;
+  size_t ncopy;
+
+  while (buflen > 0)
+    {
+      /* Refill the buffer if f_pos is not inside of it */
+
+      if (priv->ragen != fs->wrgen || filep->f_pos < priv->rapos ||
+          filep->f_pos >= priv->rapos + priv->ralen)
+        {
+          priv->ralen = 0;
+          if (filep->f_pos != priv->file.pos)
+            {
+              ret = littlefs_convert_result(
+                      lfs_file_seek(&fs->lfs, &priv->file, filep->f_pos,
+                                    LFS_SEEK_SET));
+              if (ret < 0)
+                {
+                  return nread > 0 ? nread : ret;
+                }
+            }
+
+          ret = littlefs_convert_result(
+                  lfs_file_read(&fs->lfs, &priv->file, priv->rabuf,
+                                CONFIG_FS_LITTLEFS_READAHEAD));
+          if (ret <= 0)
+            {
+              return nread > 0 ? nread : ret;
+            }
+
+          priv->rapos = filep->f_pos;
+          priv->ralen = ret;
+          priv->ragen = fs->wrgen;
+        }
+
+      ncopy = priv->rapos + priv->ralen - filep->f_pos;
+      if (ncopy > buflen)
+        {
+          ncopy = buflen;
+        }
+
+      memcpy(buffer, &priv->rabuf[filep->f_pos - priv->rapos], ncopy);
+      filep->f_pos += ncopy;
+      buffer       += ncopy;
+      buflen       -= ncopy;
+      nread        += ncopy;
+    }
+
+  return nread;
+}
+#endif
+
 /****************************************************************************
  * Name: littlefs_open
  ****************************************************************************/
@@ -286,7 +449,7 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Allocate memory for the open file */
 
-  priv = kmm_malloc(sizeof(*priv));
+  priv = kmm_zalloc(sizeof(*priv));
   if (priv == NULL)
     {
       return -ENOMEM;
@@ -337,6 +500,12 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
    */
 
   lfs_file_sync(&fs->lfs, &priv->file);
+  if (oflags & LFS_O_TRUNC)
+    {
+      littlefs_invalidate(fs);
+      littlefs_gcschedule(fs);
+    }
+
   nxmutex_unlock(&fs->lock);
 
   /* Attach the private date to the struct file instance */
@@ -381,11 +550,15 @@ static int littlefs_close(FAR struct file *filep)
   if (--priv->refs <= 0)
     {
       ret = littlefs_convert_result(lfs_file_close(&fs->lfs, &priv->file));
+      littlefs_gcschedule(fs);
     }
 
   nxmutex_unlock(&fs->lock);
   if (priv->refs <= 0)
     {
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+      kmm_free(priv->rabuf);
+#endif
       kmm_free(priv);
     }
 
@@ -418,6 +591,25 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+#if CONFIG_FS_LITTLEFS_READAHEAD > 0
+  /* Serve small reads from the readahead buffer */
+
+  if (buflen < CONFIG_FS_LITTLEFS_READAHEAD)
+    {
+      if (priv->rabuf == NULL)
+        {
+          priv->rabuf = kmm_malloc(CONFIG_FS_LITTLEFS_READAHEAD);
+          priv->ralen = 0;
+        }
+
+      if (priv->rabuf != NULL)
+        {
+          ret = littlefs_readahead(fs, priv, filep, buffer, buflen);
+          goto out;
+        }
+    }
+#endif
+
   if (filep->f_pos != priv->file.pos)
     {
       ret = littlefs_convert_result(lfs_file_seek(&fs->lfs, &priv->file,
@@ -485,6 +677,9 @@ static ssize_t littlefs_write(FAR struct file *filep, const char *buffer,
       filep->f_pos += ret;
     }
 
+  littlefs_invalidate(fs);
+  littlefs_gcschedule(fs);
+
 out:
   nxmutex_unlock(&fs->lock);
   return ret;
@@ -507,7 +702,9 @@ static off_t littlefs_seek(FAR struct file *filep, off_t offset, int whence)
   inode = filep->f_inode;
   fs    = inode->i_private;
 
-  /* Call LFS to perform the seek */
+  /* Call LFS to perform the seek.  The LFS file position may differ from
+   * f_pos (shared or read ahead files), so seek relative to f_pos.
+   */
 
   ret = nxmutex_lock(&fs->lock);
   if (ret < 0)
@@ -515,6 +712,12 @@ static off_t littlefs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+  if (whence == SEEK_CUR)
+    {
+      offset += filep->f_pos;
+      whence  = SEEK_SET;
+    }
+
   ret = littlefs_convert_result(lfs_file_seek(&fs->lfs, &priv->file,
                                               offset, whence));
   if (ret >= 0)
@@ -587,6 +790,7 @@ static int littlefs_sync(FAR struct file *filep)
     }
 
   ret = littlefs_convert_result(lfs_file_sync(&fs->lfs, &priv->file));
+  littlefs_gcschedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -704,6 +908,8 @@ static int littlefs_truncate(FAR struct file *filep, off_t length)
 
   ret = littlefs_convert_result(lfs_file_truncate(&fs->lfs, &priv->file,
                                                   length));
+  littlefs_invalidate(fs);
+  littlefs_gcschedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -997,6 +1203,99 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parse_options
+ *
+ * Description:
+ *   Parse the comma separated mount options:
+ *
+ *     forceformat        - Format the device before mounting
+ *     autoformat         - Format the device if it cannot be mounted
+ *     read_size=<n>      - Minimum read size in bytes
+ *     prog_size=<n>      - Minimum program size in bytes
+ *     cache_size=<n>     - Size of the read, program and file caches
+ *     lookahead_size=<n> - Size of the block allocator lookahead buffer
+ *
+ *   The sizes default to values derived from the device geometry.
+ *
+ ****************************************************************************/
+
+static int littlefs_parse_options(FAR struct littlefs_mountpt_s *fs,
+                                  FAR const char *data, FAR int *format)
+{
+  FAR struct lfs_config *cfg = &fs->cfg;
+  FAR char *options;
+  FAR char *saveptr;
+  FAR char *ptr;
+  int ret = OK;
+
+  *format = 0;
+  if (data == NULL)
+    {
+      return OK;
+    }
+
+  options = strdup(data);
+  if (options == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ptr = strtok_r(options, ",", &saveptr);
+  while (ptr != NULL)
+    {
+      if (strcmp(ptr, "forceformat") == 0)
+        {
+          *format = LITTLEFS_FORCEFORMAT;
+        }
+      else if (strcmp(ptr, "autoformat") == 0)
+        {
+          *format = LITTLEFS_AUTOFORMAT;
+        }
+      else if (strncmp(ptr, "read_size=", 10) == 0)
+        {
+          cfg->read_size = strtoul(&ptr[10], NULL, 0);
+        }
+      else if (strncmp(ptr, "prog_size=", 10) == 0)
+        {
+          cfg->prog_size = strtoul(&ptr[10], NULL, 0);
+        }
+      else if (strncmp(ptr, "cache_size=", 11) == 0)
+        {
+          cfg->cache_size = strtoul(&ptr[11], NULL, 0);
+        }
+      else if (strncmp(ptr, "lookahead_size=", 15) == 0)
+        {
+          cfg->lookahead_size = strtoul(&ptr[15], NULL, 0);
+        }
+
+      ptr = strtok_r(NULL, ",", &saveptr);
+    }
+
+  kmm_free(options);
+
+  /* The device can only transfer whole blocks and littlefs requires the
+   * cache to be a multiple of the read and program sizes and a factor of
+   * the erase block size.
+   */
+
+  if (cfg->read_size == 0 || cfg->read_size % fs->geo.blocksize != 0 ||
+      cfg->prog_size == 0 || cfg->prog_size % fs->geo.blocksize != 0 ||
+      cfg->cache_size == 0 || cfg->cache_size % cfg->read_size != 0 ||
+      cfg->cache_size % cfg->prog_size != 0 ||
+      cfg->block_size % cfg->cache_size != 0 ||
+      cfg->lookahead_size == 0 || cfg->lookahead_size % 8 != 0)
+    {
+      ferr("ERROR: Bad littlefs geometry read %" PRIu32 " prog %" PRIu32
+           " cache %" PRIu32 " lookahead %" PRIu32 "\n",
+           cfg->read_size, cfg->prog_size, cfg->cache_size,
+           cfg->lookahead_size);
+      ret = -EINVAL;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -1005,6 +1304,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  int format;
   int ret;
 
   /* Open the block driver */
@@ -1097,13 +1397,21 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.lookahead_size = lfs_min(lfs_alignup(fs->cfg.block_count, 64) / 8,
                                    fs->cfg.read_size);
 
+  /* Mount options override the default sizes */
+
+  ret = littlefs_parse_options(fs, data, &format);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if (format == LITTLEFS_FORCEFORMAT)
     {
       ret = littlefs_convert_result(lfs_format(&fs->lfs, &fs->cfg));
       if (ret < 0)
@@ -1117,7 +1425,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != -EFAULT || !data || strcmp(data, "autoformat"))
+      if (ret != -EFAULT || format != LITTLEFS_AUTOFORMAT)
         {
           goto errout_with_fs;
         }
@@ -1175,6 +1483,10 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
       return ret;
     }
 
+#ifdef CONFIG_FS_LITTLEFS_IDLE_GC
+  work_cancel(LPWORK, &fs->gcwork);
+#endif
+
   ret = littlefs_convert_result(lfs_unmount(&fs->lfs));
   nxmutex_unlock(&fs->lock);
 
@@ -1278,6 +1590,7 @@ static int littlefs_unlink(FAR struct inode *mountpt,
     }
 
   ret = littlefs_convert_result(lfs_remove(&fs->lfs, relpath));
+  littlefs_gcschedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -1309,6 +1622,7 @@ static int littlefs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
     }
 
   ret = lfs_mkdir(&fs->lfs, relpath);
+  littlefs_gcschedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
@@ -1370,6 +1684,7 @@ static int littlefs_rename(FAR struct inode *mountpt,
 
   ret = littlefs_convert_result(lfs_rename(&fs->lfs, oldrelpath,
                                            newrelpath));
+  littlefs_gcschedule(fs);
   nxmutex_unlock(&fs->lock);
 
   return ret;
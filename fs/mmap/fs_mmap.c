@@ -69,10 +69,10 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
     }
 
 #ifndef CONFIG_FS_RAMMAP
-  if ((flags & MAP_PRIVATE) != 0)
+  if ((flags & MAP_PRIVATE) != 0 && (prot & PROT_WRITE) != 0)
     {
-      ferr("ERROR: MAP_PRIVATE is not supported without file mapping"
-           "emulation\n");
+      ferr("ERROR: Writable MAP_PRIVATE is not supported without file "
+           "mapping emulation\n");
       return -ENOSYS;
     }
 #endif /* CONFIG_FS_RAMMAP */
@@ -124,7 +124,12 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
       return OK;
     }
 
-  if ((flags & MAP_PRIVATE) != 0)
+  /* A private mapping that can be written needs its own copy.  A read-only
+   * private mapping cannot be told apart from a shared one and is mapped
+   * directly if the file system allows.
+   */
+
+  if ((flags & MAP_PRIVATE) != 0 && (prot & PROT_WRITE) != 0)
     {
 #ifdef CONFIG_FS_RAMMAP
       /* Allocate memory and copy the file into memory.  We would, of course,
@@ -200,15 +205,21 @@ int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
  *     a. The filesystem supports the FIOC_MMAP ioctl command.  Any file
  *        system that maps files contiguously on the media should support
  *        this ioctl. (vs. file system that scatter files over the media
- *        in non-contiguous sectors).  As of this writing, ROMFS is the
- *        only file system that meets this requirement.
- *     b. The underlying block driver supports the BIOC_XIPBASE ioctl
- *        command that maps the underlying media to a randomly accessible
- *        address. At  present, only the RAM/ROM disk driver does this.
+ *        in non-contiguous sectors).  ROMFS does so on media supporting
+ *        BIOC_XIPBASE (below), TMPFS for any file and CROMFS for files
+ *        stored uncompressed in a single block.
+ *     b. The underlying block or MTD driver supports the BIOC_XIPBASE
+ *        ioctl command that maps the underlying media to a randomly
+ *        accessible address: the RAM/ROM disk, RAM MTD, program memory
+ *        MTD and MTD/block partitions of these.
+ *
+ *     Shared mappings and read-only private mappings use this direct
+ *     mapping.
  *
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
- *      into RAM.
+ *      into RAM.  This is used for writable private mappings and as the
+ *      fallback when the file cannot be mapped directly.
  *
  * Input Parameters:
  *   start   A hint at where to map the memory -- ignored.  The address
@@ -72,13 +72,14 @@ static int file_munmap_(FAR void *start, size_t length, bool kernel)
         }
     }
 
-  /* Did we find the region */
+  /* Did we find the region?  If not, this is a direct mapping of the
+   * file (FIOC_MMAP) and there is nothing to release.
+   */
 
   if (!curr)
     {
-      ferr("ERROR: Region not found\n");
-      ret = -EINVAL;
-      goto errout_with_lock;
+      nxmutex_unlock(&g_rammaps.lock);
+      return OK;
     }
 
   /* Get the offset from the beginning of the region and the actual number
@@ -199,11 +200,11 @@ int file_munmap(FAR void *start, size_t length)
  *     a. The filesystem supports the FIOC_MMAP ioctl command.  Any file
  *        system that maps files contiguously on the media should support
  *        this ioctl. (vs. file system that scatter files over the media
- *        in non-contiguous sectors).  As of this writing, ROMFS is the
- *        only file system that meets this requirement.
- *     b. The underlying block driver supports the BIOC_XIPBASE ioctl
- *        command that maps the underlying media to a randomly accessible
- *        address. At  present, only the RAM/ROM disk driver does this.
+ *        in non-contiguous sectors).  ROMFS, TMPFS and CROMFS (for files
+ *        stored uncompressed) support it.
+ *     b. The underlying block or MTD driver supports the BIOC_XIPBASE
+ *        ioctl command that maps the underlying media to a randomly
+ *        accessible address.
  *
  *     munmap() is still not required in this first case.  In this first
  *     The mapped address is a static address in the MCUs address space
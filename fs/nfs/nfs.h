@@ -59,10 +59,13 @@
 #define NFS_MAXTIMEO       255            /* Max timeout to backoff to */
 #define NFS_MAXREXMIT      100            /* Stop counting after this many */
 #define NFS_RETRANS        10             /* Num of retrans for soft mounts */
-#define NFS_WSIZE          8192           /* Def. write data size <= 8192 */
-#define NFS_RSIZE          8192           /* Def. read data size <= 8192 */
 #define NFS_READDIRSIZE    1024           /* Def. readdir size */
 
+/* Default write and read data sizes */
+
+#define NFS_WSIZE          CONFIG_NFS_WSIZE
+#define NFS_RSIZE          CONFIG_NFS_RSIZE
+
 /* Ideally, NFS_DIRBLKSIZ should be bigger, but I've seen servers with
  * broken NFS/ethernet drivers that won't work with anything bigger (Linux..)
  */
@@ -125,6 +128,17 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
               FAR struct nfs_fattr *attributes, FAR char *filename);
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
+#if CONFIG_NFS_ATTRCACHE_SIZE > 0
+EXTERN void nfs_attrcache_remove(FAR struct nfsmount *nmp,
+              FAR const char *relpath);
+EXTERN void nfs_attrcache_removefh(FAR struct nfsmount *nmp,
+              FAR const nfsfh_t *fh, uint8_t fhsize);
+EXTERN void nfs_attrcache_flush(FAR struct nfsmount *nmp);
+#else
+#  define nfs_attrcache_remove(nmp,relpath)
+#  define nfs_attrcache_removefh(nmp,fh,fhsize)
+#  define nfs_attrcache_flush(nmp)
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -49,6 +49,7 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 
 #include "rpc.h"
@@ -61,6 +62,19 @@
  * Public Types
  ****************************************************************************/
 
+/* The file handle and the attributes of a recently looked up path */
+
+#if CONFIG_NFS_ATTRCACHE_SIZE > 0
+struct nfs_attrcache_s
+{
+  FAR char                 *ac_relpath;       /* Cached path or NULL */
+  clock_t                   ac_time;          /* Time of the lookup */
+  struct file_handle        ac_fhandle;       /* File handle of the path */
+  struct nfs_fattr          ac_obj;           /* Attributes of the path */
+  struct nfs_fattr          ac_dir;           /* Attributes of the parent */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -79,6 +93,9 @@ struct nfsmount
   uint16_t                  nm_wsize;         /* Max size of write RPC */
   uint16_t                  nm_readdirsize;   /* Size of a readdir RPC */
   uint16_t                  nm_buflen;        /* Size of I/O buffer */
+#if CONFIG_NFS_ATTRCACHE_SIZE > 0
+  struct nfs_attrcache_s    nm_attrcache[CONFIG_NFS_ATTRCACHE_SIZE];
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.
    * NOTE that for the case of the write call message, it is the reply
@@ -70,6 +70,12 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_FILE_BUFFER
+  FAR char           *n_buffer;     /* Read ahead or written data */
+  off_t               n_bufpos;     /* File offset of n_buffer */
+  uint32_t            n_buflen;     /* Number of valid bytes in n_buffer */
+  bool                n_bufdirty;   /* n_buffer holds data to be written */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
@@ -36,6 +36,10 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/crc32.h>
+#include <nuttx/kmalloc.h>
+
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -43,10 +47,121 @@
 #include "nfs_node.h"
 #include "xdr_subs.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NFS_NATTRCACHE     CONFIG_NFS_ATTRCACHE_SIZE
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#if NFS_NATTRCACHE > 0
+/****************************************************************************
+ * Name: nfs_attrcache_entry
+ *
+ * Description:
+ *   Return the entry of the attribute cache that a path maps to.
+ *
+ ****************************************************************************/
+
+static FAR struct nfs_attrcache_s *
+nfs_attrcache_entry(FAR struct nfsmount *nmp, FAR const char *relpath)
+{
+  return &nmp->nm_attrcache[crc32((FAR const uint8_t *)relpath,
+                                  strlen(relpath)) % NFS_NATTRCACHE];
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_find
+ *
+ * Description:
+ *   Return the cached file handle and attributes of a path, unless they
+ *   are older than CONFIG_NFS_ATTRCACHE_TIMEOUT.
+ *
+ * Returned Value:
+ *   Zero on a hit; -ENOENT if the path is not cached.
+ *
+ ****************************************************************************/
+
+static int nfs_attrcache_find(FAR struct nfsmount *nmp,
+                              FAR const char *relpath,
+                              FAR struct file_handle *fhandle,
+                              FAR struct nfs_fattr *obj_attributes,
+                              FAR struct nfs_fattr *dir_attributes)
+{
+  FAR struct nfs_attrcache_s *ac = nfs_attrcache_entry(nmp, relpath);
+
+  if (ac->ac_relpath == NULL || strcmp(ac->ac_relpath, relpath) != 0)
+    {
+      return -ENOENT;
+    }
+
+  if (clock_systime_ticks() - ac->ac_time >=
+      SEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT))
+    {
+      kmm_free(ac->ac_relpath);
+      ac->ac_relpath = NULL;
+      return -ENOENT;
+    }
+
+  fhandle->length = ac->ac_fhandle.length;
+  memcpy(&fhandle->handle, &ac->ac_fhandle.handle, fhandle->length);
+
+  if (obj_attributes)
+    {
+      memcpy(obj_attributes, &ac->ac_obj, sizeof(struct nfs_fattr));
+    }
+
+  if (dir_attributes)
+    {
+      memcpy(dir_attributes, &ac->ac_dir, sizeof(struct nfs_fattr));
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_add
+ *
+ * Description:
+ *   Cache the file handle and attributes of a looked up path, replacing
+ *   the path that shares its entry.  Failures to allocate are not errors:
+ *   The path is then just not cached.
+ *
+ ****************************************************************************/
+
+static void nfs_attrcache_add(FAR struct nfsmount *nmp,
+                              FAR const char *relpath,
+                              FAR const struct file_handle *fhandle,
+                              FAR const struct nfs_fattr *obj_attributes,
+                              FAR const struct nfs_fattr *dir_attributes)
+{
+  FAR struct nfs_attrcache_s *ac = nfs_attrcache_entry(nmp, relpath);
+
+  if (ac->ac_relpath == NULL || strcmp(ac->ac_relpath, relpath) != 0)
+    {
+      if (ac->ac_relpath != NULL)
+        {
+          kmm_free(ac->ac_relpath);
+        }
+
+      ac->ac_relpath = strdup(relpath);
+      if (ac->ac_relpath == NULL)
+        {
+          return;
+        }
+    }
+
+  ac->ac_time = clock_systime_ticks();
+  ac->ac_fhandle.length = fhandle->length;
+  memcpy(&ac->ac_fhandle.handle, &fhandle->handle, fhandle->length);
+  memcpy(&ac->ac_obj, obj_attributes, sizeof(struct nfs_fattr));
+  memcpy(&ac->ac_dir, dir_attributes, sizeof(struct nfs_fattr));
+}
+#endif
+
 static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
                                   FAR char *terminator)
 {
@@ -322,6 +437,8 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
   char            terminator;
   uint32_t         tmp;
   int             error;
+  struct nfs_fattr obj;
+  struct nfs_fattr dir;
 
   /* Start with the file handle of the root directory.  */
 
@@ -349,6 +466,23 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
       return OK;
     }
 
+#if NFS_NATTRCACHE > 0
+  /* Has the path been looked up recently? */
+
+  if (nfs_attrcache_find(nmp, relpath, fhandle, obj_attributes,
+                         dir_attributes) == OK)
+    {
+      return OK;
+    }
+#endif
+
+  /* The type of the intermediate directories is checked below, even if the
+   * caller does not need the attributes.
+   */
+
+  obj_attributes = obj_attributes ? obj_attributes : &obj;
+  dir_attributes = dir_attributes ? dir_attributes : &dir;
+
   /* This is not the root directory. Loop until the directory entry
    * corresponding to the path is found.
    */
@@ -367,6 +501,18 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
           return error;
         }
 
+#if NFS_NATTRCACHE > 0
+      /* Zeroed attributes of the path are those that the server did not
+       * return, which are not cached.
+       */
+
+      if (!terminator)
+        {
+          memset(obj_attributes, 0, sizeof(struct nfs_fattr));
+          memset(dir_attributes, 0, sizeof(struct nfs_fattr));
+        }
+#endif
+
       /* Look-up this path segment */
 
       error = nfs_lookup(nmp, buffer, fhandle, obj_attributes,
@@ -390,6 +536,14 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
            * dir_attributes.
            */
 
+#if NFS_NATTRCACHE > 0
+          if (obj_attributes->fa_type != 0 && dir_attributes->fa_type != 0)
+            {
+              nfs_attrcache_add(nmp, relpath, fhandle, obj_attributes,
+                                dir_attributes);
+            }
+#endif
+
           return OK;
         }
 
@@ -526,3 +680,84 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
 }
+
+#if NFS_NATTRCACHE > 0
+/****************************************************************************
+ * Name: nfs_attrcache_remove
+ *
+ * Description:
+ *   Forget the cached attributes of a path, so that the next lookup goes to
+ *   the server.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_remove(FAR struct nfsmount *nmp, FAR const char *relpath)
+{
+  FAR struct nfs_attrcache_s *ac = nfs_attrcache_entry(nmp, relpath);
+
+  if (ac->ac_relpath != NULL && strcmp(ac->ac_relpath, relpath) == 0)
+    {
+      kmm_free(ac->ac_relpath);
+      ac->ac_relpath = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_removefh
+ *
+ * Description:
+ *   Forget the cached attributes of the paths of a file handle, e.g. after
+ *   the file is written.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_removefh(FAR struct nfsmount *nmp,
+                            FAR const nfsfh_t *fh, uint8_t fhsize)
+{
+  FAR struct nfs_attrcache_s *ac;
+  int i;
+
+  for (i = 0; i < NFS_NATTRCACHE; i++)
+    {
+      ac = &nmp->nm_attrcache[i];
+      if (ac->ac_relpath != NULL && ac->ac_fhandle.length == fhsize &&
+          memcmp(&ac->ac_fhandle.handle, fh, fhsize) == 0)
+        {
+          kmm_free(ac->ac_relpath);
+          ac->ac_relpath = NULL;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_flush
+ *
+ * Description:
+ *   Forget all the cached attributes, e.g. after a change of the name
+ *   space, which also changes the attributes of the directories.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_flush(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < NFS_NATTRCACHE; i++)
+    {
+      if (nmp->nm_attrcache[i].ac_relpath != NULL)
+        {
+          kmm_free(nmp->nm_attrcache[i].ac_relpath);
+          nmp->nm_attrcache[i].ac_relpath = NULL;
+        }
+    }
+}
+#endif
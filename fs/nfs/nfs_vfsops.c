@@ -136,6 +136,16 @@ static int     nfs_fileopen(FAR struct nfsmount *nmp,
                    FAR struct nfsnode *np, FAR const char *relpath,
                    int oflags, mode_t mode);
 
+static ssize_t nfs_readrpc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR char *buffer, size_t buflen, FAR bool *eof);
+static ssize_t nfs_writerpc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR const char *buffer, size_t buflen);
+#ifdef CONFIG_NFS_FILE_BUFFER
+static int     nfs_flushbuffer(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+#endif
 static int     nfs_open(FAR struct file *filep, FAR const char *relpath,
                    int oflags, mode_t mode);
 static int     nfs_close(FAR struct file *filep);
@@ -143,6 +153,7 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
                    size_t buflen);
+static int     nfs_sync(FAR struct file *filep);
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_fsinfo(FAR struct nfsmount *nmp);
 static int     nfs_fstat(FAR const struct file *filep, FAR struct stat *buf);
@@ -199,7 +210,7 @@ const struct mountpt_operations nfs_operations =
   NULL,                         /* seek */
   NULL,                         /* ioctl */
 
-  NULL,                         /* sync */
+  nfs_sync,                     /* sync */
   nfs_dup,                      /* dup */
   nfs_fstat,                    /* fstat */
   nfs_fchstat,                  /* fchstat */
@@ -334,6 +345,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
   ret = nfs_request(nmp, NFSPROC_CREATE,
                     &nmp->nm_msgbuffer.create, reqlen,
                     nmp->nm_iobuffer, nmp->nm_buflen);
+  nfs_attrcache_flush(nmp);
 
   /* Check for success */
 
@@ -530,6 +542,7 @@ static int nfs_filechstat(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
       nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
     }
 
+  nfs_attrcache_removefh(nmp, &np->n_fhandle, np->n_fhsize);
   return OK;
 }
 
@@ -633,6 +646,333 @@ static int nfs_fileopen(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_readrpc
+ *
+ * Description:
+ *   Read from a file with one READ RPC, which may return less than buflen
+ *   bytes.
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes read on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_readrpc(FAR struct nfsmount *nmp,
+                           FAR struct nfsnode *np, off_t offset,
+                           FAR char *buffer, size_t buflen, FAR bool *eof)
+{
+  ssize_t       readsize;
+  ssize_t       tmp;
+  size_t        reqlen;
+  FAR uint32_t *ptr;
+  int           ret;
+
+  /* Make sure that the attempted read size does not exceed the RPC
+   * maximum
+   */
+
+  readsize = buflen;
+  if (readsize > nmp->nm_rsize)
+    {
+      readsize = nmp->nm_rsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO buffer
+   * size
+   */
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(readsize);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the read */
+
+  finfo("Reading %zu bytes\n", readsize);
+  nfs_statistics(NFSPROC_READ);
+  ret = nfs_request(nmp, NFSPROC_READ,
+                    &nmp->nm_msgbuffer.read, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The read was successful.  Get a pointer to the beginning of the NFS
+   * response data.
+   */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
+
+  ptr++;
+
+  /* Next comes an EOF indication */
+
+  *eof = *ptr++ != 0;
+
+  /* Then the length of the read data followed by the read data itself */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp > readsize)
+    {
+      return -EIO;
+    }
+
+  /* Copy the read data into the user buffer */
+
+  memcpy(buffer, ptr, tmp);
+  return tmp;
+}
+
+/****************************************************************************
+ * Name: nfs_writerpc
+ *
+ * Description:
+ *   Write to a file with one WRITE RPC, which may write less than buflen
+ *   bytes.
+ *
+ * Returned Value:
+ *   The (positive) number of bytes written on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_writerpc(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, off_t offset,
+                            FAR const char *buffer, size_t buflen)
+{
+  ssize_t       writesize;
+  ssize_t       bufsize;
+  size_t        reqlen;
+  FAR uint32_t *ptr;
+  uint32_t      tmp;
+  int           ret;
+
+  /* Make sure that the attempted write size does not exceed the RPC
+   * maximum.
+   */
+
+  writesize = buflen;
+  if (writesize > nmp->nm_wsize)
+    {
+      writesize = nmp->nm_wsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO
+   * buffer size.
+   */
+
+  bufsize = SIZEOF_rpc_call_write(writesize);
+  if (bufsize > nmp->nm_buflen)
+    {
+      writesize -= (bufsize - nmp->nm_buflen);
+    }
+
+  /* Initialize the request.  Here we need an offset pointer to the write
+   * arguments, skipping over the RPC header.  Write is unique among the
+   * RPC calls in that the entry RPC calls message lies in the I/O buffer
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+              nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(writesize);
+  *ptr++  = txdr_unsigned(NFSV3WRITE_FILESYNC);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(writesize);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, buffer, writesize);
+  reqlen += uint32_alignup(writesize);
+
+  /* Perform the write */
+
+  nfs_statistics(NFSPROC_WRITE);
+  ret = nfs_request(nmp, NFSPROC_WRITE,
+                    nmp->nm_iobuffer, reqlen,
+                    &nmp->nm_msgbuffer.write,
+                    sizeof(struct rpc_reply_write));
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The size and times of the file changed */
+
+  nfs_attrcache_removefh(nmp, &np->n_fhandle, np->n_fhsize);
+
+  /* Get a pointer to the WRITE reply data */
+
+  ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  if (tmp < 1 || tmp > writesize)
+    {
+      return -EIO;
+    }
+
+  return tmp;
+}
+
+#ifdef CONFIG_NFS_FILE_BUFFER
+/****************************************************************************
+ * Name: nfs_allocbuffer
+ *
+ * Description:
+ *   Allocate the read ahead and write behind buffer of a file, once.
+ *
+ * Returned Value:
+ *   true if the file has a buffer.
+ *
+ ****************************************************************************/
+
+static bool nfs_allocbuffer(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np)
+{
+  if (np->n_buffer == NULL)
+    {
+      np->n_buffer = kmm_malloc(MAX(nmp->nm_rsize, nmp->nm_wsize));
+    }
+
+  return np->n_buffer != NULL;
+}
+
+/****************************************************************************
+ * Name: nfs_flushbuffer
+ *
+ * Description:
+ *   Write the data held back in the buffer of a file to the server.  The
+ *   buffer then holds clean data for the reads.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_flushbuffer(FAR struct nfsmount *nmp,
+                           FAR struct nfsnode *np)
+{
+  ssize_t nwritten;
+  size_t offset;
+
+  if (!np->n_bufdirty)
+    {
+      return OK;
+    }
+
+  for (offset = 0; offset < np->n_buflen; offset += nwritten)
+    {
+      nwritten = nfs_writerpc(nmp, np, np->n_bufpos + offset,
+                              np->n_buffer + offset,
+                              np->n_buflen - offset);
+      if (nwritten < 0)
+        {
+          /* The data is lost:  Do not report the failure again */
+
+          np->n_buflen   = 0;
+          np->n_bufdirty = false;
+          return (int)nwritten;
+        }
+    }
+
+  np->n_bufdirty = false;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_open
  *
@@ -679,8 +1019,12 @@ static int nfs_open(FAR struct file *filep, FAR const char *relpath,
       return ret;
     }
 
-  /* Try to open an existing file at that path */
+  /* Try to open an existing file at that path.  Its attributes are fetched
+   * from the server, so that the changes made by other clients before the
+   * open are seen.
+   */
 
+  nfs_attrcache_remove(nmp, relpath);
   ret = nfs_fileopen(nmp, np, relpath, oflags, mode);
   if (ret != OK)
     {
@@ -770,6 +1114,9 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+#ifdef CONFIG_NFS_FILE_BUFFER
+  int flushret;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -810,6 +1157,14 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+#ifdef CONFIG_NFS_FILE_BUFFER
+      /* Write back the data held back.  A failure is reported, but the file
+       * is closed anyway.
+       */
+
+      flushret = nfs_flushbuffer(nmp, np);
+#endif
+
       /* Assume file structure won't be found. This should never happen. */
 
       ret = -EINVAL;
@@ -839,8 +1194,17 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
-              kmm_free(np);
+#ifdef CONFIG_NFS_FILE_BUFFER
+              if (np->n_buffer != NULL)
+                {
+                  kmm_free(np->n_buffer);
+                }
+
+              ret = flushret;
+#else
               ret = OK;
+#endif
+              kmm_free(np);
               break;
             }
         }
@@ -868,8 +1232,7 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t                    readsize;
   ssize_t                    tmp;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  bool                       eof;
   int                        ret = 0;
 
   finfo("Read %zu bytes from offset %jd\n",
@@ -892,6 +1255,16 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
       return (ssize_t)ret;
     }
 
+#ifdef CONFIG_NFS_FILE_BUFFER
+  /* The data held back must be on the server before it is read back */
+
+  ret = nfs_flushbuffer(nmp, np);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
@@ -907,102 +1280,55 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
-
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
+#ifdef CONFIG_NFS_FILE_BUFFER
+      /* Copy what the buffer holds at the file position */
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
+      if (np->n_buflen > 0 && filep->f_pos >= np->n_bufpos &&
+          filep->f_pos < np->n_bufpos + np->n_buflen)
         {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+          readsize = np->n_bufpos + np->n_buflen - filep->f_pos;
+          if (readsize > buflen - bytesread)
+            {
+              readsize = buflen - bytesread;
+            }
 
-      /* Perform the read */
+          memcpy(buffer, np->n_buffer + (filep->f_pos - np->n_bufpos),
+                 readsize);
 
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
+          filep->f_pos += readsize;
+          bytesread    += readsize;
+          buffer       += readsize;
+          continue;
         }
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
+      /* Reads smaller than an RPC fill the buffer instead of the user
+       * buffer, so that the next reads need no RPC.
        */
 
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (buflen - bytesread < nmp->nm_rsize && nfs_allocbuffer(nmp, np))
         {
-          /* Yes.. Update the cached file status in the file structure. */
+          readsize = nfs_readrpc(nmp, np, filep->f_pos, np->n_buffer,
+                                 nmp->nm_rsize, &eof);
+          if (readsize <= 0)
+            {
+              np->n_buflen = 0;
+              ret = readsize;
+              break;
+            }
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          np->n_bufpos = filep->f_pos;
+          np->n_buflen = readsize;
+          continue;
         }
+#endif
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
+      readsize = nfs_readrpc(nmp, np, filep->f_pos, buffer,
+                             buflen - bytesread, &eof);
+      if (readsize < 0)
+        {
+          ret = readsize;
+          break;
+        }
 
       /* Update the read state data */
 
@@ -1012,13 +1338,15 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
       /* Check if we hit the end of file */
 
-      if (tmp != 0)
+      if (eof || readsize == 0)
         {
           break;
         }
     }
 
+#ifdef CONFIG_NFS_FILE_BUFFER
 errout_with_lock:
+#endif
   nxmutex_unlock(&nmp->nm_lock);
   return bytesread > 0 ? bytesread : ret;
 }
@@ -1038,13 +1366,7 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct nfsmount *nmp;
   FAR struct nfsnode  *np;
   ssize_t              writesize;
-  ssize_t              bufsize;
   ssize_t              byteswritten = 0;
-  size_t               reqlen;
-  FAR uint32_t        *ptr;
-  uint32_t             tmp;
-  int                  commit = 0;
-  int                  committed = NFSV3WRITE_FILESYNC;
   int                  ret;
 
   finfo("Write %zu bytes to offset %jd\n",
@@ -1075,141 +1397,123 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_lock;
     }
 
-  /* Now loop until we send the entire user buffer */
+#ifdef CONFIG_NFS_FILE_BUFFER
+  /* Writes smaller than an RPC are held back in the buffer, as long as
+   * they follow each other.
+   */
 
-  for (byteswritten = 0; byteswritten < buflen; )
+  if (buflen < nmp->nm_wsize)
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
-       */
-
-      writesize = buflen - byteswritten;
-      if (writesize > nmp->nm_wsize)
+      if (np->n_bufdirty &&
+          (filep->f_pos != np->n_bufpos + np->n_buflen ||
+           np->n_buflen + buflen > nmp->nm_wsize))
         {
-          writesize = nmp->nm_wsize;
+          ret = nfs_flushbuffer(nmp, np);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
         }
 
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
-
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+      if (nfs_allocbuffer(nmp, np))
         {
-          writesize -= (bufsize - nmp->nm_buflen);
-        }
-
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls message lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
+          if (!np->n_bufdirty)
+            {
+              /* Drop the data read ahead */
 
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
+              np->n_bufpos   = filep->f_pos;
+              np->n_buflen   = 0;
+              np->n_bufdirty = true;
+            }
 
-      /* Copy the file offset */
+          memcpy(np->n_buffer + np->n_buflen, buffer, buflen);
+          np->n_buflen += buflen;
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
+          filep->f_pos += buflen;
+          if (filep->f_pos > np->n_size)
+            {
+              np->n_size = filep->f_pos;
+            }
 
-      /* Copy the count and stable values */
+          nxmutex_unlock(&nmp->nm_lock);
+          return buflen;
+        }
+    }
 
-      *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
+  /* Larger writes go to the server at once, after the data held back */
 
-      /* Copy a chunk of the user data into the I/O buffer */
+  ret = nfs_flushbuffer(nmp, np);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
 
-      *ptr++  = txdr_unsigned(writesize);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+  np->n_buflen = 0;
+#endif
 
-      /* Perform the write */
+  /* Now loop until we send the entire user buffer */
 
-      nfs_statistics(NFSPROC_WRITE);
-      ret = nfs_request(nmp, NFSPROC_WRITE,
-                        nmp->nm_iobuffer, reqlen,
-                        &nmp->nm_msgbuffer.write,
-                        sizeof(struct rpc_reply_write));
-      if (ret)
+  for (byteswritten = 0; byteswritten < buflen; )
+    {
+      writesize = nfs_writerpc(nmp, np, filep->f_pos, buffer,
+                               buflen - byteswritten);
+      if (writesize < 0)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
+          ret = writesize;
           goto errout_with_lock;
         }
 
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
-
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
-
-      /* Check if normal file attributes follow */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+      /* Update the read state data */
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+      filep->f_pos += writesize;
+      byteswritten += writesize;
+      buffer       += writesize;
+    }
 
-      /* Get the count of bytes actually written */
+errout_with_lock:
+  nxmutex_unlock(&nmp->nm_lock);
+  return byteswritten > 0 ? byteswritten : ret;
+}
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Synchronize the file state on disk to match internal, in-memory state.
+ *
+ ****************************************************************************/
 
-      if (tmp < 1 || tmp > writesize)
-        {
-          ret = -EIO;
-          goto errout_with_lock;
-        }
+static int nfs_sync(FAR struct file *filep)
+{
+#ifdef CONFIG_NFS_FILE_BUFFER
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode *np;
+  int ret;
 
-      writesize = tmp;
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      /* Determine the lowest commitment level obtained by any of the RPCs. */
+  /* Recover our private data from the struct file instance */
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      /* Update the read state data */
+  DEBUGASSERT(nmp != NULL);
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return ret;
     }
 
-errout_with_lock:
+  ret = nfs_flushbuffer(nmp, np);
+
   nxmutex_unlock(&nmp->nm_lock);
-  return byteswritten > 0 ? byteswritten : ret;
+  return ret;
+#else
+  /* The writes are synchronous */
+
+  return OK;
+#endif
 }
 
 /****************************************************************************
@@ -1342,6 +1646,20 @@ static int nfs_fchstat(FAR const struct file *filep,
       return ret;
     }
 
+#ifdef CONFIG_NFS_FILE_BUFFER
+  /* Write back the data held back and drop the buffer, which may be beyond
+   * a new size.
+   */
+
+  ret = nfs_flushbuffer(nmp, np);
+  np->n_buflen = 0;
+  if (ret < 0)
+    {
+      nxmutex_unlock(&nmp->nm_lock);
+      return ret;
+    }
+#endif
+
   /* Change the file mode, owner, group and time. */
 
   ret = nfs_filechstat(nmp, np, buf, flags);
@@ -1380,6 +1698,20 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
     {
       struct stat buf;
 
+#ifdef CONFIG_NFS_FILE_BUFFER
+      /* Write back the data held back, which may be beyond the new size,
+       * and drop the buffer.
+       */
+
+      ret = nfs_flushbuffer(nmp, np);
+      np->n_buflen = 0;
+      if (ret < 0)
+        {
+          nxmutex_unlock(&nmp->nm_lock);
+          return ret;
+        }
+#endif
+
       /* Then perform the SETATTR RPC to set the new file size */
 
       buf.st_size = length;
@@ -2156,6 +2488,7 @@ static int nfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* And free any allocated resources */
 
+  nfs_attrcache_flush(nmp);
   nxmutex_destroy(&nmp->nm_lock);
   kmm_free(nmp->nm_rpcclnt);
   kmm_free(nmp);
@@ -2422,6 +2755,7 @@ static int nfs_remove(FAR struct inode *mountpt, FAR const char *relpath)
   ret = nfs_request(nmp, NFSPROC_REMOVE,
                     &nmp->nm_msgbuffer.removef, reqlen,
                     nmp->nm_iobuffer, nmp->nm_buflen);
+  nfs_attrcache_flush(nmp);
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
@@ -2545,6 +2879,7 @@ static int nfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   ret = nfs_request(nmp, NFSPROC_MKDIR,
                     &nmp->nm_msgbuffer.mkdir, reqlen,
                     &nmp->nm_iobuffer, nmp->nm_buflen);
+  nfs_attrcache_flush(nmp);
   if (ret)
     {
       ferr("ERROR: nfs_request failed: %d\n", ret);
@@ -2632,6 +2967,7 @@ static int nfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   ret = nfs_request(nmp, NFSPROC_RMDIR,
                     &nmp->nm_msgbuffer.rmdir, reqlen,
                     nmp->nm_iobuffer, nmp->nm_buflen);
+  nfs_attrcache_flush(nmp);
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
@@ -2745,6 +3081,7 @@ static int nfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   ret = nfs_request(nmp, NFSPROC_RENAME,
                     &nmp->nm_msgbuffer.renamef, reqlen,
                     nmp->nm_iobuffer, nmp->nm_buflen);
+  nfs_attrcache_flush(nmp);
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
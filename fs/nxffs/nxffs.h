@@ -35,6 +35,7 @@
 #include <nuttx/fs/nxffs.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -242,6 +243,18 @@ struct nxffs_blkentry_s
   uint16_t                  foffset;  /* Offset to start of data */
 };
 
+/* This structure describes one valid inode in the RAM index of the volume.
+ * The name is only hashed, matches are confirmed from the inode header.
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_index_s
+{
+  uint32_t                  hash;      /* CRC32 of the inode name */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+};
+#endif
+
 /* This structure describes the state of one open file.  This structure
  * is protected by the volume semaphore.
  */
@@ -288,6 +301,16 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  FAR struct nxffs_index_s *index;     /* RAM index of the valid inodes */
+  size_t                    nindex;    /* Number of inodes in the index */
+  size_t                    maxindex;  /* Allocated entries of the index */
+  bool                      indexed;   /* The index is complete */
+#endif
+#ifdef CONFIG_NXFFS_BGPACK
+  bool                      reclaim;   /* Deletions since the last pack */
+  struct work_s             bgwork;    /* Background packing */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1069,6 +1092,122 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_bgpack
+ *
+ * Description:
+ *   Note that an inode has been deleted and schedule the background packing
+ *   of the volume.  The volume is packed on the low priority work queue
+ *   once there are no open files, if the free FLASH memory at the end of
+ *   the volume has fallen below CONFIG_NXFFS_BGPACK_THRESH percent.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_pack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgpack(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_indexbuild
+ *
+ * Description:
+ *   (Re-)build the RAM index of the valid inodes by scanning the volume.
+ *   If the index cannot be built, inode lookups fall back to scanning.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero is returned on success. Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_indexbuild(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_indexinvalidate
+ *
+ * Description:
+ *   Discard the RAM index, e.g. because the inodes are being moved.  It is
+ *   rebuilt by the next inode lookup.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_indexinvalidate(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_indexfind
+ *
+ * Description:
+ *   Find the inode with the provided name through the RAM index, which must
+ *   be complete.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success. Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_indexfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    FAR struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_indexadd and nxffs_indexremove
+ *
+ * Description:
+ *   Add a new inode to the RAM index or remove a deleted one.  Nothing is
+ *   done if the index is not complete.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   entry   - Describes the new inode (nxffs_indexadd)
+ *   hoffset - The FLASH offset to the deleted inode (nxffs_indexremove)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_indexadd(FAR struct nxffs_volume_s *volume,
+                    FAR const struct nxffs_entry_s *entry);
+void nxffs_indexremove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
@@ -0,0 +1,272 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The index grows by this number of entries */
+
+#define NXFFS_INDEX_ALLOC 16
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_namehash
+ *
+ * Description:
+ *   Return the hash of an inode name in the index.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_namehash(FAR const char *name)
+{
+  return crc32((FAR const uint8_t *)name, strlen(name));
+}
+
+/****************************************************************************
+ * Name: nxffs_indexappend
+ *
+ * Description:
+ *   Append an inode to the index, growing it if necessary.
+ *
+ ****************************************************************************/
+
+static int nxffs_indexappend(FAR struct nxffs_volume_s *volume,
+                             FAR const struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_index_s *index;
+
+  if (volume->nindex >= volume->maxindex)
+    {
+      index = kmm_realloc(volume->index,
+                          (volume->maxindex + NXFFS_INDEX_ALLOC) *
+                          sizeof(struct nxffs_index_s));
+      if (index == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      volume->index     = index;
+      volume->maxindex += NXFFS_INDEX_ALLOC;
+    }
+
+  index          = &volume->index[volume->nindex++];
+  index->hash    = nxffs_namehash(entry->name);
+  index->hoffset = entry->hoffset;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_indexbuild
+ *
+ * Description:
+ *   (Re-)build the RAM index of the valid inodes by scanning the volume.
+ *   If the index cannot be built, inode lookups fall back to scanning.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero is returned on success. Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_indexbuild(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  nxffs_indexinvalidate(volume);
+
+  offset = volume->inoffset;
+  for (; ; )
+    {
+      ret = nxffs_nextentry(volume, offset, &entry);
+      if (ret == -ENOENT)
+        {
+          break;
+        }
+      else if (ret < 0)
+        {
+          ferr("ERROR: Failed to scan the inodes: %d\n", -ret);
+          return ret;
+        }
+
+      ret    = nxffs_indexappend(volume, &entry);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+
+      if (ret < 0)
+        {
+          ferr("ERROR: No memory for the inode index\n");
+          nxffs_indexinvalidate(volume);
+          return ret;
+        }
+    }
+
+  finfo("%zu inodes indexed\n", volume->nindex);
+  volume->indexed = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexinvalidate
+ *
+ * Description:
+ *   Discard the RAM index, e.g. because the inodes are being moved.  It is
+ *   rebuilt by the next inode lookup.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_indexinvalidate(FAR struct nxffs_volume_s *volume)
+{
+  kmm_free(volume->index);
+  volume->index    = NULL;
+  volume->nindex   = 0;
+  volume->maxindex = 0;
+  volume->indexed  = false;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexfind
+ *
+ * Description:
+ *   Find the inode with the provided name through the RAM index.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success. Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_indexfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                    FAR struct nxffs_entry_s *entry)
+{
+  uint32_t hash = nxffs_namehash(name);
+  size_t i;
+  int ret;
+
+  DEBUGASSERT(volume->indexed);
+
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hash != hash)
+        {
+          continue;
+        }
+
+      /* The inode header is at the indexed offset, so the search ends
+       * there.
+       */
+
+      ret = nxffs_nextentry(volume, volume->index[i].hoffset, entry);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (entry->hoffset == volume->index[i].hoffset &&
+          strcmp(name, entry->name) == 0)
+        {
+          return OK;
+        }
+
+      nxffs_freeentry(entry);
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexadd and nxffs_indexremove
+ *
+ * Description:
+ *   Add a new inode to the RAM index or remove a deleted one.  Nothing is
+ *   done if the index is not complete.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   entry   - Describes the new inode (nxffs_indexadd)
+ *   hoffset - The FLASH offset to the deleted inode (nxffs_indexremove)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_indexadd(FAR struct nxffs_volume_s *volume,
+                    FAR const struct nxffs_entry_s *entry)
+{
+  if (volume->indexed && nxffs_indexappend(volume, entry) < 0)
+    {
+      /* Rebuild it when there is memory again */
+
+      nxffs_indexinvalidate(volume);
+    }
+}
+
+void nxffs_indexremove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  size_t i;
+
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hoffset == hoffset)
+        {
+          volume->index[i] = volume->index[--volume->nindex];
+          break;
+        }
+    }
+}
@@ -263,6 +263,9 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+#ifdef CONFIG_NXFFS_INDEX
+      nxffs_indexbuild(volume);
+#endif
       return OK;
     }
 
@@ -292,6 +295,9 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+#ifdef CONFIG_NXFFS_INDEX
+      nxffs_indexbuild(volume);
+#endif
       return OK;
     }
 
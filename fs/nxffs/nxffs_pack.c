@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
 
@@ -1241,6 +1242,58 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
   return -ENOSYS;
 }
 
+/****************************************************************************
+ * Name: nxffs_bgpack_worker
+ *
+ * Description:
+ *   Pack the volume on the low priority work queue, if it is still worth
+ *   it.  The packing waits while files are open, so that it neither moves
+ *   the file being written nor the files being read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+static void nxffs_bgpack_worker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = arg;
+  off_t size;
+  int ret;
+
+  if (nxmutex_lock(&volume->lock) < 0)
+    {
+      return;
+    }
+
+  if (volume->reclaim)
+    {
+      if (volume->ofiles != NULL)
+        {
+          /* Try again later */
+
+          work_queue(LPWORK, &volume->bgwork, nxffs_bgpack_worker, volume,
+                     MSEC2TICK(CONFIG_NXFFS_BGPACK_DELAY));
+        }
+      else
+        {
+          size = volume->nblocks * volume->geo.blocksize;
+          if ((size - volume->froffset) * 100 <
+              size * CONFIG_NXFFS_BGPACK_THRESH)
+            {
+              finfo("Packing in the background\n");
+
+              ret = nxffs_pack(volume);
+              if (ret < 0)
+                {
+                  ferr("ERROR: Background packing failed: %d\n", -ret);
+                }
+            }
+        }
+    }
+
+  nxmutex_unlock(&volume->lock);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1277,6 +1330,16 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   wrfile = NULL;
   packed = false;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* The inodes are about to move, the index is rebuilt when next used */
+
+  nxffs_indexinvalidate(volume);
+#endif
+
+#ifdef CONFIG_NXFFS_BGPACK
+  volume->reclaim = false;
+#endif
+
   iooffset = nxffs_mediacheck(volume, &pack);
   if (iooffset == 0)
     {
@@ -1608,3 +1671,32 @@ errout_with_pack:
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_bgpack
+ *
+ * Description:
+ *   Note that an inode has been deleted and schedule the background packing
+ *   of the volume.  The volume is packed on the low priority work queue
+ *   once there are no open files, if the free FLASH memory at the end of
+ *   the volume has fallen below CONFIG_NXFFS_BGPACK_THRESH percent.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgpack(FAR struct nxffs_volume_s *volume)
+{
+  volume->reclaim = true;
+
+  /* Restart the delay, so that a burst of deletions is packed once */
+
+  work_queue(LPWORK, &volume->bgwork, nxffs_bgpack_worker, volume,
+             MSEC2TICK(CONFIG_NXFFS_BGPACK_DELAY));
+}
+#endif
@@ -270,6 +270,12 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
 {
   int ret;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* All inodes are lost */
+
+  nxffs_indexinvalidate(volume);
+#endif
+
   /* Erase and reformat the entire volume */
 
   ret = nxffs_format(volume);
@@ -112,8 +112,16 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
     {
       ferr("ERROR: Failed to write block %jd: %d\n",
            (intmax_t)volume->ioblock, ret);
+      goto errout_with_entry;
     }
 
+#ifdef CONFIG_NXFFS_INDEX
+  nxffs_indexremove(volume, entry.hoffset);
+#endif
+#ifdef CONFIG_NXFFS_BGPACK
+  nxffs_bgpack(volume);
+#endif
+
 errout_with_entry:
   nxffs_freeentry(&entry);
 errout:
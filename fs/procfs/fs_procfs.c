@@ -57,14 +57,18 @@ extern const struct procfs_operations pm_operations;
 extern const struct procfs_operations irq_operations;
 extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations critmon_operations;
+extern const struct procfs_operations crithist_operations;
 extern const struct procfs_operations meminfo_operations;
 extern const struct procfs_operations memdump_operations;
 extern const struct procfs_operations mempool_operations;
+extern const struct procfs_operations heapprof_operations;
 extern const struct procfs_operations iobinfo_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations spinlock_operations;
 extern const struct procfs_operations uptime_operations;
 extern const struct procfs_operations version_operations;
 extern const struct procfs_operations tcbinfo_operations;
+extern const struct procfs_operations taskstat_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
  * deal with them here is not a good coupling. What is really needed is a
@@ -101,6 +105,9 @@ static const struct procfs_entry_s g_procfs_entries[] =
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   { "critmon",       &critmon_operations,         PROCFS_FILE_TYPE   },
+#  ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  { "crithist",      &crithist_operations,        PROCFS_FILE_TYPE   },
+#  endif
 #endif
 
 #ifdef CONFIG_SCHED_IRQMONITOR
@@ -118,6 +125,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "mempool",       &mempool_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_MM_HEAPPROF
+  { "heapprof",      &heapprof_operations,        PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",       &iobinfo_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -165,6 +176,15 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "self/**",       &proc_operations,            PROCFS_UNKOWN_TYPE },
 #endif
 
+#if defined(CONFIG_SPINLOCK_STATISTICS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SPINLOCK)
+  { "spinlock",      &spinlock_operations,        PROCFS_FILE_TYPE   },
+#endif
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_TASKSTAT)
+  { "taskstat",      &taskstat_operations,        PROCFS_FILE_TYPE   },
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
   { "uptime",        &uptime_operations,          PROCFS_FILE_TYPE   },
 #endif
@@ -29,6 +29,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -83,6 +84,23 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
 static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t crithist_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static FAR const char * const g_crithist_kind[CRITMON_NHIST] =
+{
+  "preemption",
+  "csection",
+  "irq"
+};
+#endif
 
 /****************************************************************************
  * Public Data
@@ -110,6 +128,25 @@ const struct procfs_operations critmon_operations =
   critmon_stat        /* stat */
 };
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+const struct procfs_operations crithist_operations =
+{
+  critmon_open,       /* open */
+  critmon_close,      /* close */
+  crithist_read,      /* read */
+  NULL,               /* write */
+
+  critmon_dup,        /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  critmon_stat        /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -294,6 +331,100 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: crithist_read
+ *
+ * Description:
+ *   Generate one line per non-empty bucket of each histogram:
+ *
+ *     cpu,kind,hist,<lower bound of the bucket>,<count>
+ *
+ *   followed by one line per longest duration:
+ *
+ *     cpu,kind,top,<duration>,<pid or IRQ number>,<caller or handler>
+ *
+ *   The histograms are cumulative:  They are not reset by reading them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t crithist_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct critmon_file_s *attr;
+  FAR struct critmon_hist_s *hist;
+  struct timespec ts;
+  size_t linesize;
+  ssize_t ret = 0;
+  off_t offset;
+  int kind;
+  int cpu;
+  int i;
+
+  attr = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      for (kind = 0; kind < CRITMON_NHIST; kind++)
+        {
+          hist = &g_critmon_hist[cpu][kind];
+
+          for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NBUCKETS; i++)
+            {
+              if (hist->bucket[i] == 0)
+                {
+                  continue;
+                }
+
+              up_perf_convert(i > 0 ? (clock_t)1 << (i - 1) : 0, &ts);
+              linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                         "%d,%s,hist,%lu.%09lu,%" PRIu32
+                                         "\n", cpu, g_crithist_kind[kind],
+                                         (unsigned long)ts.tv_sec,
+                                         (unsigned long)ts.tv_nsec,
+                                         hist->bucket[i]);
+              ret += procfs_memcpy(attr->line, linesize, buffer + ret,
+                                   buflen - ret, &offset);
+              if (ret >= buflen)
+                {
+                  goto out;
+                }
+            }
+
+          for (i = 0; i < CONFIG_SCHED_CRITMONITOR_TOPN; i++)
+            {
+              if (hist->top[i].elapsed == 0)
+                {
+                  break;
+                }
+
+              up_perf_convert(hist->top[i].elapsed, &ts);
+              linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                         "%d,%s,top,%lu.%09lu,%d,%p\n",
+                                         cpu, g_crithist_kind[kind],
+                                         (unsigned long)ts.tv_sec,
+                                         (unsigned long)ts.tv_nsec,
+                                         (int)hist->top[i].pid,
+                                         hist->top[i].caller);
+              ret += procfs_memcpy(attr->line, linesize, buffer + ret,
+                                   buflen - ret, &offset);
+              if (ret >= buflen)
+                {
+                  goto out;
+                }
+            }
+        }
+    }
+
+out:
+  filep->f_pos += ret;
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_dup
  *
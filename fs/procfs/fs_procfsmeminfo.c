@@ -106,6 +106,21 @@ static int     meminfo_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     meminfo_stat(FAR const char *relpath, FAR struct stat *buf);
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_TIERS
+/* The names of the memory tiers, as listed below their heap */
+
+static FAR const char *g_meminfo_tiers[MM_NTIERS] =
+{
+  "fast",
+  "normal",
+  "slow"
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -275,6 +290,9 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
   size_t copysize;
   size_t totalsize;
   off_t offset;
+#ifdef CONFIG_MM_HEAP_TIERS
+  int tier;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -324,6 +342,36 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
+
+#ifdef CONFIG_MM_HEAP_TIERS
+          /* Followed by the tiers of the heap that have memory */
+
+          for (tier = 0; tier < MM_NTIERS && buflen > 0; tier++)
+            {
+              mm_mallinfo_tier(entry->heap, tier, &minfo);
+              if (minfo.arena == 0)
+                {
+                  continue;
+                }
+
+              buffer    += copysize;
+              buflen    -= copysize;
+
+              linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                           "%12s:%11lu%11lu%11lu%11lu"
+                                           "%7lu%7lu\n",
+                                           g_meminfo_tiers[tier],
+                                           (unsigned long)minfo.arena,
+                                           (unsigned long)minfo.uordblks,
+                                           (unsigned long)minfo.fordblks,
+                                           (unsigned long)minfo.mxordblk,
+                                           (unsigned long)minfo.aordblks,
+                                           (unsigned long)minfo.ordblks);
+              copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                         buflen, &offset);
+              totalsize += copysize;
+            }
+#endif
         }
     }
 
@@ -86,6 +86,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CPULOAD
   PROC_LOADAVG,                       /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  PROC_CPUSTAT,                       /* Exact CPU time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
@@ -151,9 +154,10 @@ struct proc_envinfo_s
  * Private Data
  ****************************************************************************/
 
-static FAR const char *g_policy[4] =
+static FAR const char *g_policy[5] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER",
+  "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -175,6 +179,11 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cpustat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
 static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
@@ -284,6 +293,13 @@ static const struct proc_node_s g_loadavg =
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPUTIME
+static const struct proc_node_s g_cpustat =
+{
+  "stat",          "stat",    (uint8_t)PROC_CPUSTAT,     DTYPE_FILE        /* Exact CPU time */
+};
+#endif
+
 #ifdef CONFIG_SCHED_CRITMONITOR
 static const struct proc_node_s g_critmon =
 {
@@ -342,6 +358,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_cpustat,      /* Exact CPU time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
@@ -371,6 +390,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+  &g_cpustat,      /* Exact CPU time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
@@ -484,7 +506,8 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *   Flags:      xxx                N,P,X
  *   Priority:   nnn                Decimal, 0-255
  *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC,
- *                                   SCHED_OTHER}
+ *                                   SCHED_OTHER, SCHED_DEADLINE}
+ *   Deadline:   nnn misses, nnn overruns  (SCHED_DEADLINE only)
  *   Sigmask:    nnnnnnnn           Hexadecimal, 32-bit
  *
  ****************************************************************************/
@@ -660,6 +683,30 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
       return totalsize;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Show the missed deadlines and the exhausted budgets */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%-12s%" PRIu32 " misses, %" PRIu32
+                                   " overruns\n", "Deadline:",
+                                   tcb->deadline.nmisses,
+                                   tcb->deadline.noverruns);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      if (totalsize >= buflen)
+        {
+          return totalsize;
+        }
+    }
+#endif
+
   /* Show the signal mask. Note: sigset_t is uint32_t on NuttX. */
 
   linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
@@ -808,6 +855,38 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_cpustat
+ *
+ * Description:
+ *   Report the CPU time consumed by the thread, in seconds, and the number
+ *   of times that it has been switched in.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+static ssize_t proc_cpustat(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  struct timespec cputime;
+  size_t linesize;
+  size_t copysize;
+
+  nxsched_get_cputime(tcb, &cputime);
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "%lu.%09lu %" PRIu32 "\n",
+                             (unsigned long)cputime.tv_sec,
+                             (unsigned long)cputime.tv_nsec,
+                             tcb->nswitches);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                           &offset);
+
+  return copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_critmon
  ****************************************************************************/
@@ -1627,6 +1706,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_CPUTIME
+    case PROC_CPUSTAT: /* Exact CPU time */
+      ret = proc_cpustat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
     case PROC_CRITMON: /* Critical section monitor */
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -0,0 +1,312 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsspinlock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SPINLOCK_STATISTICS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SPINLOCK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SPINLOCK_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct spinlock_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[SPINLOCK_LINELEN];    /* Pre-allocated buffer for lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     spinlock_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     spinlock_close(FAR struct file *filep);
+static ssize_t spinlock_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     spinlock_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     spinlock_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations spinlock_operations =
+{
+  spinlock_open,  /* open */
+  spinlock_close, /* close */
+  spinlock_read,  /* read */
+  NULL,           /* write */
+  spinlock_dup,   /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  spinlock_stat   /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinlock_open
+ ****************************************************************************/
+
+static int spinlock_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct spinlock_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   *
+   * REVISIT:  Write-able proc files could be quite useful.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct spinlock_file_s *)
+    kmm_zalloc(sizeof(struct spinlock_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_close
+ ****************************************************************************/
+
+static int spinlock_close(FAR struct file *filep)
+{
+  FAR struct spinlock_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct spinlock_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_read
+ ****************************************************************************/
+
+static ssize_t spinlock_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct spinlock_file_s *procfile;
+  struct spinlock_stat_s stat;
+  FAR struct spinlock_cpustat_s *cpustat;
+  unsigned int index;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int cpu;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct spinlock_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The first line is the headers */
+
+  linesize  = procfs_snprintf(procfile->line, SPINLOCK_LINELEN,
+                              "%-18s%4s%11s%11s%11s%16s\n",
+                              "lock", "cpu", "nlocks", "ncontended",
+                              "maxspins", "nspins");
+
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  buffer   += copysize;
+  buflen   -= copysize;
+
+  /* Then one line for each lock on each CPU that has taken it */
+
+  for (index = 0; buflen > 0 && spin_getstat(index, &stat) >= 0; index++)
+    {
+      if (stat.lock == NULL)
+        {
+          continue;
+        }
+
+      for (cpu = 0; buflen > 0 && cpu < SP_NCPUS; cpu++)
+        {
+          cpustat = &stat.cpu[cpu];
+          if (cpustat->nlocks == 0)
+            {
+              continue;
+            }
+
+          linesize   = procfs_snprintf(procfile->line, SPINLOCK_LINELEN,
+                                       "%-18p%4d%11" PRIu32 "%11" PRIu32
+                                       "%11" PRIu32 "%16" PRIu64 "\n",
+                                       stat.lock, cpu, cpustat->nlocks,
+                                       cpustat->ncontended,
+                                       cpustat->maxspins, cpustat->nspins);
+
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spinlock_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int spinlock_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct spinlock_file_s *oldattr;
+  FAR struct spinlock_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct spinlock_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct spinlock_file_s *)
+    kmm_malloc(sizeof(struct spinlock_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct spinlock_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int spinlock_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "spinlock" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SPINLOCK_STATISTICS && !CONFIG_FS_PROCFS_EXCLUDE_SPINLOCK */
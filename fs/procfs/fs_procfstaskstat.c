@@ -0,0 +1,349 @@
+/****************************************************************************
+ * fs/procfs/fs_procfstaskstat.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* /proc/taskstat reports the state, priority, CPU time, stack high-water
+ * mark and context switches of all of the threads in a single read(), as
+ * an array of struct procfs_taskstat_s.  Nothing is formatted, so that a
+ * monitor can poll all of the threads often at a small cost.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_TASKSTAT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The file position is all of
+ * its state.
+ */
+
+struct taskstat_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+};
+
+/* The records that a read() collects */
+
+struct taskstat_collect_s
+{
+  FAR char *buffer;                  /* The user buffer */
+  size_t skip;                       /* Number of records before f_pos */
+  size_t nstats;                     /* Number of records that fit */
+  size_t count;                      /* Number of records collected */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     taskstat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     taskstat_close(FAR struct file *filep);
+static ssize_t taskstat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     taskstat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     taskstat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations taskstat_operations =
+{
+  taskstat_open,     /* open */
+  taskstat_close,    /* close */
+  taskstat_read,     /* read */
+  NULL,              /* write */
+
+  taskstat_dup,      /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  taskstat_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: taskstat_collect
+ *
+ * Description:
+ *   Copy the record of a thread to the user buffer, if it is in the range
+ *   of the read().  Called by nxsched_foreach() in a critical section.
+ *
+ ****************************************************************************/
+
+static void taskstat_collect(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct taskstat_collect_s *collect = arg;
+  struct procfs_taskstat_s stat;
+#ifdef CONFIG_SCHED_CPUTIME
+  struct timespec cputime;
+#endif
+
+  if (collect->skip > 0)
+    {
+      collect->skip--;
+      return;
+    }
+
+  if (collect->count >= collect->nstats)
+    {
+      return;
+    }
+
+  memset(&stat, 0, sizeof(stat));
+  stat.stacksize = tcb->adj_stack_size;
+  stat.pid       = tcb->pid;
+  stat.group     = tcb->group ? tcb->group->tg_pid : tcb->pid;
+  stat.flags     = tcb->flags;
+  stat.state     = tcb->task_state;
+  stat.priority  = tcb->sched_priority;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  stat.basepriority = tcb->base_priority;
+#else
+  stat.basepriority = tcb->sched_priority;
+#endif
+#ifdef CONFIG_SMP
+  stat.cpu       = tcb->cpu;
+#endif
+
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_get_cputime(tcb, &cputime);
+  stat.cputime   = (uint64_t)cputime.tv_sec * NSEC_PER_SEC +
+                   cputime.tv_nsec;
+  stat.nswitches = tcb->nswitches;
+#endif
+
+  /* The user buffer need not be aligned */
+
+  memcpy(collect->buffer + collect->count * sizeof(stat), &stat,
+         sizeof(stat));
+  collect->count++;
+}
+
+/****************************************************************************
+ * Name: taskstat_open
+ ****************************************************************************/
+
+static int taskstat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct taskstat_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct taskstat_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: taskstat_close
+ ****************************************************************************/
+
+static int taskstat_close(FAR struct file *filep)
+{
+  DEBUGASSERT(filep->f_priv);
+
+  /* Release the file attributes structure */
+
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: taskstat_read
+ *
+ * Description:
+ *   Return the records of the threads from the one at the file position,
+ *   as many as fit in the buffer.  The threads are those that exist at the
+ *   time of the read(), so lseek() back to zero to take a new snapshot.
+ *
+ ****************************************************************************/
+
+static ssize_t taskstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct taskstat_collect_s collect;
+#ifdef CONFIG_STACK_COLORATION
+  struct procfs_taskstat_s stat;
+  FAR struct tcb_s *tcb;
+  size_t i;
+#endif
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Only whole records are transferred */
+
+  if (filep->f_pos % sizeof(struct procfs_taskstat_s) != 0)
+    {
+      return -EINVAL;
+    }
+
+  collect.buffer = buffer;
+  collect.skip   = filep->f_pos / sizeof(struct procfs_taskstat_s);
+  collect.nstats = buflen / sizeof(struct procfs_taskstat_s);
+  collect.count  = 0;
+
+  if (collect.nstats > 0)
+    {
+      nxsched_foreach(taskstat_collect, &collect);
+    }
+
+#ifdef CONFIG_STACK_COLORATION
+  /* Scanning the stacks is too long for the critical section of
+   * nxsched_foreach(), so it is done afterwards, with the scheduler locked
+   * so that no thread exits during its scan.
+   */
+
+  sched_lock();
+  for (i = 0; i < collect.count; i++)
+    {
+      memcpy(&stat, buffer + i * sizeof(stat), sizeof(stat));
+      tcb = nxsched_get_tcb(stat.pid);
+      if (tcb != NULL)
+        {
+          stat.stackused = up_check_tcbstack(tcb);
+          memcpy(buffer + i * sizeof(stat), &stat, sizeof(stat));
+        }
+    }
+
+  sched_unlock();
+#endif
+
+  /* Update the file offset */
+
+  ret = collect.count * sizeof(struct procfs_taskstat_s);
+  filep->f_pos += ret;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: taskstat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int taskstat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct taskstat_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+  DEBUGASSERT(oldp->f_priv);
+
+  /* Allocate a new container and copy the old attributes into it */
+
+  newattr = kmm_malloc(sizeof(struct taskstat_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct taskstat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: taskstat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int taskstat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "taskstat" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS_EXCLUDE_TASKSTAT */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
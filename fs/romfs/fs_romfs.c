@@ -1190,6 +1190,13 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           kmm_free(rm->rm_buffer);
         }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+      if (!rm->rm_xipbase)
+        {
+          kmm_free(rm->rm_index);
+        }
+#endif
+
 #ifdef CONFIG_FS_ROMFS_CACHE_NODE
       romfs_freenode(rm->rm_root);
 #endif
@@ -59,6 +59,32 @@
 #define ROMFS_FHDR_NAME    16  /* 16-..: Zero terminated volume name, padded
                                 *        to 16 byte boundary. */
 
+/* Directory hash index (multi-byte values are big-endian).  The index is
+ * optional.  tools/romfsindex appends it to the volume, at the first
+ * 16-byte boundary after the accessible bytes, where other romfs
+ * implementations ignore it.  It is followed by nbuckets + 1 bucket starts
+ * and by nentries entries of three words: The offset of the first header
+ * of the directory, the hash of the directory and of the name, and the
+ * offset of the header of the entry.  The entries of a bucket are stored
+ * from its start to the start of the next bucket.
+ */
+
+#define ROMFS_IHDR_MAGIC    0  /*  0-7:  "-romidx-" */
+#define ROMFS_IHDR_NBUCKETS 8  /*  8-11: Number of buckets, a power of two */
+#define ROMFS_IHDR_NENTRIES 12 /* 12-15: Number of entries */
+#define ROMFS_IHDR_CHKSUM  16  /* 16-19: Makes the sum of all words zero */
+#define ROMFS_IHDR_SIZE    32  /* 20-31: Reserved, zero */
+
+#define ROMFS_IHDR_MAGICSTR "-romidx-"
+#define ROMFS_IENTRY_SIZE  12
+
+/* The index hash is the 32-bit FNV-1a hash of the big-endian offset of the
+ * directory followed by the name.
+ */
+
+#define ROMFS_HASH_INIT    0x811c9dc5
+#define ROMFS_HASH_PRIME   0x01000193
+
 /* Bits 0-3 of the rf_next offset provide mode information.  These are the
  * values specified in
  */
@@ -139,6 +165,11 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;        /* Current sector in the rm_buffer */
   FAR uint8_t *rm_xipbase;        /* Base address of directly accessible media */
   FAR uint8_t *rm_buffer;         /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_INDEX
+  FAR uint8_t *rm_index;          /* Directory hash index, allocated if rm_xipbase==0 */
+  uint32_t rm_nbuckets;           /* Number of buckets of the index */
+  uint32_t rm_nentries;           /* Number of entries of the index */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
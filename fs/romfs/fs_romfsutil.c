@@ -86,6 +86,52 @@ static uint32_t romfs_devread32(FAR struct romfs_mountpt_s *rm, int ndx)
            ((uint32_t)rm->rm_buffer[ndx + 3] & 0xff));
 }
 
+/****************************************************************************
+ * Name: romfs_read32
+ *
+ * Description:
+ *   Read the big-endian 32-bit value at an address of the media or of the
+ *   index
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_ROMFS_CACHE_NODE
+static uint32_t romfs_read32(FAR const uint8_t *ptr)
+{
+  return (((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) |
+          ((uint32_t)ptr[2] << 8) | (uint32_t)ptr[3]);
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_hash
+ *
+ * Description:
+ *   Return the index hash of a name in the directory whose first header is
+ *   at offset dir
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static uint32_t romfs_hash(uint32_t dir, FAR const char *name, int len)
+{
+  uint32_t hash = ROMFS_HASH_INIT;
+  int i;
+
+  for (i = 24; i >= 0; i -= 8)
+    {
+      hash = (hash ^ ((dir >> i) & 0xff)) * ROMFS_HASH_PRIME;
+    }
+
+  for (i = 0; i < len; i++)
+    {
+      hash = (hash ^ (uint8_t)name[i]) * ROMFS_HASH_PRIME;
+    }
+
+  return hash;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_checkentry
  *
@@ -314,6 +360,100 @@ static int romfs_nodeinfo_compare(FAR const void *a, FAR const void *b)
 }
 #endif
 
+/****************************************************************************
+ * Name: romfs_xipsearchdir
+ *
+ * Description:
+ *   This is romfs_searchdir() for memory-mapped media:  The headers are
+ *   walked and the names compared in place, only the matching entry is
+ *   parsed.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_ROMFS_CACHE_NODE
+static int romfs_xipsearchdir(FAR struct romfs_mountpt_s *rm,
+                              FAR const char *entryname, int entrylen,
+                              FAR struct romfs_nodeinfo_s *nodeinfo)
+{
+  FAR const char *name;
+  uint32_t offset = nodeinfo->rn_offset;
+  uint32_t next;
+
+  do
+    {
+      if (offset + ROMFS_FHDR_NAME + entrylen >= rm->rm_volsize)
+        {
+          return -EIO;
+        }
+
+      next = romfs_read32(rm->rm_xipbase + offset + ROMFS_FHDR_NEXT) &
+             RFNEXT_OFFSETMASK;
+      name = (FAR const char *)rm->rm_xipbase + offset + ROMFS_FHDR_NAME;
+
+      if (memcmp(name, entryname, entrylen) == 0 && name[entrylen] == '\0')
+        {
+          return romfs_checkentry(rm, offset, entryname, entrylen,
+                                  nodeinfo);
+        }
+
+      offset = next;
+    }
+  while (next != 0);
+
+  return -ENOENT;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Description:
+ *   This is romfs_searchdir() with the directory hash index:  Only the
+ *   entries of the directory with the hash of the name are checked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static int romfs_searchindex(FAR struct romfs_mountpt_s *rm,
+                             FAR const char *entryname, int entrylen,
+                             FAR struct romfs_nodeinfo_s *nodeinfo)
+{
+  FAR const uint8_t *buckets = rm->rm_index + ROMFS_IHDR_SIZE;
+  FAR const uint8_t *entry;
+  uint32_t dir = nodeinfo->rn_offset;
+  uint32_t hash;
+  uint32_t last;
+  uint32_t i;
+  int ret;
+
+  hash  = romfs_hash(dir, entryname, entrylen);
+  i     = hash & (rm->rm_nbuckets - 1);
+  last  = romfs_read32(buckets + 4 * (i + 1));
+  i     = romfs_read32(buckets + 4 * i);
+  if (last > rm->rm_nentries)
+    {
+      last = rm->rm_nentries;
+    }
+
+  entry = buckets + 4 * (rm->rm_nbuckets + 1) + ROMFS_IENTRY_SIZE * i;
+
+  for (; i < last; i++, entry += ROMFS_IENTRY_SIZE)
+    {
+      if (romfs_read32(entry) == dir && romfs_read32(entry + 4) == hash)
+        {
+          ret = romfs_checkentry(rm, romfs_read32(entry + 8), entryname,
+                                 entrylen, nodeinfo);
+          if (ret != -ENOENT)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -346,6 +486,25 @@ static inline int romfs_searchdir(FAR struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+  /* Names that may have been truncated to NAME_MAX are compared as parsed
+   * from the headers, the faster paths compare them whole.
+   */
+
+  if (entrylen < NAME_MAX)
+    {
+#  ifdef CONFIG_FS_ROMFS_INDEX
+      if (rm->rm_index != NULL)
+        {
+          return romfs_searchindex(rm, entryname, entrylen, nodeinfo);
+        }
+#  endif
+
+      if (rm->rm_xipbase)
+        {
+          return romfs_xipsearchdir(rm, entryname, entrylen, nodeinfo);
+        }
+    }
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -395,6 +554,136 @@ static inline int romfs_searchdir(FAR struct romfs_mountpt_s *rm,
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: romfs_devcopy
+ *
+ * Description:
+ *   Copy a range of the media that may span several sectors
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static int romfs_devcopy(FAR struct romfs_mountpt_s *rm, uint32_t offset,
+                         FAR uint8_t *buffer, uint32_t size)
+{
+  uint32_t nbytes;
+  int16_t  ndx;
+
+  while (size > 0)
+    {
+      ndx = romfs_devcacheread(rm, offset);
+      if (ndx < 0)
+        {
+          return ndx;
+        }
+
+      nbytes = rm->rm_hwsectorsize - ndx;
+      if (nbytes > size)
+        {
+          nbytes = size;
+        }
+
+      memcpy(buffer, &rm->rm_buffer[ndx], nbytes);
+
+      buffer += nbytes;
+      offset += nbytes;
+      size   -= nbytes;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: romfs_loadindex
+ *
+ * Description:
+ *   Look for the directory hash index after the volume and validate it.
+ *   The index is used in place on XIP media and copied to memory
+ *   otherwise.  Lookups walk the directories if there is no valid index.
+ *
+ ****************************************************************************/
+
+static void romfs_loadindex(FAR struct romfs_mountpt_s *rm)
+{
+  uint8_t header[ROMFS_IHDR_SIZE];
+  FAR uint8_t *index;
+  uint64_t devsize;
+  uint32_t offset;
+  uint32_t nbuckets;
+  uint32_t nentries;
+  uint32_t chksum;
+  uint32_t size;
+  uint32_t i;
+
+  devsize = (uint64_t)rm->rm_hwnsectors * rm->rm_hwsectorsize;
+  offset  = ROMFS_ALIGNUP(rm->rm_volsize);
+  if (offset + (uint64_t)ROMFS_IHDR_SIZE > devsize ||
+      romfs_devcopy(rm, offset, header, ROMFS_IHDR_SIZE) < 0 ||
+      memcmp(&header[ROMFS_IHDR_MAGIC], ROMFS_IHDR_MAGICSTR, 8) != 0)
+    {
+      return;
+    }
+
+  nbuckets = romfs_read32(&header[ROMFS_IHDR_NBUCKETS]);
+  nentries = romfs_read32(&header[ROMFS_IHDR_NENTRIES]);
+
+  /* Each entry has a header of at least 16 bytes in the volume */
+
+  if (nbuckets == 0 || (nbuckets & (nbuckets - 1)) != 0 ||
+      nbuckets > rm->rm_volsize / 16 || nentries > rm->rm_volsize / 16)
+    {
+      return;
+    }
+
+  size = ROMFS_IHDR_SIZE + 4 * (nbuckets + 1) +
+         ROMFS_IENTRY_SIZE * nentries;
+  if (offset + (uint64_t)size > devsize)
+    {
+      return;
+    }
+
+  if (rm->rm_xipbase)
+    {
+      index = rm->rm_xipbase + offset;
+    }
+  else
+    {
+      index = kmm_malloc(size);
+      if (index == NULL)
+        {
+          return;
+        }
+
+      if (romfs_devcopy(rm, offset, index, size) < 0)
+        {
+          kmm_free(index);
+          return;
+        }
+    }
+
+  for (chksum = 0, i = 0; i < size; i += 4)
+    {
+      chksum += romfs_read32(index + i);
+    }
+
+  if (chksum != 0 ||
+      romfs_read32(index + ROMFS_IHDR_SIZE + 4 * nbuckets) != nentries)
+    {
+      fwarn("WARNING: Ignoring corrupted romfs index\n");
+      if (!rm->rm_xipbase)
+        {
+          kmm_free(index);
+        }
+
+      return;
+    }
+
+  rm->rm_index    = index;
+  rm->rm_nbuckets = nbuckets;
+  rm->rm_nentries = nentries;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_cachenode
  *
@@ -779,6 +1068,9 @@ int romfs_fsconfigure(FAR struct romfs_mountpt_s *rm)
     }
 #else
   rm->rm_rootoffset = ROMFS_ALIGNUP(ROMFS_VHDR_VOLNAME + strlen(name) + 1);
+#  ifdef CONFIG_FS_ROMFS_INDEX
+  romfs_loadindex(rm);
+#  endif
 #endif
 
   /* and return success */
@@ -36,6 +36,7 @@
 #include <debug.h>
 #include <limits.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -49,6 +50,18 @@
 
 #define RPMSGFS_RETRY_DELAY_MS       10
 
+#ifndef CONFIG_FS_RPMSGFS_BUFSIZE
+#  define CONFIG_FS_RPMSGFS_BUFSIZE    0
+#endif
+
+#ifndef CONFIG_FS_RPMSGFS_ATTRCACHE_MS
+#  define CONFIG_FS_RPMSGFS_ATTRCACHE_MS 0
+#endif
+
+#ifndef MIN
+#  define MIN(a,b)                   ((a) < (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -69,8 +82,26 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#if CONFIG_FS_RPMSGFS_BUFSIZE > 0
+  FAR char                   *buf;     /* Readahead/write-behind buffer */
+  size_t                     buflen;   /* Bytes read ahead or written */
+  size_t                     bufpos;   /* Read position in buf */
+  bool                       dirty;    /* buf holds write-behind data */
+#endif
 };
 
+/* A cached stat() result of one host path */
+
+#if CONFIG_FS_RPMSGFS_ATTRCACHE_MS > 0
+struct rpmsgfs_attr_s
+{
+  FAR char                   *path;    /* Host path, NULL if unused */
+  clock_t                    expire;   /* Tick at which the entry expires */
+  int                        result;   /* OK or -ENOENT */
+  struct stat                buf;      /* Attributes if result is OK */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a rpmsgfs filesystem.
@@ -84,6 +115,10 @@ struct rpmsgfs_mountpt_s
   void                       *handle;
   int                        timeout;  /* Connect timeout */
   struct statfs              statfs;
+#if CONFIG_FS_RPMSGFS_ATTRCACHE_MS > 0
+  struct rpmsgfs_attr_s      attr[CONFIG_FS_RPMSGFS_ATTRCACHE_ENTRIES];
+  uint8_t                    attrnext; /* Next entry to replace */
+#endif
 };
 
 /****************************************************************************
@@ -265,6 +300,237 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: rpmsgfs_attr_find
+ *
+ * Description:
+ *   Return the unexpired attribute cache entry of a host path, or NULL.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_RPMSGFS_ATTRCACHE_MS > 0
+static FAR struct rpmsgfs_attr_s *
+rpmsgfs_attr_find(FAR struct rpmsgfs_mountpt_s *fs, FAR const char *path)
+{
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_FS_RPMSGFS_ATTRCACHE_ENTRIES; i++)
+    {
+      FAR struct rpmsgfs_attr_s *attr = &fs->attr[i];
+
+      if (attr->path != NULL && strcmp(attr->path, path) == 0)
+        {
+          if ((sclock_t)(attr->expire - now) > 0)
+            {
+              return attr;
+            }
+
+          kmm_free(attr->path);
+          attr->path = NULL;
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_add
+ *
+ * Description:
+ *   Remember the result of a remote stat() of a host path.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attr_add(FAR struct rpmsgfs_mountpt_s *fs,
+                             FAR const char *path, int result,
+                             FAR const struct stat *buf)
+{
+  FAR struct rpmsgfs_attr_s *attr = &fs->attr[fs->attrnext];
+
+  fs->attrnext = (fs->attrnext + 1) % CONFIG_FS_RPMSGFS_ATTRCACHE_ENTRIES;
+
+  kmm_free(attr->path);
+  attr->path = kmm_malloc(strlen(path) + 1);
+  if (attr->path != NULL)
+    {
+      strcpy(attr->path, path);
+      attr->expire = clock_systime_ticks() +
+                     MSEC2TICK(CONFIG_FS_RPMSGFS_ATTRCACHE_MS);
+      attr->result = result;
+      if (result >= 0)
+        {
+          attr->buf = *buf;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_flush
+ *
+ * Description:
+ *   Drop the attribute cache.  Called by every local operation that
+ *   modifies the file system.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attr_flush(FAR struct rpmsgfs_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_RPMSGFS_ATTRCACHE_ENTRIES; i++)
+    {
+      kmm_free(fs->attr[i].path);
+      fs->attr[i].path = NULL;
+    }
+}
+#else
+#  define rpmsgfs_attr_flush(fs)
+#endif
+
+/****************************************************************************
+ * Name: rpmsgfs_flush
+ *
+ * Description:
+ *   Send the pending write-behind data, or drop the readahead data, so
+ *   that the position of the host file is 'pos' (the file position seen
+ *   by the caller) again.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_RPMSGFS_BUFSIZE > 0
+static int rpmsgfs_flush(FAR struct rpmsgfs_mountpt_s *fs,
+                         FAR struct rpmsgfs_ofile_s *hf, off_t pos)
+{
+  ssize_t ret = OK;
+
+  if (hf->dirty)
+    {
+      ret = rpmsgfs_client_write(fs->handle, hf->fd, hf->buf, hf->buflen);
+      rpmsgfs_attr_flush(fs);
+      hf->dirty = false;
+    }
+  else if (hf->bufpos < hf->buflen)
+    {
+      /* The host file position is ahead of the data consumed locally */
+
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd, pos, SEEK_SET);
+    }
+
+  hf->buflen = 0;
+  hf->bufpos = 0;
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_bufread
+ *
+ * Description:
+ *   Read through the readahead buffer.  Reads at least as large as the
+ *   buffer go straight to the caller's buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_bufread(FAR struct rpmsgfs_mountpt_s *fs,
+                               FAR struct rpmsgfs_ofile_s *hf,
+                               FAR char *buffer, size_t buflen, off_t pos)
+{
+  size_t nread;
+  ssize_t ret;
+
+  if (hf->dirty)
+    {
+      ret = rpmsgfs_flush(fs, hf, pos);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Serve what was read ahead */
+
+  nread = MIN(hf->buflen - hf->bufpos, buflen);
+  memcpy(buffer, hf->buf + hf->bufpos, nread);
+  hf->bufpos += nread;
+
+  if (nread == buflen)
+    {
+      return nread;
+    }
+
+  if (buflen - nread >= CONFIG_FS_RPMSGFS_BUFSIZE)
+    {
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer + nread,
+                                buflen - nread);
+    }
+  else
+    {
+      hf->buflen = 0;
+      hf->bufpos = 0;
+
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->buf,
+                                CONFIG_FS_RPMSGFS_BUFSIZE);
+      if (ret > 0)
+        {
+          hf->buflen = ret;
+          ret = MIN(ret, buflen - nread);
+          memcpy(buffer + nread, hf->buf, ret);
+          hf->bufpos = ret;
+        }
+    }
+
+  if (ret < 0)
+    {
+      return nread > 0 ? nread : ret;
+    }
+
+  return nread + ret;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_bufwrite
+ *
+ * Description:
+ *   Collect short writes in the write-behind buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_bufwrite(FAR struct rpmsgfs_mountpt_s *fs,
+                                FAR struct rpmsgfs_ofile_s *hf,
+                                FAR const char *buffer, size_t buflen,
+                                off_t pos)
+{
+  int ret;
+
+  /* Drop the readahead data, or send the pending data if the new data
+   * does not fit behind it.
+   */
+
+  if (!hf->dirty || hf->buflen + buflen > CONFIG_FS_RPMSGFS_BUFSIZE)
+    {
+      ret = rpmsgfs_flush(fs, hf, pos);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (buflen >= CONFIG_FS_RPMSGFS_BUFSIZE)
+    {
+      rpmsgfs_attr_flush(fs);
+      return rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+    }
+
+  memcpy(hf->buf + hf->buflen, buffer, buflen);
+  hf->buflen += buflen;
+  hf->dirty   = true;
+  return buflen;
+}
+#else
+#  define rpmsgfs_flush(fs, hf, pos) OK
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -314,6 +580,11 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Try to open the file in the host file system */
 
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      rpmsgfs_attr_flush(fs);
+    }
+
   hf->fd = rpmsgfs_client_open(fs->handle, path, oflags, mode);
   if (hf->fd < 0)
     {
@@ -323,6 +594,15 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+#if CONFIG_FS_RPMSGFS_BUFSIZE > 0
+  /* Without the buffer the file is simply not buffered */
+
+  hf->buf    = kmm_malloc(CONFIG_FS_RPMSGFS_BUFSIZE);
+  hf->buflen = 0;
+  hf->bufpos = 0;
+  hf->dirty  = false;
+#endif
+
   /* In write/append mode, we need to set the file pointer to the end of the
    * file.
    */
@@ -448,6 +728,11 @@ static int rpmsgfs_close(FAR struct file *filep)
 
   /* Close the host file */
 
+#if CONFIG_FS_RPMSGFS_BUFSIZE > 0
+  rpmsgfs_flush(fs, hf, filep->f_pos);
+  kmm_free(hf->buf);
+#endif
+
   rpmsgfs_client_close(fs->handle, hf->fd);
 
   /* Now free the pointer */
@@ -494,7 +779,17 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
-  ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+#if CONFIG_FS_RPMSGFS_BUFSIZE > 0
+  if (hf->buf != NULL)
+    {
+      ret = rpmsgfs_bufread(fs, hf, buffer, buflen, filep->f_pos);
+    }
+  else
+#endif
+    {
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -546,7 +841,18 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
-  ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+#if CONFIG_FS_RPMSGFS_BUFSIZE > 0
+  if (hf->buf != NULL)
+    {
+      ret = rpmsgfs_bufwrite(fs, hf, buffer, buflen, filep->f_pos);
+    }
+  else
+#endif
+    {
+      rpmsgfs_attr_flush(fs);
+      ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -590,7 +896,12 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
-  ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+  ret = rpmsgfs_flush(fs, hf, filep->f_pos);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
+    }
+
   if (ret >= 0)
     {
       filep->f_pos = ret;
@@ -633,7 +944,11 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
-  ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+  ret = rpmsgfs_flush(fs, hf, filep->f_pos);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -674,10 +989,11 @@ static int rpmsgfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  ret = rpmsgfs_flush(fs, hf, filep->f_pos);
   rpmsgfs_client_sync(fs->handle, hf->fd);
 
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -748,9 +1064,13 @@ static int rpmsgfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
-  /* Call the host to perform the read */
+  /* Send the write-behind data first, so that the size is right */
 
-  ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+  ret = rpmsgfs_flush(fs, hf, filep->f_pos);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -796,6 +1116,7 @@ static int rpmsgfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
+  rpmsgfs_attr_flush(fs);
   ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -841,7 +1162,12 @@ static int rpmsgfs_ftruncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
-  ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+  ret = rpmsgfs_flush(fs, hf, filep->f_pos);
+  if (ret >= 0)
+    {
+      rpmsgfs_attr_flush(fs);
+      ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+    }
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1189,6 +1515,8 @@ static int rpmsgfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return ret;
     }
 
+  rpmsgfs_attr_flush(fs);
+
   nxmutex_destroy(&fs->fs_lock);
   kmm_free(fs);
   return 0;
@@ -1272,6 +1600,7 @@ static int rpmsgfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host fs to perform the unlink */
 
+  rpmsgfs_attr_flush(fs);
   ret = rpmsgfs_client_unlink(fs->handle, path);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1312,6 +1641,7 @@ static int rpmsgfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attr_flush(fs);
   ret = rpmsgfs_client_mkdir(fs->handle, path, mode);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1353,6 +1683,7 @@ int rpmsgfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attr_flush(fs);
   ret = rpmsgfs_client_rmdir(fs->handle, path);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1397,6 +1728,7 @@ int rpmsgfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attr_flush(fs);
   ret = rpmsgfs_client_rename(fs->handle, oldpath, newpath);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1414,6 +1746,9 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                         FAR struct stat *buf)
 {
   FAR struct rpmsgfs_mountpt_s *fs;
+#if CONFIG_FS_RPMSGFS_ATTRCACHE_MS > 0
+  FAR struct rpmsgfs_attr_s *attr;
+#endif
   char path[PATH_MAX];
   int ret;
 
@@ -1437,8 +1772,30 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
+#if CONFIG_FS_RPMSGFS_ATTRCACHE_MS > 0
+  attr = rpmsgfs_attr_find(fs, path);
+  if (attr != NULL)
+    {
+      ret = attr->result;
+      if (ret >= 0)
+        {
+          *buf = attr->buf;
+        }
+
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+#endif
+
   ret = rpmsgfs_client_stat(fs->handle, path, buf);
 
+#if CONFIG_FS_RPMSGFS_ATTRCACHE_MS > 0
+  if (ret >= 0 || ret == -ENOENT)
+    {
+      rpmsgfs_attr_add(fs, path, ret, buf);
+    }
+#endif
+
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -1477,6 +1834,7 @@ static int rpmsgfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the chstat operation */
 
+  rpmsgfs_attr_flush(fs);
   ret = rpmsgfs_client_chstat(fs->handle, path, buf, flags);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -380,14 +380,12 @@ static int rpmsgfs_read_handler(FAR struct rpmsg_endpoint *ept,
 
   while (read < msg->count)
     {
-      rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+      rsp = rpmsg_get_reply_buffer(ept, msg, sizeof(*msg), &space);
       if (rsp == NULL)
         {
           return -ENOMEM;
         }
 
-      *rsp = *msg;
-
       space -= sizeof(*msg);
       if (space > msg->count - read)
         {
@@ -534,9 +532,17 @@ static int rpmsgfs_fstat_handler(FAR struct rpmsg_endpoint *ept,
                                  uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_fstat_s *msg = data;
+  FAR struct rpmsgfs_fstat_s *rsp;
   FAR struct file *filep;
   int ret = -ENOENT;
   struct stat buf;
+  uint32_t space;
+
+  rsp = rpmsg_get_reply_buffer(ept, msg, sizeof(msg->header), &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
 
   filep = rpmsgfs_get_file(priv, msg->fd);
   if (filep != NULL)
@@ -544,12 +550,12 @@ static int rpmsgfs_fstat_handler(FAR struct rpmsg_endpoint *ept,
       ret = file_fstat(filep, &buf);
       if (ret >= 0)
         {
-          msg->buf = buf;
+          rsp->buf = buf;
         }
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, sizeof(*msg));
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp));
 }
 
 static int rpmsgfs_ftruncate_handler(FAR struct rpmsg_endpoint *ept,
@@ -597,25 +603,34 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
                                    uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_readdir_s *msg = data;
+  FAR struct rpmsgfs_readdir_s *rsp;
   FAR struct dirent *entry;
   int ret = -ENOENT;
   FAR void *dir;
+  uint32_t space;
 
+  rsp = rpmsg_get_reply_buffer(ept, msg, sizeof(*msg), &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  len = sizeof(*rsp);
   dir = rpmsgfs_get_dir(priv, msg->fd);
   if (dir)
     {
       entry = readdir(dir);
       if (entry)
         {
-          msg->type = entry->d_type;
-          strcpy(msg->name, entry->d_name);
-          len += strlen(entry->d_name) + 1;
+          rsp->type = entry->d_type;
+          strlcpy(rsp->name, entry->d_name, space - sizeof(*rsp));
+          len += strlen(rsp->name) + 1;
           ret = 0;
         }
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, len);
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, len);
 }
 
 static int rpmsgfs_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
@@ -660,9 +675,17 @@ static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
                                   uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_statfs_s *msg = data;
+  FAR struct rpmsgfs_statfs_s *rsp;
   struct statfs buf;
+  uint32_t space;
   int ret;
 
+  rsp = rpmsg_get_reply_buffer(ept, msg, sizeof(msg->header), &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
   ret = statfs(msg->pathname, &buf);
   if (ret)
     {
@@ -670,11 +693,11 @@ static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
     }
   else
     {
-      msg->buf = buf;
+      rsp->buf = buf;
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, sizeof(*msg));
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp));
 }
 
 static int rpmsgfs_unlink_handler(FAR struct rpmsg_endpoint *ept,
@@ -733,17 +756,25 @@ static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
                                 uint32_t src, FAR void *priv)
 {
   FAR struct rpmsgfs_stat_s *msg = data;
+  FAR struct rpmsgfs_stat_s *rsp;
   struct stat buf;
+  uint32_t space;
   int ret;
 
+  rsp = rpmsg_get_reply_buffer(ept, msg, sizeof(msg->header), &space);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
   ret = nx_stat(msg->pathname, &buf, 1);
   if (ret >= 0)
     {
-      msg->buf = buf;
+      rsp->buf = buf;
     }
 
-  msg->header.result = ret;
-  return rpmsg_send(ept, msg, sizeof(*msg));
+  rsp->header.result = ret;
+  return rpmsg_send_nocopy(ept, rsp, sizeof(*rsp));
 }
 
 static int rpmsgfs_fchstat_handler(FAR struct rpmsg_endpoint *ept,
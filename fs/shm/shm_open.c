@@ -0,0 +1,242 @@
+/****************************************************************************
+ * fs/shm/shm_open.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "shm/shmfs.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_shm_open
+ ****************************************************************************/
+
+static int file_shm_open(FAR struct file *shm, FAR const char *name,
+                         int oflags, mode_t mode, FAR bool *created)
+{
+  FAR struct shmfs_object_s *object;
+  FAR struct inode *inode;
+  struct inode_search_s desc;
+  char fullpath[MAX_SHMPATH];
+  int ret;
+
+  /* Make sure that a non-NULL name is supplied */
+
+  if (name == NULL || *name == '\0')
+    {
+      return -EINVAL;
+    }
+
+  /* Skip over any leading '/'.  All shared memory paths are relative to
+   * CONFIG_FS_SHM_VFS_PATH.
+   */
+
+  while (*name == '/')
+    {
+      name++;
+    }
+
+  if (sizeof(CONFIG_FS_SHM_VFS_PATH) + 1 + strlen(name) >= MAX_SHMPATH)
+    {
+      return -ENAMETOOLONG;
+    }
+
+  snprintf(fullpath, MAX_SHMPATH, CONFIG_FS_SHM_VFS_PATH "/%s", name);
+
+  /* Make the check for the existence of the object and its creation
+   * atomic with respect to the other callers of shm_open().
+   */
+
+  sched_lock();
+
+  SETUP_SEARCH(&desc, fullpath, false);
+
+  ret = inode_find(&desc);
+  if (ret >= 0)
+    {
+      /* Something exists at this path.  Get the search results */
+
+      inode = desc.node;
+      DEBUGASSERT(inode != NULL);
+
+      if (!INODE_IS_SHM(inode))
+        {
+          ret = -ENXIO;
+          goto errout_with_inode;
+        }
+
+      if ((oflags & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+        {
+          ret = -EEXIST;
+          goto errout_with_inode;
+        }
+
+      *created = false;
+    }
+  else
+    {
+      if ((oflags & O_CREAT) == 0)
+        {
+          ret = -ENOENT;
+          goto errout_with_lock;
+        }
+
+      object = kmm_zalloc(sizeof(struct shmfs_object_s));
+      if (object == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      nxmutex_init(&object->lock);
+
+      /* Create an inode in the pseudo-filesystem at this path */
+
+      ret = inode_lock();
+      if (ret >= 0)
+        {
+          ret = inode_reserve(fullpath, mode, &inode);
+          inode_unlock();
+        }
+
+      if (ret < 0)
+        {
+          shmfs_free_object(object);
+          goto errout_with_lock;
+        }
+
+      INODE_SET_SHM(inode);
+      inode->u.i_ops   = &g_shmfs_operations;
+      inode->i_private = object;
+      inode->i_crefs   = 1;
+
+      *created = true;
+    }
+
+  /* Associate the inode with a file structure */
+
+  shm->f_oflags = oflags;
+  shm->f_pos    = 0;
+  shm->f_inode  = inode;
+  shm->f_priv   = NULL;
+
+  RELEASE_SEARCH(&desc);
+  sched_unlock();
+
+  /* O_TRUNC empties an existing object opened for writing */
+
+  if ((oflags & O_TRUNC) != 0 && (oflags & O_WROK) != 0 && !*created)
+    {
+      ret = file_truncate(shm, 0);
+      if (ret < 0)
+        {
+          file_close(shm);
+          return ret;
+        }
+    }
+
+  return OK;
+
+errout_with_inode:
+  inode_release(inode);
+
+errout_with_lock:
+  RELEASE_SEARCH(&desc);
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_open
+ *
+ * Description:
+ *   Open or create a shared memory object.  The object is created empty:
+ *   ftruncate() sets its size and mmap() with MAP_SHARED maps its memory,
+ *   the same memory for all of the tasks that open the same name.  The
+ *   memory is released when the object has been unlinked and its last
+ *   descriptor closed, so a descriptor must be kept open while it is
+ *   mapped.
+ *
+ * Input Parameters:
+ *   name   - The name of the object, below CONFIG_FS_SHM_VFS_PATH
+ *   oflags - O_RDONLY or O_RDWR, with optionally O_CREAT, O_EXCL and
+ *            O_TRUNC
+ *   mode   - The permissions of a created object
+ *
+ * Returned Value:
+ *   A file descriptor on success.  Otherwise, -1 (ERROR) is returned and
+ *   errno is set to indicate the error.
+ *
+ ****************************************************************************/
+
+int shm_open(FAR const char *name, int oflags, mode_t mode)
+{
+  struct file shm;
+  bool created;
+  int ret;
+
+  ret = file_shm_open(&shm, name, oflags, mode & ~getumask(), &created);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_allocate(shm.f_inode, shm.f_oflags, shm.f_pos, shm.f_priv,
+                      0, false);
+  if (ret < 0)
+    {
+      file_close(&shm);
+      if (created)
+        {
+          shm_unlink(name);
+        }
+
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -0,0 +1,126 @@
+/****************************************************************************
+ * fs/shm/shm_unlink.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "shm/shmfs.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_unlink
+ *
+ * Description:
+ *   Remove the name of a shared memory object.  Its memory is released
+ *   once all of its descriptors are closed.
+ *
+ * Input Parameters:
+ *   name - The name of the object
+ *
+ * Returned Value:
+ *   0 (OK) on success.  Otherwise, -1 (ERROR) is returned and errno is set
+ *   to indicate the error.
+ *
+ ****************************************************************************/
+
+int shm_unlink(FAR const char *name)
+{
+  FAR struct inode *inode;
+  struct inode_search_s desc;
+  char fullpath[MAX_SHMPATH];
+  int ret;
+
+  while (*name == '/')
+    {
+      name++;
+    }
+
+  snprintf(fullpath, MAX_SHMPATH, CONFIG_FS_SHM_VFS_PATH "/%s", name);
+
+  SETUP_SEARCH(&desc, fullpath, false);
+
+  sched_lock();
+  ret = inode_find(&desc);
+  if (ret < 0)
+    {
+      goto errout_with_search;
+    }
+
+  inode = desc.node;
+  DEBUGASSERT(inode != NULL);
+
+  if (!INODE_IS_SHM(inode))
+    {
+      ret = -ENXIO;
+      goto errout_with_inode;
+    }
+
+  ret = inode_lock();
+  if (ret < 0)
+    {
+      goto errout_with_inode;
+    }
+
+  /* Remove the inode from the tree.  Because we hold a reference, it is
+   * not freed now but marked FSNODEFLAG_DELETED.
+   */
+
+  ret = inode_remove(fullpath);
+  DEBUGASSERT(ret >= 0 || ret == -EBUSY);
+  inode_unlock();
+
+  /* Release our reference, and the memory if the object is not open */
+
+  if (inode->i_crefs <= 1 && inode->i_private != NULL)
+    {
+      shmfs_free_object(inode->i_private);
+      inode->i_private = NULL;
+    }
+
+  inode_release(inode);
+  RELEASE_SEARCH(&desc);
+  sched_unlock();
+  return OK;
+
+errout_with_inode:
+  inode_release(inode);
+
+errout_with_search:
+  RELEASE_SEARCH(&desc);
+  sched_unlock();
+  set_errno(-ret);
+  return ERROR;
+}
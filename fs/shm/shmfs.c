@@ -0,0 +1,324 @@
+/****************************************************************************
+ * fs/shm/shmfs.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Shared memory objects are inodes of the pseudo file system below
+ * CONFIG_FS_SHM_VFS_PATH.  Their memory is one block of the user heap,
+ * sized by ftruncate() and handed out as is by mmap(), so that every task
+ * mapping an object accesses the same memory without any copy.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "inode/inode.h"
+#include "shm/shmfs.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     shmfs_close(FAR struct file *filep);
+static ssize_t shmfs_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+static ssize_t shmfs_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen);
+static off_t   shmfs_seek(FAR struct file *filep, off_t offset, int whence);
+static int     shmfs_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct file_operations g_shmfs_operations =
+{
+  NULL,             /* open */
+  shmfs_close,      /* close */
+  shmfs_read,       /* read */
+  shmfs_write,      /* write */
+  shmfs_seek,       /* seek */
+  shmfs_ioctl,      /* ioctl */
+  NULL              /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL            /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmfs_truncate
+ *
+ * Description:
+ *   Set the size of an object.  The new memory is zeroed.  Once mapped,
+ *   the memory cannot move anymore and the size can no longer change.
+ *
+ ****************************************************************************/
+
+static int shmfs_truncate(FAR struct shmfs_object_s *object, off_t length)
+{
+  FAR void *paddr;
+  int ret;
+
+  if (length < 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&object->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (length == object->length)
+    {
+      goto out;
+    }
+
+  if (object->mapped)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  if (length == 0)
+    {
+      kumm_free(object->paddr);
+      paddr = NULL;
+    }
+  else
+    {
+      paddr = kumm_realloc(object->paddr, length);
+      if (paddr == NULL)
+        {
+          ret = -ENOMEM;
+          goto out;
+        }
+
+      if (length > object->length)
+        {
+          memset((FAR uint8_t *)paddr + object->length, 0,
+                 length - object->length);
+        }
+    }
+
+  object->paddr  = paddr;
+  object->length = length;
+
+out:
+  nxmutex_unlock(&object->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shmfs_close
+ ****************************************************************************/
+
+static int shmfs_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  /* Release the memory with the last reference of an unlinked object */
+
+  if (inode->i_crefs <= 1 && (inode->i_flags & FSNODEFLAG_DELETED))
+    {
+      if (inode->i_private != NULL)
+        {
+          shmfs_free_object(inode->i_private);
+          inode->i_private = NULL;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmfs_read
+ ****************************************************************************/
+
+static ssize_t shmfs_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct shmfs_object_s *object = filep->f_inode->i_private;
+  ssize_t nread = 0;
+
+  nxmutex_lock(&object->lock);
+  if (filep->f_pos < object->length)
+    {
+      nread = MIN(buflen, object->length - filep->f_pos);
+      memcpy(buffer, (FAR uint8_t *)object->paddr + filep->f_pos, nread);
+      filep->f_pos += nread;
+    }
+
+  nxmutex_unlock(&object->lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: shmfs_write
+ *
+ * Description:
+ *   Write within the size of the object:  Only ftruncate() resizes it.
+ *
+ ****************************************************************************/
+
+static ssize_t shmfs_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen)
+{
+  FAR struct shmfs_object_s *object = filep->f_inode->i_private;
+  ssize_t nwritten = 0;
+
+  nxmutex_lock(&object->lock);
+  if (filep->f_pos < object->length)
+    {
+      nwritten = MIN(buflen, object->length - filep->f_pos);
+      memcpy((FAR uint8_t *)object->paddr + filep->f_pos, buffer, nwritten);
+      filep->f_pos += nwritten;
+    }
+  else if (buflen > 0)
+    {
+      nwritten = -EFBIG;
+    }
+
+  nxmutex_unlock(&object->lock);
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: shmfs_seek
+ ****************************************************************************/
+
+static off_t shmfs_seek(FAR struct file *filep, off_t offset, int whence)
+{
+  FAR struct shmfs_object_s *object = filep->f_inode->i_private;
+  off_t position;
+
+  switch (whence)
+    {
+      case SEEK_SET:
+        position = offset;
+        break;
+
+      case SEEK_CUR:
+        position = filep->f_pos + offset;
+        break;
+
+      case SEEK_END:
+        position = object->length + offset;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  if (position < 0)
+    {
+      return -EINVAL;
+    }
+
+  filep->f_pos = position;
+  return position;
+}
+
+/****************************************************************************
+ * Name: shmfs_ioctl
+ ****************************************************************************/
+
+static int shmfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct shmfs_object_s *object = filep->f_inode->i_private;
+  FAR void **ppv = (FAR void **)((uintptr_t)arg);
+  int ret;
+
+  switch (cmd)
+    {
+      case FIOC_MMAP:
+        if (ppv == NULL)
+          {
+            return -EINVAL;
+          }
+
+        ret = nxmutex_lock(&object->lock);
+        if (ret < 0)
+          {
+            return ret;
+          }
+
+        /* Map the memory itself:  This is what makes it shared */
+
+        if (object->paddr == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            *ppv           = object->paddr;
+            object->mapped = true;
+          }
+
+        nxmutex_unlock(&object->lock);
+        return ret;
+
+      case FIOC_TRUNCATE:
+        return shmfs_truncate(object, (off_t)arg);
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmfs_free_object
+ ****************************************************************************/
+
+void shmfs_free_object(FAR struct shmfs_object_s *object)
+{
+  kumm_free(object->paddr);
+  nxmutex_destroy(&object->lock);
+  kmm_free(object);
+}
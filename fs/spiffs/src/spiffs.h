@@ -108,6 +108,17 @@ typedef int32_t(*spiffs_erase_t)(uint32_t addr, uint32_t size);
 
 /* spiffs SPI configuration struct */
 
+/* One entry of the RAM object lookup cache */
+
+#if CONFIG_SPIFFS_LUCACHE_SIZE > 0
+struct spiffs_lucache_s
+{
+  int16_t objid;                    /* Object ID, with SPIFFS_OBJID_NDXFLAG */
+  int16_t spndx;                    /* Span index within the object */
+  int16_t pgndx;                    /* Page index last found for them */
+};
+#endif
+
 /* This structure represents the current state of an SPIFFS volume */
 
 struct spiffs_file_s;               /* Forward reference */
@@ -145,6 +156,9 @@ struct spiffs_s
   int16_t lu_blkndx;                /* Cursor when searching, block index */
   int16_t max_erase_count;          /* Max erase count amongst all blocks */
   uint8_t pages_per_block;          /* Pages per block */
+#if CONFIG_SPIFFS_LUCACHE_SIZE > 0
+  struct spiffs_lucache_s lucache[CONFIG_SPIFFS_LUCACHE_SIZE];
+#endif
 };
 
 /* This structure represents the state of an open file */
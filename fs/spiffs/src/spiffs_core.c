@@ -278,6 +278,78 @@ static int spiffs_objlu_find_id_and_span_callback(FAR struct spiffs_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: spiffs_lucache_slot
+ *
+ * Description:
+ *   Return the object lookup cache entry for an object ID and span index.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPIFFS_LUCACHE_SIZE > 0
+static FAR struct spiffs_lucache_s *
+spiffs_lucache_slot(FAR struct spiffs_s *fs, int16_t objid, int16_t spndx)
+{
+  uint32_t hash = (uint16_t)objid * 31 + (uint16_t)spndx;
+
+  return &fs->lucache[hash % CONFIG_SPIFFS_LUCACHE_SIZE];
+}
+
+/****************************************************************************
+ * Name: spiffs_lucache_find
+ *
+ * Description:
+ *   Return the page of an object ID and span index from the object lookup
+ *   cache.  The entry may be stale, so it is confirmed as
+ *   spiffs_objlu_find_id_and_span() would find it:  the object lookup
+ *   entry of the page must hold the object ID and its header must match.
+ *
+ ****************************************************************************/
+
+static int spiffs_lucache_find(FAR struct spiffs_s *fs, int16_t objid,
+                               int16_t spndx, int16_t exclusion_pgndx,
+                               FAR int16_t *pgndx)
+{
+  FAR struct spiffs_lucache_s *slot;
+  int16_t luobjid;
+  int16_t blkndx;
+  int entry;
+  int ret;
+
+  slot = spiffs_lucache_slot(fs, objid, spndx);
+  if (slot->objid != objid || slot->spndx != spndx ||
+      slot->pgndx <= 0 || slot->pgndx >= fs->total_pages ||
+      SPIFFS_IS_LOOKUP_PAGE(fs, slot->pgndx))
+    {
+      return -ENOENT;
+    }
+
+  blkndx = SPIFFS_BLOCK_FOR_PAGE(fs, slot->pgndx);
+  entry  = SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, slot->pgndx);
+
+  ret = spiffs_cache_read(fs, SPIFFS_OP_T_OBJ_LU | SPIFFS_OP_C_READ, 0,
+                          SPIFFS_BLOCK_TO_PADDR(fs, blkndx) +
+                          entry * sizeof(int16_t),
+                          sizeof(int16_t), (FAR uint8_t *)&luobjid);
+  if (ret < 0 || luobjid != objid)
+    {
+      return -ENOENT;
+    }
+
+  ret = spiffs_objlu_find_id_and_span_callback(fs, objid, blkndx, entry,
+                                               exclusion_pgndx ?
+                                               &exclusion_pgndx : 0,
+                                               &spndx);
+  if (ret != OK)
+    {
+      return -ENOENT;
+    }
+
+  *pgndx = slot->pgndx;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: spiffs_find_objhdr_pgndx_callback
  *
@@ -980,6 +1052,20 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
   int16_t blkndx;
   int entry;
   int ret;
+#if CONFIG_SPIFFS_LUCACHE_SIZE > 0
+  FAR struct spiffs_lucache_s *slot;
+  int16_t found;
+
+  if (spiffs_lucache_find(fs, objid, spndx, exclusion_pgndx, &found) == OK)
+    {
+      if (pgndx != NULL)
+        {
+          *pgndx = found;
+        }
+
+      return OK;
+    }
+#endif
 
   ret = spiffs_foreach_objlu(fs, fs->lu_blkndx, fs->lu_entry,
                              SPIFFS_VIS_CHECK_ID, objid,
@@ -1002,6 +1088,16 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
       *pgndx = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx, entry);
     }
 
+#if CONFIG_SPIFFS_LUCACHE_SIZE > 0
+  if (ret >= 0)
+    {
+      slot        = spiffs_lucache_slot(fs, objid, spndx);
+      slot->objid = objid;
+      slot->spndx = spndx;
+      slot->pgndx = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx, entry);
+    }
+#endif
+
   fs->lu_blkndx = blkndx;
   fs->lu_entry  = entry;
 
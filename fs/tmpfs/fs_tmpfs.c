@@ -49,8 +49,8 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
+#if CONFIG_FS_TMPFS_FILE_CHUNKSIZE <= 0
+#  error CONFIG_FS_TMPFS_FILE_CHUNKSIZE must be positive
 #endif
 
 #define tmpfs_lock(fs) \
@@ -89,6 +89,7 @@ struct tmpfs_dir_s
 
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
@@ -254,6 +255,33 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tmpfs_free_data
+ ****************************************************************************/
+
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo)
+{
+  unsigned int i;
+
+  for (i = tfo->tfo_nmapped; i < tfo->tfo_nchunks; i++)
+    {
+      kmm_free(tfo->tfo_chunks[i]);
+    }
+
+  if (tfo->tfo_nmapped > 0)
+    {
+      kmm_free(tfo->tfo_chunks[0]);
+    }
+
+  kmm_free(tfo->tfo_chunks);
+
+  tfo->tfo_alloc   = 0;
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_nindex  = 0;
+  tfo->tfo_nmapped = 0;
+  tfo->tfo_chunks  = NULL;
+}
+
 /****************************************************************************
  * Name: tmpfs_realloc_file
  ****************************************************************************/
@@ -261,54 +289,190 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
-  FAR uint8_t *newdata;
-  size_t allocsize;
-  size_t delta;
+  FAR uint8_t **newindex;
+  FAR uint8_t *chunk;
+  unsigned int nchunks;
+  unsigned int nindex;
 
-  /* Are we growing or shrinking the object? */
+  nchunks = (newsize + TMPFS_CHUNKSIZE - 1) / TMPFS_CHUNKSIZE;
 
-  if (newsize <= tfo->tfo_alloc)
+  /* Release everything if the file is truncated to zero length */
+
+  if (nchunks == 0)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      tmpfs_free_data(tfo);
+      tfo->tfo_size = 0;
+      return OK;
+    }
+
+  /* Grow the chunk index geometrically so that appends are amortized O(1).
+   * Only the index is ever reallocated, the file data never moves.
+   */
 
-      if (newsize > 0)
+  if (nchunks > tfo->tfo_nindex)
+    {
+      nindex = tfo->tfo_nindex < 4 ? 4 : 2 * tfo->tfo_nindex;
+      if (nindex < nchunks)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          nindex = nchunks;
+        }
 
-          delta = tfo->tfo_alloc - newsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+      newindex = kmm_realloc(tfo->tfo_chunks, nindex * sizeof(*newindex));
+      if (newindex == NULL)
+        {
+          return -ENOMEM;
+        }
 
-              tfo->tfo_size = newsize;
-              return OK;
-            }
+      tfo->tfo_chunks = newindex;
+      tfo->tfo_nindex = nindex;
+    }
+
+  /* Add the missing chunks */
+
+  while (tfo->tfo_nchunks < nchunks)
+    {
+      chunk = kmm_malloc(TMPFS_CHUNKSIZE);
+      if (chunk == NULL)
+        {
+          tfo->tfo_alloc = (size_t)tfo->tfo_nchunks * TMPFS_CHUNKSIZE;
+          return -ENOMEM;
         }
+
+      tfo->tfo_chunks[tfo->tfo_nchunks++] = chunk;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
+  /* Free the chunks past the new end of the file.  Mapped chunks are only
+   * released together with the whole file.
    */
 
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  while (tfo->tfo_nchunks > nchunks && tfo->tfo_nchunks > tfo->tfo_nmapped)
+    {
+      kmm_free(tfo->tfo_chunks[--tfo->tfo_nchunks]);
+    }
+
+  tfo->tfo_alloc = (size_t)tfo->tfo_nchunks * TMPFS_CHUNKSIZE;
+  tfo->tfo_size  = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_copyout
+ *
+ * Description:
+ *   Copy nbytes of file data starting at pos to buffer.
+ *
+ ****************************************************************************/
+
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, FAR uint8_t *buffer,
+                          off_t pos, size_t nbytes)
+{
+  unsigned int index = pos / TMPFS_CHUNKSIZE;
+  size_t offset = pos % TMPFS_CHUNKSIZE;
+  size_t ncopy;
+
+  while (nbytes > 0)
+    {
+      ncopy = TMPFS_CHUNKSIZE - offset;
+      if (ncopy > nbytes)
+        {
+          ncopy = nbytes;
+        }
+
+      memcpy(buffer, tfo->tfo_chunks[index] + offset, ncopy);
+      buffer += ncopy;
+      nbytes -= ncopy;
+      offset  = 0;
+      index++;
+    }
+}
 
-  /* Realloc the file object */
+/****************************************************************************
+ * Name: tmpfs_copyin
+ *
+ * Description:
+ *   Copy nbytes from buffer to the file data starting at pos, or clear
+ *   them if buffer is NULL.  The chunks must already be allocated.
+ *
+ ****************************************************************************/
+
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo,
+                         FAR const uint8_t *buffer, off_t pos,
+                         size_t nbytes)
+{
+  unsigned int index = pos / TMPFS_CHUNKSIZE;
+  size_t offset = pos % TMPFS_CHUNKSIZE;
+  size_t ncopy;
 
-  newdata = kmm_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
+  while (nbytes > 0)
+    {
+      ncopy = TMPFS_CHUNKSIZE - offset;
+      if (ncopy > nbytes)
+        {
+          ncopy = nbytes;
+        }
+
+      if (buffer != NULL)
+        {
+          memcpy(tfo->tfo_chunks[index] + offset, buffer, ncopy);
+          buffer += ncopy;
+        }
+      else
+        {
+          memset(tfo->tfo_chunks[index] + offset, 0, ncopy);
+        }
+
+      nbytes -= ncopy;
+      offset  = 0;
+      index++;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_map_file
+ *
+ * Description:
+ *   Return the address of the file data as one contiguous region.  A file
+ *   that spans several chunks is moved once into a single allocation;
+ *   chunks appended afterwards are allocated individually again.
+ *
+ ****************************************************************************/
+
+static int tmpfs_map_file(FAR struct tmpfs_file_s *tfo, FAR void **ppv)
+{
+  FAR uint8_t *base;
+  unsigned int i;
+
+  if (tfo->tfo_nchunks <= 1 || tfo->tfo_nmapped == tfo->tfo_nchunks)
+    {
+      *ppv = tfo->tfo_nchunks > 0 ? tfo->tfo_chunks[0] : NULL;
+      return OK;
+    }
+
+  base = kmm_malloc((size_t)tfo->tfo_nchunks * TMPFS_CHUNKSIZE);
+  if (base == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Return the new address of the reallocated file object */
+  tmpfs_copyout(tfo, base, 0, (size_t)tfo->tfo_nchunks * TMPFS_CHUNKSIZE);
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
+  for (i = tfo->tfo_nmapped; i < tfo->tfo_nchunks; i++)
+    {
+      kmm_free(tfo->tfo_chunks[i]);
+    }
+
+  if (tfo->tfo_nmapped > 0)
+    {
+      kmm_free(tfo->tfo_chunks[0]);
+    }
+
+  for (i = 0; i < tfo->tfo_nchunks; i++)
+    {
+      tfo->tfo_chunks[i] = base + (size_t)i * TMPFS_CHUNKSIZE;
+    }
+
+  tfo->tfo_nmapped = tfo->tfo_nchunks;
+  *ppv = base;
   return OK;
 }
 
@@ -348,7 +512,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       kmm_free(tfo);
     }
 
@@ -522,7 +686,11 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
   tfo->tfo_refs  = 1;
   tfo->tfo_flags = 0;
   tfo->tfo_size  = 0;
-  tfo->tfo_data  = NULL;
+
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_nindex  = 0;
+  tfo->tfo_nmapped = 0;
+  tfo->tfo_chunks  = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1149,7 +1317,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1442,7 +1610,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       kmm_free(tfo);
       return OK;
     }
@@ -1488,7 +1656,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
@@ -1496,15 +1668,8 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
-    }
+  tmpfs_copyout(tfo, (FAR uint8_t *)buffer, startpos, nread);
+  filep->f_pos += nread;
 
   /* Release the lock on the file */
 
@@ -1521,6 +1686,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+  size_t oldsize;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1551,25 +1717,26 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
     {
       /* Reallocate the file to handle the write past the end of the file. */
 
+      oldsize = tfo->tfo_size;
       ret = tmpfs_realloc_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
-    }
 
-  /* Copy data from the memory object to the user buffer */
+      /* Clear any hole between the old end of the file and the write */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-      filep->f_pos += nwritten;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      if (startpos > oldsize)
+        {
+          tmpfs_copyin(tfo, NULL, oldsize, startpos - oldsize);
+        }
     }
 
+  /* Copy data from the user buffer to the memory object */
+
+  tmpfs_copyin(tfo, (FAR const uint8_t *)buffer, startpos, nwritten);
+  filep->f_pos += nwritten;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1648,6 +1815,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct tmpfs_file_s *tfo;
   FAR void **ppv = (FAR void**)arg;
+  int ret;
 
   finfo("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1666,8 +1834,15 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
        * the file.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
-      return OK;
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = tmpfs_map_file(tfo, ppv);
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1807,7 +1982,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
       if (length > oldsize)
         {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+          tmpfs_copyin(tfo, NULL, oldsize, length - oldsize);
         }
 
       ret = OK;
@@ -2251,7 +2426,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       kmm_free(tfo);
     }
 
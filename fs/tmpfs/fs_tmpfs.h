@@ -40,6 +40,10 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is stored in chunks of this size */
+
+#define TMPFS_CHUNKSIZE   CONFIG_FS_TMPFS_FILE_CHUNKSIZE
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -107,6 +111,11 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The file data is held in TMPFS_CHUNKSIZE chunks; tfo_chunks[i] holds
+ * the bytes starting at i * TMPFS_CHUNKSIZE.  The first tfo_nmapped
+ * chunks are a single contiguous allocation starting at tfo_chunks[0]
+ * (created by FIOC_MMAP), the others are allocated individually.
  */
 
 struct tmpfs_file_s
@@ -121,9 +130,12 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;   /* See TFO_FLAG_* definitions */
+  size_t        tfo_size;    /* Valid file size */
+  unsigned int  tfo_nchunks; /* Number of allocated data chunks */
+  unsigned int  tfo_nindex;  /* Number of entries in tfo_chunks[] */
+  unsigned int  tfo_nmapped; /* Number of contiguous leading chunks */
+  FAR uint8_t **tfo_chunks;  /* Chunk index */
 };
 
 /* This structure represents one instance of a TMPFS file system */
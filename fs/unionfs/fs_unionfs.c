@@ -39,6 +39,7 @@
 #include <fixedmath.h>
 #include <debug.h>
 
+#include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/unionfs.h>
@@ -58,6 +59,17 @@
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+/* Results of the lookup cache other than the index of a file system */
+
+#define UNIONFS_LOOKUP_MISS  -1      /* The path is not cached */
+#define UNIONFS_LOOKUP_NONE  2       /* The path is on neither file system */
+
+#define UNIONFS_NLOOKUP      CONFIG_FS_UNIONFS_LOOKUP_CACHE
+
+/* The initial size of the table of the names listed from file system 1 */
+
+#define UNIONFS_NNAMES       16
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,8 +80,18 @@ struct unionfs_dir_s
   uint8_t fu_ndx;                      /* Index of file system being enumerated */
   bool fu_eod;                         /* True: At end of directory */
   bool fu_prefix[2];                   /* True: Fake directory in prefix */
+  bool fu_nonames;                     /* True: fu_names is incomplete */
   FAR char *fu_relpath;                /* Path being enumerated */
   FAR struct fs_dirent_s *fu_lower[2]; /* dirent struct used by contained file system */
+
+  /* The hashes of the names listed from file system 1, an open addressed
+   * table, so that the shadowed entries of file system 2 are recognized
+   * without a lookup on file system 1.
+   */
+
+  FAR uint32_t *fu_names;
+  uint16_t fu_nnames;                  /* Number of names in fu_names */
+  uint16_t fu_size;                    /* Size of fu_names, a power of 2 */
 };
 
 /* This structure describes one contained file system mountpoint */
@@ -80,6 +102,16 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+/* This structure describes one entry of the lookup cache */
+
+#if UNIONFS_NLOOKUP > 0
+struct unionfs_lookup_s
+{
+  FAR char *ul_relpath;              /* Cached path, NULL if unused */
+  uint8_t ul_ndx;                    /* File system holding the path */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
@@ -88,6 +120,14 @@ struct unionfs_inode_s
   mutex_t ui_lock;                   /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+
+  /* The file system that held each of the recently looked up paths, so
+   * that the lookup does not fail on file system 1 first every time.
+   */
+
+#if UNIONFS_NLOOKUP > 0
+  struct unionfs_lookup_s ui_lookup[UNIONFS_NLOOKUP];
+#endif
 };
 
 /* This structure descries one opened file */
@@ -134,6 +174,24 @@ static int     unionfs_trystatdir(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
 static int     unionfs_trystatfile(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
+#if UNIONFS_NLOOKUP > 0
+static int     unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
+static void    unionfs_lookup_set(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int ndx);
+static void    unionfs_lookup_invalidate(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
+static void    unionfs_lookup_flush(FAR struct unionfs_inode_s *ui);
+#else
+#  define unionfs_lookup(ui,relpath)     UNIONFS_LOOKUP_MISS
+#  define unionfs_lookup_set(ui,relpath,ndx)
+#  define unionfs_lookup_invalidate(ui,relpath)
+#  define unionfs_lookup_flush(ui)
+#endif
+static void    unionfs_addname(FAR struct unionfs_dir_s *udir,
+                 FAR const char *name);
+static bool    unionfs_shadowed(FAR struct unionfs_inode_s *ui,
+                 FAR struct unionfs_dir_s *udir, FAR const char *name);
 static FAR char *unionfs_relpath(FAR const char *path,
                  FAR const char *name);
 
@@ -749,6 +807,250 @@ static FAR char *unionfs_relpath(FAR const char *path, FAR const char *name)
     }
 }
 
+#if UNIONFS_NLOOKUP > 0
+/****************************************************************************
+ * Name: unionfs_lookup
+ *
+ * Description:
+ *   Return the file system that held a path when it was last looked up,
+ *   UNIONFS_LOOKUP_NONE if it was on neither, or UNIONFS_LOOKUP_MISS if
+ *   the path is not cached.  The cache is only valid as long as the
+ *   contained file systems are modified through the union file system.
+ *
+ * Assumptions:
+ *   The caller holds ui_lock.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                          FAR const char *relpath)
+{
+  FAR struct unionfs_lookup_s *ul;
+
+  ul = &ui->ui_lookup[crc32((FAR const uint8_t *)relpath,
+                            strlen(relpath)) % UNIONFS_NLOOKUP];
+  if (ul->ul_relpath != NULL && strcmp(ul->ul_relpath, relpath) == 0)
+    {
+      return ul->ul_ndx;
+    }
+
+  return UNIONFS_LOOKUP_MISS;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_set
+ *
+ * Description:
+ *   Record the file system that holds a path, replacing the cached path
+ *   that shares its entry.  Failures to allocate are not errors:  The path
+ *   is then just not cached.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_set(FAR struct unionfs_inode_s *ui,
+                               FAR const char *relpath, int ndx)
+{
+  FAR struct unionfs_lookup_s *ul;
+
+  ul = &ui->ui_lookup[crc32((FAR const uint8_t *)relpath,
+                            strlen(relpath)) % UNIONFS_NLOOKUP];
+  if (ul->ul_relpath == NULL || strcmp(ul->ul_relpath, relpath) != 0)
+    {
+      if (ul->ul_relpath != NULL)
+        {
+          kmm_free(ul->ul_relpath);
+        }
+
+      ul->ul_relpath = strdup(relpath);
+    }
+
+  ul->ul_ndx = ndx;
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_invalidate
+ *
+ * Description:
+ *   Forget where a path is, e.g. because it is being created or removed.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_invalidate(FAR struct unionfs_inode_s *ui,
+                                      FAR const char *relpath)
+{
+  FAR struct unionfs_lookup_s *ul;
+
+  ul = &ui->ui_lookup[crc32((FAR const uint8_t *)relpath,
+                            strlen(relpath)) % UNIONFS_NLOOKUP];
+  if (ul->ul_relpath != NULL && strcmp(ul->ul_relpath, relpath) == 0)
+    {
+      kmm_free(ul->ul_relpath);
+      ul->ul_relpath = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup_flush
+ *
+ * Description:
+ *   Forget all the cached paths when the file system is destroyed.
+ *
+ ****************************************************************************/
+
+static void unionfs_lookup_flush(FAR struct unionfs_inode_s *ui)
+{
+  int i;
+
+  for (i = 0; i < UNIONFS_NLOOKUP; i++)
+    {
+      if (ui->ui_lookup[i].ul_relpath != NULL)
+        {
+          kmm_free(ui->ui_lookup[i].ul_relpath);
+          ui->ui_lookup[i].ul_relpath = NULL;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_addname
+ *
+ * Description:
+ *   Record a name listed from file system 1 while file system 2 remains to
+ *   be listed.  If the table cannot grow, unionfs_shadowed() falls back to
+ *   looking up every name of file system 2 on file system 1.
+ *
+ ****************************************************************************/
+
+static void unionfs_addname(FAR struct unionfs_dir_s *udir,
+                            FAR const char *name)
+{
+  FAR uint32_t *names;
+  uint32_t hash;
+  uint32_t i;
+  int size;
+
+  if (udir->fu_nonames)
+    {
+      return;
+    }
+
+  /* Keep the table at most half full */
+
+  if (udir->fu_nnames >= udir->fu_size / 2)
+    {
+      size = udir->fu_size > 0 ? 2 * udir->fu_size : UNIONFS_NNAMES;
+      names = size <= UINT16_MAX ? kmm_zalloc(size * sizeof(uint32_t)) :
+                                   NULL;
+      if (names == NULL)
+        {
+          udir->fu_nonames = true;
+          return;
+        }
+
+      /* Rehash the names recorded so far */
+
+      for (i = 0; i < udir->fu_size; i++)
+        {
+          hash = udir->fu_names[i];
+          if (hash != 0)
+            {
+              while (names[hash & (size - 1)] != 0)
+                {
+                  hash++;
+                }
+
+              names[hash & (size - 1)] = udir->fu_names[i];
+            }
+        }
+
+      if (udir->fu_names != NULL)
+        {
+          kmm_free(udir->fu_names);
+        }
+
+      udir->fu_names = names;
+      udir->fu_size  = size;
+    }
+
+  /* Zero marks the free entries */
+
+  hash = crc32((FAR const uint8_t *)name, strlen(name));
+  hash = hash != 0 ? hash : 1;
+
+  for (i = hash; udir->fu_names[i & (udir->fu_size - 1)] != 0; i++)
+    {
+      if (udir->fu_names[i & (udir->fu_size - 1)] == hash)
+        {
+          return;
+        }
+    }
+
+  udir->fu_names[i & (udir->fu_size - 1)] = hash;
+  udir->fu_nnames++;
+}
+
+/****************************************************************************
+ * Name: unionfs_shadowed
+ *
+ * Description:
+ *   Return true if a name listed from file system 2 is shadowed by an
+ *   entry of the same name on file system 1.  Only the names whose hash
+ *   was listed from file system 1 are looked up there.
+ *
+ ****************************************************************************/
+
+static bool unionfs_shadowed(FAR struct unionfs_inode_s *ui,
+                             FAR struct unionfs_dir_s *udir,
+                             FAR const char *name)
+{
+  FAR struct unionfs_mountpt_s *um0;
+  FAR char *relpath;
+  struct stat buf;
+  uint32_t hash;
+  uint32_t i;
+  int tmp;
+
+  if (!udir->fu_nonames)
+    {
+      if (udir->fu_size == 0)
+        {
+          return false;
+        }
+
+      hash = crc32((FAR const uint8_t *)name, strlen(name));
+      hash = hash != 0 ? hash : 1;
+
+      for (i = hash; udir->fu_names[i & (udir->fu_size - 1)] != hash; i++)
+        {
+          if (udir->fu_names[i & (udir->fu_size - 1)] == 0)
+            {
+              return false;
+            }
+        }
+    }
+
+  /* Get the relative path to the same file on file system 1.  NOTE: on
+   * any failures we just assume that the file is not a duplicate.
+   */
+
+  relpath = unionfs_relpath(udir->fu_relpath, name);
+  if (relpath == NULL)
+    {
+      return false;
+    }
+
+  /* Check if anything exists at this path on file system 1.
+   * REVISIT: We could allow files and directories to have duplicate names.
+   */
+
+  um0 = &ui->ui_fs[0];
+  tmp = unionfs_trystat(um0->um_node, relpath, um0->um_prefix, &buf);
+  kmm_free(relpath);
+
+  return tmp >= 0;
+}
+
 /****************************************************************************
  * Name: unionfs_unbind_child
  ****************************************************************************/
@@ -842,6 +1144,7 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
 
   /* And finally free the allocated unionfs state structure as well */
 
+  unionfs_lookup_flush(ui);
   nxmutex_destroy(&ui->ui_lock);
   kmm_free(ui);
 }
@@ -856,6 +1159,8 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  int ndx;
+  int ret1;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -883,29 +1188,28 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_lock;
     }
 
-  /* Try to open the file on file system 1 */
-
-  um = &ui->ui_fs[0];
-  DEBUGASSERT(um != NULL && um->um_node != NULL &&
-              um->um_node->u.i_mops != NULL);
-
-  uf->uf_file.f_oflags = filep->f_oflags;
-  uf->uf_file.f_pos    = 0;
-  uf->uf_file.f_inode  = um->um_node;
-  uf->uf_file.f_priv   = NULL;
+  /* Try the file system that held the path the last time first.  A file
+   * that may be created is looked for on file system 1 first, as ever.
+   */
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
-  if (ret >= 0)
+  if ((oflags & O_CREAT) != 0)
     {
-      /* Successfully opened on file system 1 */
-
-      uf->uf_ndx = 0;
+      unionfs_lookup_invalidate(ui, relpath);
+      ndx = UNIONFS_LOOKUP_MISS;
     }
   else
     {
-      /* Try to open the file on file system 1 */
+      ndx = unionfs_lookup(ui, relpath);
+    }
 
-      um  = &ui->ui_fs[1];
+  ret = -ENOENT;
+  if (ndx == UNIONFS_LOOKUP_NONE)
+    {
+      goto errout_with_uf;
+    }
+  else if (ndx != UNIONFS_LOOKUP_MISS)
+    {
+      um = &ui->ui_fs[ndx];
 
       uf->uf_file.f_oflags = filep->f_oflags;
       uf->uf_file.f_pos    = 0;
@@ -914,14 +1218,60 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
 
       ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
                             mode);
-      if (ret < 0)
+      uf->uf_ndx = ndx;
+    }
+
+  if (ret < 0)
+    {
+      /* Try to open the file on file system 1 */
+
+      um = &ui->ui_fs[0];
+      DEBUGASSERT(um != NULL && um->um_node != NULL &&
+                  um->um_node->u.i_mops != NULL);
+
+      uf->uf_file.f_oflags = filep->f_oflags;
+      uf->uf_file.f_pos    = 0;
+      uf->uf_file.f_inode  = um->um_node;
+      uf->uf_file.f_priv   = NULL;
+
+      ret1 = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                             mode);
+      ret  = ret1;
+      if (ret >= 0)
         {
-          goto errout_with_lock;
+          /* Successfully opened on file system 1 */
+
+          uf->uf_ndx = 0;
         }
+      else
+        {
+          /* Try to open the file on file system 2 */
+
+          um  = &ui->ui_fs[1];
+
+          uf->uf_file.f_oflags = filep->f_oflags;
+          uf->uf_file.f_pos    = 0;
+          uf->uf_file.f_inode  = um->um_node;
+          uf->uf_file.f_priv   = NULL;
+
+          ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix,
+                                oflags, mode);
+          if (ret < 0)
+            {
+              if (ret1 == -ENOENT && ret == -ENOENT)
+                {
+                  unionfs_lookup_set(ui, relpath, UNIONFS_LOOKUP_NONE);
+                }
+
+              goto errout_with_uf;
+            }
 
-      /* Successfully opened on file system 1 */
+          /* Successfully opened on file system 2 */
+
+          uf->uf_ndx = 1;
+        }
 
-      uf->uf_ndx = 1;
+      unionfs_lookup_set(ui, relpath, uf->uf_ndx);
     }
 
   /* Increment the open reference count */
@@ -932,7 +1282,11 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   /* Save our private data in the file structure */
 
   filep->f_priv = (FAR void *)uf;
-  ret = OK;
+  nxmutex_unlock(&ui->ui_lock);
+  return OK;
+
+errout_with_uf:
+  kmm_free(uf);
 
 errout_with_lock:
   nxmutex_unlock(&ui->ui_lock);
@@ -1601,6 +1955,11 @@ static int unionfs_closedir(FAR struct inode *mountpt,
       kmm_free(udir->fu_relpath);
     }
 
+  if (udir->fu_names != NULL)
+    {
+      kmm_free(udir->fu_names);
+    }
+
   kmm_free(udir);
 
   /* Decrement the count of open reference.  If that count would go to zero
@@ -1630,11 +1989,8 @@ static int unionfs_readdir(FAR struct inode *mountpt,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
-  FAR struct unionfs_mountpt_s *um0;
   FAR const struct mountpt_operations *ops;
   FAR struct unionfs_dir_s *udir;
-  FAR char *relpath;
-  struct stat buf;
   bool duplicate;
   int ret = -ENOSYS;
 
@@ -1767,34 +2123,9 @@ static int unionfs_readdir(FAR struct inode *mountpt,
                    * in file system 1.
                    */
 
-                  relpath = unionfs_relpath(udir->fu_relpath, um->um_prefix);
-                  if (relpath)
+                  if (unionfs_shadowed(ui, udir, um->um_prefix))
                     {
-                      int tmp;
-
-                      /* Check if anything exists at this path on file
-                       * system 1
-                       */
-
-                      um0 = &ui->ui_fs[0];
-                      tmp = unionfs_trystat(um0->um_node, relpath,
-                                            um0->um_prefix, &buf);
-
-                      /* Free the allocated relpath */
-
-                      kmm_free(relpath);
-
-                      /* Check for a duplicate */
-
-                      if (tmp >= 0)
-                        {
-                          /* There is something there!
-                           * REVISIT: We could allow files and directories to
-                           * have duplicate names.
-                           */
-
-                          return -ENOENT;
-                        }
+                      return -ENOENT;
                     }
 
                   return OK;
@@ -1833,45 +2164,25 @@ static int unionfs_readdir(FAR struct inode *mountpt,
                 }
             }
 
+          /* Remember the names listed from file system 1 if file system 2
+           * is listed next.
+           */
+
+          if (ret >= 0 && udir->fu_ndx == 0 &&
+              (udir->fu_lower[1] != NULL || udir->fu_prefix[1]))
+            {
+              unionfs_addname(udir, entry->d_name);
+            }
+
           /* Did we successfully read a directory from file system 2?  If
            * so, we need to omit an duplicates that should be occluded by
            * the matching file on file system 1 (if we are enumerating
            * file system 1).
            */
 
-          duplicate = false;
-          if (ret >= 0 && udir->fu_ndx == 1 && udir->fu_lower[0] != NULL)
-            {
-              /* Get the relative path to the same file on file system 1.
-               * NOTE: the on any failures we just assume that the filep
-               * is not a duplicate.
-               */
-
-              relpath = unionfs_relpath(udir->fu_relpath, entry->d_name);
-              if (relpath)
-                {
-                  int tmp;
-
-                  /* Check if anything exists at this path on file system 1 */
-
-                  um0 = &ui->ui_fs[0];
-                  tmp = unionfs_trystat(um0->um_node, relpath,
-                                        um0->um_prefix, &buf);
-                  if (tmp >= 0)
-                    {
-                      /* There is something there!
-                       * REVISIT: We could allow files and directories to
-                       * have duplicate names.
-                       */
-
-                      duplicate = true;
-                    }
-
-                  /* Free the allocated relpath */
-
-                  kmm_free(relpath);
-                }
-            }
+          duplicate = ret >= 0 && udir->fu_ndx == 1 &&
+                      udir->fu_lower[0] != NULL &&
+                      unionfs_shadowed(ui, udir, entry->d_name);
         }
       while (duplicate);
     }
@@ -2182,6 +2493,18 @@ static int unionfs_unlink(FAR struct inode *mountpt,
               relpath != NULL);
   ui = (FAR struct unionfs_inode_s *)mountpt->i_private;
 
+  /* Get exclusive access to the file system data structures */
+
+  ret = nxmutex_lock(&ui->ui_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The path will be somewhere else */
+
+  unionfs_lookup_invalidate(ui, relpath);
+
   /* Check if some exists at this path on file system 1.  This might be
    * a file or a directory
    */
@@ -2221,6 +2544,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
         }
     }
 
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
@@ -2246,22 +2570,36 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = (FAR struct unionfs_inode_s *)mountpt->i_private;
 
+  /* Get exclusive access to the file system data structures */
+
+  ret = nxmutex_lock(&ui->ui_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Is there anything with this name on either file system? */
 
   um  = &ui->ui_fs[0];
   ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
   if (ret >= 0)
     {
-      return -EEXIST;
+      ret = -EEXIST;
+      goto errout_with_lock;
     }
 
   um  = &ui->ui_fs[1];
   ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
   if (ret >= 0)
     {
-      return -EEXIST;
+      ret = -EEXIST;
+      goto errout_with_lock;
     }
 
+  /* The path will be somewhere else */
+
+  unionfs_lookup_invalidate(ui, relpath);
+
   /* Try to create the directory on both file systems. */
 
   um  = &ui->ui_fs[0];
@@ -2275,7 +2613,11 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
    * read-only and the other is write-able?
    */
 
-  return (ret1 >= 0 || ret2 >= 0) ? OK : ret1;
+  ret = (ret1 >= 0 || ret2 >= 0) ? OK : ret1;
+
+errout_with_lock:
+  nxmutex_unlock(&ui->ui_lock);
+  return ret;
 }
 
 /****************************************************************************
@@ -2297,6 +2639,20 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
               relpath != NULL);
   ui = (FAR struct unionfs_inode_s *)mountpt->i_private;
 
+  /* Get exclusive access to the file system data structures */
+
+  tmp = nxmutex_lock(&ui->ui_lock);
+  if (tmp < 0)
+    {
+      return tmp;
+    }
+
+  /* The path will be somewhere else.  Nothing is below it on a file
+   * system that the directory is removed from.
+   */
+
+  unionfs_lookup_invalidate(ui, relpath);
+
   /* We really don't know any better so we will try to remove the directory
    * from both file systems.
    */
@@ -2314,7 +2670,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
       if (ret < 0)
         {
-          return ret;
+          goto errout_with_lock;
         }
     }
 
@@ -2337,6 +2693,8 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
     }
 
+errout_with_lock:
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
@@ -2362,6 +2720,19 @@ static int unionfs_rename(FAR struct inode *mountpt,
 
   DEBUGASSERT(oldrelpath != NULL && oldrelpath != NULL);
 
+  /* Get exclusive access to the file system data structures */
+
+  tmp = nxmutex_lock(&ui->ui_lock);
+  if (tmp < 0)
+    {
+      return tmp;
+    }
+
+  /* Only files are renamed:  No other paths change */
+
+  unionfs_lookup_invalidate(ui, oldrelpath);
+  unionfs_lookup_invalidate(ui, newrelpath);
+
   /* Is there a file with this name on file system 1 */
 
   um   = &ui->ui_fs[0];
@@ -2382,7 +2753,8 @@ static int unionfs_rename(FAR struct inode *mountpt,
            * file of the same relative path will become visible.
            */
 
-          return OK;
+          ret = OK;
+          goto errout_with_lock;
         }
     }
 
@@ -2403,6 +2775,8 @@ static int unionfs_rename(FAR struct inode *mountpt,
                               um->um_prefix);
     }
 
+errout_with_lock:
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
@@ -2415,6 +2789,8 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+  int ndx;
+  int ret1;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2425,30 +2801,61 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = (FAR struct unionfs_inode_s *)mountpt->i_private;
 
-  /* stat this path on file system 1 */
+  /* Get exclusive access to the file system data structures */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  ret = nxmutex_lock(&ui->ui_lock);
+  if (ret < 0)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
-
-      return OK;
+      return ret;
     }
 
-  /* stat failed on the file system 1.  Try again on file system 2. */
+  /* Try the file system that held the path the last time first */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  ret = -ENOENT;
+  ndx = unionfs_lookup(ui, relpath);
+  if (ndx == 0 || ndx == 1)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      um  = &ui->ui_fs[ndx];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          ret = OK;
+          goto out;
+        }
+    }
 
-      return OK;
+  if (ndx != UNIONFS_LOOKUP_NONE)
+    {
+      /* stat this path on file system 1 */
+
+      um   = &ui->ui_fs[0];
+      ret1 = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret1 >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
+
+          unionfs_lookup_set(ui, relpath, 0);
+          ret = OK;
+          goto out;
+        }
+
+      /* stat failed on the file system 1.  Try again on file system 2. */
+
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          unionfs_lookup_set(ui, relpath, 1);
+          ret = OK;
+          goto out;
+        }
+
+      if (ret1 == -ENOENT && ret == -ENOENT)
+        {
+          unionfs_lookup_set(ui, relpath, UNIONFS_LOOKUP_NONE);
+        }
     }
 
   /* Special case the unionfs root directory when both file systems are
@@ -2480,6 +2887,8 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
         }
     }
 
+out:
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
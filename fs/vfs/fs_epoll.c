@@ -38,18 +38,44 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
+#include <nuttx/queue.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of buckets of g_epoll_hash, a power of 2 */
+
+#define EPOLL_NHASH         16
+
+#define epoll_hash(f) \
+  (&g_epoll_hash[((uintptr_t)(f) / sizeof(struct file)) & (EPOLL_NHASH - 1)])
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+typedef struct epoll_head_s epoll_head_t;
+
+/* The poll of an epoll node stays set up from EPOLL_CTL_ADD until the node
+ * is deleted or its fd is closed, so that epoll_wait() never needs to
+ * visit the nodes that are not ready.
+ */
+
 struct epoll_node_s
 {
-  struct list_node      node;
+  struct list_node      node;     /* Node in the interest or the free list */
+  struct list_node      rdnode;   /* Node in the ready list */
+  struct list_node      lvnode;   /* Node in the rearm list */
+  dq_entry_t            fnode;    /* Node in g_epoll_hash */
+  FAR epoll_head_t     *eph;      /* The epoll instance of the node */
   epoll_data_t          data;
+  bool                  armed;    /* The poll is set up on the file */
+  FAR struct file      *filep;    /* The file of the fd, NULL once closed */
   struct pollfd         pfd;
 };
 
@@ -61,13 +87,21 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
-  struct list_node      setup;    /* The setup list, store all the setuped
+  spinlock_t            rdlock;   /* Protects the ready list, which is
+                                   * updated from the poll callback that
+                                   * may run in interrupt context.
+                                   */
+  struct list_node      interest; /* The interest list, store all the added
                                    * epoll node.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      ready;    /* The ready list, store all the epoll
+                                   * node notified but not yet reported.
+                                   */
+  struct list_node      rearm;    /* The rearm list, store the level
+                                   * triggered epoll node reported by the
+                                   * last epoll_wait(), these epoll node
+                                   * should be setup again to check whether
+                                   * they are still ready.
                                    */
   struct list_node      free;     /* The free list, store all the freed epoll
                                    * node.
@@ -78,8 +112,6 @@ struct epoll_head_s
                                    */
 };
 
-typedef struct epoll_head_s epoll_head_t;
-
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -88,9 +120,6 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents);
 
 /****************************************************************************
  * Private Data
@@ -110,6 +139,14 @@ static const struct file_operations g_epoll_ops =
 #endif
 };
 
+/* The epoll nodes bound to an open file, hashed by the address of the
+ * file so that epoll_fileclose() finds them, and the lock that serializes
+ * the setup and the teardown of their polls with the close of the file.
+ */
+
+static dq_queue_t g_epoll_hash[EPOLL_NHASH];
+static mutex_t g_epoll_lock = NXMUTEX_INITIALIZER;
+
 static struct inode g_epoll_inode =
 {
   NULL,                   /* i_parent */
@@ -151,6 +188,139 @@ static FAR epoll_head_t *epoll_head_from_fd(int fd)
   return (FAR epoll_head_t *)filep->f_priv;
 }
 
+/* The poll callback of every epoll node.  It only queues the node to the
+ * ready list and wakes up epoll_wait(), and may run in interrupt context.
+ */
+
+static void epoll_default_cb(FAR struct pollfd *fds)
+{
+  FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+  int semcount = 0;
+
+  flags = spin_lock_irqsave(&eph->rdlock);
+  if (!list_in_list(&epn->rdnode))
+    {
+      list_add_tail(&eph->ready, &epn->rdnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rdlock, flags);
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
+    }
+}
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rdlock);
+  if (list_in_list(&epn->rdnode))
+    {
+      list_delete(&epn->rdnode);
+    }
+
+  epn->pfd.revents = 0;
+  spin_unlock_irqrestore(&eph->rdlock, flags);
+}
+
+/* epoll_arm(), epoll_disarm(), epoll_bind() and epoll_unbind() are
+ * called with g_epoll_lock held, so that the file of the node cannot be
+ * closed meanwhile.
+ */
+
+static int epoll_arm(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  int ret;
+
+  /* If events are already pending, the setup reports them at once through
+   * epoll_default_cb().
+   */
+
+  epoll_unready(eph, epn);
+  ret = file_poll(epn->filep, &epn->pfd, true);
+  if (ret < 0)
+    {
+      ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
+           epn->pfd.fd, epn->pfd.events, ret);
+      return ret;
+    }
+
+  epn->armed = true;
+  return ret;
+}
+
+static void epoll_disarm(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  if (epn->armed)
+    {
+      file_poll(epn->filep, &epn->pfd, false);
+      epn->armed = false;
+    }
+
+  epoll_unready(eph, epn);
+  if (list_in_list(&epn->lvnode))
+    {
+      list_delete(&epn->lvnode);
+    }
+}
+
+/* Bind a new node to the open file of its fd and set up its poll */
+
+static int epoll_bind(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(epn->pfd.fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  epn->filep = filep;
+  ret = epoll_arm(eph, epn);
+  if (ret < 0)
+    {
+      epn->filep = NULL;
+      return ret;
+    }
+
+  dq_addlast(&epn->fnode, epoll_hash(filep));
+  return ret;
+}
+
+static void epoll_unbind(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  epoll_disarm(eph, epn);
+  if (epn->filep != NULL)
+    {
+      dq_rem(&epn->fnode, epoll_hash(epn->filep));
+      epn->filep = NULL;
+    }
+}
+
+static FAR epoll_node_t *epoll_find(FAR epoll_head_t *eph, int fd)
+{
+  FAR epoll_node_t *epn;
+
+  /* The nodes of the closed fds have an fd of -1 */
+
+  list_for_every_entry(&eph->interest, epn, epoll_node_t, node)
+    {
+      if (epn->pfd.fd == fd && fd >= 0)
+        {
+          return epn;
+        }
+    }
+
+  return NULL;
+}
+
 static int epoll_do_open(FAR struct file *filep)
 {
   FAR epoll_head_t *eph = filep->f_priv;
@@ -185,17 +355,21 @@ static int epoll_do_close(FAR struct file *filep)
   if (eph->crefs <= 0)
     {
       nxmutex_destroy(&eph->lock);
-      list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+      nxmutex_lock(&g_epoll_lock);
+      list_for_every_entry(&eph->interest, epn, epoll_node_t, node)
         {
-          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          epoll_unbind(eph, epn);
         }
 
+      nxmutex_unlock(&g_epoll_lock);
+
       list_for_every_entry_safe(&eph->extend, epn, tmp, epoll_node_t, node)
         {
           list_delete(&epn->node);
           kmm_free(epn);
         }
 
+      nxsem_destroy(&eph->sem);
       kmm_free(eph);
     }
 
@@ -231,8 +405,9 @@ static int epoll_do_create(int size, int flags)
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
-  list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
+  list_initialize(&eph->interest);
+  list_initialize(&eph->ready);
+  list_initialize(&eph->rearm);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
   for (i = 0; i < size; i++)
@@ -246,6 +421,7 @@ static int epoll_do_create(int size, int flags)
   if (fd < 0)
     {
       nxmutex_destroy(&eph->lock);
+      nxsem_destroy(&eph->sem);
       kmm_free(eph);
       set_errno(-fd);
       return ERROR;
@@ -254,73 +430,180 @@ static int epoll_do_create(int size, int flags)
   return fd;
 }
 
-static int epoll_setup(FAR epoll_head_t *eph)
+/* Set up again the level triggered nodes reported by the last wait so
+ * that the ones that are still ready are queued again.  Only the nodes
+ * reported last time are visited.
+ */
+
+static void epoll_rearm(FAR epoll_head_t *eph)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
-  int ret;
 
-  ret = nxmutex_lock(&eph->lock);
-  if (ret < 0)
+  if (list_is_empty(&eph->rearm))
     {
-      return ret;
+      return;
     }
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+  nxmutex_lock(&g_epoll_lock);
+  while ((epn = list_remove_head_type(&eph->rearm, epoll_node_t,
+                                      lvnode)) != NULL)
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
-
-      epn->pfd.revents = 0;
-      ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
-      if (ret < 0)
+      if (epn->armed)
         {
-          ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
-               epn->pfd.fd, epn->pfd.events, ret);
-          break;
+          epoll_disarm(eph, epn);
+          epoll_arm(eph, epn);
         }
-
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
     }
 
-  nxmutex_unlock(&eph->lock);
-  return ret;
+  nxmutex_unlock(&g_epoll_lock);
 }
 
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents)
+/* Move up to maxevents nodes from the ready list to evs */
+
+static int epoll_collect(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  bool closed;
   int i = 0;
 
-  nxmutex_lock(&eph->lock);
-
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      if (epn->pfd.revents != 0 && i < maxevents)
+      flags = spin_lock_irqsave(&eph->rdlock);
+      epn = list_remove_head_type(&eph->ready, epoll_node_t, rdnode);
+      if (epn != NULL)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-          list_delete(&epn->node);
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->free, &epn->node);
-            }
-          else
+          revents = epn->pfd.revents;
+          epn->pfd.revents = 0;
+          closed = epn->filep == NULL;
+        }
+
+      spin_unlock_irqrestore(&eph->rdlock, flags);
+
+      if (epn == NULL)
+        {
+          break;
+        }
+
+      if (closed)
+        {
+          /* epoll_fileclose() queued the node of a closed fd, free it */
+
+          if (list_in_list(&epn->lvnode))
             {
-              list_add_tail(&eph->teardown, &epn->node);
+              list_delete(&epn->lvnode);
             }
+
+          list_delete(&epn->node);
+          list_add_tail(&eph->free, &epn->node);
+          continue;
+        }
+
+      if (revents == 0 || !epn->armed)
+        {
+          continue;
+        }
+
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
+
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
+        {
+          /* Disabled until it is rearmed with EPOLL_CTL_MOD */
+
+          nxmutex_lock(&g_epoll_lock);
+          epoll_disarm(eph, epn);
+          nxmutex_unlock(&g_epoll_lock);
+        }
+      else if ((epn->pfd.events & EPOLLET) == 0 &&
+               !list_in_list(&epn->lvnode))
+        {
+          list_add_tail(&eph->rearm, &epn->lvnode);
         }
     }
 
-  nxmutex_unlock(&eph->lock);
   return i;
 }
 
+static int epoll_do_wait(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents, int timeout)
+{
+  clock_t deadline = 0;
+  clock_t now;
+  int ret;
+
+  if (evs == NULL || maxevents <= 0)
+    {
+      return -EINVAL;
+    }
+
+  if (timeout > 0)
+    {
+      clock_t ticks;
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+                (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
+
+      deadline = clock_systime_ticks() + ticks;
+    }
+
+  ret = nxmutex_lock(&eph->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  epoll_rearm(eph);
+
+  for (; ; )
+    {
+      ret = epoll_collect(eph, evs, maxevents);
+      nxmutex_unlock(&eph->lock);
+      if (ret > 0 || timeout == 0)
+        {
+          return ret;
+        }
+
+      /* Wait the poll ready.  The semaphore may hold a stale count from
+       * nodes that were already reported, so recheck the ready list.
+       */
+
+      if (timeout > 0)
+        {
+          now = clock_systime_ticks();
+          if ((sclock_t)(deadline - now) <= 0)
+            {
+              return 0;
+            }
+
+          ret = nxsem_tickwait(&eph->sem, deadline - now);
+        }
+      else
+        {
+          ret = nxsem_wait(&eph->sem);
+        }
+
+      if (ret < 0 && ret != -ETIMEDOUT)
+        {
+          return ret;
+        }
+
+      ret = nxmutex_lock(&eph->lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -411,22 +694,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
         /* Check repetition */
 
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        if (epoll_find(eph, fd) != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
+            ret = -EEXIST;
+            goto err;
           }
 
         if (list_is_empty(&eph->free))
@@ -455,97 +726,67 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           }
 
         epn = list_remove_head_type(&eph->free, epoll_node_t, node);
+        epn->eph         = eph;
         epn->data        = ev->data;
+        epn->armed       = false;
+        epn->filep       = NULL;
         epn->pfd.events  = ev->events;
         epn->pfd.fd      = fd;
-        epn->pfd.arg     = &eph->sem;
-        epn->pfd.cb      = poll_default_cb;
+        epn->pfd.arg     = epn;
+        epn->pfd.cb      = epoll_default_cb;
         epn->pfd.revents = 0;
 
-        ret = poll_fdsetup(fd, &epn->pfd, true);
+        nxmutex_lock(&g_epoll_lock);
+        ret = epoll_bind(eph, epn);
+        nxmutex_unlock(&g_epoll_lock);
         if (ret < 0)
           {
+            epoll_unready(eph, epn);
             list_add_tail(&eph->free, &epn->node);
             goto err;
           }
 
-        list_add_tail(&eph->setup, &epn->node);
+        list_add_tail(&eph->interest, &epn->node);
         break;
 
       case EPOLL_CTL_DEL:
         finfo("%p CTL DEL: fd=%d\n", eph, fd);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                poll_fdsetup(fd, &epn->pfd, false);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            ret = -ENOENT;
+            goto err;
           }
 
+        nxmutex_lock(&g_epoll_lock);
+        epoll_unbind(eph, epn);
+        nxmutex_unlock(&g_epoll_lock);
+        list_delete(&epn->node);
+        list_add_tail(&eph->free, &epn->node);
         break;
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != ev->events)
-                  {
-                    poll_fdsetup(fd, &epn->pfd, false);
-
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
+            ret = -ENOENT;
+            goto err;
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        /* Always set up again, this also rearms an EPOLLONESHOT node */
+
+        nxmutex_lock(&g_epoll_lock);
+        epoll_disarm(eph, epn);
+
+        epn->data        = ev->data;
+        epn->pfd.events  = ev->events;
+
+        ret = epoll_arm(eph, epn);
+        nxmutex_unlock(&g_epoll_lock);
+        if (ret < 0)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != ev->events)
-                  {
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                break;
-              }
+            goto err;
           }
 
         break;
@@ -555,9 +796,9 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         goto err;
     }
 
-out:
   nxmutex_unlock(&eph->lock);
   return OK;
+
 err:
   nxmutex_unlock(&eph->lock);
 err_without_lock:
@@ -582,55 +823,17 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
       return ERROR;
     }
 
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
-  /* Wait the poll ready */
-
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
-
-  if (timeout == 0)
-    {
-      ret = OK;
-    }
-  else if (timeout > 0)
-    {
-      clock_t ticks;
-#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
-    defined(CONFIG_HAVE_LONG_LONG)
-      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
-                (USEC_PER_TICK - 1)) /
-              USEC_PER_TICK;
-#else
-      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
-              MSEC_PER_TICK;
-#endif
-
-      ret = nxsem_tickwait(&eph->sem, ticks);
-      if (ret == -ETIMEDOUT)
-        {
-          ret = OK;
-        }
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
-
+  ret = epoll_do_wait(eph, evs, maxevents, timeout);
   nxsig_procmask(SIG_SETMASK, &oldsigmask, NULL);
+
   if (ret < 0)
     {
-      goto err;
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return epoll_teardown(eph, evs, maxevents);
-
-err:
-  set_errno(-ret);
-  return ERROR;
+  return ret;
 }
 
 /****************************************************************************
@@ -656,50 +859,83 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
       return ERROR;
     }
 
-  ret = epoll_setup(eph);
+  ret = epoll_do_wait(eph, evs, maxevents, timeout);
   if (ret < 0)
     {
-      goto err;
+      set_errno(-ret);
+      return ERROR;
     }
 
-  /* Wait the poll ready */
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_fileclose
+ *
+ * Description:
+ *   Tear down the polls that epoll nodes have set up on an open file that
+ *   is being closed, while the file is still valid.  The nodes are dropped
+ *   from the interest lists as on EPOLL_CTL_DEL, and freed by the next
+ *   epoll_wait().
+ *
+ * Input Parameters:
+ *   filep - The file in the file list of the task group, before it is
+ *           cleared.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_fileclose(FAR struct file *filep)
+{
+  FAR dq_queue_t *hash = epoll_hash(filep);
+  FAR epoll_node_t *epn;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  irqstate_t flags;
+
+  /* Most files are never watched by epoll, do not take the lock for them */
 
-  if (timeout == 0)
+  if (dq_empty(hash))
     {
-      ret = OK;
+      return;
     }
-  else if (timeout > 0)
+
+  nxmutex_lock(&g_epoll_lock);
+  for (node = dq_peek(hash); node != NULL; node = next)
     {
-      clock_t ticks;
-#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
-    defined(CONFIG_HAVE_LONG_LONG)
-      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
-                (USEC_PER_TICK - 1)) /
-              USEC_PER_TICK;
-#else
-      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
-              MSEC_PER_TICK;
-#endif
+      next = dq_next(node);
+      epn  = container_of(node, epoll_node_t, fnode);
+      if (epn->filep != filep)
+        {
+          continue;
+        }
 
-      ret = nxsem_tickwait(&eph->sem, ticks);
-      if (ret == -ETIMEDOUT)
+      if (epn->armed)
         {
-          ret = OK;
+          file_poll(filep, &epn->pfd, false);
+          epn->armed = false;
         }
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
 
-  if (ret < 0)
-    {
-      goto err;
-    }
+      dq_rem(node, hash);
+
+      /* The interest list is protected by the lock of the epoll instance,
+       * which cannot be taken here.  Hand the node to epoll_collect()
+       * through the ready list instead.
+       */
 
-  return epoll_teardown(eph, evs, maxevents);
+      flags = spin_lock_irqsave(&epn->eph->rdlock);
+      epn->filep       = NULL;
+      epn->pfd.fd      = -1;
+      epn->pfd.revents = 0;
+      if (!list_in_list(&epn->rdnode))
+        {
+          list_add_tail(&epn->eph->ready, &epn->rdnode);
+        }
 
-err:
-  set_errno(-ret);
-  return ERROR;
+      spin_unlock_irqrestore(&epn->eph->rdlock, flags);
+    }
+
+  nxmutex_unlock(&g_epoll_lock);
 }
@@ -35,10 +35,60 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched.h>
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: select_allocset
+ *
+ * Description:
+ *   Return a zeroed array of npfds descriptors: the cached array of the
+ *   thread if it is large enough, else a new one.
+ *
+ ****************************************************************************/
+
+static FAR struct pollfd *select_allocset(int npfds)
+{
+#ifdef CONFIG_FS_SELECT_CACHE
+  FAR struct tcb_s *rtcb = nxsched_self();
+
+  if (rtcb->npollset < npfds)
+    {
+      /* Grow the cache, the previous content does not matter */
+
+      kmm_free(rtcb->pollset);
+      rtcb->pollset  = kmm_malloc(npfds * sizeof(struct pollfd));
+      rtcb->npollset = rtcb->pollset != NULL ? npfds : 0;
+      if (rtcb->pollset == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  memset(rtcb->pollset, 0, npfds * sizeof(struct pollfd));
+  return rtcb->pollset;
+#else
+  return kmm_zalloc(npfds * sizeof(struct pollfd));
+#endif
+}
+
+/****************************************************************************
+ * Name: select_freeset
+ ****************************************************************************/
+
+static void select_freeset(FAR struct pollfd *pollset)
+{
+#ifndef CONFIG_FS_SELECT_CACHE
+  kmm_free(pollset);
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,7 +128,10 @@
 int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
            FAR fd_set *exceptfds, FAR struct timeval *timeout)
 {
-  struct pollfd *pollset = NULL;
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  struct pollfd pollstack[CONFIG_FS_SELECT_NSTACKFDS];
+#endif
+  FAR struct pollfd *pollset = NULL;
   int fd;
   int npfds;
   int msec;
@@ -109,13 +162,21 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  /* Allocate the descriptor list for poll() */
+  /* Allocate the descriptor list for poll().  Small lists live on the
+   * stack.
+   */
 
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  if (npfds <= CONFIG_FS_SELECT_NSTACKFDS)
+    {
+      pollset = pollstack;
+      memset(pollset, 0, npfds * sizeof(struct pollfd));
+    }
+  else
+#endif
   if (npfds > 0)
     {
-      pollset = (FAR struct pollfd *)
-        kmm_zalloc(npfds * sizeof(struct pollfd));
-
+      pollset = select_allocset(npfds);
       if (pollset == NULL)
         {
           set_errno(ENOMEM);
@@ -251,6 +312,12 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  kmm_free(pollset);
+#if CONFIG_FS_SELECT_NSTACKFDS > 0
+  if (pollset != pollstack)
+#endif
+    {
+      select_freeset(pollset);
+    }
+
   return ret;
 }
@@ -25,9 +25,11 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <errno.h>
 
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 
@@ -35,6 +37,87 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: copymapped
+ *
+ * Description:
+ *   Write the data of a directly addressable input file (romfs XIP, tmpfs,
+ *   ...) from where it lies, without a bounce buffer.  The input file
+ *   position is advanced by the number of bytes transferred.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, a negated errno value on failure, or
+ *   -ENOTTY if the input file cannot be addressed directly.
+ *
+ ****************************************************************************/
+
+static ssize_t copymapped(FAR struct file *outfile, FAR struct file *infile,
+                          size_t count)
+{
+  FAR const uint8_t *map;
+  FAR void *addr;
+  struct stat st;
+  ssize_t nbyteswritten;
+  size_t ntransferred;
+  off_t pos;
+
+  if (file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&addr)) < 0 ||
+      file_fstat(infile, &st) < 0)
+    {
+      return -ENOTTY;
+    }
+
+  pos = file_seek(infile, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      return pos;
+    }
+
+  /* Never go beyond the end of the file */
+
+  if (pos >= st.st_size)
+    {
+      return 0;
+    }
+
+  if (count > st.st_size - pos)
+    {
+      count = st.st_size - pos;
+    }
+
+  map = (FAR const uint8_t *)addr + pos;
+  for (ntransferred = 0; ntransferred < count; )
+    {
+      nbyteswritten = file_write(outfile, map + ntransferred,
+                                 count - ntransferred);
+      if (nbyteswritten < 0)
+        {
+          /* Report an error only if nothing has been transferred */
+
+          if (ntransferred == 0)
+            {
+              return nbyteswritten;
+            }
+
+          break;
+        }
+
+      ntransferred += nbyteswritten;
+    }
+
+  pos = file_seek(infile, pos + ntransferred, SEEK_SET);
+  if (pos < 0)
+    {
+      return pos;
+    }
+
+  return ntransferred;
+}
+
+/****************************************************************************
+ * Name: copyfile
+ ****************************************************************************/
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         off_t *offset, size_t count)
 {
@@ -44,6 +127,7 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
   ssize_t nbytesread;
   ssize_t nbyteswritten;
   size_t  ntransferred;
+  ssize_t ret;
   bool endxfr;
 
   /* Get the current file position. */
@@ -69,6 +153,15 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
         }
     }
 
+  /* Write the data in place if the input file is directly addressable */
+
+  ret = copymapped(outfile, infile, count);
+  if (ret != -ENOTTY)
+    {
+      ntransferred = ret;
+      goto out;
+    }
+
   /* Allocate an I/O buffer */
 
   iobuffer = kmm_malloc(CONFIG_SENDFILE_BUFSIZE);
@@ -196,6 +289,8 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 
   kmm_free(iobuffer);
 
+out:
+
   /* Return the current file position */
 
   if (offset)
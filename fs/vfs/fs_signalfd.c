@@ -0,0 +1,569 @@
+/****************************************************************************
+ * fs/vfs/fs_signalfd.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A signalfd consumes the signals of its mask, which the threads of the
+ * task group must block, with nxsig_timedwait() from read().  No signal
+ * action is dispatched for them, so an event loop can take signals as it
+ * takes the data of the other file descriptors that it polls.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/mutex.h>
+#include <nuttx/signal.h>
+
+#include <sys/signalfd.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the internal state of the driver */
+
+struct signalfd_priv_s
+{
+#ifdef CONFIG_SIGNAL_FD_POLL
+  dq_entry_t        node;        /* Entry of g_signalfd_list */
+#endif
+  mutex_t           lock;        /* Enforces device exclusive access */
+  sigset_t          mask;        /* The signals read from the signalfd */
+  pid_t             pid;         /* The task group of the signalfd */
+  unsigned int      minor;       /* signalfd minor number */
+  uint8_t           crefs;       /* References counts on signalfd */
+
+  /* The following is a list if poll structures of threads waiting for
+   * driver events.
+   */
+
+#ifdef CONFIG_SIGNAL_FD_POLL
+  FAR struct pollfd *fds[CONFIG_SIGNAL_FD_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int signalfd_file_open(FAR struct file *filep);
+static int signalfd_file_close(FAR struct file *filep);
+
+static ssize_t signalfd_file_read(FAR struct file *filep, FAR char *buffer,
+                                  size_t len);
+#ifdef CONFIG_SIGNAL_FD_POLL
+static int signalfd_file_poll(FAR struct file *filep,
+                              FAR struct pollfd *fds, bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_signalfd_fops =
+{
+  signalfd_file_open,  /* open */
+  signalfd_file_close, /* close */
+  signalfd_file_read,  /* read */
+  NULL,                /* write */
+  NULL,                /* seek */
+  NULL,                /* ioctl */
+#ifdef CONFIG_SIGNAL_FD_POLL
+  signalfd_file_poll   /* poll */
+#else
+  NULL                 /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL               /* unlink */
+#endif
+};
+
+#ifdef CONFIG_SIGNAL_FD_POLL
+/* The signalfds that signalfd_notify() may have to wake up.  The list and
+ * the poll slots are modified in a critical section, because signals are
+ * also sent from interrupt handlers.
+ */
+
+static dq_queue_t g_signalfd_list;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct signalfd_priv_s *signalfd_allocdev(void)
+{
+  FAR struct signalfd_priv_s *dev;
+
+  dev = (FAR struct signalfd_priv_s *)
+    kmm_zalloc(sizeof(struct signalfd_priv_s));
+  if (dev)
+    {
+      /* Initialize the private structure */
+
+      nxmutex_init(&dev->lock);
+      nxmutex_lock(&dev->lock);
+    }
+
+  return dev;
+}
+
+static void signalfd_destroy(FAR struct signalfd_priv_s *dev)
+{
+#ifdef CONFIG_SIGNAL_FD_POLL
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  dq_rem(&dev->node, &g_signalfd_list);
+  leave_critical_section(flags);
+#endif
+
+  nxmutex_destroy(&dev->lock);
+  kmm_free(dev);
+}
+
+static unsigned int signalfd_get_unique_minor(void)
+{
+  static unsigned int minor;
+
+  return minor++;
+}
+
+#ifdef CONFIG_SIGNAL_FD_POLL
+/****************************************************************************
+ * Name: signalfd_pollnotify
+ *
+ * Description:
+ *   Report POLLIN to the pollers of a signalfd if one of the signals of
+ *   its mask is pending for the calling task group.
+ *
+ ****************************************************************************/
+
+static void signalfd_pollnotify(FAR struct signalfd_priv_s *dev)
+{
+  sigset_t pending;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (sigpending(&pending) == OK && (pending & dev->mask) != 0)
+    {
+      poll_notify(dev->fds, CONFIG_SIGNAL_FD_NPOLLWAITERS, POLLIN);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+static int signalfd_file_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *priv = inode->i_private;
+  int ret;
+
+  /* Get exclusive access to the device structures */
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("crefs: %d <%s>\n", priv->crefs, inode->i_name);
+
+  if (priv->crefs >= 255)
+    {
+      /* More than 255 opens; uint8_t would overflow to zero */
+
+      ret = -EMFILE;
+    }
+  else
+    {
+      /* Save the new open count on success */
+
+      priv->crefs += 1;
+      ret = OK;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+static int signalfd_file_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *priv = inode->i_private;
+  int ret;
+
+  /* devpath: SIGNAL_FD_VFS_PATH + /sfd (4) + %u (10) + null char (1) */
+
+  char devpath[sizeof(CONFIG_SIGNAL_FD_VFS_PATH) + 4 + 10 + 1];
+
+  /* Get exclusive access to the device structures */
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  finfo("crefs: %d <%s>\n", priv->crefs, inode->i_name);
+
+  /* Decrement the references to the driver.  If the reference count will
+   * decrement to 0, then uninitialize the driver.
+   */
+
+  if (priv->crefs > 1)
+    {
+      /* Just decrement the reference count and release the semaphore */
+
+      priv->crefs -= 1;
+      nxmutex_unlock(&priv->lock);
+      return OK;
+    }
+
+  /* Re-create the path to the driver. */
+
+  finfo("destroy\n");
+  sprintf(devpath, CONFIG_SIGNAL_FD_VFS_PATH "/sfd%u", priv->minor);
+
+  /* Will be unregistered later after close is done */
+
+  unregister_driver(devpath);
+
+  DEBUGASSERT(nxmutex_is_locked(&priv->lock));
+  signalfd_destroy(priv);
+
+  return OK;
+}
+
+static ssize_t signalfd_file_read(FAR struct file *filep, FAR char *buffer,
+                                  size_t len)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *dev = inode->i_private;
+  struct signalfd_siginfo siginfo;
+  struct timespec nowait;
+  struct siginfo info;
+  ssize_t nread = 0;
+  sigset_t mask;
+  int ret;
+
+  if (len < sizeof(struct signalfd_siginfo) || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mask = dev->mask;
+  nxmutex_unlock(&dev->lock);
+
+  nowait.tv_sec  = 0;
+  nowait.tv_nsec = 0;
+
+  /* Consume as many pending signals as fit, waiting only for the first
+   * one, and not even for it in non-blocking mode.
+   */
+
+  do
+    {
+      ret = nxsig_timedwait(&mask, &info,
+                            nread > 0 || (filep->f_oflags & O_NONBLOCK) ?
+                            &nowait : NULL);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      memset(&siginfo, 0, sizeof(siginfo));
+      siginfo.ssi_signo  = info.si_signo;
+      siginfo.ssi_errno  = info.si_errno;
+      siginfo.ssi_code   = info.si_code;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+      siginfo.ssi_pid    = info.si_pid;
+      siginfo.ssi_status = info.si_status;
+#endif
+      siginfo.ssi_int    = info.si_value.sival_int;
+      siginfo.ssi_ptr    = (uintptr_t)info.si_value.sival_ptr;
+
+      memcpy(buffer + nread, &siginfo, sizeof(siginfo));
+      nread += sizeof(siginfo);
+    }
+  while (len - nread >= sizeof(struct signalfd_siginfo));
+
+  return nread > 0 ? nread : ret;
+}
+
+#ifdef CONFIG_SIGNAL_FD_POLL
+static int signalfd_file_poll(FAR struct file *filep,
+                              FAR struct pollfd *fds, bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct signalfd_priv_s *dev = inode->i_private;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      /* Remove all memory of the poll setup */
+
+      flags     = enter_critical_section();
+      *slot     = NULL;
+      fds->priv = NULL;
+      leave_critical_section(flags);
+      goto out;
+    }
+
+  /* This is a request to set up the poll. Find an available
+   * slot for the poll structure reference
+   */
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_SIGNAL_FD_NPOLLWAITERS; i++)
+    {
+      /* Find an available slot */
+
+      if (!dev->fds[i])
+        {
+          /* Bind the poll structure and this slot */
+
+          dev->fds[i] = fds;
+          fds->priv   = &dev->fds[i];
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (i >= CONFIG_SIGNAL_FD_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto out;
+    }
+
+  /* Notify the POLLIN event if a signal of the mask is already pending */
+
+  signalfd_pollnotify(dev);
+
+out:
+  nxmutex_unlock(&dev->lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SIGNAL_FD_POLL
+/****************************************************************************
+ * Name: signalfd_notify
+ *
+ * Description:
+ *   Wake up the pollers of the signalfds of a task group whose mask
+ *   contains a signal that was just made pending.
+ *
+ * Input Parameters:
+ *   pid   - The ID of the task group
+ *   signo - The pending signal
+ *
+ * Assumptions:
+ *   May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void signalfd_notify(pid_t pid, int signo)
+{
+  FAR struct signalfd_priv_s *dev;
+  FAR dq_entry_t *entry;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (entry = dq_peek(&g_signalfd_list); entry; entry = dq_next(entry))
+    {
+      dev = container_of(entry, struct signalfd_priv_s, node);
+      if (dev->pid == pid && nxsig_ismember(&dev->mask, signo) == 1)
+        {
+          poll_notify(dev->fds, CONFIG_SIGNAL_FD_NPOLLWAITERS, POLLIN);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+int signalfd(int fd, FAR const sigset_t *mask, int flags)
+{
+  FAR struct signalfd_priv_s *new_dev;
+  FAR struct signalfd_priv_s *dev;
+  FAR struct file *filep;
+#ifdef CONFIG_SIGNAL_FD_POLL
+  irqstate_t irqflags;
+#endif
+  int new_fd;
+  int ret;
+
+  /* devpath: SIGNAL_FD_VFS_PATH + /sfd (4) + %u (10) + null char (1) */
+
+  char devpath[sizeof(CONFIG_SIGNAL_FD_VFS_PATH) + 4 + 10 + 1];
+
+  /* Some sanity checks */
+
+  if (mask == NULL)
+    {
+      ret = -EFAULT;
+      goto exit_set_errno;
+    }
+
+  if ((flags & ~(SFD_NONBLOCK | SFD_CLOEXEC)) != 0)
+    {
+      ret = -EINVAL;
+      goto exit_set_errno;
+    }
+
+  /* A valid file descriptor is that of a signalfd whose mask changes */
+
+  if (fd != -1)
+    {
+      ret = fs_getfilep(fd, &filep);
+      if (ret < 0)
+        {
+          goto exit_set_errno;
+        }
+
+      /* Check fd come from us */
+
+      if (!filep->f_inode || filep->f_inode->u.i_ops != &g_signalfd_fops)
+        {
+          ret = -EINVAL;
+          goto exit_set_errno;
+        }
+
+      dev = (FAR struct signalfd_priv_s *)filep->f_inode->i_private;
+
+      ret = nxmutex_lock(&dev->lock);
+      if (ret < 0)
+        {
+          goto exit_set_errno;
+        }
+
+      dev->mask = *mask;
+#ifdef CONFIG_SIGNAL_FD_POLL
+      signalfd_pollnotify(dev);
+#endif
+      nxmutex_unlock(&dev->lock);
+      return fd;
+    }
+
+  /* Allocate instance data for this driver */
+
+  new_dev = signalfd_allocdev();
+  if (new_dev == NULL)
+    {
+      /* Failed to allocate new device */
+
+      ret = -ENOMEM;
+      goto exit_set_errno;
+    }
+
+  new_dev->mask = *mask;
+  new_dev->pid  = getpid();
+
+  /* Request a unique minor device number */
+
+  new_dev->minor = signalfd_get_unique_minor();
+
+  /* Get device path */
+
+  sprintf(devpath, CONFIG_SIGNAL_FD_VFS_PATH "/sfd%u", new_dev->minor);
+
+#ifdef CONFIG_SIGNAL_FD_POLL
+  /* signalfd_destroy() removes the device from the list again */
+
+  irqflags = enter_critical_section();
+  dq_addlast(&new_dev->node, &g_signalfd_list);
+  leave_critical_section(irqflags);
+#endif
+
+  /* Register the driver */
+
+  ret = register_driver(devpath, &g_signalfd_fops, 0444, new_dev);
+  if (ret < 0)
+    {
+      ferr("Failed to register new device %s: %d\n", devpath, ret);
+      goto exit_destroy;
+    }
+
+  /* Device is ready for use */
+
+  nxmutex_unlock(&new_dev->lock);
+
+  /* Try open new device */
+
+  new_fd = nx_open(devpath, O_RDONLY |
+                   (flags & (SFD_NONBLOCK | SFD_CLOEXEC)));
+  if (new_fd < 0)
+    {
+      ret = new_fd;
+      goto exit_unregister_driver;
+    }
+
+  return new_fd;
+
+exit_unregister_driver:
+  unregister_driver(devpath);
+exit_destroy:
+  signalfd_destroy(new_dev);
+exit_set_errno:
+  set_errno(-ret);
+  return ERROR;
+}
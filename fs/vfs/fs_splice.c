@@ -0,0 +1,262 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_ispipe
+ *
+ * Description:
+ *   Return true if filep refers to a pipe or a FIFO.  A zero length splice
+ *   request is only accepted by the pipe driver.
+ *
+ ****************************************************************************/
+
+static bool splice_ispipe(FAR struct file *filep)
+{
+  struct pipe_splice_s ps =
+  {
+    NULL, NULL, 0, 0
+  };
+
+  return file_ioctl(filep, PIPEIOC_SPLICE,
+                    (unsigned long)((uintptr_t)&ps)) == 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t len, unsigned int flags)
+{
+  struct pipe_splice_s ps;
+
+  ps.ps_len   = len;
+  ps.ps_flags = flags;
+
+  /* From a pipe: the pipe writes its buffer directly to outfile */
+
+  if (splice_ispipe(infile))
+    {
+      if (inoffset != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      ps.ps_file   = outfile;
+      ps.ps_offset = outoffset;
+      return file_ioctl(infile, PIPEIOC_SPLICE,
+                        (unsigned long)((uintptr_t)&ps));
+    }
+
+  /* To a pipe: infile is read directly into the buffer of the pipe */
+
+  if (splice_ispipe(outfile))
+    {
+      if (outoffset != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      ps.ps_file   = infile;
+      ps.ps_offset = inoffset;
+      return file_ioctl(outfile, PIPEIOC_FILL,
+                        (unsigned long)((uintptr_t)&ps));
+    }
+
+  /* One of the files must be a pipe */
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts struct
+ *   file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags)
+{
+  struct pipe_splice_s ps;
+
+  if (!splice_ispipe(infile) || !splice_ispipe(outfile))
+    {
+      return -EINVAL;
+    }
+
+  ps.ps_file   = outfile;
+  ps.ps_offset = NULL;
+  ps.ps_len    = len;
+  ps.ps_flags  = flags;
+
+  return file_ioctl(infile, PIPEIOC_TEE, (unsigned long)((uintptr_t)&ps));
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors, one of which must be
+ *   a pipe or a FIFO.  The data is transferred with a single copy between
+ *   the buffer of the pipe and the other file (a regular file, a character
+ *   device or a socket), without a bounce buffer in user space.
+ *
+ *   NOTE: This interface is not specified by POSIX.  The interface is that
+ *   of the Linux splice().  The data is always copied; SPLICE_F_MOVE and
+ *   SPLICE_F_GIFT are accepted and ignored.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to read from
+ *   off_in  - Must be NULL if fd_in is a pipe.  Otherwise, if not NULL, the
+ *             offset to read fd_in from.  It is advanced by the number of
+ *             bytes read and the file offset of fd_in is not changed.
+ *   fd_out  - The descriptor to write to
+ *   off_out - The same as off_in for fd_out
+ *   len     - The maximum number of bytes to transfer
+ *   flags   - SPLICE_F_* flags.  With SPLICE_F_NONBLOCK, the operation does
+ *             not block on the pipe.
+ *
+ * Returned Value:
+ *   The number of bytes transferred; zero if the pipe is empty and has no
+ *   writers or at the end of the input file.  On error, -1 is returned,
+ *   and errno is set appropriately:
+ *
+ *   EINVAL - Neither descriptor refers to a pipe, or both refer to the
+ *            same pipe.
+ *   ESPIPE - An offset was given for a pipe.
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and the operation would block.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_splice(infile, off_in, outfile, off_out, len, flags);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() copies up to len bytes from the pipe fd_in to the pipe fd_out
+ *   without consuming them, so that they can still be read or spliced
+ *   from fd_in.
+ *
+ * Input Parameters:
+ *   fd_in  - The pipe to copy from
+ *   fd_out - The pipe to copy to
+ *   len    - The maximum number of bytes to copy
+ *   flags  - SPLICE_F_* flags, as for splice()
+ *
+ * Returned Value:
+ *   The number of bytes copied.  On error, -1 is returned, and errno is set
+ *   appropriately:
+ *
+ *   EINVAL - One of the descriptors is not a pipe, or both refer to the
+ *            same pipe.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = fs_getfilep(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(fd_out, &outfile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_tee(infile, outfile, len, flags);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -32,6 +32,9 @@
 #include <errno.h>
 
 #include "inode/inode.h"
+#ifdef CONFIG_FS_SHM
+#  include "shm/shmfs.h"
+#endif
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -283,7 +286,13 @@ int inode_stat(FAR struct inode *inode, FAR struct stat *buf, int resolve)
 
   if (INODE_IS_SHM(inode))
     {
+      FAR struct shmfs_object_s *object = inode->i_private;
+
       buf->st_mode = S_IFSHM;
+      if (object != NULL)
+        {
+          buf->st_size = object->length;
+        }
     }
   else
 #endif
@@ -33,6 +33,7 @@
 
 #include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/queue.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/mutex.h>
 
@@ -48,6 +49,12 @@
 
 #define TIMER_FD_WORK LPWORK
 
+/* Expirations are delayed to a multiple of the slack, so that the timers
+ * that expire within the same slack period wake up the pollers once.
+ */
+
+#define TIMER_FD_SLACK USEC2TICK(CONFIG_TIMER_FD_SLACK)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,7 +75,9 @@ struct timerfd_priv_s
   int                       delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
-  struct work_s             work;    /* For deferred timeout operations */
+  clock_t                   expiry;  /* The tick of the next expiration */
+  sq_entry_t                node;    /* Links the expired timers */
+  bool                      pending; /* In the list of expired timers */
   timerfd_t                 counter; /* timerfd counter */
   spinlock_t                splock;  /* timerfd counter specific lock */
   unsigned int              minor;   /* timerfd minor number */
@@ -105,8 +114,10 @@ static unsigned int timerfd_get_unique_minor(void);
 static void timerfd_release_minor(unsigned int minor);
 
 static FAR struct timerfd_priv_s *timerfd_allocdev(void);
+static void timerfd_unpend(FAR struct timerfd_priv_s *dev);
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev);
 
+static sclock_t timerfd_delay(clock_t expiry, clock_t now);
 static void timerfd_timeout_work(FAR void *arg);
 static void timerfd_timeout(wdparm_t idev);
 
@@ -132,6 +143,16 @@ static const struct file_operations g_timerfd_fops =
 #endif
 };
 
+/* The expired timers are notified by a single work, which wakes up the
+ * pollers of all of them at once.  g_timerfd_lock keeps a timer from
+ * being freed while the work notifies it.
+ */
+
+static sq_queue_t g_timerfd_expired;
+static spinlock_t g_timerfd_splock;
+static struct work_s g_timerfd_work;
+static mutex_t g_timerfd_lock = NXMUTEX_INITIALIZER;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -153,10 +174,30 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void)
   return dev;
 }
 
+static void timerfd_unpend(FAR struct timerfd_priv_s *dev)
+{
+  irqstate_t intflags;
+
+  intflags = spin_lock_irqsave(&g_timerfd_splock);
+  if (dev->pending)
+    {
+      sq_rem(&dev->node, &g_timerfd_expired);
+      dev->pending = false;
+    }
+
+  spin_unlock_irqrestore(&g_timerfd_splock, intflags);
+}
+
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
 {
   wd_cancel(&dev->wdog);
-  work_cancel(TIMER_FD_WORK, &dev->work);
+
+  /* Wait until the work is done with the timer */
+
+  nxmutex_lock(&g_timerfd_lock);
+  timerfd_unpend(dev);
+  nxmutex_unlock(&g_timerfd_lock);
+
   nxmutex_destroy(&dev->lock);
   kmm_free(dev);
 }
@@ -260,7 +301,11 @@ static int timerfd_close(FAR struct file *filep)
 
   unregister_driver(devpath);
 
+  /* The expiration work may be waiting for the lock */
+
   DEBUGASSERT(nxmutex_is_locked(&priv->lock));
+  nxmutex_unlock(&priv->lock);
+
   timerfd_release_minor(priv->minor);
   timerfd_destroy(priv);
 
@@ -447,42 +492,85 @@ out:
 }
 #endif
 
+static sclock_t timerfd_delay(clock_t expiry, clock_t now)
+{
+  sclock_t delay;
+
+#if TIMER_FD_SLACK > 1
+  /* Delay the expiration to the next multiple of the slack */
+
+  expiry += TIMER_FD_SLACK - 1;
+  expiry -= expiry % TIMER_FD_SLACK;
+#endif
+
+  delay = (sclock_t)(expiry - now);
+  return delay > 0 ? delay : 1;
+}
+
 static void timerfd_timeout_work(FAR void *arg)
 {
-  FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
+  FAR struct timerfd_priv_s *dev;
   FAR timerfd_waiter_sem_t *cur_sem;
-  int ret;
+  irqstate_t intflags;
 
-  ret = nxmutex_lock(&dev->lock);
-  if (ret < 0)
+  nxmutex_lock(&g_timerfd_lock);
+
+  /* Let the woken up pollers run only once all of the expired timers are
+   * notified.
+   */
+
+  sched_lock();
+
+  for (; ; )
     {
-      wd_cancel(&dev->wdog);
-      return;
-    }
+      intflags = spin_lock_irqsave(&g_timerfd_splock);
+      dev = (FAR struct timerfd_priv_s *)sq_remfirst(&g_timerfd_expired);
+      if (dev != NULL)
+        {
+          dev->pending = false;
+        }
+
+      spin_unlock_irqrestore(&g_timerfd_splock, intflags);
+
+      if (dev == NULL)
+        {
+          break;
+        }
+
+      if (nxmutex_lock(&dev->lock) < 0)
+        {
+          continue;
+        }
 
 #ifdef CONFIG_TIMER_FD_POLL
-  /* Notify all poll/select waiters */
+      /* Notify all poll/select waiters */
 
-  poll_notify(dev->fds, CONFIG_TIMER_FD_NPOLLWAITERS, POLLIN);
+      poll_notify(dev->fds, CONFIG_TIMER_FD_NPOLLWAITERS, POLLIN);
 #endif
 
-  /* Notify all of the waiting readers */
+      /* Notify all of the waiting readers */
 
-  cur_sem = dev->rdsems;
-  while (cur_sem != NULL)
-    {
-      nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
+      cur_sem = dev->rdsems;
+      while (cur_sem != NULL)
+        {
+          nxsem_post(&cur_sem->sem);
+          cur_sem = cur_sem->next;
+        }
+
+      dev->rdsems = NULL;
+      nxmutex_unlock(&dev->lock);
     }
 
-  dev->rdsems = NULL;
-  nxmutex_unlock(&dev->lock);
+  sched_unlock();
+  nxmutex_unlock(&g_timerfd_lock);
 }
 
 static void timerfd_timeout(wdparm_t idev)
 {
   FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)idev;
   irqstate_t intflags;
+  sclock_t overrun;
+  clock_t now;
 
   /* Disable interrupts to ensure that expiration counter is accessed
    * atomically
@@ -494,16 +582,48 @@ static void timerfd_timeout(wdparm_t idev)
 
   dev->counter++;
 
-  work_queue(TIMER_FD_WORK, &dev->work, timerfd_timeout_work, dev, 0);
-
-  /* If this is a repetitive timer, then restart the watchdog */
+  /* If this is a repetitive timer, then restart the watchdog.  The next
+   * expiration follows the previous one, not the watchdog, which may run
+   * late: the periods that elapsed meanwhile are counted too.
+   */
 
   if (dev->delay)
     {
-      wd_start(&dev->wdog, dev->delay, timerfd_timeout, idev);
+      now     = clock_systime_ticks();
+      overrun = (sclock_t)(now - dev->expiry) / dev->delay;
+      if (overrun > 0)
+        {
+          dev->counter += overrun;
+        }
+      else
+        {
+          overrun = 0;
+        }
+
+      dev->expiry += (overrun + 1) * dev->delay;
+      wd_start(&dev->wdog, timerfd_delay(dev->expiry, now),
+               timerfd_timeout, idev);
     }
 
   spin_unlock_irqrestore(&dev->splock, intflags);
+
+  /* Queue the timer for notification */
+
+  intflags = spin_lock_irqsave(&g_timerfd_splock);
+
+  if (!dev->pending)
+    {
+      sq_addlast(&dev->node, &g_timerfd_expired);
+      dev->pending = true;
+    }
+
+  if (work_available(&g_timerfd_work))
+    {
+      work_queue(TIMER_FD_WORK, &g_timerfd_work, timerfd_timeout_work,
+                 NULL, 0);
+    }
+
+  spin_unlock_irqrestore(&g_timerfd_splock, intflags);
 }
 
 /****************************************************************************
@@ -598,6 +718,7 @@ int timerfd_settime(int fd, int flags,
   FAR struct timerfd_priv_s *dev;
   irqstate_t intflags;
   sclock_t delay;
+  clock_t now;
   int ret;
 
   /* Some sanity checks */
@@ -656,9 +777,9 @@ int timerfd_settime(int fd, int flags,
 
   wd_cancel(&dev->wdog);
 
-  /* Cancel notification work */
+  /* Cancel the pending notification */
 
-  work_cancel(TIMER_FD_WORK, &dev->work);
+  timerfd_unpend(dev);
 
   /* Clear expiration counter */
 
@@ -725,7 +846,10 @@ int timerfd_settime(int fd, int flags,
 
   if (delay > 0)
     {
-      ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+      now         = clock_systime_ticks();
+      dev->expiry = now + delay;
+      ret = wd_start(&dev->wdog, timerfd_delay(dev->expiry, now),
+                     timerfd_timeout, (wdparm_t)dev);
       if (ret < 0)
         {
           spin_unlock_irqrestore(&dev->splock, intflags);
@@ -175,6 +175,13 @@ struct nxbe_plane_s
 
   NX_DRIVERTYPE *driver;
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+  /* Regions updated since the last call to nxbe_notify_flush() */
+
+  uint8_t ndirty;
+  struct nxgl_rect_s dirty[CONFIG_NX_UPDATE_NRECTS];
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -308,10 +315,25 @@ int nxbe_colormap(FAR NX_DRIVERTYPE *dev);
  ****************************************************************************/
 
 #ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect);
 #endif
 
+/****************************************************************************
+ * Name: nxbe_notify_flush
+ *
+ * Description:
+ *   When CONFIG_NX_UPDATE_COALESCE=y, nxbe_notify_rectangle() only records
+ *   the updated regions, merging those that overlap.  This function
+ *   notifies the external logic of the regions recorded on all of the
+ *   planes.  The server calls it when it has no more requests to process.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+void nxbe_notify_flush(FAR struct nxbe_state_s *be);
+#endif
+
 /****************************************************************************
  * Name: nx_configure
  *
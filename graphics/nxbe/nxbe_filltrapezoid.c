@@ -91,7 +91,7 @@ static void nxbe_clipfilltrapezoid(FAR struct nxbe_clipops_s *cops,
                      MIN(fillinfo->trap.bot.x2, rect->pt2.x));
   update.pt2.y = MIN(fillinfo->trap.bot.y, rect->pt2.y);
 
-  nxbe_notify_rectangle(plane->driver, &update);
+  nxbe_notify_rectangle(plane, &update);
 #endif
 }
 
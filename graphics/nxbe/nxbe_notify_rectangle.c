@@ -24,10 +24,51 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 #include <nuttx/nx/nxglib.h>
 
 #include "nxbe.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_update_area
+ *
+ * Description:
+ *   Call out to the external logic for one updated region.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE
+static void nxbe_update_area(FAR NX_DRIVERTYPE *dev,
+                             FAR const struct nxgl_rect_s *rect)
+{
+  struct fb_area_s area;
+
+  nxgl_rect2area(&area, rect);
+  dev->updatearea(dev, &area);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxbe_rect_pixels
+ *
+ * Description:
+ *   Return the number of pixels in a rectangle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+static uint32_t nxbe_rect_pixels(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,15 +92,102 @@
  *   interface.  This is the function that will handle the notification.  It
  *   receives the rectangular region that was updated on the provided plane.
  *
+ *   When CONFIG_NX_UPDATE_COALESCE=y, the region is only recorded, merged
+ *   with the recorded regions that it overlaps or touches as long as that
+ *   does not add pixels to update.  nxbe_notify_flush() calls out later.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect)
 {
-  struct fb_area_s area;
+#ifdef CONFIG_NX_UPDATE_COALESCE
+  struct nxgl_rect_s merged;
+  struct nxgl_rect_s both;
+  uint32_t growth;
+  uint32_t best;
+  int besti;
+  int i;
 
-  nxgl_rect2area(&area, rect);
-  dev->updatearea(dev, &area);
+  if (nxgl_nullrect(rect))
+    {
+      return;
+    }
+
+  nxgl_rectcopy(&merged, rect);
+
+  /* Absorb the regions that cost no more to update with this one than
+   * separately.  The merged region may absorb more, so start over after
+   * each merge.
+   */
+
+  for (i = 0; i < plane->ndirty; i++)
+    {
+      nxgl_rectunion(&both, &plane->dirty[i], &merged);
+      if (nxbe_rect_pixels(&both) <= nxbe_rect_pixels(&plane->dirty[i]) +
+                                     nxbe_rect_pixels(&merged))
+        {
+          nxgl_rectcopy(&merged, &both);
+          nxgl_rectcopy(&plane->dirty[i], &plane->dirty[--plane->ndirty]);
+          i = -1;
+        }
+    }
+
+  if (plane->ndirty < CONFIG_NX_UPDATE_NRECTS)
+    {
+      nxgl_rectcopy(&plane->dirty[plane->ndirty++], &merged);
+      return;
+    }
+
+  /* No room left: merge with the region that grows the least */
+
+  best  = UINT32_MAX;
+  besti = 0;
+
+  for (i = 0; i < plane->ndirty; i++)
+    {
+      nxgl_rectunion(&both, &plane->dirty[i], &merged);
+      growth = nxbe_rect_pixels(&both) - nxbe_rect_pixels(&plane->dirty[i]);
+      if (growth < best)
+        {
+          best  = growth;
+          besti = i;
+        }
+    }
+
+  nxgl_rectunion(&plane->dirty[besti], &plane->dirty[besti], &merged);
+#else
+  nxbe_update_area(plane->driver, rect);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: nxbe_notify_flush
+ *
+ * Description:
+ *   Notify the external logic of the regions recorded by
+ *   nxbe_notify_rectangle() on all of the planes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+void nxbe_notify_flush(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  int i;
+  int j;
+
+  for (i = 0; i < be->vinfo.nplanes; i++)
+    {
+      plane = &be->plane[i];
+      for (j = 0; j < plane->ndirty; j++)
+        {
+          nxbe_update_area(plane->driver, &plane->dirty[j]);
+        }
+
+      plane->ndirty = 0;
+    }
 }
 #endif
@@ -30,6 +30,7 @@
 #include <nuttx/nx/nxglib.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib.h"
 
 /****************************************************************************
  * Public Functions
@@ -106,6 +107,16 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   dline = pinfo->fbmem + dest->pt1.y * deststride +
           NXGL_SCALEX(dest->pt1.x);
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  /* Let the graphics engine copy the image if it can */
+
+  if (nxgl_accel_blit(dline, deststride, sline, srcstride, width, rows,
+                      NXGLIB_BITSPERPIXEL) >= 0)
+    {
+      return;
+    }
+#endif
+
   while (rows--)
     {
 #if NXGLIB_BITSPERPIXEL < 8
@@ -30,6 +30,7 @@
 #include <nuttx/nx/nxglib.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -84,6 +85,16 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
 
   line   = pinfo->fbmem + rect->pt1.y * stride + NXGL_SCALEX(rect->pt1.x);
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  /* Let the graphics engine fill the rectangle if it can */
+
+  if (nxgl_accel_fill(line, stride, width, rows, NXGLIB_BITSPERPIXEL,
+                      color) >= 0)
+    {
+      return;
+    }
+#endif
+
 #if NXGLIB_BITSPERPIXEL < 8
 # ifdef CONFIG_NX_PACKEDMSFIRST
 
@@ -511,6 +511,40 @@ void nxglib_cursor_backup_32bpp(FAR struct nxbe_state_s *be,
                                 int planeno);
 #endif
 
+/* Acceleration *************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_accel_fill, nxgl_accel_blit, nxgl_accel_blend and
+ *       nxgl_accel_convert
+ *
+ * Description:
+ *   Draw a rectangle with the registered 2D graphics engine.  See struct
+ *   nxgl_accel_s in include/nuttx/nx/nxglib.h.
+ *
+ * Returned Value:
+ *   OK if the rectangle was drawn; a negated errno value if it is to be
+ *   drawn by software: -ENOSYS if there is no such operation and -E2BIG
+ *   if the rectangle is smaller than CONFIG_NX_ACCEL_MINPIXELS.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_ACCEL
+int nxgl_accel_fill(FAR void *dest, unsigned int deststride,
+                    nxgl_coord_t width, nxgl_coord_t height,
+                    uint8_t bpp, nxgl_mxpixel_t color);
+int nxgl_accel_blit(FAR void *dest, unsigned int deststride,
+                    FAR const void *src, unsigned int srcstride,
+                    nxgl_coord_t width, nxgl_coord_t height, uint8_t bpp);
+int nxgl_accel_blend(FAR void *dest, unsigned int deststride,
+                     FAR const void *src, unsigned int srcstride,
+                     nxgl_coord_t width, nxgl_coord_t height,
+                     uint8_t bpp, uint8_t alpha);
+int nxgl_accel_convert(FAR void *dest, unsigned int deststride,
+                       uint8_t destfmt, FAR const void *src,
+                       unsigned int srcstride, uint8_t srcfmt,
+                       nxgl_coord_t width, nxgl_coord_t height);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * graphics/nxglib/nxglib_accel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "nxglib.h"
+
+#ifdef CONFIG_NX_ACCEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* True if the rectangle is worth setting up the hardware for */
+
+#define NXGL_ACCEL_WORTHWHILE(w, h) \
+  ((uint32_t)(w) * (uint32_t)(h) >= CONFIG_NX_ACCEL_MINPIXELS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct nxgl_accel_s *g_nxgl_accel;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_accel_register
+ *
+ * Description:
+ *   Register the operations of a 2D graphics engine.  See
+ *   include/nuttx/nx/nxglib.h.
+ *
+ ****************************************************************************/
+
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel)
+{
+  g_nxgl_accel = accel;
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_fill
+ ****************************************************************************/
+
+int nxgl_accel_fill(FAR void *dest, unsigned int deststride,
+                    nxgl_coord_t width, nxgl_coord_t height,
+                    uint8_t bpp, nxgl_mxpixel_t color)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->fill == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (!NXGL_ACCEL_WORTHWHILE(width, height))
+    {
+      return -E2BIG;
+    }
+
+  return accel->fill(accel, dest, deststride, width, height, bpp, color);
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_blit
+ ****************************************************************************/
+
+int nxgl_accel_blit(FAR void *dest, unsigned int deststride,
+                    FAR const void *src, unsigned int srcstride,
+                    nxgl_coord_t width, nxgl_coord_t height, uint8_t bpp)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->blit == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (!NXGL_ACCEL_WORTHWHILE(width, height))
+    {
+      return -E2BIG;
+    }
+
+  return accel->blit(accel, dest, deststride, src, srcstride,
+                     width, height, bpp);
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_blend
+ ****************************************************************************/
+
+int nxgl_accel_blend(FAR void *dest, unsigned int deststride,
+                     FAR const void *src, unsigned int srcstride,
+                     nxgl_coord_t width, nxgl_coord_t height,
+                     uint8_t bpp, uint8_t alpha)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->blend == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (!NXGL_ACCEL_WORTHWHILE(width, height))
+    {
+      return -E2BIG;
+    }
+
+  return accel->blend(accel, dest, deststride, src, srcstride,
+                      width, height, bpp, alpha);
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_convert
+ ****************************************************************************/
+
+int nxgl_accel_convert(FAR void *dest, unsigned int deststride,
+                       uint8_t destfmt, FAR const void *src,
+                       unsigned int srcstride, uint8_t srcfmt,
+                       nxgl_coord_t width, nxgl_coord_t height)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->convert == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (!NXGL_ACCEL_WORTHWHILE(width, height))
+    {
+      return -E2BIG;
+    }
+
+  return accel->convert(accel, dest, deststride, destfmt, src, srcstride,
+                        srcfmt, width, height);
+}
+
+#endif /* CONFIG_NX_ACCEL */
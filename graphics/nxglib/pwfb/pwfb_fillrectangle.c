@@ -30,6 +30,7 @@
 #include <nuttx/nx/nxbe.h>
 
 #include "nxglib_bitblit.h"
+#include "nxglib.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -85,6 +86,16 @@ void NXGL_FUNCNAME(pwfb_fillrectangle, NXGLIB_SUFFIX)
   line   = (FAR uint8_t *)bwnd->fbmem + rect->pt1.y * stride +
            NXGL_SCALEX(rect->pt1.x);
 
+#if defined(CONFIG_NX_ACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  /* Let the graphics engine fill the rectangle if it can */
+
+  if (nxgl_accel_fill(line, stride, width, rows, NXGLIB_BITSPERPIXEL,
+                      color) >= 0)
+    {
+      return;
+    }
+#endif
+
 #if NXGLIB_BITSPERPIXEL < 8
 # ifdef CONFIG_NX_PACKEDMSFIRST
 
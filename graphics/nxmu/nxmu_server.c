@@ -34,6 +34,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/nx/nx.h>
 
@@ -241,6 +242,30 @@ static inline int nxmu_setup(FAR const char *mqname, FAR NX_DRIVERTYPE *dev,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmu_idle
+ *
+ * Description:
+ *   Return true if there is no request to process.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_COALESCE
+static bool nxmu_idle(FAR struct nxmu_state_s *nxmu)
+{
+  FAR struct file *filep;
+  struct mq_attr attr;
+
+  if (fs_getfilep(nxmu->conn.crdmq, &filep) < 0 ||
+      file_mq_getattr(filep, &attr) < 0)
+    {
+      return true;
+    }
+
+  return attr.mq_curmsgs == 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -295,6 +320,15 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   for (; ; )
     {
+#ifdef CONFIG_NX_UPDATE_COALESCE
+      /* Update the display once all of the pending requests are done */
+
+      if (nxmu_idle(&nxmu))
+        {
+          nxbe_notify_flush(&nxmu.be);
+        }
+
+#endif
       /* Receive the next server message */
 
       nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
@@ -36,6 +36,10 @@
 #include <nuttx/nx/nxfonts.h>
 #include <nuttx/nx/nxterm.h>
 
+#ifdef CONFIG_NXTERM_DEFERUPDATE
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -128,9 +132,21 @@ struct nxterm_state_s
 
   uint16_t maxchars;                         /* Size of the bm[] array */
   uint16_t nchars;                           /* Number of chars in the bm[] array */
+  uint16_t ndrawn;                           /* Number of them displayed */
 
   struct nxgl_point_s fpos;                  /* Next display position */
 
+  /* Display updates not done yet.  Characters are added to bm[] and
+   * scrolled there, and the display is brought up to date afterward by
+   * nxterm_flush(), with a single move however many lines were scrolled.
+   */
+
+  nxgl_coord_t scrolled;                     /* Rows to scroll the display */
+  bool curshown;                             /* The cursor is displayed */
+#ifdef CONFIG_NXTERM_DEFERUPDATE
+  struct work_s work;                        /* Deferred display update */
+#endif
+
   /* VT100 escape sequence processing */
 
   char seq[VT100_MAX_SEQUENCE];              /* Buffered characters */
@@ -226,5 +242,6 @@ void nxterm_hidecursor(FAR struct nxterm_state_s *priv);
 /* Scrolling support */
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight);
+void nxterm_flush(FAR struct nxterm_state_s *priv);
 
 #endif /* __GRAPHICS_NXTERM_NXTERM_H */
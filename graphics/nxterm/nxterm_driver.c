@@ -49,6 +49,9 @@ static int     nxterm_ioctl(FAR struct file *filep, int cmd,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     nxterm_unlink(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_NXTERM_DEFERUPDATE
+static void    nxterm_update_worker(FAR void *arg);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -183,6 +186,28 @@ static int nxterm_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxterm_update_worker
+ *
+ * Description:
+ *   Bring the display up to date with the writes since the previous update,
+ *   from the low priority work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXTERM_DEFERUPDATE
+static void nxterm_update_worker(FAR void *arg)
+{
+  FAR struct nxterm_state_s *priv = (FAR struct nxterm_state_s *)arg;
+
+  if (nxmutex_lock(&priv->lock) >= 0)
+    {
+      nxterm_showcursor(priv);
+      nxmutex_unlock(&priv->lock);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxterm_write
  ****************************************************************************/
@@ -289,9 +314,22 @@ static ssize_t nxterm_write(FAR struct file *filep, FAR const char *buffer,
       while (state == VT100_ABORT);
     }
 
-  /* Show the cursor at its new position */
+#ifdef CONFIG_NXTERM_DEFERUPDATE
+  /* Update the display and show the cursor at its new position later, with
+   * the output of any other writes until then.
+   */
+
+  if (work_available(&priv->work))
+    {
+      work_queue(LPWORK, &priv->work, nxterm_update_worker, priv,
+                 MSEC2TICK(CONFIG_NXTERM_UPDATE_INTERVAL));
+    }
+#else
+  /* Update the display and show the cursor at its new position */
 
   nxterm_showcursor(priv);
+#endif
+
   nxmutex_unlock(&priv->lock);
   return (ssize_t)buflen;
 }
@@ -259,6 +259,10 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
       /* Decrement nchars to discard this character */
 
       priv->nchars = ndx;
+      if (priv->ndrawn > ndx)
+        {
+          priv->ndrawn = ndx;
+        }
     }
 
   return ret;
@@ -40,13 +40,12 @@
  * Name: nxterm_putc
  *
  * Description:
- *   Render the specified character at the current display position.
+ *   Add the specified character at the current display position.
  *
  ****************************************************************************/
 
 void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
 {
-  FAR const struct nxterm_bitmap_s *bm;
   int lineheight;
 
   /* Ignore carriage returns */
@@ -60,6 +59,9 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
 
   if (ch == ASCII_BS || ch == ASCII_DEL)
     {
+      /* The display must be up to date before erasing from it */
+
+      nxterm_flush(priv);
       nxterm_backspace(priv);
       return;
     }
@@ -107,22 +109,19 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
       nxterm_scroll(priv, lineheight);
     }
 
-  /* Find the glyph associated with the character and render it onto the
-   * display.
+  /* Add the character.  It is rendered onto the display by the next
+   * nxterm_flush().
    */
 
-  bm = nxterm_addchar(priv, ch);
-  if (bm)
-    {
-      nxterm_fillchar(priv, NULL, bm);
-    }
+  nxterm_addchar(priv, ch);
 }
 
 /****************************************************************************
  * Name: nxterm_showcursor
  *
  * Description:
- *   Render the cursor character at the current display position.
+ *   Bring the display up to date and render the cursor character at the
+ *   current display position.
  *
  ****************************************************************************/
 
@@ -151,11 +150,14 @@ void nxterm_showcursor(FAR struct nxterm_state_s *priv)
       nxterm_scroll(priv, lineheight);
     }
 
-  /* Render the cursor glyph onto the display. */
+  /* Render the added characters and the cursor glyph onto the display. */
+
+  nxterm_flush(priv);
 
   priv->cursor.pos.x = priv->fpos.x;
   priv->cursor.pos.y = priv->fpos.y;
   nxterm_fillchar(priv, NULL, &priv->cursor);
+  priv->curshown = true;
 }
 
 /****************************************************************************
@@ -168,5 +170,9 @@ void nxterm_showcursor(FAR struct nxterm_state_s *priv)
 
 void nxterm_hidecursor(FAR struct nxterm_state_s *priv)
 {
-  nxterm_hidechar(priv, &priv->cursor);
+  if (priv->curshown)
+    {
+      nxterm_hidechar(priv, &priv->cursor);
+      priv->curshown = false;
+    }
 }
@@ -83,6 +83,10 @@ void nxterm_redraw(NXTERM handle,
     }
   while (ret < 0);
 
+  /* Apply the pending scrolls first, which move the whole display */
+
+  nxterm_flush(priv);
+
   /* Fill the rectangular region with the window background color */
 
   ret = priv->ops->fill(priv, rect, priv->wndo.wcolor);
@@ -75,6 +75,10 @@ int nxterm_resize(NXTERM handle, FAR const struct nxgl_size_s *size)
       return ret;
     }
 
+  /* Finish the updates of the display at its old size */
+
+  nxterm_flush(priv);
+
   /* Set the new window size.
    * REVISIT:  Should other things be reset as well?
    */
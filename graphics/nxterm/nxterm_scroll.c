@@ -54,29 +54,33 @@
 
 #ifdef CONFIG_NX_WRITEONLY
 static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
-                                     int bottom, int scrollheight)
+                                      int scrollheight)
 {
   FAR struct nxterm_bitmap_s *bm;
   struct nxgl_rect_s rect;
+  nxgl_coord_t lineheight;
   nxgl_coord_t row;
   int ret;
   int i;
 
-  /* Move each row, one at a time.  They could all be moved at once (by
+  /* Redraw each row, one at a time.  They could all be redrawn at once (by
    * calling nxterm_redraw), but the since the region is cleared, then
-   * re-written, the effect would not be good.  Below the region is also
-   * cleared and re-written, however, in much smaller chunks.
+   * re-written, the effect would not be good.
    */
 
+  UNUSED(scrollheight);
+
+  lineheight = priv->fheight + CONFIG_NXTERM_LINESEPARATION;
   rect.pt1.x = 0;
   rect.pt2.x = priv->wndo.wsize.w - 1;
 
-  for (row = CONFIG_NXTERM_LINESEPARATION; row < bottom; row += scrollheight)
+  for (row = CONFIG_NXTERM_LINESEPARATION; row < priv->wndo.wsize.h;
+       row += lineheight)
     {
       /* Create a bounding box the size of one row of characters */
 
       rect.pt1.y = row;
-      rect.pt2.y = row + scrollheight - 1;
+      rect.pt2.y = row + lineheight - 1;
 
       /* Clear the region */
 
@@ -99,57 +103,49 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
         }
     }
 
-  /* Finally, clear the vacated part of the display */
-
-  rect.pt1.y = bottom;
-  rect.pt2.y = priv->wndo.wsize.h - 1;
+  /* All of the characters are on the display now */
 
-  ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
-  if (ret < 0)
-    {
-      gerr("ERROR: Fill failed: %d\n", get_errno());
-    }
+  priv->ndrawn = priv->nchars;
 }
 #else
 static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
-                                     int bottom, int scrollheight)
+                                      int scrollheight)
 {
   struct nxgl_rect_s rect;
   struct nxgl_point_s offset;
   int ret;
 
-  /* Add the line separation value to the scroll height */
-
-  scrollheight += CONFIG_NXTERM_LINESEPARATION;
-
-  /* Move the display in the range of 0-height up one scrollheight.  The
-   * line at the bottom will be reset to the background color automatically.
-   *
-   * The source rectangle to be moved.
-   */
-
   rect.pt1.x = 0;
-  rect.pt1.y = scrollheight;
+  rect.pt1.y = 0;
   rect.pt2.x = priv->wndo.wsize.w - 1;
   rect.pt2.y = priv->wndo.wsize.h - 1;
 
-  /* The offset that determines how far to move the source rectangle */
+  /* Move the display in the range of 0-height up by scrollheight, unless
+   * all of it scrolled off.  The source rectangle to be moved.
+   */
+
+  if (scrollheight < priv->wndo.wsize.h)
+    {
+      rect.pt1.y = scrollheight;
 
-  offset.x   = 0;
-  offset.y   = -scrollheight;
+      /* The offset that determines how far to move the source rectangle */
 
-  /* Move the source rectangle upward by the scrollheight */
+      offset.x   = 0;
+      offset.y   = -scrollheight;
 
-  ret = priv->ops->move(priv, &rect, &offset);
-  if (ret < 0)
-    {
-      gerr("ERROR: Move failed: %d\n", get_errno());
+      /* Move the source rectangle upward by the scrollheight */
+
+      ret = priv->ops->move(priv, &rect, &offset);
+      if (ret < 0)
+        {
+          gerr("ERROR: Move failed: %d\n", get_errno());
+        }
+
+      rect.pt1.y = priv->wndo.wsize.h - scrollheight;
     }
 
   /* Finally, clear the vacated bottom part of the display */
 
-  rect.pt1.y = priv->wndo.wsize.h - scrollheight;
-
   ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
   if (ret < 0)
     {
@@ -164,58 +160,95 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
 /****************************************************************************
  * Name: nxterm_scroll
+ *
+ * Description:
+ *   Scroll the text up by scrollheight rows, discarding the characters that
+ *   scroll off.  The display is moved by the next nxterm_flush(), once for
+ *   all of the scrolls since the previous one.
+ *
  ****************************************************************************/
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 {
+  FAR struct nxterm_bitmap_s *bm;
+  int ndrawn = 0;
   int i;
   int j;
 
-  /* Adjust the vertical position of each character */
+  /* Adjust the vertical position of each character, compacting bm[] over
+   * the characters that scrolled off the screen in a single pass.
+   */
 
-  for (i = 0; i < priv->nchars; )
+  for (i = 0, j = 0; i < priv->nchars; i++)
     {
-      FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
+      bm = &priv->bm[i];
 
       /* Has any part of this character scrolled off the screen? */
 
       if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
+          /* Yes... Delete the character */
 
-          for (j = i; j < priv->nchars - 1; j++)
-            {
-              memcpy(&priv->bm[j], &priv->bm[j + 1],
-                     sizeof(struct nxterm_bitmap_s));
-            }
-
-          /* Decrement the number of cached characters ('i' is not
-           * incremented in this case because it already points to the next
-           * character)
-           */
-
-          priv->nchars--;
+          continue;
         }
 
       /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
+       * display by one line), and keep it.
        */
 
-      else
+      bm->pos.y -= scrollheight;
+      if (i < priv->ndrawn)
         {
-          bm->pos.y -= scrollheight;
-
-          /* We are keeping this one so increment to the next character */
+          ndrawn++;
+        }
 
-          i++;
+      if (j != i)
+        {
+          memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
         }
+
+      j++;
     }
 
+  priv->nchars = j;
+  priv->ndrawn = ndrawn;
+
   /* And move the next display position up by one line as well */
 
-  priv->fpos.y -= scrollheight;
+  priv->fpos.y   -= scrollheight;
+
+  /* Any scroll of the whole window clears it */
+
+  priv->scrolled += scrollheight;
+  if (priv->scrolled > priv->wndo.wsize.h)
+    {
+      priv->scrolled = priv->wndo.wsize.h;
+    }
+}
+
+/****************************************************************************
+ * Name: nxterm_flush
+ *
+ * Description:
+ *   Bring the display up to date:  Move it by the pending scrolls, then
+ *   render the characters added since the previous flush.
+ *
+ ****************************************************************************/
+
+void nxterm_flush(FAR struct nxterm_state_s *priv)
+{
+  int i;
 
-  /* Move the display in the range of 0-height up one scrollheight. */
+  if (priv->scrolled > 0)
+    {
+      nxterm_movedisplay(priv, priv->scrolled);
+      priv->scrolled = 0;
+    }
+
+  for (i = priv->ndrawn; i < priv->nchars; i++)
+    {
+      nxterm_fillchar(priv, NULL, &priv->bm[i]);
+    }
 
-  nxterm_movedisplay(priv, priv->fpos.y, scrollheight);
+  priv->ndrawn = priv->nchars;
 }
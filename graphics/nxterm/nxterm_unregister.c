@@ -62,6 +62,12 @@ void nxterm_unregister(FAR struct nxterm_state_s *priv)
 
   DEBUGASSERT(priv != NULL);
 
+#ifdef CONFIG_NXTERM_DEFERUPDATE
+  /* Cancel any pending display update */
+
+  work_cancel(LPWORK, &priv->work);
+#endif
+
   /* Destroy mutex */
 
   nxmutex_destroy(&priv->lock);
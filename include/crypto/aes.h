@@ -39,6 +39,10 @@
 #  define AES_MAXROUNDS (14)
 #endif
 
+/* With CONFIG_CRYPTO_AES_ARMV8CE or CONFIG_CRYPTO_AES_NI, sk[] holds the
+ * encryption round keys as bytes and sk_exp[] the decryption ones.
+ */
+
 typedef struct aes_ctx
 {
   uint32_t sk[60];
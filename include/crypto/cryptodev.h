@@ -201,6 +201,8 @@ struct cryptop
 
   caddr_t crp_mac;
   caddr_t crp_dst;
+
+  FAR struct cryptop *crp_next;    /* Queue of crypto_dispatch() */
 };
 
 #define CRYPTO_BUF_IOV 0x1
@@ -278,6 +280,12 @@ struct cryptocap
 #define CRYPTOCAP_F_MAC_ENCRYPT 0x08 /* Can do MAC-then-encrypt (TLS) */
 
   CODE int (*cc_newsession)(FAR uint32_t *, FAR struct cryptoini *);
+
+  /* A hardware driver returns -ENOTSUP for a request that its engine
+   * cannot perform, e.g. for its length or alignment; the request is then
+   * performed by the software driver.
+   */
+
   CODE int (*cc_process)(FAR struct cryptop *);
   CODE int (*cc_freesession)(uint64_t);
   CODE int (*cc_kprocess)(FAR struct cryptkop *);
@@ -344,6 +352,8 @@ int crypto_kregister(uint32_t, FAR int *, CODE int (*)(struct cryptkop *));
 int crypto_unregister(uint32_t, int);
 int crypto_get_driverid(uint8_t);
 int crypto_invoke(FAR struct cryptop *);
+int crypto_dispatch(FAR struct cryptop *);
+void crypto_done(FAR struct cryptop *);
 int crypto_kinvoke(FAR struct cryptkop *);
 int crypto_getfeat(FAR int *);
 
@@ -57,6 +57,8 @@ void hmac_sha1_final(FAR u_int8_t *, FAR HMAC_SHA1_CTX *);
 
 void hmac_sha256_init(FAR HMAC_SHA256_CTX *, FAR const u_int8_t *, u_int);
 void hmac_sha256_update(FAR HMAC_SHA256_CTX *, FAR const u_int8_t *, u_int);
+void hmac_sha256_update_multi(FAR HMAC_SHA256_CTX **,
+                              FAR const u_int8_t **, u_int, int);
 void hmac_sha256_final(FAR u_int8_t *, FAR HMAC_SHA256_CTX *);
 
 #endif /* __INCLUDE_CRYPTO_HMAC_H_ */
@@ -71,6 +71,8 @@ typedef struct _SHA2_CTX
 
 void sha256init(FAR SHA2_CTX *);
 void sha256update(FAR SHA2_CTX *, FAR const void *, size_t);
+void sha256update_multi(FAR SHA2_CTX **, FAR const uint8_t **, size_t,
+                        int);
 void sha256final(FAR uint8_t *, FAR SHA2_CTX *);
 
 void sha384init(FAR SHA2_CTX *);
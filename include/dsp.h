@@ -447,6 +447,53 @@ struct pmsm_model_f32_s
   float                         iq_int; /* Iq integral part */
 };
 
+#ifdef CONFIG_LIBDSP_VECTOR
+/* FIR filter.  The state holds 2 * ntaps samples so that the delay line
+ * is always contiguous.
+ */
+
+struct fir_filter_f32_s
+{
+  FAR const float *coeffs;      /* ntaps coefficients, h[0] first */
+  FAR float       *state;       /* 2 * ntaps samples */
+  uint16_t         ntaps;       /* Number of taps */
+  uint16_t         pos;         /* Position of the newest sample */
+};
+
+typedef struct fir_filter_f32_s fir_filter_f32_t;
+
+/* Biquad section, with a0 normalized to 1 */
+
+struct biquad_coeffs_f32_s
+{
+  float b0;
+  float b1;
+  float b2;
+  float a1;
+  float a2;
+};
+
+/* Cascade of biquad sections in direct form II transposed */
+
+struct iir_filter_f32_s
+{
+  FAR const struct biquad_coeffs_f32_s *coeffs; /* nstages sections */
+  FAR float *state;                             /* 2 * nstages values */
+  uint8_t    nstages;                           /* Number of sections */
+};
+
+typedef struct iir_filter_f32_s iir_filter_f32_t;
+
+/* Radix-2 complex FFT of n points */
+
+struct fft_f32_s
+{
+  FAR const float *twiddle;     /* n / 2 complex twiddle factors */
+  uint16_t         n;           /* Number of points, a power of 2 */
+  uint8_t          log2n;       /* log2(n) */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -601,6 +648,33 @@ int pmsm_model_elec(FAR struct pmsm_model_f32_s *model,
                     FAR ab_frame_f32_t *vab);
 int pmsm_model_mech(FAR struct pmsm_model_f32_s *model, float load);
 
+#ifdef CONFIG_LIBDSP_VECTOR
+/* Vector functions */
+
+float vector_dot(FAR const float *a, FAR const float *b, size_t n);
+void vector_sin(FAR const float *in, FAR float *out, size_t n);
+void vector_cos(FAR const float *in, FAR float *out, size_t n);
+void vector_exp(FAR const float *in, FAR float *out, size_t n);
+
+/* Filters */
+
+void fir_filter_init(FAR fir_filter_f32_t *fir, FAR const float *coeffs,
+                     FAR float *state, uint16_t ntaps);
+void fir_filter(FAR fir_filter_f32_t *fir, FAR const float *in,
+                FAR float *out, size_t n);
+void iir_filter_init(FAR iir_filter_f32_t *iir,
+                     FAR const struct biquad_coeffs_f32_s *coeffs,
+                     FAR float *state, uint8_t nstages);
+void iir_filter(FAR iir_filter_f32_t *iir, FAR const float *in,
+                FAR float *out, size_t n);
+
+/* FFT */
+
+int fft_init(FAR struct fft_f32_s *fft, FAR float *twiddle, uint16_t n);
+void fft_transform(FAR const struct fft_f32_s *fft, FAR float *data,
+                   bool inverse);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -65,6 +65,18 @@
 #define ONE_BY_SQRT3_B16     ftob16(0.57735f)
 #define TWO_BY_SQRT3_B16     ftob16(1.15470f)
 
+/* The sum of two products, a*b + c*d, accumulated on 64 bits and rounded
+ * once.  On Armv7E-M this is one SMULL and one SMLAL, where two calls of
+ * b16mulb16() round twice.
+ */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+#  define b16mac2b16(a,b,c,d) \
+  b32tob16((b32_t)(a) * (b32_t)(b) + (b32_t)(c) * (b32_t)(d))
+#else
+#  define b16mac2b16(a,b,c,d) (b16mulb16(a,b) + b16mulb16(c,d))
+#endif
+
 /* Some lib constants *******************************************************/
 
 /* Motor electrical angle is in range 0.0 to 2*PI */
@@ -437,6 +449,69 @@ struct pmsm_model_b16_s
   b16_t                         iq_int; /* Iq integral part */
 };
 
+#ifdef CONFIG_LIBDSP_VECTOR
+/* FIR filter.  The state holds 2 * ntaps samples so that the delay line
+ * is always contiguous.
+ */
+
+struct fir_filter_b16_s
+{
+  FAR const b16_t *coeffs;      /* ntaps coefficients, h[0] first */
+  FAR b16_t       *state;       /* 2 * ntaps samples */
+  uint16_t         ntaps;       /* Number of taps */
+  uint16_t         pos;         /* Position of the newest sample */
+};
+
+typedef struct fir_filter_b16_s fir_filter_b16_t;
+
+/* Biquad section, with a0 normalized to 1 */
+
+struct biquad_coeffs_b16_s
+{
+  b16_t b0;
+  b16_t b1;
+  b16_t b2;
+  b16_t a1;
+  b16_t a2;
+};
+
+/* Cascade of biquad sections in direct form I, which does not overflow
+ * internally as long as the output of each section fits b16_t.
+ */
+
+struct iir_filter_b16_s
+{
+  FAR const struct biquad_coeffs_b16_s *coeffs; /* nstages sections */
+  FAR b16_t *state;                             /* 4 * nstages values */
+  uint8_t    nstages;                           /* Number of sections */
+};
+
+typedef struct iir_filter_b16_s iir_filter_b16_t;
+#endif
+
+#ifdef CONFIG_LIBDSP_BENCH
+/* The cost of the kernels of a FOC cycle, in the units of the clock given
+ * to dsp_bench_b16(), per call.
+ */
+
+struct dsp_bench_b16_s
+{
+  uint32_t clarke;           /* clarke_transform_b16() */
+  uint32_t inv_clarke;       /* inv_clarke_transform_b16() */
+  uint32_t park;             /* park_transform_b16() */
+  uint32_t inv_park;         /* inv_park_transform_b16() */
+  uint32_t park_batch;       /* park_transform_batch_b16(), per axis */
+  uint32_t svm3;             /* svm3_b16() */
+  uint32_t pi;               /* pi_controller_b16() */
+  uint32_t angle;            /* phase_angle_update_b16() */
+#ifdef CONFIG_LIBDSP_VECTOR
+  uint32_t dot;              /* vector_dot_b16(), per element */
+  uint32_t fir;              /* fir_filter_b16(), per sample */
+  uint32_t iir;              /* iir_filter_b16(), per sample */
+#endif
+};
+#endif
+
 /****************************************************************************
  * Public Functions Prototypes
  ****************************************************************************/
@@ -491,6 +566,19 @@ void park_transform_b16(FAR phase_angle_b16_t *angle, FAR ab_frame_b16_t *ab,
 void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
                             FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
 
+/* The same transforms for the n axes of a multi-axis controller, with
+ * one call per control cycle.
+ */
+
+void clarke_transform_batch_b16(FAR abc_frame_b16_t *abc,
+                                FAR ab_frame_b16_t *ab, int n);
+void park_transform_batch_b16(FAR phase_angle_b16_t *angle,
+                              FAR ab_frame_b16_t *ab,
+                              FAR dq_frame_b16_t *dq, int n);
+void inv_park_transform_batch_b16(FAR phase_angle_b16_t *angle,
+                                  FAR dq_frame_b16_t *dq,
+                                  FAR ab_frame_b16_t *ab, int n);
+
 /* Phase angle related functions */
 
 void angle_norm_b16(FAR b16_t *angle, b16_t per, b16_t bottom, b16_t top);
@@ -596,6 +684,31 @@ int pmsm_model_elec_b16(FAR struct pmsm_model_b16_s *model,
                         FAR ab_frame_b16_t *vab);
 int pmsm_model_mech_b16(FAR struct pmsm_model_b16_s *model, b16_t load);
 
+#ifdef CONFIG_LIBDSP_VECTOR
+/* Vector functions */
+
+b16_t vector_dot_b16(FAR const b16_t *a, FAR const b16_t *b, size_t n);
+
+/* Filters */
+
+void fir_filter_init_b16(FAR fir_filter_b16_t *fir, FAR const b16_t *coeffs,
+                         FAR b16_t *state, uint16_t ntaps);
+void fir_filter_b16(FAR fir_filter_b16_t *fir, FAR const b16_t *in,
+                    FAR b16_t *out, size_t n);
+void iir_filter_init_b16(FAR iir_filter_b16_t *iir,
+                         FAR const struct biquad_coeffs_b16_s *coeffs,
+                         FAR b16_t *state, uint8_t nstages);
+void iir_filter_b16(FAR iir_filter_b16_t *iir, FAR const b16_t *in,
+                    FAR b16_t *out, size_t n);
+#endif
+
+/* Benchmark of the kernels */
+
+#ifdef CONFIG_LIBDSP_BENCH
+void dsp_bench_b16(FAR struct dsp_bench_b16_s *bench,
+                   CODE uint32_t (*gettime)(void), int loops);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
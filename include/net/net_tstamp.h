@@ -0,0 +1,71 @@
+/****************************************************************************
+ * include/net/net_tstamp.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NET_NET_TSTAMP_H
+#define __INCLUDE_NET_NET_TSTAMP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The flags of the SO_TIMESTAMPING socket option, as in Linux.  The
+ * generation flags select the packets that are time stamped, the reporting
+ * flags the time stamps that are delivered in the SCM_TIMESTAMPING control
+ * messages of recvmsg().  The time stamps of sent packets are read from
+ * the error queue, with recvmsg(MSG_ERRQUEUE).
+ */
+
+#define SOF_TIMESTAMPING_TX_HARDWARE  (1 << 0) /* Generation */
+#define SOF_TIMESTAMPING_TX_SOFTWARE  (1 << 1) /* Generation */
+#define SOF_TIMESTAMPING_RX_HARDWARE  (1 << 2) /* Generation */
+#define SOF_TIMESTAMPING_RX_SOFTWARE  (1 << 3) /* Generation */
+#define SOF_TIMESTAMPING_SOFTWARE     (1 << 4) /* Reporting, in ts[0] */
+#define SOF_TIMESTAMPING_SYS_HARDWARE (1 << 5) /* Unsupported */
+#define SOF_TIMESTAMPING_RAW_HARDWARE (1 << 6) /* Reporting, in ts[2] */
+
+#define SOF_TIMESTAMPING_MASK \
+  ((SOF_TIMESTAMPING_RAW_HARDWARE << 1) - 1)
+
+#define SOF_TIMESTAMPING_TX_RECORD_MASK (SOF_TIMESTAMPING_TX_HARDWARE | \
+                                         SOF_TIMESTAMPING_TX_SOFTWARE)
+#define SOF_TIMESTAMPING_RX_RECORD_MASK (SOF_TIMESTAMPING_RX_HARDWARE | \
+                                         SOF_TIMESTAMPING_RX_SOFTWARE)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The payload of an SCM_TIMESTAMPING control message:  ts[0] holds the
+ * software time stamp, ts[2] the hardware one, ts[1] is unused.  Unused
+ * entries are zero.
+ */
+
+struct scm_timestamping
+{
+  struct timespec ts[3];
+};
+
+#endif /* __INCLUDE_NET_NET_TSTAMP_H */
@@ -26,6 +26,7 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -56,4 +57,68 @@
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 
+/* TCP protocol socket operations for congestion control: */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 5) /* Congestion control algorithm
+                                            * Argument: name string */
+#define TCP_INFO       (__SO_PROTOCOL + 6) /* Connection statistics (read only)
+                                            * Argument: struct tcp_info */
+
+/* Values of tcpi_options */
+
+#define TCPI_OPT_SACK   2                 /* SACK was negotiated */
+#define TCPI_OPT_WSCALE 4                 /* Window scaling was negotiated */
+
+/* Values of tcpi_ca_state */
+
+#define TCP_CA_OPEN     0                 /* No loss being recovered from */
+#define TCP_CA_RECOVERY 3                 /* Fast recovery */
+#define TCP_CA_LOSS     4                 /* Recovery after a timeout */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Returned by TCP_INFO.  The layout is the start of the Linux structure;
+ * fields that NuttX does not track are zero.  Times are in microseconds
+ * and windows in segments.
+ */
+
+struct tcp_info
+{
+  uint8_t  tcpi_state;          /* Connection state */
+  uint8_t  tcpi_ca_state;       /* Congestion control state, TCP_CA_* */
+  uint8_t  tcpi_retransmits;    /* Retransmissions of the current segment */
+  uint8_t  tcpi_probes;
+  uint8_t  tcpi_backoff;
+  uint8_t  tcpi_options;        /* Negotiated options, TCPI_OPT_* */
+  uint8_t  tcpi_snd_wscale : 4; /* Window scale of the peer */
+  uint8_t  tcpi_rcv_wscale : 4; /* Our window scale */
+
+  uint32_t tcpi_rto;            /* Retransmission timeout */
+  uint32_t tcpi_ato;
+  uint32_t tcpi_snd_mss;        /* Send MSS */
+  uint32_t tcpi_rcv_mss;
+
+  uint32_t tcpi_unacked;        /* Bytes sent and not yet ACKed */
+  uint32_t tcpi_sacked;
+  uint32_t tcpi_lost;
+  uint32_t tcpi_retrans;
+  uint32_t tcpi_fackets;
+
+  uint32_t tcpi_last_data_sent;
+  uint32_t tcpi_last_ack_sent;
+  uint32_t tcpi_last_data_recv;
+  uint32_t tcpi_last_ack_recv;
+
+  uint32_t tcpi_pmtu;
+  uint32_t tcpi_rcv_ssthresh;
+  uint32_t tcpi_rtt;            /* Smoothed RTT */
+  uint32_t tcpi_rttvar;         /* RTT variation */
+  uint32_t tcpi_snd_ssthresh;   /* Slow start threshold */
+  uint32_t tcpi_snd_cwnd;       /* Congestion window */
+  uint32_t tcpi_advmss;
+  uint32_t tcpi_reordering;
+};
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -31,4 +31,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol socket options */
+
+#define UDP_SEGMENT   (__SO_PROTOCOL + 0) /* Split sends into datagrams of
+                                           * this size.
+                                           * Argument: int, 0 to disable */
+
 #endif /* __INCLUDE_NETINET_UDP_H */
@@ -28,6 +28,32 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet socket options, at level SOL_PACKET */
+
+#define SOL_PACKET          263
+
+#define PACKET_RX_RING      5  /* Set up a receive ring (tpacket_req) */
+#define PACKET_STATISTICS   6  /* Get and reset counters (tpacket_stats) */
+
+/* Values of tp_status.  The slot belongs to the kernel while the status is
+ * TP_STATUS_KERNEL; the kernel sets TP_STATUS_USER when it has written a
+ * frame to it, and user space gives it back by writing TP_STATUS_KERNEL.
+ */
+
+#define TP_STATUS_KERNEL    0
+#define TP_STATUS_USER      (1 << 0)
+#define TP_STATUS_LOSING    (1 << 2) /* Frames were dropped before this one */
+
+#define TPACKET_ALIGNMENT   16
+#define TPACKET_ALIGN(x)    (((x) + TPACKET_ALIGNMENT - 1) & \
+                             ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN      (TPACKET_ALIGN(sizeof(struct tpacket_hdr)) + \
+                             sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -43,4 +69,35 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* The receive ring of PACKET_RX_RING is mapped with mmap() on the socket.
+ * It holds tp_frame_nr slots of tp_frame_size bytes, tp_block_size bytes
+ * being a whole number of slots.  Each slot starts with struct tpacket_hdr
+ * followed by struct sockaddr_ll; the frame is at offset tp_mac.
+ */
+
+struct tpacket_req
+{
+  unsigned int   tp_block_size;  /* Minimal size of contiguous block */
+  unsigned int   tp_block_nr;    /* Number of blocks */
+  unsigned int   tp_frame_size;  /* Size of frame */
+  unsigned int   tp_frame_nr;    /* Total number of frames */
+};
+
+struct tpacket_hdr
+{
+  unsigned long  tp_status;      /* TP_STATUS_* */
+  unsigned int   tp_len;         /* Length of the frame */
+  unsigned int   tp_snaplen;     /* Length stored in the slot */
+  unsigned short tp_mac;         /* Offset of the frame in the slot */
+  unsigned short tp_net;         /* Offset of the network header */
+  unsigned int   tp_sec;         /* Time of reception */
+  unsigned int   tp_usec;
+};
+
+struct tpacket_stats
+{
+  unsigned int   tp_packets;     /* Frames received */
+  unsigned int   tp_drops;       /* Frames dropped, the ring was full */
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
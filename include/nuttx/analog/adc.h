@@ -44,15 +44,15 @@
  ****************************************************************************/
 
 /* Default configuration settings that may be overridden in the NuttX
- * configuration file.  The configured size is limited to 255 to fit into a
- * uint8_t.
+ * configuration file.  The configured size is limited to 65535 to fit into
+ * a uint16_t.
  */
 
 #if !defined(CONFIG_ADC_FIFOSIZE)
 #  define CONFIG_ADC_FIFOSIZE 8
-#elif CONFIG_ADC_FIFOSIZE > 255
+#elif CONFIG_ADC_FIFOSIZE > 65535
 #  undef  CONFIG_ADC_FIFOSIZE
-#  define CONFIG_ADC_FIFOSIZE 255
+#  define CONFIG_ADC_FIFOSIZE 65535
 #endif
 
 #if !defined(CONFIG_ADC_NPOLLWAITERS)
@@ -102,6 +102,30 @@ struct adc_callback_s
    */
 
   CODE int (*au_reset)(FAR struct adc_dev_s *dev);
+
+  /* This method is called from the lower half, platform-specific ADC logic
+   * when a block of samples is available, e.g. when a DMA transfer of a
+   * continuous conversion completes.  The whole block is queued at once and
+   * the readers are woken up once, instead of once per sample.
+   *
+   * Input Parameters:
+   *   dev       - The ADC device structure that was previously registered
+   *               by adc_register()
+   *   channels  - The channels of one scan, in conversion order
+   *   nchannels - The number of channels of one scan
+   *   data      - The samples of consecutive scans: data[i] is converted
+   *               from channels[i % nchannels]
+   *   count     - The number of samples in data
+   *
+   * Returned Value:
+   *   Zero on success; -ENOMEM if the FIFO was full and the newest samples
+   *   were dropped.
+   */
+
+  CODE int (*au_receive_batch)(FAR struct adc_dev_s *dev,
+                               FAR const uint8_t *channels,
+                               uint8_t nchannels,
+                               FAR const int32_t *data, size_t count);
 };
 
 /* This describes on ADC message */
@@ -117,12 +141,25 @@ begin_packed_struct struct adc_msg_s
 struct adc_fifo_s
 {
   sem_t        af_sem;                   /* Counting semaphore */
-  uint8_t      af_head;                  /* Index to the head [IN] index in the circular buffer */
-  uint8_t      af_tail;                  /* Index to the tail [OUT] index in the circular buffer */
+  uint16_t     af_head;                  /* Index to the head [IN] index in the circular buffer */
+  uint16_t     af_tail;                  /* Index to the tail [OUT] index in the circular buffer */
                                          /* Circular buffer of CAN messages */
   struct adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+/* This describes the receive FIFO to ANIOC_GET_RING.  The ar_count queued
+ * messages start at ar_buffer[ar_head] and wrap around at ar_size.  They
+ * stay valid until they are released with ANIOC_RING_CONSUME.
+ */
+
+struct adc_ring_s
+{
+  FAR const struct adc_msg_s *ar_buffer; /* The messages of the FIFO */
+  uint16_t     ar_size;                  /* Messages in ar_buffer */
+  uint16_t     ar_head;                  /* Oldest queued message */
+  uint16_t     ar_count;                 /* The number of queued messages */
+};
+
 /* This structure defines all of the operations provided by the architecture
  * specific logic.  All fields must be provided with non-NULL function
  * pointers by the caller of adc_register().
@@ -192,6 +229,7 @@ struct adc_dev_s
   mutex_t                     ad_closelock;  /* Locks out new opens while close is in progress */
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
+  uint16_t                    ad_watermark;  /* Fill that wakes up readers */
   bool                        ad_isovr;      /* Flag to indicate an ADC overrun */
 
   /* The following is a list of poll structures of threads waiting for
@@ -64,8 +64,25 @@
                                                  * OUT: Number of samples
                                                  * waiting to be read */
 
+/* ADC */
+
+#define ANIOC_SET_WATERMARK     _ANIOC(0x0007)  /* Set the number of queued
+                                                 * samples that wake up
+                                                 * blocking reads and poll
+                                                 * IN: Number of samples
+                                                 * OUT: None */
+#define ANIOC_GET_RING          _ANIOC(0x0008)  /* Get the receive FIFO for
+                                                 * reading it in place
+                                                 * IN: Pointer to struct
+                                                 *     adc_ring_s
+                                                 * OUT: The FIFO */
+#define ANIOC_RING_CONSUME      _ANIOC(0x0009)  /* Release samples that were
+                                                 * read in place
+                                                 * IN: Number of samples
+                                                 * OUT: None */
+
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          6               /* Number of common commands */
+#define AN_NCMDS          9               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half driver to the lower-half driver via the ioctl()
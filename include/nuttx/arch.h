@@ -2288,6 +2288,28 @@ size_t  up_check_intstack_remain(void);
 #endif
 #endif
 
+/****************************************************************************
+ * Name: up_stack_guard
+ *
+ * Description:
+ *   Deny the accesses to the bottom of the stack of a thread, which is
+ *   about to run, so that its stack overflows fault.  This is called by
+ *   nxsched_resume_scheduler() at each context switch.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread, or NULL to remove the guard, e.g. before
+ *         dumping the stack of a failed thread.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_GUARD
+struct tcb_s;
+void up_stack_guard(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: up_rtc_initialize
  *
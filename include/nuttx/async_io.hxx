@@ -0,0 +1,490 @@
+//***************************************************************************
+// include/nuttx/async_io.hxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+
+#ifndef __INCLUDE_NUTTX_ASYNC_IO_HXX
+#define __INCLUDE_NUTTX_ASYNC_IO_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioring.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if __has_include(<coroutine>)
+#  include <coroutine>
+#else
+#  include <experimental/coroutine>
+#endif
+
+#ifdef CONFIG_LIBXX_ASYNC_IO
+
+//***************************************************************************
+// Namespace
+//***************************************************************************
+
+// Completion based asynchronous I/O for C++20 coroutines.  An io_context
+// runs any number of coroutines on the calling thread: a coroutine that
+// awaits an operation is suspended until the operation completes, instead
+// of blocking the thread.  The results of all operations are those of the
+// system calls, or a negated errno value.
+//
+// Regular files go through an I/O completion ring (fs/aio), so that they
+// do not block the thread either.  Sockets, pipes, FIFOs and character
+// devices are wrapped in a stream and are served by epoll when they are
+// ready.  The descriptor of the ring is polled along with the streams.
+
+namespace nuttx
+{
+namespace async
+{
+#if __has_include(<coroutine>)
+  using std::coroutine_handle;
+  using std::noop_coroutine;
+  using std::suspend_always;
+#else
+  using std::experimental::coroutine_handle;
+  using std::experimental::noop_coroutine;
+  using std::experimental::suspend_always;
+#endif
+
+  class io_context;
+  class stream;
+
+  template <class T = void>
+  class task;
+
+  namespace detail
+  {
+    // The part common to the promises of all tasks.  A finished task
+    // resumes the coroutine that awaits it, or destroys itself if it was
+    // spawned.
+
+    struct promise_base
+    {
+      struct final_awaiter
+      {
+        bool await_ready() const noexcept
+        {
+          return false;
+        }
+
+        template <class P>
+        coroutine_handle<> await_suspend(coroutine_handle<P> h) noexcept
+        {
+          promise_base &p = h.promise();
+          coroutine_handle<> next = p.continuation;
+
+          if (!next)
+            {
+              if (p.detached)
+                {
+                  h.destroy();
+                }
+
+              return noop_coroutine();
+            }
+
+          return next;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+      };
+
+      suspend_always initial_suspend() const noexcept
+      {
+        return {};
+      }
+
+      final_awaiter final_suspend() const noexcept
+      {
+        return {};
+      }
+
+      void unhandled_exception() const noexcept
+      {
+        abort();
+      }
+
+      coroutine_handle<> continuation;
+      bool detached = false;
+    };
+
+    template <class T>
+    struct promise : promise_base
+    {
+      task<T> get_return_object() noexcept;
+
+      void return_value(T v)
+      {
+        value = static_cast<T &&>(v);
+      }
+
+      T result()
+      {
+        return static_cast<T &&>(value);
+      }
+
+      T value{};
+    };
+
+    template <>
+    struct promise<void> : promise_base
+    {
+      task<void> get_return_object() noexcept;
+
+      void return_void() const noexcept
+      {
+      }
+
+      void result() const noexcept
+      {
+      }
+    };
+
+    // An operation that suspends a coroutine until it completes
+
+    struct operation
+    {
+      FAR operation *next;
+      coroutine_handle<> waiter;
+      ssize_t result;
+    };
+  }
+
+  // A coroutine that starts when it is awaited or spawned.  T must be
+  // default constructible.
+
+  template <class T>
+  class task
+  {
+  public:
+    using promise_type = detail::promise<T>;
+    using handle_type  = coroutine_handle<promise_type>;
+
+    explicit task(handle_type h) noexcept
+      : m_handle(h)
+    {
+    }
+
+    task(task &&other) noexcept
+      : m_handle(other.m_handle)
+    {
+      other.m_handle = nullptr;
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    ~task()
+    {
+      if (m_handle)
+        {
+          m_handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+      return !m_handle || m_handle.done();
+    }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiter) noexcept
+    {
+      m_handle.promise().continuation = awaiter;
+      return m_handle;
+    }
+
+    T await_resume()
+    {
+      return m_handle.promise().result();
+    }
+
+  private:
+    friend class io_context;
+
+    handle_type m_handle;
+  };
+
+  namespace detail
+  {
+    template <class T>
+    inline task<T> promise<T>::get_return_object() noexcept
+    {
+      return task<T>(coroutine_handle<promise<T>>::from_promise(*this));
+    }
+
+    inline task<void> promise<void>::get_return_object() noexcept
+    {
+      return task<void>(coroutine_handle<promise<void>>::
+                        from_promise(*this));
+    }
+  }
+
+  // The event loop of the coroutines of one thread
+
+  class io_context
+  {
+  public:
+    // An operation on the completion ring
+
+    class ring_op : public detail::operation
+    {
+    public:
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      void await_suspend(coroutine_handle<> h) noexcept
+      {
+        waiter = h;
+        m_ctx.submit(this);
+      }
+
+      ssize_t await_resume() const noexcept
+      {
+        return result;
+      }
+
+    private:
+      friend class io_context;
+
+      ring_op(io_context &ctx, uint8_t opcode, int fd, FAR void *addr,
+              size_t len, off_t off) noexcept;
+
+      io_context &m_ctx;
+      struct io_ring_sqe m_sqe;
+    };
+
+    // entries is the size of the submission queue of the ring, which
+    // bounds the file operations submitted at once, not those in progress
+
+    explicit io_context(unsigned int entries =
+                          CONFIG_LIBXX_ASYNC_IO_ENTRIES) noexcept;
+    ~io_context();
+
+    io_context(const io_context &) = delete;
+    io_context &operator=(const io_context &) = delete;
+
+    // Return OK if the context is usable, or a negated errno value
+
+    int status() const noexcept
+    {
+      return m_status;
+    }
+
+    // Start a coroutine, which destroys itself when it finishes
+
+    void spawn(task<> &&t) noexcept;
+
+    // Run the coroutines until no operation is in progress or stop() is
+    // called.  Return OK, or a negated errno value if epoll fails.
+
+    int run() noexcept;
+
+    void stop() noexcept
+    {
+      m_stopped = true;
+    }
+
+    // Read and write at off, or at the file position if off is -1
+
+    ring_op read(int fd, FAR void *buf, size_t len,
+                 off_t off = -1) noexcept
+    {
+      return ring_op(*this, IORING_OP_READ, fd, buf, len, off);
+    }
+
+    ring_op write(int fd, FAR const void *buf, size_t len,
+                  off_t off = -1) noexcept
+    {
+      return ring_op(*this, IORING_OP_WRITE, fd,
+                     const_cast<FAR void *>(buf), len, off);
+    }
+
+    ring_op fsync(int fd) noexcept
+    {
+      return ring_op(*this, IORING_OP_FSYNC, fd, nullptr, 0, 0);
+    }
+
+  private:
+    friend class stream;
+
+    void submit(FAR ring_op *op) noexcept;
+    void complete(FAR detail::operation *op) noexcept;
+    void flush() noexcept;
+    void harvest() noexcept;
+
+    struct io_ring_s m_ring;
+    int m_ringfd;
+    int m_epfd;
+    int m_status;
+    bool m_stopped;
+    size_t m_pending;                     // Operations in progress
+    FAR ring_op *m_submit_head;           // Not yet in the ring
+    FAR ring_op *m_submit_tail;
+    FAR detail::operation *m_ready_head;  // Completed, to be resumed
+    FAR detail::operation *m_ready_tail;
+  };
+
+  // A pollable descriptor driven by an io_context.  The descriptor is
+  // made non-blocking; it is not closed by the destructor.  A stream may
+  // have one reading (read, recv, accept) and one writing (write, send,
+  // connect) operation in progress at a time.  An operation that can
+  // complete at once does not suspend the coroutine.
+
+  class stream
+  {
+  public:
+    class op : public detail::operation
+    {
+    public:
+      bool await_ready() noexcept
+      {
+        return perform();
+      }
+
+      void await_suspend(coroutine_handle<> h) noexcept
+      {
+        waiter = h;
+        m_stream.wait(this);
+      }
+
+      ssize_t await_resume() const noexcept
+      {
+        return result;
+      }
+
+    private:
+      friend class stream;
+
+      enum kind_e
+      {
+        READ,
+        RECV,
+        ACCEPT,
+        WRITE,
+        SEND,
+        CONNECT
+      };
+
+      op(stream &s, kind_e kind, FAR void *buf, size_t len, int flags,
+         FAR void *addr, FAR socklen_t *addrlen) noexcept
+        : m_stream(s), m_kind(kind), m_buf(buf), m_len(len),
+          m_flags(flags), m_addr(addr), m_addrlen(addrlen),
+          m_started(false)
+      {
+      }
+
+      bool writing() const noexcept
+      {
+        return m_kind >= WRITE;
+      }
+
+      // Try the operation, return false if it would block
+
+      bool perform() noexcept;
+
+      stream &m_stream;
+      kind_e m_kind;
+      FAR void *m_buf;
+      size_t m_len;
+      int m_flags;
+      FAR void *m_addr;
+      FAR socklen_t *m_addrlen;
+      bool m_started;
+    };
+
+    stream(io_context &ctx, int fd) noexcept;
+    ~stream();
+
+    stream(const stream &) = delete;
+    stream &operator=(const stream &) = delete;
+
+    int fd() const noexcept
+    {
+      return m_fd;
+    }
+
+    op read(FAR void *buf, size_t len) noexcept
+    {
+      return op(*this, op::READ, buf, len, 0, nullptr, nullptr);
+    }
+
+    op write(FAR const void *buf, size_t len) noexcept
+    {
+      return op(*this, op::WRITE, const_cast<FAR void *>(buf), len, 0,
+                nullptr, nullptr);
+    }
+
+#ifdef CONFIG_NET
+    op recv(FAR void *buf, size_t len, int flags = 0) noexcept
+    {
+      return op(*this, op::RECV, buf, len, flags, nullptr, nullptr);
+    }
+
+    op send(FAR const void *buf, size_t len, int flags = 0) noexcept
+    {
+      return op(*this, op::SEND, const_cast<FAR void *>(buf), len, flags,
+                nullptr, nullptr);
+    }
+
+    // The result of accept is the descriptor of the new connection
+
+    op accept(FAR struct sockaddr *addr = nullptr,
+              FAR socklen_t *addrlen = nullptr) noexcept
+    {
+      return op(*this, op::ACCEPT, nullptr, 0, 0, addr, addrlen);
+    }
+
+    op connect(FAR const struct sockaddr *addr, socklen_t addrlen) noexcept
+    {
+      return op(*this, op::CONNECT, nullptr, addrlen, 0,
+                const_cast<FAR struct sockaddr *>(addr), nullptr);
+    }
+#endif
+
+  private:
+    friend class io_context;
+
+    void wait(FAR op *o) noexcept;
+    void update() noexcept;
+    void dispatch(uint32_t events) noexcept;
+
+    io_context &m_ctx;
+    int m_fd;
+    FAR op *m_reader;
+    FAR op *m_writer;
+    uint32_t m_events;                    // The events polled by epoll
+  };
+}
+}
+
+#endif // CONFIG_LIBXX_ASYNC_IO
+#endif // __INCLUDE_NUTTX_ASYNC_IO_HXX
@@ -92,6 +92,12 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_SETRXRING - Set up the capture ring mapped with mmap()
+ *
+ *   ioctl argument:  Pointer to the audio_ring_req_s structure giving the
+ *                    number and size of the periods, or zero periods to
+ *                    release the ring.  Only while streaming is stopped.
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -111,6 +117,7 @@
 #define AUDIOIOC_UNREGISTERMQ       _AUDIOIOC(15)
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
 #define AUDIOIOC_SETBUFFERINFO      _AUDIOIOC(17)
+#define AUDIOIOC_SETRXRING          _AUDIOIOC(18)
 
 /* Audio Device Types *******************************************************/
 
@@ -344,6 +351,16 @@
 #define AUDIO_APB_OUTPUT_PROCESS    (1 << 1)
 #define AUDIO_APB_DEQUEUED          (1 << 2)
 #define AUDIO_APB_FINAL             (1 << 3) /* Last buffer in the stream */
+#define AUDIO_APB_DMA               (1 << 4) /* From audio_dma_alloc() */
+
+/* Values of the status of a period of the capture ring.  The period belongs
+ * to the driver while its status is AUDIO_RING_KERNEL; the driver sets
+ * AUDIO_RING_USER when the DMA has filled it, and the application gives
+ * it back by writing AUDIO_RING_KERNEL.
+ */
+
+#define AUDIO_RING_KERNEL           0
+#define AUDIO_RING_USER             1
 
 /****************************************************************************
  * Public Types
@@ -494,6 +511,40 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* The request of AUDIOIOC_SETRXRING */
+
+struct audio_ring_req_s
+{
+  uint16_t            nperiods;           /* Number of periods, 0 to free */
+  uint32_t            period_bytes;       /* Size of one period */
+};
+
+/* The capture ring, as mapped with mmap() on the audio device.  The header
+ * is followed by nperiods slots; period i is stored at offset
+ * data + i * stride from the start of the ring.  The sequence numbers of
+ * the periods increase by one per period captured, including the periods
+ * lost while the application held all of the slots.
+ */
+
+struct audio_ring_slot_s
+{
+  volatile uint32_t   status;             /* AUDIO_RING_KERNEL or _USER */
+  uint32_t            nbytes;             /* Bytes captured in the period */
+  uint32_t            seq;                /* Sequence number of the period */
+  uint32_t            reserved;
+};
+
+struct audio_ring_s
+{
+  uint32_t            nperiods;           /* Number of periods */
+  uint32_t            period_bytes;       /* Size of one period */
+  uint32_t            stride;             /* Distance between two periods */
+  uint32_t            data;               /* Offset of the first period */
+  volatile uint32_t   overruns;           /* Periods lost, the ring full */
+  uint32_t            reserved[3];
+  struct audio_ring_slot_s slot[1];       /* nperiods slots */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -768,7 +819,7 @@ int audio_register(FAR const char *name, FAR struct audio_lowerhalf_s *dev);
  * Description:
  *   Allocated an AP Buffer and prepares it for use.
  *   This allocates a dynamically allocated buffer that has no special
- *    DMA capabilities.
+ *    DMA capabilities, unless CONFIG_AUDIO_DMAMEMORY is set.
  *
  * Input Parameters:
  *   bufdesc:   Pointer to a buffer descriptor
@@ -780,6 +831,23 @@ int audio_register(FAR const char *name, FAR struct audio_lowerhalf_s *dev);
 
 int apb_alloc(FAR struct audio_buf_desc_s *bufdesc);
 
+/****************************************************************************
+ * Name: audio_dma_alloc and audio_dma_free
+ *
+ * Description:
+ *   With CONFIG_AUDIO_DMAMEMORY, the board-specific logic must provide
+ *   these functions.  audio_dma_alloc() allocates size bytes of memory
+ *   that the I2S DMA can reach, aligned on CONFIG_AUDIO_DMAMEMORY_ALIGN;
+ *   audio_dma_free() releases it.  apb_alloc() allocates the audio
+ *   buffers with them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_DMAMEMORY
+FAR void *audio_dma_alloc(size_t size);
+void audio_dma_free(FAR void *memory);
+#endif
+
 /****************************************************************************
  * Name: apb_free
  *
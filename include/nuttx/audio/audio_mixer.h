@@ -0,0 +1,95 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mixer.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+#include <nuttx/audio/audio.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The format of the output of a mixer.  The output is 16-bit PCM. */
+
+struct audio_mixer_config_s
+{
+  uint32_t samprate;    /* Sample rate of the output */
+  uint8_t  nchannels;   /* 1 or 2 channels */
+  uint8_t  nbuffers;    /* Buffers queued to the output, 2 to 32 */
+  uint16_t nframes;     /* Frames per buffer of the output */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Share an output audio device between several clients.  nstreams audio
+ *   devices are registered, named name0, name1, ...  Each of them accepts
+ *   one stream of 16-bit PCM, mono or stereo, at its own sample rate, with
+ *   its own volume.  The streams are resampled to the rate of the output,
+ *   mixed and sent to the lower half, which must not be registered itself.
+ *
+ * Input Parameters:
+ *   name     - The prefix of the names of the stream devices
+ *   lower    - The output device
+ *   config   - The format of the output
+ *   nstreams - The number of stream devices
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           FAR const struct audio_mixer_config_s *config,
+                           int nstreams);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIXER */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H */
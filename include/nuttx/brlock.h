@@ -0,0 +1,147 @@
+/****************************************************************************
+ * include/nuttx/brlock.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BRLOCK_H
+#define __INCLUDE_NUTTX_BRLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/mutex.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The reader count of each CPU has a cache line of its own, so that
+ * readers on different CPUs do not contend for it.
+ */
+
+#define BRLOCK_ALIGN        64
+
+#define BRLOCK_INITIALIZER  {NXMUTEX_INITIALIZER, false, {{0}}}
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A reader-writer lock for read-mostly data.  A reader only increments
+ * the count of its CPU, while a writer must lock the mutex and wait until
+ * the counts of all CPUs drop to zero:  Locking for reading is cheap and
+ * scales with the number of CPUs, locking for writing is expensive.
+ */
+
+struct brlock_cpu_s
+{
+  /* The readers entered on the CPU */
+
+  volatile int readers aligned_data(BRLOCK_ALIGN);
+};
+
+struct brlock_s
+{
+  mutex_t mutex;                      /* Serializes the writers */
+  volatile bool writer;               /* A writer holds or waits for it */
+  struct brlock_cpu_s cpu[CONFIG_SMP_NCPUS];
+};
+
+typedef struct brlock_s brlock_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: brlock_init
+ *
+ * Description:
+ *   Initialize a lock, like BRLOCK_INITIALIZER does.
+ *
+ ****************************************************************************/
+
+void brlock_init(FAR brlock_t *lock);
+
+/****************************************************************************
+ * Name: brlock_rdlock
+ *
+ * Description:
+ *   Lock for reading.  Readers may be preempted and may block while they
+ *   hold the lock, and need not unlock it on the CPU that they locked it
+ *   on:  The returned slot identifies the count that they incremented.
+ *   Readers must not lock for writing.
+ *
+ * Returned Value:
+ *   The slot to pass to brlock_rdunlock() on success; a negated errno
+ *   value if the wait for a writer failed.
+ *
+ ****************************************************************************/
+
+int brlock_rdlock(FAR brlock_t *lock);
+
+/****************************************************************************
+ * Name: brlock_rdunlock
+ *
+ * Description:
+ *   Unlock for reading.
+ *
+ * Input Parameters:
+ *   lock - The lock
+ *   slot - The value returned by brlock_rdlock()
+ *
+ ****************************************************************************/
+
+void brlock_rdunlock(FAR brlock_t *lock, int slot);
+
+/****************************************************************************
+ * Name: brlock_wrlock and brlock_wrunlock
+ *
+ * Description:
+ *   Lock and unlock for writing.  A writer holds off new readers and waits
+ *   for the present ones, polling once per tick.
+ *
+ * Returned Value:
+ *   brlock_wrlock() returns OK on success; a negated errno value if the
+ *   mutex could not be locked.
+ *
+ ****************************************************************************/
+
+int brlock_wrlock(FAR brlock_t *lock);
+void brlock_wrunlock(FAR brlock_t *lock);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_BRLOCK_H */
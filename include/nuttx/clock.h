@@ -219,6 +219,21 @@ typedef int64_t sclock_t;
 typedef int32_t sclock_t;
 #endif
 
+/* The time page is written by the kernel and read without a system call by
+ * clock_gettime() in the C library.  The kernel increments seq before and
+ * after each update, so that an odd or a changed seq tells the reader to
+ * try again.
+ */
+
+#ifdef CONFIG_CLOCK_TIMEPAGE
+struct clock_timepage_s
+{
+  volatile uint32_t seq;      /* Sequence count, odd during an update */
+  clock_t ticks;              /* The system timer, see g_system_ticks */
+  struct timespec basetime;   /* The time-of-day at the tick 0 */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -471,6 +486,34 @@ int clock_ticks2time(sclock_t ticks, FAR struct timespec *reltime);
 
 int clock_systime_timespec(FAR struct timespec *ts);
 
+#ifdef CONFIG_CLOCK_TIMEPAGE
+/****************************************************************************
+ * Name: clock_timepage
+ *
+ * Description:
+ *   Return the time page, which the caller can read but must not modify.
+ *
+ * Returned Value:
+ *   The time page; NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_timepage_s *clock_timepage(void);
+
+/****************************************************************************
+ * Name: nx_clock_gettime
+ *
+ * Description:
+ *   The kernel implementation of clock_gettime().  With
+ *   CONFIG_CLOCK_TIMEPAGE, clock_gettime() is provided by the C library,
+ *   which calls this only for the clocks that are not in the time page.
+ *   It follows the application error return policy (errno is set).
+ *
+ ****************************************************************************/
+
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp);
+#endif
+
 /****************************************************************************
  * Name:  clock_cpuload
  *
@@ -494,6 +537,28 @@ int clock_systime_timespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cpuutil
+ *
+ * Description:
+ *   Return the utilization counts of a CPU:  The number of its ticks and
+ *   the number of those in which it was not idle.  The counts are never
+ *   scaled back, the utilization over an interval is the ratio of their
+ *   differences.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the CPU of interest
+ *   util - The location to return the counts
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if cpu is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD
+int clock_cpuutil(int cpu, FAR struct cpuload_s *util);
+#endif
+
 /****************************************************************************
  * Name:  nxsched_oneshot_extclk
  *
@@ -191,6 +191,10 @@
 #  define always_inline_function __attribute__ ((always_inline,no_instrument_function))
 #  define noinline_function __attribute__ ((noinline))
 
+/* The return address of the current function, or of one of its callers */
+
+#  define return_address(x) __builtin_return_address(x)
+
 /* The noinstrument_function attribute informs GCC don't instrument it */
 
 #  define noinstrument_function __attribute__ ((no_instrument_function))
@@ -472,6 +476,7 @@
 #  define always_inline_function
 #  define noinline_function
 #  define noinstrument_function
+#  define return_address(x) 0
 #  define nosanitize_address
 #  define nosanitize_undefined
 #  define nostackprotect_function
@@ -605,6 +610,7 @@
 #  define always_inline_function
 #  define noinline_function
 #  define noinstrument_function
+#  define return_address(x) 0
 #  define nosanitize_address
 #  define nosanitize_undefined
 #  define nostackprotect_function
@@ -707,6 +713,7 @@
 #  define always_inline_function
 #  define noinline_function
 #  define noinstrument_function
+#  define return_address(x) 0
 #  define nosanitize_address
 #  define nosanitize_undefined
 #  define nostackprotect_function
@@ -788,6 +795,7 @@
 #  define always_inline_function
 #  define noinline_function
 #  define noinstrument_function
+#  define return_address(x) 0
 #  define nosanitize_address
 #  define nosanitize_undefined
 #  define nostackprotect_function
@@ -844,6 +852,7 @@
 #  define always_inline_function
 #  define noinline_function
 #  define noinstrument_function
+#  define return_address(x) 0
 #  define nosanitize_address
 #  define nosanitize_undefined
 #  define nostackprotect_function
@@ -137,6 +137,22 @@ void devcrypto_register(void);
 
 void devzero_register(void);
 
+/****************************************************************************
+ * Name: devbench_register
+ *
+ * Description:
+ *   Register /dev/bench, which runs the kernel microbenchmarks when read
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void devbench_register(void);
+
 /****************************************************************************
  * Name: bchdev_register
  *
@@ -53,6 +53,33 @@ typedef CODE ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef CODE ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                                    off_t startblock, size_t nblocks);
 
+/* The state of one write buffer.  A write buffer holds a contiguous range
+ * of blocks of one window of wrmaxblocks blocks, aligned to wrmaxblocks.
+ */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+struct rwb_wrbuffer_s
+{
+  FAR uint8_t  *buffer;          /* The blocks of the window */
+  off_t         window;          /* First block of the window, -1 if free */
+  uint16_t      first;           /* First buffered block in the window */
+  uint16_t      nblocks;         /* Number of buffered blocks */
+  clock_t       stamp;           /* Time of the last write */
+};
+#endif
+
+/* The state of one read-ahead buffer */
+
+#ifdef CONFIG_DRVR_READAHEAD
+struct rwb_rhbuffer_s
+{
+  FAR uint8_t  *buffer;          /* The buffered blocks */
+  off_t         blockstart;      /* First block in the buffer */
+  uint16_t      nblocks;         /* Number of blocks in the buffer */
+  uint32_t      stamp;           /* Sequence number of the last access */
+};
+#endif
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -93,7 +120,9 @@ struct rwbuffer_s
 
   /* Read-ahead/Write buffer sizes.  Buffering can be disabled (even if it
    * is enabled in the configuration) by setting the buffer size to zero
-   * blocks.
+   * blocks.  Several buffers of that size may be used, to keep the data of
+   * interleaved accesses to different regions: They are recycled in least
+   * recently used order.
    */
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -101,9 +130,11 @@ struct rwbuffer_s
   uint16_t      wralignblocks;   /* The buffer to be flash is always multiplied by this
                                   * number. It must be 0 or divisible by wrmaxblocks.
                                   */
+  uint8_t       wrnbuffers;      /* Number of write buffers, 0 means 1 */
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   uint16_t      rhmaxblocks;     /* The number of blocks to buffer in memory */
+  uint8_t       rhnbuffers;      /* Number of read-ahead buffers, 0 means 1 */
 #endif
 
   /* Callback functions.
@@ -129,18 +160,23 @@ struct rwbuffer_s
 #ifdef CONFIG_DRVR_WRITEBUFFER
   mutex_t       wrlock;          /* Enforces exclusive access to the write buffer */
   struct work_s work;            /* Delayed work to flush buffer after a delay with no activity */
-  FAR uint8_t  *wrbuffer;        /* Allocated write buffer */
-  uint16_t      wrnblocks;       /* Number of blocks in write buffer */
-  off_t         wrblockstart;    /* First block in write buffer */
+  FAR uint8_t  *wrbuffer;        /* Allocated write buffers */
+
+  /* The states of the write buffers */
+
+  FAR struct rwb_wrbuffer_s *wrbuffers;
 #endif
 
   /* This is the state of the read-ahead buffering */
 
 #ifdef CONFIG_DRVR_READAHEAD
   mutex_t       rhlock;          /* Enforces exclusive access to the write buffer */
-  FAR uint8_t  *rhbuffer;        /* Allocated read-ahead buffer */
-  uint16_t      rhnblocks;       /* Number of blocks in read-ahead buffer */
-  off_t         rhblockstart;    /* First block in read-ahead buffer */
+  FAR uint8_t  *rhbuffer;        /* Allocated read-ahead buffers */
+  uint32_t      rhseq;           /* Sequence number of the last access */
+
+  /* The states of the read-ahead buffers */
+
+  FAR struct rwb_rhbuffer_s *rhbuffers;
 #endif
 };
 
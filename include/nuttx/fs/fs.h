@@ -233,6 +233,21 @@ struct geometry
   blksize_t geo_sectorsize;   /* Size of one sector */
 };
 
+/* The argument of BIOC_DAX.  A driver whose media is memory returns the
+ * address of startsector and the number of sectors that can be accessed
+ * contiguously from it, which may be more or less than requested.  If
+ * writable is false, the memory must not be written.
+ */
+
+struct bio_dax_s
+{
+  blkcnt_t  startsector;  /* IN:  The first sector to access */
+  blkcnt_t  nsectors;     /* IN:  The number of sectors to access
+                           * OUT: The number of sectors accessible */
+  FAR void *addr;         /* OUT: The address of startsector */
+  bool      writable;     /* OUT: The memory may be written */
+};
+
 struct partition_info_s
 {
   size_t    numsectors;   /* Number of sectors in the partition */
@@ -415,6 +430,19 @@ struct file
   FAR void         *f_priv;     /* Per file driver private data */
 };
 
+/* The argument of the PIPEIOC_SPLICE, PIPEIOC_TEE and PIPEIOC_FILL ioctl
+ * commands: the other file of the transfer and the splice() arguments
+ * that apply to it.
+ */
+
+struct pipe_splice_s
+{
+  FAR struct file  *ps_file;    /* The file to write to or read from */
+  FAR off_t        *ps_offset;  /* Position in ps_file, NULL: f_pos */
+  size_t            ps_len;     /* The maximum number of bytes */
+  unsigned int      ps_flags;   /* SPLICE_F_* flags */
+};
+
 /* This defines a two layer array of files indexed by the file descriptor.
  * Each row of this array is fixed size: CONFIG_NFILE_DESCRIPTORS_PER_BLOCK.
  * You can get file instance in filelist by the follow methods:
@@ -606,6 +634,33 @@ int register_blockpartition(FAR const char *partition,
                             off_t firstsector, off_t nsectors);
 #endif
 
+/****************************************************************************
+ * Name: register_blockqueue
+ *
+ * Description:
+ *   Register a block driver inode that queues, sorts and merges the
+ *   requests to another block driver.  Concurrent accesses through the
+ *   queue reach the parent as fewer and larger transfers.
+ *
+ * Input Parameters:
+ *   path   - The path to the queue inode
+ *   mode   - The access permissions of the queue inode
+ *   parent - The path to the parent inode
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on a failure:
+ *
+ *   EINVAL - 'path' is invalid for this operation
+ *   EEXIST - An inode already exists at 'path'
+ *   ENOMEM - Failed to allocate in-memory resources for the operation
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKQUEUE
+int register_blockqueue(FAR const char *path, mode_t mode,
+                        FAR const char *parent);
+#endif
+
 /****************************************************************************
  * Name: unregister_driver
  *
@@ -1187,6 +1242,21 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice and file_tee
+ *
+ * Description:
+ *   Equivalent to the splice() and tee() functions except that they accept
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t len, unsigned int flags);
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -194,6 +194,8 @@ int           host_fstat(int fd, struct nuttx_stat_s *buf);
 int           host_fchstat(int fd, const struct nuttx_stat_s *buf,
                            int flags);
 int           host_ftruncate(int fd, nuttx_off_t length);
+void         *host_mmap(int fd, nuttx_size_t length, int writable);
+int           host_munmap(void *addr, nuttx_size_t length);
 void         *host_opendir(const char *name);
 int           host_readdir(void *dirp, struct nuttx_dirent_s *entry);
 void          host_rewinddir(void *dirp);
@@ -218,6 +220,8 @@ int           host_dup(int fd);
 int           host_fstat(int fd, struct stat *buf);
 int           host_fchstat(int fd, const struct stat *buf, int flags);
 int           host_ftruncate(int fd, off_t length);
+void         *host_mmap(int fd, size_t length, int writable);
+int           host_munmap(void *addr, size_t length);
 void         *host_opendir(const char *name);
 int           host_readdir(void *dirp, struct dirent *entry);
 void          host_rewinddir(void *dirp);
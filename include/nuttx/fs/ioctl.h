@@ -94,6 +94,7 @@
 #define _LTEBASE        (0x3600) /* LTE device ioctl commands */
 #define _VIDIOCBASE     (0x3700) /* Video device ioctl commands */
 #define _CELLIOCBASE    (0x3800) /* Cellular device ioctl commands */
+#define _PTPIOCBASE     (0x3900) /* PTP hardware clock ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -298,6 +299,15 @@
                                            *      to return sector size.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_DAX        _BIOC(0x0010)     /* Direct access to a range of
+                                           * sectors in memory.
+                                           * IN:  Pointer to struct bio_dax_s
+                                           *      with the first sector and
+                                           *      the number of sectors
+                                           * OUT: The address of the first
+                                           *      sector and the number of
+                                           *      sectors that follow it
+                                           *      contiguously */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -422,6 +432,18 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SPLICE    _PIPEIOC(0x0002)  /* Move data out of the pipe
+                                             * to another file
+                                             * IN: struct pipe_splice_s *
+                                             * OUT: Bytes moved */
+#define PIPEIOC_TEE       _PIPEIOC(0x0003)  /* Copy data out of the pipe
+                                             * without consuming it
+                                             * IN: struct pipe_splice_s *
+                                             * OUT: Bytes copied */
+#define PIPEIOC_FILL      _PIPEIOC(0x0004)  /* Read another file directly
+                                             * into the pipe
+                                             * IN: struct pipe_splice_s *
+                                             * OUT: Bytes moved */
 
 /* RTC driver ioctl definitions *********************************************/
 
@@ -611,6 +633,11 @@
 #define _CELLIOCVALID(c) (_IOC_TYPE(c)==_CELLIOCBASE)
 #define _CELLIOC(nr)     _IOC(_CELLIOCBASE,nr)
 
+/* PTP hardware clock ioctl definitions *************************************/
+
+#define _PTPIOCVALID(c) (_IOC_TYPE(c)==_PTPIOCBASE)
+#define _PTPIOC(nr)     _IOC(_PTPIOCBASE,nr)
+
 /* Wireless driver network ioctl definitions ********************************/
 
 /* (see nuttx/include/wireless/wireless.h */
@@ -144,6 +144,27 @@ struct procfs_meminfo_entry_s
 #endif
 };
 
+/* A record of /proc/taskstat.  A read() returns one record for each task
+ * and thread, without formatting, starting from the record at the file
+ * position.  The fields of disabled features are zero.
+ */
+
+struct procfs_taskstat_s
+{
+  uint64_t cputime;                  /* CPU time in nanoseconds */
+  uint32_t nswitches;                /* Number of times switched in */
+  uint32_t stacksize;                /* Size of the stack */
+  uint32_t stackused;                /* High-water mark of the stack */
+  int32_t  pid;                      /* ID of the thread */
+  int32_t  group;                    /* ID of the main thread of the task */
+  uint16_t flags;                    /* TCB_FLAG_* */
+  uint8_t  state;                    /* TSTATE_* */
+  uint8_t  priority;                 /* Current priority */
+  uint8_t  basepriority;             /* Priority without any boost */
+  uint8_t  cpu;                      /* CPU running or assigned to */
+  uint8_t  reserved[6];
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
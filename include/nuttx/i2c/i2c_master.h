@@ -234,6 +234,26 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* This describes a transfer queued with i2c_transfer_async().  It belongs
+ * to the bus until its callback is called, so it and its messages must stay
+ * valid until then.
+ */
+
+struct i2c_async_s;
+typedef CODE void (*i2c_async_callback_t)(FAR struct i2c_async_s *req,
+                                          int result);
+
+struct i2c_async_s
+{
+  FAR struct i2c_async_s *flink;   /* Private: next in the queue of the bus */
+  FAR struct i2c_msg_s *msgs;      /* The messages of the transfer */
+  int count;                       /* The number of messages */
+  i2c_async_callback_t callback;   /* Called when it has been performed */
+  FAR void *arg;                   /* For the use of the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -347,6 +367,49 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue an I2C transfer and return at once.  The transfers queued on a
+ *   bus are performed in order by a kernel thread of the bus; the callback
+ *   of each one is called on that thread with the result of I2C_TRANSFER
+ *   once it has completed.  It may queue the next transfer.
+ *
+ *   This must not be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to queue, with its messages and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; -ENOMEM if there are already
+ *   CONFIG_I2C_ASYNC_NBUSES buses or the thread of the bus cannot be
+ *   started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+int i2c_transfer_async(FAR struct i2c_master_s *dev,
+                       FAR struct i2c_async_s *req);
+
+/****************************************************************************
+ * Name: i2c_transfer_cancel
+ *
+ * Description:
+ *   Remove a request from the queue of its bus if it has not been started.
+ *   Its callback is not called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -ENOENT if it has been started,
+ *   or is not queued.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_cancel(FAR struct i2c_master_s *dev,
+                        FAR struct i2c_async_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
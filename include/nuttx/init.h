@@ -71,6 +71,31 @@ enum nx_initstate_e
   OSINIT_IDLELOOP  = 6   /* The OS enter idle loop */
 };
 
+/* A boot initializer, see bootinit_register().  The caller provides the
+ * first fields and the storage, which must persist; the rest is private to
+ * the framework.
+ */
+
+#ifdef CONFIG_BOOTINIT
+#define BOOTINIT_DEFERRED        (1 << 0) /* Start after the application */
+
+struct bootinit_s
+{
+  FAR const char *bi_name;                   /* Name for the boot report */
+  CODE int (*bi_init)(void);                 /* The initialization logic */
+  FAR struct bootinit_s * const *bi_depends; /* NULL terminated, or NULL */
+  uint8_t bi_flags;                          /* See BOOTINIT_* definitions */
+
+  /* Set by the framework */
+
+  FAR struct bootinit_s *bi_flink;           /* Registration order */
+  uint8_t bi_state;                          /* Not run, running or done */
+  int bi_result;                             /* Value returned by bi_init */
+  uint32_t bi_start;                         /* Time since boot (usec) */
+  uint32_t bi_elapsed;                       /* Duration of bi_init (usec) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -100,6 +125,32 @@ EXTERN uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void) noreturn_function;
 
+/****************************************************************************
+ * Name: bootinit_register
+ *
+ * Description:
+ *   Register a boot initializer.  This is normally called by
+ *   board_late_initialize(); the initializers run once it has returned,
+ *   each one as soon as all of its dependencies have completed.
+ *
+ *   The dependencies must be registered first, which also rules out
+ *   cycles.  An initializer whose dependency failed is not run and
+ *   completes with -ECANCELED.
+ *
+ * Input Parameters:
+ *   init - The initializer.  The storage must persist.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if a dependency is not registered or
+ *   -EINVAL if an initializer that the application waits for depends on
+ *   a deferred one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOOTINIT
+int bootinit_register(FAR struct bootinit_s *init);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
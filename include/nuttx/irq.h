@@ -48,6 +48,12 @@
 
 #  define irq_detach(irq) irq_attach(irq, NULL, NULL)
 
+/* Returned by the interrupt context handler of irq_attach_thread() to run
+ * the thread handler.
+ */
+
+#  define IRQ_WAKE_THREAD 1
+
 /* Maximum/minimum values of IRQ integer types */
 
 #  if NR_IRQS <= 256
@@ -148,6 +154,20 @@ extern "C"
 
 int irq_attach(int irq, xcpt_t isr, FAR void *arg);
 
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that IRQ number 'irq' is handled by
+ *   'isrthread' in a kernel thread of the given priority, woken up when
+ *   'isr' returns IRQ_WAKE_THREAD or, if 'isr' is NULL, on each interrupt.
+ *   A NULL 'isrthread' detaches the interrupt and terminates its thread.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size);
+
 #ifdef CONFIG_IRQCHAIN
 int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #else
@@ -219,6 +239,47 @@ void leave_critical_section(irqstate_t flags);
 #  define leave_critical_section(f) up_irq_restore(f)
 #endif
 
+/****************************************************************************
+ * Name: local_irq_save
+ *
+ * Description:
+ *   Disable interrupts on the current CPU only.  Unlike
+ *   enter_critical_section(), this never takes the global CPU IRQ lock,
+ *   so in an SMP configuration it does not exclude the other CPUs and
+ *   never waits for them.  Data shared with other CPUs must in addition be
+ *   protected by a spinlock of its own (see spin_lock_irqsave()).
+ *
+ *   The calls nest, but without a counter: each call must be paired with
+ *   local_irq_restore() with the value that it returned.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to local_irq_save();
+ *
+ ****************************************************************************/
+
+#define local_irq_save() up_irq_save()
+
+/****************************************************************************
+ * Name: local_irq_restore
+ *
+ * Description:
+ *   Restore the interrupt state of the current CPU as it was prior to the
+ *   matching local_irq_save().
+ *
+ * Input Parameters:
+ *   flags - The value returned by local_irq_save()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#define local_irq_restore(f) up_irq_restore(f)
+
 /****************************************************************************
  * Name: restore_critical_section
  *
@@ -80,6 +80,29 @@ extern "C"
 #define kumm_free(p)             free(p)
 #define kumm_mallinfo()          mallinfo()
 
+/* Allocations that prefer a memory tier, see enum mm_tier_e.  The tiers
+ * are only known to the heap of the flat build.  Otherwise, and if the
+ * preferred tier is full, any memory of the heap is used.
+ */
+
+#ifdef CONFIG_MM_HEAP_TIERS
+#  define kumm_addregion_tier(h,s,t)  mm_addregion_tier(g_mmheap,h,s,t)
+#  define kumm_malloc_tier(s,t)       mm_malloc_tier(g_mmheap,s,t)
+#  define kumm_zalloc_tier(s,t)       mm_zalloc_tier(g_mmheap,s,t)
+#  define kumm_memalign_tier(a,s,t)   mm_memalign_tier(g_mmheap,a,s,t)
+#  define kmm_malloc_tier(s,t)        mm_malloc_tier(g_mmheap,s,t)
+#  define kmm_zalloc_tier(s,t)        mm_zalloc_tier(g_mmheap,s,t)
+#  define kmm_memalign_tier(a,s,t)    mm_memalign_tier(g_mmheap,a,s,t)
+#else
+#  define kumm_addregion_tier(h,s,t)  kumm_addregion(h,s)
+#  define kumm_malloc_tier(s,t)       kumm_malloc(s)
+#  define kumm_zalloc_tier(s,t)       kumm_zalloc(s)
+#  define kumm_memalign_tier(a,s,t)   kumm_memalign(a,s)
+#  define kmm_malloc_tier(s,t)        kmm_malloc(s)
+#  define kmm_zalloc_tier(s,t)        kmm_zalloc(s)
+#  define kmm_memalign_tier(a,s,t)    kmm_memalign(a,s)
+#endif
+
 /* This family of allocators is used to manage kernel protected memory */
 
 #ifndef CONFIG_MM_KERNEL_HEAP
@@ -159,6 +159,9 @@ struct module_s
   mod_initializer_t initializer;       /* Module initializer function */
 #endif
   struct mod_info_s modinfo;           /* Module information */
+#ifdef CONFIG_SYMTAB_HASH
+  struct symtab_hash_s exphash;        /* Hash index of the exports */
+#endif
   FAR void *textalloc;                 /* Allocated kernel text memory */
   FAR void *dataalloc;                 /* Allocated kernel memory */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
@@ -191,6 +194,7 @@ struct mod_loadinfo_s
    */
 
   uintptr_t         textalloc;   /* .text memory allocated when module was loaded */
+  uintptr_t         textstart;   /* Address of the first .text section */
   uintptr_t         datastart;   /* Start of.bss/.data memory in .text allocation */
   size_t            textsize;    /* Size of the module .text memory allocation */
   size_t            datasize;    /* Size of the module .bss/.data memory allocation */
@@ -205,6 +209,9 @@ struct mod_loadinfo_s
   uint16_t          strtabidx;   /* String table section index */
   uint16_t          buflen;      /* size of iobuffer[] */
   int               filfd;       /* Descriptor for the file being loaded */
+#ifdef CONFIG_MODLIB_XIP
+  uintptr_t         xipbase;     /* Address of the file if memory mapped */
+#endif
 };
 
 /****************************************************************************
@@ -530,4 +537,42 @@ int modlib_registry_verify(FAR struct module_s *modp);
 
 int modlib_registry_foreach(mod_callback_t callback, FAR void *arg);
 
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol exported by a module by name.
+ *
+ * Input Parameters:
+ *   modp - The module.
+ *   name - The name of the symbol.
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the module does not export a symbol
+ *   of that name.
+ *
+ * Assumptions:
+ *   The caller holds the lock on the module registry.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findexport(FAR struct module_s *modp,
+                                             FAR const char *name);
+
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol of the current kernel symbol table by name.
+ *
+ * Input Parameters:
+ *   name - The name of the symbol.
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if there is no symbol of that name.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name);
+
 #endif /* __INCLUDE_NUTTX_LIB_MODLIB_H */
@@ -28,6 +28,8 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <fixedmath.h>
 
 /****************************************************************************
@@ -143,6 +145,13 @@ struct cordic_ops_s
 
   CODE int (*calc)(FAR struct cordic_lowerhalf_s *lower,
                    FAR struct cordic_calc_s *calc);
+
+  /* Calculate n requests of the same function and res2_incl in a row,
+   * configuring the unit once (optional).
+   */
+
+  CODE int (*calcv)(FAR struct cordic_lowerhalf_s *lower,
+                    FAR struct cordic_calc_s *calc, size_t n);
 };
 
 /* This structure provides the publicly visible representation of the
@@ -182,6 +191,69 @@ extern "C"
 int cordic_register(FAR const char *path,
                     FAR struct cordic_lowerhalf_s *lower);
 
+#ifdef CONFIG_MATH_CORDIC_DIRECT
+/****************************************************************************
+ * Name: cordic_direct_calc
+ *
+ * Description:
+ *   Calculate n requests of the same function with the first registered
+ *   CORDIC unit, without going through the character driver.  This may be
+ *   called from any context, including interrupt handlers.
+ *
+ * Returned Value:
+ *   OK on success; -ENODEV if no unit is registered, or -EBUSY if the unit
+ *   is in use by an interrupted caller, so that the caller can fall back
+ *   to a software implementation.
+ *
+ ****************************************************************************/
+
+int cordic_direct_calc(FAR struct cordic_calc_s *calc, size_t n);
+
+/****************************************************************************
+ * Name: cordic_sincosf
+ *
+ * Description:
+ *   Calculate the sine and the cosine of an angle in radians with the
+ *   CORDIC unit.  Either result pointer may be NULL.  The accuracy is that
+ *   of the unit, e.g. about 2^-20 for 24 iterations on the STM32.
+ *
+ * Returned Value:
+ *   OK on success; -EDOM if the angle is not finite or too large to be
+ *   reduced accurately, otherwise as cordic_direct_calc().
+ *
+ ****************************************************************************/
+
+int cordic_sincosf(float angle, FAR float *sinval, FAR float *cosval);
+
+/****************************************************************************
+ * Name: cordic_atan2f
+ *
+ * Description:
+ *   Calculate atan2(y, x) in radians with the CORDIC unit.
+ *
+ * Returned Value:
+ *   OK on success; -EDOM if an argument is not finite or both are zero,
+ *   otherwise as cordic_direct_calc().
+ *
+ ****************************************************************************/
+
+int cordic_atan2f(float y, float x, FAR float *phase);
+
+/****************************************************************************
+ * Name: cordic_sincos_b16
+ *
+ * Description:
+ *   Calculate the sine and the cosine of a b16 angle in radians with the
+ *   CORDIC unit.  Either result pointer may be NULL.
+ *
+ * Returned Value:
+ *   As cordic_direct_calc().
+ *
+ ****************************************************************************/
+
+int cordic_sincos_b16(b16_t angle, FAR b16_t *sinval, FAR b16_t *cosval);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -337,6 +337,43 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
                            FAR const void *src, size_t bytes);
 
+/****************************************************************************
+ * Name: circbuf_write_begin / circbuf_write_commit
+ *
+ * Description:
+ *   Zero-copy write: circbuf_write_begin() returns the contiguous free
+ *   space at the head of the buffer (NULL if full) and its size; the
+ *   producer fills it in place and publishes what it wrote with
+ *   circbuf_write_commit().  Usable without locking by a single producer.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   size  - Location to return the size of the region.
+ *   bytes - Number of bytes written, at most the size of the region.
+ ****************************************************************************/
+
+FAR void *circbuf_write_begin(FAR struct circbuf_s *circ,
+                              FAR size_t *size);
+void circbuf_write_commit(FAR struct circbuf_s *circ, size_t bytes);
+
+/****************************************************************************
+ * Name: circbuf_read_begin / circbuf_read_commit
+ *
+ * Description:
+ *   Zero-copy read: circbuf_read_begin() returns the contiguous data at
+ *   the tail of the buffer (NULL if empty) and its size; the consumer uses
+ *   it in place and releases what it consumed with circbuf_read_commit().
+ *   Usable without locking by a single consumer.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   size  - Location to return the size of the region.
+ *   bytes - Number of bytes consumed, at most the size of the region.
+ ****************************************************************************/
+
+FAR void *circbuf_read_begin(FAR struct circbuf_s *circ, FAR size_t *size);
+void circbuf_read_commit(FAR struct circbuf_s *circ, size_t bytes);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
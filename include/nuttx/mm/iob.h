@@ -30,6 +30,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifdef CONFIG_IOB_TIMESTAMP
+#  include <time.h>
+#endif
+
 #ifdef CONFIG_IOB_NOTIFIER
 #  include <nuttx/wqueue.h>
 #endif
@@ -55,6 +59,13 @@
 #  define CONFIG_IOB_THROTTLE 0
 #endif
 
+/* The per-CPU caches of free I/O buffers are only useful with SMP */
+
+#if !defined(CONFIG_IOB_PERCPU_CACHE) || !defined(CONFIG_SMP)
+#  undef CONFIG_IOB_PERCPU_CACHE
+#  define CONFIG_IOB_PERCPU_CACHE 0
+#endif
+
 /* Some I/O buffers should be allocated */
 
 #if !defined(CONFIG_IOB_NBUFFERS)
@@ -83,7 +94,19 @@
 /* For backward compatibility when not using iob header padding */
 
 #if CONFIG_IOB_HEADSIZE == 0
-#  define  io_head  io_data
+#  ifdef CONFIG_IOB_EXTERNAL
+#    define  io_head  io_buf
+#  else
+#    define  io_head  io_data
+#  endif
+#endif
+
+/* The kinds of io_tstamp */
+
+#ifdef CONFIG_IOB_TIMESTAMP
+#  define IOB_TSTAMP_NONE     0 /* No time stamp */
+#  define IOB_TSTAMP_SOFTWARE 1 /* Read from CLOCK_REALTIME by the stack */
+#  define IOB_TSTAMP_HARDWARE 2 /* Read from the PHC by the MAC */
 #endif
 
 /* IOB helpers */
@@ -91,6 +114,17 @@
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
 #define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
 
+/* True if the IOB references storage lent by its owner (see
+ * iob_tryalloc_with_data() and iob_ext_attach()).  Such data is never
+ * moved within its storage.
+ */
+
+#ifdef CONFIG_IOB_EXTERNAL
+#  define IOB_ISLENT(p)  ((p)->io_free != NULL)
+#else
+#  define IOB_ISLENT(p)  false
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
 
@@ -102,6 +136,40 @@
  * Public Types
  ****************************************************************************/
 
+/* The subsystems whose IOBs are charged to a pool of their own, see
+ * iob_pool_charge().
+ */
+
+#ifdef CONFIG_IOB_POOLS
+enum iob_pool_e
+{
+  IOB_POOL_NONE = 0,    /* Not charged to any pool */
+  IOB_POOL_TCP,         /* TCP read-ahead */
+  IOB_POOL_UDP,         /* UDP read-ahead */
+  IOB_POOL_CAN,         /* CAN read-ahead */
+  IOB_NPOOLS
+};
+#endif
+
+/* Called when an IOB that references lent storage is freed */
+
+#ifdef CONFIG_IOB_EXTERNAL
+typedef CODE void (*iob_free_cb_t)(FAR void *arg);
+
+/* Storage that its owner, e.g. a network driver with its own DMA buffers,
+ * lends to one or more IOBs with iob_ext_attach().  ie_free(ie_arg) is
+ * called when the last of them is freed.  The fields are private to the
+ * IOB module once iob_ext_init() was called.
+ */
+
+struct iob_ext_s
+{
+  iob_free_cb_t ie_free;
+  FAR void     *ie_arg;
+  int16_t       ie_refs;   /* The number of IOBs referencing the storage */
+};
+#endif
+
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
@@ -123,11 +191,42 @@ struct iob_s
   uint16_t io_offset;   /* Data begins at this offset */
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
+#ifdef CONFIG_IOB_POOLS
+  uint8_t  io_pool;     /* The pool charged for the IOB (iob_pool_e) */
+#endif
+
+#ifdef CONFIG_IOB_TIMESTAMP
+  /* Like io_pktlen, these are only valid for the head of the chain:  When
+   * the packet was received or sent, and for an outgoing packet whose
+   * transmission is to be time stamped, the key of the socket that waits
+   * for the time stamp (see netdev_txtstamp()), zero if none.
+   */
+
+  uint8_t  io_tstype;   /* The kind of io_tstamp, IOB_TSTAMP_* */
+  uint32_t io_tskey;    /* The socket waiting for the TX time stamp */
+  struct timespec io_tstamp;
+#endif
+
+#ifdef CONFIG_IOB_EXTERNAL
+  /* io_data normally points to io_buf.  An IOB returned by
+   * iob_tryalloc_with_data() or passed to iob_ext_attach() points it at
+   * the lent storage instead and calls io_free(io_freearg) when the IOB is
+   * freed.
+   */
+
+  FAR uint8_t  *io_data;
+  iob_free_cb_t io_free;
+  FAR void     *io_freearg;
+#endif
 
 #if CONFIG_IOB_HEADSIZE > 0
   uint8_t  io_head[CONFIG_IOB_HEADSIZE];
 #endif
+#ifdef CONFIG_IOB_EXTERNAL
+  uint8_t  io_buf[CONFIG_IOB_BUFSIZE] aligned_data(CONFIG_IOB_ALIGNMENT);
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE] aligned_data(CONFIG_IOB_ALIGNMENT);
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -216,6 +315,81 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc_with_data
+ *
+ * Description:
+ *   Try to allocate an I/O buffer that references len bytes of storage
+ *   owned by the caller instead of its own payload buffer.  The data is
+ *   neither copied nor modified; freecb(arg) is called when the IOB is
+ *   freed, after which the storage is no longer referenced.  The IOB has
+ *   neither head nor tail room, so it should not be the head of a packet.
+ *
+ * Input Parameters:
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *   data      - The lent storage
+ *   len       - Length of the data, at most CONFIG_IOB_BUFSIZE
+ *   freecb    - Called when the IOB is freed; must not be NULL
+ *   arg       - The argument passed to freecb
+ *
+ * Returned Value:
+ *   The IOB, or NULL if no IOB is free.  freecb is not called on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTERNAL
+FAR struct iob_s *iob_tryalloc_with_data(bool throttled,
+                                         FAR const void *data,
+                                         unsigned int len,
+                                         iob_free_cb_t freecb,
+                                         FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: iob_ext_init
+ *
+ * Description:
+ *   Prepare the descriptor of external storage before it is lent to IOBs.
+ *   It must not be initialized again while IOBs still reference the
+ *   storage.
+ *
+ * Input Parameters:
+ *   ext    - The descriptor of the storage
+ *   freecb - Called when the last IOB referencing the storage is freed;
+ *            must not be NULL.  It may be called from interrupt context.
+ *   arg    - The argument passed to freecb
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTERNAL
+void iob_ext_init(FAR struct iob_ext_s *ext, iob_free_cb_t freecb,
+                  FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: iob_ext_attach
+ *
+ * Description:
+ *   Make an empty I/O buffer use the CONFIG_IOB_BUFSIZE bytes at buf, part
+ *   of the external storage described by ext, as its payload buffer
+ *   instead of its own.  Unlike the storage lent with
+ *   iob_tryalloc_with_data(), this storage is writable and the IOB is used
+ *   like any other, e.g. as the head of a received packet with headroom
+ *   for the stack.  Several IOBs may reference the same storage, e.g. the
+ *   consecutive slices of a DMA buffer that holds a large frame.
+ *
+ * Input Parameters:
+ *   iob - A newly allocated IOB
+ *   ext - The descriptor of the storage, see iob_ext_init()
+ *   buf - The payload buffer, at least CONFIG_IOB_BUFSIZE bytes
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTERNAL
+void iob_ext_attach(FAR struct iob_s *iob, FAR struct iob_ext_s *ext,
+                    FAR uint8_t *buf);
+#endif
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -226,6 +400,42 @@ FAR struct iob_s *iob_tryalloc(bool throttled);
 
 int iob_navail(bool throttled);
 
+/****************************************************************************
+ * Name: iob_pool_charge
+ *
+ * Description:
+ *   Charge all of the IOBs of a chain to the pool of a subsystem, e.g.
+ *   when the chain is added to a read-ahead queue.  The charge is refused
+ *   if the pool would exceed its quota or if fewer free IOBs than the
+ *   throttle of the pool are left for the other users.  Each IOB is
+ *   uncharged when it is freed.
+ *
+ * Input Parameters:
+ *   pool - The pool to charge
+ *   iob  - The head of the I/O buffer chain
+ *
+ * Returned Value:
+ *   OK on success; -ENOBUFS if the charge was refused, in which case the
+ *   chain should be dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+int iob_pool_charge(enum iob_pool_e pool, FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: iob_pool_navail
+ *
+ * Description:
+ *   Return the number of IOBs that can still be charged to a pool.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+int iob_pool_navail(enum iob_pool_e pool);
+#endif
+
 /****************************************************************************
  * Name: iob_qentry_navail
  *
@@ -50,6 +50,22 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+/* The head of a lock-free free block list.  The tag is incremented by every
+ * successful update so that a compare-and-swap of the whole structure
+ * cannot succeed against a head that was popped and pushed back in the
+ * meantime (the ABA problem).
+ */
+
+struct mempool_lfhead_s
+{
+  /* The first free block, aligned for the double-word compare-and-swap */
+
+  FAR sq_entry_t *head aligned_data(2 * sizeof(uintptr_t));
+  uintptr_t       tag;   /* The modification count of the list */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -64,7 +80,11 @@ struct mempool_s
 
   /* Private data for memory pool */
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  struct mempool_lfhead_s list; /* Lock-free block list in normal mempool */
+#else
   sq_queue_t list;       /* The free block list in normal mempool */
+#endif
   sq_queue_t ilist;      /* The free block list in interrupt mempool */
   sq_queue_t elist;      /* The expand block list for normal mempool */
   size_t     nused;      /* The number of used block in mempool */
@@ -155,6 +175,45 @@ FAR void *mempool_alloc(FAR struct mempool_s *pool);
 
 void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
 
+/****************************************************************************
+ * Name: mempool_alloc_batch
+ *
+ * Description:
+ *   Allocate up to nblks blocks from a specific memory pool in one
+ *   operation.  The blocks are taken from the free list with a single lock
+ *   hold (or with one compare-and-swap per block in the lock-free mode).
+ *   If the free list runs short, the interrupt reserve is used from
+ *   interrupt context or the pool is expanded otherwise, but this function
+ *   never waits.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array that receives the allocated blocks.
+ *   nblks - The number of blocks requested.
+ *
+ * Returned Value:
+ *   The number of blocks stored in blks, which may be less than nblks.
+ *
+ ****************************************************************************/
+
+size_t mempool_alloc_batch(FAR struct mempool_s *pool, FAR void **blks,
+                           size_t nblks);
+
+/****************************************************************************
+ * Name: mempool_free_batch
+ *
+ * Description:
+ *   Release nblks memory blocks to the pool in one operation.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array of the blocks to release.
+ *   nblks - The number of blocks in blks.
+ ****************************************************************************/
+
+void mempool_free_batch(FAR struct mempool_s *pool, FAR void * const *blks,
+                        size_t nblks);
+
 /****************************************************************************
  * Name: mempool_info
  *
@@ -0,0 +1,203 @@
+//***************************************************************************
+// include/nuttx/mm/mempool_resource.hxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_RESOURCE_HXX
+#define __INCLUDE_NUTTX_MM_MEMPOOL_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <pthread.h>
+
+#if __has_include(<memory_resource>)
+#  include <memory_resource>
+#else
+#  include <experimental/memory_resource>
+#endif
+
+#include <nuttx/mm/mempool.h>
+
+#ifdef CONFIG_LIBXX_MEMPOOL_RESOURCE
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The blocks of the pools are powers of two from 16 bytes up to the
+// largest_required_pool_block of the options, at most 4 KiB.  Larger
+// blocks, and blocks aligned more strictly than a pointer, are taken from
+// the upstream resource.
+
+#define MEMPOOL_RESOURCE_MINSHIFT  4
+#define MEMPOOL_RESOURCE_NPOOLS    9
+
+//***************************************************************************
+// Namespace
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  // The interface of the resources is std::pmr, or std::experimental::pmr
+  // with the libcxx releases before 16, which lack std::pool_options
+
+#if __has_include(<memory_resource>)
+  using std::pmr::memory_resource;
+  using std::pmr::get_default_resource;
+  using std::pmr::pool_options;
+#else
+  using std::experimental::pmr::memory_resource;
+  using std::experimental::pmr::get_default_resource;
+
+  struct pool_options
+  {
+    std::size_t max_blocks_per_chunk = 0;
+    std::size_t largest_required_pool_block = 0;
+  };
+#endif
+
+  // A pool resource on the memory pools of mm/mempool.  The pools are
+  // expanded from the heap and never shrink; they are protected by their
+  // own spinlocks, not by the heap lock, so the resource may be shared by
+  // all threads.  All blocks must be returned before it is destroyed.
+
+  class mempool_resource : public memory_resource
+  {
+  public:
+    explicit mempool_resource(const pool_options &opts,
+                              FAR memory_resource *upstream =
+                                get_default_resource(),
+                              FAR const char *name = "pmr");
+
+    mempool_resource()
+      : mempool_resource(pool_options())
+    {
+    }
+
+    mempool_resource(const mempool_resource &) = delete;
+    mempool_resource &operator=(const mempool_resource &) = delete;
+
+    virtual ~mempool_resource();
+
+    FAR memory_resource *upstream_resource() const
+    {
+      return m_upstream;
+    }
+
+    pool_options options() const
+    {
+      return m_options;
+    }
+
+  protected:
+    FAR void *do_allocate(std::size_t bytes,
+                          std::size_t alignment) override;
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const memory_resource &other)
+      const noexcept override;
+
+  private:
+    friend class thread_pool_resource;
+
+    // Return the index of the pool of a block, or -1 if it is taken from
+    // upstream
+
+    int pool_index(std::size_t bytes, std::size_t alignment) const;
+
+    FAR memory_resource *m_upstream;
+    pool_options m_options;
+    struct mempool_s m_pools[MEMPOOL_RESOURCE_NPOOLS];
+    struct mempool_multiple_s m_mpool;
+  };
+
+  // A pool resource with a cache of free blocks per thread.  A thread
+  // allocates from and frees to its own cache without any lock; the caches
+  // are refilled from and drained to a shared mempool_resource in batches.
+  // A block may be freed by another thread than the one that allocated
+  // it.  Every resource uses a pthread key, the cache of a thread is
+  // drained when the thread exits or calls flush().
+
+  class thread_pool_resource : public memory_resource
+  {
+  public:
+    explicit thread_pool_resource(const pool_options &opts,
+                                  FAR memory_resource *upstream =
+                                    get_default_resource(),
+                                  FAR const char *name = "pmr");
+
+    thread_pool_resource()
+      : thread_pool_resource(pool_options())
+    {
+    }
+
+    thread_pool_resource(const thread_pool_resource &) = delete;
+    thread_pool_resource &operator=(const thread_pool_resource &) =
+      delete;
+
+    // The resource must only be destroyed after all other threads that
+    // used it have exited or called flush().
+
+    virtual ~thread_pool_resource();
+
+    // Return the blocks cached by the calling thread to the shared pools
+
+    void flush();
+
+    FAR memory_resource *upstream_resource() const
+    {
+      return m_shared.upstream_resource();
+    }
+
+    pool_options options() const
+    {
+      return m_shared.options();
+    }
+
+  protected:
+    FAR void *do_allocate(std::size_t bytes,
+                          std::size_t alignment) override;
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const memory_resource &other)
+      const noexcept override;
+
+  private:
+    struct cache_s;
+
+    FAR struct cache_s *get_cache();
+    void drain(FAR struct cache_s *cache, int index, std::size_t keep);
+    static void destroy_cache(FAR void *arg);
+
+    mempool_resource m_shared;
+    pthread_key_t m_key;
+    bool m_haskey;
+  };
+}
+}
+
+#endif // CONFIG_LIBXX_MEMPOOL_RESOURCE
+#endif // __INCLUDE_NUTTX_MM_MEMPOOL_RESOURCE_HXX
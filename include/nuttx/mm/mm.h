@@ -98,6 +98,19 @@
 
 struct mm_heap_s; /* Forward reference */
 
+/* The memory tiers of a heap, from the fastest to the slowest, e.g.
+ * tightly-coupled memory, internal SRAM and external DRAM.  Regions added
+ * without a tier are MM_TIER_NORMAL.
+ */
+
+enum mm_tier_e
+{
+  MM_TIER_FAST = 0,
+  MM_TIER_NORMAL,
+  MM_TIER_SLOW,
+  MM_NTIERS
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -156,6 +169,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
                                     FAR void *heap_start, size_t heap_size);
 void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize);
+#ifdef CONFIG_MM_HEAP_TIERS
+void mm_addregion_tier(FAR struct mm_heap_s *heap, FAR void *heapstart,
+                       size_t heapsize, int tier);
+#endif
 void mm_uninitialize(FAR struct mm_heap_s *heap);
 
 /* Functions contained in umm_initialize.c **********************************/
@@ -181,6 +198,10 @@ void kmm_addregion(FAR void *heapstart, size_t heapsize);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_malloc_tier(FAR struct mm_heap_s *heap, size_t size,
+                         int tier);
+#endif
 
 /* Functions contained in kmm_malloc.c **************************************/
 
@@ -232,6 +253,10 @@ FAR void *kmm_calloc(size_t n, size_t elem_size);
 /* Functions contained in mm_zalloc.c ***************************************/
 
 FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size);
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_zalloc_tier(FAR struct mm_heap_s *heap, size_t size,
+                         int tier);
+#endif
 
 /* Functions contained in kmm_zalloc.c **************************************/
 
@@ -249,6 +274,10 @@ void kmm_memdump(pid_t pid);
 
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                       size_t size);
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_memalign_tier(FAR struct mm_heap_s *heap, size_t alignment,
+                           size_t size, int tier);
+#endif
 
 /* Functions contained in kmm_memalign.c ************************************/
 
@@ -260,6 +289,11 @@ FAR void *kmm_memalign(size_t alignment, size_t size);
 
 bool mm_heapmember(FAR struct mm_heap_s *heap, FAR void *mem);
 
+/* Functions contained in mm_nextfree.c *************************************/
+
+int mm_nextfree(FAR struct mm_heap_s *heap, uintptr_t addr,
+                FAR uintptr_t *start, FAR uintptr_t *end);
+
 /* Functions contained in mm_uheapmember.c **********************************/
 
 bool umm_heapmember(FAR void *mem);
@@ -303,6 +337,10 @@ void kmm_extend(FAR void *mem, size_t size, int region);
 
 struct mallinfo; /* Forward reference */
 int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
+#ifdef CONFIG_MM_HEAP_TIERS
+int mm_mallinfo_tier(FAR struct mm_heap_s *heap, int tier,
+                     FAR struct mallinfo *info);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 struct mallinfo_task; /* Forward reference */
 int mm_mallinfo_task(FAR struct mm_heap_s *heap,
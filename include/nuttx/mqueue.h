@@ -109,6 +109,9 @@ struct mqueue_inode_s
   struct mqueue_cmn_s cmn;    /* Common prologue */
   FAR struct inode *inode;    /* Containing inode */
   struct list_node msglist;   /* Prioritized message list */
+#ifdef CONFIG_MQ_QUEUE_POOL
+  struct list_node msgpool;   /* Free messages of the per-queue pool */
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
 #if CONFIG_MQ_MAXMSGSIZE < 256
@@ -703,6 +706,108 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: file_mq_loan, file_mq_send_loan, file_mq_receive_ref, file_mq_return
+ *
+ * Description:
+ *   Internal OS versions of mq_loan(), mq_send_loan(), mq_receive_ref() and
+ *   mq_return().  They do not modify the errno value and return a negated
+ *   errno value on failure.  file_mq_loan() returns the buffer in *buffer.
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, FAR void **buffer);
+int file_mq_send_loan(FAR struct file *mq, FAR void *buffer, size_t msglen,
+                      unsigned int prio);
+ssize_t file_mq_receive_ref(FAR struct file *mq, FAR void **buffer,
+                            FAR unsigned int *prio);
+int file_mq_return(FAR struct file *mq, FAR void *buffer);
+
+/****************************************************************************
+ * Name: mq_loan
+ *
+ * Description:
+ *   Borrow a message buffer of mq_msgsize bytes from the message queue.
+ *   The buffer is owned by the caller until it is passed to
+ *   mq_send_loan() or given back with mq_return().
+ *
+ * Input Parameters:
+ *   mqdes - Message queue descriptor opened for writing
+ *
+ * Returned Value:
+ *   The buffer on success.  NULL on failure with errno set to EBADF, EPERM
+ *   or ENOMEM.
+ *
+ ****************************************************************************/
+
+FAR void *mq_loan(mqd_t mqdes);
+
+/****************************************************************************
+ * Name: mq_send_loan
+ *
+ * Description:
+ *   Queue a buffer obtained from mq_loan() without copying it.  The
+ *   ownership of the buffer passes to the message queue on success.  The
+ *   call blocks like mq_send() if the queue is full.  On failure, the
+ *   caller still owns the buffer.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor that loaned the buffer
+ *   buffer - The buffer returned by mq_loan()
+ *   msglen - The number of valid bytes in the buffer
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   0 on success.  -1 on failure with errno set as for mq_send().
+ *
+ ****************************************************************************/
+
+int mq_send_loan(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                 unsigned int prio);
+
+/****************************************************************************
+ * Name: mq_receive_ref
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the queue like
+ *   mq_receive(), but return a reference to the queued buffer instead of
+ *   copying it.  The caller owns the buffer and must give it back with
+ *   mq_return().
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor opened for reading
+ *   buffer - The location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority
+ *
+ * Returned Value:
+ *   The length of the message on success.  -1 on failure with errno set as
+ *   for mq_receive().
+ *
+ ****************************************************************************/
+
+ssize_t mq_receive_ref(mqd_t mqdes, FAR void **buffer,
+                       FAR unsigned int *prio);
+
+/****************************************************************************
+ * Name: mq_return
+ *
+ * Description:
+ *   Give back a buffer obtained from mq_loan() or mq_receive_ref().  All
+ *   buffers must be returned before the message queue is destroyed.
+ *
+ * Input Parameters:
+ *   mqdes  - The message queue descriptor that provided the buffer
+ *   buffer - The buffer
+ *
+ * Returned Value:
+ *   0 on success.  -1 on failure with errno set to EBADF or EINVAL.
+ *
+ ****************************************************************************/
+
+int mq_return(mqd_t mqdes, FAR void *buffer);
+#endif /* CONFIG_MQ_ZEROCOPY */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -56,6 +56,15 @@
  *   ioctl argument:  Pointer to a config_data_s structure to receive the
  *                    config data.  All fields of the structure must be
  *                    specified (i.e. id, instance, pointer and len).
+ *
+ * CFGDIOC_SETCONFIGS - Set or delete several Config Data items at once
+ *
+ *   ioctl argument:  Pointer to a config_batch_s structure.  The items are
+ *                    applied in order, those with a len of zero are
+ *                    deleted.  After a power loss either all items or none
+ *                    of them were changed.  Only the fail-safe
+ *                    configuration (CONFIG_MTD_CONFIG_FAIL_SAFE) supports
+ *                    it and then all items must fit in one erase block.
  */
 
 #define CFGDIOC_GETCONFIG    _CFGDIOC(1)
@@ -64,6 +73,7 @@
 #define CFGDIOC_FINDCONFIG   _CFGDIOC(4)
 #define CFGDIOC_FIRSTCONFIG  _CFGDIOC(5)
 #define CFGDIOC_NEXTCONFIG   _CFGDIOC(6)
+#define CFGDIOC_SETCONFIGS   _CFGDIOC(7)
 
 /****************************************************************************
  * Public Types
@@ -83,6 +93,14 @@ struct config_data_s
   size_t      len;          /* Length of the config data buffer */
 };
 
+/* This structure is used to set several config data items at once */
+
+struct config_batch_s
+{
+  FAR struct config_data_s *items;  /* The items to set or delete */
+  size_t      nitems;               /* The number of items */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
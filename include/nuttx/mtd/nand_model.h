@@ -59,6 +59,10 @@
 #define NANDMODEL_DATAWIDTH16 (1 << 0)  /* NAND uses a 16-bit databus */
 #define NANDMODEL_COPYBACK    (1 << 1)  /* NAND supports the copy-back function
                                          * (internal page-to-page copy) */
+#define NANDMODEL_CACHEREAD   (1 << 2)  /* NAND supports READ CACHE */
+#define NANDMODEL_CACHEPROG   (1 << 3)  /* NAND supports CACHE PROGRAM */
+#define NANDMODEL_MULTIPLANE  (1 << 4)  /* NAND supports multi-plane
+                                         * (interleaved) operations */
 
 /****************************************************************************
  * Public Types
@@ -369,6 +373,30 @@ unsigned int nandmodel_getsparesize(FAR const struct nand_model_s *model);
 
 #define nandmodel_havecopyback(m) (((m)->options & NANDMODEL_COPYBACK) != 0)
 
+/****************************************************************************
+ * Name: nandmodel_havecacheread, nandmodel_havecacheprog and
+ *       nandmodel_havemultiplane
+ *
+ * Description:
+ *   Returns true if the given NAND model supports the READ CACHE commands,
+ *   the CACHE PROGRAM command or multi-plane operations, respectively.
+ *
+ * Input Parameters:
+ *   model  Pointer to a nand_model_s instance.
+ *
+ * Returned Value:
+ *   Returns true if the device supports the operation. Otherwise returns
+ *   false.
+ *
+ ****************************************************************************/
+
+#define nandmodel_havecacheread(m) \
+  (((m)->options & NANDMODEL_CACHEREAD) != 0)
+#define nandmodel_havecacheprog(m) \
+  (((m)->options & NANDMODEL_CACHEPROG) != 0)
+#define nandmodel_havemultiplane(m) \
+  (((m)->options & NANDMODEL_MULTIPLANE) != 0)
+
 #undef EXTERN
 #ifdef __cplusplus
 }
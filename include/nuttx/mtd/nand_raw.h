@@ -56,6 +56,8 @@
 
 #define COMMAND_READ_1                  0x00
 #define COMMAND_READ_2                  0x30
+#define COMMAND_READ_CACHE_SEQ          0x31
+#define COMMAND_READ_CACHE_END          0x3f
 #define COMMAND_COPYBACK_READ_1         0x00
 #define COMMAND_COPYBACK_READ_2         0x35
 #define COMMAND_COPYBACK_PROGRAM_1      0x85
@@ -66,6 +68,8 @@
 #define COMMAND_READID                  0x90
 #define COMMAND_WRITE_1                 0x80
 #define COMMAND_WRITE_2                 0x10
+#define COMMAND_WRITE_MULTIPLANE        0x11
+#define COMMAND_WRITE_CACHE             0x15
 #define COMMAND_ERASE_1                 0x60
 #define COMMAND_ERASE_2                 0xd0
 #define COMMAND_STATUS                  0x70
@@ -226,6 +230,54 @@
 #  define NAND_WRITEPAGE(r,b,p,d,s) ((r)->rawwrite(r,b,p,d,s))
 #endif
 
+/****************************************************************************
+ * Name: NAND_READPAGES
+ *
+ * Description:
+ *   Reads the data areas of consecutive pages of a NAND FLASH into the
+ *   provided buffer.  The pages may span several blocks.  The lower half
+ *   may overlap the array reads with the transfers, e.g. by READ CACHE
+ *   SEQUENTIAL, or read the pages of several planes at once.  Hardware ECC
+ *   checking will be performed if so configured.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the first page to read resides.
+ *   page   - Number of the first page to read inside the given block.
+ *   npages - Number of pages to read.
+ *   data   - Buffer where the data areas will be stored.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#define NAND_READPAGES(r,b,p,n,d) ((r)->readpages(r,b,p,n,d))
+
+/****************************************************************************
+ * Name: NAND_WRITEPAGES
+ *
+ * Description:
+ *   Writes the data areas of consecutive pages of a NAND FLASH.  The pages
+ *   may span several blocks.  The lower half may load the next page while
+ *   the previous one is programmed, e.g. by CACHE PROGRAM, or program the
+ *   pages of several planes at once.  Hardware ECC will be computed if so
+ *   configured.
+ *
+ * Input Parameters:
+ *   raw    - Lower-half, raw NAND FLASH interface
+ *   block  - Number of the block where the first page to write resides.
+ *   page   - Number of the first page to write inside the given block.
+ *   npages - Number of pages to write.
+ *   data   - Buffer containing the data to be written.
+ *
+ * Returned Value:
+ *   OK is returned in success; a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#define NAND_WRITEPAGES(r,b,p,n,d) ((r)->writepages(r,b,p,n,d))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -262,6 +314,17 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+  /* Optional multi-page operations, NULL if not supported.  They are not
+   * used with software ECC.
+   */
+
+  CODE int (*readpages)(FAR struct nand_raw_s *raw, off_t block,
+                        unsigned int page, unsigned int npages,
+                        FAR void *data);
+  CODE int (*writepages)(FAR struct nand_raw_s *raw, off_t block,
+                         unsigned int page, unsigned int npages,
+                         FAR const void *data);
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers */
 
@@ -48,6 +48,21 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Features supported (bytes 6-7 of the parameter page) */
+
+#define ONFI_FEATURE_BUS16          (1 << 0) /* 16-bit data bus width */
+#define ONFI_FEATURE_MULTILUN       (1 << 1) /* Multiple LUN operations */
+#define ONFI_FEATURE_NONSEQPROG     (1 << 2) /* Non-sequential page program */
+#define ONFI_FEATURE_INTERLEAVED    (1 << 3) /* Multi-plane operations */
+
+/* Optional commands supported (bytes 8-9 of the parameter page) */
+
+#define ONFI_OPTCMD_CACHEPROG       (1 << 0) /* Page cache program */
+#define ONFI_OPTCMD_CACHEREAD       (1 << 1) /* Read cache commands */
+#define ONFI_OPTCMD_FEATURES        (1 << 2) /* Get/set features */
+#define ONFI_OPTCMD_STATUSENH       (1 << 3) /* Read status enhanced */
+#define ONFI_OPTCMD_COPYBACK        (1 << 4) /* Copyback */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -61,6 +76,9 @@ struct onfi_pgparam_s
   uint8_t luns;           /* Number of logical units */
   uint8_t eccsize;        /* Number of bits of ECC correction */
   uint8_t model;          /* Device model */
+  uint8_t planebits;      /* Number of plane address bits */
+  uint16_t features;      /* See ONFI_FEATURE_* definitions */
+  uint16_t optcmds;       /* See ONFI_OPTCMD_* definitions */
   uint16_t sparesize;     /* Number of spare bytes per page */
   uint16_t pagesperblock; /* Number of pages per block */
   uint16_t blocksperlun;  /* Number of blocks per logical unit (LUN) */
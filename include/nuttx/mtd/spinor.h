@@ -0,0 +1,179 @@
+/****************************************************************************
+ * include/nuttx/mtd/spinor.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MTD_SPINOR_H
+#define __INCLUDE_NUTTX_MTD_SPINOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_MTD_SPINOR_ASYNC
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Device access callouts.  These are provided by the SPI NOR driver and
+ * are called from the low priority work queue.
+ */
+
+struct spinor_async_ops_s
+{
+  /* Lock (true) or unlock (false) the SPI bus, configuring it for the
+   * device when it is locked.
+   */
+
+  CODE void (*lock)(FAR void *arg, bool lock);
+
+  /* Return true while a program or erase operation is in progress.  Called
+   * with the bus locked.
+   */
+
+  CODE bool (*busy)(FAR void *arg);
+
+  /* Enable writing and start programming nbytes at address.  The range
+   * never crosses a page boundary.  This must not wait for the operation
+   * to complete.  Called with the bus locked.
+   */
+
+  CODE void (*program)(FAR void *arg, FAR const uint8_t *buffer,
+                       off_t address, size_t nbytes);
+};
+
+/* The state of the page program pipeline.  An instance is embedded in the
+ * state structure of the driver:
+ *
+ *   struct foo_dev_s
+ *   {
+ *     ...
+ *     struct spinor_async_s async;
+ *   };
+ *
+ * The driver calls spinor_async_write() instead of programming the pages
+ * itself and must call spinor_async_wait() before it locks the bus for
+ * any other operation on the device.
+ */
+
+struct spinor_async_s
+{
+  FAR const struct spinor_async_ops_s *ops;
+  FAR void     *arg;                /* Argument of the callouts */
+  size_t        pagesize;           /* Program page size (a power of 2) */
+  size_t        bufsize;            /* Size of buffer */
+  FAR uint8_t  *buffer;             /* Data waiting to be programmed */
+  size_t        pos;                /* Next byte of buffer to program */
+  size_t        len;                /* Number of valid bytes in buffer */
+  off_t         address;            /* FLASH address of buffer[pos] */
+  volatile bool active;             /* true: the pipeline is running */
+  mutex_t       lock;               /* Serializes the users */
+  sem_t         donesem;            /* Posted when the pipeline stops */
+  struct work_s work;               /* Program/poll work */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: spinor_async_initialize
+ *
+ * Description:
+ *   Initialize the page program pipeline of one device.
+ *
+ * Input Parameters:
+ *   as       - The pipeline state
+ *   ops      - The device access callouts
+ *   arg      - The argument passed to the callouts
+ *   pagesize - The program page size of the device
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spinor_async_initialize(FAR struct spinor_async_s *as,
+                            FAR const struct spinor_async_ops_s *ops,
+                            FAR void *arg, size_t pagesize);
+
+/****************************************************************************
+ * Name: spinor_async_uninitialize
+ *
+ * Description:
+ *   Wait for pending writes and release the pipeline resources.
+ *
+ ****************************************************************************/
+
+void spinor_async_uninitialize(FAR struct spinor_async_s *as);
+
+/****************************************************************************
+ * Name: spinor_async_write
+ *
+ * Description:
+ *   Queue data to be programmed.  The data is copied, so the caller may
+ *   reuse its buffer as soon as this returns.  Only the tail of a write
+ *   larger than CONFIG_MTD_SPINOR_ASYNC_BUFSIZE is still being programmed
+ *   on return.  The bus must not be locked by the caller.
+ *
+ * Returned Value:
+ *   The number of bytes queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t spinor_async_write(FAR struct spinor_async_s *as,
+                           FAR const uint8_t *buffer, off_t address,
+                           size_t nbytes);
+
+/****************************************************************************
+ * Name: spinor_async_wait
+ *
+ * Description:
+ *   Wait until all queued data has been programmed and the device is idle.
+ *   The bus must not be locked by the caller.
+ *
+ ****************************************************************************/
+
+void spinor_async_wait(FAR struct spinor_async_s *as);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MTD_SPINOR_ASYNC */
+#endif /* __INCLUDE_NUTTX_MTD_SPINOR_H */
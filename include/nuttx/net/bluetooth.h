@@ -40,6 +40,10 @@
  * header) + 4 (ACL header) + 1 (H4 header) = 74. This also covers the
  * biggest HCI commands and events which are a bit under the 70 byte
  * mark.
+ *
+ * CONFIG_BLUETOOTH_MAX_MTU raises the limit so that an ATT PDU fills the
+ * 251 byte packets of the LE Data Packet Length Extension; each frame
+ * must still fit into one IOB.
  */
 
 #define BLUETOOTH_L2CAP_HDRLEN  4  /* Size of L2CAP header */
@@ -50,7 +54,11 @@
   (BLUETOOTH_L2CAP_HDRLEN + BLUETOOTH_ACL_HDRLEN + BLUETOOTH_H4_HDRLEN)
 
 #define BLUETOOTH_SMP_MTU       65
-#define BLUETOOTH_MAX_MTU       70
+#ifdef CONFIG_BLUETOOTH_MAX_MTU
+#  define BLUETOOTH_MAX_MTU     CONFIG_BLUETOOTH_MAX_MTU
+#else
+#  define BLUETOOTH_MAX_MTU     70
+#endif
 
 #define BLUETOOTH_MAX_FRAMELEN  (BLUETOOTH_MAX_MTU + BLUETOOTH_MAX_HDRLEN)
 
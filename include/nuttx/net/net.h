@@ -34,6 +34,7 @@
 #include <stdarg.h>
 #include <semaphore.h>
 
+#include <nuttx/mutex.h>
 #include <nuttx/queue.h>
 #ifdef CONFIG_MM_IOB
 #  include <nuttx/mm/iob.h>
@@ -116,7 +117,7 @@ enum net_lltype_e
 
 /* This defines a bitmap big enough for one bit for each socket option */
 
-typedef uint16_t sockopt_t;
+typedef uint32_t sockopt_t;
 
 /* This defines the storage size of a timeout value.  This effects only
  * range of supported timeout values.  With an LSB in seciseconds, the
@@ -222,6 +223,12 @@ struct socket_conn_s
 #endif
 #endif
 
+  /* Protects the connection state that is shared between the socket
+   * interface and the event handlers.  See conn_lock().
+   */
+
+  rmutex_t      s_lock;
+
   /* Connection-specific content may follow */
 };
 
@@ -308,6 +315,8 @@ ssize_t net_ioctl_arglen(int cmd);
  *
  *   net_lock()        - Locks the network via a re-entrant mutex.
  *   net_unlock()      - Unlocks the network.
+ *   netdev_lock()     - Locks the packet buffer state of one device.
+ *   conn_lock()       - Locks the queues of one connection.
  *   net_lockedwait()  - Like pthread_cond_wait() except releases the
  *                       network momentarily to wait on another semaphore.
  *   net_ioballoc()    - Like iob_alloc() except releases the network
@@ -368,6 +377,86 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: netdev_lock
+ *
+ * Description:
+ *   Take the lock of a network device.  The device lock serializes the use
+ *   of the device's packet buffer (d_buf, d_iob, d_len, ...) by the input
+ *   and poll paths of that device, and only of that device.
+ *
+ *   The network is being moved from the single net_lock() to finer grained
+ *   locks; until that is complete net_lock() is still held around all
+ *   network processing.  When more than one lock is needed they must be
+ *   taken in this order:  net_lock(), netdev_lock(), conn_lock().  A lock
+ *   taken later in this order must be released before waiting with
+ *   net_lockedwait() and friends, which release only net_lock().
+ *
+ * Input Parameters:
+ *   dev - The device to be locked
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+struct net_driver_s;  /* Forward reference */
+
+int netdev_lock(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: netdev_unlock
+ *
+ * Description:
+ *   Release the lock of a network device.
+ *
+ * Input Parameters:
+ *   dev - The device to be unlocked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_unlock(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of a connection.  The connection lock protects the state
+ *   that is shared between the socket interface and the event handlers of
+ *   one connection, such as its write queues.  See netdev_lock() for the
+ *   lock ordering rules.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be locked
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int conn_lock(FAR struct socket_conn_s *sconn);
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of a connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be unlocked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn);
+
 /****************************************************************************
  * Name: net_timedwait
  *
@@ -867,6 +956,65 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends up to 'vlen' messages to a socket with the
+ *   network locked once for the whole batch.  This is an internal OS
+ *   interface.  It is functionally equivalent to sendmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of entries in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  If no message could
+ *   be sent, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to 'vlen' messages from a socket with the
+ *   network locked once for the whole batch.  This is an internal OS
+ *   interface.  It is functionally equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to receive
+ *   vlen      The number of entries in msgvec
+ *   flags     Receive flags
+ *   timeout   If not NULL, the time after which no more message is waited
+ *             for
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  If no message
+ *   could be received, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
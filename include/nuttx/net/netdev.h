@@ -51,6 +51,7 @@
 #include <nuttx/config.h>
 
 #include <sys/ioctl.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/queue.h>
@@ -157,6 +158,30 @@
 #  define NETDEV_ERRORS(dev)
 #endif
 
+/* Checksum offload.  The d_features bits are set by the driver before it
+ * registers the device and describe what its hardware can do.  The
+ * d_csumflags bits describe the packet currently in the device buffer:
+ *
+ *   NETDEV_CSUM_VERIFIED - Set (or cleared) by the driver for each
+ *     received frame when the hardware has validated the TCP/UDP checksum.
+ *   NETDEV_CSUM_NEEDED   - Set by the stack when it left the TCP/UDP
+ *     checksum of an outgoing packet zero for the hardware to insert.
+ */
+
+#define NETDEV_FEATURE_RXCSUM  (1 << 0) /* Hardware verifies TCP/UDP csum */
+#define NETDEV_FEATURE_TXCSUM  (1 << 1) /* Hardware inserts TCP/UDP csum */
+#define NETDEV_FEATURE_GRO     (1 << 2) /* Driver calls netdev_gro_flush() */
+
+#define NETDEV_CSUM_VERIFIED   (1 << 0) /* RX: TCP/UDP checksum is good */
+#define NETDEV_CSUM_NEEDED     (1 << 1) /* TX: hardware must insert csum */
+
+/* Verdicts of an early receive filter.  See struct netdev_rxfilter_s */
+
+#define NETDEV_RX_PASS         0        /* Process the frame normally */
+#define NETDEV_RX_DROP         1        /* Drop the frame */
+#define NETDEV_RX_PKT          2        /* Only deliver to packet sockets */
+#define NETDEV_RX_REDIRECT     3        /* Transmit it on another device */
+
 /* There are some helper pointers for accessing the contents of the IP
  * headers
  */
@@ -269,6 +294,9 @@ struct net_driver_s
 #endif
 
   uint16_t d_pktsize;           /* Maximum packet size */
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  uint8_t d_features;           /* See NETDEV_FEATURE_* definitions */
+#endif
 
   /* Link layer address */
 
@@ -376,6 +404,32 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* Checksum state of the packet in d_buf.  See NETDEV_CSUM_* */
+
+  uint8_t d_csumflags;
+#endif
+
+#ifdef CONFIG_NET_TCP_GRO
+  /* Received IPv4 packets held until netdev_gro_flush().  Bit n of
+   * d_gro_merge is set if d_gro[n] is a TCP segment that later segments
+   * may be appended to; bit n of d_gro_verified if its checksum is known
+   * to be good.
+   */
+
+  FAR struct iob_s *d_gro[CONFIG_NET_TCP_GRO_NPACKETS];
+  uint32_t d_gro_merge;
+  uint32_t d_gro_verified;
+  uint8_t d_gro_count;          /* Number of held packets */
+  bool d_gro_flushing;          /* netdev_gro_flush() is running */
+#endif
+
+#ifdef CONFIG_NETDEV_RXFILTER
+  /* Early receive filters.  See netdev_rxfilter_add() */
+
+  FAR struct netdev_rxfilter_s *d_rxfilter;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -418,6 +472,12 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb_tail; /* This is the list tail */
   FAR struct devif_callback_s *d_devcb;
 
+  /* Serializes the input and poll paths of this device.  It is initialized
+   * by netdev_register().  See netdev_lock().
+   */
+
+  rmutex_t d_lock;
+
   /* Driver callbacks */
 
   int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -431,6 +491,14 @@ struct net_driver_s
   int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd,
                  unsigned long arg);
 #endif
+#ifdef CONFIG_NETDEV_RXFILTER
+  /* Optional:  Transmit a whole frame, link layer header included, held in
+   * an IOB chain.  The driver owns the chain from then on.  Only devices
+   * that provide this can be the target of NETDEV_RX_REDIRECT.
+   */
+
+  int (*d_xmit)(FAR struct net_driver_s *dev, FAR struct iob_s *iob);
+#endif
 
   /* Drivers may attached device-specific, private information */
 
@@ -439,6 +507,26 @@ struct net_driver_s
 
 typedef CODE int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NETDEV_RXFILTER
+/* An early receive filter.  classify() is called for each frame received
+ * by the device, before the network stack processes it, with the frame in
+ * frame[0..len), link layer header included.  Of a frame held in an IOB
+ * chain, only the part in the first IOB is passed.  classify() returns one
+ * of the NETDEV_RX_* verdicts; it may change 'redirect' before it returns
+ * NETDEV_RX_REDIRECT.
+ */
+
+struct netdev_rxfilter_s
+{
+  FAR struct netdev_rxfilter_s *flink;
+  CODE int (*classify)(FAR struct netdev_rxfilter_s *filter,
+                       FAR struct net_driver_s *dev,
+                       FAR const uint8_t *frame, unsigned int len);
+  FAR struct net_driver_s *redirect; /* Target of NETDEV_RX_REDIRECT */
+  FAR void *priv;                    /* For use by the classifier */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -647,11 +735,15 @@ int netdev_carrier_off(FAR struct net_driver_s *dev);
  *   Calculate the raw change sum over the memory region described by
  *   data and len.
  *
+ *   If CONFIG_NET_ARCH_CHKSUM or CONFIG_NET_ARCH_CHKSUM_CORE is defined,
+ *   then this function must be provided by architecture-specific logic.
+ *
  * Input Parameters:
  *   sum  - Partial calculations carried over from a previous call to
  *          chksum().  This should be zero on the first time that check
  *          sum is called.
- *   data - Beginning of the data to include in the checksum.
+ *   data - Beginning of the data to include in the checksum.  There is no
+ *          alignment requirement.
  *   len  - Length of the data to include in the checksum.
  *
  * Returned Value:
@@ -856,6 +948,51 @@ void net_incr32(FAR uint8_t *op32, uint16_t op16);
 #  define netdev_ipv6_hdrlen(dev) dev->d_llhdrlen
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: netdev_rxcsum_verified
+ *
+ * Description:
+ *   True if the TCP/UDP checksum of the received packet in the device
+ *   buffer has already been validated by the hardware.
+ *
+ * Input Parameters:
+ *   dev Device structure pointer
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+#  define netdev_rxcsum_verified(dev) \
+     (((dev)->d_features & NETDEV_FEATURE_RXCSUM) != 0 && \
+      ((dev)->d_csumflags & NETDEV_CSUM_VERIFIED) != 0)
+#else
+#  define netdev_rxcsum_verified(dev) false
+#endif
+
+/****************************************************************************
+ * Name: netdev_txcsum_offload
+ *
+ * Description:
+ *   Decide whether the TCP/UDP checksum of the outgoing packet in the
+ *   device buffer is left to the hardware.  If so, the packet is marked
+ *   with NETDEV_CSUM_NEEDED and the caller must leave the checksum field
+ *   zero.
+ *
+ * Input Parameters:
+ *   dev Device structure pointer
+ *
+ * Returned Value:
+ *   True if the hardware will insert the checksum.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+#  define netdev_txcsum_offload(dev) \
+     (((dev)->d_features & NETDEV_FEATURE_TXCSUM) != 0 ? \
+      ((dev)->d_csumflags |= NETDEV_CSUM_NEEDED, true) : false)
+#else
+#  define netdev_txcsum_offload(dev) false
+#endif
+
 /****************************************************************************
  * Name: netdev_lladdrsize
  *
@@ -936,4 +1073,140 @@ void netdev_iob_clear(FAR struct net_driver_s *dev);
 
 void netdev_iob_release(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Process the IPv4 packets held for TCP receive aggregation.  A driver
+ *   that sets NETDEV_FEATURE_GRO must call this after each batch of
+ *   received packets, and at least every CONFIG_NET_TCP_GRO_NPACKETS
+ *   packets.  As with devif_poll(), the callback is invoked for each
+ *   reply, with the reply in d_buf and its length in d_len.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GRO
+int netdev_gro_flush(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback);
+#else
+#  define netdev_gro_flush(dev, callback) (OK)
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxfilter_add
+ *
+ * Description:
+ *   Add an early receive filter to a device.  The filters of a device are
+ *   run in the order in which they were added, until one of them returns
+ *   another verdict than NETDEV_RX_PASS.
+ *
+ * Input Parameters:
+ *   dev    - The device
+ *   filter - The filter, which must stay valid until it is removed
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXFILTER
+int netdev_rxfilter_add(FAR struct net_driver_s *dev,
+                        FAR struct netdev_rxfilter_s *filter);
+
+/****************************************************************************
+ * Name: netdev_rxfilter_remove
+ *
+ * Description:
+ *   Remove a receive filter added with netdev_rxfilter_add().
+ *
+ ****************************************************************************/
+
+int netdev_rxfilter_remove(FAR struct net_driver_s *dev,
+                           FAR struct netdev_rxfilter_s *filter);
+
+/****************************************************************************
+ * Name: netdev_rxfilter
+ *
+ * Description:
+ *   Run the receive filters of a device on the frame just received, in
+ *   d_buf (flat buffer drivers) or d_iob, with its length in d_len.
+ *   Drivers call this once per frame before passing it to pkt_input(),
+ *   ipv4_input(), etc.  Flat buffer drivers call it before any IOB is
+ *   allocated for the frame, so that dropping it costs no copy.
+ *
+ * Returned Value:
+ *   false if the frame must be processed normally.  true if it has been
+ *   consumed:  dropped, delivered to the packet sockets only or
+ *   redirected.  d_len is then zero and d_iob, if any, released.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool netdev_rxfilter(FAR struct net_driver_s *dev);
+#else
+#  define netdev_rxfilter(dev) (false)
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxtstamp
+ *
+ * Description:
+ *   Attach the time at which a frame was received, as read by the MAC from
+ *   its PTP hardware clock, to the head IOB of the frame.  The driver does
+ *   this before passing the frame to the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+#  define netdev_rxtstamp(iob, ts) \
+  do \
+    { \
+      (iob)->io_tstamp = *(ts); \
+      (iob)->io_tstype = IOB_TSTAMP_HARDWARE; \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Name: netdev_txtstamp_wanted
+ *
+ * Description:
+ *   True if the transmission of the frame of the head IOB is to be time
+ *   stamped, i.e. if the driver must report it with netdev_txtstamp().
+ *
+ ****************************************************************************/
+
+#  define netdev_txtstamp_wanted(iob) ((iob)->io_tskey != 0)
+
+/****************************************************************************
+ * Name: netdev_txtstamp
+ *
+ * Description:
+ *   Report when a frame left the MAC, as read from its PTP hardware clock.
+ *   The time stamp is queued on the error queue of the socket that sent
+ *   the frame.  Drivers call this on the completion of the frames for
+ *   which netdev_txtstamp_wanted() is true, before freeing them.
+ *
+ * Input Parameters:
+ *   dev - The device that sent the frame
+ *   iob - The head IOB of the frame
+ *   ts  - The time of the transmission
+ *
+ * Assumptions:
+ *   Called from the work queue or a thread, not from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void netdev_txtstamp(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                     FAR const struct timespec *ts);
+#else
+#  define netdev_rxtstamp(iob, ts)
+#  define netdev_txtstamp_wanted(iob) (false)
+#  define netdev_txtstamp(dev, iob, ts)
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
@@ -0,0 +1,494 @@
+/****************************************************************************
+ * include/nuttx/net/netdev_lowerhalf.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_NETDEV_LOWERHALF_H
+#define __INCLUDE_NUTTX_NET_NETDEV_LOWERHALF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NETDEV_LOWERHALF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest amount of contiguous data in one buffer of a packet */
+
+#define NETPKT_BUFLEN   CONFIG_IOB_BUFSIZE
+
+/* The room in front of the L2 header of a received frame that the stack
+ * needs; see netpkt_alloc_ext().
+ */
+
+#define NETPKT_HEADROOM(dev) \
+  (CONFIG_NET_LL_GUARDSIZE - NET_LL_HDRLEN(&(dev)->netdev))
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* The size of the Toeplitz key of receive side scaling (RSS), enough for
+ * the IPv6 addresses and ports, and of its indirection table.
+ */
+
+#  define NETDEV_RSS_KEYLEN    40
+#  define NETDEV_RSS_TABLESIZE CONFIG_NETDEV_RSS_TABLESIZE
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A packet exchanged between the network stack and a lower-half driver is
+ * an IOB chain.  From the driver's point of view the data of the chain is
+ * the complete link layer frame, starting with the L2 header.  A frame may
+ * span several IOBs; netpkt_to_iov() translates the chain into a
+ * scatter-gather list suitable for DMA descriptors.
+ */
+
+typedef struct iob_s netpkt_t;
+
+enum netpkt_type_e
+{
+  NETPKT_TX,
+  NETPKT_RX,
+  NETPKT_TYPENUM
+};
+
+struct netdev_ops_s;
+
+/* This structure is embedded in the private data of a lower-half driver.
+ * The driver initializes ops, quota[] and the MAC address in netdev before
+ * calling netdev_lower_register().
+ */
+
+struct netdev_lowerhalf_s
+{
+  FAR const struct netdev_ops_s *ops;
+
+  /* The maximum number of packets of each type that the driver may hold at
+   * a time.  Transmission stops while the TX quota is exhausted and is
+   * resumed by netdev_lower_txdone().
+   */
+
+  int quota[NETPKT_TYPENUM];
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The number of RX queues of the device.  With 0 or 1, the frames are
+   * collected with ops->receive() from the work queue.  With more, each
+   * queue is drained with ops->receiveq() by a thread of its own; see
+   * netdev_lower_rxqueue_affinity().
+   *
+   * The RSS key and indirection table that the driver programs into the
+   * hardware.  If the key is all zero when the driver is registered, the
+   * common default key and a table spreading the flows over all queues
+   * are filled in.
+   */
+
+  uint8_t rxqueues;
+  uint8_t rss_key[NETDEV_RSS_KEYLEN];
+  uint8_t rss_table[NETDEV_RSS_TABLESIZE];
+#endif
+
+  /* The structure used by the network stack.  d_buf is never used. */
+
+  struct net_driver_s netdev;
+
+  /* Private data of the upper half; not to be touched by the driver */
+
+  FAR void *upper;
+};
+
+/* The operations that a lower-half driver provides.  All of them are
+ * called with the network locked, never from interrupt context.
+ */
+
+struct netdev_ops_s
+{
+  /* Bring the interface up or down */
+
+  CODE int (*ifup)(FAR struct netdev_lowerhalf_s *dev);
+  CODE int (*ifdown)(FAR struct netdev_lowerhalf_s *dev);
+
+  /* Queue a frame for transmission.  On success the driver owns pkt and
+   * releases it with netpkt_free() once the hardware is done with it.  On
+   * failure the upper half frees the packet.
+   */
+
+  CODE int (*transmit)(FAR struct netdev_lowerhalf_s *dev,
+                       FAR netpkt_t *pkt);
+
+  /* Return the next received frame, or NULL if there is none.  The frame
+   * is normally allocated with netpkt_alloc(dev, NETPKT_RX).
+   */
+
+  CODE FAR netpkt_t *(*receive)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Return the next frame received on an RX queue, or NULL if there is
+   * none.  This is called without the network lock, and only from the
+   * thread of the queue, so the queues are drained in parallel.
+   */
+
+  CODE FAR netpkt_t *(*receiveq)(FAR struct netdev_lowerhalf_s *dev,
+                                 int queue);
+#endif
+
+#ifdef CONFIG_NET_MCASTGROUP
+  CODE int (*addmac)(FAR struct netdev_lowerhalf_s *dev,
+                     FAR const uint8_t *mac);
+  CODE int (*rmmac)(FAR struct netdev_lowerhalf_s *dev,
+                    FAR const uint8_t *mac);
+#endif
+#ifdef CONFIG_NETDEV_IOCTL
+  CODE int (*ioctl)(FAR struct netdev_lowerhalf_s *dev, int cmd,
+                    unsigned long arg);
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_register
+ *
+ * Description:
+ *   Register a lower-half network driver with the network stack.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   lltype - Link level protocol used by the driver (Ethernet, TUN, ...)
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure
+ *
+ ****************************************************************************/
+
+int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
+                          enum net_lltype_e lltype);
+
+/****************************************************************************
+ * Name: netdev_lower_unregister
+ *
+ * Description:
+ *   Unregister a lower-half network driver.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure
+ *
+ ****************************************************************************/
+
+int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Name: netdev_lower_carrier_on / netdev_lower_carrier_off
+ *
+ * Description:
+ *   Notify the network stack of a change of the link state.
+ *
+ ****************************************************************************/
+
+void netdev_lower_carrier_on(FAR struct netdev_lowerhalf_s *dev);
+void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Name: netdev_lower_rxready
+ *
+ * Description:
+ *   Notify the upper half that received frames are available.  The frames
+ *   are collected with ops->receive() from the work queue.  May be called
+ *   from interrupt context.
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Name: netdev_lower_rxqueue_ready
+ *
+ * Description:
+ *   Notify the upper half that frames were received on an RX queue of a
+ *   multi-queue device.  May be called from interrupt context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxqueue_ready(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_rxqueue_affinity
+ *
+ * Description:
+ *   Bind the thread that processes an RX queue to a set of CPUs.  By
+ *   default queue N is processed on CPU N modulo the number of CPUs; the
+ *   interrupt of the queue should be routed to the same CPU.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   queue  - The RX queue
+ *   cpuset - The CPUs that may process the queue
+ *
+ * Returned Value:
+ *   0:Success; negated errno on failure
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_MULTIQUEUE) && defined(CONFIG_SMP)
+int netdev_lower_rxqueue_affinity(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue, FAR const cpu_set_t *cpuset);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_txdone
+ *
+ * Description:
+ *   Notify the upper half that transmission completed and that more frames
+ *   may be queued.  May be called from interrupt context.
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
+
+/****************************************************************************
+ * Name: netpkt_alloc
+ *
+ * Description:
+ *   Allocate an empty packet.  There is room in front of the data for the
+ *   stack to strip the link layer header without moving the data.  This
+ *   never waits and may be called from interrupt context.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   type - Whether the packet will be used for RX or TX
+ *
+ * Returned Value:
+ *   The packet, or NULL if there is no buffer or the quota is exhausted.
+ *
+ ****************************************************************************/
+
+FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
+                           enum netpkt_type_e type);
+
+/****************************************************************************
+ * Name: netpkt_alloc_ext
+ *
+ * Description:
+ *   Wrap a frame that the hardware received into a DMA buffer of the
+ *   driver, instead of copying it into IOBs.  The hardware must have
+ *   written the frame NETPKT_HEADROOM(dev) bytes into the buffer.  Each
+ *   NETPKT_BUFLEN bytes of the buffer become one IOB of the packet, so the
+ *   buffer is lent to the stack as a whole and given back with
+ *   ext->ie_free(ext->ie_arg) when the stack has freed the last of them.
+ *   The RX quota is taken as by netpkt_alloc().  This never waits and may
+ *   be called from interrupt context.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   ext  - The descriptor of the buffer, see iob_ext_init()
+ *   buf  - The buffer; the stack may write to all of it
+ *   size - The size of the buffer
+ *   len  - The length of the frame, including the L2 header
+ *
+ * Returned Value:
+ *   The packet, or NULL if there are not enough IOBs or the quota is
+ *   exhausted.  The buffer still belongs to the driver on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTERNAL
+FAR netpkt_t *netpkt_alloc_ext(FAR struct netdev_lowerhalf_s *dev,
+                               FAR struct iob_ext_s *ext,
+                               FAR uint8_t *buf, size_t size,
+                               unsigned int len);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_free
+ *
+ * Description:
+ *   Release a packet and give its quota back.  May be called from
+ *   interrupt context.
+ *
+ ****************************************************************************/
+
+void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                 enum netpkt_type_e type);
+
+/****************************************************************************
+ * Name: netpkt_copyin / netpkt_copyout
+ *
+ * Description:
+ *   Copy frame data into or out of a packet, extending the chain as
+ *   needed.  offset is relative to the start of the L2 header.
+ *
+ * Returned Value:
+ *   The number of bytes copied; a negated errno on failure.
+ *
+ ****************************************************************************/
+
+int netpkt_copyin(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                  FAR const uint8_t *src, unsigned int len, int offset);
+int netpkt_copyout(FAR struct netdev_lowerhalf_s *dev, FAR uint8_t *dest,
+                   FAR const netpkt_t *pkt, unsigned int len, int offset);
+
+/****************************************************************************
+ * Name: netpkt_getdata
+ *
+ * Description:
+ *   Return the address of the first byte of the frame.  Only the first
+ *   netpkt_getdatalen() bytes (at most NETPKT_BUFLEN minus the headroom)
+ *   are contiguous; see netpkt_is_fragmented().
+ *
+ ****************************************************************************/
+
+FAR uint8_t *netpkt_getdata(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt);
+
+/****************************************************************************
+ * Name: netpkt_getdatalen / netpkt_setdatalen
+ *
+ * Description:
+ *   Get or set the length of the frame, including the L2 header.
+ *   netpkt_setdatalen() is called after the hardware wrote the frame
+ *   directly to the memory given by netpkt_getdata() or netpkt_to_iov().
+ *
+ ****************************************************************************/
+
+unsigned int netpkt_getdatalen(FAR struct netdev_lowerhalf_s *dev,
+                               FAR netpkt_t *pkt);
+void netpkt_setdatalen(FAR struct netdev_lowerhalf_s *dev,
+                       FAR netpkt_t *pkt, unsigned int len);
+
+/****************************************************************************
+ * Name: netpkt_is_fragmented
+ *
+ * Description:
+ *   Return true if the frame spans more than one buffer.
+ *
+ ****************************************************************************/
+
+bool netpkt_is_fragmented(FAR netpkt_t *pkt);
+
+/****************************************************************************
+ * Name: netpkt_to_iov
+ *
+ * Description:
+ *   Describe the buffers of a frame with an array of iovecs so that they
+ *   can be handed to a scatter-gather DMA engine without copying.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The packet
+ *   iov    - The array to fill
+ *   iovcnt - The number of entries in iov
+ *
+ * Returned Value:
+ *   The number of entries used; -E2BIG if iov is too small.
+ *
+ ****************************************************************************/
+
+int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                  FAR struct iovec *iov, int iovcnt);
+
+/****************************************************************************
+ * Name: netdev_lower_rss_init
+ *
+ * Description:
+ *   Fill in the default RSS key and an indirection table spreading the
+ *   flows over all of the RX queues, unless the driver set a key.  This is
+ *   done by netdev_lower_register().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rss_init(FAR struct netdev_lowerhalf_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: netdev_rss_hash
+ *
+ * Description:
+ *   Compute the Toeplitz hash of receive side scaling (RSS).
+ *
+ * Input Parameters:
+ *   key  - The RSS key, at least len + 4 bytes
+ *   data - The input: the source and destination addresses followed by the
+ *          source and destination ports, in network order
+ *   len  - The length of the input
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+uint32_t netdev_rss_hash(FAR const uint8_t *key, FAR const uint8_t *data,
+                         unsigned int len);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_rss_hash / netpkt_rss_queue
+ *
+ * Description:
+ *   Compute the RSS hash of a received frame with the key of the device,
+ *   as the hardware does: over the addresses and the TCP or UDP ports of
+ *   IPv4 and IPv6 frames, over the addresses only for other protocols and
+ *   fragments.  Zero is returned for frames that are not IP.
+ *
+ *   netpkt_rss_queue() returns the RX queue that the indirection table of
+ *   the device selects for the frame.  These let a driver without hashing
+ *   hardware steer frames in software.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+uint32_t netpkt_rss_hash(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt);
+int netpkt_rss_queue(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NETDEV_LOWERHALF */
+#endif /* __INCLUDE_NUTTX_NET_NETDEV_LOWERHALF_H */
@@ -69,6 +69,9 @@
 #ifdef CONFIG_NET_MLD
 #  include <nuttx/net/mld.h>
 #endif
+#ifdef CONFIG_NET_6LOWPAN
+#  include <nuttx/net/sixlowpan.h>
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
 
@@ -117,6 +120,10 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+#ifdef CONFIG_NET_6LOWPAN
+  struct sixlowpan_stats_s sixlowpan; /* 6LoWPAN reassembly statistics */
+#endif
 };
 
 /****************************************************************************
@@ -445,6 +445,21 @@ struct sixlowpan_reassbuf_s
   clock_t rb_time;
 };
 
+#ifdef CONFIG_NET_STATISTICS
+/* The statistics of the 6LoWPAN fragment reassembly */
+
+struct sixlowpan_stats_s
+{
+  net_stats_t fragrecv;   /* Number of received fragments */
+  net_stats_t reass;      /* Number of packets reassembled */
+  net_stats_t fragdrop;   /* Number of fragments dropped as unmatched,
+                           * inconsistent or too large */
+  net_stats_t timeout;    /* Number of reassemblies that timed out */
+  net_stats_t nobuf;      /* Number of reassemblies lost for lack of a
+                           * reassembly buffer */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
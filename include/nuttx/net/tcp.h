@@ -77,11 +77,18 @@
 #define TCP_OPT_NOOP      1   /* "No-operation" TCP option */
 #define TCP_OPT_MSS       2   /* Maximum segment size TCP option */
 #define TCP_OPT_WS        3   /* Window size scaling factor */
+#define TCP_OPT_SACK_PERM 4   /* Selective acknowledgment permitted */
+#define TCP_OPT_SACK      5   /* Selective acknowledgment blocks */
 
 #define TCP_OPT_NOOP_LEN  1   /* Length of TCP NOOP option. */
 #define TCP_OPT_MSS_LEN   4   /* Length of TCP MSS option. */
 #define TCP_OPT_WS_LEN    3   /* Length of TCP WS option. */
 
+/* Lengths of the TCP SACK permitted option and of n SACK blocks */
+
+#define TCP_OPT_SACK_PERM_LEN 2
+#define TCP_OPT_SACK_LEN(n)   (2 + ((n) << 3))
+
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
 #define TCP_STATE_MASK    0x0f /* Bits 0-3: TCP state */
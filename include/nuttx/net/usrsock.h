@@ -288,6 +288,18 @@ void usrsock_abort(void);
 ssize_t usrsock_response(FAR const char *buffer, size_t len,
                          FAR bool *req_done);
 
+/****************************************************************************
+ * Name: usrsock_request_pending() - is the request still waiting for ack
+ *
+ * Description:
+ *   Return true while the request with exchange id 'xid' has not been
+ *   acknowledged by the daemon.  A transport that queues several requests
+ *   uses this to release the buffers of the acknowledged ones.
+ *
+ ****************************************************************************/
+
+bool usrsock_request_pending(uint32_t xid);
+
 /****************************************************************************
  * Name: usrsock_request() - finish usrsock's request
  ****************************************************************************/
@@ -452,7 +452,10 @@ typedef FAR void *FCACHE;
 
 struct nxfonts_glyph_s
 {
-  FAR struct nxfonts_glyph_s *flink;   /* Implements a singly linked list */
+  FAR struct nxfonts_glyph_s *flink;   /* Next less recently used glyph */
+  FAR struct nxfonts_glyph_s *blink;   /* Next more recently used glyph */
+  FAR struct nxfonts_glyph_s *hlink;   /* Next glyph of the hash bucket */
+  uint32_t stamp;                      /* The batch that used it last */
   uint8_t code;                        /* Character code */
   uint8_t height;                      /* Height of this glyph (in rows) */
   uint8_t width;                       /* Width of this glyph (in pixels) */
@@ -661,6 +664,74 @@ NXHANDLE nxf_cache_getfonthandle(FCACHE fhandle);
 FAR const struct nxfonts_glyph_s *nxf_cache_getglyph(FCACHE fhandle,
                                                      uint8_t ch);
 
+/****************************************************************************
+ * Name: nxf_cache_connectmask
+ *
+ * Description:
+ *   Create a font cache for the provided 'fontid' whose glyphs are 8-bit
+ *   alpha masks rather than pixels of fixed colors.  The glyphs are then
+ *   rendered once and drawn in any color with nxf_blendglyph().
+ *
+ * Input Parameters:
+ *   fontid    - Identifies the font supported by this cache
+ *   maxglyphs - Maximum number of glyphs permitted in the cache
+ *
+ * Returned Value:
+ *   As for nxf_cache_connect().
+ *
+ ****************************************************************************/
+
+FCACHE nxf_cache_connectmask(enum nx_fontid_e fontid, int maxglyphs);
+
+/****************************************************************************
+ * Name: nxf_cache_getglyphs
+ *
+ * Description:
+ *   Get the glyphs of the characters of a string at once.  The glyphs
+ *   already returned are not evicted to make room for the later ones, so
+ *   all remain valid until the next call on the font cache.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by
+ *             nxf_cache_connect() or nxf_cache_connectmask()
+ *   str     - The character codes
+ *   len     - The number of character codes
+ *   glyphs  - The returned glyphs, NULL for the characters that the font
+ *             does not have
+ *
+ * Returned Value:
+ *   The number of glyphs returned, less than len if the cache was too
+ *   small for the string or out of memory.
+ *
+ ****************************************************************************/
+
+int nxf_cache_getglyphs(FCACHE fhandle, FAR const uint8_t *str, int len,
+                        FAR const struct nxfonts_glyph_s **glyphs);
+
+/****************************************************************************
+ * Name: nxf_blendglyph
+ *
+ * Description:
+ *   Draw a glyph of a font cache created by nxf_cache_connectmask() in a
+ *   color over the pixels in memory.  The transparent pixels of the glyph
+ *   are left unchanged.
+ *
+ * Input Parameters:
+ *   dest       - The address of the top, left pixel of the glyph
+ *   deststride - The length of the rows of the destination in bytes
+ *   bpp        - The pixel depth of the destination: 8, 16, 24 or 32
+ *   glyph      - The glyph
+ *   color      - The color of the glyph
+ *
+ * Returned Value:
+ *   OK on success; -ENOSYS if the pixel depth is not supported.
+ *
+ ****************************************************************************/
+
+int nxf_blendglyph(FAR void *dest, unsigned int deststride, int bpp,
+                   FAR const struct nxfonts_glyph_s *glyph,
+                   nxgl_mxpixel_t color);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
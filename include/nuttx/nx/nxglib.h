@@ -92,6 +92,53 @@
  * file that also require NXGLIB types.
  */
 
+#ifdef CONFIG_NX_ACCEL
+/* The operations of a 2D graphics engine, for CONFIG_NX_ACCEL.  Each
+ * works on a rectangle of width x height pixels given by the address of
+ * its first pixel and the length of its rows in bytes.  bpp is the pixel
+ * depth and fmt an FB_FMT_* value.  An operation returns OK when it has
+ * completed, or a negated errno value, like -ENOTSUP, to have the
+ * rectangle drawn by software.  A NULL operation is never used.
+ *
+ * The driver may embed this structure at the start of its own state.
+ */
+
+struct nxgl_accel_s
+{
+  /* Fill the rectangle with a color */
+
+  CODE int (*fill)(FAR const struct nxgl_accel_s *accel,
+                   FAR void *dest, unsigned int deststride,
+                   nxgl_coord_t width, nxgl_coord_t height,
+                   uint8_t bpp, nxgl_mxpixel_t color);
+
+  /* Copy a rectangle that does not overlap the destination */
+
+  CODE int (*blit)(FAR const struct nxgl_accel_s *accel,
+                   FAR void *dest, unsigned int deststride,
+                   FAR const void *src, unsigned int srcstride,
+                   nxgl_coord_t width, nxgl_coord_t height, uint8_t bpp);
+
+  /* Blend a rectangle over the destination with a constant alpha, 255
+   * being opaque.
+   */
+
+  CODE int (*blend)(FAR const struct nxgl_accel_s *accel,
+                    FAR void *dest, unsigned int deststride,
+                    FAR const void *src, unsigned int srcstride,
+                    nxgl_coord_t width, nxgl_coord_t height,
+                    uint8_t bpp, uint8_t alpha);
+
+  /* Copy a rectangle, converting its pixels to another format */
+
+  CODE int (*convert)(FAR const struct nxgl_accel_s *accel,
+                      FAR void *dest, unsigned int deststride,
+                      uint8_t destfmt, FAR const void *src,
+                      unsigned int srcstride, uint8_t srcfmt,
+                      nxgl_coord_t width, nxgl_coord_t height);
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -505,6 +552,21 @@ void nxgl_circletraps(FAR const struct nxgl_point_s *center,
 uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1);
 uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1);
 
+/****************************************************************************
+ * Name: nxgl_accel_register
+ *
+ * Description:
+ *   Register the operations of a 2D graphics engine to be used by the
+ *   rasterizers of the NX server, or unregister them if accel is NULL.
+ *   This is normally called by the framebuffer driver before the NX server
+ *   is started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_ACCEL
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
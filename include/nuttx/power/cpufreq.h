@@ -0,0 +1,267 @@
+/****************************************************************************
+ * include/nuttx/power/cpufreq.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The cpufreq subsystem scales the clock rate and the supply voltage of the
+ * CPUs to their utilization.  A policy groups the CPUs that share a clock
+ * of the clk framework and, optionally, a regulator.  The utilization of
+ * its busiest CPU is sampled periodically and handed to the governor of
+ * the policy, which selects one of its operating points.
+ */
+
+#ifndef __INCLUDE_NUTTX_POWER_CPUFREQ_H
+#define __INCLUDE_NUTTX_POWER_CPUFREQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/queue.h>
+
+#ifdef CONFIG_CPUFREQ
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Utilizations are reported in 1/1024ths of the time of a CPU */
+
+#define CPUFREQ_UTIL_SCALE 1024
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An operating point.  The voltage range is that of the regulator of the
+ * policy at the rate, it is not changed if min_uv is zero.
+ */
+
+struct cpufreq_opp_s
+{
+  uint32_t freq;              /* The clock rate in Hz */
+  int      min_uv;            /* The lowest voltage in microvolts */
+  int      max_uv;            /* The highest voltage in microvolts */
+};
+
+/* The statistics of a policy.  Latencies are in microseconds and include
+ * the changes of the voltage.
+ */
+
+struct cpufreq_stats_s
+{
+  uint32_t freq;              /* The current clock rate in Hz */
+  uint32_t util;              /* The last utilization sampled */
+  uint32_t transitions;       /* The number of rate changes */
+  uint32_t errors;            /* The number of failed rate changes */
+  uint32_t last_latency;      /* The duration of the last change */
+  uint32_t max_latency;       /* The duration of the longest change */
+  uint64_t total_latency;     /* The duration of all changes */
+};
+
+struct clk_s;
+struct regulator_s;
+struct cpufreq_policy_s;
+
+/* A governor selects the operating point of a policy for a utilization,
+ * between 0 and CPUFREQ_UTIL_SCALE, of its busiest CPU at the current
+ * rate.  cpufreq holds a lower operating point back for
+ * CONFIG_CPUFREQ_DOWN_HOLD samples, a higher one is applied immediately.
+ */
+
+struct cpufreq_governor_s
+{
+  FAR const char *name;
+
+  /* Return the index of the operating point to run at */
+
+  CODE int (*target)(FAR struct cpufreq_policy_s *policy, uint32_t util);
+};
+
+/* A policy is allocated by the board and must stay valid until it is
+ * unregistered.  The fields up to governor are set before
+ * cpufreq_register(), the others are private to cpufreq.
+ */
+
+struct cpufreq_policy_s
+{
+  FAR const char *clk;        /* The name of the clock of the CPUs */
+  FAR const char *regulator;  /* The name of their supply, or NULL */
+
+  /* The operating points, by increasing rate */
+
+  FAR const struct cpufreq_opp_s *opps;
+  uint8_t nopps;
+
+  /* The thresholds of the ondemand governor in percent, the defaults of
+   * Kconfig are used if they are zero.
+   */
+
+  uint8_t up_threshold;
+  uint8_t down_threshold;
+
+#ifdef CONFIG_SMP
+  cpu_set_t cpus;             /* The CPUs driven by the clock */
+#endif
+
+  /* The governor, or NULL for the default one */
+
+  FAR const struct cpufreq_governor_s *governor;
+
+  /* Private to cpufreq */
+
+  struct dq_entry_s node;      /* The list of the registered policies */
+  FAR struct clk_s *clkp;      /* The clock, from clk_get() */
+  FAR struct regulator_s *reg; /* The supply, from regulator_get() */
+  uint8_t cur;                 /* The current operating point */
+  uint8_t hold;                /* The samples that asked for a lower one */
+  struct cpufreq_stats_s stats;
+  struct cpuload_s prev[CONFIG_SMP_NCPUS]; /* The last counts of the CPUs */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpufreq_register
+ *
+ * Description:
+ *   Start scaling the clock of a group of CPUs.  The clock and the
+ *   regulator are looked up by name and the CPUs start at the operating
+ *   point closest to the current rate, which the governor leaves as soon
+ *   as the first sample has been taken.
+ *
+ * Input Parameters:
+ *   policy - The policy, see struct cpufreq_policy_s
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_register(FAR struct cpufreq_policy_s *policy);
+
+/****************************************************************************
+ * Name: cpufreq_unregister
+ *
+ * Description:
+ *   Stop scaling the clock of a policy.  The rate is left unchanged.
+ *
+ * Input Parameters:
+ *   policy - A registered policy
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_unregister(FAR struct cpufreq_policy_s *policy);
+
+/****************************************************************************
+ * Name: cpufreq_set_governor
+ *
+ * Description:
+ *   Change the governor of a registered policy.
+ *
+ * Input Parameters:
+ *   policy   - A registered policy
+ *   governor - The new governor, or NULL for the default one
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_set_governor(FAR struct cpufreq_policy_s *policy,
+                         FAR const struct cpufreq_governor_s *governor);
+
+/****************************************************************************
+ * Name: cpufreq_get_stats
+ *
+ * Description:
+ *   Return the current rate, the last utilization and the transition
+ *   statistics of a registered policy.
+ *
+ * Input Parameters:
+ *   policy - A registered policy
+ *   stats  - The location to return the statistics
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cpufreq_get_stats(FAR struct cpufreq_policy_s *policy,
+                      FAR struct cpufreq_stats_s *stats);
+
+/****************************************************************************
+ * Name: cpufreq_ondemand_initialize
+ *
+ * Description:
+ *   Return the ondemand governor:  It jumps to the highest rate when the
+ *   utilization exceeds the up threshold of the policy and lowers the rate
+ *   when it falls below the down threshold, to the lowest one that keeps
+ *   the utilization under the middle of both.  In between, it keeps the
+ *   rate, so that the thresholds form a band of hysteresis.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CPUFREQ_GOVERNOR_ONDEMAND
+FAR const struct cpufreq_governor_s *cpufreq_ondemand_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: cpufreq_schedutil_initialize
+ *
+ * Description:
+ *   Return the schedutil governor:  It runs at the lowest rate that leaves
+ *   a headroom of a quarter above the demand of the busiest CPU, which is
+ *   its utilization scaled by the current rate.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CPUFREQ_GOVERNOR_SCHEDUTIL
+FAR const struct cpufreq_governor_s *cpufreq_schedutil_initialize(void);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CPUFREQ */
+#endif /* __INCLUDE_NUTTX_POWER_CPUFREQ_H */
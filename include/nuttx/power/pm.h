@@ -59,6 +59,7 @@
 #include <nuttx/wdog.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 
 #ifdef CONFIG_PM
@@ -96,6 +97,10 @@
 #define PM_WAKELOCK_DECLARE_STATIC(var, name, domain, state) \
 static struct pm_wakelock_s var = {name, domain, state}
 
+/* The latency of a QoS request that does not constrain the wakeup */
+
+#define PM_QOS_LATENCY_ANY UINT32_MAX
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -313,6 +318,18 @@ struct pm_wakelock_s
 #endif
 };
 
+/* A wakeup latency constraint of a driver or an application.  While the
+ * request is added, the governor only selects power states of the domain
+ * that resume within the latency.
+ */
+
+struct pm_qos_s
+{
+  int domain;
+  uint32_t latency;        /* The tolerated wakeup latency in microseconds */
+  struct dq_entry_s node;
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -377,6 +394,19 @@ FAR const struct pm_governor_s *pm_greedy_governor_initialize(void);
 
 FAR const struct pm_governor_s *pm_activity_governor_initialize(void);
 
+/****************************************************************************
+ * Name: pm_latency_governor_initialize
+ *
+ * Description:
+ *   Return the latency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_latency_governor_initialize(void);
+
 /****************************************************************************
  * Name: pm_set_governor
  *
@@ -690,6 +720,77 @@ void pm_wakelock_staytimeout(FAR struct pm_wakelock_s *wakelock, int ms);
 
 int pm_wakelock_staycount(FAR struct pm_wakelock_s *wakelock);
 
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   This function is called by a device driver or an application to
+ *   constrain the wakeup latency of a domain, e.g. to bound the delay
+ *   before it can serve an interrupt.  The governor of the domain honours
+ *   the smallest latency of all added requests.
+ *
+ * Input Parameters:
+ *   qos     - The request, which must stay valid until it is removed
+ *   domain  - The domain of the constraint
+ *   latency - The tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(FAR struct pm_qos_s *qos, int domain, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of an added request.
+ *
+ * Input Parameters:
+ *   qos     - The request
+ *   latency - The tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_s *qos, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove an added request and its constraint.
+ *
+ * Input Parameters:
+ *   qos - The request
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_s *qos);
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the wakeup latency that a domain must honour.
+ *
+ * Input Parameters:
+ *   domain - The domain of the constraint
+ *
+ * Returned Value:
+ *   The smallest latency of the requests of the domain in microseconds,
+ *   or PM_QOS_LATENCY_ANY if it has none.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain);
+
 /****************************************************************************
  * Name: pm_checkstate
  *
@@ -818,6 +919,10 @@ void pm_auto_updatestate(int domain);
 #  define pm_wakelock_relax(w)
 #  define pm_wakelock_staytimeout(w,m)
 #  define pm_wakelock_staycount(w)            (0)
+#  define pm_qos_add(q,d,l)
+#  define pm_qos_update(q,l)
+#  define pm_qos_remove(q)
+#  define pm_qos_latency(domain)              (UINT32_MAX)
 #  define pm_checkstate(domain)               (0)
 #  define pm_changestate(domain,state)        (0)
 #  define pm_querystate(domain)               (0)
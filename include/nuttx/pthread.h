@@ -167,6 +167,26 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
 
 void nx_pthread_exit(FAR void *exit_value) noreturn_function;
 
+#if defined(CONFIG_SEM_FASTPATH) && defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
+/****************************************************************************
+ * Name: nx_pthread_mutex_unlock
+ *
+ * Description:
+ *   The kernel implementation of pthread_mutex_unlock().  The C library
+ *   version releases uncontended NORMAL mutexes in user space and only
+ *   calls this if there are waiters.
+ *
+ * Input Parameters:
+ *   mutex - The mutex to be unlocked
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int nx_pthread_mutex_unlock(FAR pthread_mutex_t *mutex);
+#endif
+
 /****************************************************************************
  * Name: pthread_cleanup_popall
  *
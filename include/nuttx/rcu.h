@@ -0,0 +1,115 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Read-copy-update lets readers traverse a shared structure without any
+ * lock or atomic operation, while a writer updates it:  The writer
+ * publishes a modified copy of an element with rcu_assign_pointer(), and
+ * frees the old one only after synchronize_rcu() has returned, when no
+ * reader can still hold a reference to it.  Writers must still exclude
+ * each other, e.g. with a mutex.
+ *
+ * Readers bracket their accesses with rcu_read_lock() and
+ * rcu_read_unlock() and load the pointers with rcu_dereference().  They
+ * may nest, be preempted and even block, although a blocked reader delays
+ * every writer waiting in synchronize_rcu().
+ */
+
+#define rcu_dereference(p)       __atomic_load_n(&(p), __ATOMIC_CONSUME)
+#define rcu_assign_pointer(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+#ifndef CONFIG_RCU
+/* Without RCU, the callers must hold the lock of the writers */
+
+#  define rcu_read_lock()
+#  define rcu_read_unlock()
+#  define synchronize_rcu()
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_RCU
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter an RCU read-side critical section.  The elements loaded with
+ *   rcu_dereference() are not freed until rcu_read_unlock().  The
+ *   sections may be nested.  This may be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+void rcu_read_lock(void);
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave an RCU read-side critical section.
+ *
+ ****************************************************************************/
+
+void rcu_read_unlock(void);
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait for the end of a grace period:  Every RCU read-side critical
+ *   section that was entered before the call has been left when this
+ *   returns, so that the elements unpublished before the call may be
+ *   freed.  This may block and must not be called from a read-side
+ *   critical section or an interrupt handler.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void);
+
+#endif /* CONFIG_RCU */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RCU_H */
@@ -62,6 +62,10 @@ int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem);
 
 const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev);
 
+FAR void *rpmsg_get_reply_buffer(FAR struct rpmsg_endpoint *ept,
+                                 FAR const void *req, size_t hdrlen,
+                                 FAR uint32_t *len);
+
 int rpmsg_register_callback(FAR void *priv,
                             rpmsg_dev_cb_t device_created,
                             rpmsg_dev_cb_t device_destroy,
@@ -0,0 +1,380 @@
+/****************************************************************************
+ * include/nuttx/rptun/rpmsg_rpc.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RPTUN_RPMSG_RPC_H
+#define __INCLUDE_NUTTX_RPTUN_RPMSG_RPC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_RPMSG_RPC
+
+#include <nuttx/compiler.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/rptun/openamp.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The endpoint of the service "name" is RPMSG_RPC_NAME_PREFIX "name" */
+
+#define RPMSG_RPC_NAME_PREFIX      "rpc-"
+
+/* Commands of the messages */
+
+#define RPMSG_RPC_CALL             1
+#define RPMSG_RPC_REPLY            2
+
+/* The arguments and the results of the calls are padded to 8 bytes */
+
+#define RPMSG_RPC_ALIGN(len)       (((len) + 7) & ~7)
+
+/* Compile-time stubs.  A service is described once, in a header shared by
+ * both cpus, by a list of its methods:
+ *
+ *   #define FOO_METHODS(M) \
+ *     M(foo_open,  0, struct foo_open_s,  struct foo_handle_s) \
+ *     M(foo_read,  1, struct foo_read_s,  struct foo_data_s)
+ *
+ * The argument and the result of a method are structures, which both cpus
+ * must lay out identically.  Then, on the client:
+ *
+ *   FOO_METHODS(RPMSG_RPC_CLIENT_STUB)
+ *
+ * defines for each method foo_xxx_call(rpc, arg, res), a synchronous call,
+ * and foo_xxx_add(batch, res), which returns where to build the argument of
+ * a call added to a batch.  On the server:
+ *
+ *   FOO_METHODS(RPMSG_RPC_SERVER_STUB)
+ *
+ *   static const struct rpmsg_rpc_method_s g_foo_methods[] =
+ *   {
+ *     FOO_METHODS(RPMSG_RPC_METHOD)
+ *   };
+ *
+ * declares the handlers, foo_xxx_handler(priv, arg, res), which the server
+ * must define, and builds the dispatch table of the service.  The sizes in
+ * the table let the server reject calls from a client built with another
+ * layout.
+ */
+
+#define RPMSG_RPC_CLIENT_STUB(name, id, argtype, restype) \
+  static inline int name##_call(FAR struct rpmsg_rpc_s *rpc, \
+                                FAR const argtype *arg, \
+                                FAR restype *res) \
+  { \
+    return rpmsg_rpc_call(rpc, id, arg, sizeof(argtype), \
+                          res, sizeof(restype)); \
+  } \
+  static inline FAR argtype *name##_add(FAR struct rpmsg_rpc_batch_s *batch, \
+                                        FAR restype *res) \
+  { \
+    return rpmsg_rpc_batch_add(batch, id, sizeof(argtype), \
+                               res, sizeof(restype)); \
+  }
+
+#define RPMSG_RPC_SERVER_STUB(name, id, argtype, restype) \
+  static int name##_handler(FAR void *priv, FAR const argtype *arg, \
+                            FAR restype *res); \
+  static int name##_thunk(FAR void *priv, FAR const void *arg, \
+                          FAR void *res) \
+  { \
+    return name##_handler(priv, arg, res); \
+  }
+
+#define RPMSG_RPC_METHOD(name, id, argtype, restype) \
+  [id] = { name##_thunk, sizeof(argtype), sizeof(restype) },
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A message carries a header and count calls or results, each of them an
+ * entry followed by its argument or result.
+ */
+
+begin_packed_struct struct rpmsg_rpc_header_s
+{
+  uint32_t command;
+  uint32_t count;
+  uint64_t cookie;
+} end_packed_struct;
+
+begin_packed_struct struct rpmsg_rpc_entry_s
+{
+  uint32_t method;
+  int32_t  result;      /* The value returned by the handler */
+  uint32_t len;         /* The size of the argument or of the result */
+  uint32_t reserved;
+} end_packed_struct;
+
+/* A pointer argument, to a buffer that both cpus can address, e.g. in the
+ * region CONFIG_RPMSG_RPC_SHMEM_BASE.  The buffer is passed in place
+ * instead of being copied into the message.
+ */
+
+begin_packed_struct struct rpmsg_rpc_ref_s
+{
+  uint64_t addr;
+  uint32_t len;
+  uint32_t reserved;
+} end_packed_struct;
+
+/* The handler of a method.  It returns a non-negative value, or a negated
+ * errno value, and fills res, which is in the tx buffer of the reply.
+ */
+
+typedef CODE int (*rpmsg_rpc_handler_t)(FAR void *priv, FAR const void *arg,
+                                        FAR void *res);
+
+struct rpmsg_rpc_method_s
+{
+  rpmsg_rpc_handler_t handler;
+  uint32_t arglen;
+  uint32_t reslen;
+};
+
+/* A service, registered by the server */
+
+struct rpmsg_rpc_service_s
+{
+  FAR const char *name;
+  FAR const struct rpmsg_rpc_method_s *methods;
+  uint32_t nmethods;
+  FAR void *priv;       /* Passed to the handlers */
+};
+
+/* The connection of a client to a service of a remote cpu */
+
+struct rpmsg_rpc_s
+{
+  struct rpmsg_endpoint ept;
+  FAR const char *remotecpu;
+  FAR const char *name;
+  sem_t wait;           /* Posted once the service is bound */
+};
+
+/* The completion callback of an asynchronous batch */
+
+struct rpmsg_rpc_batch_s;
+typedef CODE void (*rpmsg_rpc_done_t)(FAR struct rpmsg_rpc_batch_s *batch,
+                                      FAR void *arg);
+
+/* A batch of calls sent in one message and answered by one message.  The
+ * batch belongs to the caller until it completes.
+ */
+
+struct rpmsg_rpc_batch_s
+{
+  FAR struct rpmsg_rpc_s *rpc;
+  FAR uint8_t *msg;     /* The tx buffer being built */
+  uint32_t space;       /* The size of the tx buffer */
+  uint32_t len;         /* The bytes used in the tx buffer */
+  uint32_t count;       /* The calls of the batch */
+  int result;           /* The status of the transport */
+  FAR void *res[CONFIG_RPMSG_RPC_BATCH];
+  uint32_t reslen[CONFIG_RPMSG_RPC_BATCH];
+  int32_t status[CONFIG_RPMSG_RPC_BATCH];
+  rpmsg_rpc_done_t done;
+  FAR void *arg;
+  sem_t sem;            /* Posted when a synchronous batch completes */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rpmsg_rpc_register
+ *
+ * Description:
+ *   Serve a service to the clients of all remote cpus.  The service must
+ *   stay valid as long as the system runs.  The handlers run on the rptun
+ *   thread, in the order of the calls, and must not block for long.
+ *
+ ****************************************************************************/
+
+int rpmsg_rpc_register(FAR const struct rpmsg_rpc_service_s *service);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_connect
+ *
+ * Description:
+ *   Connect a client to the service name of the cpu remotecpu.  The calls
+ *   wait until the remote service is bound.
+ *
+ ****************************************************************************/
+
+int rpmsg_rpc_connect(FAR struct rpmsg_rpc_s *rpc,
+                      FAR const char *remotecpu, FAR const char *name);
+void rpmsg_rpc_disconnect(FAR struct rpmsg_rpc_s *rpc);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_init
+ *
+ * Description:
+ *   Start a batch:  Get the tx buffer in which the calls are built in place,
+ *   waiting for the service to be bound and for a buffer to be free.
+ *
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_init(FAR struct rpmsg_rpc_s *rpc,
+                         FAR struct rpmsg_rpc_batch_s *batch);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_add
+ *
+ * Description:
+ *   Add a call of method to a batch.  The result, of reslen bytes, is copied
+ *   to res when the batch completes.
+ *
+ * Returned Value:
+ *   Where to write the argument, of arglen bytes, or NULL if the batch is
+ *   full:  It must then be sent before adding more calls.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_rpc_batch_add(FAR struct rpmsg_rpc_batch_s *batch,
+                              uint32_t method, size_t arglen,
+                              FAR void *res, size_t reslen);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_send
+ *
+ * Description:
+ *   Send a batch without waiting for its results:  done(batch, arg) is
+ *   called on the rptun thread once they arrived.  Several batches may be
+ *   in flight, up to the number of tx buffers.
+ *
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_send(FAR struct rpmsg_rpc_batch_s *batch,
+                         rpmsg_rpc_done_t done, FAR void *arg);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_call
+ *
+ * Description:
+ *   Send a batch and wait for its results.
+ *
+ * Returned Value:
+ *   OK once the results arrived, whether the calls failed or not:  Their
+ *   values are returned by rpmsg_rpc_batch_result().  A negated errno value
+ *   if the batch could not be sent.
+ *
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_call(FAR struct rpmsg_rpc_batch_s *batch);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_batch_result
+ *
+ * Description:
+ *   Return the value returned by the handler of the call index of a
+ *   completed batch, or a negated errno value if it was not called.
+ *
+ ****************************************************************************/
+
+int rpmsg_rpc_batch_result(FAR struct rpmsg_rpc_batch_s *batch,
+                           uint32_t index);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_call
+ *
+ * Description:
+ *   Call method synchronously, as a batch of one call.
+ *
+ * Returned Value:
+ *   The value returned by the handler, or a negated errno value.
+ *
+ ****************************************************************************/
+
+int rpmsg_rpc_call(FAR struct rpmsg_rpc_s *rpc, uint32_t method,
+                   FAR const void *arg, size_t arglen,
+                   FAR void *res, size_t reslen);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_set
+ *
+ * Description:
+ *   Pass the buffer buf of len bytes by reference.  It is cleaned from the
+ *   data cache, and must not be touched until the call completes.
+ *
+ ****************************************************************************/
+
+void rpmsg_rpc_ref_set(FAR struct rpmsg_rpc_ref_s *ref,
+                       FAR const void *buf, size_t len);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_done
+ *
+ * Description:
+ *   Invalidate a buffer passed by reference from the data cache, once the
+ *   call completed, before reading what the server wrote to it.
+ *
+ ****************************************************************************/
+
+void rpmsg_rpc_ref_done(FAR const struct rpmsg_rpc_ref_s *ref);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_map
+ *
+ * Description:
+ *   Return the buffer of a reference received by a handler, or NULL unless
+ *   it lies in the region CONFIG_RPMSG_RPC_SHMEM_BASE.  The buffer is
+ *   invalidated from the data cache.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_rpc_ref_map(FAR const struct rpmsg_rpc_ref_s *ref);
+
+/****************************************************************************
+ * Name: rpmsg_rpc_ref_unmap
+ *
+ * Description:
+ *   Clean a buffer of a reference, written by a handler, from the data
+ *   cache before the reply is sent.
+ *
+ ****************************************************************************/
+
+void rpmsg_rpc_ref_unmap(FAR const struct rpmsg_rpc_ref_s *ref);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_RPMSG_RPC */
+#endif /* __INCLUDE_NUTTX_RPTUN_RPMSG_RPC_H */
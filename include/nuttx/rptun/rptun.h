@@ -42,6 +42,7 @@
 #define RPTUNIOC_PANIC              _RPTUNIOC(4)
 #define RPTUNIOC_DUMP               _RPTUNIOC(5)
 #define RPTUNIOC_PING               _RPTUNIOC(6)
+#define RPTUNIOC_BENCH              _RPTUNIOC(7)
 
 #define RPTUN_NOTIFY_ALL            (UINT32_MAX - 0)
 
@@ -352,6 +353,18 @@ struct rptun_ping_s
   int  sleep; /* unit: ms */
 };
 
+/* used for ioctl RPTUNIOC_BENCH: for each message size from minlen to
+ * maxlen, doubling, measure the round trip latency of times pings and the
+ * throughput of times messages sent without acknowledgement.
+ */
+
+struct rptun_bench_s
+{
+  int  times;
+  int  minlen;
+  int  maxlen;
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -90,19 +90,21 @@
 #define TCB_FLAG_NONCANCELABLE     (1 << 2)                      /* Bit 2: Pthread is non-cancelable */
 #define TCB_FLAG_CANCEL_DEFERRED   (1 << 3)                      /* Bit 3: Deferred (vs asynch) cancellation type */
 #define TCB_FLAG_CANCEL_PENDING    (1 << 4)                      /* Bit 4: Pthread cancel is pending */
-#define TCB_FLAG_POLICY_SHIFT      (5)                           /* Bit 5-6: Scheduling policy */
-#define TCB_FLAG_POLICY_MASK       (3 << TCB_FLAG_POLICY_SHIFT)
+#define TCB_FLAG_POLICY_SHIFT      (5)                           /* Bit 5-7: Scheduling policy */
+#define TCB_FLAG_POLICY_MASK       (7 << TCB_FLAG_POLICY_SHIFT)
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
 #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT)  /* Other scheding policy */
-#define TCB_FLAG_CPU_LOCKED        (1 << 8)                      /* Bit 7: Locked to this CPU */
-#define TCB_FLAG_SIGNAL_ACTION     (1 << 9)                      /* Bit 8: In a signal handler */
-#define TCB_FLAG_SYSCALL           (1 << 10)                     /* Bit 9: In a system call */
-#define TCB_FLAG_EXIT_PROCESSING   (1 << 11)                     /* Bit 10: Exitting */
+#  define TCB_FLAG_SCHED_DEADLINE  (4 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
+#define TCB_FLAG_CPU_LOCKED        (1 << 8)                      /* Bit 8: Locked to this CPU */
+#define TCB_FLAG_SIGNAL_ACTION     (1 << 9)                      /* Bit 9: In a signal handler */
+#define TCB_FLAG_SYSCALL           (1 << 10)                     /* Bit 10: In a system call */
+#define TCB_FLAG_EXIT_PROCESSING   (1 << 11)                     /* Bit 11: Exitting */
 #define TCB_FLAG_FREE_STACK        (1 << 12)                     /* Bit 12: Free stack after exit */
 #define TCB_FLAG_HEAP_CHECK        (1 << 13)                     /* Bit 13: Heap check */
-                                                                 /* Bits 14-15: Available */
+#define TCB_FLAG_SEM_REQUEUED      (1 << 14)                     /* Bit 14: Wait moved by nxsem_requeue() */
+                                                                 /* Bit 15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -301,6 +303,31 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure holds the constant bandwidth server of a thread with the
+ * SCHED_DEADLINE policy.  It is small enough to be embedded in the TCB.
+ * All times are in system clock ticks; the remaining budget of the server
+ * is kept in the timeslice field of the TCB.
+ */
+
+struct deadline_s
+{
+  clock_t   runtime;                /* Budget of each job                       */
+  clock_t   reldeadline;            /* Relative deadline of each job            */
+  clock_t   period;                 /* Period of the jobs                       */
+  clock_t   deadline;               /* Absolute deadline of the server          */
+  uint32_t  bandwidth;              /* Reserved share of a CPU, runtime/period  */
+  uint32_t  nmisses;                /* Number of missed deadlines               */
+  uint32_t  noverruns;              /* Number of exhausted budgets              */
+  bool      blocked;                /* Blocked since the server was last run    */
+  bool      missed;                 /* The current deadline has been missed     */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -522,6 +549,37 @@ struct task_group_s
 #endif
 };
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* struct critmon_hist_s ****************************************************/
+
+/* The distribution of the durations of one kind of latency, in the units
+ * of up_perf_gettime():  bucket[0] counts the durations of zero and
+ * bucket[n] those from 2^(n-1) to 2^n - 1, the last bucket all the longer
+ * ones.  The longest durations are kept with their offender, longest first.
+ */
+
+enum critmon_hist_e
+{
+  CRITMON_PREEMPTION = 0,           /* sched_lock() hold time              */
+  CRITMON_CSECTION,                 /* enter_critical_section() hold time  */
+  CRITMON_IRQ,                      /* Interrupt handler duration          */
+  CRITMON_NHIST
+};
+
+struct critmon_top_s
+{
+  uint32_t elapsed;                 /* The duration                         */
+  pid_t pid;                        /* The thread, or the IRQ number        */
+  FAR void *caller;                 /* Where it began, or the handler       */
+};
+
+struct critmon_hist_s
+{
+  uint32_t bucket[CONFIG_SCHED_CRITMONITOR_NBUCKETS];
+  struct critmon_top_s top[CONFIG_SCHED_CRITMONITOR_TOPN];
+};
+#endif
+
 /* struct tcb_s *************************************************************/
 
 /* This is the common part of the task control block (TCB).
@@ -556,6 +614,9 @@ struct tcb_s
   uint8_t  boost_priority;               /* "Boosted" priority of the thread */
   uint8_t  base_priority;                /* "Normal" priority of the thread */
   FAR struct semholder_s *holdsem;       /* List of held semaphores         */
+#if defined(CONFIG_SEM_TCBHOLDERS) && CONFIG_SEM_TCBHOLDERS > 0
+  struct semholder_s holders[CONFIG_SEM_TCBHOLDERS]; /* Embedded holders    */
+#endif
 #endif
 
 #ifdef CONFIG_SMP
@@ -569,16 +630,25 @@ struct tcb_s
 #endif
 #ifdef CONFIG_CANCELLATION_POINTS
   int16_t  cpcount;                      /* Nested cancellation point count */
+#endif
+#ifdef CONFIG_RCU
+  int16_t  rcu_nesting;                  /* RCU read-side nesting count     */
+  uint8_t  rcu_gp;                       /* Grace period of the reader      */
+  bool     rcu_preempted;                /* Switched out while reading      */
 #endif
   int16_t  errcode;                      /* Used to pass error information  */
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
   int32_t  timeslice;                    /* RR timeslice OR Sporadic budget */
                                          /* interval remaining              */
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  struct deadline_s deadline;            /* Deadline scheduling server      */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
 
@@ -602,6 +672,16 @@ struct tcb_s
   /* POSIX Semaphore and Message Queue Control Fields ***********************/
 
   FAR void *waitobj;                     /* Object thread waiting on        */
+#ifdef CONFIG_SEM_REQUEUE
+  FAR sem_t *waitmorph;                  /* Semaphore the wait may move to  */
+#endif
+
+  /* select() Support *******************************************************/
+
+#ifdef CONFIG_FS_SELECT_CACHE
+  FAR struct pollfd *pollset;            /* Cached descriptors of select()  */
+  size_t npollset;                       /* Entries of the cached array     */
+#endif
 
   /* POSIX Signal Control Fields ********************************************/
 
@@ -623,6 +703,14 @@ struct tcb_s
   uint32_t ticks;                        /* Number of ticks on this thread */
 #endif
 
+  /* CPU time accounting support ********************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+  uint64_t cputime;                      /* Cycles the thread has run       */
+  uint32_t cputime_start;                /* Cycle count when last resumed   */
+  uint32_t nswitches;                    /* Number of times resumed         */
+#endif
+
   /* Pre-emption monitor support ********************************************/
 
 #ifdef CONFIG_SCHED_CRITMONITOR
@@ -634,6 +722,11 @@ struct tcb_s
   uint32_t run_max;                      /* Max time thread run             */
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  FAR void *premp_caller;                /* Caller of sched_lock()          */
+  FAR void *crit_caller;                 /* Caller of critical section      */
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -757,6 +850,12 @@ extern "C"
 
 EXTERN uint32_t g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN uint32_t g_crit_max[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* Distributions of the latencies of each CPU */
+
+EXTERN struct critmon_hist_s g_critmon_hist[CONFIG_SMP_NCPUS][CRITMON_NHIST];
+#endif
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
 #ifdef CONFIG_DEBUG_TCBINFO
@@ -1370,6 +1469,26 @@ int nxsched_set_affinity(pid_t pid, size_t cpusetsize,
 
 int nxsched_get_stackinfo(pid_t pid, FAR struct stackinfo_s *stackinfo);
 
+/****************************************************************************
+ * Name: nxsched_get_cputime
+ *
+ * Description:
+ *   Return the CPU time consumed by a thread, including the time of the
+ *   current run if the thread is running.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread to query.
+ *   ts  - The location to return the CPU time.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUTIME
+void nxsched_get_cputime(FAR struct tcb_s *tcb, FAR struct timespec *ts);
+#endif
+
 /****************************************************************************
  * Name: nx_wait/nx_waitid/nx_waitpid
  ****************************************************************************/
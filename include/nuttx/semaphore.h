@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <errno.h>
 #include <semaphore.h>
 
@@ -632,10 +633,117 @@ int nxsem_clockwait_uninterruptible(FAR sem_t *sem, clockid_t clockid,
 
 int nxsem_tickwait_uninterruptible(FAR sem_t *sem, uint32_t delay);
 
+#ifdef CONFIG_SEM_FASTPATH
+/****************************************************************************
+ * Name: nx_sem_wait, nx_sem_trywait, nx_sem_post
+ *
+ * Description:
+ *   The kernel implementations of sem_wait(), sem_trywait() and sem_post().
+ *   With CONFIG_SEM_FASTPATH, the user interfaces are provided by the C
+ *   library: they first try nxsem_trywait_fast() or nxsem_post_fast() and
+ *   call these only when a task must block or must be woken up.  They
+ *   follow the application error return policy (errno is set).
+ *
+ ****************************************************************************/
+
+int nx_sem_wait(FAR sem_t *sem);
+int nx_sem_trywait(FAR sem_t *sem);
+int nx_sem_post(FAR sem_t *sem);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+/****************************************************************************
+ * Name: nxsem_trywait_fast
+ *
+ * Description:
+ *   Take one count from the semaphore with an atomic compare-and-swap if
+ *   a count is available.  The fast path is not used if priority
+ *   inheritance is enabled on the semaphore because the kernel must then
+ *   record the new holder.
+ *
+ * Input Parameters:
+ *   sem - Semaphore object
+ *
+ * Returned Value:
+ *   true if a count was taken.  false if the kernel must be entered.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_trywait_fast(FAR sem_t *sem)
+{
+  int16_t count;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((sem->flags & PRIOINHERIT_FLAGS_ENABLE) != 0)
+    {
+      return false;
+    }
+#endif
+
+  count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+  while (count > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1,
+                                      false, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_post_fast
+ *
+ * Description:
+ *   Give one count back to the semaphore with an atomic compare-and-swap if
+ *   no task is waiting for it.  Waiters (a negative count) and semaphores
+ *   with priority inheritance enabled are left to the kernel.
+ *
+ * Input Parameters:
+ *   sem - Semaphore object
+ *
+ * Returned Value:
+ *   true if the count was given.  false if the kernel must be entered.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_post_fast(FAR sem_t *sem)
+{
+  int16_t count;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((sem->flags & PRIOINHERIT_FLAGS_ENABLE) != 0)
+    {
+      return false;
+    }
+#endif
+
+  count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1,
+                                      false, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif /* CONFIG_SEM_FASTPATH */
+
 #endif /* __ASSEMBLY__ */
 #endif /* __INCLUDE_NUTTX_SEMAPHORE_H */
@@ -0,0 +1,72 @@
+/****************************************************************************
+ * include/nuttx/sensors/fusion.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_FUSION_H
+#define __INCLUDE_NUTTX_SENSORS_FUSION_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_SENSORS_FUSION
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Name: sensor_fusion_register
+ *
+ * Description:
+ *   Register an orientation topic, /dev/uorb/sensor_orientationN, fused
+ *   from the topics of an accelerometer, a gyroscope and optionally a
+ *   magnetometer.  The inputs are subscribed to, at the interval of the
+ *   output, only while the orientation has subscribers.
+ *
+ * Input Parameters:
+ *   accel - The path of the accelerometer topic, e.g.
+ *           /dev/uorb/sensor_accel0
+ *   gyro  - The path of the gyroscope topic
+ *   mag   - The path of the magnetometer topic, or NULL
+ *   devno - The number N of the orientation topic
+ *
+ *   The paths must stay valid as long as the topic is registered.
+ *
+ * Returned Value:
+ *   OK if the topic was registered; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_fusion_register(FAR const char *accel, FAR const char *gyro,
+                           FAR const char *mag, int devno);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_FUSION */
+#endif /* __INCLUDE_NUTTX_SENSORS_FUSION_H */
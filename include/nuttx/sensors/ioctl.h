@@ -341,4 +341,15 @@
 
 #define SNIOC_GET_USTATE           _SNIOC(0x0092)
 
+/* Command:      SNIOC_GET_EVENTS
+ * Description:  Consume all the events published since the last read
+ *               without copying them: they are to be read in place from
+ *               the circular buffer mapped with mmap().  The events may
+ *               wrap around the end of the buffer and must be used
+ *               before nbuffer more events get published.
+ * Argument:     This is the pointer of struct sensor_events_s
+ */
+
+#define SNIOC_GET_EVENTS           _SNIOC(0x0093)
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
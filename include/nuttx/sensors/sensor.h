@@ -289,9 +289,17 @@
 
 #define SENSOR_TYPE_CAP                             32
 
+/* Orientation
+ * The attitude of the device, fused from an accelerometer, a gyroscope
+ * and optionally a magnetometer, reported as a unit quaternion and as
+ * Euler angles in radians.
+ */
+
+#define SENSOR_TYPE_ORIENTATION                     33
+
 /* The total number of sensor */
 
-#define SENSOR_TYPE_COUNT                           33
+#define SENSOR_TYPE_COUNT                           34
 
 /* The additional sensor open flags */
 
@@ -585,6 +593,18 @@ struct sensor_cap           /* Type: Capacitance */
   int32_t rawdata[4];       /* in SI units pF */
 };
 
+struct sensor_orientation   /* Type: Orientation */
+{
+  uint64_t timestamp;       /* Unit is microseconds */
+  float w;                  /* Quaternion, scalar part */
+  float x;                  /* Quaternion, vector part */
+  float y;
+  float z;
+  float roll;               /* Rotation about X in rad */
+  float pitch;              /* Rotation about Y in rad */
+  float yaw;                /* Rotation about Z in rad, drifts w/o mag */
+};
+
 /* The sensor lower half driver interface */
 
 struct sensor_lowerhalf_s;
@@ -908,6 +928,10 @@ struct sensor_lowerhalf_s
        *   Lower half driver pushes a sensor event by calling this function.
        *   It is provided by upper half driver to lower half driver.
        *
+       *   Several events may be pushed in one call, e.g. the content of
+       *   the hardware FIFO.  Users are then woken up once for the whole
+       *   batch, and users with a batch latency only once it elapsed.
+       *
        * Input Parameters:
        *   priv   - Upper half driver handle.
        *   data   - The buffer of event, it can be all type of sensor events.
@@ -985,6 +1009,14 @@ struct sensor_ustate_s
   unsigned long generation;    /* The recent generation of circular buffer */
 };
 
+/* This structure describes the events returned by SNIOC_GET_EVENTS */
+
+struct sensor_events_s
+{
+  unsigned long offset;        /* Byte offset of first event in the mapping */
+  unsigned long nevents;       /* The number of events */
+};
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
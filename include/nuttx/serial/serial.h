@@ -135,6 +135,7 @@ struct uart_dmaxfer_s
   size_t           length;  /* Length of first DMA buffer */
   size_t           nlength; /* Length of next DMA buffer */
   size_t           nbytes;  /* Bytes actually transferred by DMA from both buffers */
+  size_t           ndone;   /* Bytes already reported to the upper half */
 };
 #endif /* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA */
 
@@ -484,6 +485,23 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_update
+ *
+ * Description:
+ *  Report the progress of a running RX DMA transfer without ending it.
+ *  The lower half calls this from its half-transfer, idle-line or receive
+ *  timeout interrupt with the number of bytes the DMA has stored so far in
+ *  the regions described by dev->dmarx.  The new bytes are handed to the
+ *  readers at once, and uart_recvchars_done() later only adds the bytes
+ *  received after the last update.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_update(FAR uart_dev_t *dev, size_t nbytes);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
@@ -561,6 +561,28 @@ void nxsig_cancel_notification(FAR struct sigwork_s *work);
   #define nxsig_cancel_notification(work) (void)(work)
 #endif
 
+/****************************************************************************
+ * Name: signalfd_notify
+ *
+ * Description:
+ *   Wake up the pollers of the signalfds of a task group whose mask
+ *   contains a signal that was just made pending.
+ *
+ * Input Parameters:
+ *   pid   - The ID of the task group
+ *   signo - The pending signal
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIGNAL_FD_POLL
+void signalfd_notify(pid_t pid, int signo);
+#else
+  #define signalfd_notify(pid, signo)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
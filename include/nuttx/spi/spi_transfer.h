@@ -112,6 +112,26 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence of SPI transactions queued with
+ * spi_transfer_async().  It belongs to the bus until its callback is
+ * called, so it and the sequence that it refers to must stay valid until
+ * then.
+ */
+
+struct spi_async_s;
+typedef CODE void (*spi_async_callback_t)(FAR struct spi_async_s *req,
+                                          int result);
+
+struct spi_async_s
+{
+  FAR struct spi_async_s *flink;   /* Private: next in the queue of the bus */
+  FAR struct spi_sequence_s *seq;  /* The transactions to perform */
+  spi_async_callback_t callback;   /* Called when it has been performed */
+  FAR void *arg;                   /* For the use of the callback */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -161,6 +181,50 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 int spi_register(FAR struct spi_dev_s *spi, int bus);
 #endif
 
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return at once.  The sequences
+ *   queued on a bus are performed in order, back-to-back, by a kernel
+ *   thread of the bus; the callback of each one is called on that thread
+ *   with the result of spi_transfer() once it has completed.  It may queue
+ *   the next sequence.
+ *
+ *   This must not be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfers
+ *   req - The request to queue, with its sequence and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; -ENOMEM if there are already
+ *   CONFIG_SPI_ASYNC_NBUSES buses or the thread of the bus cannot be
+ *   started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_transfer_async(FAR struct spi_dev_s *spi,
+                       FAR struct spi_async_s *req);
+
+/****************************************************************************
+ * Name: spi_transfer_cancel
+ *
+ * Description:
+ *   Remove a request from the queue of its bus if it has not been started.
+ *   Its callback is not called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -ENOENT if it has been started,
+ *   or is not queued.
+ *
+ ****************************************************************************/
+
+int spi_transfer_cancel(FAR struct spi_dev_s *spi,
+                        FAR struct spi_async_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
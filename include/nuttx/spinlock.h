@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/irq.h>
@@ -81,6 +82,81 @@ typedef uint8_t spinlock_t;
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
 
+#if defined(CONFIG_SPINLOCK_LOCKDEP) && !defined(__SP_UNLOCK_FUNCTION)
+#  define __SP_UNLOCK_FUNCTION 1
+#endif
+
+/* Ticket spinlocks keep the next ticket in the upper half of spinlock_t and
+ * the ticket being served in the lower half.  The lock is SP_UNLOCKED (0)
+ * whenever it is free.
+ */
+
+#ifdef CONFIG_SPINLOCK_TICKET
+#  define SP_TICKET_SHIFT   (sizeof(spinlock_t) * 4)
+#  define SP_TICKET_MASK    (((spinlock_t)1 << SP_TICKET_SHIFT) - 1)
+#  define SP_TICKET_NEXT    ((spinlock_t)1 << SP_TICKET_SHIFT)
+#  ifndef __SP_UNLOCK_FUNCTION
+#    define __SP_UNLOCK_FUNCTION 1
+#  endif
+#endif
+
+/* The number of CPUs in the spinlock statistics */
+
+#ifdef CONFIG_SMP
+#  define SP_NCPUS          CONFIG_SMP_NCPUS
+#else
+#  define SP_NCPUS          1
+#endif
+
+/* Initializer of an MCS queue lock */
+
+#ifdef CONFIG_SPINLOCK_MCS
+#  define MCS_LOCK_INITIALIZER {NULL}
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+/* One waiter of an MCS queue lock.  The node is provided by the caller of
+ * mcs_lock() and must stay valid until the matching mcs_unlock().
+ */
+
+struct mcs_node_s
+{
+  FAR struct mcs_node_s *volatile next; /* The next waiter in the queue */
+  volatile bool wait;                   /* True until the lock is passed on */
+};
+
+/* An MCS queue lock */
+
+struct mcs_lock_s
+{
+  FAR struct mcs_node_s *volatile tail; /* Last node in the queue or NULL */
+};
+#endif
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+/* Contention statistics of one CPU for one lock */
+
+struct spinlock_cpustat_s
+{
+  uint32_t nlocks;                      /* Number of acquisitions */
+  uint32_t ncontended;                  /* Acquisitions that had to wait */
+  uint32_t maxspins;                    /* Longest wait in spin iterations */
+  uint64_t nspins;                      /* Total wait in spin iterations */
+};
+
+/* Contention statistics of one lock */
+
+struct spinlock_stat_s
+{
+  FAR volatile void *lock;              /* The lock or NULL if slot unused */
+  struct spinlock_cpustat_s cpu[SP_NCPUS];
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -145,7 +221,13 @@ static inline spinlock_t up_testset(volatile FAR spinlock_t *lock)
  ****************************************************************************/
 
 /* void spin_initialize(FAR spinlock_t *lock, spinlock_t state); */
-#define spin_initialize(l,s) do { *(l) = (s); } while (0)
+#ifdef CONFIG_SPINLOCK_TICKET
+#  define spin_initialize(l,s) \
+     do { *(l) = (s) == SP_UNLOCKED ? SP_UNLOCKED : SP_TICKET_NEXT; } \
+     while (0)
+#else
+#  define spin_initialize(l,s) do { *(l) = (s); } while (0)
+#endif
 
 /****************************************************************************
  * Name: spin_lock
@@ -301,7 +383,11 @@ void spin_unlock_wo_note(FAR volatile spinlock_t *lock);
  ****************************************************************************/
 
 /* bool spin_islocked(FAR spinlock_t lock); */
-#define spin_islocked(l) (*(l) == SP_LOCKED)
+#ifdef CONFIG_SPINLOCK_TICKET
+#  define spin_islocked(l) (*(l) != SP_UNLOCKED)
+#else
+#  define spin_islocked(l) (*(l) == SP_LOCKED)
+#endif
 
 /****************************************************************************
  * Name: spin_setbit
@@ -349,6 +435,88 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *orlock);
 #endif
 
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Lock an MCS queue lock.  The caller is appended to the queue of the
+ *   lock and then spins on its own node until the previous holder hands
+ *   the lock over, so the waiting CPUs do not share a cache line and get
+ *   the lock in FIFO order.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of the caller.  It is used until mcs_unlock().
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+void mcs_lock(FAR struct mcs_lock_s *lock, FAR struct mcs_node_s *node);
+#endif
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Try once to lock an MCS queue lock.  Do not wait if the lock is
+ *   already held or if other CPUs are waiting for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of the caller.  It is used until mcs_unlock().
+ *
+ * Returned Value:
+ *   true if the lock was taken, false otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+bool mcs_trylock(FAR struct mcs_lock_s *lock, FAR struct mcs_node_s *node);
+#endif
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release an MCS queue lock and hand it over to the next waiter, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to unlock.
+ *   node - The node that was passed to mcs_lock() or mcs_trylock().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+void mcs_unlock(FAR struct mcs_lock_s *lock, FAR struct mcs_node_s *node);
+#endif
+
+/****************************************************************************
+ * Name: spin_getstat
+ *
+ * Description:
+ *   Return one entry of the spinlock contention statistics.
+ *
+ * Input Parameters:
+ *   index - The index of the entry,
+ *           0 .. CONFIG_SPINLOCK_STATISTICS_NLOCKS - 1
+ *   stat  - The location to return the entry.  stat->lock is NULL for an
+ *           unused entry.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if index is out of range.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+int spin_getstat(unsigned int index, FAR struct spinlock_stat_s *stat);
+#endif
+
 #endif /* CONFIG_SPINLOCK */
 
 /****************************************************************************
@@ -425,4 +593,35 @@ void spin_unlock_irqrestore(spinlock_t *lock, irqstate_t flags);
 #  define spin_unlock_irqrestore(l, f) up_irq_restore(f)
 #endif
 
+/****************************************************************************
+ * Name: spin_lockdep_csection
+ *
+ * Description:
+ *   Tell the spinlock dependency checker that this CPU is about to wait
+ *   for the global critical section.  Every spinlock held by this CPU is
+ *   recorded as being taken before the critical section.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SPINLOCK_LOCKDEP) && defined(CONFIG_SMP)
+void spin_lockdep_csection(void);
+#else
+#  define spin_lockdep_csection()
+#endif
+
+/****************************************************************************
+ * Name: spin_lockdep_sleep
+ *
+ * Description:
+ *   Tell the spinlock dependency checker that the current task is about
+ *   to block.  This is a violation if this CPU holds any spinlock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_LOCKDEP
+void spin_lockdep_sleep(void);
+#else
+#  define spin_lockdep_sleep()
+#endif
+
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
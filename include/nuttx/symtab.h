@@ -27,6 +27,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -55,6 +57,20 @@ struct symtab_s
   FAR const void *sym_value;         /* The value associated with the string */
 };
 
+/* struct symtab_hash_s is a hash index of a symbol table, built at run
+ * time by symtab_hashinit() for lookups by name that do not depend on the
+ * size or the order of the table.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  FAR uint16_t *buckets;             /* First entry of each bucket */
+  FAR uint16_t *chain;               /* Next entry in the same bucket */
+  int nsyms;                         /* Number of entries in symtab */
+  int nbuckets;                      /* Number of buckets, a power of two */
+};
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -106,6 +122,51 @@ FAR const struct symtab_s *
 symtab_findbyvalue(FAR const struct symtab_s *symtab,
                    FAR void *value, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index of a symbol table.  The table must not change as
+ *   long as the index is used.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -E2BIG if the table is too large to be indexed
+ *   or -ENOMEM if the index cannot be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASH
+int symtab_hashinit(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hashuninit
+ *
+ * Description:
+ *   Release the hash index of a symbol table.
+ *
+ ****************************************************************************/
+
+void symtab_hashuninit(FAR struct symtab_hash_s *hash);
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name using the hash index of its
+ *   symbol table.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name);
+#endif
+
 /****************************************************************************
  * Name: symtab_sortbyname
  *
@@ -32,6 +32,7 @@
 
 #include <sys/types.h>
 #include <stdarg.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -118,6 +119,30 @@ struct syslog_channel_s
   /* Implementation specific logic may follow */
 };
 
+#ifdef CONFIG_SYSLOG_BINARY
+/* With CONFIG_SYSLOG_BINARY, each message is written to the channels as
+ * this header followed by the arguments: each one with the size of its
+ * type after the default argument promotions, in the byte order of the
+ * target and without padding.  Strings are copied with their terminating
+ * NUL.  The text is formatted on the host from the format string found at
+ * sb_fmt in the ELF file, see tools/parsesyslog.py.
+ */
+
+#define SYSLOG_BINARY_MAGIC0 0xa5
+#define SYSLOG_BINARY_MAGIC1 0x5a
+
+begin_packed_struct struct syslog_binary_s
+{
+  uint8_t   sb_magic[2];  /* SYSLOG_BINARY_MAGIC0 and SYSLOG_BINARY_MAGIC1 */
+  uint8_t   sb_priority;  /* The priority of the message */
+  uint8_t   sb_length;    /* The length of the record with the header */
+  int32_t   sb_pid;       /* The ID of the thread that logged the message */
+  uint32_t  sb_sec;       /* The time stamp of the message */
+  uint32_t  sb_nsec;
+  uintptr_t sb_fmt;       /* The address of the format string */
+} end_packed_struct;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
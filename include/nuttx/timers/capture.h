@@ -26,6 +26,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
 #include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
@@ -37,10 +41,44 @@
 #define CAPIOC_DUTYCYCLE _CAPIOC(1)
 #define CAPIOC_FREQUENCE _CAPIOC(2)
 
+/* CAPIOC_STREAM - Start (arg != 0) or stop (arg == 0) the streaming of the
+ *   edges.  While streaming, read() returns arrays of struct cap_event_s,
+ *   oldest first, and poll() reports POLLIN when events are queued.
+ *   Requires CONFIG_CAPTURE_STREAM and a lower half with a stream method.
+ */
+
+#define CAPIOC_STREAM    _CAPIOC(3)
+
+/* The edges of struct cap_event_s */
+
+#define CAP_EDGE_RISING  1
+#define CAP_EDGE_FALLING 2
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One captured edge.  time is the value of the counter latched by the
+ * edge, in timer clocks.  Lower halves that reset the counter on each
+ * rising edge (e.g. the PWM input mode of STM32) report the counts since
+ * the previous rising edge.
+ */
+
+struct cap_event_s
+{
+  uint32_t time;      /* Latched counter value */
+  uint8_t  channel;   /* Input channel of the edge */
+  uint8_t  edge;      /* CAP_EDGE_RISING or CAP_EDGE_FALLING */
+};
+
+/* The handler of streamed edges.  It may be called from interrupt level,
+ * with a whole block of events, e.g. when a DMA transfer completes.
+ */
+
+typedef CODE void (*cap_stream_t)(FAR void *arg,
+                                  FAR const struct cap_event_s *events,
+                                  size_t nevents);
+
 /* This structure provides the "lower-half" driver operations available to
  * the "upper-half" driver.
  */
@@ -67,6 +105,15 @@ struct cap_ops_s
 
   CODE int (*getfreq)(FAR struct cap_lowerhalf_s *lower,
                       FAR uint32_t *freq);
+
+  /* Optional methods *******************************************************/
+
+  /* Deliver the captured edges to handler, or stop delivering them if
+   * handler is NULL.  The capture must have been started.
+   */
+
+  CODE int (*stream)(FAR struct cap_lowerhalf_s *lower,
+                     cap_stream_t handler, FAR void *arg);
 };
 
 /* This structure provides the publicly visible representation of the
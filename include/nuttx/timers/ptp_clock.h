@@ -0,0 +1,141 @@
+/****************************************************************************
+ * include/nuttx/timers/ptp_clock.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TIMERS_PTP_CLOCK_H
+#define __INCLUDE_NUTTX_TIMERS_PTP_CLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_PTP_CLOCK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+
+/* PTPIOC_GETTIME - Read the clock.
+ *   arg: FAR struct timespec *
+ *
+ * PTPIOC_SETTIME - Step the clock to an absolute time.
+ *   arg: FAR const struct timespec *
+ *
+ * PTPIOC_ADJTIME - Step the clock by a signed offset.
+ *   arg: FAR const int64_t *, in nanoseconds
+ *
+ * PTPIOC_ADJFINE - Set the frequency offset of the clock from its nominal
+ *   rate, as by the servo of a PTP daemon.
+ *   arg: long, in parts per billion
+ */
+
+#define PTPIOC_GETTIME   _PTPIOC(1)
+#define PTPIOC_SETTIME   _PTPIOC(2)
+#define PTPIOC_ADJTIME   _PTPIOC(3)
+#define PTPIOC_ADJFINE   _PTPIOC(4)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A PTP hardware clock (PHC) is the free running, adjustable clock of a
+ * MAC that time stamps the packets it sends and receives.  The time stamps
+ * of the network driver, see netdev_rxtstamp() and netdev_txtstamp(), are
+ * read from this clock, so that a PTP daemon can discipline it directly.
+ */
+
+struct ptp_lowerhalf_s;
+struct ptp_ops_s
+{
+  CODE int (*gettime)(FAR struct ptp_lowerhalf_s *lower,
+                      FAR struct timespec *ts);
+  CODE int (*settime)(FAR struct ptp_lowerhalf_s *lower,
+                      FAR const struct timespec *ts);
+  CODE int (*adjtime)(FAR struct ptp_lowerhalf_s *lower, int64_t delta);
+  CODE int (*adjfine)(FAR struct ptp_lowerhalf_s *lower, long ppb);
+};
+
+struct ptp_lowerhalf_s
+{
+  FAR const struct ptp_ops_s *ops;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ptp_clock_register
+ *
+ * Description:
+ *   Register a PTP hardware clock as /dev/ptpN.  The first clock that is
+ *   registered is also the one read and set by clock_gettime() and
+ *   clock_settime() with CLOCK_PTP.
+ *
+ * Input Parameters:
+ *   lower - The lower half of the clock, e.g. of an Ethernet MAC
+ *   devno - N of /dev/ptpN
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ptp_clock_register(FAR struct ptp_lowerhalf_s *lower, int devno);
+
+/****************************************************************************
+ * Name: ptp_clock_gettime / ptp_clock_settime
+ *
+ * Description:
+ *   Read or step the clock of CLOCK_PTP.  These are called by
+ *   clock_gettime() and clock_settime().
+ *
+ * Returned Value:
+ *   OK on success; -ENODEV if no clock was registered.
+ *
+ ****************************************************************************/
+
+int ptp_clock_gettime(FAR struct timespec *ts);
+int ptp_clock_settime(FAR const struct timespec *ts);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_PTP_CLOCK */
+#endif /* __INCLUDE_NUTTX_TIMERS_PTP_CLOCK_H */
@@ -101,12 +101,23 @@
  *  and return immediately.
  *
  *  ioctl argument:  None
+ *
+ * PWMIOC_UPDATE - Change the duty cycles of a started output, on all of
+ *  the channels at the same period boundary.  Lower halves with an update
+ *  method load the shadow registers of the channels and commit them
+ *  together, so that no period is generated with a partial update.  The
+ *  frequency must not change.  If the output is stopped, this command is
+ *  the same as PWMIOC_SETCHARACTERISTICS.
+ *
+ *  ioctl argument: A read-only reference to struct pwm_info_s that provides
+ *  the new characteristics of the pulsed output.
  */
 
 #define PWMIOC_SETCHARACTERISTICS _PWMIOC(1)
 #define PWMIOC_GETCHARACTERISTICS _PWMIOC(2)
 #define PWMIOC_START              _PWMIOC(3)
 #define PWMIOC_STOP               _PWMIOC(4)
+#define PWMIOC_UPDATE             _PWMIOC(5)
 
 /****************************************************************************
  * Public Types
@@ -194,6 +205,14 @@ struct pwm_ops_s
 
   CODE int (*ioctl)(FAR struct pwm_lowerhalf_s *dev,
                     int cmd, unsigned long arg);
+
+  /* Optional.  Change the duty cycles of the started output atomically,
+   * at the next period boundary.  Without it, PWMIOC_UPDATE restarts the
+   * output with the start method.
+   */
+
+  CODE int (*update)(FAR struct pwm_lowerhalf_s *dev,
+                     FAR const struct pwm_info_s *info);
 };
 
 /* This structure is the generic form of state structure used by lower half
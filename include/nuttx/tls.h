@@ -59,6 +59,14 @@
 #  define TLS_INFO(sp)     ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
 #endif
 
+/* The value of the thread pointer register of a thread: the address that
+ * follows its tls_info_s, where the TLS of the __thread variables starts
+ * (after the TCB that the ABI of ARM reserves there), see up_tls_size().
+ */
+
+#define TLS_THREAD_POINTER(tcb) \
+  ((uintptr_t)(tcb)->stack_alloc_ptr + sizeof(struct tls_info_s))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -212,6 +220,9 @@ struct tls_info_s
 #endif
 
   int tl_errno;                        /* Per-thread error number */
+#ifdef CONFIG_SEM_FASTPATH
+  pid_t tl_tid;                        /* Thread ID, for user-space owners */
+#endif
 };
 
 /****************************************************************************
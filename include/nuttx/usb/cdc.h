@@ -57,7 +57,8 @@
 #define CDC_SUBCLASS_CAPI       0x05 /* CAPI Control Model */
 #define CDC_SUBCLASS_ECM        0x06 /* Ethernet Networking Control Model */
 #define CDC_SUBCLASS_ATM        0x07 /* ATM Networking Control Model */
-                                     /* 0x08-0x0d Reserved (future use) */
+                                     /* 0x08-0x0c Reserved (future use) */
+#define CDC_SUBCLASS_NCM        0x0d /* Network Control Model */
 #define CDC_SUBCLASS_MBIM       0x0e /* MBIM Control Model */
                                      /* 0x0f-0x7f Reserved (future use) */
                                      /* 0x80-0xfe Reserved (vendor specific) */
@@ -84,8 +85,11 @@
 /* Table 19: Data Interface Class Protocol Codes */
 
 #define CDC_DATA_PROTO_NONE     0x00 /* No class specific protocol required */
-                                     /* 0x01-0x2f Reserved (future use) */
+#define CDC_DATA_PROTO_NCMNTB   0x01 /* Network Transfer Block protocol of
+                                      * NCM
+                                      */
 #define CDC_DATA_PROTO_NTB      0x02 /* Network Transfer Block protocol */
+                                     /* 0x03-0x2f Reserved (future use) */
 #define CDC_DATA_PROTO_ISDN     0x30 /* Physical interface protocol for ISDN BRI */
 #define CDC_DATA_PROTO_HDLC     0x31 /* HDLC */
 #define CDC_DATA_PROTO_TRANSP   0x32 /* Transparent */
@@ -328,6 +332,38 @@
                                       */
 #define ECM_SPEED_CHANGE        ATM_SPEED_CHANGE
 
+/* NCM 1.0 Table 6-2: Requests, Network Control Model.  NCM also
+ * uses the requests and notifications of the Ethernet Networking Control
+ * Model.
+ */
+
+#define NCM_GET_NTB_PARAMETERS  0x80 /* Returns the NTB data formats and
+                                      * sizes of the device (Required)
+                                      */
+#define NCM_GET_NET_ADDRESS     0x81 /* Returns the current EUI-48 station
+                                      * address (Optional)
+                                      */
+#define NCM_SET_NET_ADDRESS     0x82 /* Sets the EUI-48 station address
+                                      * (Optional)
+                                      */
+#define NCM_GET_NTB_FORMAT      0x83 /* Returns the NTB format in use
+                                      * (Optional)
+                                      */
+#define NCM_SET_NTB_FORMAT      0x84 /* Selects 16 or 32-bit NTBs
+                                      * (Optional)
+                                      */
+#define NCM_GET_NTB_INPUT_SIZE  0x85 /* Returns the maximum size of the
+                                      * IN NTBs (Required)
+                                      */
+#define NCM_SET_NTB_INPUT_SIZE  0x86 /* Selects the maximum size of the
+                                      * IN NTBs (Required)
+                                      */
+
+#define NCM_GET_MAX_DATAGRAM_SIZE 0x87 /* (Optional) */
+#define NCM_SET_MAX_DATAGRAM_SIZE 0x88 /* (Optional) */
+#define NCM_GET_CRC_MODE          0x89 /* (Optional) */
+#define NCM_SET_CRC_MODE          0x8a /* (Optional) */
+
 /* Descriptors ***************************************************************/
 
 /* Table 25: bDescriptor SubType in Functional Descriptors */
@@ -352,6 +388,7 @@
 #define CDC_DSUBTYPE_CAPI       0x0e /* CAPI Control Management Functional Descriptor */
 #define CDC_DSUBTYPE_ECM        0x0f /* Ethernet Networking Functional Descriptor */
 #define CDC_DSUBTYPE_ATM        0x10 /* ATM Networking Functional Descriptor */
+#define CDC_DSUBTYPE_NCM        0x1a /* NCM Functional Descriptor */
 #define CDC_DSUBTYPE_MBIM       0x1b /* MBIM Functional Descriptor */
                                      /* 0x11-0xff Reserved (future use) */
 
@@ -911,6 +948,28 @@ struct cdc_atm_funcdesc_s
 
 #define SIZEOF_ATM_FUNCDESC 12
 
+/* NCM 1.0 Table 5-2: NCM Functional Descriptor */
+
+struct cdc_ncm_funcdesc_s
+{
+  uint8_t size;       /* bFunctionLength, Size of this descriptor */
+  uint8_t type;       /* bDescriptorType, USB_DESC_TYPE_CSINTERFACE */
+  uint8_t subtype;    /* bDescriptorSubType, CDC_DSUBTYPE_NCM */
+  uint8_t version[2]; /* bcdNcmVersion, Release of the NCM specification */
+  uint8_t netcaps;    /* bmNetworkCapabilities, The optional requests that
+                       * the function supports.  See NCMCAP_* below.
+                       */
+};
+
+#define SIZEOF_NCM_FUNCDESC 6
+
+#define NCMCAP_PACKET_FILTER  (1 << 0) /* SetEthernetPacketFilter */
+#define NCMCAP_NET_ADDRESS    (1 << 1) /* Get/SetNetAddress */
+#define NCMCAP_ENCAPSULATED   (1 << 2) /* Encapsulated commands */
+#define NCMCAP_MAX_DATAGRAM   (1 << 3) /* Get/SetMaxDatagramSize */
+#define NCMCAP_CRC_MODE       (1 << 4) /* Get/SetCrcMode */
+#define NCMCAP_NTB_INPUT_8B   (1 << 5) /* 8-byte GetNtbInputSize */
+
 /* Descriptor Data Structures ************************************************/
 
 /* Table 50: Line Coding Structure */
@@ -967,6 +1026,68 @@ struct cdc_unitparm_s
 
 /* Table 61: Power Management Pattern Filter Structure */
 
+/* NCM 1.0 Table 6-3: NTB Parameter Structure */
+
+struct cdc_ncm_ntbparms_s
+{
+  uint8_t len[2];          /* wLength, Size of this structure, 28 */
+  uint8_t formats[2];      /* bmNtbFormatsSupported, Bit 0: 16-bit NTBs,
+                            * bit 1: 32-bit NTBs
+                            */
+  uint8_t inmaxsize[4];    /* dwNtbInMaxSize, The largest IN NTB */
+  uint8_t indivisor[2];    /* wNdpInDivisor, IN datagrams are aligned */
+  uint8_t inremain[2];     /* wNdpInPayloadRemainder, ... to this remainder of
+                            * the divisor
+                            */
+  uint8_t inalign[2];      /* wNdpInAlignment, Alignment of the IN NDPs */
+  uint8_t reserved[2];
+  uint8_t outmaxsize[4];   /* dwNtbOutMaxSize, The largest OUT NTB */
+  uint8_t outdivisor[2];   /* wNdpOutDivisor */
+  uint8_t outremain[2];    /* wNdpOutPayloadRemainder */
+  uint8_t outalign[2];     /* wNdpOutAlignment */
+  uint8_t outmaxdgrams[2]; /* wNtbOutMaxDatagrams, 0: no limit */
+};
+
+#define SIZEOF_NCM_NTBPARMS 28
+
+#define NCM_NTB_FORMAT_16 (1 << 0)
+#define NCM_NTB_FORMAT_32 (1 << 1)
+
+/* NCM 1.0 Tables 3-1 and 3-3: 16-bit NCM Transfer Header and Datagram
+ * Pointer.  A 16-bit NTB is an NTH16, the datagrams and one or more NDP16s,
+ * each a list of datagram index/length pairs ended by a zero pair.  All
+ * fields are little endian.
+ */
+
+struct cdc_ncm_nth16_s
+{
+  uint8_t sig[4];      /* dwSignature, NCM_NTH16_SIGNATURE */
+  uint8_t hdrlen[2];   /* wHeaderLength, SIZEOF_NCM_NTH16 */
+  uint8_t seq[2];      /* wSequence */
+  uint8_t blklen[2];   /* wBlockLength, Length of the NTB */
+  uint8_t ndpindex[2]; /* wNdpIndex, Offset of the first NDP16 */
+};
+
+#define SIZEOF_NCM_NTH16 12
+
+struct cdc_ncm_ndp16_s
+{
+  uint8_t sig[4];      /* dwSignature, NCM_NDP16_SIGNATURE */
+  uint8_t len[2];      /* wLength, Length of the NDP16 */
+  uint8_t nextndp[2];  /* wNextNdpIndex, Offset of the next NDP16 or 0 */
+};
+
+#define SIZEOF_NCM_NDP16(n) (8 + 4 * (n)) /* n pointers, with the zero pair */
+
+struct cdc_ncm_dpe16_s
+{
+  uint8_t index[2];    /* wDatagramIndex, Offset of the datagram */
+  uint8_t len[2];      /* wDatagramLength */
+};
+
+#define NCM_NTH16_SIGNATURE 0x484d434e /* "NCMH" */
+#define NCM_NDP16_SIGNATURE 0x304d434e /* "NCM0", without CRC */
+
 /* Notification Data Structures **********************************************/
 
 /* Table 72: ConnectionSpeedChange Data Structure */
@@ -39,14 +39,31 @@
 #define VIRTIO_VERSION  0x2    /* NOTE: Legacy devices used 0x1 */
 
 #define VIRTIO_DEV_NET  0x1
+#define VIRTIO_DEV_BLK  0x2
 
 #define VIRTIO_STATUS_ACKNOWLEDGE   (1)
 #define VIRTIO_STATUS_DRIVER        (2)
 #define VIRTIO_STATUS_DRIVER_OK     (4)
 #define VIRTIO_STATUS_FEATURES_OK   (8)
 
-#define VIRTQ_DESC_F_NEXT  1   /* marks a buffer as continuing */
-#define VIRTQ_DESC_F_WRITE 2   /* marks a buffer as device write-only */
+#define VIRTQ_DESC_F_NEXT     1 /* marks a buffer as continuing */
+#define VIRTQ_DESC_F_WRITE    2 /* marks a buffer as device write-only */
+#define VIRTQ_DESC_F_INDIRECT 4 /* buffer contains a descriptor table */
+
+#define VIRTQ_AVAIL_F_NO_INTERRUPT 1 /* driver does not want interrupts */
+#define VIRTQ_USED_F_NO_NOTIFY     1 /* device does not want notifications */
+
+/* Feature bits independent of the device type */
+
+#define VIRTIO_F_RING_INDIRECT_DESC 28 /* VIRTQ_DESC_F_INDIRECT */
+#define VIRTIO_F_RING_EVENT_IDX     29 /* used_event and avail_event */
+
+/* With VIRTIO_F_RING_EVENT_IDX, true if the index moving from 'old' to
+ * 'new' passed 'event', i.e. the other side asked to be told about it.
+ */
+
+#define virtq_need_event(event, new, old) \
+  ((uint16_t)((new) - (event) - 1) < (uint16_t)((new) - (old)))
 
 #define virtio_mb() SP_DMB()
 
@@ -133,7 +150,8 @@ struct virtqueue
   FAR struct virtqueue_desc *desc;
   FAR struct virtqueue_avail *avail;
   FAR struct virtqueue_used *used;
-  FAR uint16_t *avail_event;
+  FAR uint16_t *used_event;    /* Written by the driver, after avail ring */
+  FAR uint16_t *avail_event;   /* Written by the device, after used ring */
   FAR void **desc_virt;
 };
 
@@ -155,6 +173,9 @@ uint32_t virtq_alloc_desc(FAR struct virtqueue *virtq,
                           uint32_t id,
                           FAR void *addr);
 
+int virtio_mmio_negotiate(FAR struct virtio_mmio_regs *regs,
+                          FAR uint32_t *features);
+
 void virtq_add_to_mmio_device(FAR struct virtio_mmio_regs *regs,
                               FAR struct virtqueue *virtq,
                               uint32_t queue_sel);
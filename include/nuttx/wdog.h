@@ -76,6 +76,9 @@ struct wdog_s
   FAR void          *picbase;    /* PIC base address */
 #endif
   sclock_t           lag;        /* Timer associated with the delay */
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  FAR struct wdog_s *prev;       /* Back link within the wheel slot */
+#endif
 };
 
 /****************************************************************************
@@ -166,6 +169,26 @@ int wd_cancel(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_nexttime
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires, that is the latest time at which a timer will
+ *   wake up an idle system.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that a watchdog has already expired.  A negative value
+ *   means that no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nexttime(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
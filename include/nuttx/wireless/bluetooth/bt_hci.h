@@ -104,6 +104,8 @@
 /* LE features */
 
 #define BT_HCI_LE_ENCRYPTION     0x01
+#define BT_HCI_LE_DATA_LEN_EXT   0x20  /* le_features[0] */
+#define BT_HCI_LE_2M_PHY         0x01  /* le_features[1] */
 
 /* OpCode Group Fields */
 
@@ -175,6 +177,8 @@
 #define BT_HCI_OP_LE_START_ENCRYPTION         BT_OP(BT_OGF_LE, 0x0019)
 #define BT_HCI_OP_LE_LTK_REQ_REPLY            BT_OP(BT_OGF_LE, 0x001a)
 #define BT_HCI_OP_LE_LTK_REQ_NEG_REPLY        BT_OP(BT_OGF_LE, 0x001b)
+#define BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN   BT_OP(BT_OGF_LE, 0x0024)
+#define BT_HCI_OP_LE_SET_DEFAULT_PHY          BT_OP(BT_OGF_LE, 0x0031)
 
 /* Event definitions */
 
@@ -511,6 +515,27 @@ begin_packed_struct struct bt_hci_cp_le_ltk_req_neg_reply_s
   uint16_t handle;
 } end_packed_struct;
 
+/* The largest LE link layer payload and the time it takes on the 1M PHY */
+
+#define BT_HCI_LE_MAX_TX_OCTETS  251
+#define BT_HCI_LE_MAX_TX_TIME    2120
+
+begin_packed_struct struct bt_hci_cp_le_write_default_data_len_s
+{
+  uint16_t max_tx_octets;
+  uint16_t max_tx_time;
+} end_packed_struct;
+
+#define BT_HCI_LE_PHY_1M         0x01
+#define BT_HCI_LE_PHY_2M         0x02
+
+begin_packed_struct struct bt_hci_cp_le_set_default_phy_s
+{
+  uint8_t  all_phys;
+  uint8_t  tx_phys;
+  uint8_t  rx_phys;
+} end_packed_struct;
+
 /* Event definitions */
 
 begin_packed_struct struct bt_hci_evt_disconn_complete_s
@@ -165,6 +165,12 @@
 #    define CONFIG_SCHED_LPWORKSTACKSIZE CONFIG_IDLETHREAD_STACKSIZE
 #  endif
 
+#  ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+#    if CONFIG_SCHED_LPNTHREADS_MAX < CONFIG_SCHED_LPNTHREADS
+#      error CONFIG_SCHED_LPNTHREADS_MAX < CONFIG_SCHED_LPNTHREADS
+#    endif
+#  endif
+
 #  ifdef CONFIG_WORK_HPWORK
   /* The high priority worker thread should be higher priority than the low
    * priority worker thread.
@@ -201,6 +207,11 @@
  *     used for any purpose.  if CONFIG_SCHED_LPWORK is not defined, then
  *     there is only one kernel work queue and LPWORK == HPWORK.
  *
+ *   HPWORK_CPU(n): The ID of the high priority work queue of CPU n.  Work
+ *     queued there is performed by a worker thread bound to that CPU.  If
+ *     CONFIG_SCHED_HPWORK_PERCPU is not defined, this is the same as
+ *     HPWORK.
+ *
  * User Work Queue:
  *   USRWORK:  In the kernel phase a a kernel build, there should be no
  *     references to user-space work queues.  That would be an error.
@@ -214,6 +225,7 @@
 #  define USRWORK  2          /* User mode work queue */
 #  define HPWORK   USRWORK    /* Redirect kernel-mode references */
 #  define LPWORK   USRWORK
+#  define HPWORK_CPU(n) USRWORK
 
 #else
 /* Kernel mode */
@@ -225,6 +237,12 @@
 #    define LPWORK HPWORK     /* Redirect low-priority references */
 #  endif
 #  define USRWORK  LPWORK     /* Redirect user-mode references */
+#  ifdef CONFIG_SCHED_HPWORK_PERCPU
+#    define HPWORK_CPU0 4     /* First per-CPU, high priority work queue */
+#    define HPWORK_CPU(n) (HPWORK_CPU0 + (n))
+#  else
+#    define HPWORK_CPU(n) HPWORK
+#  endif
 
 #endif /* CONFIG_LIBC_USRWORK && !__KERNEL__ */
 
@@ -256,6 +274,9 @@ struct work_s
   } u;
   worker_t  worker;         /* Work callback */
   FAR void *arg;            /* Callback argument */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  FAR void *wq;             /* Target queue of delayed, per-CPU work */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -345,6 +366,10 @@ int work_usrstart(void);
  *   previous work has been performed and removed from the queue, then any
  *   pending work will be canceled and lost.
  *
+ *   With CONFIG_WQUEUE_COALESCE, a call without delay for work that is
+ *   still waiting in the queue with the same worker and argument is a
+ *   no-op: the pending entry keeps its place and runs once.
+ *
  * Input Parameters:
  *   qid    - The work queue ID
  *   work   - The work structure to queue
@@ -45,6 +45,7 @@
 #define SCHED_RR                  2  /* Round robin scheduling policy */
 #define SCHED_SPORADIC            3  /* Sporadic scheduling policy */
 #define SCHED_OTHER               4  /* Not supported */
+#define SCHED_DEADLINE            5  /* Deadline (EDF) scheduling policy */
 
 /* Maximum number of SCHED_SPORADIC replenishments */
 
@@ -196,6 +197,13 @@ struct sched_param
   int sched_ss_max_repl;                /* Maximum pending replenishments for
                                          * sporadic server. */
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  struct timespec sched_dl_runtime;     /* Execution budget of each job */
+  struct timespec sched_dl_deadline;    /* Relative deadline of each job */
+  struct timespec sched_dl_period;      /* Period of the jobs, zero for the
+                                         * relative deadline */
+#endif
 };
 
 /********************************************************************************
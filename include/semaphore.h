@@ -66,28 +66,33 @@ struct semholder_s
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *flink;  /* List of semaphore's holder            */
+  FAR struct semholder_s *blink;  /* Back link in the semaphore's list     */
 #endif
   FAR struct semholder_s *tlink;  /* List of task held semaphores          */
+  FAR struct semholder_s *tblink; /* Back link in the task's list          */
   FAR struct sem_s *sem;          /* Ths corresponding semaphore           */
   FAR struct tcb_s *htcb;         /* Ths corresponding TCB                 */
   int16_t counts;                 /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, NULL, NULL, NULL, 0}
 #  define INITIALIZE_SEMHOLDER(h) \
     do { \
       (h)->flink  = NULL; \
+      (h)->blink  = NULL; \
       (h)->tlink  = NULL; \
+      (h)->tblink = NULL; \
       (h)->sem    = NULL; \
       (h)->htcb   = NULL; \
       (h)->counts = 0; \
     } while (0)
 #else
-#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, NULL, 0}
 #  define INITIALIZE_SEMHOLDER(h) \
     do { \
       (h)->tlink  = NULL; \
+      (h)->tblink = NULL; \
       (h)->sem    = NULL; \
       (h)->htcb   = NULL; \
       (h)->counts = 0; \
@@ -117,6 +122,13 @@ struct sem_s
 # else
   struct semholder_s holder[2];  /* Slot for old and new holder */
 # endif
+#endif
+
+  /* Statistics of adaptive mutexes, for tuning MUTEX_ADAPTIVE_SPIN */
+
+#ifdef CONFIG_MUTEX_ADAPTIVE
+  uint32_t nspins;               /* Takes that succeeded by spinning */
+  uint32_t nblocks;              /* Takes that had to block */
 #endif
 };
 
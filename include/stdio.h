@@ -178,6 +178,16 @@ void flockfile(FAR FILE *stream);
 int ftrylockfile(FAR FILE *stream);
 void funlockfile(FAR FILE *stream);
 
+/* Variants of the operations above for a stream that the caller has
+ * already locked with flockfile()
+ */
+
+int    fputc_unlocked(int c, FAR FILE *stream);
+size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
+         FAR FILE *stream);
+int    putc_unlocked(int c, FAR FILE *stream);
+int    putchar_unlocked(int c);
+
 /* Operations on the stdout stream, buffers, paths,
  * and the whole printf-family
  */
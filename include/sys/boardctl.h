@@ -79,7 +79,10 @@
  * DEPENDENCIES:  Board logic must provide the board_reset() interface.
  *
  * CMD:           BOARDIOC_PM_CONTROL
- * DESCRIPTION:   Manage power state transition and query
+ * DESCRIPTION:   Manage power state transition and query.  The
+ *                BOARDIOC_PM_QOS action sets the wakeup latency, in
+ *                microseconds in the count field, that applications
+ *                tolerate in the domain; UINT32_MAX removes it.
  * ARG:           A pointer to an instance of struct boardioc_pm_ctrl_s
  * CONFIGURATION: CONFIG_PM
  * DEPENDENCIES:  None
@@ -236,7 +239,8 @@ enum boardioc_action_e
   BOARDIOC_PM_STAYCOUNT,
   BOARDIOC_PM_QUERYSTATE,
   BOARDIOC_PM_CHANGESTATE,
-  BOARDIOC_PM_CHECKSTATE
+  BOARDIOC_PM_CHECKSTATE,
+  BOARDIOC_PM_QOS
 };
 
 struct boardioc_pm_ctrl_s
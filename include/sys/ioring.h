@@ -0,0 +1,167 @@
+/****************************************************************************
+ * include/sys/ioring.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IORING_H
+#define __INCLUDE_SYS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Submission queue entry opcodes */
+
+#define IORING_OP_NOP      0  /* Complete at once with res = 0 */
+#define IORING_OP_READ     1  /* read()/pread() into addr, len */
+#define IORING_OP_WRITE    2  /* write()/pwrite() from addr, len */
+#define IORING_OP_FSYNC    3  /* fsync() */
+#define IORING_OP_SENDMSG  4  /* sendmsg() of the msghdr at addr */
+#define IORING_OP_RECVMSG  5  /* recvmsg() into the msghdr at addr */
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* One submission queue entry.  For IORING_OP_READ and IORING_OP_WRITE, an
+ * off of -1 uses (and advances) the file position, any other value is an
+ * absolute offset.  For IORING_OP_SENDMSG and IORING_OP_RECVMSG, addr
+ * points to a struct msghdr and msg_flags holds the MSG_* flags.  The
+ * memory referenced by addr must stay valid until the completion is
+ * reported.
+ */
+
+struct io_ring_sqe
+{
+  uint8_t       opcode;     /* IORING_OP_* */
+  uint8_t       flags;      /* Reserved, must be zero */
+  int16_t       reserved;
+  int           fd;         /* File or socket descriptor */
+  off_t         off;        /* File offset or -1 */
+  FAR void     *addr;       /* Buffer or struct msghdr */
+  size_t        len;        /* Buffer length */
+  int           msg_flags;  /* MSG_* flags of SENDMSG/RECVMSG */
+  uintptr_t     user_data;  /* Returned unchanged in the completion */
+};
+
+/* One completion queue entry */
+
+struct io_ring_cqe
+{
+  uintptr_t     user_data;  /* user_data of the submission */
+  ssize_t       res;        /* Result of the operation or negated errno */
+};
+
+/* The rings shared between the application and the kernel.  The structure
+ * lives in application memory; io_ring_setup() fills it in and it must
+ * stay valid until the ring descriptor is closed.
+ *
+ * The application fills sqes[sq_tail & sq_mask] and then increments
+ * sq_tail.  io_ring_enter() consumes the entries up to sq_tail and
+ * advances sq_head.  The kernel writes completions in cqes[cq_tail &
+ * cq_mask] and increments cq_tail; the application harvests the entries
+ * from cq_head and increments cq_head.  The indices run freely and wrap
+ * at 2^32.  The ring descriptor polls readable (POLLIN) while completions
+ * wait to be harvested.
+ */
+
+struct io_ring_s
+{
+  /* Submission queue */
+
+  volatile uint32_t sq_head;        /* Advanced by the kernel */
+  volatile uint32_t sq_tail;        /* Advanced by the application */
+  uint32_t          sq_mask;        /* Number of entries - 1 */
+  FAR struct io_ring_sqe *sqes;
+
+  /* Completion queue */
+
+  volatile uint32_t cq_head;        /* Advanced by the application */
+  volatile uint32_t cq_tail;        /* Advanced by the kernel */
+  uint32_t          cq_mask;        /* Number of entries - 1 */
+  FAR struct io_ring_cqe *cqes;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: io_ring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring pair.  The number of submission
+ *   entries is rounded up to a power of two; the completion queue has
+ *   twice as many entries.
+ *
+ * Input Parameters:
+ *   entries - The requested number of submission queue entries
+ *   ring    - The ring structure to be initialized
+ *
+ * Returned Value:
+ *   A file descriptor that refers to the ring on success.  Otherwise, -1
+ *   is returned and the errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int io_ring_setup(unsigned int entries, FAR struct io_ring_s *ring);
+
+/****************************************************************************
+ * Name: io_ring_enter
+ *
+ * Description:
+ *   Submit up to to_submit entries from the submission queue and then wait
+ *   until at least min_complete completions are waiting in the completion
+ *   queue.
+ *
+ * Input Parameters:
+ *   fd           - The descriptor returned by io_ring_setup()
+ *   to_submit    - The maximum number of entries to submit
+ *   min_complete - The number of completions to wait for
+ *
+ * Returned Value:
+ *   The number of entries submitted.  Otherwise, -1 is returned and the
+ *   errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int io_ring_enter(int fd, unsigned int to_submit, unsigned int min_complete);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_IORING_H */
@@ -0,0 +1,93 @@
+/****************************************************************************
+ * include/sys/signalfd.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_SIGNALFD_H
+#define __INCLUDE_SYS_SIGNALFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <signal.h>
+#include <fcntl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SFD_NONBLOCK  O_NONBLOCK
+#define SFD_CLOEXEC   O_CLOEXEC
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* A read() of a signalfd returns one of these per consumed signal.  The
+ * layout is the one of Linux; the fields that NuttX does not know about
+ * are zero.
+ */
+
+struct signalfd_siginfo
+{
+  uint32_t ssi_signo;       /* Signal number */
+  int32_t  ssi_errno;       /* Error number (unused) */
+  int32_t  ssi_code;        /* Signal code */
+  uint32_t ssi_pid;         /* PID of sender */
+  uint32_t ssi_uid;         /* Real UID of sender */
+  int32_t  ssi_fd;          /* File descriptor (SIGIO) */
+  uint32_t ssi_tid;         /* Kernel timer ID (POSIX timers) */
+  uint32_t ssi_band;        /* Band event (SIGIO) */
+  uint32_t ssi_overrun;     /* POSIX timer overrun count */
+  uint32_t ssi_trapno;      /* Trap number that caused signal */
+  int32_t  ssi_status;      /* Exit status or signal (SIGCHLD) */
+  int32_t  ssi_int;         /* Integer sent by sigqueue() */
+  uint64_t ssi_ptr;         /* Pointer sent by sigqueue() */
+  uint64_t ssi_utime;       /* User CPU time consumed (SIGCHLD) */
+  uint64_t ssi_stime;       /* System CPU time consumed (SIGCHLD) */
+  uint64_t ssi_addr;        /* Address that generated signal */
+  uint16_t ssi_addr_lsb;    /* Least significant bit of address */
+  uint16_t __pad2;
+  int32_t  ssi_syscall;     /* System call number */
+  uint64_t ssi_call_addr;   /* Address of system call instruction */
+  uint32_t ssi_arch;        /* Architecture of system call */
+  uint8_t  __pad[28];       /* Pad size to 128 bytes */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+int signalfd(int fd, FAR const sigset_t *mask, int flags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_SIGNALFD_H */
@@ -125,6 +125,10 @@
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
 
+/* Wait only for the first message (recvmmsg()).  */
+
+#define MSG_WAITFORONE 0x10000
+
 /* Protocol levels supported by get/setsockopt(): */
 
 #define SOL_SOCKET       1 /* Only socket-level options supported */
@@ -205,6 +209,16 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow sockets to share a local port, balancing
+                            * incoming flows among them (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_TIMESTAMPING 20 /* Time stamps incoming and outgoing packets
+                            * (get/set).
+                            * arg: integer SOF_TIMESTAMPING_* flags, see
+                            * include/net/net_tstamp.h
+                            */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -279,6 +293,10 @@
 #define SCM_CREDENTIALS 0x02    /* rw: struct ucred */
 #define SCM_SECURITY    0x03    /* rw: security label */
 
+/* r: struct scm_timestamping */
+
+#define SCM_TIMESTAMPING SO_TIMESTAMPING
+
 /****************************************************************************
  * Type Definitions
  ****************************************************************************/
@@ -326,6 +344,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* Used with recvmmsg() and sendmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* The message */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -410,6 +436,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
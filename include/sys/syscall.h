@@ -29,6 +29,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <stdbool.h>
 #  include <stdint.h>
 #endif
 
@@ -65,6 +66,26 @@ enum
 #  undef SYSCALL_LOOKUP
 };
 
+/* The stubs of g_stublookup[] take the call number and up to six
+ * parameters.  The parameters beyond those of a call are ignored.
+ */
+
+typedef CODE uintptr_t (*syscall_stub_t)(int nbr, uintptr_t parm1,
+                                         uintptr_t parm2, uintptr_t parm3,
+                                         uintptr_t parm4, uintptr_t parm5,
+                                         uintptr_t parm6);
+
+/* One call of syscall_batch() */
+
+#ifdef CONFIG_SYSCALL_BATCH
+struct syscall_batch_s
+{
+  unsigned int nbr;           /* The SYS_ number of the call */
+  uintptr_t parm[6];          /* Its parameters */
+  uintptr_t result;           /* Its return value */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -99,6 +120,50 @@ EXTERN const char *g_funcnames[SYS_nsyscalls];
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: syscall_isleaf
+ *
+ * Description:
+ *   Return true if the system call never blocks nor switches the context,
+ *   so that the system call exception handler can run it itself.
+ *
+ *   This function is only available during the kernel phase of a kernel
+ *   build.
+ *
+ * Input Parameters:
+ *   nbr - The SYS_ number of the call
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_LEAF
+bool syscall_isleaf(unsigned int nbr);
+#endif
+
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Make a vector of system calls in a single trap.  The calls are made in
+ *   order and the return value of each one is stored in its result field.
+ *   A call that fails does not stop the batch.
+ *
+ * Input Parameters:
+ *   calls  - The calls
+ *   ncalls - The number of calls
+ *
+ * Returned Value:
+ *   The number of calls made, which is less than ncalls if the batch
+ *   stopped at an invalid call number.  -1 (ERROR) with errno set to
+ *   ENOSYS if the first call number is invalid, or to EINVAL without
+ *   making any call if the batch holds a call that may not return, as
+ *   _exit(), vfork() or execve().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSCALL_BATCH
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -57,6 +57,10 @@ SYSCALL_LOOKUP(nxsched_get_stackinfo,      2)
 
 SYSCALL_LOOKUP(sysinfo,                    1)
 
+#ifdef CONFIG_SYSCALL_BATCH
+  SYSCALL_LOOKUP(syscall_batch,            2)
+#endif
+
 SYSCALL_LOOKUP(gethostname,                2)
 SYSCALL_LOOKUP(sethostname,                2)
 
@@ -72,11 +76,18 @@ SYSCALL_LOOKUP(sethostname,                2)
 /* Semaphores */
 
 SYSCALL_LOOKUP(sem_destroy,                1)
-SYSCALL_LOOKUP(sem_post,                   1)
 SYSCALL_LOOKUP(sem_clockwait,              3)
 SYSCALL_LOOKUP(sem_timedwait,              2)
-SYSCALL_LOOKUP(sem_trywait,                1)
-SYSCALL_LOOKUP(sem_wait,                   1)
+
+#ifdef CONFIG_SEM_FASTPATH
+  SYSCALL_LOOKUP(nx_sem_post,              1)
+  SYSCALL_LOOKUP(nx_sem_trywait,           1)
+  SYSCALL_LOOKUP(nx_sem_wait,              1)
+#else
+  SYSCALL_LOOKUP(sem_post,                 1)
+  SYSCALL_LOOKUP(sem_trywait,              1)
+  SYSCALL_LOOKUP(sem_wait,                 1)
+#endif
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
   SYSCALL_LOOKUP(sem_setprotocol,          2)
@@ -168,7 +179,12 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
 
 SYSCALL_LOOKUP(clock,                      0)
 SYSCALL_LOOKUP(clock_getres,               2)
-SYSCALL_LOOKUP(clock_gettime,              2)
+#ifdef CONFIG_CLOCK_TIMEPAGE
+  SYSCALL_LOOKUP(nx_clock_gettime,         2)
+  SYSCALL_LOOKUP(clock_timepage,           0)
+#else
+  SYSCALL_LOOKUP(clock_gettime,            2)
+#endif
 SYSCALL_LOOKUP(clock_settime,              2)
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   SYSCALL_LOOKUP(adjtime,                  2)
@@ -205,6 +221,10 @@ SYSCALL_LOOKUP(pwrite,                     4)
   SYSCALL_LOOKUP(aio_write,                1)
   SYSCALL_LOOKUP(aio_fsync,                2)
   SYSCALL_LOOKUP(aio_cancel,               2)
+#endif
+#ifdef CONFIG_FS_AIO_RING
+  SYSCALL_LOOKUP(io_ring_setup,            2)
+  SYSCALL_LOOKUP(io_ring_enter,            3)
 #endif
   SYSCALL_LOOKUP(poll,                     3)
   SYSCALL_LOOKUP(select,                   5)
@@ -218,6 +238,9 @@ SYSCALL_LOOKUP(pwrite,                     4)
   SYSCALL_LOOKUP(timerfd_settime,          4)
   SYSCALL_LOOKUP(timerfd_gettime,          2)
 #endif
+#ifdef CONFIG_SIGNAL_FD
+  SYSCALL_LOOKUP(signalfd,                 3)
+#endif
 
 /* Board support */
 
@@ -239,6 +262,8 @@ SYSCALL_LOOKUP(fstat,                      2)
 SYSCALL_LOOKUP(statfs,                     2)
 SYSCALL_LOOKUP(fstatfs,                    2)
 SYSCALL_LOOKUP(sendfile,                   4)
+SYSCALL_LOOKUP(splice,                     6)
+SYSCALL_LOOKUP(tee,                        4)
 SYSCALL_LOOKUP(chmod,                      2)
 SYSCALL_LOOKUP(lchmod,                     2)
 SYSCALL_LOOKUP(fchmod,                     2)
@@ -253,6 +278,11 @@ SYSCALL_LOOKUP(futimens,                   2)
   SYSCALL_LOOKUP(munmap,                   2)
 #endif
 
+#if defined(CONFIG_FS_SHM)
+  SYSCALL_LOOKUP(shm_open,                 3)
+  SYSCALL_LOOKUP(shm_unlink,               1)
+#endif
+
 #if defined(CONFIG_PSEUDOFS_SOFTLINKS)
   SYSCALL_LOOKUP(symlink,                  2)
   SYSCALL_LOOKUP(readlink,                 3)
@@ -307,7 +337,11 @@ SYSCALL_LOOKUP(futimens,                   2)
   SYSCALL_LOOKUP(pthread_mutex_init,       2)
   SYSCALL_LOOKUP(pthread_mutex_timedlock,  2)
   SYSCALL_LOOKUP(pthread_mutex_trylock,    1)
+#if defined(CONFIG_SEM_FASTPATH) && defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
+  SYSCALL_LOOKUP(nx_pthread_mutex_unlock,  1)
+#else
   SYSCALL_LOOKUP(pthread_mutex_unlock,     1)
+#endif
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
   SYSCALL_LOOKUP(pthread_mutex_consistent, 1)
 #endif
@@ -361,9 +395,11 @@ SYSCALL_LOOKUP(futimens,                   2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(socket,                   3)
   SYSCALL_LOOKUP(socketpair,               4)
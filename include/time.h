@@ -77,6 +77,18 @@
 
 #define CLOCK_BOOTTIME     2
 
+/* The CPU time consumed by the calling thread */
+
+#ifdef CONFIG_SCHED_CPUTIME
+#  define CLOCK_THREAD_CPUTIME_ID 3
+#endif
+
+/* The PTP hardware clock of the network, see ptp_clock_register() */
+
+#ifdef CONFIG_PTP_CLOCK
+#  define CLOCK_PTP        4
+#endif
+
 /* This is a flag that may be passed to the timer_settime() and
  * clock_nanosleep() functions.
  */
@@ -40,6 +40,16 @@
 
 #if defined(CONFIG_AUDIO)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_DMAMEMORY
+#  define APB_DMA_HDRSIZE \
+     ((sizeof(struct ap_buffer_s) + CONFIG_AUDIO_DMAMEMORY_ALIGN - 1) & \
+      ~(CONFIG_AUDIO_DMAMEMORY_ALIGN - 1))
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -61,10 +71,20 @@ int apb_alloc(FAR struct audio_buf_desc_s *bufdesc)
 
   DEBUGASSERT(bufdesc->u.pbuffer != NULL);
 
+#ifdef CONFIG_AUDIO_DMAMEMORY
+  /* Allocate from DMA-capable memory, the samples on their own cache
+   * lines, so that the lower half can hand the samples to its DMA as they
+   * are.
+   */
+
+  bufsize = APB_DMA_HDRSIZE + bufdesc->numbytes;
+  apb = audio_dma_alloc(bufsize);
+#else
   /* Perform a user mode allocation */
 
   bufsize = sizeof(struct ap_buffer_s) + bufdesc->numbytes;
   apb = lib_umalloc(bufsize);
+#endif
   *bufdesc->u.pbuffer = apb;
 
   /* Test if the allocation was successful or not */
@@ -82,8 +102,13 @@ int apb_alloc(FAR struct audio_buf_desc_s *bufdesc)
       apb->crefs      = 1;
       apb->nmaxbytes  = bufdesc->numbytes;
       apb->nbytes     = 0;
+#ifdef CONFIG_AUDIO_DMAMEMORY
+      apb->flags      = AUDIO_APB_DMA;
+      apb->samp       = (FAR uint8_t *)apb + APB_DMA_HDRSIZE;
+#else
       apb->flags      = 0;
       apb->samp       = (FAR uint8_t *)(apb + 1);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
       apb->session    = bufdesc->session;
 #endif
@@ -116,7 +141,11 @@ void apb_free(FAR struct ap_buffer_s *apb)
     {
       audinfo("Freeing %p\n", apb);
       nxmutex_destroy(&apb->lock);
+#ifdef CONFIG_AUDIO_DMAMEMORY
+      audio_dma_free(apb);
+#else
       lib_ufree(apb);
+#endif
     }
 }
 
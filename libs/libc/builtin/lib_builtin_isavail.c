@@ -25,10 +25,182 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <stdint.h>
 #include <limits.h>
 #include <errno.h>
 
 #include <nuttx/lib/builtin.h>
+#include <nuttx/mutex.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILTIN_HASH
+
+/* The index of the table of builtin applications by name, built on the
+ * first lookup.  It is open addressed with linear probing, each slot
+ * holding an index plus one, or zero if it is free.
+ */
+
+struct builtin_hash_s
+{
+  FAR const struct builtin_s *list; /* The table that was indexed */
+  int      count;                   /* And its number of entries */
+  uint32_t mask;                    /* The number of slots minus one */
+  FAR uint16_t *slots;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_builtin_lock = NXMUTEX_INITIALIZER;
+static struct builtin_hash_s g_builtin_hash;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: builtin_hashname
+ *
+ * Description:
+ *   The FNV-1a hash of a name.
+ *
+ ****************************************************************************/
+
+static uint32_t builtin_hashname(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: builtin_buildhash
+ *
+ * Description:
+ *   Index the current table of builtin applications, whose entries are
+ *   at most half of the slots.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, or -ENOMEM.
+ *
+ ****************************************************************************/
+
+static int builtin_buildhash(FAR struct builtin_hash_s *hash)
+{
+  FAR const char *name;
+  FAR uint16_t *slots;
+  uint32_t nslots = 4;
+  uint32_t slot;
+  int i;
+
+  if (g_builtin_count >= UINT16_MAX)
+    {
+      return -ENOMEM;
+    }
+
+  while (nslots < 2 * (uint32_t)g_builtin_count)
+    {
+      nslots <<= 1;
+    }
+
+  slots = lib_zalloc(nslots * sizeof(uint16_t));
+  if (slots == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; (name = builtin_getname(i)) != NULL; i++)
+    {
+      /* Keep the first of the entries of the same name, as the lookup by
+       * scan did.
+       */
+
+      for (slot = builtin_hashname(name) & (nslots - 1); slots[slot] != 0;
+           slot = (slot + 1) & (nslots - 1))
+        {
+          if (strcmp(builtin_getname(slots[slot] - 1), name) == 0)
+            {
+              break;
+            }
+        }
+
+      if (slots[slot] == 0)
+        {
+          slots[slot] = i + 1;
+        }
+    }
+
+  lib_free(hash->slots);
+  hash->list  = g_builtins;
+  hash->count = g_builtin_count;
+  hash->mask  = nslots - 1;
+  hash->slots = slots;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: builtin_lookup
+ *
+ * Description:
+ *   Look up a name in the index, rebuilding it if the table changed.
+ *
+ * Returned Value:
+ *   The index of the application, -ENOENT if there is none of this name,
+ *   or -ENOMEM if the index could not be built.
+ *
+ ****************************************************************************/
+
+static int builtin_lookup(FAR const char *appname)
+{
+  FAR struct builtin_hash_s *hash = &g_builtin_hash;
+  uint32_t slot;
+  int ret;
+
+  ret = nxmutex_lock(&g_builtin_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (hash->slots == NULL || hash->list != g_builtins ||
+      hash->count != g_builtin_count)
+    {
+      ret = builtin_buildhash(hash);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  ret = -ENOENT;
+  for (slot = builtin_hashname(appname) & hash->mask;
+       hash->slots[slot] != 0; slot = (slot + 1) & hash->mask)
+    {
+      if (strcmp(builtin_getname(hash->slots[slot] - 1), appname) == 0)
+        {
+          ret = hash->slots[slot] - 1;
+          break;
+        }
+    }
+
+out:
+  nxmutex_unlock(&g_builtin_lock);
+  return ret;
+}
+
+#endif /* CONFIG_BUILTIN_HASH */
 
 /****************************************************************************
  * Public Functions
@@ -58,6 +230,17 @@ int builtin_isavail(FAR const char *appname)
   FAR const char *name;
   int i;
 
+#ifdef CONFIG_BUILTIN_HASH
+  i = builtin_lookup(appname);
+  if (i != -ENOMEM)
+    {
+      return i;
+    }
+
+  /* Look the name up by scanning the table if it cannot be indexed */
+
+#endif
+
   for (i = 0; (name = builtin_getname(i)) != NULL; i++)
     {
       if (strcmp(name, appname) == 0)
@@ -84,8 +84,7 @@ static inline FAR const void *dlgetsym(FAR void *handle,
 
   /* Search the symbol table for the matching symbol */
 
-  symbol = symtab_findbyname(modp->modinfo.exports, name,
-                             modp->modinfo.nexports);
+  symbol = modlib_findexport(modp, name);
   if (symbol == NULL)
     {
       serr("ERROR: Failed to find symbol in symbol \"%s\" in table\n", name);
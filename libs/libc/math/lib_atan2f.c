@@ -31,12 +31,25 @@
 
 #include <math.h>
 
+#ifdef CONFIG_LIBM_CORDIC
+#  include <nuttx/math/cordic.h>
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float atan2f(float y, float x)
 {
+#ifdef CONFIG_LIBM_CORDIC
+  float phase;
+
+  if (cordic_atan2f(y, x, &phase) >= 0)
+    {
+      return phase;
+    }
+#endif
+
   if (x > 0)
     {
       return atanf(y / x);
@@ -31,11 +31,24 @@
 
 #include <math.h>
 
+#ifdef CONFIG_LIBM_CORDIC
+#  include <nuttx/math/cordic.h>
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 float cosf(float x)
 {
+#ifdef CONFIG_LIBM_CORDIC
+  float cos_x;
+
+  if (cordic_sincosf(x, NULL, &cos_x) >= 0)
+    {
+      return cos_x;
+    }
+#endif
+
   return sinf(x + M_PI_2_F);
 }
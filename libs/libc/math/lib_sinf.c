@@ -32,6 +32,10 @@
 #include <sys/types.h>
 #include <math.h>
 
+#ifdef CONFIG_LIBM_CORDIC
+#  include <nuttx/math/cordic.h>
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -56,6 +60,13 @@ float sinf(float x)
   float sin_x;
   size_t i;
 
+#ifdef CONFIG_LIBM_CORDIC
+  if (cordic_sincosf(x, &sin_x, NULL) >= 0)
+    {
+      return sin_x;
+    }
+#endif
+
   /* Move x to [-pi, pi) */
 
   x = fmodf(x, 2 * M_PI_F);
@@ -22,8 +22,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/random.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 #include <nuttx/fs/fs.h>
@@ -65,6 +68,18 @@ ssize_t getrandom(FAR void *bytes, size_t nbytes, unsigned int flags)
   int fd;
   ssize_t ret;
 
+#ifdef CONFIG_DEV_URANDOM_RANDOM_POOL
+  /* /dev/urandom would serve the request from arc4random_buf(): Call it
+   * directly, without the open(), read() and close() of the device.
+   */
+
+  if ((flags & GRND_RANDOM) == 0)
+    {
+      arc4random_buf(bytes, nbytes);
+      return nbytes;
+    }
+#endif
+
   if ((flags & GRND_NONBLOCK) != 0)
     {
       oflags |= O_NONBLOCK;
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 
 #include <stdint.h>
@@ -33,6 +34,7 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/lib/modlib.h>
 
 #include "modlib/modlib.h"
@@ -153,6 +155,16 @@ int modlib_initialize(FAR const char *filename,
       return -errval;
     }
 
+#ifdef CONFIG_MODLIB_XIP
+  /* Can the file be accessed in place? */
+
+  if (ioctl(loadinfo->filfd, FIOC_MMAP,
+            (unsigned long)((uintptr_t)&loadinfo->xipbase)) < 0)
+    {
+      loadinfo->xipbase = 0;
+    }
+#endif
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = modlib_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr,
@@ -26,6 +26,7 @@
 
 #include <sys/types.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,6 +64,48 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: modlib_inplace
+ *
+ * Description:
+ *   Return true if a section of a memory-mapped file is used in place:
+ *   it is read-only, at an address with its alignment and nothing has to
+ *   be relocated in it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MODLIB_XIP
+static bool modlib_inplace(FAR struct mod_loadinfo_s *loadinfo, int idx)
+{
+  FAR Elf_Shdr *shdr = &loadinfo->shdr[idx];
+  int i;
+
+  if (loadinfo->xipbase == 0 ||
+      (shdr->sh_flags & SHF_WRITE) != 0 ||
+      shdr->sh_type == SHT_NOBITS ||
+      shdr->sh_offset + shdr->sh_size > loadinfo->filelen ||
+      (shdr->sh_addralign > 1 &&
+       (loadinfo->xipbase + shdr->sh_offset) % shdr->sh_addralign != 0))
+    {
+      return false;
+    }
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      if ((loadinfo->shdr[i].sh_type == SHT_REL ||
+           loadinfo->shdr[i].sh_type == SHT_RELA) &&
+          loadinfo->shdr[i].sh_info == idx)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define modlib_inplace(l,i) false
+#endif /* CONFIG_MODLIB_XIP */
+
 /****************************************************************************
  * Name: modlib_elfsize
  *
@@ -109,7 +152,7 @@ static void modlib_elfsize(struct mod_loadinfo_s *loadinfo)
                   loadinfo->dataalign = shdr->sh_addralign;
                 }
             }
-          else
+          else if (!modlib_inplace(loadinfo, i))
             {
               textsize = _ALIGN_UP(textsize, shdr->sh_addralign);
               textsize += ELF_ALIGNUP(shdr->sh_size);
@@ -180,6 +223,27 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
           pptr = &text;
         }
 
+#ifdef CONFIG_MODLIB_XIP
+      /* Read-only sections of a memory-mapped file may stay where they
+       * are.
+       */
+
+      if (modlib_inplace(loadinfo, i))
+        {
+          binfo("%d. %08lx->%08lx in place\n", i,
+                (unsigned long)shdr->sh_addr,
+                (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+
+          shdr->sh_addr = loadinfo->xipbase + shdr->sh_offset;
+          if (loadinfo->textstart == 0)
+            {
+              loadinfo->textstart = shdr->sh_addr;
+            }
+
+          continue;
+        }
+#endif
+
       *pptr = (FAR uint8_t *)_ALIGN_UP((uintptr_t)*pptr, shdr->sh_addralign);
 
       /* SHT_NOBITS indicates that there is no data in the file for the
@@ -213,6 +277,10 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
             (unsigned long)shdr->sh_addr, (unsigned long)*pptr);
 
       shdr->sh_addr = (uintptr_t)*pptr;
+      if (pptr == &text && loadinfo->textstart == 0)
+        {
+          loadinfo->textstart = shdr->sh_addr;
+        }
 
       /* Setup the memory pointer for the next time through the loop */
 
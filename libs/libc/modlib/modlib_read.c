@@ -95,6 +95,25 @@ int modlib_read(FAR struct mod_loadinfo_s *loadinfo, FAR uint8_t *buffer,
 
   binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
 
+#ifdef CONFIG_MODLIB_XIP
+  /* A file mapped in memory is simply copied */
+
+  if (loadinfo->xipbase != 0)
+    {
+      if (offset < 0 || offset > loadinfo->filelen ||
+          readsize > loadinfo->filelen - offset)
+        {
+          berr("ERROR: Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, (FAR const uint8_t *)loadinfo->xipbase + offset,
+             readsize);
+      modlib_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+#endif
+
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
@@ -157,6 +157,11 @@ int modlib_registry_del(FAR struct module_s *modp)
     }
 
   modp->flink = NULL;
+
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hashuninit(&modp->exphash);
+#endif
+
   return OK;
 }
 
@@ -268,3 +273,47 @@ int modlib_registry_foreach(mod_callback_t callback, FAR void *arg)
   modlib_registry_unlock();
   return ret;
 }
+
+/****************************************************************************
+ * Name: modlib_findexport
+ *
+ * Description:
+ *   Find a symbol exported by a module by name.
+ *
+ * Input Parameters:
+ *   modp - The module.
+ *   name - The name of the symbol.
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if the module does not export a symbol
+ *   of that name.
+ *
+ * Assumptions:
+ *   The caller holds the lock on the module registry.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findexport(FAR struct module_s *modp,
+                                             FAR const char *name)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  /* The exports are indexed on the first lookup in the module */
+
+  if (modp->modinfo.exports != NULL &&
+      (modp->exphash.symtab != modp->modinfo.exports ||
+       modp->exphash.nsyms != (int)modp->modinfo.nexports))
+    {
+      symtab_hashuninit(&modp->exphash);
+      symtab_hashinit(&modp->exphash, modp->modinfo.exports,
+                      modp->modinfo.nexports);
+    }
+
+  if (modp->exphash.nbuckets > 0)
+    {
+      return symtab_findbyhash(&modp->exphash, name);
+    }
+#endif
+
+  return symtab_findbyname(modp->modinfo.exports, name,
+                           modp->modinfo.nexports);
+}
@@ -174,9 +174,7 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
+  exportinfo->symbol = modlib_findexport(modp, exportinfo->name);
 
   if (exportinfo->symbol != NULL)
     {
@@ -310,7 +308,6 @@ int modlib_symvalue(FAR struct module_s *modp,
   FAR const struct symtab_s *symbol;
   struct mod_exportinfo_s exportinfo;
   uintptr_t secbase;
-  int nsymbols;
   int ret;
 
   switch (sym->st_shndx)
@@ -374,9 +371,7 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            modlib_getsymtab(&symbol, &nsymbols);
-            symbol = symtab_findbyname(symbol, exportinfo.name,
-                                       nsymbols);
+            symbol = modlib_findsymbol(exportinfo.name);
           }
 
         /* Was the symbol found from any exporter? */
@@ -63,6 +63,10 @@ extern int CONFIG_MODLIB_NSYMBOLS_VAR;
 static FAR const struct symtab_s *g_modlib_symtab;
 static FAR int g_modlib_nsymbols;
 
+#ifdef CONFIG_SYMTAB_HASH
+static struct symtab_hash_s g_modlib_symhash;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -127,3 +131,53 @@ void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   g_modlib_nsymbols = nsymbols;
   modlib_registry_unlock();
 }
+
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol of the current kernel symbol table by name.
+ *
+ * Input Parameters:
+ *   name - The name of the symbol.
+ *
+ * Returned Value:
+ *   The symbol table entry; NULL if there is no symbol of that name.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name)
+{
+  FAR const struct symtab_s *symtab;
+  FAR const struct symtab_s *symbol;
+  int nsymbols;
+
+  modlib_registry_lock();
+  modlib_getsymtab(&symtab, &nsymbols);
+
+#ifdef CONFIG_SYMTAB_HASH
+  /* The table is indexed on the first lookup after it was selected */
+
+  if (g_modlib_symhash.symtab != symtab ||
+      g_modlib_symhash.nsyms != nsymbols)
+    {
+      symtab_hashuninit(&g_modlib_symhash);
+      if (symtab != NULL)
+        {
+          symtab_hashinit(&g_modlib_symhash, symtab, nsymbols);
+        }
+    }
+
+  if (g_modlib_symhash.nbuckets > 0)
+    {
+      symbol = symtab_findbyhash(&g_modlib_symhash, name);
+    }
+  else
+#endif
+    {
+      symbol = symtab_findbyname(symtab, name, nsymbols);
+    }
+
+  modlib_registry_unlock();
+  return symbol;
+}
@@ -75,6 +75,7 @@ int modlib_unload(struct mod_loadinfo_s *loadinfo)
   /* Clear out all indications of the allocated address environment */
 
   loadinfo->textalloc = 0;
+  loadinfo->textstart = 0;
   loadinfo->datastart = 0;
   loadinfo->textsize  = 0;
   loadinfo->datasize  = 0;
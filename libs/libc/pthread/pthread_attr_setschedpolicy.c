@@ -38,7 +38,9 @@
  * Name:  pthread_attr_setschedpolicy
  *
  * Description:
- *   Set the scheduling algorithm attribute.
+ *   Set the scheduling algorithm attribute.  SCHED_DEADLINE is not
+ *   supported:  A thread must enter it itself by sched_setscheduler(),
+ *   which runs the admission test.
  *
  * Input Parameters:
  *   attr
@@ -26,6 +26,9 @@
 
 #include <pthread.h>
 
+#include <nuttx/semaphore.h>
+#include <nuttx/tls.h>
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -82,6 +85,25 @@
 
 int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
 {
+#if defined(CONFIG_SEM_FASTPATH) && defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
+  /* An unlocked NORMAL mutex is taken in user space.  Other mutex types
+   * need the owner checks of the kernel.
+   */
+
+  if (mutex != NULL &&
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+      mutex->type == PTHREAD_MUTEX_NORMAL &&
+#endif
+      nxsem_trywait_fast(&mutex->sem))
+    {
+      mutex->pid    = tls_get_info()->tl_tid;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+      mutex->nlocks = 1;
+#endif
+      return OK;
+    }
+#endif
+
   /* pthread_mutex_lock() is equivalent to pthread_mutex_timedlock() when
    * the absolute time delay is a NULL value.
    */
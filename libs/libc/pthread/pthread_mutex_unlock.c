@@ -0,0 +1,86 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_mutex_unlock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#include <nuttx/pthread.h>
+#include <nuttx/sched.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_unlock
+ *
+ * Description:
+ *   The pthread_mutex_unlock() function releases the mutex object referenced
+ *   by mutex.  A NORMAL mutex that no thread is waiting for is released in
+ *   user space by changing the count of its semaphore from 0 to 1.  In all
+ *   other cases, nx_pthread_mutex_unlock() releases the mutex and wakes up
+ *   a waiter.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+{
+  int16_t count = 0;
+
+  if (mutex != NULL &&
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+      mutex->type == PTHREAD_MUTEX_NORMAL &&
+#endif
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      (mutex->sem.flags & PRIOINHERIT_FLAGS_ENABLE) == 0 &&
+#endif
+      mutex->sem.semcount == 0)
+    {
+      /* Nullify the owner before the mutex becomes available.  If a waiter
+       * shows up in the meantime, the kernel does the same.
+       */
+
+      mutex->pid    = INVALID_PROCESS_ID;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+      mutex->nlocks = 0;
+#endif
+
+      if (__atomic_compare_exchange_n(&mutex->sem.semcount, &count, 1,
+                                      false, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+        {
+          return OK;
+        }
+    }
+
+  return nx_pthread_mutex_unlock(mutex);
+}
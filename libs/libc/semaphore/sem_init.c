@@ -85,6 +85,12 @@ int nxsem_init(FAR sem_t *sem, int pshared, unsigned int value)
   INITIALIZE_SEMHOLDER(&sem->holder[1]);
 #  endif
 #endif
+
+#ifdef CONFIG_MUTEX_ADAPTIVE
+  sem->nspins  = 0;
+  sem->nblocks = 0;
+#endif
+
   return OK;
 }
 
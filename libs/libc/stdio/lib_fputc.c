@@ -23,6 +23,9 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <fcntl.h>
+#include <errno.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -30,15 +33,30 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: fputc
+ * Name: fputc_unlocked
  ****************************************************************************/
 
-int fputc(int c, FAR FILE *stream)
+int fputc_unlocked(int c, FAR FILE *stream)
 {
   unsigned char buf = (unsigned char)c;
   int ret;
 
-  ret = lib_fwrite(&buf, 1, stream);
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* Store the character directly if the write buffer does not fill up
+   * and no line has to be flushed.
+   */
+
+  if (stream->fs_bufpos + 1 < stream->fs_bufend &&
+      stream->fs_bufread == stream->fs_bufstart &&
+      (stream->fs_oflags & O_WROK) != 0 &&
+      (c != '\n' || (stream->fs_flags & __FS_FLAG_LBF) == 0))
+    {
+      *stream->fs_bufpos++ = buf;
+      return buf;
+    }
+#endif
+
+  ret = lib_fwrite_unlocked(&buf, 1, stream);
   if (ret > 0)
     {
       /* Flush the buffer if a newline is output */
@@ -52,10 +70,31 @@ int fputc(int c, FAR FILE *stream)
             }
         }
 
-      return c;
+      return buf;
     }
   else
     {
       return EOF;
     }
 }
+
+/****************************************************************************
+ * Name: fputc
+ ****************************************************************************/
+
+int fputc(int c, FAR FILE *stream)
+{
+  int ret;
+
+  if (stream == NULL)
+    {
+      set_errno(EBADF);
+      return EOF;
+    }
+
+  flockfile(stream);
+  ret = fputc_unlocked(c, stream);
+  funlockfile(stream);
+
+  return ret;
+}
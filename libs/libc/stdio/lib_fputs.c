@@ -83,37 +83,42 @@ int fputs(FAR const IPTR char *s, FAR FILE *stream)
 {
   int nput;
 
-  /* If line buffering is enabled, then we will have to output one character
-   * at a time, checking for a newline character each time.
+  /* If line buffering is enabled, then the string is output up to each
+   * newline, and the buffer is flushed after it.
    */
 
   if ((stream->fs_flags & __FS_FLAG_LBF) != 0)
     {
-      int ret;
+      FAR const char *nl;
+      ssize_t len;
+      int ret = 0;
 
-      /* Write the string.  Loop until the null terminator is encountered */
+      flockfile(stream);
 
-      for (nput = 0; *s; nput++, s++)
+      for (nput = 0; *s; nput += len, s += len)
         {
-          /* Write the next character to the stream buffer */
+          nl  = strchr(s, '\n');
+          len = nl != NULL ? nl - s + 1 : strlen(s);
 
-          ret = lib_fwrite(s, 1, stream);
-          if (ret <= 0)
+          if (lib_fwrite_unlocked(s, len, stream) < len)
             {
-              return EOF;
+              ret = EOF;
+              break;
             }
 
-          /* Flush the buffer if a newline was written to the buffer */
-
-          if (*s == '\n')
+          if (nl != NULL && lib_fflush(stream, true) < 0)
             {
-              ret = lib_fflush(stream, true);
-              if (ret < 0)
-                {
-                  return EOF;
-                }
+              ret = EOF;
+              break;
             }
         }
+
+      funlockfile(stream);
+
+      if (ret < 0)
+        {
+          return EOF;
+        }
     }
 
   /* We can write the whole string in one operation without line buffering */
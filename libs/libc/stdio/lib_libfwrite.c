@@ -40,10 +40,15 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: lib_fwrite
+ * Name: lib_fwrite_unlocked
+ *
+ * Description:
+ *   Write to a stream whose lock is already held by the caller.
+ *
  ****************************************************************************/
 
-ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
+ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
+                            FAR FILE *stream)
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
 {
   FAR const unsigned char *start = ptr;
@@ -81,10 +86,6 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
       goto errout;
     }
 
-  /* Get exclusive access to the stream */
-
-  flockfile(stream);
-
   /* If the buffer is currently being used for read access, then
    * discard all of the read-ahead data.  We do not support concurrent
    * buffered read/write access.
@@ -92,32 +93,45 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   if (lib_rdflush(stream) < 0)
     {
-      goto errout_with_lock;
+      goto errout;
     }
 
-  /* Determine the number of bytes left in the buffer */
-
-  gulp_size = stream->fs_bufend - stream->fs_bufpos;
-  if (gulp_size != CONFIG_STDIO_BUFFER_SIZE || count < gulp_size)
+  if (count >= (size_t)(stream->fs_bufend - stream->fs_bufstart))
     {
-      if (gulp_size > count)
-        {
-          /* Yes, clip the gulp to the size of the user data */
+      /* Writes of at least a buffer go straight to the file, once what is
+       * already buffered is written, without being copied.
+       */
 
-          gulp_size = count;
+      if (stream->fs_bufpos != stream->fs_bufstart &&
+          lib_fflush(stream, true) < 0)
+        {
+          goto errout;
         }
 
-      /* Adjust the number of bytes remaining to be transferred
-       * on the next pass through the loop (might be zero).
-       */
+      ret = _NX_WRITE(stream->fs_fd, src, count);
+      if (ret < 0)
+        {
+          _NX_SETERRNO(ret);
+          ret = ERROR;
+          goto errout;
+        }
 
-      count -= gulp_size;
+      src += ret;
+    }
+  else
+    {
+      /* Transfer what fits into the buffer */
 
-      /* Transfer the data into the buffer */
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
+      if (gulp_size > count)
+        {
+          gulp_size = count;
+        }
 
       memcpy(stream->fs_bufpos, src, gulp_size);
       stream->fs_bufpos += gulp_size;
-      src += gulp_size;
+      src   += gulp_size;
+      count -= gulp_size;
 
       /* Is the buffer full? */
 
@@ -128,37 +142,30 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
           int bytes_buffered = lib_fflush(stream, false);
           if (bytes_buffered < 0)
             {
-              goto errout_with_lock;
+              goto errout;
             }
         }
-    }
 
-  if (count >= CONFIG_STDIO_BUFFER_SIZE)
-    {
-      ret = _NX_WRITE(stream->fs_fd, src, count);
-      if (ret < 0)
+      /* The rest is less than a buffer */
+
+      if (count > 0)
         {
-          _NX_SETERRNO(ret);
-          ret = ERROR;
-          goto errout_with_lock;
-        }
+          gulp_size = stream->fs_bufend - stream->fs_bufpos;
+          if (gulp_size > count)
+            {
+              gulp_size = count;
+            }
 
-      src += ret;
-    }
-  else if (count > 0)
-    {
-      memcpy(stream->fs_bufpos, src, count);
-      stream->fs_bufpos += count;
-      src += count;
+          memcpy(stream->fs_bufpos, src, gulp_size);
+          stream->fs_bufpos += gulp_size;
+          src += gulp_size;
+        }
     }
 
   /* Return the number of bytes written */
 
   ret = (uintptr_t)src - (uintptr_t)start;
 
-errout_with_lock:
-  funlockfile(stream);
-
 errout:
   if (ret < 0)
     {
@@ -179,3 +186,24 @@ errout:
   return ret;
 }
 #endif /* CONFIG_STDIO_DISABLE_BUFFERING */
+
+/****************************************************************************
+ * Name: lib_fwrite
+ ****************************************************************************/
+
+ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
+{
+  ssize_t ret;
+
+  if (stream == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  flockfile(stream);
+  ret = lib_fwrite_unlocked(ptr, count, stream);
+  funlockfile(stream);
+
+  return ret;
+}
@@ -68,6 +68,8 @@
 #endif
 
 #define stream_putc(c,stream)  (total_len++, lib_stream_putc(stream, c))
+#define stream_puts(s,n,stream) \
+  (total_len += (n), lib_stream_puts(stream, s, n))
 
 /* Order is relevant here and matches order in format string */
 
@@ -114,6 +116,14 @@
 
 #define fmt_ungetc(fmt)   ((fmt)--)
 
+/* The text of the format string can be output as is, unless it has to be
+ * read from code space.
+ */
+
+#if !defined(CONFIG_ARCH_ROMGETC) && !defined(CONFIG_AVR_HAS_MEMX_PTR)
+#  define FMT_PUTS_TEXT
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -152,6 +162,28 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: reverse_digits
+ *
+ * Description:
+ *   __ultoa_invert() leaves the digits in reverse order, put them in order
+ *   so that they can be output at once.
+ *
+ ****************************************************************************/
+
+static void reverse_digits(FAR unsigned char *buf, int len)
+{
+  unsigned char tmp;
+  int i;
+
+  for (i = 0, len--; i < len; i++, len--)
+    {
+      tmp      = buf[i];
+      buf[i]   = buf[len];
+      buf[len] = tmp;
+    }
+}
+
 #ifdef CONFIG_ALLSYMS
 static int sprintf_internal(FAR struct lib_outstream_s *stream,
                             FAR const IPTR char *fmt, ...)
@@ -205,6 +237,21 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifdef FMT_PUTS_TEXT
+          /* Output the text up to the next conversion at once */
+
+          for (pnt = fmt; *fmt != '\0' && *fmt != '%'; fmt++);
+
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+          if (fmt != pnt && stream != NULL)
+#  else
+          if (fmt != pnt)
+#  endif
+            {
+              stream_puts(pnt, fmt - pnt, stream);
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -230,6 +277,46 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
 #endif
         }
 
+#ifndef CONFIG_LIBC_NUMBERED_ARGS
+      /* The conversions without flags, width, precision or length are
+       * the most common ones, output them without parsing the format any
+       * further.
+       */
+
+      if (c == 's')
+        {
+          pnt = va_arg(ap, FAR char *);
+          if (pnt == NULL)
+            {
+              pnt = g_nullstring;
+            }
+
+          size = strlen(pnt);
+          if (size > 0)
+            {
+              stream_puts(pnt, size, stream);
+            }
+
+          continue;
+        }
+      else if (c == 'd' || c == 'i' || c == 'u' || c == 'x')
+        {
+          unsigned int x = va_arg(ap, unsigned int);
+
+          if (c != 'u' && c != 'x' && (int)x < 0)
+            {
+              stream_putc('-', stream);
+              x = -x;
+            }
+
+          len = __ultoa_invert(x, (FAR char *)buf, c == 'x' ? 16 : 10) -
+                (FAR char *)buf;
+          reverse_digits(buf, len);
+          stream_puts(buf, len, stream);
+          continue;
+        }
+#endif
+
       flags = 0;
       width = 0;
       prec  = 0;
@@ -947,17 +1034,12 @@ str_lpad:
                 }
             }
 
-          while (size)
+          if (size > 0)
             {
-              stream_putc(*pnt++, stream);
-              if (width != 0)
-                {
-                  width -= 1;
-                }
-
-              size -= 1;
+              stream_puts(pnt, size, stream);
             }
 
+          width = (size_t)width > size ? width - size : 0;
           goto tail;
         }
 
@@ -1310,9 +1392,10 @@ str_lpad:
           prec--;
         }
 
-      while (c)
+      if (c > 0)
         {
-          stream_putc(buf[--c], stream);
+          reverse_digits(buf, c);
+          stream_puts(buf, c, stream);
         }
 
 tail:
@@ -51,6 +51,30 @@ static void lowoutstream_putc(FAR struct lib_outstream_s *this, int ch)
     }
 }
 
+/****************************************************************************
+ * Name: lowoutstream_puts
+ ****************************************************************************/
+
+static int lowoutstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR const char *ptr = buf;
+  int i;
+
+  DEBUGASSERT(this);
+
+  for (i = 0; i < len; i++)
+    {
+      if (up_putc(ptr[i]) == EOF)
+        {
+          break;
+        }
+    }
+
+  this->nput += i;
+  return i;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -73,6 +97,7 @@ static void lowoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_lowoutstream(FAR struct lib_outstream_s *stream)
 {
   stream->putc  = lowoutstream_putc;
+  stream->puts  = lowoutstream_puts;
   stream->flush = lib_noflush;
   stream->nput  = 0;
 }
@@ -39,6 +39,19 @@ static void nulloutstream_putc(FAR struct lib_outstream_s *this, int ch)
   this->nput++;
 }
 
+/****************************************************************************
+ * Name: nulloutstream_puts
+ ****************************************************************************/
+
+static int nulloutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const void *buf, int len)
+{
+  UNUSED(buf);
+  DEBUGASSERT(this);
+  this->nput += len;
+  return len;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -62,6 +75,7 @@ static void nulloutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_nulloutstream(FAR struct lib_outstream_s *nulloutstream)
 {
   nulloutstream->putc  = nulloutstream_putc;
+  nulloutstream->puts  = nulloutstream_puts;
   nulloutstream->flush = lib_noflush;
   nulloutstream->nput  = 0;
 }
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -64,6 +65,50 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (get_errno() == EINTR);
 }
 
+/****************************************************************************
+ * Name: stdoutstream_puts
+ ****************************************************************************/
+
+static int stdoutstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR struct lib_stdoutstream_s *sthis =
+                               (FAR struct lib_stdoutstream_s *)this;
+  int result;
+
+  DEBUGASSERT(this && sthis->stream);
+
+  /* Loop until the buffer is successfully transferred or an irrecoverable
+   * error occurs.
+   */
+
+  do
+    {
+      result = lib_fwrite(buf, len, sthis->stream);
+      if (result >= 0)
+        {
+          this->nput += result;
+
+          /* Flush the buffer if a newline is output, like fputc() */
+
+          if ((sthis->stream->fs_flags & __FS_FLAG_LBF) != 0 &&
+              memchr(buf, '\n', result) != NULL)
+            {
+              lib_fflush(sthis->stream, true);
+            }
+
+          return result;
+        }
+
+      /* EINTR (meaning that the write was interrupted by a signal) is the
+       * only recoverable error.
+       */
+    }
+  while (get_errno() == EINTR);
+
+  return result;
+}
+
 /****************************************************************************
  * Name: stdoutstream_flush
  ****************************************************************************/
@@ -103,9 +148,10 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *this)
 void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
                       FAR FILE *stream)
 {
-  /* Select the putc operation */
+  /* Select the putc and puts operations */
 
   outstream->public.putc = stdoutstream_putc;
+  outstream->public.puts = stdoutstream_puts;
 
   /* Select the correct flush operation.  This flush is only called when
    * a newline is encountered in the output stream.  However, we do not
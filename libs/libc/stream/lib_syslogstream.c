@@ -161,6 +161,24 @@ static void syslogstream_putc(FAR struct lib_outstream_s *this, int ch)
     }
 }
 
+/****************************************************************************
+ * Name: syslogstream_puts
+ ****************************************************************************/
+
+static int syslogstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR const char *ptr = buf;
+  int i;
+
+  for (i = 0; i < len; i++)
+    {
+      syslogstream_putc(this, ptr[i]);
+    }
+
+  return len;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -188,6 +206,7 @@ void lib_syslogstream_open(FAR struct lib_syslogstream_s *stream)
   /* Initialize the common fields */
 
   stream->public.putc  = syslogstream_putc;
+  stream->public.puts  = syslogstream_puts;
   stream->public.flush = lib_noflush;
   stream->public.nput  = 0;
 
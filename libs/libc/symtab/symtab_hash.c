@@ -0,0 +1,198 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_SYMTAB_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The end of a chain */
+
+#define SYMTAB_HASH_END UINT16_MAX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   The hash function of the GNU hash sections of ELF files.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hashname(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (unsigned char)*name++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index of a symbol table.  The table must not change as
+ *   long as the index is used.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -E2BIG if the table is too large to be indexed
+ *   or -ENOMEM if the index cannot be allocated.
+ *
+ ****************************************************************************/
+
+int symtab_hashinit(FAR struct symtab_hash_s *hash,
+                    FAR const struct symtab_s *symtab, int nsyms)
+{
+  uint32_t bucket;
+  int nbuckets;
+  int i;
+
+  memset(hash, 0, sizeof(struct symtab_hash_s));
+
+  if (nsyms >= SYMTAB_HASH_END)
+    {
+      return -E2BIG;
+    }
+
+  /* About two symbols per bucket, a power of two to mask the hash */
+
+  for (nbuckets = 1; nbuckets < nsyms / 2; nbuckets <<= 1);
+
+  hash->buckets = lib_malloc((nbuckets + nsyms) * sizeof(uint16_t));
+  if (hash->buckets == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hash->chain    = hash->buckets + nbuckets;
+  hash->symtab   = symtab;
+  hash->nsyms    = nsyms;
+  hash->nbuckets = nbuckets;
+
+  for (i = 0; i < nbuckets; i++)
+    {
+      hash->buckets[i] = SYMTAB_HASH_END;
+    }
+
+  /* Insert in reverse order so that the chains keep the order of the
+   * table; the first of duplicate names is found as with a search.
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      bucket = symtab_hashname(symtab[i].sym_name) & (nbuckets - 1);
+      hash->chain[i] = hash->buckets[bucket];
+      hash->buckets[bucket] = i;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hashuninit
+ *
+ * Description:
+ *   Release the hash index of a symbol table.
+ *
+ ****************************************************************************/
+
+void symtab_hashuninit(FAR struct symtab_hash_s *hash)
+{
+  if (hash->buckets != NULL)
+    {
+      lib_free(hash->buckets);
+    }
+
+  memset(hash, 0, sizeof(struct symtab_hash_s));
+}
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name using the hash index of its
+ *   symbol table.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name)
+{
+  uint16_t i;
+
+  DEBUGASSERT(name != NULL);
+
+  if (hash->nbuckets == 0)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  i = hash->buckets[symtab_hashname(name) & (hash->nbuckets - 1)];
+  for (; i != SYMTAB_HASH_END; i = hash->chain[i])
+    {
+      if (strcmp(name, hash->symtab[i].sym_name) == 0)
+        {
+          return &hash->symtab[i];
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_SYMTAB_HASH */
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * libs/libc/time/lib_clockgettime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct clock_timepage_s *g_timepage;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Clock Functions based on POSIX APIs
+ *
+ *   The system timer and the time-of-day are read from the time page of
+ *   the kernel.  Only the other clocks enter the kernel.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const struct clock_timepage_s *page;
+  struct timespec basetime;
+  uint32_t seq;
+  clock_t ticks;
+
+  if (tp == NULL ||
+      (clock_id != CLOCK_MONOTONIC && clock_id != CLOCK_BOOTTIME &&
+       clock_id != CLOCK_REALTIME))
+    {
+      return nx_clock_gettime(clock_id, tp);
+    }
+
+  page = g_timepage;
+  if (page == NULL)
+    {
+      page = clock_timepage();
+      if (page == NULL)
+        {
+          return nx_clock_gettime(clock_id, tp);
+        }
+
+      g_timepage = page;
+    }
+
+  /* Retry while the kernel updates the page */
+
+  do
+    {
+      seq = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+      ticks    = page->ticks;
+      basetime = page->basetime;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    }
+  while ((seq & 1) != 0 ||
+         seq != __atomic_load_n(&page->seq, __ATOMIC_RELAXED));
+
+  timespec_from_tick(tp, ticks);
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      tp->tv_sec  += basetime.tv_sec;
+      tp->tv_nsec += basetime.tv_nsec;
+      if (tp->tv_nsec >= NSEC_PER_SEC)
+        {
+          tp->tv_sec++;
+          tp->tv_nsec -= NSEC_PER_SEC;
+        }
+    }
+
+  return OK;
+}
@@ -0,0 +1,167 @@
+/****************************************************************************
+ * libs/libdsp/lib_bench_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+
+#include <dspb16.h>
+
+#ifdef CONFIG_LIBDSP_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The axes of the batched transforms */
+
+#define BENCH_NAXES  4
+
+/* The sizes of the vector kernels */
+
+#define BENCH_NELEM  64
+#define BENCH_NTAPS  16
+#define BENCH_NSTAGE 2
+
+/* Time a statement run loops times and store the cost of one run */
+
+#define BENCH(result, stmt)                     \
+  do                                            \
+    {                                           \
+      start = gettime();                        \
+      for (i = 0; i < loops; i++)               \
+        {                                       \
+          stmt;                                 \
+        }                                       \
+                                                \
+      result = (gettime() - start) / loops;     \
+    }                                           \
+  while (0)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_bench_b16
+ *
+ * Description:
+ *   Measure the cost of the kernels of a FOC cycle, to track regressions.
+ *   Each kernel is run loops times on fixed inputs and timed as a whole,
+ *   including the loop, which costs a few cycles per run.
+ *
+ * Input Parameters:
+ *   bench   - (out) pointer to the results
+ *   gettime - (in) a free running clock, e.g. up_perf_gettime() or the
+ *             cycle counter of the CPU
+ *   loops   - (in) the number of runs of each kernel
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void dsp_bench_b16(FAR struct dsp_bench_b16_s *bench,
+                   CODE uint32_t (*gettime)(void), int loops)
+{
+  phase_angle_b16_t angle[BENCH_NAXES];
+  ab_frame_b16_t ab[BENCH_NAXES];
+  dq_frame_b16_t dq[BENCH_NAXES];
+  abc_frame_b16_t abc;
+  struct svm3_state_b16_s svm;
+  pid_controller_b16_t pi;
+#ifdef CONFIG_LIBDSP_VECTOR
+  struct biquad_coeffs_b16_s coeffs[BENCH_NSTAGE];
+  b16_t vec[BENCH_NELEM];
+  b16_t out[BENCH_NELEM];
+  b16_t firstate[2 * BENCH_NTAPS];
+  b16_t iirstate[4 * BENCH_NSTAGE];
+  fir_filter_b16_t fir;
+  iir_filter_b16_t iir;
+#endif
+  uint32_t start;
+  int i;
+
+  LIBDSP_DEBUGASSERT(bench != NULL);
+  LIBDSP_DEBUGASSERT(gettime != NULL);
+  LIBDSP_DEBUGASSERT(loops > 0);
+
+  memset(bench, 0, sizeof(struct dsp_bench_b16_s));
+
+  for (i = 0; i < BENCH_NAXES; i++)
+    {
+      phase_angle_update_b16(&angle[i], ftob16(0.5f + i));
+      ab[i].a = ftob16(0.3f);
+      ab[i].b = ftob16(-0.2f);
+      dq[i].d = ftob16(0.1f);
+      dq[i].q = ftob16(0.4f);
+    }
+
+  abc.a = ftob16(0.5f);
+  abc.b = ftob16(-0.2f);
+  abc.c = ftob16(-0.3f);
+
+  svm3_init_b16(&svm);
+  pi_controller_init_b16(&pi, ftob16(0.1f), ftob16(0.01f));
+  pi_saturation_set_b16(&pi, -b16ONE, b16ONE);
+
+  BENCH(bench->clarke, clarke_transform_b16(&abc, &ab[0]));
+  BENCH(bench->inv_clarke, inv_clarke_transform_b16(&ab[0], &abc));
+  BENCH(bench->park, park_transform_b16(&angle[0], &ab[0], &dq[0]));
+  BENCH(bench->inv_park, inv_park_transform_b16(&angle[0], &dq[0], &ab[0]));
+  BENCH(bench->park_batch,
+        park_transform_batch_b16(angle, ab, dq, BENCH_NAXES));
+  BENCH(bench->svm3, svm3_b16(&svm, &ab[0]));
+  BENCH(bench->pi, pi_controller_b16(&pi, ftob16(0.05f)));
+  BENCH(bench->angle, phase_angle_update_b16(&angle[0], ftob16(1.0f)));
+
+  bench->park_batch /= BENCH_NAXES;
+
+#ifdef CONFIG_LIBDSP_VECTOR
+  for (i = 0; i < BENCH_NELEM; i++)
+    {
+      vec[i] = ftob16(0.01f * (i - BENCH_NELEM / 2));
+    }
+
+  for (i = 0; i < BENCH_NSTAGE; i++)
+    {
+      coeffs[i].b0 = ftob16(0.0675f);
+      coeffs[i].b1 = ftob16(0.135f);
+      coeffs[i].b2 = ftob16(0.0675f);
+      coeffs[i].a1 = ftob16(-1.143f);
+      coeffs[i].a2 = ftob16(0.4128f);
+    }
+
+  fir_filter_init_b16(&fir, vec, firstate, BENCH_NTAPS);
+  iir_filter_init_b16(&iir, coeffs, iirstate, BENCH_NSTAGE);
+
+  BENCH(bench->dot, out[0] = vector_dot_b16(vec, vec, BENCH_NELEM));
+  BENCH(bench->fir, fir_filter_b16(&fir, vec, out, BENCH_NELEM));
+  BENCH(bench->iir, iir_filter_b16(&iir, vec, out, BENCH_NELEM));
+
+  bench->dot /= BENCH_NELEM;
+  bench->fir /= BENCH_NELEM;
+  bench->iir /= BENCH_NELEM;
+#endif
+}
+
+#endif /* CONFIG_LIBDSP_BENCH */
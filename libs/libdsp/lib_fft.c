@@ -0,0 +1,197 @@
+/****************************************************************************
+ * libs/libdsp/lib_fft.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fft_bitreverse
+ *
+ * Description:
+ *   Reorder n complex values by bit-reversed index.
+ *
+ ****************************************************************************/
+
+static void fft_bitreverse(FAR float *data, uint16_t n)
+{
+  uint16_t i;
+  uint16_t j = 0;
+  uint16_t bit;
+  float tmp;
+
+  for (i = 0; i < n - 1; i++)
+    {
+      if (i < j)
+        {
+          tmp             = data[2 * i];
+          data[2 * i]     = data[2 * j];
+          data[2 * j]     = tmp;
+          tmp             = data[2 * i + 1];
+          data[2 * i + 1] = data[2 * j + 1];
+          data[2 * j + 1] = tmp;
+        }
+
+      for (bit = n >> 1; j & bit; bit >>= 1)
+        {
+          j ^= bit;
+        }
+
+      j |= bit;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fft_init
+ *
+ * Description:
+ *   Initialize an FFT of n points and compute its twiddle factors.
+ *
+ * Input Parameters:
+ *   fft     - (out) pointer to the FFT
+ *   twiddle - (in) buffer of n floats for the n / 2 complex factors
+ *   n       - (in) number of points, a power of 2 from 2 to 32768
+ *
+ * Returned Value:
+ *   Zero on success, -EINVAL if n is not a supported power of 2.
+ *
+ ****************************************************************************/
+
+int fft_init(FAR struct fft_f32_s *fft, FAR float *twiddle, uint16_t n)
+{
+  uint16_t k;
+
+  LIBDSP_DEBUGASSERT(fft != NULL && twiddle != NULL);
+
+  if (n < 2 || (n & (n - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  fft->twiddle = twiddle;
+  fft->n       = n;
+  fft->log2n   = 0;
+
+  while ((1 << fft->log2n) < n)
+    {
+      fft->log2n++;
+    }
+
+  /* w^k = exp(-2 * pi * i * k / n) */
+
+  for (k = 0; k < n / 2; k++)
+    {
+      twiddle[2 * k]     = cosf(2.0f * M_PI_F * k / n);
+      twiddle[2 * k + 1] = -sinf(2.0f * M_PI_F * k / n);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: fft_transform
+ *
+ * Description:
+ *   Compute the discrete Fourier transform of n complex values in place,
+ *   with radix-2 decimation in time.  The inverse transform is scaled by
+ *   1 / n, so that it undoes the forward one.  For a real signal, set the
+ *   imaginary parts to zero; bins 0 to n / 2 carry the spectrum.
+ *
+ * Input Parameters:
+ *   fft     - (in) pointer to the FFT
+ *   data    - (in/out) n complex values, real part first
+ *   inverse - (in) compute the inverse transform
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fft_transform(FAR const struct fft_f32_s *fft, FAR float *data,
+                   bool inverse)
+{
+  FAR const float *w;
+  uint16_t n;
+  uint16_t half;
+  uint16_t step;
+  uint32_t i;
+  uint32_t j;
+  float sign;
+  float wr;
+  float wi;
+  float tr;
+  float ti;
+  float scale;
+
+  LIBDSP_DEBUGASSERT(fft != NULL && data != NULL);
+
+  n    = fft->n;
+  w    = fft->twiddle;
+  sign = inverse ? -1.0f : 1.0f;
+
+  fft_bitreverse(data, n);
+
+  /* Butterflies of span 2, 4, ... n.  The twiddle factors of a span are
+   * every step-th factor of the table.
+   */
+
+  for (half = 1, step = n / 2; half < n; half <<= 1, step >>= 1)
+    {
+      for (j = 0; j < half; j++)
+        {
+          wr = w[2 * j * step];
+          wi = sign * w[2 * j * step + 1];
+
+          for (i = j; i < n; i += 2 * half)
+            {
+              FAR float *a = &data[2 * i];
+              FAR float *b = &data[2 * (i + half)];
+
+              tr   = wr * b[0] - wi * b[1];
+              ti   = wr * b[1] + wi * b[0];
+              b[0] = a[0] - tr;
+              b[1] = a[1] - ti;
+              a[0] = a[0] + tr;
+              a[1] = a[1] + ti;
+            }
+        }
+    }
+
+  if (inverse)
+    {
+      scale = 1.0f / n;
+      for (i = 0; i < 2 * n; i++)
+        {
+          data[i] *= scale;
+        }
+    }
+}
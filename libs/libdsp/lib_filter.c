@@ -0,0 +1,194 @@
+/****************************************************************************
+ * libs/libdsp/lib_filter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+
+#include <dsp.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_filter_init
+ *
+ * Description:
+ *   Initialize a FIR filter and clear its delay line.
+ *
+ * Input Parameters:
+ *   fir    - (out) pointer to the FIR filter
+ *   coeffs - (in) ntaps coefficients, h[0] first
+ *   state  - (in) buffer of 2 * ntaps samples for the delay line
+ *   ntaps  - (in) number of taps
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_init(FAR fir_filter_f32_t *fir, FAR const float *coeffs,
+                     FAR float *state, uint16_t ntaps)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL && state != NULL && ntaps > 0);
+
+  fir->coeffs = coeffs;
+  fir->state  = state;
+  fir->ntaps  = ntaps;
+  fir->pos    = 0;
+
+  memset(state, 0, 2 * ntaps * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: fir_filter
+ *
+ * Description:
+ *   Filter a block of samples.  Each sample is stored twice in the delay
+ *   line, ntaps apart, so that the last ntaps samples are always
+ *   contiguous, newest first, and each output is one vector_dot().
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter
+ *   in  - (in) input samples
+ *   out - (out) output samples, which may be the same as in
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter(FAR fir_filter_f32_t *fir, FAR const float *in,
+                FAR float *out, size_t n)
+{
+  uint16_t ntaps;
+  uint16_t pos;
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(n == 0 || (in != NULL && out != NULL));
+
+  ntaps = fir->ntaps;
+  pos   = fir->pos;
+
+  for (i = 0; i < n; i++)
+    {
+      pos = (pos == 0 ? ntaps : pos) - 1;
+      fir->state[pos]         = in[i];
+      fir->state[pos + ntaps] = in[i];
+
+      out[i] = vector_dot(&fir->state[pos], fir->coeffs, ntaps);
+    }
+
+  fir->pos = pos;
+}
+
+/****************************************************************************
+ * Name: iir_filter_init
+ *
+ * Description:
+ *   Initialize a cascade of biquad sections and clear its state.
+ *
+ * Input Parameters:
+ *   iir     - (out) pointer to the IIR filter
+ *   coeffs  - (in) nstages sections, applied in order
+ *   state   - (in) buffer of 2 * nstages values
+ *   nstages - (in) number of sections
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void iir_filter_init(FAR iir_filter_f32_t *iir,
+                     FAR const struct biquad_coeffs_f32_s *coeffs,
+                     FAR float *state, uint8_t nstages)
+{
+  LIBDSP_DEBUGASSERT(iir != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL && state != NULL && nstages > 0);
+
+  iir->coeffs  = coeffs;
+  iir->state   = state;
+  iir->nstages = nstages;
+
+  memset(state, 0, 2 * nstages * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: iir_filter
+ *
+ * Description:
+ *   Filter a block of samples with each section in turn.  A section runs
+ *   over the whole block with its state in registers before the next one.
+ *
+ * Input Parameters:
+ *   iir - (in/out) pointer to the IIR filter
+ *   in  - (in) input samples
+ *   out - (out) output samples, which may be the same as in
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void iir_filter(FAR iir_filter_f32_t *iir, FAR const float *in,
+                FAR float *out, size_t n)
+{
+  FAR const struct biquad_coeffs_f32_s *c;
+  FAR const float *src = in;
+  float s1;
+  float s2;
+  float x;
+  float y;
+  size_t i;
+  int stage;
+
+  LIBDSP_DEBUGASSERT(iir != NULL);
+  LIBDSP_DEBUGASSERT(n == 0 || (in != NULL && out != NULL));
+
+  for (stage = 0; stage < iir->nstages; stage++)
+    {
+      c  = &iir->coeffs[stage];
+      s1 = iir->state[2 * stage];
+      s2 = iir->state[2 * stage + 1];
+
+      for (i = 0; i < n; i++)
+        {
+          x      = src[i];
+          y      = c->b0 * x + s1;
+          s1     = c->b1 * x - c->a1 * y + s2;
+          s2     = c->b2 * x - c->a2 * y;
+          out[i] = y;
+        }
+
+      iir->state[2 * stage]     = s1;
+      iir->state[2 * stage + 1] = s2;
+
+      /* The next section filters the output of this one */
+
+      src = out;
+    }
+}
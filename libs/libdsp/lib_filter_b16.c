@@ -0,0 +1,206 @@
+/****************************************************************************
+ * libs/libdsp/lib_filter_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+
+#include <dspb16.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fir_filter_init_b16
+ *
+ * Description:
+ *   Initialize a FIR filter and clear its delay line.
+ *
+ * Input Parameters:
+ *   fir    - (out) pointer to the FIR filter
+ *   coeffs - (in) ntaps coefficients, h[0] first
+ *   state  - (in) buffer of 2 * ntaps samples for the delay line
+ *   ntaps  - (in) number of taps
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_init_b16(FAR fir_filter_b16_t *fir, FAR const b16_t *coeffs,
+                         FAR b16_t *state, uint16_t ntaps)
+{
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL && state != NULL && ntaps > 0);
+
+  fir->coeffs = coeffs;
+  fir->state  = state;
+  fir->ntaps  = ntaps;
+  fir->pos    = 0;
+
+  memset(state, 0, 2 * ntaps * sizeof(b16_t));
+}
+
+/****************************************************************************
+ * Name: fir_filter_b16
+ *
+ * Description:
+ *   Filter a block of samples.  The delay line is kept as in fir_filter()
+ *   and each output is one vector_dot_b16(), rounded once.
+ *
+ * Input Parameters:
+ *   fir - (in/out) pointer to the FIR filter
+ *   in  - (in) input samples
+ *   out - (out) output samples, which may be the same as in
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void fir_filter_b16(FAR fir_filter_b16_t *fir, FAR const b16_t *in,
+                    FAR b16_t *out, size_t n)
+{
+  uint16_t ntaps;
+  uint16_t pos;
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(fir != NULL);
+  LIBDSP_DEBUGASSERT(n == 0 || (in != NULL && out != NULL));
+
+  ntaps = fir->ntaps;
+  pos   = fir->pos;
+
+  for (i = 0; i < n; i++)
+    {
+      pos = (pos == 0 ? ntaps : pos) - 1;
+      fir->state[pos]         = in[i];
+      fir->state[pos + ntaps] = in[i];
+
+      out[i] = vector_dot_b16(&fir->state[pos], fir->coeffs, ntaps);
+    }
+
+  fir->pos = pos;
+}
+
+/****************************************************************************
+ * Name: iir_filter_init_b16
+ *
+ * Description:
+ *   Initialize a cascade of biquad sections and clear its state.
+ *
+ * Input Parameters:
+ *   iir     - (out) pointer to the IIR filter
+ *   coeffs  - (in) nstages sections, applied in order
+ *   state   - (in) buffer of 4 * nstages values
+ *   nstages - (in) number of sections
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void iir_filter_init_b16(FAR iir_filter_b16_t *iir,
+                         FAR const struct biquad_coeffs_b16_s *coeffs,
+                         FAR b16_t *state, uint8_t nstages)
+{
+  LIBDSP_DEBUGASSERT(iir != NULL);
+  LIBDSP_DEBUGASSERT(coeffs != NULL && state != NULL && nstages > 0);
+
+  iir->coeffs  = coeffs;
+  iir->state   = state;
+  iir->nstages = nstages;
+
+  memset(state, 0, 4 * nstages * sizeof(b16_t));
+}
+
+/****************************************************************************
+ * Name: iir_filter_b16
+ *
+ * Description:
+ *   Filter a block of samples with each section in turn.  The five
+ *   products of a section are summed on 64 bits and rounded once.
+ *
+ * Input Parameters:
+ *   iir - (in/out) pointer to the IIR filter
+ *   in  - (in) input samples
+ *   out - (out) output samples, which may be the same as in
+ *   n   - (in) number of samples
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void iir_filter_b16(FAR iir_filter_b16_t *iir, FAR const b16_t *in,
+                    FAR b16_t *out, size_t n)
+{
+  FAR const struct biquad_coeffs_b16_s *c;
+  FAR const b16_t *src = in;
+  FAR b16_t *s;
+  int64_t acc;
+  b16_t x1;
+  b16_t x2;
+  b16_t y1;
+  b16_t y2;
+  b16_t x;
+  size_t i;
+  int stage;
+
+  LIBDSP_DEBUGASSERT(iir != NULL);
+  LIBDSP_DEBUGASSERT(n == 0 || (in != NULL && out != NULL));
+
+  for (stage = 0; stage < iir->nstages; stage++)
+    {
+      c  = &iir->coeffs[stage];
+      s  = &iir->state[4 * stage];
+      x1 = s[0];
+      x2 = s[1];
+      y1 = s[2];
+      y2 = s[3];
+
+      for (i = 0; i < n; i++)
+        {
+          x   = src[i];
+          acc = (int64_t)c->b0 * x + (int64_t)c->b1 * x1 +
+                (int64_t)c->b2 * x2 - (int64_t)c->a1 * y1 -
+                (int64_t)c->a2 * y2;
+
+          x2     = x1;
+          x1     = x;
+          y2     = y1;
+          y1     = (b16_t)((acc + b16HALF) >> 16);
+          out[i] = y1;
+        }
+
+      s[0] = x1;
+      s[1] = x2;
+      s[2] = y1;
+      s[3] = y2;
+
+      /* The next section filters the output of this one */
+
+      src = out;
+    }
+}
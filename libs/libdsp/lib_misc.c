@@ -24,6 +24,10 @@
 
 #include <dsp.h>
 
+#ifdef CONFIG_LIBDSP_CORDIC
+#  include <nuttx/math/cordic.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -443,6 +447,13 @@ void phase_angle_update(FAR struct phase_angle_f32_s *angle, float val)
 
   angle->angle = val;
 
+#ifdef CONFIG_LIBDSP_CORDIC
+  if (cordic_sincosf(val, &angle->sin, &angle->cos) >= 0)
+    {
+      return;
+    }
+#endif
+
 #if CONFIG_LIBDSP_PRECISION == 1
   angle->sin = fast_sin2(val);
   angle->cos = fast_cos2(val);
@@ -24,6 +24,10 @@
 
 #include <dspb16.h>
 
+#ifdef CONFIG_LIBDSP_CORDIC
+#  include <nuttx/math/cordic.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -445,6 +449,13 @@ void phase_angle_update_b16(FAR struct phase_angle_b16_s *angle, b16_t val)
 
   angle->angle = val;
 
+#ifdef CONFIG_LIBDSP_CORDIC
+  if (cordic_sincos_b16(val, &angle->sin, &angle->cos) >= 0)
+    {
+      return;
+    }
+#endif
+
 #if CONFIG_LIBDSP_PRECISION == 0
   angle->sin = fast_sin_b16(val);
   angle->cos = fast_cos_b16(val);
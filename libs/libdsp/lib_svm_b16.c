@@ -144,6 +144,7 @@ static void svm3_duty_calc_b16(FAR struct svm3_state_b16_s *s,
   b16_t T0 = 0;
   b16_t T1 = 0;
   b16_t T2 = 0;
+  b16_t t_half = 0;
 
   /* Determine T1, T2 and T0 based on the sector */
 
@@ -204,55 +205,59 @@ static void svm3_duty_calc_b16(FAR struct svm3_state_b16_s *s,
 
   T0 = b16ONE - T1 - T2;
 
+  /* Half of it, rounded as b16mulb16(T0, b16HALF), without multiplying */
+
+  t_half = (T0 + 1) >> 1;
+
   /* Calculate duty cycle for 3 phase */
 
   switch (s->sector)
     {
       case 1:
         {
-          s->d_u = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_v = T2 + b16mulb16(T0, b16HALF);
-          s->d_w = b16mulb16(T0, b16HALF);
+          s->d_u = T1 + T2 + t_half;
+          s->d_v = T2 + t_half;
+          s->d_w = t_half;
           break;
         }
 
       case 2:
         {
-          s->d_u = T1 + b16mulb16(T0, b16HALF);
-          s->d_v = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_w = b16mulb16(T0, b16HALF);
+          s->d_u = T1 + t_half;
+          s->d_v = T1 + T2 + t_half;
+          s->d_w = t_half;
           break;
         }
 
       case 3:
         {
-          s->d_u = b16mulb16(T0, b16HALF);
-          s->d_v = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_w = T2 + b16mulb16(T0, b16HALF);
+          s->d_u = t_half;
+          s->d_v = T1 + T2 + t_half;
+          s->d_w = T2 + t_half;
           break;
         }
 
       case 4:
         {
-          s->d_u = b16mulb16(T0, b16HALF);
-          s->d_v = T1 + b16mulb16(T0, b16HALF);
-          s->d_w = T1 + T2 + b16mulb16(T0, b16HALF);
+          s->d_u = t_half;
+          s->d_v = T1 + t_half;
+          s->d_w = T1 + T2 + t_half;
           break;
         }
 
       case 5:
         {
-          s->d_u = T2 + b16mulb16(T0, b16HALF);
-          s->d_v = b16mulb16(T0, b16HALF);
-          s->d_w = T1 + T2 + b16mulb16(T0, b16HALF);
+          s->d_u = T2 + t_half;
+          s->d_v = t_half;
+          s->d_w = T1 + T2 + t_half;
           break;
         }
 
       case 6:
         {
-          s->d_u = T1 + T2 + b16mulb16(T0, b16HALF);
-          s->d_v = b16mulb16(T0, b16HALF);
-          s->d_w = T1 + b16mulb16(T0, b16HALF);
+          s->d_u = T1 + T2 + t_half;
+          s->d_v = t_half;
+          s->d_w = T1 + t_half;
           break;
         }
 
@@ -329,8 +334,7 @@ void svm3_b16(FAR struct svm3_state_b16_s *s, FAR ab_frame_b16_t *v_ab)
    * to obtain auxiliary frame which will be used in further calculations.
    */
 
-  ijk.a = b16mulb16(-b16HALF, v_ab->b) + b16mulb16(SQRT3_BY_TWO_B16,
-                                                   v_ab->a);
+  ijk.a = b16mac2b16(-b16HALF, v_ab->b, SQRT3_BY_TWO_B16, v_ab->a);
   ijk.b = v_ab->b;
   ijk.c = -ijk.b - ijk.a;
 
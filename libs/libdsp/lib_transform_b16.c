@@ -58,8 +58,7 @@ void clarke_transform_b16(FAR abc_frame_b16_t *abc,
   LIBDSP_DEBUGASSERT(ab != NULL);
 
   ab->a = abc->a;
-  ab->b = (b16mulb16(ONE_BY_SQRT3_B16, abc->a) +
-           b16mulb16(TWO_BY_SQRT3_B16, abc->b));
+  ab->b = b16mac2b16(ONE_BY_SQRT3_B16, abc->a, TWO_BY_SQRT3_B16, abc->b);
 }
 
 /****************************************************************************
@@ -87,8 +86,7 @@ void inv_clarke_transform_b16(FAR ab_frame_b16_t *ab,
   /* Assume non-power-invariant transform and balanced system */
 
   abc->a = ab->a;
-  abc->b = (b16mulb16(-b16HALF, ab->a) +
-            b16mulb16(SQRT3_BY_TWO_B16, ab->b));
+  abc->b = b16mac2b16(-b16HALF, ab->a, SQRT3_BY_TWO_B16, ab->b);
   abc->c = (-abc->a - abc->b);
 }
 
@@ -117,8 +115,8 @@ void park_transform_b16(FAR phase_angle_b16_t *angle,
   LIBDSP_DEBUGASSERT(ab != NULL);
   LIBDSP_DEBUGASSERT(dq != NULL);
 
-  dq->d = b16mulb16(angle->cos, ab->a) + b16mulb16(angle->sin, ab->b);
-  dq->q = b16mulb16(angle->cos, ab->b) - b16mulb16(angle->sin, ab->a);
+  dq->d = b16mac2b16(angle->cos, ab->a, angle->sin, ab->b);
+  dq->q = b16mac2b16(angle->cos, ab->b, -angle->sin, ab->a);
 }
 
 /****************************************************************************
@@ -146,6 +144,106 @@ void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
   LIBDSP_DEBUGASSERT(dq != NULL);
   LIBDSP_DEBUGASSERT(ab != NULL);
 
-  ab->a = b16mulb16(angle->cos, dq->d) - b16mulb16(angle->sin, dq->q);
-  ab->b = b16mulb16(angle->cos, dq->q) + b16mulb16(angle->sin, dq->d);
+  ab->a = b16mac2b16(angle->cos, dq->d, -angle->sin, dq->q);
+  ab->b = b16mac2b16(angle->cos, dq->q, angle->sin, dq->d);
+}
+
+/****************************************************************************
+ * Name: clarke_transform_batch_b16
+ *
+ * Description:
+ *   Clarke transform of the n axes of a multi-axis controller.
+ *
+ * Input Parameters:
+ *   abc - (in) array of n abc frames
+ *   ab  - (out) array of n alpha-beta frames
+ *   n   - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch_b16(FAR abc_frame_b16_t *abc,
+                                FAR ab_frame_b16_t *ab, int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = abc[i].a;
+      ab[i].b = b16mac2b16(ONE_BY_SQRT3_B16, abc[i].a,
+                           TWO_BY_SQRT3_B16, abc[i].b);
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_batch_b16
+ *
+ * Description:
+ *   Park transform of the n axes of a multi-axis controller.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   ab    - (in) array of n alpha-beta frames
+ *   dq    - (out) array of n direct-quadrature frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch_b16(FAR phase_angle_b16_t *angle,
+                              FAR ab_frame_b16_t *ab,
+                              FAR dq_frame_b16_t *dq, int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      dq[i].d = b16mac2b16(angle[i].cos, ab[i].a, angle[i].sin, ab[i].b);
+      dq[i].q = b16mac2b16(angle[i].cos, ab[i].b, -angle[i].sin, ab[i].a);
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch_b16
+ *
+ * Description:
+ *   Inverse Park transform of the n axes of a multi-axis controller.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   dq    - (in) array of n direct-quadrature frames
+ *   ab    - (out) array of n alpha-beta frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch_b16(FAR phase_angle_b16_t *angle,
+                                  FAR dq_frame_b16_t *dq,
+                                  FAR ab_frame_b16_t *ab, int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = b16mac2b16(angle[i].cos, dq[i].d, -angle[i].sin, dq[i].q);
+      ab[i].b = b16mac2b16(angle[i].cos, dq[i].q, angle[i].sin, dq[i].d);
+    }
 }
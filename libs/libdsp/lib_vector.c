@@ -0,0 +1,318 @@
+/****************************************************************************
+ * libs/libdsp/lib_vector.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dsp.h>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+#  include <arm_mve.h>
+#  define VECTOR_MVE 1
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define VECTOR_NEON 1
+#elif defined(__riscv_v) && defined(__riscv_v_intrinsic) && \
+      __riscv_v_intrinsic >= 12000
+#  include <riscv_vector.h>
+#  define VECTOR_RVV 1
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 in three parts, for an exact reduction of the argument of sin and
+ * cos in the first few thousand periods.
+ */
+
+#define PIO2_HI        (1.5703125f)
+#define PIO2_MID       (4.837512969970703125e-4f)
+#define PIO2_LO        (7.54978995489188216e-8f)
+#define TWO_BY_PI      (0.636619772367581343f)
+
+/* ln(2) in two parts and the arguments beyond which exp overflows or
+ * underflows to zero
+ */
+
+#define LN2_HI         (0.693359375f)
+#define LN2_LO         (-2.12194440e-4f)
+#define LOG2E          (1.44269504088896341f)
+#define EXP_MAX        (89.0f)
+#define EXP_MIN        (-104.0f)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vector_sincos1
+ *
+ * Description:
+ *   sin(x + quadrant * pi / 2) without a branch on the data, so that the
+ *   compiler can vectorize the loops that call it.  The error is below
+ *   2 ulp for |x| < 8192.
+ *
+ ****************************************************************************/
+
+static inline float vector_sincos1(float x, int32_t quadrant)
+{
+  float r;
+  float r2;
+  float s;
+  float c;
+  int32_t k;
+
+  k  = (int32_t)(x * TWO_BY_PI + copysignf(0.5f, x));
+  r  = x - (float)k * PIO2_HI;
+  r  = r - (float)k * PIO2_MID;
+  r  = r - (float)k * PIO2_LO;
+  r2 = r * r;
+  k += quadrant;
+
+  /* Minimax polynomials on [-pi/4, pi/4] */
+
+  s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f +
+                    r2 * -1.9515295891e-4f));
+  c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f +
+                    r2 * (-1.388731625493765e-3f +
+                    r2 * 2.443315711809948e-5f));
+
+  r = (k & 1) ? c : s;
+  return (k & 2) ? -r : r;
+}
+
+/****************************************************************************
+ * Name: vector_exp1
+ *
+ * Description:
+ *   exp(x) without a branch on the data.  The argument is clamped so that
+ *   the result overflows to infinity or underflows to zero in the final
+ *   scaling instead.  The error is below 1 ulp for normal results.
+ *
+ ****************************************************************************/
+
+static inline float vector_exp1(float x)
+{
+  union
+  {
+    uint32_t i;
+    float f;
+  } scale1;
+
+  union
+  {
+    uint32_t i;
+    float f;
+  } scale2;
+
+  float r;
+  float p;
+  int32_t k;
+
+  x = fminf(fmaxf(x, EXP_MIN), EXP_MAX);
+
+  k = (int32_t)(x * LOG2E + copysignf(0.5f, x));
+  r = x - (float)k * LN2_HI;
+  r = r - (float)k * LN2_LO;
+
+  p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * r * r + r + 1.0f;
+
+  /* Scale by 2^k in two steps, as k lies in [-150, 128] */
+
+  scale1.i = (uint32_t)((k >> 1) + 127) << 23;
+  scale2.i = (uint32_t)(k - (k >> 1) + 127) << 23;
+  return p * scale1.f * scale2.f;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vector_dot
+ *
+ * Description:
+ *   Return the dot product of two vectors.  The products are summed in a
+ *   different order by the vector instructions, so the result may differ
+ *   from a sequential sum in the last bits.
+ *
+ * Input Parameters:
+ *   a - (in) first vector
+ *   b - (in) second vector
+ *   n - (in) number of elements
+ *
+ * Returned Value:
+ *   The sum of a[i] * b[i]
+ *
+ ****************************************************************************/
+
+float vector_dot(FAR const float *a, FAR const float *b, size_t n)
+{
+  float sum = 0.0f;
+  size_t i = 0;
+
+  LIBDSP_DEBUGASSERT(n == 0 || (a != NULL && b != NULL));
+
+#if defined(VECTOR_MVE)
+  float32x4_t acc = vdupq_n_f32(0.0f);
+
+  for (; i + 4 <= n; i += 4)
+    {
+      acc = vfmaq_f32(acc, vld1q_f32(&a[i]), vld1q_f32(&b[i]));
+    }
+
+  sum = (vgetq_lane_f32(acc, 0) + vgetq_lane_f32(acc, 1)) +
+        (vgetq_lane_f32(acc, 2) + vgetq_lane_f32(acc, 3));
+#elif defined(VECTOR_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  float32x2_t acc;
+
+  /* Two accumulators hide the latency of the multiply-accumulate */
+
+  for (; i + 8 <= n; i += 8)
+    {
+      acc0 = vmlaq_f32(acc0, vld1q_f32(&a[i]), vld1q_f32(&b[i]));
+      acc1 = vmlaq_f32(acc1, vld1q_f32(&a[i + 4]), vld1q_f32(&b[i + 4]));
+    }
+
+  acc0 = vaddq_f32(acc0, acc1);
+  acc  = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+  sum  = vget_lane_f32(vpadd_f32(acc, acc), 0);
+#elif defined(VECTOR_RVV)
+  size_t vlmax = __riscv_vsetvlmax_e32m1();
+  vfloat32m1_t acc = __riscv_vfmv_v_f_f32m1(0.0f, vlmax);
+  size_t vl;
+
+  for (; i < n; i += vl)
+    {
+      vl  = __riscv_vsetvl_e32m1(n - i);
+      acc = __riscv_vfmacc_vv_f32m1_tu(acc, __riscv_vle32_v_f32m1(&a[i], vl),
+                                       __riscv_vle32_v_f32m1(&b[i], vl), vl);
+    }
+
+  sum = __riscv_vfmv_f_s_f32m1_f32(
+          __riscv_vfredusum_vs_f32m1_f32m1(acc,
+                                           __riscv_vfmv_v_f_f32m1(0.0f, 1),
+                                           vlmax));
+#endif
+
+  for (; i < n; i++)
+    {
+      sum += a[i] * b[i];
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Name: vector_sin
+ *
+ * Description:
+ *   Compute the sine of each element of a vector.  The error is below 2 ulp
+ *   for arguments of magnitude below 8192.
+ *
+ * Input Parameters:
+ *   in  - (in) the arguments in radians
+ *   out - (out) the results, which may be the same as in
+ *   n   - (in) number of elements
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vector_sin(FAR const float *in, FAR float *out, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(n == 0 || (in != NULL && out != NULL));
+
+  for (i = 0; i < n; i++)
+    {
+      out[i] = vector_sincos1(in[i], 0);
+    }
+}
+
+/****************************************************************************
+ * Name: vector_cos
+ *
+ * Description:
+ *   Compute the cosine of each element of a vector, with the accuracy of
+ *   vector_sin().
+ *
+ * Input Parameters:
+ *   in  - (in) the arguments in radians
+ *   out - (out) the results, which may be the same as in
+ *   n   - (in) number of elements
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vector_cos(FAR const float *in, FAR float *out, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(n == 0 || (in != NULL && out != NULL));
+
+  for (i = 0; i < n; i++)
+    {
+      out[i] = vector_sincos1(in[i], 1);
+    }
+}
+
+/****************************************************************************
+ * Name: vector_exp
+ *
+ * Description:
+ *   Compute the exponential of each element of a vector.  The error is
+ *   below 1 ulp for normal results.  The result for a NaN is undefined.
+ *
+ * Input Parameters:
+ *   in  - (in) the arguments
+ *   out - (out) the results, which may be the same as in
+ *   n   - (in) number of elements
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vector_exp(FAR const float *in, FAR float *out, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(n == 0 || (in != NULL && out != NULL));
+
+  for (i = 0; i < n; i++)
+    {
+      out[i] = vector_exp1(in[i]);
+    }
+}
@@ -0,0 +1,113 @@
+/****************************************************************************
+ * libs/libdsp/lib_vector_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+
+#if defined(__ARM_FEATURE_MVE)
+#  include <arm_mve.h>
+#  define VECTOR_MVE 1
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define VECTOR_NEON 1
+#elif defined(__riscv_v) && defined(__riscv_v_intrinsic) && \
+      __riscv_v_intrinsic >= 12000
+#  include <riscv_vector.h>
+#  define VECTOR_RVV 1
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vector_dot_b16
+ *
+ * Description:
+ *   Return the dot product of two b16 vectors.  The products are summed
+ *   exactly on 64 bits and rounded once.  On Armv7E-M each product is one
+ *   SMLAL; MVE, NEON and the RISC-V vector extension sum several products
+ *   per instruction.  The result is not saturated.
+ *
+ * Input Parameters:
+ *   a - (in) first vector
+ *   b - (in) second vector
+ *   n - (in) number of elements
+ *
+ * Returned Value:
+ *   The sum of a[i] * b[i]
+ *
+ ****************************************************************************/
+
+b16_t vector_dot_b16(FAR const b16_t *a, FAR const b16_t *b, size_t n)
+{
+  int64_t acc = 0;
+  size_t i = 0;
+
+  LIBDSP_DEBUGASSERT(n == 0 || (a != NULL && b != NULL));
+
+#if defined(VECTOR_MVE)
+  for (; i + 4 <= n; i += 4)
+    {
+      acc = vmlaldavaq_s32(acc, vld1q_s32(&a[i]), vld1q_s32(&b[i]));
+    }
+#elif defined(VECTOR_NEON)
+  int64x2_t acc2 = vdupq_n_s64(0);
+  int32x4_t va;
+  int32x4_t vb;
+
+  for (; i + 4 <= n; i += 4)
+    {
+      va   = vld1q_s32(&a[i]);
+      vb   = vld1q_s32(&b[i]);
+      acc2 = vmlal_s32(acc2, vget_low_s32(va), vget_low_s32(vb));
+      acc2 = vmlal_s32(acc2, vget_high_s32(va), vget_high_s32(vb));
+    }
+
+  acc = vgetq_lane_s64(acc2, 0) + vgetq_lane_s64(acc2, 1);
+#elif defined(VECTOR_RVV)
+  size_t vlmax = __riscv_vsetvlmax_e64m2();
+  vint64m2_t acc2 = __riscv_vmv_v_x_i64m2(0, vlmax);
+  size_t vl;
+
+  for (; i < n; i += vl)
+    {
+      vl   = __riscv_vsetvl_e32m1(n - i);
+      acc2 = __riscv_vwmacc_vv_i64m2_tu(acc2,
+                                        __riscv_vle32_v_i32m1(&a[i], vl),
+                                        __riscv_vle32_v_i32m1(&b[i], vl),
+                                        vl);
+    }
+
+  acc = __riscv_vmv_x_s_i64m1_i64(
+          __riscv_vredsum_vs_i64m2_i64m1(acc2, __riscv_vmv_v_x_i64m1(0, 1),
+                                         vlmax));
+#endif
+
+  for (; i < n; i++)
+    {
+      acc += (int64_t)a[i] * b[i];
+    }
+
+  return (b16_t)((acc + b16HALF) >> 16);
+}
@@ -62,6 +62,13 @@ EXTERN struct nx_font_s g_fonts;
  * Public Function Prototypes
  ****************************************************************************/
 
+/* Renders a glyph as an 8-bit alpha mask, see nxf_cache_connectmask() */
+
+int nxf_convert_mask(FAR uint8_t *dest, uint16_t height,
+                     uint16_t width, uint16_t stride,
+                     FAR const struct nx_fontbitmap_s *bm,
+                     nxgl_mxpixel_t color);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -35,6 +35,16 @@
 #include <nuttx/nx/nxfonts.h>
 
 #include "nxcontext.h"
+#include "nxfonts.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of hash buckets of a font cache, a power of two */
+
+#define NXF_HASHSIZE     32
+#define NXF_HASH(ch)     ((ch) & (NXF_HASHSIZE - 1))
 
 /****************************************************************************
  * Private Types
@@ -59,14 +69,21 @@ struct nxfonts_fcache_s
   uint8_t maxglyphs;                   /* Maximum size of glyph[] array */
   uint8_t nglyphs;                     /* Current size of glyph[] array */
   uint8_t bpp;                         /* Bits per pixel */
+  bool mask;                           /* Glyphs are alpha masks */
+  bool inbatch;                        /* nxf_cache_getglyphs() is active */
+  uint32_t batch;                      /* Stamp of the last batch */
   nxgl_mxpixel_t fgcolor;              /* Foreground color */
   nxgl_mxpixel_t bgcolor;              /* Background color */
   nxf_renderer_t renderer;             /* Font renderer */
 
-  /* Glyph cache data storage */
+  /* Glyph cache data storage.  The glyphs are indexed by their character
+   * code and kept in the order of their use, the most recently used one
+   * at the head.
+   */
 
   FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
   FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+  FAR struct nxfonts_glyph_s *hash[NXF_HASHSIZE];
 };
 
 /****************************************************************************
@@ -124,47 +141,45 @@ static inline void nxf_removecache(FAR struct nxfonts_fcache_s *fcache,
  ****************************************************************************/
 
 static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
-                                   FAR struct nxfonts_glyph_s *glyph,
-                                   FAR struct nxfonts_glyph_s *prev)
+                                   FAR struct nxfonts_glyph_s *glyph)
 {
+  FAR struct nxfonts_glyph_s **link;
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Remove the glyph for the list.  First check for removal from the head
-   * (which, I think, never actually happens).
-   */
+  /* Remove the glyph from the list */
 
-  if (prev == NULL)
+  if (glyph->blink == NULL)
     {
-      /* Replace the head with the node following glyph */
-
       priv->head = glyph->flink;
-
-      /* If there is no node following glyph, then the list is empty */
-
-      if (priv->head == NULL)
-        {
-          priv->tail = NULL;
-        }
     }
-
-  /* Check for removal from the tail (we know that the list cannot become
-   * empty in either of the next two cases).
-   */
-
-  else if (glyph->flink == NULL)
+  else
     {
-      priv->tail = prev;
-      prev->flink = NULL;
+      glyph->blink->flink = glyph->flink;
     }
 
-  /* No.. Remove from mid-list */
-
+  if (glyph->flink == NULL)
+    {
+      priv->tail = glyph->blink;
+    }
   else
     {
-      prev->flink = glyph->flink;
+      glyph->flink->blink = glyph->blink;
     }
 
   glyph->flink = NULL;
+  glyph->blink = NULL;
+
+  /* And from its hash bucket */
+
+  for (link = &priv->hash[NXF_HASH(glyph->code)]; *link != glyph;
+       link = &(*link)->hlink)
+    {
+      DEBUGASSERT(*link != NULL);
+    }
+
+  *link = glyph->hlink;
+  glyph->hlink = NULL;
 
   /* Decrement the count of glyphs in the font cache */
 
@@ -183,19 +198,31 @@ static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
 static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
                                 FAR struct nxfonts_glyph_s *glyph)
 {
+  FAR struct nxfonts_glyph_s **bucket = &priv->hash[NXF_HASH(glyph->code)];
+
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
   /* Add the glyph to the head of the list */
 
   glyph->flink = priv->head;
+  glyph->blink = NULL;
 
   if (priv->head == NULL)
     {
       priv->tail = glyph;
     }
+  else
+    {
+      priv->head->blink = glyph;
+    }
 
   priv->head = glyph;
 
+  /* And to its hash bucket */
+
+  glyph->hlink = *bucket;
+  *bucket      = glyph;
+
   /* Increment the count of glyphs in the font cache. */
 
   DEBUGASSERT(priv->nglyphs < priv->maxglyphs);
@@ -207,17 +234,10 @@ static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
  *
  * Description:
  *   Find the glyph for the specific character 'ch' in the list of pre-
- *   rendered fonts in the font cache.
- *
- *   This is logically a part of nxf_cache_getglyph().  nxf_cache_getglyph()
- *   will attempt to find the cached glyph before rendering a new one.  So
- *   this function has two unexpected side-effects:  (1) If the font cache
- *   is full and the font is not found, then the least-recently-used glyph
- *   is deleted to make space for the new glyph that will be allocated.
- *
- *   (2) If the glyph is found, then it is moved to the head of the list of
- *   glyphs since it is now the most recently used (leaving the least
- *   recently used glyph at the tail of the list).
+ *   rendered fonts in the font cache.  If the glyph is found, then it is
+ *   moved to the head of the list of glyphs since it is now the most
+ *   recently used (leaving the least recently used glyph at the tail of
+ *   the list).
  *
  * Assumptions:
  *   The caller has exclusive access to the font cache.
@@ -228,54 +248,61 @@ static FAR struct nxfonts_glyph_s *
 nxf_findglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph;
-  FAR struct nxfonts_glyph_s *prev;
 
   ginfo("fcache=%p ch=%c (%02x)\n",
         priv, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Try to find the glyph in the list of pre-rendered glyphs */
+  /* Try to find the glyph in its hash bucket */
 
-  for (prev = NULL, glyph = priv->head;
-       glyph != NULL;
-       prev = glyph, glyph = glyph->flink)
+  for (glyph = priv->hash[NXF_HASH(ch)]; glyph != NULL;
+       glyph = glyph->hlink)
     {
-      /* Check if we found the glyph for this character */
-
       if (glyph->code == ch)
         {
           /* This is now the most recently used glyph.  Move it to the head
            * of the list (if it is not already at the head of the list).
            */
 
-          if (prev != NULL)
+          if (glyph != priv->head)
             {
-              nxf_removeglyph(priv, glyph, prev);
+              nxf_removeglyph(priv, glyph);
               nxf_addglyph(priv, glyph);
             }
 
-          /* And return the glyph that we found */
-
-          return glyph;
+          break;
         }
+    }
 
-      /* Is this the last glyph in the list?  Has the cache reached its
-       * limit for the number of cached fonts?
-       */
+  return glyph;
+}
 
-      if (glyph->flink == NULL && priv->nglyphs >= priv->maxglyphs)
-        {
-          /* Yes.. then remove it from the list and free the glyph memory.
-           * We do this because we have all of the information in hand now
-           * and we will surely need to have this space later.
-           */
+/****************************************************************************
+ * Name: nxf_evictglyph
+ *
+ * Description:
+ *   Free the least recently used glyph to make space for a new one, unless
+ *   it is used by the current batch.
+ *
+ * Returned Value:
+ *   true if a glyph was freed.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the font cache.
+ *
+ ****************************************************************************/
 
-          nxf_removeglyph(priv, glyph, prev);
-          lib_free(glyph);
-          return NULL;
-        }
+static bool nxf_evictglyph(FAR struct nxfonts_fcache_s *priv)
+{
+  FAR struct nxfonts_glyph_s *glyph = priv->tail;
+
+  if (glyph == NULL || (priv->inbatch && glyph->stamp == priv->batch))
+    {
+      return false;
     }
 
-  return NULL;
+  nxf_removeglyph(priv, glyph);
+  lib_free(glyph);
+  return true;
 }
 
 /****************************************************************************
@@ -295,6 +322,14 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
   UNUSED(row); /* Not used in all configurations */
   UNUSED(col);
 
+  /* The background of an alpha mask is transparent */
+
+  if (priv->mask)
+    {
+      memset(glyph->bitmap, 0, glyph->stride * glyph->height);
+      return;
+    }
+
   /* Initialize the glyph memory to the background color. */
 
 #if !defined(CONFIG_NXFONTS_DISABLE_1BPP) || !defined(CONFIG_NXFONTS_DISABLE_2BPP) || \
@@ -496,6 +531,7 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
       glyph->width  = width;
       glyph->height = height;
       glyph->stride = stride;
+      glyph->stamp  = priv->batch;
 
       /* Initialize the glyph memory to the background color. */
 
@@ -523,6 +559,56 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
   return glyph;
 }
 
+/****************************************************************************
+ * Name: nxf_getglyph
+ *
+ * Description:
+ *   Get the glyph for the character code 'ch' from the font cache,
+ *   rendering it if is not cached yet.
+ *
+ * Returned Value:
+ *   OK with the glyph in *glyph; -ENOENT if the font has no glyph for the
+ *   character code, -ENOSPC if the cache is full of the glyphs of the
+ *   current batch, or -ENOMEM.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the font cache.
+ *
+ ****************************************************************************/
+
+static int nxf_getglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch,
+                        FAR struct nxfonts_glyph_s **glyph)
+{
+  FAR const struct nx_fontbitmap_s *fbm;
+
+  /* First, try to find the glyph in the cache of pre-rendered glyphs */
+
+  *glyph = nxf_findglyph(priv, ch);
+  if (*glyph != NULL)
+    {
+      (*glyph)->stamp = priv->batch;
+      return OK;
+    }
+
+  /* No, it is not cached... Does the code map to a font? */
+
+  fbm = nxf_getbitmap(priv->font, ch);
+  if (fbm == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* Yes.. make space and render the glyph for the font */
+
+  if (priv->nglyphs >= priv->maxglyphs && !nxf_evictglyph(priv))
+    {
+      return -ENOSPC;
+    }
+
+  *glyph = nxf_renderglyph(priv, fbm, ch);
+  return *glyph != NULL ? OK : -ENOMEM;
+}
+
 /****************************************************************************
  * Name: nxf_findcache
  *
@@ -536,7 +622,7 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
 
 static FAR struct nxfonts_fcache_s *
 nxf_findcache(enum nx_fontid_e fontid, nxgl_mxpixel_t fgcolor,
-              nxgl_mxpixel_t bgcolor, int bpp)
+              nxgl_mxpixel_t bgcolor, int bpp, bool mask)
 {
   FAR struct nxfonts_fcache_s *fcache;
 
@@ -552,7 +638,8 @@ nxf_findcache(enum nx_fontid_e fontid, nxgl_mxpixel_t fgcolor,
       if (fcache->fontid  == fontid &&
           fcache->fgcolor == fgcolor &&
           fcache->bgcolor == bgcolor &&
-          fcache->bpp     == bpp)
+          fcache->bpp     == bpp &&
+          fcache->mask    == mask)
         {
           /* Yes... return it */
 
@@ -566,49 +653,28 @@ nxf_findcache(enum nx_fontid_e fontid, nxgl_mxpixel_t fgcolor,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: nxf_cache_connect
+ * Name: nxf_connect
  *
  * Description:
- *   Create a new font cache for the provided 'fontid'.  If the cache
- *   already, then just increment a reference count return the handle for
- *   the existing font cache.
- *
- * Input Parameters:
- *   fontid    - Identifies the font supported by this cache
- *   fgcolor   - Foreground color
- *   bgcolor   - Background color
- *   bpp       - Bits per pixel
- *   maxglyphs - Maximum number of glyphs permitted in the cache
- *
- * Returned Value:
- *   On success a non-NULL handle is returned that then may sequently be
- *   used with nxf_getglyph() to extract fonts from the font cache.  NULL
- *   returned on any failure with the errno value set to indicate the nature
- *   of the error.
+ *   Find or create the font cache with the characteristics, as
+ *   nxf_cache_connect() and nxf_cache_connectmask() do.
  *
  ****************************************************************************/
 
-FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
-                         nxgl_mxpixel_t fgcolor, nxgl_mxpixel_t bgcolor,
-                         int bpp, int maxglyphs)
+static FCACHE nxf_connect(enum nx_fontid_e fontid,
+                          nxgl_mxpixel_t fgcolor, nxgl_mxpixel_t bgcolor,
+                          int bpp, bool mask, int maxglyphs)
 {
   FAR struct nxfonts_fcache_s *priv;
   int errcode;
 
-  ginfo("fontid=%d fgcolor=%ju bgcolor=%ju bpp=%d maxglyphs=%d\n",
-        fontid, (uintmax_t)fgcolor, (uintmax_t)bgcolor, bpp, maxglyphs);
-
   /* Get exclusive access to the font cache list */
 
   nxmutex_lock(&g_cachelock);
 
   /* Find a font cache with the matching font characteristics */
 
-  priv = nxf_findcache(fontid, fgcolor, bgcolor, bpp);
+  priv = nxf_findcache(fontid, fgcolor, bgcolor, bpp, mask);
   if (priv == NULL)
     {
       /* There isn't one... we will have to create a new font cache for this
@@ -632,6 +698,7 @@ FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
       priv->fclients  = 1;
       priv->maxglyphs = maxglyphs;
       priv->bpp       = bpp;
+      priv->mask      = mask;
       priv->fgcolor   = fgcolor;
       priv->bgcolor   = bgcolor;
 
@@ -642,8 +709,12 @@ FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
        * 24).
        */
 
-      switch (bpp)
+      switch (mask ? 0 : bpp)
         {
+        case 0:
+          priv->renderer = (nxf_renderer_t)nxf_convert_mask;
+          break;
+
 #ifndef CONFIG_NXFONTS_DISABLE_1BPP
         case 1:
           priv->renderer = (nxf_renderer_t)nxf_convert_1bpp;
@@ -733,6 +804,70 @@ errout_with_lock:
   return NULL;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxf_cache_connect
+ *
+ * Description:
+ *   Create a new font cache for the provided 'fontid'.  If the cache
+ *   already, then just increment a reference count return the handle for
+ *   the existing font cache.
+ *
+ * Input Parameters:
+ *   fontid    - Identifies the font supported by this cache
+ *   fgcolor   - Foreground color
+ *   bgcolor   - Background color
+ *   bpp       - Bits per pixel
+ *   maxglyphs - Maximum number of glyphs permitted in the cache
+ *
+ * Returned Value:
+ *   On success a non-NULL handle is returned that then may sequently be
+ *   used with nxf_getglyph() to extract fonts from the font cache.  NULL
+ *   returned on any failure with the errno value set to indicate the nature
+ *   of the error.
+ *
+ ****************************************************************************/
+
+FCACHE nxf_cache_connect(enum nx_fontid_e fontid,
+                         nxgl_mxpixel_t fgcolor, nxgl_mxpixel_t bgcolor,
+                         int bpp, int maxglyphs)
+{
+  ginfo("fontid=%d fgcolor=%ju bgcolor=%ju bpp=%d maxglyphs=%d\n",
+        fontid, (uintmax_t)fgcolor, (uintmax_t)bgcolor, bpp, maxglyphs);
+
+  return nxf_connect(fontid, fgcolor, bgcolor, bpp, false, maxglyphs);
+}
+
+/****************************************************************************
+ * Name: nxf_cache_connectmask
+ *
+ * Description:
+ *   Create a new font cache for the provided 'fontid' whose glyphs are
+ *   8-bit alpha masks, 0 being transparent and 255 opaque, instead of
+ *   pixels of a color.  One such cache serves the clients drawing the font
+ *   in any color:  They draw the glyphs with nxf_blendglyph().  If the
+ *   cache already exists, then just increment a reference count return the
+ *   handle for the existing font cache.
+ *
+ * Input Parameters:
+ *   fontid    - Identifies the font supported by this cache
+ *   maxglyphs - Maximum number of glyphs permitted in the cache
+ *
+ * Returned Value:
+ *   As for nxf_cache_connect().
+ *
+ ****************************************************************************/
+
+FCACHE nxf_cache_connectmask(enum nx_fontid_e fontid, int maxglyphs)
+{
+  ginfo("fontid=%d maxglyphs=%d\n", fontid, maxglyphs);
+
+  return nxf_connect(fontid, 0, 0, 8, true, maxglyphs);
+}
+
 /****************************************************************************
  * Name: nxf_cache_disconnect
  *
@@ -861,30 +996,74 @@ nxf_cache_getglyph(FCACHE fhandle, uint8_t ch)
 {
   FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
   FAR struct nxfonts_glyph_s *glyph;
-  FAR const struct nx_fontbitmap_s *fbm;
 
   ginfo("ch=%c (%02x)\n", (ch >= 32 && ch < 128) ? ch : '.', ch);
 
   /* Get exclusive access to the font cache */
 
   nxmutex_lock(&priv->flock);
+  if (nxf_getglyph(priv, ch, &glyph) < 0)
+    {
+      glyph = NULL;
+    }
 
-  /* First, try to find the glyph in the cache of pre-rendered glyphs */
+  nxmutex_unlock(&priv->flock);
+  return glyph;
+}
 
-  glyph = nxf_findglyph(priv, ch);
-  if (glyph == NULL)
-    {
-      /* No, it is not cached... Does the code map to a font? */
+/****************************************************************************
+ * Name: nxf_cache_getglyphs
+ *
+ * Description:
+ *   Get the font glyphs for a string of character codes at once, which
+ *   locks the font cache only once.  No glyph of the string evicts another
+ *   one of the same string:  If the string has more distinct characters
+ *   than the cache can hold, only the glyphs of its beginning are
+ *   returned.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by
+ *             nxf_cache_connect() or nxf_cache_connectmask()
+ *   str     - The character codes
+ *   len     - The number of character codes
+ *   glyphs  - The glyphs of the character codes, NULL for those that the
+ *             font does not have.  They remain valid until the font cache
+ *             is used again.
+ *
+ * Returned Value:
+ *   The number of glyphs returned.
+ *
+ ****************************************************************************/
 
-      fbm = nxf_getbitmap(priv->font, ch);
-      if (fbm)
-        {
-          /* Yes.. render the glyph for the font */
+int nxf_cache_getglyphs(FCACHE fhandle, FAR const uint8_t *str, int len,
+                        FAR const struct nxfonts_glyph_s **glyphs)
+{
+  FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
+  FAR struct nxfonts_glyph_s *glyph;
+  int ret;
+  int i;
+
+  DEBUGASSERT(priv != NULL && str != NULL && glyphs != NULL);
+
+  nxmutex_lock(&priv->flock);
+
+  /* Stamp the glyphs of this batch, so that they are not evicted */
 
-          glyph = nxf_renderglyph(priv, fbm, ch);
+  priv->batch++;
+  priv->inbatch = true;
+
+  for (i = 0; i < len; i++)
+    {
+      ret = nxf_getglyph(priv, str[i], &glyph);
+      if (ret == -ENOSPC || ret == -ENOMEM)
+        {
+          break;
         }
+
+      glyphs[i] = ret < 0 ? NULL : glyph;
     }
 
+  priv->inbatch = false;
   nxmutex_unlock(&priv->flock);
-  return glyph;
+  return i;
 }
@@ -0,0 +1,247 @@
+/****************************************************************************
+ * libs/libnx/nxfonts/nxfonts_mask.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Glyphs stored as 8-bit alpha masks, that nxf_cache_connectmask() caches
+ * once for every color and nxf_blendglyph() draws in any color.  The fonts
+ * are bitmaps, so their masks only hold 0 and 255 for now, but the blender
+ * handles any coverage.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <fixedmath.h>
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "nxfonts.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The blend fraction of an alpha value, 255 being almost b16ONE */
+
+#define NXF_ALPHA2FRAC(a) ((ub16_t)(a) * 257)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxf_convert_mask
+ *
+ * Description:
+ *   Convert the 1BPP font to an 8-bit alpha mask.  dest must be cleared.
+ *
+ * Input Parameters:
+ *   dest   - The destination mask
+ *   height - The max height of the returned char in rows
+ *   width  - The max width of the returned char in pixels
+ *   stride - The width of the destination buffer in bytes
+ *   bm     - Describes the character glyph to convert
+ *   color  - Unused
+ *
+ * Returned Value:
+ *   OK on Success, ERROR: on failure with errno set appropriately.
+ *
+ ****************************************************************************/
+
+int nxf_convert_mask(FAR uint8_t *dest, uint16_t height,
+                     uint16_t width, uint16_t stride,
+                     FAR const struct nx_fontbitmap_s *bm,
+                     nxgl_mxpixel_t color)
+{
+  FAR const uint8_t *sptr;
+  FAR uint8_t *line;
+  FAR uint8_t *dptr;
+  uint8_t bmbyte;
+  int bmbit;
+  int bmndx;
+  int row;
+  int col;
+
+  UNUSED(color);
+
+  line   = dest + bm->metric.yoffset * stride + bm->metric.xoffset;
+  height = ngl_min(bm->metric.height, height - bm->metric.yoffset);
+  width  = ngl_min(bm->metric.width, width - bm->metric.xoffset);
+  sptr   = bm->bitmap;
+
+  for (row = 0; row < height; row++, line += stride)
+    {
+      col  = 0;
+      dptr = line;
+
+      for (bmndx = 0; bmndx < bm->metric.stride; bmndx++)
+        {
+          bmbyte = *sptr++;
+
+          for (bmbit = 7; bmbit >= 0 && col < width; bmbit--, col++)
+            {
+              *dptr++ = (bmbyte & (1 << bmbit)) ? 255 : 0;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxf_blendglyph
+ *
+ * Description:
+ *   Draw a glyph of a font cache created by nxf_cache_connectmask() in a
+ *   color over the pixels in memory, e.g. those of a framebuffer or of a
+ *   RAM-backed window.  The transparent pixels of the glyph are left
+ *   unchanged.
+ *
+ * Input Parameters:
+ *   dest       - The address of the top, left pixel of the glyph
+ *   deststride - The length of the rows of the destination in bytes
+ *   bpp        - The pixel depth of the destination: 8, 16, 24 or 32
+ *   glyph      - The glyph
+ *   color      - The color of the glyph
+ *
+ * Returned Value:
+ *   OK on success; -ENOSYS if the pixel depth is not supported.  At 8 bpp
+ *   the color is not blended, but drawn where the glyph is mostly opaque.
+ *
+ ****************************************************************************/
+
+int nxf_blendglyph(FAR void *dest, unsigned int deststride, int bpp,
+                   FAR const struct nxfonts_glyph_s *glyph,
+                   nxgl_mxpixel_t color)
+{
+  FAR const uint8_t *sptr;
+  FAR uint8_t *line = dest;
+  uint8_t alpha;
+  int row;
+  int col;
+
+  DEBUGASSERT(dest != NULL && glyph != NULL);
+
+  for (row = 0; row < glyph->height; row++, line += deststride)
+    {
+      sptr = &glyph->bitmap[row * glyph->stride];
+
+      switch (bpp)
+        {
+          case 8:
+            {
+              FAR uint8_t *dptr = line;
+
+              for (col = 0; col < glyph->width; col++, dptr++)
+                {
+                  if (sptr[col] >= 128)
+                    {
+                      *dptr = (uint8_t)color;
+                    }
+                }
+            }
+            break;
+
+#ifndef CONFIG_NX_DISABLE_16BPP
+          case 16:
+            {
+              FAR uint16_t *dptr = (FAR uint16_t *)line;
+
+              for (col = 0; col < glyph->width; col++, dptr++)
+                {
+                  alpha = sptr[col];
+                  if (alpha == 255)
+                    {
+                      *dptr = (uint16_t)color;
+                    }
+                  else if (alpha != 0)
+                    {
+                      *dptr = nxglib_rgb565_blend((uint16_t)color, *dptr,
+                                                  NXF_ALPHA2FRAC(alpha));
+                    }
+                }
+            }
+            break;
+#endif
+
+#if !defined(CONFIG_NX_DISABLE_24BPP) || !defined(CONFIG_NX_DISABLE_32BPP)
+          case 24:
+            {
+              FAR uint8_t *dptr = line;
+              uint32_t pixel;
+
+              for (col = 0; col < glyph->width; col++, dptr += 3)
+                {
+                  alpha = sptr[col];
+                  if (alpha == 0)
+                    {
+                      continue;
+                    }
+
+                  pixel = (uint32_t)color;
+                  if (alpha != 255)
+                    {
+                      pixel = (uint32_t)dptr[2] << 16 |
+                              (uint32_t)dptr[1] << 8 | dptr[0];
+                      pixel = nxglib_rgb24_blend((uint32_t)color, pixel,
+                                                 NXF_ALPHA2FRAC(alpha));
+                    }
+
+                  dptr[0] = (uint8_t)pixel;
+                  dptr[1] = (uint8_t)(pixel >> 8);
+                  dptr[2] = (uint8_t)(pixel >> 16);
+                }
+            }
+            break;
+
+          case 32:
+            {
+              FAR uint32_t *dptr = (FAR uint32_t *)line;
+
+              for (col = 0; col < glyph->width; col++, dptr++)
+                {
+                  alpha = sptr[col];
+                  if (alpha == 255)
+                    {
+                      *dptr = (uint32_t)color;
+                    }
+                  else if (alpha != 0)
+                    {
+                      *dptr = nxglib_rgb24_blend((uint32_t)color, *dptr,
+                                                 NXF_ALPHA2FRAC(alpha));
+                    }
+                }
+            }
+            break;
+#endif
+
+          default:
+            return -ENOSYS;
+        }
+    }
+
+  return OK;
+}
@@ -0,0 +1,272 @@
+//***************************************************************************
+// libs/libxx/libcxxmini/libxx_memory_resource.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include <nuttx/lib/lib.h>
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The size of the first chunk of a monotonic buffer resource without an
+// initial buffer
+
+#define MONOTONIC_INITIAL_SIZE  256
+
+#define MAX_ALIGN               alignof(::max_align_t)
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+namespace
+{
+  class new_delete_resource_imp : public std::pmr::memory_resource
+  {
+  private:
+    FAR void *do_allocate(std::size_t bytes,
+                          std::size_t alignment) override
+    {
+      if (alignment <= MAX_ALIGN)
+        {
+          return lib_malloc(bytes);
+        }
+
+      return lib_memalign(alignment, bytes);
+    }
+
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override
+    {
+      lib_free(p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override
+    {
+      return this == &other;
+    }
+  };
+
+  class null_memory_resource_imp : public std::pmr::memory_resource
+  {
+  private:
+    FAR void *do_allocate(std::size_t bytes,
+                          std::size_t alignment) override
+    {
+      return nullptr;
+    }
+
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override
+    {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override
+    {
+      return this == &other;
+    }
+  };
+}
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+// Both resources are constant initialized, so they may be used by the
+// constructors of other static objects.
+
+static new_delete_resource_imp g_new_delete_resource;
+static null_memory_resource_imp g_null_memory_resource;
+
+static FAR std::pmr::memory_resource *g_default_resource;
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace std
+{
+namespace pmr
+{
+  FAR memory_resource *new_delete_resource() noexcept
+  {
+    return &g_new_delete_resource;
+  }
+
+  FAR memory_resource *null_memory_resource() noexcept
+  {
+    return &g_null_memory_resource;
+  }
+
+  FAR memory_resource *set_default_resource(FAR memory_resource *r)
+    noexcept
+  {
+    FAR memory_resource *old;
+
+    if (r == nullptr)
+      {
+        r = &g_new_delete_resource;
+      }
+
+    old = __atomic_exchange_n(&g_default_resource, r, __ATOMIC_ACQ_REL);
+    return old != nullptr ? old : &g_new_delete_resource;
+  }
+
+  FAR memory_resource *get_default_resource() noexcept
+  {
+    FAR memory_resource *r;
+
+    r = __atomic_load_n(&g_default_resource, __ATOMIC_ACQUIRE);
+    return r != nullptr ? r : &g_new_delete_resource;
+  }
+
+  //*************************************************************************
+  // Name: monotonic_buffer_resource
+  //*************************************************************************
+
+  // The header of a chunk taken from the upstream resource
+
+  struct monotonic_buffer_resource::chunk_s
+  {
+    FAR struct chunk_s *next;
+    size_t size;
+  };
+
+  monotonic_buffer_resource::
+    monotonic_buffer_resource(FAR memory_resource *upstream)
+    : monotonic_buffer_resource(MONOTONIC_INITIAL_SIZE, upstream)
+  {
+  }
+
+  monotonic_buffer_resource::
+    monotonic_buffer_resource(size_t initial_size,
+                              FAR memory_resource *upstream)
+    : m_upstream(upstream), m_chunks(nullptr), m_buffer(nullptr),
+      m_buffer_size(0), m_cur(nullptr), m_avail(0),
+      m_next_size(initial_size > 0 ? initial_size : 1)
+  {
+  }
+
+  monotonic_buffer_resource::
+    monotonic_buffer_resource(FAR void *buffer, size_t buffer_size,
+                              FAR memory_resource *upstream)
+    : m_upstream(upstream), m_chunks(nullptr), m_buffer(buffer),
+      m_buffer_size(buffer_size), m_cur(static_cast<FAR char *>(buffer)),
+      m_avail(buffer_size),
+      m_next_size(buffer_size > 0 ? 2 * buffer_size : 1)
+  {
+  }
+
+  monotonic_buffer_resource::~monotonic_buffer_resource()
+  {
+    release();
+  }
+
+  void monotonic_buffer_resource::release()
+  {
+    FAR struct chunk_s *chunk;
+
+    while ((chunk = m_chunks) != nullptr)
+      {
+        m_chunks = chunk->next;
+        m_upstream->deallocate(chunk, chunk->size, MAX_ALIGN);
+      }
+
+    m_cur   = static_cast<FAR char *>(m_buffer);
+    m_avail = m_buffer_size;
+  }
+
+  FAR void *monotonic_buffer_resource::do_allocate(size_t bytes,
+                                                   size_t alignment)
+  {
+    FAR struct chunk_s *chunk;
+    uintptr_t start;
+    uintptr_t end;
+    size_t size;
+
+    if (bytes == 0)
+      {
+        bytes = 1;
+      }
+
+    start = (reinterpret_cast<uintptr_t>(m_cur) + alignment - 1) &
+            ~(static_cast<uintptr_t>(alignment) - 1);
+    end   = reinterpret_cast<uintptr_t>(m_cur) + m_avail;
+
+    if (m_cur == nullptr || start > end || end - start < bytes)
+      {
+        // Take a new chunk, growing geometrically, that holds at least
+        // the block with the worst case padding
+
+        size = sizeof(struct chunk_s) + bytes + alignment;
+        if (size < m_next_size)
+          {
+            size = m_next_size;
+          }
+
+        chunk = static_cast<FAR struct chunk_s *>(
+                  m_upstream->allocate(size, MAX_ALIGN));
+        if (chunk == nullptr)
+          {
+            return nullptr;
+          }
+
+        chunk->next = m_chunks;
+        chunk->size = size;
+        m_chunks    = chunk;
+        m_cur       = reinterpret_cast<FAR char *>(chunk + 1);
+        m_avail     = size - sizeof(struct chunk_s);
+        m_next_size = 2 * size;
+
+        start = (reinterpret_cast<uintptr_t>(m_cur) + alignment - 1) &
+                ~(static_cast<uintptr_t>(alignment) - 1);
+        end   = reinterpret_cast<uintptr_t>(m_cur) + m_avail;
+      }
+
+    m_cur   = reinterpret_cast<FAR char *>(start + bytes);
+    m_avail = end - (start + bytes);
+    return reinterpret_cast<FAR void *>(start);
+  }
+
+  void monotonic_buffer_resource::do_deallocate(FAR void *p, size_t bytes,
+                                                size_t alignment)
+  {
+    // The memory is only freed by release()
+  }
+
+  bool monotonic_buffer_resource::
+    do_is_equal(const memory_resource &other) const noexcept
+  {
+    return this == &other;
+  }
+}
+}
@@ -0,0 +1,481 @@
+//***************************************************************************
+// libs/libxx/libxx_async_io.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <nuttx/async_io.hxx>
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The number of events taken from epoll at once
+
+#define ASYNC_IO_NEVENTS  16
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+namespace async
+{
+  //*************************************************************************
+  // Name: io_context
+  //*************************************************************************
+
+  io_context::ring_op::ring_op(io_context &ctx, uint8_t opcode, int fd,
+                               FAR void *addr, size_t len, off_t off)
+    noexcept
+    : m_ctx(ctx), m_sqe()
+  {
+    m_sqe.opcode = opcode;
+    m_sqe.fd     = fd;
+    m_sqe.off    = off;
+    m_sqe.addr   = addr;
+    m_sqe.len    = len;
+  }
+
+  io_context::io_context(unsigned int entries) noexcept
+    : m_ring(), m_ringfd(-1), m_epfd(-1), m_status(OK), m_stopped(false),
+      m_pending(0), m_submit_head(nullptr), m_submit_tail(nullptr),
+      m_ready_head(nullptr), m_ready_tail(nullptr)
+  {
+    struct epoll_event ev;
+
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epfd < 0)
+      {
+        m_status = -errno;
+        return;
+      }
+
+    m_ringfd = io_ring_setup(entries, &m_ring);
+    if (m_ringfd < 0)
+      {
+        m_status = -errno;
+        return;
+      }
+
+    // The ring is told from the streams by a null pointer
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = nullptr;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_ringfd, &ev) < 0)
+      {
+        m_status = -errno;
+      }
+  }
+
+  io_context::~io_context()
+  {
+    // Closing the ring waits for the file operations in progress
+
+    if (m_ringfd >= 0)
+      {
+        close(m_ringfd);
+      }
+
+    if (m_epfd >= 0)
+      {
+        epoll_close(m_epfd);
+      }
+  }
+
+  void io_context::spawn(task<> &&t) noexcept
+  {
+    task<>::handle_type h = t.m_handle;
+
+    t.m_handle = nullptr;
+    if (h)
+      {
+        h.promise().detached = true;
+        h.resume();
+      }
+  }
+
+  void io_context::submit(FAR ring_op *op) noexcept
+  {
+    m_pending++;
+
+    if (m_status < 0)
+      {
+        op->result = m_status;
+        complete(op);
+        return;
+      }
+
+    op->next = nullptr;
+    if (m_submit_tail != nullptr)
+      {
+        m_submit_tail->next = op;
+      }
+    else
+      {
+        m_submit_head = op;
+      }
+
+    m_submit_tail = op;
+  }
+
+  void io_context::complete(FAR detail::operation *op) noexcept
+  {
+    DEBUGASSERT(m_pending > 0);
+    m_pending--;
+
+    op->next = nullptr;
+    if (m_ready_tail != nullptr)
+      {
+        m_ready_tail->next = op;
+      }
+    else
+      {
+        m_ready_head = op;
+      }
+
+    m_ready_tail = op;
+  }
+
+  // Move the queued operations into the submission queue and submit them.
+  // The ring takes no more than its completion queue can report, the rest
+  // is submitted again on the next turn of the loop.
+
+  void io_context::flush() noexcept
+  {
+    FAR ring_op *op;
+
+    while ((op = m_submit_head) != nullptr &&
+           m_ring.sq_tail - m_ring.sq_head <= m_ring.sq_mask)
+      {
+        m_submit_head = static_cast<FAR ring_op *>(op->next);
+        if (m_submit_head == nullptr)
+          {
+            m_submit_tail = nullptr;
+          }
+
+        m_ring.sqes[m_ring.sq_tail & m_ring.sq_mask]           = op->m_sqe;
+        m_ring.sqes[m_ring.sq_tail & m_ring.sq_mask].user_data =
+          reinterpret_cast<uintptr_t>(op);
+        m_ring.sq_tail = m_ring.sq_tail + 1;
+      }
+
+    if (m_ring.sq_tail != m_ring.sq_head)
+      {
+        io_ring_enter(m_ringfd, m_ring.sq_tail - m_ring.sq_head, 0);
+      }
+  }
+
+  void io_context::harvest() noexcept
+  {
+    FAR struct io_ring_cqe *cqe;
+    FAR detail::operation *op;
+    uint32_t tail;
+
+    tail = __atomic_load_n(&m_ring.cq_tail, __ATOMIC_ACQUIRE);
+    while (m_ring.cq_head != tail)
+      {
+        cqe = &m_ring.cqes[m_ring.cq_head & m_ring.cq_mask];
+        op  = reinterpret_cast<FAR detail::operation *>(cqe->user_data);
+        op->result = cqe->res;
+        __atomic_store_n(&m_ring.cq_head, m_ring.cq_head + 1,
+                         __ATOMIC_RELEASE);
+        complete(op);
+      }
+  }
+
+  int io_context::run() noexcept
+  {
+    struct epoll_event evs[ASYNC_IO_NEVENTS];
+    FAR detail::operation *op;
+    int n;
+    int i;
+
+    m_stopped = false;
+
+    for (; ; )
+      {
+        // Resume the coroutines of the completed operations; they may
+        // start new ones
+
+        while ((op = m_ready_head) != nullptr)
+          {
+            m_ready_head = op->next;
+            if (m_ready_head == nullptr)
+              {
+                m_ready_tail = nullptr;
+              }
+
+            op->waiter.resume();
+          }
+
+        if (m_stopped || m_pending == 0)
+          {
+            return OK;
+          }
+
+        flush();
+        harvest();
+        if (m_ready_head != nullptr)
+          {
+            continue;
+          }
+
+        n = epoll_wait(m_epfd, evs, ASYNC_IO_NEVENTS, -1);
+        if (n < 0)
+          {
+            if (errno == EINTR)
+              {
+                continue;
+              }
+
+            return -errno;
+          }
+
+        // No coroutine is resumed before all the events are handled, so
+        // a stream destroyed by a coroutine cannot be left in evs
+
+        for (i = 0; i < n; i++)
+          {
+            if (evs[i].data.ptr == nullptr)
+              {
+                harvest();
+              }
+            else
+              {
+                static_cast<FAR stream *>(evs[i].data.ptr)->
+                  dispatch(evs[i].events);
+              }
+          }
+      }
+  }
+
+  //*************************************************************************
+  // Name: stream
+  //*************************************************************************
+
+  bool stream::op::perform() noexcept
+  {
+    int fd = m_stream.m_fd;
+    socklen_t len;
+    ssize_t ret;
+    int err;
+
+    switch (m_kind)
+      {
+        case READ:
+          ret = ::read(fd, m_buf, m_len);
+          break;
+
+        case WRITE:
+          ret = ::write(fd, m_buf, m_len);
+          break;
+
+#ifdef CONFIG_NET
+        case RECV:
+          ret = ::recv(fd, m_buf, m_len, m_flags);
+          break;
+
+        case SEND:
+          ret = ::send(fd, m_buf, m_len, m_flags);
+          break;
+
+        case ACCEPT:
+          ret = ::accept(fd, static_cast<FAR struct sockaddr *>(m_addr),
+                         m_addrlen);
+          break;
+
+        case CONNECT:
+          if (!m_started)
+            {
+              m_started = true;
+              ret = ::connect(fd, static_cast<FAR struct sockaddr *>(m_addr),
+                              m_len);
+              if (ret < 0 && errno == EINPROGRESS)
+                {
+                  return false;
+                }
+
+              break;
+            }
+
+          // The socket is writable once the connection is established or
+          // has failed
+
+          len = sizeof(err);
+          ret = getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+          if (ret == 0 && err != 0)
+            {
+              result = -err;
+              return true;
+            }
+
+          break;
+#endif
+
+        default:
+          ret = -1;
+          errno = EINVAL;
+          break;
+      }
+
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+        return false;
+      }
+
+    result = ret < 0 ? -errno : ret;
+    return true;
+  }
+
+  stream::stream(io_context &ctx, int fd) noexcept
+    : m_ctx(ctx), m_fd(fd), m_reader(nullptr), m_writer(nullptr),
+      m_events(0)
+  {
+    int flags = fcntl(fd, F_GETFL);
+
+    if (flags >= 0 && (flags & O_NONBLOCK) == 0)
+      {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+      }
+  }
+
+  stream::~stream()
+  {
+    DEBUGASSERT(m_reader == nullptr && m_writer == nullptr);
+
+    if (m_events != 0)
+      {
+        epoll_ctl(m_ctx.m_epfd, EPOLL_CTL_DEL, m_fd, nullptr);
+      }
+  }
+
+  void stream::wait(FAR op *o) noexcept
+  {
+    FAR op **slot = o->writing() ? &m_writer : &m_reader;
+
+    DEBUGASSERT(*slot == nullptr);
+
+    *slot = o;
+    m_ctx.m_pending++;
+    update();
+  }
+
+  // Poll the events of the operations in progress only: epoll always
+  // reports errors and hangups, which would wake up the loop for nothing
+
+  void stream::update() noexcept
+  {
+    struct epoll_event ev;
+    uint32_t events = 0;
+    int ret;
+
+    if (m_reader != nullptr)
+      {
+        events |= EPOLLIN;
+      }
+
+    if (m_writer != nullptr)
+      {
+        events |= EPOLLOUT;
+      }
+
+    if (events == m_events)
+      {
+        return;
+      }
+
+    ev.events   = events;
+    ev.data.ptr = this;
+
+    if (events == 0)
+      {
+        ret = epoll_ctl(m_ctx.m_epfd, EPOLL_CTL_DEL, m_fd, nullptr);
+      }
+    else
+      {
+        ret = epoll_ctl(m_ctx.m_epfd, m_events == 0 ? EPOLL_CTL_ADD :
+                        EPOLL_CTL_MOD, m_fd, &ev);
+      }
+
+    if (ret == 0)
+      {
+        m_events = events;
+        return;
+      }
+
+    // The descriptor cannot be polled: fail what waits for it
+
+    ret = -errno;
+    if (m_reader != nullptr)
+      {
+        m_reader->result = ret;
+        m_ctx.complete(m_reader);
+        m_reader = nullptr;
+      }
+
+    if (m_writer != nullptr)
+      {
+        m_writer->result = ret;
+        m_ctx.complete(m_writer);
+        m_writer = nullptr;
+      }
+
+    if (m_events != 0)
+      {
+        epoll_ctl(m_ctx.m_epfd, EPOLL_CTL_DEL, m_fd, nullptr);
+        m_events = 0;
+      }
+  }
+
+  void stream::dispatch(uint32_t events) noexcept
+  {
+    if (m_reader != nullptr &&
+        (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0 &&
+        m_reader->perform())
+      {
+        m_ctx.complete(m_reader);
+        m_reader = nullptr;
+      }
+
+    if (m_writer != nullptr &&
+        (events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0 &&
+        m_writer->perform())
+      {
+        m_ctx.complete(m_writer);
+        m_writer = nullptr;
+      }
+
+    update();
+  }
+}
+}
@@ -0,0 +1,370 @@
+//***************************************************************************
+// libs/libxx/libxx_mempool_resource.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstring>
+#include <assert.h>
+
+#include <nuttx/mm/mempool_resource.hxx>
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The pools are expanded by about 1 KiB at a time unless the options give
+// the number of blocks per chunk
+
+#define MEMPOOL_RESOURCE_CHUNK   1024
+
+#define NCACHED                  CONFIG_LIBXX_MEMPOOL_RESOURCE_NCACHED
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  // The free blocks cached by a thread, linked through their first word
+
+  struct thread_pool_resource::cache_s
+  {
+    FAR thread_pool_resource *owner;
+    FAR void *head[MEMPOOL_RESOURCE_NPOOLS];
+    std::size_t count[MEMPOOL_RESOURCE_NPOOLS];
+  };
+}
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  //*************************************************************************
+  // Name: mempool_resource
+  //*************************************************************************
+
+  mempool_resource::mempool_resource(const pool_options &opts,
+                                     FAR memory_resource *upstream,
+                                     FAR const char *name)
+    : m_upstream(upstream)
+  {
+    std::size_t bsize = 1 << MEMPOOL_RESOURCE_MINSHIFT;
+    std::size_t npools;
+
+    std::memset(m_pools, 0, sizeof(m_pools));
+
+    for (npools = 0; npools < MEMPOOL_RESOURCE_NPOOLS; npools++)
+      {
+        m_pools[npools].bsize   = bsize;
+        m_pools[npools].nexpand = opts.max_blocks_per_chunk;
+        if (m_pools[npools].nexpand == 0)
+          {
+            m_pools[npools].nexpand = bsize < MEMPOOL_RESOURCE_CHUNK ?
+                                      MEMPOOL_RESOURCE_CHUNK / bsize : 1;
+          }
+
+        if (bsize >= opts.largest_required_pool_block &&
+            opts.largest_required_pool_block != 0)
+          {
+            npools++;
+            break;
+          }
+
+        bsize <<= 1;
+      }
+
+    m_mpool.pools  = m_pools;
+    m_mpool.npools = npools;
+
+    // Without the pools, every block is taken from upstream
+
+    if (mempool_multiple_init(&m_mpool, name) < 0)
+      {
+        m_mpool.npools = 0;
+      }
+
+    m_options.max_blocks_per_chunk        = opts.max_blocks_per_chunk;
+    m_options.largest_required_pool_block =
+      m_mpool.npools > 0 ? m_pools[m_mpool.npools - 1].bsize : 0;
+  }
+
+  mempool_resource::~mempool_resource()
+  {
+    if (m_mpool.npools > 0)
+      {
+        int ret = mempool_multiple_deinit(&m_mpool);
+        DEBUGASSERT(ret == 0);
+        UNUSED(ret);
+      }
+  }
+
+  int mempool_resource::pool_index(std::size_t bytes,
+                                   std::size_t alignment) const
+  {
+    int index = 0;
+
+    if (m_mpool.npools == 0 || alignment > sizeof(FAR void *) ||
+        bytes > m_pools[m_mpool.npools - 1].bsize)
+      {
+        return -1;
+      }
+
+    while (m_pools[index].bsize < bytes)
+      {
+        index++;
+      }
+
+    return index;
+  }
+
+  FAR void *mempool_resource::do_allocate(std::size_t bytes,
+                                          std::size_t alignment)
+  {
+    int index = pool_index(bytes, alignment);
+
+    if (index < 0)
+      {
+        return m_upstream->allocate(bytes, alignment);
+      }
+
+    return mempool_alloc(&m_pools[index]);
+  }
+
+  void mempool_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                       std::size_t alignment)
+  {
+    int index = pool_index(bytes, alignment);
+
+    if (index < 0)
+      {
+        m_upstream->deallocate(p, bytes, alignment);
+      }
+    else
+      {
+        mempool_free(&m_pools[index], p);
+      }
+  }
+
+  bool mempool_resource::
+    do_is_equal(const memory_resource &other) const noexcept
+  {
+    return this == &other;
+  }
+
+  //*************************************************************************
+  // Name: thread_pool_resource
+  //*************************************************************************
+
+  thread_pool_resource::
+    thread_pool_resource(const pool_options &opts,
+                         FAR memory_resource *upstream,
+                         FAR const char *name)
+    : m_shared(opts, upstream, name)
+  {
+    // Without a key all threads share the pools
+
+    m_haskey = pthread_key_create(&m_key, destroy_cache) == 0;
+  }
+
+  thread_pool_resource::~thread_pool_resource()
+  {
+    if (m_haskey)
+      {
+        flush();
+        pthread_key_delete(m_key);
+      }
+  }
+
+  void thread_pool_resource::flush()
+  {
+    FAR struct cache_s *cache;
+
+    if (m_haskey &&
+        (cache = static_cast<FAR struct cache_s *>(
+                   pthread_getspecific(m_key))) != nullptr)
+      {
+        pthread_setspecific(m_key, nullptr);
+        destroy_cache(cache);
+      }
+  }
+
+  FAR struct thread_pool_resource::cache_s *thread_pool_resource::
+    get_cache()
+  {
+    FAR struct cache_s *cache;
+
+    if (!m_haskey)
+      {
+        return nullptr;
+      }
+
+    cache = static_cast<FAR struct cache_s *>(pthread_getspecific(m_key));
+    if (cache == nullptr)
+      {
+        cache = static_cast<FAR struct cache_s *>(
+                  m_shared.upstream_resource()->
+                    allocate(sizeof(struct cache_s),
+                             alignof(struct cache_s)));
+        if (cache == nullptr)
+          {
+            return nullptr;
+          }
+
+        std::memset(cache, 0, sizeof(struct cache_s));
+        cache->owner = this;
+
+        if (pthread_setspecific(m_key, cache) != 0)
+          {
+            m_shared.upstream_resource()->
+              deallocate(cache, sizeof(struct cache_s),
+                         alignof(struct cache_s));
+            return nullptr;
+          }
+      }
+
+    return cache;
+  }
+
+  // Return the cached blocks of a pool beyond keep to the shared pool
+
+  void thread_pool_resource::drain(FAR struct cache_s *cache, int index,
+                                   std::size_t keep)
+  {
+    FAR void *blks[NCACHED];
+    std::size_t n = 0;
+
+    while (cache->count[index] > keep)
+      {
+        blks[n]            = cache->head[index];
+        cache->head[index] = *static_cast<FAR void **>(blks[n]);
+        cache->count[index]--;
+
+        if (++n == NCACHED)
+          {
+            mempool_free_batch(&m_shared.m_pools[index], blks, n);
+            n = 0;
+          }
+      }
+
+    mempool_free_batch(&m_shared.m_pools[index], blks, n);
+  }
+
+  void thread_pool_resource::destroy_cache(FAR void *arg)
+  {
+    FAR struct cache_s *cache = static_cast<FAR struct cache_s *>(arg);
+    FAR thread_pool_resource *self = cache->owner;
+    int index;
+
+    for (index = 0; index < MEMPOOL_RESOURCE_NPOOLS; index++)
+      {
+        self->drain(cache, index, 0);
+      }
+
+    self->m_shared.upstream_resource()->
+      deallocate(cache, sizeof(struct cache_s), alignof(struct cache_s));
+  }
+
+  FAR void *thread_pool_resource::do_allocate(std::size_t bytes,
+                                              std::size_t alignment)
+  {
+    FAR struct cache_s *cache;
+    FAR void *blks[NCACHED / 2 + 1];
+    std::size_t n;
+    std::size_t i;
+    FAR void *p;
+    int index;
+
+    index = m_shared.pool_index(bytes, alignment);
+    if (index < 0 || (cache = get_cache()) == nullptr)
+      {
+        return m_shared.allocate(bytes, alignment);
+      }
+
+    if (cache->count[index] == 0)
+      {
+        // Refill half of the cache, plus the block returned
+
+        n = mempool_alloc_batch(&m_shared.m_pools[index], blks,
+                                NCACHED / 2 + 1);
+        if (n == 0)
+          {
+            return nullptr;
+          }
+
+        for (i = 1; i < n; i++)
+          {
+            *static_cast<FAR void **>(blks[i]) = cache->head[index];
+            cache->head[index] = blks[i];
+          }
+
+        cache->count[index] = n - 1;
+        return blks[0];
+      }
+
+    p = cache->head[index];
+    cache->head[index] = *static_cast<FAR void **>(p);
+    cache->count[index]--;
+    return p;
+  }
+
+  void thread_pool_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                           std::size_t alignment)
+  {
+    FAR struct cache_s *cache;
+    int index;
+
+    index = m_shared.pool_index(bytes, alignment);
+    if (index < 0 || (cache = get_cache()) == nullptr)
+      {
+        m_shared.deallocate(p, bytes, alignment);
+        return;
+      }
+
+    *static_cast<FAR void **>(p) = cache->head[index];
+    cache->head[index] = p;
+
+    // Keep half of the cache when it overflows
+
+    if (++cache->count[index] > NCACHED)
+      {
+        drain(cache, index, NCACHED / 2);
+      }
+  }
+
+  bool thread_pool_resource::
+    do_is_equal(const memory_resource &other) const noexcept
+  {
+    return this == &other;
+  }
+}
+}
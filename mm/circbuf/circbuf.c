@@ -22,7 +22,9 @@
  * and one writer is using the circular buffer.
  * For multiple writer and one reader there is only a need to lock the
  * writer. And vice versa for only one writer and multiple reader there is
- * only a need to lock the reader.
+ * only a need to lock the reader.  With CONFIG_MM_CIRCBUF_SPSC the indices
+ * are accessed with acquire/release atomics, so that this also holds on
+ * SMP and with interrupt handlers as producer or consumer.
  */
 
 /****************************************************************************
@@ -37,9 +39,22 @@
 #include <nuttx/mm/circbuf.h>
 
 /****************************************************************************
- * Private Types
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* Each side publishes its own index with a release store and observes the
+ * index of the other side with an acquire load.  The data accesses can
+ * then not move across the index update that hands the space over.
+ */
+
+#ifdef CONFIG_MM_CIRCBUF_SPSC
+#  define circbuf_load(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define circbuf_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#else
+#  define circbuf_load(p)     (*(p))
+#  define circbuf_store(p, v) (*(p) = (v))
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -209,7 +224,7 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+  return circbuf_load(&circ->head) - circbuf_load(&circ->tail);
 }
 
 /****************************************************************************
@@ -379,7 +394,7 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -416,7 +431,7 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -470,7 +485,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  circbuf_store(&circ->head, circ->head + bytes);
 
   return bytes;
 }
@@ -538,3 +553,134 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
 
   return overwrite;
 }
+
+/****************************************************************************
+ * Name: circbuf_write_begin
+ *
+ * Description:
+ *   Reserve space for the producer to write to in place.  The returned
+ *   region is the contiguous free space at the head of the buffer; call
+ *   circbuf_write_commit() once it is filled to make the data visible to
+ *   the consumer.
+ *
+ * Input Parameters:
+ *   circ - Address of the circular buffer to be used.
+ *   size - Location to return the size of the region.
+ *
+ * Returned Value:
+ *   The address of the region, or NULL if the buffer is full.
+ ****************************************************************************/
+
+FAR void *circbuf_write_begin(FAR struct circbuf_s *circ,
+                              FAR size_t *size)
+{
+  size_t space;
+  size_t off;
+
+  DEBUGASSERT(circ && size);
+
+  *size = 0;
+  if (!circ->size)
+    {
+      return NULL;
+    }
+
+  space = circbuf_space(circ);
+  if (!space)
+    {
+      return NULL;
+    }
+
+  off = circ->head % circ->size;
+  if (space > circ->size - off)
+    {
+      space = circ->size - off;
+    }
+
+  *size = space;
+  return (FAR char *)circ->base + off;
+}
+
+/****************************************************************************
+ * Name: circbuf_write_commit
+ *
+ * Description:
+ *   Publish bytes written to the region returned by circbuf_write_begin().
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   bytes - Number of bytes written, at most the size of the region.
+ ****************************************************************************/
+
+void circbuf_write_commit(FAR struct circbuf_s *circ, size_t bytes)
+{
+  DEBUGASSERT(circ);
+  DEBUGASSERT(bytes <= circbuf_space(circ));
+
+  circbuf_store(&circ->head, circ->head + bytes);
+}
+
+/****************************************************************************
+ * Name: circbuf_read_begin
+ *
+ * Description:
+ *   Get the data for the consumer to read in place.  The returned region
+ *   is the contiguous data at the tail of the buffer; call
+ *   circbuf_read_commit() once it is consumed to release the space.
+ *
+ * Input Parameters:
+ *   circ - Address of the circular buffer to be used.
+ *   size - Location to return the size of the region.
+ *
+ * Returned Value:
+ *   The address of the region, or NULL if the buffer is empty.
+ ****************************************************************************/
+
+FAR void *circbuf_read_begin(FAR struct circbuf_s *circ, FAR size_t *size)
+{
+  size_t used;
+  size_t off;
+
+  DEBUGASSERT(circ && size);
+
+  *size = 0;
+  if (!circ->size)
+    {
+      return NULL;
+    }
+
+  used = circbuf_used(circ);
+  if (!used)
+    {
+      return NULL;
+    }
+
+  off = circ->tail % circ->size;
+  if (used > circ->size - off)
+    {
+      used = circ->size - off;
+    }
+
+  *size = used;
+  return (FAR char *)circ->base + off;
+}
+
+/****************************************************************************
+ * Name: circbuf_read_commit
+ *
+ * Description:
+ *   Release bytes consumed from the region returned by
+ *   circbuf_read_begin().
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   bytes - Number of bytes consumed, at most the size of the region.
+ ****************************************************************************/
+
+void circbuf_read_commit(FAR struct circbuf_s *circ, size_t bytes)
+{
+  DEBUGASSERT(circ);
+  DEBUGASSERT(bytes <= circbuf_used(circ));
+
+  circbuf_store(&circ->tail, circ->tail + bytes);
+}
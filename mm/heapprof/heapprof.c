@@ -0,0 +1,565 @@
+/****************************************************************************
+ * mm/heapprof/heapprof.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The heap profiler samples about one allocation every
+ * CONFIG_MM_HEAPPROF_PERIOD bytes, so that its cost does not depend on the
+ * rate of the allocations.  A sampled allocation of size s stands for
+ * max(s, period) bytes, and for as many allocations of its size, which are
+ * charged to the call site given by its backtrace.  The sampled allocations
+ * that are not freed yet make up the live bytes of their call sites.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/compiler.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/procfs.h>
+
+#include "heapprof.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HEAPPROF_PERIOD   CONFIG_MM_HEAPPROF_PERIOD
+#define HEAPPROF_DEPTH    CONFIG_MM_HEAPPROF_DEPTH
+#define HEAPPROF_NSITES   CONFIG_MM_HEAPPROF_NSITES
+#define HEAPPROF_NSAMPLES CONFIG_MM_HEAPPROF_NSAMPLES
+
+/* Skip the frames of heapprof_sample() and heapprof_alloc() */
+
+#define HEAPPROF_SKIP     2
+
+#define HEAPPROF_NONE     UINT16_MAX
+
+#define HEAPPROF_BUCKET(mem) \
+  (((uintptr_t)(mem) / sizeof(uintptr_t)) % HEAPPROF_NSAMPLES)
+
+/* The longest line of the procfs file */
+
+#define HEAPPROF_LINELEN  (64 + HEAPPROF_DEPTH * (2 * sizeof(uintptr_t) + 3))
+
+#if defined(CONFIG_FS_PROCFS) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define HAVE_HEAPPROF_PROCFS 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The statistics of a call site */
+
+struct heapprof_site_s
+{
+  FAR void *backtrace[HEAPPROF_DEPTH];
+  uint32_t hash;                  /* Hash of the backtrace, 0 if unused */
+  uint64_t allocs;                /* Estimated number of allocations */
+  uint64_t bytes;                 /* Estimated bytes allocated */
+  size_t   live;                  /* Estimated bytes not freed yet */
+  size_t   peak;                  /* The largest value of live */
+};
+
+/* A sampled allocation that is not freed yet */
+
+struct heapprof_sample_s
+{
+  FAR void *mem;
+  size_t   weight;                /* The bytes that it stands for */
+  uint16_t site;                  /* Index of its call site */
+  uint16_t next;                  /* Next of the bucket or the free list */
+};
+
+struct heapprof_s
+{
+  spinlock_t lock;
+  bool       initialized;
+  uint16_t   freelist;            /* Unused entries of samples[] */
+  size_t     nlive;               /* Used entries of samples[] */
+  uint32_t   dropped;             /* Samples lost for lack of room */
+  uint32_t   seed;                /* Randomizes the sampling period */
+  clock_t    start;               /* The time of the first sample */
+  uint16_t   bucket[HEAPPROF_NSAMPLES];
+  struct heapprof_sample_s samples[HEAPPROF_NSAMPLES];
+  struct heapprof_site_s   sites[HEAPPROF_NSITES];
+};
+
+#ifdef HAVE_HEAPPROF_PROCFS
+/* This structure describes one open "file" */
+
+struct heapprof_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[HEAPPROF_LINELEN];    /* Pre-allocated buffer for lines */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef HAVE_HEAPPROF_PROCFS
+static int     heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     heapprof_close(FAR struct file *filep);
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static int     heapprof_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     heapprof_stat(FAR const char *relpath, FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef HAVE_HEAPPROF_PROCFS
+const struct procfs_operations heapprof_operations =
+{
+  heapprof_open,   /* open */
+  heapprof_close,  /* close */
+  heapprof_read,   /* read */
+  NULL,            /* write */
+  heapprof_dup,    /* dup */
+  NULL,            /* opendir */
+  NULL,            /* closedir */
+  NULL,            /* readdir */
+  NULL,            /* rewinddir */
+  heapprof_stat    /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct heapprof_s g_heapprof;
+
+/* The bytes left before the next sample.  It is updated without the lock:
+ * a lost update only moves a sample a little, which does not bias the
+ * estimates.
+ */
+
+static size_t g_heapprof_countdown = HEAPPROF_PERIOD;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_period
+ *
+ * Description:
+ *   Return a period between half and one and a half times the configured
+ *   one, so that the samples do not follow periodic allocation patterns.
+ *
+ * Assumptions:
+ *   The profiler is locked.
+ *
+ ****************************************************************************/
+
+static size_t heapprof_period(void)
+{
+  g_heapprof.seed = g_heapprof.seed * 1103515245 + 12345;
+  return HEAPPROF_PERIOD / 2 + (g_heapprof.seed >> 8) % HEAPPROF_PERIOD;
+}
+
+/****************************************************************************
+ * Name: heapprof_initialize
+ *
+ * Assumptions:
+ *   The profiler is locked.
+ *
+ ****************************************************************************/
+
+static void heapprof_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < HEAPPROF_NSAMPLES; i++)
+    {
+      g_heapprof.bucket[i]       = HEAPPROF_NONE;
+      g_heapprof.samples[i].next = i + 1 < HEAPPROF_NSAMPLES ?
+                                   i + 1 : HEAPPROF_NONE;
+    }
+
+  g_heapprof.freelist    = 0;
+  g_heapprof.start       = clock_systime_ticks();
+  g_heapprof.initialized = true;
+}
+
+/****************************************************************************
+ * Name: heapprof_findsite
+ *
+ * Description:
+ *   Return the call site of a backtrace, which is added if it is new, or
+ *   -1 if the table is full.
+ *
+ * Assumptions:
+ *   The profiler is locked.
+ *
+ ****************************************************************************/
+
+static int heapprof_findsite(FAR void **backtrace, uint32_t hash)
+{
+  FAR struct heapprof_site_s *site;
+  int ndx = hash % HEAPPROF_NSITES;
+  int i;
+
+  for (i = 0; i < HEAPPROF_NSITES; i++)
+    {
+      site = &g_heapprof.sites[ndx];
+      if (site->hash == 0)
+        {
+          memcpy(site->backtrace, backtrace, sizeof(site->backtrace));
+          site->hash = hash;
+          return ndx;
+        }
+
+      if (site->hash == hash &&
+          memcmp(site->backtrace, backtrace, sizeof(site->backtrace)) == 0)
+        {
+          return ndx;
+        }
+
+      ndx = (ndx + 1) % HEAPPROF_NSITES;
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: heapprof_sample
+ ****************************************************************************/
+
+static noinline_function void heapprof_sample(FAR void *mem, size_t size)
+{
+  FAR void *backtrace[HEAPPROF_DEPTH];
+  FAR struct heapprof_site_s *site;
+  FAR struct heapprof_sample_s *sample;
+  irqstate_t flags;
+  uint32_t hash = 2166136261u;
+  size_t weight;
+  int ndx;
+  int i;
+
+  memset(backtrace, 0, sizeof(backtrace));
+  sched_backtrace(gettid(), backtrace, HEAPPROF_DEPTH, HEAPPROF_SKIP);
+
+  for (i = 0; i < HEAPPROF_DEPTH; i++)
+    {
+      hash = (hash ^ (uintptr_t)backtrace[i]) * 16777619u;
+    }
+
+  hash  |= 1;
+  weight = size > HEAPPROF_PERIOD ? size : HEAPPROF_PERIOD;
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+
+  if (!g_heapprof.initialized)
+    {
+      heapprof_initialize();
+    }
+
+  ndx = heapprof_findsite(backtrace, hash);
+  if (ndx < 0 || g_heapprof.freelist == HEAPPROF_NONE)
+    {
+      g_heapprof.dropped++;
+      goto out;
+    }
+
+  site          = &g_heapprof.sites[ndx];
+  site->allocs += weight / size;
+  site->bytes  += weight;
+  site->live   += weight;
+  if (site->live > site->peak)
+    {
+      site->peak = site->live;
+    }
+
+  /* Remember the allocation until it is freed */
+
+  i                   = g_heapprof.freelist;
+  sample              = &g_heapprof.samples[i];
+  g_heapprof.freelist = sample->next;
+
+  sample->mem    = mem;
+  sample->weight = weight;
+  sample->site   = ndx;
+  sample->next   = g_heapprof.bucket[HEAPPROF_BUCKET(mem)];
+  g_heapprof.bucket[HEAPPROF_BUCKET(mem)] = i;
+  g_heapprof.nlive++;
+
+out:
+  g_heapprof_countdown = heapprof_period();
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+#ifdef HAVE_HEAPPROF_PROCFS
+
+/****************************************************************************
+ * Name: heapprof_open
+ ****************************************************************************/
+
+static int heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct heapprof_file_s *procfile;
+
+  procfile = kmm_zalloc(sizeof(struct heapprof_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_close
+ ****************************************************************************/
+
+static int heapprof_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_read
+ *
+ * Description:
+ *   Print a line per call site:  its live and peak bytes, the number of
+ *   its allocations, their rates per second since the first sample, and
+ *   its backtrace.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct heapprof_file_s *procfile;
+  struct heapprof_site_s site;
+  irqstate_t flags;
+  clock_t elapsed;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+  int j;
+
+  offset    = filep->f_pos;
+  procfile  = filep->f_priv;
+  elapsed   = clock_systime_ticks() - g_heapprof.start;
+  elapsed   = elapsed > 0 ? elapsed : 1;
+
+  linesize  = procfs_snprintf(procfile->line, HEAPPROF_LINELEN,
+                              "%10s %10s %10s %10s %10s  %s\n", "live",
+                              "peak", "allocs", "allocs/s", "bytes/s",
+                              "backtrace");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (i = 0; i < HEAPPROF_NSITES && totalsize < buflen; i++)
+    {
+      flags = spin_lock_irqsave(&g_heapprof.lock);
+      site  = g_heapprof.sites[i];
+      spin_unlock_irqrestore(&g_heapprof.lock, flags);
+
+      if (site.hash == 0)
+        {
+          continue;
+        }
+
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      linesize  = procfs_snprintf(procfile->line, HEAPPROF_LINELEN,
+                                  "%10zu %10zu %10llu %10llu %10llu ",
+                                  site.live, site.peak,
+                                  (unsigned long long)site.allocs,
+                                  (unsigned long long)
+                                  (site.allocs * TICK_PER_SEC / elapsed),
+                                  (unsigned long long)
+                                  (site.bytes * TICK_PER_SEC / elapsed));
+
+      for (j = 0; j < HEAPPROF_DEPTH && site.backtrace[j] != NULL; j++)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      HEAPPROF_LINELEN - linesize,
+                                      " %p", site.backtrace[j]);
+        }
+
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  HEAPPROF_LINELEN - linesize, "\n");
+
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, HEAPPROF_LINELEN,
+                                   "dropped: %" PRIu32 "\n",
+                                   g_heapprof.dropped);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heapprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heapprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapprof_file_s *oldattr;
+  FAR struct heapprof_file_s *newattr;
+
+  oldattr = oldp->f_priv;
+  newattr = kmm_malloc(sizeof(struct heapprof_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct heapprof_file_s));
+  newp->f_priv = newattr;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heapprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return 0;
+}
+
+#endif /* HAVE_HEAPPROF_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_alloc
+ ****************************************************************************/
+
+noinline_function void heapprof_alloc(FAR void *mem, size_t size)
+{
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  if (size < g_heapprof_countdown)
+    {
+      g_heapprof_countdown -= size;
+      return;
+    }
+
+  /* The backtrace of an interrupt handler is not worth recording */
+
+  if (up_interrupt_context())
+    {
+      g_heapprof_countdown = HEAPPROF_PERIOD;
+      return;
+    }
+
+  heapprof_sample(mem, size);
+}
+
+/****************************************************************************
+ * Name: heapprof_free
+ ****************************************************************************/
+
+void heapprof_free(FAR void *mem)
+{
+  FAR struct heapprof_sample_s *sample;
+  FAR uint16_t *prev;
+  irqstate_t flags;
+  uint16_t ndx;
+
+  if (mem == NULL || g_heapprof.nlive == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+
+  for (prev = &g_heapprof.bucket[HEAPPROF_BUCKET(mem)];
+       *prev != HEAPPROF_NONE; prev = &sample->next)
+    {
+      sample = &g_heapprof.samples[*prev];
+      if (sample->mem == mem)
+        {
+          g_heapprof.sites[sample->site].live -= sample->weight;
+          g_heapprof.nlive--;
+
+          /* Move the sample from its bucket to the free list */
+
+          ndx                 = *prev;
+          *prev               = sample->next;
+          sample->next        = g_heapprof.freelist;
+          g_heapprof.freelist = ndx;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
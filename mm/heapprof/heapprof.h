@@ -0,0 +1,98 @@
+/****************************************************************************
+ * mm/heapprof/heapprof.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_HEAPPROF_HEAPPROF_H
+#define __MM_HEAPPROF_HEAPPROF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MM_HEAPPROF
+#  define heapprof_alloc(mem, size)
+#  define heapprof_free(mem)
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_MM_HEAPPROF
+
+/****************************************************************************
+ * Name: heapprof_alloc
+ *
+ * Description:
+ *   Account for an allocation.  About one allocation every
+ *   CONFIG_MM_HEAPPROF_PERIOD bytes is sampled:  its backtrace is recorded
+ *   and its call site charged for the allocations it stands for.
+ *
+ * Input Parameters:
+ *   mem  - The allocated memory
+ *   size - The size of the allocation
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void heapprof_alloc(FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: heapprof_free
+ *
+ * Description:
+ *   Account for the release of memory, which is only remembered if its
+ *   allocation was sampled.
+ *
+ * Input Parameters:
+ *   mem - The memory released
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void heapprof_free(FAR void *mem);
+
+#endif /* CONFIG_MM_HEAPPROF */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MM_HEAPPROF_HEAPPROF_H */
@@ -48,6 +48,21 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+/* The limits and the usage of the pool of one subsystem */
+
+struct iob_pool_s
+{
+  int16_t quota;      /* Most IOBs charged at a time, zero for no limit */
+  int16_t throttle;   /* Free IOBs that must be left for the other users */
+  int16_t inuse;      /* IOBs charged now */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -80,6 +95,12 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_POOLS
+/* The pools of the subsystems, indexed by enum iob_pool_e */
+
+extern struct iob_pool_s g_iob_pools[IOB_NPOOLS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -119,6 +140,67 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_global
+ *
+ * Description:
+ *   Return a free I/O buffer to the global free list, or hand it over to a
+ *   task waiting for one.  Called in the critical section.
+ *
+ ****************************************************************************/
+
+void iob_free_global(FAR struct iob_s *iob);
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache with a batch from the global free list if it is empty.  Return
+ *   NULL if no IOB is cached and none can be taken.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(void);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a freed I/O buffer into the cache of the current CPU, draining a
+ *   batch to the global free list if the cache is full.  Return false if
+ *   the IOB must be freed to the global free list with iob_free_global()
+ *   instead, because there are tasks waiting for one.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_wait
+ *
+ * Description:
+ *   Called with true before a task waits for a free IOB and with false
+ *   after it stopped waiting, both in the critical section.  While any
+ *   task waits, the IOBs of all of the caches are given back to the
+ *   global free list and the caches are not used.
+ *
+ ****************************************************************************/
+
+void iob_cache_wait(bool waiting);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of free IOBs in the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
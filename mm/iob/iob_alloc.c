@@ -94,6 +94,9 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   irqstate_t flags;
   FAR sem_t *sem;
   int ret = OK;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  bool waiting = false;
+#endif
 
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore count to check. */
@@ -116,6 +119,21 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
    */
 
   iob = iob_tryalloc(throttled);
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (iob == NULL)
+    {
+      /* Take back the IOBs cached by all CPUs and stop caching while we
+       * wait, so that every freed IOB can reach us.
+       */
+
+      iob_cache_wait(true);
+      waiting = true;
+
+      iob = iob_tryalloc(throttled);
+    }
+#endif
+
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -173,6 +191,13 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
         }
     }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (waiting)
+    {
+      iob_cache_wait(false);
+    }
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -242,6 +267,27 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR sem_t *sem;
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Non-throttled allocations are served by the cache of this CPU first.
+   * The throttle only applies to the global free list.
+   */
+
+  if (!throttled)
+    {
+      iob = iob_cache_alloc();
+      if (iob != NULL)
+        {
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = NULL; /* Not in a chain */
+          iob->io_len    = 0;    /* Length of the data in the entry */
+          iob->io_offset = 0;    /* Offset to the beginning of data */
+          iob->io_pktlen = 0;    /* Total length of the packet */
+          return iob;
+        }
+    }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore count to check. */
 
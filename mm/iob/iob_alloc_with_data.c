@@ -0,0 +1,154 @@
+/****************************************************************************
+ * mm/iob/iob_alloc_with_data.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_EXTERNAL
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_ext_release
+ *
+ * Description:
+ *   Drop the reference of a freed IOB to external storage and give the
+ *   storage back to its owner with the last one.
+ *
+ ****************************************************************************/
+
+static void iob_ext_release(FAR void *arg)
+{
+  FAR struct iob_ext_s *ext = arg;
+  irqstate_t flags;
+  int16_t refs;
+
+  flags = enter_critical_section();
+  refs  = --ext->ie_refs;
+  leave_critical_section(flags);
+
+  DEBUGASSERT(refs >= 0);
+  if (refs == 0)
+    {
+      ext->ie_free(ext->ie_arg);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_ext_init
+ *
+ * Description:
+ *   Prepare the descriptor of external storage before it is lent to IOBs.
+ *
+ ****************************************************************************/
+
+void iob_ext_init(FAR struct iob_ext_s *ext, iob_free_cb_t freecb,
+                  FAR void *arg)
+{
+  DEBUGASSERT(ext != NULL && freecb != NULL);
+
+  ext->ie_free = freecb;
+  ext->ie_arg  = arg;
+  ext->ie_refs = 0;
+}
+
+/****************************************************************************
+ * Name: iob_ext_attach
+ *
+ * Description:
+ *   Make an empty I/O buffer use part of external storage as its payload
+ *   buffer instead of its own.
+ *
+ ****************************************************************************/
+
+void iob_ext_attach(FAR struct iob_s *iob, FAR struct iob_ext_s *ext,
+                    FAR uint8_t *buf)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(iob != NULL && iob->io_free == NULL);
+  DEBUGASSERT(ext != NULL && ext->ie_free != NULL && buf != NULL);
+
+  flags = enter_critical_section();
+  ext->ie_refs++;
+  leave_critical_section(flags);
+
+  iob->io_data    = buf;
+  iob->io_free    = iob_ext_release;
+  iob->io_freearg = ext;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_with_data
+ *
+ * Description:
+ *   Try to allocate an I/O buffer that references len bytes of storage
+ *   owned by the caller instead of its own payload buffer.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_with_data(bool throttled,
+                                         FAR const void *data,
+                                         unsigned int len,
+                                         iob_free_cb_t freecb,
+                                         FAR void *arg)
+{
+  FAR struct iob_s *iob;
+
+  DEBUGASSERT(data != NULL && freecb != NULL);
+  DEBUGASSERT(len > 0 && len <= CONFIG_IOB_BUFSIZE);
+
+  iob = iob_tryalloc(throttled);
+  if (iob != NULL)
+    {
+      /* Place the data at the end of the (virtual) buffer so that the
+       * generic length arithmetic sees a full entry:  IOB_FREESPACE() and
+       * iob_tailroom() report zero and nothing is ever appended to the
+       * lent storage.
+       */
+
+      iob->io_offset  = CONFIG_IOB_BUFSIZE - len;
+      iob->io_len     = len;
+      iob->io_pktlen  = len;
+      iob->io_data    = (FAR uint8_t *)data - iob->io_offset;
+      iob->io_free    = freecb;
+      iob->io_freearg = arg;
+    }
+
+  return iob;
+}
+
+#endif /* CONFIG_IOB_EXTERNAL */
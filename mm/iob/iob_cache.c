@@ -0,0 +1,326 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A cache is refilled with and drained by batches of this many IOBs, so
+ * that it holds at most twice as many.
+ */
+
+#define IOB_CACHE_BATCH  CONFIG_IOB_PERCPU_CACHE
+#define IOB_CACHE_MAX    (2 * IOB_CACHE_BATCH)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The free IOBs cached by one CPU.  Its lock is only contended when
+ * iob_cache_wait() drains the cache of another CPU.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t lock;
+  FAR struct iob_s *head;
+  int16_t count;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/* The number of tasks waiting for an IOB.  The caches are not used while
+ * there are any, so that all freed IOBs reach the waiters.
+ */
+
+static volatile int16_t g_iob_cache_nwaiters;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_refill
+ *
+ * Description:
+ *   Take a batch of IOBs from the global free list, as many as are free
+ *   for non-throttled allocations.  They count as allocated from then on.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_cache_refill(FAR int16_t *count)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  *count = 0;
+  flags  = enter_critical_section();
+
+  while (*count < IOB_CACHE_BATCH && g_iob_cache_nwaiters == 0 &&
+         g_iob_sem.semcount > 0 &&
+         (iob = g_iob_freelist) != NULL)
+    {
+      g_iob_freelist = iob->io_flink;
+      g_iob_sem.semcount--;
+#if CONFIG_IOB_THROTTLE > 0
+      g_throttle_sem.semcount--;
+#endif
+
+      iob->io_flink = head;
+      head = iob;
+      (*count)++;
+    }
+
+  leave_critical_section(flags);
+  return head;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Give a list of IOBs back to the global free list.
+ *
+ ****************************************************************************/
+
+static void iob_cache_drain(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+      iob_free_global(iob);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an IOB from the cache of the current CPU, refilling the cache
+ *   from the global free list if it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(void)
+{
+  FAR struct iob_cache_s *cache = &g_iob_cache[up_cpu_index()];
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int16_t count;
+
+  /* The task may migrate to another CPU before the lock is taken; then it
+   * just uses the cache of the CPU that it ran on.
+   */
+
+  flags = spin_lock_irqsave(&cache->lock);
+  iob   = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+      spin_unlock_irqrestore(&cache->lock, flags);
+      return iob;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  /* The lock of the cache is never held while entering the critical
+   * section, see iob_cache_wait().
+   */
+
+  iob = iob_cache_refill(&count);
+  if (iob != NULL && count > 1)
+    {
+      flags = spin_lock_irqsave(&cache->lock);
+      cache->count += count - 1;
+      while (--count > 0)
+        {
+          FAR struct iob_s *next = iob->io_flink;
+
+          iob->io_flink = next->io_flink;
+          next->io_flink = cache->head;
+          cache->head = next;
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a freed IOB into the cache of the current CPU, draining a batch to
+ *   the global free list if the cache is full.  Return false if the IOB
+ *   must be freed to the global free list instead, because there are
+ *   tasks waiting for one.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache = &g_iob_cache[up_cpu_index()];
+  FAR struct iob_s *drain = NULL;
+  FAR struct iob_s *last;
+  irqstate_t flags;
+  int i;
+
+  /* A waiter sets g_iob_cache_nwaiters before it takes the locks of the
+   * caches to flush them, so either it sees the IOB or the IOB is not
+   * cached.
+   */
+
+  flags = spin_lock_irqsave(&cache->lock);
+  if (g_iob_cache_nwaiters > 0)
+    {
+      spin_unlock_irqrestore(&cache->lock, flags);
+      return false;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  if (++cache->count > IOB_CACHE_MAX)
+    {
+      /* Detach the oldest batch, past the newest ones */
+
+      last = cache->head;
+      for (i = 1; i < IOB_CACHE_MAX - IOB_CACHE_BATCH; i++)
+        {
+          last = last->io_flink;
+        }
+
+      drain          = last->io_flink;
+      last->io_flink = NULL;
+      cache->count   = IOB_CACHE_MAX - IOB_CACHE_BATCH;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (drain != NULL)
+    {
+      iob_cache_drain(drain);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_wait
+ *
+ * Description:
+ *   Called with true before a task waits for a free IOB and with false
+ *   after it stopped waiting, both in the critical section.  While any
+ *   task waits, the IOBs of all of the caches are given back to the
+ *   global free list and the caches are not used.
+ *
+ ****************************************************************************/
+
+void iob_cache_wait(bool waiting)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int cpu;
+
+  if (!waiting)
+    {
+      DEBUGASSERT(g_iob_cache_nwaiters > 0);
+      g_iob_cache_nwaiters--;
+      return;
+    }
+
+  g_iob_cache_nwaiters++;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+
+      flags = spin_lock_irqsave(&cache->lock);
+      iob          = cache->head;
+      cache->head  = NULL;
+      cache->count = 0;
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      for (; iob != NULL; iob = next)
+        {
+          next = iob->io_flink;
+          iob_free_global(iob);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of IOBs in all of the caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_cache[cpu].count;
+    }
+
+  return navail;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
@@ -62,6 +62,70 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_global
+ *
+ * Description:
+ *   Return a free I/O buffer to the global free list, or hand it over to a
+ *   task waiting for one.  Called in the critical section.
+ *
+ ****************************************************************************/
+
+void iob_free_global(FAR struct iob_s *iob)
+{
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t navail;
+#endif
+
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on either the free list or on the committed list where
+   * it is reserved for that allocation (and not available to
+   * iob_tryalloc()).
+   */
+
+  if (g_iob_sem.semcount < 0)
+    {
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+    }
+  else
+    {
+      iob->io_flink   = g_iob_freelist;
+      g_iob_freelist  = iob;
+    }
+
+  /* Signal that an IOB is available.  If there is a thread blocked,
+   * waiting for an IOB, this will wake up exactly one thread.  The
+   * semaphore count will correctly indicated that the awakened task
+   * owns an IOB and should find it in the committed list.
+   */
+
+  nxsem_post(&g_iob_sem);
+  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+  nxsem_post(&g_throttle_sem);
+  DEBUGASSERT(g_throttle_sem.semcount <=
+              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & IOB_MASK) == 0)
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -75,9 +139,6 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
   irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -98,6 +159,14 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 
           next->io_pktlen = iob->io_pktlen - iob->io_len;
           DEBUGASSERT(next->io_pktlen >= next->io_len);
+
+#ifdef CONFIG_IOB_TIMESTAMP
+          /* The time stamp of the packet moves to the new head as well */
+
+          next->io_tstype = iob->io_tstype;
+          next->io_tskey  = iob->io_tskey;
+          next->io_tstamp = iob->io_tstamp;
+#endif
         }
       else
         {
@@ -112,62 +181,53 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
               next, next->io_pktlen, next->io_len);
     }
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = enter_critical_section();
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()).
-   */
+#ifdef CONFIG_IOB_EXTERNAL
+  /* Give lent storage back to its owner */
 
-  if (g_iob_sem.semcount < 0)
+  if (iob->io_free != NULL)
     {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
+      iob->io_free(iob->io_freearg);
+      iob->io_free = NULL;
     }
-  else
-    {
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-    }
-
-  /* Signal that an IOB is available.  If there is a thread blocked,
-   * waiting for an IOB, this will wake up exactly one thread.  The
-   * semaphore count will correctly indicated that the awakened task
-   * owns an IOB and should find it in the committed list.
-   */
 
-  nxsem_post(&g_iob_sem);
-  DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+  iob->io_data = iob->io_buf;
+#endif
 
-#if CONFIG_IOB_THROTTLE > 0
-  nxsem_post(&g_throttle_sem);
-  DEBUGASSERT(g_throttle_sem.semcount <=
-              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#ifdef CONFIG_IOB_TIMESTAMP
+  iob->io_tstype = IOB_TSTAMP_NONE;
+  iob->io_tskey  = 0;
 #endif
 
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
+#ifdef CONFIG_IOB_POOLS
+  /* Uncharge the IOB from the pool of its subsystem */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
+  if (iob->io_pool != IOB_POOL_NONE)
     {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
+      flags = enter_critical_section();
+      g_iob_pools[iob->io_pool].inuse--;
+      DEBUGASSERT(g_iob_pools[iob->io_pool].inuse >= 0);
+      iob->io_pool = IOB_POOL_NONE;
+      leave_critical_section(flags);
+    }
+#endif
 
-      iob_notifier_signal();
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the I/O buffer in the cache of this CPU if possible */
+
+  if (iob_cache_free(iob))
+    {
+      return next;
     }
 #endif
 
+  /* Free the I/O buffer by adding it to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+  iob_free_global(iob);
   leave_critical_section(flags);
 
   /* And return the I/O buffer after the one that was freed */
@@ -134,6 +134,10 @@ void iob_initialize(void)
     {
       FAR struct iob_s *iob = (FAR struct iob_s *)(buf + i * IOB_ALIGN_SIZE);
 
+#ifdef CONFIG_IOB_EXTERNAL
+      iob->io_data   = iob->io_buf;
+#endif
+
       /* Add the pre-allocate I/O buffer to the head of the free list */
 
       iob->io_flink  = g_iob_freelist;
@@ -72,9 +72,11 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
     {
       next = iob->io_flink;
 
-      /* Eliminate the data offset in this entry */
+      /* Eliminate the data offset in this entry.  Lent storage is
+       * read-only, so such entries are left as they are.
+       */
 
-      if (iob->io_offset > 0)
+      if (iob->io_offset > 0 && !IOB_ISLENT(iob))
         {
           memcpy(iob->io_data, &iob->io_data[iob->io_offset], iob->io_len);
           iob->io_offset = 0;
@@ -90,7 +92,7 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
            */
 
           ncopy  = next->io_len;
-          navail = CONFIG_IOB_BUFSIZE - iob->io_len;
+          navail = IOB_FREESPACE(iob);
           if (ncopy > navail)
             {
               ncopy = navail;
@@ -0,0 +1,153 @@
+/****************************************************************************
+ * mm/iob/iob_pool.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_POOLS
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The pools of the subsystems, indexed by enum iob_pool_e */
+
+struct iob_pool_s g_iob_pools[IOB_NPOOLS] =
+{
+  {
+    0, 0, 0                     /* IOB_POOL_NONE */
+  },
+  {
+    CONFIG_IOB_POOL_TCP_QUOTA, CONFIG_IOB_POOL_TCP_THROTTLE, 0
+  },
+  {
+    CONFIG_IOB_POOL_UDP_QUOTA, CONFIG_IOB_POOL_UDP_THROTTLE, 0
+  },
+  {
+    CONFIG_IOB_POOL_CAN_QUOTA, CONFIG_IOB_POOL_CAN_THROTTLE, 0
+  }
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_pool_charge
+ *
+ * Description:
+ *   Charge all of the IOBs of a chain to the pool of a subsystem.
+ *
+ ****************************************************************************/
+
+int iob_pool_charge(enum iob_pool_e pool, FAR struct iob_s *iob)
+{
+  FAR struct iob_pool_s *ppool;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int niob = 0;
+  int ret = OK;
+
+  DEBUGASSERT(pool > IOB_POOL_NONE && pool < IOB_NPOOLS);
+
+  ppool = &g_iob_pools[pool];
+  flags = enter_critical_section();
+
+  /* The IOBs already charged to this pool do not count again.  The
+   * throttle is only checked against the free IOBs: the chain has been
+   * allocated already but would be dropped if refused.
+   */
+
+  for (next = iob; next != NULL; next = next->io_flink)
+    {
+      if (next->io_pool != pool)
+        {
+          niob++;
+        }
+    }
+
+  if (g_iob_sem.semcount < ppool->throttle ||
+      (ppool->quota > 0 && ppool->inuse + niob > ppool->quota))
+    {
+      ret = -ENOBUFS;
+    }
+  else
+    {
+      for (next = iob; next != NULL; next = next->io_flink)
+        {
+          if (next->io_pool != pool)
+            {
+              if (next->io_pool != IOB_POOL_NONE)
+                {
+                  g_iob_pools[next->io_pool].inuse--;
+                }
+
+              next->io_pool = pool;
+            }
+        }
+
+      ppool->inuse += niob;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iob_pool_navail
+ *
+ * Description:
+ *   Return the number of IOBs that can still be charged to a pool.
+ *
+ ****************************************************************************/
+
+int iob_pool_navail(enum iob_pool_e pool)
+{
+  FAR struct iob_pool_s *ppool;
+  irqstate_t flags;
+  int navail;
+
+  DEBUGASSERT(pool > IOB_POOL_NONE && pool < IOB_NPOOLS);
+
+  ppool  = &g_iob_pools[pool];
+  flags  = enter_critical_section();
+
+  navail = g_iob_sem.semcount - ppool->throttle;
+  if (ppool->quota > 0 && ppool->quota - ppool->inuse < navail)
+    {
+      navail = ppool->quota - ppool->inuse;
+    }
+
+  leave_critical_section(flags);
+  return navail > 0 ? navail : 0;
+}
+
+#endif /* CONFIG_IOB_POOLS */
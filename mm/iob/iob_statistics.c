@@ -65,6 +65,12 @@ void iob_getstats(FAR struct iob_stats_s *stats)
       stats->nwait = 0;
     }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* The IOBs cached by the CPUs are free, too */
+
+  stats->nfree += iob_cache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   nxsem_get_value(&g_throttle_sem, &stats->nthrottle);
   if (stats->nthrottle < 0)
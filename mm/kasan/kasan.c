@@ -18,16 +18,25 @@
  *
  ****************************************************************************/
 
+/* The shadow of a region has one byte per granule of 8 bytes, like that of
+ * the address sanitizer:  0 if the whole granule is accessible, n from 1 to
+ * 7 if only its first n bytes are, and KASAN_POISONED if none is.  So an
+ * aligned access of up to 8 bytes is checked with a single shadow byte, and
+ * the shadow bytes are updated without a lock.
+ */
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/compiler.h>
 #include <nuttx/spinlock.h>
 
 #include <assert.h>
 #include <debug.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "kasan.h"
 
@@ -35,18 +44,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define KASAN_BYTES_PER_WORD (sizeof(uintptr_t))
-#define KASAN_BITS_PER_WORD  (KASAN_BYTES_PER_WORD * 8)
-
-#define KASAN_FIRST_WORD_MASK(start) \
-  (UINTPTR_MAX << ((start) & (KASAN_BITS_PER_WORD - 1)))
-#define KASAN_LAST_WORD_MASK(end) \
-  (UINTPTR_MAX >> (-(end) & (KASAN_BITS_PER_WORD - 1)))
+#define KASAN_SHADOW_SCALE   8
+#define KASAN_SHADOW_MASK    (KASAN_SHADOW_SCALE - 1)
 
-#define KASAN_SHADOW_SCALE (sizeof(uintptr_t))
+#define KASAN_POISONED       0xff
 
 #define KASAN_SHADOW_SIZE(size) \
-  (KASAN_BYTES_PER_WORD * ((size) / KASAN_SHADOW_SCALE / KASAN_BITS_PER_WORD))
+  (((size) / KASAN_SHADOW_SCALE + sizeof(uintptr_t)) & \
+   ~(sizeof(uintptr_t) - 1))
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
@@ -61,7 +66,7 @@ struct kasan_region_s
   FAR struct kasan_region_s *next;
   uintptr_t                  begin;
   uintptr_t                  end;
-  uintptr_t                  shadow[1];
+  uint8_t                    shadow[1];
 };
 
 /****************************************************************************
@@ -72,30 +77,39 @@ static spinlock_t g_lock;
 static FAR struct kasan_region_s *g_region;
 static uint32_t g_region_init;
 
+/* The region of the last access.  Most accesses hit the same region as the
+ * previous one, and regions are never removed, so it is safe to read and
+ * update without the lock.
+ */
+
+static FAR struct kasan_region_s *g_region_last;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                                          unsigned int *bit)
+static always_inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr)
 {
   FAR struct kasan_region_s *region;
-  uintptr_t addr = (uintptr_t)ptr;
 
   if (g_region_init != KASAN_INIT_VALUE)
     {
       return NULL;
     }
 
+  region = g_region_last;
+  if (region != NULL && addr >= region->begin && addr < region->end)
+    {
+      return region;
+    }
+
   for (region = g_region; region != NULL; region = region->next)
     {
       if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= region->end);
-          addr -= region->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &region->shadow[addr / KASAN_BITS_PER_WORD];
+          g_region_last = region;
+          return region;
         }
     }
 
@@ -117,65 +131,133 @@ static void kasan_report(FAR const void *addr, size_t size, bool is_write)
   --recursion;
 }
 
+static bool kasan_range_is_poisoned(FAR struct kasan_region_s *region,
+                                    uintptr_t addr, size_t size)
+{
+  uintptr_t last;
+  uintptr_t i;
+
+  if (size == 0)
+    {
+      return false;
+    }
+
+  if (addr + size > region->end)
+    {
+      return true;
+    }
+
+  /* All the granules but the last one must be entirely accessible */
+
+  last = addr - region->begin + size - 1;
+  for (i = (addr - region->begin) / KASAN_SHADOW_SCALE;
+       i < last / KASAN_SHADOW_SCALE; i++)
+    {
+      if (region->shadow[i] != 0)
+        {
+          return true;
+        }
+    }
+
+  return region->shadow[i] != 0 &&
+         (last & KASAN_SHADOW_MASK) >= region->shadow[i];
+}
+
 static bool kasan_is_poisoned(FAR const void *addr, size_t size)
 {
-  FAR uintptr_t *p;
-  unsigned int bit;
+  FAR struct kasan_region_s *region;
 
-  p = kasan_mem_to_shadow(addr + size - 1, 1, &bit);
-  return p && ((*p >> bit) & 1);
+  region = kasan_find_region((uintptr_t)addr);
+  return region != NULL &&
+         kasan_range_is_poisoned(region, (uintptr_t)addr, size);
+}
+
+/* The check of the accesses of 1, 2, 4 and 8 bytes, which are by far the
+ * most frequent ones:  Unless they cross a granule, which aligned ones
+ * never do, they are decided by a single shadow byte.
+ */
+
+static always_inline_function bool
+kasan_is_poisoned_small(FAR const void *addr, size_t size)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t offset;
+  int8_t shadow;
+
+  region = kasan_find_region((uintptr_t)addr);
+  if (region == NULL)
+    {
+      return false;
+    }
+
+  offset = (uintptr_t)addr - region->begin;
+  if ((offset & KASAN_SHADOW_MASK) + size > KASAN_SHADOW_SCALE)
+    {
+      return kasan_range_is_poisoned(region, (uintptr_t)addr, size);
+    }
+
+  /* KASAN_POISONED is negative, so it fails the comparison */
+
+  shadow = (int8_t)region->shadow[offset / KASAN_SHADOW_SCALE];
+  return shadow != 0 &&
+         (int8_t)((offset & KASAN_SHADOW_MASK) + size - 1) >= shadow;
 }
 
 static void kasan_set_poison(FAR const void *addr, size_t size,
                              bool poisoned)
 {
-  FAR uintptr_t *p;
-  unsigned int bit;
-  unsigned int nbit;
-  uintptr_t mask;
-  int flags;
+  FAR struct kasan_region_s *region;
+  FAR uint8_t *shadow;
+  uintptr_t begin;
+  uintptr_t end;
 
-  flags = spin_lock_irqsave(&g_lock);
+  /* Ranges that are not registered, e.g. those of the heaps that are not
+   * checked, are silently ignored.
+   */
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
-  DEBUGASSERT(p != NULL);
+  region = kasan_find_region((uintptr_t)addr);
+  if (region == NULL || size == 0)
+    {
+      return;
+    }
 
-  nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
-  mask = KASAN_FIRST_WORD_MASK(bit);
+  begin = (uintptr_t)addr - region->begin;
+  end   = begin + size;
+  DEBUGASSERT((uintptr_t)addr + size <= region->end);
 
-  size /= KASAN_SHADOW_SCALE;
-  while (size >= nbit)
+  if (poisoned)
     {
-      if (poisoned)
+      /* The head of a granule can stay accessible, but not its tail */
+
+      if (begin & KASAN_SHADOW_MASK)
         {
-          *p++ |= mask;
+          shadow = &region->shadow[begin / KASAN_SHADOW_SCALE];
+          if (*shadow == 0 || *shadow > (begin & KASAN_SHADOW_MASK))
+            {
+              *shadow = begin & KASAN_SHADOW_MASK;
+            }
+
+          begin += KASAN_SHADOW_SCALE;
         }
-      else
+
+      begin /= KASAN_SHADOW_SCALE;
+      end   /= KASAN_SHADOW_SCALE;
+      if (end > begin)
         {
-          *p++ &= ~mask;
+          memset(&region->shadow[begin], KASAN_POISONED, end - begin);
         }
-
-      bit  += nbit;
-      size -= nbit;
-
-      nbit = KASAN_BITS_PER_WORD;
-      mask = UINTPTR_MAX;
     }
-
-  if (size)
+  else
     {
-      mask &= KASAN_LAST_WORD_MASK(bit + size);
-      if (poisoned)
+      begin /= KASAN_SHADOW_SCALE;
+      memset(&region->shadow[begin], 0,
+             end / KASAN_SHADOW_SCALE - begin);
+      if (end & KASAN_SHADOW_MASK)
         {
-          *p |= mask;
-        }
-      else
-        {
-          *p &= ~mask;
+          region->shadow[end / KASAN_SHADOW_SCALE] =
+            end & KASAN_SHADOW_MASK;
         }
     }
-
-  spin_unlock_irqrestore(&g_lock, flags);
 }
 
 /****************************************************************************
@@ -202,8 +284,11 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  /* Granules are aligned, so that aligned accesses never cross them */
+
+  region->begin = (uintptr_t)addr & ~KASAN_SHADOW_MASK;
+  region->end   = (uintptr_t)addr + *size;
+  memset(region->shadow, KASAN_POISONED, KASAN_SHADOW_SIZE(*size));
 
   flags = spin_lock_irqsave(&g_lock);
   region->next  = g_region;
@@ -211,10 +296,40 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   g_region_init = KASAN_INIT_VALUE;
   spin_unlock_irqrestore(&g_lock, flags);
 
-  kasan_poison(addr, *size);
   *size -= KASAN_REGION_SIZE(*size);
 }
 
+bool kasan_heap_enabled(FAR const char *name)
+{
+  FAR const char *heaps = CONFIG_MM_KASAN_HEAPS;
+  size_t len;
+
+  if (*heaps == '\0')
+    {
+      return true;
+    }
+
+  len = strlen(name);
+  while (*heaps != '\0')
+    {
+      if (strncmp(heaps, name, len) == 0 &&
+          (heaps[len] == ',' || heaps[len] == '\0'))
+        {
+          return true;
+        }
+
+      heaps = strchr(heaps, ',');
+      if (heaps == NULL)
+        {
+          break;
+        }
+
+      heaps++;
+    }
+
+  return false;
+}
+
 /* Exported functions called from the compiler generated code */
 
 void __sanitizer_annotate_contiguous_container(FAR const void *beg,
@@ -328,42 +443,66 @@ void __asan_store16_noabort(FAR void *addr)
 
 void __asan_load8_noabort(FAR void *addr)
 {
-  __asan_loadN_noabort(addr, 8);
+  if (kasan_is_poisoned_small(addr, 8))
+    {
+      kasan_report(addr, 8, false);
+    }
 }
 
 void __asan_store8_noabort(FAR void *addr)
 {
-  __asan_storeN_noabort(addr, 8);
+  if (kasan_is_poisoned_small(addr, 8))
+    {
+      kasan_report(addr, 8, true);
+    }
 }
 
 void __asan_load4_noabort(FAR void *addr)
 {
-  __asan_loadN_noabort(addr, 4);
+  if (kasan_is_poisoned_small(addr, 4))
+    {
+      kasan_report(addr, 4, false);
+    }
 }
 
 void __asan_store4_noabort(FAR void *addr)
 {
-  __asan_storeN_noabort(addr, 4);
+  if (kasan_is_poisoned_small(addr, 4))
+    {
+      kasan_report(addr, 4, true);
+    }
 }
 
 void __asan_load2_noabort(FAR void *addr)
 {
-  __asan_loadN_noabort(addr, 2);
+  if (kasan_is_poisoned_small(addr, 2))
+    {
+      kasan_report(addr, 2, false);
+    }
 }
 
 void __asan_store2_noabort(FAR void *addr)
 {
-  __asan_storeN_noabort(addr, 2);
+  if (kasan_is_poisoned_small(addr, 2))
+    {
+      kasan_report(addr, 2, true);
+    }
 }
 
 void __asan_load1_noabort(FAR void *addr)
 {
-  __asan_loadN_noabort(addr, 1);
+  if (kasan_is_poisoned_small(addr, 1))
+    {
+      kasan_report(addr, 1, false);
+    }
 }
 
 void __asan_store1_noabort(FAR void *addr)
 {
-  __asan_storeN_noabort(addr, 1);
+  if (kasan_is_poisoned_small(addr, 1))
+    {
+      kasan_report(addr, 1, true);
+    }
 }
 
 void __asan_loadN(FAR void *addr, size_t size)
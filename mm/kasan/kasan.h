@@ -25,6 +25,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /****************************************************************************
@@ -35,6 +36,7 @@
 #  define kasan_poison(addr, size)
 #  define kasan_unpoison(addr, size)
 #  define kasan_register(addr, size)
+#  define kasan_heap_enabled(name) false
 #endif
 
 /****************************************************************************
@@ -105,6 +107,23 @@ void kasan_unpoison(FAR const void *addr, size_t size);
 
 void kasan_register(FAR void *addr, FAR size_t *size);
 
+/****************************************************************************
+ * Name: kasan_heap_enabled
+ *
+ * Description:
+ *   Tell whether the regions of a heap should be registered, according to
+ *   CONFIG_MM_KASAN_HEAPS
+ *
+ * Input Parameters:
+ *   name - the heap name passed to mm_initialize
+ *
+ * Returned Value:
+ *   True if the heap is checked.
+ *
+ ****************************************************************************/
+
+bool kasan_heap_enabled(FAR const char *name);
+
 #endif /* CONFIG_MM_KASAN */
 
 #undef EXTERN
@@ -29,6 +29,27 @@
 
 #include "kasan/kasan.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* In the lock-free mode the normal free list and the use count are updated
+ * without holding pool->lock.
+ */
+
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+#  define mempool_nused_add(p, n) \
+     __atomic_fetch_add(&(p)->nused, (n), __ATOMIC_RELAXED)
+#  define mempool_nused_sub(p, n) \
+     __atomic_fetch_sub(&(p)->nused, (n), __ATOMIC_RELAXED)
+#  define mempool_nused(p) \
+     __atomic_load_n(&(p)->nused, __ATOMIC_RELAXED)
+#else
+#  define mempool_nused_add(p, n) ((p)->nused += (n))
+#  define mempool_nused_sub(p, n) ((p)->nused -= (n))
+#  define mempool_nused(p)        ((p)->nused)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -43,6 +64,99 @@ static inline void mempool_add_list(FAR sq_queue_t *list, FAR void *base,
     }
 }
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+/****************************************************************************
+ * Name: mempool_lf_push
+ *
+ * Description:
+ *   Push the chain of blocks first..last onto a lock-free list with a
+ *   single compare-and-swap.
+ *
+ ****************************************************************************/
+
+static void mempool_lf_push(FAR struct mempool_lfhead_s *list,
+                            FAR sq_entry_t *first, FAR sq_entry_t *last)
+{
+  struct mempool_lfhead_s old;
+  struct mempool_lfhead_s new;
+
+  /* The two halves may be read torn; the compare-and-swap validates them */
+
+  old.tag  = __atomic_load_n(&list->tag, __ATOMIC_ACQUIRE);
+  old.head = __atomic_load_n(&list->head, __ATOMIC_ACQUIRE);
+
+  do
+    {
+      last->flink = old.head;
+      new.head    = first;
+      new.tag     = old.tag + 1;
+    }
+  while (!__atomic_compare_exchange(list, &old, &new, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+/****************************************************************************
+ * Name: mempool_lf_pop
+ *
+ * Description:
+ *   Pop the first block from a lock-free list with a compare-and-swap.
+ *   The link of the head block may be read while another CPU allocates
+ *   the block and overwrites it; that is harmless because the memory of a
+ *   pool is never released while the pool is in use, the link is never
+ *   followed, and the tag makes the compare-and-swap fail in that case.
+ *   Only the head may be read that way, so chains are popped one block at
+ *   a time.
+ *
+ * Returned Value:
+ *   The block, or NULL if the list is empty.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_lf_pop(FAR struct mempool_lfhead_s *list)
+{
+  struct mempool_lfhead_s old;
+  struct mempool_lfhead_s new;
+
+  old.tag  = __atomic_load_n(&list->tag, __ATOMIC_ACQUIRE);
+  old.head = __atomic_load_n(&list->head, __ATOMIC_ACQUIRE);
+
+  do
+    {
+      if (old.head == NULL)
+        {
+          return NULL;
+        }
+
+      new.head = old.head->flink;
+      new.tag  = old.tag + 1;
+    }
+  while (!__atomic_compare_exchange(list, &old, &new, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+  return old.head;
+}
+
+static void mempool_lf_add_list(FAR struct mempool_lfhead_s *list,
+                                FAR void *base, size_t nblks, size_t bsize)
+{
+  FAR sq_entry_t *first = base;
+  FAR sq_entry_t *blk = base;
+
+  if (nblks == 0)
+    {
+      return;
+    }
+
+  while (--nblks > 0)
+    {
+      blk->flink = (FAR sq_entry_t *)((FAR char *)blk + bsize);
+      blk = blk->flink;
+    }
+
+  mempool_lf_push(list, first, blk);
+}
+#endif
+
 static inline FAR void *mempool_malloc(FAR struct mempool_s *pool,
                                        size_t size)
 {
@@ -68,6 +182,126 @@ static inline void mempool_mfree(FAR struct mempool_s *pool, FAR void *addr)
     }
 }
 
+static inline bool mempool_is_iblk(FAR struct mempool_s *pool,
+                                   FAR void *blk)
+{
+  FAR char *base;
+
+  if (pool->ninterrupt == 0)
+    {
+      return false;
+    }
+
+  base = (FAR char *)(sq_peek(&pool->elist) + 1);
+  return (FAR char *)blk >= base &&
+         (FAR char *)blk < base + pool->ninterrupt * pool->bsize;
+}
+
+static int mempool_expand(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *base;
+  irqstate_t flags;
+
+  base = mempool_malloc(pool, sizeof(*base) + pool->bsize * pool->nexpand);
+  if (base == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  kasan_poison(base + 1, pool->bsize * pool->nexpand);
+  flags = spin_lock_irqsave(&pool->lock);
+  sq_addlast(base, &pool->elist);
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  mempool_lf_add_list(&pool->list, base + 1, pool->nexpand, pool->bsize);
+#else
+  mempool_add_list(&pool->list, base + 1, pool->nexpand, pool->bsize);
+#endif
+  spin_unlock_irqrestore(&pool->lock, flags);
+  return 0;
+}
+
+static FAR void *mempool_alloc_block(FAR struct mempool_s *pool, bool wait)
+{
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+retry:
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  /* The normal free list does not need the lock */
+
+  blk = mempool_lf_pop(&pool->list);
+  if (blk != NULL)
+    {
+      mempool_nused_add(pool, 1);
+      kasan_unpoison(blk, pool->bsize);
+      return blk;
+    }
+
+  flags = spin_lock_irqsave(&pool->lock);
+#else
+  flags = spin_lock_irqsave(&pool->lock);
+  blk = sq_remfirst(&pool->list);
+  if (blk == NULL)
+#endif
+    {
+      if (up_interrupt_context())
+        {
+          blk = sq_remfirst(&pool->ilist);
+          if (blk == NULL)
+            {
+              goto out_with_lock;
+            }
+        }
+      else
+        {
+          spin_unlock_irqrestore(&pool->lock, flags);
+          if (pool->nexpand != 0)
+            {
+              if (mempool_expand(pool) < 0)
+                {
+                  return NULL;
+                }
+
+              goto retry;
+            }
+          else if (!wait ||
+                   nxsem_wait_uninterruptible(&pool->waitsem) < 0)
+            {
+              return NULL;
+            }
+          else
+            {
+              goto retry;
+            }
+        }
+    }
+
+  mempool_nused_add(pool, 1);
+  kasan_unpoison(blk, pool->bsize);
+out_with_lock:
+  spin_unlock_irqrestore(&pool->lock, flags);
+  return blk;
+}
+
+static void mempool_wakeup(FAR struct mempool_s *pool, size_t nblks)
+{
+  int semcount;
+
+  if (pool->wait && pool->nexpand == 0)
+    {
+      while (nblks-- > 0)
+        {
+          nxsem_get_value(&pool->waitsem, &semcount);
+          if (semcount >= 1)
+            {
+              break;
+            }
+
+          nxsem_post(&pool->waitsem);
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -97,7 +331,12 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
   DEBUGASSERT(pool != NULL && pool->bsize != 0);
 
   pool->nused = 0;
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  pool->list.head = NULL;
+  pool->list.tag  = 0;
+#else
   sq_init(&pool->list);
+#endif
   sq_init(&pool->ilist);
   sq_init(&pool->elist);
 
@@ -114,9 +353,15 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
       sq_addfirst(base, &pool->elist);
       mempool_add_list(&pool->ilist, base + 1,
                        pool->ninterrupt, pool->bsize);
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+      mempool_lf_add_list(&pool->list, (FAR char *)(base + 1) +
+                          pool->ninterrupt * pool->bsize,
+                          pool->ninitial, pool->bsize);
+#else
       mempool_add_list(&pool->list, (FAR char *)(base + 1) +
                        pool->ninterrupt * pool->bsize,
                        pool->ninitial, pool->bsize);
+#endif
       kasan_poison(base + 1, pool->bsize * count);
     }
 
@@ -150,114 +395,189 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
  ****************************************************************************/
 
 FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  DEBUGASSERT(pool != NULL);
+
+  return mempool_alloc_block(pool, pool->wait);
+}
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Release an memory block to the pool.
+ *
+ * Input Parameters:
+ *   pool - Address of the memory pool to be used.
+ *   blk  - The pointer of memory block.
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
+{
+  DEBUGASSERT(pool != NULL && blk != NULL);
+
+  mempool_free_batch(pool, &blk, 1);
+}
+
+/****************************************************************************
+ * Name: mempool_alloc_batch
+ *
+ * Description:
+ *   Allocate up to nblks blocks from a specific memory pool in one
+ *   operation.  The blocks are taken from the free list with a single lock
+ *   hold (or with one compare-and-swap per block in the lock-free mode).
+ *   If the free list runs short, the interrupt reserve is used from
+ *   interrupt context or the pool is expanded otherwise, but this function
+ *   never waits.
+ *
+ * Input Parameters:
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array that receives the allocated blocks.
+ *   nblks - The number of blocks requested.
+ *
+ * Returned Value:
+ *   The number of blocks stored in blks, which may be less than nblks.
+ *
+ ****************************************************************************/
+
+size_t mempool_alloc_batch(FAR struct mempool_s *pool, FAR void **blks,
+                           size_t nblks)
 {
   FAR sq_entry_t *blk;
+  size_t count = 0;
+  size_t i;
+#ifndef CONFIG_MM_MEMPOOL_LOCKFREE
   irqstate_t flags;
+#endif
 
-  DEBUGASSERT(pool != NULL);
+  DEBUGASSERT(pool != NULL && (blks != NULL || nblks == 0));
 
-retry:
-  flags = spin_lock_irqsave(&pool->lock);
-  blk = sq_remfirst(&pool->list);
-  if (blk == NULL)
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  while (count < nblks && (blk = mempool_lf_pop(&pool->list)) != NULL)
     {
-      if (up_interrupt_context())
-        {
-          blk = sq_remfirst(&pool->ilist);
-          if (blk == NULL)
-            {
-              goto out_with_lock;
-            }
-        }
-      else
-        {
-          spin_unlock_irqrestore(&pool->lock, flags);
-          if (pool->nexpand != 0)
-            {
-              blk = mempool_malloc(pool, sizeof(*blk) + pool->bsize *
-                                   pool->nexpand);
-              if (blk == NULL)
-                {
-                  return NULL;
-                }
+      blks[count++] = blk;
+    }
 
-              kasan_poison(blk + 1, pool->bsize * pool->nexpand);
-              flags = spin_lock_irqsave(&pool->lock);
-              sq_addlast(blk, &pool->elist);
-              mempool_add_list(&pool->list, blk + 1, pool->nexpand,
-                               pool->bsize);
-              blk = sq_remfirst(&pool->list);
-            }
-          else if (!pool->wait ||
-                   nxsem_wait_uninterruptible(&pool->waitsem) < 0)
-            {
-              return NULL;
-            }
-          else
-            {
-              goto retry;
-            }
-        }
+  mempool_nused_add(pool, count);
+#else
+  flags = spin_lock_irqsave(&pool->lock);
+  while (count < nblks && (blk = sq_remfirst(&pool->list)) != NULL)
+    {
+      blks[count++] = blk;
     }
 
-  pool->nused++;
-  kasan_unpoison(blk, pool->bsize);
-out_with_lock:
+  pool->nused += count;
   spin_unlock_irqrestore(&pool->lock, flags);
-  return blk;
+#endif
+
+  for (i = 0; i < count; i++)
+    {
+      kasan_unpoison(blks[i], pool->bsize);
+    }
+
+  /* Fall back to the single block path for the remainder, which uses the
+   * interrupt reserve or expands the pool.
+   */
+
+  while (count < nblks && (blk = mempool_alloc_block(pool, false)) != NULL)
+    {
+      blks[count++] = blk;
+    }
+
+  return count;
 }
 
 /****************************************************************************
- * Name: mempool_free
+ * Name: mempool_free_batch
  *
  * Description:
- *   Release an memory block to the pool.
+ *   Release nblks memory blocks to the pool in one operation.
  *
  * Input Parameters:
- *   pool - Address of the memory pool to be used.
- *   blk  - The pointer of memory block.
+ *   pool  - Address of the memory pool to be used.
+ *   blks  - The array of the blocks to release.
+ *   nblks - The number of blocks in blks.
  ****************************************************************************/
 
-void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
+void mempool_free_batch(FAR struct mempool_s *pool, FAR void * const *blks,
+                        size_t nblks)
 {
+  FAR sq_entry_t *blk;
   irqstate_t flags;
+  size_t i;
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  FAR sq_entry_t *first = NULL;
+  FAR sq_entry_t *last = NULL;
+#endif
 
-  DEBUGASSERT(pool != NULL && blk != NULL);
+  DEBUGASSERT(pool != NULL && (blks != NULL || nblks == 0));
 
-  flags = spin_lock_irqsave(&pool->lock);
-  if (pool->ninterrupt)
+  if (nblks == 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  /* Chain the normal blocks together and push them with one
+   * compare-and-swap.  Only blocks of the interrupt reserve take the lock.
+   */
+
+  for (i = 0; i < nblks; i++)
     {
-      FAR char *base;
+      blk = blks[i];
+      DEBUGASSERT(blk != NULL);
 
-      base = (FAR char *)(sq_peek(&pool->elist) + 1);
-      if ((FAR char *)blk >= base &&
-          (FAR char *)blk < base + pool->ninterrupt * pool->bsize)
+      /* Poison the block before another CPU can allocate it */
+
+      kasan_poison(blk, pool->bsize);
+
+      if (mempool_is_iblk(pool, blk))
         {
+          flags = spin_lock_irqsave(&pool->lock);
           sq_addfirst(blk, &pool->ilist);
+          spin_unlock_irqrestore(&pool->lock, flags);
         }
       else
         {
-          sq_addfirst(blk, &pool->list);
+          blk->flink = first;
+          first = blk;
+          if (last == NULL)
+            {
+              last = blk;
+            }
         }
     }
-  else
+
+  if (first != NULL)
     {
-      sq_addfirst(blk, &pool->list);
+      mempool_lf_push(&pool->list, first, last);
     }
 
-  pool->nused--;
-  kasan_poison(blk, pool->bsize);
-  spin_unlock_irqrestore(&pool->lock, flags);
-  if (pool->wait && pool->nexpand == 0)
+  mempool_nused_sub(pool, nblks);
+#else
+  flags = spin_lock_irqsave(&pool->lock);
+  for (i = 0; i < nblks; i++)
     {
-      int semcount;
+      blk = blks[i];
+      DEBUGASSERT(blk != NULL);
 
-      nxsem_get_value(&pool->waitsem, &semcount);
-      if (semcount < 1)
+      if (mempool_is_iblk(pool, blk))
         {
-          nxsem_post(&pool->waitsem);
+          sq_addfirst(blk, &pool->ilist);
+        }
+      else
+        {
+          sq_addfirst(blk, &pool->list);
         }
+
+      kasan_poison(blk, pool->bsize);
     }
+
+  pool->nused -= nblks;
+  spin_unlock_irqrestore(&pool->lock, flags);
+#endif
+
+  mempool_wakeup(pool, nblks);
 }
 
 /****************************************************************************
@@ -277,14 +597,36 @@ void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
 int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   irqstate_t flags;
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  size_t total;
+#endif
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
   flags = spin_lock_irqsave(&pool->lock);
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  /* The lock-free list cannot be walked safely, so derive the number of
+   * free blocks from the number of blocks owned by the pool.
+   */
+
+  info->iordblks = sq_count(&pool->ilist);
+  info->aordblks = mempool_nused(pool);
+
+  total = sq_count(&pool->elist) * pool->nexpand;
+  if (pool->ninitial + pool->ninterrupt != 0)
+    {
+      total += pool->ninitial + pool->ninterrupt - pool->nexpand;
+    }
+
+  total -= info->iordblks;
+  info->ordblks = total > info->aordblks ? total - info->aordblks : 0;
+#else
   info->ordblks = sq_count(&pool->list);
   info->iordblks = sq_count(&pool->ilist);
   info->aordblks = pool->nused;
-  info->arena = (pool->nused + info->ordblks + info->iordblks) * pool->bsize;
+#endif
+  info->arena = (info->aordblks + info->ordblks + info->iordblks) *
+                pool->bsize;
   spin_unlock_irqrestore(&pool->lock, flags);
   info->sizeblks = pool->bsize;
   if (pool->wait && pool->nexpand == 0)
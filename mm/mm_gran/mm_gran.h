@@ -27,22 +27,50 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <strings.h>
 
 #include <arch/types.h>
 #include <nuttx/mm/gran.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* Sizes of things */
+/* The per-CPU cache is only usable where interrupts may be disabled */
+
+#if defined(CONFIG_GRAN_CPUCACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define GRAN_HAVE_CPUCACHE 1
+#endif
+
+/* Sizes of things.  The GAT is followed by the summary, with one bit per
+ * GAT entry that is set while all of its granules are allocated.
+ */
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + sizeof(uint32_t) * \
+   (SIZEOF_GAT(n) + SIZEOF_GAT(SIZEOF_GAT(n)) - 1))
+
+/* Bit scans of a non-zero GAT entry */
+
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+#  define gran_ctz(x) __builtin_ctzl((unsigned long)(x))
+#else
+#  define gran_ctz(x) (ffsl((long)(x)) - 1)
+#endif
+
+#ifdef CONFIG_HAVE_BUILTIN_CLZ
+#  define gran_clz(x) (__builtin_clzl((unsigned long)(x)) - \
+                       (8 * sizeof(long) - 32))
+#else
+#  define gran_clz(x) (32 - flsl((long)(x)))
+#endif
 
 /* Debug */
 
@@ -60,6 +88,17 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_GRAN_CPUCACHE
+/* Single granules reserved by one CPU.  They are allocated in the GAT. */
+
+struct gran_cpucache_s
+{
+  spinlock_t lock;      /* Only contended by gran_cpucache_drain() */
+  uint8_t    count;     /* The number of cached granules */
+  uint16_t   granno[CONFIG_GRAN_CPUCACHE_DEPTH];
+};
+#endif
+
 /* This structure represents the state of one granule allocation */
 
 struct gran_s
@@ -72,6 +111,13 @@ struct gran_s
   mutex_t    lock;       /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+
+  /* The bitmap of the full GAT entries, stored after the GAT */
+
+  FAR uint32_t *summary;
+#ifdef CONFIG_GRAN_CPUCACHE
+  struct gran_cpucache_s cpucache[CONFIG_SMP_NCPUS];
+#endif
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
@@ -97,6 +143,23 @@ struct gran_s
 int  gran_enter_critical(FAR struct gran_s *priv);
 void gran_leave_critical(FAR struct gran_s *priv);
 
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Find the first run of free granules that is long enough.
+ *
+ * Input Parameters:
+ *   priv      - The granule heap state structure.
+ *   ngranules - The number of granules needed
+ *
+ * Returned Value:
+ *   The number of the first granule of the run, or -ENOMEM.
+ *
+ ****************************************************************************/
+
+int gran_search(FAR struct gran_s *priv, unsigned int ngranules);
+
 /****************************************************************************
  * Name: gran_mark_allocated
  *
@@ -117,4 +180,41 @@ void gran_leave_critical(FAR struct gran_s *priv);
 FAR void *gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
                               unsigned int ngranules);
 
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of allocated granules as free.
+ *
+ * Input Parameters:
+ *   priv      - The granule heap state structure.
+ *   granno    - The number of the first granule
+ *   ngranules - The number of granules to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void gran_mark_free(FAR struct gran_s *priv, unsigned int granno,
+                    unsigned int ngranules);
+
+/****************************************************************************
+ * Name: gran_cpucache_*
+ *
+ * Description:
+ *   Allocate and free single granules from the cache of the current CPU,
+ *   without entering the critical section of the allocator.  The refill
+ *   of the cache of the current CPU and the drain of all caches back to
+ *   the GAT must be called in the critical section.
+ *
+ ****************************************************************************/
+
+#ifdef GRAN_HAVE_CPUCACHE
+FAR void *gran_cpucache_alloc(FAR struct gran_s *priv);
+bool gran_cpucache_free(FAR struct gran_s *priv, FAR void *memory);
+void gran_cpucache_refill(FAR struct gran_s *priv);
+bool gran_cpucache_drain(FAR struct gran_s *priv);
+#endif
+
 #endif /* __MM_MM_GRAN_MM_GRAN_H */
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <errno.h>
 
 #include <nuttx/mm/gran.h>
 
@@ -33,218 +34,217 @@
 #ifdef CONFIG_GRAN
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: gran_alloc
+ * Name: gran_fit
  *
  * Description:
- *   Allocate memory from the granule heap.
+ *   Return the bits of a GAT entry that start a run of ngranules free
+ *   granules within the entry.  Each step doubles the length of the runs
+ *   that the bits stand for, so the cost is logarithmic in ngranules.
+ *
+ ****************************************************************************/
+
+static uint32_t gran_fit(uint32_t gat, unsigned int ngranules)
+{
+  uint32_t fit = ~gat;
+  unsigned int len = 1;
+  unsigned int shift;
+
+  while (len < ngranules && fit != 0)
+    {
+      shift = len < ngranules - len ? len : ngranules - len;
+      fit  &= fit >> shift;
+      len  += shift;
+    }
+
+  return fit;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_search
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ * Description:
+ *   Find the first run of free granules that is long enough.  The GAT is
+ *   scanned one entry at a time, and the summary lets the scan skip the
+ *   full entries without reading them.
  *
  * Input Parameters:
- *   handle - The handle previously returned by gran_initialize
- *   size   - The size of the memory region to allocate.
+ *   priv      - The granule heap state structure.
+ *   ngranules - The number of granules needed
  *
  * Returned Value:
- *   On success, a non-NULL pointer to the allocated memory is returned;
- *   NULL is returned on failure.
+ *   The number of the first granule of the run, or -ENOMEM.
  *
  ****************************************************************************/
 
-FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
+int gran_search(FAR struct gran_s *priv, unsigned int ngranules)
 {
-  FAR struct gran_s *priv = (FAR struct gran_s *)handle;
-  unsigned int ngranules;
-  size_t       tmpmask;
-  uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
-  int          ret;
-
-  DEBUGASSERT(priv != NULL && size <= 32 * (1 << priv->log2gran));
-
-  if (priv != NULL && size > 0)
+  unsigned int ngat = SIZEOF_GAT(priv->ngranules);
+  unsigned int run = 0;
+  unsigned int gatidx = 0;
+  uint32_t notfull;
+  uint32_t gat;
+  uint32_t fit;
+
+  while (gatidx < ngat)
     {
-      /* Get exclusive access to the GAT */
+      /* Skip to the next entry that is not full.  The summary bits past
+       * the end of the GAT are set.
+       */
 
-      ret = gran_enter_critical(priv);
-      if (ret < 0)
+      notfull = ~priv->summary[gatidx >> 5] >> (gatidx & 31);
+      if (notfull == 0)
         {
-          return NULL;
+          run     = 0;
+          gatidx  = (gatidx | 31) + 1;
+          continue;
         }
-
-      /* How many contiguous granules we we need to find? */
-
-      tmpmask   = (1 << priv->log2gran) - 1;
-      ngranules = (size + tmpmask) >> priv->log2gran;
-
-      /* Then create mask for that number of granules */
-
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
-
-      /* Now search the granule allocation table for that number
-       * of contiguous
-       */
-
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      else if ((notfull & 1) == 0)
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
+          run     = 0;
+          gatidx += gran_ctz(notfull);
+        }
 
-          /* Handle the case where there are no free granules in the entry */
+      gat = priv->gat[gatidx];
+      if (gat == 0)
+        {
+          /* All free: the run goes on */
 
-          if (curr == 0xffffffff)
+          run += 32;
+          if (run >= ngranules)
             {
-              continue;
+              return (gatidx << 5) + 32 - run;
             }
+        }
+      else
+        {
+          /* The run that ends in the low granules of the entry */
 
-          /* Get the next entry from the GAT to support a 64 bit shift */
-
-          if (granidx + 32 < priv->ngranules)
+          if (run + gran_ctz(gat) >= ngranules)
             {
-              next = priv->gat[gatidx + 1];
+              return (gatidx << 5) - run;
             }
 
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
-
-          else
-            {
-              next = 0xffffffff;
-            }
+          /* A run within the entry */
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          alloc = priv->heapstart + (granidx << priv->log2gran);
-
-          for (bitidx = 0;
-               bitidx < 32 &&
-               (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
+          if (ngranules < 32)
             {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
+              fit = gran_fit(gat, ngranules);
+              if (fit != 0)
                 {
-                  break;
+                  return (gatidx << 5) + gran_ctz(fit);
                 }
+            }
 
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
+          /* The run that starts in the high granules of the entry */
 
-                  shift = 16;
-                }
+          run = gran_clz(gat);
+        }
 
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
+      gatidx++;
+    }
 
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
+  return -ENOMEM;
+}
 
-                  shift = 8;
-                }
+/****************************************************************************
+ * Name: gran_alloc
+ *
+ * Description:
+ *   Allocate memory from the granule heap.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by gran_initialize
+ *   size   - The size of the memory region to allocate.
+ *
+ * Returned Value:
+ *   On success, a non-NULL pointer to the allocated memory is returned;
+ *   NULL is returned on failure.
+ *
+ ****************************************************************************/
 
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
+FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
+{
+  FAR struct gran_s *priv = (FAR struct gran_s *)handle;
+  FAR void    *alloc = NULL;
+  unsigned int ngranules;
+  size_t       tmpmask;
+  int          granno;
+  int          ret;
 
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
+  DEBUGASSERT(priv != NULL);
 
-                  shift = 4;
-                }
+  if (priv == NULL || size == 0)
+    {
+      return NULL;
+    }
 
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower pair?
-               */
+  if (size > ((size_t)priv->ngranules << priv->log2gran))
+    {
+      return NULL;
+    }
 
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
+  /* How many contiguous granules we we need to find? */
 
-                  shift = 2;
-                }
+  tmpmask   = (1 << priv->log2gran) - 1;
+  ngranules = (size + tmpmask) >> priv->log2gran;
 
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Check if we have the allocation at this
-               * bit position.
-               */
+#ifdef GRAN_HAVE_CPUCACHE
+  /* Single granules come from the cache of this CPU if it has any */
 
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
+  if (ngranules == 1)
+    {
+      alloc = gran_cpucache_alloc(priv);
+      if (alloc != NULL)
+        {
+          return alloc;
+        }
+    }
+#endif
 
-                  gran_mark_allocated(priv, alloc, ngranules);
+  /* Get exclusive access to the GAT */
 
-                  /* And return the allocation address */
+  ret = gran_enter_critical(priv);
+  if (ret < 0)
+    {
+      return NULL;
+    }
 
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
+  granno = gran_search(priv, ngranules);
 
-              /* The free allocation does not start at this position */
+#ifdef GRAN_HAVE_CPUCACHE
+  /* The cached granules may be in the way */
 
-              else
-                {
-                  shift = 1;
-                }
+  if (granno < 0 && gran_cpucache_drain(priv))
+    {
+      granno = gran_search(priv, ngranules);
+    }
+#endif
 
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position and increment
-               * to the next candidate allocation address.
-               */
+  if (granno >= 0)
+    {
+      alloc = gran_mark_allocated(priv, priv->heapstart +
+                                  ((uintptr_t)granno << priv->log2gran),
+                                  ngranules);
+      DEBUGASSERT(alloc != NULL);
 
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
+#ifdef GRAN_HAVE_CPUCACHE
+      if (ngranules == 1)
+        {
+          gran_cpucache_refill(priv);
         }
-
-      gran_leave_critical(priv);
+#endif
     }
 
-  return NULL;
+  gran_leave_critical(priv);
+  return alloc;
 }
 
 #endif /* CONFIG_GRAN */
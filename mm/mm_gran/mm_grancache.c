@@ -0,0 +1,226 @@
+/****************************************************************************
+ * mm/mm_gran/mm_grancache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/gran.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_gran/mm_gran.h"
+
+#ifdef GRAN_HAVE_CPUCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A refill reserves half of the cache, leaving room for the frees */
+
+#define GRAN_CPUCACHE_REFILL  (CONFIG_GRAN_CPUCACHE_DEPTH / 2)
+
+/* In the SMP case, the spinlock only serializes against a drain running on
+ * another CPU.  Otherwise disabling interrupts is sufficient.
+ */
+
+#ifdef CONFIG_SMP
+#  define gran_cpucache_lock(c)   spin_lock(&(c)->lock)
+#  define gran_cpucache_unlock(c) spin_unlock(&(c)->lock)
+#else
+#  define gran_cpucache_lock(c)
+#  define gran_cpucache_unlock(c)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_cpucache_alloc
+ *
+ * Description:
+ *   Try to allocate a single granule from the cache of the current CPU.
+ *
+ * Input Parameters:
+ *   priv - The granule heap state structure.
+ *
+ * Returned Value:
+ *   The allocated granule or NULL if the cache is empty.
+ *
+ ****************************************************************************/
+
+FAR void *gran_cpucache_alloc(FAR struct gran_s *priv)
+{
+  FAR struct gran_cpucache_s *cache;
+  FAR void *ret = NULL;
+  irqstate_t flags;
+
+  /* With local interrupts disabled this thread cannot migrate to another
+   * CPU while it is using the cache.
+   */
+
+  flags = up_irq_save();
+  cache = &priv->cpucache[up_cpu_index()];
+
+  gran_cpucache_lock(cache);
+  if (cache->count > 0)
+    {
+      ret = (FAR void *)(priv->heapstart +
+                         ((uintptr_t)cache->granno[--cache->count] <<
+                          priv->log2gran));
+    }
+
+  gran_cpucache_unlock(cache);
+  up_irq_restore(flags);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: gran_cpucache_free
+ *
+ * Description:
+ *   Try to return a single granule to the cache of the current CPU instead
+ *   of to the GAT.  The granule stays allocated in the GAT.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   memory - The granule to free
+ *
+ * Returned Value:
+ *   true if the granule was cached; false if it must be freed to the GAT.
+ *
+ ****************************************************************************/
+
+bool gran_cpucache_free(FAR struct gran_s *priv, FAR void *memory)
+{
+  FAR struct gran_cpucache_s *cache;
+  irqstate_t flags;
+  bool cached = false;
+
+  flags = up_irq_save();
+  cache = &priv->cpucache[up_cpu_index()];
+
+  gran_cpucache_lock(cache);
+  if (cache->count < CONFIG_GRAN_CPUCACHE_DEPTH)
+    {
+      cache->granno[cache->count++] =
+        ((uintptr_t)memory - priv->heapstart) >> priv->log2gran;
+      cached = true;
+    }
+
+  gran_cpucache_unlock(cache);
+  up_irq_restore(flags);
+
+  return cached;
+}
+
+/****************************************************************************
+ * Name: gran_cpucache_refill
+ *
+ * Description:
+ *   Reserve single granules for the cache of the current CPU after it ran
+ *   empty, so that the next allocations do not enter the critical section.
+ *
+ * Input Parameters:
+ *   priv - The granule heap state structure.
+ *
+ * Assumptions:
+ *   The caller is in the critical section of the allocator.
+ *
+ ****************************************************************************/
+
+void gran_cpucache_refill(FAR struct gran_s *priv)
+{
+  FAR struct gran_cpucache_s *cache;
+  irqstate_t flags;
+  int granno;
+
+  flags = up_irq_save();
+  cache = &priv->cpucache[up_cpu_index()];
+
+  gran_cpucache_lock(cache);
+  while (cache->count < GRAN_CPUCACHE_REFILL)
+    {
+      granno = gran_search(priv, 1);
+      if (granno < 0)
+        {
+          break;
+        }
+
+      gran_mark_allocated(priv, priv->heapstart +
+                          ((uintptr_t)granno << priv->log2gran), 1);
+      cache->granno[cache->count++] = granno;
+    }
+
+  gran_cpucache_unlock(cache);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: gran_cpucache_drain
+ *
+ * Description:
+ *   Return the granules held in the caches of all CPUs to the GAT so that
+ *   they can be part of larger allocations.  This is called when a search
+ *   of the GAT fails.
+ *
+ * Input Parameters:
+ *   priv - The granule heap state structure.
+ *
+ * Returned Value:
+ *   true if any granule was released to the GAT.
+ *
+ * Assumptions:
+ *   The caller is in the critical section of the allocator.
+ *
+ ****************************************************************************/
+
+bool gran_cpucache_drain(FAR struct gran_s *priv)
+{
+  FAR struct gran_cpucache_s *cache;
+  irqstate_t flags;
+  bool drained = false;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &priv->cpucache[cpu];
+
+      flags = spin_lock_irqsave(&cache->lock);
+      while (cache->count > 0)
+        {
+          gran_mark_free(priv, cache->granno[--cache->count], 1);
+          drained = true;
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+    }
+
+  return drained;
+}
+
+#endif /* GRAN_HAVE_CPUCACHE */
@@ -69,10 +69,6 @@
  *   The actual memory allocates will be 64 byte (wasting 17 bytes) and
  *   will be aligned at least to (1 << log2align).
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   heapstart - Start of the granule allocation heap
  *   heapsize  - Size of heap in bytes
@@ -97,9 +93,10 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
   FAR struct gran_s *priv;
   uintptr_t          heapend;
   uintptr_t          alignedstart;
-  unsigned int       mask;
+  uintptr_t          mask;
   unsigned int       alignedsize;
   unsigned int       ngranules;
+  unsigned int       ngat;
 
   /* Check parameters if debug is on.  Note the size of a granule is
    * limited to 2**31 bytes and that the size of the granule must be greater
@@ -122,6 +119,13 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
   alignedsize  = (heapend - alignedstart) & ~mask;
   ngranules    = alignedsize >> log2gran;
 
+  /* The granules are numbered in 16 bits */
+
+  if (ngranules > UINT16_MAX)
+    {
+      ngranules = UINT16_MAX;
+    }
+
   /* Allocate the information structure with a granule table of the
    * correct size.
    */
@@ -135,6 +139,24 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
       priv->ngranules = ngranules;
       priv->heapstart = alignedstart;
 
+      /* The granules past the end of the heap, in the last GAT entry, and
+       * the GAT entries past the end of the GAT, in the last summary
+       * entry, are never free.
+       */
+
+      ngat          = SIZEOF_GAT(ngranules);
+      priv->summary = &priv->gat[ngat];
+
+      if ((ngranules & 31) != 0)
+        {
+          priv->gat[ngat - 1] = 0xffffffff << (ngranules & 31);
+        }
+
+      if ((ngat & 31) != 0)
+        {
+          priv->summary[SIZEOF_GAT(ngat) - 1] = 0xffffffff << (ngat & 31);
+        }
+
       /* Initialize mutual exclusion support */
 
 #ifndef CONFIG_GRAN_INTR
@@ -32,6 +32,35 @@
 
 #ifdef CONFIG_GRAN
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_range_mask
+ *
+ * Description:
+ *   Return the mask of the granules of a range that are in the GAT entry
+ *   of its first granule, and advance the range past them.
+ *
+ ****************************************************************************/
+
+static uint32_t gran_range_mask(FAR unsigned int *granno,
+                                FAR unsigned int *ngranules)
+{
+  unsigned int gatbit = *granno & 31;
+  unsigned int nbits  = 32 - gatbit;
+
+  if (nbits > *ngranules)
+    {
+      nbits = *ngranules;
+    }
+
+  *granno    += nbits;
+  *ngranules -= nbits;
+  return (0xffffffff >> (32 - nbits)) << gatbit;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -58,64 +87,82 @@ FAR void *gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
 {
   unsigned int granno;
   unsigned int gatidx;
-  unsigned int gatbit;
-  unsigned int avail;
+  unsigned int next;
+  unsigned int count;
   uint32_t     gatmask;
 
   /* Determine the granule number of the allocation */
 
   granno = (alloc - priv->heapstart) >> priv->log2gran;
-
-  /* Determine the GAT table index associated with the allocation */
-
-  gatidx = granno >> 5;
-  gatbit = granno & 31;
-
-  /* Mark bits in the GAT entry or entries */
-
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  if (alloc < priv->heapstart || granno >= priv->ngranules ||
+      ngranules > priv->ngranules - granno)
     {
-      uint32_t gatmask2;
-
-      gatmask    = 0xffffffff << gatbit;
-      ngranules -= avail;
-      gatmask2   = 0xffffffff >> (32 - ngranules);
+      return NULL;
+    }
 
-      /* Check that the area is free, from both mask words */
+  /* Check that the area is free, from all of the GAT entries */
 
-      if (((priv->gat[gatidx] & gatmask) != 0) ||
-          ((priv->gat[gatidx + 1] & gatmask2) != 0))
+  for (next = granno, count = ngranules; count > 0; )
+    {
+      gatidx  = next >> 5;
+      gatmask = gran_range_mask(&next, &count);
+      if ((priv->gat[gatidx] & gatmask) != 0)
         {
           return NULL;
         }
+    }
+
+  /* Mark bits in the GAT entries, and the full entries in the summary */
 
-      /* Mark bits in the first and second GAT entry */
+  for (next = granno, count = ngranules; count > 0; )
+    {
+      gatidx  = next >> 5;
+      gatmask = gran_range_mask(&next, &count);
 
       priv->gat[gatidx] |= gatmask;
-      priv->gat[gatidx + 1] |= gatmask2;
+      if (priv->gat[gatidx] == 0xffffffff)
+        {
+          priv->summary[gatidx >> 5] |= 1u << (gatidx & 31);
+        }
     }
 
-  /* Handle the case where where all of the granules come from one entry */
+  return (FAR void *)alloc;
+}
 
-  else
-    {
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of allocated granules as free.
+ *
+ * Input Parameters:
+ *   priv      - The granule heap state structure.
+ *   granno    - The number of the first granule
+ *   ngranules - The number of granules to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-      /* Check that the area is free */
+void gran_mark_free(FAR struct gran_s *priv, unsigned int granno,
+                    unsigned int ngranules)
+{
+  unsigned int gatidx;
+  uint32_t     gatmask;
 
-      if ((priv->gat[gatidx] & gatmask) != 0)
-        {
-          return NULL;
-        }
+  DEBUGASSERT(granno < priv->ngranules &&
+              ngranules <= priv->ngranules - granno);
 
-      /* Mark bits in a single GAT entry */
+  while (ngranules > 0)
+    {
+      gatidx  = granno >> 5;
+      gatmask = gran_range_mask(&granno, &ngranules);
+      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
 
-      priv->gat[gatidx] |= gatmask;
+      priv->gat[gatidx] &= ~gatmask;
+      priv->summary[gatidx >> 5] &= ~(1u << (gatidx & 31));
     }
-
-  return (FAR void *)alloc;
 }
 
 #endif /* CONFIG_GRAN */
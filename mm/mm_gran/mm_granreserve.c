@@ -69,7 +69,7 @@ FAR void *gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size)
   if (size > 0)
     {
       uintptr_t mask = (1 << priv->log2gran) - 1;
-      uintptr_t end  = start + size - 1;
+      uintptr_t end  = start + size;
       unsigned int ngranules;
 
       /* Get the aligned (down) start address and the aligned (up) end
@@ -81,7 +81,7 @@ FAR void *gran_reserve(GRAN_HANDLE handle, uintptr_t start, size_t size)
 
       /* Calculate the new size in granules */
 
-      ngranules = ((end - start) >> priv->log2gran) + 1;
+      ngranules = (end - start) >> priv->log2gran;
 
       /* Must lock the granule allocator */
 
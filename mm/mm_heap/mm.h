@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 
@@ -121,6 +122,23 @@
 # define MMSIZE_MAX      UINT32_MAX
 #endif
 
+/* The per-CPU cache is only usable where interrupts may be disabled */
+
+#if defined(CONFIG_MM_HEAP_CPUCACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HAVE_CPUCACHE 1
+#endif
+
+/* Each memory tier has its own free lists */
+
+#ifdef CONFIG_MM_HEAP_TIERS
+#  define MM_NFREELISTS       MM_NTIERS
+#  define MM_FREELIST(h, n)   mm_tierof(h, n)
+#else
+#  define MM_NFREELISTS       1
+#  define MM_FREELIST(h, n)   0
+#endif
+
 /* What is the size of the allocnode? */
 
 #define SIZEOF_MM_ALLOCNODE sizeof(struct mm_allocnode_s)
@@ -185,6 +203,21 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+/* This describes the per-CPU cache of small chunks.  Class 'n' holds
+ * chunks of exactly (n + 1) * MM_MIN_CHUNK bytes.  The chunks remain marked
+ * as allocated in the heap while they are in the cache.
+ */
+
+#ifdef CONFIG_MM_HEAP_CPUCACHE
+struct mm_cpucache_s
+{
+  spinlock_t lock;    /* Only contended by mm_cpucache_drain() */
+  uint8_t    count[CONFIG_MM_HEAP_CPUCACHE_NCLASSES];
+  FAR void  *blocks[CONFIG_MM_HEAP_CPUCACHE_NCLASSES]
+                   [CONFIG_MM_HEAP_CPUCACHE_DEPTH];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -208,12 +241,18 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
-  /* All free nodes are maintained in a doubly linked list.  This
-   * array provides some hooks into the list at various points to
+#ifdef CONFIG_MM_HEAP_TIERS
+  /* The memory tier of each region */
+
+  uint8_t mm_regiontier[CONFIG_MM_REGIONS];
+#endif
+
+  /* All free nodes are maintained in a doubly linked list per tier.  This
+   * array provides some hooks into the lists at various points to
    * speed searches for free nodes.
    */
 
-  struct mm_freenode_s mm_nodelist[MM_NNODES];
+  struct mm_freenode_s mm_nodelist[MM_NFREELISTS][MM_NNODES];
 
   /* Free delay list, for some situations where we can't do free
    * immdiately.
@@ -221,6 +260,18 @@ struct mm_heap_s
 
   FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_MM_KASAN
+  /* Whether the regions of the heap are checked by KASan */
+
+  bool mm_kasan;
+#endif
+
+#ifdef CONFIG_MM_HEAP_CPUCACHE
+  /* Per-CPU caches of recently freed small chunks */
+
+  struct mm_cpucache_s mm_cpucache[CONFIG_SMP_NCPUS];
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
@@ -250,10 +301,31 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_tier.c *****************************************/
+
+#ifdef CONFIG_MM_HEAP_TIERS
+int mm_tierof(FAR struct mm_heap_s *heap, FAR const void *mem);
+int mm_tiernext(int tier, int i);
+#endif
+
 /* Functions contained in mm_size2ndx.c *************************************/
 
 int mm_size2ndx(size_t size);
 
+/* Functions contained in mm_free.c *****************************************/
+
+#ifdef MM_HAVE_CPUCACHE
+void mm_free_nocache(FAR struct mm_heap_s *heap, FAR void *mem);
+#endif
+
+/* Functions contained in mm_cpucache.c *************************************/
+
+#ifdef MM_HAVE_CPUCACHE
+FAR void *mm_cpucache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+bool mm_cpucache_drain(FAR struct mm_heap_s *heap);
+#endif
+
 /* Functions contained in mm_foreach.c **************************************/
 
 void mm_foreach(FAR struct mm_heap_s *heap, mmchunk_handler_t handler,
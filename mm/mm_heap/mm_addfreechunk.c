@@ -59,8 +59,8 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
   /* Now put the new node into the next */
 
-  for (prev = &heap->mm_nodelist[ndx],
-       next = heap->mm_nodelist[ndx].flink;
+  for (prev = &heap->mm_nodelist[MM_FREELIST(heap, node)][ndx],
+       next = prev->flink;
        next && next->size && next->size < node->size;
        prev = next, next = next->flink);
 
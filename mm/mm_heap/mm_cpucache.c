@@ -0,0 +1,247 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cpucache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_heap/mm.h"
+#include "kasan/kasan.h"
+
+#ifdef MM_HAVE_CPUCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Map a chunk size (including the allocation node) to a cache class */
+
+#define MM_CPUCACHE_CLASS(s)  ((int)((s) >> MM_MIN_SHIFT) - 1)
+
+/* In the SMP case, the spinlock only serializes against a drain running on
+ * another CPU.  Otherwise disabling interrupts is sufficient.
+ */
+
+#ifdef CONFIG_SMP
+#  define mm_cpucache_lock(c)   spin_lock(&(c)->lock)
+#  define mm_cpucache_unlock(c) spin_unlock(&(c)->lock)
+#else
+#  define mm_cpucache_lock(c)
+#  define mm_cpucache_unlock(c)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_alloc
+ *
+ * Description:
+ *   Try to satisfy an allocation from the cache of the current CPU.  This
+ *   never takes the heap mutex; the cache is protected by disabling local
+ *   interrupts and by a per-CPU spinlock that is only contended while the
+ *   cache is being drained.
+ *
+ * Input Parameters:
+ *   heap      - The heap to allocate from
+ *   alignsize - The aligned chunk size, including the allocation node
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if the cache has no chunk of that size.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cpucache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_allocnode_s *node;
+  FAR void *ret = NULL;
+  irqstate_t flags;
+  int ndx = MM_CPUCACHE_CLASS(alignsize);
+
+  if (ndx < 0 || ndx >= CONFIG_MM_HEAP_CPUCACHE_NCLASSES)
+    {
+      return NULL;
+    }
+
+  /* With local interrupts disabled this thread cannot migrate to another
+   * CPU while it is using the cache.
+   */
+
+  flags = up_irq_save();
+  cache = &heap->mm_cpucache[up_cpu_index()];
+
+  mm_cpucache_lock(cache);
+  if (cache->count[ndx] > 0)
+    {
+      ret = cache->blocks[ndx][--cache->count[ndx]];
+    }
+
+  mm_cpucache_unlock(cache);
+  up_irq_restore(flags);
+
+  if (ret != NULL)
+    {
+      node = (FAR struct mm_allocnode_s *)
+             ((FAR char *)ret - SIZEOF_MM_ALLOCNODE);
+      DEBUGASSERT(node->size == alignsize &&
+                  (node->preceding & MM_ALLOC_BIT) != 0);
+
+      MM_ADD_BACKTRACE(heap, node);
+      kasan_unpoison(ret, mm_malloc_size(ret));
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, alignsize - SIZEOF_MM_ALLOCNODE);
+#endif
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_free
+ *
+ * Description:
+ *   Try to return a small chunk to the cache of the current CPU instead of
+ *   to the heap.  The chunk stays allocated from the heap's point of view.
+ *
+ * Input Parameters:
+ *   heap - The heap that the memory belongs to
+ *   mem  - The memory to free
+ *
+ * Returned Value:
+ *   true if the memory was cached; false if it must be freed to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_allocnode_s *node;
+  irqstate_t flags;
+  bool cached = false;
+  int ndx;
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
+
+  ndx = MM_CPUCACHE_CLASS(node->size);
+  if (ndx < 0 || ndx >= CONFIG_MM_HEAP_CPUCACHE_NCLASSES)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_MM_HEAP_TIERS
+  /* Only the chunks of the normal tier are cached for malloc() */
+
+  if (mm_tierof(heap, node) != MM_TIER_NORMAL)
+    {
+      return false;
+    }
+#endif
+
+  DEBUGASSERT(mm_heapmember(heap, mem));
+  kasan_poison(mem, mm_malloc_size(mem));
+
+  flags = up_irq_save();
+  cache = &heap->mm_cpucache[up_cpu_index()];
+
+  mm_cpucache_lock(cache);
+  if (cache->count[ndx] < CONFIG_MM_HEAP_CPUCACHE_DEPTH)
+    {
+      cache->blocks[ndx][cache->count[ndx]++] = mem;
+      cached = true;
+    }
+
+  mm_cpucache_unlock(cache);
+  up_irq_restore(flags);
+
+  if (!cached)
+    {
+      kasan_unpoison(mem, mm_malloc_size(mem));
+    }
+
+  return cached;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_drain
+ *
+ * Description:
+ *   Return every chunk held in the caches of all CPUs to the heap so that
+ *   it can be coalesced with its neighbours.  This is called when an
+ *   allocation from the heap fails.
+ *
+ * Input Parameters:
+ *   heap - The heap to drain
+ *
+ * Returned Value:
+ *   true if any chunk was released to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cpucache_drain(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR void *mem;
+  irqstate_t flags;
+  bool drained = false;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &heap->mm_cpucache[cpu];
+      for (ndx = 0; ndx < CONFIG_MM_HEAP_CPUCACHE_NCLASSES; ndx++)
+        {
+          for (; ; )
+            {
+              flags = spin_lock_irqsave(&cache->lock);
+              mem = cache->count[ndx] > 0 ?
+                    cache->blocks[ndx][--cache->count[ndx]] : NULL;
+              spin_unlock_irqrestore(&cache->lock, flags);
+
+              if (mem == NULL)
+                {
+                  break;
+                }
+
+              kasan_unpoison(mem, mm_malloc_size(mem));
+              mm_free_nocache(heap, mem);
+              drained = true;
+            }
+        }
+    }
+
+  return drained;
+}
+
+#endif /* MM_HAVE_CPUCACHE */
@@ -31,6 +31,7 @@
 #include <nuttx/mm/mm.h>
 
 #include "mm_heap/mm.h"
+#include "heapprof/heapprof.h"
 #include "kasan/kasan.h"
 
 /****************************************************************************
@@ -69,12 +70,46 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 {
+#ifdef MM_HAVE_CPUCACHE
+  minfo("Freeing %p\n", mem);
+
+  /* Protect against attempts to free a NULL reference */
+
+  if (!mem)
+    {
+      return;
+    }
+
+  heapprof_free(mem);
+
+  /* Small chunks go to the cache of this CPU if there is room */
+
+  if (mm_cpucache_free(heap, mem))
+    {
+      return;
+    }
+
+  mm_free_nocache(heap, mem);
+}
+
+/****************************************************************************
+ * Name: mm_free_nocache
+ *
+ * Description:
+ *   Return memory to the heap free lists, bypassing the per-CPU cache.
+ *
+ ****************************************************************************/
+
+void mm_free_nocache(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#endif
   FAR struct mm_freenode_s *node;
   FAR struct mm_freenode_s *prev;
   FAR struct mm_freenode_s *next;
   int ret;
 
   UNUSED(ret);
+#ifndef MM_HAVE_CPUCACHE
   minfo("Freeing %p\n", mem);
 
   /* Protect against attempts to free a NULL reference */
@@ -84,6 +119,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       return;
     }
 
+  heapprof_free(mem);
+#endif
+
   if (mm_lock(heap) < 0)
     {
       /* Meet -ESRCH return, which means we are in situations
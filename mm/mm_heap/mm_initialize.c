@@ -38,7 +38,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_addregion
+ * Name: mm_addregion and mm_addregion_tier
  *
  * Description:
  *   This function adds a region of contiguous memory to the selected heap.
@@ -47,6 +47,8 @@
  *   heap      - The selected heap
  *   heapstart - Start of the heap region
  *   heapsize  - Size of the heap region
+ *   tier      - The memory tier of the region, MM_TIER_NORMAL for
+ *               mm_addregion()
  *
  * Returned Value:
  *   None
@@ -55,8 +57,13 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_HEAP_TIERS
+void mm_addregion_tier(FAR struct mm_heap_s *heap, FAR void *heapstart,
+                       size_t heapsize, int tier)
+#else
 void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize)
+#endif
 {
   FAR struct mm_freenode_s *node;
   uintptr_t heapbase;
@@ -89,7 +96,12 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   /* Register to KASan for access check */
 
-  kasan_register(heapstart, &heapsize);
+#ifdef CONFIG_MM_KASAN
+  if (heap->mm_kasan)
+    {
+      kasan_register(heapstart, &heapsize);
+    }
+#endif
 
   DEBUGVERIFY(mm_lock(heap));
 
@@ -142,6 +154,11 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapend[IDX]->preceding   = node->size | MM_ALLOC_BIT;
   MM_ADD_BACKTRACE(heap, heap->mm_heapend[IDX]);
 
+#ifdef CONFIG_MM_HEAP_TIERS
+  DEBUGASSERT(tier >= 0 && tier < MM_NTIERS);
+  heap->mm_regiontier[IDX] = tier;
+#endif
+
 #undef IDX
 
 #if CONFIG_MM_REGIONS > 1
@@ -154,6 +171,14 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   mm_unlock(heap);
 }
 
+#ifdef CONFIG_MM_HEAP_TIERS
+void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
+                  size_t heapsize)
+{
+  mm_addregion_tier(heap, heapstart, heapsize, MM_TIER_NORMAL);
+}
+#endif
+
 /****************************************************************************
  * Name: mm_initialize
  *
@@ -179,6 +204,7 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 {
   FAR struct mm_heap_s *heap;
   uintptr_t             heap_adj;
+  int                   list;
   int                   i;
 
   minfo("Heap: name=%s, start=%p size=%zu\n", name, heapstart, heapsize);
@@ -202,12 +228,21 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   memset(heap, 0, sizeof(struct mm_heap_s));
 
-  /* Initialize the node array */
+#ifdef CONFIG_MM_KASAN
+  heap->mm_kasan = kasan_heap_enabled(name);
+#endif
+
+  /* Initialize the node arrays */
 
-  for (i = 1; i < MM_NNODES; i++)
+  for (list = 0; list < MM_NFREELISTS; list++)
     {
-      heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
-      heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
+      for (i = 1; i < MM_NNODES; i++)
+        {
+          heap->mm_nodelist[list][i - 1].flink =
+            &heap->mm_nodelist[list][i];
+          heap->mm_nodelist[list][i].blink     =
+            &heap->mm_nodelist[list][i - 1];
+        }
     }
 
   /* Initialize the malloc mutex to one (to support one-at-
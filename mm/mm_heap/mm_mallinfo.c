@@ -125,9 +125,68 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 
   DEBUGASSERT(info->uordblks + info->fordblks == heap->mm_heapsize);
 
+#undef region
   return OK;
 }
 
+/****************************************************************************
+ * Name: mm_mallinfo_tier
+ *
+ * Description:
+ *   mallinfo_tier returns a copy of updated current heap information for
+ *   the regions of one memory tier.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_TIERS
+int mm_mallinfo_tier(FAR struct mm_heap_s *heap, int tier,
+                     FAR struct mallinfo *info)
+{
+  FAR struct mm_allocnode_s *node;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(info && tier >= 0 && tier < MM_NTIERS);
+
+  memset(info, 0, sizeof(*info));
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Visit each node of the regions of the tier, like mm_foreach() */
+
+      if (heap->mm_regiontier[region] == tier)
+        {
+          DEBUGVERIFY(mm_lock(heap));
+
+          for (node = heap->mm_heapstart[region];
+               node < heap->mm_heapend[region];
+               node = (FAR struct mm_allocnode_s *)
+                      ((FAR char *)node + node->size))
+            {
+              mallinfo_handler(node, info);
+            }
+
+          mm_unlock(heap);
+
+          /* Account for the tail node */
+
+          info->uordblks += SIZEOF_MM_ALLOCNODE;
+          info->arena    += (uintptr_t)heap->mm_heapend[region] +
+                            SIZEOF_MM_ALLOCNODE -
+                            (uintptr_t)heap->mm_heapstart[region];
+        }
+    }
+
+#undef region
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: mm_mallinfo_task
  *
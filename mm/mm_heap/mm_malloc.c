@@ -34,6 +34,7 @@
 #include <nuttx/sched.h>
 
 #include "mm_heap/mm.h"
+#include "heapprof/heapprof.h"
 #include "kasan/kasan.h"
 
 /****************************************************************************
@@ -92,21 +93,30 @@ void mm_dump_handler(FAR struct tcb_s *tcb, FAR void *arg)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_malloc and mm_malloc_tier
  *
  * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
  *  that chunk, save the remaining, smaller chunk (if any).
  *
+ *  With memory tiers, the chunk is taken from the preferred tier if it has
+ *  one, else from the slower and lastly from the faster tiers.  mm_malloc()
+ *  prefers MM_TIER_NORMAL.
+ *
  *  8-byte alignment of the allocated data is assured.
  *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_malloc_tier(FAR struct mm_heap_s *heap, size_t size, int tier)
+#else
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
 {
-  FAR struct mm_freenode_s *node;
+  FAR struct mm_freenode_s *node = NULL;
   size_t alignsize;
   FAR void *ret = NULL;
+  int list;
   int ndx;
 
   /* Free the delay list first */
@@ -135,6 +145,24 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(alignsize >= MM_MIN_CHUNK);
   DEBUGASSERT(alignsize >= SIZEOF_MM_FREENODE);
 
+#ifdef MM_HAVE_CPUCACHE
+  /* Try the cache of this CPU first.  This does not take the mutex.  It
+   * only holds chunks of the normal tier.
+   */
+
+#  ifdef CONFIG_MM_HEAP_TIERS
+  if (tier == MM_TIER_NORMAL)
+#  endif
+    {
+      ret = mm_cpucache_alloc(heap, alignsize);
+      if (ret != NULL)
+        {
+          heapprof_alloc(ret, size);
+          return ret;
+        }
+    }
+#endif
+
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
@@ -154,16 +182,24 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       ndx = mm_size2ndx(alignsize);
     }
 
-  /* Search for a large enough chunk in the list of nodes. This list is
+  /* Search for a large enough chunk in the lists of nodes. Each list is
    * ordered by size, but will have occasional zero sized nodes as we visit
    * other mm_nodelist[] entries.
    */
 
-  for (node = heap->mm_nodelist[ndx].flink;
-       node && node->size < alignsize;
-       node = node->flink)
+  for (list = 0; list < MM_NFREELISTS && node == NULL; list++)
     {
-      DEBUGASSERT(node->blink->flink == node);
+#ifdef CONFIG_MM_HEAP_TIERS
+      node = heap->mm_nodelist[mm_tiernext(tier, list)][ndx].flink;
+#else
+      node = heap->mm_nodelist[list][ndx].flink;
+#endif
+
+      while (node && node->size < alignsize)
+        {
+          DEBUGASSERT(node->blink->flink == node);
+          node = node->flink;
+        }
     }
 
   /* If we found a node with non-zero size, then this is one to use. Since
@@ -235,10 +271,26 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || mm_heapmember(heap, ret));
   mm_unlock(heap);
 
+#ifdef MM_HAVE_CPUCACHE
+  /* Under memory pressure, release everything held in the per-CPU caches
+   * back to the heap and try again.
+   */
+
+  if (ret == NULL && mm_cpucache_drain(heap))
+    {
+#  ifdef CONFIG_MM_HEAP_TIERS
+      return mm_malloc_tier(heap, size, tier);
+#  else
+      return mm_malloc(heap, size);
+#  endif
+    }
+#endif
+
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
       kasan_unpoison(ret, mm_malloc_size(ret));
+      heapprof_alloc(ret, size);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, 0xaa, alignsize - SIZEOF_MM_ALLOCNODE);
 #endif
@@ -272,3 +324,10 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_MIN_CHUNK == 0);
   return ret;
 }
+
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  return mm_malloc_tier(heap, size, MM_TIER_NORMAL);
+}
+#endif
@@ -29,6 +29,7 @@
 #include <nuttx/mm/mm.h>
 
 #include "mm_heap/mm.h"
+#include "heapprof/heapprof.h"
 #include "kasan/kasan.h"
 
 /****************************************************************************
@@ -36,7 +37,7 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_memalign
+ * Name: mm_memalign and mm_memalign_tier
  *
  * Description:
  *   memalign requests more than enough space from malloc, finds a region
@@ -48,8 +49,13 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_memalign_tier(FAR struct mm_heap_s *heap, size_t alignment,
+                           size_t size, int tier)
+#else
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                       size_t size)
+#endif
 {
   FAR struct mm_allocnode_s *node;
   size_t rawchunk;
@@ -78,7 +84,11 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   if (alignment <= MM_MIN_CHUNK)
     {
+#ifdef CONFIG_MM_HEAP_TIERS
+      FAR void *ptr = mm_malloc_tier(heap, size, tier);
+#else
       FAR void *ptr = mm_malloc(heap, size);
+#endif
       DEBUGASSERT(ptr == NULL || ((uintptr_t)ptr) % alignment == 0);
       return ptr;
     }
@@ -108,13 +118,18 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Then malloc that size */
 
+#ifdef CONFIG_MM_HEAP_TIERS
+  rawchunk = (size_t)mm_malloc_tier(heap, allocsize, tier);
+#else
   rawchunk = (size_t)mm_malloc(heap, allocsize);
+#endif
   if (rawchunk == 0)
     {
       return NULL;
     }
 
   kasan_poison((FAR void *)rawchunk, mm_malloc_size((FAR void *)rawchunk));
+  heapprof_free((FAR void *)rawchunk);
 
   /* We need to hold the MM mutex while we muck with the chunks and
    * nodelist.
@@ -229,7 +244,17 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   kasan_unpoison((FAR void *)alignedchunk,
                  mm_malloc_size((FAR void *)alignedchunk));
+  heapprof_alloc((FAR void *)alignedchunk,
+                 mm_malloc_size((FAR void *)alignedchunk));
 
   DEBUGASSERT(alignedchunk % alignment == 0);
   return (FAR void *)alignedchunk;
 }
+
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                      size_t size)
+{
+  return mm_memalign_tier(heap, alignment, size, MM_TIER_NORMAL);
+}
+#endif
@@ -0,0 +1,122 @@
+/****************************************************************************
+ * mm/mm_heap/mm_nextfree.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_nextfree
+ *
+ * Description:
+ *   Find the free memory of the heap with the lowest address that ends
+ *   above an address.  The headers of the free chunks are not part of it,
+ *   so that the heap can still be walked in a dump that omits the free
+ *   memory.
+ *
+ * Parameters:
+ *   heap  - The heap to search
+ *   addr  - The address to search from
+ *   start - The start of the free memory found
+ *   end   - The end of the free memory found
+ *
+ * Return Value:
+ *   OK if free memory was found; -ENOENT if not, or the error of
+ *   mm_lock().
+ *
+ ****************************************************************************/
+
+int mm_nextfree(FAR struct mm_heap_s *heap, uintptr_t addr,
+                FAR uintptr_t *start, FAR uintptr_t *end)
+{
+  FAR struct mm_allocnode_s *node;
+  uintptr_t nodestart;
+  uintptr_t nodeend;
+  uintptr_t first = UINTPTR_MAX;
+  uintptr_t last = 0;
+  int ret;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(start != NULL && end != NULL);
+
+  ret = mm_lock(heap);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)
+                  ((FAR char *)node + node->size))
+        {
+          nodestart = (uintptr_t)node + SIZEOF_MM_FREENODE;
+          nodeend   = (uintptr_t)node + node->size;
+
+          /* The nodes of a region are sorted:  No later one comes first */
+
+          if (nodestart >= first)
+            {
+              break;
+            }
+
+          if ((node->preceding & MM_ALLOC_BIT) == 0 &&
+              nodeend > nodestart && nodeend > addr)
+            {
+              first = nodestart;
+              last  = nodeend;
+            }
+        }
+    }
+
+  mm_unlock(heap);
+
+  if (last == 0)
+    {
+      return -ENOENT;
+    }
+
+  *start = first;
+  *end   = last;
+  return OK;
+#undef region
+}
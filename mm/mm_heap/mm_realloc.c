@@ -32,6 +32,7 @@
 #include <nuttx/mm/mm.h>
 
 #include "mm_heap/mm.h"
+#include "heapprof/heapprof.h"
 #include "kasan/kasan.h"
 
 /****************************************************************************
@@ -132,6 +133,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, oldnode);
+      heapprof_free(oldmem);
+      heapprof_alloc(oldmem, size);
 
       return oldmem;
     }
@@ -338,6 +341,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - SIZEOF_MM_ALLOCNODE);
 
       kasan_unpoison(newmem, mm_malloc_size(newmem));
+      heapprof_free(oldmem);
+      heapprof_alloc(newmem, size);
       if (newmem != oldmem)
         {
           /* Now we have to move the user contents 'down' in memory.  memcpy
@@ -361,7 +366,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
        */
 
       mm_unlock(heap);
+#ifdef CONFIG_MM_HEAP_TIERS
+      /* Keep the memory in the tier of the old block */
+
+      newmem = mm_malloc_tier(heap, size, mm_tierof(heap, oldmem));
+#else
       newmem = mm_malloc(heap, size);
+#endif
       if (newmem)
         {
           memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
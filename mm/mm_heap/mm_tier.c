@@ -0,0 +1,99 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tier.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_TIERS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tierof
+ *
+ * Description:
+ *   Return the memory tier of the region that holds a chunk.
+ *
+ * Input Parameters:
+ *   heap - The heap of the chunk
+ *   mem  - Any address within the chunk
+ *
+ * Returned Value:
+ *   The tier of the region, or MM_TIER_NORMAL if the address is not in
+ *   the heap.
+ *
+ ****************************************************************************/
+
+int mm_tierof(FAR struct mm_heap_s *heap, FAR const void *mem)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region;
+
+  for (region = 0; region < heap->mm_nregions; region++)
+    {
+      if ((FAR const void *)heap->mm_heapstart[region] <= mem &&
+          (FAR const void *)heap->mm_heapend[region] >= mem)
+        {
+          return heap->mm_regiontier[region];
+        }
+    }
+
+  return MM_TIER_NORMAL;
+#else
+  return heap->mm_regiontier[0];
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_tiernext
+ *
+ * Description:
+ *   Return the i-th tier to search for an allocation that prefers a tier:
+ *   The preferred one first, then the slower ones and the faster ones
+ *   last, so that fast memory is left to the allocations that ask for it.
+ *
+ * Input Parameters:
+ *   tier - The preferred tier
+ *   i    - The index in the search order, from 0 to MM_NTIERS - 1
+ *
+ * Returned Value:
+ *   The tier to search.
+ *
+ ****************************************************************************/
+
+int mm_tiernext(int tier, int i)
+{
+  DEBUGASSERT(tier >= 0 && tier < MM_NTIERS && i >= 0 && i < MM_NTIERS);
+
+  return tier + i < MM_NTIERS ? tier + i : MM_NTIERS - 1 - i;
+}
+
+#endif /* CONFIG_MM_HEAP_TIERS */
@@ -32,6 +32,28 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_zalloc_tier
+ *
+ * Description:
+ *   mm_zalloc_tier calls mm_malloc_tier, then zeroes out the allocated
+ *   chunk.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_TIERS
+FAR void *mm_zalloc_tier(FAR struct mm_heap_s *heap, size_t size, int tier)
+{
+  FAR void *alloc = mm_malloc_tier(heap, size, tier);
+  if (alloc)
+    {
+       memset(alloc, 0, size);
+    }
+
+  return alloc;
+}
+#endif
+
 /****************************************************************************
  * Name: mm_zalloc
  *
@@ -0,0 +1,1661 @@
+/****************************************************************************
+ * mm/mm_tlsf/mm_tlsf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <errno.h>
+#include <malloc.h>
+#include <assert.h>
+#include <debug.h>
+#include <execinfo.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mm/mm.h>
+
+#include "heapprof/heapprof.h"
+#include "kasan/kasan.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* All blocks and all returned memory are aligned to TLSF_ALIGN.  The first
+ * level index is limited so that both bitmaps fit in 32 bits; this bounds
+ * the largest block to 2 GiB on 32-bit and to 128 GiB on 64-bit targets.
+ */
+
+#if UINTPTR_MAX <= UINT32_MAX
+#  define TLSF_ALIGN_LOG2   3
+#  define TLSF_FL_INDEX_MAX 30
+#else
+#  define TLSF_ALIGN_LOG2   4
+#  define TLSF_FL_INDEX_MAX 36
+#endif
+
+#define TLSF_ALIGN          (1 << TLSF_ALIGN_LOG2)
+#define TLSF_ALIGN_MASK     (TLSF_ALIGN - 1)
+#define TLSF_ALIGN_UP(a)    (((a) + TLSF_ALIGN_MASK) & ~TLSF_ALIGN_MASK)
+#define TLSF_ALIGN_DOWN(a)  ((a) & ~TLSF_ALIGN_MASK)
+
+/* Each power-of-two first level range is split into TLSF_SL_COUNT linear
+ * second level ranges.  Blocks smaller than TLSF_SMALL_BLOCK all live in
+ * first level zero, which is split into TLSF_ALIGN sized ranges.
+ */
+
+#define TLSF_SL_LOG2        CONFIG_MM_TLSF_SL_LOG2
+#define TLSF_SL_COUNT       (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT       (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT       (TLSF_FL_INDEX_MAX - TLSF_FL_SHIFT + 2)
+#define TLSF_SMALL_BLOCK    ((size_t)1 << TLSF_FL_SHIFT)
+#define TLSF_BLOCK_MAX      ((size_t)1 << (TLSF_FL_INDEX_MAX + 1))
+
+#if TLSF_FL_COUNT > 32 || TLSF_SL_COUNT > 32
+#  error "TLSF bitmaps do not fit in 32 bits"
+#endif
+
+/* The low bit of the size field marks a free block */
+
+#define TLSF_FREE_BIT       (1)
+#define TLSF_BLOCKSIZE(b)   ((b)->size & ~(size_t)TLSF_FREE_BIT)
+#define TLSF_ISFREE(b)      (((b)->size & TLSF_FREE_BIT) != 0)
+
+/* Size of the header that precedes each allocation and of the smallest
+ * block that can hold the free list links.
+ */
+
+#define TLSF_HDRSIZE        TLSF_ALIGN_UP(offsetof(struct tlsf_block_s, next))
+#define TLSF_MINBLOCK       TLSF_ALIGN_UP(sizeof(struct tlsf_block_s))
+
+#define TLSF_NEXT(b) \
+  ((FAR struct tlsf_block_s *)((FAR char *)(b) + TLSF_BLOCKSIZE(b)))
+#define TLSF_PREV(b) \
+  ((FAR struct tlsf_block_s *)((FAR char *)(b) - (b)->prevsize))
+#define TLSF_PAYLOAD(b)     ((FAR void *)((FAR char *)(b) + TLSF_HDRSIZE))
+#define TLSF_BLOCK(m) \
+  ((FAR struct tlsf_block_s *)((FAR char *)(m) - TLSF_HDRSIZE))
+
+#if CONFIG_MM_BACKTRACE == 0
+#  define TLSF_ADD_BACKTRACE(heap, b) \
+     do \
+       { \
+         (b)->pid = gettid(); \
+       } \
+     while (0)
+#elif CONFIG_MM_BACKTRACE > 0
+#  define TLSF_ADD_BACKTRACE(heap, b) \
+     do \
+       { \
+         (b)->pid = gettid(); \
+         if ((heap)->mm_procfs.backtrace) \
+           { \
+             memset((b)->backtrace, 0, sizeof((b)->backtrace)); \
+             backtrace((b)->backtrace, CONFIG_MM_BACKTRACE); \
+           } \
+         else \
+           { \
+             (b)->backtrace[0] = 0; \
+           } \
+       } \
+     while (0)
+#else
+#  define TLSF_ADD_BACKTRACE(heap, b)
+#endif
+
+#if UINTPTR_MAX <= UINT32_MAX
+#  define MM_PTR_FMT_WIDTH 11
+#elif UINTPTR_MAX <= UINT64_MAX
+#  define MM_PTR_FMT_WIDTH 19
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one block of a heap region.  Every block, free or
+ * allocated, starts with the sizes of itself and of the block that
+ * physically precedes it so that neighbours can be found in constant time.
+ * The free list links overlay the first bytes of the payload.
+ */
+
+struct tlsf_block_s
+{
+  size_t prevsize;                          /* Size of the preceding block */
+  size_t size;                              /* Block size | TLSF_FREE_BIT */
+#if CONFIG_MM_BACKTRACE >= 0
+  pid_t pid;                                /* The pid for caller */
+#  if CONFIG_MM_BACKTRACE > 0
+  FAR void *backtrace[CONFIG_MM_BACKTRACE]; /* The backtrace buffer */
+#  endif
+#endif
+  FAR struct tlsf_block_s *next;            /* Next free block of class */
+  FAR struct tlsf_block_s *prev;            /* Prev free block of class */
+};
+
+struct mm_delaynode_s
+{
+  FAR struct mm_delaynode_s *flink;
+};
+
+/* This describes one heap (possibly with multiple regions) */
+
+struct mm_heap_s
+{
+  /* Mutually exclusive access to this data set is enforced with
+   * the following un-named mutex.
+   */
+
+  mutex_t mm_lock;
+
+  /* This is the size of the heap provided to mm */
+
+  size_t mm_heapsize;
+
+  /* This is the first and last block of each region.  Both are
+   * permanently allocated guard blocks.
+   */
+
+  FAR struct tlsf_block_s *mm_heapstart[CONFIG_MM_REGIONS];
+  FAR struct tlsf_block_s *mm_heapend[CONFIG_MM_REGIONS];
+
+#if CONFIG_MM_REGIONS > 1
+  int mm_nregions;
+#endif
+
+  /* Bit 'fl' of mm_flbitmap is set if mm_slbitmap[fl] is non-zero and bit
+   * 'sl' of mm_slbitmap[fl] is set if mm_freelist[fl][sl] is non-empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[TLSF_FL_COUNT];
+  FAR struct tlsf_block_s *mm_freelist[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+  /* Free delay list, for some situations where we can't do free
+   * immdiately.
+   */
+
+  FAR struct mm_delaynode_s *mm_delaylist[CONFIG_SMP_NCPUS];
+
+#ifdef CONFIG_MM_KASAN
+  /* Whether the regions of the heap are checked by KASan */
+
+  bool mm_kasan;
+#endif
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  struct procfs_meminfo_entry_s mm_procfs;
+#endif
+};
+
+typedef CODE void (*tlsf_handler_t)(FAR struct tlsf_block_s *block,
+                                    FAR void *arg);
+
+struct memdump_info_s
+{
+  pid_t pid;
+  int   blks;
+  int   size;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_lock / mm_unlock
+ *
+ * Description:
+ *   Take and give the heap mutex, with the same semantics as the default
+ *   heap manager:  from interrupt context the heap is only touched if
+ *   nobody holds the mutex, and -ESRCH is returned while the OS is in the
+ *   middle of a context switch.
+ *
+ ****************************************************************************/
+
+static int mm_lock(FAR struct mm_heap_s *heap)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  if (up_interrupt_context())
+    {
+#if !defined(CONFIG_SMP)
+      return nxmutex_is_locked(&heap->mm_lock) ? -EAGAIN : 0;
+#else
+      return -EAGAIN;
+#endif
+    }
+  else
+#endif
+
+  if (gettid() < 0)
+    {
+      return -ESRCH;
+    }
+  else
+    {
+      return nxmutex_lock(&heap->mm_lock);
+    }
+}
+
+static void mm_unlock(FAR struct mm_heap_s *heap)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  if (up_interrupt_context())
+    {
+      return;
+    }
+#endif
+
+  DEBUGVERIFY(nxmutex_unlock(&heap->mm_lock));
+}
+
+static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *tmp = mem;
+  irqstate_t flags;
+
+  /* Delay the deallocation until a more appropriate time. */
+
+  flags = enter_critical_section();
+
+  tmp->flink = heap->mm_delaylist[up_cpu_index()];
+  heap->mm_delaylist[up_cpu_index()] = tmp;
+
+  leave_critical_section(flags);
+#endif
+}
+
+static void free_delaylist(FAR struct mm_heap_s *heap)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *tmp;
+  irqstate_t flags;
+
+  /* Move the delay list to local */
+
+  flags = enter_critical_section();
+
+  tmp = heap->mm_delaylist[up_cpu_index()];
+  heap->mm_delaylist[up_cpu_index()] = NULL;
+
+  leave_critical_section(flags);
+
+  while (tmp)
+    {
+      FAR void *address = tmp;
+
+      tmp = tmp->flink;
+      mm_free(heap, address);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tlsf_mapping
+ *
+ * Description:
+ *   Map a block size onto its first and second level indices.
+ *
+ ****************************************************************************/
+
+static void tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size < TLSF_SMALL_BLOCK)
+    {
+      *fl = 0;
+      *sl = (int)(size >> TLSF_ALIGN_LOG2);
+    }
+  else
+    {
+      msb = flsl((long)size) - 1;
+      *sl = (int)(size >> (msb - TLSF_SL_LOG2)) - TLSF_SL_COUNT;
+      *fl = msb - TLSF_FL_SHIFT + 1;
+    }
+
+  DEBUGASSERT(*fl < TLSF_FL_COUNT && *sl < TLSF_SL_COUNT);
+}
+
+/****************************************************************************
+ * Name: tlsf_insert
+ *
+ * Description:
+ *   Add a free block to the head of the list of its size class.
+ *
+ ****************************************************************************/
+
+static void tlsf_insert(FAR struct mm_heap_s *heap,
+                        FAR struct tlsf_block_s *block)
+{
+  FAR struct tlsf_block_s *head;
+  int fl;
+  int sl;
+
+  DEBUGASSERT(TLSF_BLOCKSIZE(block) < TLSF_BLOCK_MAX);
+
+  tlsf_mapping(TLSF_BLOCKSIZE(block), &fl, &sl);
+
+  head        = heap->mm_freelist[fl][sl];
+  block->next = head;
+  block->prev = NULL;
+  if (head != NULL)
+    {
+      head->prev = block;
+    }
+
+  heap->mm_freelist[fl][sl] = block;
+  heap->mm_slbitmap[fl]    |= UINT32_C(1) << sl;
+  heap->mm_flbitmap        |= UINT32_C(1) << fl;
+}
+
+/****************************************************************************
+ * Name: tlsf_remove
+ *
+ * Description:
+ *   Remove a free block from the list of its size class.
+ *
+ ****************************************************************************/
+
+static void tlsf_remove(FAR struct mm_heap_s *heap,
+                        FAR struct tlsf_block_s *block)
+{
+  int fl;
+  int sl;
+
+  tlsf_mapping(TLSF_BLOCKSIZE(block), &fl, &sl);
+
+  if (block->next != NULL)
+    {
+      block->next->prev = block->prev;
+    }
+
+  if (block->prev != NULL)
+    {
+      block->prev->next = block->next;
+    }
+  else
+    {
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == block);
+
+      heap->mm_freelist[fl][sl] = block->next;
+      if (block->next == NULL)
+        {
+          heap->mm_slbitmap[fl] &= ~(UINT32_C(1) << sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~(UINT32_C(1) << fl);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tlsf_search
+ *
+ * Description:
+ *   Find and remove a free block of at least 'size' bytes.  The request is
+ *   rounded up to the next second level boundary so that any block of the
+ *   selected class is large enough; the search then costs two ffs()
+ *   operations regardless of the state of the heap.
+ *
+ ****************************************************************************/
+
+static FAR struct tlsf_block_s *tlsf_search(FAR struct mm_heap_s *heap,
+                                            size_t size)
+{
+  FAR struct tlsf_block_s *block;
+  uint32_t map;
+  int fl;
+  int sl;
+
+  if (size >= TLSF_SMALL_BLOCK)
+    {
+      size += ((size_t)1 << (flsl((long)size) - 1 - TLSF_SL_LOG2)) - 1;
+    }
+
+  if (size >= TLSF_BLOCK_MAX)
+    {
+      return NULL;
+    }
+
+  tlsf_mapping(size, &fl, &sl);
+
+  map = heap->mm_slbitmap[fl] & (~UINT32_C(0) << sl);
+  if (map == 0)
+    {
+      /* Nothing in this first level range, try the next larger one */
+
+      map = fl + 1 < TLSF_FL_COUNT ?
+            heap->mm_flbitmap & (~UINT32_C(0) << (fl + 1)) : 0;
+      if (map == 0)
+        {
+          return NULL;
+        }
+
+      fl  = ffs((int)map) - 1;
+      map = heap->mm_slbitmap[fl];
+    }
+
+  sl    = ffs((int)map) - 1;
+  block = heap->mm_freelist[fl][sl];
+  DEBUGASSERT(block != NULL);
+
+  tlsf_remove(heap, block);
+  return block;
+}
+
+/****************************************************************************
+ * Name: tlsf_release
+ *
+ * Description:
+ *   Mark a block as free, merge it with its free neighbours and add the
+ *   result to the free lists.
+ *
+ ****************************************************************************/
+
+static void tlsf_release(FAR struct mm_heap_s *heap,
+                         FAR struct tlsf_block_s *block)
+{
+  FAR struct tlsf_block_s *prev;
+  FAR struct tlsf_block_s *next;
+  size_t size = TLSF_BLOCKSIZE(block);
+
+  /* The guard blocks are always allocated, so there is always a valid
+   * neighbour on both sides.
+   */
+
+  prev = TLSF_PREV(block);
+  if (TLSF_ISFREE(prev))
+    {
+      tlsf_remove(heap, prev);
+      size += TLSF_BLOCKSIZE(prev);
+      block = prev;
+    }
+
+  next = (FAR struct tlsf_block_s *)((FAR char *)block + size);
+  if (TLSF_ISFREE(next))
+    {
+      tlsf_remove(heap, next);
+      size += TLSF_BLOCKSIZE(next);
+    }
+
+  block->size = size | TLSF_FREE_BIT;
+  TLSF_NEXT(block)->prevsize = size;
+  tlsf_insert(heap, block);
+}
+
+/****************************************************************************
+ * Name: tlsf_trim
+ *
+ * Description:
+ *   Shrink an allocated block to 'size' bytes and release the remainder,
+ *   if it is large enough to form a block of its own.
+ *
+ ****************************************************************************/
+
+static void tlsf_trim(FAR struct mm_heap_s *heap,
+                      FAR struct tlsf_block_s *block, size_t size)
+{
+  FAR struct tlsf_block_s *remainder;
+  size_t remaining = TLSF_BLOCKSIZE(block) - size;
+
+  if (remaining >= TLSF_MINBLOCK)
+    {
+      remainder           = (FAR struct tlsf_block_s *)
+                            ((FAR char *)block + size);
+      remainder->size     = remaining;
+      remainder->prevsize = size;
+      block->size         = size;
+      TLSF_NEXT(remainder)->prevsize = remaining;
+
+      tlsf_release(heap, remainder);
+    }
+}
+
+/****************************************************************************
+ * Name: tlsf_alignsize
+ *
+ * Description:
+ *   Convert a user request into a block size.  Zero is returned on
+ *   overflow.
+ *
+ ****************************************************************************/
+
+static size_t tlsf_alignsize(size_t size)
+{
+  size_t alignsize = TLSF_ALIGN_UP(size + TLSF_HDRSIZE);
+
+  if (alignsize < size)
+    {
+      return 0;
+    }
+
+  return alignsize < TLSF_MINBLOCK ? TLSF_MINBLOCK : alignsize;
+}
+
+/****************************************************************************
+ * Name: tlsf_foreach
+ *
+ * Description:
+ *   Call 'handler' for every block of every region, including the leading
+ *   guard block but not the trailing one.
+ *
+ ****************************************************************************/
+
+static void tlsf_foreach(FAR struct mm_heap_s *heap, tlsf_handler_t handler,
+                         FAR void *arg)
+{
+  FAR struct tlsf_block_s *block;
+  FAR struct tlsf_block_s *next;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      if (mm_lock(heap) < 0)
+        {
+          return;
+        }
+
+      for (block = heap->mm_heapstart[region];
+           block < heap->mm_heapend[region];
+           block = next)
+        {
+          next = TLSF_NEXT(block);
+          DEBUGASSERT(next->prevsize == TLSF_BLOCKSIZE(block));
+          handler(block, arg);
+        }
+
+      mm_unlock(heap);
+    }
+
+#undef region
+}
+
+static void mallinfo_handler(FAR struct tlsf_block_s *block, FAR void *arg)
+{
+  FAR struct mallinfo *info = arg;
+  size_t size = TLSF_BLOCKSIZE(block);
+
+  if (!TLSF_ISFREE(block))
+    {
+      info->aordblks++;
+      info->uordblks += size;
+    }
+  else
+    {
+      info->ordblks++;
+      info->fordblks += size;
+      if (size > info->mxordblk)
+        {
+          info->mxordblk = size;
+        }
+    }
+}
+
+#if CONFIG_MM_BACKTRACE >= 0
+static void mallinfo_task_handler(FAR struct tlsf_block_s *block,
+                                  FAR void *arg)
+{
+  FAR struct mallinfo_task *info = arg;
+
+  if (!TLSF_ISFREE(block) && block->pid == info->pid)
+    {
+      info->aordblks++;
+      info->uordblks += TLSF_BLOCKSIZE(block);
+    }
+}
+#endif
+
+static void memdump_handler(FAR struct tlsf_block_s *block, FAR void *arg)
+{
+  FAR struct memdump_info_s *info = arg;
+  size_t size = TLSF_BLOCKSIZE(block);
+
+  if (!TLSF_ISFREE(block))
+    {
+#if CONFIG_MM_BACKTRACE < 0
+      if (info->pid == -1)
+#else
+      if (info->pid == -1 || block->pid == info->pid)
+#endif
+        {
+#if CONFIG_MM_BACKTRACE < 0
+          syslog(LOG_INFO, "%12zu%*p\n",
+                 size, MM_PTR_FMT_WIDTH, TLSF_PAYLOAD(block));
+#else
+#  if CONFIG_MM_BACKTRACE > 0
+          int i;
+          FAR const char *format = " %0*p";
+#  endif
+          char buf[CONFIG_MM_BACKTRACE * MM_PTR_FMT_WIDTH + 1];
+
+          buf[0] = '\0';
+#  if CONFIG_MM_BACKTRACE > 0
+          for (i = 0; i < CONFIG_MM_BACKTRACE && block->backtrace[i]; i++)
+            {
+              sprintf(buf + i * MM_PTR_FMT_WIDTH, format,
+                      MM_PTR_FMT_WIDTH - 1, block->backtrace[i]);
+            }
+#  endif
+
+          syslog(LOG_INFO, "%6d%12zu%*p%s\n",
+                 (int)block->pid, size, MM_PTR_FMT_WIDTH,
+                 TLSF_PAYLOAD(block), buf);
+#endif
+          info->blks++;
+          info->size += size;
+        }
+    }
+  else if (info->pid <= -2)
+    {
+      info->blks++;
+      info->size += size;
+      syslog(LOG_INFO, "%12zu%*p\n",
+             size, MM_PTR_FMT_WIDTH, TLSF_PAYLOAD(block));
+    }
+}
+
+#ifdef CONFIG_DEBUG_MM
+static void checkcorruption_handler(FAR struct tlsf_block_s *block,
+                                    FAR void *arg)
+{
+  size_t size = TLSF_BLOCKSIZE(block);
+
+  UNUSED(arg);
+
+  if (TLSF_ISFREE(block))
+    {
+      FAR struct tlsf_block_s *next = TLSF_NEXT(block);
+
+      /* Free blocks are always fully coalesced and properly linked */
+
+      assert(size >= TLSF_MINBLOCK);
+      assert(!TLSF_ISFREE(next));
+      assert(block->next == NULL || block->next->prev == block);
+      assert(block->prev == NULL || block->prev->next == block);
+    }
+  else
+    {
+      assert(size >= TLSF_HDRSIZE);
+    }
+
+  assert((size & TLSF_ALIGN_MASK) == 0);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addregion
+ *
+ * Description:
+ *   This function adds a region of contiguous memory to the selected heap.
+ *
+ * Input Parameters:
+ *   heap      - The selected heap
+ *   heapstart - Start of the heap region
+ *   heapsize  - Size of the heap region
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
+                  size_t heapsize)
+{
+  FAR struct tlsf_block_s *node;
+  uintptr_t heapbase;
+  uintptr_t heapend;
+#if CONFIG_MM_REGIONS > 1
+  int IDX;
+
+  IDX = heap->mm_nregions;
+
+  /* Writing past CONFIG_MM_REGIONS would have catastrophic consequences */
+
+  DEBUGASSERT(IDX < CONFIG_MM_REGIONS);
+  if (IDX >= CONFIG_MM_REGIONS)
+    {
+      return;
+    }
+
+#else
+# define IDX 0
+#endif
+
+  /* Register to KASan for access check */
+
+#ifdef CONFIG_MM_KASAN
+  if (heap->mm_kasan)
+    {
+      kasan_register(heapstart, &heapsize);
+    }
+#endif
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  heapbase = TLSF_ALIGN_UP((uintptr_t)heapstart);
+  heapend  = TLSF_ALIGN_DOWN((uintptr_t)heapstart + (uintptr_t)heapsize);
+  heapsize = heapend - heapbase;
+
+  /* A single block cannot exceed what the first level index can map */
+
+  if (heapsize - 2 * TLSF_HDRSIZE >= TLSF_BLOCK_MAX)
+    {
+      heapsize = TLSF_BLOCK_MAX - TLSF_ALIGN + 2 * TLSF_HDRSIZE;
+      heapend  = heapbase + heapsize;
+    }
+
+  DEBUGASSERT(heapsize >= 2 * TLSF_HDRSIZE + TLSF_MINBLOCK);
+
+#if defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+  minfo("[%s] Region %d: base=%p size=%zu\n",
+        heap->mm_procfs.name, IDX + 1, heapstart, heapsize);
+#else
+  minfo("Region %d: base=%p size=%zu\n", IDX + 1, heapstart, heapsize);
+#endif
+
+  /* Add the size of this region to the total size of the heap */
+
+  heap->mm_heapsize += heapsize;
+
+  /* Create two allocated guard blocks at the beginning and end of the
+   * region and one free block between them that holds all of the
+   * available memory.
+   */
+
+  heap->mm_heapstart[IDX]           = (FAR struct tlsf_block_s *)heapbase;
+  heap->mm_heapstart[IDX]->prevsize = 0;
+  heap->mm_heapstart[IDX]->size     = TLSF_HDRSIZE;
+  TLSF_ADD_BACKTRACE(heap, heap->mm_heapstart[IDX]);
+
+  node                              = (FAR struct tlsf_block_s *)
+                                      (heapbase + TLSF_HDRSIZE);
+  node->prevsize                    = TLSF_HDRSIZE;
+  node->size                        = heapsize - 2 * TLSF_HDRSIZE;
+
+  heap->mm_heapend[IDX]             = (FAR struct tlsf_block_s *)
+                                      (heapend - TLSF_HDRSIZE);
+  heap->mm_heapend[IDX]->prevsize   = node->size;
+  heap->mm_heapend[IDX]->size       = TLSF_HDRSIZE;
+  TLSF_ADD_BACKTRACE(heap, heap->mm_heapend[IDX]);
+
+#undef IDX
+
+#if CONFIG_MM_REGIONS > 1
+  heap->mm_nregions++;
+#endif
+
+  /* Add the single, large free block to the free lists */
+
+  node->size |= TLSF_FREE_BIT;
+  tlsf_insert(heap, node);
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_initialize
+ *
+ * Description:
+ *   Initialize the selected heap data structures, providing the initial
+ *   heap region.
+ *
+ * Input Parameters:
+ *   name      - The heap procfs name
+ *   heapstart - Start of the initial heap region
+ *   heapsize  - Size of the initial heap region
+ *
+ * Returned Value:
+ *   Return the address of a new heap instance.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_initialize(FAR const char *name,
+                                    FAR void *heapstart, size_t heapsize)
+{
+  FAR struct mm_heap_s *heap;
+  uintptr_t             heap_adj;
+
+  minfo("Heap: name=%s, start=%p size=%zu\n", name, heapstart, heapsize);
+
+  /* First ensure the memory to be used is aligned */
+
+  heap_adj  = TLSF_ALIGN_UP((uintptr_t)heapstart);
+  heapsize -= heap_adj - (uintptr_t)heapstart;
+
+  /* Reserve a block space for mm_heap_s context */
+
+  DEBUGASSERT(heapsize > sizeof(struct mm_heap_s));
+  heap = (FAR struct mm_heap_s *)heap_adj;
+  heapsize -= sizeof(struct mm_heap_s);
+  heapstart = (FAR char *)heap_adj + sizeof(struct mm_heap_s);
+
+  /* Set up global variables.  All free lists start out empty. */
+
+  memset(heap, 0, sizeof(struct mm_heap_s));
+
+#ifdef CONFIG_MM_KASAN
+  heap->mm_kasan = kasan_heap_enabled(name);
+#endif
+
+  nxmutex_init(&heap->mm_lock);
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  heap->mm_procfs.name = name;
+  heap->mm_procfs.heap = heap;
+#    ifdef CONFIG_MM_BACKTRACE_DEFAULT
+  heap->mm_procfs.backtrace = true;
+#    endif
+#  endif
+#endif
+
+  /* Add the initial region of memory to the heap */
+
+  mm_addregion(heap, heapstart, heapsize);
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  procfs_register_meminfo(&heap->mm_procfs);
+#  endif
+#endif
+
+  return heap;
+}
+
+/****************************************************************************
+ * Name: mm_uninitialize
+ *
+ * Description:
+ *   Uninitialize the selected heap data structures.
+ *
+ * Input Parameters:
+ *   heap - The heap to uninitialize
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_uninitialize(FAR struct mm_heap_s *heap)
+{
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  procfs_unregister_meminfo(&heap->mm_procfs);
+#  endif
+#endif
+  nxmutex_destroy(&heap->mm_lock);
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request.  Unlike the default
+ *  heap manager, the time taken does not depend on the number or the sizes
+ *  of the free chunks:  the size class is found with two bitmap searches
+ *  and its first chunk is always large enough.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct tlsf_block_s *block;
+  FAR void *ret = NULL;
+  size_t alignsize;
+
+  /* Free the delay list first */
+
+  free_delaylist(heap);
+
+  /* Ignore zero-length allocations */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  alignsize = tlsf_alignsize(size);
+  if (alignsize == 0)
+    {
+      /* There must have been an integer overflow */
+
+      return NULL;
+    }
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  block = tlsf_search(heap, alignsize);
+  if (block != NULL)
+    {
+      block->size = TLSF_BLOCKSIZE(block);
+      tlsf_trim(heap, block, alignsize);
+      ret = TLSF_PAYLOAD(block);
+    }
+
+  mm_unlock(heap);
+
+  if (ret)
+    {
+      TLSF_ADD_BACKTRACE(heap, block);
+      kasan_unpoison(ret, mm_malloc_size(ret));
+      heapprof_alloc(ret, size);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, alignsize - TLSF_HDRSIZE);
+#endif
+#ifdef CONFIG_DEBUG_MM
+      minfo("Allocated %p, size %zu\n", ret, alignsize);
+#endif
+    }
+#ifdef CONFIG_DEBUG_MM
+  else
+    {
+#ifdef CONFIG_MM_DUMP_ON_FAILURE
+      struct mallinfo minfo;
+#endif
+
+      mwarn("WARNING: Allocation failed, size %zu\n", alignsize);
+#ifdef CONFIG_MM_DUMP_ON_FAILURE
+      mm_mallinfo(heap, &minfo);
+      mwarn("Total:%d, used:%d, free:%d, largest:%d, nused:%d, nfree:%d\n",
+            minfo.arena, minfo.uordblks, minfo.fordblks,
+            minfo.mxordblk, minfo.aordblks, minfo.ordblks);
+#endif
+#ifdef CONFIG_MM_PANIC_ON_FAILURE
+      PANIC();
+#endif
+    }
+#endif
+
+  DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % TLSF_ALIGN == 0);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_free
+ *
+ * Description:
+ *   Returns a chunk of memory to the list of free nodes,  merging with
+ *   adjacent free chunks if possible.
+ *
+ ****************************************************************************/
+
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct tlsf_block_s *block;
+
+  minfo("Freeing %p\n", mem);
+
+  /* Protect against attempts to free a NULL reference */
+
+  if (!mem)
+    {
+      return;
+    }
+
+  heapprof_free(mem);
+
+  if (mm_lock(heap) < 0)
+    {
+      /* Meet -ESRCH return, which means we are in situations
+       * during context switching(See mm_lock() & gettid()).
+       * Then add to the delay list.
+       */
+
+      add_delaylist(heap, mem);
+      return;
+    }
+
+  kasan_poison(mem, mm_malloc_size(mem));
+
+  DEBUGASSERT(mm_heapmember(heap, mem));
+
+  block = TLSF_BLOCK(mem);
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(!TLSF_ISFREE(block));
+
+  tlsf_release(heap, block);
+  mm_unlock(heap);
+}
+
+/****************************************************************************
+ * Name: mm_realloc
+ *
+ * Description:
+ *   If the reallocation is for less space, then the tail of the chunk is
+ *   released.  If it is for more space and the physically following chunk
+ *   is free and large enough, that chunk is absorbed.  Otherwise a new
+ *   chunk is allocated, the data copied and the old chunk freed.
+ *
+ ****************************************************************************/
+
+FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                     size_t size)
+{
+  FAR struct tlsf_block_s *block;
+  FAR struct tlsf_block_s *next;
+  FAR void *newmem;
+  size_t newsize;
+  size_t oldsize;
+  size_t cursize;
+
+  /* If oldmem is NULL, then realloc is equivalent to malloc */
+
+  if (oldmem == NULL)
+    {
+      return mm_malloc(heap, size);
+    }
+
+  /* If size is zero, then realloc is equivalent to free */
+
+  if (size < 1)
+    {
+      mm_free(heap, oldmem);
+      return NULL;
+    }
+
+  newsize = tlsf_alignsize(size);
+  if (newsize == 0)
+    {
+      /* There must have been an integer overflow */
+
+      DEBUGPANIC();
+      return NULL;
+    }
+
+  DEBUGASSERT(mm_heapmember(heap, oldmem));
+  DEBUGVERIFY(mm_lock(heap));
+
+  block   = TLSF_BLOCK(oldmem);
+  oldsize = TLSF_BLOCKSIZE(block);
+  DEBUGASSERT(!TLSF_ISFREE(block));
+
+  if (newsize > oldsize)
+    {
+      next = TLSF_NEXT(block);
+      if (TLSF_ISFREE(next) && oldsize + TLSF_BLOCKSIZE(next) >= newsize)
+        {
+          tlsf_remove(heap, next);
+          block->size = oldsize + TLSF_BLOCKSIZE(next);
+          TLSF_NEXT(block)->prevsize = block->size;
+        }
+    }
+
+  cursize = TLSF_BLOCKSIZE(block);
+  if (cursize >= newsize)
+    {
+      /* The chunk can be resized in place.  The tail released by shrinking
+       * it is free memory.
+       */
+
+      tlsf_trim(heap, block, newsize);
+      if (TLSF_BLOCKSIZE(block) < cursize)
+        {
+          kasan_poison((FAR char *)block + TLSF_BLOCKSIZE(block),
+                       cursize - TLSF_BLOCKSIZE(block));
+        }
+
+      mm_unlock(heap);
+
+      kasan_unpoison(oldmem, mm_malloc_size(oldmem));
+      heapprof_free(oldmem);
+      heapprof_alloc(oldmem, size);
+      return oldmem;
+    }
+
+  mm_unlock(heap);
+
+  /* Allocate a new block.  On failure, realloc must return NULL but
+   * leave the original memory in place.
+   */
+
+  newmem = mm_malloc(heap, size);
+  if (newmem)
+    {
+      memcpy(newmem, oldmem, oldsize - TLSF_HDRSIZE);
+      mm_free(heap, oldmem);
+    }
+
+  return newmem;
+}
+
+/****************************************************************************
+ * Name: mm_calloc
+ *
+ * Descriptor:
+ *   mm_calloc() calculates the size of the allocation and calls mm_zalloc()
+ *
+ ****************************************************************************/
+
+FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
+{
+  FAR void *ret = NULL;
+
+  /* Verify input parameters */
+
+  if (n > 0 && elem_size > 0)
+    {
+      /* Assure that the following multiplication cannot overflow the size_t
+       * type, i.e., that:  SIZE_MAX >= n * elem_size
+       */
+
+      if (n <= (SIZE_MAX / elem_size))
+        {
+          ret = mm_zalloc(heap, n * elem_size);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_zalloc
+ *
+ * Description:
+ *   mm_zalloc calls mm_malloc, then zeroes out the allocated chunk.
+ *
+ ****************************************************************************/
+
+FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR void *alloc = mm_malloc(heap, size);
+  if (alloc)
+    {
+      memset(alloc, 0, size);
+    }
+
+  return alloc;
+}
+
+/****************************************************************************
+ * Name: mm_memalign
+ *
+ * Description:
+ *   memalign requests more than enough space from the free lists, aligns
+ *   the memory and releases the unused leading and trailing space.  This
+ *   is done with a single search and so has the same bound as mm_malloc.
+ *
+ ****************************************************************************/
+
+FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                      size_t size)
+{
+  FAR struct tlsf_block_s *block;
+  FAR struct tlsf_block_s *aligned;
+  uintptr_t payload;
+  uintptr_t alignedpayload;
+  size_t alignsize;
+  size_t allocsize;
+  size_t blocksize;
+  size_t gap;
+
+  /* Make sure that alignment is less than half max size_t */
+
+  if (alignment >= (SIZE_MAX / 2))
+    {
+      return NULL;
+    }
+
+  /* Make sure that alignment is a power of 2 */
+
+  if ((alignment & -alignment) != alignment)
+    {
+      return NULL;
+    }
+
+  /* If this requested alinement's less than or equal to the natural
+   * alignment of malloc, then just let malloc do the work.
+   */
+
+  if (alignment <= TLSF_ALIGN)
+    {
+      FAR void *ptr = mm_malloc(heap, size);
+      DEBUGASSERT(ptr == NULL || ((uintptr_t)ptr) % alignment == 0);
+      return ptr;
+    }
+
+  /* Leave room for the alignment and for a leading free block that is at
+   * least TLSF_MINBLOCK in size.
+   */
+
+  alignsize = tlsf_alignsize(size);
+  allocsize = alignsize + alignment + TLSF_MINBLOCK;
+  if (alignsize == 0 || allocsize < alignsize)
+    {
+      /* Integer overflow */
+
+      return NULL;
+    }
+
+  free_delaylist(heap);
+  DEBUGVERIFY(mm_lock(heap));
+
+  block = tlsf_search(heap, allocsize);
+  if (block == NULL)
+    {
+      mm_unlock(heap);
+      return NULL;
+    }
+
+  blocksize   = TLSF_BLOCKSIZE(block);
+  block->size = blocksize;
+
+  payload        = (uintptr_t)TLSF_PAYLOAD(block);
+  alignedpayload = (payload + alignment - 1) & ~(alignment - 1);
+  gap            = alignedpayload - payload;
+  if (gap != 0 && gap < TLSF_MINBLOCK)
+    {
+      alignedpayload = (payload + TLSF_MINBLOCK + alignment - 1) &
+                       ~(alignment - 1);
+      gap            = alignedpayload - payload;
+    }
+
+  if (gap != 0)
+    {
+      /* Split off the leading space and return it to the free lists */
+
+      aligned           = (FAR struct tlsf_block_s *)
+                          ((FAR char *)block + gap);
+      aligned->size     = blocksize - gap;
+      aligned->prevsize = gap;
+      block->size       = gap;
+      TLSF_NEXT(aligned)->prevsize = aligned->size;
+
+      tlsf_release(heap, block);
+      block = aligned;
+    }
+
+  tlsf_trim(heap, block, alignsize);
+  mm_unlock(heap);
+
+  TLSF_ADD_BACKTRACE(heap, block);
+  kasan_unpoison(TLSF_PAYLOAD(block), mm_malloc_size(TLSF_PAYLOAD(block)));
+  heapprof_alloc(TLSF_PAYLOAD(block), mm_malloc_size(TLSF_PAYLOAD(block)));
+
+  DEBUGASSERT(((uintptr_t)TLSF_PAYLOAD(block)) % alignment == 0);
+  return TLSF_PAYLOAD(block);
+}
+
+/****************************************************************************
+ * Name: mm_malloc_size
+ ****************************************************************************/
+
+size_t mm_malloc_size(FAR void *mem)
+{
+  FAR struct tlsf_block_s *block;
+
+  /* Protect against attempts to query a NULL reference */
+
+  if (!mem)
+    {
+      return 0;
+    }
+
+  block = TLSF_BLOCK(mem);
+  DEBUGASSERT(!TLSF_ISFREE(block));
+
+  return TLSF_BLOCKSIZE(block) - TLSF_HDRSIZE;
+}
+
+/****************************************************************************
+ * Name: mm_heapmember
+ *
+ * Description:
+ *   Check if an address lies in the heap.
+ *
+ * Parameters:
+ *   heap - The heap to check
+ *   mem  - The address to check
+ *
+ * Return Value:
+ *   true if the address is a member of the heap.  false if not
+ *   not.  If the address is not a member of the heap, then it
+ *   must be a member of the user-space heap (unchecked)
+ *
+ ****************************************************************************/
+
+bool mm_heapmember(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if CONFIG_MM_REGIONS > 1
+  int i;
+
+  /* A valid address from the heap for this region would have to lie
+   * between the region's two guard blocks.
+   */
+
+  for (i = 0; i < heap->mm_nregions; i++)
+    {
+      if (mem > (FAR void *)heap->mm_heapstart[i] &&
+          mem < (FAR void *)heap->mm_heapend[i])
+        {
+          return true;
+        }
+    }
+
+  return false;
+#else
+  return mem > (FAR void *)heap->mm_heapstart[0] &&
+         mem < (FAR void *)heap->mm_heapend[0];
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_nextfree
+ *
+ * Description:
+ *   Find the free memory of the heap with the lowest address that ends
+ *   above an address.  The headers of the free blocks are not part of it,
+ *   so that the heap can still be walked in a dump that omits the free
+ *   memory.
+ *
+ * Parameters:
+ *   heap  - The heap to search
+ *   addr  - The address to search from
+ *   start - The start of the free memory found
+ *   end   - The end of the free memory found
+ *
+ * Return Value:
+ *   OK if free memory was found; -ENOENT if not, or the error of
+ *   mm_lock().
+ *
+ ****************************************************************************/
+
+int mm_nextfree(FAR struct mm_heap_s *heap, uintptr_t addr,
+                FAR uintptr_t *start, FAR uintptr_t *end)
+{
+  FAR struct tlsf_block_s *block;
+  uintptr_t blockstart;
+  uintptr_t blockend;
+  uintptr_t first = UINTPTR_MAX;
+  uintptr_t last = 0;
+  int ret;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(start != NULL && end != NULL);
+
+  ret = mm_lock(heap);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      for (block = heap->mm_heapstart[region];
+           block < heap->mm_heapend[region];
+           block = TLSF_NEXT(block))
+        {
+          blockstart = (uintptr_t)block + sizeof(struct tlsf_block_s);
+          blockend   = (uintptr_t)TLSF_NEXT(block);
+
+          /* The blocks of a region are sorted:  No later one comes first */
+
+          if (blockstart >= first)
+            {
+              break;
+            }
+
+          if (TLSF_ISFREE(block) && blockend > blockstart &&
+              blockend > addr)
+            {
+              first = blockstart;
+              last  = blockend;
+            }
+        }
+    }
+
+  mm_unlock(heap);
+
+  if (last == 0)
+    {
+      return -ENOENT;
+    }
+
+  *start = first;
+  *end   = last;
+  return OK;
+#undef region
+}
+
+/****************************************************************************
+ * Name: mm_brkaddr
+ *
+ * Description:
+ *   Return the break address of a heap region.  Zero is returned if the
+ *   memory region is not initialized.
+ *
+ ****************************************************************************/
+
+FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region)
+{
+  uintptr_t brkaddr;
+
+#if CONFIG_MM_REGIONS > 1
+  DEBUGASSERT(heap && region < heap->mm_nregions);
+#else
+  DEBUGASSERT(heap && region == 0);
+#endif
+
+  brkaddr = (uintptr_t)heap->mm_heapend[region];
+  return brkaddr ? (FAR void *)(brkaddr + TLSF_HDRSIZE) : 0;
+}
+
+/****************************************************************************
+ * Name: mm_extend
+ *
+ * Description:
+ *   Extend a heap region by add a block of (virtually) contiguous memory
+ *   to the end of the heap.
+ *
+ ****************************************************************************/
+
+void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
+               int region)
+{
+  FAR struct tlsf_block_s *oldnode;
+  FAR struct tlsf_block_s *newnode;
+  uintptr_t blockend;
+
+  /* Make sure that we were passed valid parameters */
+
+  DEBUGASSERT(heap && mem);
+#if CONFIG_MM_REGIONS > 1
+  DEBUGASSERT(size >= TLSF_MINBLOCK &&
+      (size_t)region < (size_t)heap->mm_nregions);
+#else
+  DEBUGASSERT(size >= TLSF_MINBLOCK && region == 0);
+#endif
+
+  blockend = (uintptr_t)mem + size;
+
+  DEBUGASSERT(TLSF_ALIGN_UP((uintptr_t)mem) == (uintptr_t)mem);
+  DEBUGASSERT(TLSF_ALIGN_DOWN(blockend) == blockend);
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  /* The block to extend must immediately follow the trailing guard block,
+   * which becomes an allocated block covering the new memory.
+   */
+
+  oldnode = heap->mm_heapend[region];
+  DEBUGASSERT((uintptr_t)oldnode + TLSF_HDRSIZE == (uintptr_t)mem);
+
+  oldnode->size      = size;
+
+  newnode            = (FAR struct tlsf_block_s *)(blockend - TLSF_HDRSIZE);
+  newnode->prevsize  = size;
+  newnode->size      = TLSF_HDRSIZE;
+  TLSF_ADD_BACKTRACE(heap, newnode);
+
+  heap->mm_heapend[region] = newnode;
+  heap->mm_heapsize       += size;
+  mm_unlock(heap);
+
+  /* Finally "free" the new block of memory where the old guard block was
+   * located.
+   */
+
+  mm_free(heap, mem);
+}
+
+/****************************************************************************
+ * Name: mm_mallinfo
+ *
+ * Description:
+ *   mallinfo returns a copy of updated current heap information.
+ *
+ ****************************************************************************/
+
+int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region = heap->mm_nregions;
+#else
+# define region 1
+#endif
+
+  DEBUGASSERT(info);
+
+  memset(info, 0, sizeof(*info));
+  tlsf_foreach(heap, mallinfo_handler, info);
+
+  info->arena = heap->mm_heapsize;
+  info->uordblks += region * TLSF_HDRSIZE; /* account for the tail guard */
+
+  DEBUGASSERT(info->uordblks + info->fordblks == heap->mm_heapsize);
+
+  return OK;
+#undef region
+}
+
+/****************************************************************************
+ * Name: mm_mallinfo_task
+ *
+ * Description:
+ *   mallinfo_task returns a copy of updated current task's heap information.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE >= 0
+int mm_mallinfo_task(FAR struct mm_heap_s *heap,
+                     FAR struct mallinfo_task *info)
+{
+  DEBUGASSERT(info);
+
+  info->uordblks = 0;
+  info->aordblks = 0;
+  tlsf_foreach(heap, mallinfo_task_handler, info);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_memdump
+ *
+ * Description:
+ *   mm_memdump returns a memory info about specified pid of task/thread.
+ *   if pid equals -1, this function will dump all allocated node and output
+ *   backtrace for every allocated node for this heap, if pid equals -2, this
+ *   function will dump all free node for this heap, and if pid is greater
+ *   than or equal to 0, will dump pid allocated node and output backtrace.
+ *
+ ****************************************************************************/
+
+void mm_memdump(FAR struct mm_heap_s *heap, pid_t pid)
+{
+  struct memdump_info_s info;
+
+  if (pid >= -1)
+    {
+      syslog(LOG_INFO, "Dump all used memory node info:\n");
+#if CONFIG_MM_BACKTRACE < 0
+      syslog(LOG_INFO, "%12s%*s\n", "Size", MM_PTR_FMT_WIDTH, "Address");
+#else
+      syslog(LOG_INFO, "%6s%12s%*s %s\n", "PID", "Size", MM_PTR_FMT_WIDTH,
+             "Address", "Backtrace");
+#endif
+    }
+  else
+    {
+      syslog(LOG_INFO, "Dump all free memory node info:\n");
+      syslog(LOG_INFO, "%12s%*s\n", "Size", MM_PTR_FMT_WIDTH, "Address");
+    }
+
+  info.blks = 0;
+  info.size = 0;
+  info.pid  = pid;
+  tlsf_foreach(heap, memdump_handler, &info);
+
+  syslog(LOG_INFO, "%12s%12s\n", "Total Blks", "Total Size");
+  syslog(LOG_INFO, "%12d%12d\n", info.blks, info.size);
+}
+
+/****************************************************************************
+ * Name: mm_checkcorruption
+ *
+ * Description:
+ *   mm_checkcorruption is used to check whether memory heap is normal.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM
+void mm_checkcorruption(FAR struct mm_heap_s *heap)
+{
+  tlsf_foreach(heap, checkcorruption_handler, NULL);
+}
+#endif
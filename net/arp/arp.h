@@ -38,6 +38,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
 
 #include <netinet/in.h>
@@ -420,6 +421,28 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev);
 
 void arp_cleanup(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: arp_refresh
+ *
+ * Description:
+ *   If an entry of the device that is in use is about to expire, format an
+ *   ARP request to refresh it into d_buf.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure
+ *
+ * Returned Value:
+ *   True if a request was formatted.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_REFRESH
+bool arp_refresh(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: arp_update
  *
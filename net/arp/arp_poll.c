@@ -62,6 +62,15 @@ int arp_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 
   devif_conn_event(dev, ARP_POLL, dev->d_conncb);
 
+#ifdef CONFIG_NET_ARP_REFRESH
+  /* If no request was sent, refresh an entry that is about to expire */
+
+  if (dev->d_len == 0)
+    {
+      arp_refresh(dev);
+    }
+#endif
+
   /* Call back into the driver */
 
   return devif_poll_out(dev, callback);
@@ -55,6 +55,7 @@
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/queue.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -72,6 +73,28 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#ifdef CONFIG_NET_ARP_REFRESH
+#  define ARP_REFRESH_TICK \
+     (ARP_MAXAGE_TICK - MIN(ARP_MAXAGE_TICK / 2, \
+                            SEC2TICK(CONFIG_NET_ARP_REFRESH_SEC)))
+#endif
+
+/* The table is indexed by a hash of the IP address, one bucket per entry.
+ * Bucket heads and chain links hold an entry index plus one, zero ending
+ * the chain.
+ */
+
+#define ARP_HASHSIZE    CONFIG_NET_ARPTAB_SIZE
+#define ARP_HASH(ip)    ((((uint32_t)(ip) * 2654435761u) >> 16) % \
+                         ARP_HASHSIZE)
+#define ARP_INDEX(link) ((int)((FAR dq_entry_t *)(link) - g_arplink))
+
+/* The refresh state of an entry */
+
+#define ARP_REFRESH_NONE    0  /* Not due for refresh */
+#define ARP_REFRESH_PENDING 1  /* A request is to be sent */
+#define ARP_REFRESH_SENT    2  /* A request was sent */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -90,6 +113,26 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The hash index of the table */
+
+static uint16_t g_arphash[ARP_HASHSIZE];
+static uint16_t g_arpnext[CONFIG_NET_ARPTAB_SIZE];
+
+/* The entries handed out so far, least recently used first.  Entries
+ * are handed out from the start of the table until it is full.
+ */
+
+static dq_entry_t g_arplink[CONFIG_NET_ARPTAB_SIZE];
+static dq_queue_t g_arplru;
+static int g_arpnused;
+
+#ifdef CONFIG_NET_ARP_REFRESH
+/* The refresh state of each entry and the number of pending refreshes */
+
+static uint8_t g_arprefresh[CONFIG_NET_ARPTAB_SIZE];
+static int g_arpnpending;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -141,32 +184,98 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_unhash
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Remove an entry from the hash index and mark it unused.  The entry is
+ *   made the least recently used one, so that it is reused first.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static void arp_unhash(int index)
 {
-  if (e1->at_ipaddr == 0)
+  FAR uint16_t *link;
+
+  for (link = &g_arphash[ARP_HASH(g_arptable[index].at_ipaddr)];
+       *link != 0; link = &g_arpnext[*link - 1])
     {
-      return e1;
+      if (*link == index + 1)
+        {
+          *link = g_arpnext[index];
+          break;
+        }
     }
-  else if (e2->at_ipaddr == 0)
+
+#ifdef CONFIG_NET_ARP_REFRESH
+  if (g_arprefresh[index] == ARP_REFRESH_PENDING)
     {
-      return e2;
+      g_arpnpending--;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  g_arprefresh[index] = ARP_REFRESH_NONE;
+#endif
+
+  g_arptable[index].at_ipaddr = 0;
+  dq_rem(&g_arplink[index], &g_arplru);
+  dq_addfirst(&g_arplink[index], &g_arplru);
+}
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Get an entry for a new address mapping: an entry never used before if
+ *   there is one, otherwise the least recently used entry.
+ *
+ ****************************************************************************/
+
+static int arp_alloc(void)
+{
+  int index;
+
+  if (g_arpnused < CONFIG_NET_ARPTAB_SIZE)
     {
-      return e1;
+      index = g_arpnused++;
+      dq_addfirst(&g_arplink[index], &g_arplru);
+      return index;
     }
-  else
+
+  index = ARP_INDEX(dq_peek(&g_arplru));
+  if (g_arptable[index].at_ipaddr != 0)
+    {
+      arp_unhash(index);
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Name: arp_search
+ *
+ * Description:
+ *   Find the ARP table entry of this IP address on this device, expired or
+ *   not.
+ *
+ * Returned Value:
+ *   The index of the entry; -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int arp_search(in_addr_t ipaddr, FAR struct net_driver_s *dev)
+{
+  uint16_t link;
+
+  for (link = g_arphash[ARP_HASH(ipaddr)]; link != 0;
+       link = g_arpnext[link - 1])
     {
-      return e2;
+      if (g_arptable[link - 1].at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, g_arptable[link - 1].at_ipaddr))
+        {
+          return link - 1;
+        }
     }
+
+  return -1;
 }
 
 /****************************************************************************
@@ -188,20 +297,15 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  int index;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  index = arp_search(ipaddr, dev);
+  if (index >= 0 &&
+      clock_systime_ticks() - g_arptable[index].at_time <= ARP_MAXAGE_TICK)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return &g_arptable[index];
     }
 
   /* Not found */
@@ -237,45 +341,49 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_entry_s *tabptr;
+  int index;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  /* An address of zero marks an unused entry (ARP probes use it) */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  if (ipaddr == 0)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      return -EINVAL;
+    }
 
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
+  /* Find the entry to update.  If none is found, the IP -> MAC address
+   * mapping is inserted in the ARP table.
+   */
 
-          tabptr = &g_arptable[i];
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
+  index = arp_search(ipaddr, dev);
+  if (index < 0)
+    {
+      index = arp_alloc();
+      g_arpnext[index] = g_arphash[ARP_HASH(ipaddr)];
+      g_arphash[ARP_HASH(ipaddr)] = index + 1;
+    }
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+#ifdef CONFIG_NET_ARP_REFRESH
+  else if (g_arprefresh[index] == ARP_REFRESH_PENDING)
+    {
+      g_arpnpending--;
     }
 
+  g_arprefresh[index] = ARP_REFRESH_NONE;
+#endif
+
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
+  tabptr = &g_arptable[index];
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
+
+  dq_rem(&g_arplink[index], &g_arplru);
+  dq_addlast(&g_arplink[index], &g_arplru);
   return OK;
 }
 
@@ -335,13 +443,32 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
 {
   FAR struct arp_entry_s *tabptr;
   struct arp_table_info_s info;
+  int index;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
-      /* Yes.. return the Ethernet MAC address if the caller has provided a
+      index = tabptr - g_arptable;
+
+      /* Make the entry the most recently used one */
+
+      dq_rem(&g_arplink[index], &g_arplru);
+      dq_addlast(&g_arplink[index], &g_arplru);
+
+#ifdef CONFIG_NET_ARP_REFRESH
+      /* Ask for a refresh of an entry in use before it expires */
+
+      if (g_arprefresh[index] == ARP_REFRESH_NONE &&
+          clock_systime_ticks() - tabptr->at_time > ARP_REFRESH_TICK)
+        {
+          g_arprefresh[index] = ARP_REFRESH_PENDING;
+          g_arpnpending++;
+        }
+#endif
+
+      /* Return the Ethernet MAC address if the caller has provided a
        * non-NULL address in 'ethaddr'.
        */
 
@@ -401,7 +528,7 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
     {
       /* Yes.. Set the IP address to zero to "delete" it */
 
-      tabptr->at_ipaddr = 0;
+      arp_unhash(tabptr - g_arptable);
       return OK;
     }
 
@@ -426,15 +553,74 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 {
   int i;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < g_arpnused; ++i)
     {
       if (dev == g_arptable[i].at_dev)
         {
+          if (g_arptable[i].at_ipaddr != 0)
+            {
+              arp_unhash(i);
+            }
+
           memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
         }
     }
 }
 
+/****************************************************************************
+ * Name: arp_refresh
+ *
+ * Description:
+ *   If an entry of the device that is in use is about to expire, format an
+ *   ARP request to refresh it into d_buf.  The request is sent with the
+ *   next outgoing packet of the device, so resolution does not stall the
+ *   packets sent to the address meanwhile.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure
+ *
+ * Returned Value:
+ *   True if a request was formatted.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_REFRESH
+bool arp_refresh(FAR struct net_driver_s *dev)
+{
+  int i;
+
+  if (g_arpnpending == 0)
+    {
+      return false;
+    }
+
+  for (i = 0; i < g_arpnused; i++)
+    {
+      if (g_arprefresh[i] == ARP_REFRESH_PENDING &&
+          g_arptable[i].at_dev == dev)
+        {
+          g_arprefresh[i] = ARP_REFRESH_SENT;
+          g_arpnpending--;
+
+          ninfo("ARP refresh for IP %08lx\n",
+                (unsigned long)g_arptable[i].at_ipaddr);
+
+          arp_format(dev, g_arptable[i].at_ipaddr);
+
+          /* Make sure that arp_out() does not overwrite the request */
+
+          IFF_SET_NOARP(dev->d_flags);
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: arp_snapshot
  *
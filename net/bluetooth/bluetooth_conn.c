@@ -142,6 +142,7 @@ FAR struct bluetooth_conn_s *bluetooth_conn_alloc(void)
       /* Mark as unbound */
 
       conn->bc_proto = BTPROTO_NONE;
+      nxrmutex_init(&conn->bc_conn.s_lock);
 
       /* Enqueue the connection into the active list */
 
@@ -56,10 +56,31 @@
 #define can_callback_free(dev,conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->sconn.list, &conn->sconn.list_tail)
 
+/* The key of a CAN ID in the filter hash table: the ID with its EFF and
+ * RTR flags, without the error flag.
+ */
+
+#define CAN_FILTER_KEY(id) \
+  ((id) & (CAN_EFF_FLAG | CAN_RTR_FLAG | \
+           (((id) & CAN_EFF_FLAG) != 0 ? CAN_EFF_MASK : CAN_SFF_MASK)))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+/* An exact filter of a connection, in the filter hash table */
+
+struct can_conn_s; /* Forward reference */
+
+struct can_filter_ent_s
+{
+  FAR struct can_filter_ent_s *flink;
+  FAR struct can_conn_s *conn;
+  canid_t key;                       /* CAN_FILTER_KEY() of the ID */
+};
+#endif
+
 /* This is a container that holds the poll-related information */
 
 struct can_poll_s
@@ -107,6 +128,16 @@ struct can_conn_s
 #endif
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+
+  /* If all of the filters are exact, the connection is only found through
+   * the hash table of the CAN IDs.  Otherwise its filters are evaluated for
+   * every frame, the connection being in the list of rxnode.
+   */
+
+  struct can_filter_ent_s filterents[CONFIG_NET_CAN_RAW_FILTER_MAX];
+  uint8_t nfilterents;               /* Entries in the hash table */
+  bool rxall;                        /* In the list of rxnode */
+  dq_entry_t rxnode;
 # ifdef CONFIG_NET_CAN_RAW_TX_DEADLINE
   int32_t tx_deadline;
 # endif
@@ -405,6 +436,66 @@ int can_getsockopt(FAR struct socket *psock, int level, int option,
                    FAR void *value, FAR socklen_t *value_len);
 #endif
 
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Index the CAN_RAW_FILTER filters of a connection for can_input(),
+ *   after they were changed.  A connection with only exact filters, that
+ *   match a single ID with its EFF and RTR flags, is entered into the hash
+ *   table of the IDs.  Any other connection with filters is put in the
+ *   list of those that are checked by can_filter_match() for every frame.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_update(FAR struct can_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: can_filter_remove
+ *
+ * Description:
+ *   Remove a connection from the filter hash table or list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_remove(FAR struct can_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Return true if a frame with the CAN ID 'id' passes one of the filters
+ *   of the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+bool can_filter_match(FAR struct can_conn_s *conn, canid_t id);
+#endif
+
+/****************************************************************************
+ * Name: can_filter_lookup / can_filter_nextconn
+ *
+ * Description:
+ *   can_filter_lookup() returns the chain of the hash table where the
+ *   exact filters for the CAN ID key 'key' are; entries of other keys must
+ *   be skipped.  can_filter_nextconn() traverses the list of connections
+ *   whose filters must be checked with can_filter_match().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+FAR struct can_filter_ent_s *can_filter_lookup(canid_t key);
+FAR struct can_conn_s *can_filter_nextconn(FAR struct can_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
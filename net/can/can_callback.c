@@ -202,6 +202,17 @@ uint16_t can_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+#ifdef CONFIG_IOB_POOLS
+  ret = iob_pool_charge(IOB_POOL_CAN, iob);
+  if (ret < 0)
+    {
+      /* CAN is over its quota, drop the frame */
+
+      netdev_iob_release(dev);
+      return 0;
+    }
+#endif
+
   ret = iob_tryadd_queue(iob, &conn->readahead);
   if (ret >= 0)
     {
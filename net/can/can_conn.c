@@ -141,8 +141,11 @@ FAR struct can_conn_s *can_alloc(void)
        */
 
       conn->filter_count = 1;
+      can_filter_update(conn);
 #endif
 
+      nxrmutex_init(&conn->sconn.s_lock);
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_can_connections);
@@ -173,6 +176,10 @@ void can_free(FAR struct can_conn_s *conn)
 
   dq_rem(&conn->sconn.node, &g_active_can_connections);
 
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+  can_filter_remove(conn);
+#endif
+
   /* Reset structure */
 
   memset(conn, 0, sizeof(*conn));
@@ -0,0 +1,233 @@
+/****************************************************************************
+ * net/can/can_filter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CAN_FILTER_HASH(key) \
+  (((key) ^ ((key) >> 11) ^ ((key) >> 22)) % CONFIG_NET_CAN_FILTER_HASHSIZE)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The exact filters of the connections, by CAN ID */
+
+static FAR struct can_filter_ent_s *
+g_can_filter_hash[CONFIG_NET_CAN_FILTER_HASHSIZE];
+
+/* The connections with other filters */
+
+static dq_queue_t g_can_filter_rxall;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_exact
+ *
+ * Description:
+ *   Return true if the filter matches the frames of one CAN ID only, with
+ *   given EFF and RTR flags.
+ *
+ ****************************************************************************/
+
+static bool can_filter_exact(FAR const struct can_filter *filter)
+{
+  return (filter->can_id & CAN_INV_FILTER) == 0 &&
+         filter->can_mask == (CAN_EFF_FLAG | CAN_RTR_FLAG |
+                              ((filter->can_id & CAN_EFF_FLAG) != 0 ?
+                               CAN_EFF_MASK : CAN_SFF_MASK));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_remove
+ ****************************************************************************/
+
+void can_filter_remove(FAR struct can_conn_s *conn)
+{
+  FAR struct can_filter_ent_s **prev;
+  FAR struct can_filter_ent_s *ent;
+  irqstate_t flags;
+  int i;
+
+  /* Frames may be dispatched from the interrupt handler of the driver */
+
+  flags = enter_critical_section();
+
+  for (i = 0; i < conn->nfilterents; i++)
+    {
+      ent  = &conn->filterents[i];
+      prev = &g_can_filter_hash[CAN_FILTER_HASH(ent->key)];
+      while (*prev != ent)
+        {
+          prev = &(*prev)->flink;
+        }
+
+      *prev = ent->flink;
+    }
+
+  conn->nfilterents = 0;
+
+  if (conn->rxall)
+    {
+      dq_rem(&conn->rxnode, &g_can_filter_rxall);
+      conn->rxall = false;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: can_filter_update
+ ****************************************************************************/
+
+void can_filter_update(FAR struct can_conn_s *conn)
+{
+  FAR struct can_filter_ent_s *ent;
+  irqstate_t flags;
+  canid_t key;
+  int i;
+  int j;
+
+  can_filter_remove(conn);
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (!can_filter_exact(&conn->filters[i]))
+        {
+          break;
+        }
+    }
+
+  flags = enter_critical_section();
+
+  if (i < conn->filter_count)
+    {
+      dq_addlast(&conn->rxnode, &g_can_filter_rxall);
+      conn->rxall = true;
+    }
+  else
+    {
+      for (i = 0; i < conn->filter_count; i++)
+        {
+          /* A frame is delivered once, even if filters are repeated */
+
+          key = CAN_FILTER_KEY(conn->filters[i].can_id);
+          for (j = 0; j < conn->nfilterents; j++)
+            {
+              if (conn->filterents[j].key == key)
+                {
+                  break;
+                }
+            }
+
+          if (j < conn->nfilterents)
+            {
+              continue;
+            }
+
+          ent        = &conn->filterents[conn->nfilterents++];
+          ent->conn  = conn;
+          ent->key   = key;
+          ent->flink = g_can_filter_hash[CAN_FILTER_HASH(key)];
+          g_can_filter_hash[CAN_FILTER_HASH(key)] = ent;
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: can_filter_match
+ ****************************************************************************/
+
+bool can_filter_match(FAR struct can_conn_s *conn, canid_t id)
+{
+  FAR struct can_filter *filter;
+  int i;
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      filter = &conn->filters[i];
+      if ((filter->can_id & CAN_INV_FILTER) != 0)
+        {
+          if ((id & filter->can_mask) !=
+              ((filter->can_id & ~CAN_INV_FILTER) & filter->can_mask))
+            {
+              return true;
+            }
+        }
+      else if ((id & filter->can_mask) ==
+               (filter->can_id & filter->can_mask))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: can_filter_lookup
+ ****************************************************************************/
+
+FAR struct can_filter_ent_s *can_filter_lookup(canid_t key)
+{
+  return g_can_filter_hash[CAN_FILTER_HASH(key)];
+}
+
+/****************************************************************************
+ * Name: can_filter_nextconn
+ ****************************************************************************/
+
+FAR struct can_conn_s *can_filter_nextconn(FAR struct can_conn_s *conn)
+{
+  FAR dq_entry_t *node;
+
+  node = conn == NULL ? dq_peek(&g_can_filter_rxall) : conn->rxnode.flink;
+  return node != NULL ?
+         container_of(node, struct can_conn_s, rxnode) : NULL;
+}
+
+#endif /* CONFIG_NET_CANPROTO_OPTIONS */
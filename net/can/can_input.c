@@ -27,8 +27,10 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_CAN)
 
 #include <errno.h>
+#include <string.h>
 #include <debug.h>
 
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/can.h>
 
@@ -128,15 +130,80 @@ const uint8_t len_to_can_dlc[65] =
 };
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: can_deliver
+ *
+ * Description:
+ *   Deliver the frame to one connection.  The frame, saved in 'frame', is
+ *   put back in d_iob first if a previous connection kept the buffer or
+ *   appended a time stamp to it.
+ *
+ * Returned Value:
+ *   OK     The frame was delivered or buffered
+ *  -EAGAIN The frame could not be dispatched yet
+ *
+ ****************************************************************************/
+
+static int can_deliver(FAR struct net_driver_s *dev,
+                       FAR struct can_conn_s *conn,
+                       FAR const uint8_t *frame, uint16_t buflen)
+{
+  uint16_t flags;
+
+  if (dev->d_iob == NULL || dev->d_iob->io_pktlen != buflen)
+    {
+      netdev_iob_release(dev);
+      if (netdev_iob_prepare(dev, false, 0) != OK ||
+          iob_trycopyin(dev->d_iob, frame, buflen, 0, false) != buflen)
+        {
+          nwarn("WARNING: No IOB for the frame\n");
+          return -ENOMEM;
+        }
+    }
+
+  /* Setup for the application callback */
+
+  dev->d_appdata = dev->d_buf;
+  dev->d_sndlen  = 0;
+  dev->d_len     = buflen;
+
+  /* Perform the application callback */
+
+  flags = can_callback(dev, conn, CAN_NEWDATA);
+
+  /* If the operation was successful, the CAN_NEWDATA flag is removed
+   * and thus the packet can be deleted (OK will be returned).
+   */
+
+  if ((flags & CAN_NEWDATA) != 0)
+    {
+      /* No.. the packet was not processed now.  Return -EAGAIN so
+       * that the driver may retry again later.  We still need to
+       * set d_len to zero so that the driver is aware that there
+       * is nothing to be sent.
+       */
+
+      nwarn("WARNING: Packet not processed\n");
+      return -EAGAIN;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: can_in
  *
  * Description:
  *   Handle incoming packet input
  *
+ *   With CAN_RAW_FILTER support, the frame is only delivered to the
+ *   connections whose filters accept it: those with exact filters for its
+ *   ID are found in the filter hash table and only the other ones evaluate
+ *   their filters.
+ *
  * Input Parameters:
  *   dev - The device driver structure containing the received packet
  *
@@ -154,49 +221,72 @@ const uint8_t len_to_can_dlc[65] =
 static int can_in(struct net_driver_s *dev)
 {
   FAR struct can_conn_s *conn = NULL;
-  int ret = OK;
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+  FAR struct can_filter_ent_s *ent;
+  canid_t key;
+#endif
+#ifdef CONFIG_NET_CAN_CANFD
+  uint8_t frame[CANFD_MTU];
+#else
+  uint8_t frame[CAN_MTU];
+#endif
   uint16_t buflen = dev->d_len;
+  canid_t id;
+  int ret = OK;
 
-  do
-    {
-      conn = can_nextconn(conn);
-
-      if (conn && (conn->dev == NULL || dev == conn->dev))
-        {
-          uint16_t flags;
-
-          /* Setup for the application callback */
-
-          dev->d_appdata = dev->d_buf;
-          dev->d_sndlen  = 0;
-          dev->d_len     = buflen;
+  /* Keep the frame, for the case that several connections receive it */
 
-          /* Perform the application callback */
+  if (buflen < sizeof(canid_t) || buflen > sizeof(frame) ||
+      iob_copyout(frame, dev->d_iob, buflen, 0) != buflen)
+    {
+      nwarn("WARNING: Bad frame length %u\n", buflen);
+      return OK;
+    }
 
-          flags = can_callback(dev, conn, CAN_NEWDATA);
+  memcpy(&id, frame, sizeof(canid_t));
 
-          /* If the operation was successful, the CAN_NEWDATA flag is removed
-           * and thus the packet can be deleted (OK will be returned).
-           */
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+  key = CAN_FILTER_KEY(id);
+  for (ent = can_filter_lookup(key); ent != NULL; ent = ent->flink)
+    {
+      conn = ent->conn;
+      if (ent->key == key && (conn->dev == NULL || dev == conn->dev) &&
+          can_deliver(dev, conn, frame, buflen) == -EAGAIN)
+        {
+          ret = -EAGAIN;
+        }
+    }
 
-          if ((flags & CAN_NEWDATA) != 0)
-            {
-              /* No.. the packet was not processed now.  Return -EAGAIN so
-               * that the driver may retry again later.  We still need to
-               * set d_len to zero so that the driver is aware that there
-               * is nothing to be sent.
-               */
+  for (conn = can_filter_nextconn(NULL); conn != NULL;
+       conn = can_filter_nextconn(conn))
+    {
+      if ((conn->dev == NULL || dev == conn->dev) &&
+          can_filter_match(conn, id) &&
+          can_deliver(dev, conn, frame, buflen) == -EAGAIN)
+        {
+          ret = -EAGAIN;
+        }
+    }
+#else
+  UNUSED(id);
 
-               nwarn("WARNING: Packet not processed\n");
-               ret = -EAGAIN;
-            }
+  while ((conn = can_nextconn(conn)) != NULL)
+    {
+      if ((conn->dev == NULL || dev == conn->dev) &&
+          can_deliver(dev, conn, frame, buflen) == -EAGAIN)
+        {
+          ret = -EAGAIN;
         }
     }
-  while (conn);
+#endif
 
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: can_input
  *
@@ -124,7 +124,10 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
       case CAN_RAW_FILTER:
         if (value_len == 0)
           {
+            net_lock();
             conn->filter_count = 0;
+            can_filter_update(conn);
+            net_unlock();
             ret = OK;
           }
         else if (value_len % sizeof(struct can_filter) != 0)
@@ -140,12 +143,17 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
           {
             count = value_len / sizeof(struct can_filter);
 
+            net_lock();
+
             for (int i = 0; i < count; i++)
               {
                 conn->filters[i] = ((struct can_filter *)value)[i];
               }
 
             conn->filter_count = count;
+            can_filter_update(conn);
+
+            net_unlock();
 
             ret = OK;
           }
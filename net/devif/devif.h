@@ -604,6 +604,24 @@ int devif_loopback(FAR struct net_driver_s *dev);
 int netdev_input(FAR struct net_driver_s *dev,
                  devif_poll_callback_t callback, bool reply);
 
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Offer the received IPv4 packet in d_iob for TCP receive aggregation.
+ *   If the packet is taken, it is either appended to the TCP segment held
+ *   before it or held itself until netdev_gro_flush(); d_iob is then NULL
+ *   and the caller has nothing more to do.
+ *
+ * Returned Value:
+ *   True if the packet was taken.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GRO
+bool netdev_gro_receive(FAR struct net_driver_s *dev);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -90,6 +90,15 @@ int devif_loopback(FAR struct net_driver_s *dev)
        NETDEV_TXPACKETS(dev);
        NETDEV_RXPACKETS(dev);
 
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+      /* A checksum left to the hardware was never computed, but the packet
+       * did not leave memory either:  Take it as verified.
+       */
+
+      dev->d_csumflags = (dev->d_csumflags & NETDEV_CSUM_NEEDED) != 0 ?
+                         NETDEV_CSUM_VERIFIED : 0;
+#endif
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the tap */
 
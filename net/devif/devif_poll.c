@@ -910,9 +910,15 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   FAR uint8_t *buf;
   int bstop;
 
+  /* The packet buffer of the device is in use until the poll completes */
+
+  netdev_lock(dev);
+
   if (dev->d_buf == NULL)
     {
-      return devif_iob_poll(dev, callback);
+      bstop = devif_iob_poll(dev, callback);
+      netdev_unlock(dev);
+      return bstop;
     }
 
   buf = dev->d_buf;
@@ -976,6 +982,7 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 
   dev->d_buf = buf;
 
+  netdev_unlock(dev);
   return bstop;
 }
 
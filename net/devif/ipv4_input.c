@@ -449,6 +449,29 @@ drop:
   return OK;
 }
 
+/****************************************************************************
+ * Name: ipv4_gro_in
+ *
+ * Description:
+ *   Hold the packet for TCP receive aggregation, or process it now.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GRO
+static int ipv4_gro_in(FAR struct net_driver_s *dev)
+{
+  if (netdev_gro_receive(dev))
+    {
+      dev->d_len = 0;
+      return OK;
+    }
+
+  return ipv4_in(dev);
+}
+#else
+#  define ipv4_gro_in ipv4_in
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -478,6 +501,18 @@ int ipv4_input(FAR struct net_driver_s *dev)
   FAR uint8_t *buf;
   int ret;
 
+  /* Processing of the packet, and of any reply built in place, uses the
+   * packet buffer of the device.
+   */
+
+  netdev_lock(dev);
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* Any reply is built in place; it starts with nothing offloaded */
+
+  dev->d_csumflags &= ~NETDEV_CSUM_NEEDED;
+#endif
+
   if (dev->d_iob != NULL)
     {
       buf = dev->d_buf;
@@ -486,14 +521,17 @@ int ipv4_input(FAR struct net_driver_s *dev)
 
       dev->d_buf = &dev->d_iob->io_data[CONFIG_NET_LL_GUARDSIZE -
                                         NET_LL_HDRLEN(dev)];
-      ret = ipv4_in(dev);
+      ret = ipv4_gro_in(dev);
 
       dev->d_buf = buf;
-
-      return ret;
+    }
+  else
+    {
+      ret = netdev_input(dev, ipv4_gro_in, true);
     }
 
-  return netdev_input(dev, ipv4_in, true);
+  netdev_unlock(dev);
+  return ret;
 }
 
 #endif /* CONFIG_NET_IPv4 */
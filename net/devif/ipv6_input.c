@@ -46,6 +46,7 @@
 #include "sixlowpan/sixlowpan.h"
 #include "pkt/pkt.h"
 #include "icmpv6/icmpv6.h"
+#include "mld/mld.h"
 
 #include "netdev/netdev.h"
 #include "ipforward/ipforward.h"
@@ -349,6 +350,19 @@ static int ipv6_in(FAR struct net_driver_s *dev)
         }
 #endif
 
+#if defined(CONFIG_NET_MLD) && !defined(CONFIG_NET_MLD_ROUTER)
+      /* Beyond the link-local scope, only accept the groups joined on the
+       * device.  All the link-local groups are still accepted for the
+       * Neighbor Discovery.  A router must see the reports of all groups.
+       */
+
+      if ((NTOHS(ipv6->destipaddr[0]) & 0x000f) > 2 &&
+          mld_grpfind(dev, ipv6->destipaddr) == NULL)
+        {
+          goto drop;
+        }
+#endif
+
       /* Fall through with no further address checks and handle the multicast
        * address by its IPv6 nexthdr field.
        */
@@ -572,6 +586,18 @@ int ipv6_input(FAR struct net_driver_s *dev)
   FAR uint8_t *buf;
   int ret;
 
+  /* Processing of the packet, and of any reply built in place, uses the
+   * packet buffer of the device.
+   */
+
+  netdev_lock(dev);
+
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* Any reply is built in place; it starts with nothing offloaded */
+
+  dev->d_csumflags &= ~NETDEV_CSUM_NEEDED;
+#endif
+
   if (dev->d_iob != NULL)
     {
       buf = dev->d_buf;
@@ -583,10 +609,13 @@ int ipv6_input(FAR struct net_driver_s *dev)
       ret = ipv6_in(dev);
 
       dev->d_buf = buf;
-
-      return ret;
+    }
+  else
+    {
+      ret = netdev_input(dev, ipv6_in, true);
     }
 
-  return netdev_input(dev, ipv6_in, true);
+  netdev_unlock(dev);
+  return ret;
 }
 #endif /* CONFIG_NET_IPv6 */
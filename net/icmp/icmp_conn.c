@@ -127,6 +127,8 @@ FAR struct icmp_conn_s *icmp_alloc(void)
       conn = (FAR struct icmp_conn_s *)dq_remfirst(&g_free_icmp_connections);
       if (conn != NULL)
         {
+          nxrmutex_init(&conn->sconn.s_lock);
+
           /* Enqueue the connection into the active list */
 
           dq_addlast(&conn->sconn.node, &g_active_icmp_connections);
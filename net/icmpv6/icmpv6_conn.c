@@ -128,6 +128,8 @@ FAR struct icmpv6_conn_s *icmpv6_alloc(void)
              dq_remfirst(&g_free_icmpv6_connections);
       if (conn != NULL)
         {
+          nxrmutex_init(&conn->sconn.s_lock);
+
           /* Enqueue the connection into the active list */
 
           dq_addlast(&conn->sconn.node, &g_active_icmpv6_connections);
@@ -133,6 +133,7 @@ FAR struct ieee802154_conn_s *ieee802154_conn_alloc(void)
          dq_remfirst(&g_free_ieee802154_connections);
   if (conn)
     {
+      nxrmutex_init(&conn->sconn.s_lock);
       dq_addlast(&conn->sconn.node, &g_active_ieee802154_connections);
     }
 
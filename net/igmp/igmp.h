@@ -110,6 +110,9 @@
 struct igmp_group_s
 {
   struct igmp_group_s *next;    /* Implements a singly-linked list */
+#ifdef CONFIG_NET_IGMP_GRP_HASH
+  sq_entry_t           hnode;   /* Link in the group hash table */
+#endif
   struct work_s        work;    /* For deferred timeout operations */
   in_addr_t            grpaddr; /* Group IPv4 address */
   struct wdog_s        wdog;    /* WDOG used to detect timeouts */
@@ -203,6 +206,21 @@ FAR struct igmp_group_s *igmp_grpfind(FAR struct net_driver_s *dev,
 FAR struct igmp_group_s *igmp_grpallocfind(FAR struct net_driver_s *dev,
                                            FAR const in_addr_t *addr);
 
+/****************************************************************************
+ * Name:  igmp_grpmacused
+ *
+ * Description:
+ *   Check whether a group of another address maps to the same multicast
+ *   MAC address as addr, so that the MAC filter entry is shared.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool igmp_grpmacused(FAR struct net_driver_s *dev,
+                     FAR const in_addr_t *addr);
+
 /****************************************************************************
  * Name:  igmp_grpfree
  *
@@ -89,6 +89,50 @@
 #  define grpinfo   _none
 #endif
 
+/* The groups are hashed by the 23 bits of their address that make up the
+ * multicast MAC address, so that the groups sharing a MAC address share a
+ * bucket.
+ */
+
+#define IGMP_MACBITS(a)     (NTOHL(a) & 0x007fffff)
+
+#ifdef CONFIG_NET_IGMP_GRP_HASH
+#  if (CONFIG_NET_IGMP_GRP_HASHSIZE & (CONFIG_NET_IGMP_GRP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_IGMP_GRP_HASHSIZE must be a power of two
+#  endif
+
+#  define IGMP_HASH_MASK    (CONFIG_NET_IGMP_GRP_HASHSIZE - 1)
+#  define igmp_hash(a)      ((IGMP_MACBITS(a) ^ (IGMP_MACBITS(a) >> 8) ^ \
+                              (IGMP_MACBITS(a) >> 16)) & IGMP_HASH_MASK)
+#  define igmp_first(d, a)  igmp_hashgrp(g_igmp_hash[igmp_hash(a)].head)
+#  define igmp_next(g)      igmp_hashgrp((g)->hnode.flink)
+#else
+#  define igmp_first(d, a) \
+     ((FAR struct igmp_group_s *)(d)->d_igmp_grplist.head)
+#  define igmp_next(g)      ((g)->next)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IGMP_GRP_HASH
+/* The groups of all the devices hashed by address */
+
+static sq_queue_t g_igmp_hash[CONFIG_NET_IGMP_GRP_HASHSIZE];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IGMP_GRP_HASH
+static inline FAR struct igmp_group_s *igmp_hashgrp(FAR sq_entry_t *node)
+{
+  return node ? container_of(node, struct igmp_group_s, hnode) : NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -130,6 +174,9 @@ FAR struct igmp_group_s *igmp_grpalloc(FAR struct net_driver_s *dev,
       /* Add the group structure to the list in the device structure */
 
       sq_addfirst((FAR sq_entry_t *)group, &dev->d_igmp_grplist);
+#ifdef CONFIG_NET_IGMP_GRP_HASH
+      sq_addfirst(&group->hnode, &g_igmp_hash[igmp_hash(*addr)]);
+#endif
     }
 
   return group;
@@ -153,16 +200,14 @@ FAR struct igmp_group_s *igmp_grpfind(FAR struct net_driver_s *dev,
 
   grpinfo("Searching for addr %08x\n", (int)*addr);
 
-  for (group = (FAR struct igmp_group_s *)dev->d_igmp_grplist.head;
-       group;
-       group = group->next)
+  for (group = igmp_first(dev, *addr); group; group = igmp_next(group))
     {
       grpinfo("Compare: %08" PRIx32 " vs. %08" PRIx32 "\n",
               (uint32_t)group->grpaddr, (uint32_t)*addr);
-      if (net_ipv4addr_cmp(group->grpaddr, *addr))
+      if (net_ipv4addr_cmp(group->grpaddr, *addr) &&
+          group->ifindex == dev->d_ifindex)
         {
           grpinfo("Match!\n");
-          DEBUGASSERT(group->ifindex == dev->d_ifindex);
           break;
         }
     }
@@ -170,6 +215,36 @@ FAR struct igmp_group_s *igmp_grpfind(FAR struct net_driver_s *dev,
   return group;
 }
 
+/****************************************************************************
+ * Name:  igmp_grpmacused
+ *
+ * Description:
+ *   Check whether a group of another address maps to the same multicast
+ *   MAC address as addr, so that the MAC filter entry is shared.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool igmp_grpmacused(FAR struct net_driver_s *dev,
+                     FAR const in_addr_t *addr)
+{
+  FAR struct igmp_group_s *group;
+
+  for (group = igmp_first(dev, *addr); group; group = igmp_next(group))
+    {
+      if (group->ifindex == dev->d_ifindex &&
+          !net_ipv4addr_cmp(group->grpaddr, *addr) &&
+          IGMP_MACBITS(group->grpaddr) == IGMP_MACBITS(*addr))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name:  igmp_grpallocfind
  *
@@ -220,6 +295,9 @@ void igmp_grpfree(FAR struct net_driver_s *dev,
   /* Remove the group structure from the group list in the device structure */
 
   sq_rem((FAR sq_entry_t *)group, &dev->d_igmp_grplist);
+#ifdef CONFIG_NET_IGMP_GRP_HASH
+  sq_rem(&group->hnode, &g_igmp_hash[igmp_hash(group->grpaddr)]);
+#endif
 
   /* Destroy the wait semaphore */
 
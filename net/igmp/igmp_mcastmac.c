@@ -47,6 +47,7 @@
 #include <debug.h>
 #include <inttypes.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
@@ -85,6 +86,44 @@ static void igmp_mcastmac(FAR const in_addr_t *ip, FAR uint8_t *mac)
         (uint32_t)*ip, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 }
 
+/****************************************************************************
+ * Name:  igmp_macused
+ *
+ * Description:
+ *   Check whether the MAC filter entry of an IP address is shared by other
+ *   addresses:  Other groups, or the addresses that igmp_devinit() always
+ *   lets through.  Several addresses map to each multicast MAC address.
+ *
+ ****************************************************************************/
+
+static bool igmp_macused(FAR struct net_driver_s *dev,
+                         FAR const in_addr_t *ip)
+{
+  uint8_t mcastmac[6];
+  uint8_t mac[6];
+
+  if (igmp_grpmacused(dev, ip))
+    {
+      return true;
+    }
+
+  if (net_ipv4addr_cmp(*ip, g_ipv4_allsystems) ||
+      net_ipv4addr_cmp(*ip, g_ipv4_allrouters))
+    {
+      return false;
+    }
+
+  igmp_mcastmac(ip, mcastmac);
+  igmp_mcastmac(&g_ipv4_allsystems, mac);
+  if (memcmp(mac, mcastmac, sizeof(mac)) == 0)
+    {
+      return true;
+    }
+
+  igmp_mcastmac(&g_ipv4_allrouters, mac);
+  return memcmp(mac, mcastmac, sizeof(mac)) == 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -102,7 +141,7 @@ void igmp_addmcastmac(FAR struct net_driver_s *dev, FAR const in_addr_t *ip)
   uint8_t mcastmac[6];
 
   ninfo("Adding: IP %08" PRIx32 "\n", (uint32_t)*ip);
-  if (dev->d_addmac)
+  if (dev->d_addmac && !igmp_macused(dev, ip))
     {
       igmp_mcastmac(ip, mcastmac);
       dev->d_addmac(dev, mcastmac);
@@ -123,7 +162,7 @@ void igmp_removemcastmac(FAR struct net_driver_s *dev,
   uint8_t mcastmac[6];
 
   ninfo("Removing: IP %08" PRIx32 "\n", (uint32_t)*ip);
-  if (dev->d_rmmac)
+  if (dev->d_rmmac && !igmp_macused(dev, ip))
     {
       igmp_mcastmac(ip, mcastmac);
       dev->d_rmmac(dev, mcastmac);
@@ -679,6 +679,26 @@ static int inet_get_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING:  /* Reports the time stamping flags */
+        {
+          FAR struct udp_conn_s *udp = psock->s_conn;
+
+          if (*value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_DGRAM)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          *(FAR int *)value = udp->tsflags;
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
       case SO_KEEPALIVE:
         {
@@ -808,6 +828,33 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
         }
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING:  /* Time stamps the packets of a UDP socket */
+        {
+          int ret;
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_DGRAM)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          net_lock();
+          ret = udp_tstamp_setflags(psock->s_conn, *(FAR const int *)value);
+          net_unlock();
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_SOLINGER
       case SO_LINGER:
         {
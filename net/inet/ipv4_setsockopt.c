@@ -40,6 +40,106 @@
 
 #ifdef CONFIG_NET_IPv4
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_setsourcefilter
+ *
+ * Description:
+ *   Handle the source-specific multicast options of a UDP socket.  The
+ *   first source added to a group joins it on the interface; the group is
+ *   left when its last source is dropped.  The filters themselves are
+ *   applied locally, to the received datagrams.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IGMP_SOURCE_FILTER
+static int ipv4_setsourcefilter(FAR struct socket *psock, int option,
+                                FAR const void *value, socklen_t value_len)
+{
+  FAR const struct ip_mreq_source *mreq;
+  FAR struct net_driver_s *dev;
+  FAR struct udp_conn_s *conn;
+  in_addr_t group;
+  in_addr_t source;
+  int ret;
+
+  mreq = (FAR const struct ip_mreq_source *)value;
+  if (psock->s_type != SOCK_DGRAM || mreq == NULL ||
+      value_len < sizeof(struct ip_mreq_source) ||
+      !IN_MULTICAST(NTOHL(mreq->imr_multiaddr.s_addr)))
+    {
+      nerr("ERROR: Bad socket type, value or value_len\n");
+      return -EINVAL;
+    }
+
+  /* Use the default network device if imr_interface is INADDR_ANY */
+
+  if (mreq->imr_interface.s_addr == INADDR_ANY)
+    {
+      dev = netdev_default();
+    }
+  else
+    {
+      dev = netdev_findby_lipv4addr(mreq->imr_interface.s_addr);
+    }
+
+  if (dev == NULL)
+    {
+      nwarn("WARNING: Could not find device\n");
+      return -ENODEV;
+    }
+
+  conn   = psock->s_conn;
+  group  = mreq->imr_multiaddr.s_addr;
+  source = mreq->imr_sourceaddr.s_addr;
+
+  switch (option)
+    {
+      case IP_ADD_SOURCE_MEMBERSHIP:
+        ret = udp_msfilter_add(conn, group, source, MCAST_INCLUDE);
+        if (ret >= 0 && udp_msfilter_count(conn, group, MCAST_INCLUDE) == 1)
+          {
+            /* The group may already be joined, e.g. by another socket */
+
+            ret = igmp_joingroup(dev, &mreq->imr_multiaddr);
+            if (ret == -EEXIST)
+              {
+                ret = OK;
+              }
+            else if (ret < 0)
+              {
+                udp_msfilter_remove(conn, group, source, MCAST_INCLUDE);
+              }
+          }
+        break;
+
+      case IP_DROP_SOURCE_MEMBERSHIP:
+        ret = udp_msfilter_remove(conn, group, source, MCAST_INCLUDE);
+        if (ret >= 0 && udp_msfilter_count(conn, group, MCAST_INCLUDE) == 0)
+          {
+            igmp_leavegroup(dev, &mreq->imr_multiaddr);
+          }
+        break;
+
+      case IP_BLOCK_SOURCE:
+        ret = udp_msfilter_add(conn, group, source, MCAST_EXCLUDE);
+        break;
+
+      default: /* IP_UNBLOCK_SOURCE */
+        ret = udp_msfilter_remove(conn, group, source, MCAST_EXCLUDE);
+        break;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -174,6 +274,19 @@ int ipv4_setsockopt(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_IGMP_SOURCE_FILTER
+      case IP_ADD_SOURCE_MEMBERSHIP:  /* Join a multicast group; allow receive
+                                       * only from source */
+      case IP_DROP_SOURCE_MEMBERSHIP: /* Stop receiving data of a group from
+                                       * a source */
+      case IP_BLOCK_SOURCE:           /* Stop receiving multicast data from
+                                       * source */
+      case IP_UNBLOCK_SOURCE:         /* Unblock previously blocked multicast
+                                       * source */
+        ret = ipv4_setsourcefilter(psock, option, value, value_len);
+        break;
+#endif
+
 #if defined(CONFIG_NET_UDP) && !defined(CONFIG_NET_UDP_NO_STACK)
       case IP_MULTICAST_TTL:          /* Set/read the time-to-live value of
                                        * outgoing multicast packets */
@@ -241,6 +354,7 @@ int ipv4_setsockopt(FAR struct socket *psock, int option,
                                        * whether sent multicast packets
                                        * should be looped back to local
                                        * sockets. */
+#ifndef CONFIG_NET_IGMP_SOURCE_FILTER
       case IP_UNBLOCK_SOURCE:         /* Unblock previously blocked multicast
                                        * source */
       case IP_BLOCK_SOURCE:           /* Stop receiving multicast data from
@@ -250,6 +364,7 @@ int ipv4_setsockopt(FAR struct socket *psock, int option,
       case IP_DROP_SOURCE_MEMBERSHIP: /* Leave a source-specific group.  Stop
                                        * receiving data from a given multicast
                                        * group that come from a given source */
+#endif
       case IP_MULTICAST_ALL:          /* Modify the delivery policy of
                                        * multicast messages bound to
                                        * INADDR_ANY */
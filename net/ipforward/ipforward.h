@@ -30,6 +30,8 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <netinet/in.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -74,6 +76,23 @@ struct forward_s
 #endif
 };
 
+/* A cached forwarding decision for one IPv4 TCP or UDP flow */
+
+struct ipv4_nat_entry;   /* Forward reference */
+
+struct ipfwd_flow_s
+{
+  FAR struct net_driver_s     *fl_dev;        /* Forwarding device */
+#ifdef CONFIG_NET_NAT
+  FAR struct ipv4_nat_entry   *fl_natentry;   /* NAT entry, if translated */
+#endif
+  in_addr_t                    fl_srcipaddr;  /* Flow 5-tuple */
+  in_addr_t                    fl_destipaddr;
+  uint16_t                     fl_srcport;
+  uint16_t                     fl_destport;
+  uint8_t                      fl_proto;
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -366,5 +385,69 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ *
+ * Description:
+ *   Find the cached forwarding decision for the flow of an IPv4 packet.
+ *
+ * Input Parameters:
+ *   ipv4 - A pointer to the IPv4 header of the packet to be forwarded,
+ *          before any NAT translation.
+ *
+ * Returned Value:
+ *   The flow cache entry; NULL if the flow is not cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct ipfwd_flow_s *ipfwd_flow_lookup(FAR struct ipv4_hdr_s *ipv4);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_insert
+ *
+ * Description:
+ *   Remember the device on which the flow of an IPv4 packet is forwarded.
+ *
+ * Input Parameters:
+ *   ipv4   - A pointer to the IPv4 header of the packet to be forwarded,
+ *            before any NAT translation.
+ *   fwddev - The device on which the packet is forwarded.
+ *
+ * Returned Value:
+ *   The new flow cache entry; NULL if the flow cannot be cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct ipfwd_flow_s *ipfwd_flow_insert(FAR struct ipv4_hdr_s *ipv4,
+                                           FAR struct net_driver_s *fwddev);
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Forget all cached forwarding decisions.  This must be called whenever
+ *   a decision could change: when routes, device addresses or the up/down
+ *   state of devices change, when a device is unregistered and when a NAT
+ *   entry is deleted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flow_flush(void);
+#else
+#  define ipfwd_flow_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
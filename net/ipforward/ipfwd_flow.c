@@ -0,0 +1,201 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flow.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The TCP and UDP headers both start with the source and destination
+ * ports.
+ */
+
+#define FLOW_PORTS(ipv4) \
+  ((FAR uint8_t *)(ipv4) + (((ipv4)->vhl & IPv4_HLMASK) << 2))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The flow cache is direct-mapped: a new flow replaces the one that was
+ * using its slot.  An entry with no device is unused.
+ */
+
+static struct ipfwd_flow_s g_flows[CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flow_slot
+ *
+ * Description:
+ *   Return the cache slot of the flow of an IPv4 packet, or NULL if the
+ *   packet cannot be cached: only TCP and UDP packets that are not
+ *   fragments are, so that the ports are known.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfwd_flow_s *
+ipfwd_flow_slot(FAR struct ipv4_hdr_s *ipv4, FAR in_addr_t *srcipaddr,
+                FAR in_addr_t *destipaddr, FAR uint16_t *ports)
+{
+  uint32_t hash;
+
+  if ((ipv4->proto != IP_PROTO_TCP && ipv4->proto != IP_PROTO_UDP) ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+    {
+      return NULL;
+    }
+
+  *srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  *destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  memcpy(ports, FLOW_PORTS(ipv4), 2 * sizeof(uint16_t));
+
+  hash  = *srcipaddr ^ *destipaddr ^ ipv4->proto;
+  hash ^= ((uint32_t)ports[0] << 16) | ports[1];
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+
+  return &g_flows[hash % CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ *
+ * Description:
+ *   Find the cached forwarding decision for the flow of an IPv4 packet.
+ *
+ * Input Parameters:
+ *   ipv4 - A pointer to the IPv4 header of the packet to be forwarded,
+ *          before any NAT translation.
+ *
+ * Returned Value:
+ *   The flow cache entry; NULL if the flow is not cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipfwd_flow_s *ipfwd_flow_lookup(FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipfwd_flow_s *flow;
+  in_addr_t srcipaddr;
+  in_addr_t destipaddr;
+  uint16_t ports[2];
+
+  flow = ipfwd_flow_slot(ipv4, &srcipaddr, &destipaddr, ports);
+  if (flow == NULL || flow->fl_dev == NULL ||
+      flow->fl_srcipaddr != srcipaddr ||
+      flow->fl_destipaddr != destipaddr ||
+      flow->fl_srcport != ports[0] || flow->fl_destport != ports[1] ||
+      flow->fl_proto != ipv4->proto)
+    {
+      return NULL;
+    }
+
+  return flow;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_insert
+ *
+ * Description:
+ *   Remember the device on which the flow of an IPv4 packet is forwarded.
+ *
+ * Input Parameters:
+ *   ipv4   - A pointer to the IPv4 header of the packet to be forwarded,
+ *            before any NAT translation.
+ *   fwddev - The device on which the packet is forwarded.
+ *
+ * Returned Value:
+ *   The new flow cache entry; NULL if the flow cannot be cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipfwd_flow_s *ipfwd_flow_insert(FAR struct ipv4_hdr_s *ipv4,
+                                           FAR struct net_driver_s *fwddev)
+{
+  FAR struct ipfwd_flow_s *flow;
+  in_addr_t srcipaddr;
+  in_addr_t destipaddr;
+  uint16_t ports[2];
+
+  flow = ipfwd_flow_slot(ipv4, &srcipaddr, &destipaddr, ports);
+  if (flow != NULL)
+    {
+      memset(flow, 0, sizeof(struct ipfwd_flow_s));
+      flow->fl_dev        = fwddev;
+      flow->fl_srcipaddr  = srcipaddr;
+      flow->fl_destipaddr = destipaddr;
+      flow->fl_srcport    = ports[0];
+      flow->fl_destport   = ports[1];
+      flow->fl_proto      = ipv4->proto;
+    }
+
+  return flow;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Forget all cached forwarding decisions.  This must be called whenever
+ *   a decision could change: when routes, device addresses or the up/down
+ *   state of devices change, when a device is unregistered and when a NAT
+ *   entry is deleted.
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_flush(void)
+{
+  net_lock();
+  memset(g_flows, 0, sizeof(g_flows));
+  net_unlock();
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
@@ -196,6 +196,7 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
  *              contains the IPv4 packet.
  *   fwdddev  - The device on which the packet must be forwarded.
  *   ipv4     - A pointer to the IPv4 header in within the IPv4 packet
+ *   flow     - The flow cache entry of the packet, NULL if none.
  *
  * Returned Value:
  *   Zero is returned if the packet was successfully forward;  A negated
@@ -206,7 +207,8 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_dev_forward(FAR struct net_driver_s *dev,
                             FAR struct net_driver_s *fwddev,
-                            FAR struct ipv4_hdr_s *ipv4)
+                            FAR struct ipv4_hdr_s *ipv4,
+                            FAR struct ipfwd_flow_s *flow)
 {
   FAR struct forward_s *fwd = NULL;
 #ifdef CONFIG_DEBUG_NET_WARN
@@ -283,9 +285,21 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
     }
 
 #ifdef CONFIG_NET_NAT
-  /* Try NAT outbound, rule matching will be performed in NAT module. */
+  /* Try NAT outbound, rule matching will be performed in NAT module.  The
+   * NAT entry of a cached flow is reused.
+   */
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  if (flow != NULL)
+    {
+      ret = ipv4_nat_outbound_flow(fwd->f_dev, ipv4, &flow->fl_natentry);
+    }
+  else
+#endif
+    {
+      ret = ipv4_nat_outbound(fwd->f_dev, ipv4, NAT_MANIP_SRC);
+    }
 
-  ret = ipv4_nat_outbound(fwd->f_dev, ipv4, NAT_MANIP_SRC);
   if (ret < 0)
     {
       nwarn("WARNING: Performing NAT outbound failed, dropping!\n");
@@ -355,7 +369,7 @@ int ipv4_forward_callback(FAR struct net_driver_s *fwddev, FAR void *arg)
 
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, NULL);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
@@ -405,6 +419,7 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
+  FAR struct ipfwd_flow_s *flow = NULL;
   int ret;
 #ifdef CONFIG_NET_ICMP
   int icmp_reply_type;
@@ -416,7 +431,26 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
-  fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* The packets of a known flow go where the first one went */
+
+  flow = ipfwd_flow_lookup(ipv4);
+  if (flow != NULL)
+    {
+      fwddev = flow->fl_dev;
+    }
+  else
+#endif
+    {
+      fwddev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      if (fwddev != NULL && fwddev != dev)
+        {
+          flow = ipfwd_flow_insert(ipv4, fwddev);
+        }
+#endif
+    }
+
   if (fwddev == NULL)
     {
       nwarn("WARNING: Not routable\n");
@@ -432,7 +466,7 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
     {
       /* Send the packet asynchrously on the forwarding device. */
 
-      ret = ipv4_dev_forward(dev, fwddev, ipv4);
+      ret = ipv4_dev_forward(dev, fwddev, ipv4, flow);
       if (ret < 0)
         {
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
@@ -118,14 +118,12 @@ struct local_conn_s
   uint8_t lc_proto;              /* SOCK_STREAM or SOCK_DGRAM */
   uint8_t lc_type;               /* See enum local_type_e */
   uint8_t lc_state;              /* See enum local_state_e */
-  struct file lc_infile;         /* File for read-only FIFO (peers) */
-  struct file lc_outfile;        /* File descriptor of write-only FIFO (peers) */
+  struct file lc_infile;         /* Read-only FIFO (datagrams) */
+  struct file lc_outfile;        /* Write-only FIFO (datagrams) */
   char lc_path[UNIX_PATH_MAX];   /* Path assigned by bind() */
-  int32_t lc_instance_id;        /* Connection instance ID for stream
-                                  * server<->client connection pair */
-#ifdef CONFIG_NET_LOCAL_SCM
   FAR struct local_conn_s *
-                        lc_peer; /* Peer connection instance */
+                        lc_peer; /* Peer connection instance (streams) */
+#ifdef CONFIG_NET_LOCAL_SCM
   uint16_t lc_cfpcount;          /* Control file pointer counter */
   FAR struct file *
      lc_cfps[LOCAL_NCONTROLFDS]; /* Socket message control filep */
@@ -138,15 +136,23 @@ struct local_conn_s
   /* SOCK_STREAM fields common to both client and server */
 
   sem_t lc_waitsem;            /* Use to wait for a connection to be accepted */
-  sem_t lc_donesem;            /* Use to wait for client connected done */
   FAR struct socket *lc_psock; /* A reference to the socket structure */
 
+  /* A connected peer receives into a ring buffer of its own.  The peer
+   * writes directly into it, so no FIFO is needed for the connection.
+   */
+
+  FAR uint8_t *lc_rxbuf;       /* Receive ring buffer (peers) */
+  size_t lc_rxtail;            /* Offset of the oldest byte in lc_rxbuf */
+  size_t lc_rxlen;             /* Number of bytes in lc_rxbuf */
+  sem_t lc_rxsem;              /* Use to wait for data in lc_rxbuf */
+  sem_t lc_txsem;              /* Use to wait for space in the peer ring */
+
   /* The following is a list if poll structures of threads waiting for
    * socket events.
    */
 
   struct pollfd *lc_event_fds[LOCAL_NPOLLWAITERS];
-  struct pollfd lc_inout_fds[2*LOCAL_NPOLLWAITERS];
 
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
@@ -390,8 +396,10 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
 int local_send_packet(FAR struct file *filep, FAR const struct iovec *buf,
                       size_t len, bool preamble);
+#endif
 
 /****************************************************************************
  * Name: local_recvmsg
@@ -442,8 +450,10 @@ ssize_t local_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
 int local_fifo_read(FAR struct file *filep, FAR uint8_t *buf,
                     size_t *len, bool once);
+#endif
 
 /****************************************************************************
  * Name: local_getaddr
@@ -480,128 +490,173 @@ int local_getaddr(FAR struct local_conn_s *conn, FAR struct sockaddr *addr,
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
 int local_sync(FAR struct file *filep);
+#endif
 
 /****************************************************************************
- * Name: local_create_fifos
+ * Name: local_create_halfduplex
  *
  * Description:
- *   Create the FIFO pair needed for a SOCK_STREAM connection.
+ *   Create the half-duplex FIFO needed for SOCK_DGRAM communication.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_create_fifos(FAR struct local_conn_s *conn);
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_create_halfduplex(FAR struct local_conn_s *conn,
+                            FAR const char *path);
 #endif
 
 /****************************************************************************
- * Name: local_create_halfduplex
+ * Name: local_release_halfduplex
  *
  * Description:
- *   Create the half-duplex FIFO needed for SOCK_DGRAM communication.
+ *   Release a reference to the FIFO used for SOCK_DGRAM communication
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_DGRAM
-int local_create_halfduplex(FAR struct local_conn_s *conn,
-                            FAR const char *path);
+int local_release_halfduplex(FAR struct local_conn_s *conn);
 #endif
 
 /****************************************************************************
- * Name: local_release_fifos
+ * Name: local_open_receiver
  *
  * Description:
- *   Release references to the FIFO pair used for a SOCK_STREAM connection.
+ *   Only the receiving side of the half duplex FIFO.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_release_fifos(FAR struct local_conn_s *conn);
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_open_receiver(FAR struct local_conn_s *conn, bool nonblock);
 #endif
 
 /****************************************************************************
- * Name: local_release_halfduplex
+ * Name: local_open_sender
  *
  * Description:
- *   Release a reference to the FIFO used for SOCK_DGRAM communication
+ *   Only the sending side of the half duplex FIFO.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_DGRAM
-int local_release_halfduplex(FAR struct local_conn_s *conn);
+int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
+                      bool nonblock);
 #endif
 
 /****************************************************************************
- * Name: local_open_client_rx
+ * Name: local_ring_alloc
  *
  * Description:
- *   Only the client-side Rx FIFO.
+ *   Allocate the receive ring buffer of a SOCK_STREAM peer, or empty it if
+ *   it already exists.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the ring buffer cannot be allocated.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_rx(FAR struct local_conn_s *client, bool nonblock);
+int local_ring_alloc(FAR struct local_conn_s *conn);
 #endif
 
 /****************************************************************************
- * Name: local_open_client_tx
+ * Name: local_ring_free
  *
  * Description:
- *   Only the client-side Tx FIFO.
+ *   Disconnect a SOCK_STREAM peer and free its receive ring buffer.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_tx(FAR struct local_conn_s *client, bool nonblock);
+void local_ring_free(FAR struct local_conn_s *conn);
 #endif
 
 /****************************************************************************
- * Name: local_open_server_rx
+ * Name: local_ring_connect
  *
  * Description:
- *   Only the server-side Rx FIFO.
+ *   Connect two SOCK_STREAM peers whose receive ring buffers have been
+ *   allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_rx(FAR struct local_conn_s *server, bool nonblock);
+void local_ring_connect(FAR struct local_conn_s *conn1,
+                        FAR struct local_conn_s *conn2);
 #endif
 
 /****************************************************************************
- * Name: local_open_server_tx
+ * Name: local_ring_send
  *
  * Description:
- *   Only the server-side Tx FIFO.
+ *   Copy data into the receive ring buffer of the peer, waiting for space
+ *   unless 'nonblock' is set.
+ *
+ * Input Parameters:
+ *   conn     The sending peer
+ *   buf      Data to send
+ *   len      Number of entries in 'buf'
+ *   nonblock Do not wait for space
+ *
+ * Returned Value:
+ *   The number of bytes sent on success; a negated errno value on failure:
+ *   -EAGAIN if nothing can be sent without waiting and -EPIPE if the peer
+ *   has closed the connection.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_tx(FAR struct local_conn_s *server, bool nonblock);
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t len,
+                        bool nonblock);
 #endif
 
 /****************************************************************************
- * Name: local_open_receiver
+ * Name: local_ring_recv
  *
  * Description:
- *   Only the receiving side of the half duplex FIFO.
+ *   Copy data out of the receive ring buffer, waiting for data unless
+ *   'nonblock' is set.
+ *
+ * Input Parameters:
+ *   conn     The receiving peer
+ *   buf      Location to store the received data
+ *   len      Size of 'buf'
+ *   nonblock Do not wait for data
+ *
+ * Returned Value:
+ *   The number of bytes received on success, zero if the peer has closed
+ *   the connection and all of its data has been received; a negated errno
+ *   value on failure: -EAGAIN if there is no data to receive.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
-int local_open_receiver(FAR struct local_conn_s *conn, bool nonblock);
+#ifdef CONFIG_NET_LOCAL_STREAM
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, bool nonblock);
 #endif
 
 /****************************************************************************
- * Name: local_open_sender
+ * Name: local_ring_pollstate
  *
  * Description:
- *   Only the sending side of the half duplex FIFO.
+ *   Return the poll events that are currently set for a connected
+ *   SOCK_STREAM peer.
+ *
+ * Assumptions:
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
-int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
-                      bool nonblock);
+#ifdef CONFIG_NET_LOCAL_STREAM
+pollevent_t local_ring_pollstate(FAR struct local_conn_s *conn);
 #endif
 
 /****************************************************************************
@@ -647,16 +702,6 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
 
 int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
 
-/****************************************************************************
- * Name: local_generate_instance_id
- *
- * Description:
- *   Generate instance ID for stream
- *
- ****************************************************************************/
-
-int32_t local_generate_instance_id(void);
-
 #undef EXTERN
 #ifdef __cplusplus
 }
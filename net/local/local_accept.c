@@ -168,61 +168,27 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_type   = LOCAL_TYPE_PATHNAME;
               conn->lc_state  = LOCAL_STATE_CONNECTED;
               conn->lc_psock  = psock;
-#ifdef CONFIG_NET_LOCAL_SCM
-              conn->lc_peer   = client;
-              client->lc_peer = conn;
-#endif /* CONFIG_NET_LOCAL_SCM */
 
               strlcpy(conn->lc_path, client->lc_path, sizeof(conn->lc_path));
-              conn->lc_instance_id = client->lc_instance_id;
-
-              /* Open the server-side write-only FIFO.  This should not
-               * block.
-               */
-
-              ret = local_open_server_tx(conn, false);
-              if (ret < 0)
-                {
-                  nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-                     conn->lc_path, ret);
-                }
-            }
 
-          /* Do we have a connection?  Is the write-side FIFO opened? */
+              /* Allocate the ring buffer that the client will send into */
 
-          if (ret == OK)
-            {
-              DEBUGASSERT(conn->lc_outfile.f_inode != NULL);
-
-              /* Open the server-side read-only FIFO.  This should not
-               * block because the client side has already opening it
-               * for writing.
-               */
-
-              ret = local_open_server_rx(conn, false);
-              if (ret < 0)
-                {
-                   nerr("ERROR: Failed to open read-only FIFOs for %s: %d\n",
-                        conn->lc_path, ret);
-                }
+              ret = local_ring_alloc(conn);
             }
 
-          /* Do we have a connection?  Are the FIFOs opened? */
+          /* Return the address family */
 
-          if (ret == OK)
+          if (ret == OK && addr != NULL)
             {
-              DEBUGASSERT(conn->lc_infile.f_inode != NULL);
-
-              /* Return the address family */
-
-              if (addr != NULL)
-                {
-                  ret = local_getaddr(client, addr, addrlen);
-                }
+              ret = local_getaddr(client, addr, addrlen);
             }
 
           if (ret == OK)
             {
+              /* The peers now send directly into the ring of each other */
+
+              local_ring_connect(conn, client);
+
               /* Setup the client socket structure */
 
               newsock->s_domain = psock->s_domain;
@@ -230,24 +196,23 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               newsock->s_sockif = psock->s_sockif;
               newsock->s_conn   = (FAR void *)conn;
             }
+          else if (conn != NULL)
+            {
+              local_free(conn);
+            }
 
           /* Signal the client with the result of the connection */
 
           client->u.client.lc_result = ret;
           if (client->lc_state == LOCAL_STATE_CONNECTING)
             {
-              client->lc_state = LOCAL_STATE_CONNECTED;
+              client->lc_state = ret == OK ? LOCAL_STATE_CONNECTED :
+                                             LOCAL_STATE_BOUND;
               _SO_SETERRNO(client->lc_psock, ret);
               local_event_pollnotify(client, POLLOUT);
             }
 
           nxsem_post(&client->lc_waitsem);
-
-          if (ret == OK)
-            {
-              ret = net_lockedwait(&client->lc_donesem);
-            }
-
           return ret;
         }
 
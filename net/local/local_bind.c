@@ -93,7 +93,6 @@ int psock_local_bind(FAR struct socket *psock,
           /* Copy the path into the connection structure */
 
           strlcpy(conn->lc_path, unaddr->sun_path, sizeof(conn->lc_path));
-          conn->lc_instance_id = -1;
         }
     }
 
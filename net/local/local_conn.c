@@ -120,8 +120,8 @@ FAR struct local_conn_s *local_alloc(void)
 
 #ifdef CONFIG_NET_LOCAL_STREAM
       nxsem_init(&conn->lc_waitsem, 0, 0);
-      nxsem_init(&conn->lc_donesem, 0, 0);
-
+      nxsem_init(&conn->lc_rxsem, 0, 0);
+      nxsem_init(&conn->lc_txsem, 0, 0);
 #endif
 
       /* This semaphore is used for sending safely in multithread.
@@ -129,6 +129,7 @@ FAR struct local_conn_s *local_alloc(void)
        */
 
       nxmutex_init(&conn->lc_sendlock);
+      nxrmutex_init(&conn->lc_conn.s_lock);
 
 #ifdef CONFIG_NET_LOCAL_SCM
       conn->lc_cred.pid = getpid();
@@ -168,13 +169,11 @@ void local_free(FAR struct local_conn_s *conn)
   net_lock();
   dq_rem(&conn->lc_conn.node, &g_local_connections);
 
-#ifdef CONFIG_NET_LOCAL_SCM
-  if (local_peerconn(conn) && conn->lc_peer)
-    {
-      conn->lc_peer->lc_peer = NULL;
-      conn->lc_peer = NULL;
-    }
-#endif /* CONFIG_NET_LOCAL_SCM */
+#ifdef CONFIG_NET_LOCAL_STREAM
+  /* Disconnect from the peer and free the receive ring buffer */
+
+  local_ring_free(conn);
+#endif
 
   net_unlock();
 
@@ -209,16 +208,15 @@ void local_free(FAR struct local_conn_s *conn)
 #endif /* CONFIG_NET_LOCAL_SCM */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-  /* Destroy all FIFOs associted with the connection */
-
-  local_release_fifos(conn);
   nxsem_destroy(&conn->lc_waitsem);
-  nxsem_destroy(&conn->lc_donesem);
+  nxsem_destroy(&conn->lc_rxsem);
+  nxsem_destroy(&conn->lc_txsem);
 #endif
 
   /* Destory sem associated with the connection */
 
   nxmutex_destroy(&conn->lc_sendlock);
+  nxrmutex_destroy(&conn->lc_conn.s_lock);
 
   /* And free the connection structure */
 
@@ -85,36 +85,18 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
       return -ECONNREFUSED;
     }
 
-  /* Increment the number of pending server connection s */
-
-  server->u.server.lc_pending++;
-  DEBUGASSERT(server->u.server.lc_pending != 0);
-
-  /* Create the FIFOs needed for the connection */
+  /* Allocate the ring buffer that the server side will send into */
 
-  ret = local_create_fifos(client);
+  ret = local_ring_alloc(client);
   if (ret < 0)
     {
-      nerr("ERROR: Failed to create FIFOs for %s: %d\n",
-           client->lc_path, ret);
-
       return ret;
     }
 
-  /* Open the client-side write-only FIFO.  This should not block and should
-   * prevent the server-side from blocking as well.
-   */
-
-  ret = local_open_client_tx(client, nonblock);
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-           client->lc_path, ret);
-
-      goto errout_with_fifos;
-    }
+  /* Increment the number of pending server connection s */
 
-  DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+  server->u.server.lc_pending++;
+  DEBUGASSERT(server->u.server.lc_pending != 0);
 
   /* Set the busy "result" before giving the semaphore. */
 
@@ -131,87 +113,40 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
       nxsem_post(&server->lc_waitsem);
     }
 
-  /* Wait for the server to accept the connections */
+  /* A non-blocking connection completes when the server accepts it */
 
-  if (!nonblock)
+  if (nonblock)
     {
-      do
-        {
-          net_lockedwait_uninterruptible(&client->lc_waitsem);
-          ret = client->u.client.lc_result;
-        }
-      while (ret == -EBUSY);
-
-      /* Did we successfully connect? */
-
-      if (ret < 0)
-        {
-          nerr("ERROR: Failed to connect: %d\n", ret);
-          goto errout_with_outfd;
-        }
+      client->lc_state = LOCAL_STATE_CONNECTING;
+      return -EINPROGRESS;
     }
 
-  /* Yes.. open the read-only FIFO */
+  /* Wait for the server to accept the connections */
 
-  ret = local_open_client_rx(client, nonblock);
-  if (ret < 0)
+  do
     {
-      nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-           client->lc_path, ret);
-      goto errout_with_outfd;
+      net_lockedwait_uninterruptible(&client->lc_waitsem);
+      ret = client->u.client.lc_result;
     }
+  while (ret == -EBUSY);
 
-  DEBUGASSERT(client->lc_infile.f_inode != NULL);
+  /* Did we successfully connect? */
 
-  nxsem_post(&client->lc_donesem);
-
-  if (!nonblock)
+  if (ret < 0)
     {
-      client->lc_state = LOCAL_STATE_CONNECTED;
+      nerr("ERROR: Failed to connect: %d\n", ret);
+      client->lc_state = LOCAL_STATE_BOUND;
       return ret;
     }
 
-  client->lc_state = LOCAL_STATE_CONNECTING;
-  return -EINPROGRESS;
-
-errout_with_outfd:
-  file_close(&client->lc_outfile);
-  client->lc_outfile.f_inode = NULL;
-
-errout_with_fifos:
-  local_release_fifos(client);
-  client->lc_state = LOCAL_STATE_BOUND;
-  return ret;
+  client->lc_state = LOCAL_STATE_CONNECTED;
+  return OK;
 }
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: local_generate_instance_id
- *
- * Description:
- *   Generate instance ID for stream
- *
- ****************************************************************************/
-
-int32_t local_generate_instance_id(void)
-{
-  static int32_t g_next_instance_id = 0;
-  int32_t id;
-
-  /* Called from local_connect with net_lock held. */
-
-  id = g_next_instance_id++;
-  if (g_next_instance_id < 0)
-    {
-      g_next_instance_id = 0;
-    }
-
-  return id;
-}
-
 /****************************************************************************
  * Name: psock_local_connect
  *
@@ -293,7 +228,6 @@ int psock_local_connect(FAR struct socket *psock,
                 client->lc_proto = conn->lc_proto;
                 strlcpy(client->lc_path, unaddr->sun_path,
                         sizeof(client->lc_path));
-                client->lc_instance_id = local_generate_instance_id();
 
                 /* The client is now bound to an address */
 
@@ -23,7 +23,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
-#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_DGRAM)
 
 #include <sys/stat.h>
 #include <sys/ioctl.h>
@@ -44,8 +44,6 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define LOCAL_CS_SUFFIX    "CS"  /* Name of the client-to-server FIFO */
-#define LOCAL_SC_SUFFIX    "SC"  /* Name of the server-to-client FIFO */
 #define LOCAL_HD_SUFFIX    "HD"  /* Name of the half duplex datagram FIFO */
 #define LOCAL_SUFFIX_LEN   2
 
@@ -64,55 +62,13 @@
  ****************************************************************************/
 
 static void local_format_name(FAR const char *inpath, FAR char *outpath,
-                              FAR const char *suffix, int32_t id)
+                              FAR const char *suffix)
 {
-  if (id < 0)
-    {
-      snprintf(outpath, LOCAL_FULLPATH_LEN - 1,
-               CONFIG_NET_LOCAL_VFS_PATH "/%s%s", inpath, suffix);
-    }
-  else
-    {
-      snprintf(outpath, LOCAL_FULLPATH_LEN - 1,
-               CONFIG_NET_LOCAL_VFS_PATH "/%s%s%" PRIx32,
-               inpath, suffix, id);
-    }
-
+  snprintf(outpath, LOCAL_FULLPATH_LEN - 1,
+           CONFIG_NET_LOCAL_VFS_PATH "/%s%s", inpath, suffix);
   outpath[LOCAL_FULLPATH_LEN - 1] = '\0';
 }
 
-/****************************************************************************
- * Name: local_cs_name
- *
- * Description:
- *   Create the name of the client-to-server FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-static void local_cs_name(FAR struct local_conn_s *conn, FAR char *path)
-{
-  local_format_name(conn->lc_path, path,
-                    LOCAL_CS_SUFFIX, conn->lc_instance_id);
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_sc_name
- *
- * Description:
- *   Create the name of the server-to-client FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-static void local_sc_name(FAR struct local_conn_s *conn, FAR char *path)
-{
-  local_format_name(conn->lc_path, path,
-                    LOCAL_SC_SUFFIX, conn->lc_instance_id);
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
 /****************************************************************************
  * Name: local_hd_name
  *
@@ -121,12 +77,10 @@ static void local_sc_name(FAR struct local_conn_s *conn, FAR char *path)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
 static void local_hd_name(FAR const char *inpath, FAR char *outpath)
 {
-  local_format_name(inpath, outpath, LOCAL_HD_SUFFIX, -1);
+  local_format_name(inpath, outpath, LOCAL_HD_SUFFIX);
 }
-#endif /* CONFIG_NET_LOCAL_DGRAM */
 
 /****************************************************************************
  * Name: local_fifo_exists
@@ -188,43 +142,6 @@ static int local_create_fifo(FAR const char *path)
   return OK;
 }
 
-/****************************************************************************
- * Name: local_release_fifo
- *
- * Description:
- *   Release a reference from one of the FIFOs used in a connection.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM /* Currently not used by datagram code */
-static int local_release_fifo(FAR const char *path)
-{
-  int ret;
-
-  /* Unlink the client-to-server FIFO if it exists. */
-
-  if (local_fifo_exists(path))
-    {
-      /* Un-linking the FIFO removes the FIFO from the namespace.  It will
-       * also mark the FIFO device "unlinked".  When all of the open
-       * references to the FIFO device are closed, the resources consumed
-       * by the device instance will also be freed.
-       */
-
-      ret = nx_unlink(path);
-      if (ret < 0)
-        {
-          nerr("ERROR: Failed to unlink FIFO %s: %d\n", path, ret);
-          return ret;
-        }
-    }
-
-  /* The FIFO does not exist or we successfully unlinked it. */
-
-  return OK;
-}
-#endif
-
 /****************************************************************************
  * Name: local_rx_open
  *
@@ -323,36 +240,6 @@ static int local_set_policy(FAR struct file *filep, unsigned long policy)
  * Public Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: local_create_fifos
- *
- * Description:
- *   Create the FIFO pair needed for a SOCK_STREAM connection.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_create_fifos(FAR struct local_conn_s *conn)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Create the client-to-server FIFO if it does not already exist. */
-
-  local_cs_name(conn, path);
-  ret = local_create_fifo(path);
-  if (ret >= 0)
-    {
-      /* Create the server-to-client FIFO if it does not already exist. */
-
-      local_sc_name(conn, path);
-      ret = local_create_fifo(path);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
 /****************************************************************************
  * Name: local_create_halfduplex
  *
@@ -361,7 +248,6 @@ int local_create_fifos(FAR struct local_conn_s *conn)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
 int local_create_halfduplex(FAR struct local_conn_s *conn,
                             FAR const char *path)
 {
@@ -372,38 +258,6 @@ int local_create_halfduplex(FAR struct local_conn_s *conn,
   local_hd_name(path, fullpath);
   return local_create_fifo(fullpath);
 }
-#endif /* CONFIG_NET_LOCAL_DGRAM */
-
-/****************************************************************************
- * Name: local_release_fifos
- *
- * Description:
- *   Release references to the FIFO pair used for a SOCK_STREAM connection.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_release_fifos(FAR struct local_conn_s *conn)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret1;
-  int ret2;
-
-  /* Destroy the client-to-server FIFO if it exists. */
-
-  local_sc_name(conn, path);
-  ret1 = local_release_fifo(path);
-
-  /* Destroy the server-to-client FIFO if it exists. */
-
-  local_cs_name(conn, path);
-  ret2 = local_release_fifo(path);
-
-  /* Return a failure if one occurred. */
-
-  return ret1 < 0 ? ret1 : ret2;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
 
 /****************************************************************************
  * Name: local_release_halfduplex
@@ -413,7 +267,6 @@ int local_release_fifos(FAR struct local_conn_s *conn)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
 int local_release_halfduplex(FAR struct local_conn_s *conn)
 {
 #if 1
@@ -442,135 +295,6 @@ int local_release_halfduplex(FAR struct local_conn_s *conn)
   return local_release_fifo(path);
 #endif
 }
-#endif /* CONFIG_NET_LOCAL_DGRAM */
-
-/****************************************************************************
- * Name: local_open_client_rx
- *
- * Description:
- *   Open the client-side of the server-to-client FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_rx(FAR struct local_conn_s *client, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the server-to-client path name */
-
-  local_sc_name(client, path);
-
-  /* Then open the file for read-only access */
-
-  ret = local_rx_open(client, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&client->lc_infile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_open_client_tx
- *
- * Description:
- *   Open the client-side of the client-to-server FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_tx(FAR struct local_conn_s *client, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the client-to-server path name */
-
-  local_cs_name(client, path);
-
-  /* Then open the file for write-only access */
-
-  ret = local_tx_open(client, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&client->lc_outfile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_open_server_rx
- *
- * Description:
- *   Open the server-side of the client-to-server FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_rx(FAR struct local_conn_s *server, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the client-to-server path name */
-
-  local_cs_name(server, path);
-
-  /* Then open the file for write-only access */
-
-  ret = local_rx_open(server, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&server->lc_infile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_open_server_tx
- *
- * Description:
- *   Only the server-side of the server-to-client FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_tx(FAR struct local_conn_s *server, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the server-to-client path name */
-
-  local_sc_name(server, path);
-
-  /* Then open the file for read-only access */
-
-  ret = local_tx_open(server, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&server->lc_outfile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
 
 /****************************************************************************
  * Name: local_open_receiver
@@ -580,7 +304,6 @@ int local_open_server_tx(FAR struct local_conn_s *server, bool nonblock)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
 int local_open_receiver(FAR struct local_conn_s *conn, bool nonblock)
 {
   char path[LOCAL_FULLPATH_LEN];
@@ -602,7 +325,6 @@ int local_open_receiver(FAR struct local_conn_s *conn, bool nonblock)
 
   return ret;
 }
-#endif /* CONFIG_NET_LOCAL_DGRAM */
 
 /****************************************************************************
  * Name: local_open_sender
@@ -612,7 +334,6 @@ int local_open_receiver(FAR struct local_conn_s *conn, bool nonblock)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_DGRAM
 int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
                       bool nonblock)
 {
@@ -635,6 +356,5 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
 
   return ret;
 }
-#endif /* CONFIG_NET_LOCAL_DGRAM */
 
-#endif /* CONFIG_NET && CONFIG_NET_LOCAL */
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_DGRAM */
@@ -78,11 +78,25 @@ static int local_event_pollsetup(FAR struct local_conn_s *conn,
           goto errout;
         }
 
-      eventset = 0;
-      if (conn->lc_state == LOCAL_STATE_LISTENING &&
-          dq_peek(&conn->u.server.lc_waiters) != NULL)
+      switch (conn->lc_state)
         {
-          eventset |= POLLIN;
+          case LOCAL_STATE_LISTENING:
+            eventset = dq_peek(&conn->u.server.lc_waiters) != NULL ?
+                       POLLIN : 0;
+            break;
+
+          case LOCAL_STATE_ACCEPT:
+          case LOCAL_STATE_CONNECTING:
+            eventset = 0;
+            break;
+
+          case LOCAL_STATE_CONNECTED:
+            eventset = local_ring_pollstate(conn);
+            break;
+
+          default:
+            eventset = POLLERR;
+            break;
         }
 
       local_event_pollnotify(conn, eventset);
@@ -95,7 +109,6 @@ static int local_event_pollsetup(FAR struct local_conn_s *conn,
 
       if (!slot)
         {
-          ret = -EIO;
           goto errout;
         }
 
@@ -156,125 +169,10 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     }
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-  if ((conn->lc_state == LOCAL_STATE_LISTENING ||
-       conn->lc_state == LOCAL_STATE_CONNECTING) &&
-       conn->lc_type  == LOCAL_TYPE_PATHNAME)
-    {
-      return local_event_pollsetup(conn, fds, true);
-    }
-
-  if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
-    {
-      fds->priv = NULL;
-      goto pollerr;
-    }
-
-  switch (fds->events & (POLLIN | POLLOUT))
-    {
-      case (POLLIN | POLLOUT):
-        {
-          FAR struct pollfd *shadowfds;
-
-          /* Poll wants to check state for both input and output. */
-
-          if (conn->lc_infile.f_inode == NULL ||
-              conn->lc_outfile.f_inode == NULL)
-            {
-              fds->priv = NULL;
-              goto pollerr;
-            }
-
-          /* Find shadow pollfds. */
-
-          net_lock();
-
-          shadowfds = conn->lc_inout_fds;
-          while (shadowfds->fd != 0)
-            {
-              shadowfds += 2;
-              if (shadowfds >= &conn->lc_inout_fds[2*LOCAL_NPOLLWAITERS])
-                {
-                  net_unlock();
-                  return -ENOMEM;
-                }
-            }
-
-          shadowfds[0]         = *fds;
-          shadowfds[0].fd      = 1; /* Does not matter */
-          shadowfds[0].events &= ~POLLOUT;
-
-          shadowfds[1]         = *fds;
-          shadowfds[1].fd      = 0; /* Does not matter */
-          shadowfds[1].events &= ~POLLIN;
-
-          net_unlock();
-
-          /* Setup poll for both shadow pollfds. */
-
-          ret = file_poll(&conn->lc_infile, &shadowfds[0], true);
-          if (ret >= 0)
-            {
-              ret = file_poll(&conn->lc_outfile, &shadowfds[1], true);
-              if (ret < 0)
-                {
-                  file_poll(&conn->lc_infile, &shadowfds[0], false);
-                }
-            }
-
-          if (ret < 0)
-            {
-              shadowfds[0].fd = 0;
-              fds->priv = NULL;
-              goto pollerr;
-            }
-          else
-            {
-              fds->priv = shadowfds;
-            }
-        }
-        break;
-
-      case POLLIN:
-        {
-          /* Poll wants to check state for input only. */
-
-          if (conn->lc_infile.f_inode == NULL)
-            {
-              fds->priv = NULL;
-              goto pollerr;
-            }
-
-          ret = file_poll(&conn->lc_infile, fds, true);
-        }
-        break;
-
-      case POLLOUT:
-        {
-          /* Poll wants to check state for output only. */
-
-          if (conn->lc_outfile.f_inode == NULL)
-            {
-              fds->priv = NULL;
-              goto pollerr;
-            }
-
-          ret = file_poll(&conn->lc_outfile, fds, true);
-        }
-        break;
-
-      default:
-        ret = OK;
-        break;
-    }
+  ret = local_event_pollsetup(conn, fds, true);
 #endif
 
   return ret;
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-pollerr:
-  poll_notify(&fds, 1, POLLERR);
-  return OK;
-#endif
 }
 
 /****************************************************************************
@@ -306,70 +204,7 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
     }
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-  if ((conn->lc_state == LOCAL_STATE_LISTENING ||
-       conn->lc_state == LOCAL_STATE_CONNECTING) &&
-       conn->lc_type  == LOCAL_TYPE_PATHNAME)
-    {
-      return local_event_pollsetup(conn, fds, false);
-    }
-
-  if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
-    {
-      return OK;
-    }
-
-  switch (fds->events & (POLLIN | POLLOUT))
-    {
-      case (POLLIN | POLLOUT):
-        {
-          FAR struct pollfd *shadowfds = fds->priv;
-          int ret2;
-
-          if (shadowfds == NULL)
-            {
-              return OK;
-            }
-
-          /* Teardown for both shadow pollfds. */
-
-          ret = file_poll(&conn->lc_infile, &shadowfds[0], false);
-          ret2 = file_poll(&conn->lc_outfile, &shadowfds[1], false);
-          if (ret2 < 0)
-            {
-              ret = ret2;
-            }
-
-          fds->revents |= shadowfds[0].revents | shadowfds[1].revents;
-          fds->priv = NULL;
-          shadowfds[0].fd = 0;
-        }
-        break;
-
-      case POLLIN:
-        {
-          if (fds->priv == NULL)
-            {
-              return OK;
-            }
-
-          ret = file_poll(&conn->lc_infile, fds, false);
-        }
-        break;
-
-      case POLLOUT:
-        {
-          if (fds->priv == NULL)
-            {
-              return OK;
-            }
-
-          ret = file_poll(&conn->lc_outfile, fds, false);
-        }
-        break;
-
-      default:
-        break;
-    }
+  ret = local_event_pollsetup(conn, fds, false);
 #endif
 
   return ret;
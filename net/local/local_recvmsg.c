@@ -52,6 +52,7 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
 /****************************************************************************
  * Name: psock_fifo_read
  *
@@ -107,6 +108,8 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
   return OK;
 }
 
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
 /****************************************************************************
  * Name: local_recvctl
  *
@@ -140,7 +143,11 @@ static void local_recvctl(FAR struct local_conn_s *conn,
       goto out;
     }
 
-  if (conn->lc_peer == NULL)
+  /* The file descriptors sent on a stream are already queued on this end,
+   * but datagrams leave them on the sender.
+   */
+
+  if (conn->lc_proto == SOCK_DGRAM)
     {
       peer = local_peerconn(conn);
       if (peer == NULL)
@@ -180,7 +187,7 @@ static void local_recvctl(FAR struct local_conn_s *conn,
     {
       if (peer->lc_cfpcount)
         {
-          memmove(peer->lc_cfps[0], peer->lc_cfps[i],
+          memmove(&peer->lc_cfps[0], &peer->lc_cfps[i],
                   sizeof(FAR void *) * peer->lc_cfpcount);
         }
 
@@ -223,7 +230,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       FAR socklen_t *fromlen)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
-  size_t readlen = len;
+  ssize_t nread;
   int ret;
 
   /* Verify that this is a connected peer socket */
@@ -239,16 +246,18 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
-  /* The incoming FIFO should be open */
+  /* The receive ring buffer should be allocated */
 
-  DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+  DEBUGASSERT(conn->lc_rxbuf != NULL);
 
-  /* Read the packet */
+  /* Read the data that the peer sent into the ring */
 
-  ret = psock_fifo_read(psock, buf, &readlen, true);
-  if (ret < 0)
+  nread = local_ring_recv(conn, buf, len,
+                          _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                          (flags & MSG_DONTWAIT) != 0);
+  if (nread < 0)
     {
-      return ret;
+      return nread;
     }
 
   /* Return the address family */
@@ -262,7 +271,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         }
     }
 
-  return readlen;
+  return nread;
 }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
@@ -42,6 +42,7 @@
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
 /****************************************************************************
  * Name: local_fifo_read
  *
@@ -151,6 +152,8 @@ int local_sync(FAR struct file *filep)
   return ret < 0 ? ret : pktlen;
 }
 
+#endif /* CONFIG_NET_LOCAL_DGRAM */
+
 /****************************************************************************
  * Name: local_getaddr
  *
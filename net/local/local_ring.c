@@ -0,0 +1,336 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_STREAM)
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+#include <poll.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCAL_RING_SIZE  CONFIG_NET_LOCAL_RING_SIZE
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_wake
+ *
+ * Description:
+ *   Wake up all of the threads waiting on a ring buffer semaphore.  They
+ *   check the state of the ring buffer again when they run.
+ *
+ ****************************************************************************/
+
+static void local_ring_wake(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_get_value(sem, &sval) >= 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_write
+ *
+ * Description:
+ *   Copy as much as fits of 'len' bytes into the receive ring buffer of
+ *   'conn' and return the number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t local_ring_write(FAR struct local_conn_s *conn,
+                               FAR const uint8_t *buf, size_t len)
+{
+  size_t head;
+  size_t ncopy;
+  size_t nchunk;
+
+  ncopy = MIN(len, LOCAL_RING_SIZE - conn->lc_rxlen);
+  head  = (conn->lc_rxtail + conn->lc_rxlen) % LOCAL_RING_SIZE;
+
+  /* The free space may wrap around the end of the buffer */
+
+  nchunk = MIN(ncopy, LOCAL_RING_SIZE - head);
+  memcpy(&conn->lc_rxbuf[head], buf, nchunk);
+  memcpy(conn->lc_rxbuf, buf + nchunk, ncopy - nchunk);
+
+  conn->lc_rxlen += ncopy;
+  return ncopy;
+}
+
+/****************************************************************************
+ * Name: local_ring_read
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the receive ring buffer of 'conn' and
+ *   return the number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t local_ring_read(FAR struct local_conn_s *conn,
+                              FAR uint8_t *buf, size_t len)
+{
+  size_t ncopy;
+  size_t nchunk;
+
+  ncopy  = MIN(len, conn->lc_rxlen);
+  nchunk = MIN(ncopy, LOCAL_RING_SIZE - conn->lc_rxtail);
+  memcpy(buf, &conn->lc_rxbuf[conn->lc_rxtail], nchunk);
+  memcpy(buf + nchunk, conn->lc_rxbuf, ncopy - nchunk);
+
+  conn->lc_rxtail = (conn->lc_rxtail + ncopy) % LOCAL_RING_SIZE;
+  conn->lc_rxlen -= ncopy;
+  return ncopy;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *conn)
+{
+  if (conn->lc_rxbuf == NULL)
+    {
+      conn->lc_rxbuf = kmm_malloc(LOCAL_RING_SIZE);
+      if (conn->lc_rxbuf == NULL)
+        {
+          nerr("ERROR: Failed to allocate the receive ring\n");
+          return -ENOMEM;
+        }
+    }
+
+  conn->lc_rxtail = 0;
+  conn->lc_rxlen  = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_free
+ ****************************************************************************/
+
+void local_ring_free(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  /* The peer may still receive what was sent to it, then end of file */
+
+  if (peer != NULL)
+    {
+      peer->lc_peer = NULL;
+      conn->lc_peer = NULL;
+
+      local_ring_wake(&peer->lc_rxsem);
+      local_ring_wake(&peer->lc_txsem);
+      local_event_pollnotify(peer, POLLIN | POLLHUP);
+    }
+
+  if (conn->lc_rxbuf != NULL)
+    {
+      kmm_free(conn->lc_rxbuf);
+      conn->lc_rxbuf = NULL;
+      conn->lc_rxlen = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_connect
+ ****************************************************************************/
+
+void local_ring_connect(FAR struct local_conn_s *conn1,
+                        FAR struct local_conn_s *conn2)
+{
+  DEBUGASSERT(conn1->lc_rxbuf != NULL && conn2->lc_rxbuf != NULL);
+
+  conn1->lc_peer = conn2;
+  conn2->lc_peer = conn1;
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t len,
+                        bool nonblock)
+{
+  FAR const struct iovec *end = buf + len;
+  FAR struct local_conn_s *peer;
+  ssize_t nsent = 0;
+  size_t offset = 0;
+  size_t ncopy;
+  int ret = OK;
+
+  net_lock();
+
+  while (buf != end)
+    {
+      peer = conn->lc_peer;
+      if (peer == NULL)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      /* Copy what fits of the current vector into the ring of the peer */
+
+      ncopy = local_ring_write(peer, (FAR const uint8_t *)buf->iov_base +
+                               offset, buf->iov_len - offset);
+      if (ncopy > 0)
+        {
+          nsent  += ncopy;
+          offset += ncopy;
+
+          local_ring_wake(&peer->lc_rxsem);
+          local_event_pollnotify(peer, POLLIN);
+        }
+
+      if (offset == buf->iov_len)
+        {
+          buf++;
+          offset = 0;
+          continue;
+        }
+
+      /* The ring of the peer is full */
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = net_lockedwait(&conn->lc_txsem);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+  return nsent > 0 ? nsent : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, bool nonblock)
+{
+  size_t nread;
+  int ret;
+
+  net_lock();
+
+  while (conn->lc_rxlen == 0)
+    {
+      /* End of file once the peer is gone */
+
+      if (conn->lc_peer == NULL)
+        {
+          net_unlock();
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          net_unlock();
+          return -EAGAIN;
+        }
+
+      ret = net_lockedwait(&conn->lc_rxsem);
+      if (ret < 0)
+        {
+          net_unlock();
+          return ret;
+        }
+    }
+
+  nread = local_ring_read(conn, buf, len);
+
+  /* Let the peer send more */
+
+  if (nread > 0 && conn->lc_peer != NULL)
+    {
+      local_ring_wake(&conn->lc_peer->lc_txsem);
+      local_event_pollnotify(conn->lc_peer, POLLOUT);
+    }
+
+  net_unlock();
+  return nread;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollstate
+ ****************************************************************************/
+
+pollevent_t local_ring_pollstate(FAR struct local_conn_s *conn)
+{
+  pollevent_t eventset = 0;
+
+  if (conn->lc_rxlen > 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (conn->lc_peer == NULL)
+    {
+      eventset |= POLLIN | POLLHUP;
+    }
+  else if (conn->lc_peer->lc_rxlen < LOCAL_RING_SIZE)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_STREAM */
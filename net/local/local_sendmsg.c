@@ -72,9 +72,17 @@ static int local_sendctl(FAR struct local_conn_s *conn,
 
   net_lock();
 
+  /* The file descriptors are queued directly on the connected peer */
+
   peer = conn->lc_peer;
   if (peer == NULL)
     {
+      if (conn->lc_proto == SOCK_STREAM)
+        {
+          net_unlock();
+          return -ENOTCONN;
+        }
+
       peer = conn;
     }
 
@@ -178,12 +186,9 @@ static ssize_t local_send(FAR struct socket *psock,
           DEBUGASSERT(psock && psock->s_conn && buf);
           peer = (FAR struct local_conn_s *)psock->s_conn;
 
-          /* Verify that this is a connected peer socket and that it has
-           * opened the outgoing FIFO for write-only access.
-           */
+          /* Verify that this is a connected peer socket */
 
-          if (peer->lc_state != LOCAL_STATE_CONNECTED ||
-              peer->lc_outfile.f_inode == NULL)
+          if (peer->lc_state != LOCAL_STATE_CONNECTED)
             {
               if (peer->lc_state == LOCAL_STATE_CONNECTING)
                 {
@@ -204,7 +209,9 @@ static ssize_t local_send(FAR struct socket *psock,
               return ret;
             }
 
-          ret = local_send_packet(&peer->lc_outfile, buf, len, false);
+          ret = local_ring_send(peer, buf, len,
+                                _SS_ISNONBLOCK(peer->lc_conn.s_flags) ||
+                                (flags & MSG_DONTWAIT) != 0);
           nxmutex_unlock(&peer->lc_sendlock);
         }
         break;
@@ -410,9 +417,11 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   FAR const struct iovec *buf = msg->msg_iov;
   socklen_t tolen = msg->msg_namelen;
   size_t len = msg->msg_iovlen;
+  ssize_t ret;
 #ifdef CONFIG_NET_LOCAL_SCM
   FAR struct local_conn_s *conn = psock->s_conn;
-  int count;
+  FAR struct local_conn_s *peer;
+  int count = 0;
 
   if (msg->msg_control &&
       msg->msg_controllen > sizeof(struct cmsghdr))
@@ -425,25 +434,30 @@ ssize_t local_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
     }
 #endif /* CONFIG_NET_LOCAL_SCM */
 
-  len = to ? local_sendto(psock, buf, len, flags, to, tolen) :
+  ret = to ? local_sendto(psock, buf, len, flags, to, tolen) :
              local_send(psock, buf, len, flags);
 #ifdef CONFIG_NET_LOCAL_SCM
-  if (len < 0 && count > 0)
+  if (ret < 0 && count > 0)
     {
       net_lock();
 
-      while (count-- > 0)
+      /* The descriptors were queued on the peer, unless it has closed the
+       * connection since and released them.
+       */
+
+      peer = conn->lc_proto == SOCK_STREAM ? conn->lc_peer : conn;
+      while (peer != NULL && count-- > 0 && peer->lc_cfpcount > 0)
         {
-          file_close(conn->lc_cfps[--conn->lc_cfpcount]);
-          kmm_free(conn->lc_cfps[conn->lc_cfpcount]);
-          conn->lc_cfps[conn->lc_cfpcount] = NULL;
+          file_close(peer->lc_cfps[--peer->lc_cfpcount]);
+          kmm_free(peer->lc_cfps[peer->lc_cfpcount]);
+          peer->lc_cfps[peer->lc_cfpcount] = NULL;
         }
 
       net_unlock();
     }
 #endif
 
-  return len;
+  return ret;
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL */
@@ -36,7 +36,7 @@
 
 #include "local/local.h"
 
-#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_DGRAM)
 
 /****************************************************************************
  * Private Functions
@@ -159,4 +159,4 @@ int local_send_packet(FAR struct file *filep, FAR const struct iovec *buf,
   return len16 > 0 ? len16 : ret;
 }
 
-#endif /* CONFIG_NET && CONFIG_NET_LOCAL */
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_DGRAM */
@@ -488,6 +488,11 @@ static int local_getsockopt(FAR struct socket *psock, int level, int option,
           return -EINVAL;
         }
 
+      if (conn->lc_peer == NULL)
+        {
+          return -ENOTCONN;
+        }
+
       memcpy(value, &conn->lc_peer->lc_cred, sizeof(struct ucred));
       return OK;
     }
@@ -801,45 +806,53 @@ static int local_close(FAR struct socket *psock)
 
 static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
 {
-  FAR struct local_conn_s *conn;
+#ifdef CONFIG_NET_LOCAL_STREAM
+  FAR struct local_conn_s *conn = psock->s_conn;
+#endif
   int ret = OK;
 
-  conn = (FAR struct local_conn_s *)psock->s_conn;
-
   switch (cmd)
     {
-      case FIONBIO:
-        if (conn->lc_infile.f_inode != NULL)
-          {
-            ret = file_ioctl(&conn->lc_infile, cmd, arg);
-          }
-
-        if (ret >= 0 && conn->lc_outfile.f_inode != NULL)
-          {
-            ret = file_ioctl(&conn->lc_outfile, cmd, arg);
-          }
-        break;
+#ifdef CONFIG_NET_LOCAL_STREAM
       case FIONREAD:
-        if (conn->lc_infile.f_inode != NULL)
+        net_lock();
+        if (conn->lc_state == LOCAL_STATE_CONNECTED)
           {
-            ret = file_ioctl(&conn->lc_infile, cmd, arg);
+            *(FAR int *)((uintptr_t)arg) = conn->lc_rxlen;
           }
         else
           {
             ret = -ENOTCONN;
           }
+
+        net_unlock();
         break;
+
       case FIONWRITE:
       case FIONSPACE:
-        if (conn->lc_outfile.f_inode != NULL)
+
+        /* What was sent and not yet received is in the ring of the peer */
+
+        net_lock();
+        if (conn->lc_peer != NULL)
           {
-            ret = file_ioctl(&conn->lc_outfile, cmd, arg);
+            *(FAR int *)((uintptr_t)arg) = cmd == FIONWRITE ?
+              conn->lc_peer->lc_rxlen :
+              CONFIG_NET_LOCAL_RING_SIZE - conn->lc_peer->lc_rxlen;
           }
         else
           {
             ret = -ENOTCONN;
           }
+
+        net_unlock();
         break;
+#endif /* CONFIG_NET_LOCAL_STREAM */
+
+      /* FIONBIO is handled by the socket layer: only the flags of the
+       * socket are checked when sending and receiving.
+       */
+
       default:
         ret = -ENOTTY;
         break;
@@ -864,7 +877,6 @@ static int local_socketpair(FAR struct socket *psocks[2])
 #if defined(CONFIG_NET_LOCAL_STREAM) || defined(CONFIG_NET_LOCAL_DGRAM)
   FAR struct local_conn_s *conns[2];
 #ifdef CONFIG_NET_LOCAL_STREAM
-  bool nonblock;
   int ret;
 #endif /* CONFIG_NET_LOCAL_STREAM */
   int i;
@@ -890,58 +902,24 @@ static int local_socketpair(FAR struct socket *psocks[2])
 #endif /* CONFIG_NET_LOCAL_DGRAM */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-  conns[0]->lc_instance_id = conns[1]->lc_instance_id
-                           = local_generate_instance_id();
+  /* Each end receives directly into its own ring buffer */
 
-  /* Create the FIFOs needed for the connection */
-
-  ret = local_create_fifos(conns[0]);
-  if (ret < 0)
-    {
-      goto errout;
-    }
-
-  nonblock = _SS_ISNONBLOCK(conns[0]->lc_conn.s_flags);
-
-  /* Open the client-side write-only FIFO. */
-
-  ret = local_open_client_tx(conns[0], nonblock);
-  if (ret < 0)
-    {
-      goto errout;
-    }
-
-  /* Open the server-side read-only FIFO. */
-
-  ret = local_open_server_rx(conns[1], nonblock);
-  if (ret < 0)
-    {
-      goto errout;
-    }
-
-  /* Open the server-side write-only FIFO. */
-
-  ret = local_open_server_tx(conns[1], nonblock);
-  if (ret < 0)
+  for (i = 0; i < 2; i++)
     {
-      goto errout;
+      ret = local_ring_alloc(conns[i]);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 
-  /* Open the client-side read-only FIFO */
-
-  ret = local_open_client_rx(conns[0], nonblock);
-  if (ret < 0)
-    {
-      goto errout;
-    }
+  net_lock();
+  local_ring_connect(conns[0], conns[1]);
+  net_unlock();
 
   conns[0]->lc_state = conns[1]->lc_state
                      = LOCAL_STATE_CONNECTED;
   return OK;
-
-errout:
-  local_release_fifos(conns[0]);
-  return ret;
 #endif /* CONFIG_NET_LOCAL_STREAM */
 #else
   return -EOPNOTSUPP;
@@ -189,6 +189,9 @@ enum mld_msgtype_e
 struct mld_group_s
 {
   struct mld_group_s *next;    /* Implements a singly-linked list */
+#ifdef CONFIG_NET_MLD_GRP_HASH
+  sq_entry_t          hnode;   /* Link in the group hash table */
+#endif
   net_ipv6addr_t      grpaddr; /* Group IPv6 address */
   struct work_s       work;    /* For deferred timeout operations */
   struct wdog_s       polldog; /* Timer used for periodic or delayed events */
@@ -318,6 +321,21 @@ FAR struct mld_group_s *mld_grpfind(FAR struct net_driver_s *dev,
 FAR struct mld_group_s *mld_grpallocfind(FAR struct net_driver_s *dev,
                                          FAR const net_ipv6addr_t addr);
 
+/****************************************************************************
+ * Name:  mld_grpmacused
+ *
+ * Description:
+ *   Check whether a group of another address maps to the same multicast
+ *   MAC address as addr, so that the MAC filter entry is shared.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool mld_grpmacused(FAR struct net_driver_s *dev,
+                    FAR const net_ipv6addr_t addr);
+
 /****************************************************************************
  * Name:  mld_grpfree
  *
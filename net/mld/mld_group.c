@@ -46,10 +46,54 @@
 
 #ifdef CONFIG_NET_MLD
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The groups are hashed by the low 32 bits of their address that make up
+ * the multicast MAC address, so that the groups sharing a MAC address share
+ * a bucket.
+ */
+
+#define MLD_MACBITS(a)      ((a)[6] ^ (a)[7])
+
+#ifdef CONFIG_NET_MLD_GRP_HASH
+#  if (CONFIG_NET_MLD_GRP_HASHSIZE & (CONFIG_NET_MLD_GRP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_MLD_GRP_HASHSIZE must be a power of two
+#  endif
+
+#  define MLD_HASH_MASK     (CONFIG_NET_MLD_GRP_HASHSIZE - 1)
+#  define mld_hash(a)       ((MLD_MACBITS(a) ^ (MLD_MACBITS(a) >> 8)) & \
+                             MLD_HASH_MASK)
+#  define mld_first(d, a)   mld_hashgrp(g_mld_hash[mld_hash(a)].head)
+#  define mld_next(g)       mld_hashgrp((g)->hnode.flink)
+#else
+#  define mld_first(d, a) \
+     ((FAR struct mld_group_s *)(d)->d_mld.grplist.head)
+#  define mld_next(g)       ((g)->next)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MLD_GRP_HASH
+/* The groups of all the devices hashed by address */
+
+static sq_queue_t g_mld_hash[CONFIG_NET_MLD_GRP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_MLD_GRP_HASH
+static inline FAR struct mld_group_s *mld_hashgrp(FAR sq_entry_t *node)
+{
+  return node ? container_of(node, struct mld_group_s, hnode) : NULL;
+}
+#endif
+
 /****************************************************************************
  * Name:  mld_ngroups
  *
@@ -132,6 +176,9 @@ FAR struct mld_group_s *mld_grpalloc(FAR struct net_driver_s *dev,
       /* Add the group structure to the list in the device structure */
 
       sq_addfirst((FAR sq_entry_t *)group, &dev->d_mld.grplist);
+#ifdef CONFIG_NET_MLD_GRP_HASH
+      sq_addfirst(&group->hnode, &g_mld_hash[mld_hash(addr)]);
+#endif
     }
 
   return group;
@@ -157,19 +204,17 @@ FAR struct mld_group_s *mld_grpfind(FAR struct net_driver_s *dev,
           addr[0], addr[1], addr[2], addr[3], addr[4], addr[5], addr[6],
           addr[7]);
 
-  for (group = (FAR struct mld_group_s *)dev->d_mld.grplist.head;
-       group;
-       group = group->next)
+  for (group = mld_first(dev, addr); group; group = mld_next(group))
     {
       mldinfo("Compare: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
               group->grpaddr[0], group->grpaddr[1], group->grpaddr[2],
               group->grpaddr[3], group->grpaddr[4], group->grpaddr[5],
               group->grpaddr[6], group->grpaddr[7]);
 
-      if (net_ipv6addr_cmp(group->grpaddr, addr))
+      if (net_ipv6addr_cmp(group->grpaddr, addr) &&
+          group->ifindex == dev->d_ifindex)
         {
           mldinfo("Match!\n");
-          DEBUGASSERT(group->ifindex == dev->d_ifindex);
           break;
         }
     }
@@ -177,6 +222,36 @@ FAR struct mld_group_s *mld_grpfind(FAR struct net_driver_s *dev,
   return group;
 }
 
+/****************************************************************************
+ * Name:  mld_grpmacused
+ *
+ * Description:
+ *   Check whether a group of another address maps to the same multicast
+ *   MAC address as addr, so that the MAC filter entry is shared.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool mld_grpmacused(FAR struct net_driver_s *dev,
+                    FAR const net_ipv6addr_t addr)
+{
+  FAR struct mld_group_s *group;
+
+  for (group = mld_first(dev, addr); group; group = mld_next(group))
+    {
+      if (group->ifindex == dev->d_ifindex &&
+          !net_ipv6addr_cmp(group->grpaddr, addr) &&
+          group->grpaddr[6] == addr[6] && group->grpaddr[7] == addr[7])
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name:  mld_grpallocfind
  *
@@ -223,6 +298,9 @@ void mld_grpfree(FAR struct net_driver_s *dev, FAR struct mld_group_s *group)
   /* Remove the group structure from the group list in the device structure */
 
   sq_rem((FAR sq_entry_t *)group, &dev->d_mld.grplist);
+#ifdef CONFIG_NET_MLD_GRP_HASH
+  sq_rem(&group->hnode, &g_mld_hash[mld_hash(group->grpaddr)]);
+#endif
 
   /* Destroy the wait semaphore */
 
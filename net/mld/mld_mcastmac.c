@@ -33,6 +33,7 @@
 #include <nuttx/net/mld.h>
 
 #include "devif/devif.h"
+#include "inet/inet.h"
 #include "mld/mld.h"
 
 #ifdef CONFIG_NET_MLD
@@ -74,6 +75,50 @@ static void mld_mcastmac(FAR const net_ipv6addr_t ipaddr, FAR uint8_t *mac)
           mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 }
 
+/****************************************************************************
+ * Name:  mld_macused
+ *
+ * Description:
+ *   Check whether the MAC filter entry of an IPv6 address is shared by
+ *   other addresses:  Other groups, or the addresses that mld_devinit()
+ *   always lets through.
+ *
+ ****************************************************************************/
+
+static bool mld_macused(FAR struct net_driver_s *dev,
+                        FAR const net_ipv6addr_t ipaddr)
+{
+  FAR const uint16_t *fixed[3];
+  int i;
+
+  if (mld_grpmacused(dev, ipaddr))
+    {
+      return true;
+    }
+
+  fixed[0] = g_ipv6_allnodes;
+  fixed[1] = g_ipv6_allrouters;
+  fixed[2] = g_ipv6_allmldv2routers;
+
+  for (i = 0; i < 3; i++)
+    {
+      if (net_ipv6addr_cmp(ipaddr, fixed[i]))
+        {
+          return false;
+        }
+    }
+
+  for (i = 0; i < 3; i++)
+    {
+      if (ipaddr[6] == fixed[i][6] && ipaddr[7] == fixed[i][7])
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -93,7 +138,7 @@ void mld_addmcastmac(FAR struct net_driver_s *dev,
 
   mldinfo("Adding MAC address filter\n");
 
-  if (dev->d_addmac != NULL)
+  if (dev->d_addmac != NULL && !mld_macused(dev, ipaddr))
     {
       mld_mcastmac(ipaddr, mcastmac);
       dev->d_addmac(dev, mcastmac);
@@ -115,7 +160,7 @@ void mld_removemcastmac(FAR struct net_driver_s *dev,
 
   mldinfo("Removing MAC address filter\n");
 
-  if (dev->d_rmmac != NULL)
+  if (dev->d_rmmac != NULL && !mld_macused(dev, ipaddr))
     {
       mld_mcastmac(ipaddr, mcastmac);
       dev->d_rmmac(dev, mcastmac);
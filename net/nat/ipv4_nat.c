@@ -656,6 +656,62 @@ ipv4_nat_outbound_internal(FAR struct net_driver_s *dev,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: ipv4_nat_outbound_rewrite
+ *
+ * Description:
+ *   Translate the local IP/Port of an outbound TCP or UDP packet to the
+ *   external IP/Port of a known NAT entry.
+ *
+ * Input Parameters:
+ *   dev   - The device to sent the packet (to get external IP).
+ *   ipv4  - Points to the IPv4 header to translate.
+ *   entry - The NAT entry of the packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+static void ipv4_nat_outbound_rewrite(FAR struct net_driver_s *dev,
+                                      FAR struct ipv4_hdr_s *ipv4,
+                                      FAR struct ipv4_nat_entry *entry)
+{
+  FAR uint16_t *l4chksum = NULL;
+  FAR uint16_t *local_port = NULL;
+
+  switch (ipv4->proto)
+    {
+#ifdef CONFIG_NET_TCP
+      case IP_PROTO_TCP:
+        {
+          FAR struct tcp_hdr_s *tcp = L4_HDR(ipv4);
+
+          l4chksum   = &tcp->tcpchksum;
+          local_port = &tcp->srcport;
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP
+      case IP_PROTO_UDP:
+        {
+          FAR struct udp_hdr_s *udp = L4_HDR(ipv4);
+
+          /* UDP checksum has special case 0 (no checksum) */
+
+          l4chksum   = udp->udpchksum != 0 ? &udp->udpchksum : NULL;
+          local_port = &udp->srcport;
+        }
+        break;
+#endif
+    }
+
+  DEBUGASSERT(local_port != NULL);
+
+  ipv4_nat_port_adjust(l4chksum, local_port, entry->external_port);
+  ipv4_nat_ip_adjust(ipv4, l4chksum, dev->d_ipaddr, NAT_MANIP_SRC);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -812,6 +868,58 @@ int ipv4_nat_outbound(FAR struct net_driver_s *dev,
   return OK;
 }
 
+/****************************************************************************
+ * Name: ipv4_nat_outbound_flow
+ *
+ * Description:
+ *   Perform NAT on an outbound forwarded packet of a cached flow, as
+ *   ipv4_nat_outbound() with NAT_MANIP_SRC does.  If the flow already has
+ *   a NAT entry, the packet is translated with it without searching the
+ *   NAT entry list; otherwise the entry used is remembered in the flow.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet will be sent.
+ *   ipv4  - Points to the IPv4 header to be filled into dev->d_buf later.
+ *   entry - The location of the NAT entry of the flow, NULL if none yet.
+ *
+ * Returned Value:
+ *   Zero is returned if NAT is successfully applied, or is not enabled for
+ *   this packet;
+ *   A negated errno value is returned if error occured.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+int ipv4_nat_outbound_flow(FAR struct net_driver_s *dev,
+                           FAR struct ipv4_hdr_s *ipv4,
+                           FAR struct ipv4_nat_entry **entry)
+{
+  if (!IFF_IS_NAT(dev->d_flags) ||
+      net_ipv4addr_hdrcmp(ipv4->srcipaddr, &dev->d_ipaddr) ||
+      net_ipv4addr_hdrcmp(ipv4->destipaddr, &dev->d_ipaddr))
+    {
+      return OK;
+    }
+
+  if (*entry != NULL)
+    {
+      ipv4_nat_entry_refresh(*entry);
+      ipv4_nat_outbound_rewrite(dev, ipv4, *entry);
+      return OK;
+    }
+
+  *entry = ipv4_nat_outbound_internal(dev, ipv4, NAT_MANIP_SRC);
+  if (*entry == NULL)
+    {
+      /* Outbound entry creation failed, should have entry. */
+
+      return -ENOMEM;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_nat_port_inuse
  *
@@ -31,6 +31,7 @@
 #include <nuttx/queue.h>
 
 #include "icmp/icmp.h"
+#include "ipforward/ipforward.h"
 #include "nat/nat.h"
 #include "tcp/tcp.h"
 #include "udp/udp.h"
@@ -209,7 +210,7 @@ static uint16_t ipv4_nat_select_port(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-static void ipv4_nat_entry_refresh(FAR struct ipv4_nat_entry *entry)
+void ipv4_nat_entry_refresh(FAR struct ipv4_nat_entry *entry)
 {
   switch (entry->protocol)
     {
@@ -302,6 +303,10 @@ void ipv4_nat_entry_delete(FAR struct ipv4_nat_entry *entry)
 
   dq_rem((FAR dq_entry_t *)entry, &g_entries);
   kmm_free(entry);
+
+  /* Cached flows may refer to the entry */
+
+  ipfwd_flow_flush();
 }
 
 /****************************************************************************
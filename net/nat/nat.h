@@ -170,6 +170,33 @@ int ipv4_nat_outbound(FAR struct net_driver_s *dev,
                       FAR struct ipv4_hdr_s *ipv4,
                       enum nat_manip_type_e manip_type);
 
+/****************************************************************************
+ * Name: ipv4_nat_outbound_flow
+ *
+ * Description:
+ *   Perform NAT on an outbound forwarded packet of a cached flow, as
+ *   ipv4_nat_outbound() with NAT_MANIP_SRC does.  If the flow already has
+ *   a NAT entry, the packet is translated with it without searching the
+ *   NAT entry list; otherwise the entry used is remembered in the flow.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet will be sent.
+ *   ipv4  - Points to the IPv4 header to be filled into dev->d_buf later.
+ *   entry - The location of the NAT entry of the flow, NULL if none yet.
+ *
+ * Returned Value:
+ *   Zero is returned if NAT is successfully applied, or is not enabled for
+ *   this packet;
+ *   A negated errno value is returned if error occured.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+int ipv4_nat_outbound_flow(FAR struct net_driver_s *dev,
+                           FAR struct ipv4_hdr_s *ipv4,
+                           FAR struct ipv4_nat_entry **entry);
+#endif
+
 /****************************************************************************
  * Name: ipv4_nat_port_inuse
  *
@@ -232,5 +259,18 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
                              in_addr_t local_ip, uint16_t local_port,
                              bool try_create);
 
+/****************************************************************************
+ * Name: ipv4_nat_entry_refresh
+ *
+ * Description:
+ *   Refresh a NAT entry, update its expiration time.
+ *
+ * Input Parameters:
+ *   entry      - The entry to refresh.
+ *
+ ****************************************************************************/
+
+void ipv4_nat_entry_refresh(FAR struct ipv4_nat_entry *entry);
+
 #endif /* CONFIG_NET_NAT && CONFIG_NET_IPv4 */
 #endif /* __NET_NAT_NAT_H */
@@ -30,6 +30,7 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/queue.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -37,6 +38,22 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The Neighbor table is indexed by a hash of the low 32 bits of the IPv6
+ * address, one bucket per entry.  Bucket heads and chain links hold an
+ * entry index plus one, zero ending the chain.
+ */
+
+#define NEIGHBOR_HASHSIZE CONFIG_NET_IPv6_NCONF_ENTRIES
+#define NEIGHBOR_HASH(ipaddr) \
+  (((((uint32_t)(ipaddr)[6] << 16 | (ipaddr)[7]) * 2654435761u) >> 16) % \
+   NEIGHBOR_HASHSIZE)
+#define NEIGHBOR_INDEX(link) \
+  ((int)((FAR dq_entry_t *)(link) - g_neighbor_link))
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -47,6 +64,19 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash index of the Neighbor table */
+
+extern uint16_t g_neighbor_hash[NEIGHBOR_HASHSIZE];
+extern uint16_t g_neighbor_next[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The entries handed out so far, least recently used first.  Entries are
+ * handed out from the start of the table until it is full.
+ */
+
+extern dq_entry_t g_neighbor_link[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern dq_queue_t g_neighbor_lru;
+extern int g_neighbor_nused;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -62,53 +62,72 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+  FAR uint16_t *link;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
-  int     i;
+  int ndx = -1;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
-   */
+  /* Find the matching entry */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (link = &g_neighbor_hash[NEIGHBOR_HASH(ipaddr)]; *link != 0;
+       link = &g_neighbor_next[*link - 1])
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      neighbor = &g_neighbors[*link - 1];
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
+          ndx = *link - 1;
           break;
         }
+    }
+
+  if (ndx < 0)
+    {
+      /* Use the first free entry or else the least recently used one,
+       * removing it from its hash bucket.
+       */
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      if (g_neighbor_nused < CONFIG_NET_IPv6_NCONF_ENTRIES)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          ndx = g_neighbor_nused++;
+          dq_addfirst(&g_neighbor_link[ndx], &g_neighbor_lru);
         }
+      else
+        {
+          ndx  = NEIGHBOR_INDEX(dq_peek(&g_neighbor_lru));
+          link = &g_neighbor_hash[NEIGHBOR_HASH(g_neighbors[ndx].ne_ipaddr)];
+
+          while (*link != ndx + 1)
+            {
+              link = &g_neighbor_next[*link - 1];
+            }
+
+          *link = g_neighbor_next[ndx];
+        }
+
+      g_neighbor_next[ndx] = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+      g_neighbor_hash[NEIGHBOR_HASH(ipaddr)] = ndx + 1;
     }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  /* Fill the entry and make it the most recently used one */
+
+  neighbor = &g_neighbors[ndx];
+  neighbor->ne_time = clock_systime_ticks();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  dq_rem(&g_neighbor_link[ndx], &g_neighbor_lru);
+  dq_addlast(&g_neighbor_link[ndx], &g_neighbor_lru);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -51,11 +51,12 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  uint16_t link;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (link = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)]; link != 0;
+       link = g_neighbor_next[link - 1])
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &g_neighbors[link - 1];
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
@@ -36,6 +36,17 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash index of the Neighbor table */
+
+uint16_t g_neighbor_hash[NEIGHBOR_HASHSIZE];
+uint16_t g_neighbor_next[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The entries handed out so far, least recently used first */
+
+dq_entry_t g_neighbor_link[CONFIG_NET_IPv6_NCONF_ENTRIES];
+dq_queue_t g_neighbor_lru;
+int g_neighbor_nused;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
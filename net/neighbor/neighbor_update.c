@@ -49,10 +49,15 @@
 void neighbor_update(const net_ipv6addr_t ipaddr)
 {
   struct neighbor_entry_s *neighbor;
+  int ndx;
 
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+      ndx = neighbor - g_neighbors;
       neighbor->ne_time = clock_systime_ticks();
+
+      dq_rem(&g_neighbor_link[ndx], &g_neighbor_lru);
+      dq_addlast(&g_neighbor_link[ndx], &g_neighbor_lru);
     }
 }
@@ -28,6 +28,7 @@
 #include <errno.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
@@ -57,17 +58,26 @@ FAR struct net_driver_s *netdev_findbyname(FAR const char *ifname)
 
   if (ifname)
     {
+#ifdef CONFIG_RCU
+      rcu_read_lock();
+#else
       net_lock();
-      for (dev = g_netdevices; dev; dev = dev->flink)
+#endif
+      for (dev = rcu_dereference(g_netdevices); dev;
+           dev = rcu_dereference(dev->flink))
         {
           if (strcmp(ifname, dev->d_ifname) == 0)
             {
-              net_unlock();
-              return dev;
+              break;
             }
         }
 
+#ifdef CONFIG_RCU
+      rcu_read_unlock();
+#else
       net_unlock();
+#endif
+      return dev;
     }
 
   return NULL;
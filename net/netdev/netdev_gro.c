@@ -0,0 +1,294 @@
+/****************************************************************************
+ * net/netdev/netdev_gro.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+
+#ifdef CONFIG_NET_TCP_GRO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define GRO_IPLEN(ipv4)   (((uint16_t)(ipv4)->len[0] << 8) | (ipv4)->len[1])
+#define GRO_TCPHDR(ipv4) \
+  ((FAR struct tcp_hdr_s *)((FAR uint8_t *)(ipv4) + IPv4_HDRLEN))
+#define GRO_HDRLEN(tcp)   (IPv4_HDRLEN + (((tcp)->tcpoffset >> 4) << 2))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gro_seqno
+ ****************************************************************************/
+
+static uint32_t gro_seqno(FAR const uint8_t *seqno)
+{
+  return ((uint32_t)seqno[0] << 24) | ((uint32_t)seqno[1] << 16) |
+         ((uint32_t)seqno[2] << 8) | seqno[3];
+}
+
+/****************************************************************************
+ * Name: gro_candidate
+ *
+ * Description:
+ *   True if the packet may take part in aggregation: an IPv4 TCP segment
+ *   for this device without IP options or fragmentation, carrying data
+ *   and no flags but ACK and PSH, with headers in the first IOB.
+ *
+ ****************************************************************************/
+
+static bool gro_candidate(FAR struct net_driver_s *dev,
+                          FAR struct iob_s *iob)
+{
+  FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(iob);
+  FAR struct tcp_hdr_s *tcp = GRO_TCPHDR(ipv4);
+  uint16_t hdrlen;
+
+  if (iob->io_len < IPv4_HDRLEN + TCP_HDRLEN || ipv4->vhl != 0x45 ||
+      ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+      !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                        dev->d_ipaddr))
+    {
+      return false;
+    }
+
+  hdrlen = GRO_HDRLEN(tcp);
+  return (tcp->tcpoffset >> 4) >= 5 && hdrlen <= iob->io_len &&
+         GRO_IPLEN(ipv4) == iob->io_pktlen &&
+         GRO_IPLEN(ipv4) > hdrlen &&
+         (tcp->flags & TCP_CTL & ~TCP_PSH) == TCP_ACK;
+}
+
+/****************************************************************************
+ * Name: gro_merge
+ *
+ * Description:
+ *   Append the payload of the segment 'iob' to the held segment 'head' if
+ *   it is the next in-order segment of the same connection with the same
+ *   acknowledgement, window and options.  Aggregation stops at a segment
+ *   with PSH.
+ *
+ ****************************************************************************/
+
+static bool gro_merge(FAR struct iob_s *head, FAR struct iob_s *iob)
+{
+  FAR struct ipv4_hdr_s *hipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(head);
+  FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(iob);
+  FAR struct tcp_hdr_s *htcp = GRO_TCPHDR(hipv4);
+  FAR struct tcp_hdr_s *tcp = GRO_TCPHDR(ipv4);
+  uint16_t hdrlen = GRO_HDRLEN(tcp);
+  uint32_t len = GRO_IPLEN(hipv4);
+
+  if ((htcp->flags & TCP_PSH) != 0 || GRO_HDRLEN(htcp) != hdrlen ||
+      memcmp(hipv4->srcipaddr, ipv4->srcipaddr, 8) != 0 ||
+      htcp->srcport != tcp->srcport || htcp->destport != tcp->destport ||
+      memcmp(htcp->ackno, tcp->ackno, 4) != 0 ||
+      memcmp(htcp->wnd, tcp->wnd, 2) != 0 ||
+      memcmp(htcp->optdata, tcp->optdata, hdrlen - IPv4_HDRLEN -
+             TCP_HDRLEN) != 0 ||
+      gro_seqno(htcp->seqno) + len - hdrlen != gro_seqno(tcp->seqno))
+    {
+      return false;
+    }
+
+  len += GRO_IPLEN(ipv4) - hdrlen;
+  if (len > UINT16_MAX)
+    {
+      return false;
+    }
+
+  /* Update the headers of the held segment.  Its TCP checksum is not
+   * valid anymore; it is marked as verified instead.
+   */
+
+  htcp->flags    |= tcp->flags;
+  hipv4->len[0]   = len >> 8;
+  hipv4->len[1]   = len & 0xff;
+  hipv4->ipchksum = 0;
+  hipv4->ipchksum = ~ipv4_chksum(hipv4);
+
+  iob_concat(head, iob_trimhead(iob, hdrlen));
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Offer the received IPv4 packet in d_iob for TCP receive aggregation.
+ *   If the packet is taken, it is either appended to the TCP segment held
+ *   before it or held itself until netdev_gro_flush(); d_iob is then NULL
+ *   and the caller has nothing more to do.
+ *
+ * Returned Value:
+ *   True if the packet was taken.
+ *
+ ****************************************************************************/
+
+bool netdev_gro_receive(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  uint8_t n = dev->d_gro_count;
+  bool verified;
+  bool candidate;
+
+  if ((dev->d_features & NETDEV_FEATURE_GRO) == 0 ||
+      dev->d_gro_flushing || iob == NULL)
+    {
+      return false;
+    }
+
+  verified  = netdev_rxcsum_verified(dev);
+  candidate = verified && gro_candidate(dev, iob);
+
+  if (candidate && n > 0 && (dev->d_gro_merge & (1 << (n - 1))) != 0 &&
+      gro_merge(dev->d_gro[n - 1], iob))
+    {
+      dev->d_iob = NULL;
+      return true;
+    }
+
+  /* Packets that cannot be aggregated are only held to keep them in
+   * order with those held before them.  If the driver did not flush in
+   * time, the packet is processed now, possibly out of order.
+   */
+
+  if ((n == 0 && !candidate) || n == CONFIG_NET_TCP_GRO_NPACKETS)
+    {
+      return false;
+    }
+
+  dev->d_gro[n] = iob;
+  if (candidate)
+    {
+      dev->d_gro_merge |= 1 << n;
+    }
+
+  if (verified)
+    {
+      dev->d_gro_verified |= 1 << n;
+    }
+
+  dev->d_gro_count = n + 1;
+  dev->d_iob = NULL;
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Process the IPv4 packets held for TCP receive aggregation.  A driver
+ *   that sets NETDEV_FEATURE_GRO must call this after each batch of
+ *   received packets, and at least every CONFIG_NET_TCP_GRO_NPACKETS
+ *   packets.  As with devif_poll(), the callback is invoked for each
+ *   reply, with the reply in d_buf and its length in d_len.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+int netdev_gro_flush(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback)
+{
+  uint16_t llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int offset = CONFIG_NET_LL_GUARDSIZE - llhdrlen;
+  FAR uint8_t *buf = dev->d_buf;
+  uint8_t i;
+
+  if (dev->d_gro_count == 0)
+    {
+      return OK;
+    }
+
+  netdev_lock(dev);
+  dev->d_gro_flushing = true;
+
+  for (i = 0; i < dev->d_gro_count; i++)
+    {
+      dev->d_iob    = dev->d_gro[i];
+      dev->d_gro[i] = NULL;
+      dev->d_buf    = buf;
+      dev->d_len    = dev->d_iob->io_pktlen;
+
+      dev->d_csumflags = (dev->d_gro_verified & (1 << i)) != 0 ?
+                         NETDEV_CSUM_VERIFIED : 0;
+
+      ipv4_input(dev);
+
+      if (dev->d_iob != NULL && dev->d_len > 0)
+        {
+          /* Hand the reply to the driver, in its flat buffer if it has
+           * one.
+           */
+
+          if (buf != NULL)
+            {
+              iob_copyout(buf + llhdrlen, dev->d_iob, dev->d_len, 0);
+              memcpy(buf, dev->d_iob->io_data + offset, llhdrlen);
+              dev->d_buf = buf;
+            }
+          else
+            {
+              dev->d_buf = dev->d_iob->io_data + offset;
+            }
+
+          callback(dev);
+        }
+
+      netdev_iob_release(dev);
+    }
+
+  dev->d_gro_count    = 0;
+  dev->d_gro_merge    = 0;
+  dev->d_gro_verified = 0;
+  dev->d_gro_flushing = false;
+
+  dev->d_buf = buf;
+  dev->d_len = 0;
+
+  netdev_unlock(dev);
+  return OK;
+}
+
+#endif /* CONFIG_NET_TCP_GRO */
@@ -77,6 +77,12 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
   dev->d_buf = &dev->d_iob->io_data[CONFIG_NET_LL_GUARDSIZE -
                                     NET_LL_HDRLEN(dev)];
 
+#ifdef CONFIG_NETDEV_CHECKSUM_OFFLOAD
+  /* Nothing has been left to the hardware in the new packet yet */
+
+  dev->d_csumflags &= ~NETDEV_CSUM_NEEDED;
+#endif
+
   /* Update l2 gruard size */
 
   iob_reserve(dev->d_iob, CONFIG_NET_LL_GUARDSIZE);
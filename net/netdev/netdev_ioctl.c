@@ -77,6 +77,7 @@
 #include "devif/devif.h"
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
+#include "ipforward/ipforward.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
 
@@ -146,6 +147,7 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
   in_addr_t target;
   in_addr_t netmask;
   in_addr_t router;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_dst;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -156,7 +158,9 @@ static int ioctl_add_ipv4route(FAR struct rtentry *rtentry)
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_gateway;
   router  = (in_addr_t)addr->sin_addr.s_addr;
 
-  return net_addroute_ipv4(target, netmask, router);
+  ret = net_addroute_ipv4(target, netmask, router);
+  ipfwd_flow_flush();
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -209,6 +213,7 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   FAR struct sockaddr_in *addr;
   in_addr_t target;
   in_addr_t netmask;
+  int ret;
 
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_dst;
   target  = (in_addr_t)addr->sin_addr.s_addr;
@@ -216,7 +221,9 @@ static int ioctl_del_ipv4route(FAR struct rtentry *rtentry)
   addr    = (FAR struct sockaddr_in *)&rtentry->rt_genmask;
   netmask = (in_addr_t)addr->sin_addr.s_addr;
 
-  return net_delroute_ipv4(target, netmask);
+  ret = net_delroute_ipv4(target, netmask);
+  ipfwd_flow_flush();
+  return ret;
 }
 #endif /* HAVE_WRITABLE_IPv4ROUTE */
 
@@ -840,6 +847,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFADDR:  /* Set IP address */
         ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+        ipfwd_flow_flush();
         break;
 
       case SIOCGIFDSTADDR:  /* Get P-to-P address */
@@ -848,6 +856,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFDSTADDR:  /* Set P-to-P address */
         ioctl_set_ipv4addr(&dev->d_draddr, &req->ifr_dstaddr);
+        ipfwd_flow_flush();
         break;
 
       case SIOCGIFBRDADDR:  /* Get broadcast IP address */
@@ -865,6 +874,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFNETMASK:  /* Set network mask */
         ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+        ipfwd_flow_flush();
         break;
 #endif
 
@@ -1811,6 +1821,7 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              ipfwd_flow_flush();
 
               /* Update the driver status */
 
@@ -1845,6 +1856,7 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
+              ipfwd_flow_flush();
 
               /* Update the driver status */
 
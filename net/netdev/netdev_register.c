@@ -38,6 +38,7 @@
 #include <nuttx/net/ethernet.h>
 #include <nuttx/net/bluetooth.h>
 #include <nuttx/net/can.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "igmp/igmp.h"
@@ -389,6 +390,8 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb_tail = NULL;
       dev->d_devcb = NULL;
 
+      nxrmutex_init(&dev->d_lock);
+
       /* We need exclusive access for the following operations */
 
       net_lock();
@@ -451,16 +454,6 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       snprintf(dev->d_ifname, IFNAMSIZ, devfmt, devnum);
 
-      /* Add the device to the list of known network devices */
-
-      last = &g_netdevices;
-      while (*last)
-        {
-          last = &((*last)->flink);
-        }
-
-      *last = dev;
-
       dev->flink = NULL;
 
 #ifdef CONFIG_NET_IGMP
@@ -475,6 +468,18 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       mld_devinit(dev);
 #endif
 
+      /* Add the device to the list of known network devices.  Publish it
+       * last:  netdev_findbyname() may find it without the network lock.
+       */
+
+      last = &g_netdevices;
+      while (*last)
+        {
+          last = &((*last)->flink);
+        }
+
+      rcu_assign_pointer(*last, dev);
+
       net_unlock();
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_DRIVERS_IEEE80211)
@@ -0,0 +1,264 @@
+/****************************************************************************
+ * net/netdev/netdev_rxfilter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/pkt.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_RXFILTER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxfilter_redirect
+ *
+ * Description:
+ *   Transmit the received frame on another device.  A frame held in an
+ *   IOB chain is handed over as is; a frame in a flat buffer is copied.
+ *
+ ****************************************************************************/
+
+static int netdev_rxfilter_redirect(FAR struct net_driver_s *dev,
+                                    FAR struct net_driver_s *to)
+{
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int len = dev->d_len;
+  FAR struct iob_s *iob;
+
+  if (to == NULL || to->d_xmit == NULL || !IFF_IS_UP(to->d_flags) ||
+      len < llhdrlen)
+    {
+      return -ENODEV;
+    }
+
+  if (dev->d_iob != NULL)
+    {
+      /* The link layer header is in the guard area, in front of the data:
+       * Only io_offset has to move to expose it.
+       */
+
+      iob = dev->d_iob;
+      netdev_iob_clear(dev);
+
+      iob_update_pktlen(iob, len - llhdrlen);
+      DEBUGASSERT(iob->io_offset >= llhdrlen);
+
+      iob->io_offset -= llhdrlen;
+      iob->io_len    += llhdrlen;
+      iob->io_pktlen += llhdrlen;
+    }
+  else
+    {
+      iob = iob_tryalloc(false);
+      if (iob == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      iob_reserve(iob, CONFIG_NET_LL_GUARDSIZE - llhdrlen);
+      if (iob_trycopyin(iob, dev->d_buf, len, 0, false) != len)
+        {
+          iob_free_chain(iob);
+          return -ENOMEM;
+        }
+    }
+
+  return to->d_xmit(to, iob);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxfilter_add
+ *
+ * Description:
+ *   Add an early receive filter to a device.
+ *
+ ****************************************************************************/
+
+int netdev_rxfilter_add(FAR struct net_driver_s *dev,
+                        FAR struct netdev_rxfilter_s *filter)
+{
+  FAR struct netdev_rxfilter_s **tail;
+
+  if (dev == NULL || filter == NULL || filter->classify == NULL)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+
+  for (tail = &dev->d_rxfilter; *tail != NULL; tail = &(*tail)->flink)
+    {
+      if (*tail == filter)
+        {
+          net_unlock();
+          return -EEXIST;
+        }
+    }
+
+  filter->flink = NULL;
+  *tail         = filter;
+
+  net_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_rxfilter_remove
+ *
+ * Description:
+ *   Remove a receive filter added with netdev_rxfilter_add().
+ *
+ ****************************************************************************/
+
+int netdev_rxfilter_remove(FAR struct net_driver_s *dev,
+                           FAR struct netdev_rxfilter_s *filter)
+{
+  FAR struct netdev_rxfilter_s **prev;
+  int ret = -ENOENT;
+
+  if (dev == NULL || filter == NULL)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+
+  for (prev = &dev->d_rxfilter; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == filter)
+        {
+          *prev = filter->flink;
+          ret   = OK;
+          break;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_rxfilter
+ *
+ * Description:
+ *   Run the receive filters of a device on the frame just received.
+ *
+ * Returned Value:
+ *   true if the frame has been consumed by a filter.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool netdev_rxfilter(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_rxfilter_s *filter = dev->d_rxfilter;
+  FAR const uint8_t *frame;
+  unsigned int llhdrlen;
+  unsigned int len;
+  int verdict = NETDEV_RX_PASS;
+
+  if (filter == NULL)
+    {
+      return false;
+    }
+
+  llhdrlen = NET_LL_HDRLEN(dev);
+  if (dev->d_iob != NULL)
+    {
+      frame = &dev->d_iob->io_data[CONFIG_NET_LL_GUARDSIZE - llhdrlen];
+      len   = MIN(dev->d_len, llhdrlen + dev->d_iob->io_len);
+    }
+  else
+    {
+      frame = dev->d_buf;
+      len   = dev->d_len;
+    }
+
+  for (; filter != NULL; filter = filter->flink)
+    {
+      verdict = filter->classify(filter, dev, frame, len);
+      if (verdict != NETDEV_RX_PASS)
+        {
+          break;
+        }
+    }
+
+  switch (verdict)
+    {
+      case NETDEV_RX_PASS:
+        return false;
+
+#ifdef CONFIG_NET_PKT
+      case NETDEV_RX_PKT:
+        pkt_input(dev);
+        break;
+#endif
+
+      case NETDEV_RX_REDIRECT:
+        if (netdev_rxfilter_redirect(dev, filter->redirect) >= 0)
+          {
+            break;
+          }
+
+        /* A frame that cannot be redirected is dropped */
+
+      default:
+        NETDEV_RXDROPPED(dev);
+        break;
+    }
+
+  /* The frame is consumed.  Of a flat buffer, only the length is reset. */
+
+  netdev_iob_release(dev);
+  dev->d_len = 0;
+  return true;
+}
+
+#endif /* CONFIG_NETDEV_RXFILTER */
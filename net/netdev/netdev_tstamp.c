@@ -0,0 +1,61 @@
+/****************************************************************************
+ * net/netdev/netdev_tstamp.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <assert.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_TIMESTAMPING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_txtstamp
+ ****************************************************************************/
+
+void netdev_txtstamp(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                     FAR const struct timespec *ts)
+{
+  DEBUGASSERT(dev != NULL && iob != NULL && ts != NULL);
+
+  if (iob->io_tskey != 0)
+    {
+      net_lock();
+      udp_txtstamp(iob->io_tskey, ts);
+      net_unlock();
+
+      iob->io_tskey = 0;
+    }
+}
+
+#endif /* CONFIG_NET_TIMESTAMPING */
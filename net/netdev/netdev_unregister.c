@@ -34,9 +34,11 @@
 #include <net/if.h>
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -112,6 +114,10 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 {
   struct net_driver_s *prev;
   struct net_driver_s *curr;
+#ifdef CONFIG_RCU
+  unsigned int count;
+  int blresult;
+#endif
 
   if (dev)
     {
@@ -141,15 +147,39 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 
               g_netdevices = curr->flink;
             }
-
-          curr->flink = NULL;
         }
 
+      /* Forget the flows that were forwarded on the device */
+
+      ipfwd_flow_flush();
+
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
       net_unlock();
 
+      /* Wait for the lockless readers that may still be on the device
+       * before it is detached from the list.  A reader may wait for the
+       * network lock, so a caller that still holds it must release it for
+       * the grace period.
+       */
+
+      if (curr)
+        {
+#ifdef CONFIG_RCU
+          blresult = net_breaklock(&count);
+          synchronize_rcu();
+          if (blresult >= 0)
+            {
+              net_restorelock(count);
+            }
+#endif
+
+          curr->flink = NULL;
+        }
+
+      nxrmutex_destroy(&dev->d_lock);
+
 #ifdef CONFIG_NET_ETHERNET
       ninfo("Unregistered MAC: %02x:%02x:%02x:%02x:%02x:%02x as dev: %s\n",
             dev->d_mac.ether.ether_addr_octet[0],
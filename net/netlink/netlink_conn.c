@@ -156,6 +156,8 @@ FAR struct netlink_conn_s *netlink_alloc(void)
            dq_remfirst(&g_free_netlink_connections);
   if (conn != NULL)
     {
+      nxrmutex_init(&conn->sconn.s_lock);
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_netlink_connections);
@@ -64,6 +64,18 @@ struct pkt_conn_s
   uint8_t    ifindex;
   uint16_t   proto;
   uint8_t    crefs;    /* Reference counts on this instance */
+
+#ifdef CONFIG_NET_PKT_RXRING
+  /* The memory-mapped receive ring of PACKET_RX_RING */
+
+  FAR uint8_t *ring;       /* The slots, shared with user space */
+  uint32_t   framesize;    /* The size of a slot */
+  uint32_t   nframes;      /* The number of slots */
+  uint32_t   head;         /* The next slot to be written */
+  uint32_t   packets;      /* Frames received, for PACKET_STATISTICS */
+  uint32_t   drops;        /* Frames dropped, the ring being full */
+  bool       losing;       /* Frames were dropped since the last one */
+#endif
 };
 
 /****************************************************************************
@@ -89,6 +101,7 @@ EXTERN const struct sock_intf_s g_pkt_sockif;
 struct net_driver_s; /* Forward reference */
 struct eth_hdr_s;    /* Forward reference */
 struct socket;       /* Forward reference */
+struct tpacket_req;  /* Forward reference */
 
 /****************************************************************************
  * Name: pkt_initialize()
@@ -283,6 +296,74 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_getsockopt / pkt_setsockopt
+ *
+ * Description:
+ *   Get or set the SOL_PACKET options of a packet socket.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_getsockopt() and psock_setsockopt() for the possible values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Allocate the receive ring of a packet socket as described by
+ *   PACKET_RX_RING, or release it if req->tp_block_nr is zero.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req *req);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the receive ring of a packet socket, if any.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the frame in d_buf into the next slot of the receive ring, or
+ *   count it as dropped if user space has not given the slot back yet.
+ *
+ * Assumptions:
+ *   The network is locked and the connection has a receive ring.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -130,6 +130,8 @@ FAR struct pkt_conn_s *pkt_alloc(void)
   conn = (FAR struct pkt_conn_s *)dq_remfirst(&g_free_pkt_connections);
   if (conn)
     {
+      nxrmutex_init(&conn->sconn.s_lock);
+
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_pkt_connections);
@@ -160,6 +162,10 @@ void pkt_free(FAR struct pkt_conn_s *conn)
 
   dq_rem(&conn->sconn.node, &g_active_pkt_connections);
 
+#ifdef CONFIG_NET_PKT_RXRING
+  pkt_ring_free(conn);
+#endif
+
   /* Make sure that the connection is marked as uninitialized */
 
   memset(conn, 0, sizeof(*conn));
@@ -83,6 +83,16 @@ static int pkt_in(FAR struct net_driver_s *dev)
       dev->d_appdata = dev->d_buf;
       dev->d_sndlen  = 0;
 
+#ifdef CONFIG_NET_PKT_RXRING
+      /* A socket with a receive ring gets all of its frames there */
+
+      if (conn->ring != NULL)
+        {
+          pkt_ring_input(dev, conn);
+          return OK;
+        }
+#endif
+
       /* Perform the application callback */
 
       flags = pkt_callback(dev, conn, PKT_NEWDATA);
@@ -0,0 +1,205 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_RXRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The layout of a slot: the header, the address of the sender and the
+ * frame.
+ */
+
+#define PKT_RING_SLLOFF     TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+#define PKT_RING_MACOFF     TPACKET_ALIGN(TPACKET_HDRLEN)
+
+/* The header of a slot is shared with user space and only accessed as
+ * volatile, the status last.  With SMP, the other stores must also be
+ * visible to the other CPUs before the status.
+ */
+
+#ifndef CONFIG_SPINLOCK
+#  define SP_DMB()
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn,
+                   FAR const struct tpacket_req *req)
+{
+  size_t size;
+
+  if (req->tp_block_nr == 0)
+    {
+      pkt_ring_free(conn);
+      return OK;
+    }
+
+  if (conn->ring != NULL)
+    {
+      return -EBUSY;
+    }
+
+  /* The slots are laid out back to back, so blocks are only checked for
+   * consistency with the request.
+   */
+
+  if (req->tp_frame_size < PKT_RING_MACOFF + ETH_HDRLEN ||
+      req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_block_size == 0 ||
+      req->tp_block_size % req->tp_frame_size != 0 ||
+      req->tp_frame_nr == 0 ||
+      req->tp_frame_nr != req->tp_block_size / req->tp_frame_size *
+                          req->tp_block_nr ||
+      req->tp_frame_nr > SIZE_MAX / req->tp_frame_size)
+    {
+      return -EINVAL;
+    }
+
+  size = (size_t)req->tp_frame_nr * req->tp_frame_size;
+
+  /* The ring is mapped by user space, so it comes from the user heap */
+
+  conn->ring = kumm_zalloc(size);
+  if (conn->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  conn->framesize = req->tp_frame_size;
+  conn->nframes   = req->tp_frame_nr;
+  conn->head      = 0;
+  conn->losing    = false;
+
+  ninfo("RX ring: %" PRIu32 " frames of %" PRIu32 " bytes\n",
+        conn->nframes, conn->framesize);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  if (conn->ring != NULL)
+    {
+      kumm_free(conn->ring);
+      conn->ring    = NULL;
+      conn->nframes = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)dev->d_buf;
+  FAR uint8_t *slot = conn->ring + conn->head * conn->framesize;
+  FAR volatile struct tpacket_hdr *hdr =
+    (FAR volatile struct tpacket_hdr *)slot;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  unsigned int snaplen;
+  unsigned int offset;
+
+  conn->packets++;
+
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      /* User space is too slow */
+
+      conn->drops++;
+      conn->losing = true;
+      return;
+    }
+
+  /* Copy what fits of the frame after the headers of the slot */
+
+  snaplen = MIN(dev->d_len, conn->framesize - PKT_RING_MACOFF);
+  offset  = (dev->d_appdata - dev->d_iob->io_data) - dev->d_iob->io_offset;
+  snaplen = iob_copyout(slot + PKT_RING_MACOFF, dev->d_iob, snaplen,
+                        offset);
+
+  sll = (FAR struct sockaddr_ll *)(slot + PKT_RING_SLLOFF);
+  memset(sll, 0, sizeof(struct sockaddr_ll));
+  sll->sll_family   = AF_PACKET;
+  sll->sll_protocol = eth->type;
+  sll->sll_ifindex  = dev->d_ifindex;
+  sll->sll_hatype   = ARPHRD_ETHER;
+  sll->sll_halen    = ETHER_ADDR_LEN;
+  memcpy(sll->sll_addr, eth->src, ETHER_ADDR_LEN);
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = PKT_RING_MACOFF;
+  hdr->tp_net     = PKT_RING_MACOFF + ETH_HDRLEN;
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / NSEC_PER_USEC;
+
+  /* The slot must be complete before user space can see its status */
+
+  SP_DMB();
+  hdr->tp_status = TP_STATUS_USER | (conn->losing ? TP_STATUS_LOSING : 0);
+
+  conn->losing = false;
+  conn->head   = (conn->head + 1) % conn->nframes;
+}
+
+#endif /* CONFIG_NET_PKT_RXRING */
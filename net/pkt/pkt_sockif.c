@@ -34,6 +34,7 @@
 
 #include <netpacket/packet.h>
 
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 
@@ -65,6 +66,10 @@ static int        pkt_accept(FAR struct socket *psock,
 static int        pkt_poll_local(FAR struct socket *psock,
                     FAR struct pollfd *fds, bool setup);
 static int        pkt_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_PKT_RXRING
+static int        pkt_ioctl(FAR struct socket *psock, int cmd,
+                    unsigned long arg);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -85,6 +90,12 @@ const struct sock_intf_s g_pkt_sockif =
   pkt_sendmsg,     /* si_sendmsg */
   pkt_recvmsg,     /* si_recvmsg */
   pkt_close        /* si_close */
+#ifdef CONFIG_NET_PKT_RXRING
+  , pkt_ioctl      /* si_ioctl */
+  , NULL           /* si_socketpair */
+  , pkt_getsockopt /* si_getsockopt */
+  , pkt_setsockopt /* si_setsockopt */
+#endif
 };
 
 /****************************************************************************
@@ -547,6 +558,42 @@ static int pkt_close(FAR struct socket *psock)
     }
 }
 
+/****************************************************************************
+ * Name: pkt_ioctl
+ *
+ * Description:
+ *   Handle FIOC_MMAP, by which mmap() on the socket returns the address of
+ *   the receive ring set up with PACKET_RX_RING.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_RXRING
+static int pkt_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR void **addr = (FAR void **)((uintptr_t)arg);
+  int ret = -ENOTTY;
+
+  if (cmd == FIOC_MMAP)
+    {
+      net_lock();
+      if (conn->ring != NULL)
+        {
+          *addr = conn->ring;
+          ret = OK;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+
+      net_unlock();
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,152 @@
+/****************************************************************************
+ * net/pkt/pkt_sockopt.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/net/net.h>
+
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_RXRING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   pkt_getsockopt() retrieves the value of the packet socket option
+ *   specified by the 'option' argument.  PACKET_STATISTICS reports the
+ *   frames received and dropped since it was last read.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   level     Protocol level to get the option
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn;
+  FAR struct tpacket_stats *stats;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+
+  conn = psock->s_conn;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_STATISTICS:
+        if (*value_len < sizeof(struct tpacket_stats))
+          {
+            return -EINVAL;
+          }
+
+        stats = value;
+
+        net_lock();
+        stats->tp_packets = conn->packets;
+        stats->tp_drops   = conn->drops;
+        conn->packets     = 0;
+        conn->drops       = 0;
+        net_unlock();
+
+        *value_len = sizeof(struct tpacket_stats);
+        return OK;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   pkt_setsockopt() sets the packet socket option specified by the
+ *   'option' argument to the value pointed to by the 'value' argument.
+ *   PACKET_RX_RING sets up the receive ring that is then mapped with
+ *   mmap() on the socket.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to operate on
+ *   level     Protocol level to set the option
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn;
+  int ret;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  DEBUGASSERT(value_len == 0 || value != NULL);
+
+  conn = psock->s_conn;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case PACKET_RX_RING:
+        if (value_len < sizeof(struct tpacket_req))
+          {
+            return -EINVAL;
+          }
+
+        net_lock();
+        ret = pkt_ring_setup(conn, value);
+        net_unlock();
+        return ret;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+#endif /* CONFIG_NET_PKT_RXRING */
@@ -55,6 +55,9 @@ static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_IPv6
 static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_IPv4 */
+#ifdef CONFIG_NET_6LOWPAN
+static int netprocfs_6lowpan(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_6LOWPAN */
 static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile);
@@ -86,6 +89,10 @@ static const linegen_t g_stat_linegen[] =
   netprocfs_ipv6_dropped,
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NET_6LOWPAN
+  netprocfs_6lowpan,
+#endif /* CONFIG_NET_6LOWPAN */
+
   netprocfs_checksum,
 
 #ifdef CONFIG_NET_TCP
@@ -247,6 +254,22 @@ static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: netprocfs_6lowpan
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_6LOWPAN)
+static int netprocfs_6lowpan(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  6LoWPAN     Frg: %04x   Rsm: %04x   Drp: %04x   "
+                  "Tmo: %04x   Buf: %04x\n",
+                  g_netstats.sixlowpan.fragrecv, g_netstats.sixlowpan.reass,
+                  g_netstats.sixlowpan.fragdrop,
+                  g_netstats.sixlowpan.timeout, g_netstats.sixlowpan.nobuf);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_6LOWPAN */
+
 /****************************************************************************
  * Name: netprocfs_checksum
  ****************************************************************************/
@@ -31,8 +31,11 @@
 
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/net.h>
+#include <nuttx/rcu.h>
 
 #include "route/ramroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -45,6 +48,7 @@
 struct route_match_ipv4_s
 {
   FAR struct net_route_ipv4_s *prev;     /* Predecessor in the list */
+  FAR struct net_route_ipv4_s *del;      /* The removed entry */
   in_addr_t                    target;   /* The target IP address to match */
   in_addr_t                    netmask;  /* The network mask to match */
 };
@@ -54,6 +58,7 @@ struct route_match_ipv4_s
 struct route_match_ipv6_s
 {
   FAR struct net_route_ipv6_s *prev;     /* Predecessor in the list */
+  FAR struct net_route_ipv6_s *del;      /* The removed entry */
   net_ipv6addr_t               target;   /* The target IP address to match */
   net_ipv6addr_t               netmask;  /* The network mask to match */
 };
@@ -109,9 +114,13 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
-      /* And free the routing table entry by adding it to the free list */
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+      net_deltrie_ipv4(route);
+#endif
+
+      /* And free the routing table entry once no reader is left on it */
 
-      net_freeroute_ipv4(route);
+      match->del = route;
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -165,9 +174,13 @@ static int net_match_ipv6(
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
-      /* And free the routing table entry by adding it to the free list */
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+      net_deltrie_ipv6(route);
+#endif
+
+      /* And free the routing table entry once no reader is left on it */
 
-      net_freeroute_ipv6(route);
+      match->del = route;
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -206,12 +219,24 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   /* Set up the comparison structure */
 
   match.prev = NULL;
+  match.del  = NULL;
   net_ipv4addr_copy(match.target, target);
   net_ipv4addr_copy(match.netmask, netmask);
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  net_lock();
+  net_foreachroute_ipv4(net_match_ipv4, &match);
+  net_unlock();
+
+  if (match.del == NULL)
+    {
+      return -ENOENT;
+    }
+
+  synchronize_rcu();
+  net_freeroute_ipv4(match.del);
+  return OK;
 }
 #endif
 
@@ -223,12 +248,24 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   /* Set up the comparison structure */
 
   match.prev = NULL;
+  match.del  = NULL;
   net_ipv6addr_copy(match.target, target);
   net_ipv6addr_copy(match.netmask, netmask);
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  net_lock();
+  net_foreachroute_ipv6(net_match_ipv6, &match);
+  net_unlock();
+
+  if (match.del == NULL)
+    {
+      return -ENOENT;
+    }
+
+  synchronize_rcu();
+  net_freeroute_ipv6(match.del);
+  return OK;
 }
 #endif
 
@@ -28,6 +28,7 @@
 #include <errno.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/rcu.h>
 
 #include <arch/irq.h>
 
@@ -64,25 +65,36 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
   FAR struct net_route_ipv4_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
+  /* Prevent concurrent access to the routing table.  With RCU, the
+   * handlers that modify it must hold the network lock themselves.
+   */
 
+#ifdef CONFIG_RCU
+  rcu_read_lock();
+#else
   net_lock();
+#endif
 
   /* Visit each entry in the routing table */
 
-  for (route = g_ipv4_routes.head; ret == 0 && route != NULL; route = next)
+  for (route = rcu_dereference(g_ipv4_routes.head);
+       ret == 0 && route != NULL; route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the handler may delete this entry.
        */
 
-      next = route->flink;
+      next = rcu_dereference(route->flink);
       ret  = handler(&route->entry, arg);
     }
 
   /* Unlock the network */
 
+#ifdef CONFIG_RCU
+  rcu_read_unlock();
+#else
   net_unlock();
+#endif
   return ret;
 }
 #endif
@@ -94,25 +106,36 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
   FAR struct net_route_ipv6_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
+  /* Prevent concurrent access to the routing table.  With RCU, the
+   * handlers that modify it must hold the network lock themselves.
+   */
 
+#ifdef CONFIG_RCU
+  rcu_read_lock();
+#else
   net_lock();
+#endif
 
   /* Visit each entry in the routing table */
 
-  for (route = g_ipv6_routes.head; ret == 0 && route != NULL; route = next)
+  for (route = rcu_dereference(g_ipv6_routes.head);
+       ret == 0 && route != NULL; route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the handler may delete this entry.
        */
 
-      next = route->flink;
+      next = rcu_dereference(route->flink);
       ret  = handler(&route->entry, arg);
     }
 
   /* Unlock the network */
 
+#ifdef CONFIG_RCU
+  rcu_read_unlock();
+#else
   net_unlock();
+#endif
   return ret;
 }
 #endif
@@ -26,6 +26,7 @@
 
 #include "route/ramroute.h"
 #include "route/cacheroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #ifdef CONFIG_NET_ROUTE
@@ -54,6 +55,10 @@ void net_init_route(void)
   net_init_ramroute();
 #endif
 
+#if defined(CONFIG_ROUTE_IPv4_LPMTRIE) || defined(CONFIG_ROUTE_IPv6_LPMTRIE)
+  net_init_trieroute();
+#endif
+
 #if defined(CONFIG_ROUTE_IPv4_CACHEROUTE) || defined(CONFIG_ROUTE_IPv6_CACHEROUTE)
   net_init_cacheroute();
 #endif
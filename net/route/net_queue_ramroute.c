@@ -24,6 +24,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/rcu.h>
+
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -52,16 +54,18 @@
 void ramroute_ipv4_addlast(FAR struct net_route_ipv4_entry_s *entry,
                            FAR struct net_route_ipv4_queue_s *list)
 {
+  /* Publish the entry last:  It may be found without the network lock */
+
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      rcu_assign_pointer(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      rcu_assign_pointer(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -70,16 +74,18 @@ void ramroute_ipv4_addlast(FAR struct net_route_ipv4_entry_s *entry,
 void ramroute_ipv6_addlast(FAR struct net_route_ipv6_entry_s *entry,
                            FAR struct net_route_ipv6_queue_s *list)
 {
+  /* Publish the entry last:  It may be found without the network lock */
+
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      rcu_assign_pointer(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      rcu_assign_pointer(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -114,7 +120,9 @@ ramroute_ipv4_remfirst(FAR struct net_route_ipv4_queue_s *list)
           list->tail = NULL;
         }
 
-      ret->flink = NULL;
+      /* Leave the link of the removed entry:  Lockless readers may still
+       * be on it.
+       */
     }
 
   return ret;
@@ -135,7 +143,9 @@ ramroute_ipv6_remfirst(FAR struct net_route_ipv6_queue_s *list)
           list->tail = NULL;
         }
 
-      ret->flink = NULL;
+      /* Leave the link of the removed entry:  Lockless readers may still
+       * be on it.
+       */
     }
 
   return ret;
@@ -178,7 +188,9 @@ ramroute_ipv4_remafter(FAR struct net_route_ipv4_entry_s *entry,
           entry->flink = ret->flink;
         }
 
-      ret->flink = NULL;
+      /* Leave the link of the removed entry:  Lockless readers may still
+       * be on it.
+       */
     }
 
   return ret;
@@ -204,7 +216,9 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
           entry->flink = ret->flink;
         }
 
-      ret->flink = NULL;
+      /* Leave the link of the removed entry:  Lockless readers may still
+       * be on it.
+       */
     }
 
   return ret;
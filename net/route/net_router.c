@@ -34,6 +34,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -109,7 +110,8 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 
   /* To match, the masked target addresses must be the same.  In the event
    * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * concept for the precedence of networks, except that the LPM index
+   * offers the routes from the shortest prefix to the longest.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask))
@@ -153,7 +155,8 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 
   /* To match, the masked target addresses must be the same.  In the event
    * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * concept for the precedence of networks, except that the LPM index
+   * offers the routes from the shortest prefix to the longest.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask))
@@ -224,7 +227,11 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+      ret = net_foreachtrie_ipv4(target, net_ipv4_match, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -299,7 +306,11 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+      ret = net_foreachtrie_ipv6(target, net_ipv6_match, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -0,0 +1,631 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/trieroute.h"
+#include "route/route.h"
+
+#if defined(CONFIG_ROUTE_IPv4_LPMTRIE) || defined(CONFIG_ROUTE_IPv6_LPMTRIE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Keys are addresses in network order, compared bit by bit from the most
+ * significant bit of the first byte.
+ */
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+#  define TRIE_KEYLEN      16
+#else
+#  define TRIE_KEYLEN      4
+#endif
+
+#define trie_bit(k, n)     (((k)[(n) >> 3] >> (7 - ((n) & 7))) & 1)
+
+/* A path-compressed trie of n prefixes has at most n - 1 branch nodes */
+
+#define TRIE_IPv4_NNODES   (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#define TRIE_IPv6_NNODES   (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A node holds a prefix, with the route to that prefix or, for a node that
+ * only branches, no route.  The prefixes of its children are longer and
+ * extend its own prefix by a 0 or a 1 bit.
+ */
+
+struct trie_node_s
+{
+  FAR struct trie_node_s *child[2];
+  FAR void *route;                  /* Route to the prefix, or NULL */
+  uint8_t key[TRIE_KEYLEN];         /* The prefix, zero beyond plen */
+  uint8_t plen;                     /* Prefix length in bits */
+};
+
+struct trie_s
+{
+  FAR struct trie_node_s *root;
+  FAR struct trie_node_s *free;     /* Free nodes linked by child[0] */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+static struct trie_s g_ipv4_trie;
+static struct trie_node_s g_ipv4_trienodes[TRIE_IPv4_NNODES];
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+static struct trie_s g_ipv6_trie;
+static struct trie_node_s g_ipv6_trienodes[TRIE_IPv6_NNODES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_init
+ ****************************************************************************/
+
+static void trie_init(FAR struct trie_s *trie,
+                      FAR struct trie_node_s *nodes, int nnodes)
+{
+  int i;
+
+  trie->root = NULL;
+  trie->free = NULL;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      nodes[i].child[0] = trie->free;
+      trie->free        = &nodes[i];
+    }
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ *
+ * Description:
+ *   Allocate a node for the first 'plen' bits of 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct trie_node_s *trie_alloc(FAR struct trie_s *trie,
+                                          FAR const uint8_t *key,
+                                          uint8_t plen, FAR void *route)
+{
+  FAR struct trie_node_s *node = trie->free;
+  int nbytes = (plen + 7) >> 3;
+
+  if (node != NULL)
+    {
+      trie->free = node->child[0];
+
+      memset(node, 0, sizeof(struct trie_node_s));
+      memcpy(node->key, key, nbytes);
+      if ((plen & 7) != 0)
+        {
+          node->key[nbytes - 1] &= 0xff << (8 - (plen & 7));
+        }
+
+      node->plen  = plen;
+      node->route = route;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_free
+ ****************************************************************************/
+
+static void trie_free(FAR struct trie_s *trie, FAR struct trie_node_s *node)
+{
+  node->child[0] = trie->free;
+  trie->free     = node;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits, at most 'maxbits', that are the
+ *   same in both keys.
+ *
+ ****************************************************************************/
+
+static uint8_t trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                           uint8_t maxbits)
+{
+  unsigned int nbits = 0;
+  uint8_t diff;
+
+  while (nbits < maxbits)
+    {
+      diff = a[nbits >> 3] ^ b[nbits >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          break;
+        }
+
+      nbits += 8;
+    }
+
+  return MIN(nbits, maxbits);
+}
+
+/****************************************************************************
+ * Name: trie_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a netmask, or -EINVAL if its bits are not
+ *   contiguous.
+ *
+ ****************************************************************************/
+
+static int trie_prefixlen(FAR const uint8_t *mask, int len)
+{
+  uint8_t bits;
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < len && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < len)
+    {
+      for (bits = mask[i]; (bits & 0x80) != 0; bits <<= 1)
+        {
+          plen++;
+        }
+
+      if (bits != 0)
+        {
+          return -EINVAL;
+        }
+
+      while (++i < len)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Add the route to the prefix 'key'/'plen'.  The new nodes are complete
+ *   before they are linked into the trie.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct trie_s *trie, FAR const uint8_t *key,
+                       uint8_t plen, FAR void *route)
+{
+  FAR struct trie_node_s **link = &trie->root;
+  FAR struct trie_node_s *node;
+  FAR struct trie_node_s *leaf;
+  FAR struct trie_node_s *branch;
+  uint8_t common = 0;
+
+  /* Find where the prefix belongs */
+
+  while ((node = *link) != NULL)
+    {
+      common = trie_common(node->key, key, MIN(node->plen, plen));
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          /* The prefix is already in the trie */
+
+          if (node->route != NULL)
+            {
+              return -EEXIST;
+            }
+
+          node->route = route;
+          return OK;
+        }
+
+      link = &node->child[trie_bit(key, node->plen)];
+    }
+
+  leaf = trie_alloc(trie, key, plen, route);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (node != NULL)
+    {
+      if (common == plen)
+        {
+          /* The new prefix contains the prefix of the node */
+
+          leaf->child[trie_bit(node->key, plen)] = node;
+        }
+      else
+        {
+          /* The prefixes diverge after 'common' bits: branch there */
+
+          branch = trie_alloc(trie, key, common, NULL);
+          if (branch == NULL)
+            {
+              trie_free(trie, leaf);
+              return -ENOMEM;
+            }
+
+          branch->child[trie_bit(key, common)]       = leaf;
+          branch->child[trie_bit(node->key, common)] = node;
+          leaf = branch;
+        }
+    }
+
+  *link = leaf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_remove
+ *
+ * Description:
+ *   Remove the route to the prefix 'key'/'plen', and the nodes that are
+ *   not needed anymore.
+ *
+ ****************************************************************************/
+
+static void trie_remove(FAR struct trie_s *trie, FAR const uint8_t *key,
+                        uint8_t plen, FAR void *route)
+{
+  FAR struct trie_node_s **plink = NULL;
+  FAR struct trie_node_s **link = &trie->root;
+  FAR struct trie_node_s *parent;
+  FAR struct trie_node_s *node;
+
+  while ((node = *link) != NULL && node->plen < plen)
+    {
+      plink = link;
+      link  = &node->child[trie_bit(key, node->plen)];
+    }
+
+  if (node == NULL || node->route != route)
+    {
+      return;
+    }
+
+  node->route = NULL;
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      /* The node still branches */
+
+      return;
+    }
+
+  *link = node->child[0] != NULL ? node->child[0] : node->child[1];
+  trie_free(trie, node);
+
+  /* A parent that only branched is not needed with one child left */
+
+  if (plink != NULL)
+    {
+      parent = *plink;
+      if (parent->route == NULL &&
+          (parent->child[0] == NULL || parent->child[1] == NULL))
+        {
+          *plink = parent->child[0] != NULL ? parent->child[0] :
+                                              parent->child[1];
+          trie_free(trie, parent);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: trie_next
+ *
+ * Description:
+ *   Return the node after 'node' on the path to 'key' if the prefix of
+ *   that node contains 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct trie_node_s *trie_next(FAR struct trie_node_s *node,
+                                         FAR const uint8_t *key,
+                                         uint8_t maxbits)
+{
+  node = node->plen < maxbits ? node->child[trie_bit(key, node->plen)] :
+                                NULL;
+  if (node != NULL && trie_common(node->key, key, node->plen) < node->plen)
+    {
+      node = NULL;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_first
+ ****************************************************************************/
+
+static FAR struct trie_node_s *trie_first(FAR struct trie_s *trie,
+                                          FAR const uint8_t *key)
+{
+  FAR struct trie_node_s *node = trie->root;
+
+  if (node != NULL && trie_common(node->key, key, node->plen) < node->plen)
+    {
+      node = NULL;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the longest-prefix-match index of the routing table
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_trieroute(void)
+{
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+  trie_init(&g_ipv4_trie, g_ipv4_trienodes, TRIE_IPv4_NNODES);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+  trie_init(&g_ipv6_trie, g_ipv6_trienodes, TRIE_IPv6_NNODES);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Add one route of the in-memory routing table to the index
+ *
+ * Input Parameters:
+ *   route - The route to be added
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on any failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+int net_addtrie_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  in_addr_t key = route->target & route->netmask;
+  int plen;
+
+  plen = trie_prefixlen((FAR const uint8_t *)&route->netmask,
+                        sizeof(in_addr_t));
+  if (plen < 0)
+    {
+      return plen;
+    }
+
+  return trie_insert(&g_ipv4_trie, (FAR const uint8_t *)&key, plen, route);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+int net_addtrie_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  net_ipv6addr_t key;
+  int plen;
+  int i;
+
+  plen = trie_prefixlen((FAR const uint8_t *)route->netmask,
+                        sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      return plen;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = route->target[i] & route->netmask[i];
+    }
+
+  return trie_insert(&g_ipv6_trie, (FAR const uint8_t *)key, plen, route);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Remove one route from the index
+ *
+ * Input Parameters:
+ *   route - The route to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+void net_deltrie_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  in_addr_t key = route->target & route->netmask;
+  int plen;
+
+  plen = trie_prefixlen((FAR const uint8_t *)&route->netmask,
+                        sizeof(in_addr_t));
+  if (plen >= 0)
+    {
+      trie_remove(&g_ipv4_trie, (FAR const uint8_t *)&key, plen, route);
+    }
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+void net_deltrie_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  net_ipv6addr_t key;
+  int plen;
+  int i;
+
+  plen = trie_prefixlen((FAR const uint8_t *)route->netmask,
+                        sizeof(net_ipv6addr_t));
+  if (plen >= 0)
+    {
+      for (i = 0; i < 8; i++)
+        {
+          key[i] = route->target[i] & route->netmask[i];
+        }
+
+      trie_remove(&g_ipv6_trie, (FAR const uint8_t *)key, plen, route);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: net_foreachtrie_ipv4 and net_foreachtrie_ipv6
+ *
+ * Description:
+ *   Visit the routes of the index whose network contains 'target', from
+ *   the shortest to the longest prefix.  A handler that accepts a route
+ *   returns a positive value; the last route accepted is then the longest
+ *   match.
+ *
+ * Input Parameters:
+ *   target  - The address to look up
+ *   handler - Will be called for each route containing the address
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   A positive value if any route was accepted; zero otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+int net_foreachtrie_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                         FAR void *arg)
+{
+  FAR const uint8_t *key = (FAR const uint8_t *)&target;
+  FAR struct trie_node_s *node;
+  int ret = 0;
+
+  /* Prevent concurrent access to the routing table */
+
+  net_lock();
+
+  for (node = trie_first(&g_ipv4_trie, key); node != NULL;
+       node = trie_next(node, key, 32))
+    {
+      if (node->route != NULL && handler(node->route, arg) > 0)
+        {
+          ret = 1;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+int net_foreachtrie_ipv6(const net_ipv6addr_t target,
+                         route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR const uint8_t *key = (FAR const uint8_t *)target;
+  FAR struct trie_node_s *node;
+  int ret = 0;
+
+  /* Prevent concurrent access to the routing table */
+
+  net_lock();
+
+  for (node = trie_first(&g_ipv6_trie, key); node != NULL;
+       node = trie_next(node, key, 128))
+    {
+      if (node->route != NULL && handler(node->route, arg) > 0)
+        {
+          ret = 1;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_IPv4_LPMTRIE || CONFIG_ROUTE_IPv6_LPMTRIE */
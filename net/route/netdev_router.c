@@ -33,6 +33,7 @@
 
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -114,7 +115,8 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
    * router address must like on the network provided by the device.
    *
    * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+   * not (yet) any concept for the precedence of networks, except that the
+   * LPM index offers the routes from the shortest prefix to the longest.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask) &&
@@ -163,7 +165,8 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
    * router address must like on the network provided by the device.
    *
    * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+   * not (yet) any concept for the precedence of networks, except that the
+   * LPM index offers the routes from the shortest prefix to the longest.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask) &&
@@ -235,7 +238,11 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+      ret = net_foreachtrie_ipv4(target, net_ipv4_devmatch, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -314,7 +321,11 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+      ret = net_foreachtrie_ipv6(target, net_ipv6_devmatch, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -0,0 +1,142 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_ROUTE_IPv4_LPMTRIE) || defined(CONFIG_ROUTE_IPv6_LPMTRIE)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_trieroute
+ *
+ * Description:
+ *   Initialize the longest-prefix-match index of the routing table
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_trieroute(void);
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Add one route of the in-memory routing table to the index
+ *
+ * Input Parameters:
+ *   route - The route to be added
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on any failure:
+ *
+ *   EINVAL - The netmask of the route is not contiguous
+ *   EEXIST - There is already a route with the same target and netmask
+ *   ENOMEM - The index is full
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+int net_addtrie_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+int net_addtrie_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Remove one route from the index
+ *
+ * Input Parameters:
+ *   route - The route to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+void net_deltrie_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+void net_deltrie_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_foreachtrie_ipv4 and net_foreachtrie_ipv6
+ *
+ * Description:
+ *   Visit the routes of the index whose network contains 'target', from
+ *   the shortest to the longest prefix.  A handler that accepts a route
+ *   returns a positive value; the last route accepted is then the longest
+ *   match.
+ *
+ * Input Parameters:
+ *   target  - The address to look up
+ *   handler - Will be called for each route containing the address
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   A positive value if any route was accepted; zero otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_LPMTRIE
+int net_foreachtrie_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                         FAR void *arg);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_LPMTRIE
+int net_foreachtrie_ipv6(const net_ipv6addr_t target,
+                         route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
+#endif /* CONFIG_ROUTE_IPv4_LPMTRIE || CONFIG_ROUTE_IPv6_LPMTRIE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
@@ -327,6 +327,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
         fragsize = GETUINT16(fragptr, SIXLOWPAN_FRAG_DISPATCH_SIZE) & 0x07ff;
         fragtag  = GETUINT16(fragptr, SIXLOWPAN_FRAG_TAG);
         g_frame_hdrlen += SIXLOWPAN_FRAG1_HDR_LEN;
+        SIXLOWPAN_STAT(fragrecv);
 
         ninfo("FRAG1: fragsize=%d fragtag=%d fragoffset=%d\n",
               fragsize, fragtag, fragoffset);
@@ -336,6 +337,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
         if (fragsize == 0)
           {
             nwarn("WARNING: Dropping zero-length 6LoWPAN fragment\n");
+            SIXLOWPAN_STAT(fragdrop);
             return INPUT_PARTIAL;
           }
 
@@ -345,6 +347,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
           {
             nwarn("WARNING:  Reassembled packet size exceeds "
                   "CONFIG_NET_6LOWPAN_PKTSIZE\n");
+            SIXLOWPAN_STAT(fragdrop);
             return -ENOSPC;
           }
 
@@ -386,6 +389,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
         fragtag  = GETUINT16(fragptr, SIXLOWPAN_FRAG_TAG);
         fragsize = GETUINT16(fragptr, SIXLOWPAN_FRAG_DISPATCH_SIZE) & 0x07ff;
         g_frame_hdrlen += SIXLOWPAN_FRAGN_HDR_LEN;
+        SIXLOWPAN_STAT(fragrecv);
 
         /* Extract the source address from the 'metadata'. */
 
@@ -405,6 +409,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
           {
             nerr("ERROR: Failed to find a reassembly buffer for tag=%04x\n",
                  fragtag);
+            SIXLOWPAN_STAT(fragdrop);
             return -ENOENT;
           }
 
@@ -414,6 +419,7 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
 
           nwarn("WARNING: Dropping 6LoWPAN packet. Bad fragsize: %u vs %u\n",
                 fragsize, reass->rb_pktlen);
+          SIXLOWPAN_STAT(fragdrop);
           ret = -EPERM;
           goto errout_with_reass;
         }
@@ -586,6 +592,12 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
       reass->rb_active    = false;
       reass->rb_pktlen    = 0;
       reass->rb_accumlen  = 0;
+
+      if (isfrag)
+        {
+          SIXLOWPAN_STAT(reass);
+        }
+
       return INPUT_COMPLETE;
     }
 
@@ -594,6 +606,11 @@ static int sixlowpan_frame_process(FAR struct radio_driver_s *radio,
   return INPUT_PARTIAL;
 
 errout_with_reass:
+  if (isfrag)
+    {
+      SIXLOWPAN_STAT(fragdrop);
+    }
+
   sixlowpan_reass_free(reass);
   return ret;
 }
@@ -44,6 +44,12 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Active reassemblies are swept for expiry at most this often, and
+ * whenever the pre-allocated buffers are exhausted.
+ */
+
+#define NET_6LOWPAN_SWEEP   (NET_6LOWPAN_TIMEOUT / 2)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -55,9 +61,17 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* The active, allocated reassemby buffers, hashed by reassembly tag and
+ * fragment source so that each fragment finds its buffer without walking
+ * every reassembly in progress.
+ */
+
+static FAR struct sixlowpan_reassbuf_s *
+              g_active_reass[CONFIG_NET_6LOWPAN_REASS_HASHSIZE];
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+/* The time of the last expiry sweep */
+
+static clock_t g_reass_swept;
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -65,7 +79,7 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
@@ -100,6 +114,59 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
   return false;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the hash bucket of a reassembly tag and fragment source.
+ *
+ ****************************************************************************/
+
+static unsigned int
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      hash = hash * 31 + fragsrc->nv_addr[i];
+    }
+
+  return hash % CONFIG_NET_6LOWPAN_REASS_HASHSIZE;
+}
+
+/****************************************************************************
+ * Name: sixlowpan_reass_expired
+ *
+ * Description:
+ *   Return true if a reassembly buffer is inactive or has timed out.
+ *
+ ****************************************************************************/
+
+static bool sixlowpan_reass_expired(FAR struct sixlowpan_reassbuf_s *reass,
+                                    clock_t now)
+{
+  /* Inactive reassembly buffers are freed because the life of the
+   * reassembly buffer is not certain.
+   */
+
+  if (!reass->rb_active)
+    {
+      return true;
+    }
+
+  if (now - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+    {
+      nwarn("WARNING: Reassembly timed out\n");
+      SIXLOWPAN_STAT(timeout);
+      return true;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: sixlowpan_reass_expire
  *
@@ -107,7 +174,7 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
  *   Free all expired or inactive reassembly buffers.
  *
  * Input Parameters:
- *   None
+ *   now - The current time
  *
  * Returned Value:
  *   None
@@ -117,39 +184,24 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
  *
  ****************************************************************************/
 
-static void sixlowpan_reass_expire(void)
+static void sixlowpan_reass_expire(clock_t now)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
-  clock_t elapsed;
+  int i;
 
-  /* If reassembly timed out, cancel it */
+  g_reass_swept = now;
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < CONFIG_NET_6LOWPAN_REASS_HASHSIZE; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
-
-      if (!reass->rb_active)
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
         {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
-          /* Get the elpased time of the reassembly */
-
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          /* Needed if 'reass' is freed */
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          next = reass->rb_flink;
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
+          if (sixlowpan_reass_expired(reass, now))
             {
-              nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
         }
@@ -175,12 +227,24 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
-  /* Find the reassembly buffer in the list of active reassembly buffers */
+  /* Only buffers from the reassembly pools are hashed; the one of the
+   * radio driver is not tagged.
+   */
 
-  for (prev = NULL, curr = g_active_reass;
+  if (reass->rb_pool == REASS_POOL_RADIO)
+    {
+      return;
+    }
+
+  /* Find the reassembly buffer in its bucket of active reassembly buffers */
+
+  head = &g_active_reass[sixlowpan_reass_hash(reass->rb_reasstag,
+                                              &reass->rb_fragsrc)];
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -194,7 +258,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -259,7 +323,8 @@ void sixlowpan_reass_initialize(void)
  *
  *   This function will first attempt to allocate from the g_free_reass
  *   list.  If that the list is empty, then the reassembly buffer structure
- *   will be allocated from the dynamic memory pool.
+ *   will be allocated from the dynamic memory pool.  A reassembly already
+ *   in progress with the same tag and source is discarded.
  *
  * Input Parameters:
  *   reasstag - The reassembly tag for subsequent lookup.
@@ -280,13 +345,29 @@ FAR struct sixlowpan_reassbuf_s *
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  clock_t now = clock_systime_ticks();
+  unsigned int hash;
   uint8_t pool;
 
-  /* First, removed any expired or inactive reassembly buffers.  This might
-   * free up a pre-allocated buffer for this allocation.
+  /* A first fragment for a reassembly that is already in progress is a
+   * retransmission of the packet:  Start over in a fresh buffer.
    */
 
-  sixlowpan_reass_expire();
+  reass = sixlowpan_reass_find(reasstag, fragsrc);
+  if (reass != NULL)
+    {
+      sixlowpan_reass_free(reass);
+    }
+
+  /* Remove any expired or inactive reassembly buffers now and then, and
+   * whenever that might free up a pre-allocated buffer for this
+   * allocation.
+   */
+
+  if (g_free_reass == NULL || now - g_reass_swept >= NET_6LOWPAN_SWEEP)
+    {
+      sixlowpan_reass_expire(now);
+    }
 
   /* Now, try the free list first */
 
@@ -322,12 +403,17 @@ FAR struct sixlowpan_reassbuf_s *
       reass->rb_pool     = pool;
       reass->rb_active   = true;
       reass->rb_reasstag = reasstag;
-      reass->rb_time     = clock_systime_ticks();
+      reass->rb_time     = now;
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      hash                  = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink       = g_active_reass[hash];
+      g_active_reass[hash]  = reass;
+    }
+  else
+    {
+      SIXLOWPAN_STAT(nobuf);
     }
 
   return reass;
@@ -358,17 +444,13 @@ FAR struct sixlowpan_reassbuf_s *
 {
   FAR struct sixlowpan_reassbuf_s *reass;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
+  /* Search for the matching reassembly buffer in the bucket of the tag and
+   * source address.
    */
 
-  sixlowpan_reass_expire();
-
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
-   */
-
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_active_reass[sixlowpan_reass_hash(reasstag, fragsrc)];
+       reass != NULL;
+       reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -378,6 +460,16 @@ FAR struct sixlowpan_reassbuf_s *
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          /* We don't want to return an old reassembly buffer with the same
+           * tag.
+           */
+
+          if (sixlowpan_reass_expired(reass, clock_systime_ticks()))
+            {
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
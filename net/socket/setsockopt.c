@@ -134,6 +134,9 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                            * periodic transmission of probes */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+#ifdef CONFIG_NET_REUSEPORT
+      case SO_REUSEPORT:  /* Allow sharing of a local port */
+#endif
         {
           int setting;
 
@@ -74,6 +74,9 @@
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+#  define TCP_WBSACKED(wrb)          ((wrb)->wb_sacked)
+#endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
@@ -105,6 +108,26 @@
 /* The TCP options flags */
 
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
+#define TCP_SACK              0x02U /* Selective ACK option enabled */
+
+/* The largest window scale factor allowed by RFC 7323 */
+
+#define TCP_MAX_WSCALE        14
+
+/* The largest number of SACK blocks that fit in the TCP options */
+
+#define TCP_SACK_RANGES_MAX   4
+
+/* Congestion control states, numbered as tcpi_ca_state of TCP_INFO */
+
+#define TCP_CC_OPEN           0     /* No loss being recovered from */
+#define TCP_CC_RECOVERY       3     /* Fast recovery */
+#define TCP_CC_LOSS           4     /* Recovery after a retransmission
+                                     * timeout */
+
+/* The room for the private state of a congestion control algorithm */
+
+#define TCP_CC_PRIV_WORDS     24
 
 /* After receiving 3 duplicate ACKs, TCP performs a retransmission
  * (RFC 5681 (3.2))
@@ -134,6 +157,32 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_conn_s;        /* Forward reference */
+
+#ifdef CONFIG_NET_TCP_CC
+/* A congestion control algorithm.  The common logic in tcp_cc.c keeps the
+ * cwnd and ssthresh fields of the connection, RTT samples and the loss
+ * recovery state; the algorithm only decides how cwnd and ssthresh evolve
+ * and may keep its own state in cc_priv.
+ *
+ *   init - Initialize the private state.  cwnd and ssthresh are already
+ *          set.
+ *   ack  - 'acked' new bytes were cumulatively ACKed.  'rtt' is an RTT
+ *          sample in microseconds, or zero if the ACK gave none.  Not
+ *          called for ACKs inside fast recovery.
+ *   loss - Loss was detected, by a retransmission timeout if 'timeout',
+ *          otherwise by duplicate ACKs.  Called once per window of data.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* Name used with TCP_CONGESTION */
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*ack)(FAR struct tcp_conn_s *conn, uint32_t acked,
+                   uint32_t rtt);
+  CODE void (*loss)(FAR struct tcp_conn_s *conn, bool timeout);
+};
+#endif
 
 /* This is a container that holds the poll-related information */
 
@@ -144,6 +193,20 @@ struct tcp_poll_s
   FAR struct devif_callback_s *cb; /* Needed to teardown the poll */
 };
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+/* An out-of-order range of received data, held until the data before it
+ * arrives.  The I/O buffer chain holds exactly the payload from 'left' up
+ * to, but not including, 'right'.
+ */
+
+struct tcp_ofoseg_s
+{
+  uint32_t left;           /* Sequence number of the first byte */
+  uint32_t right;          /* Sequence number after the last byte */
+  FAR struct iob_s *data;  /* The payload */
+};
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -176,6 +239,9 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_entry_t hnode;       /* Active or listener hash table link */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -249,6 +315,21 @@ struct tcp_conn_s
 
   struct iob_s *readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  /* Out-of-order buffering.
+   *
+   *   ofosegs   - The ranges received beyond rcvseq, sorted by sequence
+   *               number and never overlapping or adjacent.
+   *   nofosegs  - The number of ranges in ofosegs.
+   *   ofo_last  - The first sequence number of the latest segment added,
+   *               so that its range is reported first (RFC 2018).
+   */
+
+  struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
+  uint8_t    nofosegs;
+  uint32_t   ofo_last;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Write buffering
    *
@@ -300,6 +381,26 @@ struct tcp_conn_s
   bool       sendfile;    /* True if sendfile operation is in progress */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control:  cc_ops is the algorithm in use and cc_priv holds
+   * its private state.  Sizes are in bytes, times in microseconds.
+   */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+  uint32_t   cwnd;          /* Congestion window */
+  uint32_t   ssthresh;      /* Slow start threshold */
+  uint32_t   srtt;          /* Smoothed RTT */
+  uint32_t   rttvar;        /* RTT variation */
+  uint32_t   cc_una;        /* Highest cumulative ACK seen */
+  uint32_t   cc_delivered;  /* Count of bytes cumulatively ACKed */
+  uint32_t   cc_recover;    /* sndseq_max when the recovery started */
+  uint32_t   cc_rttseq;     /* Sequence number ending the timed segment */
+  clock_t    cc_rtttime;    /* When the timed segment was sent */
+  bool       cc_timing;     /* True: a segment is being timed */
+  uint8_t    cc_state;      /* TCP_CC_OPEN, TCP_CC_RECOVERY or TCP_CC_LOSS */
+  uint32_t   cc_priv[TCP_CC_PRIV_WORDS];
+#endif
+
   /* connevents is a list of callbacks for each socket the uses this
    * connection (there can be more that one in the event that the the socket
    * was dup'ed).  It is used with the network monitor to handle
@@ -351,6 +452,10 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  bool       wb_sacked;    /* All of the data has been selectively
+                            * ACKed */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -382,8 +487,23 @@ struct tcp_backlog_s
  ****************************************************************************/
 
 #ifdef __cplusplus
+#  define EXTERN extern "C"
 extern "C"
 {
+#else
+#  define EXTERN extern
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+/* The congestion control algorithms */
+
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
 #endif
 
 /****************************************************************************
@@ -938,6 +1058,21 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_connlistener
+ *
+ * Description:
+ *   Return the listener for a connection in the 3-way handshake (if any).
+ *   The same listener is returned for the connection every time, also when
+ *   several listeners share the port with SO_REUSEPORT.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_connlistener(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -1582,6 +1717,106 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 
 bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_get_rcvscale
+ *
+ * Description:
+ *   Calculate the window scale factor to offer to the peer: the smallest
+ *   one that lets the advertised window cover the read-ahead buffering
+ *   available to the connection.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Returned Value:
+ *   The window scale factor.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_rcvscale(FAR struct tcp_conn_s *conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+/****************************************************************************
+ * Name: tcp_ofoseg_queue
+ *
+ * Description:
+ *   Keep the payload of a segment received beyond rcvseq until the data
+ *   before it arrives.  On success, the packet in d_iob is consumed and a
+ *   fresh d_iob is prepared for the ACK.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received segment.
+ *          d_appdata and d_len describe its payload.
+ *   conn - The TCP connection structure holding connection information.
+ *   seq  - The sequence number of the first byte of the payload.
+ *
+ * Returned Value:
+ *   True if the payload was kept.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_ofoseg_queue(FAR struct net_driver_s *dev,
+                      FAR struct tcp_conn_s *conn, uint32_t seq);
+
+/****************************************************************************
+ * Name: tcp_ofoseg_deliver
+ *
+ * Description:
+ *   Append the out-of-order data that the in-order segment in d_iob makes
+ *   contiguous to its payload, so that it is delivered to the application
+ *   with that segment.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received segment.
+ *          d_appdata and d_len describe its payload, which starts at
+ *          rcvseq.
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_ofoseg_deliver(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_ofoseg_free
+ *
+ * Description:
+ *   Release all of the out-of-order data held by the connection.
+ *
+ ****************************************************************************/
+
+void tcp_ofoseg_free(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_sack_options
+ *
+ * Description:
+ *   Build the SACK option describing the out-of-order data held by the
+ *   connection, the range holding the latest segment first.
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection structure holding connection information.
+ *   optdata - Where to build the option.
+ *   maxlen  - The room available at optdata.
+ *
+ * Returned Value:
+ *   The length of the option, a multiple of 4; zero if there is nothing
+ *   to report.
+ *
+ ****************************************************************************/
+
+uint16_t tcp_sack_options(FAR struct tcp_conn_s *conn,
+                          FAR uint8_t *optdata, uint16_t maxlen);
+#endif
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -2062,6 +2297,103 @@ void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn);
 
 uint16_t tcpip_hdrsize(FAR struct tcp_conn_s *conn);
 
+#ifdef CONFIG_NET_TCP_CC
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Start congestion control on a connection that has just been
+ *   established, with the initial window of RFC 3390.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_cansend
+ *
+ * Description:
+ *   Check if 'len' more bytes may be sent without exceeding cwnd.  One
+ *   segment may always be sent when nothing is in flight.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_cansend(FAR struct tcp_conn_s *conn, uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Account for a data segment about to be sent, timing it for an RTT
+ *   sample if none is being timed and it is not a retransmission (Karn).
+ *   Must be called before sndseq_max accounts for the segment.
+ *
+ ****************************************************************************/
+
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t seq, uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Account for an incoming ACK.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection structure holding connection information.
+ *   ackno - The acknowledgement number of the ACK.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno);
+
+/****************************************************************************
+ * Name: tcp_cc_loss
+ *
+ * Description:
+ *   Account for a loss, detected by a retransmission timeout if 'timeout',
+ *   otherwise by duplicate ACKs.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_loss(FAR struct tcp_conn_s *conn, bool timeout);
+#endif /* CONFIG_NET_TCP_CC */
+
+#undef EXTERN
 #ifdef __cplusplus
 }
 #endif
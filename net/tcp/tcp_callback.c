@@ -247,6 +247,20 @@ uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
 
   buflen = iob->io_pktlen;
 
+#ifdef CONFIG_IOB_POOLS
+  /* Drop the data if TCP is over its quota; it is not acknowledged and so
+   * will be retransmitted.
+   */
+
+  if (iob_pool_charge(IOB_POOL_TCP, iob) < 0)
+    {
+      nwarn("WARNING: TCP read-ahead quota exceeded\n");
+      iob_free_chain(iob);
+      netdev_iob_clear(dev);
+      return 0;
+    }
+#endif
+
   /* Concat the iob to readahead */
 
   if (conn->readahead == NULL)
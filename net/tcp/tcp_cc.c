@@ -0,0 +1,377 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT   (&g_tcp_cc_cubic)
+#elif defined(CONFIG_NET_TCP_CC_DEFAULT_BBR)
+#  define TCP_CC_DEFAULT   (&g_tcp_cc_bbr)
+#else
+#  define TCP_CC_DEFAULT   (&g_tcp_cc_newreno)
+#endif
+
+/* Bounds of the congestion window */
+
+#define TCP_CC_MAXCWND     (1ul << 30)
+#define TCP_CC_MINCWND(c)  ((uint32_t)(c)->mss)
+
+#define TCP_CC_NOPS        (sizeof(g_tcp_cc_ops) / sizeof(g_tcp_cc_ops[0]))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_ops[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_ops
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *
+tcp_cc_ops(FAR struct tcp_conn_s *conn)
+{
+  return conn->cc_ops != NULL ? conn->cc_ops : TCP_CC_DEFAULT;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_rttsample
+ *
+ * Description:
+ *   Update the smoothed RTT and its variation with a new sample (RFC6298).
+ *
+ ****************************************************************************/
+
+static void tcp_cc_rttsample(FAR struct tcp_conn_s *conn, uint32_t rtt)
+{
+  uint32_t delta;
+
+  if (conn->srtt == 0)
+    {
+      conn->srtt   = rtt;
+      conn->rttvar = rtt / 2;
+    }
+  else
+    {
+      delta        = rtt > conn->srtt ? rtt - conn->srtt : conn->srtt - rtt;
+      conn->rttvar = conn->rttvar - (conn->rttvar >> 2) + (delta >> 2);
+      conn->srtt   = conn->srtt - (conn->srtt >> 3) + (rtt >> 3);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_clamp
+ ****************************************************************************/
+
+static void tcp_cc_clamp(FAR struct tcp_conn_s *conn)
+{
+  if (conn->cwnd > TCP_CC_MAXCWND)
+    {
+      conn->cwnd = TCP_CC_MAXCWND;
+    }
+  else if (conn->cwnd < TCP_CC_MINCWND(conn))
+    {
+      conn->cwnd = TCP_CC_MINCWND(conn);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Start congestion control on a connection that has just been
+ *   established, with the initial window of RFC 3390.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  uint32_t mss = conn->mss;
+
+  conn->cc_ops       = tcp_cc_ops(conn);
+  conn->cwnd         = MIN(4 * mss, MAX(2 * mss, 4380));
+  conn->ssthresh     = TCP_CC_MAXCWND;
+  conn->srtt         = 0;
+  conn->rttvar       = 0;
+  conn->cc_una       = conn->isn;
+  conn->cc_delivered = 0;
+  conn->cc_timing    = false;
+  conn->cc_state     = TCP_CC_OPEN;
+  memset(conn->cc_priv, 0, sizeof(conn->cc_priv));
+
+  conn->cc_ops->init(conn);
+  tcp_cc_clamp(conn);
+
+  ninfo("%s: cwnd=%" PRIu32 "\n", conn->cc_ops->name, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < TCP_CC_NOPS; i++)
+    {
+      if (strcmp(g_tcp_cc_ops[i]->name, name) == 0)
+        {
+          break;
+        }
+    }
+
+  if (i == TCP_CC_NOPS)
+    {
+      return -ENOENT;
+    }
+
+  if (conn->cc_ops != g_tcp_cc_ops[i])
+    {
+      conn->cc_ops = g_tcp_cc_ops[i];
+
+      /* Restart the new algorithm from the current window */
+
+      if (conn->cwnd != 0)
+        {
+          memset(conn->cc_priv, 0, sizeof(conn->cc_priv));
+          conn->cc_ops->init(conn);
+          tcp_cc_clamp(conn);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn)
+{
+  return tcp_cc_ops(conn)->name;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_cansend
+ *
+ * Description:
+ *   Check if 'len' more bytes may be sent without exceeding cwnd.  One
+ *   segment may always be sent when nothing is in flight.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_cansend(FAR struct tcp_conn_s *conn, uint32_t len)
+{
+  return conn->cwnd == 0 || conn->tx_unacked == 0 ||
+         conn->tx_unacked + len <= conn->cwnd;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Account for a data segment about to be sent, timing it for an RTT
+ *   sample if none is being timed and it is not a retransmission (Karn).
+ *   Must be called before sndseq_max accounts for the segment.
+ *
+ ****************************************************************************/
+
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t seq, uint32_t len)
+{
+  if (conn->sndseq_max != 0 && TCP_SEQ_LT(seq, conn->sndseq_max))
+    {
+      /* A retransmission: the sample it gave would be ambiguous */
+
+      if (conn->cc_timing &&
+          TCP_SEQ_LT(seq, conn->cc_rttseq))
+        {
+          conn->cc_timing = false;
+        }
+    }
+  else if (!conn->cc_timing)
+    {
+      conn->cc_timing  = true;
+      conn->cc_rttseq  = TCP_SEQ_ADD(seq, len);
+      conn->cc_rtttime = clock_systime_ticks();
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Account for an incoming ACK.
+ *
+ * Input Parameters:
+ *   conn  - The TCP connection structure holding connection information.
+ *   ackno - The acknowledgement number of the ACK.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno)
+{
+  uint32_t acked;
+  uint32_t rtt = 0;
+  clock_t elapsed;
+
+  if (conn->cwnd == 0 || !TCP_SEQ_GT(ackno, conn->cc_una))
+    {
+      return;
+    }
+
+  acked               = TCP_SEQ_SUB(ackno, conn->cc_una);
+  conn->cc_una        = ackno;
+  conn->cc_delivered += acked;
+
+  if (conn->cc_timing && TCP_SEQ_GTE(ackno, conn->cc_rttseq))
+    {
+      /* Samples shorter than the tick are taken as half a tick */
+
+      elapsed         = clock_systime_ticks() - conn->cc_rtttime;
+      rtt             = elapsed > 0 ? TICK2USEC(elapsed) :
+                                      USEC_PER_TICK / 2;
+      conn->cc_timing = false;
+      tcp_cc_rttsample(conn, rtt);
+    }
+
+  if (conn->cc_state != TCP_CC_OPEN)
+    {
+      if (TCP_SEQ_GTE(ackno, conn->cc_recover))
+        {
+          /* All of the data outstanding at the loss is now ACKed */
+
+          ninfo("Recovered: cwnd=%" PRIu32 " ssthresh=%" PRIu32 "\n",
+                conn->cwnd, conn->ssthresh);
+          conn->cc_state = TCP_CC_OPEN;
+        }
+      else if (conn->cc_state == TCP_CC_RECOVERY)
+        {
+          /* No growth while repairing the loss (RFC6582) */
+
+          return;
+        }
+    }
+
+  conn->cc_ops->ack(conn, acked, rtt);
+  tcp_cc_clamp(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_loss
+ *
+ * Description:
+ *   Account for a loss, detected by a retransmission timeout if 'timeout',
+ *   otherwise by duplicate ACKs.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  if (conn->cwnd == 0)
+    {
+      return;
+    }
+
+  /* Duplicate ACKs for data sent before the loss are expected and do not
+   * reduce the window again.
+   */
+
+  if (!timeout && conn->cc_state != TCP_CC_OPEN)
+    {
+      return;
+    }
+
+  conn->cc_ops->loss(conn, timeout);
+  tcp_cc_clamp(conn);
+
+  conn->cc_state   = timeout ? TCP_CC_LOSS : TCP_CC_RECOVERY;
+  conn->cc_recover = conn->sndseq_max;
+  conn->cc_timing  = false;
+
+  ninfo("%s: cwnd=%" PRIu32 " ssthresh=%" PRIu32 "\n",
+        timeout ? "Timeout" : "Fast retransmit", conn->cwnd,
+        conn->ssthresh);
+}
+
+#endif /* CONFIG_NET_TCP_CC */
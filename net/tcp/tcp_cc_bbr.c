@@ -0,0 +1,323 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BBR_BW_NSAMPLES      8       /* Rounds of the bandwidth filter */
+#define BBR_MINRTT_WINDOW    10000   /* Lifetime of a min_rtt sample (ms) */
+#define BBR_PROBERTT_TIME    200     /* Time spent in PROBE_RTT (ms) */
+#define BBR_FULLBW_ROUNDS    3       /* Rounds without 25% growth */
+#define BBR_MINCWND(c)       (4 * (uint32_t)(c)->mss)
+
+/* Gains, in percent */
+
+#define BBR_CWND_GAIN        200
+#define BBR_CYCLE_LEN        8
+
+/* The modes of the model */
+
+#define BBR_STARTUP          0       /* Grow exponentially to find the
+                                      * bottleneck bandwidth */
+#define BBR_DRAIN            1       /* Drain the queue made by STARTUP */
+#define BBR_PROBE_BW         2       /* Cycle around the estimated BDP */
+#define BBR_PROBE_RTT        3       /* Shrink the window to measure the
+                                      * minimum RTT again */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bbr_s
+{
+  uint32_t bw[BBR_BW_NSAMPLES]; /* Delivery rate of the last rounds
+                                 * (bytes/ms) */
+  uint32_t full_bw;             /* Bandwidth when the last growth was seen */
+  uint32_t min_rtt;             /* Minimum RTT seen (us) */
+  uint32_t min_rtt_stamp;       /* When min_rtt was measured (ms) */
+  uint32_t round_seq;           /* The ACK that ends the round */
+  uint32_t round_delivered;     /* cc_delivered when the round started */
+  uint32_t round_stamp;         /* When the round started (ms) */
+  uint32_t cycle_stamp;         /* When the gain cycle phase started (ms) */
+  uint32_t probe_rtt_done;      /* When PROBE_RTT may end (ms) */
+  uint32_t prior_cwnd;          /* cwnd before PROBE_RTT */
+  uint8_t  mode;                /* BBR_STARTUP, ... */
+  uint8_t  bw_index;            /* The next bw[] entry to replace */
+  uint8_t  full_bw_cnt;         /* Rounds without growth in STARTUP */
+  uint8_t  cycle_index;         /* Phase of the PROBE_BW gain cycle */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static void bbr_ack(FAR struct tcp_conn_s *conn, uint32_t acked,
+                    uint32_t rtt);
+static void bbr_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint8_t g_bbr_cycle_gain[BBR_CYCLE_LEN] =
+{
+  125, 75, 100, 100, 100, 100, 100, 100
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",
+  bbr_init,
+  bbr_ack,
+  bbr_loss
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_now
+ ****************************************************************************/
+
+static uint32_t bbr_now(void)
+{
+  return (uint32_t)TICK2MSEC(clock_systime_ticks());
+}
+
+/****************************************************************************
+ * Name: bbr_max_bw
+ ****************************************************************************/
+
+static uint32_t bbr_max_bw(FAR struct bbr_s *bbr)
+{
+  uint32_t bw = 0;
+  int i;
+
+  for (i = 0; i < BBR_BW_NSAMPLES; i++)
+    {
+      bw = MAX(bw, bbr->bw[i]);
+    }
+
+  return bw;
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct bbr_s *bbr = (FAR struct bbr_s *)conn->cc_priv;
+  uint32_t now = bbr_now();
+
+  DEBUGASSERT(sizeof(*bbr) <= sizeof(conn->cc_priv));
+
+  memset(bbr, 0, sizeof(*bbr));
+  bbr->mode            = BBR_STARTUP;
+  bbr->round_seq       = conn->cc_una;
+  bbr->round_delivered = conn->cc_delivered;
+  bbr->round_stamp     = now;
+  bbr->min_rtt_stamp   = now;
+  bbr->cycle_index     = 2;
+}
+
+/****************************************************************************
+ * Name: bbr_round
+ *
+ * Description:
+ *   Take the delivery rate of a round trip that just ended, and check if
+ *   STARTUP has found the bottleneck bandwidth.
+ *
+ ****************************************************************************/
+
+static void bbr_round(FAR struct tcp_conn_s *conn, FAR struct bbr_s *bbr,
+                      uint32_t now)
+{
+  uint32_t elapsed = MAX(now - bbr->round_stamp, 1);
+  uint32_t bw;
+
+  bbr->bw[bbr->bw_index] = (conn->cc_delivered - bbr->round_delivered) /
+                           elapsed;
+  bbr->bw_index          = (bbr->bw_index + 1) % BBR_BW_NSAMPLES;
+
+  bbr->round_seq         = conn->sndseq_max;
+  bbr->round_delivered   = conn->cc_delivered;
+  bbr->round_stamp       = now;
+
+  if (bbr->mode == BBR_STARTUP)
+    {
+      bw = bbr_max_bw(bbr);
+      if (bw >= bbr->full_bw + bbr->full_bw / 4)
+        {
+          bbr->full_bw     = bw;
+          bbr->full_bw_cnt = 0;
+        }
+      else if (++bbr->full_bw_cnt >= BBR_FULLBW_ROUNDS)
+        {
+          ninfo("BBR: bandwidth %" PRIu32 " bytes/ms, draining\n", bw);
+          bbr->mode = BBR_DRAIN;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_ack
+ ****************************************************************************/
+
+static void bbr_ack(FAR struct tcp_conn_s *conn, uint32_t acked,
+                    uint32_t rtt)
+{
+  FAR struct bbr_s *bbr = (FAR struct bbr_s *)conn->cc_priv;
+  uint32_t now = bbr_now();
+  uint32_t target;
+  uint64_t bdp;
+
+  /* Update the minimum RTT, and probe for it again when it is stale */
+
+  if (rtt > 0 && (bbr->min_rtt == 0 || rtt <= bbr->min_rtt))
+    {
+      bbr->min_rtt       = rtt;
+      bbr->min_rtt_stamp = now;
+    }
+  else if (bbr->mode != BBR_PROBE_RTT &&
+           now - bbr->min_rtt_stamp > BBR_MINRTT_WINDOW)
+    {
+      bbr->mode           = BBR_PROBE_RTT;
+      bbr->prior_cwnd     = conn->cwnd;
+      bbr->probe_rtt_done = now + BBR_PROBERTT_TIME;
+      bbr->min_rtt_stamp  = now;
+
+      if (rtt > 0)
+        {
+          bbr->min_rtt = rtt;
+        }
+    }
+
+  if (TCP_SEQ_GTE(conn->cc_una, bbr->round_seq))
+    {
+      bbr_round(conn, bbr, now);
+    }
+
+  /* The window is a multiple of the estimated bandwidth-delay product */
+
+  bdp = (uint64_t)bbr_max_bw(bbr) * bbr->min_rtt / 1000;
+  if (bdp == 0)
+    {
+      conn->cwnd += acked;
+      return;
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        conn->cwnd += acked;
+        return;
+
+      case BBR_DRAIN:
+        target = (uint32_t)MIN(bdp, UINT32_MAX);
+        if (conn->tx_unacked <= target)
+          {
+            bbr->mode        = BBR_PROBE_BW;
+            bbr->cycle_stamp = now;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        if (now - bbr->cycle_stamp > bbr->min_rtt / 1000)
+          {
+            bbr->cycle_index = (bbr->cycle_index + 1) % BBR_CYCLE_LEN;
+            bbr->cycle_stamp = now;
+          }
+
+        target = (uint32_t)MIN(bdp * BBR_CWND_GAIN / 100 *
+                               g_bbr_cycle_gain[bbr->cycle_index] / 100,
+                               UINT32_MAX);
+        break;
+
+      default: /* BBR_PROBE_RTT */
+        conn->cwnd = BBR_MINCWND(conn);
+        if ((int32_t)(now - bbr->probe_rtt_done) >= 0)
+          {
+            conn->cwnd = MAX(conn->cwnd, bbr->prior_cwnd);
+            bbr->mode  = bbr->full_bw_cnt >= BBR_FULLBW_ROUNDS ?
+                         BBR_PROBE_BW : BBR_STARTUP;
+            bbr->cycle_stamp = now;
+          }
+
+        return;
+    }
+
+  /* Approach the target as data is delivered */
+
+  target = MAX(target, BBR_MINCWND(conn));
+  if (conn->cwnd < target)
+    {
+      conn->cwnd = MIN(conn->cwnd + acked, target);
+    }
+  else
+    {
+      conn->cwnd = target;
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_loss
+ *
+ * Description:
+ *   The model does not treat loss as congestion: only a timeout, where
+ *   nothing is known to be in flight, restarts from one segment.
+ *
+ ****************************************************************************/
+
+static void bbr_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  if (timeout)
+    {
+      conn->cwnd = conn->mss;
+    }
+}
+
+#endif /* CONFIG_NET_TCP_CC_BBR */
@@ -0,0 +1,246 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC8312 with C = 0.4 and beta = 0.7, in integer arithmetic */
+
+#define CUBIC_BETA_NUM    7     /* beta = 7 / 10 */
+#define CUBIC_BETA_DEN    10
+#define CUBIC_FC_NUM      17    /* (1 + beta) / 2, for fast convergence */
+#define CUBIC_FC_DEN      20
+#define CUBIC_ALPHA_NUM   9     /* 3 * (1 - beta) / (1 + beta) */
+#define CUBIC_ALPHA_DEN   17
+
+/* W(t) = C * (t - K)^3 + W_max in segments (t in seconds) */
+
+#define CUBIC_KCUBE(mss)  (2500000000ull / (mss))  /* ms^3 per byte */
+#define CUBIC_MAXDELTA    100000                   /* ms */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cubic_s
+{
+  uint32_t w_max;         /* Window before the last reduction */
+  uint32_t origin;        /* The window the cubic function plateaus at */
+  uint32_t k;             /* Time to reach origin (ms) */
+  uint32_t epoch;         /* Start of the current epoch (ms) */
+  uint32_t w_est;         /* Window of a standard TCP flow */
+  bool     started;       /* True: epoch, origin and k are valid */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked,
+                      uint32_t rtt);
+static void cubic_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",
+  cubic_init,
+  cubic_ack,
+  cubic_loss
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_now
+ ****************************************************************************/
+
+static uint32_t cubic_now(void)
+{
+  return (uint32_t)TICK2MSEC(clock_systime_ticks());
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct cubic_s *cubic = (FAR struct cubic_s *)conn->cc_priv;
+
+  DEBUGASSERT(sizeof(*cubic) <= sizeof(conn->cc_priv));
+
+  cubic->w_max   = 0;
+  cubic->started = false;
+}
+
+/****************************************************************************
+ * Name: cubic_ack
+ ****************************************************************************/
+
+static void cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked,
+                      uint32_t rtt)
+{
+  FAR struct cubic_s *cubic = (FAR struct cubic_s *)conn->cc_priv;
+  uint32_t mss = conn->mss;
+  uint64_t offs;
+  uint32_t target;
+  int32_t delta;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      conn->cwnd += MIN(acked, 2 * mss);
+      return;
+    }
+
+  /* Start a new epoch on the first ACK of congestion avoidance */
+
+  if (!cubic->started)
+    {
+      cubic->started = true;
+      cubic->epoch   = cubic_now();
+      cubic->w_est   = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          cubic->origin = cubic->w_max;
+          cubic->k      = cubic_cbrt((uint64_t)(cubic->w_max - conn->cwnd) *
+                                     CUBIC_KCUBE(mss));
+        }
+      else
+        {
+          cubic->origin = conn->cwnd;
+          cubic->k      = 0;
+        }
+    }
+
+  /* The window the cubic function gives one RTT from now */
+
+  delta = (int32_t)(cubic_now() - cubic->epoch + conn->srtt / 1000 -
+                    cubic->k);
+  delta = MAX(MIN(delta, CUBIC_MAXDELTA), -CUBIC_MAXDELTA);
+
+  offs  = (uint64_t)(delta < 0 ? -delta : delta);
+  offs  = offs * offs * offs / 1000 * 4 * mss / 10000000;
+
+  if (delta >= 0)
+    {
+      target = cubic->origin + (uint32_t)MIN(offs, UINT32_MAX / 2);
+    }
+  else
+    {
+      target = offs < cubic->origin ? cubic->origin - (uint32_t)offs : 0;
+    }
+
+  /* Never grow slower than standard TCP would (TCP-friendly region) */
+
+  cubic->w_est += (uint64_t)acked * mss * CUBIC_ALPHA_NUM /
+                  ((uint64_t)conn->cwnd * CUBIC_ALPHA_DEN);
+  target = MAX(target, cubic->w_est);
+
+  /* Grow towards the target, at most by half of the ACKed bytes */
+
+  if (target > conn->cwnd)
+    {
+      target = MIN(target, conn->cwnd + conn->cwnd / 2);
+      conn->cwnd += (uint64_t)(target - conn->cwnd) * acked / conn->cwnd;
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_loss
+ ****************************************************************************/
+
+static void cubic_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  FAR struct cubic_s *cubic = (FAR struct cubic_s *)conn->cc_priv;
+
+  /* Fast convergence: release bandwidth for new flows if the window did
+   * not reach its former maximum.
+   */
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = conn->cwnd / CUBIC_FC_DEN * CUBIC_FC_NUM;
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  conn->ssthresh = MAX(conn->cwnd / CUBIC_BETA_DEN * CUBIC_BETA_NUM,
+                       2 * (uint32_t)conn->mss);
+  conn->cwnd     = timeout ? conn->mss : conn->ssthresh;
+  cubic->started = false;
+}
+
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
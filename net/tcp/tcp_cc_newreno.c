@@ -0,0 +1,124 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_newreno.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/net/netconfig.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_CC
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct newreno_s
+{
+  uint32_t acked;         /* Bytes ACKed since cwnd last grew in congestion
+                           * avoidance */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void newreno_init(FAR struct tcp_conn_s *conn);
+static void newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked,
+                        uint32_t rtt);
+static void newreno_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "reno",
+  newreno_init,
+  newreno_ack,
+  newreno_loss
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: newreno_init
+ ****************************************************************************/
+
+static void newreno_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct newreno_s *nr = (FAR struct newreno_s *)conn->cc_priv;
+
+  nr->acked = 0;
+}
+
+/****************************************************************************
+ * Name: newreno_ack
+ *
+ * Description:
+ *   Grow cwnd by the ACKed bytes in slow start, limited to two segments
+ *   per ACK, and by one segment per window in congestion avoidance
+ *   (RFC5681 with appropriate byte counting, RFC3465).
+ *
+ ****************************************************************************/
+
+static void newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked,
+                        uint32_t rtt)
+{
+  FAR struct newreno_s *nr = (FAR struct newreno_s *)conn->cc_priv;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      conn->cwnd += MIN(acked, 2 * (uint32_t)conn->mss);
+      return;
+    }
+
+  nr->acked += acked;
+  if (nr->acked >= conn->cwnd)
+    {
+      nr->acked  -= conn->cwnd;
+      conn->cwnd += conn->mss;
+    }
+}
+
+/****************************************************************************
+ * Name: newreno_loss
+ ****************************************************************************/
+
+static void newreno_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  FAR struct newreno_s *nr = (FAR struct newreno_s *)conn->cc_priv;
+
+  conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * (uint32_t)conn->mss);
+  conn->cwnd     = timeout ? conn->mss : conn->ssthresh;
+  nr->acked      = 0;
+}
+
+#endif /* CONFIG_NET_TCP_CC */
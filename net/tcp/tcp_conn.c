@@ -65,6 +65,7 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
 #include "arp/arp.h"
 #include "icmpv6/icmpv6.h"
@@ -88,10 +89,94 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The connected TCP connections hashed by lport, rport and raddr */
+
+static dq_queue_t g_tcp_hash[CONFIG_NET_TCP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey, tcp_first and tcp_next
+ *
+ * Description:
+ *   Iterate over the connected TCP connections that may match a segment.
+ *   With CONFIG_NET_TCP_CONN_HASH this is the bucket of the segment's
+ *   ports and source address (all in network byte order); otherwise it is
+ *   the list of all connections.  The local address is not part of the key
+ *   because a connection may be bound to INADDR_ANY.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+#  if (CONFIG_NET_TCP_CONN_HASHSIZE & (CONFIG_NET_TCP_CONN_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_TCP_CONN_HASHSIZE must be a power of two
+#  endif
+
+#  define tcp_first(k)  tcp_hashconn(g_tcp_hash[k].head)
+#  define tcp_next(c)   tcp_hashconn((c)->hnode.flink)
+
+static inline FAR struct tcp_conn_s *tcp_hashconn(FAR dq_entry_t *node)
+{
+  return node ? container_of(node, struct tcp_conn_s, hnode) : NULL;
+}
+
+static inline unsigned int tcp_hashkey(uint16_t lport, uint16_t rport,
+                                       uint32_t raddr)
+{
+  uint32_t key = (((uint32_t)lport << 16) | rport) ^ raddr;
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key & (CONFIG_NET_TCP_CONN_HASHSIZE - 1);
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return ((uint32_t)(addr[0] ^ addr[2] ^ addr[4] ^ addr[6]) << 16) |
+         (addr[1] ^ addr[3] ^ addr[5] ^ addr[7]);
+}
+#endif
+
+static unsigned int tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_hashkey(conn->lport, conn->rport,
+                         tcp_ipv6_fold(conn->u.ipv6.raddr));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_hashkey(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif
+}
+
+#  define tcp_hash_add(c) \
+     dq_addlast(&(c)->hnode, &g_tcp_hash[tcp_conn_hashkey(c)])
+#  define tcp_hash_rem(c) \
+     dq_rem(&(c)->hnode, &g_tcp_hash[tcp_conn_hashkey(c)])
+#else
+#  define tcp_hashkey(l, r, a) 0
+#  define tcp_first(k) \
+     ((FAR struct tcp_conn_s *)g_active_tcp_connections.head)
+#  define tcp_next(c)   ((FAR struct tcp_conn_s *)(c)->sconn.node.flink)
+#  define tcp_hash_add(c)
+#  define tcp_hash_rem(c)
+#endif
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -102,11 +187,15 @@ static dq_queue_t g_active_tcp_connections;
  *   Primary uses: (1) to determine if a port number is available, (2) to
  *   To identify the socket that will accept new connections on a local port.
  *
+ *   If 'reuseport', only the sockets that are bound to the port, but not
+ *   connected, and that do not share the port with SO_REUSEPORT are
+ *   considered.
+ *
  ****************************************************************************/
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, bool reuseport)
 {
   FAR struct tcp_conn_s *conn = NULL;
 
@@ -114,6 +203,15 @@ static FAR struct tcp_conn_s *
 
   while ((conn = tcp_nextconn(conn)) != NULL)
     {
+#ifdef CONFIG_NET_REUSEPORT
+      if (reuseport &&
+          ((conn->tcpstateflags & TCP_STATE_MASK) != TCP_ALLOCATED ||
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT)))
+        {
+          continue;
+        }
+#endif
+
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -186,9 +284,10 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+  conn       = tcp_first(tcp_hashkey(tcp->destport, tcp->srcport,
+                                     srcipaddr));
 
   while (conn)
     {
@@ -225,7 +324,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_next(conn);
     }
 
   return conn;
@@ -253,9 +352,10 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+  conn       = tcp_first(tcp_hashkey(tcp->destport, tcp->srcport,
+                                     tcp_ipv6_fold(ip->srcipaddr)));
 
   while (conn)
     {
@@ -292,13 +392,52 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_next(conn);
     }
 
   return conn;
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: tcp_bindport
+ *
+ * Description:
+ *   Verify or select the local port for bind().  Sockets that all set
+ *   SO_REUSEPORT may be bound to the same address and port.
+ *
+ * Returned Value:
+ *   Selected or verified port number in network order on success, a negated
+ *   errno on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int tcp_bindport(FAR struct tcp_conn_s *conn, uint8_t domain,
+                        FAR const union ip_addr_u *ipaddr, uint16_t portno)
+{
+#ifdef CONFIG_NET_REUSEPORT
+  if (portno != 0 && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      if (tcp_listener(domain, ipaddr, portno, true)
+#if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
+          || (domain == PF_INET &&
+              ipv4_nat_port_inuse(IP_PROTO_TCP, ipaddr->ipv4, portno))
+#endif
+      )
+        {
+          return -EADDRINUSE;
+        }
+
+      return portno;
+    }
+#endif
+
+  return tcp_selectport(domain, ipaddr, portno);
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_bind
  *
@@ -327,12 +466,12 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  port = tcp_selectport(PF_INET,
-                       (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+  port = tcp_bindport(conn, PF_INET,
+                      (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
+                      addr->sin_port);
   if (port < 0)
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
+      nerr("ERROR: tcp_bindport failed: %d\n", port);
       net_unlock();
       return port;
     }
@@ -394,12 +533,12 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* The port number must be unique for this address binding */
 
-  port = tcp_selectport(PF_INET6,
+  port = tcp_bindport(conn, PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
                 addr->sin6_port);
   if (port < 0)
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
+      nerr("ERROR: tcp_bindport failed: %d\n", port);
       net_unlock();
       return port;
     }
@@ -555,7 +694,7 @@ int tcp_selectport(uint8_t domain,
 
           portno = HTONS(g_last_tcp_port);
         }
-      while (tcp_listener(domain, ipaddr, portno)
+      while (tcp_listener(domain, ipaddr, portno, false)
 #if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
              || (domain == PF_INET &&
                  ipv4_nat_port_inuse(IP_PROTO_TCP, ipaddr->ipv4, portno))
@@ -568,7 +707,7 @@ int tcp_selectport(uint8_t domain,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno)
+      if (tcp_listener(domain, ipaddr, portno, false)
 #if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
           || (domain == PF_INET &&
               ipv4_nat_port_inuse(IP_PROTO_TCP, ipaddr->ipv4, portno))
@@ -728,6 +867,7 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
 #endif
+      nxrmutex_init(&conn->sconn.s_lock);
 #ifdef CONFIG_NET_TCP_KEEPALIVE
       conn->keepidle      = 2 * DSEC_PER_HOUR;
       conn->keepintvl     = 2 * DSEC_PER_SEC;
@@ -799,6 +939,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_hash_rem(conn);
     }
 
   /* Release any read-ahead buffers attached to the connection */
@@ -806,6 +947,12 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   iob_free_chain(conn->readahead);
   conn->readahead = NULL;
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  /* Release any out-of-order data held by the connection */
+
+  tcp_ofoseg_free(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -847,6 +994,8 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     }
 #endif
 
+  nxrmutex_destroy(&conn->sconn.s_lock);
+
   /* Mark the connection available and put it into the free list */
 
   conn->tcpstateflags = TCP_CLOSED;
@@ -1072,6 +1221,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_hash_add(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1351,6 +1501,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_hash_add(conn);
   ret = OK;
 
 errout_with_lock:
@@ -26,6 +26,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -41,6 +42,60 @@
 
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+/****************************************************************************
+ * Name: tcp_get_info
+ *
+ * Description:
+ *   Fill the TCP_INFO statistics of a connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_get_info(FAR struct tcp_conn_s *conn,
+                         FAR struct tcp_info *info)
+{
+  uint32_t mss = conn->mss > 0 ? conn->mss : 1;
+
+  memset(info, 0, sizeof(*info));
+
+  info->tcpi_state        = conn->tcpstateflags & TCP_STATE_MASK;
+  info->tcpi_ca_state     = conn->cc_state;
+  info->tcpi_retransmits  = conn->nrtx;
+  info->tcpi_rto          = conn->rto * 500000;
+  info->tcpi_snd_mss      = conn->mss;
+  info->tcpi_rcv_mss      = conn->mss;
+  info->tcpi_unacked      = conn->tx_unacked / mss;
+  info->tcpi_rtt          = conn->srtt;
+  info->tcpi_rttvar       = conn->rttvar;
+  info->tcpi_snd_ssthresh = conn->ssthresh / mss;
+  info->tcpi_snd_cwnd     = conn->cwnd / mss;
+  info->tcpi_advmss       = conn->mss;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if ((conn->flags & TCP_WSCALE) != 0)
+    {
+      info->tcpi_options   |= TCPI_OPT_WSCALE;
+      info->tcpi_snd_wscale = conn->snd_scale;
+      info->tcpi_rcv_wscale = conn->rcv_scale;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  if ((conn->flags & TCP_SACK) != 0)
+    {
+      info->tcpi_options   |= TCPI_OPT_SACK;
+    }
+#endif
+}
+#endif /* CONFIG_NET_TCP_CC */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -82,9 +137,9 @@
 int tcp_getsockopt(FAR struct socket *psock, int option,
                    FAR void *value, FAR socklen_t *value_len)
 {
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* Keep alive options are the only TCP protocol socket option currently
-   * supported.
+#if defined(CONFIG_NET_TCP_KEEPALIVE) || defined(CONFIG_NET_TCP_CC)
+  /* Keep alive and congestion control options are the only TCP protocol
+   * socket options currently supported.
    */
 
   FAR struct tcp_conn_s *conn;
@@ -105,10 +160,11 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
       return -ENOTCONN;
     }
 
-  /* Handle the Keep-Alive option */
+  /* Handle the TCP protocol options */
 
   switch (option)
     {
+#ifdef CONFIG_NET_TCP_KEEPALIVE
       /* Handle the SO_KEEPALIVE socket-level option.
        *
        * NOTE: SO_KEEPALIVE is not really a socket-level option; it is a
@@ -137,6 +193,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
             ret                = OK;
           }
         break;
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
 
       case TCP_NODELAY:  /* Avoid coalescing of small segments. */
         if (*value_len < sizeof(int))
@@ -155,6 +212,38 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          FAR const char *name = tcp_cc_name(conn);
+          socklen_t len = strlen(name) + 1;
+
+          /* The name is truncated to the room given */
+
+          len        = MIN(len, *value_len);
+          memcpy(value, name, len);
+          *value_len = len;
+          ret        = OK;
+        }
+        break;
+
+      case TCP_INFO: /* Connection statistics */
+        {
+          struct tcp_info info;
+
+          net_lock();
+          tcp_get_info(conn, &info);
+          net_unlock();
+
+          *value_len = MIN(*value_len, sizeof(info));
+          memcpy(value, &info, *value_len);
+          ret        = OK;
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+
       case TCP_KEEPIDLE:  /* Start keepalives after this IDLE period */
       case TCP_KEEPINTVL: /* Interval between keepalives */
         {
@@ -221,6 +310,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
             ret              = OK;
           }
         break;
+#endif /* CONFIG_NET_TCP_KEEPALIVE */
 
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
@@ -231,7 +321,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
   return ret;
 #else
   return -ENOPROTOOPT;
-#endif /* CONFIG_NET_TCP_KEEPALIVE */
+#endif /* CONFIG_NET_TCP_KEEPALIVE || CONFIG_NET_TCP_CC */
 }
 
 #endif /* CONFIG_NET_TCPPROTO_OPTIONS */
@@ -314,9 +314,11 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!netdev_rxcsum_verified(dev) && tcp_chksum(dev) != 0xffff)
     {
-      /* Compute and check the TCP checksum. */
+      /* Compute and check the TCP checksum, unless the hardware already
+       * did.
+       */
 
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.tcp.drop++;
@@ -475,9 +477,17 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
                            IPDATA(tcpiplen + 1 + i) == TCP_OPT_WS_LEN)
                     {
                       conn->snd_scale = IPDATA(tcpiplen + 2 + i);
-                      conn->rcv_scale = CONFIG_NET_TCP_WINDOW_SCALE_FACTOR;
+                      conn->rcv_scale = tcp_get_rcvscale(conn);
                       conn->flags    |= TCP_WSCALE;
                     }
+#endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+                  else if (opt == TCP_OPT_SACK_PERM &&
+                           IPDATA(tcpiplen + 1 + i) ==
+                           TCP_OPT_SACK_PERM_LEN)
+                    {
+                      conn->flags    |= TCP_SACK;
+                    }
 #endif
                   else
                     {
@@ -551,30 +561,7 @@ found:
 
           /* Notify the listener for the connection of the reset event */
 
-#ifdef CONFIG_NET_IPv6
-#  ifdef CONFIG_NET_IPv4
-          if (domain == PF_INET6)
-#  endif
-            {
-              net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
-            }
-#endif
-
-#ifdef CONFIG_NET_IPv4
-#  ifdef CONFIG_NET_IPv6
-          if (domain == PF_INET)
-#  endif
-            {
-              net_ipv4addr_copy(uaddr.ipv4.laddr,
-                                net_ip4addr_conv32(IPv4BUF->destipaddr));
-            }
-#endif
-
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-          listener = tcp_findlistener(&uaddr, conn->lport, domain);
-#else
-          listener = tcp_findlistener(&uaddr, conn->lport);
-#endif
+          listener = tcp_connlistener(conn);
 
           /* We must free this TCP connection structure; this connection
            * will never be established.  There should only be one reference
@@ -666,7 +653,20 @@ found:
             }
           else
             {
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+              /* Keep the data of an out-of-order segment until the data
+               * before it arrives.  The duplicate ACK reports it.
+               */
+
+              if ((conn->tcpstateflags & TCP_STATE_MASK) ==
+                  TCP_ESTABLISHED &&
+                  (tcp->flags & (TCP_SYN | TCP_FIN | TCP_URG)) == 0)
+                {
+                  tcp_ofoseg_queue(dev, conn, seq);
+                }
+#else
               /* We never queue out-of-order segments. */
+#endif
 
               tcp_send(dev, conn, TCP_ACK, tcpiplen);
               return;
@@ -862,6 +862,9 @@ found:
             conn->tx_unacked    = 0;
             tcp_snd_wnd_init(conn, tcp);
             tcp_snd_wnd_update(conn, tcp);
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
 
             flags               = TCP_CONNECTED;
             ninfo("TCP state: TCP_ESTABLISHED\n");
@@ -937,10 +940,19 @@ found:
                     else if (opt == TCP_OPT_WS &&
                              IPDATA(tcpiplen + 1 + i) == TCP_OPT_WS_LEN)
                       {
+                        /* rcv_scale holds the factor offered in our SYN */
+
                         conn->snd_scale = IPDATA(tcpiplen + 2 + i);
-                        conn->rcv_scale = CONFIG_NET_TCP_WINDOW_SCALE_FACTOR;
                         conn->flags    |= TCP_WSCALE;
                       }
+#endif
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+                    else if (opt == TCP_OPT_SACK_PERM &&
+                             IPDATA(tcpiplen + 1 + i) ==
+                             TCP_OPT_SACK_PERM_LEN)
+                      {
+                        conn->flags    |= TCP_SACK;
+                      }
 #endif
                     else
                       {
@@ -962,6 +974,15 @@ found:
                   }
               }
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+            /* Without the option from the peer, no scaling is done */
+
+            if ((conn->flags & TCP_WSCALE) == 0)
+              {
+                conn->rcv_scale = 0;
+              }
+#endif
+
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
             conn->rcv_adv = tcp_getsequence(conn->rcvseq);
@@ -974,6 +995,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -1157,6 +1181,15 @@ found:
 
         if (dev->d_len > 0 && (conn->tcpstateflags & TCP_STOPPED) == 0)
           {
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+            /* Deliver the held data that this segment makes contiguous */
+
+            if (conn->nofosegs > 0)
+              {
+                tcp_ofoseg_deliver(dev, conn);
+              }
+#endif
+
             flags |= TCP_NEWDATA;
           }
 
@@ -53,8 +53,27 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+#  define tcp_reuseport(c)  _SO_GETOPT((c)->sconn.s_options, SO_REUSEPORT)
+#else
+#  define tcp_reuseport(c)  false
+#endif
+
+/* The IP domain of the listeners without dual-stack support */
+
+#ifdef CONFIG_NET_IPv4
+#  define TCP_DOMAIN        PF_INET
+#else
+#  define TCP_DOMAIN        PF_INET6
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -63,32 +82,106 @@
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The same listeners, hashed by local port for tcp_findlistener() */
+
+static dq_queue_t g_tcp_listenhash[CONFIG_NET_TCP_CONN_HASHSIZE];
+
+#  define tcp_listenhash(p) \
+     (&g_tcp_listenhash[(((p) >> 8) ^ (p)) & \
+                        (CONFIG_NET_TCP_CONN_HASHSIZE - 1)])
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: tcp_findlistener
+ * Name: tcp_listenmatch
  *
  * Description:
- *   Return the connection listener for connections on this port (if any)
- *
- * Assumptions:
- *   This function is called from network logic with the network locked.
+ *   Return true if the listener 'conn' accepts connections to this local
+ *   address and port.
  *
  ****************************************************************************/
 
+static bool tcp_listenmatch(FAR struct tcp_conn_s *conn,
+                            FAR union ip_binding_u *uaddr,
+                            uint16_t portno, uint8_t domain)
+{
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
-                                        uint8_t domain)
+  if (conn == NULL || conn->lport != portno || conn->domain != domain)
 #else
-FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno)
+  if (conn == NULL || conn->lport != portno)
+#endif
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
+             net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
+             net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
+    }
 #endif
+}
+
+/****************************************************************************
+ * Name: tcp_scanlisteners
+ *
+ * Description:
+ *   Return the first listener for connections on this port that does not
+ *   share the port with SO_REUSEPORT; if there is none, the listener
+ *   numbered 'index' among those that do.  The number of listeners seen
+ *   sharing the port is returned in 'nshared'.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *
+  tcp_scanlisteners(FAR union ip_binding_u *uaddr, uint16_t portno,
+                    uint8_t domain, int index, FAR int *nshared)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR dq_entry_t *node;
+
+  *nshared = 0;
+
+  /* Examine each listener that hashes to the same bucket as the port */
+
+  for (node = dq_peek(tcp_listenhash(portno)); node; node = dq_next(node))
+    {
+      FAR struct tcp_conn_s *conn =
+        container_of(node, struct tcp_conn_s, hnode);
+
+      if (tcp_listenmatch(conn, uaddr, portno, domain) &&
+          (!tcp_reuseport(conn) || (*nshared)++ == index))
+        {
+          /* Yes.. we found a listener on this port */
+
+          return conn;
+        }
+    }
+#else
   int ndx;
 
+  *nshared = 0;
+
   /* Examine each connection structure in each slot of the listener list */
 
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -98,53 +191,132 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
-#else
-      if (conn && conn->lport == portno)
-#endif
-        {
-#ifdef CONFIG_NET_IPv6
-#  ifdef CONFIG_NET_IPv4
-          if (domain == PF_INET6)
-#  endif
-            {
-              if (net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
-                  net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr))
-                {
-                  /* Yes.. we found a listener on this port */
-
-                  return conn;
-                }
-            }
-#endif
 
-#ifdef CONFIG_NET_IPv4
-#  ifdef CONFIG_NET_IPv6
-          if (domain == PF_INET)
-#  endif
-            {
-              if (net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
-                  net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
-                {
-                  /* Yes.. we found a listener on this port */
+      if (tcp_listenmatch(conn, uaddr, portno, domain) &&
+          (!tcp_reuseport(conn) || (*nshared)++ == index))
+        {
+          /* Yes.. we found a listener on this port */
 
-                  return conn;
-                }
-            }
-#endif
+          return conn;
         }
     }
+#endif
 
   /* No listener for this port */
 
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_selectlistener
+ *
+ * Description:
+ *   Return the connection listener for connections on this port (if any).
+ *   If several listeners share the port with SO_REUSEPORT, the flow hash
+ *   'hash' selects one of them.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *
+  tcp_selectlistener(FAR union ip_binding_u *uaddr, uint16_t portno,
+                     uint8_t domain, uint32_t hash)
+{
+  FAR struct tcp_conn_s *conn;
+  int nshared;
+
+  conn = tcp_scanlisteners(uaddr, portno, domain, -1, &nshared);
+  if (conn == NULL && nshared > 0)
+    {
+      conn = tcp_scanlisteners(uaddr, portno, domain, hash % nshared,
+                               &nshared);
+    }
+
+  return conn;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_findlistener
+ *
+ * Description:
+ *   Return the connection listener for connections on this port (if any)
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
+                                        uint16_t portno,
+                                        uint8_t domain)
+{
+  return tcp_selectlistener(uaddr, portno, domain, 0);
+}
+#else
+FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
+                                        uint16_t portno)
+{
+  return tcp_selectlistener(uaddr, portno, TCP_DOMAIN, 0);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connlistener
+ *
+ * Description:
+ *   Return the listener for the connection 'conn' in the 3-way handshake.
+ *   Among the listeners sharing the port with SO_REUSEPORT, the remote
+ *   address and port of the connection always select the same one.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_connlistener(FAR struct tcp_conn_s *conn)
+{
+  uint32_t hash = 0;
+
+#ifdef CONFIG_NET_REUSEPORT
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      FAR const uint16_t *raddr = conn->u.ipv6.raddr;
+
+      hash = ((uint32_t)(raddr[0] ^ raddr[2] ^ raddr[4] ^ raddr[6]) << 16) |
+             (raddr[1] ^ raddr[3] ^ raddr[5] ^ raddr[7]);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      hash = conn->u.ipv4.raddr;
+    }
+#endif
+
+  hash  = (hash ^ conn->rport) * 0x9e3779b1;
+  hash ^= hash >> 16;
+#endif
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  return tcp_selectlistener(&conn->u, conn->lport, conn->domain, hash);
+#else
+  return tcp_selectlistener(&conn->u, conn->lport, TCP_DOMAIN, hash);
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -167,6 +339,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
       if (tcp_listenports[ndx] == conn)
         {
           tcp_listenports[ndx] = NULL;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+          dq_rem(&conn->hnode, tcp_listenhash(conn->lport));
+#endif
           ret = OK;
           break;
         }
@@ -189,6 +364,8 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+  FAR struct tcp_conn_s *listener;
+  int nshared;
   int ndx;
   int ret;
 
@@ -198,13 +375,19 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   net_lock();
 
-  /* First, check if there is already a socket listening on this port */
+  /* First, check if there is already a socket listening on this port.
+   * Listeners that all set SO_REUSEPORT may share the port.
+   */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  listener = tcp_scanlisteners(&conn->u, conn->lport, conn->domain, -1,
+                               &nshared);
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  listener = tcp_scanlisteners(&conn->u, conn->lport, TCP_DOMAIN, -1,
+                               &nshared);
 #endif
+
+  if (listener != NULL || (nshared > 0 && !tcp_reuseport(conn)))
     {
       /* Yes, then we must refuse this request */
 
@@ -229,6 +412,9 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               /* Yes.. we found it */
 
               tcp_listenports[ndx] = conn;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+              dq_addlast(&conn->hnode, tcp_listenhash(conn->lport));
+#endif
               ret = OK;
               break;
             }
@@ -285,11 +471,9 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
    * the connection.
    */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  listener = tcp_findlistener(&conn->u, portno, conn->domain);
-#else
-  listener = tcp_findlistener(&conn->u, portno);
-#endif
+  DEBUGASSERT(conn->lport == portno);
+
+  listener = tcp_connlistener(conn);
   if (listener != NULL)
     {
       /* Yes, there is a listener.  Is it accepting connections now? */
@@ -165,6 +165,15 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 
   niob_avail = iob_navail(true);
 
+#ifdef CONFIG_IOB_POOLS
+  /* Nor more than TCP may still charge to its pool */
+
+  if (niob_avail > iob_pool_navail(IOB_POOL_TCP))
+    {
+      niob_avail = iob_pool_navail(IOB_POOL_TCP);
+    }
+#endif
+
   /* Is there a a queue entry and IOBs available for read-ahead buffering? */
 
   if (niob_avail > 0)
@@ -235,6 +244,43 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
   return recvwndo;
 }
 
+/****************************************************************************
+ * Name: tcp_get_rcvscale
+ *
+ * Description:
+ *   Calculate the window scale factor to offer to the peer: the smallest
+ *   one that lets the advertised window cover the read-ahead buffering
+ *   available to the connection.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Returned Value:
+ *   The window scale factor.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_rcvscale(FAR struct tcp_conn_s *conn)
+{
+  uint32_t recvwndo;
+  uint8_t scale = CONFIG_NET_TCP_WINDOW_SCALE_FACTOR;
+
+  /* This needs to be in sync with tcp_maxrcvwin() */
+
+  recvwndo = tcp_calc_rcvsize(conn, (CONFIG_IOB_NBUFFERS -
+                                     CONFIG_IOB_THROTTLE) *
+                                     CONFIG_IOB_BUFSIZE);
+
+  while (scale < TCP_MAX_WSCALE && (recvwndo >> scale) > UINT16_MAX)
+    {
+      scale++;
+    }
+
+  return scale;
+}
+#endif
+
 bool tcp_should_send_recvwindow(FAR struct tcp_conn_s *conn)
 {
   FAR struct net_driver_s *dev = conn->dev;
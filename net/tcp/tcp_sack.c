@@ -0,0 +1,373 @@
+/****************************************************************************
+ * net/tcp/tcp_sack.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ofoseg_merge
+ *
+ * Description:
+ *   Merge the range 'b' into the range 'a'.  'b' must start inside 'a' or
+ *   right after it.
+ *
+ ****************************************************************************/
+
+static void tcp_ofoseg_merge(FAR struct tcp_ofoseg_s *a,
+                             FAR struct tcp_ofoseg_s *b)
+{
+  if (TCP_SEQ_LTE(b->right, a->right))
+    {
+      /* Nothing new in 'b' */
+
+      iob_free_chain(b->data);
+    }
+  else
+    {
+      iob_concat(a->data,
+                 iob_trimhead(b->data, TCP_SEQ_SUB(a->right, b->left)));
+      a->right = b->right;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_remove
+ *
+ * Description:
+ *   Remove the range at 'index', without releasing its data.
+ *
+ ****************************************************************************/
+
+static void tcp_ofoseg_remove(FAR struct tcp_ofoseg_s *segs,
+                              FAR uint8_t *nsegs, int index)
+{
+  (*nsegs)--;
+  memmove(&segs[index], &segs[index + 1],
+          (*nsegs - index) * sizeof(struct tcp_ofoseg_s));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ofoseg_queue
+ *
+ * Description:
+ *   Keep the payload of a segment received beyond rcvseq until the data
+ *   before it arrives.  On success, the packet in d_iob is consumed and a
+ *   fresh d_iob is prepared for the ACK.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received segment.
+ *          d_appdata and d_len describe its payload.
+ *   conn - The TCP connection structure holding connection information.
+ *   seq  - The sequence number of the first byte of the payload.
+ *
+ * Returned Value:
+ *   True if the payload was kept.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_ofoseg_queue(FAR struct net_driver_s *dev,
+                      FAR struct tcp_conn_s *conn, uint32_t seq)
+{
+  struct tcp_ofoseg_s segs[TCP_SACK_RANGES_MAX + 1];
+  FAR struct iob_s *iob;
+  unsigned int offset;
+  uint32_t right = TCP_SEQ_ADD(seq, dev->d_len);
+  uint32_t total = dev->d_len;
+  uint8_t nsegs = conn->nofosegs;
+  int i;
+
+  /* Only data inside the window that we advertised is kept, so the
+   * read-ahead budget bounds it as well.
+   */
+
+  if (dev->d_len == 0 || dev->d_iob == NULL ||
+      TCP_SEQ_GT(right, conn->rcv_adv))
+    {
+      return false;
+    }
+
+  for (i = 0; i < nsegs; i++)
+    {
+      total += TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left);
+    }
+
+  if (total > CONFIG_NET_TCP_OUT_OF_ORDER_BUFSIZE)
+    {
+      ninfo("Out-of-order buffer full, dropping seq=%" PRIu32 "\n", seq);
+      return false;
+    }
+
+  /* Take the payload from the packet */
+
+  offset = (dev->d_appdata - dev->d_iob->io_data) - dev->d_iob->io_offset;
+  iob = iob_trimhead(dev->d_iob, offset);
+  if (iob->io_pktlen > dev->d_len)
+    {
+      iob = iob_trimtail(iob, iob->io_pktlen - dev->d_len);
+    }
+
+  netdev_iob_clear(dev);
+
+  /* Insert the new range in sequence number order */
+
+  memcpy(segs, conn->ofosegs, nsegs * sizeof(struct tcp_ofoseg_s));
+  for (i = nsegs; i > 0 && TCP_SEQ_GT(segs[i - 1].left, seq); i--)
+    {
+      segs[i] = segs[i - 1];
+    }
+
+  segs[i].left  = seq;
+  segs[i].right = right;
+  segs[i].data  = iob;
+  nsegs++;
+
+  /* Coalesce the ranges that now overlap or touch */
+
+  for (i = 0; i + 1 < nsegs; )
+    {
+      if (TCP_SEQ_LT(segs[i].right, segs[i + 1].left))
+        {
+          i++;
+        }
+      else
+        {
+          tcp_ofoseg_merge(&segs[i], &segs[i + 1]);
+          tcp_ofoseg_remove(segs, &nsegs, i + 1);
+        }
+    }
+
+  /* Give up the farthest range if there are too many */
+
+  if (nsegs > TCP_SACK_RANGES_MAX)
+    {
+      nsegs--;
+      iob_free_chain(segs[nsegs].data);
+    }
+
+  memcpy(conn->ofosegs, segs, nsegs * sizeof(struct tcp_ofoseg_s));
+  conn->nofosegs = nsegs;
+  conn->ofo_last = seq;
+
+  ninfo("Queued out-of-order seq=%" PRIu32 "-%" PRIu32 " nsegs=%u\n",
+        seq, right, nsegs);
+
+  /* Prepare a new buffer for the ACK */
+
+  netdev_iob_prepare(dev, true, 0);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_deliver
+ *
+ * Description:
+ *   Append the out-of-order data that the in-order segment in d_iob makes
+ *   contiguous to its payload, so that it is delivered to the application
+ *   with that segment.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure containing the received segment.
+ *          d_appdata and d_len describe its payload, which starts at
+ *          rcvseq.
+ *   conn - The TCP connection structure holding connection information.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_ofoseg_deliver(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  unsigned int offset;
+  uint32_t right;
+  uint32_t len;
+
+  right  = TCP_SEQ_ADD(tcp_getsequence(conn->rcvseq), dev->d_len);
+  offset = (dev->d_appdata - dev->d_iob->io_data) - dev->d_iob->io_offset;
+
+  while (conn->nofosegs > 0 && TCP_SEQ_LTE(conn->ofosegs[0].left, right))
+    {
+      seg = &conn->ofosegs[0];
+
+      if (TCP_SEQ_GT(seg->right, right))
+        {
+          len = TCP_SEQ_SUB(seg->right, right);
+          if (dev->d_len + len > UINT16_MAX)
+            {
+              /* Too much for one packet.  Discard the rest; the peer must
+               * resend it if it is never acknowledged (RFC 2018).
+               */
+
+              nwarn("WARNING: Dropping out-of-order data\n");
+              tcp_ofoseg_free(conn);
+              break;
+            }
+
+          /* Let the payload end the packet, then append the new data */
+
+          if (dev->d_iob->io_pktlen > offset + dev->d_len)
+            {
+              dev->d_iob = iob_trimtail(dev->d_iob, dev->d_iob->io_pktlen -
+                                        offset - dev->d_len);
+            }
+
+          iob_concat(dev->d_iob,
+                     iob_trimhead(seg->data, TCP_SEQ_SUB(right, seg->left)));
+
+          dev->d_len += len;
+          right       = seg->right;
+
+          ninfo("Delivering out-of-order data up to seq=%" PRIu32 "\n",
+                right);
+        }
+      else
+        {
+          iob_free_chain(seg->data);
+        }
+
+      tcp_ofoseg_remove(conn->ofosegs, &conn->nofosegs, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_free
+ *
+ * Description:
+ *   Release all of the out-of-order data held by the connection.
+ *
+ ****************************************************************************/
+
+void tcp_ofoseg_free(FAR struct tcp_conn_s *conn)
+{
+  int i;
+
+  for (i = 0; i < conn->nofosegs; i++)
+    {
+      iob_free_chain(conn->ofosegs[i].data);
+    }
+
+  conn->nofosegs = 0;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_options
+ *
+ * Description:
+ *   Build the SACK option describing the out-of-order data held by the
+ *   connection, the range holding the latest segment first.
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection structure holding connection information.
+ *   optdata - Where to build the option.
+ *   maxlen  - The room available at optdata.
+ *
+ * Returned Value:
+ *   The length of the option, a multiple of 4; zero if there is nothing
+ *   to report.
+ *
+ ****************************************************************************/
+
+uint16_t tcp_sack_options(FAR struct tcp_conn_s *conn,
+                          FAR uint8_t *optdata, uint16_t maxlen)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  uint16_t optlen;
+  int nblocks = conn->nofosegs;
+  int first = 0;
+  int i;
+
+  /* The option is padded by two NOPs to keep the blocks aligned */
+
+  while (nblocks > 0 && 2 + TCP_OPT_SACK_LEN(nblocks) > maxlen)
+    {
+      nblocks--;
+    }
+
+  if (nblocks == 0)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < conn->nofosegs; i++)
+    {
+      seg = &conn->ofosegs[i];
+      if (TCP_SEQ_LTE(seg->left, conn->ofo_last) &&
+          TCP_SEQ_LT(conn->ofo_last, seg->right))
+        {
+          first = i;
+          break;
+        }
+    }
+
+  optdata[0] = TCP_OPT_NOOP;
+  optdata[1] = TCP_OPT_NOOP;
+  optdata[2] = TCP_OPT_SACK;
+  optdata[3] = TCP_OPT_SACK_LEN(nblocks);
+  optlen     = 4;
+
+  for (i = -1; i < conn->nofosegs && optlen < 2 + TCP_OPT_SACK_LEN(nblocks);
+       i++)
+    {
+      if (i == first)
+        {
+          continue;
+        }
+
+      seg = &conn->ofosegs[i < 0 ? first : i];
+      tcp_setsequence(&optdata[optlen], seg->left);
+      tcp_setsequence(&optdata[optlen + 4], seg->right);
+      optlen += 8;
+    }
+
+  return optlen;
+}
+
+#endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
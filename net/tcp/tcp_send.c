@@ -151,12 +151,24 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
       uint32_t recvwndo = tcp_get_recvwindow(dev, conn);
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      /* The window of a SYN segment is never scaled (RFC 7323) */
+
+      if ((tcp->flags & TCP_SYN) != 0 && recvwndo > UINT16_MAX)
+        {
+          recvwndo = UINT16_MAX;
+        }
+#endif
+
       /* Update the Receiver Window */
 
       conn->rcv_adv = rcvseq + recvwndo;
 
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
-      recvwndo >>= conn->rcv_scale;
+      if ((tcp->flags & TCP_SYN) == 0)
+        {
+          recvwndo >>= conn->rcv_scale;
+        }
 #endif
 
       /* Set the TCP Window */
@@ -187,7 +199,11 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_txcsum_offload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv6.sent++;
 #endif
@@ -207,7 +223,11 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_txcsum_offload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv4.sent++;
 #endif
@@ -268,6 +288,7 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len)
 {
   FAR struct tcp_hdr_s *tcp;
+  uint16_t optlen = 0;
 
   if (dev->d_iob == NULL)
     {
@@ -275,9 +296,22 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 
   tcp            = tcp_header(dev);
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  /* Report the out-of-order data held in segments without payload */
+
+  if ((conn->flags & TCP_SACK) != 0 && conn->nofosegs > 0 &&
+      len == tcpip_hdrsize(conn))
+    {
+      optlen = tcp_sack_options(conn, tcp->optdata,
+                                CONFIG_IOB_BUFSIZE -
+                                (tcp->optdata - dev->d_iob->io_data));
+    }
+#endif
+
   tcp->flags     = flags;
-  dev->d_len     = len;
-  tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
+  dev->d_len     = len + optlen;
+  tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
   tcp_sendcommon(dev, conn, tcp);
 }
 
@@ -418,7 +452,10 @@ void tcp_reset(FAR struct net_driver_s *dev)
                         IP_TTL_DEFAULT);
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_txcsum_offload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -434,7 +471,10 @@ void tcp_reset(FAR struct net_driver_s *dev)
                         IP_TTL_DEFAULT, NULL);
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_txcsum_offload(dev))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
     }
 #endif /* CONFIG_NET_IPv4 */
 }
@@ -559,13 +599,31 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->optdata[optlen++] = tcp_mss & 0xff;
 
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (tcp->flags == TCP_SYN)
+    {
+      /* Offer a factor that lets the window cover the read-ahead buffer */
+
+      conn->rcv_scale = tcp_get_rcvscale(conn);
+    }
+
   if (tcp->flags == TCP_SYN ||
       ((tcp->flags == (TCP_ACK | TCP_SYN)) && (conn->flags & TCP_WSCALE)))
     {
       tcp->optdata[optlen++] = TCP_OPT_NOOP;
       tcp->optdata[optlen++] = TCP_OPT_WS;
       tcp->optdata[optlen++] = TCP_OPT_WS_LEN;
-      tcp->optdata[optlen++] = CONFIG_NET_TCP_WINDOW_SCALE_FACTOR;
+      tcp->optdata[optlen++] = conn->rcv_scale;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  if (tcp->flags == TCP_SYN ||
+      ((tcp->flags == (TCP_ACK | TCP_SYN)) && (conn->flags & TCP_SACK)))
+    {
+      tcp->optdata[optlen++] = TCP_OPT_NOOP;
+      tcp->optdata[optlen++] = TCP_OPT_NOOP;
+      tcp->optdata[optlen++] = TCP_OPT_SACK_PERM;
+      tcp->optdata[optlen++] = TCP_OPT_SACK_PERM_LEN;
     }
 #endif
 
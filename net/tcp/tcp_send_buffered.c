@@ -140,6 +140,85 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
     }
 }
 
+/****************************************************************************
+ * Name: psock_sack_update
+ *
+ * Description:
+ *   Mark the un-ACKed write buffers that the SACK blocks of an incoming
+ *   ACK report as entirely received by the peer (RFC 2018).
+ *
+ * Input Parameters:
+ *   conn  The connection structure associated with the socket
+ *   tcp   The TCP header of the incoming ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+static void psock_sack_update(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR uint8_t *opt = tcp->optdata;
+  int optlen = ((tcp->tcpoffset >> 4) << 2) - TCP_HDRLEN;
+  uint32_t left;
+  uint32_t right;
+  int i;
+  int j;
+
+  for (i = 0; i < optlen; )
+    {
+      if (opt[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (i + 1 >= optlen || opt[i + 1] < 2 ||
+               i + opt[i + 1] > optlen)
+        {
+          /* Malformed options */
+
+          break;
+        }
+
+      if (opt[i] == TCP_OPT_SACK)
+        {
+          for (j = i + 2; j + 8 <= i + opt[i + 1]; j += 8)
+            {
+              left  = tcp_getsequence(&opt[j]);
+              right = tcp_getsequence(&opt[j + 4]);
+
+              for (entry = sq_peek(&conn->unacked_q); entry;
+                   entry = sq_next(entry))
+                {
+                  wrb = (FAR struct tcp_wrbuffer_s *)entry;
+                  if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), left) &&
+                      TCP_SEQ_LTE(TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb),
+                                  right))
+                    {
+                      ninfo("SACK: wrb=%p seqno=%" PRIu32 "\n",
+                            wrb, TCP_WBSEQNO(wrb));
+                      TCP_WBSACKED(wrb) = true;
+                    }
+                }
+            }
+        }
+
+      i += opt[i + 1];
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: psock_writebuffer_notify
  *
@@ -287,7 +366,7 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
 #endif
 
 /****************************************************************************
- * Name: psock_send_eventhandler
+ * Name: psock_send_event
  *
  * Description:
  *   This function is called to perform the actual send operation when
@@ -295,31 +374,25 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
  *
  * Input Parameters:
  *   dev      The structure of the network driver that caused the event
- *   pvpriv   An instance of struct tcp_conn_s cast to void*
+ *   conn     The TCP connection
  *   flags    Set of events describing why the callback was invoked
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   The network is locked
+ *   The network, the device and the connection are locked
  *
  ****************************************************************************/
 
-static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
-                                        FAR void *pvpriv, uint16_t flags)
+static uint16_t psock_send_event(FAR struct net_driver_s *dev,
+                                 FAR struct tcp_conn_s *conn,
+                                 uint16_t flags)
 {
-  FAR struct tcp_conn_s *conn = pvpriv;
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
   uint32_t rexmitno = 0;
 #endif
 
-  /* Get the TCP connection pointer reliably from
-   * the corresponding TCP socket.
-   */
-
-  DEBUGASSERT(conn != NULL);
-
   /* The TCP socket is connected and, hence, should be bound to a device.
    * Make sure that the polling device is the one that we are bound to.
    */
@@ -476,6 +549,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                   /* Do fast retransmit */
 
                   rexmitno = ackno;
+#ifdef CONFIG_NET_TCP_CC
+                  tcp_cc_loss(conn, false);
+#endif
 
                   /* Reset counter */
 
@@ -485,6 +561,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #endif
         }
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      if ((conn->flags & TCP_SACK) != 0)
+        {
+          psock_sack_update(conn, tcp);
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+      tcp_cc_ack(conn, ackno);
+#endif
+
       /* A special case is the head of the write_q which may be partially
        * sent and so can still have un-ACKed bytes that could get ACKed
        * before the entire write buffer has even been sent.
@@ -620,9 +707,20 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     {
       FAR struct tcp_wrbuffer_s *wrb;
       FAR sq_entry_t *entry;
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      sq_queue_t sacked;
+
+      sq_init(&sacked);
+#endif
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Account for the loss while tx_unacked still holds the flight */
+
+      tcp_cc_loss(conn, true);
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -710,6 +808,20 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           wrb = (FAR struct tcp_wrbuffer_s *)entry;
           uint16_t sent;
 
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+          if (TCP_WBSACKED(wrb))
+            {
+              /* The peer has this data already, so it stays un-ACKed.
+               * The mark only spares one timeout, in case the peer has
+               * discarded the data since (RFC 2018).
+               */
+
+              TCP_WBSACKED(wrb) = false;
+              sq_addfirst(entry, &sacked);
+              continue;
+            }
+#endif
+
           /* Reset the number of bytes sent sent from the write buffer */
 
           sent = TCP_WBSENT(wrb);
@@ -777,6 +889,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               psock_insert_segment(wrb, &conn->write_q);
             }
         }
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+      sq_move(&sacked, &conn->unacked_q);
+#endif
     }
 
 #if CONFIG_NET_SEND_BUFSIZE > 0
@@ -857,6 +973,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = remaining_snd_wnd;
             }
 
+#ifdef CONFIG_NET_TCP_CC
+          /* Wait for ACKs if the congestion window is full */
+
+          if (!tcp_cc_cansend(conn, sndlen))
+            {
+              ninfo("SEND: cwnd=%" PRIu32 " full, tx_unacked=%" PRIu32
+                    "\n", conn->cwnd, (uint32_t)conn->tx_unacked);
+              return flags;
+            }
+#endif
+
           ninfo("SEND: wrb=%p seq=%" PRIu32 " pktlen=%u sent=%u sndlen=%zu "
                 "mss=%u snd_wnd=%u seq=%" PRIu32
                 " remaining_snd_wnd=%" PRIu32 "\n",
@@ -900,6 +1027,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            * number calculations.
            */
 
+#ifdef CONFIG_NET_TCP_CC
+          tcp_cc_sent(conn, seq, sndlen);
+#endif
+
           conn->tx_unacked += sndlen;
           conn->sent       += sndlen;
 
@@ -960,6 +1091,45 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: psock_send_eventhandler
+ *
+ * Description:
+ *   The callback of the connection's send callback.  The write and unacked
+ *   queues are shared with psock_tcp_send(), so they are only touched with
+ *   the connection locked.
+ *
+ * Input Parameters:
+ *   dev      The structure of the network driver that caused the event
+ *   pvpriv   An instance of struct tcp_conn_s cast to void*
+ *   flags    Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network and the device are locked
+ *
+ ****************************************************************************/
+
+static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
+                                        FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct tcp_conn_s *conn = pvpriv;
+
+  /* Get the TCP connection pointer reliably from
+   * the corresponding TCP socket.
+   */
+
+  DEBUGASSERT(conn != NULL);
+
+  conn_lock(&conn->sconn);
+  flags = psock_send_event(dev, conn, flags);
+  conn_unlock(&conn->sconn);
+
+  return flags;
+}
+
 /****************************************************************************
  * Name: tcp_max_wrb_size
  *
@@ -1252,6 +1422,8 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            */
 
           max_wrb_size = tcp_max_wrb_size(conn);
+
+          conn_lock(&conn->sconn);
           wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
           if (wrb != NULL && TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
               TCP_WBPKTLEN(wrb) < max_wrb_size &&
@@ -1262,16 +1434,28 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                     TCP_WBPKTLEN(wrb));
               DEBUGASSERT(TCP_WBPKTLEN(wrb) > 0);
             }
-          else if (nonblock)
+          else
             {
-              wrb = tcp_wrbuffer_tryalloc();
-              ninfo("new wrb %p (non blocking)\n", wrb);
+              wrb = NULL;
             }
-          else
+
+          /* The connection must not be locked while waiting for a buffer */
+
+          conn_unlock(&conn->sconn);
+
+          if (wrb == NULL)
             {
-              wrb = tcp_wrbuffer_timedalloc(tcp_send_gettimeout(start,
-                                                                timeout));
-              ninfo("new wrb %p\n", wrb);
+              if (nonblock)
+                {
+                  wrb = tcp_wrbuffer_tryalloc();
+                  ninfo("new wrb %p (non blocking)\n", wrb);
+                }
+              else
+                {
+                  wrb = tcp_wrbuffer_timedalloc(
+                          tcp_send_gettimeout(start, timeout));
+                  ninfo("new wrb %p\n", wrb);
+                }
             }
 
           if (wrb == NULL)
@@ -1354,7 +1538,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             {
               DEBUGASSERT(TCP_WBSENT(wrb) == 0);
               DEBUGASSERT(TCP_WBPKTLEN(wrb) > 0);
+
+              conn_lock(&conn->sconn);
               sq_addlast(&wrb->wb_node, &conn->write_q);
+              conn_unlock(&conn->sconn);
             }
           else
             {
@@ -1390,12 +1577,16 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        * conn->write_q
        */
 
+      conn_lock(&conn->sconn);
       sq_addlast(&wrb->wb_node, &conn->write_q);
       ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
             wrb, TCP_WBPKTLEN(wrb),
             conn->write_q.head, conn->write_q.tail);
+      conn_unlock(&conn->sconn);
 
-      /* Notify the device driver of the availability of TX data */
+      /* Notify the device driver of the availability of TX data.  This may
+       * poll the device, so the connection must be unlocked first.
+       */
 
       tcp_send_txnotify(psock, conn);
       net_unlock();
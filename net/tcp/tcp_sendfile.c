@@ -42,6 +42,8 @@
 #include <arch/irq.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -88,12 +90,153 @@ struct sendfile_s
 #endif
   int                snd_dup_acks;         /* Duplicate ACK counter */
 #endif
+#ifdef CONFIG_IOB_EXTERNAL
+  FAR const uint8_t *snd_map;              /* Mapped file data or NULL */
+  sem_t              snd_lentsem;          /* Posted as lent IOBs are freed */
+  unsigned int       snd_nlent;            /* The number of IOBs lent */
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_iob_free
+ *
+ * Description:
+ *   Called when an IOB that references the mapped file is freed, possibly
+ *   by the driver from interrupt context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTERNAL
+static void sendfile_iob_free(FAR void *arg)
+{
+  FAR struct sendfile_s *pstate = arg;
+
+  nxsem_post(&pstate->snd_lentsem);
+}
+
+/****************************************************************************
+ * Name: sendfile_lend
+ *
+ * Description:
+ *   Set up the payload of the outgoing segment from the mapped file without
+ *   copying it.  The rest of the head IOB (after the headers) is filled by
+ *   copying so that the chain stays packed; the remaining data is chained
+ *   behind it as IOBs that reference the file data.
+ *
+ * Input Parameters:
+ *   dev    - The device whose d_iob holds the outgoing segment
+ *   pstate - The sendfile state
+ *   offset - Offset of the data relative to snd_foffset
+ *   sndlen - The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes set up.  This is less than sndlen if IOBs ran out.
+ *
+ * Assumptions:
+ *   The network is locked and dev->d_iob is a single IOB.
+ *
+ ****************************************************************************/
+
+static uint32_t sendfile_lend(FAR struct net_driver_s *dev,
+                              FAR struct sendfile_s *pstate,
+                              uint32_t offset, uint32_t sndlen)
+{
+  FAR const uint8_t *src = pstate->snd_map + offset;
+  FAR struct iob_s *tail = dev->d_iob;
+  FAR struct iob_s *iob;
+  uint32_t ncopy;
+  uint32_t len;
+
+  ncopy = CONFIG_IOB_BUFSIZE - (dev->d_appdata - dev->d_iob->io_data);
+  if (ncopy > sndlen)
+    {
+      ncopy = sndlen;
+    }
+
+  memcpy(dev->d_appdata, src, ncopy);
+
+  while (ncopy < sndlen)
+    {
+      len = sndlen - ncopy;
+      if (len > CONFIG_IOB_BUFSIZE)
+        {
+          len = CONFIG_IOB_BUFSIZE;
+        }
+
+      iob = iob_tryalloc_with_data(false, src + ncopy, len,
+                                   sendfile_iob_free, pstate);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      pstate->snd_nlent++;
+      tail->io_flink = iob;
+      tail           = iob;
+      ncopy         += len;
+    }
+
+  return ncopy;
+}
+#endif
+
+/****************************************************************************
+ * Name: sendfile_fill
+ *
+ * Description:
+ *   Set up the payload of the outgoing segment, either by lending the
+ *   mapped file data or by reading the file into the device buffer.
+ *
+ * Input Parameters:
+ *   dev    - The network driver
+ *   pstate - The sendfile state
+ *   offset - Offset of the data relative to snd_foffset
+ *   sndlen - The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes set up on success; a negated errno on failure.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_fill(FAR struct net_driver_s *dev,
+                             FAR struct sendfile_s *pstate,
+                             uint32_t offset, uint32_t sndlen)
+{
+  ssize_t ret;
+
+#ifdef CONFIG_IOB_EXTERNAL
+  if (pstate->snd_map != NULL && dev->d_iob != NULL &&
+      dev->d_iob->io_flink == NULL)
+    {
+      return sendfile_lend(dev, pstate, offset, sndlen);
+    }
+#endif
+
+  ret = file_seek(pstate->snd_file, pstate->snd_foffset + offset,
+                  SEEK_SET);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to lseek: %zd\n", ret);
+      return ret;
+    }
+
+  ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to read from input file: %zd\n", ret);
+      return ret;
+    }
+
+  return sndlen;
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -119,7 +262,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
 {
   FAR struct sendfile_s *pstate = pvpriv;
   FAR struct tcp_conn_s *conn;
-  int ret;
+  ssize_t ret;
 
   DEBUGASSERT(pstate != NULL);
 
@@ -267,24 +410,14 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = file_seek(pstate->snd_file,
-                      pstate->snd_foffset + pstate->snd_acked, SEEK_SET);
-      if (ret < 0)
-        {
-          nerr("ERROR: Failed to lseek: %d\n", ret);
-          pstate->snd_sent = ret;
-          goto end_wait;
-        }
-
-      ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+      ret = sendfile_fill(dev, pstate, pstate->snd_acked, sndlen);
       if (ret < 0)
         {
-          nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
           pstate->snd_sent = ret;
           goto end_wait;
         }
 
-      dev->d_sndlen = sndlen;
+      dev->d_sndlen = ret;
 
       /* Continue waiting */
 
@@ -345,28 +478,18 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+          ret = sendfile_fill(dev, pstate, pstate->snd_sent, sndlen);
           if (ret < 0)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
               pstate->snd_sent = ret;
               goto end_wait;
             }
 
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
-            {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
-            }
-
-          dev->d_sndlen = sndlen;
+          dev->d_sndlen = ret;
 
           /* Update the amount of data sent (but not necessarily ACKed) */
 
-          pstate->snd_sent += sndlen;
+          pstate->snd_sent += ret;
           ninfo("pid: %d SEND: acked=%" PRId32 " sent=%zd flen=%zu\n",
                 getpid(),
                 pstate->snd_acked, pstate->snd_sent, pstate->snd_flen);
@@ -431,6 +554,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
   off_t startpos;
+#ifdef CONFIG_IOB_EXTERNAL
+  FAR void *map;
+  struct stat st;
+#endif
   int ret;
 
   conn = psock->s_conn;
@@ -502,6 +629,24 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
 
+#ifdef CONFIG_IOB_EXTERNAL
+  /* If the file content is directly addressable (romfs XIP, tmpfs, ...),
+   * then transmit it in place instead of reading it into the packets.
+   * Never reference data beyond the end of the file.
+   */
+
+  nxsem_init(&state.snd_lentsem, 0, 0);
+  if (file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&map)) >= 0 &&
+      file_fstat(infile, &st) >= 0 && st.st_size >= state.snd_foffset)
+    {
+      state.snd_map = (FAR const uint8_t *)map + state.snd_foffset;
+      if (state.snd_flen > st.st_size - state.snd_foffset)
+        {
+          state.snd_flen = st.st_size - state.snd_foffset;
+        }
+    }
+#endif
+
   /* Allocate resources to receive a callback */
 
   state.snd_cb = tcp_callback_alloc(conn);
@@ -560,6 +705,26 @@ errout_locked:
 #endif
   net_unlock();
 
+#ifdef CONFIG_IOB_EXTERNAL
+  /* Wait until the drivers released every IOB that references the file,
+   * since the state and possibly the file mapping go away on return.
+   */
+
+  while (state.snd_nlent-- > 0)
+    {
+      nxsem_wait_uninterruptible(&state.snd_lentsem);
+    }
+
+  nxsem_destroy(&state.snd_lentsem);
+
+  /* The file position was not moved by the transfer */
+
+  if (state.snd_map != NULL && state.snd_sent > 0)
+    {
+      file_seek(infile, state.snd_foffset + state.snd_sent, SEEK_SET);
+    }
+#endif
+
   /* Return the current file position */
 
   if (offset)
@@ -74,6 +74,15 @@
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+/* Limits of UDP_SEGMENT: the largest IPv4 UDP payload and the most
+ * datagrams that one send may be split into (as with Linux).
+ */
+
+#  define UDP_MAX_PAYLOAD     (UINT16_MAX - IPv4_HDRLEN - UDP_HDRLEN)
+#  define UDP_MAX_SEGMENTS    64
+#endif
+
 /* This is a helper pointer for accessing the contents of the udp header */
 
 #define UDPIPv4BUF ((FAR struct udp_hdr_s *)IPBUF(IPv4_HDRLEN))
@@ -103,6 +112,17 @@ struct udp_poll_s
   FAR struct devif_callback_s *cb; /* Needed to teardown the poll */
 };
 
+#ifdef CONFIG_NET_IGMP_SOURCE_FILTER
+/* An IPv4 multicast source filter of a socket */
+
+struct udp_msfilter_s
+{
+  in_addr_t group;        /* The multicast group */
+  in_addr_t source;       /* The source address */
+  uint8_t   mode;         /* MCAST_INCLUDE or MCAST_EXCLUDE */
+};
+#endif
+
 struct udp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -111,6 +131,9 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  dq_entry_t hnode;       /* Link in the port hash table if lport != 0 */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -118,6 +141,13 @@ struct udp_conn_s
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  ttl;           /* Default time-to-live */
   uint8_t  crefs;         /* Reference counts on this instance */
+#ifdef CONFIG_NET_UDP_SEGMENT
+  uint16_t gso_size;      /* UDP_SEGMENT size, or zero if not set */
+#endif
+#ifdef CONFIG_NET_IGMP_SOURCE_FILTER
+  uint8_t  nmsfilters;    /* Number of used entries of msfilter[] */
+  struct udp_msfilter_s msfilter[CONFIG_NET_IGMP_NSOURCES];
+#endif
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcvbufs;       /* Maximum amount of bytes queued in recv */
@@ -135,6 +165,19 @@ struct udp_conn_s
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* SO_TIMESTAMPING.  The time stamps of the sent packets are queued in
+   * errqueue, as IOBs without data, until they are read with
+   * recvmsg(MSG_ERRQUEUE).
+   */
+
+  uint16_t tsflags;               /* SOF_TIMESTAMPING_* flags */
+  uint8_t  tsqlen;                /* The number of entries of errqueue */
+  uint32_t tskey;                 /* Key of the packets sent, see
+                                   * udp_txtstamp() */
+  struct iob_queue_s errqueue;    /* TX time stamps */
+#endif
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Write buffering
    *
@@ -219,6 +262,21 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain);
 
 void udp_free(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of a UDP connection (network byte order), keeping
+ *   the port hash table up to date.  Zero unbinds the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+#else
+#  define udp_setport(conn, portno) ((conn)->lport = (portno))
+#endif
+
 /****************************************************************************
  * Name: udp_active
  *
@@ -739,6 +797,34 @@ ssize_t psock_udp_sendto(FAR struct socket *psock,
                          FAR const void *buf, size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen);
 
+/****************************************************************************
+ * Name: udp_sendto_segments
+ *
+ * Description:
+ *   Send the data as consecutive datagrams of the UDP_SEGMENT size of the
+ *   socket, the last one possibly shorter.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent, which is less than
+ *   len if a datagram after the first could not be sent.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+ssize_t udp_sendto_segments(FAR struct socket *psock,
+                            FAR const void *buf, size_t len, int flags,
+                            FAR const struct sockaddr *to, socklen_t tolen);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -947,6 +1033,180 @@ int udp_txdrain(FAR struct socket *psock, unsigned int timeout);
 
 int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg);
 
+#ifdef CONFIG_NET_IGMP_SOURCE_FILTER
+/****************************************************************************
+ * Name: udp_msfilter_add
+ *
+ * Description:
+ *   Add a source filter to a UDP connection.
+ *
+ * Input Parameters:
+ *   conn   - The UDP connection of interest
+ *   group  - The multicast group (network byte order)
+ *   source - The source address (network byte order)
+ *   mode   - MCAST_INCLUDE to receive only from the listed sources of the
+ *            group, MCAST_EXCLUDE to block the source
+ *
+ * Returned Value:
+ *   OK on success; -EADDRINUSE if the filter exists, -EINVAL if the source
+ *   has a filter of the other mode, -ENOBUFS if the table is full.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int udp_msfilter_add(FAR struct udp_conn_s *conn, in_addr_t group,
+                     in_addr_t source, uint8_t mode);
+
+/****************************************************************************
+ * Name: udp_msfilter_remove
+ *
+ * Description:
+ *   Remove a source filter added by udp_msfilter_add().
+ *
+ * Returned Value:
+ *   OK on success; -EADDRNOTAVAIL if there is no such filter.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int udp_msfilter_remove(FAR struct udp_conn_s *conn, in_addr_t group,
+                        in_addr_t source, uint8_t mode);
+
+/****************************************************************************
+ * Name: udp_msfilter_count
+ *
+ * Description:
+ *   Return the number of filters of the given mode for a group.
+ *
+ ****************************************************************************/
+
+int udp_msfilter_count(FAR struct udp_conn_s *conn, in_addr_t group,
+                       uint8_t mode);
+
+/****************************************************************************
+ * Name: udp_msfilter_accept
+ *
+ * Description:
+ *   Check a received datagram against the source filters of a connection:
+ *   A blocked source is rejected and, if sources are listed for the group,
+ *   only those are accepted.  Datagrams to unicast addresses always pass.
+ *
+ * Input Parameters:
+ *   conn   - The UDP connection of interest
+ *   group  - The destination address (network byte order)
+ *   source - The source address (network byte order)
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool udp_msfilter_accept(FAR struct udp_conn_s *conn, in_addr_t group,
+                         in_addr_t source);
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMPING
+/****************************************************************************
+ * Name: udp_tstamp_setflags
+ *
+ * Description:
+ *   Set the SO_TIMESTAMPING flags of a connection.
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the flags are not supported.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int udp_tstamp_setflags(FAR struct udp_conn_s *conn, int flags);
+
+/****************************************************************************
+ * Name: udp_tstamp_send
+ *
+ * Description:
+ *   Called when the packet of a connection was set up in dev->d_iob, to
+ *   ask the driver for its time stamp and to take the software one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_send(FAR struct net_driver_s *dev,
+                     FAR struct udp_conn_s *conn);
+
+/****************************************************************************
+ * Name: udp_tstamp_recv
+ *
+ * Description:
+ *   Called when a packet is received by a connection, to keep its time
+ *   stamp only if the socket wants it, or to take a software one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_tstamp_recv(FAR struct udp_conn_s *conn, FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: udp_tstamp_cmsg
+ *
+ * Description:
+ *   Append the SCM_TIMESTAMPING control message of a received packet to
+ *   the msg_controllen bytes already used of msg_control.
+ *
+ * Input Parameters:
+ *   conn       - The UDP connection of interest
+ *   msg        - The message being received
+ *   controllen - The size of msg_control
+ *   iob        - The head of the packet
+ *
+ ****************************************************************************/
+
+void udp_tstamp_cmsg(FAR struct udp_conn_s *conn, FAR struct msghdr *msg,
+                     socklen_t controllen, FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: udp_tstamp_recverr
+ *
+ * Description:
+ *   Receive the oldest time stamp of the error queue, for
+ *   recvmsg(MSG_ERRQUEUE).  No data is returned, only the control message.
+ *
+ * Returned Value:
+ *   Zero on success; -EAGAIN if the queue is empty.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t udp_tstamp_recverr(FAR struct udp_conn_s *conn,
+                           FAR struct msghdr *msg);
+
+/****************************************************************************
+ * Name: udp_txtstamp
+ *
+ * Description:
+ *   Queue the hardware time stamp of a sent packet for the socket of the
+ *   given key, see netdev_txtstamp().  Nothing is done if the socket was
+ *   closed meanwhile.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void udp_txtstamp(uint32_t key, FAR const struct timespec *ts);
+#endif
+
 /****************************************************************************
  * Name: udp_sendbuffer_notify
  *
@@ -148,6 +148,10 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
     }
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  udp_tstamp_recv(conn, iob);
+#endif
+
   /* Override the address info begin of io_data */
 
 #ifdef CONFIG_NETDEV_IFINDEX
@@ -163,7 +167,14 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Add the new I/O buffer chain to the tail of the read-ahead queue */
 
-  ret = iob_tryadd_queue(iob, &conn->readahead);
+#ifdef CONFIG_IOB_POOLS
+  ret = iob_pool_charge(IOB_POOL_UDP, iob);
+  if (ret >= 0)
+#endif
+    {
+      ret = iob_tryadd_queue(iob, &conn->readahead);
+    }
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
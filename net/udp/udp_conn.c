@@ -67,8 +67,19 @@
 #include "nat/nat.h"
 #include "netdev/netdev.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "udp/udp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+#  define udp_reuseport(c)  _SO_GETOPT((c)->sconn.s_options, SO_REUSEPORT)
+#else
+#  define udp_reuseport(c)  false
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -88,15 +99,53 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/* The bound UDP connections hashed by local port */
+
+static dq_queue_t g_udp_hash[CONFIG_NET_UDP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_first / udp_next
+ *
+ * Description:
+ *   Iterate over the connections that may be bound to a local port
+ *   (network byte order).  With CONFIG_NET_UDP_CONN_HASH this is the
+ *   bucket of the port; otherwise it is the list of all connections.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+#  if (CONFIG_NET_UDP_CONN_HASHSIZE & (CONFIG_NET_UDP_CONN_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_UDP_CONN_HASHSIZE must be a power of two
+#  endif
+
+#  define UDP_HASH_MASK (CONFIG_NET_UDP_CONN_HASHSIZE - 1)
+#  define udp_hash(p)   ((((p) >> 8) ^ (p)) & UDP_HASH_MASK)
+#  define udp_first(p)  udp_hashconn(g_udp_hash[udp_hash(p)].head)
+#  define udp_next(c)   udp_hashconn((c)->hnode.flink)
+
+static inline FAR struct udp_conn_s *udp_hashconn(FAR dq_entry_t *node)
+{
+  return node ? container_of(node, struct udp_conn_s, hnode) : NULL;
+}
+#else
+#  define udp_first(p) \
+     ((FAR struct udp_conn_s *)g_active_udp_connections.head)
+#  define udp_next(c)   ((FAR struct udp_conn_s *)(c)->sconn.node.flink)
+#endif
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
  * Description:
- *   Find the UDP connection that uses this local port number.
+ *   Find the UDP connection that uses this local port number.  If
+ *   'reuseport', the connections that share their port with SO_REUSEPORT
+ *   are ignored.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -105,14 +154,19 @@ static dq_queue_t g_active_udp_connections;
 
 static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
-                                            uint16_t portno)
+                                            uint16_t portno, bool reuseport)
 {
-  FAR struct udp_conn_s *conn = NULL;
+  FAR struct udp_conn_s *conn;
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure that may use the port. */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  for (conn = udp_first(portno); conn != NULL; conn = udp_next(conn))
     {
+      if (reuseport && udp_reuseport(conn))
+        {
+          continue;
+        }
+
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -151,6 +205,110 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   return NULL;
 }
 
+#ifdef CONFIG_NET_REUSEPORT
+/****************************************************************************
+ * Name: udp_flowhash
+ *
+ * Description:
+ *   Hash the remote address and port of a datagram.
+ *
+ ****************************************************************************/
+
+static uint32_t udp_flowhash(uint32_t raddr, uint16_t rport)
+{
+  uint32_t hash = (raddr ^ rport) * 0x9e3779b1;
+
+  return hash ^ (hash >> 16);
+}
+
+#ifdef CONFIG_NET_IPv6
+static uint32_t udp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return ((uint32_t)(addr[0] ^ addr[2] ^ addr[4] ^ addr[6]) << 16) |
+         (addr[1] ^ addr[3] ^ addr[5] ^ addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_reuseport_member
+ *
+ * Description:
+ *   Return true if 'conn' shares the local address and port of 'first'
+ *   with SO_REUSEPORT.
+ *
+ ****************************************************************************/
+
+static bool udp_reuseport_member(FAR struct udp_conn_s *first,
+                                 FAR struct udp_conn_s *conn)
+{
+  if (conn->lport != first->lport || !udp_reuseport(conn) ||
+      _UDP_ISCONNECTMODE(conn->flags)
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      || conn->domain != first->domain
+#endif
+     )
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, first->u.ipv4.laddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, first->u.ipv6.laddr);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Select the socket of the SO_REUSEPORT group that receives a datagram
+ *   with the flow hash 'hash'.  'first' is the first member of the group
+ *   found by the lookup.  While the group is unchanged, all datagrams of a
+ *   flow go to the same socket.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *
+  udp_reuseport_select(FAR struct udp_conn_s *first, uint32_t hash)
+{
+  FAR struct udp_conn_s *conn;
+  unsigned int nmembers = 0;
+  unsigned int index;
+
+  for (conn = first; conn != NULL; conn = udp_next(conn))
+    {
+      if (udp_reuseport_member(first, conn))
+        {
+          nmembers++;
+        }
+    }
+
+  index = hash % nmembers;
+  for (conn = first; conn != NULL; conn = udp_next(conn))
+    {
+      if (udp_reuseport_member(first, conn) && index-- == 0)
+        {
+          break;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_REUSEPORT */
+
 /****************************************************************************
  * Name: udp_ipv4_active
  *
@@ -173,7 +331,7 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  conn = udp_first(udp->destport);
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -237,7 +395,15 @@ static inline FAR struct udp_conn_s *
            */
 
           (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
-           net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)))
+           net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr))
+
+#ifdef CONFIG_NET_IGMP_SOURCE_FILTER
+          /* And the multicast source filters of the socket pass it */
+
+          && udp_msfilter_accept(conn, net_ip4addr_conv32(ip->destipaddr),
+                                 net_ip4addr_conv32(ip->srcipaddr))
+#endif
+          )
         {
           /* Check if the socket is connection mode.  In this case, only
            * packets with source addresses from the connected remote peer
@@ -286,8 +452,20 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_next(conn);
+    }
+
+#ifdef CONFIG_NET_REUSEPORT
+  /* Spread the flows among the sockets sharing the port */
+
+  if (conn != NULL && udp_reuseport(conn) &&
+      !_UDP_ISCONNECTMODE(conn->flags))
+    {
+      conn = udp_reuseport_select(conn,
+               udp_flowhash(net_ip4addr_conv32(ip->srcipaddr),
+                            udp->srcport));
     }
+#endif
 
   return conn;
 }
@@ -312,7 +490,7 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  conn = udp_first(udp->destport);
   while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -425,8 +603,20 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_next(conn);
+    }
+
+#ifdef CONFIG_NET_REUSEPORT
+  /* Spread the flows among the sockets sharing the port */
+
+  if (conn != NULL && udp_reuseport(conn) &&
+      !_UDP_ISCONNECTMODE(conn->flags))
+    {
+      conn = udp_reuseport_select(conn,
+               udp_flowhash(udp_ipv6_fold(ip->srcipaddr),
+                            udp->srcport));
     }
+#endif
 
   return conn;
 }
@@ -534,7 +724,7 @@ uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
           g_last_udp_port = 4096;
         }
     }
-  while (udp_find_conn(domain, u, HTONS(g_last_udp_port)) != NULL
+  while (udp_find_conn(domain, u, HTONS(g_last_udp_port), false) != NULL
 #if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
          || (domain == PF_INET &&
              ipv4_nat_port_inuse(IP_PROTO_UDP, u->ipv4.laddr,
@@ -607,6 +797,7 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 #endif
       conn->lport   = 0;
       conn->ttl     = IP_TTL_DEFAULT;
+      nxrmutex_init(&conn->sconn.s_lock);
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcvbufs = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -649,8 +840,8 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+  udp_setport(conn, 0);
   nxmutex_lock(&g_free_lock);
-  conn->lport = 0;
 
   /* Remove the connection from the active list */
 
@@ -660,6 +851,12 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   iob_free_queue(&conn->readahead);
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* Release the time stamps that were not read */
+
+  iob_free_queue(&conn->errqueue);
+#endif
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -677,6 +874,8 @@ void udp_free(FAR struct udp_conn_s *conn)
 
 #endif
 
+  nxrmutex_destroy(&conn->sconn.s_lock);
+
   /* Clear the connection structure */
 
   memset(conn, 0, sizeof(*conn));
@@ -687,6 +886,36 @@ void udp_free(FAR struct udp_conn_s *conn)
   nxmutex_unlock(&g_free_lock);
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port of a UDP connection (network byte order), keeping
+ *   the port hash table up to date.  Zero unbinds the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  net_lock();
+
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hnode, &g_udp_hash[udp_hash(conn->lport)]);
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      dq_addlast(&conn->hnode, &g_udp_hash[udp_hash(portno)]);
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: udp_active
  *
@@ -810,7 +1039,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       ret         = OK;
     }
   else
@@ -823,7 +1052,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * and port ?
        */
 
-      if (udp_find_conn(conn->domain, &conn->u, portno) == NULL
+      if (udp_find_conn(conn->domain, &conn->u, portno,
+                        udp_reuseport(conn)) == NULL
 #if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
           && !(conn->domain == PF_INET &&
                ipv4_nat_port_inuse(IP_PROTO_UDP, conn->u.ipv4.laddr,
@@ -833,7 +1063,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -886,7 +1116,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
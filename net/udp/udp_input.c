@@ -122,7 +122,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (chksum != 0 && !netdev_rxcsum_verified(dev))
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -142,6 +142,12 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
         }
 #endif /* CONFIG_NET_IPv6 */
     }
+  else
+    {
+      /* No checksum, or already validated by the hardware */
+
+      chksum = 0;
+    }
 
   if (chksum != 0)
     {
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * net/udp/udp_msfilter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_IGMP_SOURCE_FILTER
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_msfilter_find
+ *
+ * Description:
+ *   Return the index of the filter of a source for a group, or -1.
+ *
+ ****************************************************************************/
+
+static int udp_msfilter_find(FAR struct udp_conn_s *conn, in_addr_t group,
+                             in_addr_t source)
+{
+  int i;
+
+  for (i = 0; i < conn->nmsfilters; i++)
+    {
+      if (conn->msfilter[i].group == group &&
+          conn->msfilter[i].source == source)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_msfilter_add
+ ****************************************************************************/
+
+int udp_msfilter_add(FAR struct udp_conn_s *conn, in_addr_t group,
+                     in_addr_t source, uint8_t mode)
+{
+  FAR struct udp_msfilter_s *filter;
+  int i;
+
+  i = udp_msfilter_find(conn, group, source);
+  if (i >= 0)
+    {
+      return conn->msfilter[i].mode == mode ? -EADDRINUSE : -EINVAL;
+    }
+
+  if (conn->nmsfilters >= CONFIG_NET_IGMP_NSOURCES)
+    {
+      return -ENOBUFS;
+    }
+
+  filter         = &conn->msfilter[conn->nmsfilters++];
+  filter->group  = group;
+  filter->source = source;
+  filter->mode   = mode;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_msfilter_remove
+ ****************************************************************************/
+
+int udp_msfilter_remove(FAR struct udp_conn_s *conn, in_addr_t group,
+                        in_addr_t source, uint8_t mode)
+{
+  int i;
+
+  i = udp_msfilter_find(conn, group, source);
+  if (i < 0 || conn->msfilter[i].mode != mode)
+    {
+      return -EADDRNOTAVAIL;
+    }
+
+  /* Move the last entry into the hole */
+
+  conn->msfilter[i] = conn->msfilter[--conn->nmsfilters];
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_msfilter_count
+ ****************************************************************************/
+
+int udp_msfilter_count(FAR struct udp_conn_s *conn, in_addr_t group,
+                       uint8_t mode)
+{
+  int count = 0;
+  int i;
+
+  for (i = 0; i < conn->nmsfilters; i++)
+    {
+      if (conn->msfilter[i].group == group &&
+          conn->msfilter[i].mode == mode)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: udp_msfilter_accept
+ ****************************************************************************/
+
+bool udp_msfilter_accept(FAR struct udp_conn_s *conn, in_addr_t group,
+                         in_addr_t source)
+{
+  bool include = false;
+  int i;
+
+  if (conn->nmsfilters == 0 || !IN_MULTICAST(NTOHL(group)))
+    {
+      return true;
+    }
+
+  for (i = 0; i < conn->nmsfilters; i++)
+    {
+      if (conn->msfilter[i].group != group)
+        {
+          continue;
+        }
+
+      if (conn->msfilter[i].source == source)
+        {
+          return conn->msfilter[i].mode == MCAST_INCLUDE;
+        }
+
+      include |= conn->msfilter[i].mode == MCAST_INCLUDE;
+    }
+
+  /* The source is not listed:  It passes unless the group is restricted
+   * to its listed sources.
+   */
+
+  return !include;
+}
+
+#endif /* CONFIG_NET_IGMP_SOURCE_FILTER */
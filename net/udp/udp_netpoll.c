@@ -215,6 +215,15 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLRDNORM;
     }
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* Time stamps are waiting in the error queue */
+
+  if (!IOB_QEMPTY(&conn->errqueue))
+    {
+      eventset |= POLLERR;
+    }
+#endif
+
   if (psock_udp_cansend(conn) >= 0)
     {
       /* Normal data may be sent without blocking (at least one byte). */
@@ -62,12 +62,16 @@ struct udp_recvfrom_s
  ****************************************************************************/
 
 static void udp_recvpktinfo(FAR struct udp_recvfrom_s *pstate,
-                            FAR void *srcaddr, uint8_t ifindex)
+                            FAR void *srcaddr, uint8_t ifindex,
+                            FAR struct iob_s *iob)
 {
   FAR struct msghdr     *msg      = pstate->ir_msg;
   FAR struct udp_conn_s *conn     = pstate->ir_conn;
   FAR struct cmsghdr    *control  = msg->msg_control;
   size_t                 cmsg_len = 0;
+#ifdef CONFIG_NET_TIMESTAMPING
+  socklen_t              controllen = msg->msg_controllen;
+#endif
 
   if (!(conn->flags & _UDP_FLAG_PKTINFO))
     {
@@ -117,6 +121,10 @@ static void udp_recvpktinfo(FAR struct udp_recvfrom_s *pstate,
 
 out:
   msg->msg_controllen = cmsg_len;
+
+#ifdef CONFIG_NET_TIMESTAMPING
+  udp_tstamp_cmsg(conn, msg, controllen, iob);
+#endif
 }
 
 /****************************************************************************
@@ -220,7 +228,7 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
                  pstate->ir_msg->msg_namelen);
         }
 
-      udp_recvpktinfo(pstate, srcaddr, ifindex);
+      udp_recvpktinfo(pstate, srcaddr, ifindex, iob);
 
       /* Remove the I/O buffer chain from the head of the read-ahead
        * buffer queue.
@@ -336,10 +344,14 @@ static inline void udp_sender(FAR struct net_driver_s *dev,
       memcpy(pstate->ir_msg->msg_name, srcaddr, pstate->ir_msg->msg_namelen);
     }
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  udp_tstamp_recv(pstate->ir_conn, dev->d_iob);
+#endif
+
 #ifdef CONFIG_NETDEV_IFINDEX
-  udp_recvpktinfo(pstate, srcaddr, dev->d_ifindex);
+  udp_recvpktinfo(pstate, srcaddr, dev->d_ifindex, dev->d_iob);
 #else
-  udp_recvpktinfo(pstate, srcaddr, 0);
+  udp_recvpktinfo(pstate, srcaddr, 0, dev->d_iob);
 #endif
 }
 
@@ -575,6 +587,20 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    */
 
   net_lock();
+
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* The error queue holds the time stamps of the sent packets.  Reading
+   * it never blocks.
+   */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      ret = udp_tstamp_recverr(conn, msg);
+      net_unlock();
+      return ret;
+    }
+#endif
+
   udp_recvfrom_initialize(conn, msg, &state);
 
   /* Copy the read-ahead data from the packet */
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * net/udp/udp_segment.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/udp.h>
+
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_sendto_segments
+ *
+ * Description:
+ *   Send the data as consecutive datagrams of the UDP_SEGMENT size of the
+ *   socket, the last one possibly shorter.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent, which is less than
+ *   len if a datagram after the first could not be sent.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t udp_sendto_segments(FAR struct socket *psock,
+                            FAR const void *buf, size_t len, int flags,
+                            FAR const struct sockaddr *to, socklen_t tolen)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  uint16_t segment = conn->gso_size;
+  size_t offset = 0;
+  ssize_t ret = OK;
+
+  if ((len + segment - 1) / segment > UDP_MAX_SEGMENTS)
+    {
+      nerr("ERROR: Too many segments: len=%zu segment=%u\n", len, segment);
+      return -EINVAL;
+    }
+
+  /* Hold the network lock across the datagrams; each send takes it again
+   * recursively.
+   */
+
+  net_lock();
+
+  while (offset < len)
+    {
+      ret = psock_udp_sendto(psock, (FAR const uint8_t *)buf + offset,
+                             MIN(len - offset, segment), flags, to, tolen);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      offset += ret;
+    }
+
+  net_unlock();
+
+  return offset > 0 ? (ssize_t)offset : ret;
+}
+
+#endif /* CONFIG_NET_UDP_SEGMENT */
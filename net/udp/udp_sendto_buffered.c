@@ -261,7 +261,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Get the device that will handle the remote packet transfers.  This
@@ -454,6 +454,10 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 
       devif_iob_send(dev, wrb->wb_iob, sndlen, 0, udpiplen);
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      udp_tstamp_send(dev, conn);
+#endif
+
       /* Free the write buffer at the head of the queue and attempt to
        * setup the next transfer.
        */
@@ -547,6 +551,15 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   conn = psock->s_conn;
   DEBUGASSERT(conn);
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  /* Split a large send into datagrams of the UDP_SEGMENT size */
+
+  if (conn->gso_size > 0 && len > conn->gso_size)
+    {
+      return udp_sendto_segments(psock, buf, len, flags, to, tolen);
+    }
+#endif
+
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
    * used with a non-NULL destination address.  Normally send() would be
@@ -211,6 +211,10 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NET_TIMESTAMPING
+          udp_tstamp_send(dev, pstate->st_conn);
+#endif
+
           pstate->st_sndlen = pstate->st_buflen;
         }
 
@@ -282,6 +286,15 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   conn = psock->s_conn;
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  /* Split a large send into datagrams of the UDP_SEGMENT size */
+
+  if (conn->gso_size > 0 && len > conn->gso_size)
+    {
+      return udp_sendto_segments(psock, buf, len, flags, to, tolen);
+    }
+#endif
+
   if (to != NULL && _SS_ISCONNECTED(conn->sconn.s_flags))
     {
       /* EISCONN - A destination address was specified and the socket is
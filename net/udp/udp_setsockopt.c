@@ -74,6 +74,36 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
+#ifdef CONFIG_NET_UDP_SEGMENT
+  FAR struct udp_conn_s *conn;
+  int segment;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+  switch (option)
+    {
+      case UDP_SEGMENT: /* Split sends into datagrams of this size */
+        if (value == NULL || value_len != sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        segment = *(FAR const int *)value;
+        if (segment < 0 || segment > UDP_MAX_PAYLOAD)
+          {
+            nerr("ERROR: UDP_SEGMENT value out of range: %d\n", segment);
+            return -EINVAL;
+          }
+
+        conn->gso_size = segment;
+        return OK;
+
+      default:
+        break;
+    }
+#endif
+
   return -ENOPROTOOPT;
 }
 
@@ -0,0 +1,288 @@
+/****************************************************************************
+ * net/udp/udp_tstamp.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_UDP) && \
+    defined(CONFIG_NET_TIMESTAMPING)
+
+#include <sys/socket.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/net_tstamp.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The last key given to a socket that time stamps its transmissions */
+
+static uint32_t g_udp_tskey;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_tstamp_report
+ *
+ * Description:
+ *   Queue the time stamp of a sent packet on the error queue of its socket
+ *   and wake up the threads polling the socket.  The oldest time stamp is
+ *   dropped if the queue is full.
+ *
+ ****************************************************************************/
+
+static void udp_tstamp_report(FAR struct udp_conn_s *conn, uint8_t type,
+                              FAR const struct timespec *ts)
+{
+  FAR struct pollfd *fds;
+  FAR struct iob_s *iob;
+  int i;
+
+  if (conn->tsqlen >= CONFIG_NET_TIMESTAMPING_ERRQUEUE)
+    {
+      iob = iob_remove_queue(&conn->errqueue);
+      iob_free_chain(iob);
+      conn->tsqlen--;
+    }
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      nwarn("WARNING: No IOB for the time stamp\n");
+      return;
+    }
+
+  iob->io_tstype = type;
+  iob->io_tstamp = *ts;
+
+  if (iob_tryadd_queue(iob, &conn->errqueue) < 0)
+    {
+      iob_free(iob);
+      return;
+    }
+
+  conn->tsqlen++;
+
+  for (i = 0; i < CONFIG_NET_UDP_NPOLLWAITERS; i++)
+    {
+      if (conn->pollinfo[i].conn != NULL)
+        {
+          fds = conn->pollinfo[i].fds;
+          poll_notify(&fds, 1, POLLERR);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_tstamp_setflags
+ ****************************************************************************/
+
+int udp_tstamp_setflags(FAR struct udp_conn_s *conn, int flags)
+{
+  if ((flags & ~SOF_TIMESTAMPING_MASK) != 0 ||
+      (flags & SOF_TIMESTAMPING_SYS_HARDWARE) != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Each socket that time stamps its transmissions gets a key of its own,
+   * so that the packets still in flight when it closes or stops time
+   * stamping are not reported to another socket.
+   */
+
+  if ((flags & SOF_TIMESTAMPING_TX_HARDWARE) != 0 && conn->tskey == 0)
+    {
+      if (++g_udp_tskey == 0)
+        {
+          g_udp_tskey++;
+        }
+
+      conn->tskey = g_udp_tskey;
+    }
+  else if ((flags & SOF_TIMESTAMPING_TX_HARDWARE) == 0)
+    {
+      conn->tskey = 0;
+    }
+
+  conn->tsflags = flags;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_send
+ ****************************************************************************/
+
+void udp_tstamp_send(FAR struct net_driver_s *dev,
+                     FAR struct udp_conn_s *conn)
+{
+  struct timespec ts;
+
+  if (dev->d_sndlen == 0 || dev->d_iob == NULL)
+    {
+      return;
+    }
+
+  /* Ask the driver to report when the packet leaves the MAC */
+
+  dev->d_iob->io_tskey = conn->tskey;
+
+  if ((conn->tsflags & SOF_TIMESTAMPING_TX_SOFTWARE) != 0)
+    {
+      clock_gettime(CLOCK_REALTIME, &ts);
+      udp_tstamp_report(conn, IOB_TSTAMP_SOFTWARE, &ts);
+    }
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_recv
+ ****************************************************************************/
+
+void udp_tstamp_recv(FAR struct udp_conn_s *conn, FAR struct iob_s *iob)
+{
+  /* Only one time stamp is kept:  That of the MAC if it is wanted, else
+   * one taken now.
+   */
+
+  if (iob->io_tstype == IOB_TSTAMP_HARDWARE &&
+      (conn->tsflags & SOF_TIMESTAMPING_RX_HARDWARE) != 0)
+    {
+      return;
+    }
+
+  if ((conn->tsflags & SOF_TIMESTAMPING_RX_SOFTWARE) != 0)
+    {
+      clock_gettime(CLOCK_REALTIME, &iob->io_tstamp);
+      iob->io_tstype = IOB_TSTAMP_SOFTWARE;
+    }
+  else
+    {
+      iob->io_tstype = IOB_TSTAMP_NONE;
+    }
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_cmsg
+ ****************************************************************************/
+
+void udp_tstamp_cmsg(FAR struct udp_conn_s *conn, FAR struct msghdr *msg,
+                     socklen_t controllen, FAR struct iob_s *iob)
+{
+  FAR struct scm_timestamping *tss;
+  FAR struct cmsghdr *cmsg;
+  socklen_t offset;
+
+  if (iob->io_tstype == IOB_TSTAMP_SOFTWARE)
+    {
+      if ((conn->tsflags & SOF_TIMESTAMPING_SOFTWARE) == 0)
+        {
+          return;
+        }
+    }
+  else if (iob->io_tstype != IOB_TSTAMP_HARDWARE ||
+           (conn->tsflags & SOF_TIMESTAMPING_RAW_HARDWARE) == 0)
+    {
+      return;
+    }
+
+  offset = CMSG_ALIGN(msg->msg_controllen);
+  if (msg->msg_control == NULL || offset > controllen ||
+      controllen - offset < CMSG_LEN(sizeof(struct scm_timestamping)))
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+      return;
+    }
+
+  cmsg             = (FAR struct cmsghdr *)
+                     ((FAR uint8_t *)msg->msg_control + offset);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type  = SCM_TIMESTAMPING;
+  cmsg->cmsg_len   = CMSG_LEN(sizeof(struct scm_timestamping));
+
+  tss = CMSG_DATA(cmsg);
+  memset(tss, 0, sizeof(struct scm_timestamping));
+  tss->ts[iob->io_tstype == IOB_TSTAMP_HARDWARE ? 2 : 0] = iob->io_tstamp;
+
+  msg->msg_controllen = offset + cmsg->cmsg_len;
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_recverr
+ ****************************************************************************/
+
+ssize_t udp_tstamp_recverr(FAR struct udp_conn_s *conn,
+                           FAR struct msghdr *msg)
+{
+  socklen_t controllen = msg->msg_controllen;
+  FAR struct iob_s *iob;
+
+  iob = iob_remove_queue(&conn->errqueue);
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  conn->tsqlen--;
+
+  msg->msg_namelen    = 0;
+  msg->msg_controllen = 0;
+  msg->msg_flags     |= MSG_ERRQUEUE;
+
+  udp_tstamp_cmsg(conn, msg, controllen, iob);
+  iob_free_chain(iob);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: udp_txtstamp
+ ****************************************************************************/
+
+void udp_txtstamp(uint32_t key, FAR const struct timespec *ts)
+{
+  FAR struct udp_conn_s *conn = NULL;
+
+  while ((conn = udp_nextconn(conn)) != NULL)
+    {
+      if (conn->tskey == key)
+        {
+          udp_tstamp_report(conn, IOB_TSTAMP_HARDWARE, ts);
+          break;
+        }
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_TIMESTAMPING */
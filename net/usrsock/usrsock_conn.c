@@ -107,6 +107,7 @@ FAR struct usrsock_conn_s *usrsock_alloc(void)
       nxsem_init(&conn->resp.sem, 0, 1);
       conn->usockid = -1;
       conn->state = USRSOCK_CONN_STATE_UNINITIALIZED;
+      nxrmutex_init(&conn->sconn.s_lock);
 
       /* Enqueue the connection into the active list */
 
@@ -35,27 +35,43 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/queue.h>
 #include <nuttx/random.h>
-#include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
 
 #include "usrsock/usrsock.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_USRSOCK_NREQUESTS
+#  define CONFIG_NET_USRSOCK_NREQUESTS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* A request that has been handed to the daemon and is waiting for its
+ * acknowledgment.  Lives on the stack of the requesting thread.
+ */
+
+struct usrsock_ackwait_s
+{
+  sq_entry_t node;            /* Entry in g_usrsock_req.ackwaits */
+  uint32_t   xid;             /* Exchange id of the request */
+  sem_t      sem;             /* Acknowledgment notification */
+};
+
 struct usrsock_req_s
 {
-  mutex_t  lock;              /* Request mutex (only one outstanding
-                               * request) */
-  sem_t    acksem;            /* Request acknowledgment notification */
+  sem_t    reqsem;            /* Free slots for requests outstanding on
+                               * the daemon link */
   uint32_t newxid;            /* New transcation Id */
-  uint32_t ackxid;            /* Exchange id for which waiting ack */
-  uint16_t nbusy;             /* Number of requests blocked from different
-                               * threads */
+  sq_queue_t ackwaits;        /* Requests waiting for acknowledgment */
 
   /* Connection instance to receive data buffers. */
 
@@ -73,11 +89,12 @@ struct usrsock_req_s
 
 static struct usrsock_req_s g_usrsock_req =
 {
-  NXMUTEX_INITIALIZER,
-  SEM_INITIALIZER(0),
-  0,
-  0,
+  SEM_INITIALIZER(CONFIG_NET_USRSOCK_NREQUESTS),
   0,
+  {
+    NULL,
+    NULL
+  },
   NULL
 };
 
@@ -188,6 +205,35 @@ out:
   return total;
 }
 
+/****************************************************************************
+ * Name: usrsock_find_ackwait
+ *
+ * Description:
+ *   Find the thread waiting for the acknowledgment of request 'xid'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct usrsock_ackwait_s *usrsock_find_ackwait(uint32_t xid)
+{
+  FAR sq_entry_t *node;
+
+  for (node = sq_peek(&g_usrsock_req.ackwaits); node; node = sq_next(node))
+    {
+      FAR struct usrsock_ackwait_s *wait =
+        (FAR struct usrsock_ackwait_s *)node;
+
+      if (wait->xid == xid)
+        {
+          return wait;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: usrsock_handle_event
  ****************************************************************************/
@@ -427,7 +473,7 @@ static ssize_t usrsock_handle_req_response(FAR const void *buffer,
 {
   FAR const struct usrsock_message_req_ack_s *hdr = buffer;
   FAR struct usrsock_conn_s *conn = NULL;
-  FAR struct usrsock_req_s *req = &g_usrsock_req;
+  FAR struct usrsock_ackwait_s *wait;
   ssize_t (*handle_response)(FAR struct usrsock_conn_s *conn,
                              FAR const void *buffer,
                              size_t len);
@@ -476,9 +522,10 @@ static ssize_t usrsock_handle_req_response(FAR const void *buffer,
       goto unlock_out;
     }
 
-  if (req->ackxid == hdr->xid)
+  wait = usrsock_find_ackwait(hdr->xid);
+  if (wait != NULL)
     {
-      req->ackxid = 0;
+      sq_rem(&wait->node, &g_usrsock_req.ackwaits);
       if (req_done)
         {
           *req_done = true;
@@ -488,7 +535,7 @@ static ssize_t usrsock_handle_req_response(FAR const void *buffer,
        * acknowledgment response was received.
        */
 
-      nxsem_post(&req->acksem);
+      nxsem_post(&wait->sem);
     }
 
   conn->resp.events = hdr->head.events | USRSOCK_EVENT_REQ_COMPLETE;
@@ -527,6 +574,12 @@ static ssize_t usrsock_handle_message(FAR const void *buffer, size_t len,
 
 /****************************************************************************
  * Name: usrsock_response() - handle usrsock request's ack/response
+ *
+ * Description:
+ *   The buffer may hold several messages back to back, so that the daemon
+ *   can deliver a batch of events and acknowledgments with a single
+ *   transfer.
+ *
  ****************************************************************************/
 
 ssize_t usrsock_response(FAR const char *buffer, size_t len,
@@ -535,70 +588,78 @@ ssize_t usrsock_response(FAR const char *buffer, size_t len,
   FAR struct usrsock_req_s *req = &g_usrsock_req;
   FAR struct usrsock_conn_s *conn;
   size_t origlen = len;
-  int ret = 0;
+  ssize_t ret = 0;
 
-  if (!req->datain_conn)
+  while (len > 0)
     {
-      /* Start of message, buffer length should be at least size of common
-       * message header.
-       */
-
-      if (len < sizeof(struct usrsock_message_common_s))
+      if (!req->datain_conn)
         {
-          nwarn("message too short, %zu < %zu.\n", len,
-                sizeof(struct usrsock_message_common_s));
-          return -EINVAL;
-        }
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
+
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              nwarn("message too short, %zu < %zu.\n", len,
+                    sizeof(struct usrsock_message_common_s));
+              return -EINVAL;
+            }
 
-      /* Handle message. */
+          /* Handle message. */
+
+          ret = usrsock_handle_message(buffer, len, req_done);
+          if (ret < 0)
+            {
+              return ret;
+            }
 
-      ret = usrsock_handle_message(buffer, len, req_done);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
-          ret = origlen - len;
         }
-    }
 
-  if (req->datain_conn)
-    {
-      conn = req->datain_conn;
+      if (req->datain_conn)
+        {
+          conn = req->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      if (len != 0)
-        {
-          ret = usrsock_iovec_put(conn->resp.datain.iov,
-                                  conn->resp.datain.iovcnt,
-                                  conn->resp.datain.pos, buffer, len);
-          if (ret < 0)
+          if (len != 0)
             {
-              /* Tried writing beyond buffer. */
-
-              conn->resp.result = ret;
-              conn->resp.datain.pos = conn->resp.datain.total;
+              ret = usrsock_iovec_put(conn->resp.datain.iov,
+                                      conn->resp.datain.iovcnt,
+                                      conn->resp.datain.pos, buffer, len);
+              if (ret < 0)
+                {
+                  /* Tried writing beyond buffer. */
+
+                  conn->resp.result = ret;
+                  conn->resp.datain.pos = conn->resp.datain.total;
+                }
+              else
+                {
+                  conn->resp.datain.pos += ret;
+                  buffer += ret;
+                  len -= ret;
+                }
             }
-          else
+
+          if (conn->resp.datain.pos == conn->resp.datain.total)
             {
-              conn->resp.datain.pos += ret;
-              buffer += ret;
-              len -= ret;
-              ret = origlen - len;
-            }
-        }
+              req->datain_conn = NULL;
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
-        {
-          req->datain_conn = NULL;
+              /* Done with data response. */
 
-          /* Done with data response. */
+              usrsock_event(conn);
+            }
 
-          usrsock_event(conn);
+          if (ret < 0)
+            {
+              return ret;
+            }
         }
     }
 
-  return ret;
+  return origlen - len;
 }
 
 /****************************************************************************
@@ -624,8 +685,29 @@ ssize_t usrsock_iovec_put(FAR struct iovec *iov, int iovcnt, size_t pos,
                           pos, false, NULL);
 }
 
+/****************************************************************************
+ * Name: usrsock_request_pending() - is the request still waiting for ack
+ ****************************************************************************/
+
+bool usrsock_request_pending(uint32_t xid)
+{
+  bool pending;
+
+  net_lock();
+  pending = usrsock_find_ackwait(xid) != NULL;
+  net_unlock();
+
+  return pending;
+}
+
 /****************************************************************************
  * Name: usrsock_request() - finish usrsock's request
+ *
+ * Description:
+ *   Up to CONFIG_NET_USRSOCK_NREQUESTS requests from different threads
+ *   may be outstanding on the daemon link at the same time; each caller
+ *   only waits for the acknowledgment of its own request.
+ *
  ****************************************************************************/
 
 int usrsock_do_request(FAR struct usrsock_conn_s *conn,
@@ -633,15 +715,16 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
 {
   FAR struct usrsock_request_common_s *req_head = NULL;
   FAR struct usrsock_req_s *req = &g_usrsock_req;
+  struct usrsock_ackwait_s wait;
   int ret;
 
   /* Get exchange id. */
 
   req_head = iov[0].iov_base;
 
-  /* Set outstanding request for daemon to handle. */
+  /* Wait for a free request slot on the daemon link. */
 
-  net_lockedwait_uninterruptible(&req->lock);
+  net_lockedwait_uninterruptible(&req->reqsem);
   if (++req->newxid == 0)
     {
       ++req->newxid;
@@ -654,21 +737,27 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
-  req->ackxid = req_head->xid;
+  wait.xid = req_head->xid;
+  nxsem_init(&wait.sem, 0, 0);
+  sq_addlast(&wait.node, &req->ackwaits); /* net_lock held. */
 
   ret = usrsock_request(iov, iovcnt);
   if (ret == OK)
     {
       /* Wait ack for request. */
 
-      ++req->nbusy; /* net_lock held. */
-      net_lockedwait_uninterruptible(&req->acksem);
-      --req->nbusy; /* net_lock held. */
+      net_lockedwait_uninterruptible(&wait.sem);
+    }
+  else if (usrsock_find_ackwait(wait.xid) != NULL)
+    {
+      sq_rem(&wait.node, &req->ackwaits);
     }
 
-  /* Free request line for next command. */
+  nxsem_destroy(&wait.sem);
+
+  /* Free request slot for next command. */
 
-  nxmutex_unlock(&req->lock);
+  nxsem_post(&req->reqsem);
   return ret;
 }
 
@@ -680,7 +769,7 @@ void usrsock_abort(void)
 {
   FAR struct usrsock_req_s *req = &g_usrsock_req;
   FAR struct usrsock_conn_s *conn = NULL;
-  int ret;
+  FAR struct usrsock_ackwait_s *wait;
 
   net_lock();
 
@@ -694,36 +783,13 @@ void usrsock_abort(void)
       usrsock_event(conn);
     }
 
-  do
-    {
-      /* Give other threads short time window to complete recently completed
-       * requests.
-       */
-
-      ret = net_timedwait(&req->lock, 10);
-      if (ret < 0)
-        {
-          if (ret != -ETIMEDOUT && ret != -EINTR)
-            {
-              ninfo("net_timedwait errno: %d\n", ret);
-              DEBUGASSERT(false);
-            }
-        }
-      else
-        {
-          nxmutex_unlock(&req->lock);
-        }
-
-      /* Wake-up pending requests. */
+  /* Wake-up pending requests. */
 
-      if (req->nbusy == 0)
-        {
-          break;
-        }
-
-      nxsem_post(&req->acksem);
+  while ((wait = (FAR struct usrsock_ackwait_s *)
+                 sq_remfirst(&req->ackwaits)) != NULL)
+    {
+      nxsem_post(&wait->sem);
     }
-  while (true);
 
   net_unlock();
 }
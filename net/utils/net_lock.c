@@ -37,6 +37,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
 
 #include "utils/utils.h"
 
@@ -183,6 +184,84 @@ void net_unlock(void)
   nxrmutex_unlock(&g_netlock);
 }
 
+/****************************************************************************
+ * Name: netdev_lock
+ *
+ * Description:
+ *   Take the lock of a network device.
+ *
+ * Input Parameters:
+ *   dev - The device to be locked
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int netdev_lock(FAR struct net_driver_s *dev)
+{
+  return nxrmutex_lock(&dev->d_lock);
+}
+
+/****************************************************************************
+ * Name: netdev_unlock
+ *
+ * Description:
+ *   Release the lock of a network device.
+ *
+ * Input Parameters:
+ *   dev - The device to be unlocked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void netdev_unlock(FAR struct net_driver_s *dev)
+{
+  nxrmutex_unlock(&dev->d_lock);
+}
+
+/****************************************************************************
+ * Name: conn_lock
+ *
+ * Description:
+ *   Take the lock of a connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be locked
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int conn_lock(FAR struct socket_conn_s *sconn)
+{
+  return nxrmutex_lock(&sconn->s_lock);
+}
+
+/****************************************************************************
+ * Name: conn_unlock
+ *
+ * Description:
+ *   Release the lock of a connection.
+ *
+ * Input Parameters:
+ *   sconn - The common prologue of the connection to be unlocked
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void conn_unlock(FAR struct socket_conn_s *sconn)
+{
+  nxrmutex_unlock(&sconn->s_lock);
+}
+
 /****************************************************************************
  * Name: net_breaklock
  *
@@ -73,6 +73,14 @@ extern struct timespec  g_basetime;
 int  clock_basetime(FAR struct timespec *tp);
 
 void clock_initialize(void);
+#ifdef CONFIG_CLOCK_TIMEPAGE
+void clock_timepage_initialize(void);
+void clock_timepage_update(void);
+#else
+#  define clock_timepage_initialize()
+#  define clock_timepage_update()
+#endif
+
 #ifndef CONFIG_SCHED_TICKLESS
 void clock_timer(void);
 #else
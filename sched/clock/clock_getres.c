@@ -69,6 +69,16 @@ int clock_getres(clockid_t clock_id, struct timespec *res)
         sinfo("Returning res=(%d,%d)\n", (int)res->tv_sec,
                                          (int)res->tv_nsec);
         break;
+
+#ifdef CONFIG_PTP_CLOCK
+      case CLOCK_PTP:
+
+        /* The hardware clocks count nanoseconds */
+
+        res->tv_sec  = 0;
+        res->tv_nsec = 1;
+        break;
+#endif
     }
 
   return ret;
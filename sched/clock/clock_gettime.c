@@ -31,7 +31,9 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/sched.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/timers/ptp_clock.h>
 
 #include "clock/clock.h"
 #ifdef CONFIG_CLOCK_TIMEKEEPING
@@ -50,7 +52,11 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_CLOCK_TIMEPAGE
+int nx_clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+#else
 int clock_gettime(clockid_t clock_id, struct timespec *tp)
+#endif
 {
 #ifndef CONFIG_CLOCK_TIMEKEEPING
   struct timespec ts;
@@ -132,6 +138,19 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
         }
 #endif /* CONFIG_CLOCK_TIMEKEEPING */
     }
+#ifdef CONFIG_SCHED_CPUTIME
+  else if (clock_id == CLOCK_THREAD_CPUTIME_ID)
+    {
+      nxsched_get_cputime(nxsched_self(), tp);
+      ret = OK;
+    }
+#endif
+#ifdef CONFIG_PTP_CLOCK
+  else if (clock_id == CLOCK_PTP)
+    {
+      ret = ptp_clock_gettime(tp);
+    }
+#endif
   else
     {
       ret = -EINVAL;
@@ -182,6 +182,8 @@ static void clock_inittime(FAR const struct timespec *tp)
       g_basetime.tv_nsec += NSEC_PER_SEC;
       g_basetime.tv_sec--;
     }
+
+  clock_timepage_update();
 #else
   clock_inittimekeeping(tp);
 #endif
@@ -202,6 +204,10 @@ static void clock_inittime(FAR const struct timespec *tp)
 
 void clock_initialize(void)
 {
+  /* Allocate the time page before anything can update the time */
+
+  clock_timepage_initialize();
+
 #if !defined(CONFIG_SUPPRESS_INTERRUPTS) && \
     !defined(CONFIG_SUPPRESS_TIMER_INTS) && \
     !defined(CONFIG_SYSTEMTICK_EXTCLK)
@@ -396,6 +402,7 @@ void clock_resynchronize(FAR struct timespec *rtc_diff)
 
       g_system_ticks += SEC2TICK(rtc_diff->tv_sec);
       g_system_ticks += NSEC2TICK(rtc_diff->tv_nsec);
+      clock_timepage_update();
     }
 
 skip:
@@ -419,5 +426,6 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_ticks++;
+  clock_timepage_update();
 }
 #endif
@@ -31,6 +31,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/timers/ptp_clock.h>
 
 #include "clock/clock.h"
 #ifdef CONFIG_CLOCK_TIMEKEEPING
@@ -101,6 +102,7 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 
       g_basetime.tv_nsec -= bias.tv_nsec;
       g_basetime.tv_sec  -= bias.tv_sec;
+      clock_timepage_update();
 
       /* Setup the RTC (lo- or high-res) */
 
@@ -120,6 +122,18 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
       ret = clock_timekeeping_set_wall_time(tp);
 #endif
     }
+#ifdef CONFIG_PTP_CLOCK
+  else if (clock_id == CLOCK_PTP &&
+           tp->tv_nsec >= 0 && tp->tv_nsec < 1000000000)
+    {
+      ret = ptp_clock_settime(tp);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          ret = ERROR;
+        }
+    }
+#endif
   else
     {
       serr("Returning ERROR\n");
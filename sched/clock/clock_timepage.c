@@ -0,0 +1,111 @@
+/****************************************************************************
+ * sched/clock/clock_timepage.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The page lives in the user heap so that the C library can read it */
+
+static FAR struct clock_timepage_s *g_clock_timepage;
+
+/* Serializes the timer interrupt and clock_settime() on SMP */
+
+static spinlock_t g_clock_timepage_lock;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_timepage_initialize
+ *
+ * Description:
+ *   Allocate the time page.  The C library falls back to the system call
+ *   if this fails.
+ *
+ ****************************************************************************/
+
+void clock_timepage_initialize(void)
+{
+  g_clock_timepage = kumm_zalloc(sizeof(struct clock_timepage_s));
+  clock_timepage_update();
+}
+
+/****************************************************************************
+ * Name: clock_timepage_update
+ *
+ * Description:
+ *   Copy the system timer and the base time to the time page.  This must
+ *   be called whenever either of them changes.
+ *
+ ****************************************************************************/
+
+void clock_timepage_update(void)
+{
+  FAR struct clock_timepage_s *page = g_clock_timepage;
+  irqstate_t flags;
+
+  if (page == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_clock_timepage_lock);
+
+  page->seq++;
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  page->ticks    = g_system_ticks;
+  page->basetime = g_basetime;
+
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  page->seq++;
+
+  spin_unlock_irqrestore(&g_clock_timepage_lock, flags);
+}
+
+/****************************************************************************
+ * Name: clock_timepage
+ *
+ * Description:
+ *   Return the time page, which the caller can read but must not modify.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_timepage_s *clock_timepage(void)
+{
+  return g_clock_timepage;
+}
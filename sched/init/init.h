@@ -49,6 +49,28 @@
 
 void nx_start(void);
 
+/****************************************************************************
+ * Name: nx_bootinit
+ *
+ * Description:
+ *   Run the boot initializers registered with bootinit_register(), except
+ *   the deferred ones, and wait for them to complete.
+ *   nx_bootinit_deferred() starts the deferred ones once the application
+ *   has been started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOOTINIT
+void nx_bootinit(void);
+void nx_bootinit_deferred(void);
+#endif
+
 /****************************************************************************
  * Name: nx_smp_start
  *
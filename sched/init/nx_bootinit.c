@@ -0,0 +1,355 @@
+/****************************************************************************
+ * sched/init/nx_bootinit.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <syslog.h>
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#include "init/init.h"
+
+#ifdef CONFIG_BOOTINIT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The states of an initializer */
+
+#define BOOTINIT_WAITING  1        /* Registered, not started */
+#define BOOTINIT_RUNNING  2        /* Taken by a worker */
+#define BOOTINIT_DONE     3        /* bi_result is valid */
+
+/* The phases of the boot */
+
+#define BOOTINIT_IDLE     0        /* Only registration */
+#define BOOTINIT_EARLY    1        /* Run the initializers waited for */
+#define BOOTINIT_ALL      2        /* Run the deferred ones too */
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bootinit_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct bootinit_s *g_bootinit_head;
+static FAR struct bootinit_s *g_bootinit_tail;
+static struct work_s g_bootinit_work[CONFIG_BOOTINIT_NWORKERS];
+static sem_t g_bootinit_sem = SEM_INITIALIZER(0);
+static uint8_t g_bootinit_phase;
+static int g_bootinit_pending;  /* Not deferred and not done */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bootinit_usec
+ *
+ * Description:
+ *   Return the time since boot in microseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t bootinit_usec(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: bootinit_ready
+ *
+ * Description:
+ *   Return true if the initializer may run now.  Called within a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static bool bootinit_ready(FAR struct bootinit_s *init)
+{
+  FAR struct bootinit_s * const *dep;
+
+  if (init->bi_state != BOOTINIT_WAITING ||
+      ((init->bi_flags & BOOTINIT_DEFERRED) != 0 &&
+       g_bootinit_phase < BOOTINIT_ALL))
+    {
+      return false;
+    }
+
+  for (dep = init->bi_depends; dep != NULL && *dep != NULL; dep++)
+    {
+      if ((*dep)->bi_state != BOOTINIT_DONE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: bootinit_take
+ *
+ * Description:
+ *   Take the first initializer that may run now, or return NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct bootinit_s *bootinit_take(void)
+{
+  FAR struct bootinit_s *init;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  for (init = g_bootinit_head; init != NULL; init = init->bi_flink)
+    {
+      if (bootinit_ready(init))
+        {
+          init->bi_state = BOOTINIT_RUNNING;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return init;
+}
+
+/****************************************************************************
+ * Name: bootinit_run
+ *
+ * Description:
+ *   Run an initializer whose dependencies are done and return its result.
+ *
+ ****************************************************************************/
+
+static int bootinit_run(FAR struct bootinit_s *init)
+{
+  FAR struct bootinit_s * const *dep;
+  int ret;
+
+  for (dep = init->bi_depends; dep != NULL && *dep != NULL; dep++)
+    {
+      if ((*dep)->bi_result < 0)
+        {
+          return -ECANCELED;
+        }
+    }
+
+  init->bi_start   = bootinit_usec();
+  ret              = init->bi_init();
+  init->bi_elapsed = bootinit_usec() - init->bi_start;
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bootinit_kick
+ *
+ * Description:
+ *   Start the idle workers.  They return at once if nothing is ready.
+ *
+ ****************************************************************************/
+
+static void bootinit_kick(void)
+{
+  int i;
+
+  if (g_bootinit_phase == BOOTINIT_IDLE)
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_BOOTINIT_NWORKERS; i++)
+    {
+      if (work_available(&g_bootinit_work[i]))
+        {
+          work_queue(LPWORK, &g_bootinit_work[i], bootinit_worker, NULL, 0);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bootinit_worker
+ *
+ * Description:
+ *   Run the initializers that are ready, one after the other, on a
+ *   low-priority worker thread.
+ *
+ ****************************************************************************/
+
+static void bootinit_worker(FAR void *arg)
+{
+  FAR struct bootinit_s *init;
+  irqstate_t flags;
+  int ret;
+
+  while ((init = bootinit_take()) != NULL)
+    {
+      ret = bootinit_run(init);
+
+#ifdef CONFIG_BOOTINIT_REPORT
+      syslog(LOG_INFO, "bootinit: %s: %" PRIu32 " us at %" PRIu32
+             " us: %d\n", init->bi_name, init->bi_elapsed, init->bi_start,
+             ret);
+#endif
+
+      flags = enter_critical_section();
+
+      init->bi_result = ret;
+      init->bi_state  = BOOTINIT_DONE;
+
+      if ((init->bi_flags & BOOTINIT_DEFERRED) == 0 &&
+          --g_bootinit_pending == 0)
+        {
+          nxsem_post(&g_bootinit_sem);
+        }
+
+      leave_critical_section(flags);
+
+      /* Its dependents may be ready now */
+
+      bootinit_kick();
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bootinit_register
+ *
+ * Description:
+ *   Register a boot initializer.  See include/nuttx/init.h.
+ *
+ ****************************************************************************/
+
+int bootinit_register(FAR struct bootinit_s *init)
+{
+  FAR struct bootinit_s * const *dep;
+  irqstate_t flags;
+
+  DEBUGASSERT(init != NULL && init->bi_init != NULL);
+
+  for (dep = init->bi_depends; dep != NULL && *dep != NULL; dep++)
+    {
+      if ((*dep)->bi_state == 0)
+        {
+          return -ENOENT;
+        }
+
+      if (((*dep)->bi_flags & BOOTINIT_DEFERRED) != 0 &&
+          (init->bi_flags & BOOTINIT_DEFERRED) == 0)
+        {
+          return -EINVAL;
+        }
+    }
+
+  init->bi_flink   = NULL;
+  init->bi_result  = 0;
+  init->bi_start   = 0;
+  init->bi_elapsed = 0;
+
+  flags = enter_critical_section();
+
+  init->bi_state = BOOTINIT_WAITING;
+  if (g_bootinit_tail != NULL)
+    {
+      g_bootinit_tail->bi_flink = init;
+    }
+  else
+    {
+      g_bootinit_head = init;
+    }
+
+  g_bootinit_tail = init;
+
+  if ((init->bi_flags & BOOTINIT_DEFERRED) == 0)
+    {
+      g_bootinit_pending++;
+    }
+
+  leave_critical_section(flags);
+
+  /* Registered by an initializer: it may run at once */
+
+  bootinit_kick();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nx_bootinit
+ *
+ * Description:
+ *   Run the registered initializers, except the deferred ones, and wait
+ *   for them to complete.
+ *
+ ****************************************************************************/
+
+void nx_bootinit(void)
+{
+  g_bootinit_phase = BOOTINIT_EARLY;
+  bootinit_kick();
+
+  while (g_bootinit_pending > 0)
+    {
+      nxsem_wait_uninterruptible(&g_bootinit_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: nx_bootinit_deferred
+ *
+ * Description:
+ *   Start the deferred initializers once the application has been
+ *   started.  They complete in the background.
+ *
+ ****************************************************************************/
+
+void nx_bootinit_deferred(void)
+{
+  g_bootinit_phase = BOOTINIT_ALL;
+  bootinit_kick();
+}
+
+#endif /* CONFIG_BOOTINIT */
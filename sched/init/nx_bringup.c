@@ -249,6 +249,14 @@ static inline void nx_start_application(void)
   board_late_initialize();
 #endif
 
+#ifdef CONFIG_BOOTINIT
+  /* Run the initializers registered by the board logic.  Only the deferred
+   * ones may still be running when the application starts.
+   */
+
+  nx_bootinit();
+#endif
+
 #if defined(CONFIG_INIT_ENTRY)
 
   /* Start the application initialization task.  In a flat build, this is
@@ -299,6 +307,12 @@ static inline void nx_start_application(void)
   DEBUGASSERT(ret >= 0);
 #endif
 
+#ifdef CONFIG_BOOTINIT
+  /* The application is started, the deferred initializers may run */
+
+  nx_bootinit_deferred();
+#endif
+
   UNUSED(ret);
 }
 
@@ -60,11 +60,14 @@ struct irq_info_s
   FAR void *arg;     /* The argument provided to the interrupt handler. */
 #ifdef CONFIG_SCHED_IRQMONITOR
   clock_t start;     /* Time interrupt attached */
+
+  /* The counts are kept per CPU so that they need no lock */
+
 #ifdef CONFIG_HAVE_LONG_LONG
-  uint64_t count;    /* Number of interrupts on this IRQ */
+  uint64_t count[CONFIG_SMP_NCPUS];   /* Number of interrupts on this IRQ */
 #else
-  uint32_t mscount;  /* Number of interrupts on this IRQ (MS) */
-  uint32_t lscount;  /* Number of interrupts on this IRQ (LS) */
+  uint32_t mscount[CONFIG_SMP_NCPUS]; /* Number of interrupts (MS) */
+  uint32_t lscount[CONFIG_SMP_NCPUS]; /* Number of interrupts (LS) */
 #endif
   uint32_t time;     /* Maximum execution time on this IRQ */
 #endif
@@ -102,8 +105,16 @@ extern struct irq_info_s g_irqvector[NR_IRQS];
  * declaration is here for the time being.
  */
 
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE_DYNAMIC
+extern irq_mapped_t g_irqmap[NR_IRQS];
+
+/* The number of entries of the vector table already mapped */
+
+extern int g_irqmap_count;
+#else
 extern const irq_mapped_t g_irqmap[NR_IRQS];
 #endif
+#endif
 
 #ifdef CONFIG_SMP
 /* This is the spinlock that enforces critical sections when interrupts are
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <string.h>
 
 #include <nuttx/irq.h>
 
@@ -53,14 +54,30 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
       irqstate_t flags;
       int ndx;
 
+      flags = enter_critical_section();
+
 #ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
       /* Is there a mapping for this IRQ number? */
 
       ndx = g_irqmap[irq];
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE_DYNAMIC
+      if (ndx == IRQMAPPED_MAX && isr != NULL &&
+          g_irqmap_count < CONFIG_ARCH_NUSER_INTERRUPTS)
+        {
+          /* No.. map it to the next free entry.  The entry stays mapped
+           * when the ISR is detached, to be reused if it is attached again.
+           */
+
+          ndx           = g_irqmap_count++;
+          g_irqmap[irq] = ndx;
+        }
+#endif
+
       if ((unsigned)ndx >= CONFIG_ARCH_NUSER_INTERRUPTS)
         {
           /* No.. then return failure. */
 
+          leave_critical_section(flags);
           return ret;
         }
 #else
@@ -72,7 +89,6 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
        * to the unexpected interrupt handler.
        */
 
-      flags = enter_critical_section();
       if (isr == NULL)
         {
           /* Disable the interrupt if we can before detaching it.  We might
@@ -118,10 +134,12 @@ int irq_attach(int irq, xcpt_t isr, FAR void *arg)
 #ifdef CONFIG_SCHED_IRQMONITOR
       g_irqvector[ndx].start   = clock_systime_ticks();
 #ifdef CONFIG_HAVE_LONG_LONG
-      g_irqvector[ndx].count   = 0;
+      memset(g_irqvector[ndx].count, 0, sizeof(g_irqvector[ndx].count));
 #else
-      g_irqvector[ndx].mscount = 0;
-      g_irqvector[ndx].lscount = 0;
+      memset(g_irqvector[ndx].mscount, 0,
+             sizeof(g_irqvector[ndx].mscount));
+      memset(g_irqvector[ndx].lscount, 0,
+             sizeof(g_irqvector[ndx].lscount));
 #endif
 #endif
 
@@ -0,0 +1,263 @@
+/****************************************************************************
+ * sched/irq/irq_attach_thread.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+
+#include "irq/irq.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This describes one interrupt handled by a thread */
+
+struct irq_thread_s
+{
+  sq_entry_t node;            /* Supports a list of threaded interrupts */
+  xcpt_t isr;                 /* The handler in the interrupt context */
+  xcpt_t isrthread;           /* The handler in the thread */
+  FAR void *arg;              /* The argument of both handlers */
+  sem_t sem;                  /* Wakes up the thread */
+  int irq;                    /* The IRQ number */
+  bool stop;                  /* The thread is asked to terminate */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_irq_threads;
+static mutex_t g_irq_threads_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   Run the handler in the interrupt context, if any, and wake up the
+ *   thread if it returns IRQ_WAKE_THREAD.  The interrupt is disabled until
+ *   the thread has handled it, so that a level triggered interrupt does
+ *   not fire again in the meantime.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct irq_thread_s *info = arg;
+  int ret = IRQ_WAKE_THREAD;
+
+  if (info->isr != NULL)
+    {
+      ret = info->isr(irq, context, info->arg);
+    }
+
+  if (ret == IRQ_WAKE_THREAD)
+    {
+#if !defined(CONFIG_ARCH_NOINTC) && !defined(CONFIG_ARCH_VECNOTIRQ)
+      up_disable_irq(irq);
+#endif
+      nxsem_post(&info->sem);
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, FAR char *argv[])
+{
+  FAR struct irq_thread_s *info = (FAR struct irq_thread_s *)
+    ((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&info->sem);
+      if (info->stop)
+        {
+          break;
+        }
+
+      info->isrthread(info->irq, NULL, info->arg);
+
+#if !defined(CONFIG_ARCH_NOINTC) && !defined(CONFIG_ARCH_VECNOTIRQ)
+      up_enable_irq(info->irq);
+#endif
+    }
+
+  nxsem_destroy(&info->sem);
+  kmm_free(info);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_detach
+ *
+ * Assumptions:
+ *   g_irq_threads_lock is held.
+ *
+ ****************************************************************************/
+
+static int irq_thread_detach(int irq)
+{
+  FAR struct irq_thread_s *info;
+  FAR sq_entry_t *node;
+
+  for (node = sq_peek(&g_irq_threads); node != NULL; node = sq_next(node))
+    {
+      info = (FAR struct irq_thread_s *)node;
+      if (info->irq == irq)
+        {
+          /* Once detached, the interrupt cannot wake up the thread:  Ask
+           * it to terminate.  It releases the structure on its way out.
+           */
+
+          irq_detach(irq);
+          sq_rem(node, &g_irq_threads);
+
+          info->stop = true;
+          nxsem_post(&info->sem);
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Configure the IRQ subsystem so that the interrupt 'irq' is handled by
+ *   a dedicated kernel thread, for handlers too long to run with the
+ *   interrupts disabled.  'isr' runs in the interrupt context and returns
+ *   IRQ_WAKE_THREAD to have 'isrthread' run in the thread; if 'isr' is
+ *   NULL, the thread always runs.  The interrupt is disabled from the
+ *   wake-up until 'isrthread' returns.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - The handler in the interrupt context, or NULL
+ *   isrthread  - The handler in the thread, or NULL to detach the
+ *                interrupt and terminate its thread
+ *   arg        - The argument of both handlers
+ *   priority   - The priority of the thread
+ *   stack_size - The stack size of the thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
+                      int priority, int stack_size)
+{
+  FAR struct irq_thread_s *info;
+  FAR char *argv[2];
+  char arg1[32];
+  char name[16];
+  int ret;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&g_irq_threads_lock);
+
+  /* Replace any thread already attached to the interrupt */
+
+  irq_thread_detach(irq);
+  if (isrthread == NULL)
+    {
+      nxmutex_unlock(&g_irq_threads_lock);
+      return OK;
+    }
+
+  info = kmm_zalloc(sizeof(struct irq_thread_s));
+  if (info == NULL)
+    {
+      nxmutex_unlock(&g_irq_threads_lock);
+      return -ENOMEM;
+    }
+
+  info->isr       = isr;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+  info->irq       = irq;
+  nxsem_init(&info->sem, 0, 0);
+
+  snprintf(name, sizeof(name), "isr%d", irq);
+  snprintf(arg1, sizeof(arg1), "%p", info);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create(name, priority, stack_size, irq_thread_main, argv);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = irq_attach(irq, irq_thread_isr, info);
+  if (ret < 0)
+    {
+      /* The thread releases the structure */
+
+      info->stop = true;
+      nxsem_post(&info->sem);
+      nxmutex_unlock(&g_irq_threads_lock);
+      return ret;
+    }
+
+  sq_addlast(&info->node, &g_irq_threads);
+  nxmutex_unlock(&g_irq_threads_lock);
+  return OK;
+
+errout:
+  nxsem_destroy(&info->sem);
+  kmm_free(info);
+  nxmutex_unlock(&g_irq_threads_lock);
+  return ret;
+}
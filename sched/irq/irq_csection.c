@@ -265,6 +265,8 @@ try_again:
                    * no longer blocked by the critical section).
                    */
 
+                  spin_lockdep_csection();
+
 try_again_in_irq:
                   if (!irq_waitlock(cpu))
                     {
@@ -346,6 +348,7 @@ try_again_in_irq:
 
               DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
+              spin_lockdep_csection();
               if (!irq_waitlock(cpu))
                 {
                   /* We are in a deadlock condition due to a pending pause
@@ -376,7 +379,7 @@ try_again_in_irq:
               /* Note that we have entered the critical section */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
-              nxsched_critmon_csection(rtcb, true);
+              nxsched_critmon_csection(rtcb, true, return_address(0));
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
               sched_note_csection(rtcb, true);
@@ -419,7 +422,7 @@ irqstate_t enter_critical_section(void)
           /* Note that we have entered the critical section */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
-          nxsched_critmon_csection(rtcb, true);
+          nxsched_critmon_csection(rtcb, true, return_address(0));
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
           sched_note_csection(rtcb, true);
@@ -526,7 +529,7 @@ void leave_critical_section(irqstate_t flags)
               /* No.. Note that we have left the critical section */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
-              nxsched_critmon_csection(rtcb, false);
+              nxsched_critmon_csection(rtcb, false, NULL);
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
               sched_note_csection(rtcb, false);
@@ -608,7 +611,7 @@ void leave_critical_section(irqstate_t flags)
           /* Note that we have left the critical section */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
-          nxsched_critmon_csection(rtcb, false);
+          nxsched_critmon_csection(rtcb, false, NULL);
 #endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
           sched_note_csection(rtcb, false);
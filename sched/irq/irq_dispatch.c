@@ -53,16 +53,17 @@
 #  define INCR_COUNT(ndx) \
      do \
        { \
-         g_irqvector[ndx].count++; \
+         g_irqvector[ndx].count[this_cpu()]++; \
        } \
      while (0)
 #else
 #  define INCR_COUNT(ndx) \
      do \
        { \
-         if (++g_irqvector[ndx].lscount == 0) \
+         int cpu = this_cpu(); \
+         if (++g_irqvector[ndx].lscount[cpu] == 0) \
            { \
-             g_irqvector[ndx].mscount++; \
+             g_irqvector[ndx].mscount[cpu]++; \
            } \
        } \
      while (0)
@@ -77,15 +78,10 @@
 #endif
 
 #ifdef CONFIG_SCHED_IRQMONITOR
-#  define CALL_VECTOR(ndx, vector, irq, context, arg) \
+#  define IRQ_MONITOR(ndx, vector, irq, elapsed) \
      do \
        { \
          struct timespec delta; \
-         uint32_t start; \
-         uint32_t elapsed; \
-         start = up_perf_gettime(); \
-         vector(irq, context, arg); \
-         elapsed = up_perf_gettime() - start; \
          up_perf_convert(elapsed, &delta); \
          if (ndx < NUSER_IRQS) \
            { \
@@ -104,9 +100,35 @@
        } \
      while (0)
 #else
+#  define IRQ_MONITOR(ndx, vector, irq, elapsed)
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+#  define IRQ_HISTOGRAM(vector, irq, elapsed) \
+     nxsched_critmon_hist(&g_critmon_hist[this_cpu()][CRITMON_IRQ], \
+                          elapsed, (FAR void *)vector, irq)
+#else
+#  define IRQ_HISTOGRAM(vector, irq, elapsed)
+#endif
+
+#if defined(CONFIG_SCHED_IRQMONITOR) || \
+    defined(CONFIG_SCHED_CRITMONITOR_HISTOGRAM)
+#  define CALL_VECTOR(ndx, vector, irq, context, arg) \
+     do \
+       { \
+         uint32_t start; \
+         uint32_t elapsed; \
+         start = up_perf_gettime(); \
+         vector(irq, context, arg); \
+         elapsed = up_perf_gettime() - start; \
+         IRQ_MONITOR(ndx, vector, irq, elapsed); \
+         IRQ_HISTOGRAM(vector, irq, elapsed); \
+       } \
+     while (0)
+#else
 #  define CALL_VECTOR(ndx, vector, irq, context, arg) \
      vector(irq, context, arg)
-#endif /* CONFIG_SCHED_IRQMONITOR */
+#endif
 
 /****************************************************************************
  * Public Functions
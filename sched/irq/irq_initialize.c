@@ -52,6 +52,13 @@ struct irq_info_s g_irqvector[CONFIG_ARCH_NUSER_INTERRUPTS];
 struct irq_info_s g_irqvector[NR_IRQS];
 #endif
 
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE_DYNAMIC
+/* The map of the IRQ numbers to the vector table, built by irq_attach() */
+
+irq_mapped_t g_irqmap[NR_IRQS];
+int g_irqmap_count;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -75,6 +82,15 @@ void irq_initialize(void)
       g_irqvector[i].handler = irq_unexpected_isr;
     }
 
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE_DYNAMIC
+  /* No IRQ number is mapped yet */
+
+  for (i = 0; i < NR_IRQS; i++)
+    {
+      g_irqmap[i] = IRQMAPPED_MAX;
+    }
+#endif
+
 #ifdef CONFIG_IRQCHAIN
   /* Initialize IRQ chain support */
 
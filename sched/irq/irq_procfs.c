@@ -151,6 +151,8 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   unsigned long intpart;
   unsigned long fracpart;
   unsigned long count;
+  uint64_t total = 0;
+  int cpu;
 
   DEBUGASSERT(irqfile != NULL);
 
@@ -161,14 +163,21 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   now           = clock_systime_ticks();
   info->start   = now;
 #ifdef CONFIG_HAVE_LONG_LONG
-  info->count   = 0;
+  memset(info->count, 0, sizeof(info->count));
 #else
-  info->mscount = 0;
-  info->lscount = 0;
+  memset(info->mscount, 0, sizeof(info->mscount));
+  memset(info->lscount, 0, sizeof(info->lscount));
 #endif
   info->time    = 0;
   leave_critical_section(flags);
 
+  /* Sum the counts of the CPUs */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      total += copy.count[cpu];
+    }
+
   /* Don't bother if count == 0.
    *
    * REVISIT:  There is a logic problem with skipping if the count is zero.
@@ -187,7 +196,7 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
    * byte offset into the pseudo-file, f_pos.
    */
 
-  if (copy.count == 0)
+  if (total == 0)
     {
       return 0;
     }
@@ -207,7 +216,7 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
    */
 
   elapsed = elapsed ? elapsed : 1;
-  intpart = (unsigned int)((copy.count * TICK_PER_SEC) / elapsed);
+  intpart = (unsigned int)((total * TICK_PER_SEC) / elapsed);
   if (intpart >= 10000)
     {
       intpart  = 9999;
@@ -217,18 +226,18 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
     {
       uint64_t intcount = ((uint64_t)intpart * elapsed);
       fracpart = (unsigned int)
-        (((copy.count * TICK_PER_SEC - intcount) * 1000) / elapsed);
+        (((total * TICK_PER_SEC - intcount) * 1000) / elapsed);
     }
 
   /* Make sure that the count is representable with snprintf format */
 
-  if (copy.count > ULONG_MAX)
+  if (total > ULONG_MAX)
     {
       count = ULONG_MAX;
     }
   else
     {
-      count = (unsigned long)copy.count;
+      count = (unsigned long)total;
     }
 #else
 #  error Missing logic
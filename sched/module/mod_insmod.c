@@ -234,7 +234,7 @@ FAR void *insmod(FAR const char *filename, FAR const char *modname)
 
   /* Get the module initializer entry point */
 
-  initializer = (mod_initializer_t)(loadinfo.textalloc +
+  initializer = (mod_initializer_t)(loadinfo.textstart +
                                     loadinfo.ehdr.e_entry);
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   modp->initializer = initializer;
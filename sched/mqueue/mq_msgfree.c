@@ -45,6 +45,7 @@
  *   allocated dynamically it will be deallocated.
  *
  * Input Parameters:
+ *   msgq  - The message queue that the message was allocated for
  *   mqmsg - message to free
  *
  * Returned Value:
@@ -52,7 +53,8 @@
  *
  ****************************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg)
 {
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
@@ -89,6 +91,15 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
     {
       kmm_free(mqmsg);
     }
+
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* Messages of a per-queue pool go back to the pool of their queue */
+
+  else if (mqmsg->type == MQ_ALLOC_QUEUE)
+    {
+      list_add_tail(&msgq->msgpool, &mqmsg->node);
+    }
+#endif
   else
     {
       DEBUGPANIC();
@@ -66,6 +66,13 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
                     FAR struct mqueue_inode_s **pmsgq)
 {
   FAR struct mqueue_inode_s *msgq;
+  size_t size = MQ_ALIGN(sizeof(struct mqueue_inode_s));
+#ifdef CONFIG_MQ_QUEUE_POOL
+  FAR struct mqueue_msg_s *mqmsg;
+  size_t msgsize;
+  int16_t maxmsgs;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -77,10 +84,17 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       return -EINVAL;
     }
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* The per-queue pool of messages follows the queue structure */
+
+  maxmsgs = attr ? (int16_t)attr->mq_maxmsg : MQ_MAX_MSGS;
+  msgsize = MQ_MSG_SIZE(attr ? attr->mq_msgsize : MQ_MAX_BYTES);
+  size   += maxmsgs * msgsize;
+#endif
+
   /* Allocate memory for the new message queue. */
 
-  msgq = (FAR struct mqueue_inode_s *)
-    kmm_zalloc(sizeof(struct mqueue_inode_s));
+  msgq = (FAR struct mqueue_inode_s *)kmm_zalloc(size);
 
   if (msgq)
     {
@@ -102,6 +116,17 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+      list_initialize(&msgq->msgpool);
+      for (i = 0; i < maxmsgs; i++)
+        {
+          mqmsg = (FAR struct mqueue_msg_s *)
+            (MQ_POOL_BASE(msgq) + i * msgsize);
+          mqmsg->type = MQ_ALLOC_QUEUE;
+          list_add_tail(&msgq->msgpool, &mqmsg->node);
+        }
+#endif
+
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
     }
@@ -250,7 +250,8 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
  * Input Parameters:
  *   msgq    - Message queue descriptor
  *   mqmsg   - The message obtained by mq_waitmsg()
- *   ubuffer - The address of the user provided buffer to receive the message
+ *   ubuffer - The address of the user provided buffer to receive the
+ *             message.  NULL to keep the message for the caller instead.
  *   prio    - The user-provided location to return the message priority.
  *
  * Returned Value:
@@ -277,20 +278,23 @@ ssize_t nxmq_do_receive(FAR struct mqueue_inode_s *msgq,
 
   rcvmsglen = mqmsg->msglen;
 
-  /* Copy the message into the caller's buffer */
-
-  memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
-
-  /* Copy the message priority as well (if a buffer is provided) */
+  /* Copy the message priority (if a buffer is provided) */
 
   if (prio)
     {
       *prio = mqmsg->priority;
     }
 
-  /* We are done with the message.  Deallocate it now. */
+  /* Copy the message into the caller's buffer.  We are then done with the
+   * message.  Without a buffer, the message is passed by reference and the
+   * caller is responsible for freeing it.
+   */
 
-  nxmq_free_msg(mqmsg);
+  if (ubuffer != NULL)
+    {
+      memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+      nxmq_free_msg(msgq, mqmsg);
+    }
 
   /* Check if any tasks are waiting for the MQ not full event. */
 
@@ -112,8 +112,8 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  The message will be allocated from the pool of the
+ *   message queue (with CONFIG_MQ_QUEUE_POOL) or from the g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -126,7 +126,7 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *   handler will be notified.
  *
  * Input Parameters:
- *   None
+ *   msgq - The message queue that the message will be sent to
  *
  * Returned Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -134,10 +134,20 @@ int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct list_node *mqmsg;
 
+#ifdef CONFIG_MQ_QUEUE_POOL
+  /* Try to get the message from the pool of the message queue */
+
+  mqmsg = list_remove_head(&msgq->msgpool);
+  if (mqmsg != NULL)
+    {
+      return (FAR struct mqueue_msg_s *)mqmsg;
+    }
+#endif
+
   /* Try to get the message from the generally available free list. */
 
   mqmsg = list_remove_head(&g_msgfree);
@@ -334,9 +344,14 @@ int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message, unless it was built in place
+   * in a loaned message.
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue
    * Search the message list to find the location to insert the new
@@ -0,0 +1,411 @@
+/****************************************************************************
+ * sched/mqueue/mq_zerocopy.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_file_msgq
+ *
+ * Description:
+ *   Return the message queue of an open message queue descriptor if it was
+ *   opened with the access mode in oflags.
+ *
+ ****************************************************************************/
+
+static int nxmq_file_msgq(FAR struct file *mq, int oflags,
+                          FAR struct mqueue_inode_s **msgq)
+{
+  if (mq->f_inode == NULL || mq->f_inode->i_private == NULL)
+    {
+      return -EBADF;
+    }
+
+  if ((mq->f_oflags & oflags) == 0)
+    {
+      return -EPERM;
+    }
+
+  *msgq = mq->f_inode->i_private;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_loaned_msg
+ *
+ * Description:
+ *   Return the message that contains a buffer handed out by file_mq_loan()
+ *   or file_mq_receive_ref(), or NULL if buffer cannot be such a buffer.
+ *
+ ****************************************************************************/
+
+static FAR struct mqueue_msg_s *
+nxmq_loaned_msg(FAR struct mqueue_inode_s *msgq, FAR void *buffer)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (buffer == NULL)
+    {
+      return NULL;
+    }
+
+  mqmsg = MQ_MSG_OF(buffer);
+  switch (mqmsg->type)
+    {
+      case MQ_ALLOC_FIXED:
+      case MQ_ALLOC_DYN:
+      case MQ_ALLOC_IRQ:
+        return mqmsg;
+
+#ifdef CONFIG_MQ_QUEUE_POOL
+      case MQ_ALLOC_QUEUE:
+        {
+          /* It must be one of the messages of this queue's pool */
+
+          size_t msgsize = MQ_MSG_SIZE(msgq->maxmsgsize);
+          size_t offset  = (FAR char *)mqmsg - MQ_POOL_BASE(msgq);
+
+          if ((FAR char *)mqmsg >= MQ_POOL_BASE(msgq) &&
+              offset < msgq->maxmsgs * msgsize && offset % msgsize == 0)
+            {
+              return mqmsg;
+            }
+        }
+        break;
+#endif
+
+      default:
+        break;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_mq_loan
+ *
+ * Description:
+ *   Borrow a message buffer from the message queue.  See mq_loan().
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, FAR void **buffer)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_file_msgq(mq, O_WROK, &msgq);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+  mqmsg = nxmq_alloc_msg(msgq);
+  leave_critical_section(flags);
+
+  if (mqmsg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *buffer = mqmsg->mail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: file_mq_send_loan
+ *
+ * Description:
+ *   Queue a loaned message buffer without copying it.  See mq_send_loan().
+ *
+ ****************************************************************************/
+
+int file_mq_send_loan(FAR struct file *mq, FAR void *buffer, size_t msglen,
+                      unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_file_msgq(mq, O_WROK, &msgq);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mqmsg = nxmq_loaned_msg(msgq, buffer);
+  if (mqmsg == NULL || prio > MQ_PRIO_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if (msglen > (size_t)msgq->maxmsgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  /* Wait for room in the queue like file_mq_send().  The message itself is
+   * already allocated, so nothing else can fail.
+   */
+
+  flags = enter_critical_section();
+
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(msgq, mq->f_oflags);
+    }
+
+  if (ret == OK)
+    {
+      ret = nxmq_do_send(msgq, mqmsg, mqmsg->mail, msglen, prio);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_mq_receive_ref
+ *
+ * Description:
+ *   Receive a message by reference.  See mq_receive_ref().
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_receive_ref(FAR struct file *mq, FAR void **buffer,
+                            FAR unsigned int *prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmq_file_msgq(mq, O_RDOK, &msgq);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  ret = nxmq_wait_receive(msgq, mq->f_oflags, &mqmsg);
+  if (ret == OK)
+    {
+      /* Without a user buffer, the message stays allocated */
+
+      ret     = nxmq_do_receive(msgq, mqmsg, NULL, prio);
+      *buffer = mqmsg->mail;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_mq_return
+ *
+ * Description:
+ *   Give back a loaned or received message buffer.  See mq_return().
+ *
+ ****************************************************************************/
+
+int file_mq_return(FAR struct file *mq, FAR void *buffer)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_file_msgq(mq, O_RDOK | O_WROK, &msgq);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mqmsg = nxmq_loaned_msg(msgq, buffer);
+  if (mqmsg == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  nxmq_free_msg(msgq, mqmsg);
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mq_loan
+ *
+ * Description:
+ *   Borrow a message buffer of mq_msgsize bytes from the message queue.
+ *
+ ****************************************************************************/
+
+FAR void *mq_loan(mqd_t mqdes)
+{
+  FAR struct file *filep;
+  FAR void *buffer = NULL;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret >= 0)
+    {
+      ret = file_mq_loan(filep, &buffer);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return NULL;
+    }
+
+  return buffer;
+}
+
+/****************************************************************************
+ * Name: mq_send_loan
+ *
+ * Description:
+ *   Queue a buffer obtained from mq_loan() without copying it.
+ *
+ ****************************************************************************/
+
+int mq_send_loan(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                 unsigned int prio)
+{
+  FAR struct file *filep;
+  int ret;
+
+  /* mq_send_loan() is a cancellation point, like mq_send() */
+
+  enter_cancellation_point();
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret >= 0)
+    {
+      ret = file_mq_send_loan(filep, buffer, msglen, prio);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receive_ref
+ *
+ * Description:
+ *   Remove a message from the queue and return a reference to its buffer.
+ *
+ ****************************************************************************/
+
+ssize_t mq_receive_ref(mqd_t mqdes, FAR void **buffer,
+                       FAR unsigned int *prio)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  /* mq_receive_ref() is a cancellation point, like mq_receive() */
+
+  enter_cancellation_point();
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret >= 0)
+    {
+      ret = file_mq_receive_ref(filep, buffer, prio);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_return
+ *
+ * Description:
+ *   Give back a buffer obtained from mq_loan() or mq_receive_ref().
+ *
+ ****************************************************************************/
+
+int mq_return(mqd_t mqdes, FAR void *buffer)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = fs_getfilep(mqdes, &filep);
+  if (ret >= 0)
+    {
+      ret = file_mq_return(filep, buffer);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
+}
@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
+#include <stddef.h>
 #include <mqueue.h>
 #include <sched.h>
 
@@ -47,6 +48,26 @@
 #define MQ_MAX_MSGS    16
 #define MQ_PRIO_MAX    _POSIX_MQ_PRIO_MAX
 
+/* Round n up to pointer alignment */
+
+#define MQ_ALIGN(n) \
+  (((n) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+
+/* The size of a message structure with room for n bytes of data.  The
+ * messages of a per-queue pool are laid out back to back after the queue
+ * structure, starting at MQ_POOL_BASE().
+ */
+
+#define MQ_MSG_SIZE(n) MQ_ALIGN(offsetof(struct mqueue_msg_s, mail) + (n))
+#define MQ_POOL_BASE(msgq) \
+  ((FAR char *)(msgq) + MQ_ALIGN(sizeof(struct mqueue_inode_s)))
+
+/* The message structure that contains the data buffer b */
+
+#define MQ_MSG_OF(b) \
+  ((FAR struct mqueue_msg_s *)((FAR char *)(b) - \
+                               offsetof(struct mqueue_msg_s, mail)))
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
@@ -55,7 +76,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_QUEUE       /* Preallocated in the pool of one message queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -107,7 +129,8 @@ struct task_group_s; /* Forward reference */
 /* Functions defined in mq_initialize.c *****************************************/
 
 void nxmq_initialize(void);
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c *****************************************************************/
 
@@ -134,7 +157,7 @@ int nxmq_verify_send(FAR struct file *mq, FAR const char *msg,
 #else
 # define nxmq_verify_send(mq, msg, msglen, prio) OK
 #endif
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq);
 int nxmq_wait_send(FAR struct mqueue_inode_s *msgq, int oflags);
 int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
                  FAR struct mqueue_msg_s *mqmsg,
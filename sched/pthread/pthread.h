@@ -106,6 +106,19 @@ void pthread_mutex_inconsistent(FAR struct tcb_s *tcb);
 #  define pthread_mutex_give(m)                pthread_sem_give(&(m)->sem)
 #endif
 
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+int pthread_cond_waitsem(FAR pthread_cond_t *cond,
+                         FAR pthread_mutex_t *mutex, clockid_t clockid,
+                         FAR const struct timespec *abstime,
+                         FAR bool *locked);
+int pthread_cond_wakeup(FAR pthread_cond_t *cond);
+#  ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+int pthread_mutex_handed(FAR struct pthread_mutex_s *mutex);
+#  else
+#    define pthread_mutex_handed(m)              OK
+#  endif
+#endif
+
 #ifdef CONFIG_PTHREAD_MUTEX_TYPES
 int pthread_mutexattr_verifytype(int type);
 #endif
@@ -86,9 +86,14 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
               /* If the value is less than zero (meaning that one or more
                * thread is waiting), then post the condition semaphore.
                * Only the highest priority waiting thread will get to execute
+               * or, if the mutex is held, be moved to its wait list.
                */
 
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+              ret = pthread_cond_wakeup(cond);
+#else
               ret = pthread_sem_give(&cond->sem);
+#endif
 
               /* Increment the semaphore count (as was done by the
                * above post).
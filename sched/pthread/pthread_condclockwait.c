@@ -116,6 +116,9 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
       uint8_t type;
       int16_t nlocks;
 #endif
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      bool locked = false;
+#endif
 
       sinfo("Give up mutex...\n");
 
@@ -141,12 +144,17 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
       ret        = pthread_mutex_give(mutex);
       if (ret == 0)
         {
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+          ret = pthread_cond_waitsem(cond, mutex, clockid, abstime,
+                                     &locked);
+#else
           status = nxsem_clockwait_uninterruptible(
                    &cond->sem, clockid, abstime);
           if (status < 0)
             {
               ret = -status;
             }
+#endif
         }
 
       /* Restore interrupts  (pre-emption will be enabled
@@ -159,7 +167,17 @@ int pthread_cond_clockwait(FAR pthread_cond_t *cond,
 
       sinfo("Re-locking...\n");
 
-      status = pthread_mutex_take(mutex, NULL);
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      if (locked)
+        {
+          status = pthread_mutex_handed(mutex);
+        }
+      else
+#endif
+        {
+          status = pthread_mutex_take(mutex, NULL);
+        }
+
       if (status == OK)
         {
           mutex->pid    = mypid;
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * sched/pthread/pthread_condrequeue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+#include "pthread/pthread.h"
+
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cond_waitsem
+ *
+ * Description:
+ *   Wait on the semaphore of a condition variable after the mutex has been
+ *   given up.  pthread_cond_wakeup() may move the wait to the mutex, which
+ *   is then held when this returns.
+ *
+ * Input Parameters:
+ *   cond    - The condition variable to wait on
+ *   mutex   - The mutex given up by the caller
+ *   clockid - The clock of abstime
+ *   abstime - The end of the wait, or NULL to wait forever
+ *   locked  - The location to return whether the mutex is held
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_waitsem(FAR pthread_cond_t *cond,
+                         FAR pthread_mutex_t *mutex, clockid_t clockid,
+                         FAR const struct timespec *abstime,
+                         FAR bool *locked)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  irqstate_t flags;
+  bool requeued;
+  int ret;
+
+  rtcb->waitmorph = &mutex->sem;
+
+  /* Signals do not end the wait, unless it has already been moved to the
+   * mutex:  The condition has then been signalled.
+   */
+
+  do
+    {
+      if (abstime == NULL)
+        {
+          ret = nxsem_wait(&cond->sem);
+        }
+      else
+        {
+          ret = nxsem_clockwait(&cond->sem, clockid, abstime);
+        }
+    }
+  while (ret == -EINTR && (rtcb->flags & TCB_FLAG_SEM_REQUEUED) == 0);
+
+  flags           = enter_critical_section();
+  requeued        = (rtcb->flags & TCB_FLAG_SEM_REQUEUED) != 0;
+  rtcb->flags    &= ~TCB_FLAG_SEM_REQUEUED;
+  rtcb->waitmorph = NULL;
+  leave_critical_section(flags);
+
+  /* A wait on the mutex succeeds when it is handed over.  If it ends with
+   * a signal or a timeout, the condition was still signalled and the mutex
+   * is taken as usual.
+   */
+
+  *locked = requeued && ret == OK;
+  if (requeued && (ret == -EINTR || ret == -ETIMEDOUT))
+    {
+      ret = OK;
+    }
+
+  return -ret;
+}
+
+/****************************************************************************
+ * Name: pthread_cond_wakeup
+ *
+ * Description:
+ *   Let the highest priority waiter of a condition variable go:  Move it
+ *   to the wait list of its mutex if it is held, or wake it up.
+ *
+ * Input Parameters:
+ *   cond - The condition variable
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_wakeup(FAR pthread_cond_t *cond)
+{
+  int ret;
+
+  ret = nxsem_requeue(&cond->sem);
+  if (ret == -EAGAIN)
+    {
+      return pthread_sem_give(&cond->sem);
+    }
+
+  /* The waiter has been moved, or it left before it could be signalled */
+
+  return OK;
+}
+
+#endif /* CONFIG_PTHREAD_COND_REQUEUE */
@@ -91,7 +91,11 @@ int pthread_cond_signal(FAR pthread_cond_t *cond)
           if (sval < 0)
             {
               sinfo("Signalling...\n");
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+              ret = pthread_cond_wakeup(cond);
+#else
               ret = pthread_sem_give(&cond->sem);
+#endif
             }
         }
     }
@@ -87,6 +87,9 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
       uint8_t type;
       int16_t nlocks;
 #endif
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      bool locked;
+#endif
 
       /* Give up the mutex */
 
@@ -107,7 +110,12 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
        * or if the thread is canceled (ECANCELED)
        */
 
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      status = pthread_cond_waitsem(cond, mutex, CLOCK_REALTIME, NULL,
+                                    &locked);
+#else
       status = pthread_sem_take(&cond->sem, NULL);
+#endif
       if (ret == OK)
         {
           /* Report the first failure that occurs */
@@ -117,7 +125,8 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 
       sched_unlock();
 
-      /* Reacquire the mutex.
+      /* Reacquire the mutex, unless the wait was moved to it and it has
+       * been handed over already.
        *
        * When cancellation points are enabled, we need to hold the mutex
        * when the pthread is canceled and cleanup handlers, if any, are
@@ -126,7 +135,17 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 
       sinfo("Reacquire mutex...\n");
 
-      status = pthread_mutex_take(mutex, NULL);
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      if (locked)
+        {
+          status = pthread_mutex_handed(mutex);
+        }
+      else
+#endif
+        {
+          status = pthread_mutex_take(mutex, NULL);
+        }
+
       if (ret == OK)
         {
           /* Report the first failure that occurs */
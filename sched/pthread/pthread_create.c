@@ -234,7 +234,7 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
   /* Allocate a TCB for the new task. */
 
   ptcb = (FAR struct pthread_tcb_s *)
-            kmm_zalloc(sizeof(struct pthread_tcb_s));
+    nxsched_alloc_tcb(TCB_FLAG_TTYPE_PTHREAD, sizeof(struct pthread_tcb_s));
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -334,6 +334,20 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
           errcode = -policy;
           goto errout_with_join;
         }
+
+#ifdef CONFIG_SCHED_DEADLINE
+      /* The bandwidth of a SCHED_DEADLINE thread is not inherited:  The
+       * child would exceed the admission test of the parent.  As with
+       * pthread_attr_setschedpolicy(), a new thread cannot be created in
+       * that policy.
+       */
+
+      if (policy == SCHED_DEADLINE)
+        {
+          errcode = EAGAIN;
+          goto errout_with_join;
+        }
+#endif
     }
   else
     {
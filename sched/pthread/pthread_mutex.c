@@ -34,6 +34,7 @@
 #include <nuttx/semaphore.h>
 
 #include "sched/sched.h"
+#include "semaphore/semaphore.h"
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -160,11 +161,31 @@ int pthread_mutex_take(FAR struct pthread_mutex_s *mutex,
         }
       else
         {
-          /* Take semaphore underlying the mutex.  pthread_sem_take
-           * returns zero on success and a positive errno value on failure.
+#ifdef CONFIG_MUTEX_ADAPTIVE
+          /* Spin while the holder runs on another CPU before blocking.
+           * nxsem_wait() does so itself if priority inheritance tracks the
+           * holder.
            */
 
-          ret = pthread_sem_take(&mutex->sem, abs_timeout);
+          ret = -EAGAIN;
+#  ifdef CONFIG_PRIORITY_INHERITANCE
+          if ((mutex->sem.flags & PRIOINHERIT_FLAGS_ENABLE) == 0)
+#  endif
+            {
+              ret = nxsem_spin(&mutex->sem, mutex->pid);
+            }
+
+          if (ret < 0)
+#endif
+            {
+              /* Take semaphore underlying the mutex.  pthread_sem_take
+               * returns zero on success and a positive errno value on
+               * failure.
+               */
+
+              ret = pthread_sem_take(&mutex->sem, abs_timeout);
+            }
+
           if (ret == OK)
             {
               /* Check if the holder of the mutex has terminated without
@@ -192,6 +213,49 @@ int pthread_mutex_take(FAR struct pthread_mutex_s *mutex,
   return ret;
 }
 
+/****************************************************************************
+ * Name: pthread_mutex_handed
+ *
+ * Description:
+ *   Complete the take of a pthread_mutex whose semaphore has been handed
+ *   to this thread by a wait that pthread_cond_wakeup() moved to it.  Add
+ *   the mutex to the list of mutexes held by this thread.
+ *
+ * Input Parameters:
+ *  mutex - The mutex that was handed over
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+int pthread_mutex_handed(FAR struct pthread_mutex_s *mutex)
+{
+  int ret = OK;
+
+  DEBUGASSERT(mutex != NULL);
+
+  sched_lock();
+
+  /* The holder may have terminated without releasing the mutex, as in
+   * pthread_mutex_take().
+   */
+
+  if ((mutex->flags & _PTHREAD_MFLAGS_INCONSISTENT) != 0)
+    {
+      ret = EOWNERDEAD;
+    }
+  else
+    {
+      pthread_mutex_add(mutex);
+    }
+
+  sched_unlock();
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: pthread_mutex_trytake
  *
@@ -98,7 +98,11 @@ static inline bool pthread_mutex_islocked(FAR struct pthread_mutex_s *mutex)
  *
  ****************************************************************************/
 
+#if defined(CONFIG_SEM_FASTPATH) && defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
+int nx_pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+#else
 int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+#endif
 {
   int ret = EPERM;
 
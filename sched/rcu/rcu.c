@@ -0,0 +1,225 @@
+/****************************************************************************
+ * sched/rcu/rcu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A quiescent-state based RCU.  A CPU is in a quiescent state whenever
+ * the thread that it runs is outside any read-side critical section: In
+ * particular while it runs its idle thread, and after every switch to a
+ * thread that does not read.  The readers only mark their tasks, so that
+ * the read side never writes shared memory.
+ *
+ * synchronize_rcu() starts a new grace period and then waits until no CPU
+ * runs a reader that entered during the previous one.  Readers that are
+ * switched out of their CPU, because they are preempted or block, are
+ * counted per grace period, and the grace period also waits for those of
+ * the previous one to resume and leave.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/signal.h>
+#include <nuttx/rcu.h>
+
+#include "sched/sched.h"
+#include "rcu/rcu.h"
+
+#ifdef CONFIG_RCU
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The current grace period */
+
+static volatile uint8_t g_rcu_gp;
+
+/* The readers switched out of their CPU, by parity of their grace period */
+
+static int16_t g_rcu_preempted[2];
+
+/* Serializes the grace periods */
+
+static mutex_t g_rcu_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_quiescent
+ *
+ * Description:
+ *   Return true if no reader of the grace period gp is left.  No reader
+ *   can be switched in or out while this checks:  The critical section
+ *   holds off every context switch.
+ *
+ ****************************************************************************/
+
+static bool rcu_quiescent(uint8_t gp)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  bool quiescent;
+  int cpu;
+
+  flags     = enter_critical_section();
+  quiescent = g_rcu_preempted[gp & 1] == 0;
+
+  for (cpu = 0; quiescent && cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      tcb = current_task(cpu);
+      if (tcb->rcu_nesting > 0)
+        {
+          __atomic_thread_fence(__ATOMIC_SEQ_CST);
+          quiescent = tcb->rcu_gp != gp;
+        }
+    }
+
+  leave_critical_section(flags);
+  return quiescent;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ ****************************************************************************/
+
+void rcu_read_lock(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  uint8_t gp;
+
+  if (rtcb->rcu_nesting == 0)
+    {
+      /* Label the section with the grace period before showing it to
+       * synchronize_rcu(), and show it before reading anything.  If a new
+       * grace period started meanwhile, relabel:  The writer that started
+       * it may have missed this reader.
+       */
+
+      do
+        {
+          gp           = g_rcu_gp;
+          rtcb->rcu_gp = gp;
+          __atomic_thread_fence(__ATOMIC_SEQ_CST);
+          rtcb->rcu_nesting = 1;
+          __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        }
+      while (g_rcu_gp != gp);
+    }
+  else
+    {
+      DEBUGASSERT(rtcb->rcu_nesting < INT16_MAX);
+      rtcb->rcu_nesting++;
+    }
+}
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ ****************************************************************************/
+
+void rcu_read_unlock(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  DEBUGASSERT(rtcb->rcu_nesting > 0);
+
+  /* Complete the reads before leaving */
+
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  rtcb->rcu_nesting--;
+}
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ ****************************************************************************/
+
+void synchronize_rcu(void)
+{
+  irqstate_t flags;
+  uint8_t gp;
+
+  DEBUGASSERT(!up_interrupt_context() && this_task()->rcu_nesting == 0);
+
+  nxmutex_lock(&g_rcu_lock);
+
+  /* Start a new grace period.  The readers that enter from now on see
+   * every update published before.
+   */
+
+  flags = enter_critical_section();
+  gp    = g_rcu_gp;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  g_rcu_gp = gp + 1;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  leave_critical_section(flags);
+
+  /* Then wait for the readers of the previous one.  They are rarely
+   * switched out, so the first check usually succeeds on a single CPU.
+   */
+
+  while (!rcu_quiescent(gp))
+    {
+      nxsig_usleep(USEC_PER_TICK);
+    }
+
+  nxmutex_unlock(&g_rcu_lock);
+}
+
+/****************************************************************************
+ * Name: rcu_suspend
+ ****************************************************************************/
+
+void rcu_suspend(FAR struct tcb_s *tcb)
+{
+  if (tcb->rcu_nesting > 0 && !tcb->rcu_preempted)
+    {
+      tcb->rcu_preempted = true;
+      g_rcu_preempted[tcb->rcu_gp & 1]++;
+    }
+}
+
+/****************************************************************************
+ * Name: rcu_resume
+ ****************************************************************************/
+
+void rcu_resume(FAR struct tcb_s *tcb)
+{
+  if (tcb->rcu_preempted)
+    {
+      tcb->rcu_preempted = false;
+      g_rcu_preempted[tcb->rcu_gp & 1]--;
+    }
+}
+
+#endif /* CONFIG_RCU */
@@ -0,0 +1,55 @@
+/****************************************************************************
+ * sched/rcu/rcu.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_RCU_RCU_H
+#define __SCHED_RCU_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/sched.h>
+
+#ifdef CONFIG_RCU
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_suspend and rcu_resume
+ *
+ * Description:
+ *   Account for an RCU reader that is switched out of its CPU, or back in,
+ *   in the middle of a read-side critical section.  Called by
+ *   nxsched_suspend_scheduler() and nxsched_resume_scheduler().
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void rcu_suspend(FAR struct tcb_s *tcb);
+void rcu_resume(FAR struct tcb_s *tcb);
+
+#endif /* CONFIG_RCU */
+#endif /* __SCHED_RCU_RCU_H */
@@ -157,6 +157,12 @@ extern dq_queue_t g_readytorun;
  * CPU.  Tasks after the active task are ready-to-run and assigned to this
  * CPU. The tail of this assigned task list, the lowest priority task, is
  * always the CPU's IDLE task.
+ *
+ * If CONFIG_SCHED_CPU_RUNQUEUE is selected, each g_assignedtasks[] list is
+ * also the run queue of its CPU:  Ready-to-run tasks that are not locked
+ * to a CPU are queued on the list of the CPU that they last ran on rather
+ * than in g_readytorun, and a CPU with no better local work will steal
+ * from the lists of the other CPUs.
  */
 
 extern dq_queue_t g_assignedtasks[CONFIG_SMP_NCPUS];
@@ -316,6 +322,47 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 bool nxsched_add_readytorun(FAR struct tcb_s *rtrtcb);
 bool nxsched_remove_readytorun(FAR struct tcb_s *rtrtcb, bool merge);
 bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+
+/* Within a priority level, SCHED_DEADLINE threads are queued before the
+ * other threads and in the order of their absolute deadlines (EDF).
+ * nxsched_edf_before() is true if tcb must be queued before ntcb of the
+ * same priority.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define nxsched_isdeadline(tcb) \
+     (((tcb)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+#  define nxsched_edf_before(tcb, ntcb) \
+     ((tcb)->sched_priority == (ntcb)->sched_priority && \
+      nxsched_isdeadline(tcb) && (!nxsched_isdeadline(ntcb) || \
+      (sclock_t)((tcb)->deadline.deadline - (ntcb)->deadline.deadline) < 0))
+#else
+#  define nxsched_isdeadline(tcb)       (false)
+#  define nxsched_edf_before(tcb, ntcb) (false)
+#endif
+
+/* O(1) indexing of the g_readytorun list */
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+bool nxsched_add_rtrbitmap(FAR struct tcb_s *tcb);
+void nxsched_remove_rtrbitmap(FAR struct tcb_s *tcb);
+#  define nxsched_remove_prioritized(tcb,list) \
+     do \
+       { \
+         if ((list) == &g_readytorun) \
+           { \
+             nxsched_remove_rtrbitmap(tcb); \
+           } \
+         else \
+           { \
+             dq_rem((FAR dq_entry_t *)(tcb), (list)); \
+           } \
+       } \
+     while (0)
+#else
+#  define nxsched_remove_prioritized(tcb,list) \
+     dq_rem((FAR dq_entry_t *)(tcb), (list))
+#endif
 void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                                uint8_t task_state);
 bool nxsched_merge_pending(void);
@@ -345,6 +392,14 @@ void nxsched_reassess_timer(void);
 #  define nxsched_reassess_timer()
 #endif
 
+#if defined(CONFIG_SCHED_TICKLESS) && \
+    (CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+     defined(CONFIG_SCHED_DEADLINE))
+void nxsched_resume_timeslice(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_resume_timeslice(tcb)
+#endif
+
 /* Scheduler policy support */
 
 #if CONFIG_RR_INTERVAL > 0
@@ -364,6 +419,18 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb,
+                            FAR const struct sched_param *param);
+void nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_get_deadline(FAR struct tcb_s *tcb,
+                          FAR struct sched_param *param);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+int  nxsched_yield_deadline(FAR struct tcb_s *tcb);
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -374,6 +441,12 @@ FAR struct tcb_s *this_task(void);
 int  nxsched_select_cpu(cpu_set_t affinity);
 int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 
+#  ifdef CONFIG_SCHED_CPU_RUNQUEUE
+int  nxsched_home_cpu(FAR struct tcb_s *tcb);
+FAR struct tcb_s *nxsched_steal_task(int cpu);
+void nxsched_migrate_task(FAR struct tcb_s *tcb);
+#  endif
+
 #  define nxsched_islocked_global() spin_islocked(&g_cpu_schedlock)
 #  define nxsched_islocked_tcb(tcb) nxsched_islocked_global()
 
@@ -399,14 +472,37 @@ void nxsched_process_cpuload_ticks(uint32_t ticks);
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
-void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state);
-void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state);
+void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                                FAR void *caller);
+void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller);
 void nxsched_resume_critmon(FAR struct tcb_s *tcb);
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+void nxsched_critmon_hist(FAR struct critmon_hist_s *hist, uint32_t elapsed,
+                          FAR void *caller, pid_t pid);
+#endif
+
+/* CPU time accounting */
+
+#ifdef CONFIG_SCHED_CPUTIME
+void nxsched_resume_cputime(FAR struct tcb_s *tcb);
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_SCHED_TCB_CACHE
+FAR struct tcb_s *nxsched_alloc_tcb(uint8_t ttype, size_t size);
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
+#else
+#  define nxsched_alloc_tcb(ttype, size) \
+     ((FAR struct tcb_s *)kmm_zalloc(size))
+#  define nxsched_free_tcb(tcb, ttype) kmm_free(tcb)
+#endif
+
 #endif /* __SCHED_SCHED_SCHED_H */
@@ -67,6 +67,12 @@ void nxsched_add_blocked(FAR struct tcb_s *btcb, tstate_t task_state)
 
   btcb->task_state = task_state;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* The server of a deadline thread is checked when it wakes up */
+
+  btcb->deadline.blocked = true;
+#endif
+
   /* Add the TCB to the blocked task list associated with this state. */
 
   tasklist = TLIST_BLOCKED(btcb);
@@ -70,13 +70,21 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread that wakes up may need a new deadline */
+
+  nxsched_wakeup_deadline(btcb);
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 &&
+      (rtcb->sched_priority < btcb->sched_priority ||
+       nxsched_edf_before(btcb, rtcb)))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -159,6 +167,12 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int cpu;
   int me;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread that wakes up may need a new deadline */
+
+  nxsched_wakeup_deadline(btcb);
+#endif
+
   /* Check if the blocked TCB is locked to this CPU */
 
   if ((btcb->flags & TCB_FLAG_CPU_LOCKED) != 0)
@@ -186,7 +200,8 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    * required.
    */
 
-  if (rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->sched_priority < btcb->sched_priority ||
+      nxsched_edf_before(btcb, rtcb))
     {
       task_state = TSTATE_TASK_RUNNING;
     }
@@ -244,9 +259,25 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
+#ifdef CONFIG_SCHED_CPU_RUNQUEUE
+      /* Queue the task on the run queue of its home CPU.  Its priority
+       * is not higher than that of the task running on any eligible CPU,
+       * so it cannot become the head of that list and the CPU does not
+       * need to be paused.
+       */
+
+      cpu = nxsched_home_cpu(btcb);
+      switched = nxsched_add_prioritized(btcb, &g_assignedtasks[cpu]);
+      DEBUGASSERT(!switched);
+      UNUSED(switched);
+
+      btcb->cpu        = cpu;
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+#else
       nxsched_add_prioritized(btcb, &g_readytorun);
 
       btcb->task_state = TSTATE_TASK_READYTORUN;
+#endif
       doswitch         = false;
     }
   else /* (task_state == TSTATE_TASK_ASSIGNED || task_state == TSTATE_TASK_RUNNING) */
@@ -323,6 +354,14 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
               DEBUGASSERT(next->cpu == cpu);
               next->task_state = TSTATE_TASK_ASSIGNED;
             }
+#ifdef CONFIG_SCHED_CPU_RUNQUEUE
+          else if (!nxsched_islocked_global())
+            {
+              /* The pre-empted task stays in the run queue of this CPU */
+
+              next->task_state = TSTATE_TASK_ASSIGNED;
+            }
+#endif
           else
             {
               /* Remove the task from the assigned task list */
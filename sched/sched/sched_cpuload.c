@@ -80,6 +80,13 @@
 
 volatile uint32_t g_cpuload_total;
 
+/* The ticks of each CPU and those in which it did not run its IDLE thread.
+ * Unlike the counts of the threads, these are never scaled back, so that
+ * the utilization over an interval is the ratio of their increments.
+ */
+
+static struct cpuload_s g_cpuutil[CONFIG_SMP_NCPUS];
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -116,6 +123,12 @@ static inline void nxsched_cpu_process_cpuload(int cpu, uint32_t ticks)
    */
 
   g_cpuload_total += ticks;
+
+  g_cpuutil[cpu].total += ticks;
+  if (!is_idle_task(rtcb))
+    {
+      g_cpuutil[cpu].active += ticks;
+    }
 }
 
 /****************************************************************************
@@ -246,4 +259,41 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
   return ret;
 }
 
+/****************************************************************************
+ * Name:  clock_cpuutil
+ *
+ * Description:
+ *   Return the utilization counts of a CPU.  total is the number of ticks
+ *   of the CPU and active the number of those in which it was not idle.
+ *   Both only increase and wrap around, so that the utilization in an
+ *   interval is the ratio of their differences between two calls.
+ *
+ * Input Parameters:
+ *   cpu  - The index of the CPU of interest
+ *   util - The location to return the counts
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if cpu is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+int clock_cpuutil(int cpu, FAR struct cpuload_s *util)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(util);
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  util->total  = g_cpuutil[cpu].total;
+  util->active = g_cpuutil[cpu].active;
+  leave_critical_section(flags);
+
+  return OK;
+}
+
 #endif /* CONFIG_SCHED_CPULOAD */
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * sched/sched/sched_cpusteal.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPU_RUNQUEUE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  nxsched_home_cpu
+ *
+ * Description:
+ *   Return the CPU whose run queue should hold a ready-to-run, but not
+ *   running, task.  This is the CPU that the task last ran on if that CPU
+ *   is still in its affinity mask so that the task stays cache-hot.
+ *   Otherwise, the CPU with the lowest priority running task is used.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task to be queued.
+ *
+ * Returned Value:
+ *   Index of the CPU that will own the task.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+int nxsched_home_cpu(FAR struct tcb_s *tcb)
+{
+  if (CPU_ISSET(tcb->cpu, &tcb->affinity))
+    {
+      return tcb->cpu;
+    }
+
+  return nxsched_select_cpu(tcb->affinity);
+}
+
+/****************************************************************************
+ * Name:  nxsched_steal_task
+ *
+ * Description:
+ *   Search the run queues of the other CPUs for the highest priority task
+ *   that is ready-to-run but not running, is not locked to its CPU and is
+ *   permitted to run on 'cpu'.  Each g_assignedtasks[] list is prioritized
+ *   so only the first eligible entry of each list needs to be examined.
+ *
+ *   The returned TCB is not removed from its run queue; that is the
+ *   responsibility of the caller (see nxsched_migrate_task()).
+ *
+ * Input Parameters:
+ *   cpu - The CPU that is looking for work.
+ *
+ * Returned Value:
+ *   The TCB of the best candidate or NULL if there is nothing to steal.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_steal_task(int cpu)
+{
+  FAR struct tcb_s *best = NULL;
+  FAR struct tcb_s *tcb;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* Skip the running task at the head of the list.  The IDLE task is
+       * always at the tail and always locked to its CPU.
+       */
+
+      tcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+      DEBUGASSERT(tcb != NULL);
+
+      for (tcb = tcb->flink; tcb != NULL; tcb = tcb->flink)
+        {
+          if (best != NULL && tcb->sched_priority <= best->sched_priority)
+            {
+              /* Nothing further in this list can be better */
+
+              break;
+            }
+
+          if ((tcb->flags & TCB_FLAG_CPU_LOCKED) == 0 &&
+              CPU_ISSET(cpu, &tcb->affinity))
+            {
+              best = tcb;
+              break;
+            }
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name:  nxsched_migrate_task
+ *
+ * Description:
+ *   Remove a task returned by nxsched_steal_task() from the run queue of the
+ *   CPU that owns it.  The task is never at the head of that list so the
+ *   owning CPU does not need to be paused.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task to migrate.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_migrate_task(FAR struct tcb_s *tcb)
+{
+  DEBUGASSERT(tcb->task_state == TSTATE_TASK_ASSIGNED && tcb->blink != NULL);
+
+  dq_rem((FAR dq_entry_t *)tcb, &g_assignedtasks[tcb->cpu]);
+}
+
+#endif /* CONFIG_SCHED_CPU_RUNQUEUE */
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * sched/sched/sched_cputime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CPUTIME
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_resume_cputime
+ *
+ * Description:
+ *   Called when a thread resumes execution to start its CPU time interval.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_resume_cputime(FAR struct tcb_s *tcb)
+{
+  tcb->cputime_start = up_perf_gettime();
+  tcb->nswitches++;
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_cputime
+ *
+ * Description:
+ *   Called when a thread suspends execution to add the cycles of the
+ *   interval that ends to its CPU time.  The interval is at most one period
+ *   of the 32-bit counter, so the unsigned difference handles the wrap.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_cputime(FAR struct tcb_s *tcb)
+{
+  tcb->cputime += (uint32_t)(up_perf_gettime() - tcb->cputime_start);
+}
+
+/****************************************************************************
+ * Name: nxsched_get_cputime
+ *
+ * Description:
+ *   Return the CPU time consumed by a thread, including the time of the
+ *   current run if the thread is running.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread to query.
+ *   ts  - The location to return the CPU time.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_get_cputime(FAR struct tcb_s *tcb, FAR struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t cycles;
+  uint32_t freq;
+
+  flags  = enter_critical_section();
+  cycles = tcb->cputime;
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      cycles += (uint32_t)(up_perf_gettime() - tcb->cputime_start);
+    }
+
+  leave_critical_section(flags);
+
+  /* up_perf_convert() only takes a 32-bit interval */
+
+  freq        = up_perf_getfreq();
+  ts->tv_sec  = cycles / freq;
+  ts->tv_nsec = (cycles % freq) * NSEC_PER_SEC / freq;
+}
+
+#endif /* CONFIG_SCHED_CPUTIME */
@@ -26,6 +26,7 @@
 
 #include <sys/types.h>
 #include <sched.h>
+#include <strings.h>
 #include <assert.h>
 
 #include "sched/sched.h"
@@ -96,6 +97,13 @@
 #  define CHECK_THREAD(pid, elapsed)
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+#  define CRITMON_HIST(cpu, kind, elapsed, caller, pid) \
+     nxsched_critmon_hist(&g_critmon_hist[cpu][kind], elapsed, caller, pid)
+#else
+#  define CRITMON_HIST(cpu, kind, elapsed, caller, pid)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -114,10 +122,69 @@ static uint32_t g_crit_start[CONFIG_SMP_NCPUS];
 uint32_t g_premp_max[CONFIG_SMP_NCPUS];
 uint32_t g_crit_max[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/* Distributions of the hold times of the threads and of the durations of
+ * the interrupt handlers.
+ */
+
+struct critmon_hist_s g_critmon_hist[CONFIG_SMP_NCPUS][CRITMON_NHIST];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+/****************************************************************************
+ * Name: nxsched_critmon_hist
+ *
+ * Description:
+ *   Count a duration in its log2 bucket and keep it among the longest ones
+ *   if it is long enough.
+ *
+ * Input Parameters:
+ *   hist    - The histogram of the CPU and of the kind of the duration
+ *   elapsed - The duration in the units of up_perf_gettime()
+ *   caller  - The code that began the duration
+ *   pid     - The thread that held the lock, or the IRQ number
+ *
+ * Assumptions:
+ *   - Called within a critical section or from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void nxsched_critmon_hist(FAR struct critmon_hist_s *hist, uint32_t elapsed,
+                          FAR void *caller, pid_t pid)
+{
+  int i;
+
+  i = fls(elapsed);
+  if (i >= CONFIG_SCHED_CRITMONITOR_NBUCKETS)
+    {
+      i = CONFIG_SCHED_CRITMONITOR_NBUCKETS - 1;
+    }
+
+  hist->bucket[i]++;
+
+  /* The common case is shorter than all of the longest durations */
+
+  i = CONFIG_SCHED_CRITMONITOR_TOPN - 1;
+  if (elapsed <= hist->top[i].elapsed)
+    {
+      return;
+    }
+
+  for (; i > 0 && elapsed > hist->top[i - 1].elapsed; i--)
+    {
+      hist->top[i] = hist->top[i - 1];
+    }
+
+  hist->top[i].elapsed = elapsed;
+  hist->top[i].caller  = caller;
+  hist->top[i].pid     = pid;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_critmon_preemption
  *
@@ -130,7 +197,8 @@ uint32_t g_crit_max[CONFIG_SMP_NCPUS];
  *
  ****************************************************************************/
 
-void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
+void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                                FAR void *caller)
 {
   int cpu = this_cpu();
 
@@ -142,6 +210,9 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
 
       tcb->premp_start   = up_perf_gettime();
       g_premp_start[cpu] = tcb->premp_start;
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+      tcb->premp_caller  = caller;
+#endif
     }
   else
     {
@@ -150,6 +221,8 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
       uint32_t now     = up_perf_gettime();
       uint32_t elapsed = now - tcb->premp_start;
 
+      CRITMON_HIST(cpu, CRITMON_PREEMPTION, elapsed, tcb->premp_caller,
+                   tcb->pid);
       if (elapsed > tcb->premp_max)
         {
           tcb->premp_max = elapsed;
@@ -178,7 +251,8 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state)
  *
  ****************************************************************************/
 
-void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
+void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller)
 {
   int cpu = this_cpu();
 
@@ -190,6 +264,9 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
 
       tcb->crit_start   = up_perf_gettime();
       g_crit_start[cpu] = tcb->crit_start;
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+      tcb->crit_caller  = caller;
+#endif
     }
   else
     {
@@ -198,6 +275,8 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state)
       uint32_t now     = up_perf_gettime();
       uint32_t elapsed = now - tcb->crit_start;
 
+      CRITMON_HIST(cpu, CRITMON_CSECTION, elapsed, tcb->crit_caller,
+                   tcb->pid);
       if (elapsed > tcb->crit_max)
         {
           tcb->crit_max = elapsed;
@@ -295,6 +374,9 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
 {
   uint32_t current = up_perf_gettime();
   uint32_t elapsed = current - tcb->run_start;
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  int cpu = this_cpu();
+#endif
 
   if (elapsed > tcb->run_max)
     {
@@ -309,6 +391,8 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
       /* Possibly re-enabling.. Check for the max elapsed time */
 
       elapsed = current - tcb->premp_start;
+      CRITMON_HIST(cpu, CRITMON_PREEMPTION, elapsed, tcb->premp_caller,
+                   tcb->pid);
       if (elapsed > tcb->premp_max)
         {
           tcb->premp_max = elapsed;
@@ -323,6 +407,8 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb)
       /* Possibly leaving .. Check for the max elapsed time */
 
       elapsed = current - tcb->crit_start;
+      CRITMON_HIST(cpu, CRITMON_CSECTION, elapsed, tcb->crit_caller,
+                   tcb->pid);
       if (elapsed > tcb->crit_max)
         {
           tcb->crit_max = elapsed;
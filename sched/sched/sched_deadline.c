@@ -0,0 +1,426 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/signal.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/* Bandwidths are fractions of one CPU with 20 fractional bits */
+
+#define DEADLINE_BW_SHIFT  20
+#define DEADLINE_BW_LIMIT  ((uint32_t)(((uint64_t)CONFIG_SMP_NCPUS * \
+                                        CONFIG_SCHED_DEADLINE_MAXUTIL << \
+                                        DEADLINE_BW_SHIFT) / 100))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidths of all deadline threads */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_deadline_replenish
+ *
+ * Description:
+ *   Start a new server period:  Set the deadline to 'deadline' with a full
+ *   budget.
+ *
+ ****************************************************************************/
+
+static void nxsched_deadline_replenish(FAR struct tcb_s *tcb,
+                                       clock_t deadline)
+{
+  tcb->deadline.deadline = deadline;
+  tcb->deadline.missed   = false;
+  tcb->timeslice         = tcb->deadline.runtime;
+}
+
+/****************************************************************************
+ * Name: nxsched_deadline_checkmiss
+ *
+ * Description:
+ *   Count a missed deadline if the current job is still not complete at
+ *   time 'now'.  Each deadline is counted once.
+ *
+ ****************************************************************************/
+
+static void nxsched_deadline_checkmiss(FAR struct deadline_s *dl,
+                                       clock_t now)
+{
+  if (!dl->missed && (sclock_t)(now - dl->deadline) > 0)
+    {
+      dl->missed = true;
+      dl->nmisses++;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Admit a thread to the SCHED_DEADLINE policy, or change the parameters
+ *   of a deadline thread, and start a new job.  The thread is admitted only
+ *   if the bandwidths of all deadline threads still fit in
+ *   CONFIG_SCHED_DEADLINE_MAXUTIL percent of the CPUs.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The runtime, relative deadline and period of its jobs.  A zero
+ *           period stands for the relative deadline.
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the parameters do not satisfy
+ *   0 < runtime <= deadline <= period, or -EBUSY if the thread cannot be
+ *   admitted.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.  The caller queues the thread again, as its
+ *   deadline has changed.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb,
+                           FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  sclock_t reldeadline;
+  sclock_t runtime;
+  sclock_t period;
+  uint32_t oldbw = 0;
+  uint32_t bw;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+
+  /* Convert timespec values to system clock ticks */
+
+  clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  clock_time2ticks(&param->sched_dl_deadline, &reldeadline);
+  clock_time2ticks(&param->sched_dl_period, &period);
+
+  if (period == 0)
+    {
+      period = reldeadline;
+    }
+
+  if (runtime < 1 || runtime > reldeadline || reldeadline > period)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control, counting the current bandwidth of a thread that
+   * already has the deadline policy only once.
+   */
+
+  bw = (uint32_t)(((uint64_t)runtime << DEADLINE_BW_SHIFT) / period);
+  if (nxsched_isdeadline(tcb))
+    {
+      oldbw = dl->bandwidth;
+    }
+  else
+    {
+      dl->nmisses   = 0;
+      dl->noverruns = 0;
+    }
+
+  if (g_deadline_bw - oldbw + bw > DEADLINE_BW_LIMIT)
+    {
+      return -EBUSY;
+    }
+
+  g_deadline_bw   = g_deadline_bw - oldbw + bw;
+  dl->bandwidth   = bw;
+  dl->runtime     = runtime;
+  dl->reldeadline = reldeadline;
+  dl->period      = period;
+  dl->blocked     = false;
+
+  nxsched_deadline_replenish(tcb, clock_systime_ticks() + reldeadline);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Release the bandwidth of a thread that leaves the SCHED_DEADLINE
+ *   policy or exits.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  DEBUGASSERT(g_deadline_bw >= tcb->deadline.bandwidth);
+
+  g_deadline_bw           -= tcb->deadline.bandwidth;
+  tcb->deadline.bandwidth  = 0;
+  tcb->timeslice           = 0;
+}
+
+/****************************************************************************
+ * Name: nxsched_get_deadline
+ *
+ * Description:
+ *   Return the SCHED_DEADLINE parameters of a thread, or zeroes if it does
+ *   not have that policy.
+ *
+ ****************************************************************************/
+
+void nxsched_get_deadline(FAR struct tcb_s *tcb,
+                          FAR struct sched_param *param)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+
+  if (nxsched_isdeadline(tcb))
+    {
+      clock_ticks2time((sclock_t)dl->runtime, &param->sched_dl_runtime);
+      clock_ticks2time((sclock_t)dl->reldeadline,
+                       &param->sched_dl_deadline);
+      clock_ticks2time((sclock_t)dl->period, &param->sched_dl_period);
+    }
+  else
+    {
+      param->sched_dl_runtime.tv_sec   = 0;
+      param->sched_dl_runtime.tv_nsec  = 0;
+      param->sched_dl_deadline.tv_sec  = 0;
+      param->sched_dl_deadline.tv_nsec = 0;
+      param->sched_dl_period.tv_sec    = 0;
+      param->sched_dl_period.tv_nsec   = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Called when a thread is made ready to run.  If it is a deadline thread
+ *   that was blocked, apply the wakeup rule of the CBS:  The current
+ *   deadline and budget are kept only if the remaining budget can be
+ *   consumed before the deadline without exceeding the bandwidth of the
+ *   thread.  Otherwise a new period starts now, so that a thread that
+ *   slept cannot claim an old, early deadline.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.  The thread is not in any list yet.
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  clock_t now;
+  sclock_t left;
+
+  if (!nxsched_isdeadline(tcb) || !dl->blocked)
+    {
+      return;
+    }
+
+  dl->blocked = false;
+
+  now  = clock_systime_ticks();
+  left = (sclock_t)(dl->deadline - now);
+
+  if (left <= 0 || ((uint64_t)tcb->timeslice << DEADLINE_BW_SHIFT) >=
+                   (uint64_t)left * dl->bandwidth)
+    {
+      nxsched_deadline_replenish(tcb, now + dl->reldeadline);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_yield_deadline
+ *
+ * Description:
+ *   End the current job of the running deadline thread:  Count a missed
+ *   deadline if it is late, then sleep until the next job is released, one
+ *   period after the current one, with a full budget.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the running thread
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value if the sleep was interrupted.
+ *
+ ****************************************************************************/
+
+int nxsched_yield_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  struct timespec delay;
+  irqstate_t flags;
+  clock_t release;
+  clock_t now;
+  sclock_t ticks;
+
+  flags = enter_critical_section();
+
+  now = clock_systime_ticks();
+  nxsched_deadline_checkmiss(dl, now);
+
+  release = dl->deadline - dl->reldeadline + dl->period;
+  ticks   = (sclock_t)(release - now);
+
+  if (ticks <= 0)
+    {
+      /* The next job is already due.  Start it now, behind any deadline
+       * thread that is more urgent.
+       */
+
+      nxsched_deadline_replenish(tcb, now + dl->reldeadline);
+      leave_critical_section(flags);
+      return nxsched_set_priority(tcb, tcb->sched_priority);
+    }
+
+  /* The budget is replenished when the thread wakes up */
+
+  nxsched_deadline_replenish(tcb, release + dl->reldeadline);
+  leave_critical_section(flags);
+
+  clock_ticks2time(ticks, &delay);
+  return nxsig_nanosleep(&delay, NULL);
+}
+
+/****************************************************************************
+ * Name: nxsched_process_deadline
+ *
+ * Description:
+ *   Charge the running deadline thread for the time that it ran.  If its
+ *   budget is exhausted, the CBS postpones its deadline by one period and
+ *   replenishes the budget.  The thread then keeps running only if no
+ *   other deadline thread has an earlier deadline.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the currently executing thread
+ *   ticks - The number of ticks that have elapsed on the interval timer.
+ *   noswitches - True: Can't do context switches now.
+ *
+ * Returned Value:
+ *   The number if ticks remaining until the budget is exhausted.
+ *
+ *   The value one is returned if the budget is exhausted but the context
+ *   switch cannot be performed now, so that the timer expires again as soon
+ *   as possible.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The thread associated with TCB uses the deadline scheduling policy
+ *
+ ****************************************************************************/
+
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches)
+{
+  FAR struct deadline_s *dl;
+  FAR struct tcb_s *rtcb;
+
+  DEBUGASSERT(tcb != NULL);
+
+  dl              = &tcb->deadline;
+  tcb->timeslice -= MIN((uint32_t)tcb->timeslice, ticks);
+
+  /* A job that still runs after its deadline has missed it */
+
+  nxsched_deadline_checkmiss(dl, clock_systime_ticks());
+
+  if (tcb->timeslice > 0)
+    {
+      return tcb->timeslice;
+    }
+
+  if (noswitches || nxsched_islocked_tcb(tcb))
+    {
+      return 1;
+    }
+
+  /* The budget is exhausted:  Postpone the deadline with a new budget.
+   * This bounds the share of the CPU that the thread can take away from
+   * the other deadline threads to its bandwidth.
+   */
+
+  dl->noverruns++;
+  nxsched_deadline_replenish(tcb, dl->deadline + dl->period);
+
+  /* Give up the CPU if another deadline thread is now more urgent */
+
+  if (tcb->flink != NULL && nxsched_edf_before(tcb->flink, tcb))
+    {
+      rtcb = this_task();
+      if (nxsched_reprioritize_rtr(tcb, tcb->sched_priority))
+        {
+          up_switch_context(this_task(), rtcb);
+        }
+    }
+
+  return tcb->timeslice;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
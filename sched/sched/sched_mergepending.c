@@ -73,11 +73,36 @@
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
+#ifndef CONFIG_SCHED_PRIORITY_BITMAP
   FAR struct tcb_s *pnext;
-  FAR struct tcb_s *rtcb;
   FAR struct tcb_s *rprev;
+#endif
+  FAR struct tcb_s *rtcb;
   bool ret = false;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+  /* The ready-to-run list is indexed, so each pending task can be inserted
+   * directly without searching the list.
+   */
+
+  rtcb = this_task();
+  while ((ptcb = (FAR struct tcb_s *)dq_remfirst(&g_pendingtasks)) != NULL)
+    {
+      if (nxsched_add_rtrbitmap(ptcb))
+        {
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          ptcb->task_state = TSTATE_TASK_RUNNING;
+          rtcb             = ptcb;
+          ret              = true;
+        }
+      else
+        {
+          ptcb->task_state = TSTATE_TASK_READYTORUN;
+        }
+    }
+
+  return ret;
+#else
   /* Initialize the inner search loop */
 
   rtcb = this_task();
@@ -100,7 +125,8 @@ bool nxsched_merge_pending(void)
        */
 
       for (;
-           (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+           (rtcb && ptcb->sched_priority <= rtcb->sched_priority &&
+            !nxsched_edf_before(ptcb, rtcb));
            rtcb = rtcb->flink)
         {
         }
@@ -150,6 +176,7 @@ bool nxsched_merge_pending(void)
   g_pendingtasks.tail = NULL;
 
   return ret;
+#endif /* CONFIG_SCHED_PRIORITY_BITMAP */
 }
 #endif /* !CONFIG_SMP */
 
@@ -130,9 +130,10 @@ void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
           break;
         }
 
-      /* Which TCB has higher priority? */
+      /* Which TCB has higher priority (or the earlier deadline)? */
 
-      else if (tcb1->sched_priority > tcb2->sched_priority)
+      else if (tcb1->sched_priority > tcb2->sched_priority ||
+               nxsched_edf_before(tcb1, tcb2))
         {
           /* The TCB from list1 has higher priority than the TCB from list2.
            * Remove the TCB from list1 and insert it before the TCB from
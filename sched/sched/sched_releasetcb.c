@@ -29,6 +29,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
 
 #include "sched/sched.h"
@@ -111,6 +112,17 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
       timer_deleteall(tcb->pid);
 #endif
 
+#ifdef CONFIG_FS_SELECT_CACHE
+      /* Release the descriptors cached by select() */
+
+      if (tcb->pollset != NULL)
+        {
+          kmm_free(tcb->pollset);
+          tcb->pollset  = NULL;
+          tcb->npollset = 0;
+        }
+#endif
+
       /* Release the task's process ID if one was assigned.  PID
        * zero is reserved for the IDLE task.  The TCB of the IDLE
        * task is never release so a value of zero simply means that
@@ -122,6 +134,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
           nxsched_releasepid(tcb->pid);
         }
 
+#ifndef CONFIG_SCHED_TCB_CACHE
       /* Delete the thread's stack if one has been allocated */
 
       if (tcb->stack_alloc_ptr)
@@ -143,6 +156,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
               up_release_stack(tcb, ttype);
             }
         }
+#endif
 
 #ifdef CONFIG_PIC
       /* Delete the task's allocated DSpace region (external modules only) */
@@ -176,9 +190,11 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       group_leave(tcb);
 
-      /* And, finally, release the TCB itself */
+      /* And, finally, release the TCB itself, along with its stack if the
+       * TCB cache is enabled.
+       */
 
-      kmm_free(tcb);
+      nxsched_free_tcb(tcb, ttype);
     }
 
   return ret;
@@ -88,7 +88,7 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, &g_readytorun);
+  nxsched_remove_prioritized(rtcb, &g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -160,6 +160,9 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
     {
       FAR struct tcb_s *nxttcb;
       FAR struct tcb_s *rtrtcb = NULL;
+#ifdef CONFIG_SCHED_CPU_RUNQUEUE
+      FAR struct tcb_s *stltcb;
+#endif
       int me;
 
       /* There must always be at least one task in the list (the IDLE task)
@@ -206,6 +209,26 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
           for (rtrtcb = (FAR struct tcb_s *)g_readytorun.head;
                rtrtcb != NULL && !CPU_ISSET(cpu, &rtrtcb->affinity);
                rtrtcb = rtrtcb->flink);
+
+#ifdef CONFIG_SCHED_CPU_RUNQUEUE
+          /* If another CPU has a better candidate waiting in its run queue
+           * than anything that we have locally, then steal it.
+           */
+
+          stltcb = nxsched_steal_task(cpu);
+          if (stltcb != NULL &&
+              stltcb->sched_priority > nxttcb->sched_priority &&
+              (rtrtcb == NULL ||
+               stltcb->sched_priority > rtrtcb->sched_priority))
+            {
+              nxsched_migrate_task(stltcb);
+              dq_addfirst((FAR dq_entry_t *)stltcb, tasklist);
+
+              stltcb->cpu = cpu;
+              nxttcb = stltcb;
+              rtrtcb = NULL;
+            }
+#endif
         }
 
       /* Did we find a task in the g_readytorun list?  Which task should
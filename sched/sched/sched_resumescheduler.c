@@ -26,12 +26,14 @@
 
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
 
 #include "irq/irq.h"
 #include "sched/sched.h"
+#include "rcu/rcu.h"
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_RESUMESCHEDULER)
 
@@ -66,14 +68,30 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+  /* Time its slice or budget without a periodic timer */
+
+  nxsched_resume_timeslice(tcb);
+
   /* Indicate the task has been resumed */
 
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_resume_cputime(tcb);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
+#ifdef CONFIG_RCU
+  rcu_resume(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
+
+  /* Move the guard under the stack of the thread */
+
+#ifdef CONFIG_STACK_GUARD
+  up_stack_guard(tcb);
+#endif
 }
 
 #endif /* CONFIG_RR_INTERVAL > 0 || CONFIG_SCHED_RESUMESCHEDULER */
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * sched/sched/sched_rtrbitmap.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTR_NPRIOS     (SCHED_PRIORITY_MAX + 1)
+#define RTR_NWORDS     ((RTR_NPRIOS + 31) >> 5)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The g_readytorun list remains a single prioritized list so that
+ * this_task() is still its head.  The list is, however, logically divided
+ * into one FIFO segment per priority level.  g_rtrtail[] holds the last TCB
+ * of each segment and g_rtrbitmap[] has a bit set for each priority level
+ * that has a non-empty segment.  The IDLE task (priority zero) is always at
+ * the tail of the list and is never indexed.
+ */
+
+static FAR struct tcb_s *g_rtrtail[RTR_NPRIOS];
+static uint32_t g_rtrbitmap[RTR_NWORDS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_ceiling
+ *
+ * Description:
+ *   Return the lowest populated priority level that is greater than or
+ *   equal to 'priority', or -1 if there is none.  This requires at most
+ *   RTR_NWORDS ffs() operations regardless of the number of ready tasks.
+ *
+ ****************************************************************************/
+
+static int nxsched_rtr_ceiling(int priority)
+{
+  uint32_t mask;
+  int word = priority >> 5;
+
+  mask = g_rtrbitmap[word] & ~((UINT32_C(1) << (priority & 31)) - 1);
+  while (mask == 0)
+    {
+      if (++word >= RTR_NWORDS)
+        {
+          return -1;
+        }
+
+      mask = g_rtrbitmap[word];
+    }
+
+  return (word << 5) + ffs((int)mask) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_add_rtrbitmap
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list in constant time.  The TCB is placed
+ *   after all other TCBs of the same or higher priority.  SCHED_DEADLINE
+ *   TCBs are the exception:  They are sorted by deadline within their
+ *   level, which costs a walk over the deadline TCBs of that level.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to add to the ready-to-run list
+ *
+ * Returned Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ *   Same as for nxsched_add_prioritized().
+ *
+ ****************************************************************************/
+
+bool nxsched_add_rtrbitmap(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+  int ceiling;
+  bool ret;
+
+  DEBUGASSERT(priority >= SCHED_PRIORITY_MIN);
+
+  ceiling = nxsched_rtr_ceiling(priority);
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (ceiling == priority && nxsched_edf_before(tcb, g_rtrtail[priority]))
+    {
+      FAR struct tcb_s *next = g_rtrtail[priority];
+
+      /* Insert before the first TCB of the level with a later deadline.
+       * The tail of the level does not change.
+       */
+
+      while (next->blink != NULL && nxsched_edf_before(tcb, next->blink))
+        {
+          next = next->blink;
+        }
+
+      dq_addbefore((FAR dq_entry_t *)next, (FAR dq_entry_t *)tcb,
+                   &g_readytorun);
+      return tcb->blink == NULL;
+    }
+#endif
+
+  if (ceiling < 0)
+    {
+      /* Nothing of equal or higher priority:  tcb becomes the new head */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, &g_readytorun);
+      ret = true;
+    }
+  else
+    {
+      /* Insert just after the last TCB of the nearest populated level */
+
+      dq_addafter((FAR dq_entry_t *)g_rtrtail[ceiling],
+                  (FAR dq_entry_t *)tcb, &g_readytorun);
+      ret = false;
+    }
+
+  g_rtrtail[priority] = tcb;
+  g_rtrbitmap[priority >> 5] |= UINT32_C(1) << (priority & 31);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_remove_rtrbitmap
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list in constant time.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the ready-to-run list
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_remove_rtrbitmap(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+
+  if (g_rtrtail[priority] == tcb)
+    {
+      FAR struct tcb_s *prev = tcb->blink;
+
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          g_rtrtail[priority] = prev;
+        }
+      else
+        {
+          g_rtrtail[priority] = NULL;
+          g_rtrbitmap[priority >> 5] &= ~(UINT32_C(1) << (priority & 31));
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, &g_readytorun);
+}
+
+#endif /* CONFIG_SCHED_PRIORITY_BITMAP */
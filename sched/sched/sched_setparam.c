@@ -203,6 +203,29 @@ int nxsched_set_param(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  The priority of a
+   * deadline thread does not change, but it is queued again with its new
+   * deadline.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      ret = nxsched_start_deadline(tcb, param);
+      leave_critical_section(flags);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+
+      ret = nxsched_reprioritize(tcb, tcb->sched_priority);
+      goto errout_with_lock;
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = nxsched_reprioritize(tcb, param->sched_priority);
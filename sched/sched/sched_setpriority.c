@@ -83,11 +83,24 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
       if (rtrtcb != NULL &&
           rtrtcb->sched_priority >= nxttcb->sched_priority)
         {
-          return rtrtcb;
+          nxttcb = rtrtcb;
         }
+
+#ifdef CONFIG_SCHED_CPU_RUNQUEUE
+      /* A task waiting in the run queue of another CPU might also be
+       * stolen by tcb->cpu.
+       */
+
+      rtrtcb = nxsched_steal_task(tcb->cpu);
+      if (rtrtcb != NULL &&
+          rtrtcb->sched_priority > nxttcb->sched_priority)
+        {
+          nxttcb = rtrtcb;
+        }
+#endif
     }
 
-  /* Otherwise, return the next TCB in the g_assignedtasks[] list...
+  /* Otherwise, this is the next TCB in the g_assignedtasks[] list...
    * probably the TCB of the IDLE thread.
    * REVISIT:  What if it is not the IDLE thread?
    */
@@ -154,9 +167,19 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+      /* Move the task to the index of its new priority.  It remains at
+       * the head of the ready-to-run list.
+       */
+
+      nxsched_remove_rtrbitmap(tcb);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_add_rtrbitmap(tcb);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -196,6 +219,17 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
       cpu = nxsched_select_cpu(tcb->affinity);
     }
 
+#ifdef CONFIG_SCHED_CPU_RUNQUEUE
+  /* CASE 2a'. The task is waiting in the run queue of some CPU, but is not
+   * locked to it.  It may still run on any CPU in its affinity mask.
+   */
+
+  else if ((tcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+    {
+      cpu = nxsched_select_cpu(tcb->affinity);
+    }
+#endif
+
   /* CASE 2b.  The task is ready to run, and assigned to a CPU.  An increase
    * in priority could cause this task to become running but the task can
    * only run on its assigned CPU.
@@ -80,6 +80,10 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+#ifdef CONFIG_SCHED_DEADLINE
+  uint16_t oldpolicy;
+#endif
+  int priority = param->sched_priority;
   int ret;
 
   /* Check for supported scheduling policy */
@@ -90,6 +94,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -120,6 +127,17 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Release the bandwidth of a thread that leaves the deadline policy */
+
+  oldpolicy = tcb->flags & TCB_FLAG_POLICY_MASK;
+  if (oldpolicy == TCB_FLAG_SCHED_DEADLINE && policy != SCHED_DEADLINE)
+    {
+      nxsched_stop_deadline(tcb);
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -141,7 +159,8 @@ int nxsched_set_scheduler(pid_t pid, int policy,
           /* Save the FIFO scheduling parameters */
 
           tcb->flags       |= TCB_FLAG_SCHED_FIFO;
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
           tcb->timeslice    = 0;
 #endif
         }
@@ -258,6 +277,29 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Admit the server and start its first job.  It was checked
+           * against the current policy, so restore that on failure.
+           */
+
+          tcb->flags |= oldpolicy;
+          ret = nxsched_start_deadline(tcb, param);
+          if (ret < 0)
+            {
+              goto errout_with_irq;
+            }
+
+          /* Deadline threads run above all other real-time threads */
+
+          tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+          tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+          priority    = SCHED_PRIORITY_MAX;
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -265,15 +307,24 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
     }
 
+#ifdef CONFIG_SCHED_TICKLESS
+  /* If the caller changed its own policy, time its new slice or budget */
+
+  if (tcb == this_task())
+    {
+      nxsched_resume_timeslice(tcb);
+    }
+#endif
+
   leave_critical_section(flags);
 
   /* Set the new priority */
 
-  ret = nxsched_reprioritize(tcb, param->sched_priority);
+  ret = nxsched_reprioritize(tcb, priority);
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -34,6 +34,7 @@
 
 #include "clock/clock.h"
 #include "sched/sched.h"
+#include "rcu/rcu.h"
 
 #ifdef CONFIG_SCHED_SUSPENDSCHEDULER
 
@@ -70,9 +71,15 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
 
   /* Indicate that the task has been suspended */
 
+#ifdef CONFIG_SCHED_CPUTIME
+  nxsched_suspend_cputime(tcb);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_suspend_critmon(tcb);
 #endif
+#ifdef CONFIG_RCU
+  rcu_suspend(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(tcb);
 #endif
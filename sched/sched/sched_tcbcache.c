@@ -0,0 +1,187 @@
+/****************************************************************************
+ * sched/sched/sched_tcbcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TCB_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* One cache for each thread type: tasks, pthreads and kernel threads */
+
+#define TCB_CACHE_NTYPES  3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcb_cache_s
+{
+  FAR struct tcb_s *head;          /* Cached TCBs, linked by flink */
+  uint16_t count;                  /* Number of cached TCBs */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tcb_cache_s g_tcb_cache[TCB_CACHE_NTYPES];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a new thread, reusing the TCB of an exited
+ *   thread of the same type if one is cached.  The stack of the exited
+ *   thread stays with its TCB so that up_create_stack() reuses it if the
+ *   size matches and replaces it otherwise.
+ *
+ * Input Parameters:
+ *   ttype - The type of the thread (TCB_FLAG_TTYPE_*)
+ *   size  - The size of the TCB of this type
+ *
+ * Returned Value:
+ *   The TCB, or NULL if it cannot be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(uint8_t ttype, size_t size)
+{
+  FAR struct tcb_cache_s *cache = &g_tcb_cache[ttype];
+  FAR struct tcb_s *tcb;
+  FAR void *stack_alloc_ptr;
+  size_t stack_size;
+  irqstate_t flags;
+
+  DEBUGASSERT(ttype < TCB_CACHE_NTYPES);
+
+  flags = enter_critical_section();
+  tcb   = cache->head;
+  if (tcb != NULL)
+    {
+      cache->head = tcb->flink;
+      cache->count--;
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb == NULL)
+    {
+      /* The TCB is touched on every context switch */
+
+      return kmm_zalloc_tier(size, MM_TIER_FAST);
+    }
+
+  stack_alloc_ptr = tcb->stack_alloc_ptr;
+  stack_size      = tcb->adj_stack_size;
+
+  memset(tcb, 0, size);
+
+  if (stack_alloc_ptr != NULL)
+    {
+      tcb->stack_alloc_ptr = stack_alloc_ptr;
+      tcb->adj_stack_size  = stack_size;
+      tcb->flags           = ttype | TCB_FLAG_FREE_STACK;
+    }
+
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Release the TCB of a thread that has been torn down, keeping it in
+ *   the cache of its type if there is room, or freeing it and its stack.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB to release
+ *   ttype - The type of the thread (TCB_FLAG_TTYPE_*)
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+  FAR struct tcb_cache_s *cache = &g_tcb_cache[ttype];
+  irqstate_t flags;
+
+  DEBUGASSERT(ttype < TCB_CACHE_NTYPES);
+
+#ifdef CONFIG_SCHED_TCB_CACHE_STACK
+  if ((tcb->flags & TCB_FLAG_FREE_STACK) != 0)
+    {
+      /* Record the size that the stack was created with, the one that
+       * up_create_stack() compares with the requested size.
+       */
+
+      tcb->adj_stack_size += (uintptr_t)tcb->stack_base_ptr -
+                             (uintptr_t)tcb->stack_alloc_ptr;
+    }
+  else
+#endif
+  if (tcb->stack_alloc_ptr != NULL)
+    {
+      up_release_stack(tcb, ttype);
+      tcb->stack_alloc_ptr = NULL;
+    }
+
+  flags = enter_critical_section();
+  if (cache->count < CONFIG_SCHED_TCB_CACHE_SIZE)
+    {
+      tcb->flink  = cache->head;
+      cache->head = tcb;
+      cache->count++;
+      tcb = NULL;
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb != NULL)
+    {
+      if (tcb->stack_alloc_ptr != NULL)
+        {
+          up_release_stack(tcb, ttype);
+        }
+
+      kmm_free(tcb);
+    }
+}
+
+#endif /* CONFIG_SCHED_TCB_CACHE */
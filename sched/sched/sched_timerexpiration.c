@@ -48,27 +48,6 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* In the original design, it was planned that nxsched_reassess_timer() be
- * called whenever there was a change at the head of the ready-to-run
- * list.  That call was intended to establish a new time-slice or to
- * stop an old time-slice timer.  However, it turns out that that
- * solution is too fragile:  The system is too vulnerable at the time
- * that the ready-to-run list is modified in order to muck with timers.
- *
- * The kludge/work-around is simple to keep the timer running all of the
- * time with an interval of no more than the timeslice interval.  If we
- * do this, then there is really no need to do anything when on context
- * switches.
- */
-
-#define KEEP_ALIVE_HACK 1
-
-#if CONFIG_RR_INTERVAL > 0
-#  define KEEP_ALIVE_TICKS MSEC2TICK(CONFIG_RR_INTERVAL)
-#else
-#  define KEEP_ALIVE_TICKS MSEC2TICK(80)
-#endif
-
 #ifndef MIN
 #  define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #endif
@@ -102,11 +81,13 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * Private Function Prototypes
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
                                       bool noswitches);
 #endif
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_process_scheduler(uint32_t ticks, bool noswitches);
 #endif
 static unsigned int nxsched_timer_process(unsigned int ticks,
@@ -124,6 +105,11 @@ static void nxsched_timer_start(unsigned int ticks);
  */
 
 static clock_t g_stop_time;
+
+/* The time when the alarm expires, valid when g_timer_active is true */
+
+static clock_t g_timer_deadline;
+static bool g_timer_active;
 #else
 /* This is the duration of the currently active timer or, when
  * nxsched_timer_expiration() is called, the duration of interval timer
@@ -131,6 +117,28 @@ static clock_t g_stop_time;
  */
 
 static unsigned int g_timer_interval;
+
+/* The elapsed part of intervals that were cut short to time a new time
+ * slice, not yet processed.
+ */
+
+static unsigned int g_timer_carry;
+
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+/* The time when the interval timer was started */
+
+static clock_t g_timer_start;
+#endif
+#endif
+
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+/* The time when the task running on each CPU was resumed.  A task is only
+ * charged for the time that it actually ran, not for the whole interval.
+ */
+
+static clock_t g_resume_time[CONFIG_SMP_NCPUS];
 #endif
 
 #ifdef CONFIG_SCHED_SPORADIC
@@ -215,13 +223,23 @@ int up_timer_tick_cancel(FAR clock_t *ticks)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
                                       bool noswitches)
 {
   FAR struct tcb_s *rtcb = current_task(cpu);
   FAR struct tcb_s *ntcb = current_task(cpu);
   uint32_t ret = 0;
+  clock_t now;
+
+  /* The task may have been resumed after the start of the interval */
+
+  if (ticks > 0)
+    {
+      up_timer_gettick(&now);
+      ticks = MIN(ticks, now - g_resume_time[cpu]);
+    }
 
 #if CONFIG_RR_INTERVAL > 0
   /* Check if the currently executing task uses round robin scheduling. */
@@ -258,7 +276,25 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
        * budget.
        */
 
-      ret = nxsched_process_sporadic(rtcb, ticks, noswitches);
+      if (ticks > 0)
+        {
+          ret = nxsched_process_sporadic(rtcb, ticks, noswitches);
+        }
+      else if (rtcb->timeslice > 0)
+        {
+          ret = rtcb->timeslice;
+        }
+    }
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the elapsed time to the budget of its server */
+
+      ret = nxsched_process_deadline(rtcb, ticks, noswitches);
     }
 #endif
 
@@ -279,15 +315,6 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
 
   /* Returning zero means that there is no interesting event to be timed */
 
-#ifdef KEEP_ALIVE_HACK
-  if (ret == 0)
-    {
-      /* Apply the keep alive hack */
-
-      return KEEP_ALIVE_TICKS;
-    }
-#endif
-
   return ret;
 }
 #endif
@@ -316,7 +343,8 @@ static uint32_t nxsched_cpu_scheduler(int cpu, uint32_t ticks,
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t nxsched_process_scheduler(uint32_t ticks, bool noswitches)
 {
 #ifdef CONFIG_SMP
@@ -450,8 +478,9 @@ static unsigned int nxsched_timer_process(unsigned int ticks,
 
   tmp = nxsched_process_scheduler(ticks, noswitches);
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
-  if (tmp > 0 && tmp < rettime)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+  if (tmp > 0 && (rettime == 0 || tmp < rettime))
     {
       rettime = tmp;
     }
@@ -492,11 +521,18 @@ static void nxsched_timer_start(unsigned int ticks)
        * to the time when last stopped the timer).
        */
 
-      ret = up_alarm_tick_start(g_stop_time + ticks);
+      g_timer_deadline = g_stop_time + ticks;
+      g_timer_active   = true;
+
+      ret = up_alarm_tick_start(g_timer_deadline);
 #else
       /* Save new timer interval */
 
       g_timer_interval = ticks;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+      up_timer_gettick(&g_timer_start);
+#endif
 
       /* [Re-]start the interval timer */
 
@@ -547,7 +583,8 @@ void nxsched_alarm_tick_expiration(clock_t ticks)
 
   /* Save the time that the alarm occurred */
 
-  g_stop_time = ticks;
+  g_stop_time    = ticks;
+  g_timer_active = false;
 
 #ifdef CONFIG_SCHED_SPORADIC
   /* Save the last time that the scheduler ran */
@@ -596,8 +633,9 @@ void nxsched_timer_expiration(void)
 
   /* Get the interval associated with last expiration */
 
-  elapsed          = g_timer_interval;
+  elapsed          = g_timer_interval + g_timer_carry;
   g_timer_interval = 0;
+  g_timer_carry    = 0;
 
 #ifdef CONFIG_SCHED_SPORADIC
   /* Save the last time that the scheduler ran */
@@ -650,6 +688,7 @@ unsigned int nxsched_cancel_timer(void)
   ticks = g_stop_time;
 
   up_alarm_tick_cancel(&g_stop_time);
+  g_timer_active = false;
 
 #ifdef CONFIG_SCHED_SPORADIC
   /* Save the last time that the scheduler ran */
@@ -689,8 +728,9 @@ unsigned int nxsched_cancel_timer(void)
    * calling conditions.
    */
 
-  elapsed          = g_timer_interval - ticks;
+  elapsed          = g_timer_interval - ticks + g_timer_carry;
   g_timer_interval = 0;
+  g_timer_carry    = 0;
 
   /* Process the timer ticks and return the next interval */
 
@@ -737,6 +777,94 @@ void nxsched_resume_timer(void)
   nxsched_timer_start(nexttime);
 }
 
+/****************************************************************************
+ * Name:  nxsched_resume_timeslice
+ *
+ * Description:
+ *   Called by nxsched_resume_scheduler() when a task is about to run on
+ *   the current CPU.  If the task has a time slice or a sporadic budget,
+ *   the timer is moved earlier as needed so that it expires when the time
+ *   slice or budget does.  Nothing else is processed, so this is safe in
+ *   the middle of a context switch, and the timer does not have to be kept
+ *   running while no task needs it.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the task about to run
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+void nxsched_resume_timeslice(FAR struct tcb_s *tcb)
+{
+  unsigned int slice;
+  irqstate_t flags;
+  clock_t now;
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+  clock_t deadline;
+#else
+  clock_t remaining;
+#endif
+
+  flags = enter_critical_section();
+
+  up_timer_gettick(&now);
+  g_resume_time[this_cpu()] = now;
+
+  if (tcb->timeslice <= 0 ||
+      ((tcb->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_RR &&
+       (tcb->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_SPORADIC &&
+       (tcb->flags & TCB_FLAG_POLICY_MASK) != TCB_FLAG_SCHED_DEADLINE))
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  slice = tcb->timeslice;
+#ifdef CONFIG_SCHED_TICKLESS_LIMIT_MAX_SLEEP
+  slice = MIN(slice, g_oneshot_maxticks);
+#endif
+
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+  deadline = now + slice;
+  if (!g_timer_active || (sclock_t)(deadline - g_timer_deadline) < 0)
+    {
+      /* The expiration still accounts from g_stop_time */
+
+      g_timer_deadline = deadline;
+      g_timer_active   = true;
+      up_alarm_tick_start(deadline);
+    }
+#else
+  if (g_timer_interval == 0)
+    {
+      g_timer_interval = slice;
+      g_timer_start    = now;
+      up_timer_tick_start(slice);
+    }
+  else if (now - g_timer_start < g_timer_interval &&
+           g_timer_interval - (now - g_timer_start) > slice)
+    {
+      /* Carry the elapsed part of the interval to the next expiration */
+
+      up_timer_tick_cancel(&remaining);
+      g_timer_carry   += g_timer_interval - remaining;
+      g_timer_interval = slice;
+      g_timer_start    = now;
+      up_timer_tick_start(slice);
+    }
+#endif
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name:  nxsched_reassess_timer
  *
@@ -758,10 +886,9 @@ void nxsched_resume_timer(void)
  *   solution is too fragile:  The system is too vulnerable at the time
  *   that the ready-to-run list is modified in order to muck with timers.
  *
- *   The kludge/work-around is simple to keep the timer running all of the
- *   time with an interval of no more than the timeslice interval.  If we
- *   do this, then there is really no need to do anything on context
- *   switches.
+ *   Instead, nxsched_resume_timeslice() only moves the timer earlier when
+ *   a task with a time slice or a sporadic budget is resumed, and the
+ *   timer is stopped while no task or watchdog needs it.
  *
  * Input Parameters:
  *   None
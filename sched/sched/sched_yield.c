@@ -54,6 +54,18 @@ int sched_yield(void)
   FAR struct tcb_s *rtcb = this_task();
   int ret;
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread yields when its current job is complete.  It then
+   * sleeps until its next job is released.
+   */
+
+  if (nxsched_isdeadline(rtcb))
+    {
+      ret = nxsched_yield_deadline(rtcb);
+      return ret < 0 ? ERROR : OK;
+    }
+#endif
+
   /* This equivalent to just resetting the task priority to its current value
    * since this will cause the task to be rescheduled behind any other tasks
    * at the same priority.
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * sched/semaphore/brlock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/signal.h>
+#include <nuttx/brlock.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: brlock_readers
+ *
+ * Description:
+ *   Return the number of readers on all CPUs.
+ *
+ ****************************************************************************/
+
+static int brlock_readers(FAR brlock_t *lock)
+{
+  int readers = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      readers += __atomic_load_n(&lock->cpu[cpu].readers, __ATOMIC_SEQ_CST);
+    }
+
+  return readers;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: brlock_init
+ ****************************************************************************/
+
+void brlock_init(FAR brlock_t *lock)
+{
+  DEBUGASSERT(lock != NULL);
+
+  memset(lock, 0, sizeof(brlock_t));
+  nxmutex_init(&lock->mutex);
+}
+
+/****************************************************************************
+ * Name: brlock_rdlock
+ ****************************************************************************/
+
+int brlock_rdlock(FAR brlock_t *lock)
+{
+  int slot;
+  int ret;
+
+  DEBUGASSERT(lock != NULL);
+
+  for (; ; )
+    {
+      /* Enter, then check for a writer:  The writer sets its flag before
+       * it counts the readers, so that either it sees this one or this
+       * one sees it.
+       */
+
+      slot = this_cpu();
+      __atomic_fetch_add(&lock->cpu[slot].readers, 1, __ATOMIC_SEQ_CST);
+      if (!__atomic_load_n(&lock->writer, __ATOMIC_SEQ_CST))
+        {
+          return slot;
+        }
+
+      /* Back off and wait for the writer to finish */
+
+      __atomic_fetch_sub(&lock->cpu[slot].readers, 1, __ATOMIC_SEQ_CST);
+
+      ret = nxmutex_lock(&lock->mutex);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxmutex_unlock(&lock->mutex);
+    }
+}
+
+/****************************************************************************
+ * Name: brlock_rdunlock
+ ****************************************************************************/
+
+void brlock_rdunlock(FAR brlock_t *lock, int slot)
+{
+  DEBUGASSERT(lock != NULL && slot >= 0 && slot < CONFIG_SMP_NCPUS);
+  DEBUGASSERT(lock->cpu[slot].readers > 0);
+
+  __atomic_fetch_sub(&lock->cpu[slot].readers, 1, __ATOMIC_RELEASE);
+}
+
+/****************************************************************************
+ * Name: brlock_wrlock
+ ****************************************************************************/
+
+int brlock_wrlock(FAR brlock_t *lock)
+{
+  int ret;
+
+  DEBUGASSERT(lock != NULL);
+
+  ret = nxmutex_lock(&lock->mutex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  __atomic_store_n(&lock->writer, true, __ATOMIC_SEQ_CST);
+
+  while (brlock_readers(lock) > 0)
+    {
+      nxsig_usleep(USEC_PER_TICK);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: brlock_wrunlock
+ ****************************************************************************/
+
+void brlock_wrunlock(FAR brlock_t *lock)
+{
+  DEBUGASSERT(lock != NULL && lock->writer);
+
+  __atomic_store_n(&lock->writer, false, __ATOMIC_RELEASE);
+  nxmutex_unlock(&lock->mutex);
+}
@@ -44,6 +44,10 @@
 #  define CONFIG_SEM_PREALLOCHOLDERS 0
 #endif
 
+#ifndef CONFIG_SEM_TCBHOLDERS
+#  define CONFIG_SEM_TCBHOLDERS 0
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -62,6 +66,33 @@ static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
 static FAR struct semholder_s *g_freeholders;
 #endif
 
+/****************************************************************************
+ * Name: nxsem_alloctcbholder
+ *
+ * Description:
+ *   Return a free holder record embedded in the TCB of the holder, if any.
+ *   A record is free when it is not attached to a semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SEM_TCBHOLDERS > 0
+static inline FAR struct semholder_s *
+nxsem_alloctcbholder(FAR struct tcb_s *htcb)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SEM_TCBHOLDERS; i++)
+    {
+      if (htcb->holders[i].sem == NULL)
+        {
+          return &htcb->holders[i];
+        }
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: nxsem_allocholder
  ****************************************************************************/
@@ -69,26 +100,39 @@ static FAR struct semholder_s *g_freeholders;
 static inline FAR struct semholder_s *
 nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
-  FAR struct semholder_s *pholder;
-
-  /* Check if the "built-in" holder is being used.  We have this built-in
-   * holder to optimize for the simplest case where semaphores are only
-   * used to implement mutexes.
-   */
+  FAR struct semholder_s *pholder = NULL;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
+  /* Use a record embedded in the TCB first, then the shared pool */
+
+#if CONFIG_SEM_TCBHOLDERS > 0
+  pholder = nxsem_alloctcbholder(htcb);
+#endif
+  if (pholder == NULL && g_freeholders != NULL)
+    {
+      pholder          = g_freeholders;
+      g_freeholders    = pholder->flink;
+    }
+
   if (pholder != NULL)
     {
-      /* Remove the holder from the free list and
-       * put it into the semaphore's holder list
-       */
+      /* Put it at the head of the semaphore's holder list */
 
-      g_freeholders    = pholder->flink;
+      pholder->blink   = NULL;
       pholder->flink   = sem->hhead;
+      if (sem->hhead != NULL)
+        {
+          sem->hhead->blink = pholder;
+        }
+
       sem->hhead       = pholder;
     }
 #else
+  /* Check if the "built-in" holder is being used.  We have this built-in
+   * holder to optimize for the simplest case where semaphores are only
+   * used to implement mutexes.
+   */
+
   if (sem->holder[0].htcb == NULL)
     {
       pholder          = &sem->holder[0];
@@ -98,34 +142,39 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
       pholder          = &sem->holder[1];
     }
 #endif
-  else
+
+  if (pholder == NULL)
     {
       serr("ERROR: Insufficient pre-allocated holders\n");
-      pholder          = NULL;
       DEBUGPANIC();
+      return NULL;
     }
 
-  if (pholder != NULL)
-    {
-      pholder->sem    = sem;
-      pholder->htcb   = htcb;
-      pholder->counts = 0;
+  pholder->sem    = sem;
+  pholder->htcb   = htcb;
+  pholder->counts = 0;
 
-      /* Put it into the task's list */
+  /* Put it at the head of the task's list */
 
-      pholder->tlink  = htcb->holdsem;
-      htcb->holdsem   = pholder;
+  pholder->tblink = NULL;
+  pholder->tlink  = htcb->holdsem;
+  if (htcb->holdsem != NULL)
+    {
+      htcb->holdsem->tblink = pholder;
     }
 
+  htcb->holdsem   = pholder;
   return pholder;
 }
 
 /****************************************************************************
  * Name: nxsem_findholder
  *
- * NOTE: htcb may be used only as a look-up key.  It certain cases, the task
- * may have exited and htcb may refer to a stale memory.  It must not be
- * dereferenced.
+ * Description:
+ *   Look up the holder record of htcb on the semaphore.  The search runs
+ *   over the semaphores held by htcb, not over the holders of the
+ *   semaphore, so that its cost does not grow with the number of threads
+ *   holding a counting semaphore.
  *
  ****************************************************************************/
 
@@ -134,36 +183,15 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder;
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  /* Try to find the holder in the list of holders associated with this
-   * semaphore
-   */
-
-  for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
-    {
-      if (pholder->htcb == htcb)
-        {
-          /* Got it! */
-
-          return pholder;
-        }
-    }
-#else
-  int i;
-
-  /* We have two hard-allocated holder structures in sem_t */
-
-  for (i = 0; i < 2; i++)
+  for (pholder = htcb->holdsem; pholder != NULL; pholder = pholder->tlink)
     {
-      pholder = &sem->holder[i];
-      if (pholder->htcb == htcb)
+      if (pholder->sem == sem)
         {
           /* Got it! */
 
           return pholder;
         }
     }
-#endif
 
   /* The holder does not appear in the list */
 
@@ -193,24 +221,28 @@ nxsem_findorallocateholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 static inline void nxsem_freeholder(FAR sem_t *sem,
                                     FAR struct semholder_s *pholder)
 {
-  FAR struct semholder_s * FAR *curr;
+  FAR struct tcb_s *htcb = pholder->htcb;
 
   /* Remove the holder from the task's list */
 
-  for (curr = &pholder->htcb->holdsem;
-       *curr != NULL;
-       curr = &(*curr)->tlink)
+  if (pholder->tblink != NULL)
     {
-      if (*curr == pholder)
-        {
-          *curr = pholder->tlink;
-          break;
-        }
+      pholder->tblink->tlink = pholder->tlink;
+    }
+  else
+    {
+      htcb->holdsem = pholder->tlink;
+    }
+
+  if (pholder->tlink != NULL)
+    {
+      pholder->tlink->tblink = pholder->tblink;
     }
 
   /* Release the holder and counts */
 
   pholder->tlink  = NULL;
+  pholder->tblink = NULL;
   pholder->sem    = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
@@ -218,17 +250,33 @@ static inline void nxsem_freeholder(FAR sem_t *sem,
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   /* Remove the holder from the semaphore's list */
 
-  for (curr = &sem->hhead;
-       *curr != NULL;
-       curr = &(*curr)->flink)
+  if (pholder->blink != NULL)
     {
-      if (*curr == pholder)
-        {
-          *curr = pholder->flink;
-          break;
-        }
+      pholder->blink->flink = pholder->flink;
+    }
+  else
+    {
+      sem->hhead = pholder->flink;
+    }
+
+  if (pholder->flink != NULL)
+    {
+      pholder->flink->blink = pholder->blink;
     }
 
+  pholder->blink = NULL;
+
+#if CONFIG_SEM_TCBHOLDERS > 0
+  /* A record embedded in the TCB is free again now that sem is NULL */
+
+  if (pholder >= &htcb->holders[0] &&
+      pholder < &htcb->holders[CONFIG_SEM_TCBHOLDERS])
+    {
+      pholder->flink = NULL;
+      return;
+    }
+#endif
+
   /* And put it in the free list */
 
   pholder->flink = g_freeholders;
@@ -391,6 +439,41 @@ static int nxsem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsem_getholdertcb
+ ****************************************************************************/
+
+#ifdef CONFIG_MUTEX_ADAPTIVE
+static int nxsem_getholdertcb(FAR struct semholder_s *pholder,
+                              FAR sem_t *sem, FAR void *arg)
+{
+  if (pholder->counts > 0)
+    {
+      *(FAR struct tcb_s **)arg = pholder->htcb;
+      return 1;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsem_highestwaiter
+ *
+ * Description:
+ *   Return the priority of the highest priority thread waiting for the
+ *   semaphore, or -1 if there is none.  The wait list is kept in priority
+ *   order, so this is the head of the list.
+ *
+ ****************************************************************************/
+
+static inline int nxsem_highestwaiter(FAR sem_t *sem)
+{
+  FAR struct tcb_s *stcb = (FAR struct tcb_s *)dq_peek(SEM_WAITLIST(sem));
+
+  return stcb != NULL ? stcb->sched_priority : -1;
+}
+
 /****************************************************************************
  * Name: nxsem_restoreholderprio
  ****************************************************************************/
@@ -431,13 +514,11 @@ static int nxsem_restoreholderprio(FAR struct semholder_s *pholder,
       for (pholder = htcb->holdsem; pholder != NULL;
            pholder = pholder->tlink)
         {
-          FAR struct tcb_s *stcb;
+          int wpriority = nxsem_highestwaiter(pholder->sem);
 
-          stcb = (FAR struct tcb_s *)dq_peek(SEM_WAITLIST(pholder->sem));
-
-          if (stcb != NULL && stcb->sched_priority > hpriority)
+          if (wpriority > hpriority)
             {
-              hpriority = stcb->sched_priority;
+              hpriority = wpriority;
             }
         }
 
@@ -471,30 +552,6 @@ static int nxsem_restoreholderprio_others(FAR struct semholder_s *pholder,
   return 0;
 }
 
-/****************************************************************************
- * Name: nxsem_restoreholderprio_self
- *
- * Description:
- *   Reprioritize only the currently executing task
- *
- ****************************************************************************/
-
-static int nxsem_restoreholderprio_self(FAR struct semholder_s *pholder,
-                                        FAR sem_t *sem, FAR void *arg)
-{
-  FAR struct tcb_s *rtcb = this_task();
-
-  if (pholder->htcb == rtcb)
-    {
-      /* The running task has given up a count on the semaphore */
-
-      nxsem_restoreholderprio(pholder, sem, arg);
-      return 1;
-    }
-
-  return 0;
-}
-
 /****************************************************************************
  * Name: nxsem_restore_baseprio_irq
  *
@@ -579,11 +636,19 @@ static inline void nxsem_restore_baseprio_task(FAR struct tcb_s *stcb,
    * except for the running thread.
    */
 
+  FAR struct semholder_s *pholder;
+
   nxsem_foreachholder(sem, nxsem_restoreholderprio_others, stcb);
 
   /* Now, find an reprioritize only the ready to run task */
 
-  nxsem_foreachholder(sem, nxsem_restoreholderprio_self, stcb);
+  pholder = nxsem_findholder(sem, this_task());
+  if (pholder != NULL)
+    {
+      /* The running task has given up a count on the semaphore */
+
+      nxsem_restoreholderprio(pholder, sem, stcb);
+    }
 }
 
 /****************************************************************************
@@ -792,55 +857,43 @@ void nxsem_release_holder(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
   FAR struct semholder_s *pholder;
-  FAR struct semholder_s *candidate = NULL;
-  unsigned int total = 0;
 
   /* Find the container for this holder */
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
-#else
-  int i;
-
-  /* We have two hard-allocated holder structures in sem_t */
-
-  for (i = 0; i < 2; i++)
-#endif
+  pholder = nxsem_findholder(sem, rtcb);
+  if (pholder != NULL)
     {
-#if CONFIG_SEM_PREALLOCHOLDERS == 0
-      pholder = &sem->holder[i];
-      if (pholder->htcb == NULL)
-        {
-          continue;
-        }
-#endif
+      /* Decrement the counts on this holder -- the holder will be freed
+       * later in nxsem_restore_baseprio.
+       */
 
       DEBUGASSERT(pholder->counts > 0);
-
-      if (pholder->htcb == rtcb)
-        {
-          /* Decrement the counts on this holder -- the holder will be freed
-           * later in nxsem_restore_baseprio.
-           */
-
-          pholder->counts--;
-          return;
-        }
-
-      total++;
-      candidate = pholder;
+      pholder->counts--;
+      return;
     }
 
-  /* The current task is not a holder */
+  /* The current task is not a holder.  If the semaphore has only one
+   * holder, we can decrement the counts simply.
+   */
 
-  if (total == 1)
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  pholder = sem->hhead;
+  if (pholder != NULL && pholder->flink == NULL)
+#else
+  if (sem->holder[0].htcb == NULL)
     {
-      /* If the semaphore has only one holder, we can decrement the counts
-       * simply.
-       */
+      pholder = &sem->holder[1];
+    }
+  else if (sem->holder[1].htcb == NULL)
+    {
+      pholder = &sem->holder[0];
+    }
 
-      candidate->counts--;
-      return;
+  if (pholder != NULL && pholder->htcb != NULL)
+#endif
+    {
+      DEBUGASSERT(pholder->counts > 0);
+      pholder->counts--;
     }
 
   /* TODO:
@@ -1051,4 +1104,32 @@ void nxsem_release_all(FAR struct tcb_s *htcb)
     }
 }
 
+/****************************************************************************
+ * Name: nxsem_get_holder
+ *
+ * Description:
+ *   Return the TCB of a thread that holds a count of the semaphore, i.e.
+ *   the owner of a semaphore used as a mutex.
+ *
+ * Input Parameters:
+ *   sem - A reference to the semaphore
+ *
+ * Returned Value:
+ *   The TCB of the holder, or NULL if the semaphore has no tracked holder.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MUTEX_ADAPTIVE
+FAR struct tcb_s *nxsem_get_holder(FAR sem_t *sem)
+{
+  FAR struct tcb_s *htcb = NULL;
+
+  nxsem_foreachholder(sem, nxsem_getholdertcb, &htcb);
+  return htcb;
+}
+#endif
+
 #endif /* CONFIG_PRIORITY_INHERITANCE */
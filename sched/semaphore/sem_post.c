@@ -220,7 +220,11 @@ int nxsem_post(FAR sem_t *sem)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SEM_FASTPATH
+int nx_sem_post(FAR sem_t *sem)
+#else
 int sem_post(FAR sem_t *sem)
+#endif
 {
   int ret;
 
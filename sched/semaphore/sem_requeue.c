@@ -0,0 +1,112 @@
+/****************************************************************************
+ * sched/semaphore/sem_requeue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_REQUEUE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_requeue
+ *
+ * Description:
+ *   Move the highest priority waiter of a semaphore to the wait list of the
+ *   semaphore that it named in its waitmorph field, without waking it up.
+ *   This is the wait morphing of condition variables:  A waiter that has
+ *   been signalled goes on to wait for the mutex, instead of waking up only
+ *   to find the mutex taken by the signalling thread.
+ *
+ *   The waiter then resumes when the second semaphore is posted to it, as
+ *   if it had waited on it, and finds TCB_FLAG_SEM_REQUEUED set in its
+ *   flags.
+ *
+ *   The wait can only be moved to a semaphore that is not available, so
+ *   that it is sure to be posted to, and that does not use priority
+ *   inheritance, which would have to boost its holders as the waiter does
+ *   itself in nxsem_wait().
+ *
+ * Input Parameters:
+ *   sem - The semaphore whose waiter is moved
+ *
+ * Returned Value:
+ *   OK if the waiter has been moved, -EAGAIN if it has to be woken up by
+ *   posting sem instead, or -ENOENT if no thread waits on sem.
+ *
+ ****************************************************************************/
+
+int nxsem_requeue(FAR sem_t *sem)
+{
+  FAR struct tcb_s *stcb;
+  FAR sem_t *to;
+  irqstate_t flags;
+  int ret = -EAGAIN;
+
+  DEBUGASSERT(sem != NULL);
+
+  flags = enter_critical_section();
+
+  stcb = (FAR struct tcb_s *)dq_peek(SEM_WAITLIST(sem));
+  if (stcb == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else if ((to = stcb->waitmorph) != NULL && to->semcount <= 0
+#ifdef CONFIG_PRIORITY_INHERITANCE
+           && (to->flags & PRIOINHERIT_FLAGS_ENABLE) == 0
+#endif
+          )
+    {
+      DEBUGASSERT(stcb->waitobj == sem && sem->semcount < 0);
+
+      /* Release the count that the waiter took on sem and take one on the
+       * new semaphore, as nxsem_wait() would have.
+       */
+
+      dq_rem((FAR dq_entry_t *)stcb, SEM_WAITLIST(sem));
+      sem->semcount++;
+
+      to->semcount--;
+      stcb->waitobj = to;
+      stcb->flags  |= TCB_FLAG_SEM_REQUEUED;
+      nxsched_add_prioritized(stcb, SEM_WAITLIST(to));
+
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_SEM_REQUEUE */
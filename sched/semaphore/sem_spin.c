@@ -0,0 +1,133 @@
+/****************************************************************************
+ * sched/semaphore/sem_spin.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_MUTEX_ADAPTIVE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_spin
+ *
+ * Description:
+ *   Try to take a semaphore used as a mutex by spinning while its holder
+ *   is running on another CPU, for at most CONFIG_MUTEX_ADAPTIVE_SPIN
+ *   microseconds.  A holder that runs is likely to release the mutex
+ *   sooner than the two context switches of a blocking wait would take.
+ *   Spinning stops as soon as the holder blocks or is preempted, or when
+ *   other threads are already waiting for the mutex.
+ *
+ * Input Parameters:
+ *   sem    - The semaphore to take
+ *   holder - The ID of the thread that holds the semaphore, or
+ *            INVALID_PROCESS_ID to find it among the holders tracked for
+ *            priority inheritance.
+ *
+ * Returned Value:
+ *   OK if the semaphore was taken.  -EAGAIN if the caller has to block.
+ *
+ ****************************************************************************/
+
+int nxsem_spin(FAR sem_t *sem, pid_t holder)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct tcb_s *htcb;
+  irqstate_t flags;
+  bool running;
+  int usec;
+
+  DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
+
+  /* The holder would have to enter the critical section to release the
+   * semaphore.
+   */
+
+  if (rtcb->irqcount > 0)
+    {
+      return -EAGAIN;
+    }
+
+  for (usec = 0; ; usec++)
+    {
+      flags = enter_critical_section();
+
+      if (sem->semcount > 0)
+        {
+          /* The holder has released the semaphore.  Take it. */
+
+          sem->semcount--;
+          nxsem_add_holder(sem);
+          if (usec > 0)
+            {
+              sem->nspins++;
+            }
+
+          leave_critical_section(flags);
+          return OK;
+        }
+
+      /* Keep spinning only if nobody waits yet:  The next count goes to
+       * the first waiter.
+       */
+
+      running = false;
+      if (sem->semcount == 0 && usec < CONFIG_MUTEX_ADAPTIVE_SPIN)
+        {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+          htcb = holder == INVALID_PROCESS_ID ? nxsem_get_holder(sem) :
+                                                nxsched_get_tcb(holder);
+#else
+          htcb = nxsched_get_tcb(holder);
+#endif
+          running = htcb != NULL && htcb != rtcb &&
+                    htcb->task_state == TSTATE_TASK_RUNNING;
+        }
+
+      leave_critical_section(flags);
+
+      if (!running)
+        {
+          return -EAGAIN;
+        }
+
+      /* Let the holder run to the release */
+
+      up_udelay(1);
+    }
+}
+
+#endif /* CONFIG_MUTEX_ADAPTIVE */
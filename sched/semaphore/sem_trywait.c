@@ -126,7 +126,11 @@ int nxsem_trywait(FAR sem_t *sem)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SEM_FASTPATH
+int nx_sem_trywait(FAR sem_t *sem)
+#else
 int sem_trywait(FAR sem_t *sem)
+#endif
 {
   int ret;
 
@@ -32,6 +32,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/spinlock.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -80,6 +81,18 @@ int nxsem_wait(FAR sem_t *sem)
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+#if defined(CONFIG_MUTEX_ADAPTIVE) && defined(CONFIG_PRIORITY_INHERITANCE)
+  /* A contended mutex with priority inheritance has a known holder.
+   * Spin while it runs on another CPU before blocking.
+   */
+
+  if (sem->semcount <= 0 && (sem->flags & PRIOINHERIT_FLAGS_ENABLE) != 0 &&
+      nxsem_spin(sem, INVALID_PROCESS_ID) == OK)
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -117,6 +130,10 @@ int nxsem_wait(FAR sem_t *sem)
 
       sem->semcount--;
 
+#ifdef CONFIG_MUTEX_ADAPTIVE
+      sem->nblocks++;
+#endif
+
       /* Save the waited on semaphore in the TCB */
 
       rtcb->waitobj = sem;
@@ -152,6 +169,12 @@ int nxsem_wait(FAR sem_t *sem)
 
       DEBUGASSERT(!is_idle_task(rtcb));
 
+      /* Blocking while this CPU holds a spinlock would stall the other
+       * CPUs spinning on it.
+       */
+
+      spin_lockdep_sleep();
+
       /* Remove the tcb task from the ready-to-run list. */
 
       switch_needed = nxsched_remove_readytorun(rtcb, true);
@@ -262,7 +285,11 @@ int nxsem_wait_uninterruptible(FAR sem_t *sem)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SEM_FASTPATH
+int nx_sem_wait(FAR sem_t *sem)
+#else
 int sem_wait(FAR sem_t *sem)
+#endif
 {
   int errcode;
   int ret;
@@ -65,6 +65,18 @@ void nxsem_timeout(wdparm_t pid);
 
 void nxsem_recover(FAR struct tcb_s *tcb);
 
+/* Spin for a semaphore used as a mutex while its holder runs */
+
+#ifdef CONFIG_MUTEX_ADAPTIVE
+int nxsem_spin(FAR sem_t *sem, pid_t holder);
+#endif
+
+/* Move a waiter of a semaphore to the semaphore it waits on next */
+
+#ifdef CONFIG_SEM_REQUEUE
+int nxsem_requeue(FAR sem_t *sem);
+#endif
+
 /* Special logic needed only by priority inheritance to manage collections of
  * holders of semaphores.
  */
@@ -79,6 +91,9 @@ void nxsem_release_holder(FAR sem_t *sem);
 void nxsem_restore_baseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 void nxsem_release_all(FAR struct tcb_s *stcb);
+#ifdef CONFIG_MUTEX_ADAPTIVE
+FAR struct tcb_s *nxsem_get_holder(FAR sem_t *sem);
+#endif
 #else
 #  define nxsem_initialize_holders()
 #  define nxsem_destroyholder(sem)
@@ -26,16 +26,385 @@
 
 #include <sys/types.h>
 #include <sched.h>
+#include <string.h>
 #include <assert.h>
+#include <errno.h>
+#include <debug.h>
 
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
 #include <arch/irq.h>
 
 #include "sched/sched.h"
+#include "irq/irq.h"
 
 #ifdef CONFIG_SPINLOCK
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_LOCKDEP
+/* The spinlocks held by each CPU */
+
+struct spin_lockdep_s
+{
+  FAR volatile void *held[CONFIG_SPINLOCK_LOCKDEP_DEPTH];
+  uint8_t nheld;
+  bool reported;                    /* A violation is being reported */
+};
+
+/* A pair of locks seen being taken nested, in that order */
+
+struct spin_lockorder_s
+{
+  FAR volatile void *first;
+  FAR volatile void *second;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+static struct spinlock_stat_s
+g_spinlock_stats[CONFIG_SPINLOCK_STATISTICS_NLOCKS];
+#endif
+
+#ifdef CONFIG_SPINLOCK_LOCKDEP
+static struct spin_lockdep_s g_lockdep[SP_NCPUS];
+static struct spin_lockorder_s g_lockorder[CONFIG_SPINLOCK_LOCKDEP_NORDERS];
+
+static unsigned int g_nlockorders;
+static spinlock_t g_lockorder_lock = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_wait
+ *
+ * Description:
+ *   Loop until the spinlock is successfully locked.  For a ticket lock,
+ *   take the next ticket and wait until the owner reaches it.
+ *
+ * Returned Value:
+ *   The number of spin loop iterations spent waiting for the lock.
+ *
+ ****************************************************************************/
+
+static inline unsigned long spin_wait(FAR volatile spinlock_t *lock)
+{
+  unsigned long nspins = 0;
+#ifdef CONFIG_SPINLOCK_TICKET
+  spinlock_t ticket;
+
+  DEBUGASSERT(SP_NCPUS <= SP_TICKET_MASK);
+
+  ticket = __atomic_fetch_add(lock, SP_TICKET_NEXT, __ATOMIC_ACQUIRE);
+  ticket = (ticket >> SP_TICKET_SHIFT) & SP_TICKET_MASK;
+
+  while ((__atomic_load_n(lock, __ATOMIC_ACQUIRE) & SP_TICKET_MASK) !=
+         ticket)
+#else
+  while (up_testset(lock) == SP_LOCKED)
+#endif
+    {
+      SP_DSB();
+      SP_WFE();
+      nspins++;
+    }
+
+  return nspins;
+}
+
+/****************************************************************************
+ * Name: spin_try
+ *
+ * Description:
+ *   Try once to lock the spinlock.  A ticket lock is only taken if it is
+ *   free, i.e. no ticket is waiting.
+ *
+ * Returned Value:
+ *   true if the spinlock was locked.
+ *
+ ****************************************************************************/
+
+static inline bool spin_try(FAR volatile spinlock_t *lock)
+{
+#ifdef CONFIG_SPINLOCK_TICKET
+  spinlock_t expected = SP_UNLOCKED;
+
+  return __atomic_compare_exchange_n(lock, &expected, SP_TICKET_NEXT, false,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#else
+  return up_testset(lock) == SP_UNLOCKED;
+#endif
+}
+
+/****************************************************************************
+ * Name: spin_release
+ *
+ * Description:
+ *   Unlock the spinlock.  A ticket lock is passed to the next ticket, or
+ *   returns to SP_UNLOCKED if nobody is waiting.
+ *
+ ****************************************************************************/
+
+static inline void spin_release(FAR volatile spinlock_t *lock)
+{
+#ifdef CONFIG_SPINLOCK_TICKET
+  spinlock_t oldval = __atomic_load_n(lock, __ATOMIC_RELAXED);
+  spinlock_t newval;
+  spinlock_t owner;
+
+  do
+    {
+      owner = (oldval + 1) & SP_TICKET_MASK;
+      if (((oldval >> SP_TICKET_SHIFT) & SP_TICKET_MASK) == owner)
+        {
+          newval = SP_UNLOCKED;
+        }
+      else
+        {
+          newval = (oldval & ~SP_TICKET_MASK) | owner;
+        }
+    }
+  while (!__atomic_compare_exchange_n(lock, &oldval, newval, true,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+#else
+  *lock = SP_UNLOCKED;
+#endif
+}
+
+/****************************************************************************
+ * Name: spin_stat
+ *
+ * Description:
+ *   Account one acquisition of a lock in the contention statistics of
+ *   this CPU.  The statistics slot of the lock is found by hashing its
+ *   address and taken on first use.  A new longest wait is also recorded
+ *   in the note driver.
+ *
+ * Input Parameters:
+ *   lock   - The address of the lock
+ *   nspins - The number of spin loop iterations waited, 0 if the lock was
+ *            free.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+static void spin_stat(FAR volatile void *lock, unsigned long nspins)
+{
+  FAR struct spinlock_cpustat_s *cpustat;
+  FAR struct spinlock_stat_s *stat;
+  FAR volatile void *slotlock;
+  unsigned int index;
+  unsigned int i;
+
+  index = ((uintptr_t)lock >> 2) % CONFIG_SPINLOCK_STATISTICS_NLOCKS;
+  for (i = 0; i < CONFIG_SPINLOCK_STATISTICS_NLOCKS; i++)
+    {
+      stat     = &g_spinlock_stats[index];
+      slotlock = __atomic_load_n(&stat->lock, __ATOMIC_RELAXED);
+      if (slotlock == NULL &&
+          __atomic_compare_exchange_n(&stat->lock, &slotlock, lock, false,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+          slotlock = lock;
+        }
+
+      if (slotlock == lock)
+        {
+          break;
+        }
+
+      if (++index >= CONFIG_SPINLOCK_STATISTICS_NLOCKS)
+        {
+          index = 0;
+        }
+    }
+
+  if (i >= CONFIG_SPINLOCK_STATISTICS_NLOCKS)
+    {
+      /* The table is full, this lock is not tracked */
+
+      return;
+    }
+
+  /* Each CPU only updates its own counters */
+
+  cpustat = &stat->cpu[this_cpu()];
+  cpustat->nlocks++;
+
+  if (nspins > 0)
+    {
+      cpustat->ncontended++;
+      cpustat->nspins += nspins;
+
+      if (nspins > cpustat->maxspins)
+        {
+          cpustat->maxspins = nspins;
+          SCHED_NOTE_PRINTF("spinlock %p: %lu spins\n", lock, nspins);
+        }
+    }
+}
+#else
+#  define spin_stat(l,n)
+#endif
+
+/****************************************************************************
+ * Name: spin_lockdep_report
+ *
+ * Description:
+ *   Report a violation found by the spinlock dependency checker.  Further
+ *   checks on this CPU are disabled so that the report itself, which takes
+ *   spinlocks, cannot recurse.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_LOCKDEP
+static void spin_lockdep_report(int cpu, FAR const char *msg,
+                                FAR volatile void *lock,
+                                FAR volatile void *other)
+{
+  g_lockdep[cpu].reported = true;
+  _alert("lockdep: CPU%d %s: %p %p\n", cpu, msg, lock, other);
+  DEBUGPANIC();
+}
+
+/****************************************************************************
+ * Name: spin_lockdep_order
+ *
+ * Description:
+ *   Record that lock second is taken while lock first is held, and report
+ *   a violation if the opposite order has been seen before.
+ *
+ ****************************************************************************/
+
+static void spin_lockdep_order(int cpu, FAR volatile void *first,
+                               FAR volatile void *second)
+{
+  unsigned int i;
+
+  spin_lock_wo_note(&g_lockorder_lock);
+
+  for (i = 0; i < g_nlockorders; i++)
+    {
+      if (g_lockorder[i].first == first && g_lockorder[i].second == second)
+        {
+          break;
+        }
+
+      if (g_lockorder[i].first == second && g_lockorder[i].second == first)
+        {
+          spin_unlock_wo_note(&g_lockorder_lock);
+          spin_lockdep_report(cpu, "lock order inversion", second, first);
+          return;
+        }
+    }
+
+  if (i == g_nlockorders && i < CONFIG_SPINLOCK_LOCKDEP_NORDERS)
+    {
+      g_lockorder[i].first  = first;
+      g_lockorder[i].second = second;
+      g_nlockorders++;
+    }
+
+  spin_unlock_wo_note(&g_lockorder_lock);
+}
+
+/****************************************************************************
+ * Name: spin_lockdep_acquire
+ *
+ * Description:
+ *   Account a spinlock taken by this CPU.  If wait is true, the caller is
+ *   about to wait for the lock, so its order with respect to the locks
+ *   already held, and to the global critical section, is checked too.
+ *
+ ****************************************************************************/
+
+static void spin_lockdep_acquire(FAR volatile void *lock, bool wait)
+{
+  int cpu = this_cpu();
+  int i;
+
+  if (g_lockdep[cpu].reported)
+    {
+      return;
+    }
+
+  for (i = 0; i < g_lockdep[cpu].nheld; i++)
+    {
+      if (g_lockdep[cpu].held[i] == lock)
+        {
+          spin_lockdep_report(cpu, "recursive lock", lock, NULL);
+          return;
+        }
+
+      if (wait)
+        {
+          spin_lockdep_order(cpu, g_lockdep[cpu].held[i], lock);
+        }
+    }
+
+#ifdef CONFIG_SMP
+  if (wait && (g_cpu_irqset & (1 << cpu)) != 0)
+    {
+      spin_lockdep_order(cpu, &g_cpu_irqlock, lock);
+    }
+#endif
+
+  if (g_lockdep[cpu].nheld >= CONFIG_SPINLOCK_LOCKDEP_DEPTH)
+    {
+      spin_lockdep_report(cpu, "too many locks held", lock, NULL);
+      return;
+    }
+
+  g_lockdep[cpu].held[g_lockdep[cpu].nheld++] = lock;
+}
+
+/****************************************************************************
+ * Name: spin_lockdep_release
+ *
+ * Description:
+ *   Account a spinlock released by this CPU.
+ *
+ ****************************************************************************/
+
+static void spin_lockdep_release(FAR volatile void *lock)
+{
+  int cpu = this_cpu();
+  int i;
+
+  if (g_lockdep[cpu].reported)
+    {
+      return;
+    }
+
+  for (i = g_lockdep[cpu].nheld - 1; i >= 0; i--)
+    {
+      if (g_lockdep[cpu].held[i] == lock)
+        {
+          /* Locks need not be released in reverse order */
+
+          g_lockdep[cpu].nheld--;
+          memmove(&g_lockdep[cpu].held[i], &g_lockdep[cpu].held[i + 1],
+                  (g_lockdep[cpu].nheld - i) * sizeof(FAR void *));
+          return;
+        }
+    }
+
+  spin_lockdep_report(cpu, "unlock of a lock not held", lock, NULL);
+}
+#else
+#  define spin_lockdep_acquire(l,w)
+#  define spin_lockdep_release(l)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -71,11 +440,13 @@ void spin_lock(FAR volatile spinlock_t *lock)
   sched_note_spinlock(this_task(), lock, NOTE_SPINLOCK_LOCK);
 #endif
 
-  while (up_testset(lock) == SP_LOCKED)
-    {
-      SP_DSB();
-      SP_WFE();
-    }
+  spin_lockdep_acquire(lock, true);
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  spin_stat(lock, spin_wait(lock));
+#else
+  spin_wait(lock);
+#endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
@@ -109,12 +480,7 @@ void spin_lock(FAR volatile spinlock_t *lock)
 
 void spin_lock_wo_note(FAR volatile spinlock_t *lock)
 {
-  while (up_testset(lock) == SP_LOCKED)
-    {
-      SP_DSB();
-      SP_WFE();
-    }
-
+  spin_wait(lock);
   SP_DMB();
 }
 
@@ -145,7 +511,7 @@ spinlock_t spin_trylock(FAR volatile spinlock_t *lock)
   sched_note_spinlock(this_task(), lock, NOTE_SPINLOCK_LOCK);
 #endif
 
-  if (up_testset(lock) == SP_LOCKED)
+  if (!spin_try(lock))
     {
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
       /* Notify that we abort for a spinlock */
@@ -156,6 +522,9 @@ spinlock_t spin_trylock(FAR volatile spinlock_t *lock)
       return SP_LOCKED;
     }
 
+  spin_stat(lock, 0);
+  spin_lockdep_acquire(lock, false);
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
 
@@ -189,7 +558,7 @@ spinlock_t spin_trylock(FAR volatile spinlock_t *lock)
 
 spinlock_t spin_trylock_wo_note(FAR volatile spinlock_t *lock)
 {
-  if (up_testset(lock) == SP_LOCKED)
+  if (!spin_try(lock))
     {
       SP_DSB();
       return SP_LOCKED;
@@ -225,8 +594,9 @@ void spin_unlock(FAR volatile spinlock_t *lock)
   sched_note_spinlock(this_task(), lock, NOTE_SPINLOCK_UNLOCK);
 #endif
 
+  spin_lockdep_release(lock);
   SP_DMB();
-  *lock = SP_UNLOCKED;
+  spin_release(lock);
   SP_DSB();
   SP_SEV();
 }
@@ -255,7 +625,7 @@ void spin_unlock(FAR volatile spinlock_t *lock)
 void spin_unlock_wo_note(FAR volatile spinlock_t *lock)
 {
   SP_DMB();
-  *lock = SP_UNLOCKED;
+  spin_release(lock);
   SP_DSB();
   SP_SEV();
 }
@@ -384,4 +754,219 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 }
 #endif
 
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Lock an MCS queue lock.  The caller is appended to the queue of the
+ *   lock and then spins on its own node until the previous holder hands
+ *   the lock over.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of the caller.  It is used until mcs_unlock().
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+void mcs_lock(FAR struct mcs_lock_s *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *prev;
+  unsigned long nspins = 0;
+
+  node->next = NULL;
+  node->wait = true;
+
+  /* Append our node to the queue.  If there was a previous node, link
+   * ours behind it and wait until its owner hands the lock over.
+   */
+
+  prev = __atomic_exchange_n(&lock->tail, node, __ATOMIC_ACQ_REL);
+  if (prev != NULL)
+    {
+      __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+
+      while (__atomic_load_n(&node->wait, __ATOMIC_ACQUIRE))
+        {
+          SP_DSB();
+          SP_WFE();
+          nspins++;
+        }
+    }
+
+  spin_stat(lock, nspins);
+  UNUSED(nspins);
+  SP_DMB();
+}
+#endif
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Try once to lock an MCS queue lock.  Do not wait if the lock is
+ *   already held or if other CPUs are waiting for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of the caller.  It is used until mcs_unlock().
+ *
+ * Returned Value:
+ *   true if the lock was taken, false otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+bool mcs_trylock(FAR struct mcs_lock_s *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *expected = NULL;
+
+  node->next = NULL;
+  node->wait = false;
+
+  if (!__atomic_compare_exchange_n(&lock->tail, &expected, node, false,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      SP_DSB();
+      return false;
+    }
+
+  spin_stat(lock, 0);
+  SP_DMB();
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release an MCS queue lock and hand it over to the next waiter, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to unlock.
+ *   node - The node that was passed to mcs_lock() or mcs_trylock().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+void mcs_unlock(FAR struct mcs_lock_s *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *next;
+  FAR struct mcs_node_s *expected;
+
+  SP_DMB();
+
+  next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+  if (next == NULL)
+    {
+      /* If we are still the tail, nobody is waiting: the lock is free */
+
+      expected = node;
+      if (__atomic_compare_exchange_n(&lock->tail, &expected, NULL, false,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+          return;
+        }
+
+      /* A new waiter has taken the tail, but has not linked its node to
+       * ours yet.
+       */
+
+      while ((next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) ==
+             NULL)
+        {
+        }
+    }
+
+  /* Hand the lock over to the next waiter */
+
+  __atomic_store_n(&next->wait, false, __ATOMIC_RELEASE);
+  SP_DSB();
+  SP_SEV();
+}
+#endif
+
+/****************************************************************************
+ * Name: spin_getstat
+ *
+ * Description:
+ *   Return one entry of the spinlock contention statistics.
+ *
+ * Input Parameters:
+ *   index - The index of the entry,
+ *           0 .. CONFIG_SPINLOCK_STATISTICS_NLOCKS - 1
+ *   stat  - The location to return the entry.  stat->lock is NULL for an
+ *           unused entry.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if index is out of range.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+int spin_getstat(unsigned int index, FAR struct spinlock_stat_s *stat)
+{
+  if (index >= CONFIG_SPINLOCK_STATISTICS_NLOCKS)
+    {
+      return -ENOENT;
+    }
+
+  memcpy(stat, &g_spinlock_stats[index], sizeof(struct spinlock_stat_s));
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: spin_lockdep_csection
+ *
+ * Description:
+ *   Tell the spinlock dependency checker that this CPU is about to wait
+ *   for the global critical section.  Every spinlock held by this CPU is
+ *   recorded as being taken before the critical section.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SPINLOCK_LOCKDEP) && defined(CONFIG_SMP)
+void spin_lockdep_csection(void)
+{
+  int cpu = this_cpu();
+  int i;
+
+  for (i = 0; !g_lockdep[cpu].reported && i < g_lockdep[cpu].nheld; i++)
+    {
+      spin_lockdep_order(cpu, g_lockdep[cpu].held[i], &g_cpu_irqlock);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: spin_lockdep_sleep
+ *
+ * Description:
+ *   Tell the spinlock dependency checker that the current task is about
+ *   to block.  This is a violation if this CPU holds any spinlock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_LOCKDEP
+void spin_lockdep_sleep(void)
+{
+  int cpu = this_cpu();
+
+  if (!g_lockdep[cpu].reported && g_lockdep[cpu].nheld > 0)
+    {
+      spin_lockdep_report(cpu, "blocking with a lock held",
+                          g_lockdep[cpu].held[g_lockdep[cpu].nheld - 1],
+                          NULL);
+    }
+}
+#endif
+
 #endif /* CONFIG_SPINLOCK */
@@ -267,6 +267,10 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
     }
 
   DEBUGASSERT(sigpend);
+
+  /* Let the signalfds of the group that wait for the signal know */
+
+  signalfd_notify(group->tg_pid, info->si_signo);
 }
 
 /****************************************************************************
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <signal.h>
+#include <strings.h>
 
 #include <nuttx/signal.h>
 
@@ -44,15 +45,14 @@
 
 int nxsig_lowest(sigset_t *set)
 {
-  int signo;
+  sigset_t valid = *set & ~(SIGNO2SET(MIN_SIGNO) - 1);
 
-  for (signo = MIN_SIGNO; signo <= MAX_SIGNO; signo++)
+  /* The set is a bitmap:  The lowest member is its lowest bit set */
+
+  if (valid == NULL_SIGNAL_SET)
     {
-      if (nxsig_ismember(set, signo))
-        {
-          return signo;
-        }
+      return ERROR;
     }
 
-  return ERROR;
+  return ffs((int)valid) - 1;
 }
@@ -81,7 +81,8 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)
+    nxsched_alloc_tcb(ttype, sizeof(struct task_tcb_s));
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -90,7 +91,7 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Setup the task type */
 
-  tcb->cmn.flags = ttype;
+  tcb->cmn.flags |= ttype;
 
   /* Initialize the task */
 
@@ -98,7 +99,7 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
                     entry, argv, envp);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb(&tcb->cmn, ttype);
       return ret;
     }
 
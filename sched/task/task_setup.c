@@ -377,6 +377,14 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
   ret = nxtask_assign_pid(tcb);
   if (ret == OK)
     {
+#ifdef CONFIG_SEM_FASTPATH
+      /* The TLS was set up before the ID was known.  Publish the ID so that
+       * user-space fast paths can record the owner of a mutex.
+       */
+
+      ((FAR struct tls_info_s *)tcb->stack_alloc_ptr)->tl_tid = tcb->pid;
+#endif
+
       /* Save task priority and entry point in the TCB */
 
       tcb->sched_priority = (uint8_t)priority;
@@ -134,7 +134,8 @@ FAR struct task_tcb_s *nxtask_setup_vfork(start_t retaddr)
 
   /* Allocate a TCB for the child task. */
 
-  child = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  child = (FAR struct task_tcb_s *)
+    nxsched_alloc_tcb(ttype, sizeof(struct task_tcb_s));
   if (!child)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -66,5 +66,8 @@ int tls_init_info(FAR struct tcb_s *tcb)
   /* Attach per-task info in group to TLS */
 
   info->tl_task = tcb->group->tg_info;
+#ifdef CONFIG_SEM_FASTPATH
+  info->tl_tid  = tcb->pid;
+#endif
   return OK;
 }
@@ -57,8 +57,10 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -72,6 +74,32 @@ int wd_cancel(FAR struct wdog_s *wdog)
    * active.
    */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+    {
+      /* A watchdog that has reached its expiration tick has already been
+       * moved to g_wdexpired by wd_timer().  Otherwise, it is still in the
+       * slot of its expiration tick.
+       */
+
+      if (WDOG_REMAINING(wdog) <= 0)
+        {
+          wd_wheel_unlink(wdog, &g_wdexpired);
+        }
+      else
+        {
+          wd_wheel_unlink(wdog, WDOG_WHEEL_SLOT(wdog->lag));
+        }
+
+      /* Mark the watchdog inactive */
+
+      wdog->func = NULL;
+
+      /* Return success */
+
+      ret = OK;
+    }
+#else
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
@@ -132,6 +160,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
       ret = OK;
     }
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
 
   leave_critical_section(flags);
   return ret;
@@ -57,6 +57,17 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
   /* Verify the wdog */
 
   flags = enter_critical_section();
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  if (wdog != NULL && WDOG_ISACTIVE(wdog))
+    {
+      /* The watchdog holds its absolute expiration tick */
+
+      sclock_t delay = WDOG_REMAINING(wdog);
+
+      leave_critical_section(flags);
+      return delay > 0 ? delay : 0;
+    }
+#else
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
       /* Traverse the watchdog list accumulating lag times until we find the
@@ -79,7 +90,86 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
             }
         }
     }
+#endif
 
   leave_critical_section(flags);
   return 0;
 }
+
+/****************************************************************************
+ * Name: wd_nexttime
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires, that is the latest time at which a timer will
+ *   wake up an idle system.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that a watchdog has already expired.  A negative value
+ *   means that no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nexttime(void)
+{
+  irqstate_t flags;
+  sclock_t delay = -1;
+
+  flags = enter_critical_section();
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  if (g_wdexpired.head != NULL)
+    {
+      delay = 0;
+    }
+  else
+    {
+      FAR struct wdog_s *wdog;
+      sclock_t remaining;
+      int i;
+
+      /* Walk the wheel from the next tick on.  A watchdog that expires in
+       * the current revolution is the earliest one; the others only bound
+       * the result.
+       */
+
+      for (i = 1; i <= CONFIG_WDOG_WHEEL_NSLOTS; i++)
+        {
+          for (wdog = (FAR struct wdog_s *)
+                      WDOG_WHEEL_SLOT(g_wdclock + i)->head;
+               wdog != NULL;
+               wdog = wdog->next)
+            {
+              remaining = WDOG_REMAINING(wdog);
+              if (delay < 0 || remaining < delay)
+                {
+                  delay = remaining > 0 ? remaining : 0;
+                }
+            }
+
+          if (delay >= 0 && delay <= i)
+            {
+              break;
+            }
+        }
+    }
+#else
+  if (g_wdactivelist.head != NULL)
+    {
+      /* The list is ordered:  The head expires first */
+
+      delay = ((FAR struct wdog_s *)g_wdactivelist.head)->lag -
+              wd_elapse();
+      if (delay < 0)
+        {
+          delay = 0;
+        }
+    }
+#endif
+
+  leave_critical_section(flags);
+  return delay;
+}
@@ -37,7 +37,17 @@
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 sq_queue_t g_wdactivelist;
+#else
+/* The timing wheel.  A watchdog expiring on tick 't' is kept in slot
+ * (t % CONFIG_WDOG_WHEEL_NSLOTS).
+ */
+
+sq_queue_t g_wdwheel[CONFIG_WDOG_WHEEL_NSLOTS];
+sq_queue_t g_wdexpired;
+clock_t g_wdclock;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -93,6 +93,48 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+static inline void wd_expiration(void)
+{
+  FAR sq_queue_t *slot = WDOG_WHEEL_SLOT(g_wdclock);
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *next;
+  wdentry_t func;
+
+  /* Move every watchdog in the current slot that expires on this tick to
+   * g_wdexpired.  The others belong to a later revolution of the wheel.
+   * A watchdog in g_wdexpired may still be canceled by one of the
+   * functions called below.
+   */
+
+  for (wdog = (FAR struct wdog_s *)slot->head; wdog != NULL; wdog = next)
+    {
+      next = wdog->next;
+      if (WDOG_REMAINING(wdog) <= 0)
+        {
+          wd_wheel_unlink(wdog, slot);
+          wd_wheel_link(wdog, &g_wdexpired);
+        }
+    }
+
+  /* Then run the whole batch */
+
+  while ((wdog = (FAR struct wdog_s *)g_wdexpired.head) != NULL)
+    {
+      wd_wheel_unlink(wdog, &g_wdexpired);
+
+      /* Indicate that the watchdog is no longer active. */
+
+      func = wdog->func;
+      wdog->func = NULL;
+
+      /* Execute the watchdog function */
+
+      up_setpicbase(wdog->picbase);
+      CALL_FUNC(func, wdog->arg);
+    }
+}
+#else
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
@@ -129,6 +171,7 @@ static inline void wd_expiration(void)
       CALL_FUNC(func, wdog->arg);
     }
 }
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
 
 /****************************************************************************
  * Public Functions
@@ -173,10 +216,12 @@ static inline void wd_expiration(void)
 int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
              wdentry_t wdentry, wdparm_t arg)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   sclock_t now;
+#endif
   irqstate_t flags;
 
   /* Verify the wdog and setup parameters */
@@ -228,6 +273,12 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
       delay--;
     }
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  /* Hash the watchdog into the slot of its expiration tick */
+
+  wdog->lag = (sclock_t)(g_wdclock + delay);
+  wd_wheel_link(wdog, WDOG_WHEEL_SLOT(wdog->lag));
+#else
 #ifdef CONFIG_SCHED_TICKLESS
   /* Cancel the interval timer that drives the timing events.  This will
    * cause wd_timer to be called which update the delay value for the first
@@ -331,6 +382,7 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   /* Put the lag into the watchdog structure and mark it as active. */
 
   wdog->lag = delay;
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Resume the interval timer that will generate the next interval event.
@@ -417,6 +469,15 @@ unsigned int wd_timer(int ticks, bool noswitches)
   return ret;
 }
 
+#elif defined(CONFIG_WDOG_TIMER_WHEEL)
+void wd_timer(void)
+{
+  /* Advance the wheel by one tick and run the watchdogs in the new slot */
+
+  g_wdclock++;
+  wd_expiration();
+}
+
 #else
 void wd_timer(void)
 {
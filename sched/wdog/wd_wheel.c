@@ -0,0 +1,112 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/queue.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Append a watchdog to the tail of a timing wheel slot.  Watchdogs that
+ *   expire on the same tick are thus run in the order they were started.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to add
+ *   slot - The slot (or g_wdexpired) to add it to
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_link(FAR struct wdog_s *wdog, FAR sq_queue_t *slot)
+{
+  wdog->prev = (FAR struct wdog_s *)slot->tail;
+  sq_addlast((FAR sq_entry_t *)wdog, slot);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ *
+ * Description:
+ *   Remove a watchdog from the slot that holds it without searching.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove
+ *   slot - The slot (or g_wdexpired) that holds it
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_unlink(FAR struct wdog_s *wdog, FAR sq_queue_t *slot)
+{
+  FAR struct wdog_s *next = wdog->next;
+  FAR struct wdog_s *prev = wdog->prev;
+
+  if (prev != NULL)
+    {
+      prev->next = next;
+    }
+  else
+    {
+      DEBUGASSERT(slot->head == (FAR sq_entry_t *)wdog);
+      slot->head = (FAR sq_entry_t *)next;
+    }
+
+  if (next != NULL)
+    {
+      next->prev = prev;
+    }
+  else
+    {
+      DEBUGASSERT(slot->tail == (FAR sq_entry_t *)wdog);
+      slot->tail = (FAR sq_entry_t *)prev;
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+}
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
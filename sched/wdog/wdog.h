@@ -56,6 +56,21 @@
 #  define wd_elapse() (0)
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  if (CONFIG_WDOG_WHEEL_NSLOTS & (CONFIG_WDOG_WHEEL_NSLOTS - 1)) != 0
+#    error CONFIG_WDOG_WHEEL_NSLOTS must be a power of two
+#  endif
+
+#  define WDOG_WHEEL_MASK     (CONFIG_WDOG_WHEEL_NSLOTS - 1)
+#  define WDOG_WHEEL_SLOT(t)  (&g_wdwheel[(clock_t)(t) & WDOG_WHEEL_MASK])
+
+/* Remaining ticks of an active watchdog.  In the timing wheel, the lag
+ * field holds the absolute expiration tick rather than a delta.
+ */
+
+#  define WDOG_REMAINING(w)   ((sclock_t)((clock_t)(w)->lag - g_wdclock))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -73,7 +88,19 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 extern sq_queue_t g_wdactivelist;
+#else
+/* With the timing wheel, an active watchdog lives in the slot selected by
+ * its expiration tick.  g_wdexpired holds the watchdogs that have expired
+ * on the current tick but whose functions have not yet been called.
+ * g_wdclock is the tick that was most recently processed by wd_timer().
+ */
+
+extern sq_queue_t g_wdwheel[CONFIG_WDOG_WHEEL_NSLOTS];
+extern sq_queue_t g_wdexpired;
+extern clock_t g_wdclock;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -141,6 +168,23 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_link and wd_wheel_unlink
+ *
+ * Description:
+ *   Append a watchdog to, or remove a watchdog from, a timing wheel slot
+ *   (or the g_wdexpired list) in constant time.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_wheel_link(FAR struct wdog_s *wdog, FAR sq_queue_t *slot);
+void wd_wheel_unlink(FAR struct wdog_s *wdog, FAR sq_queue_t *slot);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
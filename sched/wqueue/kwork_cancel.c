@@ -142,6 +142,15 @@ int work_cancel(int qid, FAR struct work_s *work)
       return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
     }
   else
+#endif
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (qid >= HPWORK_CPU0 && qid < HPWORK_CPU(CONFIG_SMP_NCPUS))
+    {
+      /* Cancel per-CPU, high priority work */
+
+      return work_qcancel(&g_hpcpuwork[qid - HPWORK_CPU0], work);
+    }
+  else
 #endif
     {
       return -EINVAL;
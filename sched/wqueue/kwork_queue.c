@@ -70,6 +70,22 @@ static void lp_work_timer_expiry(wdparm_t arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: cpu_work_timer_expiry
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+static void cpu_work_timer_expiry(wdparm_t arg)
+{
+  FAR struct work_s *work = (FAR struct work_s *)arg;
+  FAR struct kwork_wqueue_s *wqueue = work->wq;
+  irqstate_t flags = enter_critical_section();
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  nxsem_post(&wqueue->sem);
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -89,6 +105,10 @@ static void lp_work_timer_expiry(wdparm_t arg)
  *   previous work has been performed and removed from the queue, then any
  *   pending work will be canceled and lost.
  *
+ *   With CONFIG_WQUEUE_COALESCE, a call without delay for work that is
+ *   still waiting in the queue with the same worker and argument is a
+ *   no-op: the pending entry keeps its place and runs once.
+ *
  * Input Parameters:
  *   qid    - The work queue ID (index)
  *   work   - The work structure to queue
@@ -110,6 +130,20 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   irqstate_t flags;
   int ret = OK;
 
+#ifdef CONFIG_WQUEUE_COALESCE
+  /* If the same work is already waiting in the queue, it will run after
+   * this call anyway.  The worker thread clears work->worker when it takes
+   * the entry, so no lock is needed to detect that case.
+   */
+
+  if (delay == 0 &&
+      __atomic_load_n(&work->worker, __ATOMIC_ACQUIRE) == worker &&
+      work->arg == arg && !WDOG_ISACTIVE(&work->u.timer))
+    {
+      return OK;
+    }
+#endif
+
   /* Interrupts are disabled so that this logic can be called from with
    * task logic or from interrupt handling logic.
    */
@@ -162,6 +196,27 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
         }
     }
   else
+#endif
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (qid >= HPWORK_CPU0 && qid < HPWORK_CPU(CONFIG_SMP_NCPUS))
+    {
+      /* Queue high priority work on the queue of one CPU */
+
+      FAR struct kwork_wqueue_s *wqueue = &g_hpcpuwork[qid - HPWORK_CPU0];
+
+      if (!delay)
+        {
+          dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+          nxsem_post(&wqueue->sem);
+        }
+      else
+        {
+          work->wq = wqueue;
+          wd_start(&work->u.timer, delay, cpu_work_timer_expiry,
+                   (wdparm_t)work);
+        }
+    }
+  else
 #endif
     {
       ret = -EINVAL;
@@ -85,6 +85,12 @@ struct hp_wqueue_s g_hpwork =
 
 #endif /* CONFIG_SCHED_HPWORK */
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the per-CPU, high priority work queues */
+
+struct kwork_wqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 #if defined(CONFIG_SCHED_LPWORK)
 /* The state of the kernel mode, low priority work queue(s). */
 
@@ -100,6 +106,126 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+static int work_thread(int argc, FAR char *argv[]);
+
+/****************************************************************************
+ * Name: work_thread_spawn
+ *
+ * Description:
+ *   Create one worker thread for the work queue wqueue.
+ *
+ * Input Parameters:
+ *   name       - Name of the new task
+ *   priority   - Priority of the new task
+ *   stack_size - size (in bytes) of the stack needed
+ *   wqueue     - Work queue instance
+ *
+ * Returned Value:
+ *   The pid of the new thread on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int work_thread_spawn(FAR const char *name, int priority,
+                             int stack_size,
+                             FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR char *argv[2];
+  char args[32];
+
+  snprintf(args, sizeof(args), "0x%" PRIxPTR, (uintptr_t)wqueue);
+  argv[0] = args;
+  argv[1] = NULL;
+
+  return kthread_create(name, priority, stack_size, work_thread, argv);
+}
+
+/****************************************************************************
+ * Name: lpwork_grow
+ *
+ * Description:
+ *   Called by a low priority worker thread, within the critical section,
+ *   after it has taken work from the queue.  If there is still a backlog
+ *   that no idle thread is going to take, start one more worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+static void lpwork_grow(void)
+{
+  int backlog;
+  int pid;
+
+  if (g_lpwork.nthreads >= CONFIG_SCHED_LPNTHREADS_MAX)
+    {
+      return;
+    }
+
+  /* A positive semaphore count is the number of queued entries that no
+   * waiting worker has been woken up for.
+   */
+
+  nxsem_get_value(&g_lpwork.sem, &backlog);
+  if (backlog < CONFIG_SCHED_LPWORK_BACKLOG)
+    {
+      return;
+    }
+
+  pid = work_thread_spawn(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                          CONFIG_SCHED_LPWORKSTACKSIZE,
+                          (FAR struct kwork_wqueue_s *)&g_lpwork);
+  if (pid > 0)
+    {
+      g_lpwork.worker[g_lpwork.nthreads++].pid = pid;
+    }
+}
+
+/****************************************************************************
+ * Name: lpwork_wait
+ *
+ * Description:
+ *   Wait for low priority work, within the critical section.  A thread
+ *   above the CONFIG_SCHED_LPNTHREADS base that has been idle for
+ *   CONFIG_SCHED_LPWORK_IDLETIME milliseconds removes itself from the pool.
+ *
+ * Returned Value:
+ *   True if there is work to do; false if the calling thread must exit.
+ *
+ ****************************************************************************/
+
+static bool lpwork_wait(void)
+{
+  pid_t pid;
+  int wndx;
+
+  while (nxsem_tickwait_uninterruptible(&g_lpwork.sem,
+                          MSEC2TICK(CONFIG_SCHED_LPWORK_IDLETIME)) < 0)
+    {
+      if (g_lpwork.nthreads <= CONFIG_SCHED_LPNTHREADS)
+        {
+          continue;
+        }
+
+      /* Keep the worker table dense for work_foreach() and the priority
+       * inheritance logic.
+       */
+
+      pid = gettid();
+      for (wndx = 0; wndx < g_lpwork.nthreads; wndx++)
+        {
+          if (g_lpwork.worker[wndx].pid == pid)
+            {
+              g_lpwork.nthreads--;
+              g_lpwork.worker[wndx] = g_lpwork.worker[g_lpwork.nthreads];
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+#endif /* CONFIG_SCHED_LPWORK_DYNAMIC */
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -144,7 +270,19 @@ static int work_thread(int argc, FAR char *argv[])
        * posted.
        */
 
-      nxsem_wait_uninterruptible(&wqueue->sem);
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+      if (wqueue == (FAR struct kwork_wqueue_s *)&g_lpwork)
+        {
+          if (!lpwork_wait())
+            {
+              break;
+            }
+        }
+      else
+#endif
+        {
+          nxsem_wait_uninterruptible(&wqueue->sem);
+        }
 
       /* And check each entry in the work queue.  Since we have disabled
        * interrupts we know:  (1) we will not be suspended unless we do
@@ -170,6 +308,13 @@ static int work_thread(int argc, FAR char *argv[])
 
           work->worker = NULL;
 
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+          if (wqueue == (FAR struct kwork_wqueue_s *)&g_lpwork)
+            {
+              lpwork_grow();
+            }
+#endif
+
           /* Do the work.  Re-enable interrupts while the work is being
            * performed... we don't have any idea how long this will take!
            */
@@ -208,15 +353,9 @@ static int work_thread_create(FAR const char *name, int priority,
                               int stack_size, int nthread,
                               FAR struct kwork_wqueue_s *wqueue)
 {
-  FAR char *argv[2];
-  char args[32];
   int wndx;
   int pid;
 
-  snprintf(args, sizeof(args), "0x%" PRIxPTR, (uintptr_t)wqueue);
-  argv[0] = args;
-  argv[1] = NULL;
-
   /* Don't permit any of the threads to run until we have fully initialized
    * g_hpwork and g_lpwork.
    */
@@ -225,8 +364,7 @@ static int work_thread_create(FAR const char *name, int priority,
 
   for (wndx = 0; wndx < nthread; wndx++)
     {
-      pid = kthread_create(name, priority, stack_size,
-                           work_thread, argv);
+      pid = work_thread_spawn(name, priority, stack_size, wqueue);
 
       DEBUGASSERT(pid > 0);
       if (pid < 0)
@@ -282,7 +420,15 @@ void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
   if (qid == LPWORK)
     {
       wqueue  = (FAR struct kwork_wqueue_s *)&g_lpwork;
-      nthread = CONFIG_SCHED_LPNTHREADS;
+      nthread = LPWORK_NTHREADS;
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (qid >= HPWORK_CPU0 && qid < HPWORK_CPU(CONFIG_SMP_NCPUS))
+    {
+      wqueue  = &g_hpcpuwork[qid - HPWORK_CPU0];
+      nthread = 1;
     }
   else
 #endif
@@ -315,12 +461,48 @@ int work_start_highpri(void)
 {
   /* Start the high-priority, kernel mode worker thread(s) */
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  FAR struct kwork_wqueue_s *wqueue;
+  cpu_set_t cpuset;
+  int cpu;
+#endif
+  int ret;
+
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
-  return work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
-                            CONFIG_SCHED_HPWORKSTACKSIZE,
-                            CONFIG_SCHED_HPNTHREADS,
-                            (FAR struct kwork_wqueue_s *)&g_hpwork);
+  ret = work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                           CONFIG_SCHED_HPWORKSTACKSIZE,
+                           CONFIG_SCHED_HPNTHREADS,
+                           (FAR struct kwork_wqueue_s *)&g_hpwork);
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  /* Start one worker thread for the queue of each CPU.  The thread is
+   * bound to its CPU before it is allowed to run.
+   */
+
+  for (cpu = 0; ret >= 0 && cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      wqueue = &g_hpcpuwork[cpu];
+      dq_init(&wqueue->q);
+      nxsem_init(&wqueue->sem, 0, 0);
+      nxsem_set_protocol(&wqueue->sem, SEM_PRIO_NONE);
+
+      sched_lock();
+      ret = work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                               CONFIG_SCHED_HPWORKSTACKSIZE, 1, wqueue);
+      if (ret >= 0)
+        {
+          CPU_ZERO(&cpuset);
+          CPU_SET(cpu, &cpuset);
+          ret = nxsched_set_affinity(wqueue->worker[0].pid,
+                                     sizeof(cpu_set_t), &cpuset);
+        }
+
+      sched_unlock();
+    }
+#endif
+
+  return ret;
 }
 #endif /* CONFIG_SCHED_HPWORK */
 
@@ -345,6 +527,10 @@ int work_start_lowpri(void)
 
   sinfo("Starting low-priority kernel worker thread(s)\n");
 
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+  g_lpwork.nthreads = CONFIG_SCHED_LPNTHREADS;
+#endif
+
   return work_thread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
                             CONFIG_SCHED_LPWORKSTACKSIZE,
                             CONFIG_SCHED_LPNTHREADS,
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <nuttx/clock.h>
@@ -43,6 +44,14 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The number of threads currently serving the low priority work queue */
+
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+#  define LPWORK_NTHREADS g_lpwork.nthreads
+#else
+#  define LPWORK_NTHREADS CONFIG_SCHED_LPNTHREADS
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -91,7 +100,12 @@ struct lp_wqueue_s
 
   /* Describes each thread in the low priority queue's thread pool */
 
+#ifdef CONFIG_SCHED_LPWORK_DYNAMIC
+  struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS_MAX];
+  uint8_t           nthreads;  /* The number of running worker threads */
+#else
   struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS];
+#endif
 };
 #endif
 
@@ -105,6 +119,14 @@ struct lp_wqueue_s
 extern struct hp_wqueue_s g_hpwork;
 #endif
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the per-CPU, high priority work queues.  Each has exactly
+ * one worker thread that is bound to its CPU.
+ */
+
+extern struct kwork_wqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_SCHED_LPWORK
 /* The state of the kernel mode, low priority work queue(s). */
 
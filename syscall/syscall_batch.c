@@ -0,0 +1,141 @@
+/****************************************************************************
+ * syscall/syscall_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <syscall.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#ifdef CONFIG_SYSCALL_BATCH
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_batch_noreturn
+ *
+ * Description:
+ *   Return true if the system call may not return to the batch:  It ends
+ *   the calling thread, replaces its program or runs a child on its stack.
+ *
+ ****************************************************************************/
+
+static bool syscall_batch_noreturn(unsigned int nbr)
+{
+  switch (nbr)
+    {
+      case SYS__exit:
+#if defined(CONFIG_SCHED_WAITPID) && defined(CONFIG_ARCH_HAVE_VFORK)
+      case SYS_vfork:
+#endif
+#if !defined(CONFIG_BINFMT_DISABLE) && defined(CONFIG_LIBC_EXECFUNCS)
+      case SYS_execve:
+#endif
+#ifndef CONFIG_DISABLE_PTHREAD
+      case SYS_nx_pthread_exit:
+#endif
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Make a vector of system calls in a single trap.  The calls are made in
+ *   order and the return value of each one is stored in its result field.
+ *   A call that fails does not stop the batch.
+ *
+ * Input Parameters:
+ *   calls  - The calls
+ *   ncalls - The number of calls
+ *
+ * Returned Value:
+ *   The number of calls made, which is less than ncalls if the batch
+ *   stopped at an invalid call number.  -1 (ERROR) with errno set to
+ *   ENOSYS if the first call number is invalid, or to EINVAL without
+ *   making any call if the batch holds a call that may not return, as
+ *   _exit(), vfork() or execve().
+ *
+ ****************************************************************************/
+
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls)
+{
+  FAR struct syscall_batch_s *call;
+  syscall_stub_t stub;
+  int nbr;
+  int i;
+
+  for (i = 0; i < ncalls; i++)
+    {
+      if (syscall_batch_noreturn(calls[i].nbr))
+        {
+          set_errno(EINVAL);
+          return ERROR;
+        }
+    }
+
+  for (i = 0; i < ncalls; i++)
+    {
+      call = &calls[i];
+
+      /* Batches do not nest */
+
+      if (call->nbr < CONFIG_SYS_RESERVED || call->nbr >= SYS_maxsyscall ||
+          call->nbr == SYS_syscall_batch)
+        {
+          break;
+        }
+
+      nbr  = call->nbr - CONFIG_SYS_RESERVED;
+      stub = (syscall_stub_t)g_stublookup[nbr];
+
+      call->result = stub(nbr, call->parm[0], call->parm[1], call->parm[2],
+                          call->parm[3], call->parm[4], call->parm[5]);
+    }
+
+  if (i == 0 && ncalls > 0)
+    {
+      set_errno(ENOSYS);
+      return ERROR;
+    }
+
+  return i;
+}
+
+#endif /* CONFIG_SYSCALL_BATCH */
@@ -0,0 +1,86 @@
+/****************************************************************************
+ * syscall/syscall_leaf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <syscall.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#ifdef CONFIG_SYSCALL_LEAF
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_isleaf
+ *
+ * Description:
+ *   Return true if the system call never blocks nor switches the context,
+ *   so that the system call exception handler can run it itself.
+ *
+ ****************************************************************************/
+
+bool syscall_isleaf(unsigned int nbr)
+{
+  switch (nbr)
+    {
+      case SYS_getpid:
+      case SYS_gettid:
+#ifdef CONFIG_SCHED_HAVE_PARENT
+      case SYS_getppid:
+#endif
+      case SYS_sched_lockcount:
+#ifdef CONFIG_SMP
+      case SYS_sched_getcpu:
+#endif
+#ifdef CONFIG_SCHED_USER_IDENTITY
+      case SYS_getuid:
+      case SYS_getgid:
+#endif
+      case SYS_clock:
+      case SYS_clock_getres:
+
+      /* A high resolution RTC may sit on a bus that sleeps */
+
+#ifndef CONFIG_RTC_HIRES
+#  ifdef CONFIG_CLOCK_TIMEPAGE
+      case SYS_nx_clock_gettime:
+      case SYS_clock_timepage:
+#  else
+      case SYS_clock_gettime:
+#  endif
+#endif
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+#endif /* CONFIG_SYSCALL_LEAF */
@@ -89,6 +89,8 @@ initscript=`grep CONFIG_NSH_INITSCRIPT= $topdir/.config | cut -d'=' -f2`
 sysinitscript=`grep CONFIG_NSH_SYSINITSCRIPT= $topdir/.config | cut -d'=' -f2`
 romfsdevno=`grep CONFIG_NSH_ROMFSDEVNO= $topdir/.config | cut -d'=' -f2`
 romfssectsize=`grep CONFIG_NSH_ROMFSSECTSIZE= $topdir/.config | cut -d'=' -f2`
+romfsindex=`grep CONFIG_FS_ROMFS_INDEX= $topdir/.config | cut -d'=' -f2`
+romfsalign=`grep CONFIG_FS_ROMFS_XIP_ALIGN= $topdir/.config | cut -d'=' -f2`
 
 # If we disabled FAT FS requirement, we don't need to check it
 
@@ -301,12 +303,24 @@ rm -f $rcsfile
 
 # Now we are ready to make the ROMFS image
 
-genromfs -f $romfsimg -d $workingdir -V "NSHInitVol" || { echo "genromfs failed" ; exit 1 ; }
+if [ -z "$romfsalign" ]; then
+  romfsalign=4
+  genromfs -f $romfsimg -d $workingdir -V "NSHInitVol" || { echo "genromfs failed" ; exit 1 ; }
+else
+  genromfs -f $romfsimg -d $workingdir -V "NSHInitVol" -a $romfsalign || { echo "genromfs failed" ; exit 1 ; }
+fi
 rm -rf $workingdir || { echo "Failed to remove the old $workingdir"; exit 1; }
 
+# Append the directory hash index
+
+if [ "X$romfsindex" = "Xy" ]; then
+  make -C $topdir/tools -f Makefile.host romfsindex || { echo "Failed to build romfsindex" ; exit 1 ; }
+  $topdir/tools/romfsindex $romfsimg || { echo "romfsindex failed" ; rm -f $romfsimg; exit 1 ; }
+fi
+
 # And, finally, create the header file
 
 echo '#include <nuttx/compiler.h>' >${headerfile}
-xxd -i ${romfsimg} | sed 's/^unsigned char/const unsigned char aligned_data(4)/g' >>${headerfile} || \
+xxd -i ${romfsimg} | sed "s/^unsigned char/const unsigned char aligned_data($romfsalign)/g" >>${headerfile} || \
   { echo "ERROR: xxd of $< failed" ; rm -f $romfsimg; exit 1 ; }
 rm -f $romfsimg
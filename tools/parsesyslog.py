@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+# tools/parsesyslog.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+
+import argparse
+import re
+import struct
+import sys
+
+program_description = """
+This program formats the binary syslog records of CONFIG_SYSLOG_BINARY
+(see struct syslog_binary_s in include/nuttx/syslog/syslog.h) with the
+format strings of the ELF file of the target.  The log is the raw output
+of the SYSLOG channel, for example a dump of the RAM log buffer.
+"""
+
+MAGIC = b"\xa5\x5a"
+
+PRIORITIES = ["EMERG", "ALERT", "CRIT", "ERROR", "WARN", "NOTICE", "INFO", "DEBUG"]
+
+CONVERSION = re.compile(
+    rb"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXcfeEgGaAspn%])"
+)
+
+
+class elf_image:
+    """The allocated sections of an ELF file, to read the format strings"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+
+        self.is64 = data[4] == 2
+        self.endian = "<" if data[5] == 1 else ">"
+        self.ptrsize = 8 if self.is64 else 4
+        self.sections = []
+
+        if self.is64:
+            (shoff,) = struct.unpack_from(self.endian + "Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from(self.endian + "HH", data, 0x3A)
+            shfmt = "IIQQQQIIQQ"
+        else:
+            (shoff,) = struct.unpack_from(self.endian + "I", data, 0x20)
+            shentsize, shnum = struct.unpack_from(self.endian + "HH", data, 0x2E)
+            shfmt = "IIIIIIIIII"
+
+        for i in range(shnum):
+            sh = struct.unpack_from(self.endian + shfmt, data, shoff + i * shentsize)
+            shtype, flags, addr, offset, size = sh[1], sh[2], sh[3], sh[4], sh[5]
+
+            # Only the sections loaded on the target with contents
+
+            if flags & 0x2 and shtype != 8 and size > 0:
+                self.sections.append((addr, size, data[offset : offset + size]))
+
+    def string(self, addr):
+        for start, size, contents in self.sections:
+            if start <= addr < start + size:
+                end = contents.find(b"\0", addr - start)
+                return contents[addr - start : end if end >= 0 else None]
+
+        return None
+
+
+class record_args:
+    """The arguments of a record, in the order of the format"""
+
+    def __init__(self, image, data):
+        self.image = image
+        self.data = data
+        self.pos = 0
+
+    def take(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise EOFError
+        (value,) = struct.unpack_from(self.image.endian + fmt, self.data, self.pos)
+        self.pos += size
+        return value
+
+    def integer(self, length, signed):
+        ptr = "q" if self.image.ptrsize == 8 else "i"
+        types = {
+            None: "i",
+            "hh": "i",
+            "h": "i",
+            "l": ptr,
+            "ll": "q",
+            "j": "q",
+            "z": ptr,
+            "t": ptr,
+        }
+        fmt = types.get(length, "i")
+        return self.take(fmt if signed else fmt.upper())
+
+    def string(self):
+        end = self.data.find(b"\0", self.pos)
+        if end < 0:
+            end = len(self.data)
+        value = self.data[self.pos : end]
+        self.pos = end + 1
+        return value.decode(errors="replace")
+
+
+def format_record(image, fmt, args):
+    out = []
+    pos = 0
+
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos : m.start()].decode(errors="replace"))
+        pos = m.end()
+
+        flags, width, prec, length, conv = [
+            g.decode() if g is not None else None for g in m.groups()
+        ]
+
+        if conv == "%":
+            out.append("%")
+            continue
+
+        try:
+            if width == "*":
+                width = str(args.take("i"))
+            if prec == "*":
+                prec = str(args.take("i"))
+
+            spec = "%" + flags + (width or "")
+            if prec is not None:
+                spec += "." + prec
+
+            if conv in "di":
+                out.append((spec + "d") % args.integer(length, True))
+            elif conv in "ouxX":
+                out.append((spec + conv) % args.integer(length, False))
+            elif conv == "c":
+                out.append((spec + "c") % chr(args.take("i") & 0xFF))
+            elif conv in "feEgGaAF":
+                value = args.take("d")
+                if conv in "aA":
+                    out.append(value.hex())
+                else:
+                    out.append((spec + conv) % value)
+            elif conv == "p":
+                out.append(
+                    "0x%x" % args.take("Q" if image.ptrsize == 8 else "I")
+                )
+            elif conv == "s":
+                out.append((spec + "s") % args.string())
+            elif conv == "n":
+                pass
+        except EOFError:
+            out.append("[truncated]")
+            return "".join(out)
+
+    out.append(fmt[pos:].decode(errors="replace"))
+    return "".join(out)
+
+
+def parse_log(image, log):
+    ptr = "Q" if image.ptrsize == 8 else "I"
+    header = image.endian + "2sBBiII" + ptr
+    hdrlen = struct.calcsize(header)
+    pos = 0
+
+    while True:
+        pos = log.find(MAGIC, pos)
+        if pos < 0 or pos + hdrlen > len(log):
+            break
+
+        magic, prio, length, pid, sec, nsec, fmtaddr = struct.unpack_from(
+            header, log, pos
+        )
+
+        fmt = image.string(fmtaddr)
+        if length < hdrlen or pos + length > len(log) or fmt is None:
+            # Not a record, the magic is in other data
+
+            pos += 1
+            continue
+
+        args = record_args(image, log[pos + hdrlen : pos + length])
+        text = format_record(image, fmt, args)
+        prio = PRIORITIES[prio] if prio < len(PRIORITIES) else str(prio)
+
+        yield "[%5d.%06d] [%3d] [%6s] %s" % (sec, nsec // 1000, pid, prio, text)
+        pos += length
+
+
+def main():
+    parser = argparse.ArgumentParser(description=program_description)
+    parser.add_argument("-e", "--elf", required=True, help="ELF file of the target")
+    parser.add_argument("-f", "--file", required=True, help="binary syslog output")
+    parser.add_argument("-o", "--output", help="output file, stdout by default")
+    args = parser.parse_args()
+
+    image = elf_image(args.elf)
+    with open(args.file, "rb") as f:
+        log = f.read()
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    for line in parse_log(image, log):
+        out.write(line.rstrip("\n") + "\n")
+
+
+if __name__ == "__main__":
+    main()
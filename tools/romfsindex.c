@@ -0,0 +1,364 @@
+/****************************************************************************
+ * tools/romfsindex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Append the directory hash index of CONFIG_FS_ROMFS_INDEX to a ROMFS
+ * image made by genromfs.  The layout is described in fs/romfs/fs_romfs.h.
+ * An index already appended to the image is replaced.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These must match fs/romfs/fs_romfs.h */
+
+#define ROMFS_VHDR_SIZE     8
+#define ROMFS_VHDR_VOLNAME  16
+#define ROMFS_VHDR_MAGIC    "-rom1fs-"
+
+#define ROMFS_FHDR_NEXT     0
+#define ROMFS_FHDR_INFO     4
+#define ROMFS_FHDR_NAME     16
+
+#define ROMFS_IHDR_MAGIC    0
+#define ROMFS_IHDR_NBUCKETS 8
+#define ROMFS_IHDR_NENTRIES 12
+#define ROMFS_IHDR_CHKSUM   16
+#define ROMFS_IHDR_SIZE     32
+#define ROMFS_IHDR_MAGICSTR "-romidx-"
+#define ROMFS_IENTRY_SIZE   12
+
+#define ROMFS_HASH_INIT     0x811c9dc5
+#define ROMFS_HASH_PRIME    0x01000193
+
+#define RFNEXT_MODEMASK     7
+#define RFNEXT_DIRECTORY    1
+#define RFNEXT_OFFSETMASK   (~15)
+
+#define ROMFS_ALIGNUP(addr) (((addr) + 15) & ~15)
+
+/* Bound the depth of the directories, in case of a corrupted image */
+
+#define MAX_DEPTH           64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct index_entry_s
+{
+  uint32_t dir;                /* Offset of the first header of the dir */
+  uint32_t hash;               /* Hash of the dir and of the name */
+  uint32_t offset;             /* Offset of the header of the entry */
+  uint32_t bucket;             /* Bucket of the hash */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static char *g_progname;       /* Name of this program */
+static uint8_t *g_image;       /* The image */
+static uint32_t g_volsize;     /* Size of the volume */
+
+static struct index_entry_s *g_entries;
+static uint32_t g_nentries;
+static uint32_t g_maxentries;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(void)
+{
+  fprintf(stderr, "USAGE: %s <romfs-image>\n", g_progname);
+  exit(1);
+}
+
+static uint32_t get_uint32(const uint8_t *ptr)
+{
+  return ((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) |
+         ((uint32_t)ptr[2] << 8) | (uint32_t)ptr[3];
+}
+
+static void put_uint32(uint8_t *ptr, uint32_t value)
+{
+  ptr[0] = value >> 24;
+  ptr[1] = value >> 16;
+  ptr[2] = value >> 8;
+  ptr[3] = value;
+}
+
+static uint32_t romfs_hash(uint32_t dir, const char *name, size_t len)
+{
+  uint32_t hash = ROMFS_HASH_INIT;
+  size_t i;
+  int j;
+
+  for (j = 24; j >= 0; j -= 8)
+    {
+      hash = (hash ^ ((dir >> j) & 0xff)) * ROMFS_HASH_PRIME;
+    }
+
+  for (i = 0; i < len; i++)
+    {
+      hash = (hash ^ (uint8_t)name[i]) * ROMFS_HASH_PRIME;
+    }
+
+  return hash;
+}
+
+static void add_entry(uint32_t dir, uint32_t offset, const char *name,
+                      size_t len)
+{
+  if (g_nentries >= g_maxentries)
+    {
+      g_maxentries = g_maxentries ? 2 * g_maxentries : 64;
+      g_entries    = realloc(g_entries,
+                             g_maxentries * sizeof(struct index_entry_s));
+      if (g_entries == NULL)
+        {
+          fprintf(stderr, "Out of memory\n");
+          exit(1);
+        }
+    }
+
+  g_entries[g_nentries].dir    = dir;
+  g_entries[g_nentries].hash   = romfs_hash(dir, name, len);
+  g_entries[g_nentries].offset = offset;
+  g_nentries++;
+}
+
+static void traverse_directory(uint32_t dir, int depth)
+{
+  const char *name;
+  uint32_t offset = dir;
+  uint32_t next;
+  uint32_t info;
+  size_t len;
+
+  if (depth > MAX_DEPTH)
+    {
+      fprintf(stderr, "Directories nested too deep\n");
+      exit(1);
+    }
+
+  do
+    {
+      if (offset < ROMFS_VHDR_VOLNAME ||
+          offset + ROMFS_FHDR_NAME >= g_volsize)
+        {
+          fprintf(stderr, "Bad header offset 0x%08x\n", offset);
+          exit(1);
+        }
+
+      next = get_uint32(&g_image[offset + ROMFS_FHDR_NEXT]);
+      info = get_uint32(&g_image[offset + ROMFS_FHDR_INFO]);
+      name = (const char *)&g_image[offset + ROMFS_FHDR_NAME];
+      len  = strnlen(name, g_volsize - offset - ROMFS_FHDR_NAME);
+
+      add_entry(dir, offset, name, len);
+
+      /* Hard links (as . and ..) are not followed */
+
+      if ((next & RFNEXT_MODEMASK) == RFNEXT_DIRECTORY &&
+          strcmp(name, ".") != 0 && strcmp(name, "..") != 0)
+        {
+          traverse_directory(info & RFNEXT_OFFSETMASK, depth + 1);
+        }
+
+      offset = next & RFNEXT_OFFSETMASK;
+    }
+  while (offset != 0);
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+  const struct index_entry_s *ea = a;
+  const struct index_entry_s *eb = b;
+
+  if (ea->bucket != eb->bucket)
+    {
+      return ea->bucket < eb->bucket ? -1 : 1;
+    }
+
+  return ea->offset < eb->offset ? -1 : ea->offset > eb->offset;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  char *progname;
+  uint8_t *index;
+  uint8_t *ptr;
+  uint32_t nbuckets;
+  uint32_t imgsize;
+  uint32_t chksum;
+  uint32_t size;
+  uint32_t i;
+  uint32_t j;
+  long filesize;
+  FILE *stream;
+
+  progname   = strrchr(argv[0], '/');
+  g_progname = progname == NULL ? argv[0] : progname + 1;
+
+  if (argc != 2)
+    {
+      fprintf(stderr, "Unexpected number of arguments\n");
+      show_usage();
+    }
+
+  /* Read the image */
+
+  stream = fopen(argv[1], "rb");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "open %s failed: %s\n", argv[1], strerror(errno));
+      exit(1);
+    }
+
+  fseek(stream, 0, SEEK_END);
+  filesize = ftell(stream);
+  fseek(stream, 0, SEEK_SET);
+
+  if (filesize < ROMFS_VHDR_VOLNAME + ROMFS_FHDR_NAME)
+    {
+      fprintf(stderr, "%s is not a ROMFS image\n", argv[1]);
+      exit(1);
+    }
+
+  g_image = malloc(filesize + 16);
+  if (g_image == NULL ||
+      fread(g_image, 1, filesize, stream) != (size_t)filesize)
+    {
+      fprintf(stderr, "read %s failed\n", argv[1]);
+      exit(1);
+    }
+
+  fclose(stream);
+
+  g_volsize = get_uint32(&g_image[ROMFS_VHDR_SIZE]);
+  if (memcmp(g_image, ROMFS_VHDR_MAGIC, 8) != 0 ||
+      g_volsize > (uint32_t)filesize ||
+      g_volsize < ROMFS_VHDR_VOLNAME + ROMFS_FHDR_NAME)
+    {
+      fprintf(stderr, "%s is not a ROMFS image\n", argv[1]);
+      exit(1);
+    }
+
+  /* Index all of the entries of all of the directories */
+
+  size = strnlen((const char *)&g_image[ROMFS_VHDR_VOLNAME],
+                 g_volsize - ROMFS_VHDR_VOLNAME);
+  traverse_directory(ROMFS_ALIGNUP(ROMFS_VHDR_VOLNAME + size + 1), 0);
+
+  nbuckets = 1;
+  while (nbuckets < g_nentries)
+    {
+      nbuckets <<= 1;
+    }
+
+  for (i = 0; i < g_nentries; i++)
+    {
+      g_entries[i].bucket = g_entries[i].hash & (nbuckets - 1);
+    }
+
+  qsort(g_entries, g_nentries, sizeof(struct index_entry_s),
+        compare_entries);
+
+  /* Generate the index */
+
+  size  = ROMFS_IHDR_SIZE + 4 * (nbuckets + 1) +
+          ROMFS_IENTRY_SIZE * g_nentries;
+  index = calloc(1, size);
+  if (index == NULL)
+    {
+      fprintf(stderr, "Out of memory\n");
+      exit(1);
+    }
+
+  memcpy(&index[ROMFS_IHDR_MAGIC], ROMFS_IHDR_MAGICSTR, 8);
+  put_uint32(&index[ROMFS_IHDR_NBUCKETS], nbuckets);
+  put_uint32(&index[ROMFS_IHDR_NENTRIES], g_nentries);
+
+  ptr = &index[ROMFS_IHDR_SIZE];
+  for (i = 0, j = 0; i <= nbuckets; i++, ptr += 4)
+    {
+      while (j < g_nentries && g_entries[j].bucket < i)
+        {
+          j++;
+        }
+
+      put_uint32(ptr, j);
+    }
+
+  for (i = 0; i < g_nentries; i++, ptr += ROMFS_IENTRY_SIZE)
+    {
+      put_uint32(ptr, g_entries[i].dir);
+      put_uint32(ptr + 4, g_entries[i].hash);
+      put_uint32(ptr + 8, g_entries[i].offset);
+    }
+
+  for (chksum = 0, i = 0; i < size; i += 4)
+    {
+      chksum += get_uint32(&index[i]);
+    }
+
+  put_uint32(&index[ROMFS_IHDR_CHKSUM], -chksum);
+
+  /* Replace anything after the volume with the index */
+
+  imgsize = ROMFS_ALIGNUP(g_volsize);
+  memset(&g_image[g_volsize], 0, imgsize - g_volsize);
+
+  stream = fopen(argv[1], "wb");
+  if (stream == NULL)
+    {
+      fprintf(stderr, "open %s failed: %s\n", argv[1], strerror(errno));
+      exit(1);
+    }
+
+  if (fwrite(g_image, 1, imgsize, stream) != imgsize ||
+      fwrite(index, 1, size, stream) != size)
+    {
+      fprintf(stderr, "write %s failed\n", argv[1]);
+      exit(1);
+    }
+
+  fclose(stream);
+  free(index);
+  free(g_entries);
+  free(g_image);
+  return 0;
+}
@@ -491,6 +491,17 @@ static uint8_t att_mtu_req(struct bt_conn_s *conn, struct bt_buf_s *data)
    */
 
   maxmtu = bt_buf_tailroom(buf) + 1;
+
+  /* A PDU that fits into one ACL packet of the controller is sent in
+   * place, without L2CAP fragmentation.
+   */
+
+  if (g_btdev.le_mtu > sizeof(struct bt_l2cap_hdr_s) &&
+      maxmtu > g_btdev.le_mtu - sizeof(struct bt_l2cap_hdr_s))
+    {
+      maxmtu = g_btdev.le_mtu - sizeof(struct bt_l2cap_hdr_s);
+    }
+
   if (mtu > maxmtu)
     {
       mtu = maxmtu;
@@ -564,6 +575,13 @@ static uint8_t att_mtu_rsp(FAR struct bt_conn_s *conn,
   maxmtu = BLUETOOTH_MAX_FRAMELEN - (sizeof(struct bt_l2cap_hdr_s) +
                                      sizeof(struct bt_hci_acl_hdr_s) +
                                      g_btdev.btdev->head_reserve);
+
+  if (g_btdev.le_mtu > sizeof(struct bt_l2cap_hdr_s) &&
+      maxmtu > g_btdev.le_mtu - sizeof(struct bt_l2cap_hdr_s))
+    {
+      maxmtu = g_btdev.le_mtu - sizeof(struct bt_l2cap_hdr_s);
+    }
+
   if (mtu > maxmtu)
     {
       mtu = maxmtu;
@@ -1420,6 +1420,44 @@ static int hci_initialize(void)
       bt_hci_cmd_send_sync(BT_HCI_OP_LE_WRITE_LE_HOST_SUPP, buf, NULL);
     }
 
+  /* Ask for the link layer payload of the LE Data Packet Length Extension
+   * and for the 2M PHY on new connections.  Both are only preferences: the
+   * controller negotiates them with the peer.
+   */
+
+  if ((g_btdev.le_features[0] & BT_HCI_LE_DATA_LEN_EXT) != 0)
+    {
+      FAR struct bt_hci_cp_le_write_default_data_len_s *cp;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN,
+                              sizeof(*cp));
+      if (buf != NULL)
+        {
+          cp                = bt_buf_extend(buf, sizeof(*cp));
+          cp->max_tx_octets = BT_HOST2LE16(BT_HCI_LE_MAX_TX_OCTETS);
+          cp->max_tx_time   = BT_HOST2LE16(BT_HCI_LE_MAX_TX_TIME);
+
+          bt_hci_cmd_send_sync(BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN, buf,
+                               NULL);
+        }
+    }
+
+  if ((g_btdev.le_features[1] & BT_HCI_LE_2M_PHY) != 0)
+    {
+      FAR struct bt_hci_cp_le_set_default_phy_s *cp;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_DEFAULT_PHY, sizeof(*cp));
+      if (buf != NULL)
+        {
+          cp           = bt_buf_extend(buf, sizeof(*cp));
+          cp->all_phys = 0;
+          cp->tx_phys  = BT_HCI_LE_PHY_1M | BT_HCI_LE_PHY_2M;
+          cp->rx_phys  = BT_HCI_LE_PHY_1M | BT_HCI_LE_PHY_2M;
+
+          bt_hci_cmd_send_sync(BT_HCI_OP_LE_SET_DEFAULT_PHY, buf, NULL);
+        }
+    }
+
   wlinfo("HCI ver %u rev %u, manufacturer %u\n", g_btdev.hci_version,
          g_btdev.hci_revision, g_btdev.manufacturer);
   wlinfo("ACL buffers: pkts %u mtu %u\n", g_btdev.le_pkts, g_btdev.le_mtu);
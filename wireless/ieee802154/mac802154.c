@@ -163,6 +163,16 @@ int mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
 
       nxmutex_unlock(&priv->lock);
 
+      /* The descriptors are only released as the radio sends frames:  Make
+       * sure that it knows of those queued without a notification by
+       * mac802154_req_datalist().
+       */
+
+      if (!sq_empty(&priv->csma_queue))
+        {
+          priv->radio->txnotify(priv->radio, false);
+        }
+
       /* Take a count from the tx desc semaphore, waiting if necessary. We
        * only return from here with an error if we are allowing interruptions
        * and we received a signal.
@@ -369,13 +379,18 @@ static void mac802154_notify_worker(FAR void *arg)
     (FAR struct ieee802154_privmac_s *)arg;
   FAR struct mac802154_maccb_s *cb;
   FAR struct ieee802154_primitive_s *primitive;
+  sq_queue_t batch;
   int ret;
 
+  /* Take all the queued primitives at once, so that a burst of received
+   * frames is handed to the clients without taking the MAC lock for each.
+   */
+
   nxmutex_lock(&priv->lock);
-  primitive =
-    (FAR struct ieee802154_primitive_s *)sq_remfirst(&priv->primitive_queue);
+  sq_move(&priv->primitive_queue, &batch);
   nxmutex_unlock(&priv->lock);
 
+  primitive = (FAR struct ieee802154_primitive_s *)sq_remfirst(&batch);
   while (primitive != NULL)
     {
       /* Data indications are a special case since the frame can only be
@@ -442,12 +457,16 @@ static void mac802154_notify_worker(FAR void *arg)
             }
         }
 
-      /* Get the next primitive then loop */
+      /* Get the next primitive, or the next batch, then loop */
 
-      nxmutex_lock(&priv->lock);
-      primitive = (FAR struct ieee802154_primitive_s *)
-                    sq_remfirst(&priv->primitive_queue);
-      nxmutex_unlock(&priv->lock);
+      if (sq_empty(&batch))
+        {
+          nxmutex_lock(&priv->lock);
+          sq_move(&priv->primitive_queue, &batch);
+          nxmutex_unlock(&priv->lock);
+        }
+
+      primitive = (FAR struct ieee802154_primitive_s *)sq_remfirst(&batch);
     }
 }
 
@@ -140,6 +140,21 @@ int mac802154_req_data(MACHANDLE mac,
                        FAR const struct ieee802154_frame_meta_s *meta,
                        FAR struct iob_s *frame);
 
+/****************************************************************************
+ * Name: mac802154_req_datalist
+ *
+ * Description:
+ *   Issue an MCPS-DATA.request for each frame of a list linked through
+ *   io_flink, notifying the radio once for the whole list.  Returns the
+ *   number of frames queued; on failure, the frames that were not queued
+ *   are freed and a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int mac802154_req_datalist(MACHANDLE mac,
+                           FAR const struct ieee802154_frame_meta_s *meta,
+                           FAR struct iob_s *framelist);
+
 /****************************************************************************
  * Name: mac802154_req_purge
  *
@@ -39,26 +39,24 @@
 #include <nuttx/wireless/ieee802154/ieee802154_mac.h>
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mac802154_req_data
+ * Name: mac802154_data_queue
  *
  * Description:
- *   The MCPS-DATA.request primitive requests the transfer of a data SPDU
- *   (i.e., MSDU) from a local SSCS entity to a single peer SSCS entity.
- *   Confirmation is returned via the
- *   struct mac802154_maccb_s->conf_data callback.
+ *   Build the MAC header of a data frame and queue it for transmission.
+ *   The radio is notified of a CSMA transaction only if notify is true, so
+ *   that a list of frames costs a single notification.
  *
  ****************************************************************************/
 
-int mac802154_req_data(MACHANDLE mac,
-                       FAR const struct ieee802154_frame_meta_s *meta,
-                       FAR struct iob_s *frame)
+static int
+mac802154_data_queue(FAR struct ieee802154_privmac_s *priv,
+                     FAR const struct ieee802154_frame_meta_s *meta,
+                     FAR struct iob_s *frame, bool notify)
 {
-  FAR struct ieee802154_privmac_s *priv =
-    (FAR struct ieee802154_privmac_s *)mac;
   FAR struct ieee802154_txdesc_s *txdesc;
   uint16_t *frame_ctrl;
   uint8_t mhr_len = 3;
@@ -340,7 +338,10 @@ int mac802154_req_data(MACHANDLE mac,
 
           /* Notify the radio driver that there is data available */
 
-          priv->radio->txnotify(priv->radio, false);
+          if (notify)
+            {
+              priv->radio->txnotify(priv->radio, false);
+            }
         }
     }
 
@@ -358,6 +359,86 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mac802154_req_data
+ *
+ * Description:
+ *   The MCPS-DATA.request primitive requests the transfer of a data SPDU
+ *   (i.e., MSDU) from a local SSCS entity to a single peer SSCS entity.
+ *   Confirmation is returned via the
+ *   struct mac802154_maccb_s->conf_data callback.
+ *
+ ****************************************************************************/
+
+int mac802154_req_data(MACHANDLE mac,
+                       FAR const struct ieee802154_frame_meta_s *meta,
+                       FAR struct iob_s *frame)
+{
+  return mac802154_data_queue((FAR struct ieee802154_privmac_s *)mac,
+                              meta, frame, true);
+}
+
+/****************************************************************************
+ * Name: mac802154_req_datalist
+ *
+ * Description:
+ *   Issue an MCPS-DATA.request for each frame of a list linked through
+ *   io_flink, e.g. the fragments of a 6LoWPAN packet.  The frames are
+ *   queued back to back and the radio is notified once, so that it can
+ *   send them without returning to the MAC in between.
+ *
+ * Returned Value:
+ *   The number of frames queued, which is the length of the list on
+ *   success.  On failure, the frames that were not queued are freed and a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int mac802154_req_datalist(MACHANDLE mac,
+                           FAR const struct ieee802154_frame_meta_s *meta,
+                           FAR struct iob_s *framelist)
+{
+  FAR struct ieee802154_privmac_s *priv =
+    (FAR struct ieee802154_privmac_s *)mac;
+  FAR struct iob_s *iob;
+  int nqueued = 0;
+  int ret = OK;
+
+  while (framelist != NULL)
+    {
+      iob           = framelist;
+      framelist     = iob->io_flink;
+      iob->io_flink = NULL;
+
+      ret = mac802154_data_queue(priv, meta, iob, false);
+      if (ret < 0)
+        {
+          iob_free(iob);
+          while (framelist != NULL)
+            {
+              iob       = framelist;
+              framelist = iob->io_flink;
+              iob_free(iob);
+            }
+
+          break;
+        }
+
+      nqueued++;
+    }
+
+  if (nqueued > 0)
+    {
+      priv->radio->txnotify(priv->radio, false);
+    }
+
+  return ret < 0 ? ret : nqueued;
+}
+
 /****************************************************************************
  * Internal MAC Functions
  ****************************************************************************/
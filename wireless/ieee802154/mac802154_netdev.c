@@ -1098,39 +1098,25 @@ static int macnet_req_data(FAR struct radio_driver_s *netdev,
 
   DEBUGASSERT(priv != NULL && pktmeta != NULL && framelist != NULL);
 
-  /* Add the incoming list of frames to the MAC's outgoing queue */
+  /* Increment statistics */
 
-  for (iob = framelist; iob != NULL; iob = framelist)
+  for (iob = framelist; iob != NULL; iob = iob->io_flink)
     {
-      /* Increment statistics */
-
       NETDEV_TXPACKETS(&priv->md_dev.r_dev);
+    }
 
-      /* Remove the IOB from the queue */
-
-      framelist     = iob->io_flink;
-      iob->io_flink = NULL;
-
-      /* Transfer the frame to the MAC. */
-
-      ret = mac802154_req_data(priv->md_mac, pktmeta, iob);
-      if (ret < 0)
-        {
-          wlerr("ERROR: mac802154_req_data failed: %d\n", ret);
-
-          iob_free(iob);
-          for (iob = framelist; iob != NULL; iob = framelist)
-            {
-              /* Remove the IOB from the queue and free */
-
-              framelist = iob->io_flink;
-              iob_free(iob);
-            }
+  /* Add the incoming list of frames to the MAC's outgoing queue at once */
 
-          NETDEV_TXERRORS(&priv->md_dev.r_dev);
-          return ret;
-        }
+  ret = mac802154_req_datalist(priv->md_mac, pktmeta, framelist);
+  if (ret < 0)
+    {
+      wlerr("ERROR: mac802154_req_datalist failed: %d\n", ret);
+      NETDEV_TXERRORS(&priv->md_dev.r_dev);
+      return ret;
+    }
 
+  while (ret-- > 0)
+    {
       NETDEV_TXDONE(&priv->md_dev.r_dev);
     }
 